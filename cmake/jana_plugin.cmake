@@ -68,6 +68,26 @@ macro(plugin_add _name)
       DESTINATION ${PLUGIN_OUTPUT_DIRECTORY})
   endif(${_name}_WITH_PLUGIN)
 
+  # Define the objects of the plugin that are linked into eicrecon_static, with
+  # InitPlugin renamed for the static plugin registry of the executable
+  set(${_name}_WITH_STATIC OFF)
+  if(${_name}_WITH_PLUGIN
+     AND USE_STATIC_PLUGINS
+     AND ${_name} IN_LIST EICRECON_STATIC_PLUGINS)
+    set(${_name}_WITH_STATIC ON)
+    add_library(${_name}_static OBJECT ${PLUGIN_SOURCES})
+
+    target_include_directories(
+      ${_name}_static PUBLIC $<BUILD_INTERFACE:${EICRECON_SOURCE_DIR}/src>)
+    target_include_directories(${_name}_static SYSTEM
+                               PUBLIC ${JANA_INCLUDE_DIR} ${ROOT_INCLUDE_DIRS})
+    target_compile_definitions(${_name}_static
+                               PRIVATE "InitPlugin=InitPlugin_${_name}")
+    target_link_libraries(${_name}_static ${JANA_LIB} podio::podio
+                          podio::podioRootIO spdlog::spdlog fmt::fmt)
+    target_link_libraries(${_name}_static Microsoft.GSL::GSL)
+  endif()
+
   # Define library
   if(${_name}_WITH_LIBRARY)
     add_library(${_name}_library ${${_name}_LIBRARY_TYPE} "")
@@ -114,6 +134,10 @@ macro(plugin_add _name)
       target_link_libraries(${_name}_plugin ${_name}_library)
     endif()
   endif()
+
+  if(${_name}_WITH_LIBRARY AND ${_name}_WITH_STATIC)
+    target_link_libraries(${_name}_static ${_name}_library)
+  endif()
 endmacro()
 
 # target_link_libraries for both a plugin and a library
@@ -122,6 +146,10 @@ macro(plugin_link_libraries _name)
     target_link_libraries(${_name}_plugin ${ARGN})
   endif(${_name}_WITH_PLUGIN)
 
+  if(${_name}_WITH_STATIC)
+    target_link_libraries(${_name}_static ${ARGN})
+  endif(${_name}_WITH_STATIC)
+
   if(${_name}_WITH_LIBRARY)
     target_link_libraries(${_name}_library ${ARGN})
   endif(${_name}_WITH_LIBRARY)
@@ -133,6 +161,10 @@ macro(plugin_include_directories _name)
     target_include_directories(${_name}_plugin ${ARGN})
   endif(${_name}_WITH_PLUGIN)
 
+  if(${_name}_WITH_STATIC)
+    target_include_directories(${_name}_static ${ARGN})
+  endif(${_name}_WITH_STATIC)
+
   if(${_name}_WITH_LIBRARY)
     target_include_directories(${_name}_library ${ARGN})
   endif(${_name}_WITH_LIBRARY)
@@ -145,6 +177,9 @@ macro(plugin_sources _name)
 
   # Add sources to plugin
   target_sources(${_name}_plugin PRIVATE ${SOURCES})
+  if(${_name}_WITH_STATIC)
+    target_sources(${_name}_static PRIVATE ${SOURCES})
+  endif(${_name}_WITH_STATIC)
 
   if(${_name}_WITH_LIBRARY)
     # Library don't need <plugin_name>.cc in library
@@ -198,6 +233,9 @@ macro(plugin_glob_all _name)
   if(TARGET ${_name}_plugin)
     target_sources(${_name}_plugin PRIVATE ${PLUGIN_SRC_FILES})
   endif()
+  if(${_name}_WITH_STATIC)
+    target_sources(${_name}_static PRIVATE ${PLUGIN_SRC_FILES})
+  endif()
 
   # FIXME cmake 3.23: define FILE_SET on target_sources
   install(
@@ -305,6 +343,10 @@ macro(plugin_add_acts _name)
     target_compile_definitions(
       ${PLUGIN_NAME}_plugin PRIVATE "Acts_VERSION_MAJOR=${Acts_VERSION_MAJOR}")
   endif()
+  if(${_name}_WITH_STATIC)
+    target_compile_definitions(
+      ${PLUGIN_NAME}_static PRIVATE "Acts_VERSION_MAJOR=${Acts_VERSION_MAJOR}")
+  endif()
 
 endmacro()
 
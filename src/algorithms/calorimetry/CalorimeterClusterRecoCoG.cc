@@ -20,20 +20,21 @@
 #include <fmt/core.h>
 #include <podio/ObjectID.h>
 #include <podio/RelationRange.h>
-#include <Eigen/Core>
-#include <Eigen/Eigenvalues>
-#include <Eigen/Householder> // IWYU pragma: keep
+#include <array>
 #include <cctype>
-#include <complex>
 #include <cstddef>
 #include <gsl/pointers>
 #include <iterator>
 #include <limits>
 #include <map>
 #include <optional>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 #include "CalorimeterClusterRecoCoG.h"
+#include "FastLog.h"
+#include "SymmetricEigen.h"
 #include "algorithms/calorimetry/CalorimeterClusterRecoCoGConfig.h"
 
 namespace eicrecon {
@@ -52,36 +53,85 @@ namespace eicrecon {
       return;
     }
     weightFunc = it->second;
+    m_fastLogWeights = m_cfg.singlePrecision && (ew == "log");
+  }
+
+  void CalorimeterClusterRecoCoG::computeWeights(std::span<const float> energy, float totalE, double logWeightBase, std::span<float> w) const {
+    if (m_fastLogWeights) {
+      const float inv_totalE = 1.f / totalE;
+      const auto base = static_cast<float>(logWeightBase);
+      for (std::size_t i = 0; i < energy.size(); ++i) {
+        w[i] = fast_math::log_weight(energy[i] * inv_totalE, base);
+      }
+      return;
+    }
+    for (std::size_t i = 0; i < energy.size(); ++i) {
+      w[i] = weightFunc(energy[i], totalE, logWeightBase, 0);
+    }
   }
 
   void CalorimeterClusterRecoCoG::process(
       const CalorimeterClusterRecoCoG::Input& input,
       const CalorimeterClusterRecoCoG::Output& output) const {
+    process(std::span<const Input>(&input, 1), std::span<const Output>(&output, 1));
+  }
+
+  void CalorimeterClusterRecoCoG::process(std::span<const Input> inputs, std::span<const Output> outputs) const {
+
+    // reused by all clusters of all the collections
+    HitBuffer hit_buffer;
+
+    // index of the first mchit of every CellID, shared by the collections of the same mchits
+    const edm4hep::SimCalorimeterHitCollection* indexed_mchits = nullptr;
+    std::unordered_map<uint64_t, std::size_t> mchit_index;
+
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+      const auto [proto, mchits] = inputs[i];
+      auto [clusters, associations] = outputs[i];
+
+      // no truth association without the mchits or without an association output
+      if (mchits == nullptr || associations == nullptr) {
+        reconstructCollection(*proto, nullptr, mchit_index, hit_buffer, *clusters, nullptr);
+        continue;
+      }
+      if (mchits != indexed_mchits) {
+        mchit_index.clear();
+        mchit_index.reserve(mchits->size());
+        for (std::size_t ix = 0; ix < mchits->size(); ++ix) {
+          mchit_index.emplace((*mchits)[ix].getCellID(), ix);
+        }
+        indexed_mchits = mchits;
+      }
+      reconstructCollection(*proto, mchits, mchit_index, hit_buffer, *clusters, associations);
+    }
+  }
 
-    const auto [proto, mchits] = input;
-    auto [clusters, associations] = output;
+  void CalorimeterClusterRecoCoG::reconstructCollection(
+      const edm4eic::ProtoClusterCollection& proto, const edm4hep::SimCalorimeterHitCollection* mchits,
+      const std::unordered_map<uint64_t, std::size_t>& mchit_index, HitBuffer& hit_buffer,
+      edm4eic::ClusterCollection& clusters, edm4eic::MCRecoClusterParticleAssociationCollection* associations) const {
 
-    for (const auto& pcl : *proto) {
+    for (const auto& pcl : proto) {
 
       // skip protoclusters with no hits
       if (pcl.hits_size() == 0) {
         continue;
       }
 
-      auto cl_opt = reconstruct(pcl);
+      auto cl_opt = reconstruct(pcl, hit_buffer);
       if (! cl_opt.has_value()) {
         continue;
       }
       auto cl = *std::move(cl_opt);
 
       debug("{} hits: {} GeV, ({}, {}, {})", cl.getNhits(), cl.getEnergy() / dd4hep::GeV, cl.getPosition().x / dd4hep::mm, cl.getPosition().y / dd4hep::mm, cl.getPosition().z / dd4hep::mm);
-      clusters->push_back(cl);
+      clusters.push_back(cl);
 
       // If mcHits are available, associate cluster with MCParticle
       // 1. find proto-cluster hit with largest energy deposition
       // 2. find first mchit with same CellID
       // 3. assign mchit's MCParticle as cluster truth
-      if (mchits->size() > 0) {
+      if (mchits != nullptr && associations != nullptr && mchits->size() > 0) {
 
         // 1. find pclhit with largest energy deposition
         auto pclhits = pcl.getHits();
@@ -93,23 +143,9 @@ namespace eicrecon {
           }
         );
 
-        // 2. find mchit with same CellID
-        // find_if not working, https://github.com/AIDASoft/podio/pull/273
-        //auto mchit = std::find_if(
-        //  mchits->begin(),
-        //  mchits->end(),
-        //  [&pclhit](const auto& mchit1) {
-        //    return mchit1.getCellID() == pclhit->getCellID();
-        //  }
-        //);
-        auto mchit = mchits->begin();
-        for ( ; mchit != mchits->end(); ++mchit) {
-          // break loop when CellID match found
-          if ( mchit->getCellID() == pclhit->getCellID()) {
-            break;
-          }
-        }
-        if (!(mchit != mchits->end())) {
+        // 2. find first mchit with same CellID
+        auto mchit_it = mchit_index.find(pclhit->getCellID());
+        if (mchit_it == mchit_index.end()) {
           // break if no matching hit found for this CellID
           warning("Proto-cluster has highest energy in CellID {}, but no mc hit with that CellID was found.", pclhit->getCellID());
           trace("Proto-cluster hits: ");
@@ -122,13 +158,14 @@ namespace eicrecon {
           }
           break;
         }
+        const auto mchit = (*mchits)[mchit_it->second];
 
         // 3. find mchit's MCParticle
-        const auto& mcp = mchit->getContributions(0).getParticle();
+        const auto& mcp = mchit.getContributions(0).getParticle();
 
         debug("cluster has largest energy in cellID: {}", pclhit->getCellID());
         debug("pcl hit with highest energy {} at index {}", pclhit->getEnergy(), pclhit->getObjectID().index);
-        debug("corresponding mc hit energy {} at index {}", mchit->getEnergy(), mchit->getObjectID().index);
+        debug("corresponding mc hit energy {} at index {}", mchit.getEnergy(), mchit.getObjectID().index);
         debug("from MCParticle index {}, PDG {}, {}", mcp.getObjectID().index, mcp.getPDG(), edm4hep::utils::magnitude(mcp.getMomentum()));
 
         // set association
@@ -145,7 +182,7 @@ namespace eicrecon {
 }
 
 //------------------------------------------------------------------------
-std::optional<edm4eic::MutableCluster> CalorimeterClusterRecoCoG::reconstruct(const edm4eic::ProtoCluster& pcl) const {
+std::optional<edm4eic::MutableCluster> CalorimeterClusterRecoCoG::reconstruct(const edm4eic::ProtoCluster& pcl, HitBuffer& buf) const {
   edm4eic::MutableCluster cl;
   cl.setNhits(pcl.hits_size());
 
@@ -156,27 +193,41 @@ std::optional<edm4eic::MutableCluster> CalorimeterClusterRecoCoG::reconstruct(co
     return {};
   }
 
+  // gather the hits once into contiguous arrays, all later passes run over these
+  const auto hits    = pcl.getHits();
+  const auto weights = pcl.getWeights();
+  const std::size_t n_hits = hits.size();
+  buf.resize(n_hits);
+
   // calculate total energy, find the cell with the maximum energy deposit
   float totalE = 0.;
   // Used to optionally constrain the cluster eta to those of the contributing hits
   float minHitEta = std::numeric_limits<float>::max();
   float maxHitEta = std::numeric_limits<float>::min();
-  auto time       = pcl.getHits()[0].getTime();
-  auto timeError  = pcl.getHits()[0].getTimeError();
-  for (unsigned i = 0; i < pcl.getHits().size(); ++i) {
-    const auto& hit   = pcl.getHits()[i];
-    const auto weight = pcl.getWeights()[i];
+  auto time       = hits[0].getTime();
+  auto timeError  = hits[0].getTimeError();
+  for (std::size_t i = 0; i < n_hits; ++i) {
+    const auto& hit   = hits[i];
+    const auto weight = weights[i];
     debug("hit energy = {} hit weight: {}", hit.getEnergy(), weight);
     auto energy = hit.getEnergy() * weight;
     totalE += energy;
     cl.addToHits(hit);
     cl.addToHitContributions(energy);
-    const float eta = edm4hep::utils::eta(hit.getPosition());
-    if (eta < minHitEta) {
-      minHitEta = eta;
-    }
-    if (eta > maxHitEta) {
-      maxHitEta = eta;
+    const auto& position = hit.getPosition();
+    buf.energy[i]   = hit.getEnergy();
+    buf.weighted[i] = energy;
+    buf.x[i]        = position.x;
+    buf.y[i]        = position.y;
+    buf.z[i]        = position.z;
+    if (m_cfg.enableEtaBounds) {
+      const float eta = edm4hep::utils::eta(position);
+      if (eta < minHitEta) {
+        minHitEta = eta;
+      }
+      if (eta > maxHitEta) {
+        maxHitEta = eta;
+      }
     }
   }
   cl.setEnergy(totalE / m_cfg.sampFrac);
@@ -197,13 +248,10 @@ std::optional<edm4eic::MutableCluster> CalorimeterClusterRecoCoG::reconstruct(co
     }
   }
 
-  for (unsigned i = 0; i < pcl.getHits().size(); ++i) {
-    const auto& hit   = pcl.getHits()[i];
-    const auto weight = pcl.getWeights()[i];
-    //      _DBG_<<" -- weight = " << weight << "  E=" << hit.getEnergy() << " totalE=" <<totalE << " log(E/totalE)=" << std::log(hit.getEnergy()/totalE) << std::endl;
-    float w           = weightFunc(hit.getEnergy() * weight, totalE, logWeightBase, 0);
-    tw += w;
-    v = v + (hit.getPosition() * w);
+  computeWeights(buf.weighted, totalE, logWeightBase, buf.w);
+  for (std::size_t i = 0; i < n_hits; ++i) {
+    tw += buf.w[i];
+    v = v + (edm4hep::Vector3f(buf.x[i], buf.y[i], buf.z[i]) * buf.w[i]);
   }
   if (tw == 0.) {
     warning("zero total weights encountered, you may want to adjust your weighting parameter.");
@@ -242,36 +290,50 @@ std::optional<edm4eic::MutableCluster> CalorimeterClusterRecoCoG::reconstruct(co
   //    x-y-z cluster widths (3D)
   float radius = 0, dispersion = 0, w_sum = 0;
 
-  Eigen::Matrix2f sum2_2D = Eigen::Matrix2f::Zero();
-  Eigen::Matrix3f sum2_3D = Eigen::Matrix3f::Zero();
-  Eigen::Vector2f sum1_2D = Eigen::Vector2f::Zero();
-  Eigen::Vector3f sum1_3D = Eigen::Vector3f::Zero();
-  Eigen::Vector2cf eigenValues_2D = Eigen::Vector2cf::Zero();
-  Eigen::Vector3cf eigenValues_3D = Eigen::Vector3cf::Zero();
+  std::array<double, 2> eigenValues_2D{0., 0.};
+  std::array<double, 3> eigenValues_3D{0., 0., 0.};
   //the axis is the direction of the eigenvalue corresponding to the largest eigenvalue.
   double axis_x=0, axis_y=0, axis_z=0;
   if (cl.getNhits() > 1) {
 
-    for (const auto& hit : pcl.getHits()) {
-
-      float w = weightFunc(hit.getEnergy(), totalE, logWeightBase, 0);
-
-      // theta, phi
-      Eigen::Vector2f pos2D( edm4hep::utils::anglePolar( hit.getPosition() ), edm4hep::utils::angleAzimuthal( hit.getPosition() ) );
-      // x, y, z
-      Eigen::Vector3f pos3D( hit.getPosition().x, hit.getPosition().y, hit.getPosition().z );
-
-      const auto delta = cl.getPosition() - hit.getPosition();
-      radius          += delta * delta;
-      dispersion      += delta * delta * w;
-
-      // Weighted Sum x*x, x*y, x*z, y*y, etc.
-      sum2_2D += w * pos2D * pos2D.transpose();
-      sum2_3D += w * pos3D * pos3D.transpose();
+    // moments are weighted with the unweighted hit energies
+    computeWeights(buf.energy, totalE, logWeightBase, buf.w);
+    for (std::size_t i = 0; i < n_hits; ++i) {
+      const edm4hep::Vector3f position(buf.x[i], buf.y[i], buf.z[i]);
+      buf.theta[i] = edm4hep::utils::anglePolar(position);
+      buf.phi[i]   = edm4hep::utils::angleAzimuthal(position);
+    }
 
-      // Weighted Sum x, y, z
-      sum1_2D += w * pos2D;
-      sum1_3D += w * pos3D;
+    // Weighted sums of theta, phi and x, y, z, and of their products
+    const auto cl_position = cl.getPosition();
+    float s_t = 0, s_p = 0, s_tt = 0, s_tp = 0, s_pp = 0;
+    float s_x = 0, s_y = 0, s_z = 0, s_xx = 0, s_yy = 0, s_zz = 0, s_xy = 0, s_xz = 0, s_yz = 0;
+    for (std::size_t i = 0; i < n_hits; ++i) {
+      const float w = buf.w[i];
+      const float dx = cl_position.x - buf.x[i];
+      const float dy = cl_position.y - buf.y[i];
+      const float dz = cl_position.z - buf.z[i];
+      const float d2 = dx * dx + dy * dy + dz * dz;
+      radius     += d2;
+      dispersion += d2 * w;
+
+      const float wt = w * buf.theta[i], wp = w * buf.phi[i];
+      s_t  += wt;
+      s_p  += wp;
+      s_tt += wt * buf.theta[i];
+      s_tp += wt * buf.phi[i];
+      s_pp += wp * buf.phi[i];
+
+      const float wx = w * buf.x[i], wy = w * buf.y[i], wz = w * buf.z[i];
+      s_x  += wx;
+      s_y  += wy;
+      s_z  += wz;
+      s_xx += wx * buf.x[i];
+      s_yy += wy * buf.y[i];
+      s_zz += wz * buf.z[i];
+      s_xy += wx * buf.y[i];
+      s_xz += wx * buf.z[i];
+      s_yz += wy * buf.z[i];
 
       w_sum += w;
     }
@@ -280,55 +342,41 @@ std::optional<edm4eic::MutableCluster> CalorimeterClusterRecoCoG::reconstruct(co
     if( w_sum > 0 ) {
       dispersion = sqrt( dispersion / w_sum );
 
-      // normalize matrices
-      sum2_2D /= w_sum;
-      sum2_3D /= w_sum;
-      sum1_2D /= w_sum;
-      sum1_3D /= w_sum;
+      // normalized first moments
+      const float m_t = s_t / w_sum, m_p = s_p / w_sum;
+      const float m_x = s_x / w_sum, m_y = s_y / w_sum, m_z = s_z / w_sum;
 
       // 2D and 3D covariance matrices
-      Eigen::Matrix2f cov2 = sum2_2D - sum1_2D * sum1_2D.transpose();
-      Eigen::Matrix3f cov3 = sum2_3D - sum1_3D * sum1_3D.transpose();
+      const double cov_tt = s_tt / w_sum - m_t * m_t;
+      const double cov_pp = s_pp / w_sum - m_p * m_p;
+      const double cov_tp = s_tp / w_sum - m_t * m_p;
+      const symmetric_eigen::Matrix3 cov3{
+        s_xx / w_sum - m_x * m_x,
+        s_yy / w_sum - m_y * m_y,
+        s_zz / w_sum - m_z * m_z,
+        s_xy / w_sum - m_x * m_y,
+        s_xz / w_sum - m_x * m_z,
+        s_yz / w_sum - m_y * m_z,
+      };
 
       // Solve for eigenvalues.  Corresponds to cluster's 2nd moments (widths)
-      Eigen::EigenSolver<Eigen::Matrix2f> es_2D(cov2, false); // set to true for eigenvector calculation
-      Eigen::EigenSolver<Eigen::Matrix3f> es_3D(cov3, true); // set to true for eigenvector calculation
-
-      // eigenvalues of symmetric real matrix are always real
-      eigenValues_2D = es_2D.eigenvalues();
-      eigenValues_3D = es_3D.eigenvalues();
+      eigenValues_2D = symmetric_eigen::eigenvalues(cov_tt, cov_pp, cov_tp);
+      eigenValues_3D = symmetric_eigen::eigenvalues(cov3);
       //find the eigenvector corresponding to the largest eigenvalue
-      auto eigenvectors= es_3D.eigenvectors();
-      auto max_eigenvalue_it = std::max_element(
-        eigenValues_3D.begin(),
-        eigenValues_3D.end(),
-        [](auto a, auto b) {
-            return std::real(a) < std::real(b);
-        }
-      );
-      auto axis = eigenvectors.col(std::distance(
-            eigenValues_3D.begin(),
-            max_eigenvalue_it
-        ));
-      axis_x=axis(0,0).real();
-      axis_y=axis(1,0).real();
-      axis_z=axis(2,0).real();
-      double norm=sqrt(axis_x*axis_x+axis_y*axis_y+axis_z*axis_z);
-      if (norm!=0){
-        axis_x/=norm;
-        axis_y/=norm;
-        axis_z/=norm;
-      }
+      const auto axis = symmetric_eigen::eigenvector(cov3, eigenValues_3D[2]);
+      axis_x=axis[0];
+      axis_y=axis[1];
+      axis_z=axis[2];
     }
   }
 
   cl.addToShapeParameters( radius );
   cl.addToShapeParameters( dispersion );
-  cl.addToShapeParameters( eigenValues_2D[0].real() ); // 2D theta-phi cluster width 1
-  cl.addToShapeParameters( eigenValues_2D[1].real() ); // 2D theta-phi cluster width 2
-  cl.addToShapeParameters( eigenValues_3D[0].real() ); // 3D x-y-z cluster width 1
-  cl.addToShapeParameters( eigenValues_3D[1].real() ); // 3D x-y-z cluster width 2
-  cl.addToShapeParameters( eigenValues_3D[2].real() ); // 3D x-y-z cluster width 3
+  cl.addToShapeParameters( eigenValues_2D[0] ); // 2D theta-phi cluster width 1
+  cl.addToShapeParameters( eigenValues_2D[1] ); // 2D theta-phi cluster width 2
+  cl.addToShapeParameters( eigenValues_3D[0] ); // 3D x-y-z cluster width 1
+  cl.addToShapeParameters( eigenValues_3D[1] ); // 3D x-y-z cluster width 2
+  cl.addToShapeParameters( eigenValues_3D[2] ); // 3D x-y-z cluster width 3
   //last 3 shape parameters are the components of the axis direction
   cl.addToShapeParameters( axis_x );
   cl.addToShapeParameters( axis_y );
@@ -17,13 +17,18 @@
 #include <edm4hep/SimCalorimeterHitCollection.h>
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "CalorimeterClusterRecoCoGConfig.h"
 #include "algorithms/interfaces/WithPodConfig.h"
@@ -76,11 +81,37 @@ namespace eicrecon {
 
     void process(const Input&, const Output&) const final;
 
+    /// Several proto-cluster collections, `outputs[i]` are the clusters of `inputs[i]`,
+    /// e.g. the truth and the island clusters of a detector. The inputs with the same
+    /// mcHits, one after the other, share the index of the mcHits by CellID
+    void process(std::span<const Input> inputs, std::span<const Output> outputs) const;
+
   private:
     std::function<double(double, double, double, int)> weightFunc;
+    // log weights with fast_math::log, when singlePrecision is set
+    bool m_fastLogWeights{false};
 
   private:
-    std::optional<edm4eic::MutableCluster> reconstruct(const edm4eic::ProtoCluster& pcl) const;
+    // per-hit quantities of a cluster in contiguous arrays
+    struct HitBuffer {
+      std::vector<float> energy, weighted, w, x, y, z, theta, phi;
+
+      void resize(std::size_t n) {
+        for (auto* v : {&energy, &weighted, &w, &x, &y, &z, &theta, &phi}) {
+          v->resize(n);
+        }
+      }
+    };
+
+    /// Weights of the hit energies `energy` for a cluster energy `totalE`
+    void computeWeights(std::span<const float> energy, float totalE, double logWeightBase, std::span<float> w) const;
+
+    std::optional<edm4eic::MutableCluster> reconstruct(const edm4eic::ProtoCluster& pcl, HitBuffer& buf) const;
+
+    /// Without mchits or associations, i.e. either is nullptr, the clusters are not associated
+    void reconstructCollection(const edm4eic::ProtoClusterCollection& proto, const edm4hep::SimCalorimeterHitCollection* mchits,
+                               const std::unordered_map<uint64_t, std::size_t>& mchit_index, HitBuffer& hit_buffer,
+                               edm4eic::ClusterCollection& clusters, edm4eic::MCRecoClusterParticleAssociationCollection* associations) const;
   };
 
 } // eicrecon
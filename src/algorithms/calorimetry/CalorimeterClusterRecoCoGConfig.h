@@ -28,6 +28,14 @@ namespace eicrecon {
         // for endcaps.
         bool enableEtaBounds = false;
 
+        // Compute the logarithmic weights in single precision with fast_math::log
+        // (FastLog.h), in loops that vectorise, instead of the double precision
+        // std::log of the weighting functions
+        bool singlePrecision = false;
+
+        // identical wirings are merged, see omnifactory:MergeIdenticalWirings
+        bool operator==(const CalorimeterClusterRecoCoGConfig&) const = default;
+
     };
 
 } // eicrecon
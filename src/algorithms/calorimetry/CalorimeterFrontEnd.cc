@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "CalorimeterFrontEnd.h"
+
+#include <gsl/pointers>
+#include <string>
+
+namespace eicrecon {
+
+void CalorimeterFrontEnd::init() {
+
+    const std::string prefix{name()};
+
+    m_digi = std::make_unique<CalorimeterHitDigi>(prefix + ":digi");
+    m_digi->level(level());
+    m_digi->applyConfig(m_cfg.digi);
+    m_digi->init();
+
+    auto reco_cfg = m_cfg.reco;
+    if (reco_cfg.readout.empty()) {
+        reco_cfg.readout = m_cfg.digi.readout;
+    }
+    // the merger looks up the merged cells
+    reco_cfg.cellGeometry = m_cfg.merge.fields.empty();
+    m_reco = std::make_unique<CalorimeterHitReco>(prefix + ":reco");
+    m_reco->level(level());
+    m_reco->applyConfig(reco_cfg);
+    m_reco->init();
+
+    if (!m_cfg.merge.fields.empty()) {
+        auto merge_cfg = m_cfg.merge;
+        if (merge_cfg.readout.empty()) {
+            merge_cfg.readout = m_cfg.digi.readout;
+        }
+        m_merger = std::make_unique<CalorimeterHitsMerger>(prefix + ":merge");
+        m_merger->level(level());
+        m_merger->applyConfig(merge_cfg);
+        m_merger->init();
+    }
+}
+
+void CalorimeterFrontEnd::process(
+      const CalorimeterFrontEnd::Input& input,
+      const CalorimeterFrontEnd::Output& output) const {
+
+    const auto [headers, sim_hits] = input;
+    auto [hits, raw_hits] = output;
+
+    if (raw_hits == nullptr) {
+        m_raw_hits.clear();
+        raw_hits = &m_raw_hits;
+    }
+    m_digi->process({headers, sim_hits}, {raw_hits});
+
+    if (!m_merger) {
+        m_reco->process({raw_hits}, {hits});
+        return;
+    }
+    m_rec_hits.clear();
+    m_reco->process({raw_hits}, {&m_rec_hits});
+    m_merger->process({&m_rec_hits}, {hits});
+}
+
+} // namespace eicrecon
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <algorithms/algorithm.h>
+#include <edm4eic/CalorimeterHitCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
+#include <edm4hep/RawCalorimeterHitCollection.h>
+#include <edm4hep/SimCalorimeterHitCollection.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "CalorimeterFrontEndConfig.h"
+#include "CalorimeterHitDigi.h"
+#include "CalorimeterHitReco.h"
+#include "CalorimeterHitsMerger.h"
+#include "algorithms/interfaces/WithPodConfig.h"
+
+namespace eicrecon {
+
+  using CalorimeterFrontEndAlgorithm = algorithms::Algorithm<
+    algorithms::Input<
+      edm4hep::EventHeaderCollection,
+      edm4hep::SimCalorimeterHitCollection
+    >,
+    algorithms::Output<
+      edm4eic::CalorimeterHitCollection,
+      std::optional<edm4hep::RawCalorimeterHitCollection>
+    >
+  >;
+
+  /**
+   * CalorimeterHitDigi followed by CalorimeterHitReco and, if merge.fields are
+   * set, CalorimeterHitsMerger, from the sim hits to the hits for the clustering.
+   *
+   * The intermediate hits that are not an output are kept in collections of the
+   * algorithm that are reused for every event. With merging, the position and
+   * dimensions of a cell are only looked up for the merged cells: the hits
+   * before the merging come without them (CalorimeterHitRecoConfig::cellGeometry),
+   * which gives the same merged hits as the three algorithms one after the other.
+   */
+  class CalorimeterFrontEnd
+  : public CalorimeterFrontEndAlgorithm,
+    public WithPodConfig<CalorimeterFrontEndConfig> {
+
+  public:
+    CalorimeterFrontEnd(std::string_view name)
+      : CalorimeterFrontEndAlgorithm{name,
+                            {"eventHeaderCollection", "inputHitCollection"},
+                            {"outputHitCollection", "outputRawHitCollection"},
+                            "Digitize, reconstruct and optionally merge the hits of a calorimeter."} {}
+
+    void init() final;
+    void process(const Input&, const Output&) const final;
+
+  private:
+    std::unique_ptr<CalorimeterHitDigi> m_digi;
+    std::unique_ptr<CalorimeterHitReco> m_reco;
+    std::unique_ptr<CalorimeterHitsMerger> m_merger;
+
+    // the intermediate hits, kept across the events (an algorithm instance is
+    // only used by one thread at a time)
+    mutable edm4hep::RawCalorimeterHitCollection m_raw_hits;
+    mutable edm4eic::CalorimeterHitCollection m_rec_hits;
+
+  };
+
+} // namespace eicrecon
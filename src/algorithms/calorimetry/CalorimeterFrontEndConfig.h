@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include "algorithms/calorimetry/CalorimeterHitDigiConfig.h"
+#include "algorithms/calorimetry/CalorimeterHitRecoConfig.h"
+#include "algorithms/calorimetry/CalorimeterHitsMergerConfig.h"
+
+namespace eicrecon {
+
+  struct CalorimeterFrontEndConfig {
+    CalorimeterHitDigiConfig    digi;
+    // the readouts of reco and merge default to the one of digi
+    CalorimeterHitRecoConfig    reco;
+    CalorimeterHitsMergerConfig merge; // no merging if there are no fields
+  };
+
+} // eicrecon
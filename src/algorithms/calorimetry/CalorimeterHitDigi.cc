@@ -6,6 +6,8 @@
 // 2. Digitize the energy with dynamic ADC range and add pedestal (mean +- sigma)
 // 3. Time conversion with smearing resolution (absolute value)
 // 4. Signal is summed if the SumFields are provided
+// 5. Optionally, the contributions are summed as sampled pulses, whose peak gives the amplitude and time
+// 6. Cells below the zero suppression threshold are dropped
 //
 // Author: Chao Peng
 // Date: 06/02/2021
@@ -23,18 +25,19 @@
 #include <edm4hep/CaloHitContributionCollection.h>
 #include <fmt/core.h>
 #include <podio/RelationRange.h>
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <gsl/pointers>
 #include <limits>
 #include <stdexcept>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "HitGroups.h"
 #include "algorithms/calorimetry/CalorimeterHitDigiConfig.h"
-#include "services/evaluator/EvaluatorSvc.h"
+#include "algorithms/interfaces/LogMacros.h"
 
 using namespace dd4hep;
 
@@ -43,7 +46,6 @@ namespace eicrecon {
 //
 // TODO:
 // - Array type configuration parameters are not yet supported in JANA (needs to be added)
-// - Random number service needs to bew resolved (on global scale)
 // - It is possible standard running of this with Gaudi relied on a number of parameters
 //   being set in the config. If that is the case, they should be moved into the default
 //   values here. This needs to be confirmed.
@@ -51,19 +53,10 @@ namespace eicrecon {
 
 void CalorimeterHitDigi::init() {
 
-    // Gaudi implements a random number generator service. It is not clear to me how this
-    // can work. There are multiple race conditions that occur in parallel event processing:
-    // 1. The exact same events processed by a given thread in one invocation will not
-    //    necessarily be the combination of events any thread sees in a subsequent
-    //    invocation. Thus, you can't rely on thread_local storage.
-    // 2. Its possible for the factory execution order to be modified by the presence of
-    //    a processor (e.g. monitoring plugin). This is not as serious since changing the
-    //    command line should cause one not to expect reproducibility. Still, one may
-    //    expect the inclusion of an "observer" plugin not to have such side affects.
-    //
-    // More information will be needed. In the meantime, we implement a local random number
-    // generator. Ideally, this would be seeded with the run number+event number, but for
-    // now, just use default values defined in header file.
+    // Random numbers are drawn from per-cell streams keyed on the run and event
+    // numbers, so the results do not depend on the event processing order
+    auto& serviceSvc = algorithms::ServiceSvc::instance();
+    m_random = serviceSvc.service<CounterRandomSvc>("CounterRandomSvc");
 
     // set energy resolution numbers
     if (m_cfg.eRes.empty()) {
@@ -77,6 +70,13 @@ void CalorimeterHitDigi::init() {
     tRes       = m_cfg.tRes / dd4hep::ns;
     stepTDC    = dd4hep::ns / m_cfg.resolutionTDC;
 
+    // zero suppression relative to the pedestal
+    thresholdADC = 0;
+    if (m_cfg.zeroSuppressionFactor != 0 || m_cfg.zeroSuppressionValue != 0) {
+        thresholdADC = m_cfg.pedMeanADC + m_cfg.zeroSuppressionFactor * m_cfg.pedSigmaADC + m_cfg.zeroSuppressionValue;
+        debug("Zero suppression of the cells with ADC < {}", thresholdADC);
+    }
+
     // sanity checks
     if (m_cfg.readout.empty()) {
         error("readoutClass is not provided, it is needed to know the fields in readout ids");
@@ -104,19 +104,59 @@ void CalorimeterHitDigi::init() {
     }
     id_mask = ~id_inverse_mask;
 
-    std::function hit_to_map = [this](const edm4hep::SimCalorimeterHit &h) {
-      std::unordered_map<std::string, double> params;
-      for(const auto &p : id_spec.fields()) {
-        const std::string &name = p.first;
-        const dd4hep::IDDescriptor::Field* field = p.second;
-        params.emplace(name, field->value(h.getCellID()));
-        trace("{} = {}", name, field->value(h.getCellID()));
-      }
-      return params;
-    };
+    corrMeanScale.init(m_cfg.corrMeanScale, id_spec);
 
-    auto& serviceSvc = algorithms::ServiceSvc::instance();
-    corrMeanScale = serviceSvc.service<EvaluatorSvc>("EvaluatorSvc")->compile(m_cfg.corrMeanScale, hit_to_map);
+    // pulse templates, one per start time within a clock cycle, sampled from the
+    // start of the cycle over the window of the digitizer
+    if (!m_cfg.pulseShape.empty()) {
+        if (m_cfg.pulseShape != "CRRC") {
+            error("Unknown pulseShape \"{}\", expected \"CRRC\"", m_cfg.pulseShape);
+            throw std::runtime_error(fmt::format("Unknown pulseShape \"{}\"", m_cfg.pulseShape));
+        }
+        if (!(m_cfg.pulseShapeTau > 0 && m_cfg.pulseShapeOrder > 0 && m_cfg.samplingInterval > 0
+              && m_cfg.nSamples > 0 && m_cfg.pulseTemplatePhases > 0)) {
+            error("Invalid pulse shape configuration");
+            throw std::runtime_error("Invalid pulse shape configuration");
+        }
+        const double tau = m_cfg.pulseShapeTau / dd4hep::ns;
+        const double dt  = m_cfg.samplingInterval / dd4hep::ns;
+        const double n   = m_cfg.pulseShapeOrder;
+        m_peakTime = n * tau;
+        m_templates.resize(std::size_t{m_cfg.pulseTemplatePhases} * m_cfg.nSamples);
+        for (std::size_t phase = 0; phase < m_cfg.pulseTemplatePhases; ++phase) {
+            const double start = dt * phase / m_cfg.pulseTemplatePhases;
+            for (std::size_t j = 0; j < m_cfg.nSamples; ++j) {
+                const double t = j * dt - start;
+                m_templates[phase * m_cfg.nSamples + j] =
+                    (t > 0) ? std::pow(t / m_peakTime, n) * std::exp(n - t / tau) : 0;
+            }
+        }
+        debug("Pulse templates of {} phases and {} samples, peaking at {} ns",
+              m_cfg.pulseTemplatePhases, m_cfg.nSamples, m_peakTime);
+    }
+}
+
+
+std::pair<double, double> CalorimeterHitDigi::peak(const float* samples) const {
+    const std::size_t n = m_cfg.nSamples;
+    std::size_t imax = 0;
+    for (std::size_t j = 1; j < n; ++j) {
+        imax = (samples[j] > samples[imax]) ? j : imax;
+    }
+
+    // parabola through the maximum and its neighbours
+    double amplitude = samples[imax];
+    double offset    = 0;
+    if (imax > 0 && imax + 1 < n) {
+        const double left  = samples[imax - 1];
+        const double right = samples[imax + 1];
+        const double curvature = left - 2 * amplitude + right;
+        if (curvature < 0) {
+            offset    = 0.5 * (left - right) / curvature;
+            amplitude -= 0.25 * (left - right) * offset;
+        }
+    }
+    return {amplitude, (imax + offset) * (m_cfg.samplingInterval / dd4hep::ns) - m_peakTime};
 }
 
 
@@ -124,26 +164,94 @@ void CalorimeterHitDigi::process(
       const CalorimeterHitDigi::Input& input,
       const CalorimeterHitDigi::Output& output) const {
 
-    const auto [simhits] = input;
+    const auto [headers, simhits] = input;
     auto [rawhits] = output;
 
+    const auto& header = headers->at(0);
+    const auto random_key = m_random->key(name(), header.getRunNumber(), header.getEventNumber());
+
     // find the hits that belong to the same group (for merging)
-    std::unordered_map<uint64_t, std::vector<std::size_t>> merge_map;
-    std::size_t ix = 0;
-    for (const auto &ahit : *simhits) {
+    HitGroups merge_groups;
+    merge_groups.build(*simhits, [this](const auto& ahit) {
         uint64_t hid = ahit.getCellID() & id_mask;
 
-        trace("org cell ID in {:s}: {:#064b}", m_cfg.readout, ahit.getCellID());
-        trace("new cell ID in {:s}: {:#064b}", m_cfg.readout, hid);
+        EICRECON_TRACE("org cell ID in {:s}: {:#064b}", m_cfg.readout, ahit.getCellID());
+        EICRECON_TRACE("new cell ID in {:s}: {:#064b}", m_cfg.readout, hid);
+
+        return hid;
+    });
 
-        merge_map[hid].push_back(ix);
+    if (!m_cfg.pulseShape.empty()) {
+        const std::size_t n  = m_cfg.nSamples;
+        const double      dt = m_cfg.samplingInterval / dd4hep::ns;
+        m_samples.assign(merge_groups.size() * n, 0.f);
 
-        ix++;
+        // 1. Sum the pulses of the contributions of each cell
+        std::vector<std::size_t> leading(merge_groups.size());
+        for (std::size_t g = 0; g < merge_groups.size(); ++g) {
+            const auto ixs = merge_groups[g].indices;
+            float* samples = m_samples.data() + g * n;
+            double max_edep = -1;
+            for (const auto ix : ixs) {
+                const auto hit = (*simhits)[ix];
+                if (hit.getEnergy() > max_edep) {
+                    max_edep   = hit.getEnergy();
+                    leading[g] = ix;
+                }
+                for (const auto& c : hit.getContributions()) {
+                    const double clock = c.getTime() / dt;
+                    if (!(clock >= 0 && clock < n)) {
+                        continue;
+                    }
+                    const auto first = static_cast<std::size_t>(clock);
+                    const auto phase = std::min<std::size_t>(static_cast<std::size_t>((clock - first) * m_cfg.pulseTemplatePhases), m_cfg.pulseTemplatePhases - 1);
+                    const float* pulse = m_templates.data() + phase * n;
+                    const float  energy = c.getEnergy();
+                    for (std::size_t j = 0; j < n - first; ++j) {
+                        samples[first + j] += energy * pulse[j];
+                    }
+                }
+            }
+        }
+
+        // 2. Amplitude and time at the peak of every cell
+        for (std::size_t g = 0; g < merge_groups.size(); ++g) {
+            const auto [edep, time] = peak(m_samples.data() + g * n);
+            if (!(edep > 0)) {
+                continue;
+            }
+            const auto leading_hit = (*simhits)[leading[g]];
+            auto rng = m_random->generator(random_key, leading_hit.getCellID());
+
+            const double eResRel = (edep > m_cfg.threshold)
+                ? rng.gaussian() * std::sqrt(
+                     std::pow(m_cfg.eRes[0] / std::sqrt(edep), 2) +
+                     std::pow(m_cfg.eRes[1], 2) +
+                     std::pow(m_cfg.eRes[2] / (edep), 2)
+                  )
+                : 0;
+            double    corrMeanScale_value = corrMeanScale(leading_hit.getCellID());
+            double    ped     = m_cfg.pedMeanADC + rng.gaussian() * m_cfg.pedSigmaADC;
+            unsigned long long adc     = std::llround(ped + edep * corrMeanScale_value * ( 1.0 + eResRel) / m_cfg.dyRangeADC * m_cfg.capADC);
+            unsigned long long tdc     = std::llround((time + rng.gaussian() * tRes) * stepTDC);
+
+            EICRECON_TRACE("pulse peak {} \t adc: {} \t time: {} \t tdc: {}", edep, adc, time, tdc);
+            if (adc < thresholdADC) {
+                EICRECON_TRACE("adc {} below the zero suppression threshold", adc);
+                continue;
+            }
+            rawhits->create(
+                    leading_hit.getCellID(),
+                    (adc > m_cfg.capADC ? m_cfg.capADC : adc),
+                    tdc
+            );
+        }
+        return;
     }
 
     // signal sum
     // NOTE: we take the cellID of the most energetic hit in this group so it is a real cellID from an MC hit
-    for (const auto &[id, ixs] : merge_map) {
+    for (const auto &[id, ixs] : merge_groups) {
         double edep     = 0;
         double time     = std::numeric_limits<double>::max();
         double max_edep = 0;
@@ -160,7 +268,7 @@ void CalorimeterHitDigi::process(
             }
             if (timeC > m_cfg.capTime) continue;
             edep += hit.getEnergy();
-            trace("adding {} \t total: {}", hit.getEnergy(), edep);
+            EICRECON_TRACE("adding {} \t total: {}", hit.getEnergy(), edep);
 
             // change maximum hit energy & time if necessary
             if (hit.getEnergy() > max_edep) {
@@ -173,20 +281,26 @@ void CalorimeterHitDigi::process(
         }
         if (time > m_cfg.capTime) continue;
 
+        auto rng = m_random->generator(random_key, leading_hit.getCellID());
+
         // safety check
         const double eResRel = (edep > m_cfg.threshold)
-                ? m_gaussian(m_generator) * std::sqrt(
+                ? rng.gaussian() * std::sqrt(
                      std::pow(m_cfg.eRes[0] / std::sqrt(edep), 2) +
                      std::pow(m_cfg.eRes[1], 2) +
                      std::pow(m_cfg.eRes[2] / (edep), 2)
                   )
                 : 0;
-        double    corrMeanScale_value = corrMeanScale(leading_hit);
-        double    ped     = m_cfg.pedMeanADC + m_gaussian(m_generator) * m_cfg.pedSigmaADC;
+        double    corrMeanScale_value = corrMeanScale(leading_hit.getCellID());
+        double    ped     = m_cfg.pedMeanADC + rng.gaussian() * m_cfg.pedSigmaADC;
         unsigned long long adc     = std::llround(ped + edep * corrMeanScale_value * ( 1.0 + eResRel) / m_cfg.dyRangeADC * m_cfg.capADC);
-        unsigned long long tdc     = std::llround((time + m_gaussian(m_generator) * tRes) * stepTDC);
+        unsigned long long tdc     = std::llround((time + rng.gaussian() * tRes) * stepTDC);
 
-        if (edep> 1.e-3) trace("E sim {} \t adc: {} \t time: {}\t maxtime: {} \t tdc: {} \t corrMeanScale: {}", edep, adc, time, m_cfg.capTime, tdc, corrMeanScale_value);
+        if (edep> 1.e-3) EICRECON_TRACE("E sim {} \t adc: {} \t time: {}\t maxtime: {} \t tdc: {} \t corrMeanScale: {}", edep, adc, time, m_cfg.capTime, tdc, corrMeanScale_value);
+        if (adc < thresholdADC) {
+            EICRECON_TRACE("adc {} below the zero suppression threshold", adc);
+            continue;
+        }
         rawhits->create(
                 leading_hit.getCellID(),
                 (adc > m_cfg.capADC ? m_cfg.capADC : adc),
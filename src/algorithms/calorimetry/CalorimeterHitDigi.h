@@ -6,6 +6,8 @@
 // 2. Digitize the energy with dynamic ADC range and add pedestal (mean +- sigma)
 // 3. Time conversion with smearing resolution (absolute value)
 // 4. Signal is summed if the SumFields are provided
+// 5. Optionally, the contributions are summed as sampled pulses, whose peak gives the amplitude and time
+// 6. Cells below the zero suppression threshold are dropped
 //
 // Author: Chao Peng
 // Date: 06/02/2021
@@ -16,21 +18,26 @@
 #include <algorithms/algorithm.h>
 #include <algorithms/geo.h>
 #include <DD4hep/IDDescriptor.h>
+#include <edm4hep/EventHeaderCollection.h>
 #include <edm4hep/RawCalorimeterHitCollection.h>
 #include <edm4hep/SimCalorimeterHitCollection.h>
-#include <random>
 #include <stdint.h>
 #include <string>
 #include <string_view>
 #include <functional>
+#include <utility>
+#include <vector>
 
 #include "CalorimeterHitDigiConfig.h"
+#include "ReadoutExpression.h"
+#include "algorithms/interfaces/CounterRandomSvc.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 
 namespace eicrecon {
 
   using CalorimeterHitDigiAlgorithm = algorithms::Algorithm<
     algorithms::Input<
+      edm4hep::EventHeaderCollection,
       edm4hep::SimCalorimeterHitCollection
     >,
     algorithms::Output<
@@ -45,7 +52,7 @@ namespace eicrecon {
   public:
     CalorimeterHitDigi(std::string_view name)
       : CalorimeterHitDigiAlgorithm{name,
-                            {"inputHitCollection"},
+                            {"eventHeaderCollection", "inputHitCollection"},
                             {"outputRawHitCollection"},
                             "Smear energy deposit, digitize within ADC range, add pedestal, "
                             "convert time with smearing resolution, and sum signals."} {}
@@ -58,17 +65,30 @@ namespace eicrecon {
     // unitless counterparts of inputs
     double           dyRangeADC{0}, stepTDC{0}, tRes{0};
 
+    // lowest ADC of a written cell, 0 without zero suppression
+    double           thresholdADC{0};
+
     uint64_t         id_mask{0};
 
-    std::function<double(const edm4hep::SimCalorimeterHit &h)> corrMeanScale;
+    ReadoutExpression corrMeanScale;
 
     dd4hep::IDDescriptor id_spec;
 
+    // pulse templates of the phases, nSamples each, and the time of their peak in ns
+    std::vector<float> m_templates;
+    double m_peakTime{0};
+
+    // sums of the pulses of the cells, nSamples each, kept across the events (an
+    // algorithm instance is only used by one thread at a time)
+    mutable std::vector<float> m_samples;
+
+    /// Peak amplitude, and its time in ns of the pulses of a cell
+    std::pair<double, double> peak(const float* samples) const;
+
   private:
     const algorithms::GeoSvc& m_geo = algorithms::GeoSvc::instance();
 
-    mutable std::default_random_engine m_generator;
-    mutable std::normal_distribution<double> m_gaussian;
+    const CounterRandomSvc* m_random{nullptr};
 
   };
 
@@ -25,6 +25,23 @@ namespace eicrecon {
     double                   resolutionTDC{1};
     std::string              corrMeanScale{"1.0"};
 
+    // zero suppression, cells with an ADC below pedMeanADC + zeroSuppressionFactor *
+    // pedSigmaADC + zeroSuppressionValue are not written, off if both are zero
+    double                   zeroSuppressionFactor{0};
+    double                   zeroSuppressionValue{0};
+
+    // pulse shape digitization, off if empty, otherwise "CRRC" for the pulses
+    // (t/(n*tau))^n * exp(n - t/tau) of a CR-(RC)^n shaper, sampled at the clock
+    // of the digitizer and summed per cell, the amplitude and the time are taken
+    // at the peak of the sum
+    std::string              pulseShape{""};
+    double                   pulseShapeTau{5 * dd4hep::ns};
+    unsigned int             pulseShapeOrder{2};
+    double                   samplingInterval{1 * dd4hep::ns};
+    unsigned int             nSamples{64};
+    // start times of the pulses within a clock cycle that have their own template
+    unsigned int             pulseTemplatePhases{16};
+
     // signal sums
     std::string              readout{""};
     std::vector<std::string> fields{};
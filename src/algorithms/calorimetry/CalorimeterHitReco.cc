@@ -29,12 +29,11 @@
 #include <map>
 #include <ostream>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "algorithms/calorimetry/CalorimeterHitRecoConfig.h"
-#include "services/evaluator/EvaluatorSvc.h"
+#include "services/geometry/cellid_cache/CellIDGeometryCacheSvc.h"
 
 using namespace dd4hep;
 
@@ -42,6 +41,9 @@ namespace eicrecon {
 
 void CalorimeterHitReco::init() {
 
+    auto& serviceSvc = algorithms::ServiceSvc::instance();
+    m_geo_cache = serviceSvc.service<CellIDGeometryCacheSvc>("CellIDGeometryCacheSvc");
+
     // threshold for firing
     // Should set either m_cfg.thresholdFactor or m_cfg.thresholdValue, not both
     if ( m_cfg.thresholdFactor * m_cfg.thresholdValue != 0 ){
@@ -68,6 +70,7 @@ void CalorimeterHitReco::init() {
     // Next, try and get the readout fields. This will throw a different exception.
     try {
         id_dec = id_spec.decoder();
+        id_fields = CellIDFieldDecoder::allFields(*id_dec);
         if (!m_cfg.sectorField.empty()) {
             sector_idx = id_dec->index(m_cfg.sectorField);
             debug("Find sector field {}, index = {}", m_cfg.sectorField, sector_idx);
@@ -110,19 +113,7 @@ void CalorimeterHitReco::init() {
 
     id_spec = m_detector->readout(m_cfg.readout).idSpec();
 
-    std::function hit_to_map = [this](const edm4hep::RawCalorimeterHit &h) {
-      std::unordered_map<std::string, double> params;
-      for(const auto &p : id_spec.fields()) {
-        const std::string &name = p.first;
-        const dd4hep::IDDescriptor::Field* field = p.second;
-        params.emplace(name, field->value(h.getCellID()));
-        trace("{} = {}", name, field->value(h.getCellID()));
-      }
-      return params;
-    };
-
-    auto& serviceSvc = algorithms::ServiceSvc::instance();
-    sampFrac = serviceSvc.service<EvaluatorSvc>("EvaluatorSvc")->compile(m_cfg.sampFrac, hit_to_map);
+    sampFrac.init(m_cfg.sampFrac, id_spec);
 
     // local detector name has higher priority
     if (!m_cfg.localDetElement.empty()) {
@@ -164,6 +155,18 @@ void CalorimeterHitReco::process(
     // error is detector.
     if (NcellIDerrors >= MaxCellIDerrors) return;
 
+    // Error looking up cellID. Messages should already have been printed.
+    // Also, see comment at top of this method.
+    auto cellID_error = [this](uint64_t cellID) {
+        if (++NcellIDerrors >= MaxCellIDerrors) {
+            error("Maximum number of errors reached: {}", MaxCellIDerrors);
+            error("This is likely an issue with the cellID being unknown.");
+            error("Note: local_mask={:X} example cellID={:x}", local_mask, cellID);
+            error("Disabling this algorithm since it requires a valid cellID.");
+            error("(See {}:{})", __FILE__,__LINE__);
+        }
+    };
+
     for (const auto &rh: *rawhits) {
 
         //did not pass the zero-suppresion threshold
@@ -174,27 +177,45 @@ void CalorimeterHitReco::process(
 
         // get layer and sector ID
         const int lid =
-                id_dec != nullptr && !m_cfg.layerField.empty() ? static_cast<int>(id_dec->get(cellID, layer_idx)) : -1;
+                id_dec != nullptr && !m_cfg.layerField.empty() ? static_cast<int>(id_fields.get(cellID, layer_idx)) : -1;
         const int sid =
-                id_dec != nullptr && !m_cfg.sectorField.empty() ? static_cast<int>(id_dec->get(cellID, sector_idx)) : -1;
+                id_dec != nullptr && !m_cfg.sectorField.empty() ? static_cast<int>(id_fields.get(cellID, sector_idx)) : -1;
 
         // convert ADC to energy
-        float sampFrac_value = sampFrac(rh);
+        float sampFrac_value = sampFrac(rh.getCellID());
         float energy = (((signed) rh.getAmplitude() - (signed) m_cfg.pedMeanADC)) / static_cast<float>(m_cfg.capADC) * m_cfg.dyRangeADC /
                 sampFrac_value;
 
         const float time = rh.getTimeStamp() / stepTDC;
         trace("cellID {}, \t energy: {},  TDC: {}, time: {}, sampFrac: {}", cellID, energy, rh.getTimeStamp(), time, sampFrac_value);
 
+        if (!m_cfg.cellGeometry) {
+            // only the volume of the cell is looked up, so that unknown cells are dropped all the same
+            const dd4hep::VolumeManagerContext* context = nullptr;
+            try {
+                context = m_geo_cache->findContext(cellID);
+            } catch (...) {
+            }
+            if (context == nullptr) {
+                cellID_error(cellID);
+                continue;
+            }
+            recohits->create(rh.getCellID(), energy, 0, time, 0,
+                             decltype(edm4eic::CalorimeterHitData::position){},
+                             decltype(edm4eic::CalorimeterHitData::dimension){}, sid, lid,
+                             decltype(edm4eic::CalorimeterHitData::local){});
+            continue;
+        }
+
         dd4hep::DetElement local;
         dd4hep::Position gpos;
         try {
             // global positions
-            gpos = m_converter->position(cellID);
+            gpos = m_geo_cache->position(cellID);
 
             // masked position (look for a mother volume)
             if (gpos_mask != 0) {
-                auto mpos = m_converter->position(cellID & ~gpos_mask);
+                auto mpos = m_geo_cache->position(cellID & ~gpos_mask);
                 // replace corresponding coords
                 for (const char &c : m_cfg.maskPos) {
                     switch (std::tolower(c)) {
@@ -215,46 +236,19 @@ void CalorimeterHitReco::process(
 
             // local positions
             if (m_cfg.localDetElement.empty()) {
-                auto volman = m_detector->volumeManager();
-                local = volman.lookupDetElement(cellID & local_mask);
+                local = m_geo_cache->detElement(cellID & local_mask);
             } else {
                 local = m_local;
             }
         } catch (...) {
-            // Error looking up cellID. Messages should already have been printed.
-            // Also, see comment at top of this method.
-            if (++NcellIDerrors >= MaxCellIDerrors) {
-                error("Maximum number of errors reached: {}", MaxCellIDerrors);
-                error("This is likely an issue with the cellID being unknown.");
-                error("Note: local_mask={:X} example cellID={:x}", local_mask, cellID);
-                error("Disabling this algorithm since it requires a valid cellID.");
-                error("(See {}:{})", __FILE__,__LINE__);
-            }
+            cellID_error(cellID);
             continue;
         }
 
         const auto pos = local.nominal().worldToLocal(gpos);
-        std::vector<double> cdim;
-        // get segmentation dimensions
-        auto segmentation_type = m_converter->findReadout(local).segmentation().type();
-        if (segmentation_type == "CartesianGridXY" || segmentation_type == "HexGridXY") {
-            auto cell_dim = m_converter->cellDimensions(cellID);
-            cdim.resize(3);
-            cdim[0] = cell_dim[0];
-            cdim[1] = cell_dim[1];
-            debug("Using segmentation for cell dimensions: {}", fmt::join(cdim, ", "));
-        } else {
-            if ((segmentation_type != "NoSegmentation") && (!warned_unsupported_segmentation)) {
-                warning("Unsupported segmentation type \"{}\"", segmentation_type);
-                warned_unsupported_segmentation = true;
-            }
-
-            // Using bounding box instead of actual solid so the dimensions are always in dim_x, dim_y, dim_z
-            cdim = m_converter->findContext(cellID)->volumePlacement().volume().boundingBox().dimensions();
-            std::transform(cdim.begin(), cdim.end(), cdim.begin(),
-                           std::bind(std::multiplies<double>(), std::placeholders::_1, 2));
-            debug("Using bounding box for cell dimensions: {}", fmt::join(cdim, ", "));
-        }
+        // get segmentation dimensions, or the bounding box dimensions
+        const auto cdim = m_geo_cache->cellDimensions(cellID);
+        debug("Cell dimensions: {}", fmt::join(cdim, ", "));
 
         //create constant vectors for passing to hit initializer list
         //FIXME: needs to come from the geometry service/converter
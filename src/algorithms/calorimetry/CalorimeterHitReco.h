@@ -25,7 +25,10 @@
 #include <string_view>
 
 #include "CalorimeterHitRecoConfig.h"
+#include "ReadoutExpression.h"
+#include "algorithms/interfaces/CellIDFieldDecoder.h"
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "services/geometry/cellid_cache/CellIDGeometryCacheSvc.h"
 
 namespace eicrecon {
 
@@ -58,24 +61,23 @@ namespace eicrecon {
     double thresholdADC{0};
     double stepTDC{0};
 
-    std::function<double(const edm4hep::RawCalorimeterHit &h)> sampFrac;
+    ReadoutExpression sampFrac;
 
     dd4hep::IDDescriptor id_spec;
     dd4hep::BitFieldCoder* id_dec = nullptr;
+    CellIDFieldDecoder id_fields; // all the fields of id_dec
 
     mutable uint32_t NcellIDerrors = 0;
     uint32_t MaxCellIDerrors = 100;
 
     size_t sector_idx{0}, layer_idx{0};
 
-    mutable bool warned_unsupported_segmentation = false;
-
     dd4hep::DetElement m_local;
     size_t local_mask = ~static_cast<size_t>(0), gpos_mask = static_cast<size_t>(0);
 
   private:
     const dd4hep::Detector* m_detector{algorithms::GeoSvc::instance().detector()};
-    const dd4hep::rec::CellIDPositionConverter* m_converter{algorithms::GeoSvc::instance().cellIDPositionConverter()};
+    CellIDGeometryCacheSvc* m_geo_cache{nullptr};
 
   };
 
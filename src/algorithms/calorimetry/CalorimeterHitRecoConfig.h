@@ -36,6 +36,10 @@ namespace eicrecon {
     std::vector<std::string> localDetFields{};
     std::string              maskPos{""};
     std::vector<std::string> maskPosFields{};
+
+    // look up the position, local position and dimensions of every cell, they are zero otherwise
+    // (for hits that are merged right away by CalorimeterHitsMerger, which looks up the merged cells)
+    bool                     cellGeometry{true};
   };
 
 } // eicrecon
@@ -20,22 +20,27 @@
 #include <Evaluator/DD4hepUnits.h>
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/DisplacementVector3D.h>
+#include <algorithms/service.h>
 #include <fmt/core.h>
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <gsl/pointers>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "HitGroups.h"
 #include "algorithms/calorimetry/CalorimeterHitsMergerConfig.h"
+#include "services/geometry/cellid_cache/CellIDGeometryCacheSvc.h"
 
 namespace eicrecon {
 
 void CalorimeterHitsMerger::init() {
 
+    auto& serviceSvc = algorithms::ServiceSvc::instance();
+    m_geo_cache = serviceSvc.service<CellIDGeometryCacheSvc>("CellIDGeometryCacheSvc");
+
     if (m_cfg.readout.empty()) {
         error("readoutClass is not provided, it is needed to know the fields in readout ids");
         return;
@@ -69,35 +74,27 @@ void CalorimeterHitsMerger::process(
     auto [out_hits] = output;
 
     // find the hits that belong to the same group (for merging)
-    std::unordered_map<uint64_t, std::vector<std::size_t>> merge_map;
-    std::size_t ix = 0;
-    for (const auto &h : *in_hits) {
-        uint64_t id = h.getCellID() & id_mask;
-        merge_map[id].push_back(ix);
-
-        ix++;
-    }
+    HitGroups merge_groups;
+    merge_groups.build(*in_hits, [this](const auto& h) { return h.getCellID() & id_mask; });
 
     // sort hits by energy from large to small
-    for (auto &it : merge_map) {
-        std::sort(it.second.begin(), it.second.end(), [&](std::size_t ix1, std::size_t ix2) {
-            return (*in_hits)[ix1].getEnergy() > (*in_hits)[ix2].getEnergy();
-        });
-    }
+    merge_groups.sort_each([&](std::size_t ix1, std::size_t ix2) {
+        return (*in_hits)[ix1].getEnergy() > (*in_hits)[ix2].getEnergy();
+    });
 
     // reconstruct info for merged hits
-    // dd4hep decoders
-    auto volman = m_detector->volumeManager();
-
-    for (const auto &[id, ixs] : merge_map) {
+    for (const auto &[id, ixs] : merge_groups) {
         // reference fields id
         const uint64_t ref_id = id | ref_mask;
         // global positions
-        const auto gpos = m_converter->position(ref_id);
+        const auto gpos = m_geo_cache->position(ref_id);
         // local positions
-        auto alignment = volman.lookupDetElement(ref_id).nominal();
+        const auto det_element = m_geo_cache->detElement(ref_id);
+        auto alignment = det_element.nominal();
         const auto pos = alignment.worldToLocal(dd4hep::Position(gpos.x(), gpos.y(), gpos.z()));
-        debug("{}, {}", volman.lookupDetElement(ref_id).path(), volman.lookupDetector(ref_id).path());
+        if (level() <= algorithms::LogLevel::kDebug) {
+            debug("{}, {}", det_element.path(), m_detector->volumeManager().lookupDetector(ref_id).path());
+        }
         // sum energy
         float energy = 0.;
         float energyError = 0.;
@@ -115,6 +112,8 @@ void CalorimeterHitsMerger::process(
         timeError = sqrt(timeError) / ixs.size();
 
         const auto href = (*in_hits)[ixs.front()];
+        // the dimensions of the reference cell, looked up here as the input hits may come without their geometry
+        const auto cdim = m_geo_cache->cellDimensions(href.getCellID());
 
         // create const vectors for passing to hit initializer list
         const decltype(edm4eic::CalorimeterHitData::position) position(
@@ -123,6 +122,9 @@ void CalorimeterHitsMerger::process(
         const decltype(edm4eic::CalorimeterHitData::local) local(
                 pos.x(), pos.y(), pos.z()
         );
+        const decltype(edm4eic::CalorimeterHitData::dimension) dimension(
+                cdim.at(0) / dd4hep::mm, cdim.at(1) / dd4hep::mm, cdim.at(2) / dd4hep::mm
+        );
 
         out_hits->create(
                         href.getCellID(),
@@ -131,7 +133,7 @@ void CalorimeterHitsMerger::process(
                         time,
                         timeError,
                         position,
-                        href.getDimension(),
+                        dimension,
                         href.getSector(),
                         href.getLayer(),
                         local); // Can do better here? Right now position is mapped on the central hit
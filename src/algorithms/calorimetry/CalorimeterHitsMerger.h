@@ -11,7 +11,6 @@
 #pragma once
 
 #include <DD4hep/Detector.h>
-#include <DDRec/CellIDPositionConverter.h>
 #include <algorithms/algorithm.h>
 #include <algorithms/geo.h>
 #include <edm4eic/CalorimeterHitCollection.h>
@@ -22,6 +21,7 @@
 
 #include "CalorimeterHitsMergerConfig.h"
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "services/geometry/cellid_cache/CellIDGeometryCacheSvc.h"
 
 namespace eicrecon {
 
@@ -53,7 +53,7 @@ namespace eicrecon {
 
   private:
     const dd4hep::Detector* m_detector{algorithms::GeoSvc::instance().detector()};
-    const dd4hep::rec::CellIDPositionConverter* m_converter{algorithms::GeoSvc::instance().cellIDPositionConverter()};
+    CellIDGeometryCacheSvc* m_geo_cache{nullptr};
 
   };
 
@@ -7,17 +7,18 @@
 
 #include <DD4hep/Readout.h>
 #include <Evaluator/DD4hepUnits.h>
-#include <TInterpreter.h>
-#include <TInterpreterValue.h>
+#include <algorithms/service.h>
 #include <edm4hep/Vector2f.h>
 #include <edm4hep/Vector3f.h>
 #include <fmt/format.h>
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <gsl/pointers>
 #include <map>
 #include <memory>
-#include <set>
-#include <sstream>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -25,14 +26,17 @@
 #include <vector>
 
 #include "CalorimeterIslandCluster.h"
+#include "ConnectedComponents.h"
+#include "NeighbourGrid.h"
 #include "algorithms/calorimetry/CalorimeterIslandClusterConfig.h"
+#include "algorithms/interfaces/LogMacros.h"
+#include "services/evaluator/EvaluatorSvc.h"
+#include "services/log/StartupProfile.h"
 
 using namespace edm4eic;
 
 namespace eicrecon {
 
-unsigned int CalorimeterIslandCluster::function_id = 0;
-
 static double Phi_mpi_pi(double phi) {
   return std::remainder(phi, 2 * M_PI);
 }
@@ -79,11 +83,70 @@ static edm4hep::Vector2f globalDistEtaPhi(const CaloHit &h1, const CaloHit &h2)
   };
 }
 
+// Grid coordinates corresponding to the distance methods above
+static std::array<double, 2> localCoordXY(const CaloHit &h) {
+  return {h.getLocal().x, h.getLocal().y};
+}
+static std::array<double, 2> localCoordXZ(const CaloHit &h) {
+  return {h.getLocal().x, h.getLocal().z};
+}
+static std::array<double, 2> localCoordYZ(const CaloHit &h) {
+  return {h.getLocal().y, h.getLocal().z};
+}
+static std::array<double, 2> globalCoordRPhi(const CaloHit &h) {
+  return {edm4hep::utils::magnitude(h.getPosition()), edm4hep::utils::angleAzimuthal(h.getPosition())};
+}
+static std::array<double, 2> globalCoordEtaPhi(const CaloHit &h) {
+  return {edm4hep::utils::eta(h.getPosition()), edm4hep::utils::angleAzimuthal(h.getPosition())};
+}
+
+// Kernels of the distance methods above, for the loops over hit pairs: the
+// distances are the differences of the coordinates, scaled by the summed hit
+// dimensions (dim_scaled), with the second one wrapped to [-pi, pi] (azimuthal)
+namespace {
+  template <std::array<double, 2> (*Coord)(const CaloHit&), bool Azimuthal, bool DimScaled>
+  struct DistKernel {
+    static constexpr bool azimuthal = Azimuthal;
+    static constexpr bool dim_scaled = DimScaled;
+    static std::array<double, 2> coord(const CaloHit &h) { return Coord(h); }
+  };
+} // namespace
+
+template <typename F>
+void CalorimeterIslandCluster::visit_metric(DistMetric metric, F&& f) {
+  switch (metric) {
+  case DistMetric::localXY:
+    f(DistKernel<localCoordXY, false, false>{});
+    break;
+  case DistMetric::localXZ:
+    f(DistKernel<localCoordXZ, false, false>{});
+    break;
+  case DistMetric::localYZ:
+    f(DistKernel<localCoordYZ, false, false>{});
+    break;
+  case DistMetric::dimScaledLocalXY:
+    f(DistKernel<localCoordXY, false, true>{});
+    break;
+  case DistMetric::globalRPhi:
+    f(DistKernel<globalCoordRPhi, true, false>{});
+    break;
+  case DistMetric::globalEtaPhi:
+    f(DistKernel<globalCoordEtaPhi, true, false>{});
+    break;
+  }
+}
+
+// Grid cells are made slightly larger than the neighbour distances, so that
+// the single precision distance computation never escapes the adjacent cells
+static constexpr double grid_margin = 1. + 1e-4;
+
 //------------------------
 // AlgorithmInit
 //------------------------
 void CalorimeterIslandCluster::init() {
 
+    StartupProfile::Scope profile("CalorimeterIslandCluster init", std::string(name()));
+
     static std::map<std::string,
                 std::tuple<std::function<edm4hep::Vector2f(const CaloHit&, const CaloHit&)>, std::vector<double>>>
     distMethods{
@@ -92,6 +155,18 @@ void CalorimeterIslandCluster::init() {
         {"globalDistRPhi", {globalDistRPhi, {dd4hep::mm, dd4hep::rad}}}, {"globalDistEtaPhi", {globalDistEtaPhi, {1., dd4hep::rad}}}
     };
 
+    // kernels of the distance methods
+    static std::map<std::string, DistMetric>
+    distMetrics{
+        {"localDistXY", DistMetric::localXY},            {"localDistXZ", DistMetric::localXZ},
+        {"localDistYZ", DistMetric::localYZ},            {"dimScaledLocalDistXY", DistMetric::dimScaledLocalXY},
+        {"globalDistRPhi", DistMetric::globalRPhi},      {"globalDistEtaPhi", DistMetric::globalEtaPhi}
+    };
+
+    m_distMetric.reset();
+    m_adjacency.reset();
+    m_neighbourTable = nullptr;
+
 
     // set coordinate system
     auto set_dist_method = [this](std::pair<std::string, std::vector<double>> uprop) {
@@ -107,6 +182,11 @@ void CalorimeterIslandCluster::init() {
           neighbourDist[i] = uprop.second[i] / units[i];
         }
         hitsDist = method;
+        m_distMetric = distMetrics[uprop.first];
+        visit_metric(*m_distMetric, [this](auto metric) {
+          m_gridAzimuthal = metric.azimuthal;
+          m_gridDimScaled = metric.dim_scaled;
+        });
         info("Clustering uses {} with distances <= [{}]", uprop.first, fmt::join(neighbourDist, ","));
       }
       return true;
@@ -124,48 +204,79 @@ void CalorimeterIslandCluster::init() {
 
     bool method_found = false;
 
+    // Precomputed readout neighbours
+    if (m_cfg.adjacency == "table") {
+      if (m_cfg.readout.empty()) {
+        throw std::runtime_error("readoutClass is not provided, it is needed for the neighbour table");
+      }
+      auto& serviceSvc = algorithms::ServiceSvc::instance();
+      m_neighbourTable = &serviceSvc.service<ReadoutNeighbourTableSvc>("ReadoutNeighbourTableSvc")->table(m_cfg.readout);
+      is_neighbour = [this](const CaloHit &h1, const CaloHit &h2) {
+        return m_neighbourTable->adjacent(h1.getCellID(), h2.getCellID());
+      };
+      info("Clustering uses the neighbour table of {} ({} cells)", m_cfg.readout, m_neighbourTable->size());
+      method_found = true;
+    } else if (!m_cfg.adjacency.empty()) {
+      throw std::runtime_error(fmt::format("Unsupported value \"{}\" for \"adjacency\"", m_cfg.adjacency));
+    }
+
     // Adjacency matrix methods
-    if (!m_cfg.adjacencyMatrix.empty()) {
+    if (!method_found && !m_cfg.adjacencyMatrix.empty()) {
       // sanity checks
       if (m_cfg.readout.empty()) {
         error("readoutClass is not provided, it is needed to know the fields in readout ids");
       }
       m_idSpec = m_detector->readout(m_cfg.readout).idSpec();
+      m_idDecoder = CellIDFieldDecoder::allFields(m_idSpec);
 
-      std::string func_name = fmt::format("_CalorimeterIslandCluster_{}", function_id++);
-      std::ostringstream sstr;
-      sstr << "bool " << func_name << "(double params[]){";
-      unsigned int param_ix = 0;
+      std::vector<std::string> params;
       for(const auto &p : m_idSpec.fields()) {
-        const std::string &name = p.first;
-        const dd4hep::IDDescriptor::Field* field = p.second;
-        sstr << "double " << name << "_1 = params[" << (param_ix++) << "];";
-        sstr << "double " << name << "_2 = params[" << (param_ix++) << "];";
+        params.push_back(p.first + "_1");
+        params.push_back(p.first + "_2");
+      }
+
+      try {
+        m_adjacency = CompiledExpression::compile(m_cfg.adjacencyMatrix, params);
+      } catch (std::invalid_argument &e) {
+        info("Adjacency matrix needs the interpreter: {}", e.what());
       }
-      sstr << "return " << m_cfg.adjacencyMatrix << ";";
-      sstr << "}";
-      debug("Compiling {}", sstr.str());
-
-      TInterpreter *interp = TInterpreter::Instance();
-      interp->ProcessLine(sstr.str().c_str());
-      std::unique_ptr<TInterpreterValue> func_val { gInterpreter->MakeInterpreterValue() };
-      interp->Evaluate(func_name.c_str(), *func_val);
-      typedef bool (*func_t)(double params[]);
-      func_t func = ((func_t)(func_val->GetAsPointer()));
-
-      is_neighbour = [this, func, param_ix](const CaloHit &h1, const CaloHit &h2) {
-        std::vector<double> params;
-        params.reserve(param_ix);
-        for(const auto &p : m_idSpec.fields()) {
-          const std::string &name = p.first;
-          const dd4hep::IDDescriptor::Field* field = p.second;
-          params.push_back(field->value(h1.getCellID()));
-          params.push_back(field->value(h2.getCellID()));
-          trace("{}_1 = {}", name, field->value(h1.getCellID()));
-          trace("{}_2 = {}", name, field->value(h2.getCellID()));
+
+      if (m_adjacency) {
+        // only the fields that appear in the expression get decoded
+        std::vector<const dd4hep::IDDescriptor::Field*> adjacency_fields;
+        m_adjacencyFieldSlots.assign(m_idSpec.fields().size(), 0);
+        for (std::size_t field_ix = 0; const auto &p : m_idSpec.fields()) {
+          if (m_adjacency->uses(2 * field_ix) || m_adjacency->uses(2 * field_ix + 1)) {
+            m_adjacencyFieldSlots[field_ix] = adjacency_fields.size();
+            adjacency_fields.push_back(p.second);
+          }
+          field_ix++;
         }
-        return func(params.data());
-      };
+        m_adjacencyDecoder = CellIDFieldDecoder(adjacency_fields);
+        debug("Compiled adjacency matrix natively, it uses {} readout fields", m_adjacencyDecoder.size());
+
+        is_neighbour = [this](const CaloHit &h1, const CaloHit &h2) {
+          return m_adjacency->evaluate([&](std::size_t param_ix) {
+            return static_cast<double>(m_idDecoder.get(((param_ix % 2) == 0) ? h1.getCellID() : h2.getCellID(), param_ix / 2));
+          }) != 0.;
+        };
+      } else {
+        // through EvaluatorSvc, which sets up the interpreter on its first such expression
+        auto& serviceSvc = algorithms::ServiceSvc::instance();
+        auto func = serviceSvc.service<EvaluatorSvc>("EvaluatorSvc")->compile_positional(m_cfg.adjacencyMatrix, params);
+
+        is_neighbour = [this, func](const CaloHit &h1, const CaloHit &h2) {
+          // two per field, a field takes at least one of the 64 bits of the cellID
+          std::array<double, 2 * 64> values;
+          for (std::size_t field_ix = 0; field_ix < m_idDecoder.size(); ++field_ix) {
+            values[2 * field_ix] = m_idDecoder.get(h1.getCellID(), field_ix);
+            values[2 * field_ix + 1] = m_idDecoder.get(h2.getCellID(), field_ix);
+            EICRECON_TRACE("{}_1 = {}", m_idSpec.fields()[field_ix].first, values[2 * field_ix]);
+            EICRECON_TRACE("{}_2 = {}", m_idSpec.fields()[field_ix].first, values[2 * field_ix + 1]);
+          }
+          return func(std::span<const double>{values.data(), 2 * m_idDecoder.size()}) != 0.;
+        };
+      }
       method_found = true;
     }
 
@@ -198,12 +309,21 @@ void CalorimeterIslandCluster::init() {
       throw std::runtime_error("Cannot determine the clustering coordinates");
     }
 
+    if (m_cfg.grouping == "components") {
+      // the interpreted adjacency matrix can not be evaluated on several threads
+      const bool interpreted = !m_neighbourTable && !m_cfg.adjacencyMatrix.empty() && !m_adjacency;
+      info("Grouping the hits as connected components, with {} tasks", interpreted ? 1 : m_cfg.groupingTasks);
+    } else if (m_cfg.grouping != "bfs") {
+      throw std::runtime_error(fmt::format("Unsupported value \"{}\" for \"grouping\"", m_cfg.grouping));
+    }
+
     if (m_cfg.splitCluster) {
       auto transverseEnergyProfileMetric_it = std::find_if(distMethods.begin(), distMethods.end(), [&](auto &p) { return m_cfg.transverseEnergyProfileMetric == p.first; });
       if (transverseEnergyProfileMetric_it == distMethods.end()) {
           throw std::runtime_error(fmt::format("Unsupported value \"{}\" for \"transverseEnergyProfileMetric\"", m_cfg.transverseEnergyProfileMetric));
       }
       transverseEnergyProfileMetric = std::get<0>(transverseEnergyProfileMetric_it->second);
+      m_profileMetric = distMetrics[m_cfg.transverseEnergyProfileMetric];
       std::vector<double> &units = std::get<1>(transverseEnergyProfileMetric_it->second);
       for (auto unit : units) {
         if (unit != units[0]) {
@@ -224,34 +344,281 @@ void CalorimeterIslandCluster::process(
     const auto [hits] = input;
     auto [proto_clusters] = output;
 
-    // group neighboring hits
-    std::vector<std::set<std::size_t>> groups;
-
-    std::vector<bool> visits(hits->size(), false);
-    for (size_t i = 0; i < hits->size(); ++i) {
+    // shared with the other algorithms of the event that read the same members
+    const auto columns = ColumnCache::get<HitColumns>(*hits);
+    const auto energies = columns->get<0>();
+    const auto cell_ids = columns->get<1>();
+    const auto sectors = columns->get<2>();
+
+    // index qualified hits, so that grouping only tests hits in adjacent grid cells
+    // (cells of the hitsDist coordinates within a sector, and global cells of
+    // sectorDist for the neighbours in other sectors)
+    const std::size_t n_hits = hits->size();
+
+    // coordinates of the distance metric, computed once per hit for the grid
+    // and for the distance tests of the hit pairs
+    DistCoords dist_coords;
+    if (m_distMetric) {
+      visit_metric(*m_distMetric, [&](auto metric) {
+        using Metric = decltype(metric);
+        dist_coords.a.resize(n_hits);
+        dist_coords.b.resize(n_hits);
+        if constexpr (Metric::dim_scaled) {
+          dist_coords.dim_a.resize(n_hits);
+          dist_coords.dim_b.resize(n_hits);
+        }
+        dist_coords.x.resize(n_hits);
+        dist_coords.y.resize(n_hits);
+        dist_coords.z.resize(n_hits);
+        for (std::size_t i = 0; i < n_hits; ++i) {
+          const auto& hit = (*hits)[i];
+          const auto coord = Metric::coord(hit);
+          dist_coords.a[i] = coord[0];
+          dist_coords.b[i] = coord[1];
+          if constexpr (Metric::dim_scaled) {
+            dist_coords.dim_a[i] = hit.getDimension().x;
+            dist_coords.dim_b[i] = hit.getDimension().y;
+          }
+          dist_coords.x[i] = hit.getPosition().x;
+          dist_coords.y[i] = hit.getPosition().y;
+          dist_coords.z[i] = hit.getPosition().z;
+        }
+      });
+    }
 
-      {
-        const auto& hit = (*hits)[i];
-        debug("hit {:d}: energy = {:.4f} MeV, local = ({:.4f}, {:.4f}) mm, global=({:.4f}, {:.4f}, {:.4f}) mm", i, hit.getEnergy() * 1000., hit.getLocal().x, hit.getLocal().y, hit.getPosition().x,  hit.getPosition().y, hit.getPosition().z);
+    NeighbourGrid<3> sector_grid;
+    NeighbourGrid<3> global_grid;
+    std::vector<NeighbourGrid<3>::Key> sector_keys(m_distMetric ? n_hits : 0);
+    std::vector<NeighbourGrid<3>::Key> global_keys;
+    bool multiple_sectors = false;
+    if (m_distMetric) {
+      std::array<double, 2> scale{1., 1.};
+      if (m_gridDimScaled) {
+        // dimension scaled distances are bounded by the largest cell dimensions
+        scale = {0., 0.};
+        for (std::size_t i = 0; i < n_hits; ++i) {
+          if (energies[i] >= m_cfg.minClusterHitEdep) {
+            scale[0] = std::max<double>(scale[0], std::abs(dist_coords.dim_a[i]));
+            scale[1] = std::max<double>(scale[1], std::abs(dist_coords.dim_b[i]));
+          }
+        }
+      }
+      sector_grid.configure({
+        NeighbourGridAxis::exact(),
+        NeighbourGridAxis::linear(neighbourDist[0] * scale[0] * grid_margin),
+        m_gridAzimuthal ? NeighbourGridAxis::periodic(neighbourDist[1] * scale[1] * grid_margin, 2 * M_PI, -M_PI)
+                        : NeighbourGridAxis::linear(neighbourDist[1] * scale[1] * grid_margin)
+      });
+      sector_grid.reserve(hits->size());
+      for (size_t i = 0; i < hits->size(); ++i) {
+        if (energies[i] < m_cfg.minClusterHitEdep) {
+          continue;
+        }
+        sector_keys[i] = sector_grid.key({static_cast<double>(sectors[i]), dist_coords.a[i], dist_coords.b[i]});
+        sector_grid.insert(sector_keys[i], i);
+        multiple_sectors |= (sectors[i] != sectors[0]);
       }
-      // already in a group
-      if (visits[i]) {
-        continue;
+      sector_grid.build();
+
+      if (multiple_sectors) {
+        const double global_width = m_cfg.sectorDist / dd4hep::mm * grid_margin;
+        global_grid.configure({
+          NeighbourGridAxis::linear(global_width),
+          NeighbourGridAxis::linear(global_width),
+          NeighbourGridAxis::linear(global_width)
+        });
+        global_grid.reserve(hits->size());
+        global_keys.resize(hits->size());
+        for (size_t i = 0; i < hits->size(); ++i) {
+          if (energies[i] < m_cfg.minClusterHitEdep) {
+            continue;
+          }
+          global_keys[i] = global_grid.key({dist_coords.x[i], dist_coords.y[i], dist_coords.z[i]});
+          global_grid.insert(global_keys[i], i);
+        }
+        global_grid.build();
+      }
+    }
+
+    // readout fields of the adjacency expression, decoded once per hit
+    // (one column per field)
+    std::vector<double> field_table;
+    if (m_adjacency) {
+      field_table.resize(m_adjacencyDecoder.size() * n_hits);
+      m_adjacencyDecoder.decode(cell_ids.data(), n_hits, field_table.data());
+    }
+
+    // qualified hits sorted by cellID, to find the hits of the table neighbours
+    std::vector<std::pair<std::uint64_t, std::size_t>> cell_hits;
+    if (m_neighbourTable) {
+      cell_hits.reserve(n_hits);
+      for (std::size_t i = 0; i < n_hits; ++i) {
+        if (energies[i] >= m_cfg.minClusterHitEdep) {
+          cell_hits.emplace_back(cell_ids[i], i);
+        }
       }
-      groups.emplace_back();
-      // create a new group, and group all the neighboring hits
-      bfs_group(*hits, groups.back(), i, visits);
+      std::sort(cell_hits.begin(), cell_hits.end());
     }
 
-    for (auto& group : groups) {
-      if (group.empty()) {
-        continue;
+    auto for_each_candidate = [&](std::size_t idx1, auto&& f) {
+      if (m_neighbourTable) {
+        for (auto cellID : m_neighbourTable->neighbours(cell_ids[idx1])) {
+          auto it = std::lower_bound(cell_hits.begin(), cell_hits.end(), std::pair<std::uint64_t, std::size_t>{cellID, 0});
+          for (; (it != cell_hits.end()) && (it->first == cellID); ++it) {
+            f(it->second);
+          }
+        }
+        return;
+      }
+      if (!m_distMetric) {
+        // arbitrary adjacency, test all hits
+        for (std::size_t idx2 = 0; idx2 < hits->size(); ++idx2) {
+          f(idx2);
+        }
+        return;
+      }
+      sector_grid.for_each_neighbour(sector_keys[idx1], f);
+      if (multiple_sectors) {
+        const auto sector = sectors[idx1];
+        global_grid.for_each_neighbour(global_keys[idx1], [&](std::size_t idx2) {
+          // same sector hits are already covered by the sector grid
+          if (sectors[idx2] != sector) {
+            f(idx2);
+          }
+        });
+      }
+    };
+
+    // group neighboring hits, the groups are stored contiguously,
+    // group g is group_hits[group_offsets[g]:group_offsets[g + 1]]
+    std::vector<std::size_t> group_hits;
+    std::vector<std::size_t> group_offsets{0};
+    group_hits.reserve(hits->size());
+    // local maxima of each group, maxima of group g are maxima_hits[maxima_offsets[g]:maxima_offsets[g + 1]]
+    std::vector<std::size_t> maxima_hits;
+    std::vector<std::size_t> maxima_offsets{0};
+
+    // grouping and local maxima for a neighbour test, instantiated once per kind of test
+    auto group_hits_by = [&](auto&& neighbour) {
+      if (m_cfg.grouping == "components") {
+        const bool interpreted = !m_neighbourTable && !m_cfg.adjacencyMatrix.empty() && !m_adjacency;
+        auto qualified = [&](std::size_t idx) { return energies[idx] >= m_cfg.minClusterHitEdep; };
+        ConnectedComponents components(std::max(1, m_cfg.groupingMinHitsPerTask));
+        components.build(n_hits, interpreted ? 1 : std::max(1, m_cfg.groupingTasks), qualified, for_each_candidate, neighbour);
+        // every qualified hit starts a group in the breadth-first search
+        components.groups([](std::size_t) { return true; }, group_hits, group_offsets);
+      } else {
+        std::vector<bool> visits(hits->size(), false);
+        std::vector<std::size_t> queue;
+        for (size_t i = 0; i < hits->size(); ++i) {
+
+          {
+            const auto& hit = (*hits)[i];
+            EICRECON_DEBUG("hit {:d}: energy = {:.4f} MeV, local = ({:.4f}, {:.4f}) mm, global=({:.4f}, {:.4f}, {:.4f}) mm", i, hit.getEnergy() * 1000., hit.getLocal().x, hit.getLocal().y, hit.getPosition().x,  hit.getPosition().y, hit.getPosition().z);
+          }
+          // already in a group
+          if (visits[i]) {
+            continue;
+          }
+          // create a new group, and group all the neighboring hits
+          bfs_group(energies, group_hits, i, visits, queue, for_each_candidate, neighbour);
+          if (group_hits.size() > group_offsets.back()) {
+            // hits of a group are kept in ascending order
+            std::sort(group_hits.begin() + group_offsets.back(), group_hits.end());
+            group_offsets.push_back(group_hits.size());
+          }
+        }
+      }
+
+      std::vector<std::size_t> maxima;
+      for (std::size_t g = 0; g + 1 < group_offsets.size(); ++g) {
+        std::span<const std::size_t> group(group_hits.data() + group_offsets[g], group_offsets[g + 1] - group_offsets[g]);
+        // without the grid or the table, testing the group is cheaper than testing all hits
+        auto for_each_maxima_candidate = [&](std::size_t idx1, auto&& f) {
+          if (m_distMetric || m_neighbourTable) {
+            for_each_candidate(idx1, f);
+            return;
+          }
+          for (std::size_t idx2 : group) {
+            f(idx2);
+          }
+        };
+        find_maxima(energies, group, for_each_maxima_candidate, neighbour, !m_cfg.splitCluster, maxima);
+        maxima_hits.insert(maxima_hits.end(), maxima.begin(), maxima.end());
+        maxima_offsets.push_back(maxima_hits.size());
       }
-      auto maxima = find_maxima(*hits, group, !m_cfg.splitCluster);
-      split_group(*hits, group, maxima, proto_clusters);
+    };
 
-      debug("hits in a group: {}, local maxima: {}", group.size(), maxima.size());
+    if (m_adjacency) {
+      group_hits_by([&](std::size_t idx1, std::size_t idx2) {
+        return m_adjacency->evaluate([&](std::size_t param_ix) {
+          return field_table[m_adjacencyFieldSlots[param_ix / 2] * n_hits + (((param_ix % 2) == 0) ? idx1 : idx2)];
+        }) != 0.;
+      });
+    } else if (m_distMetric) {
+      // same tests as is_neighbour, inlined for the metric over the coordinate arrays
+      const double sector_dist = m_cfg.sectorDist / dd4hep::mm;
+      visit_metric(*m_distMetric, [&](auto metric) {
+        using Metric = decltype(metric);
+        group_hits_by([&](std::size_t idx1, std::size_t idx2) {
+          // in the same sector
+          if (sectors[idx1] == sectors[idx2]) {
+            float delta_a = static_cast<float>(dist_coords.a[idx1] - dist_coords.a[idx2]);
+            float delta_b = static_cast<float>(dist_coords.b[idx1] - dist_coords.b[idx2]);
+            if constexpr (Metric::azimuthal) {
+              delta_b = static_cast<float>(Phi_mpi_pi(dist_coords.b[idx1] - dist_coords.b[idx2]));
+            }
+            if constexpr (Metric::dim_scaled) {
+              delta_a = 2 * delta_a / (dist_coords.dim_a[idx1] + dist_coords.dim_a[idx2]);
+              delta_b = 2 * delta_b / (dist_coords.dim_b[idx1] + dist_coords.dim_b[idx2]);
+            }
+            return (std::fabs(delta_a) <= neighbourDist[0]) && (std::fabs(delta_b) <= neighbourDist[1]);
+          }
+          // different sector, using global coordinates
+          const edm4hep::Vector3f delta{dist_coords.x[idx1] - dist_coords.x[idx2],
+                                        dist_coords.y[idx1] - dist_coords.y[idx2],
+                                        dist_coords.z[idx1] - dist_coords.z[idx2]};
+          return edm4hep::utils::magnitude(delta) <= sector_dist;
+        });
+      });
+    } else {
+      group_hits_by([&](std::size_t idx1, std::size_t idx2) {
+        return is_neighbour((*hits)[idx1], (*hits)[idx2]);
+      });
     }
+
+    // profile coordinates are only needed to split groups with several maxima
+    visit_metric(m_profileMetric, [&](auto metric) {
+      using ProfileMetric = decltype(metric);
+      ProfileCoords profile_coords;
+      if (m_cfg.splitCluster) {
+        profile_coords.a.resize(n_hits);
+        profile_coords.b.resize(n_hits);
+        if constexpr (ProfileMetric::dim_scaled) {
+          profile_coords.dim_a.resize(n_hits);
+          profile_coords.dim_b.resize(n_hits);
+        }
+        for (std::size_t i = 0; i < n_hits; ++i) {
+          const auto& hit = (*hits)[i];
+          const auto coord = ProfileMetric::coord(hit);
+          profile_coords.a[i] = static_cast<float>(coord[0]);
+          profile_coords.b[i] = static_cast<float>(coord[1]);
+          if constexpr (ProfileMetric::dim_scaled) {
+            profile_coords.dim_a[i] = hit.getDimension().x;
+            profile_coords.dim_b[i] = hit.getDimension().y;
+          }
+        }
+      }
+
+      std::vector<double> weights;
+      for (std::size_t g = 0; g + 1 < group_offsets.size(); ++g) {
+        std::span<const std::size_t> group(group_hits.data() + group_offsets[g], group_offsets[g + 1] - group_offsets[g]);
+        std::span<const std::size_t> maxima(maxima_hits.data() + maxima_offsets[g], maxima_offsets[g + 1] - maxima_offsets[g]);
+        split_group<ProfileMetric>(*hits, energies, group, maxima, profile_coords, weights, proto_clusters);
+
+        debug("hits in a group: {}, local maxima: {}", group.size(), maxima.size());
+      }
+    });
 }
 
 } // namespace eicrecon
@@ -17,13 +17,18 @@
 #include <cstddef>
 #include <functional>
 #include <gsl/pointers>
-#include <set>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include "CalorimeterIslandClusterConfig.h"
+#include "algorithms/interfaces/CellIDFieldDecoder.h"
+#include "algorithms/interfaces/CollectionColumns.h"
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "services/evaluator/CompiledExpression.h"
+#include "services/geometry/neighbour_table/ReadoutNeighbourTableSvc.h"
 
 namespace eicrecon {
 
@@ -75,86 +80,141 @@ namespace eicrecon {
 
   private:
 
-    static unsigned int function_id;
-
-    // grouping function with Breadth-First Search
-    void bfs_group(const edm4eic::CalorimeterHitCollection &hits, std::set<std::size_t> &group, std::size_t idx, std::vector<bool> &visits) const {
+    // metrics of the coordinate distance methods, each one has a kernel with
+    // its coordinates and flags in the source, dispatched once per event
+    enum class DistMetric { localXY, localXZ, localYZ, dimScaledLocalXY, globalRPhi, globalEtaPhi };
+    template <typename F> static void visit_metric(DistMetric metric, F&& f);
+
+    // metric of the neighbour distances and of the neighbour search grid,
+    // unset for the adjacency matrix and the neighbour table
+    std::optional<DistMetric> m_distMetric;
+    // adjacency expression compiled over the readout fields (name_1, name_2 for each field),
+    // unset if the expression needed the interpreter
+    std::optional<CompiledExpression> m_adjacency;
+    // all the idSpec fields, for the adjacency expression of a hit pair
+    CellIDFieldDecoder m_idDecoder;
+    // fields used by the adjacency expression, and the index of each idSpec field among them
+    CellIDFieldDecoder m_adjacencyDecoder;
+    std::vector<std::size_t> m_adjacencyFieldSlots;
+
+    // precomputed readout neighbours, unset unless adjacency is "table"
+    const ReadoutNeighbourTable* m_neighbourTable{nullptr};
+
+    // grid cells need to be scaled by the hit dimensions
+    bool m_gridDimScaled{false};
+    // second grid coordinate is an azimuthal angle
+    bool m_gridAzimuthal{false};
+
+    // transverse energy profile metric, the profile distances are the differences
+    // of its coordinates (scaled by the hit dimensions, or with an azimuthal second coordinate)
+    DistMetric m_profileMetric{DistMetric::globalEtaPhi};
+
+    // the hit members of the grouping loops: energy, cellID and sector
+    using HitColumns = CollectionColumns<edm4eic::CalorimeterHitCollection,
+                                         &CaloHit::getEnergy, &CaloHit::getCellID, &CaloHit::getSector>;
+
+    // distance metric coordinates of all hits of an event, as contiguous arrays,
+    // with the global positions for the hits of different sectors
+    struct DistCoords {
+      std::vector<double> a, b;
+      std::vector<float> dim_a, dim_b;
+      std::vector<float> x, y, z;
+    };
+
+    // profile coordinates of all hits of an event, as contiguous arrays
+    struct ProfileCoords {
+      std::vector<float> a, b;
+      std::vector<float> dim_a, dim_b;
+    };
+
+    // grouping function with Breadth-First Search, appends the group of idx to the
+    // flat group storage
+    // for_each_candidate(idx1, f) has to call f(idx2) at least for all neighbours idx2 of idx1,
+    // neighbour(idx1, idx2) is the index based counterpart of is_neighbour
+    template <typename CandidatesFn, typename NeighbourFn>
+    void bfs_group(std::span<const float> energies, std::vector<std::size_t> &group, std::size_t idx, std::vector<bool> &visits, std::vector<std::size_t> &queue, CandidatesFn&& for_each_candidate, NeighbourFn&& neighbour) const {
       visits[idx] = true;
 
       // not a qualified hit to particpate clustering, stop here
-      if (hits[idx].getEnergy() < m_cfg.minClusterHitEdep) {
+      if (energies[idx] < m_cfg.minClusterHitEdep) {
         return;
       }
 
-      group.insert(idx);
-      size_t prev_size = 0;
-
-      while (prev_size != group.size()) {
-        prev_size = group.size();
-        for (std::size_t idx1 : group) {
-          // check neighbours
-          for (std::size_t idx2 = 0; idx2 < hits.size(); ++idx2) {
-            // not a qualified hit to particpate clustering, skip
-            if (hits[idx2].getEnergy() < m_cfg.minClusterHitEdep) {
-              continue;
-            }
-            if ((!visits[idx2])
-                && is_neighbour(hits[idx1], hits[idx2])) {
-              group.insert(idx2);
-              visits[idx2] = true;
-            }
+      group.push_back(idx);
+      queue.clear();
+      queue.push_back(idx);
+
+      while (!queue.empty()) {
+        std::size_t idx1 = queue.back();
+        queue.pop_back();
+        // check neighbours
+        for_each_candidate(idx1, [&](std::size_t idx2) {
+          // not a qualified hit to particpate clustering, skip
+          if (energies[idx2] < m_cfg.minClusterHitEdep) {
+            return;
           }
-        }
+          if ((!visits[idx2])
+              && neighbour(idx1, idx2)) {
+            group.push_back(idx2);
+            visits[idx2] = true;
+            queue.push_back(idx2);
+          }
+        });
       }
     }
 
     // find local maxima that above a certain threshold
-  std::vector<std::size_t> find_maxima(const edm4eic::CalorimeterHitCollection &hits, const std::set<std::size_t> &group, bool global = false) const {
-    std::vector<std::size_t> maxima;
+    // for_each_candidate(idx1, f) has to call f(idx2) at least for all neighbours idx2 of idx1,
+    // qualified neighbours of a group member are always in the same group
+  template <typename CandidatesFn, typename NeighbourFn>
+  void find_maxima(std::span<const float> energies, std::span<const std::size_t> group, CandidatesFn&& for_each_candidate, NeighbourFn&& neighbour, bool global, std::vector<std::size_t> &maxima) const {
+    maxima.clear();
     if (group.empty()) {
-      return maxima;
+      return;
     }
 
     if (global) {
-      std::size_t mpos = *group.begin();
+      std::size_t mpos = group.front();
       for (auto idx : group) {
-        if (hits[mpos].getEnergy() < hits[idx].getEnergy()) {
+        if (energies[mpos] < energies[idx]) {
           mpos = idx;
         }
       }
-      if (hits[mpos].getEnergy() >= m_cfg.minClusterCenterEdep) {
+      if (energies[mpos] >= m_cfg.minClusterCenterEdep) {
         maxima.push_back(mpos);
       }
-      return maxima;
+      return;
     }
 
     for (std::size_t idx1 : group) {
       // not a qualified center
-      if (hits[idx1].getEnergy() < m_cfg.minClusterCenterEdep) {
+      const float energy1 = energies[idx1];
+      if (energy1 < m_cfg.minClusterCenterEdep) {
         continue;
       }
 
       bool maximum = true;
-      for (std::size_t idx2 : group) {
-        if (idx1 == idx2) {
-          continue;
+      for_each_candidate(idx1, [&](std::size_t idx2) {
+        if (!maximum || (idx1 == idx2)) {
+          return;
         }
-
-        if (is_neighbour(hits[idx1], hits[idx2]) && (hits[idx2].getEnergy() > hits[idx1].getEnergy())) {
+        const float energy2 = energies[idx2];
+        // not in the group
+        if (energy2 < m_cfg.minClusterHitEdep) {
+          return;
+        }
+        if ((energy2 > energy1) && neighbour(idx1, idx2)) {
           maximum = false;
-          break;
         }
-      }
+      });
 
       if (maximum) {
         maxima.push_back(idx1);
       }
     }
-
-    return maxima;
   }
     // helper function
-    inline static void vec_normalize(std::vector<double>& vals) {
+    inline static void vec_normalize(std::span<double> vals) {
         double total = 0.;
         for (auto& val : vals) {
             total += val;
@@ -165,8 +225,11 @@ namespace eicrecon {
     }
 
     // split a group of hits according to the local maxima
+    // weights is a scratch buffer, the profile weights of all (hit, maximum) pairs
+    // are computed over the contiguous coordinate arrays before any normalization
     //TODO: confirm protoclustering without protoclustercollection
-  void split_group(const edm4eic::CalorimeterHitCollection &hits, std::set<std::size_t>& group, const std::vector<std::size_t>& maxima, edm4eic::ProtoClusterCollection *protoClusters) const {
+  template <typename ProfileMetric>
+  void split_group(const edm4eic::CalorimeterHitCollection &hits, std::span<const float> energies, std::span<const std::size_t> group, std::span<const std::size_t> maxima, const ProfileCoords &coords, std::vector<double> &weights, edm4eic::ProtoClusterCollection *protoClusters) const {
     // special cases
     if (maxima.empty()) {
       debug("No maxima found, not building any clusters");
@@ -185,40 +248,57 @@ namespace eicrecon {
 
     // split between maxima
     // TODO, here we can implement iterations with profile, or even ML for better splits
-    std::vector<double> weights(maxima.size(), 1.);
+    const std::size_t n_maxima = maxima.size();
     std::vector<edm4eic::MutableProtoCluster> pcls;
-    for (size_t k = 0; k < maxima.size(); ++k) {
+    pcls.reserve(n_maxima);
+    for (size_t k = 0; k < n_maxima; ++k) {
       pcls.push_back(protoClusters->create());
     }
 
-    for (std::size_t idx : group) {
-      size_t j = 0;
-      // calculate weights for local maxima
-      for (std::size_t cidx : maxima) {
-        double energy   = hits[cidx].getEnergy();
-        double dist     = edm4hep::utils::magnitude(transverseEnergyProfileMetric(hits[cidx], hits[idx]));
-        weights[j]      = std::exp(-dist * transverseEnergyProfileScaleUnits / m_cfg.transverseEnergyProfileScale) * energy;
-        j += 1;
+    // calculate weights for local maxima, weights[i * n_maxima + k] for hit group[i]
+    weights.resize(group.size() * n_maxima);
+    for (size_t k = 0; k < n_maxima; ++k) {
+      const std::size_t cidx = maxima[k];
+      const double energy = energies[cidx];
+      const float center_a = coords.a[cidx];
+      const float center_b = coords.b[cidx];
+      for (size_t i = 0; i < group.size(); ++i) {
+        const std::size_t idx = group[i];
+        float delta_a = center_a - coords.a[idx];
+        float delta_b = center_b - coords.b[idx];
+        if constexpr (ProfileMetric::dim_scaled) {
+          delta_a = 2 * delta_a / (coords.dim_a[cidx] + coords.dim_a[idx]);
+          delta_b = 2 * delta_b / (coords.dim_b[cidx] + coords.dim_b[idx]);
+        }
+        if constexpr (ProfileMetric::azimuthal) {
+          delta_b = static_cast<float>(std::remainder(delta_b, 2 * M_PI));
+        }
+        const float dist = std::sqrt(delta_a * delta_a + delta_b * delta_b);
+        weights[i * n_maxima + k] = std::exp(-dist * transverseEnergyProfileScaleUnits / m_cfg.transverseEnergyProfileScale) * energy;
       }
+    }
+
+    for (size_t i = 0; i < group.size(); ++i) {
+      std::span<double> hit_weights(weights.data() + i * n_maxima, n_maxima);
 
       // normalize weights
-      vec_normalize(weights);
+      vec_normalize(hit_weights);
 
       // ignore small weights
-      for (auto& w : weights) {
+      for (auto& w : hit_weights) {
         if (w < 0.02) {
           w = 0;
         }
       }
-      vec_normalize(weights);
+      vec_normalize(hit_weights);
 
       // split energy between local maxima
-      for (size_t k = 0; k < maxima.size(); ++k) {
-        double weight = weights[k];
+      for (size_t k = 0; k < n_maxima; ++k) {
+        double weight = hit_weights[k];
         if (weight <= 1e-6) {
           continue;
         }
-        pcls[k].addToHits(hits[idx]);
+        pcls[k].addToHits(hits[group[i]]);
         pcls[k].addToWeights(weight);
       }
     }
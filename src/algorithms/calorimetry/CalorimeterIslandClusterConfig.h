@@ -9,6 +9,9 @@ namespace eicrecon {
 
     struct CalorimeterIslandClusterConfig {
 
+        // "table" to take the neighbours from the readout neighbour table,
+        // otherwise adjacencyMatrix or the neighbour checking distances are used
+        std::string adjacency;
         std::string adjacencyMatrix;
         std::string readout;
 
@@ -21,6 +24,14 @@ namespace eicrecon {
         std::vector<double> globalDistEtaPhi;
         std::vector<double> dimScaledLocalDistXY;
 
+        // "bfs" groups the hits with a breadth-first search (the reference),
+        // "components" tests the neighbour pairs of up to groupingTasks blocks of hits
+        // in parallel and joins them as connected components, with the same groups
+        std::string grouping{"bfs"};
+        int groupingTasks{4};
+        // of at least groupingMinHitsPerTask hits, smaller events are grouped on one thread
+        int groupingMinHitsPerTask{1024};
+
         bool splitCluster{false};
         double minClusterHitEdep;
         double minClusterCenterEdep;
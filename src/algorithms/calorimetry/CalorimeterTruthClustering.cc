@@ -10,7 +10,9 @@
 #include <cstddef>
 #include <cstdint>
 #include <gsl/pointers>
-#include <map>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
 using namespace dd4hep;
 
@@ -25,11 +27,20 @@ namespace eicrecon {
     const auto [hits, mc] = input;
     auto [clusters] = output;
 
-    // Map mc track ID to protoCluster index
-    std::map<int32_t, int32_t> protoIndex;
+    // Map mc track ID to protoCluster index, the protoClusters are in the
+    // order of the first hit of their mc track
+    std::unordered_map<int32_t, std::size_t> protoIndex;
+    // protoCluster of every hit, npos for a hit without truth
+    constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> hitProto(hits->size(), npos);
+
+    // Index of the first mc hit of every cellID, built for the first hit
+    // that is not in a collection
+    std::unordered_map<uint64_t, std::size_t> mcByCellID;
 
     // Loop over all calorimeter hits and sort per mcparticle
-    for (const auto& hit : *hits) {
+    for (std::size_t i = 0; i < hits->size(); ++i) {
+        const auto hit = (*hits)[i];
         // The original algorithm used the following to get the mcHit:
         //
         //    const auto& mcHit     = mc[hit->getObjectID().index];
@@ -43,8 +54,8 @@ namespace eicrecon {
         //
         // The way we handle this is here is to check if getObjectID().index
         // is within the size limits of mc which includes >=0. If so, then
-        // assume the old code is valid. If not, then we need to search
-        // for the right hit.
+        // assume the old code is valid. If not, then we need to look up
+        // the right hit by its cellID.
         // FIXME: This is clearly not the right way to do this! Podio needs
         // FIXME: to be fixed so proper object tracking can be done without
         // FIXME: requiring Collection classes be used to manage all objects.
@@ -52,29 +63,35 @@ namespace eicrecon {
         if ((hit.getObjectID().index >= 0) && (hit.getObjectID().index < mc->size())) {
             mcIndex = hit.getObjectID().index;
         } else {
-            mcIndex = 0;
-            bool success = false;
-            for (auto tmpmc : *mc) {
-                if (tmpmc.getCellID() == hit.getCellID()) {
-                    success = true;
-                    break;
+            if (mcByCellID.empty()) {
+                mcByCellID.reserve(mc->size());
+                for (std::size_t ix = 0; ix < mc->size(); ++ix) {
+                    mcByCellID.emplace((*mc)[ix].getCellID(), ix);
                 }
-                mcIndex++;
             }
-            if (not success) {
+            auto it = mcByCellID.find(hit.getCellID());
+            if (it == mcByCellID.end()) {
                 continue; // ignore hit if we couldn't match it to truth hit
             }
+            mcIndex = it->second;
         }
 
         const auto &trackID = (*mc)[mcIndex].getContributions(0).getParticle().getObjectID().index;
-        // Create a new protocluster if we don't have one for this trackID
-        if (protoIndex.count(trackID) == 0) {
-            clusters->create();
-            protoIndex[trackID] = clusters->size() - 1;
+        // Assign a new protocluster if we don't have one for this trackID
+        hitProto[i] = protoIndex.emplace(trackID, protoIndex.size()).first->second;
+    }
+
+    // Add the hits to their protoclusters
+    std::vector<edm4eic::MutableProtoCluster> protos;
+    protos.reserve(protoIndex.size());
+    for (std::size_t p = 0; p < protoIndex.size(); ++p) {
+        protos.push_back(clusters->create());
+    }
+    for (std::size_t i = 0; i < hits->size(); ++i) {
+        if (hitProto[i] != npos) {
+            protos[hitProto[i]].addToHits((*hits)[i]);
+            protos[hitProto[i]].addToWeights(1);
         }
-        // Add hit to the appropriate protocluster
-        (*clusters)[protoIndex[trackID]].addToHits(hit);
-        (*clusters)[protoIndex[trackID]].addToWeights(1);
     }
 
   }
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <edm4eic/Cluster.h>
+#include <edm4eic/MCRecoClusterParticleAssociationCollection.h>
+#include <podio/ObjectID.h>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+namespace eicrecon {
+
+  /** Lookup of the MC association of a reconstructed cluster.
+   *
+   * Built once per event, replaces a linear search of the association
+   * collection for every cluster. Like the linear search, the first
+   * association that refers to a cluster is returned.
+   */
+  class ClusterAssociationIndex {
+  public:
+    explicit ClusterAssociationIndex(const edm4eic::MCRecoClusterParticleAssociationCollection& associations)
+      : m_associations(associations) {
+      m_index.reserve(associations.size());
+      for (std::size_t i = 0; i < associations.size(); ++i) {
+        m_index.emplace(key(associations[i].getRec().getObjectID()), i);
+      }
+    }
+
+    std::optional<edm4eic::MCRecoClusterParticleAssociation> find(const edm4eic::Cluster& cluster) const {
+      auto it = m_index.find(key(cluster.getObjectID()));
+      if (it == m_index.end()) {
+        return std::nullopt;
+      }
+      return m_associations[it->second];
+    }
+
+  private:
+    static std::uint64_t key(const podio::ObjectID& id) {
+      return (static_cast<std::uint64_t>(id.collectionID) << 32) | static_cast<std::uint32_t>(id.index);
+    }
+
+    const edm4eic::MCRecoClusterParticleAssociationCollection& m_associations;
+    std::unordered_map<std::uint64_t, std::size_t> m_index;
+  };
+
+} // namespace eicrecon
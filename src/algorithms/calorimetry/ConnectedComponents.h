@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace eicrecon {
+
+  /** Groups of neighbouring hits as the connected components of the neighbour graph.
+   *
+   * This is the data parallel counterpart of the breadth-first grouping of the
+   * clustering algorithms. The candidate pairs of every hit are tested
+   * independently of the other hits, in `tasks` contiguous blocks of at least
+   * `min_hits_per_task` hits, of which the first runs on the calling thread.
+   * The neighbour pairs are then joined with a union-find whose roots are the
+   * smallest hit index of their component, so that the result does not depend
+   * on the number of tasks.
+   *
+   * For a symmetric neighbour relation, which all the distance and table
+   * criteria are, the components are the groups of the breadth-first search.
+   */
+  class ConnectedComponents {
+  public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    /// Fewest hits per task, smaller events are not worth the threads
+    explicit ConnectedComponents(std::size_t min_hits_per_task = 1024)
+      : m_min_hits_per_task(std::max<std::size_t>(min_hits_per_task, 1)) {}
+
+    /// qualified(idx) is whether hit idx takes part, for_each_candidate(idx1, f) has to
+    /// call f(idx2) at least for all neighbours idx2 of idx1, neighbour(idx1, idx2) tests a pair
+    template <typename QualifiedFn, typename CandidatesFn, typename NeighbourFn>
+    void build(std::size_t n, std::size_t tasks, QualifiedFn&& qualified, CandidatesFn&& for_each_candidate, NeighbourFn&& neighbour) {
+      m_parent.resize(n);
+      std::iota(m_parent.begin(), m_parent.end(), std::size_t{0});
+      m_qualified.assign(n, false);
+      for (std::size_t i = 0; i < n; ++i) {
+        m_qualified[i] = qualified(i);
+      }
+
+      tasks = std::clamp<std::size_t>(tasks, 1, std::max<std::size_t>(1, n / m_min_hits_per_task));
+      std::vector<std::vector<std::pair<std::size_t, std::size_t>>> pairs(tasks);
+      auto collect = [&](std::size_t t) {
+        for (std::size_t idx1 = n * t / tasks; idx1 < n * (t + 1) / tasks; ++idx1) {
+          if (!m_qualified[idx1]) {
+            continue;
+          }
+          for_each_candidate(idx1, [&](std::size_t idx2) {
+            // every pair is tested once, from its smaller index
+            if ((idx2 > idx1) && m_qualified[idx2] && neighbour(idx1, idx2)) {
+              pairs[t].emplace_back(idx1, idx2);
+            }
+          });
+        }
+      };
+      std::vector<std::future<void>> futures;
+      for (std::size_t t = 1; t < tasks; ++t) {
+        futures.push_back(std::async(std::launch::async, collect, t));
+      }
+      collect(0);
+      for (auto& future : futures) {
+        future.get();
+      }
+
+      for (const auto& block : pairs) {
+        for (const auto& [idx1, idx2] : block) {
+          unite(idx1, idx2);
+        }
+      }
+      for (std::size_t i = 0; i < n; ++i) {
+        m_parent[i] = find(i);
+      }
+    }
+
+    /// Appends the components with at least one seed(idx) hit to the flat group storage,
+    /// group g is group_hits[group_offsets[g]:group_offsets[g + 1]]. The groups are in the
+    /// order of their smallest seed, the hits of a group in ascending order, as with the
+    /// breadth-first search from the seeds in ascending order
+    template <typename SeedFn>
+    void groups(SeedFn&& seed, std::vector<std::size_t>& group_hits, std::vector<std::size_t>& group_offsets) const {
+      const std::size_t n = m_parent.size();
+      std::vector<std::size_t> slot(n, npos);
+      std::size_t n_groups = 0;
+      for (std::size_t i = 0; i < n; ++i) {
+        if (m_qualified[i] && (slot[m_parent[i]] == npos) && seed(i)) {
+          slot[m_parent[i]] = n_groups++;
+        }
+      }
+
+      // counting sort of the hits by group, which keeps their ascending order
+      std::vector<std::size_t> offsets(n_groups + 1, 0);
+      for (std::size_t i = 0; i < n; ++i) {
+        if (m_qualified[i] && (slot[m_parent[i]] != npos)) {
+          ++offsets[slot[m_parent[i]] + 1];
+        }
+      }
+      std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+      const std::size_t begin = group_hits.size();
+      group_hits.resize(begin + offsets.back());
+      std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+      for (std::size_t i = 0; i < n; ++i) {
+        if (m_qualified[i] && (slot[m_parent[i]] != npos)) {
+          group_hits[begin + next[slot[m_parent[i]]]++] = i;
+        }
+      }
+      for (std::size_t g = 0; g < n_groups; ++g) {
+        group_offsets.push_back(begin + offsets[g + 1]);
+      }
+    }
+
+  private:
+    std::size_t find(std::size_t i) {
+      while (m_parent[i] != i) {
+        // path halving
+        m_parent[i] = m_parent[m_parent[i]];
+        i = m_parent[i];
+      }
+      return i;
+    }
+
+    void unite(std::size_t i, std::size_t j) {
+      i = find(i);
+      j = find(j);
+      if (i > j) {
+        std::swap(i, j);
+      }
+      // the smaller index stays the root
+      m_parent[j] = i;
+    }
+
+    std::size_t m_min_hits_per_task;
+    std::vector<std::size_t> m_parent;
+    std::vector<bool> m_qualified;
+  };
+
+} // namespace eicrecon
@@ -3,7 +3,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <limits>
+#include <numeric>
+#include <optional>
+#include <vector>
 
 #include <algorithms/algorithm.h>
 #include <fmt/format.h>
@@ -13,7 +19,9 @@
 #include <edm4hep/utils/vector_utils.h>
 
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "ClusterAssociationIndex.h"
 #include "EnergyPositionClusterMergerConfig.h"
+#include "NeighbourGrid.h"
 
 namespace eicrecon {
 
@@ -72,15 +80,54 @@ namespace eicrecon {
 
         std::vector<bool> consumed(energy_clus->size(), false);
 
+        // index the energy clusters in eta and phi, with cells as wide as the
+        // tolerances, so that only nearby energy clusters need to be evaluated
+        NeighbourGrid<2> grid;
+        grid.configure({
+            (m_cfg.etaTolerance > 0) ? NeighbourGridAxis::linear(m_cfg.etaTolerance * grid_margin)
+                                     : NeighbourGridAxis::none(),
+            (m_cfg.phiTolerance > 0) ? NeighbourGridAxis::periodic(m_cfg.phiTolerance * grid_margin, 2 * M_PI, -M_PI)
+                                     : NeighbourGridAxis::none()
+        });
+        grid.reserve(energy_clus->size());
+        // clusters without a finite direction are evaluated against every position cluster
+        std::vector<size_t> unbinned;
+        for (size_t ie = 0; ie < energy_clus->size(); ++ie) {
+            const auto coords = etaPhi((*energy_clus)[ie]);
+            if (std::isfinite(coords[0]) && std::isfinite(coords[1])) {
+                grid.insert(coords, ie);
+            } else {
+                unbinned.push_back(ie);
+            }
+        }
+        grid.build();
+
+        const ClusterAssociationIndex energy_assoc_index(*energy_assoc);
+        const ClusterAssociationIndex pos_assoc_index(*pos_assoc);
+
+        std::vector<size_t> candidates;
+
         // use position clusters as starting point
         for (const auto& pc : *pos_clus) {
 
             trace(" --> Processing position cluster {}, energy: {}", pc.getObjectID().index, pc.getEnergy());
 
+            // energy clusters that may be within tolerance, in the order of the collection
+            candidates.clear();
+            const auto pc_coords = etaPhi(pc);
+            if (std::isfinite(pc_coords[0]) && std::isfinite(pc_coords[1])) {
+                grid.for_each_neighbour(pc_coords, [&candidates](size_t ie) { candidates.push_back(ie); });
+                candidates.insert(candidates.end(), unbinned.begin(), unbinned.end());
+                std::sort(candidates.begin(), candidates.end());
+            } else {
+                candidates.resize(energy_clus->size());
+                std::iota(candidates.begin(), candidates.end(), 0);
+            }
+
             // check if we find a good match
             int best_match    = -1;
             double best_delta = std::numeric_limits<double>::max();
-            for (size_t ie = 0; ie < energy_clus->size(); ++ie) {
+            for (size_t ie : candidates) {
                 if (consumed[ie]) {
                     continue;
                 }
@@ -134,22 +181,12 @@ namespace eicrecon {
                 trace("   --> Created a new combined cluster {}, energy: {}", new_clus.getObjectID().index, new_clus.getEnergy() );
 
                 // find association from energy cluster
-                auto ea = energy_assoc->begin();
-                for (; ea != energy_assoc->end(); ++ea) {
-                    if (ea->getRec() == ec) {
-                        break;
-                    }
-                }
+                const auto ea = energy_assoc_index.find(ec);
                 // find association from position cluster if different
-                auto pa = pos_assoc->begin();
-                for (; pa != pos_assoc->end(); ++pa) {
-                    if (pa->getRec() == pc) {
-                        break;
-                    }
-                }
-                if (ea != energy_assoc->end() || pa != pos_assoc->end()) {
+                const auto pa = pos_assoc_index.find(pc);
+                if (ea.has_value() || pa.has_value()) {
                     // we must write an association
-                    if (ea != energy_assoc->end() && pa != pos_assoc->end()) {
+                    if (ea.has_value() && pa.has_value()) {
                         // we have two associations
                         if (pa->getSimID() == ea->getSimID()) {
                             // both associations agree on the MCParticles entry
@@ -175,7 +212,7 @@ namespace eicrecon {
                             clusterassoc2.setRec(new_clus);
                             clusterassoc2.setSim(pa->getSim());
                         }
-                    } else if (ea != energy_assoc->end()) {
+                    } else if (ea.has_value()) {
                         // no position association
                         debug("   --> Only added energy cluster association to {}", ea->getSimID());
                         auto clusterassoc = merged_assoc->create();
@@ -184,7 +221,7 @@ namespace eicrecon {
                         clusterassoc.setWeight(1.0);
                         clusterassoc.setRec(new_clus);
                         clusterassoc.setSim(ea->getSim());
-                    } else if (pa != pos_assoc->end()) {
+                    } else if (pa.has_value()) {
                         // no energy association
                         debug("   --> Only added position cluster association to {}", pa->getSimID());
                         auto clusterassoc = merged_assoc->create();
@@ -216,6 +253,14 @@ namespace eicrecon {
 
         }
     }
+
+  private:
+    // widen the grid cells a little, so that rounding can not hide matches
+    static constexpr double grid_margin = 1. + 1e-4;
+
+    static std::array<double, 2> etaPhi(const edm4eic::Cluster& cluster) {
+        return {edm4hep::utils::eta(cluster.getPosition()), edm4hep::utils::angleAzimuthal(cluster.getPosition())};
+    }
   };
 
 } // namespace eicrecon
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <bit>
+#include <cfloat>
+#include <cstdint>
+
+namespace eicrecon::fast_math {
+
+  /// |log(x) - ln(x)| <= log_error * max(|ln(x)|, 1) for all positive normal floats
+  constexpr float log_error = 2 * FLT_EPSILON;
+
+  /**
+   * Natural logarithm in single precision, for the loops over the hit energies
+   * of a cluster. The exponent is taken from the bits, the mantissa m is reduced
+   * to [sqrt(1/2), sqrt(2)) and log(m) = 2 atanh(s), s = (m - 1) / (m + 1), is a
+   * polynomial in s. Zero and negative arguments give -inf, which compares below
+   * every weight like the -inf and NaN of std::log.
+   *
+   * The selections are bit masks rather than conditionals: with the default
+   * -ftrapping-math the compilers do not if-convert a floating point select,
+   * and the loop would not vectorise.
+   */
+  inline float log(float x) {
+    const auto bits = std::bit_cast<std::uint32_t>(x);
+    // 0x3f3504f3 is sqrt(1/2)
+    const std::uint32_t offset = bits - 0x3f3504f3u;
+    const auto exponent = static_cast<float>(static_cast<std::int32_t>(offset) >> 23);
+    const float m = std::bit_cast<float>((offset & 0x007fffffu) + 0x3f3504f3u);
+    const float s = (m - 1.f) / (m + 1.f);
+    const float s2 = s * s;
+    const float log_m = s * (2.f + s2 * (2.f / 3 + s2 * (2.f / 5 + s2 * (2.f / 7 + s2 * (2.f / 9)))));
+    const float result = exponent * 0.693147180559945f + log_m;
+    // all ones for a positive x, -inf otherwise
+    const auto positive = static_cast<std::uint32_t>(-static_cast<std::int32_t>(static_cast<std::int32_t>(bits) > 0));
+    constexpr std::uint32_t minus_inf = 0xff800000u;
+    return std::bit_cast<float>((std::bit_cast<std::uint32_t>(result) & positive) | (minus_inf & ~positive));
+  }
+
+  /// max(0, base + log(ratio)), the logarithmic weight of a hit with a fraction `ratio` of the cluster energy
+  inline float log_weight(float ratio, float base) {
+    const auto bits = std::bit_cast<std::uint32_t>(base + log(ratio));
+    // zero for a negative sum
+    return std::bit_cast<float>(bits & ~static_cast<std::uint32_t>(static_cast<std::int32_t>(bits) >> 31));
+  }
+
+} // namespace eicrecon::fast_math
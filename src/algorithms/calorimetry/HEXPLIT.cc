@@ -7,22 +7,29 @@
 #include <DD4hep/Alignments.h>
 #include <DD4hep/DetElement.h>
 #include <DD4hep/Objects.h>
-#include <DD4hep/VolumeManager.h>
 #include <Evaluator/DD4hepUnits.h>
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/DisplacementVector3D.h>
+#include <algorithms/service.h>
 #include <edm4hep/Vector3f.h>
 #include <stdlib.h>
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <gsl/pointers>                            // for not_null
 #include <vector>
 
 #include "HEXPLIT.h"
+#include "NeighbourGrid.h"
 #include "algorithms/calorimetry/HEXPLITConfig.h"
+#include "services/geometry/cellid_cache/CellIDGeometryCacheSvc.h"
 
 namespace eicrecon {
 
+// widen the grid cells a little, so that rounding can not hide neighbors
+static constexpr double grid_margin = 1. + 1e-4;
+
 //positions where the overlapping cells are relative to a given cell (in units of hexagon side length)
 const std::vector<double> HEXPLIT::neighbor_offsets_x =[]() {
   std::vector<double> x;
@@ -73,7 +80,10 @@ const std::vector<double> HEXPLIT::subcell_offsets_y =[]() {
   return y;
 }();
 
-void HEXPLIT::init() { }
+void HEXPLIT::init() {
+  auto& serviceSvc = algorithms::ServiceSvc::instance();
+  m_geo_cache = serviceSvc.service<CellIDGeometryCacheSvc>("CellIDGeometryCacheSvc");
+}
 
 void HEXPLIT::process(const HEXPLIT::Input& input,
                       const HEXPLIT::Output& output) const {
@@ -85,7 +95,29 @@ void HEXPLIT::process(const HEXPLIT::Input& input,
   double Emin=m_cfg.Emin_in_MIPs*MIP;
   double tmax=m_cfg.tmax/dd4hep::ns;
 
-  auto volman = m_detector->volumeManager();
+  // index the hits that pass the cuts by layer and local position, so that only
+  // the hits near the neighboring cell locations need to be checked
+  double max_sl=0;
+  for(const auto& hit : *hits){
+    if (hit.getEnergy()<Emin || hit.getTime()>tmax)
+      continue;
+    max_sl=std::max(max_sl, hit.getDimension().x/2.);
+  }
+  NeighbourGrid<3> grid;
+  grid.configure({
+      NeighbourGridAxis::exact(2),
+      NeighbourGridAxis::linear(2*max_sl*grid_margin),
+      NeighbourGridAxis::linear(sqrt(3)*max_sl*grid_margin)
+  });
+  grid.reserve(hits->size());
+  for(std::size_t ix=0; ix<hits->size(); ix++){
+    const auto& hit=(*hits)[ix];
+    if (hit.getEnergy()<Emin || hit.getTime()>tmax)
+      continue;
+    grid.insert({static_cast<double>(hit.getLayer()), hit.getLocal().x, hit.getLocal().y}, ix);
+  }
+  grid.build();
+  std::vector<std::size_t> candidates;
 
   for(const auto& hit : *hits){
     //skip hits that do not pass E and t cuts
@@ -93,10 +125,17 @@ void HEXPLIT::process(const HEXPLIT::Input& input,
       continue;
 
     //keep track of the energy in each neighboring cell
-    std::vector<double> Eneighbors(NEIGHBORS, 0.0);
+    std::array<double, NEIGHBORS> Eneighbors;
+    Eneighbors.fill(0.0);
 
     double sl = hit.getDimension().x/2.;
-    for (const auto& other_hit : *hits){
+    // candidates in the order of the collection, to sum the energies in the same order
+    candidates.clear();
+    grid.for_each_neighbour({static_cast<double>(hit.getLayer()), hit.getLocal().x, hit.getLocal().y},
+                            [&candidates](std::size_t ix) { candidates.push_back(ix); });
+    std::sort(candidates.begin(), candidates.end());
+    for (auto ix : candidates){
+      const auto& other_hit=(*hits)[ix];
       // maximum distance between where the neighboring cell is and where it should be
       // based on an ideal geometry using the staggered tessellation pattern.
       // Deviations could arise from rounding errors or from detector misalignment.
@@ -123,13 +162,22 @@ void HEXPLIT::process(const HEXPLIT::Input& input,
         }
       }
     }
-    double weights[SUBCELLS];
     for(int k=0; k<NEIGHBORS; k++){
       Eneighbors[k]=std::max(Eneighbors[k],MIP);
     }
+    // gather the overlapping energies first, so that the products are a plain loop
+    std::array<std::array<double, SUBCELLS>, OVERLAP> Eoverlap;
+    for(int i=0; i<OVERLAP; i++){
+      for(int k=0; k<SUBCELLS; k++){
+        Eoverlap[i][k]=Eneighbors[neighbor_indices[k][i]];
+      }
+    }
+    std::array<double, SUBCELLS> weights;
+    for(int k=0; k<SUBCELLS; k++){
+      weights[k]=Eoverlap[0][k]*Eoverlap[1][k]*Eoverlap[2][k];
+    }
     double sum_weights=0;
     for(int k=0; k<SUBCELLS; k++){
-      weights[k]=Eneighbors[neighbor_indices[k][0]]*Eneighbors[neighbor_indices[k][1]]*Eneighbors[neighbor_indices[k][2]];
       sum_weights+=weights[k];
     }
     for(int k=0; k<SUBCELLS;k++){
@@ -147,7 +195,7 @@ void HEXPLIT::process(const HEXPLIT::Input& input,
       try {
 
         //also convert this to the detector's global coordinates.  To do: check if this is correct
-        auto alignment = volman.lookupDetElement(hit.getCellID()).nominal();
+        auto alignment = m_geo_cache->detElement(hit.getCellID()).nominal();
 
         global_position = alignment.localToWorld(local_position);
 
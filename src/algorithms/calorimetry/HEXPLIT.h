@@ -20,6 +20,7 @@
 
 #include "HEXPLITConfig.h"
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "services/geometry/cellid_cache/CellIDGeometryCacheSvc.h"
 
 namespace eicrecon {
 
@@ -64,6 +65,7 @@ using HEXPLITAlgorithm = algorithms::Algorithm<
 
   private:
     const dd4hep::Detector* m_detector{algorithms::GeoSvc::instance().detector()};
+    CellIDGeometryCacheSvc* m_geo_cache{nullptr};
 
   };
 
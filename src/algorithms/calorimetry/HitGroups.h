@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace eicrecon {
+
+  /** Grouping of hit indices by a 64-bit key (usually a masked cellID).
+   *
+   * The (key, index) pairs are sorted into one flat array, groups are the runs
+   * of equal keys. Compared to a map of vectors this needs a fixed number of
+   * allocations per event, and the groups are visited in a deterministic order:
+   * ascending key, with the indices of a group in ascending order.
+   */
+  class HitGroups {
+  public:
+    struct Group {
+      std::uint64_t id;
+      std::span<const std::size_t> indices;
+    };
+
+    class const_iterator {
+    public:
+      const_iterator(const HitGroups* groups, std::size_t i) : m_groups(groups), m_i(i) {}
+      Group operator*() const { return (*m_groups)[m_i]; }
+      const_iterator& operator++() {
+        ++m_i;
+        return *this;
+      }
+      bool operator==(const const_iterator& other) const { return m_i == other.m_i; }
+      bool operator!=(const const_iterator& other) const { return m_i != other.m_i; }
+
+    private:
+      const HitGroups* m_groups;
+      std::size_t m_i;
+    };
+
+    /// Group the elements of `hits` by `key(hit)`
+    template <typename Collection, typename Key>
+    void build(const Collection& hits, Key&& key) {
+      m_entries.clear();
+      m_entries.reserve(hits.size());
+      std::size_t ix = 0;
+      for (const auto& hit : hits) {
+        m_entries.emplace_back(key(hit), ix++);
+      }
+      std::sort(m_entries.begin(), m_entries.end());
+
+      m_indices.resize(m_entries.size());
+      m_runs.clear();
+      for (std::size_t i = 0; i < m_entries.size(); ++i) {
+        if (m_runs.empty() || (m_entries[i].first != m_runs.back().first)) {
+          m_runs.emplace_back(m_entries[i].first, i);
+        }
+        m_indices[i] = m_entries[i].second;
+      }
+    }
+
+    /// Reorder the indices within every group, ties keep the ascending index order
+    template <typename Compare>
+    void sort_each(Compare&& comp) {
+      for (std::size_t g = 0; g < m_runs.size(); ++g) {
+        std::stable_sort(m_indices.begin() + run_begin(g), m_indices.begin() + run_end(g), comp);
+      }
+    }
+
+    std::size_t size() const { return m_runs.size(); }
+    bool empty() const { return m_runs.empty(); }
+
+    Group operator[](std::size_t g) const {
+      return {m_runs[g].first, std::span<const std::size_t>(m_indices).subspan(run_begin(g), run_end(g) - run_begin(g))};
+    }
+
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, m_runs.size()}; }
+
+  private:
+    std::size_t run_begin(std::size_t g) const { return m_runs[g].second; }
+    std::size_t run_end(std::size_t g) const {
+      return (g + 1 < m_runs.size()) ? m_runs[g + 1].second : m_indices.size();
+    }
+
+    std::vector<std::pair<std::uint64_t, std::size_t>> m_entries;
+    std::vector<std::size_t> m_indices;
+    // key and first position in m_indices of every group
+    std::vector<std::pair<std::uint64_t, std::size_t>> m_runs;
+  };
+
+} // namespace eicrecon
@@ -10,8 +10,16 @@
 
 #pragma once
 
-#include <Eigen/Dense>
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <algorithms/algorithm.h>
 #include <DDRec/CellIDPositionConverter.h>
@@ -19,6 +27,7 @@
 #include <DDRec/SurfaceManager.h>
 
 #include "algorithms/calorimetry/ClusterTypes.h"
+#include "algorithms/calorimetry/SymmetricEigen.h"
 
 // Event Model related classes
 #include <edm4hep/MCParticleCollection.h>
@@ -66,6 +75,9 @@ namespace eicrecon {
 
   public:
 
+    /// Fewest hits per task, smaller events are not worth the threads
+    static constexpr std::size_t min_hits_per_task = 1024;
+
     void init()  { }
 
     void process(const Input& input, const Output& output) const final {
@@ -73,23 +85,106 @@ namespace eicrecon {
         const auto [proto, mchits] = input;
         auto [clusters, associations, layers] = output;
 
-        for (const auto& pcl: *proto) {
-            if (!pcl.getHits().empty() && !pcl.getHits(0).isAvailable()) {
+        // the sums of each proto-cluster, in reconstructionTasks blocks of about
+        // the same number of hits, of which the first runs on the calling thread
+        std::vector<ClusterSums> sums(proto->size());
+        std::size_t n_hits = 0;
+        for (std::size_t k = 0; k < proto->size(); ++k) {
+            const auto pcl = (*proto)[k];
+            sums[k].valid = pcl.getHits().empty() || pcl.getHits(0).isAvailable();
+            if (sums[k].valid) {
+                n_hits += pcl.hits_size();
+            }
+        }
+        const std::size_t tasks =
+            std::clamp<std::size_t>(std::max(1, m_cfg.reconstructionTasks), 1, std::max<std::size_t>(1, n_hits / min_hits_per_task));
+        std::vector<std::size_t> block_begin(tasks + 1, proto->size());
+        block_begin[0] = 0;
+        for (std::size_t k = 0, t = 1, hits_before = 0; k < proto->size() && t < tasks; ++k) {
+            if (hits_before >= n_hits * t / tasks) {
+                block_begin[t++] = k;
+            }
+            if (sums[k].valid) {
+                hits_before += (*proto)[k].hits_size();
+            }
+        }
+        auto summarize_block = [&](std::size_t t) {
+            HitBuffer buf;
+            for (std::size_t k = block_begin[t]; k < block_begin[t + 1]; ++k) {
+                if (sums[k].valid) {
+                    if (m_cfg.singlePrecision) {
+                        summarize<float>((*proto)[k], buf, sums[k]);
+                    } else {
+                        summarize<double>((*proto)[k], buf, sums[k]);
+                    }
+                }
+            }
+        };
+        std::vector<std::future<void>> futures;
+        for (std::size_t t = 1; t < tasks; ++t) {
+            futures.push_back(std::async(std::launch::async, summarize_block, t));
+        }
+        summarize_block(0);
+        for (auto& future : futures) {
+            future.get();
+        }
+
+        // index of the first mchit of every CellID
+        std::unordered_map<std::uint64_t, std::size_t> mchit_index;
+        if (mchits->size() > 0) {
+            mchit_index.reserve(mchits->size());
+            for (std::size_t ix = 0; ix < mchits->size(); ++ix) {
+                mchit_index.emplace((*mchits)[ix].getCellID(), ix);
+            }
+        }
+
+        for (std::size_t k = 0; k < proto->size(); ++k) {
+            const auto pcl = (*proto)[k];
+            const auto& cl_sums = sums[k];
+            if (!cl_sums.valid) {
                 warning("Protocluster hit relation is invalid, skipping protocluster");
                 continue;
             }
-            // get cluster and associated layers
-            auto cl = reconstruct_cluster(pcl);
-            auto cl_layers = reconstruct_cluster_layers(pcl);
+            const auto hits = pcl.getHits();
 
-            // Get cluster direction from the layer profile
-            auto [theta, phi] = fit_track(cl_layers);
-            cl.setIntrinsicTheta(theta);
-            cl.setIntrinsicPhi(phi);
+            // get cluster and associated layers
+            edm4eic::MutableCluster cl;
+            cl.setType(Jug::Reco::ClusterType::kCluster3D);
+            for (const auto& hit : hits) {
+                cl.addToHits(hit);
+            }
+            cl.setEnergy(cl_sums.energy);
+            cl.setEnergyError(cl_sums.energyError);
+            cl.setTime(cl_sums.time);
+            cl.setTimeError(cl_sums.timeError);
+            cl.setNhits(hits.size());
+            cl.setPosition(cl_sums.position);
+            cl.addToShapeParameters(cl_sums.radius);
+            // Skewedness not calculated TODO
+
+            // Cluster direction from the layer profile
+            cl.setIntrinsicTheta(cl_sums.theta);
+            cl.setIntrinsicPhi(cl_sums.phi);
             // no error on the intrinsic direction TODO
 
             // store layer and clusters on the datastore
-            for (const auto& layer: cl_layers) {
+            for (const auto& layer_sums : cl_sums.layers) {
+                edm4eic::MutableCluster layer;
+                layer.setType(Jug::Reco::ClusterType::kClusterSlice);
+                for (std::size_t i = layer_sums.begin; i < layer_sums.end; ++i) {
+                    layer.addToHits(hits[cl_sums.order[i]]);
+                }
+                layer.setEnergy(layer_sums.energy);
+                layer.setEnergyError(layer_sums.energyError);
+                layer.setTime(layer_sums.time);
+                layer.setTimeError(layer_sums.timeError);
+                layer.setNhits(layer_sums.end - layer_sums.begin);
+                layer.setPosition(layer_sums.position);
+                // positionError not set
+                // Intrinsic direction meaningless in a cluster layer --> not set
+                layer.addToShapeParameters(layer_sums.radius);
+                // TODO Skewedness
+
                 layers->push_back(layer);
                 cl.addToClusters(layer);
             }
@@ -98,32 +193,19 @@ namespace eicrecon {
             // If mcHits are available, associate cluster with MCParticle
             if (mchits->size() > 0) {
 
-                // 1. find pclhit with the largest energy deposition
-                auto pclhits = pcl.getHits();
-                auto pclhit = std::max_element(
-                        pclhits.begin(),
-                        pclhits.end(),
-                        [](const auto &pclhit1, const auto &pclhit2) {
-                            return pclhit1.getEnergy() < pclhit2.getEnergy();
-                        }
-                );
+                // 1. pclhit with the largest energy deposition
+                const auto pclhit = hits[cl_sums.max_hit];
 
                 // 2. find mchit with same CellID
-                const edm4hep::SimCalorimeterHit* mchit = nullptr;
-                for (auto h : *mchits) {
-                    if (h.getCellID() == pclhit->getCellID()) {
-                        mchit = &h;
-                        break;
-                    }
-                }
-                if( !mchit ){
+                auto mchit_it = mchit_index.find(pclhit.getCellID());
+                if (mchit_it == mchit_index.end()) {
                     // break if no matching hit found for this CellID
-                    warning("Proto-cluster has highest energy in CellID {}, but no mc hit with that CellID was found.", pclhit->getCellID());
+                    warning("Proto-cluster has highest energy in CellID {}, but no mc hit with that CellID was found.", pclhit.getCellID());
                     break;
                 }
 
                 // 3. find mchit's MCParticle
-                const auto &mcp = mchit->getContributions(0).getParticle();
+                const auto &mcp = (*mchits)[mchit_it->second].getContributions(0).getParticle();
 
                 // set association
                 auto clusterassoc = associations->create();
@@ -147,135 +229,168 @@ namespace eicrecon {
 
   private:
 
-    static std::vector<edm4eic::MutableCluster> reconstruct_cluster_layers(const edm4eic::ProtoCluster& pcl) {
-        const auto& hits = pcl.getHits();
-        const auto& weights = pcl.getWeights();
-        // using map to have hits sorted by layer
-        std::map<int, std::vector<std::pair<const edm4eic::CalorimeterHit, float>>> layer_map;
-        for (unsigned i = 0; i < hits.size(); ++i) {
-            const auto hit = hits[i];
-            auto lid = hit.getLayer();
-//            if (layer_map.count(lid) == 0) {
-//                std::vector<std::pair<const edm4eic::CalorimeterHit, float>> v;
-//                layer_map[lid] = {};
-//            }
-            layer_map[lid].push_back({hit, weights[i]});
-        }
+    // per-hit quantities of a proto-cluster in contiguous arrays, in the order of its hits
+    struct HitBuffer {
+      std::vector<int> layer;
+      std::vector<float> energy, weight, energyError, timeError, time, x, y, z;
+      std::vector<double> eta, phi;
 
-        // create layers
-        std::vector<edm4eic::MutableCluster> cl_layers;
-        for (const auto &[lid, layer_hits]: layer_map) {
-            auto layer = reconstruct_layer(layer_hits);
-            cl_layers.push_back(layer);
+      void resize(std::size_t n) {
+        layer.resize(n);
+        for (auto* v : {&energy, &weight, &energyError, &timeError, &time, &x, &y, &z}) {
+          v->resize(n);
         }
-        return cl_layers;
-    }
-
-    static edm4eic::MutableCluster reconstruct_layer(const std::vector<std::pair<const edm4eic::CalorimeterHit, float>>& hits) {
-        edm4eic::MutableCluster layer;
-        layer.setType(Jug::Reco::ClusterType::kClusterSlice);
-        // Calculate averages
-        double energy{0};
-        double energyError{0};
-        double time{0};
-        double timeError{0};
-        double sumOfWeights{0};
-        auto pos = layer.getPosition();
-        for (const auto &[hit, weight]: hits) {
-            energy += hit.getEnergy() * weight;
-            energyError += std::pow(hit.getEnergyError() * weight, 2);
-            time += hit.getTime() * weight;
-            timeError += std::pow(hit.getTimeError() * weight, 2);
-            pos = pos + hit.getPosition() * weight;
-            sumOfWeights += weight;
-            layer.addToHits(hit);
+        eta.resize(n);
+        phi.resize(n);
+      }
+    };
+
+    // the layer clusters are the hits order[begin:end] of a cluster
+    struct LayerSums {
+      int layer;
+      std::size_t begin, end;
+      float energy, energyError, time, timeError, radius;
+      edm4hep::Vector3f position;
+    };
+
+    struct ClusterSums {
+      bool valid{false};
+      float energy{0}, energyError{0}, time{0}, timeError{0}, radius{0};
+      edm4hep::Vector3f position;
+      double theta{0}, phi{0};
+      // first hit with the largest energy
+      std::size_t max_hit{0};
+      // hits sorted by layer, in their order within a layer
+      std::vector<std::size_t> order;
+      std::vector<LayerSums> layers;
+    };
+
+    // the sums over the hits are accumulated in Real, float with singlePrecision
+    template <typename Real>
+    void summarize(const edm4eic::ProtoCluster& pcl, HitBuffer& buf, ClusterSums& out) const {
+        const auto hits = pcl.getHits();
+        const auto weights = pcl.getWeights();
+        const std::size_t n = hits.size();
+        buf.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto& hit = hits[i];
+            const auto& position = hit.getPosition();
+            buf.layer[i] = hit.getLayer();
+            buf.energy[i] = hit.getEnergy();
+            buf.weight[i] = weights[i];
+            buf.energyError[i] = hit.getEnergyError();
+            buf.time[i] = hit.getTime();
+            buf.timeError[i] = hit.getTimeError();
+            buf.x[i] = position.x;
+            buf.y[i] = position.y;
+            buf.z[i] = position.z;
+            buf.eta[i] = edm4hep::utils::eta(position);
+            buf.phi[i] = edm4hep::utils::angleAzimuthal(position);
         }
-        layer.setEnergy(energy);
-        layer.setEnergyError(std::sqrt(energyError));
-        layer.setTime(time / sumOfWeights);
-        layer.setTimeError(std::sqrt(timeError) / sumOfWeights);
-        layer.setNhits(hits.size());
-        layer.setPosition(pos / sumOfWeights);
-        // positionError not set
-        // Intrinsic direction meaningless in a cluster layer --> not set
-
-        // Calculate radius as the standard deviation of the hits versus the cluster center
-        double radius = 0.;
-        for (const auto &[hit, weight]: hits) {
-            radius += std::pow(edm4hep::utils::magnitude(hit.getPosition() - layer.getPosition()), 2);
-        }
-        layer.addToShapeParameters(std::sqrt(radius / layer.getNhits()));
-        // TODO Skewedness
-
-        return layer;
-    }
 
-    static edm4eic::MutableCluster reconstruct_cluster(const edm4eic::ProtoCluster& pcl) {
-        edm4eic::MutableCluster cluster;
-
-        const auto& hits = pcl.getHits();
-        const auto& weights = pcl.getWeights();
-
-        cluster.setType(Jug::Reco::ClusterType::kCluster3D);
-        double energy = 0.;
-        double energyError = 0.;
-        double time = 0.;
-        double timeError = 0.;
-        double meta = 0.;
-        double mphi = 0.;
-        double r = 9999 * dd4hep::cm;
-        for (unsigned i = 0; i < hits.size(); ++i) {
-            const auto &hit = hits[i];
-            const auto &weight = weights[i];
-            energy += hit.getEnergy() * weight;
-            energyError += std::pow(hit.getEnergyError() * weight, 2);
+        // cluster
+        Real energy = 0.;
+        Real energyError = 0.;
+        Real time = 0.;
+        Real timeError = 0.;
+        Real meta = 0.;
+        Real mphi = 0.;
+        Real r = 9999 * dd4hep::cm;
+        out.max_hit = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            energy += buf.energy[i] * buf.weight[i];
+            const Real weightedEnergyError = buf.energyError[i] * buf.weight[i];
+            energyError += weightedEnergyError * weightedEnergyError;
             // energy weighting for the other variables
-            const double energyWeight = hit.getEnergy() * weight;
-            time += hit.getTime() * energyWeight;
-            timeError += std::pow(hit.getTimeError() * energyWeight, 2);
-            meta += edm4hep::utils::eta(hit.getPosition()) * energyWeight;
-            mphi += edm4hep::utils::angleAzimuthal(hit.getPosition()) * energyWeight;
-            r = std::min(edm4hep::utils::magnitude(hit.getPosition()), r);
-            cluster.addToHits(hit);
+            const Real energyWeight = buf.energy[i] * buf.weight[i];
+            time += buf.time[i] * energyWeight;
+            const Real weightedTimeError = buf.timeError[i] * energyWeight;
+            timeError += weightedTimeError * weightedTimeError;
+            meta += static_cast<Real>(buf.eta[i]) * energyWeight;
+            mphi += static_cast<Real>(buf.phi[i]) * energyWeight;
+            r = std::min(static_cast<Real>(edm4hep::utils::magnitude(edm4hep::Vector3f(buf.x[i], buf.y[i], buf.z[i]))), r);
+            if (buf.energy[i] > buf.energy[out.max_hit]) {
+                out.max_hit = i;
+            }
         }
-        cluster.setEnergy(energy);
-        cluster.setEnergyError(std::sqrt(energyError));
-        cluster.setTime(time / energy);
-        cluster.setTimeError(std::sqrt(timeError) / energy);
-        cluster.setNhits(hits.size());
-        cluster.setPosition(edm4hep::utils::sphericalToVector(r, edm4hep::utils::etaToAngle(meta / energy), mphi / energy));
+        out.energy = energy;
+        out.energyError = std::sqrt(energyError);
+        out.time = time / energy;
+        out.timeError = std::sqrt(timeError) / energy;
+        out.position = edm4hep::utils::sphericalToVector(r, edm4hep::utils::etaToAngle(meta / energy), mphi / energy);
 
         // shower radius estimate (eta-phi plane)
-        double radius = 0.;
-        for (const auto &hit: hits) {
-            radius += std::pow(
-              std::hypot(
-                (edm4hep::utils::eta(hit.getPosition()) - edm4hep::utils::eta(cluster.getPosition())),
-                (edm4hep::utils::angleAzimuthal(hit.getPosition()) - edm4hep::utils::angleAzimuthal(cluster.getPosition()))
-              ),
-              2.0
-            );
+        Real radius = 0.;
+        const Real cluster_eta = edm4hep::utils::eta(out.position);
+        const Real cluster_phi = edm4hep::utils::angleAzimuthal(out.position);
+        for (std::size_t i = 0; i < n; ++i) {
+            const Real delta_eta = static_cast<Real>(buf.eta[i]) - cluster_eta;
+            const Real delta_phi = static_cast<Real>(buf.phi[i]) - cluster_phi;
+            radius += delta_eta * delta_eta + delta_phi * delta_phi;
+        }
+        out.radius = std::sqrt(radius / n);
+
+        // layers, the hits sorted once by layer
+        out.order.resize(n);
+        std::iota(out.order.begin(), out.order.end(), std::size_t{0});
+        std::stable_sort(out.order.begin(), out.order.end(), [&](std::size_t i1, std::size_t i2) { return buf.layer[i1] < buf.layer[i2]; });
+        out.layers.clear();
+        for (std::size_t begin = 0, end = 0; begin < n; begin = end) {
+            const int lid = buf.layer[out.order[begin]];
+            Real layer_energy{0};
+            Real layer_energyError{0};
+            Real layer_time{0};
+            Real layer_timeError{0};
+            Real sumOfWeights{0};
+            float px = 0, py = 0, pz = 0;
+            for (end = begin; (end < n) && (buf.layer[out.order[end]] == lid); ++end) {
+                const std::size_t i = out.order[end];
+                const float weight = buf.weight[i];
+                layer_energy += buf.energy[i] * weight;
+                const Real weightedEnergyError = buf.energyError[i] * weight;
+                layer_energyError += weightedEnergyError * weightedEnergyError;
+                layer_time += buf.time[i] * weight;
+                const Real weightedTimeError = buf.timeError[i] * weight;
+                layer_timeError += weightedTimeError * weightedTimeError;
+                px += buf.x[i] * weight;
+                py += buf.y[i] * weight;
+                pz += buf.z[i] * weight;
+                sumOfWeights += weight;
+            }
+            LayerSums layer{lid, begin, end};
+            layer.energy = layer_energy;
+            layer.energyError = std::sqrt(layer_energyError);
+            layer.time = layer_time / sumOfWeights;
+            layer.timeError = std::sqrt(layer_timeError) / sumOfWeights;
+            layer.position = edm4hep::Vector3f(px / sumOfWeights, py / sumOfWeights, pz / sumOfWeights);
+
+            // Calculate radius as the standard deviation of the hits versus the cluster center
+            Real layer_radius = 0.;
+            for (std::size_t j = begin; j < end; ++j) {
+                const std::size_t i = out.order[j];
+                const Real distance = edm4hep::utils::magnitude(edm4hep::Vector3f(buf.x[i], buf.y[i], buf.z[i]) - layer.position);
+                layer_radius += distance * distance;
+            }
+            layer.radius = std::sqrt(layer_radius / (end - begin));
+            out.layers.push_back(layer);
         }
-        cluster.addToShapeParameters(std::sqrt(radius / cluster.getNhits()));
-        // Skewedness not calculated TODO
-
-        // Optionally store the MC truth associated with the first hit in this cluster
-        // FIXME no connection between cluster and truth in edm4hep
-        // if (mcHits) {
-        //  const auto& mc_hit    = (*mcHits)[pcl.getHits(0).ID.value];
-        //  cluster.mcID({mc_hit.truth().trackID, m_kMonteCarloSource});
-        //}
 
-        return cluster;
+        std::tie(out.theta, out.phi) = fit_track(out.layers);
     }
 
-    std::pair<double /* polar */, double /* azimuthal */> fit_track(const std::vector<edm4eic::MutableCluster> &layers) const {
+    // principal axis of the positions of the layers up to trackStopLayer,
+    // oriented from the first to the last of these layers
+    std::pair<double /* polar */, double /* azimuthal */> fit_track(const std::vector<LayerSums> &layers) const {
         int nrows = 0;
         decltype(edm4eic::ClusterData::position) mean_pos{0, 0, 0};
+        const LayerSums* first = nullptr;
+        const LayerSums* last = nullptr;
         for (const auto &layer: layers) {
-            if ((layer.getNhits() > 0) && (layer.getHits(0).getLayer() <= m_cfg.trackStopLayer)) {
-                mean_pos = mean_pos + layer.getPosition();
+            if (layer.layer <= m_cfg.trackStopLayer) {
+                mean_pos = mean_pos + layer.position;
                 nrows += 1;
+                first = (first == nullptr) ? &layer : first;
+                last = &layer;
             }
         }
 
@@ -285,23 +400,29 @@ namespace eicrecon {
         }
 
         mean_pos = mean_pos / nrows;
-        // fill position data
-        Eigen::MatrixXd pos(nrows, 3);
-        int ir = 0;
+        symmetric_eigen::Matrix3 cov{0., 0., 0., 0., 0., 0.};
+        auto& [xx, yy, zz, xy, xz, yz] = cov;
         for (const auto &layer: layers) {
-            if ((layer.getNhits() > 0) && (layer.getHits(0).getLayer() <= m_cfg.trackStopLayer)) {
-                auto delta = layer.getPosition() - mean_pos;
-                pos(ir, 0) = delta.x;
-                pos(ir, 1) = delta.y;
-                pos(ir, 2) = delta.z;
-                ir += 1;
+            if (layer.layer <= m_cfg.trackStopLayer) {
+                const auto delta = layer.position - mean_pos;
+                xx += delta.x * delta.x;
+                yy += delta.y * delta.y;
+                zz += delta.z * delta.z;
+                xy += delta.x * delta.y;
+                xz += delta.x * delta.z;
+                yz += delta.y * delta.z;
             }
         }
 
-        Eigen::JacobiSVD <Eigen::MatrixXd> svd(pos, Eigen::ComputeThinU | Eigen::ComputeThinV);
-        const auto dir = svd.matrixV().col(0);
+        auto dir = symmetric_eigen::eigenvector(cov, symmetric_eigen::eigenvalues(cov)[2]);
+        const auto span = last->position - first->position;
+        if (dir[0] * span.x + dir[1] * span.y + dir[2] * span.z < 0) {
+            for (auto& c : dir) {
+                c = -c;
+            }
+        }
         // theta and phi
-        return {std::acos(dir(2)), std::atan2(dir(1), dir(0))};
+        return {std::acos(dir[2]), std::atan2(dir[1], dir[0])};
     }
 };
 
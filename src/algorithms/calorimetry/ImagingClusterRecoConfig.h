@@ -9,6 +9,13 @@ namespace eicrecon {
 
     int trackStopLayer = 9;
 
+    // accumulate the sums over the cluster and layer hits in float instead of double
+    bool singlePrecision = false;
+
+    // the proto-clusters of an event are reconstructed in reconstructionTasks
+    // blocks in parallel, for events of at least 1024 hits per block
+    int reconstructionTasks = 1;
+
   };
 
 } // eicrecon
@@ -12,6 +12,12 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <algorithms/algorithm.h>
 #include <DD4hep/BitFieldCoder.h>
@@ -27,7 +33,9 @@
 #include <edm4hep/utils/vector_utils.h>
 
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "ConnectedComponents.h"
 #include "ImagingTopoClusterConfig.h"
+#include "NeighbourGrid.h"
 
 namespace eicrecon {
 
@@ -103,6 +111,11 @@ namespace eicrecon {
                     "Global distance between hits <= {:.4f} mm.",
                     sectorDist
         );
+        if (m_cfg.grouping == "components") {
+            info("Grouping the hits as connected components, with {} tasks", m_cfg.groupingTasks);
+        } else if (m_cfg.grouping != "bfs") {
+            throw std::runtime_error("Unsupported value \"" + m_cfg.grouping + "\" for \"grouping\"");
+        }
     }
 
     void process(const Input& input, const Output& output) const final {
@@ -110,29 +123,98 @@ namespace eicrecon {
         const auto [hits] = input;
         auto [proto] = output;
 
-        // group neighbouring hits
-        std::vector<bool> visits(hits->size(), false);
-        std::vector<std::set<std::size_t>> groups;
-        for (size_t i = 0; i < hits->size(); ++i) {
-            debug("hit {:d}: local position = ({}, {}, {}), global position = ({}, {}, {})", i + 1,
-                         (*hits)[i].getLocal().x, (*hits)[i].getLocal().y, (*hits)[i].getPosition().z,
-                         (*hits)[i].getPosition().x, (*hits)[i].getPosition().y, (*hits)[i].getPosition().z
-            );
-            // already in a group, or not energetic enough to form a cluster
-            if (visits[i] || (*hits)[i].getEnergy() < minClusterCenterEdep) {
+        // index qualified hits by (sector, layer) and local (x, y) cells for the
+        // same layer, by (sector, layer) and (eta, phi) cells for the neighbour layers,
+        // and by global cells for the neighbour sectors
+        // cells are slightly wider than the distances to absorb the rounding of
+        // single precision positions
+        constexpr double margin = 1. + 1e-4;
+        const std::int64_t layer_reach = std::max(0, m_cfg.neighbourLayersRange);
+        Grids grids;
+        grids.local.configure({
+            NeighbourGridAxis::exact(), NeighbourGridAxis::exact(),
+            NeighbourGridAxis::linear(localDistXY[0] * margin), NeighbourGridAxis::linear(localDistXY[1] * margin)
+        });
+        grids.layer.configure({
+            NeighbourGridAxis::exact(), NeighbourGridAxis::exact(layer_reach),
+            NeighbourGridAxis::linear(layerDistEtaPhi[0] * margin), NeighbourGridAxis::linear(layerDistEtaPhi[1] * margin)
+        });
+        grids.local_keys.resize(hits->size());
+        grids.layer_keys.resize(hits->size());
+        grids.local.reserve(hits->size());
+        grids.layer.reserve(hits->size());
+        for (std::size_t i = 0; i < hits->size(); ++i) {
+            const auto& hit = (*hits)[i];
+            if (hit.getEnergy() < m_cfg.minClusterHitEdep) {
                 continue;
             }
-            // create a new group, and group all the neighbouring hits
-            groups.emplace_back();
-            bfs_group(*hits, groups.back(), i, visits);
+            const double sector = hit.getSector();
+            const double layer = hit.getLayer();
+            grids.local_keys[i] = grids.local.key({sector, layer, hit.getLocal().x, hit.getLocal().y});
+            grids.local.insert(grids.local_keys[i], i);
+            grids.layer_keys[i] = grids.layer.key({sector, layer,
+                                                   edm4hep::utils::eta(hit.getPosition()),
+                                                   edm4hep::utils::angleAzimuthal(hit.getPosition())});
+            grids.layer.insert(grids.layer_keys[i], i);
+            grids.multiple_sectors |= (hit.getSector() != (*hits)[0].getSector());
+        }
+        grids.local.build();
+        grids.layer.build();
+        if (grids.multiple_sectors) {
+            grids.global.configure({
+                NeighbourGridAxis::linear(sectorDist * margin),
+                NeighbourGridAxis::linear(sectorDist * margin),
+                NeighbourGridAxis::linear(sectorDist * margin)
+            });
+            grids.global_keys.resize(hits->size());
+            grids.global.reserve(hits->size());
+            for (std::size_t i = 0; i < hits->size(); ++i) {
+                const auto& hit = (*hits)[i];
+                if (hit.getEnergy() < m_cfg.minClusterHitEdep) {
+                    continue;
+                }
+                grids.global_keys[i] = grids.global.key({hit.getPosition().x, hit.getPosition().y, hit.getPosition().z});
+                grids.global.insert(grids.global_keys[i], i);
+            }
+            grids.global.build();
         }
-        debug("found {} potential clusters (groups of hits)", groups.size());
-        for (size_t i = 0; i < groups.size(); ++i) {
-            debug("group {}: {} hits", i, groups[i].size());
+
+        // group neighbouring hits, the groups are stored contiguously,
+        // group g is group_hits[group_offsets[g]:group_offsets[g + 1]]
+        std::vector<std::size_t> group_hits;
+        std::vector<std::size_t> group_offsets{0};
+        group_hits.reserve(hits->size());
+        if (m_cfg.grouping == "components") {
+            ConnectedComponents components(std::max(1, m_cfg.groupingMinHitsPerTask));
+            components.build(hits->size(), std::max(1, m_cfg.groupingTasks),
+                [&](std::size_t idx) { return (*hits)[idx].getEnergy() >= m_cfg.minClusterHitEdep; },
+                [&](std::size_t idx1, auto&& f) { for_each_candidate(*hits, grids, idx1, f); },
+                [&](std::size_t idx1, std::size_t idx2) { return is_neighbour((*hits)[idx1], (*hits)[idx2]); });
+            // the groups start from the hits energetic enough to form a cluster
+            components.groups([&](std::size_t idx) { return (*hits)[idx].getEnergy() >= minClusterCenterEdep; },
+                              group_hits, group_offsets);
+        } else {
+            std::vector<bool> visits(hits->size(), false);
+            for (size_t i = 0; i < hits->size(); ++i) {
+                debug("hit {:d}: local position = ({}, {}, {}), global position = ({}, {}, {})", i + 1,
+                             (*hits)[i].getLocal().x, (*hits)[i].getLocal().y, (*hits)[i].getPosition().z,
+                             (*hits)[i].getPosition().x, (*hits)[i].getPosition().y, (*hits)[i].getPosition().z
+                );
+                // already in a group, or not energetic enough to form a cluster
+                if (visits[i] || (*hits)[i].getEnergy() < minClusterCenterEdep) {
+                    continue;
+                }
+                // create a new group, and group all the neighbouring hits
+                bfs_group(*hits, grids, group_hits, i, visits);
+                group_offsets.push_back(group_hits.size());
+            }
         }
+        debug("found {} potential clusters (groups of hits)", group_offsets.size() - 1);
 
         // form clusters
-        for (const auto &group : groups) {
+        for (std::size_t g = 0; g + 1 < group_offsets.size(); ++g) {
+            std::span<const std::size_t> group(group_hits.data() + group_offsets[g], group_offsets[g + 1] - group_offsets[g]);
+            debug("group {}: {} hits", g, group.size());
             if (static_cast<int>(group.size()) < m_cfg.minClusterNhits) {
                 continue;
             }
@@ -153,6 +235,17 @@ namespace eicrecon {
 
   private:
 
+    // per-event neighbour search index
+    struct Grids {
+        NeighbourGrid<4> local;
+        NeighbourGrid<4> layer;
+        NeighbourGrid<3> global;
+        std::vector<NeighbourGrid<4>::Key> local_keys;
+        std::vector<NeighbourGrid<4>::Key> layer_keys;
+        std::vector<NeighbourGrid<3>::Key> global_keys;
+        bool multiple_sectors{false};
+    };
+
     // helper function to group hits
     bool is_neighbour(const edm4eic::CalorimeterHit& h1, const edm4eic::CalorimeterHit& h2) const {
         // different sectors, simple distance check
@@ -178,8 +271,32 @@ namespace eicrecon {
         return false;
     }
 
-    // grouping function with Breadth-First Search
-    void bfs_group(const edm4eic::CalorimeterHitCollection &hits, std::set<std::size_t> &group, std::size_t idx, std::vector<bool> &visits) const {
+    // calls f(idx2) for the indexed hits near hit idx1, which include all its neighbours
+    template <typename F>
+    void for_each_candidate(const edm4eic::CalorimeterHitCollection &hits, const Grids &grids, std::size_t idx1, F&& f) const {
+        const auto layer1 = hits[idx1].getLayer();
+        const auto sector1 = hits[idx1].getSector();
+        // only qualified hits are indexed
+        grids.local.for_each_neighbour(grids.local_keys[idx1], f);
+        grids.layer.for_each_neighbour(grids.layer_keys[idx1], [&](std::size_t idx2) {
+          // same layer is covered by the local grid
+          if (hits[idx2].getLayer() != layer1) {
+            f(idx2);
+          }
+        });
+        if (grids.multiple_sectors) {
+          grids.global.for_each_neighbour(grids.global_keys[idx1], [&](std::size_t idx2) {
+            // same sector is covered by the other grids
+            if (hits[idx2].getSector() != sector1) {
+              f(idx2);
+            }
+          });
+        }
+    }
+
+    // grouping function with Breadth-First Search, appends the group of idx to the
+    // flat group storage
+    void bfs_group(const edm4eic::CalorimeterHitCollection &hits, const Grids &grids, std::vector<std::size_t> &group_hits, std::size_t idx, std::vector<bool> &visits) const {
       visits[idx] = true;
 
       // not a qualified hit to particpate clustering, stop here
@@ -187,26 +304,23 @@ namespace eicrecon {
         return;
       }
 
-      group.insert(idx);
-      size_t prev_size = 0;
-
-      while (prev_size != group.size()) {
-        prev_size = group.size();
-        for (std::size_t idx1 : group) {
-          // check neighbours
-          for (std::size_t idx2 = 0; idx2 < hits.size(); ++idx2) {
-            // not a qualified hit to particpate clustering, skip
-            if (hits[idx2].getEnergy() < m_cfg.minClusterHitEdep) {
-              continue;
-            }
-            if ((!visits[idx2])
-                && is_neighbour(hits[idx1], hits[idx2])) {
-              group.insert(idx2);
-              visits[idx2] = true;
-            }
+      const std::size_t begin = group_hits.size();
+      group_hits.push_back(idx);
+
+      // the group doubles as the queue of hits whose neighbours are not checked yet
+      for (std::size_t next = begin; next < group_hits.size(); ++next) {
+        const std::size_t idx1 = group_hits[next];
+        for_each_candidate(hits, grids, idx1, [&](std::size_t idx2) {
+          if ((!visits[idx2])
+              && is_neighbour(hits[idx1], hits[idx2])) {
+            group_hits.push_back(idx2);
+            visits[idx2] = true;
           }
-        }
+        });
       }
+
+      // keep the hit ordering of the collection
+      std::sort(group_hits.begin() + begin, group_hits.end());
     }
   };
 
@@ -18,6 +18,14 @@ namespace eicrecon {
     // maximum global distance to be considered as neighbors in different sectors
     double sectorDist = 1.0 * dd4hep::cm;
 
+    // "bfs" groups the hits with a breadth-first search (the reference),
+    // "components" tests the neighbour pairs of up to groupingTasks blocks of hits
+    // in parallel and joins them as connected components, with the same groups
+    std::string grouping{"bfs"};
+    int groupingTasks{4};
+    // of at least groupingMinHitsPerTask hits, smaller events are grouped on one thread
+    int groupingMinHitsPerTask{1024};
+
     // minimum hit energy to participate clustering
     double minClusterHitEdep = 0.;
     // minimum cluster center energy (to be considered as a seed for cluster)
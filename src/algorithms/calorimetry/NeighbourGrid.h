@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace eicrecon {
+
+  /** Binning of one coordinate of a NeighbourGrid.
+   *
+   * A coordinate is split into cells of `width`, and a neighbour search visits
+   * the cells within `reach` of the cell of the query point. As long as the
+   * width is not smaller than the largest coordinate difference allowed between
+   * neighbours, and the reach is at least one, the search visits every neighbour.
+   * Axes with a non-positive (or non-finite) width are not binned at all.
+   * Periodic axes (e.g. azimuth) wrap around after `period` cells.
+   */
+  struct NeighbourGridAxis {
+    double width{0.};
+    std::int64_t reach{1};
+    std::int64_t period{0};
+    double origin{0.};
+
+    /// Integer coordinate used as is (sector, layer, ...)
+    static NeighbourGridAxis exact(std::int64_t reach = 0) {
+      return {1., reach, 0, 0.};
+    }
+
+    /// Not binned, every entry shares the same cell
+    static NeighbourGridAxis none() {
+      return {0., 0, 0, 0.};
+    }
+
+    /// Cells of at least `min_width`, neighbours are found in adjacent cells
+    static NeighbourGridAxis linear(double min_width) {
+      return {min_width, 1, 0, 0.};
+    }
+
+    /// Cells of at least `min_width` covering [origin, origin + range) periodically
+    static NeighbourGridAxis periodic(double min_width, double range, double origin) {
+      if (!(min_width > 0.) || !std::isfinite(min_width)) {
+        return none();
+      }
+      auto n = static_cast<std::int64_t>(std::floor(range / min_width));
+      // too few cells to tell neighbours from non-neighbours
+      if (n < 3) {
+        return none();
+      }
+      return {range / static_cast<double>(n), 1, n, origin};
+    }
+
+    bool binned() const { return (width > 0.) && std::isfinite(width); }
+
+    std::int64_t bin(double x) const {
+      if (!binned() || std::isnan(x)) {
+        return 0;
+      }
+      // clamp to keep the cast defined, clamping does not separate neighbours
+      constexpr double limit = static_cast<double>(std::numeric_limits<std::int32_t>::max());
+      const double b = std::clamp(std::floor((x - origin) / width), -limit, limit);
+      auto ib = static_cast<std::int64_t>(b);
+      if (period > 0) {
+        ib %= period;
+        if (ib < 0) {
+          ib += period;
+        }
+      }
+      return ib;
+    }
+  };
+
+  /** Sorted uniform grid over entry indices (usually hit indices).
+   *
+   * Entries are inserted once per event with their grid coordinates, after
+   * build() the entries stored in the cells near a point can be visited
+   * without scanning the whole collection.
+   */
+  template <std::size_t N>
+  class NeighbourGrid {
+  public:
+    using Coordinates = std::array<double, N>;
+    using Key = std::array<std::int64_t, N>;
+
+    void configure(const std::array<NeighbourGridAxis, N>& axes) {
+      m_axes = axes;
+      m_entries.clear();
+    }
+
+    const std::array<NeighbourGridAxis, N>& axes() const { return m_axes; }
+
+    void reserve(std::size_t n) { m_entries.reserve(n); }
+
+    std::size_t size() const { return m_entries.size(); }
+
+    Key key(const Coordinates& x) const {
+      Key k;
+      for (std::size_t i = 0; i < N; ++i) {
+        k[i] = m_axes[i].bin(x[i]);
+      }
+      return k;
+    }
+
+    void insert(const Key& k, std::size_t idx) { m_entries.emplace_back(k, idx); }
+    void insert(const Coordinates& x, std::size_t idx) { insert(key(x), idx); }
+
+    /// Sort the entries, needs to be called after the last insert() and before any lookup
+    void build() { std::sort(m_entries.begin(), m_entries.end()); }
+
+    /// Call f(idx) for all entries in the cell `k`, in ascending order of idx
+    template <typename F>
+    void for_each_in_cell(const Key& k, F&& f) const {
+      auto it = std::lower_bound(m_entries.begin(), m_entries.end(), k,
+                                 [](const Entry& e, const Key& key) { return e.first < key; });
+      for (; it != m_entries.end() && it->first == k; ++it) {
+        f(it->second);
+      }
+    }
+
+    /// Call f(idx) for all entries in the cells within reach of cell `k`
+    template <typename F>
+    void for_each_neighbour(const Key& k, F&& f) const {
+      Key lo, hi, cur;
+      for (std::size_t i = 0; i < N; ++i) {
+        const auto& axis = m_axes[i];
+        std::int64_t reach = axis.binned() ? axis.reach : 0;
+        if ((axis.period > 0) && (2 * reach + 1 >= axis.period)) {
+          // the whole circle is within reach
+          lo[i] = -k[i];
+          hi[i] = axis.period - 1 - k[i];
+        } else {
+          lo[i] = -reach;
+          hi[i] = reach;
+        }
+      }
+      Key offset = lo;
+      while (true) {
+        for (std::size_t i = 0; i < N; ++i) {
+          cur[i] = k[i] + offset[i];
+          if (m_axes[i].period > 0) {
+            cur[i] = (cur[i] % m_axes[i].period + m_axes[i].period) % m_axes[i].period;
+          }
+        }
+        for_each_in_cell(cur, f);
+        // advance the offset like an odometer
+        std::size_t i = 0;
+        for (; i < N; ++i) {
+          if (offset[i] < hi[i]) {
+            ++offset[i];
+            break;
+          }
+          offset[i] = lo[i];
+        }
+        if (i == N) {
+          break;
+        }
+      }
+    }
+
+    template <typename F>
+    void for_each_neighbour(const Coordinates& x, F&& f) const {
+      for_each_neighbour(key(x), std::forward<F>(f));
+    }
+
+  private:
+    using Entry = std::pair<Key, std::size_t>;
+
+    std::array<NeighbourGridAxis, N> m_axes;
+    std::vector<Entry> m_entries;
+  };
+
+} // namespace eicrecon
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <algorithms/service.h>
+#include <fmt/core.h>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "ReadoutExpression.h"
+#include "services/evaluator/EvaluatorSvc.h"
+
+namespace eicrecon {
+
+void ReadoutExpression::init(const std::string& expr, const dd4hep::IDDescriptor& id_spec, bool memoize) {
+  std::vector<std::string> names;
+  m_fields.clear();
+  for (const auto& [name, field] : id_spec.fields()) {
+    names.push_back(name);
+    m_fields.push_back(field);
+  }
+  if (m_fields.size() > max_fields) {
+    throw std::runtime_error(fmt::format("Readout with {} fields is not supported", m_fields.size()));
+  }
+  m_decoder = CellIDFieldDecoder(m_fields);
+
+  auto& serviceSvc = algorithms::ServiceSvc::instance();
+  m_func = serviceSvc.service<EvaluatorSvc>("EvaluatorSvc")->compile_positional(expr, names);
+
+  // fields referenced by the expression, any identifier matching a field name counts
+  m_mask = 0;
+  for (std::size_t pos = 0; pos < expr.size();) {
+    if (std::isalpha(static_cast<unsigned char>(expr[pos])) || (expr[pos] == '_')) {
+      std::size_t end = pos;
+      while ((end < expr.size()) && (std::isalnum(static_cast<unsigned char>(expr[end])) || (expr[end] == '_'))) {
+        ++end;
+      }
+      std::string_view identifier{expr.data() + pos, end - pos};
+      for (std::size_t field_ix = 0; field_ix < names.size(); ++field_ix) {
+        if (names[field_ix] == identifier) {
+          m_mask |= m_fields[field_ix]->mask();
+        }
+      }
+      pos = end;
+    } else if (std::isdigit(static_cast<unsigned char>(expr[pos]))) {
+      // skip numeric literals like 1e3
+      while ((pos < expr.size()) && (std::isalnum(static_cast<unsigned char>(expr[pos])) || (expr[pos] == '.'))) {
+        ++pos;
+      }
+    } else {
+      ++pos;
+    }
+  }
+
+  m_constant = (m_mask == 0);
+  if (m_constant) {
+    m_constant_value = evaluate(0);
+  }
+
+  m_runs.clear();
+  m_table.clear();
+  const auto table_bits = static_cast<unsigned>(std::popcount(m_mask));
+  if (!memoize || m_constant || table_bits > max_table_bits) {
+    return;
+  }
+  for (unsigned offset = 0; offset < 64;) {
+    if ((m_mask >> offset) & 1) {
+      const auto width = static_cast<unsigned>(std::countr_one(m_mask >> offset));
+      m_runs.push_back({offset, width});
+      offset += width;
+    } else {
+      ++offset;
+    }
+  }
+  // the value of every combination of the masked bits, in the order of their table index
+  m_table.resize(std::size_t{1} << table_bits);
+  for (std::size_t index = 0; index < m_table.size(); ++index) {
+    std::uint64_t cellID = 0;
+    unsigned shift       = 0;
+    for (const auto& [offset, width] : m_runs) {
+      cellID |= ((index >> shift) & ((std::uint64_t{1} << width) - 1)) << offset;
+      shift += width;
+    }
+    m_table[index] = evaluate(cellID);
+  }
+}
+
+double ReadoutExpression::operator()(std::uint64_t cellID) const {
+  if (m_constant) {
+    return m_constant_value;
+  }
+  if (m_table.empty()) {
+    return evaluate(cellID);
+  }
+  return m_table[table_index(cellID)];
+}
+
+std::size_t ReadoutExpression::table_index(std::uint64_t cellID) const {
+  std::size_t index = 0;
+  unsigned shift    = 0;
+  for (const auto& [offset, width] : m_runs) {
+    index |= ((cellID >> offset) & ((std::uint64_t{1} << width) - 1)) << shift;
+    shift += width;
+  }
+  return index;
+}
+
+double ReadoutExpression::evaluate(std::uint64_t cellID) const {
+  std::array<double, max_fields> values;
+  m_decoder.decode(&cellID, 1, values.data());
+  return m_func(std::span<const double>{values.data(), m_fields.size()});
+}
+
+} // namespace eicrecon
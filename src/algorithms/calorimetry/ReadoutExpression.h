@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <DD4hep/IDDescriptor.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "algorithms/interfaces/CellIDFieldDecoder.h"
+
+namespace eicrecon {
+
+  /** Configuration expression over the fields of a readout.
+   *
+   * The expression is compiled once with one positional parameter per
+   * readout field (e.g. `"(rlayerz == 0) ? 0.019 : 0.037"`). On evaluation
+   * the fields of the cellID are decoded into a fixed size buffer, so there
+   * is no allocation per call. The value only depends on the fields that
+   * appear in the expression: if those take at most `max_table_bits` bits of
+   * the cellID, the expression is evaluated at init for all their values, and
+   * calls read the value from that table without a lock. Expressions over
+   * more bits are evaluated on every call, as are all with `memoize = false`.
+   */
+  class ReadoutExpression {
+  public:
+    // a field takes at least one bit of the 64-bit cellID
+    static constexpr std::size_t max_fields = 64;
+    // largest table of memoised values, 2^12 doubles
+    static constexpr unsigned max_table_bits = 12;
+
+    void init(const std::string& expr, const dd4hep::IDDescriptor& id_spec, bool memoize = true);
+
+    double operator()(std::uint64_t cellID) const;
+
+    /// Mask of the cellID bits the expression depends on
+    std::uint64_t mask() const { return m_mask; }
+
+    /// Whether the values are read from the table made at init
+    bool memoized() const { return !m_table.empty(); }
+
+  private:
+    double evaluate(std::uint64_t cellID) const;
+
+    /// Index in m_table of the masked bits of a cellID
+    std::size_t table_index(std::uint64_t cellID) const;
+
+    std::function<double(std::span<const double>)> m_func;
+    std::vector<const dd4hep::IDDescriptor::Field*> m_fields;
+    CellIDFieldDecoder m_decoder;
+    std::uint64_t m_mask{0};
+    bool m_constant{false};
+    double m_constant_value{0.};
+
+    // runs of consecutive bits of m_mask, which are packed into the table index
+    struct BitRun {
+      unsigned offset;
+      unsigned width;
+    };
+    std::vector<BitRun> m_runs;
+    std::vector<double> m_table;
+  };
+
+} // namespace eicrecon
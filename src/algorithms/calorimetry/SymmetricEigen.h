@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+
+namespace eicrecon {
+
+  /** Closed-form eigen decomposition of small real symmetric matrices.
+   *
+   * Used for cluster moments, replaces general iterative solvers. Eigenvalues
+   * are returned in ascending order.
+   */
+  namespace symmetric_eigen {
+
+    /// Eigenvalues of {{xx, xy}, {xy, yy}}
+    inline std::array<double, 2> eigenvalues(double xx, double yy, double xy) {
+      const double mean = 0.5 * (xx + yy);
+      const double r = std::hypot(0.5 * (xx - yy), xy);
+      return {mean - r, mean + r};
+    }
+
+    /// Symmetric 3x3 matrix stored as {xx, yy, zz, xy, xz, yz}
+    using Matrix3 = std::array<double, 6>;
+
+    /// Eigenvalues of a symmetric 3x3 matrix, trigonometric method (Smith, 1961)
+    inline std::array<double, 3> eigenvalues(const Matrix3& m) {
+      const auto& [xx, yy, zz, xy, xz, yz] = m;
+      const double p1 = xy * xy + xz * xz + yz * yz;
+      if (p1 == 0.) {
+        std::array<double, 3> diagonal{xx, yy, zz};
+        std::sort(diagonal.begin(), diagonal.end());
+        return diagonal;
+      }
+      const double q = (xx + yy + zz) / 3.;
+      const double p2 = (xx - q) * (xx - q) + (yy - q) * (yy - q) + (zz - q) * (zz - q) + 2. * p1;
+      const double p = std::sqrt(p2 / 6.);
+      // B = (A - q I) / p, r = det(B) / 2
+      const double bxx = (xx - q) / p, byy = (yy - q) / p, bzz = (zz - q) / p;
+      const double bxy = xy / p, bxz = xz / p, byz = yz / p;
+      const double det = bxx * (byy * bzz - byz * byz) - bxy * (bxy * bzz - byz * bxz) + bxz * (bxy * byz - byy * bxz);
+      const double r = std::clamp(0.5 * det, -1., 1.);
+      const double phi = std::acos(r) / 3.;
+      const double largest = q + 2. * p * std::cos(phi);
+      const double smallest = q + 2. * p * std::cos(phi + 2. * std::numbers::pi / 3.);
+      return {smallest, 3. * q - largest - smallest, largest};
+    }
+
+    /// Unit eigenvector of a symmetric 3x3 matrix for the eigenvalue `lambda`
+    inline std::array<double, 3> eigenvector(const Matrix3& m, double lambda) {
+      const auto& [xx, yy, zz, xy, xz, yz] = m;
+      // rows of A - lambda I, the eigenvector is orthogonal to all of them
+      const std::array<std::array<double, 3>, 3> rows{{
+        {xx - lambda, xy, xz},
+        {xy, yy - lambda, yz},
+        {xz, yz, zz - lambda},
+      }};
+      auto cross = [](const std::array<double, 3>& a, const std::array<double, 3>& b) {
+        return std::array<double, 3>{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+      };
+      auto norm2 = [](const std::array<double, 3>& a) { return a[0] * a[0] + a[1] * a[1] + a[2] * a[2]; };
+
+      // the largest cross product of two rows is the most accurate
+      std::array<double, 3> best{0., 0., 0.};
+      double best_norm2 = 0.;
+      for (std::size_t i = 0; i < 3; ++i) {
+        const auto c = cross(rows[i], rows[(i + 1) % 3]);
+        if (const double n2 = norm2(c); n2 > best_norm2) {
+          best = c;
+          best_norm2 = n2;
+        }
+      }
+      if (best_norm2 == 0.) {
+        // degenerate eigenvalue, any vector orthogonal to the non-zero rows will do
+        std::size_t i_max = 0;
+        for (std::size_t i = 1; i < 3; ++i) {
+          if (norm2(rows[i]) > norm2(rows[i_max])) {
+            i_max = i;
+          }
+        }
+        const auto& row = rows[i_max];
+        if (norm2(row) == 0.) {
+          return {1., 0., 0.};
+        }
+        // cross with the coordinate axis least aligned with the row
+        std::size_t axis = 0;
+        for (std::size_t k = 1; k < 3; ++k) {
+          if (std::abs(row[k]) < std::abs(row[axis])) {
+            axis = k;
+          }
+        }
+        std::array<double, 3> unit{0., 0., 0.};
+        unit[axis] = 1.;
+        best = cross(row, unit);
+        best_norm2 = norm2(best);
+      }
+      const double norm = std::sqrt(best_norm2);
+      return {best[0] / norm, best[1] / norm, best[2] / norm};
+    }
+
+  } // namespace symmetric_eigen
+
+} // namespace eicrecon
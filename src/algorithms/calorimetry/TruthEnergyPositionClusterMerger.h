@@ -14,6 +14,7 @@
 #include <edm4hep/utils/vector_utils.h>
 
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "ClusterAssociationIndex.h"
 
 namespace eicrecon {
 
@@ -179,15 +180,14 @@ namespace eicrecon {
 
         std::map<int, edm4eic::Cluster> matched = {};
 
+        const ClusterAssociationIndex association_index(associations);
+
         for (const auto &cluster: clusters) {
             int mcID = -1;
 
             // find associated particle
-            for (const auto &assoc: associations) {
-                if (assoc.getRec() == cluster) {
-                    mcID = assoc.getSimID();
-                    break;
-                }
+            if (const auto assoc = association_index.find(cluster)) {
+                mcID = assoc->getSimID();
             }
 
             trace(" --> Found cluster: {} with mcID {} and energy {}", cluster.getObjectID().index, mcID, cluster.getEnergy());
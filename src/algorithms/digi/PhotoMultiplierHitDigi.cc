@@ -17,19 +17,68 @@
 
 #include <Evaluator/DD4hepUnits.h>
 #include <algorithms/logger.h>
+#include <algorithms/service.h>
 #include <edm4eic/EDM4eicVersion.h>
 #include <edm4hep/Vector3d.h>
 #include <fmt/core.h>
 #include <math.h>
 #include <podio/ObjectID.h>
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <gsl/pointers>
 #include <iterator>
 
 #include "algorithms/digi/PhotoMultiplierHitDigiConfig.h"
+#include "algorithms/interfaces/EventArena.h"
 
 namespace eicrecon {
 
+namespace {
+
+  // substream of the event-wide stream (cellID 0) of the noise sampling
+  constexpr std::uint32_t noise_sampling_substream = 0xFFFFFFFF;
+
+  // Poisson variate, by multiplication of uniforms for small means and by
+  // transformed rejection (Hoermann, "The transformed rejection method for
+  // generating Poisson random variables", 1993) otherwise
+  std::uint64_t poisson(CounterRandom& rng, double mean) {
+    if (mean <= 0.) {
+      return 0;
+    }
+    if (mean < 10.) {
+      const double limit = std::exp(-mean);
+      std::uint64_t k = 0;
+      for (double prod = rng.uniform(); prod > limit; prod *= rng.uniform()) {
+        ++k;
+      }
+      return k;
+    }
+    const double slam     = std::sqrt(mean);
+    const double loglam   = std::log(mean);
+    const double b        = 0.931 + 2.53 * slam;
+    const double a        = -0.059 + 0.02483 * b;
+    const double invalpha = 1.1239 + 1.1328 / (b - 3.4);
+    const double vr       = 0.9277 - 3.6224 / (b - 2.);
+    while (true) {
+      const double u  = rng.uniform() - 0.5;
+      const double v  = rng.uniform();
+      const double us = 0.5 - std::abs(u);
+      const double k  = std::floor((2. * a / us + b) * u + mean + 0.43);
+      if ((us >= 0.07) && (v <= vr)) {
+        return static_cast<std::uint64_t>(k);
+      }
+      if ((k < 0.) || ((us < 0.013) && (v > us))) {
+        continue;
+      }
+      if (std::log(v) + std::log(invalpha) - std::log(a / (us * us) + b) <= -mean + k * loglam - std::lgamma(k + 1.)) {
+        return static_cast<std::uint64_t>(k);
+      }
+    }
+  }
+
+} // namespace
+
 //------------------------
 // init
 //------------------------
@@ -38,27 +87,9 @@ void PhotoMultiplierHitDigi::init()
     // print the configuration parameters
     debug() << m_cfg << endmsg;
 
-    /* warn if using potentially thread-unsafe seed
-     * FIXME: remove this warning when this issue is resolved:
-     *        https://github.com/eic/EICrecon/issues/539
-     */
-    if(m_cfg.seed==0) warning("using seed=0 may cause thread-unsafe behavior of TRandom (EICrecon issue 539)");
-
-    // random number generators
-    m_random.SetSeed(m_cfg.seed);
-    m_rngNorm = [&](){
-        return m_random.Gaus(0., 1.0);
-    };
-    m_rngUni = [&](){
-        return m_random.Uniform(0., 1.0);
-    };
-    //auto randSvc = svc<IRndmGenSvc>("RndmGenSvc", true);
-    auto sc1 = m_rngUni;//m_rngUni.initialize(randSvc, Rndm::Flat(0., 1.));
-    auto sc2 = m_rngNorm;//m_rngNorm.initialize(randSvc, Rndm::Gauss(0., 1.));
-    //if (!sc1.isSuccess() || !sc2.isSuccess()) {
-    if (!sc1 || !sc2) {
-        throw std::runtime_error("Cannot initialize random generator!");
-    }
+    // random number streams, `seed` is combined with the run and event numbers
+    auto& serviceSvc = algorithms::ServiceSvc::instance();
+    m_random = serviceSvc.service<CounterRandomSvc>("CounterRandomSvc");
 
     // initialize quantum efficiency table
     qe_init();
@@ -72,25 +103,45 @@ void PhotoMultiplierHitDigi::process(
       const PhotoMultiplierHitDigi::Input& input,
       const PhotoMultiplierHitDigi::Output& output) const
 {
-        const auto [sim_hits] = input;
+        const auto [headers, sim_hits] = input;
         auto [raw_hits, hit_assocs] = output;
 
+        const auto& header = headers->at(0);
+        const auto random_key = m_random->key(name(), header.getRunNumber(), header.getEventNumber(), m_cfg.seed);
+
         trace("{:=^70}"," call PhotoMultiplierHitDigi::process ");
-        std::unordered_map<CellIDType, std::vector<HitData>> hit_groups;
+        HitGroups hit_groups{EventArena::resource()};
         // collect the photon hit in the same cell
         // calculate signal
         trace("{:-<70}","Loop over simulated hits ");
-        for(std::size_t sim_hit_index = 0; sim_hit_index < sim_hits->size(); sim_hit_index++) {
+
+        // overall safety factor and quantum efficiency of all photons at once;
+        // the two uniforms are the first numbers of the stream of each hit
+        const std::size_t n_sim_hits = sim_hits->size();
+        std::vector<CounterRandom> rngs;
+        std::vector<double> edeps_eV(n_sim_hits), qe_rands(n_sim_hits);
+        std::vector<std::uint8_t> qe_accepted(n_sim_hits);
+        rngs.reserve(n_sim_hits);
+        for(std::size_t sim_hit_index = 0; sim_hit_index < n_sim_hits; sim_hit_index++) {
             const auto& sim_hit = sim_hits->at(sim_hit_index);
-            auto edep_eV = sim_hit.getEDep() * 1e9; // [GeV] -> [eV] // FIXME: use common unit converters, when available
+            // substream 0 is used for noise
+            auto& rng = rngs.emplace_back(m_random->generator(random_key, sim_hit.getCellID(), sim_hit_index + 1));
+            const double safety_rand = rng.uniform();
+            edeps_eV[sim_hit_index]  = sim_hit.getEDep() * 1e9; // [GeV] -> [eV] // FIXME: use common unit converters, when available
+            qe_rands[sim_hit_index]  = (safety_rand > m_cfg.safetyFactor) ? 2. : rng.uniform(); // 2 is never accepted
+        }
+        qe_pass(edeps_eV, qe_rands, qe_accepted);
+
+        for(std::size_t sim_hit_index = 0; sim_hit_index < n_sim_hits; sim_hit_index++) {
+            const auto& sim_hit = sim_hits->at(sim_hit_index);
+            auto edep_eV = edeps_eV[sim_hit_index];
             auto id      = sim_hit.getCellID();
             trace("hit: pixel id={:#018X}  edep = {} eV", id, edep_eV);
 
-            // overall safety factor
-            if (m_rngUni() > m_cfg.safetyFactor) continue;
+            auto& rng = rngs[sim_hit_index];
 
-            // quantum efficiency
-            if (!qe_pass(edep_eV, m_rngUni())) continue;
+            // overall safety factor and quantum efficiency
+            if (!qe_accepted[sim_hit_index]) continue;
 
             // pixel gap cuts
             if(m_cfg.enablePixelGaps) {
@@ -103,7 +154,7 @@ void PhotoMultiplierHitDigi::process(
             trace(" -> hit accepted");
             trace(" -> MC hit id={}", sim_hit.getObjectID().index);
             auto   time = sim_hit.getTime();
-            double amp  = m_cfg.speMean + m_rngNorm() * m_cfg.speError;
+            double amp  = m_cfg.speMean + rng.gaussian() * m_cfg.speError;
 
             // insert hit to `hit_groups`
             InsertHit(
@@ -111,7 +162,8 @@ void PhotoMultiplierHitDigi::process(
                 id,
                 amp,
                 time,
-                sim_hit_index
+                sim_hit_index,
+                rng
                 );
         }
 
@@ -130,25 +182,24 @@ void PhotoMultiplierHitDigi::process(
         if (m_cfg.enableNoise) {
           trace("{:=^70}"," BEGIN NOISE INJECTION ");
           float p = m_cfg.noiseRate*m_cfg.noiseTimeWindow;
-          auto cellID_action = [this,&hit_groups] (auto id) {
-
-            // cell time, signal amplitude
-            double   amp  = m_cfg.speMean + m_rngNorm()*m_cfg.speError;
-            TimeType time = m_cfg.noiseTimeWindow*m_rngUni() / dd4hep::ns;
-            dd4hep::Position pos_hit_global = m_converter->position(id);
-
-            // insert in `hit_groups`, or if the pixel already has a hit, update `npe` and `signal`
-            this->InsertHit(
-                hit_groups,
-                id,
-                amp,
-                time,
-                0, // not used
-                true
-                );
-
-          };
-          m_VisitRngCellIDs(cellID_action, p);
+          if (!m_noise_cellIDs.empty()) {
+            // sparse sampling: a Poisson number of noise hits for the whole
+            // readout, each on a uniformly drawn pixel
+            auto rng = m_random->generator(random_key, 0, noise_sampling_substream);
+            const auto n_pixels = m_noise_cellIDs.size();
+            const auto n_noise  = poisson(rng, static_cast<double>(p) * n_pixels);
+            trace("{} noise hits in {} pixels", n_noise, n_pixels);
+            for (std::uint64_t i = 0; i < n_noise; ++i) {
+              const auto index = std::min(static_cast<std::size_t>(rng.uniform() * n_pixels), n_pixels - 1);
+              InsertNoiseHit(hit_groups, m_noise_cellIDs[index], random_key);
+            }
+          }
+          else {
+            auto cellID_action = [this,&hit_groups,random_key] (auto id) {
+              InsertNoiseHit(hit_groups, id, random_key);
+            };
+            m_VisitRngCellIDs(cellID_action, p);
+          }
         }
 
         // build output `RawTrackerHit` and `MCRecoTrackerHitAssociation` collections
@@ -167,8 +218,8 @@ void PhotoMultiplierHitDigi::process(
                     raw_hit.getTimeStamp()
                     );
 
-                // build `MCRecoTrackerHitAssociation` (for non-noise hits only)
-                if(!data.sim_hit_indices.empty()) {
+                // build `MCRecoTrackerHitAssociation` (for non-noise hits only, if asked for)
+                if(hit_assocs != nullptr && !data.sim_hit_indices.empty()) {
                   for(auto i : data.sim_hit_indices) {
                     auto hit_assoc = hit_assocs->create();
                     hit_assoc.setWeight(1.0 / data.sim_hit_indices.size()); // not used
@@ -216,66 +267,81 @@ void PhotoMultiplierHitDigi::qe_init()
         if (qeff.back().first < 3.0) {
             warning("Quantum efficiency data end at {:.2f} {}", qeff.back().first, " eV, maybe you are using wrong units?");
         }
-}
 
-
-template<class RndmIter, typename T, class Compare> RndmIter PhotoMultiplierHitDigi::interval_search(RndmIter beg, RndmIter end, const T &val, Compare comp) const
-{
-        // special cases
-        auto dist = std::distance(beg, end);
-        if ((dist < 2) || (comp(*beg, val) > 0) || (comp(*std::prev(end), val) < 0)) {
-            return end;
-        }
-        auto mid = std::next(beg, dist / 2);
-
-        while (mid != end) {
-            if (comp(*mid, val) == 0) {
-                return mid;
-            } else if (comp(*mid, val) > 0) {
-                end = mid;
-            } else {
-                beg = std::next(mid);
+        // resample the linear interpolation of the table on a uniform grid, so
+        // that each photon is one index computation instead of a search
+        qe_grid_min = qeff.front().first;
+        qe_grid_max = qeff.back().first;
+        qe_grid.assign(qe_grid_points, qeff.front().second);
+        const double step = (qe_grid_max - qe_grid_min) / (qe_grid_points - 1);
+        qe_grid_inv_step  = (step > 0) ? 1. / step : 0.;
+        auto it = qeff.begin();
+        for (std::size_t i = 0; i < qe_grid_points; ++i) {
+            const double ev = (i + 1 == qe_grid_points) ? qe_grid_max : qe_grid_min + i * step;
+            while (std::next(it) != qeff.end() && std::next(it)->first <= ev && std::next(it, 2) != qeff.end()) {
+                ++it;
             }
-            mid = std::next(beg, std::distance(beg, end)/2);
-        }
-
-        if (mid == end || comp(*mid, val) > 0) {
-            return std::prev(mid);
+            auto itn = std::next(it);
+            double prob = it->second;
+            if (itn != qeff.end() && (itn->first - it->first != 0)) {
+                prob = (it->second*(itn->first - ev) + itn->second*(ev - it->first)) / (itn->first - it->first);
+            }
+            qe_grid[i] = prob;
         }
-        return mid;
 }
 
-bool PhotoMultiplierHitDigi::qe_pass(double ev, double rand) const
+
+void PhotoMultiplierHitDigi::qe_pass(std::span<const double> ev, std::span<const double> rand, std::span<std::uint8_t> pass) const
 {
-        auto it = interval_search(qeff.begin(), qeff.end(), ev,
-                    [] (const std::pair<double, double> &vals, double val) {
-                        return vals.first - val;
-                    });
-
-        if (it == qeff.end()) {
-            // warning("{} eV is out of QE data range, assuming 0\% efficiency",ev);
-            return false;
+        // no data dependencies between photons, so that the loop can be vectorized
+        const std::size_t n    = std::min({ev.size(), rand.size(), pass.size()});
+        const std::size_t last = qe_grid.size() - 2;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double x    = (ev[i] - qe_grid_min) * qe_grid_inv_step;
+            const bool   in   = (x >= 0.) && (ev[i] <= qe_grid_max) && (qe_grid_inv_step > 0.);
+            const double xc   = in ? x : 0.;
+            const auto   j    = std::min(static_cast<std::size_t>(xc), last);
+            const double f    = xc - static_cast<double>(j);
+            const double prob = qe_grid[j] + f * (qe_grid[j + 1] - qe_grid[j]);
+            pass[i] = static_cast<std::uint8_t>(in && (rand[i] <= prob));
         }
+}
 
-        double prob = it->second;
-        auto itn = std::next(it);
-        if (itn != qeff.end() && (itn->first - it->first != 0)) {
-            prob = (it->second*(itn->first - ev) + itn->second*(ev - it->first)) / (itn->first - it->first);
-        }
 
-        // trace("{} eV, QE: {}\%",ev,prob*100.);
-        return rand <= prob;
+// add the noise hit of a pixel to local `hit_groups` data structure
+void PhotoMultiplierHitDigi::InsertNoiseHit(
+    HitGroups &hit_groups,
+    CellIDType       id,
+    std::uint64_t    random_key
+    ) const
+{
+  auto rng = m_random->generator(random_key, id);
+
+  // cell time, signal amplitude
+  double   amp  = m_cfg.speMean + rng.gaussian()*m_cfg.speError;
+  TimeType time = m_cfg.noiseTimeWindow*rng.uniform() / dd4hep::ns;
+
+  // insert in `hit_groups`, or if the pixel already has a hit, update `npe` and `signal`
+  InsertHit(
+      hit_groups,
+      id,
+      amp,
+      time,
+      0, // not used
+      rng,
+      true
+      );
 }
 
-
 // add a hit to local `hit_groups` data structure
 // NOLINTBEGIN(bugprone-easily-swappable-parameters)
 void PhotoMultiplierHitDigi::InsertHit(
-    std::unordered_map<CellIDType, std::vector<HitData>> &hit_groups,
+    HitGroups &hit_groups,
     CellIDType       id,
     double           amp,
     TimeType         time,
     std::size_t      sim_hit_index,
+    CounterRandom&   rng,
     bool             is_noise_hit
     ) const // NOLINTEND(bugprone-easily-swappable-parameters)
 {
@@ -294,7 +360,7 @@ void PhotoMultiplierHitDigi::InsertHit(
     }
     // no hits group found
     if (i >= it->second.size()) {
-      auto sig = amp + m_cfg.pedMean + m_cfg.pedError * m_rngNorm();
+      auto sig = amp + m_cfg.pedMean + m_cfg.pedError * rng.gaussian();
       decltype(HitData::sim_hit_indices) indices;
       if(!is_noise_hit) indices.push_back(sim_hit_index);
       hit_groups.insert({ id, {HitData{1, sig, time, indices}} });
@@ -302,7 +368,7 @@ void PhotoMultiplierHitDigi::InsertHit(
       trace("    so new group @ {:#018X}: signal={}", id, sig);
     }
   } else {
-    auto sig = amp + m_cfg.pedMean + m_cfg.pedError * m_rngNorm();
+    auto sig = amp + m_cfg.pedMean + m_cfg.pedError * rng.gaussian();
     decltype(HitData::sim_hit_indices) indices;
     if(!is_noise_hit) indices.push_back(sim_hit_index);
     hit_groups.insert({ id, {HitData{1, sig, time, indices}} });
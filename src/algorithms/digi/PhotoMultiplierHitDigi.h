@@ -17,18 +17,21 @@
 
 #include <DD4hep/Detector.h>
 #include <DD4hep/Objects.h>
-#include <DDRec/CellIDPositionConverter.h>
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/DisplacementVector3D.h>
-#include <TRandomGen.h>
 #include <algorithms/algorithm.h>
 #include <algorithms/geo.h>
 #include <edm4eic/MCRecoTrackerHitAssociationCollection.h>
 #include <edm4eic/RawTrackerHitCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
 #include <edm4hep/SimTrackerHitCollection.h>
 #include <stdint.h>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory_resource>
+#include <optional>
+#include <span>
 #include <gsl/pointers>
 #include <stdexcept>
 #include <string>
@@ -38,17 +41,19 @@
 #include <vector>
 
 #include "PhotoMultiplierHitDigiConfig.h"
+#include "algorithms/interfaces/CounterRandomSvc.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 
 namespace eicrecon {
 
   using PhotoMultiplierHitDigiAlgorithm = algorithms::Algorithm<
     algorithms::Input<
+      edm4hep::EventHeaderCollection,
       edm4hep::SimTrackerHitCollection
     >,
     algorithms::Output<
       edm4eic::RawTrackerHitCollection,
-      edm4eic::MCRecoTrackerHitAssociationCollection
+      std::optional<edm4eic::MCRecoTrackerHitAssociationCollection>
     >
   >;
 
@@ -59,7 +64,7 @@ namespace eicrecon {
   public:
     PhotoMultiplierHitDigi(std::string_view name)
       : PhotoMultiplierHitDigiAlgorithm{name,
-                            {"inputHitCollection"},
+                            {"eventHeaderCollection", "inputHitCollection"},
                             {"outputRawHitCollection", "outputRawHitAssociations"},
                             "Digitize within ADC range, add pedestal, convert time "
                             "with smearing resolution."} {}
@@ -79,12 +84,6 @@ namespace eicrecon {
       std::vector<std::size_t> sim_hit_indices;
     };
 
-    // random number generators
-    TRandomMixMax m_random;
-    std::function<double()> m_rngNorm;
-    std::function<double()> m_rngUni;
-    //Rndm::Numbers m_rngUni, m_rngNorm;
-
     // set `m_VisitAllRngPixels`, a visitor to run an action (type
     // `function<void(cellID)>`) on a selection of random CellIDs; must be
     // defined externally, since this would be detector-specific
@@ -93,6 +92,11 @@ namespace eicrecon {
         )
     { m_VisitRngCellIDs = visitor; }
 
+    // set `m_noise_cellIDs`, the cellIDs of all the readout pixels; noise hits
+    // are then sampled from them, instead of with `m_VisitRngCellIDs`; the
+    // cellIDs must outlive this algorithm
+    void SetNoiseCellIDs(std::span<const CellIDType> cellIDs) { m_noise_cellIDs = cellIDs; }
+
     // set `m_PixelGapMask`, which takes `cellID` and MC hit position, returning
     // true if the hit position is on a pixel, or false if on a pixel gap; must be
     // defined externally, since this would be detector-specific
@@ -107,6 +111,9 @@ protected:
     std::function< void(std::function<void(CellIDType)>, float) > m_VisitRngCellIDs =
       [] ( std::function<void(CellIDType)> visitor_action, float p ) { /* default no-op */ };
 
+    // all readout pixels, for noise sampling (set with SetNoiseCellIDs)
+    std::span<const CellIDType> m_noise_cellIDs;
+
     // pixel gap mask
     std::function< bool(CellIDType, dd4hep::Position) > m_PixelGapMask =
       [] (CellIDType cellID, dd4hep::Position pos_hit_global) {
@@ -116,25 +123,39 @@ protected:
 
 private:
 
+    // the hits of the event by pixel, in the arena of the event
+    using HitGroups = std::pmr::unordered_map<CellIDType, std::pmr::vector<HitData>>;
+
     // add a hit to local `hit_groups` data structure
     void InsertHit(
-        std::unordered_map<CellIDType, std::vector<HitData>> &hit_groups,
+        HitGroups &hit_groups,
         CellIDType       id,
         double           amp,
         TimeType         time,
         std::size_t      sim_hit_index,
+        CounterRandom&   rng,
         bool             is_noise_hit = false
         ) const;
 
+    // add the noise hit of pixel `id` to `hit_groups`
+    void InsertNoiseHit(
+        HitGroups &hit_groups,
+        CellIDType       id,
+        std::uint64_t    random_key
+        ) const;
+
     const dd4hep::Detector* m_detector{algorithms::GeoSvc::instance().detector()};
-    const dd4hep::rec::CellIDPositionConverter* m_converter{algorithms::GeoSvc::instance().cellIDPositionConverter()};
 
-    // std::default_random_engine generator; // TODO: need something more appropriate here
-    // std::normal_distribution<double> m_normDist; // defaults to mean=0, sigma=1
+    // random streams, one per MC hit and one per cell for noise
+    const CounterRandomSvc* m_random{nullptr};
 
+    // quantum efficiency table, and its resampling on a uniform energy grid
+    static constexpr std::size_t qe_grid_points = 4096;
     std::vector<std::pair<double, double>> qeff;
+    std::vector<double> qe_grid;
+    double qe_grid_min{0}, qe_grid_max{0}, qe_grid_inv_step{0};
     void qe_init();
-    template<class RndmIter, typename T, class Compare> RndmIter interval_search(RndmIter beg, RndmIter end, const T &val, Compare comp) const;
-    bool qe_pass(double ev, double rand) const;
+    // `pass[i]` is whether a photon of energy `ev[i]` [eV] is detected, given a uniform random `rand[i]`
+    void qe_pass(std::span<const double> ev, std::span<const double> rand, std::span<std::uint8_t> pass) const;
 };
 }
@@ -14,7 +14,7 @@ namespace eicrecon {
        * FIXME: remove this warning when this issue is resolved:
        *        https://github.com/eic/EICrecon/issues/539
        */
-      unsigned long seed = 1; // seed for RNG (note: `0` might mean "unique" seed)
+      unsigned long seed = 1; // seed for RNG, combined with the run and event numbers
 
       // triggering
       double hitTimeWindow  = 20.0;   // time gate in which 2 input hits will be grouped to 1 output hit // [ns]
@@ -3,18 +3,31 @@
 
 #include "SiliconTrackerDigi.h"
 
+#include <DD4hep/Detector.h>
+#include <DD4hep/Readout.h>
+#include <DD4hep/Segmentations.h>
+#include <DD4hep/Volumes.h>
+#include <DDSegmentation/CartesianGridXY.h>
 #include <Evaluator/DD4hepUnits.h>
+#include <TGeoBBox.h>
+#include <algorithms/geo.h>
 #include <edm4eic/EDM4eicVersion.h>
 #include <edm4hep/MCParticleCollection.h>
 #include <edm4hep/Vector3d.h>
 #include <edm4hep/Vector3f.h>
 #include <fmt/core.h>
+#include <functional>
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <gsl/pointers>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "algorithms/digi/SiliconTrackerDigiConfig.h"
 
@@ -26,6 +39,105 @@ void SiliconTrackerDigi::init() {
         return m_random.Gaus(0, m_cfg.timeResolution);
         //return m_rng.gaussian<double>(0., m_cfg.timeResolution);
     };
+    m_poisson = [&](double mean){
+        return (double) m_random.Poisson(mean);
+    };
+    m_uniform = [&](){
+        return m_random.Rndm();
+    };
+
+    if (m_cfg.noiseOccupancy > 0) {
+        initNoise();
+    }
+}
+
+
+void SiliconTrackerDigi::initNoise() {
+    m_noise_sensors.clear();
+    m_noise_channels_end.clear();
+    if (m_cfg.readout.empty()) {
+        error("readout is not provided, it is needed to know the channels of the sensors for the noise");
+        throw std::runtime_error("readout is not provided");
+    }
+    const auto* detector = algorithms::GeoSvc::instance().detector();
+    const auto readout = detector->readout(m_cfg.readout);
+    const auto* grid = dynamic_cast<const dd4hep::DDSegmentation::CartesianGridXY*>(readout.segmentation().segmentation());
+    if (grid == nullptr) {
+        error("Noise is only generated for CartesianGridXY segmentations, not {} of {}", readout.segmentation().type(), m_cfg.readout);
+        throw std::runtime_error(fmt::format("unsupported segmentation of {} for the noise", m_cfg.readout));
+    }
+    const auto* decoder = readout.idSpec().decoder();
+    m_noise_field_x = &(*decoder)[grid->fieldNameX()];
+    m_noise_field_y = &(*decoder)[grid->fieldNameY()];
+
+    // the pixels of the bounding box of every sensitive volume, with the binning of the segmentation
+    const auto bin = [](double position, double size, double offset) {
+        return (std::int64_t) std::floor((position + 0.5 * size - offset) / size);
+    };
+    std::function<void(dd4hep::PlacedVolume, dd4hep::DDSegmentation::CellID)> walk =
+        [&](dd4hep::PlacedVolume placement, dd4hep::DDSegmentation::CellID volume_id) {
+        for (const auto& [field, value] : placement.volIDs()) {
+            (*decoder)[field].set(volume_id, value);
+        }
+        auto volume = placement.volume();
+        if (volume.isSensitive()) {
+            const auto* box = dynamic_cast<const TGeoBBox*>(volume.solid().ptr());
+            if (box != nullptr) {
+                const double dx = box->GetDX() * (1 - 1e-9), dy = box->GetDY() * (1 - 1e-9);
+                const auto x_min = bin(-dx, grid->gridSizeX(), grid->offsetX());
+                const auto y_min = bin(-dy, grid->gridSizeY(), grid->offsetY());
+                const auto nx = bin(dx, grid->gridSizeX(), grid->offsetX()) - x_min + 1;
+                const auto ny = bin(dy, grid->gridSizeY(), grid->offsetY()) - y_min + 1;
+                m_noise_sensors.push_back({volume_id, x_min, y_min, (std::uint64_t) nx, (std::uint64_t) ny});
+                const std::uint64_t before = m_noise_channels_end.empty() ? 0 : m_noise_channels_end.back();
+                m_noise_channels_end.push_back(before + nx * ny);
+            }
+        }
+        for (Int_t i = 0; i < volume->GetNdaughters(); ++i) {
+            walk(dd4hep::PlacedVolume(volume->GetNode(i)), volume_id);
+        }
+    };
+    for (const auto& [name, handle] : detector->detectors()) {
+        const auto sensitive = detector->sensitiveDetector(name);
+        if (sensitive.isValid() && sensitive.readout().name() == m_cfg.readout) {
+            walk(dd4hep::DetElement(handle).placement(), 0);
+        }
+    }
+
+    if (m_noise_sensors.empty()) {
+        warning("No sensors of {} for the noise", m_cfg.readout);
+        return;
+    }
+    info("Noise in {} channels of {} sensors of {}, {} hits per event on average",
+         m_noise_channels_end.back(), m_noise_sensors.size(), m_cfg.readout,
+         m_cfg.noiseOccupancy * m_noise_channels_end.back());
+}
+
+
+std::vector<SiliconTrackerDigi::NoiseHit> SiliconTrackerDigi::sampleNoise() const {
+    std::vector<NoiseHit> noise_hits;
+    if (m_noise_sensors.empty()) {
+        return noise_hits;
+    }
+
+    // a Poisson number of hits in all the channels, the same as a Poisson number per sensor
+    const std::uint64_t channels = m_noise_channels_end.back();
+    const auto n = (std::size_t) m_poisson(m_cfg.noiseOccupancy * channels);
+    const double edep = (m_cfg.noiseEDep > 0) ? m_cfg.noiseEDep : m_cfg.threshold;
+    noise_hits.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto channel = std::min((std::uint64_t) (m_uniform() * channels), channels - 1);
+        const std::size_t s = std::upper_bound(m_noise_channels_end.begin(), m_noise_channels_end.end(), channel) - m_noise_channels_end.begin();
+        const auto& sensor = m_noise_sensors[s];
+        const std::uint64_t pixel = channel - ((s == 0) ? 0 : m_noise_channels_end[s - 1]);
+
+        // the cellID from the fields, without a geometry lookup
+        dd4hep::DDSegmentation::CellID cell_id = sensor.volumeID;
+        m_noise_field_x->set(cell_id, sensor.x_min + (std::int64_t) (pixel % sensor.nx));
+        m_noise_field_y->set(cell_id, sensor.y_min + (std::int64_t) (pixel / sensor.nx));
+        noise_hits.push_back({cell_id, edep, m_uniform() * m_cfg.noiseTimeWindow});
+    }
+    return noise_hits;
 }
 
 
@@ -36,9 +148,39 @@ void SiliconTrackerDigi::process(
     const auto [sim_hits] = input;
     auto [raw_hits,associations] = output;
 
-    // A map of unique cellIDs with temporary structure RawHit
-    std::unordered_map<std::uint64_t, edm4eic::MutableRawTrackerHit> cell_hit_map;
+    if (m_cfg.readoutWindow > 0) {
+        processWindows(*sim_hits, *raw_hits, associations);
+        return;
+    }
+
+    // Unique cells with temporary structure RawHit, in the order of their first hit
+    std::vector<edm4eic::MutableRawTrackerHit> cell_hits;
+    std::unordered_map<std::uint64_t, std::size_t> cell_index;
+    cell_hits.reserve(sim_hits->size());
+    cell_index.reserve(sim_hits->size());
 
+    const auto deposit = [&](std::uint64_t cell_id, double edep, std::int32_t hit_time_stamp) {
+        auto [it, inserted] = cell_index.try_emplace(cell_id, cell_hits.size());
+        if (inserted) {
+            // This cell doesn't have hits
+            cell_hits.emplace_back(
+                cell_id,
+                (std::int32_t) std::llround(edep * 1e6),
+                hit_time_stamp  // ns->ps
+            );
+        } else {
+            // There is previous values in the cell
+            auto& hit = cell_hits[it->second];
+            debug("  Hit already exists in cell ID={}, prev. hit time: {}", cell_id, hit.getTimeStamp());
+
+            // keep earliest time for hit
+            hit.setTimeStamp(std::min(hit_time_stamp, hit.getTimeStamp()));
+
+            // sum deposited energy
+            auto charge = hit.getCharge();
+            hit.setCharge(charge + (std::int32_t) std::llround(edep * 1e6));
+        }
+    };
 
     for (const auto& sim_hit : *sim_hits) {
 
@@ -64,46 +206,141 @@ void SiliconTrackerDigi::process(
             continue;
         }
 
-        if (cell_hit_map.count(sim_hit.getCellID()) == 0) {
-            // This cell doesn't have hits
-            cell_hit_map[sim_hit.getCellID()] = {
-                sim_hit.getCellID(),
-                (std::int32_t) std::llround(sim_hit.getEDep() * 1e6),
-                hit_time_stamp  // ns->ps
-            };
-        } else {
-            // There is previous values in the cell
-            auto& hit = cell_hit_map[sim_hit.getCellID()];
-            debug("  Hit already exists in cell ID={}, prev. hit time: {}", sim_hit.getCellID(), hit.getTimeStamp());
+        deposit(sim_hit.getCellID(), sim_hit.getEDep(), hit_time_stamp);
+    }
 
-            // keep earliest time for hit
-            auto time_stamp = hit.getTimeStamp();
-            hit.setTimeStamp(std::min(hit_time_stamp, hit.getTimeStamp()));
+    // noise hits have no sim hits to associate
+    for (const auto& noise_hit : sampleNoise()) {
+        deposit(noise_hit.cellID, noise_hit.edep, (std::int32_t) (noise_hit.time * 1e3));
+    }
 
-            // sum deposited energy
-            auto charge = hit.getCharge();
-            hit.setCharge(charge + (std::int32_t) std::llround(sim_hit.getEDep() * 1e6));
+    if (associations == nullptr) {
+        // no associations asked for
+        for (const auto& cell_hit : cell_hits) {
+            raw_hits->push_back(cell_hit);
+        }
+        return;
+    }
+
+    // Sim hits of each cell, including the ones below threshold, grouped by
+    // cell with a counting sort that keeps the collection order within a cell
+    std::vector<std::size_t> offsets(cell_hits.size() + 1, 0);
+    std::vector<std::size_t> hit_cell(sim_hits->size(), cell_hits.size());
+    for (std::size_t i = 0; i < sim_hits->size(); ++i) {
+        auto it = cell_index.find((*sim_hits)[i].getCellID());
+        if (it != cell_index.end()) {
+            hit_cell[i] = it->second;
+            ++offsets[it->second + 1];
+        }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<std::size_t> cell_sim_hits(offsets.back());
+    {
+        std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < sim_hits->size(); ++i) {
+            if (hit_cell[i] < cell_hits.size()) {
+                cell_sim_hits[next[hit_cell[i]]++] = i;
+            }
         }
     }
 
-    for (auto item : cell_hit_map) {
-        raw_hits->push_back(item.second);
+    for (std::size_t c = 0; c < cell_hits.size(); ++c) {
+        raw_hits->push_back(cell_hits[c]);
 
-        for (const auto& sim_hit : *sim_hits) {
-          if (item.first == sim_hit.getCellID()) {
+        for (std::size_t k = offsets[c]; k < offsets[c + 1]; ++k) {
+            const auto sim_hit = (*sim_hits)[cell_sim_hits[k]];
             // set association
             auto hitassoc = associations->create();
             hitassoc.setWeight(1.0);
-            hitassoc.setRawHit(item.second);
+            hitassoc.setRawHit(cell_hits[c]);
 #if EDM4EIC_VERSION_MAJOR >= 6
             hitassoc.setSimHit(sim_hit);
 #else
             hitassoc.addToSimHits(sim_hit);
 #endif
-          }
         }
 
     }
 }
 
+
+void SiliconTrackerDigi::processWindows(
+        const edm4hep::SimTrackerHitCollection& sim_hits,
+        edm4eic::RawTrackerHitCollection& raw_hits,
+        edm4eic::MCRecoTrackerHitAssociationCollection* associations) const {
+
+    // smeared times, in the order of the collection as in the single window mode,
+    // followed by the noise hits, which have no sim hits
+    const std::size_t n_sim = sim_hits.size();
+    std::vector<std::uint64_t> cell_ids(n_sim);
+    std::vector<double> edeps(n_sim);
+    std::vector<double> times(n_sim);
+    for (std::size_t i = 0; i < n_sim; ++i) {
+        const auto sim_hit = sim_hits[i];
+        cell_ids[i] = sim_hit.getCellID();
+        edeps[i] = sim_hit.getEDep();
+        times[i] = sim_hit.getTime() + m_gauss();
+    }
+    for (const auto& noise_hit : sampleNoise()) {
+        cell_ids.push_back(noise_hit.cellID);
+        edeps.push_back(noise_hit.edep);
+        times.push_back(noise_hit.time);
+    }
+    const std::size_t n = cell_ids.size();
+    std::vector<std::int64_t> windows(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        windows[i] = (std::int64_t) std::floor(times[i] / m_cfg.readoutWindow);
+    }
+
+    // one sort by (cellID, time), then the hits of a window of a cell are consecutive
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return std::tie(cell_ids[a], times[a]) < std::tie(cell_ids[b], times[b]);
+    });
+
+    for (std::size_t begin = 0; begin < n;) {
+        const std::uint64_t cell_id = cell_ids[order[begin]];
+        const std::int64_t window = windows[order[begin]];
+        std::size_t end = begin + 1;
+        while (end < n && cell_ids[order[end]] == cell_id && windows[order[end]] == window) {
+            ++end;
+        }
+
+        // the earliest hit above threshold gives the time, as in the single window mode
+        bool fired = false;
+        std::int32_t charge = 0;
+        std::int32_t time_stamp = 0;
+        for (std::size_t k = begin; k < end; ++k) {
+            if (edeps[order[k]] < m_cfg.threshold) {
+                continue;
+            }
+            if (!fired) {
+                time_stamp = (std::int32_t) (times[order[k]] * 1e3); // ns->ps
+                fired = true;
+            }
+            charge += (std::int32_t) std::llround(edeps[order[k]] * 1e6);
+        }
+
+        if (fired) {
+            auto raw_hit = raw_hits.create(cell_id, charge, time_stamp);
+            debug("Hit cellID = {}, window {}: {} hits, time stamp {} [~ps]", cell_id, window, end - begin, time_stamp);
+            for (std::size_t k = begin; associations != nullptr && k < end; ++k) {
+                if (order[k] >= n_sim) {
+                    continue; // noise
+                }
+                auto hitassoc = associations->create();
+                hitassoc.setWeight(1.0);
+                hitassoc.setRawHit(raw_hit);
+#if EDM4EIC_VERSION_MAJOR >= 6
+                hitassoc.setSimHit(sim_hits[order[k]]);
+#else
+                hitassoc.addToSimHits(sim_hits[order[k]]);
+#endif
+            }
+        }
+        begin = end;
+    }
+}
+
 } // namespace eicrecon
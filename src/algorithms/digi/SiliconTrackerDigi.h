@@ -3,14 +3,18 @@
 
 #pragma once
 
+#include <DDSegmentation/BitFieldCoder.h>
 #include <TRandomGen.h>
 #include <algorithms/algorithm.h>
 #include <edm4eic/MCRecoTrackerHitAssociationCollection.h>
 #include <edm4eic/RawTrackerHitCollection.h>
 #include <edm4hep/SimTrackerHitCollection.h>
+#include <cstdint>
 #include <functional>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "SiliconTrackerDigiConfig.h"
 #include "algorithms/interfaces/WithPodConfig.h"
@@ -20,7 +24,7 @@ namespace eicrecon {
 using SiliconTrackerDigiAlgorithm =
     algorithms::Algorithm<algorithms::Input<edm4hep::SimTrackerHitCollection>,
                           algorithms::Output<edm4eic::RawTrackerHitCollection,
-                                             edm4eic::MCRecoTrackerHitAssociationCollection>>;
+                                             std::optional<edm4eic::MCRecoTrackerHitAssociationCollection>>>;
 
 class SiliconTrackerDigi : public SiliconTrackerDigiAlgorithm,
                            public WithPodConfig<SiliconTrackerDigiConfig> {
@@ -37,9 +41,43 @@ public:
   void process(const Input&, const Output&) const final;
 
 private:
+  /** A noise hit, of no sim hit */
+  struct NoiseHit {
+    std::uint64_t cellID;
+    double edep;
+    double time;
+  };
+
+  /** Raw hits per cell and readout window, from the hits sorted by (cellID, time),
+      without associations if they are nullptr */
+  void processWindows(const edm4hep::SimTrackerHitCollection& sim_hits,
+                      edm4eic::RawTrackerHitCollection& raw_hits,
+                      edm4eic::MCRecoTrackerHitAssociationCollection* associations) const;
+
+  /** Channel table of the sensors of the readout, for the noise */
+  void initNoise();
+
+  /** Poisson number of noise hits in random channels of the table */
+  std::vector<NoiseHit> sampleNoise() const;
+
+  /** Pixels of a sensor, as ranges of the x and y fields of the segmentation */
+  struct NoiseSensor {
+    std::uint64_t volumeID;
+    std::int64_t x_min;
+    std::int64_t y_min;
+    std::uint64_t nx;
+    std::uint64_t ny;
+  };
+  std::vector<NoiseSensor> m_noise_sensors;
+  std::vector<std::uint64_t> m_noise_channels_end; // cumulative channel count of the sensors
+  const dd4hep::DDSegmentation::BitFieldElement* m_noise_field_x{nullptr};
+  const dd4hep::DDSegmentation::BitFieldElement* m_noise_field_y{nullptr};
+
   /** Random number generation*/
   TRandomMixMax m_random;
   std::function<double()> m_gauss;
+  std::function<double(double)> m_poisson;
+  std::function<double()> m_uniform;
 
   // FIXME replace with standard random engine
   // std::default_random_engine generator; // TODO: need something more appropriate here
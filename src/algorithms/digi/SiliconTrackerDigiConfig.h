@@ -4,6 +4,7 @@
 #pragma once
 
 #include <DD4hep/DD4hepUnits.h>
+#include <string>
 
 namespace eicrecon {
 
@@ -12,6 +13,15 @@ namespace eicrecon {
     // NB: be aware of thresholds in npsim! E.g. https://github.com/eic/npsim/pull/9/files
     double threshold  = 0 * dd4hep::keV;
     double timeResolution = 8;   /// TODO 8 of what units??? Same TODO in juggler. Probably [ns]
+    // readout windows of this length [ns] for streaming time frames, several raw hits per cell;
+    // the event is one integration window if 0
+    double readoutWindow = 0;
+
+    // noise hits, sampled from the channels of the sensors of the readout
+    std::string readout{""};
+    double noiseOccupancy = 0;    // probability of a noise hit per channel and event
+    double noiseEDep = 0;         // deposit of a noise hit, the threshold if 0
+    double noiseTimeWindow = 0;   // [ns] noise times are uniform in [0, noiseTimeWindow)
   };
 
 } // eicrecon
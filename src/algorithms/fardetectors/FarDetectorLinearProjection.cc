@@ -7,10 +7,13 @@
 #include <edm4hep/Vector3f.h>
 #include <fmt/core.h>
 #include <podio/RelationRange.h>
+#include <Eigen/Geometry>
 #include <Eigen/LU>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <gsl/pointers>
+#include <stdexcept>
 #include <vector>
 
 #include "algorithms/fardetectors/FarDetectorLinearProjection.h"
@@ -25,8 +28,20 @@ namespace eicrecon {
 
       // plane position
       m_plane_position << m_cfg.plane_position[0], m_cfg.plane_position[1], m_cfg.plane_position[2];
-      m_directions.block<3,1>(0,0) << m_cfg.plane_a[0], m_cfg.plane_a[1], m_cfg.plane_a[2];
-      m_directions.block<3,1>(0,1) << m_cfg.plane_b[0], m_cfg.plane_b[1], m_cfg.plane_b[2];
+
+      Eigen::Matrix<double,3,2> plane;
+      plane.col(0) << m_cfg.plane_a[0], m_cfg.plane_a[1], m_cfg.plane_a[2];
+      plane.col(1) << m_cfg.plane_b[0], m_cfg.plane_b[1], m_cfg.plane_b[2];
+      m_plane_normal = plane.col(0).cross(plane.col(1));
+      if(m_plane_normal.squaredNorm() == 0){
+        error("Invalid configuration: plane_a and plane_b do not span a plane");
+        throw std::runtime_error("Invalid configuration: plane_a and plane_b do not span a plane");
+      }
+
+      // A point in the plane is a*plane_a + b*plane_b, with (a,b) given by the
+      // left inverse of the two directions
+      const Eigen::Matrix2d gram = plane.transpose()*plane;
+      m_plane_inverse = gram.inverse()*plane.transpose();
 
     }
 
@@ -36,32 +51,47 @@ namespace eicrecon {
       const auto [inputSegments] = input;
       auto [outputTracks]        = output;
 
-      Eigen::Matrix3d directions = m_directions;
-
+      // 1. Gather the first point of every segment in columns
+      const std::size_t n = inputSegments->size();
+      std::vector<double> pos_x, pos_y, pos_z, theta, phi;
+      for(auto* column : {&pos_x, &pos_y, &pos_z, &theta, &phi}){
+        column->reserve(n);
+      }
       for(const auto& segment: *inputSegments ) {
+        if(segment.getPoints().empty()){
+          continue;
+        }
+        const auto& inputPoint = segment.getPoints()[0];
+        pos_x.push_back(inputPoint.position.x - m_plane_position.x());
+        pos_y.push_back(inputPoint.position.y - m_plane_position.y());
+        pos_z.push_back(inputPoint.position.z - m_plane_position.z());
+        theta.push_back(inputPoint.theta);
+        phi.push_back(inputPoint.phi);
+      }
 
-        auto inputPoint = segment.getPoints()[0];
-
-        Eigen::Vector3d point_position(inputPoint.position.x,inputPoint.position.y,inputPoint.position.z);
-        Eigen::Vector3d positionDiff = point_position - m_plane_position;
-
+      // 2. Intersect the lines with the plane, and take the in-plane coordinates
+      const std::size_t ntracks = theta.size();
+      std::vector<float> loc_a(ntracks), loc_b(ntracks);
+      for(std::size_t i=0; i<ntracks; ++i){
         // Convert spherical coordinates to Cartesian
-        double x = std::sin(inputPoint.theta) * std::cos(inputPoint.phi);
-        double y = std::sin(inputPoint.theta) * std::sin(inputPoint.phi);
-        double z = std::cos(inputPoint.theta);
-        directions.block<3,1>(0,2) << x,y,z;
-
-        auto projectedPoint = directions.inverse()*positionDiff;
+        const Eigen::Vector3d direction(std::sin(theta[i]) * std::cos(phi[i]),
+                                        std::sin(theta[i]) * std::sin(phi[i]),
+                                        std::cos(theta[i]));
+        const Eigen::Vector3d positionDiff(pos_x[i], pos_y[i], pos_z[i]);
+        const double t = m_plane_normal.dot(positionDiff) / m_plane_normal.dot(direction);
+        const Eigen::Vector2d projectedPoint = m_plane_inverse*(positionDiff - t*direction);
+        loc_a[i] = projectedPoint[0];
+        loc_b[i] = projectedPoint[1];
+      }
 
-        // Create track parameters edm4eic structure
-        // TODO - populate more of the fields correctly
+      // 3. Create track parameters edm4eic structure
+      // TODO - populate more of the fields correctly
+      for(std::size_t i=0; i<ntracks; ++i){
         std::int32_t type = 0;
         // Surface ID not used in this context
         std::uint64_t surface = 0;
         // Plane Point
-        edm4hep::Vector2f loc(projectedPoint[0],projectedPoint[1]); //Temp unit transform
-        float theta = inputPoint.theta;//edm4eic::anglePolar(outVec);
-        float phi   = inputPoint.phi  ;//edm4eic::angleAzimuthal(outVec);
+        edm4hep::Vector2f loc(loc_a[i],loc_b[i]);
         float qOverP = 0.;
         float time      = 0;
         int32_t pdgCode = 11;
@@ -69,10 +99,9 @@ namespace eicrecon {
         edm4eic::Cov6f error;
 
         debug("Position:      a={},   b={}",loc.a,loc.b);
-        debug("Direction: theta={}, phi={}",theta,phi);
-
-        outputTracks->create(type,surface,loc,theta,phi,qOverP,time,pdgCode,error);
+        debug("Direction: theta={}, phi={}",theta[i],phi[i]);
 
+        outputTracks->create(type,surface,loc,static_cast<float>(theta[i]),static_cast<float>(phi[i]),qOverP,time,pdgCode,error);
       }
 
     }
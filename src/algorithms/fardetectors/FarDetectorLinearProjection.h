@@ -45,9 +45,10 @@ namespace eicrecon {
 
     private:
         Eigen::Vector3d  m_plane_position;
-        Eigen::Vector3d  m_plane_a;
-        Eigen::Vector3d  m_plane_b;
-        Eigen::Matrix3d  m_directions;
+        // normal of the plane, and the rows giving the coordinates along
+        // plane_a and plane_b of a point in the plane, fixed at init
+        Eigen::Vector3d  m_plane_normal;
+        Eigen::Matrix<double,2,3> m_plane_inverse;
 
     };
 
@@ -12,12 +12,12 @@
 #include <edm4hep/utils/vector_utils.h>
 #include <fmt/core.h>
 #include <stdint.h>
+#include <Eigen/Eigenvalues>
 #include <Eigen/Geometry>
-#include <Eigen/Householder>
-#include <Eigen/Jacobi>
-#include <Eigen/QR>
-#include <Eigen/SVD>
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <limits>
 #include <utility>
 
 #include "FarDetectorLinearTracking.h"
@@ -31,9 +31,10 @@ namespace eicrecon {
       m_layerWeights = Eigen::VectorXd::Constant(m_cfg.n_layer,1);
 
       // For checking the direction of the track from theta and phi angles
-      m_optimumDirection = Eigen::Vector3d::UnitZ();
-      m_optimumDirection = Eigen::AngleAxisd(m_cfg.optimum_theta,Eigen::Vector3d::UnitY())*m_optimumDirection;
-      m_optimumDirection = Eigen::AngleAxisd(m_cfg.optimum_phi,Eigen::Vector3d::UnitZ())*m_optimumDirection;
+      Eigen::Matrix3d rotation = (Eigen::AngleAxisd(m_cfg.optimum_phi,Eigen::Vector3d::UnitZ())
+                                  *Eigen::AngleAxisd(m_cfg.optimum_theta,Eigen::Vector3d::UnitY())).toRotationMatrix();
+      m_optimumDirection = rotation*Eigen::Vector3d::UnitZ();
+      m_toOptimumFrame   = rotation.transpose();
 
     }
 
@@ -61,65 +62,115 @@ namespace eicrecon {
           }
         }
 
-        // Create a matrix to store the hit positions
-        Eigen::MatrixXd hitMatrix(3,m_cfg.n_layer);
+        // Bucket the hits per layer, sorted in x in the frame of the optimum direction
+        std::vector<LayerHits> layers(m_cfg.n_layer);
+        for(int layer=0; layer<m_cfg.n_layer; ++layer){
+          std::vector<std::pair<double,Eigen::Vector3d>> sorted;
+          sorted.reserve(inputhits[layer]->size());
+          double local_z_min = std::numeric_limits<double>::infinity();
+          for(auto hit : (*inputhits[layer])){
+            auto pos = hit.getPosition();
+            Eigen::Vector3d position(pos.x, pos.y, pos.z);
+            Eigen::Vector3d local = m_toOptimumFrame*position;
+            sorted.emplace_back(local.x(), position);
+            local_z_min = std::min(local_z_min, local.z());
+          }
+          std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+          auto& bucket = layers[layer];
+          bucket.positions.reserve(sorted.size());
+          bucket.local_x.reserve(sorted.size());
+          for(const auto& [x, position] : sorted){
+            bucket.local_x.push_back(x);
+            bucket.positions.push_back(position);
+          }
+          bucket.local_z_min = local_z_min;
+        }
+
         // Loop over all combinations of hits fitting a track to all layers
-        buildMatrixRecursive(m_cfg.n_layer-1,&hitMatrix,inputhits,outputTracks);
+        std::vector<Eigen::Vector3d> combination(m_cfg.n_layer);
+        buildHitCombinations(m_cfg.n_layer-1,combination,layers,outputTracks);
 
     }
 
 
-    void FarDetectorLinearTracking::buildMatrixRecursive(int level,
-                                                        Eigen::MatrixXd* hitMatrix,
-                                                        const std::vector<gsl::not_null<const edm4hep::TrackerHitCollection*>>& hits,
+    void FarDetectorLinearTracking::buildHitCombinations(int level,
+                                                        std::vector<Eigen::Vector3d>& combination,
+                                                        const std::vector<LayerHits>& layers,
                                                         gsl::not_null<edm4eic::TrackSegmentCollection*> outputTracks ) const {
 
+      const auto& layer = layers[level];
+
+      // Range of hits in this layer to iterate over
+      std::size_t first = 0;
+      std::size_t last  = layer.positions.size();
+
+      // A hit within the angular tolerance of the optimum direction from the hit in
+      // the next layer is displaced transversely by at most tan(tolerance) times
+      // the longitudinal distance, which bounds its local x
+      const bool restrict = m_cfg.restrict_direction && level<m_cfg.n_layer-1;
+      if(restrict && m_cfg.step_angle_tolerance<M_PI_2){
+        const Eigen::Vector3d next = m_toOptimumFrame*combination[level+1];
+        const double max_step = std::max(0.0, next.z()-layer.local_z_min)*std::tan(m_cfg.step_angle_tolerance);
+        first = std::lower_bound(layer.local_x.begin(), layer.local_x.end(), next.x()-max_step)-layer.local_x.begin();
+        last  = std::upper_bound(layer.local_x.begin(), layer.local_x.end(), next.x()+max_step)-layer.local_x.begin();
+      }
+
       // Iterate over hits in this layer
-      for(auto hit : (*hits[level])){
-        auto pos = hit.getPosition();
-        hitMatrix->col(level) << pos.x, pos.y, pos.z;
+      for(std::size_t ihit=first; ihit<last; ++ihit){
+        combination[level] = layer.positions[ihit];
 
         // Check the last two hits are within a certain angle of the optimum direction
-        if(m_cfg.restrict_direction && level<m_cfg.n_layer-1){
-          if(!checkHitPair(hitMatrix->col(level),hitMatrix->col(level+1))){
+        if(restrict){
+          if(!checkHitPair(combination[level],combination[level+1])){
             continue;
           }
         }
 
         if(level>0){
-          buildMatrixRecursive(level-1,
-                               hitMatrix,
-                               hits,
+          buildHitCombinations(level-1,
+                               combination,
+                               layers,
                                outputTracks);
         }
         else{
-          checkHitCombination(hitMatrix,outputTracks);
+          checkHitCombination(combination,outputTracks);
         }
       }
 
     }
 
 
-    void FarDetectorLinearTracking::checkHitCombination(Eigen::MatrixXd* hitMatrix,
+    void FarDetectorLinearTracking::checkHitCombination(const std::vector<Eigen::Vector3d>& combination,
                                                         gsl::not_null<edm4eic::TrackSegmentCollection*> outputTracks ) const {
 
-      Eigen::Vector3d weightedAnchor = (*hitMatrix)*m_layerWeights/(m_layerWeights.sum());
-
-      auto localMatrix = (*hitMatrix).colwise()-weightedAnchor;
-
-      Eigen::BDCSVD<Eigen::MatrixXd> svd(localMatrix.transpose(), Eigen::ComputeThinU | Eigen::ComputeThinV);
+      Eigen::Vector3d weightedAnchor = Eigen::Vector3d::Zero();
+      for(int layer=0; layer<m_cfg.n_layer; ++layer){
+        weightedAnchor += m_layerWeights[layer]*combination[layer];
+      }
+      weightedAnchor /= m_layerWeights.sum();
+
+      // Closed form line fit: the direction is the principal axis of the scatter
+      // matrix and the squared residuals sum to its two smaller eigenvalues
+      Eigen::Matrix3d scatter = Eigen::Matrix3d::Zero();
+      for(const auto& hit : combination){
+        Eigen::Vector3d local = hit-weightedAnchor;
+        scatter.noalias() += local*local.transpose();
+      }
 
-      auto V = svd.matrixV();
+      Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigen;
+      eigen.computeDirect(scatter);
 
-      // Rotate into principle components and calculate chi2/ndf
-      auto rotatedMatrix = localMatrix.transpose()*V;
-      auto residuals     = rotatedMatrix.rightCols(2);
-      double chi2        = (residuals.array()*residuals.array()).sum()/(2*m_cfg.n_layer);
+      // Calculate chi2/ndf from the residuals in the principal components
+      const auto& eigenvalues = eigen.eigenvalues();
+      double chi2 = std::max(0.0, eigenvalues(0)+eigenvalues(1))/(2*m_cfg.n_layer);
 
       if(chi2>m_cfg.chi2_max) return;
 
+      Eigen::Vector3d direction = eigen.eigenvectors().col(2);
+
       edm4hep::Vector3d outPos = weightedAnchor.data();
-      edm4hep::Vector3d outVec = V.col(0).data();
+      edm4hep::Vector3d outVec = direction.data();
 
       // Make sure fit was pointing in the right direction
       if(outVec.z>0) outVec = outVec*-1;
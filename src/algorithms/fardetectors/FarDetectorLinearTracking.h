@@ -38,16 +38,24 @@ public:
   void process(const Input&, const Output&) const final;
 
 private:
+  /// Hits of a layer in the frame of the optimum direction, sorted in local x
+  struct LayerHits {
+    std::vector<Eigen::Vector3d> positions; // global positions
+    std::vector<double> local_x;            // local x of the positions, ascending
+    double local_z_min;                     // smallest local z (along the optimum direction)
+  };
+
   Eigen::VectorXd m_layerWeights;
 
   Eigen::Vector3d m_optimumDirection;
+  // global to optimum direction frame, the local z axis is the optimum direction
+  Eigen::Matrix3d m_toOptimumFrame;
 
-  void
-  buildMatrixRecursive(int level, Eigen::MatrixXd* hitMatrix,
-                       const std::vector<gsl::not_null<const edm4hep::TrackerHitCollection*>>& hits,
-                       gsl::not_null<edm4eic::TrackSegmentCollection*> outputTracks) const;
+  void buildHitCombinations(int level, std::vector<Eigen::Vector3d>& combination,
+                            const std::vector<LayerHits>& layers,
+                            gsl::not_null<edm4eic::TrackSegmentCollection*> outputTracks) const;
 
-  void checkHitCombination(Eigen::MatrixXd* hitMatrix,
+  void checkHitCombination(const std::vector<Eigen::Vector3d>& combination,
                            gsl::not_null<edm4eic::TrackSegmentCollection*> outputTracks) const;
 
   bool checkHitPair(const Eigen::Vector3d& hit1, const Eigen::Vector3d& hit2) const;
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace eicrecon {
+
+  enum FarDetectorMLNNIndexIn{PosY,PosZ,DirX,DirY};
+  enum FarDetectorMLNNIndexOut{MomX,MomY,MomZ};
+
+  /** Inference backend of FarDetectorMLReconstruction.
+   *
+   * Evaluates the network for a batch of tracks: the inputs are stored
+   * row-major, `n_inputs` values per track in the order of
+   * FarDetectorMLNNIndexIn, and the outputs `n_outputs` values per track in
+   * the order of FarDetectorMLNNIndexOut.
+   */
+  class FarDetectorMLInference {
+  public:
+    static constexpr std::size_t n_inputs  = 4;
+    static constexpr std::size_t n_outputs = 3;
+
+    virtual ~FarDetectorMLInference() = default;
+
+    virtual void evaluate(std::span<const float> inputs, std::span<float> outputs) = 0;
+  };
+
+  /// TMVA reader of a weight file, evaluated one track at a time
+  std::unique_ptr<FarDetectorMLInference> makeFarDetectorMLTMVAInference(const std::string& modelPath,
+                                                                          const std::string& methodName);
+
+  /// ONNX Runtime session of a model file from OnnxRuntimeSvc, shared by all instances with the
+  /// same model, nullptr if EICrecon was built without ONNX Runtime
+  std::unique_ptr<FarDetectorMLInference> makeFarDetectorMLOnnxInference(const std::string& modelPath);
+
+} // eicrecon
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <memory>
+#include <string>
+
+#include "FarDetectorMLInference.h"
+
+#if defined(USE_ONNX)
+
+#include <algorithms/service.h>
+#include <fmt/core.h>
+#include <onnxruntime_c_api.h>
+#include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "algorithms/onnx/OnnxRuntimeSvc.h"
+
+namespace eicrecon {
+
+  namespace {
+
+    /// Session of a model with its input and output names
+    struct SharedSession {
+      Ort::Session session{nullptr};
+      std::string input_name;
+      std::string output_name;
+    };
+
+    /// Sessions are shared by all instances with the same model, Ort::Session::Run can be called
+    /// concurrently. They are made by OnnxRuntimeSvc, with its environment and thread pools.
+    std::shared_ptr<SharedSession> sharedSession(const std::string& modelPath) {
+      static std::mutex mutex;
+      static std::map<std::string, std::weak_ptr<SharedSession>> sessions;
+
+      std::lock_guard<std::mutex> lock(mutex);
+      auto& cached = sessions[modelPath];
+      if (auto shared = cached.lock()) {
+        return shared;
+      }
+
+      auto* onnx_svc = algorithms::ServiceSvc::instance().service<OnnxRuntimeSvc>("OnnxRuntimeSvc");
+      if (onnx_svc == nullptr) {
+        throw std::runtime_error("OnnxRuntimeSvc is not available, it is added by the reco plugin");
+      }
+      auto shared = std::make_shared<SharedSession>();
+      shared->session = onnx_svc->session(modelPath);
+      if (shared->session.GetInputCount() != 1 || shared->session.GetOutputCount() != 1) {
+        throw std::runtime_error(fmt::format("Model {} must have one input and one output", modelPath));
+      }
+      Ort::AllocatorWithDefaultOptions allocator;
+      shared->input_name  = shared->session.GetInputNameAllocated(0, allocator).get();
+      shared->output_name = shared->session.GetOutputNameAllocated(0, allocator).get();
+      cached = shared;
+      return shared;
+    }
+
+    class FarDetectorMLOnnxInference : public FarDetectorMLInference {
+    public:
+      explicit FarDetectorMLOnnxInference(const std::string& modelPath)
+        : m_session(sharedSession(modelPath)) {}
+
+      void evaluate(std::span<const float> inputs, std::span<float> outputs) final {
+        const std::size_t n_tracks = std::min(inputs.size() / n_inputs, outputs.size() / n_outputs);
+        if (n_tracks == 0) {
+          return;
+        }
+
+        // All tracks of the event in one [n_tracks, n_inputs] tensor
+        Ort::MemoryInfo mem_info = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+        const std::array<std::int64_t, 2> input_shape{static_cast<std::int64_t>(n_tracks), n_inputs};
+        const std::array<std::int64_t, 2> output_shape{static_cast<std::int64_t>(n_tracks), n_outputs};
+        auto input_tensor  = Ort::Value::CreateTensor<float>(mem_info, const_cast<float*>(inputs.data()), n_tracks * n_inputs,
+                                                             input_shape.data(), input_shape.size());
+        auto output_tensor = Ort::Value::CreateTensor<float>(mem_info, outputs.data(), n_tracks * n_outputs,
+                                                             output_shape.data(), output_shape.size());
+
+        const char* input_names[]  = {m_session->input_name.c_str()};
+        const char* output_names[] = {m_session->output_name.c_str()};
+        m_session->session.Run(Ort::RunOptions{nullptr}, input_names, &input_tensor, 1, output_names, &output_tensor, 1);
+      }
+
+    private:
+      std::shared_ptr<SharedSession> m_session;
+    };
+
+  } // namespace
+
+  std::unique_ptr<FarDetectorMLInference> makeFarDetectorMLOnnxInference(const std::string& modelPath) {
+    return std::make_unique<FarDetectorMLOnnxInference>(modelPath);
+  }
+
+} // eicrecon
+
+#else
+
+namespace eicrecon {
+
+  std::unique_ptr<FarDetectorMLInference> makeFarDetectorMLOnnxInference(const std::string& /* modelPath */) {
+    return nullptr;
+  }
+
+} // eicrecon
+
+#endif
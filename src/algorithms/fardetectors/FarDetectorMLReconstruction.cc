@@ -1,7 +1,6 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 // Copyright (C) 2024, Simon Gardner
 
-#include <TMVA/IMethod.h>
 #include <edm4eic/Cov6f.h>
 #include <edm4eic/vector_utils.h>
 #include <edm4hep/Vector2f.h>
@@ -9,6 +8,7 @@
 #include <edm4hep/utils/vector_utils.h>
 #include <fmt/core.h>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <gsl/pointers>
@@ -22,27 +22,25 @@ namespace eicrecon {
 
   void FarDetectorMLReconstruction::init() {
 
-    m_reader = new TMVA::Reader( "!Color:!Silent" );
-    // Create a set of variables and declare them to the reader
-    // - the variable names MUST corresponds in name and type to those given in the weight file(s) used
-    m_reader->AddVariable( "LowQ2Tracks[0].loc.a", &nnInput[FarDetectorMLNNIndexIn::PosY] );
-    m_reader->AddVariable( "LowQ2Tracks[0].loc.b", &nnInput[FarDetectorMLNNIndexIn::PosZ] );
-    m_reader->AddVariable( "sin(LowQ2Tracks[0].phi)*sin(LowQ2Tracks[0].theta)", &nnInput[FarDetectorMLNNIndexIn::DirX] );
-    m_reader->AddVariable( "cos(LowQ2Tracks[0].phi)*sin(LowQ2Tracks[0].theta)", &nnInput[FarDetectorMLNNIndexIn::DirY] );
-
-    // Locate and load the weight file
-    // TODO - Add functionality to select passed by configuration
-    bool methodFound = false;
-    if(!m_cfg.modelPath.empty()){
-      try{
-        m_method = dynamic_cast<TMVA::MethodBase*>(m_reader->BookMVA( m_cfg.methodName, m_cfg.modelPath ));
-      }
-      catch(std::exception &e){
-        error(fmt::format("Failed to load method {} from file {}: {}", m_cfg.methodName, m_cfg.modelPath, e.what()));
-      }
-
-    } else {
+    // Locate and load the model
+    if(m_cfg.modelPath.empty()){
       error("No model path provided for FarDetectorMLReconstruction");
+      return;
+    }
+    try{
+      if(m_cfg.backend == "TMVA"){
+        m_inference = makeFarDetectorMLTMVAInference(m_cfg.modelPath, m_cfg.methodName);
+      } else if(m_cfg.backend == "ONNX"){
+        m_inference = makeFarDetectorMLOnnxInference(m_cfg.modelPath);
+        if(!m_inference){
+          error("EICrecon was built without ONNX Runtime, the ONNX backend is not available");
+        }
+      } else {
+        error(fmt::format("Unknown inference backend {}, expected TMVA or ONNX", m_cfg.backend));
+      }
+    }
+    catch(std::exception &e){
+      error(fmt::format("Failed to load method {} from file {}: {}", m_cfg.methodName, m_cfg.modelPath, e.what()));
     }
   }
 
@@ -71,18 +69,33 @@ namespace eicrecon {
     std::int32_t type   = 0; // Check?
     float        charge = -1;
 
-    for(const auto& track: *inputTracks){
+    if(!m_inference){
+      error("No model loaded, skipping the event");
+      return;
+    }
+
+    // Evaluate all the tracks of the event in one batch
+    const std::size_t n_tracks = inputTracks->size();
+    m_nnInput.resize(n_tracks * FarDetectorMLInference::n_inputs);
+    m_nnOutput.resize(n_tracks * FarDetectorMLInference::n_outputs);
+    for(std::size_t i = 0; i < n_tracks; ++i){
+      const auto track = (*inputTracks)[i];
 
       auto pos        = track.getLoc();
       auto trackphi   = track.getPhi();
       auto tracktheta = track.getTheta();
 
+      float* nnInput = &m_nnInput[i * FarDetectorMLInference::n_inputs];
       nnInput[FarDetectorMLNNIndexIn::PosY] = pos.a;
       nnInput[FarDetectorMLNNIndexIn::PosZ] = pos.b;
       nnInput[FarDetectorMLNNIndexIn::DirX] = sin(trackphi)*sin(tracktheta);
       nnInput[FarDetectorMLNNIndexIn::DirY] = cos(trackphi)*sin(tracktheta);
+    }
+    m_inference->evaluate(m_nnInput, m_nnOutput);
+
+    for(std::size_t i = 0; i < n_tracks; ++i){
 
-      auto values = m_method->GetRegressionValues();
+      const float* values = &m_nnOutput[i * FarDetectorMLInference::n_outputs];
 
       edm4hep::Vector3f momentum = {values[FarDetectorMLNNIndexOut::MomX],values[FarDetectorMLNNIndexOut::MomY],values[FarDetectorMLNNIndexOut::MomZ]};
 
@@ -3,26 +3,24 @@
 
 #pragma once
 
-#include <TMVA/MethodBase.h>
-#include <TMVA/Reader.h>
 #include <algorithms/algorithm.h>
 #include <edm4eic/TrackCollection.h>
 #include <edm4eic/TrackParametersCollection.h>
 #include <edm4eic/TrajectoryCollection.h>
 // Event Model related classes
 #include <edm4hep/MCParticleCollection.h>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
+#include <vector>
 
+#include "FarDetectorMLInference.h"
 #include "FarDetectorMLReconstructionConfig.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 
 namespace eicrecon {
 
-  enum FarDetectorMLNNIndexIn{PosY,PosZ,DirX,DirY};
-  enum FarDetectorMLNNIndexOut{MomX,MomY,MomZ};
-
   using FarDetectorMLReconstructionAlgorithm = algorithms::Algorithm<
     algorithms::Input<
       edm4eic::TrackParametersCollection,
@@ -56,11 +54,12 @@ namespace eicrecon {
       //----- Define constants here ------
 
   private:
-      TMVA::Reader*     m_reader{nullptr};
-      TMVA::MethodBase* m_method{nullptr};
+      std::unique_ptr<FarDetectorMLInference> m_inference;
       float m_beamE{10.0};
       std::once_flag m_initBeamE;
-      float nnInput[4]  = {0.0,0.0,0.0,0.0};
+      // batched network inputs and outputs of an event
+      std::vector<float> m_nnInput;
+      std::vector<float> m_nnOutput;
 
   };
 
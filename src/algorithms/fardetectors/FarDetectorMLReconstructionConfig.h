@@ -4,10 +4,13 @@
 #pragma once
 
 #include <DD4hep/DD4hepUnits.h>
+#include <string>
 
 namespace eicrecon {
   struct FarDetectorMLReconstructionConfig {
 
+    // Inference backend, "TMVA" (weight file and method name) or "ONNX" (model file)
+    std::string backend{"TMVA"};
     std::string modelPath;
     std::string methodName;
 
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <TMVA/IMethod.h>
+#include <TMVA/MethodBase.h>
+#include <TMVA/Reader.h>
+#include <fmt/core.h>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "FarDetectorMLInference.h"
+
+namespace eicrecon {
+
+  namespace {
+
+    class FarDetectorMLTMVAInference : public FarDetectorMLInference {
+    public:
+      FarDetectorMLTMVAInference(const std::string& modelPath, const std::string& methodName) {
+        // Booking goes through global TMVA state
+        static std::mutex booking_mutex;
+        std::lock_guard<std::mutex> lock(booking_mutex);
+
+        m_reader = std::make_unique<TMVA::Reader>( "!Color:!Silent" );
+        // Create a set of variables and declare them to the reader
+        // - the variable names MUST corresponds in name and type to those given in the weight file(s) used
+        m_reader->AddVariable( "LowQ2Tracks[0].loc.a", &m_input[FarDetectorMLNNIndexIn::PosY] );
+        m_reader->AddVariable( "LowQ2Tracks[0].loc.b", &m_input[FarDetectorMLNNIndexIn::PosZ] );
+        m_reader->AddVariable( "sin(LowQ2Tracks[0].phi)*sin(LowQ2Tracks[0].theta)", &m_input[FarDetectorMLNNIndexIn::DirX] );
+        m_reader->AddVariable( "cos(LowQ2Tracks[0].phi)*sin(LowQ2Tracks[0].theta)", &m_input[FarDetectorMLNNIndexIn::DirY] );
+
+        m_method = dynamic_cast<TMVA::MethodBase*>(m_reader->BookMVA( methodName, modelPath ));
+        if (m_method == nullptr) {
+          throw std::runtime_error(fmt::format("Method {} not found in {}", methodName, modelPath));
+        }
+      }
+
+      void evaluate(std::span<const float> inputs, std::span<float> outputs) final {
+        // The reader reads its inputs from m_input, tracks are evaluated in turn
+        const std::size_t n_tracks = std::min(inputs.size() / n_inputs, outputs.size() / n_outputs);
+        for (std::size_t i = 0; i < n_tracks; ++i) {
+          std::copy_n(inputs.begin() + i * n_inputs, n_inputs, m_input.begin());
+          const auto& values = m_method->GetRegressionValues();
+          std::copy_n(values.begin(), n_outputs, outputs.begin() + i * n_outputs);
+        }
+      }
+
+    private:
+      std::unique_ptr<TMVA::Reader> m_reader;
+      TMVA::MethodBase* m_method{nullptr};
+      std::array<float, n_inputs> m_input{};
+    };
+
+  } // namespace
+
+  std::unique_ptr<FarDetectorMLInference> makeFarDetectorMLTMVAInference(const std::string& modelPath,
+                                                                          const std::string& methodName) {
+    return std::make_unique<FarDetectorMLTMVAInference>(modelPath, methodName);
+  }
+
+} // eicrecon
@@ -12,12 +12,19 @@
 #include <JANA/JException.h>
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/DisplacementVector3D.h>
-#include <ROOT/RVec.hxx>
 #include <algorithms/geo.h>
+#include <algorithms/service.h>
 #include <edm4hep/Vector3d.h>
 #include <fmt/core.h>
 #include <gsl/pointers>
 #include <sys/types.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <future>
+#include <numeric>
+#include <tuple>
+#include <utility>
 
 #include "algorithms/fardetectors/FarDetectorTrackerCluster.h"
 #include "algorithms/fardetectors/FarDetectorTrackerClusterConfig.h"
@@ -28,6 +35,7 @@ void FarDetectorTrackerCluster::init() {
 
   m_detector         = algorithms::GeoSvc::instance().detector();
   m_cellid_converter = algorithms::GeoSvc::instance().cellIDPositionConverter();
+  m_geo_cache        = algorithms::ServiceSvc::instance().service<CellIDGeometryCacheSvc>("CellIDGeometryCacheSvc");
 
   if (m_cfg.readout.empty()) {
     throw JException("Readout is empty");
@@ -35,6 +43,7 @@ void FarDetectorTrackerCluster::init() {
   try {
     m_seg    = m_detector->readout(m_cfg.readout).segmentation();
     m_id_dec = m_detector->readout(m_cfg.readout).idSpec().decoder();
+    m_id_fields = CellIDFieldDecoder::allFields(*m_id_dec);
     if (!m_cfg.x_field.empty()) {
       m_x_idx = m_id_dec->index(m_cfg.x_field);
       debug("Find layer field {}, index = {}", m_cfg.x_field, m_x_idx);
@@ -57,10 +66,10 @@ void FarDetectorTrackerCluster::process(const FarDetectorTrackerCluster::Input&
 
   // Loop over input and output collections - Any collection should only contain hits from a single
   // surface
-  for (size_t i = 0; i < inputHitsCollections.size(); i++) {
+  auto clusterCollection = [&](std::size_t i) {
     auto inputHits = inputHitsCollections[i];
     if (inputHits->size() == 0)
-      continue;
+      return;
     auto outputClusters = outputClustersCollection[i];
 
     // Make clusters
@@ -68,6 +77,36 @@ void FarDetectorTrackerCluster::process(const FarDetectorTrackerCluster::Input&
 
     // Create TrackerHits from 2D cluster positions
     ConvertClusters(clusters, *outputClusters);
+  };
+
+  // One task per collection with enough hits to pay for its thread, the first of them and the
+  // smaller collections run on the calling thread
+  std::vector<std::size_t> large;
+  if (m_cfg.parallel_collections) {
+    for (std::size_t i = 0; i < inputHitsCollections.size(); i++) {
+      if (inputHitsCollections[i]->size() >= std::max<std::size_t>(m_cfg.parallel_min_hits, 1)) {
+        large.push_back(i);
+      }
+    }
+  }
+  if (large.size() < 2) {
+    for (std::size_t i = 0; i < inputHitsCollections.size(); i++) {
+      clusterCollection(i);
+    }
+    return;
+  }
+
+  std::vector<std::future<void>> tasks;
+  for (std::size_t j = 1; j < large.size(); j++) {
+    tasks.push_back(std::async(std::launch::async, clusterCollection, large[j]));
+  }
+  for (std::size_t i = 0; i < inputHitsCollections.size(); i++) {
+    if (i == large[0] || !std::binary_search(large.begin(), large.end(), i)) {
+      clusterCollection(i);
+    }
+  }
+  for (auto& task : tasks) {
+    task.get();
   }
 }
 
@@ -77,70 +116,85 @@ FarDetectorTrackerCluster::ClusterHits(const edm4eic::RawTrackerHitCollection& i
 
   std::vector<FDTrackerCluster> clusters;
 
-  ROOT::VecOps::RVec<unsigned long> id;
-  ROOT::VecOps::RVec<int> x;
-  ROOT::VecOps::RVec<int> y;
-  ROOT::VecOps::RVec<float> e;
-  ROOT::VecOps::RVec<float> t;
-
-  // Gather detector id positions
-  for (const auto& hit : inputHits) {
-    auto cellID = hit.getCellID();
-    id.push_back(cellID);
-    x.push_back(m_id_dec->get(cellID, m_x_idx));
-    y.push_back(m_id_dec->get(cellID, m_y_idx));
-    e.push_back(hit.getCharge());
-    t.push_back(hit.getTimeStamp());
+  struct Pixel {
+    int x;
+    int y;
+    float e;
+    float t;
+    std::size_t index; // index in the input collection
+  };
+
+  // Gather detector id positions, sorted in (x, y) to look up the neighbours of a hit
+  std::vector<Pixel> pixels;
+  pixels.reserve(inputHits.size());
+  for (std::size_t i = 0; i < inputHits.size(); ++i) {
+    const auto& hit = inputHits[i];
+    auto cellID     = hit.getCellID();
+    pixels.push_back({static_cast<int>(m_id_fields.get(cellID, m_x_idx)),
+                      static_cast<int>(m_id_fields.get(cellID, m_y_idx)), hit.getCharge(),
+                      static_cast<float>(hit.getTimeStamp()), i});
   }
-
-  // Set up clustering variables
-  ROOT::VecOps::RVec<bool> available(id.size(), 1);
-  auto indices = Enumerate(id);
-
-  // Loop while there are unclustered hits
-  while (ROOT::VecOps::Any(available)) {
+  std::vector<Pixel> sorted_pixels = pixels;
+  auto xy_less = [](const Pixel& a, const Pixel& b) { return std::tie(a.x, a.y) < std::tie(b.x, b.y); };
+  std::sort(sorted_pixels.begin(), sorted_pixels.end(), xy_less);
+
+  // Seeds in decreasing energy, of equal energies the first in the input
+  std::vector<std::size_t> seeds(pixels.size());
+  std::iota(seeds.begin(), seeds.end(), 0);
+  std::stable_sort(seeds.begin(), seeds.end(),
+                   [&pixels](std::size_t a, std::size_t b) { return pixels[a].e > pixels[b].e; });
+
+  std::vector<bool> available(pixels.size(), true);
+  std::vector<std::size_t> clusterList;
+  std::vector<std::size_t> neighbours;
+
+  for (std::size_t maxIndex : seeds) {
+    if (!available[maxIndex]) {
+      continue;
+    }
+    available[maxIndex] = false;
+
+    // Adds the neighbours of each hit in the cluster within the time limit, in input order
+    clusterList.assign(1, maxIndex);
+    for (std::size_t next = 0; next < clusterList.size(); ++next) {
+      const auto& pixel = pixels[clusterList[next]];
+      neighbours.clear();
+      for (int x = pixel.x - 1; x <= pixel.x + 1; ++x) {
+        for (auto it = std::lower_bound(sorted_pixels.begin(), sorted_pixels.end(),
+                                        Pixel{x, pixel.y - 1, 0, 0, 0}, xy_less);
+             it != sorted_pixels.end() && it->x == x && it->y <= pixel.y + 1; ++it) {
+          if (available[it->index] && std::abs(it->t - pixel.t) < m_cfg.hit_time_limit) {
+            neighbours.push_back(it->index);
+          }
+        }
+      }
+      std::sort(neighbours.begin(), neighbours.end());
+      for (std::size_t i : neighbours) {
+        available[i] = false;
+        clusterList.push_back(i);
+      }
+    }
 
     dd4hep::Position localPos = {0, 0, 0};
     float weightSum           = 0;
 
-    float esum    = 0;
-    float t0      = 0;
-    float tError  = 0;
-    auto maxIndex = ROOT::VecOps::ArgMax(e * available);
-
-    available[maxIndex] = 0;
-
-    ROOT::VecOps::RVec<unsigned long> clusterList = {maxIndex};
-    ROOT::VecOps::RVec<float> clusterT;
+    float esum   = 0;
+    double tSum  = 0;
+    float tError = 0;
     std::vector<podio::ObjectID> clusterHits;
+    clusterHits.reserve(clusterList.size());
 
-    // Loop over hits, adding neighbouring hits as relevant
-    while (clusterList.size()) {
-
-      // Takes first remaining hit in cluster list
-      auto index = clusterList[0];
-
-      // Finds neighbours of cluster within time limit
-      auto filter = available * (abs(x - x[index]) <= 1) * (abs(y - y[index]) <= 1) *
-                    (abs(t - t[index]) < m_cfg.hit_time_limit);
-
-      // Adds the found hits to the cluster
-      clusterList = Concatenate(clusterList, indices[filter]);
-
-      // Removes the found hits from the list of still available hits
-      available = available * (!filter);
-
-      // Removes current hit from remaining found cluster hits
-      clusterList.erase(clusterList.begin());
+    for (std::size_t index : clusterList) {
+      const auto& pixel = pixels[index];
 
       // Adds raw hit to TrackerHit contribution
-      clusterHits.push_back((inputHits)[index].getObjectID());
+      clusterHits.push_back(inputHits[index].getObjectID());
 
       // Energy
-      auto hitE = e[index];
+      auto hitE = pixel.e;
       esum += hitE;
       // TODO - See if now a single detector element is expected a better function is available.
-      auto pos = m_seg->position(id[index]);
+      auto pos = m_seg->position(inputHits[index].getCellID());
 
       // Weighted position
       float weight = hitE; // TODO - Calculate appropriate weighting based on sensor charge sharing
@@ -148,24 +202,28 @@ FarDetectorTrackerCluster::ClusterHits(const edm4eic::RawTrackerHitCollection& i
       localPos += pos * weight;
 
       // Time
-      clusterT.push_back(t[index]);
+      tSum += pixel.t;
     }
 
     // Finalise position
     localPos /= weightSum;
 
     // Finalise time
-    t0     = Mean(clusterT);
-    tError = StdDev(clusterT); // TODO fold detector timing resolution into error
+    float t0 = tSum / clusterList.size();
+    for (std::size_t index : clusterList) {
+      tError += (pixels[index].t - t0) * (pixels[index].t - t0);
+    }
+    tError = clusterList.size() > 1 ? std::sqrt(tError / (clusterList.size() - 1))
+                                    : 0; // TODO fold detector timing resolution into error
 
     // Create cluster
-    clusters.push_back(FDTrackerCluster{.cellID    = id[maxIndex],
+    clusters.push_back(FDTrackerCluster{.cellID    = inputHits[maxIndex].getCellID(),
                                         .x         = localPos.x(),
                                         .y         = localPos.y(),
                                         .energy    = esum,
                                         .time      = t0,
                                         .timeError = tError,
-                                        .rawHits   = clusterHits});
+                                        .rawHits   = std::move(clusterHits)});
   }
 
   return clusters;
@@ -177,7 +235,7 @@ void FarDetectorTrackerCluster::ConvertClusters(
     edm4hep::TrackerHitCollection& outputClusters) const {
 
   // Get context of first hit
-  const dd4hep::VolumeManagerContext* context = m_cellid_converter->findContext(clusters[0].cellID);
+  const dd4hep::VolumeManagerContext* context = m_geo_cache->findContext(clusters[0].cellID);
 
   for (auto cluster : clusters) {
     auto hitPos = outputClusters.create();
@@ -16,7 +16,9 @@
 #include <vector>
 
 #include "FarDetectorTrackerClusterConfig.h"
+#include "algorithms/interfaces/CellIDFieldDecoder.h"
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "services/geometry/cellid_cache/CellIDGeometryCacheSvc.h"
 
 // Cluster struct
 struct FDTrackerCluster {
@@ -60,7 +62,9 @@ public:
 private:
   const dd4hep::Detector* m_detector{nullptr};
   const dd4hep::BitFieldCoder* m_id_dec{nullptr};
+  CellIDFieldDecoder m_id_fields; // all the fields of m_id_dec
   const dd4hep::rec::CellIDPositionConverter* m_cellid_converter{nullptr};
+  CellIDGeometryCacheSvc* m_geo_cache{nullptr};
   dd4hep::Segmentation m_seg;
 
   int m_x_idx{0};
@@ -4,6 +4,8 @@
 #pragma once
 
 #include <edm4eic/unit_system.h>
+#include <cstddef>
+#include <string>
 
 namespace eicrecon {
   struct FarDetectorTrackerClusterConfig {
@@ -16,5 +18,9 @@ namespace eicrecon {
     // Timing limit to add a hit to a cluster
     double hit_time_limit{10*edm4eic::unit::ns};
 
+    // Cluster the input collections in parallel tasks, those with at least parallel_min_hits hits
+    bool parallel_collections{false};
+    std::size_t parallel_min_hits{256};
+
   };
 }
@@ -10,11 +10,14 @@
 #include <DD4hep/Objects.h>
 #include <DD4hep/VolumeManager.h>
 #include <Evaluator/DD4hepUnits.h>
+#include <algorithms/service.h>
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/DisplacementVector3D.h>
 #include <edm4hep/Vector3f.h>
 #include <edm4hep/utils/vector_utils.h>
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
 #include <gsl/pointers>
 #include <vector>
 
@@ -22,6 +25,58 @@
 
 void eicrecon::MatrixTransferStatic::init() {
 
+  m_geo_cache = algorithms::ServiceSvc::instance().service<CellIDGeometryCacheSvc>("CellIDGeometryCacheSvc");
+
+  // Transfer matrices {{a, b}, {c, d}} and orbit offsets of the beam momenta.
+  // This is a temporary solution to get the beam energy information
+  // needed to select the correct matrix
+  struct Optics {
+    double nomMomentum;
+    double aX[2][2];
+    double aY[2][2];
+    double local_x_offset;
+    double local_y_offset;
+    double local_x_slope_offset;
+    double local_y_slope_offset;
+  };
+  const Optics optics[] = {
+    {275.0,
+     {{3.251116, 30.285734}, {0.186036375, 0.196439472}},
+     {{0.4730500000, 3.062999454}, {0.0204108951, -0.139318692}},
+     -0.339334, -0.000299454, -0.219603248, -0.000176128},
+    {100.0,
+     {{3.152158, 20.852072}, {0.181649517, -0.303998487}},
+     {{0.5306100000, 3.19623343}, {0.0226283320, -0.082666019}},
+     -0.329072, -0.00028343, -0.218525084, -0.00015321},
+    {41.0,
+     {{3.135997, 18.482273}, {0.176479921, -0.497839483}},
+     {{0.4914400000, 4.53857451}, {0.0179664765, 0.004160679}},
+     -0.283273, -0.00552451, -0.21174031, -0.003212011},
+    {135.0, // 135 GeV deuterons
+     {{1.6248, 12.966293}, {0.1832, -2.8636535}},
+     {{0.0001674, -28.6003}, {0.0000837, -2.87985}},
+     -11.9872, -0.0146, -14.75315, -0.0073},
+  };
+
+  const auto invert = [](const double a[2][2], double ainv[2][2]) {
+    const double determinant = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+    if (determinant == 0) {
+      throw std::runtime_error("Reco matrix determinant = 0! Matrix cannot be inverted! Double-check matrix!");
+    }
+    ainv[0][0] =  a[1][1] / determinant;
+    ainv[0][1] = -a[0][1] / determinant;
+    ainv[1][0] = -a[1][0] / determinant;
+    ainv[1][1] =  a[0][0] / determinant;
+  };
+
+  m_optics.clear();
+  for (const auto& o : optics) {
+    BeamOptics inverted{o.nomMomentum, {}, {}, o.local_x_offset, o.local_y_offset, o.local_x_slope_offset, o.local_y_slope_offset};
+    invert(o.aX, inverted.aXinv);
+    invert(o.aY, inverted.aYinv);
+    m_optics.push_back(inverted);
+  }
+
 }
 
 void eicrecon::MatrixTransferStatic::process(
@@ -31,21 +86,6 @@ void eicrecon::MatrixTransferStatic::process(
   const auto [mcparts, rechits] = input;
   auto [outputParticles] = output;
 
-  std::vector<std::vector<double>> aX(m_cfg.aX);
-  std::vector<std::vector<double>> aY(m_cfg.aY);
-
-  //----- Define constants here ------
-  double aXinv[2][2] = {{0.0, 0.0},
-                        {0.0, 0.0}};
-  double aYinv[2][2] = {{0.0, 0.0},
-                        {0.0, 0.0}};
-
-  double nomMomentum     = m_cfg.nomMomentum; //extract the nominal value first -- will be overwritten by MCParticle
-  double local_x_offset  = m_cfg.local_x_offset;
-  double local_y_offset  = m_cfg.local_y_offset;
-  double local_x_slope_offset  = m_cfg.local_x_slope_offset;
-  double local_y_slope_offset  = m_cfg.local_y_slope_offset;
-
   double numBeamProtons = 0;
   double runningMomentum = 0.0;
 
@@ -62,114 +102,23 @@ void eicrecon::MatrixTransferStatic::process(
 
   if(numBeamProtons == 0) {error("No beam protons to choose matrix!! Skipping!!"); return;}
 
-  nomMomentum = runningMomentum/numBeamProtons;
-
-  double nomMomentumError = 0.05;
-
-  //This is a temporary solution to get the beam energy information
-  //needed to select the correct matrix
-
-  if(abs(275.0 - nomMomentum)/275.0 < nomMomentumError){
-
-     aX[0][0] = 3.251116; //a
-     aX[0][1] = 30.285734; //b
-     aX[1][0] = 0.186036375; //c
-     aX[1][1] = 0.196439472; //d
-
-     aY[0][0] = 0.4730500000; //a
-     aY[0][1] = 3.062999454; //b
-     aY[1][0] = 0.0204108951; //c
-     aY[1][1] = -0.139318692; //d
-
-     local_x_offset       = -0.339334;
-     local_y_offset       = -0.000299454;
-     local_x_slope_offset = -0.219603248;
-     local_y_slope_offset = -0.000176128;
-
-  }
-  else if(abs(100.0 - nomMomentum)/100.0 < nomMomentumError){
-
-     aX[0][0] = 3.152158; //a
-     aX[0][1] = 20.852072; //b
-     aX[1][0] = 0.181649517; //c
-     aX[1][1] = -0.303998487; //d
-
-     aY[0][0] = 0.5306100000; //a
-     aY[0][1] = 3.19623343; //b
-     aY[1][0] = 0.0226283320; //c
-     aY[1][1] = -0.082666019; //d
-
-     local_x_offset       = -0.329072;
-     local_y_offset       = -0.00028343;
-     local_x_slope_offset = -0.218525084;
-     local_y_slope_offset = -0.00015321;
-
-  }
-  else if(abs(41.0 - nomMomentum)/41.0 < nomMomentumError){
-
-         aX[0][0] = 3.135997; //a
-         aX[0][1] = 18.482273; //b
-         aX[1][0] = 0.176479921; //c
-         aX[1][1] = -0.497839483; //d
+  const double nomMomentum = runningMomentum/numBeamProtons;
 
-         aY[0][0] = 0.4914400000; //a
-         aY[0][1] = 4.53857451; //b
-         aY[1][0] = 0.0179664765; //c
-         aY[1][1] = 0.004160679; //d
+  const double nomMomentumError = 0.05;
 
-         local_x_offset       = -0.283273;
-         local_y_offset       = -0.00552451;
-         local_x_slope_offset = -0.21174031;
-         local_y_slope_offset = -0.003212011;
-
-  }
-  else if(abs(135.0 - nomMomentum)/135.0 < nomMomentumError){ //135 GeV deuterons
-
-      aX[0][0] = 1.6248;
-      aX[0][1] = 12.966293;
-      aX[1][0] = 0.1832;
-      aX[1][1] = -2.8636535;
-
-      aY[0][0] = 0.0001674; //a
-      aY[0][1] = -28.6003; //b
-      aY[1][0] = 0.0000837; //c
-      aY[1][1] = -2.87985; //d
-
-      local_x_offset       = -11.9872;
-      local_y_offset       = -0.0146;
-      local_x_slope_offset = -14.75315;
-      local_y_slope_offset = -0.0073;
-
-  }
-  else {
+  const auto selected = std::find_if(m_optics.begin(), m_optics.end(), [nomMomentum, nomMomentumError](const auto& o) {
+    return std::abs(o.nomMomentum - nomMomentum)/o.nomMomentum < nomMomentumError;
+  });
+  if (selected == m_optics.end()) {
     error("MatrixTransferStatic:: No valid matrix found to match beam momentum!! Skipping!!");
     return;
   }
-
-  double determinant = aX[0][0] * aX[1][1] - aX[0][1] * aX[1][0];
-
-  if (determinant == 0) {
-    error("Reco matrix determinant = 0! Matrix cannot be inverted! Double-check matrix!");
-    return;
-  }
-
-  aXinv[0][0] =  aX[1][1] / determinant;
-  aXinv[0][1] = -aX[0][1] / determinant;
-  aXinv[1][0] = -aX[1][0] / determinant;
-  aXinv[1][1] =  aX[0][0] / determinant;
-
-
-  determinant = aY[0][0] * aY[1][1] - aY[0][1] * aY[1][0];
-
-  if (determinant == 0) {
-    error("Reco matrix determinant = 0! Matrix cannot be inverted! Double-check matrix!");
-    return;
-  }
-
-  aYinv[0][0] =  aY[1][1] / determinant;
-  aYinv[0][1] = -aY[0][1] / determinant;
-  aYinv[1][0] = -aY[1][0] / determinant;
-  aYinv[1][1] =  aY[0][0] / determinant;
+  const auto& aXinv = selected->aXinv;
+  const auto& aYinv = selected->aYinv;
+  const double local_x_offset       = selected->local_x_offset;
+  const double local_y_offset       = selected->local_y_offset;
+  const double local_x_slope_offset = selected->local_x_slope_offset;
+  const double local_y_slope_offset = selected->local_y_slope_offset;
 
   //---- begin Reconstruction code ----
 
@@ -184,12 +133,16 @@ void eicrecon::MatrixTransferStatic::process(
 
   for (const auto &h: *rechits) {
 
+    // the first hit of each detector is used
+    if (goodHit1 && goodHit2) {
+      break;
+    }
+
     auto cellID = h.getCellID();
     // The actual hit position in Global Coordinates
-    auto gpos = m_converter->position(cellID);
+    auto gpos = m_geo_cache->position(cellID);
     // local positions
-    auto volman = m_detector->volumeManager();
-    auto local = volman.lookupDetElement(cellID);
+    auto local = m_geo_cache->detElement(cellID);
 
     auto pos0 = local.nominal().worldToLocal(dd4hep::Position(gpos.x(), gpos.y(), gpos.z())); // hit position in local coordinates
 
@@ -13,9 +13,11 @@
 #include <gsl/pointers>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "MatrixTransferStaticConfig.h"
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "services/geometry/cellid_cache/CellIDGeometryCacheSvc.h"
 
 namespace eicrecon {
 
@@ -44,8 +46,25 @@ namespace eicrecon {
     void process(const Input&, const Output&) const final;
 
   private:
+    /// Inverted transfer matrices and orbit offsets of a beam momentum
+    struct BeamOptics {
+      double nomMomentum;
+      double aXinv[2][2];
+      double aYinv[2][2];
+      double local_x_offset;
+      double local_y_offset;
+      double local_x_slope_offset;
+      double local_y_slope_offset;
+    };
+
     const dd4hep::Detector* m_detector{algorithms::GeoSvc::instance().detector()};
     const dd4hep::rec::CellIDPositionConverter* m_converter{algorithms::GeoSvc::instance().cellIDPositionConverter()};
 
+    /// Per-thread cache of the cell positions
+    CellIDGeometryCacheSvc* m_geo_cache{nullptr};
+
+    /// Of all the beam momenta, inverted once at init
+    std::vector<BeamOptics> m_optics;
+
   };
 }
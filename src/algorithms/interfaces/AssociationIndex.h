@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <podio/ObjectID.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * @brief Per-event index of associations by their reconstructed object
+ *
+ * Built once from an association collection (e.g.
+ * edm4eic::MCRecoParticleAssociationCollection), it returns the associations
+ * of a reconstructed object in collection order with a binary search, instead
+ * of a scan of the whole collection per object. The index can be rebuilt for
+ * every event without reallocating. `RecOf` returns the reconstructed object
+ * of an association, for associations without `getRec()`.
+ */
+struct AssociationRec {
+  template <typename Association> auto operator()(const Association& association) const {
+    return association.getRec();
+  }
+};
+
+struct AssociationSim {
+  template <typename Association> auto operator()(const Association& association) const {
+    return association.getSim();
+  }
+};
+
+template <typename AssociationCollection, typename RecOf = AssociationRec> class AssociationIndex {
+public:
+  AssociationIndex() = default;
+  explicit AssociationIndex(const AssociationCollection& associations) { build(associations); }
+
+  void build(const AssociationCollection& associations) {
+    m_associations = &associations;
+    m_entries.clear();
+    m_entries.reserve(associations.size());
+    for (std::size_t i = 0; i < associations.size(); ++i) {
+      const auto rec = RecOf{}(associations[i]);
+      if (rec.isAvailable()) {
+        m_entries.emplace_back(key(rec.getObjectID()), i);
+      }
+    }
+    // stable in the association index for equal keys
+    std::sort(m_entries.begin(), m_entries.end());
+  }
+
+  /// The indexed association collection
+  const AssociationCollection& associations() const { return *m_associations; }
+
+  /// Indices in the association collection of the associations of an object
+  template <typename Object> std::vector<std::size_t> indices(const Object& rec) const {
+    std::vector<std::size_t> result;
+    for (const auto& entry : range(rec.getObjectID())) {
+      result.push_back(entry.second);
+    }
+    return result;
+  }
+
+  /// Index in the association collection of the first association of an object
+  template <typename Object> std::optional<std::size_t> first(const Object& rec) const {
+    const auto entries = range(rec.getObjectID());
+    if (entries.empty()) {
+      return std::nullopt;
+    }
+    return entries.front().second;
+  }
+
+  /// Calls `f(association)` for the associations of an object, in collection order
+  template <typename Object, typename F> void forEach(const Object& rec, F&& f) const {
+    for (const auto& entry : range(rec.getObjectID())) {
+      f((*m_associations)[entry.second]);
+    }
+  }
+
+private:
+  using Entry = std::pair<std::uint64_t, std::size_t>;
+
+  static std::uint64_t key(const podio::ObjectID& id) {
+    return (static_cast<std::uint64_t>(id.collectionID) << 32) | static_cast<std::uint32_t>(id.index);
+  }
+
+  std::span<const Entry> range(const podio::ObjectID& id) const {
+    const std::uint64_t k = key(id);
+    auto first            = std::lower_bound(m_entries.begin(), m_entries.end(), Entry{k, 0});
+    auto last             = first;
+    while (last != m_entries.end() && last->first == k) {
+      ++last;
+    }
+    return {first, last};
+  }
+
+  const AssociationCollection* m_associations{nullptr};
+  std::vector<Entry> m_entries;
+};
+
+/**
+ * @brief Indices of an association collection in both directions
+ *
+ * Published once per event by AssociationIndex_factory, so that all the
+ * consumers of an association collection share the indices instead of
+ * scanning or indexing the collection again.
+ */
+template <typename AssociationCollection> struct AssociationLookup {
+  AssociationIndex<AssociationCollection, AssociationRec> by_rec;
+  AssociationIndex<AssociationCollection, AssociationSim> by_sim;
+
+  AssociationLookup() = default;
+  explicit AssociationLookup(const AssociationCollection& associations)
+      : by_rec(associations), by_sim(associations) {}
+
+  const AssociationCollection& associations() const { return by_rec.associations(); }
+};
+
+} // namespace eicrecon
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+
+namespace eicrecon {
+
+  /// Whether an algorithm processes a batch of events with one call of its own
+  template <typename AlgoT>
+  concept HasBatchedProcess = requires(const AlgoT& algo, std::span<const typename AlgoT::Input> inputs,
+                                       std::span<const typename AlgoT::Output> outputs) {
+    algo.process(inputs, outputs);
+  };
+
+  /**
+   * Processes a batch of events, `outputs[i]` are the outputs of `inputs[i]`.
+   *
+   * Algorithms with a `process(std::span<const Input>, std::span<const Output>)`
+   * overload share their work between the events, e.g. one table lookup for the
+   * particles of all of them; the others are called once per event.
+   */
+  template <typename AlgoT>
+  void process_batch(const AlgoT& algo, std::span<const typename AlgoT::Input> inputs,
+                     std::span<const typename AlgoT::Output> outputs) {
+    if (inputs.size() != outputs.size()) {
+      throw std::invalid_argument("process_batch: not as many outputs as inputs");
+    }
+    if constexpr (HasBatchedProcess<AlgoT>) {
+      algo.process(inputs, outputs);
+    } else {
+      for (std::size_t i = 0; i < inputs.size(); ++i) {
+        algo.process(inputs[i], outputs[i]);
+      }
+    }
+  }
+
+} // namespace eicrecon
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <DD4hep/IDDescriptor.h>
+#include <DDSegmentation/BitFieldCoder.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * @brief Readout fields of cellIDs, decoded with two shifts each
+ *
+ * Built once at init from the fields of a readout, e.g.
+ *
+ *     m_decoder = CellIDFieldDecoder(*id_spec.decoder(), {m_cfg.layerField, m_cfg.sectorField});
+ *     const auto layer = m_decoder.get<0>(cellID);
+ *
+ * A field is moved to the top bits of the cellID and back down, which sign
+ * extends the signed fields without a branch, instead of the mask, shift and
+ * sign test of `dd4hep::IDDescriptor::Field::value()`. decode() fills a column
+ * per field for a whole array of cellIDs, for the loops over the hits of an
+ * event.
+ */
+class CellIDFieldDecoder {
+public:
+  CellIDFieldDecoder() = default;
+
+  explicit CellIDFieldDecoder(const std::vector<const dd4hep::DDSegmentation::BitFieldElement*>& fields) {
+    for (const auto* field : fields) {
+      add(*field);
+    }
+  }
+
+  /// The named fields of a readout, throws std::runtime_error for a field that the readout has not
+  CellIDFieldDecoder(const dd4hep::DDSegmentation::BitFieldCoder& coder, const std::vector<std::string>& names) {
+    for (const auto& name : names) {
+      add(coder[name]);
+    }
+  }
+
+  /// All the fields of a readout, in the order of `id_spec.fields()`
+  static CellIDFieldDecoder allFields(const dd4hep::IDDescriptor& id_spec) {
+    CellIDFieldDecoder decoder;
+    for (const auto& [name, field] : id_spec.fields()) {
+      decoder.add(*field);
+    }
+    return decoder;
+  }
+
+  /// All the fields of a readout, in the order of their `coder.index()`
+  static CellIDFieldDecoder allFields(const dd4hep::DDSegmentation::BitFieldCoder& coder) {
+    CellIDFieldDecoder decoder;
+    for (const auto& field : coder.fields()) {
+      decoder.add(field);
+    }
+    return decoder;
+  }
+
+  std::size_t size() const { return m_fields.size(); }
+  bool empty() const { return m_fields.empty(); }
+
+  std::int64_t get(std::uint64_t cellID, std::size_t k) const {
+    const auto& field = m_fields[k];
+    const std::uint64_t top = cellID << field.left;
+    return field.is_signed ? static_cast<std::int64_t>(top) >> field.right
+                           : static_cast<std::int64_t>(top >> field.right);
+  }
+
+  template <std::size_t K> std::int64_t get(std::uint64_t cellID) const { return get(cellID, K); }
+
+  /// Decodes the fields of n cellIDs into the columns `out[k * n + i]`
+  template <typename T> void decode(const std::uint64_t* cellIDs, std::size_t n, T* out) const {
+    for (std::size_t k = 0; k < m_fields.size(); ++k) {
+      const auto [left, right, is_signed] = m_fields[k];
+      T* column = out + k * n;
+      if (is_signed) {
+        for (std::size_t i = 0; i < n; ++i) {
+          column[i] = static_cast<T>(static_cast<std::int64_t>(cellIDs[i] << left) >> right);
+        }
+      } else {
+        for (std::size_t i = 0; i < n; ++i) {
+          column[i] = static_cast<T>((cellIDs[i] << left) >> right);
+        }
+      }
+    }
+  }
+
+private:
+  struct Field {
+    unsigned left;  // 64 - offset - width
+    unsigned right; // 64 - width
+    bool is_signed;
+  };
+
+  void add(const dd4hep::DDSegmentation::BitFieldElement& field) {
+    m_fields.push_back({64 - field.offset() - field.width(), 64 - field.width(), field.isSigned()});
+  }
+
+  std::vector<Field> m_fields;
+};
+
+} // namespace eicrecon
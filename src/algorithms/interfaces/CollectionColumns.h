@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * @brief Members of the elements of a podio collection in contiguous arrays
+ *
+ * Every member is a getter or a projection of the element, e.g.
+ *
+ *     using HitColumns = CollectionColumns<edm4eic::CalorimeterHitCollection,
+ *         &edm4eic::CalorimeterHit::getEnergy,
+ *         [](const edm4eic::CalorimeterHit& hit) { return hit.getPosition().x; }>;
+ *     const auto columns = ColumnCache::get<HitColumns>(*hits);
+ *     const auto energy = columns->get<0>();
+ *
+ * so that the numerical loops of an algorithm run over plain arrays instead
+ * of a handle per element and field. The columns are read only, the results
+ * are still written through the collection API.
+ */
+template <typename CollectionT, auto... Members> class CollectionColumns {
+public:
+  using collection_type = CollectionT;
+  using element_type    = typename CollectionT::value_type;
+
+  template <std::size_t I>
+  using column_type =
+      std::decay_t<std::invoke_result_t<std::tuple_element_t<I, std::tuple<decltype(Members)...>>, const element_type&>>;
+
+  CollectionColumns() = default;
+  explicit CollectionColumns(const CollectionT& collection) { build(collection); }
+
+  void build(const CollectionT& collection) {
+    m_size = collection.size();
+    build(collection, std::index_sequence_for<decltype(Members)...>{});
+  }
+
+  std::size_t size() const { return m_size; }
+
+  /// The column of the member I
+  template <std::size_t I> std::span<const column_type<I>> get() const { return std::get<I>(m_columns); }
+
+private:
+  template <std::size_t... I> void build(const CollectionT& collection, std::index_sequence<I...>) {
+    (std::get<I>(m_columns).resize(m_size), ...);
+    for (std::size_t i = 0; i < m_size; ++i) {
+      const auto element = collection[i];
+      ((std::get<I>(m_columns)[i] = std::invoke(Members, element)), ...);
+    }
+  }
+
+  template <std::size_t... I>
+  static auto columns(std::index_sequence<I...>) -> std::tuple<std::vector<column_type<I>>...>;
+
+  std::size_t m_size{0};
+  decltype(columns(std::index_sequence_for<decltype(Members)...>{})) m_columns;
+};
+
+/**
+ * @brief Columns of the collections of the event of this thread
+ *
+ * JOmniFactory opens an EventScope around the processing of every event, the
+ * columns of a collection are then built once per event, by the first
+ * algorithm that asks for them, and shared with the later algorithms of the
+ * same event on this thread. The columns of the previous event are dropped
+ * when the next one starts. Outside of any EventScope, e.g. in the tests,
+ * every call builds its own columns.
+ *
+ * The collections are identified by their address and size, so only the
+ * columns of collections that are not modified any more, i.e. of inputs,
+ * may be asked for.
+ */
+class ColumnCache {
+public:
+  /// Marks the event processed by this thread, nested scopes of the same event share the cache
+  class EventScope {
+  public:
+    EventScope(const void* event, std::uint64_t event_number) {
+      auto& state = threadState();
+      if (state.event != event || state.event_number != event_number) {
+        state.entries.clear();
+        state.event        = event;
+        state.event_number = event_number;
+      }
+      ++state.depth;
+    }
+    ~EventScope() { --threadState().depth; }
+    EventScope(const EventScope&)            = delete;
+    EventScope& operator=(const EventScope&) = delete;
+  };
+
+  template <typename Columns>
+  static std::shared_ptr<const Columns> get(const typename Columns::collection_type& collection) {
+    auto& state = threadState();
+    if (state.depth == 0) {
+      return std::make_shared<const Columns>(collection);
+    }
+    auto& entry = state.entries[{static_cast<const void*>(&collection), std::type_index(typeid(Columns))}];
+    if (entry.columns == nullptr || entry.size != collection.size()) {
+      entry.columns = std::make_shared<const Columns>(collection);
+      entry.size    = collection.size();
+    }
+    return std::static_pointer_cast<const Columns>(entry.columns);
+  }
+
+private:
+  struct Entry {
+    std::shared_ptr<const void> columns;
+    std::size_t size{0};
+  };
+
+  struct State {
+    const void* event{nullptr};
+    std::uint64_t event_number{0};
+    int depth{0};
+    std::map<std::pair<const void*, std::type_index>, Entry> entries;
+  };
+
+  static State& threadState() {
+    thread_local State state;
+    return state;
+  }
+};
+
+} // namespace eicrecon
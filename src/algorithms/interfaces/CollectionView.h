@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * @brief Concatenation of podio collections, iterated without a copy
+ *
+ * The view refers to the collections of an event, e.g. the tracker hits of
+ * all the subsystems, and iterates their elements in order as if they were
+ * merged. The elements are never copied into another collection, so there is
+ * no handle and no reference count per element, except for `materialize()`
+ * that fills a subset collection where a real collection is needed, e.g. for
+ * an output. The view is only valid as long as the event of its collections.
+ */
+template <typename CollectionT> class CollectionView {
+public:
+  using collection_type = CollectionT;
+  using value_type      = typename CollectionT::value_type;
+
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = typename CollectionView::value_type;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = value_type;
+
+    iterator() = default;
+
+    value_type operator*() const { return (*(*m_collections)[m_collection])[m_index]; }
+
+    iterator& operator++() {
+      ++m_index;
+      skip_empty();
+      return *this;
+    }
+    iterator operator++(int) {
+      auto it = *this;
+      ++*this;
+      return it;
+    }
+
+    bool operator==(const iterator& other) const {
+      return m_collection == other.m_collection && m_index == other.m_index;
+    }
+
+  private:
+    friend class CollectionView;
+
+    iterator(const std::vector<const CollectionT*>* collections, std::size_t collection)
+        : m_collections(collections), m_collection(collection) {
+      skip_empty();
+    }
+
+    void skip_empty() {
+      while (m_collection < m_collections->size() && m_index >= (*m_collections)[m_collection]->size()) {
+        ++m_collection;
+        m_index = 0;
+      }
+    }
+
+    const std::vector<const CollectionT*>* m_collections{nullptr};
+    std::size_t m_collection{0};
+    std::size_t m_index{0};
+  };
+
+  CollectionView() = default;
+  explicit CollectionView(std::vector<const CollectionT*> collections) : m_collections(std::move(collections)) {}
+
+  void add(const CollectionT* collection) { m_collections.push_back(collection); }
+
+  const std::vector<const CollectionT*>& collections() const { return m_collections; }
+
+  std::size_t size() const {
+    std::size_t n = 0;
+    for (const auto* collection : m_collections) {
+      n += collection->size();
+    }
+    return n;
+  }
+  bool empty() const { return size() == 0; }
+
+  iterator begin() const { return {&m_collections, 0}; }
+  iterator end() const { return {&m_collections, m_collections.size()}; }
+
+  /// Calls `f(element)` for the elements of all the collections, in order
+  template <typename F> void forEach(F&& f) const {
+    for (const auto* collection : m_collections) {
+      for (const auto& element : *collection) {
+        f(element);
+      }
+    }
+  }
+
+  /// Fills a subset collection with the elements of the view
+  void materialize(CollectionT& out) const {
+    out.setSubsetCollection();
+    forEach([&out](const auto& element) { out.push_back(element); });
+  }
+
+private:
+  std::vector<const CollectionT*> m_collections;
+};
+
+} // namespace eicrecon
@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <algorithms/logger.h>
+#include <algorithms/service.h>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <span>
+#include <string_view>
+
+#include "services/geometry/disk_cache/CacheFile.h"
+
+namespace eicrecon {
+
+/**
+ * @brief Philox4x32-10 counter-based random function
+ *
+ * Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11.
+ * The output is a pure function of the counter and the key, so there is no
+ * state to share or to lock.
+ */
+struct Philox4x32 {
+  using Counter = std::array<std::uint32_t, 4>;
+  using Key = std::array<std::uint32_t, 2>;
+
+  static constexpr Counter generate(Counter ctr, Key key) {
+    for (int round = 0; round < 10; ++round) {
+      if (round > 0) {
+        key[0] += 0x9E3779B9;
+        key[1] += 0xBB67AE85;
+      }
+      const std::uint64_t p0 = std::uint64_t{0xD2511F53} * ctr[0];
+      const std::uint64_t p1 = std::uint64_t{0xCD9E8D57} * ctr[2];
+      ctr = {static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<std::uint32_t>(p1),
+             static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<std::uint32_t>(p0)};
+    }
+    return ctr;
+  }
+};
+
+/**
+ * @brief Stream of random numbers for one readout cell
+ *
+ * The n-th number of the stream only depends on the stream key, the cellID
+ * and the substream, not on the order in which cells or events are processed.
+ * Substreams tell apart several objects in the same cell (e.g. photons of a
+ * pixel). Streams are cheap to create and are meant to be local to process().
+ */
+class CounterRandom {
+public:
+  CounterRandom(std::uint64_t key, std::uint64_t cellID, std::uint32_t substream = 0)
+    : m_key{static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32)}
+    , m_cell{static_cast<std::uint32_t>(cellID), static_cast<std::uint32_t>(cellID >> 32)}
+    , m_substream(substream) {}
+
+  /// 64 random bits
+  std::uint64_t bits() {
+    if (m_next == m_block.size()) {
+      m_block = Philox4x32::generate({m_cell[0], m_cell[1], m_counter++, m_substream}, m_key);
+      m_next = 0;
+    }
+    const std::uint64_t lo = m_block[m_next++];
+    const std::uint64_t hi = m_block[m_next++];
+    return (hi << 32) | lo;
+  }
+
+  /// Uniform in (0, 1)
+  double uniform() { return to_uniform(bits()); }
+
+  /// Standard normal
+  double gaussian() {
+    if (m_has_spare) {
+      m_has_spare = false;
+      return m_spare;
+    }
+    const double r = std::sqrt(-2. * std::log(uniform()));
+    const double phi = 2. * std::numbers::pi * uniform();
+    m_spare = r * std::sin(phi);
+    m_has_spare = true;
+    return r * std::cos(phi);
+  }
+
+  /**
+   * @brief First standard normal of the stream of every cell
+   *
+   * `out[i]` is the same as `CounterRandom(key, cellIDs[i]).gaussian()`, the
+   * loop has no data dependencies between cells and can be vectorized.
+   */
+  static void gaussians(std::uint64_t key, std::span<const std::uint64_t> cellIDs, std::span<double> out) {
+    const Philox4x32::Key k{static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32)};
+    for (std::size_t i = 0; i < cellIDs.size() && i < out.size(); ++i) {
+      const auto block = Philox4x32::generate(
+          {static_cast<std::uint32_t>(cellIDs[i]), static_cast<std::uint32_t>(cellIDs[i] >> 32), 0, 0}, k);
+      const double u1 = to_uniform((std::uint64_t{block[1]} << 32) | block[0]);
+      const double u2 = to_uniform((std::uint64_t{block[3]} << 32) | block[2]);
+      out[i] = std::sqrt(-2. * std::log(u1)) * std::cos(2. * std::numbers::pi * u2);
+    }
+  }
+
+private:
+  static double to_uniform(std::uint64_t x) {
+    // 53 significant bits, offset by half a step to exclude 0 and 1
+    return (static_cast<double>(x >> 11) + 0.5) * 0x1p-53;
+  }
+
+  Philox4x32::Key m_key;
+  std::array<std::uint32_t, 2> m_cell;
+  std::uint32_t m_substream;
+  std::uint32_t m_counter{0};
+  Philox4x32::Counter m_block{};
+  std::size_t m_next{m_block.size()};
+  double m_spare{0.};
+  bool m_has_spare{false};
+};
+
+/**
+ * @brief Service for reproducible per-event random numbers
+ *
+ * Streams are keyed on the global seed, the algorithm name, the run and event
+ * numbers and the cellID, so the results do not depend on the number of
+ * threads, on the assignment of events to threads, or on which other
+ * algorithms run.
+ */
+class CounterRandomSvc : public algorithms::LoggedService<CounterRandomSvc> {
+public:
+  void init() {}
+
+  /// Key of the streams used by `algorithm` in the given event, `salt` allows for a per-algorithm seed
+  std::uint64_t key(std::string_view algorithm, std::uint64_t run, std::uint64_t event, std::uint64_t salt = 0) const {
+    CacheHash name_hash;
+    name_hash.add_bytes(std::as_bytes(std::span(algorithm.data(), algorithm.size())));
+    std::uint64_t h = mix(m_seed.value());
+    h = mix(h ^ name_hash.value());
+    h = mix(h ^ run);
+    h = mix(h ^ event);
+    h = mix(h ^ salt);
+    return h;
+  }
+
+  CounterRandom generator(std::uint64_t key, std::uint64_t cellID, std::uint32_t substream = 0) const {
+    return {key, cellID, substream};
+  }
+
+private:
+  // splitmix64 finalizer
+  static std::uint64_t mix(std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  Property<std::size_t> m_seed{this, "seed", 1, "Global seed of the per-event random streams"};
+
+  ALGORITHMS_DEFINE_LOGGED_SERVICE(CounterRandomSvc);
+};
+
+} // namespace eicrecon
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace eicrecon {
+
+/**
+ * Per-thread monotonic arena for the temporaries of the algorithms, e.g.
+ *
+ *     std::pmr::unordered_map<CellIDType, std::pmr::vector<HitData>> groups{EventArena::resource()};
+ *
+ * Allocations only bump a pointer and deallocations do nothing, the memory is
+ * released at once when the outermost Scope of the thread ends, i.e. after the
+ * algorithm of a factory has processed an event. The released blocks stay in
+ * a pool of the thread and are reused by the next events, so that a thread
+ * stops allocating once it has seen its largest event. Containers from the
+ * arena must not outlive the Scope, outputs are never allocated from it.
+ *
+ * With -DUSE_ARENA_STATS=ON (EICRECON_ARENA_STATS) the bytes of each Scope
+ * are counted, and the largest of every name is kept for highWater().
+ */
+class EventArena {
+public:
+  /// The arena of this thread, or the default resource outside of any Scope
+  static std::pmr::memory_resource* resource() {
+    auto& state = threadState();
+    if (state.depth == 0) {
+      return std::pmr::get_default_resource();
+    }
+#ifdef EICRECON_ARENA_STATS
+    return &state.counting;
+#else
+    return &state.arena;
+#endif
+  }
+
+  /// Marks the processing of an event by an algorithm, nested scopes share the outermost one
+  class Scope {
+  public:
+    explicit Scope(std::string_view name) : m_name(name) { ++threadState().depth; }
+    ~Scope() {
+      auto& state = threadState();
+      if (--state.depth > 0) {
+        return;
+      }
+#ifdef EICRECON_ARENA_STATS
+      record(m_name, state.counting.bytes);
+      state.counting.bytes = 0;
+#endif
+      state.arena.release();
+    }
+    Scope(const Scope&)            = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    std::string_view m_name;
+  };
+
+  /// Largest bytes asked from the arena in one Scope of this name, 0 without EICRECON_ARENA_STATS
+  static std::size_t highWater(std::string_view name) {
+    std::lock_guard<std::mutex> lock(statsMutex());
+    const auto it = stats().find(name);
+    return it == stats().end() ? 0 : it->second;
+  }
+
+private:
+  /// Counts the bytes asked from the arena
+  class CountingResource : public std::pmr::memory_resource {
+  public:
+    explicit CountingResource(std::pmr::memory_resource* upstream) : m_upstream(upstream) {}
+    std::size_t bytes{0};
+
+  private:
+    void* do_allocate(std::size_t size, std::size_t alignment) override {
+      bytes += size;
+      return m_upstream->allocate(size, alignment);
+    }
+    void do_deallocate(void* p, std::size_t size, std::size_t alignment) override {
+      m_upstream->deallocate(p, size, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::pmr::memory_resource* m_upstream;
+  };
+
+  struct State {
+    std::pmr::unsynchronized_pool_resource pool{{.max_blocks_per_chunk = 0, .largest_required_pool_block = 1 << 22}};
+    std::pmr::monotonic_buffer_resource arena{64 * 1024, &pool};
+    CountingResource counting{&arena};
+    int depth{0};
+  };
+
+  static State& threadState() {
+    thread_local State state;
+    return state;
+  }
+
+  static std::mutex& statsMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static std::map<std::string, std::size_t, std::less<>>& stats() {
+    static std::map<std::string, std::size_t, std::less<>> high_water;
+    return high_water;
+  }
+
+  static void record(std::string_view name, std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(statsMutex());
+    auto it = stats().find(name);
+    if (it == stats().end()) {
+      stats().emplace(std::string(name), bytes);
+    } else if (bytes > it->second) {
+      it->second = bytes;
+    }
+  }
+};
+
+} // namespace eicrecon
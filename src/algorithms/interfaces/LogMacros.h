@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+/**
+ * Level-checked logging for hot loops.
+ *
+ * The arguments are only evaluated if the level is enabled, e.g.
+ *
+ *     EICRECON_DEBUG("hit {:d}: energy = {:.4f} MeV", i, hit.getEnergy() * 1000.);   // algorithms::LoggerMixin
+ *     EICRECON_LOG_TRACE(m_log, "cell id: {}", hit.getCellID());                     // spdlog::logger
+ *
+ * Levels below EICRECON_LOG_ACTIVE_LEVEL (0 trace, 1 debug, 2 info) are
+ * compiled out, configuring with -DUSE_DEBUG_LOGGING=OFF sets it to 2.
+ */
+#ifndef EICRECON_LOG_ACTIVE_LEVEL
+#define EICRECON_LOG_ACTIVE_LEVEL 0
+#endif
+
+// in the members of an algorithms::LoggerMixin, algorithms/logger.h must be included
+#define EICRECON_ALGORITHMS_LOG(active, lvl, method, ...)                       \
+  do {                                                                          \
+    if ((active) && (this->level() <= algorithms::LogLevel::lvl)) {             \
+      this->method(__VA_ARGS__);                                                \
+    }                                                                           \
+  } while (false)
+
+#define EICRECON_TRACE(...) EICRECON_ALGORITHMS_LOG(EICRECON_LOG_ACTIVE_LEVEL <= 0, kTrace, trace, __VA_ARGS__)
+#define EICRECON_DEBUG(...) EICRECON_ALGORITHMS_LOG(EICRECON_LOG_ACTIVE_LEVEL <= 1, kDebug, debug, __VA_ARGS__)
+
+// with a std::shared_ptr<spdlog::logger>, e.g. the m_log of SpdlogMixin, spdlog/spdlog.h must be included
+#define EICRECON_SPDLOG(active, lvl, logger, ...)                               \
+  do {                                                                          \
+    if ((active) && (logger)->should_log(spdlog::level::lvl)) {                 \
+      (logger)->lvl(__VA_ARGS__);                                               \
+    }                                                                           \
+  } while (false)
+
+#define EICRECON_LOG_TRACE(logger, ...) EICRECON_SPDLOG(EICRECON_LOG_ACTIVE_LEVEL <= 0, trace, logger, __VA_ARGS__)
+#define EICRECON_LOG_DEBUG(logger, ...) EICRECON_SPDLOG(EICRECON_LOG_ACTIVE_LEVEL <= 1, debug, logger, __VA_ARGS__)
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <cctype>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace eicrecon {
+
+/// NUMA node of the CPU that the calling thread runs on, 0 if unknown
+inline std::size_t CurrentNumaNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu  = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return node;
+  }
+#endif
+  return 0;
+}
+
+/// Number of NUMA nodes of the machine, at least 1
+inline std::size_t NumaNodeCount() {
+  std::size_t nodes = 0;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+    const auto name = entry.path().filename().string();
+    if (name.rfind("node", 0) == 0 && name.size() > 4 && std::isdigit(static_cast<unsigned char>(name[4]))) {
+      ++nodes;
+    }
+  }
+  return nodes > 0 ? nodes : 1;
+}
+
+/**
+ * Copies of read-only data, one per NUMA node, made on the first request
+ * from a thread of the node so that the kernel places their pages on it.
+ *
+ * local() is meant to be called once per thread or per cache object (e.g.
+ * in makeCache()), not per lookup, and only pays off when the threads are
+ * pinned to their nodes (jana:numa_policy). Without replication, or on a
+ * machine with one node, it returns the master copy.
+ */
+template <typename T> class NumaReplicas {
+public:
+  explicit NumaReplicas(bool enabled = false) { enable(enabled); }
+
+  void enable(bool enabled) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_replicas.clear();
+    m_replicas.resize(enabled ? NumaNodeCount() : 0);
+    if (m_replicas.size() == 1) {
+      m_replicas.clear();
+    }
+  }
+
+  bool enabled() const { return !m_replicas.empty(); }
+
+  /// The copy of master on the node of the calling thread
+  const T& local(const T& master) const {
+    if (m_replicas.empty()) {
+      return master;
+    }
+    const std::size_t node = CurrentNumaNode();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (node >= m_replicas.size()) {
+      return master;
+    }
+    if (m_replicas[node] == nullptr) {
+      m_replicas[node] = std::make_unique<const T>(master);
+    }
+    return *m_replicas[node];
+  }
+
+private:
+  mutable std::mutex m_mutex;
+  mutable std::vector<std::unique_ptr<const T>> m_replicas;
+};
+
+} // namespace eicrecon
@@ -11,6 +11,7 @@ namespace eicrecon {
      *    WithPodConfig<NoConfig>
      */
     struct NoConfig {
+        bool operator==(const NoConfig&) const = default;
     };
 
     /**
@@ -6,6 +6,7 @@
 #include <string>
 #include <string_view>
 
+#include "algorithms/interfaces/CollectionView.h"
 #include "services/log/Log_service.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 
@@ -35,13 +36,11 @@ namespace eicrecon {
       const auto [in_collections] = input;
       auto [out_collection]       = output;
 
-      out_collection->setSubsetCollection();
-
+      CollectionView<T> view;
       for (const auto& collection : in_collections) {
-        for (const auto& hit : *collection) {
-          out_collection->push_back(hit);
-        }
+        view.add(collection);
       }
+      view.materialize(*out_collection);
     }
 
   };
@@ -5,8 +5,14 @@
 
 #include <spdlog/spdlog.h>
 #include <algorithms/algorithm.h>
+#include <podio/ObjectID.h>
+#include <concepts>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <string_view>
+#include <unordered_set>
+#include <utility>
 
 #include "services/log/Log_service.h"
 #include "algorithms/interfaces/WithPodConfig.h"
@@ -25,11 +31,27 @@ namespace eicrecon {
         >
      >;
 
+  /// Key of an ObjectID in a hash set, the collection ID and the index packed in 64 bits
+  inline std::uint64_t FilterMatchingKey(const podio::ObjectID& id) {
+    return (static_cast<std::uint64_t>(id.collectionID) << 32) | static_cast<std::uint32_t>(id.index);
+  }
+
+  template<typename KeyT>
+  KeyT FilterMatchingKey(const KeyT& key) { return key; }
+
+  template<typename KeyT>
+  concept HashableMatchingKey = requires(const KeyT& key) {
+    { std::hash<KeyT>{}(key) } -> std::convertible_to<std::size_t>;
+  };
+
   /// Filters a collection by the members of another collection
   /// The first collection is divided up into two collections where its elements either passed the filter or not
   /// The second collection provides a filter
   /// Functions need to be provided along with the collections to form the link between the data types
   /// These functions are envisioned to link the objectIDs of the collection/associations but could be anything
+  /// Entries match when the values returned by the functions compare equal. If the values are hashable
+  /// (ObjectIDs, cellIDs, ...) the smaller collection is put in a hash set and the filtering is linear,
+  /// otherwise every pair of entries is compared.
   template<typename ToFilterObjectT,auto ToFilterFunction, typename FilterByObjectT,auto FilterByFunction>
   class FilterMatching : public FilterMatchingAlgorithm<ToFilterObjectT,FilterByObjectT> {
 
@@ -53,26 +75,61 @@ namespace eicrecon {
           is_matched->setSubsetCollection();
           is_not_matched->setSubsetCollection();
 
-          for (const auto& matchedEntry : *toFilterEntries){
+          using KeyT      = decltype(FilterMatchingKey(ToFilterFunction(std::declval<const ToFilterObjectT*>())));
+          using OtherKeyT = decltype(FilterMatchingKey(FilterByFunction(std::declval<const FilterByObjectT*>())));
 
-            auto ref_value = ToFilterFunction(&matchedEntry);
-
-            bool found_match = false;
+          if constexpr (HashableMatchingKey<KeyT> && std::same_as<KeyT, OtherKeyT>) {
+            // filterBy keys, or the toFilter keys seen in filterBy when toFilter is the smaller side
+            std::unordered_set<KeyT> matched_keys;
+            if (filterByEntries->size() <= toFilterEntries->size()) {
+              matched_keys.reserve(filterByEntries->size());
+              for (const auto& entry : *filterByEntries) {
+                matched_keys.insert(FilterMatchingKey(FilterByFunction(&entry)));
+              }
+            } else {
+              std::unordered_set<KeyT> ref_keys;
+              ref_keys.reserve(toFilterEntries->size());
+              for (const auto& entry : *toFilterEntries) {
+                ref_keys.insert(FilterMatchingKey(ToFilterFunction(&entry)));
+              }
+              for (const auto& entry : *filterByEntries) {
+                auto other_key = FilterMatchingKey(FilterByFunction(&entry));
+                if (ref_keys.contains(other_key)) {
+                  matched_keys.insert(other_key);
+                }
+              }
+            }
 
-            // Tries to find the association in the entries
-            for(const auto& entry : *filterByEntries){
-              auto other_value = FilterByFunction(&entry);
-              if(other_value == ref_value){
+            for (const auto& matchedEntry : *toFilterEntries) {
+              if (matched_keys.contains(FilterMatchingKey(ToFilterFunction(&matchedEntry)))) {
                 is_matched->push_back(matchedEntry);
-                found_match = true;
-                break;
+              } else {
+                is_not_matched->push_back(matchedEntry);
               }
             }
+          } else {
+            // non-hashable values, compared pairwise
+            for (const auto& matchedEntry : *toFilterEntries){
+
+              auto ref_value = ToFilterFunction(&matchedEntry);
+
+              bool found_match = false;
+
+              // Tries to find the association in the entries
+              for(const auto& entry : *filterByEntries){
+                auto other_value = FilterByFunction(&entry);
+                if(other_value == ref_value){
+                  is_matched->push_back(matchedEntry);
+                  found_match = true;
+                  break;
+                }
+              }
 
-            if(!found_match){
-              is_not_matched->push_back(matchedEntry);
-            }
+              if(!found_match){
+                is_not_matched->push_back(matchedEntry);
+              }
 
+            }
           }
 
         };
@@ -6,8 +6,11 @@
 #include <spdlog/spdlog.h>
 #include <DD4hep/Detector.h>
 #include <algorithms/algorithm.h>
+#include <functional>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <vector>
 
 #include "services/log/Log_service.h"
 #include "algorithms/meta/SubDivideCollectionConfig.h"
@@ -22,8 +25,16 @@ namespace eicrecon {
      >;
 
 
-  template<typename T>
-  class SubDivideCollection : public SubDivideCollectionAlgorithm<T>, public WithPodConfig<SubDivideCollectionConfig<T>>  {
+  // the division functor either has a `forEachDivision(entry, f)` member,
+  // which calls `f(index)` for each division of the entry, or returns the
+  // indices of the divisions of the entry
+  template<typename FunctorT, typename T>
+  concept DivisionVisitor = requires(const FunctorT& function, const T& entry) {
+    function.forEachDivision(entry, [](int) {});
+  };
+
+  template<typename T, typename FunctorT = std::function<std::vector<int>(const T&)>>
+  class SubDivideCollection : public SubDivideCollectionAlgorithm<T>, public WithPodConfig<SubDivideCollectionConfig<T, FunctorT>>  {
 
     public:
     SubDivideCollection(std::string_view name)
@@ -32,7 +43,7 @@ namespace eicrecon {
                         {"outputCollection"},
                           "Sub-Divide collection"
                       },
-        WithPodConfig<SubDivideCollectionConfig<T>>() {
+        WithPodConfig<SubDivideCollectionConfig<T, FunctorT>>() {
         };
 
         void init() final { };
@@ -48,10 +59,16 @@ namespace eicrecon {
 
           for (const auto& entry : *entries) {
 
-            auto div_indices = this->m_cfg.function(entry);
+            if constexpr (DivisionVisitor<FunctorT, T>) {
+              this->m_cfg.function.forEachDivision(entry, [&](int index) {
+                subdivided_entries[index]->push_back(entry);
+              });
+            } else {
+              auto div_indices = this->m_cfg.function(entry);
 
-            for (auto index : div_indices){
-              subdivided_entries[index]->push_back(entry);
+              for (auto index : div_indices){
+                subdivided_entries[index]->push_back(entry);
+              }
             }
 
           }
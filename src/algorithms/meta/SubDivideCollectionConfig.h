@@ -3,11 +3,16 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
 namespace eicrecon {
 
-  template<class T>
+  // FunctorT can be one of the functors of SubDivideFunctors.h, so that it is
+  // called directly instead of through std::function
+  template<class T, class FunctorT = std::function<std::vector<int>(const T&)>>
   struct SubDivideCollectionConfig {
-    std::function<std::vector<int>(const T&)> function;
+    FunctorT function;
   };
 
 } // eicrecon
@@ -4,9 +4,20 @@
 #pragma once
 
 #include <algorithms/geo.h>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace eicrecon {
 
+// The functors can be called for the indices of the divisions of an instance,
+// or, without building that list, with forEachDivision(instance, f) which
+// calls f(index) for each division (see SubDivideCollection)
+
 // ----------------------------------------------------------------------------
 // Functor to split collection based on a range of values
 // ----------------------------------------------------------------------------
@@ -14,18 +25,25 @@ template <auto MemberFunctionPtr>
 class RangeSplit {
 public:
 
+    RangeSplit() = default;
     RangeSplit(std::vector<std::pair<double,double>> ranges) : m_ranges(ranges) {};
 
     template <typename T>
     std::vector<int> operator()(T& instance) const {
         std::vector<int> ids;
+        forEachDivision(instance, [&ids](int id) { ids.push_back(id); });
+        return ids;
+    }
+
+    template <typename T, typename F>
+    void forEachDivision(T& instance, F&& f) const {
         //Check if requested value is within the ranges
+        const auto value = (instance.*MemberFunctionPtr)();
         for(size_t i = 0; i < m_ranges.size(); i++){
-            if((instance.*MemberFunctionPtr)() > m_ranges[i].first && (instance.*MemberFunctionPtr)() < m_ranges[i].second){
-                ids.push_back(i);
+            if(value > m_ranges[i].first && value < m_ranges[i].second){
+                f(static_cast<int>(i));
             }
         }
-        return ids;
     }
 
 private:
@@ -39,46 +57,70 @@ private:
 class GeometrySplit {
 public:
 
+    GeometrySplit() = default;
     GeometrySplit(std::vector<std::vector<long int>> ids, std::string readout, std::vector<std::string> divisions)
-    : m_ids(ids), m_readout(readout), m_divisions(divisions){};
+    : m_ids(ids), m_divisions(divisions), m_readout(readout){};
 
     template <typename T>
     std::vector<int> operator()(T& instance) const {
+        std::vector<int> ids;
+        forEachDivision(instance, [&ids](int id) { ids.push_back(id); });
+        return ids;
+    }
 
-        // Initialize the decoder and division ids on the first function call
-        std::call_once(*is_init, &GeometrySplit::init, this);
-
-        //Check which detector division to put the hit into
-        auto cellID = instance.getCellID();
-        std::vector<long int> det_ids;
-        for(auto d : m_div_ids){
-            det_ids.push_back(m_id_dec->get(cellID, d));
-        }
-        auto index = std::find(m_ids.begin(),m_ids.end(),det_ids);
+    template <typename T, typename F>
+    void forEachDivision(T& instance, F&& f) const {
 
-        std::vector<int> ids;
-        if(index != m_ids.end()){
-            ids.push_back(std::distance(m_ids.begin(),index));
+        // Initialize the decoder and division ids on the first function call
+        std::call_once(m_state->is_init, &GeometrySplit::init, this);
+
+        //Check which detector division to put the hit into, from the bits of
+        //the division fields of the cellID
+        const auto& keys = m_state->div_keys;
+        const auto key = instance.getCellID() & m_state->div_mask;
+        auto index = std::lower_bound(keys.begin(), keys.end(), std::make_pair(key, std::size_t{0}));
+        if(index != keys.end() && index->first == key){
+            f(static_cast<int>(index->second));
         }
-        return ids;
     }
 
 private:
 
     void init() const {
-        m_id_dec = algorithms::GeoSvc::instance().detector()->readout(m_readout).idSpec().decoder();
+        auto& state = *m_state;
+        auto* id_dec = algorithms::GeoSvc::instance().detector()->readout(m_readout).idSpec().decoder();
+        std::vector<size_t> div_ids;
         for (auto d : m_divisions){
-            m_div_ids.push_back(m_id_dec->index(d));
+            div_ids.push_back(id_dec->index(d));
+            state.div_mask |= (*id_dec)[div_ids.back()].mask();
+        }
+        // cellID bits of the division fields of each division, sorted for
+        // lookups, the first division wins for duplicates as with std::find
+        for (std::size_t i = 0; i < m_ids.size(); i++){
+            if (m_ids[i].size() != div_ids.size()){
+                continue;
+            }
+            dd4hep::CellID key = 0;
+            for (std::size_t j = 0; j < div_ids.size(); j++){
+                id_dec->set(key, div_ids[j], m_ids[i][j]);
+            }
+            state.div_keys.emplace_back(key, i);
         }
+        std::sort(state.div_keys.begin(), state.div_keys.end());
     }
 
     std::vector<std::vector<long int>> m_ids;
     std::vector<std::string> m_divisions;
     std::string m_readout;
 
-    mutable std::shared_ptr<std::once_flag> is_init = std::make_shared<std::once_flag>();
-    mutable dd4hep::DDSegmentation::BitFieldCoder* m_id_dec;
-    mutable std::vector<size_t> m_div_ids;
+    // initialized once, and shared by the copies of the functor in the
+    // factories of all threads
+    struct State {
+        std::once_flag is_init;
+        dd4hep::CellID div_mask{0};
+        std::vector<std::pair<dd4hep::CellID, std::size_t>> div_keys;
+    };
+    std::shared_ptr<State> m_state = std::make_shared<State>();
 
 };
 
@@ -90,22 +132,37 @@ template <auto... MemberFunctionPtrs>
 class ValueSplit {
 public:
 
+    ValueSplit() = default;
     ValueSplit(std::vector<std::vector<int>> ids) : m_ids(ids) {};
 
     template <typename T>
     std::vector<int> operator()(T& instance) const {
         std::vector<int> ids;
+        forEachDivision(instance, [&ids](int id) { ids.push_back(id); });
+        return ids;
+    }
+
+    template <typename T, typename F>
+    void forEachDivision(T& instance, F&& f) const {
         // Check if requested value matches any configuration combinations
-        std::vector<int> values;
-        (values.push_back((instance.*MemberFunctionPtrs)()), ...);
-        auto index = std::find(m_ids.begin(),m_ids.end(),values);
-        if(index != m_ids.end()){
-            ids.push_back(std::distance(m_ids.begin(),index));
+        for(size_t i = 0; i < m_ids.size(); i++){
+            if(matches(instance, m_ids[i])){
+                f(static_cast<int>(i));
+                return;
+            }
         }
-        return ids;
     }
 
 private:
+    template <typename T>
+    static bool matches(T& instance, const std::vector<int>& values) {
+        if(values.size() != sizeof...(MemberFunctionPtrs)){
+            return false;
+        }
+        std::size_t i = 0;
+        return ((values[i++] == static_cast<int>((instance.*MemberFunctionPtrs)())) && ...);
+    }
+
     std::vector<std::vector<int>> m_ids;
 
 };
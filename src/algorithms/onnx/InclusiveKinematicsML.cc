@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 // Copyright (C) 2022, 2023 Wouter Deconinck, Tooba Ali
 
+#include <algorithms/service.h>
 #include <fmt/core.h>
 #include <onnxruntime_c_api.h>
 #include <onnxruntime_cxx_api.h>
@@ -10,8 +11,10 @@
 #include <gsl/pointers>
 #include <iterator>
 #include <ostream>
+#include <sstream>
 
 #include "InclusiveKinematicsML.h"
+#include "OnnxRuntimeSvc.h"
 
 namespace eicrecon {
 
@@ -22,20 +25,22 @@ namespace eicrecon {
     return ss.str();
   }
 
-  template <typename T>
-  Ort::Value vec_to_tensor(std::vector<T>& data, const std::vector<std::int64_t>& shape) {
-    Ort::MemoryInfo mem_info =
-        Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-    auto tensor = Ort::Value::CreateTensor<T>(mem_info, data.data(), data.size(), shape.data(), shape.size());
-    return tensor;
+  // number of elements of a tensor, with dynamic dimensions taken as 1
+  static std::size_t fix_dynamic_shape(std::vector<std::int64_t>& shape) {
+    std::size_t n = 1;
+    for (auto& dim : shape) {
+      if (dim < 0) dim = 1;
+      n *= static_cast<std::size_t>(dim);
+    }
+    return n;
   }
 
   void InclusiveKinematicsML::init() {
     // onnxruntime setup
-    Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "inclusive-kinematics-ml");
-    Ort::SessionOptions session_options;
+    auto& serviceSvc = algorithms::ServiceSvc::instance();
+    auto onnx_svc = serviceSvc.service<OnnxRuntimeSvc>("OnnxRuntimeSvc");
     try {
-      m_session = Ort::Session(env, m_cfg.modelPath.c_str(), session_options);
+      m_session = onnx_svc->session(m_cfg.modelPath);
 
       // print name/shape of inputs
       Ort::AllocatorWithDefaultOptions allocator;
@@ -62,6 +67,22 @@ namespace eicrecon {
       std::transform(std::begin(m_output_names), std::end(m_output_names), std::begin(m_output_names_char),
                      [&](const std::string& str) { return str.c_str(); });
 
+      // preallocate the tensors of a model with 1 input node and 1 output node,
+      // and bind them once instead of creating them for every event
+      if (m_input_names.size() == 1 && m_output_names.size() == 1) {
+        Ort::MemoryInfo mem_info =
+            Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+        m_input_values.resize(fix_dynamic_shape(m_input_shapes.front()));
+        m_output_values.resize(fix_dynamic_shape(m_output_shapes.front()));
+        m_input_tensor = Ort::Value::CreateTensor<float>(mem_info, m_input_values.data(), m_input_values.size(),
+                                                         m_input_shapes.front().data(), m_input_shapes.front().size());
+        m_output_tensor = Ort::Value::CreateTensor<float>(mem_info, m_output_values.data(), m_output_values.size(),
+                                                          m_output_shapes.front().data(), m_output_shapes.front().size());
+        m_binding = Ort::IoBinding(m_session);
+        m_binding.BindInput(m_input_names_char.front(), m_input_tensor);
+        m_binding.BindOutput(m_output_names_char.front(), m_output_tensor);
+      }
+
     } catch(std::exception& e) {
       error(e.what());
     }
@@ -86,34 +107,21 @@ namespace eicrecon {
       return;
     }
 
-    // Prepare input tensor
-    std::vector<float> input_tensor_values;
-    std::vector<Ort::Value> input_tensors;
-    for (std::size_t i = 0; i < electron->size(); i++) {
-      input_tensor_values.push_back(electron->at(i).getX());
-    }
-    input_tensors.emplace_back(vec_to_tensor<float>(input_tensor_values, m_input_shapes.front()));
-
-    // Double-check the dimensions of the input tensor
-    if (! input_tensors[0].IsTensor() || input_tensors[0].GetTensorTypeAndShapeInfo().GetShape() != m_input_shapes.front()) {
+    // Fill the bound input tensor
+    if (electron->size() != m_input_values.size()) {
       debug("skipping because input tensor shape incorrect");
       return;
     }
+    for (std::size_t i = 0; i < electron->size(); i++) {
+      m_input_values[i] = electron->at(i).getX();
+    }
 
     // Attempt inference
     try {
-      auto output_tensors = m_session.Run(Ort::RunOptions{nullptr}, m_input_names_char.data(), input_tensors.data(),
-                                          m_input_names_char.size(), m_output_names_char.data(), m_output_names_char.size());
-
-      // Double-check the dimensions of the output tensors
-      if (!output_tensors[0].IsTensor() || output_tensors.size() != m_output_names.size()) {
-        debug("skipping because output tensor shape incorrect");
-        return;
-      }
+      m_session.Run(Ort::RunOptions{nullptr}, m_binding);
 
       // Convert output tensor
-      float* output_tensor_data = output_tensors[0].GetTensorMutableData<float>();
-      auto x  = output_tensor_data[0];
+      auto x  = m_output_values.front();
       auto kin = ml->create();
       kin.setX(x);
 
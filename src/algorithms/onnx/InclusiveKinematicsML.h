@@ -45,6 +45,14 @@ private:
   std::vector<std::string> m_output_names;
   std::vector<const char*> m_output_names_char;
   std::vector<std::vector<std::int64_t>> m_output_shapes;
+
+  // input and output buffers, bound to the session once (an algorithm
+  // instance is only used by one thread at a time, as for m_session)
+  mutable std::vector<float> m_input_values;
+  mutable std::vector<float> m_output_values;
+  Ort::Value m_input_tensor{nullptr};
+  Ort::Value m_output_tensor{nullptr};
+  Ort::IoBinding m_binding{nullptr};
 };
 
 } // namespace eicrecon
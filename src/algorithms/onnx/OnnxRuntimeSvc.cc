@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <fmt/core.h>
+#include <onnxruntime_c_api.h>
+#include <exception>
+#include <utility>
+
+#include "OnnxRuntimeSvc.h"
+#include "services/log/StartupProfile.h"
+
+namespace eicrecon {
+
+  void OnnxRuntimeSvc::init() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Ort::ThreadingOptions threading_options;
+    threading_options.SetGlobalIntraOpNumThreads(m_intraOpThreads.value());
+    threading_options.SetGlobalInterOpNumThreads(m_interOpThreads.value());
+    m_env = std::make_unique<Ort::Env>(threading_options, ORT_LOGGING_LEVEL_WARNING, "eicrecon");
+    debug("ONNX Runtime environment with {} intra-op and {} inter-op threads",
+          m_intraOpThreads.value(), m_interOpThreads.value());
+    if (m_preload.value()) {
+      for (auto& [modelPath, future] : m_preloaded) {
+        start(modelPath, future);
+      }
+    }
+  }
+
+  void OnnxRuntimeSvc::preload(const std::string& modelPath) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto [it, inserted] = m_preloaded.try_emplace(modelPath);
+    if (inserted && m_env && m_preload.value()) {
+      start(it->first, it->second);
+    }
+  }
+
+  void OnnxRuntimeSvc::start(const std::string& modelPath, std::future<Ort::Session>& future) {
+    if (future.valid()) {
+      return;
+    }
+    future = std::async(std::launch::async, [this, modelPath]() {
+      eicrecon::StartupProfile::Scope profile("ONNX session", modelPath);
+      return make_session(modelPath);
+    });
+  }
+
+  void OnnxRuntimeSvc::wait() {
+    // the sessions are made without m_mutex, nor does session() hold it while it waits
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& [modelPath, future] : m_preloaded) {
+      if (future.valid()) {
+        future.wait();
+      }
+    }
+  }
+
+  Ort::Session OnnxRuntimeSvc::session(const std::string& modelPath) {
+    std::future<Ort::Session> preloaded;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (auto it = m_preloaded.find(modelPath); it != m_preloaded.end() && it->second.valid()) {
+        preloaded = std::move(it->second);
+        m_preloaded.erase(it);
+      }
+    }
+    if (preloaded.valid()) {
+      // waits for the session without holding the lock, make_session can except
+      eicrecon::StartupProfile::Scope profile("ONNX session wait", modelPath);
+      return preloaded.get();
+    }
+    eicrecon::StartupProfile::Scope profile("ONNX session", modelPath);
+    return make_session(modelPath);
+  }
+
+  Ort::Session OnnxRuntimeSvc::make_session(const std::string& modelPath) {
+    // m_env and the properties do not change after init()
+    Ort::SessionOptions session_options;
+    session_options.DisablePerSessionThreads();
+    for (const auto& provider : m_executionProviders.value()) {
+      try {
+        if (provider == "CUDA") {
+          OrtCUDAProviderOptions cuda_options{};
+          session_options.AppendExecutionProvider_CUDA(cuda_options);
+        } else {
+          session_options.AppendExecutionProvider(provider);
+        }
+        debug("Using the {} execution provider for {}", provider, modelPath);
+      } catch (const std::exception& e) {
+        warning("Execution provider {} not available for {}: {}", provider, modelPath, e.what());
+      }
+    }
+    return Ort::Session(*m_env, modelPath.c_str(), session_options);
+  }
+
+} // namespace eicrecon
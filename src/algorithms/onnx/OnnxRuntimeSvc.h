@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <algorithms/logger.h>
+#include <algorithms/service.h>
+#include <onnxruntime_cxx_api.h>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * Owns the one `Ort::Env` of the process and its global thread pools, and
+ * creates the sessions of the algorithms with the configured execution
+ * providers. Sessions do not get their own thread pools, so the number of
+ * ONNX Runtime threads does not grow with the number of JANA threads.
+ *
+ * Sessions can be scheduled with preload() when the plugins are loaded, they
+ * are then created in background threads as soon as the service is
+ * initialized, and the first session() of the model only waits for it.
+ */
+class OnnxRuntimeSvc : public algorithms::LoggedService<OnnxRuntimeSvc> {
+public:
+  void init();
+
+  /// New session of a model, on the first of the execution providers that is available
+  Ort::Session session(const std::string& modelPath);
+
+  /// Schedules the creation of a session in the background, does nothing if it is already scheduled
+  void preload(const std::string& modelPath);
+
+  /// Waits for the sessions that are being created, without their errors, which session() reports
+  void wait();
+
+private:
+  /// Starts creating the preloaded session unless it is already started, m_mutex must be held
+  void start(const std::string& modelPath, std::future<Ort::Session>& future);
+
+  Ort::Session make_session(const std::string& modelPath);
+
+  Property<int> m_intraOpThreads{this, "intraOpThreads", 1,
+                                 "Threads of the global intra-op thread pool"};
+  Property<int> m_interOpThreads{this, "interOpThreads", 1,
+                                 "Threads of the global inter-op thread pool"};
+  Property<std::vector<std::string>> m_executionProviders{
+      this, "executionProviders", {}, "Execution providers to try before the CPU, e.g. CUDA"};
+  Property<bool> m_preload{this, "preload", true, "Create the scheduled sessions in the background when initialized"};
+
+  std::mutex m_mutex;
+  std::unique_ptr<Ort::Env> m_env;
+  // for the first session() of every model
+  std::map<std::string, std::future<Ort::Session>> m_preloaded;
+
+  ALGORITHMS_DEFINE_LOGGED_SERVICE(OnnxRuntimeSvc);
+};
+
+} // namespace eicrecon
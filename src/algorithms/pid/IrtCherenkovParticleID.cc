@@ -22,28 +22,36 @@
 #include <podio/RelationRange.h>
 #include <spdlog/common.h>
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <functional>
+#include <future>
 #include <gsl/pointers>
 #include <iterator>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <stdexcept>
 #include <utility>
 #include <vector>
 
+#include "algorithms/interfaces/AssociationIndex.h"
 #include "algorithms/pid/IrtCherenkovParticleIDConfig.h"
+#include "algorithms/pid/IrtObjectPool.h"
 #include "algorithms/pid/Tools.h"
 
 namespace eicrecon {
 
 void IrtCherenkovParticleID::init(
     CherenkovDetectorCollection*     irt_det_coll,
-    std::shared_ptr<spdlog::logger>& logger
+    std::shared_ptr<spdlog::logger>& logger,
+    IrtGeometryLender                lender
     )
 {
   // members
   m_irt_det_coll = irt_det_coll;
   m_log          = logger;
+  m_lender       = std::move(lender);
 
   // print the configuration parameters
   m_cfg.Print(m_log, spdlog::level::debug);
@@ -52,30 +60,13 @@ void IrtCherenkovParticleID::init(
   m_cfg.PrintCheats(m_log);
 
   // extract the the relevant `CherenkovDetector`, set to `m_irt_det`
-  auto& detectors = m_irt_det_coll->GetDetectors();
-  if(detectors.size() == 0)
-    throw std::runtime_error("No CherenkovDetectors found in input collection `irt_det_coll`");
-  if(detectors.size() > 1)
-    m_log->warn("IrtCherenkovParticleID currently only supports 1 CherenkovDetector at a time; taking the first");
-  auto this_detector = *detectors.begin();
-  m_det_name         = this_detector.first;
-  m_irt_det          = this_detector.second;
+  m_irt_det = initDetector(m_irt_det_coll, m_det_name);
   m_log->debug("Initializing IrtCherenkovParticleID algorithm for CherenkovDetector '{}'", m_det_name);
 
   // readout decoding
   m_cell_mask = m_irt_det->GetReadoutCellMask();
   m_log->debug("readout cellMask = {:#X}", m_cell_mask);
 
-  // rebin refractive index tables to have `m_cfg.numRIndexBins` bins
-  m_log->trace("Rebinning refractive index tables to have {} bins",m_cfg.numRIndexBins);
-  for(auto [rad_name,irt_rad] : m_irt_det->Radiators()) {
-    auto ri_lookup_table_orig = irt_rad->m_ri_lookup_table;
-    irt_rad->m_ri_lookup_table.clear();
-    irt_rad->m_ri_lookup_table = Tools::ApplyFineBinning( ri_lookup_table_orig, m_cfg.numRIndexBins );
-    // m_log->trace("- {}", rad_name);
-    // for(auto [energy,rindex] : irt_rad->m_ri_lookup_table) m_log->trace("  {:>5} eV   {:<}", energy, rindex);
-  }
-
   // build `m_pid_radiators`, the list of radiators to use for PID
   m_log->debug("Obtain List of Radiators:");
   for(auto [rad_name,irt_rad] : m_irt_det->Radiators()) {
@@ -85,10 +76,64 @@ void IrtCherenkovParticleID::init(
     }
   }
 
-  // check radiators' configuration, and pass it to `m_irt_det`'s radiators
-  for(auto [rad_name,irt_rad] : m_pid_radiators) {
+  // uniformly binned refractive index tables, for the lookups of the photons
+  for(auto [rad_name,irt_rad] : m_pid_radiators)
+    m_ri_tables.push_back(Tools::GetUniformTable(irt_rad->m_ri_lookup_table, m_cfg.numRIndexBins));
+
+  // the task without a lender
+  if(!m_lender.acquire && m_cfg.numTasks > 1)
+    m_log->warn("No IRT geometries for {} tasks; running 1 task", m_cfg.numTasks);
+  m_task.det = m_irt_det;
+  for(auto [rad_name,irt_rad] : m_pid_radiators)
+    m_task.radiators.push_back(m_task.det->GetRadiator(rad_name.c_str()));
+
+  // get PDG info for the particles we want to identify in PID
+  // FIXME: cannot use `TDatabasePDG` since it is not thread safe; until we
+  // have a proper PDG database service, we hard-code the masses in Tools.h
+  m_log->debug("List of particles for PID:");
+  for(auto pdg : m_cfg.pdgList) {
+    auto mass = Tools::GetPDGMass(pdg);
+    m_pdg_mass.insert({ pdg, mass });
+    m_log->debug("  {:>8}  M={} GeV", pdg, mass);
+  }
+
+}
+
+CherenkovDetector* IrtCherenkovParticleID::initDetector(CherenkovDetectorCollection* irt_det_coll, std::string& det_name) const
+{
+  auto& detectors = irt_det_coll->GetDetectors();
+  if(detectors.size() == 0)
+    throw std::runtime_error("No CherenkovDetectors found in input collection `irt_det_coll`");
+  if(detectors.size() > 1)
+    m_log->warn("IrtCherenkovParticleID currently only supports 1 CherenkovDetector at a time; taking the first");
+  auto this_detector = *detectors.begin();
+  if(!det_name.empty() && det_name != this_detector.first)
+    throw std::runtime_error(fmt::format("IRT geometry of '{}' for a task of '{}'", this_detector.first, det_name));
+  det_name           = this_detector.first;
+  auto* irt_det = this_detector.second;
+
+  // the IRT geometries are lent to the instances of all the threads, which all
+  // initialize their radiators the same way; one at a time
+  static std::mutex shared_geometry_mutex;
+  std::lock_guard<std::mutex> lock(shared_geometry_mutex);
+
+  // rebin refractive index tables to have `m_cfg.numRIndexBins` bins, unless
+  // another instance did already
+  m_log->trace("Rebinning refractive index tables to have {} bins",m_cfg.numRIndexBins);
+  for(auto [rad_name,irt_rad] : irt_det->Radiators()) {
+    if(irt_rad->m_ri_lookup_table.size() == m_cfg.numRIndexBins + 1) continue;
+    auto ri_lookup_table_orig = irt_rad->m_ri_lookup_table;
+    irt_rad->m_ri_lookup_table.clear();
+    irt_rad->m_ri_lookup_table = Tools::ApplyFineBinning( ri_lookup_table_orig, m_cfg.numRIndexBins );
+    // m_log->trace("- {}", rad_name);
+    // for(auto [energy,rindex] : irt_rad->m_ri_lookup_table) m_log->trace("  {:>5} eV   {:<}", energy, rindex);
+  }
+
+  // check radiators' configuration, and pass it to `irt_det`'s radiators
+  for(auto [rad_name,irt_rad] : irt_det->Radiators()) {
+    if(rad_name=="Filter") continue;
     // find `cfg_rad`, the associated `IrtCherenkovParticleIDConfig` radiator
-    auto cfg_rad_it = m_cfg.radiators.find(rad_name);
+    auto cfg_rad_it = m_cfg.radiators.find(std::string(rad_name));
     if(cfg_rad_it != m_cfg.radiators.end()) {
       auto cfg_rad = cfg_rad_it->second;
       // pass `cfg_rad` params to `irt_rad`, the IRT radiator
@@ -103,23 +148,32 @@ void IrtCherenkovParticleID::init(
         else if(cfg_rad.smearingMode=="gaussian")
           irt_rad->SetGaussianSmearing(cfg_rad.smearing);
         else
-          m_log->error("Unknown smearing mode '{}' for {} radiator", cfg_rad.smearingMode, rad_name);
+          m_log->error("Unknown smearing mode '{}' for {} radiator", cfg_rad.smearingMode, rad_name.Data());
       }
     }
     else
-      m_log->error("Cannot find radiator '{}' in IrtCherenkovParticleIDConfig instance", rad_name);
+      m_log->error("Cannot find radiator '{}' in IrtCherenkovParticleIDConfig instance", rad_name.Data());
   }
 
-  // get PDG info for the particles we want to identify in PID
-  // FIXME: cannot use `TDatabasePDG` since it is not thread safe; until we
-  // have a proper PDG database service, we hard-code the masses in Tools.h
-  m_log->debug("List of particles for PID:");
-  for(auto pdg : m_cfg.pdgList) {
-    auto mass = Tools::GetPDGMass(pdg);
-    m_pdg_mass.insert({ pdg, mass });
-    m_log->debug("  {:>8}  M={} GeV", pdg, mass);
-  }
+  return irt_det;
+}
 
+const IrtCherenkovParticleID::IrtTask& IrtCherenkovParticleID::task(CherenkovDetectorCollection* irt_det_coll) const
+{
+  std::lock_guard<std::mutex> lock(m_tasks_mutex);
+  auto [it, inserted] = m_tasks.try_emplace(irt_det_coll);
+  if(inserted) {
+    try {
+      std::string det_name = m_det_name;
+      it->second.det = initDetector(irt_det_coll, det_name);
+      for(auto [rad_name,irt_rad] : m_pid_radiators)
+        it->second.radiators.push_back(it->second.det->GetRadiator(rad_name.c_str()));
+    } catch(...) {
+      m_tasks.erase(it);
+      throw;
+    }
+  }
+  return it->second;
 }
 
 void IrtCherenkovParticleID::process(
@@ -160,284 +214,381 @@ void IrtCherenkovParticleID::process(
     return;
   }
 
-  // loop over charged particles ********************************************
-  m_log->trace("{:#<70}","### CHARGED PARTICLES ");
-  std::size_t num_charged_particles = in_charged_particle_size_distribution.begin()->first;
-  for(long i_charged_particle=0; i_charged_particle<num_charged_particles; i_charged_particle++) {
-    m_log->trace("{:-<70}", fmt::format("--- charged particle #{} ", i_charged_particle));
-
-    // start an `irt_particle`, for `IRT`
-    auto irt_particle = std::make_unique<ChargedParticle>();
-
-    // loop over radiators
-    for(auto [rad_name,irt_rad] : m_pid_radiators) {
-
-      // get the `charged_particle` for this radiator
-      auto charged_particle_list_it = in_charged_particles.find(rad_name);
-      if(charged_particle_list_it == in_charged_particles.end()) {
-        m_log->error("Cannot find radiator '{}' in `in_charged_particles`", rad_name);
-        continue;
-      }
-      const auto *charged_particle_list = charged_particle_list_it->second;
-      auto charged_particle      = charged_particle_list->at(i_charged_particle);
-
-      // set number of bins for this radiator and charged particle
-      if(charged_particle.points_size()==0) {
-        m_log->trace("No propagated track points in radiator '{}'", rad_name);
-        continue;
-      }
-      irt_rad->SetTrajectoryBinCount(charged_particle.points_size() - 1);
-
-      // start a new IRT `RadiatorHistory`
-      // - must be a raw pointer for `irt` compatibility
-      // - it will be destroyed when `irt_particle` is destroyed
-      auto *irt_rad_history = new RadiatorHistory();
-      irt_particle->StartRadiatorHistory({ irt_rad, irt_rad_history });
-
-      // loop over `TrackPoint`s of this `charged_particle`, adding each to the IRT radiator
-      irt_rad->ResetLocations();
-      m_log->trace("TrackPoints in '{}' radiator:", rad_name);
-      for(const auto& point : charged_particle.getPoints()) {
-        TVector3 position = Tools::PodioVector3_to_TVector3(point.position);
-        TVector3 momentum = Tools::PodioVector3_to_TVector3(point.momentum);
-        irt_rad->AddLocation(position, momentum);
-        Tools::PrintTVector3(m_log, " point: x", position);
-        Tools::PrintTVector3(m_log, "        p", momentum);
-      }
-
-
-      // loop over raw hits ***************************************************
-      m_log->trace("{:#<70}","### SENSOR HITS ");
-      for(const auto& raw_hit : *in_raw_hits) {
-
-        // get MC photon(s), typically only used by cheat modes or trace logging
-        // - loop over `in_hit_assocs`, searching for the matching hit association
-        // - will not exist for noise hits
-        edm4hep::MCParticle mc_photon;
-        bool mc_photon_found = false;
-        if(m_cfg.cheatPhotonVertex || m_cfg.cheatTrueRadiator) {
-          for(const auto& hit_assoc : *in_hit_assocs) {
-            if(hit_assoc.getRawHit().isAvailable()) {
-              if(hit_assoc.getRawHit().id() == raw_hit.id()) {
-#if EDM4EIC_VERSION_MAJOR >= 6
-                mc_photon = hit_assoc.getSimHit().getMCParticle();
-#else
-                // hit association found, get the MC photon and break the loop
-                if(hit_assoc.simHits_size() > 0) {
-                  mc_photon = hit_assoc.getSimHits(0).getMCParticle();
-#endif
-                  mc_photon_found = true;
-                  if(mc_photon.getPDG() != -22)
-                    m_log->warn("non-opticalphoton hit: PDG = {}",mc_photon.getPDG());
+  // sensor hits ************************************************************
+  // the quantities of the raw hits do not depend on the charged particle, so
+  // they are computed once per event instead of per particle and radiator
+  m_log->trace("{:#<70}","### SENSOR HITS ");
+  const bool need_mc_photons = m_cfg.cheatPhotonVertex || m_cfg.cheatTrueRadiator;
+  AssociationIndex<edm4eic::MCRecoTrackerHitAssociationCollection, RawHitOf> hit_assoc_index;
+  if(need_mc_photons) {
+    hit_assoc_index.build(*in_hit_assocs);
+  }
+  std::vector<SensorHit> sensor_hits;
+  sensor_hits.reserve(in_raw_hits->size());
+  for(const auto& raw_hit : *in_raw_hits) {
+    auto& sensor_hit = sensor_hits.emplace_back();
+
+    // get MC photon(s), typically only used by cheat modes or trace logging
+    // - the first association of the hit, if any
+    // - will not exist for noise hits
+    edm4hep::MCParticle mc_photon;
+    if(need_mc_photons) {
+      if(auto i_assoc = hit_assoc_index.first(raw_hit); i_assoc.has_value()) {
+        const auto hit_assoc = (*in_hit_assocs)[*i_assoc];
 #if EDM4EIC_VERSION_MAJOR >= 6
+        mc_photon = hit_assoc.getSimHit().getMCParticle();
+        sensor_hit.mc_photon_found = true;
 #else
-                }
-                else if(m_cfg.CheatModeEnabled())
-                  m_log->error("cheat mode enabled, but no MC photons provided");
-#endif
-                break;
-              }
-            }
-          }
-        }
-
-        // cheat mode, for testing only: use MC photon to get the actual radiator
-        if(m_cfg.cheatTrueRadiator && mc_photon_found) {
-          auto vtx    = Tools::PodioVector3_to_TVector3(mc_photon.getVertex());
-          auto mc_rad = m_irt_det->GuessRadiator(vtx, vtx); // assume IP is at (0,0,0)
-          if(mc_rad != irt_rad) continue; // skip this photon, if not from radiator `irt_rad`
-          Tools::PrintTVector3(m_log, fmt::format("cheat: radiator '{}' determined from photon vertex", rad_name), vtx);
-        }
-
-        // get sensor and pixel info
-        // FIXME: signal and timing cuts (ADC, TDC, ToT, ...)
-        auto     cell_id   = raw_hit.getCellID();
-        uint64_t sensor_id = cell_id & m_cell_mask;
-        TVector3 pixel_pos = m_irt_det->m_ReadoutIDToPosition(cell_id);
-
-        // trace logging
-        if(m_log->level() <= spdlog::level::trace) {
-          m_log->trace("cell_id={:#X}  sensor_id={:#X}", cell_id, sensor_id);
-          Tools::PrintTVector3(m_log, "pixel position", pixel_pos);
-          if(mc_photon_found) {
-            TVector3 mc_endpoint = Tools::PodioVector3_to_TVector3(mc_photon.getEndpoint());
-            Tools::PrintTVector3(m_log, "photon endpoint", mc_endpoint);
-            m_log->trace("{:>30} = {}", "dist( pixel,  photon )", (pixel_pos  - mc_endpoint).Mag());
-          }
-          else m_log->trace("  no MC photon found; probably a noise hit");
-        }
-
-        // start new IRT photon
-        auto *irt_sensor = m_irt_det->m_PhotonDetectors[0]; // NOTE: assumes one sensor type
-        auto *irt_photon = new OpticalPhoton(); // new raw pointer; it will also be destroyed when `irt_particle` is destroyed
-        irt_photon->SetVolumeCopy(sensor_id);
-        irt_photon->SetDetectionPosition(pixel_pos);
-        irt_photon->SetPhotonDetector(irt_sensor);
-        irt_photon->SetDetected(true);
-
-        // cheat mode: get photon vertex info from MC truth
-        if((m_cfg.cheatPhotonVertex || m_cfg.cheatTrueRadiator) && mc_photon_found) {
-          irt_photon->SetVertexPosition(Tools::PodioVector3_to_TVector3(mc_photon.getVertex()));
-          irt_photon->SetVertexMomentum(Tools::PodioVector3_to_TVector3(mc_photon.getMomentum()));
+        if(hit_assoc.simHits_size() > 0) {
+          mc_photon = hit_assoc.getSimHits(0).getMCParticle();
+          sensor_hit.mc_photon_found = true;
         }
+        else if(m_cfg.CheatModeEnabled())
+          m_log->error("cheat mode enabled, but no MC photons provided");
+#endif
+        if(sensor_hit.mc_photon_found && mc_photon.getPDG() != -22)
+          m_log->warn("non-opticalphoton hit: PDG = {}",mc_photon.getPDG());
+      }
+    }
+    if(sensor_hit.mc_photon_found) {
+      sensor_hit.mc_vertex   = Tools::PodioVector3_to_TVector3(mc_photon.getVertex());
+      sensor_hit.mc_momentum = Tools::PodioVector3_to_TVector3(mc_photon.getMomentum());
+      sensor_hit.mc_endpoint = Tools::PodioVector3_to_TVector3(mc_photon.getEndpoint());
+    }
 
-        // cheat mode: retrieve a refractive index estimate; it is not exactly the one, which
-        // was used in GEANT, but should be very close
-        if(m_cfg.cheatPhotonVertex) {
-          double ri;
-          auto mom    = 1e9 * irt_photon->GetVertexMomentum().Mag();
-          auto ri_set = Tools::GetFinelyBinnedTableEntry(irt_rad->m_ri_lookup_table, mom, &ri);
-          if(ri_set) {
-            irt_photon->SetVertexRefractiveIndex(ri);
-            m_log->trace("{:>30} = {}", "refractive index", ri);
-          }
-          else
-            m_log->warn("Tools::GetFinelyBinnedTableEntry failed to lookup refractive index for momentum {} eV", mom);
+    // cheat mode, for testing only: use MC photon to get the actual radiator
+    if(m_cfg.cheatTrueRadiator && sensor_hit.mc_photon_found) {
+      auto *mc_rad = m_irt_det->GuessRadiator(sensor_hit.mc_vertex, sensor_hit.mc_vertex); // assume IP is at (0,0,0)
+      std::size_t i_rad = 0;
+      for(auto [rad_name,irt_rad] : m_pid_radiators) {
+        if(irt_rad == mc_rad) {
+          sensor_hit.mc_rad = i_rad;
+          break;
         }
+        i_rad++;
+      }
+      Tools::PrintTVector3(m_log, "cheat: radiator determined from photon vertex", sensor_hit.mc_vertex);
+    }
 
-        // add each `irt_photon` to the radiator history
-        // - unless cheating, we don't know which photon goes with which
-        // radiator, thus we add them all to each radiator; the radiators'
-        // photons are mixed in `ChargedParticle::PIDReconstruction`
-        irt_rad_history->AddOpticalPhoton(irt_photon);
-        /* FIXME: this considers ALL of the `irt_photon`s... we can limit this
-         * once we add the ability to get a fiducial volume for each track, i.e.,
-         * a region of sensors where we expect to see this `irt_particle`'s
-         * Cherenkov photons; this should also combat sensor noise
-         */
-      } // end `in_hit_assocs` loop
-
-    } // end radiator loop
-
-
-
-    // particle identification +++++++++++++++++++++++++++++++++++++++++++++++++++++
-
-    // define a mass hypothesis for each particle we want to check
-    m_log->trace("{:+^70}"," PARTICLE IDENTIFICATION ");
-    CherenkovPID irt_pid;
-    std::unordered_map<int,MassHypothesis*> pdg_to_hyp; // `pdg` -> hypothesis
-    for(auto [pdg,mass] : m_pdg_mass) {
-      irt_pid.AddMassHypothesis(mass);
-      pdg_to_hyp.insert({ pdg, irt_pid.GetHypothesis(irt_pid.GetHypothesesCount()-1) });
+    // get sensor and pixel info
+    // FIXME: signal and timing cuts (ADC, TDC, ToT, ...)
+    auto cell_id         = raw_hit.getCellID();
+    sensor_hit.sensor_id = cell_id & m_cell_mask;
+    sensor_hit.pixel_pos = m_irt_det->m_ReadoutIDToPosition(cell_id);
+
+    // trace logging
+    if(m_log->level() <= spdlog::level::trace) {
+      m_log->trace("cell_id={:#X}  sensor_id={:#X}", cell_id, sensor_hit.sensor_id);
+      Tools::PrintTVector3(m_log, "pixel position", sensor_hit.pixel_pos);
+      if(sensor_hit.mc_photon_found) {
+        Tools::PrintTVector3(m_log, "photon endpoint", sensor_hit.mc_endpoint);
+        m_log->trace("{:>30} = {}", "dist( pixel,  photon )", (sensor_hit.pixel_pos - sensor_hit.mc_endpoint).Mag());
+      }
+      else m_log->trace("  no MC photon found; probably a noise hit");
     }
 
-    // run IRT PID
-    irt_particle->PIDReconstruction(irt_pid);
-    m_log->trace("{:-^70}"," IRT RESULTS ");
+  }
 
-    // loop over radiators
+  // cheat mode: retrieve a refractive index estimate for each radiator; it is
+  // not exactly the one, which was used in GEANT, but should be very close;
+  // looked up for the photons of all the hits at once
+  if(m_cfg.cheatPhotonVertex) {
+    std::vector<double> moms, ris(sensor_hits.size());
+    moms.reserve(sensor_hits.size());
+    for(const auto& sensor_hit : sensor_hits)
+      moms.push_back(1e9 * (sensor_hit.mc_photon_found ? sensor_hit.mc_momentum.Mag() : 0.));
+    std::size_t i_rad = 0;
     for(auto [rad_name,irt_rad] : m_pid_radiators) {
-      m_log->trace("-> {} Radiator (ID={}):", rad_name, irt_rad->m_ID);
-
-      // Cherenkov angle (theta) estimate
-      unsigned npe        = 0;
-      double   rindex_ave = 0.0;
-      double   energy_ave = 0.0;
-      std::vector<std::pair<double,double>> phot_theta_phi;
-
-      // loop over this radiator's photons, and decide which to include in the theta estimate
-      auto *irt_rad_history = irt_particle->FindRadiatorHistory(irt_rad);
-      if(irt_rad_history==nullptr) {
-        m_log->trace("  No radiator history; skip");
-        continue;
-      }
-      m_log->trace("  Photoelectrons:");
-      for(auto *irt_photon : irt_rad_history->Photons()) {
-
-        // check whether this photon was selected by at least one mass hypothesis
-        bool photon_selected = false;
-        for(auto irt_photon_sel : irt_photon->_m_Selected) {
-          if(irt_photon_sel.second == irt_rad) {
-            photon_selected = true;
-            break;
-          }
+      m_ri_tables[i_rad++].Lookup(moms, ris);
+      for(std::size_t i_hit = 0; i_hit < sensor_hits.size(); i_hit++) {
+        if(!std::isnan(ris[i_hit])) {
+          sensor_hits[i_hit].rindex.emplace_back(ris[i_hit]);
+          m_log->trace("{:>30} = {} ({})", "refractive index", ris[i_hit], rad_name);
         }
-        if(!photon_selected) continue;
-
-        // trace logging
-        Tools::PrintTVector3(
-            m_log,
-            fmt::format("- sensor_id={:#X}: hit",irt_photon->GetVolumeCopy()),
-            irt_photon->GetDetectionPosition()
-            );
-        Tools::PrintTVector3(m_log, "photon vertex", irt_photon->GetVertexPosition());
-
-        // get this photon's theta and phi estimates
-        auto phot_theta = irt_photon->_m_PDF[irt_rad].GetAverage();
-        auto phot_phi   = irt_photon->m_Phi[irt_rad];
-
-        // add to the total
-        npe++;
-        phot_theta_phi.emplace_back( phot_theta, phot_phi );
-        if(m_cfg.cheatPhotonVertex) {
-          rindex_ave += irt_photon->GetVertexRefractiveIndex();
-          energy_ave += irt_photon->GetVertexMomentum().Mag();
+        else {
+          sensor_hits[i_hit].rindex.emplace_back(std::nullopt);
+          m_log->warn("Tools::UniformTable failed to lookup refractive index for momentum {} eV", moms[i_hit]);
         }
+      }
+    }
+  }
 
-      } // end loop over this radiator's photons
+  // the TrackSegments of each radiator of `m_pid_radiators`
+  std::vector<const edm4eic::TrackSegmentCollection*> rad_charged_particles;
+  for(auto [rad_name,irt_rad] : m_pid_radiators) {
+    auto charged_particle_list_it = in_charged_particles.find(rad_name);
+    if(charged_particle_list_it == in_charged_particles.end())
+      m_log->error("Cannot find radiator '{}' in `in_charged_particles`", rad_name);
+    rad_charged_particles.push_back(charged_particle_list_it == in_charged_particles.end() ? nullptr : charged_particle_list_it->second);
+  }
 
-      // compute averages
-      if(npe>0) {
-        rindex_ave /= npe;
-        energy_ave /= npe;
-      }
+  // reconstruct the charged particles ***************************************
+  // - contiguous blocks of charged particles, one per task, each with the IRT
+  //   geometry of its task; the first block runs on this thread
+  // - the results are filled into the output collections afterwards, in the
+  //   order of the charged particles
+  m_log->trace("{:#<70}","### CHARGED PARTICLES ");
+  std::size_t num_charged_particles = in_charged_particle_size_distribution.begin()->first;
+  std::vector<std::vector<RadiatorResult>> results(num_charged_particles);
+  // - every task borrows a geometry of its own for the event, which no other
+  //   event uses meanwhile; they are given back on every way out
+  struct Borrowed {
+    const IrtGeometryLender& lender;
+    std::vector<CherenkovDetectorCollection*> det_colls;
+    ~Borrowed() {
+      for(auto* det_coll : det_colls)
+        lender.release(det_coll);
+    }
+  } borrowed{m_lender, {}};
+  std::vector<const IrtTask*> tasks(1, &m_task);
+  if(m_lender.acquire && num_charged_particles > 0) {
+    tasks.resize(std::min<std::size_t>(std::max(1u, m_cfg.numTasks), num_charged_particles));
+    for(auto& task_ptr : tasks) {
+      borrowed.det_colls.push_back(m_lender.acquire());
+      task_ptr = &task(borrowed.det_colls.back());
+    }
+  }
+  const auto reconstruct_block = [&](std::size_t i_task, std::size_t begin, std::size_t end) {
+    for(std::size_t i_charged_particle = begin; i_charged_particle < end; i_charged_particle++)
+      reconstruct(*tasks[i_task], rad_charged_particles, i_charged_particle, sensor_hits, results[i_charged_particle]);
+  };
+  const std::size_t num_tasks = std::min(tasks.size(), num_charged_particles);
+  if(num_tasks > 1) {
+    const std::size_t block = (num_charged_particles + num_tasks - 1) / num_tasks;
+    std::vector<std::future<void>> futures;
+    for(std::size_t i_task = 1; i_task < num_tasks; i_task++) {
+      const std::size_t begin = std::min(i_task * block, num_charged_particles);
+      const std::size_t end   = std::min(begin + block, num_charged_particles);
+      futures.push_back(std::async(std::launch::async, reconstruct_block, i_task, begin, end));
+    }
+    reconstruct_block(0, 0, std::min(block, num_charged_particles));
+    for(auto& future : futures)
+      future.get();
+  }
+  else
+    reconstruct_block(0, 0, num_charged_particles);
+
+  // fill the output collections ********************************************
+  const auto *merged_charged_particles = in_charged_particles.at("Merged");
+  for(std::size_t i_charged_particle = 0; i_charged_particle < num_charged_particles; i_charged_particle++) {
+    std::size_t i_rad = 0;
+    for(auto [rad_name,irt_rad] : m_pid_radiators) {
+      const auto& result = results[i_charged_particle][i_rad++];
+      if(!result.found) continue;
 
       // fill photon info
       auto out_cherenkov_pid = out_cherenkov_pids.at(rad_name)->create();
-      out_cherenkov_pid.setNpe(static_cast<decltype(edm4eic::CherenkovParticleIDData::npe)>(npe));
-      out_cherenkov_pid.setRefractiveIndex(static_cast<decltype(edm4eic::CherenkovParticleIDData::refractiveIndex)>(rindex_ave));
-      out_cherenkov_pid.setPhotonEnergy(static_cast<decltype(edm4eic::CherenkovParticleIDData::photonEnergy)>(energy_ave));
-      for(auto [phot_theta,phot_phi] : phot_theta_phi)
+      out_cherenkov_pid.setNpe(static_cast<decltype(edm4eic::CherenkovParticleIDData::npe)>(result.npe));
+      out_cherenkov_pid.setRefractiveIndex(static_cast<decltype(edm4eic::CherenkovParticleIDData::refractiveIndex)>(result.rindex_ave));
+      out_cherenkov_pid.setPhotonEnergy(static_cast<decltype(edm4eic::CherenkovParticleIDData::photonEnergy)>(result.energy_ave));
+      for(auto [phot_theta,phot_phi] : result.phot_theta_phi)
         out_cherenkov_pid.addToThetaPhiPhotons(edm4hep::Vector2f{
             static_cast<float>(phot_theta),
             static_cast<float>(phot_phi)
             });
 
       // relate mass hypotheses
-      for(auto [pdg,mass] : m_pdg_mass) {
-
-        // get hypothesis results
-        auto *irt_hypothesis = pdg_to_hyp.at(pdg);
-        auto hyp_weight     = irt_hypothesis->GetWeight(irt_rad);
-        auto hyp_npe        = irt_hypothesis->GetNpe(irt_rad);
-
-        // fill `ParticleID` output collection
+      for(auto [pdg,hyp_weight,hyp_npe] : result.hypotheses) {
         edm4eic::CherenkovParticleIDHypothesis out_hypothesis;
         out_hypothesis.PDG    = static_cast<decltype(edm4eic::CherenkovParticleIDHypothesis::PDG)>(pdg);
         out_hypothesis.weight = static_cast<decltype(edm4eic::CherenkovParticleIDHypothesis::weight)>(hyp_weight);
         out_hypothesis.npe    = static_cast<decltype(edm4eic::CherenkovParticleIDHypothesis::npe)>(hyp_npe);
-
-        // relate
         out_cherenkov_pid.addToHypotheses(out_hypothesis);
-
-      } // end hypothesis loop
+      }
 
       // logging
+      m_log->trace("-> {} Radiator of charged particle #{}:", rad_name, i_charged_particle);
       Tools::PrintCherenkovEstimate(m_log, out_cherenkov_pid);
 
       // relate charged particle projection
-      auto charged_particle_list_it = in_charged_particles.find("Merged");
-      if(charged_particle_list_it != in_charged_particles.end()) {
-        const auto *charged_particle_list = charged_particle_list_it->second;
-        auto charged_particle      = charged_particle_list->at(i_charged_particle);
-        out_cherenkov_pid.setChargedParticle(charged_particle);
-      }
-      else
-        m_log->error("Cannot find radiator 'Merged' in `in_charged_particles`");
+      out_cherenkov_pid.setChargedParticle(merged_charged_particles->at(i_charged_particle));
 
       // relate hit associations
       for(const auto& hit_assoc : *in_hit_assocs)
         out_cherenkov_pid.addToRawHitAssociations(hit_assoc);
 
     } // end radiator loop
+  } // end `in_charged_particles` loop
+}
 
-    /* NOTE: `unique_ptr irt_particle` goes out of scope and will now be destroyed, and along with it:
-     * - raw pointer `irt_rad_history` for each radiator
-     * - all `irt_photon` raw pointers
-     */
+void IrtCherenkovParticleID::reconstruct(
+    const IrtTask& task,
+    const std::vector<const edm4eic::TrackSegmentCollection*>& rad_charged_particles,
+    std::size_t i_charged_particle,
+    const std::vector<SensorHit>& sensor_hits,
+    std::vector<RadiatorResult>& results
+    ) const
+{
+  m_log->trace("{:-<70}", fmt::format("--- charged particle #{} ", i_charged_particle));
+  results.assign(task.radiators.size(), {});
+
+  // start an `irt_particle`, for `IRT`
+  auto irt_particle = std::make_unique<ChargedParticle>();
+
+  // loop over radiators
+  std::size_t i_rad = 0;
+  for(const auto& [rad_name,pid_rad] : m_pid_radiators) {
+    const std::size_t rad_index = i_rad++;
+    auto *irt_rad = task.radiators[rad_index];
+    if(irt_rad == nullptr || rad_charged_particles[rad_index] == nullptr) continue;
+
+    // get the `charged_particle` for this radiator
+    auto charged_particle = rad_charged_particles[rad_index]->at(i_charged_particle);
+
+    // set number of bins for this radiator and charged particle
+    if(charged_particle.points_size()==0) {
+      m_log->trace("No propagated track points in radiator '{}'", rad_name);
+      continue;
+    }
+    irt_rad->SetTrajectoryBinCount(charged_particle.points_size() - 1);
+
+    // start a new IRT `RadiatorHistory`
+    // - must be a raw pointer for `irt` compatibility
+    // - it will be destroyed when `irt_particle` is destroyed
+    // - allocated from a per-thread pool, see `Pooled`
+    auto *irt_rad_history = new Pooled<RadiatorHistory>();
+    irt_particle->StartRadiatorHistory({ irt_rad, irt_rad_history });
+
+    // loop over `TrackPoint`s of this `charged_particle`, adding each to the IRT radiator
+    irt_rad->ResetLocations();
+    m_log->trace("TrackPoints in '{}' radiator:", rad_name);
+    for(const auto& point : charged_particle.getPoints()) {
+      TVector3 position = Tools::PodioVector3_to_TVector3(point.position);
+      TVector3 momentum = Tools::PodioVector3_to_TVector3(point.momentum);
+      irt_rad->AddLocation(position, momentum);
+      Tools::PrintTVector3(m_log, " point: x", position);
+      Tools::PrintTVector3(m_log, "        p", momentum);
+    }
 
-  } // end `in_charged_particles` loop
+
+    // loop over raw hits ***************************************************
+    for(const auto& sensor_hit : sensor_hits) {
+
+      // cheat mode, for testing only: use MC photon to get the actual radiator
+      if(m_cfg.cheatTrueRadiator && sensor_hit.mc_photon_found) {
+        if(sensor_hit.mc_rad != rad_index) continue; // skip this photon, if not from radiator `irt_rad`
+      }
+
+      // start new IRT photon
+      auto *irt_sensor = task.det->m_PhotonDetectors[0]; // NOTE: assumes one sensor type
+      auto *irt_photon = new Pooled<OpticalPhoton>(); // new raw pointer; it will also be destroyed when `irt_particle` is destroyed
+      irt_photon->SetVolumeCopy(sensor_hit.sensor_id);
+      irt_photon->SetDetectionPosition(sensor_hit.pixel_pos);
+      irt_photon->SetPhotonDetector(irt_sensor);
+      irt_photon->SetDetected(true);
+
+      // cheat mode: get photon vertex info from MC truth
+      if((m_cfg.cheatPhotonVertex || m_cfg.cheatTrueRadiator) && sensor_hit.mc_photon_found) {
+        irt_photon->SetVertexPosition(sensor_hit.mc_vertex);
+        irt_photon->SetVertexMomentum(sensor_hit.mc_momentum);
+      }
+
+      // cheat mode: refractive index estimate, looked up once per event
+      if(m_cfg.cheatPhotonVertex && sensor_hit.rindex[rad_index].has_value()) {
+        irt_photon->SetVertexRefractiveIndex(*sensor_hit.rindex[rad_index]);
+      }
+
+      // add each `irt_photon` to the radiator history
+      // - unless cheating, we don't know which photon goes with which
+      // radiator, thus we add them all to each radiator; the radiators'
+      // photons are mixed in `ChargedParticle::PIDReconstruction`
+      irt_rad_history->AddOpticalPhoton(irt_photon);
+      /* FIXME: this considers ALL of the `irt_photon`s... we can limit this
+       * once we add the ability to get a fiducial volume for each track, i.e.,
+       * a region of sensors where we expect to see this `irt_particle`'s
+       * Cherenkov photons; this should also combat sensor noise
+       */
+    } // end `sensor_hits` loop
+
+  } // end radiator loop
+
+
+
+  // particle identification +++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+  // define a mass hypothesis for each particle we want to check
+  m_log->trace("{:+^70}"," PARTICLE IDENTIFICATION ");
+  CherenkovPID irt_pid;
+  std::unordered_map<int,MassHypothesis*> pdg_to_hyp; // `pdg` -> hypothesis
+  for(auto [pdg,mass] : m_pdg_mass) {
+    irt_pid.AddMassHypothesis(mass);
+    pdg_to_hyp.insert({ pdg, irt_pid.GetHypothesis(irt_pid.GetHypothesesCount()-1) });
+  }
+
+  // run IRT PID
+  irt_particle->PIDReconstruction(irt_pid);
+  m_log->trace("{:-^70}"," IRT RESULTS ");
+
+  // loop over radiators
+  i_rad = 0;
+  for(const auto& [rad_name,pid_rad] : m_pid_radiators) {
+    const std::size_t rad_index = i_rad++;
+    auto *irt_rad = task.radiators[rad_index];
+    if(irt_rad == nullptr) continue;
+    auto& result  = results[rad_index];
+    m_log->trace("-> {} Radiator (ID={}):", rad_name, irt_rad->m_ID);
+
+    // loop over this radiator's photons, and decide which to include in the theta estimate
+    auto *irt_rad_history = irt_particle->FindRadiatorHistory(irt_rad);
+    if(irt_rad_history==nullptr) {
+      m_log->trace("  No radiator history; skip");
+      continue;
+    }
+    result.found = true;
+    m_log->trace("  Photoelectrons:");
+    for(auto *irt_photon : irt_rad_history->Photons()) {
+
+      // check whether this photon was selected by at least one mass hypothesis
+      bool photon_selected = false;
+      for(auto irt_photon_sel : irt_photon->_m_Selected) {
+        if(irt_photon_sel.second == irt_rad) {
+          photon_selected = true;
+          break;
+        }
+      }
+      if(!photon_selected) continue;
+
+      // trace logging
+      Tools::PrintTVector3(
+          m_log,
+          fmt::format("- sensor_id={:#X}: hit",irt_photon->GetVolumeCopy()),
+          irt_photon->GetDetectionPosition()
+          );
+      Tools::PrintTVector3(m_log, "photon vertex", irt_photon->GetVertexPosition());
+
+      // get this photon's theta and phi estimates
+      auto phot_theta = irt_photon->_m_PDF[irt_rad].GetAverage();
+      auto phot_phi   = irt_photon->m_Phi[irt_rad];
+
+      // add to the total
+      result.npe++;
+      result.phot_theta_phi.emplace_back( phot_theta, phot_phi );
+      if(m_cfg.cheatPhotonVertex) {
+        result.rindex_ave += irt_photon->GetVertexRefractiveIndex();
+        result.energy_ave += irt_photon->GetVertexMomentum().Mag();
+      }
+
+    } // end loop over this radiator's photons
+
+    // compute averages
+    if(result.npe>0) {
+      result.rindex_ave /= result.npe;
+      result.energy_ave /= result.npe;
+    }
+
+    // mass hypotheses results
+    for(auto [pdg,mass] : m_pdg_mass) {
+      auto *irt_hypothesis = pdg_to_hyp.at(pdg);
+      result.hypotheses.emplace_back(pdg, irt_hypothesis->GetWeight(irt_rad), irt_hypothesis->GetNpe(irt_rad));
+    }
+
+  } // end radiator loop
+
+  /* NOTE: `unique_ptr irt_particle` goes out of scope and will now be destroyed, and along with it:
+   * - raw pointer `irt_rad_history` for each radiator
+   * - all `irt_photon` raw pointers
+   * their memory returns to the pools of this thread and is reused by its next particle
+   */
 }
 
 } // namespace eicrecon
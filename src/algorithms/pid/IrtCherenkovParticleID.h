@@ -6,6 +6,7 @@
 #include <IRT/CherenkovDetector.h>
 #include <IRT/CherenkovDetectorCollection.h>
 #include <IRT/CherenkovRadiator.h>
+#include <TVector3.h>
 #include <algorithms/algorithm.h>
 #include <edm4eic/CherenkovParticleIDCollection.h>
 #include <edm4eic/MCRecoTrackerHitAssociationCollection.h>
@@ -13,14 +14,23 @@
 #include <edm4eic/TrackSegmentCollection.h>
 #include <spdlog/logger.h>
 #include <stdint.h>
+#include <cstddef>
+#include <functional>
+#include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 // EICrecon
 #include "IrtCherenkovParticleIDConfig.h"
+#include "Tools.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 
 namespace eicrecon {
@@ -59,20 +69,85 @@ namespace eicrecon {
                             {"outputAerogelParticleIDs", "outputGasParticleIDs"},
                             "Effectively 'zip' the input particle IDs"} {}
 
-    void init(CherenkovDetectorCollection* irt_det_coll, std::shared_ptr<spdlog::logger>& logger);
+    // lends the IRT geometries that the tasks of an event change, each to one task at a time
+    struct IrtGeometryLender {
+      std::function<CherenkovDetectorCollection*()>     acquire;
+      std::function<void(CherenkovDetectorCollection*)> release;
+    };
+
+    // - `irt_det_coll` is the IRT geometry of the detector, which is only read
+    // - every event borrows the geometries of its parallel tasks from `lender`, see
+    //   `IrtCherenkovParticleIDConfig::numTasks`; without a lender, a single task uses
+    //   `irt_det_coll`, for an instance that is the only user of it
+    void init(CherenkovDetectorCollection* irt_det_coll, std::shared_ptr<spdlog::logger>& logger,
+              IrtGeometryLender lender = {});
 
     void process(const Input&, const Output&) const;
 
   private:
 
+    // raw hit of a hit association
+    struct RawHitOf {
+      auto operator()(const edm4eic::MCRecoTrackerHitAssociation& assoc) const { return assoc.getRawHit(); }
+    };
+
+    static constexpr std::size_t no_radiator = std::numeric_limits<std::size_t>::max();
+
+    // raw hit quantities, which do not depend on the charged particle
+    struct SensorHit {
+      uint64_t           sensor_id{0};
+      TVector3           pixel_pos;
+      bool               mc_photon_found{false};
+      TVector3           mc_vertex, mc_momentum, mc_endpoint;
+      std::size_t        mc_rad{no_radiator};        // of `m_pid_radiators`, cheatTrueRadiator only
+      std::vector<std::optional<double>> rindex;     // per radiator of `m_pid_radiators`, cheatPhotonVertex only
+    };
+
+    // IRT geometry of a parallel task
+    struct IrtTask {
+      CherenkovDetector*              det{nullptr};
+      std::vector<CherenkovRadiator*> radiators; // in the order of `m_pid_radiators`
+    };
+
+    // IRT results of a charged particle in a radiator, filled into the output after the tasks
+    struct RadiatorResult {
+      bool                                  found{false};
+      unsigned                              npe{0};
+      double                                rindex_ave{0.0};
+      double                                energy_ave{0.0};
+      std::vector<std::pair<double,double>> phot_theta_phi;
+      std::vector<std::tuple<int,double,double>> hypotheses; // PDG, weight, npe
+    };
+
+    // selects the detector of `irt_det_coll`, and passes the radiator configuration to it;
+    // `det_name` is set to its name if empty, which it must match otherwise
+    CherenkovDetector* initDetector(CherenkovDetectorCollection* irt_det_coll, std::string& det_name) const;
+
+    // the task of a borrowed geometry, set up on its first use by this instance
+    const IrtTask& task(CherenkovDetectorCollection* irt_det_coll) const;
+
+    // IRT reconstruction of one charged particle, with the geometry of `task`
+    void reconstruct(
+        const IrtTask& task,
+        const std::vector<const edm4eic::TrackSegmentCollection*>& rad_charged_particles,
+        std::size_t i_charged_particle,
+        const std::vector<SensorHit>& sensor_hits,
+        std::vector<RadiatorResult>& results
+        ) const;
+
     std::shared_ptr<spdlog::logger> m_log;
     CherenkovDetectorCollection*    m_irt_det_coll;
     CherenkovDetector*              m_irt_det;
+    IrtTask                         m_task;   // of `m_irt_det`, without a lender
+    IrtGeometryLender               m_lender;
+    mutable std::mutex              m_tasks_mutex;
+    mutable std::map<CherenkovDetectorCollection*, IrtTask> m_tasks; // of the borrowed geometries
 
     uint64_t    m_cell_mask;
     std::string m_det_name;
     std::unordered_map<int,double>           m_pdg_mass;
     std::map<std::string,CherenkovRadiator*> m_pid_radiators;
+    std::vector<Tools::UniformTable>         m_ri_tables; // per radiator of `m_pid_radiators`, cheatPhotonVertex only
 
   };
 }
@@ -43,6 +43,12 @@ namespace eicrecon {
       bool cheatPhotonVertex  = false; // if true, use MC photon vertex, wavelength, and refractive index
       bool cheatTrueRadiator  = false; // if true, use MC truth to obtain true radiator, for each hit
 
+      /* charged particles reconstructed in parallel; every task after the first one needs an IRT
+       * geometry of its own, as IRT keeps the trajectory of the current particle in the radiators;
+       * the tasks of an event borrow them for the event, from geometries shared by all the threads
+       */
+      unsigned numTasks = 1;
+
       //
       /////////////////////////////////////////////////////
 
@@ -77,6 +83,7 @@ namespace eicrecon {
           m_log->log(lvl, "  {:>20} = {:<}", name, val);
         };
         print_param("numRIndexBins",numRIndexBins);
+        print_param("numTasks",numTasks);
         PrintCheats(m_log, lvl, true);
         m_log->log(lvl, "pdgList:");
         for(const auto& pdg : pdgList) m_log->log(lvl, "  {}", pdg);
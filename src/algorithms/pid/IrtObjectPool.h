@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace eicrecon {
+
+  /** Per-thread free list of fixed size blocks.
+   *
+   * Blocks are carved from chunks that are kept for the lifetime of the
+   * thread, so that after the first busy events allocating a block is a
+   * pointer swap. A block must be released by the thread that allocated it
+   * while that thread is alive, which holds for objects that only live within
+   * one call of an algorithm.
+   */
+  template <std::size_t Size, std::size_t Align>
+  class IrtBlockPool {
+  public:
+    static IrtBlockPool& instance() {
+      thread_local IrtBlockPool pool;
+      return pool;
+    }
+
+    void* allocate() {
+      if (m_free == nullptr) {
+        grow();
+      }
+      Block* block = m_free;
+      m_free       = block->next;
+      return block;
+    }
+
+    void deallocate(void* ptr) {
+      auto* block = static_cast<Block*>(ptr);
+      block->next = m_free;
+      m_free      = block;
+    }
+
+  private:
+    union Block {
+      Block* next;
+      alignas(Align) std::byte storage[Size];
+    };
+
+    static constexpr std::size_t blocks_per_chunk = 512;
+
+    void grow() {
+      auto& chunk = m_chunks.emplace_back(std::make_unique<Block[]>(blocks_per_chunk));
+      for (std::size_t i = 0; i < blocks_per_chunk; ++i) {
+        deallocate(&chunk[i]);
+      }
+    }
+
+    Block* m_free{nullptr};
+    std::vector<std::unique_ptr<Block[]>> m_chunks;
+  };
+
+  /** IRT object allocated from a per-thread pool.
+   *
+   * IRT takes ownership of the objects it is given and deletes them through
+   * a pointer to the base class, e.g. the `OpticalPhoton`s of a
+   * `RadiatorHistory` when the `ChargedParticle` is destroyed. As the IRT
+   * classes have virtual destructors, that `delete` calls the deallocation
+   * function of the dynamic type, so `new Pooled<OpticalPhoton>()` can be
+   * handed to IRT like `new OpticalPhoton()` and still returns to the pool.
+   */
+  template <typename T>
+  class Pooled final : public T {
+    static_assert(std::has_virtual_destructor_v<T>,
+                  "Pooled objects deleted through the base class need a virtual destructor");
+
+  public:
+    using T::T;
+
+    static void* operator new(std::size_t size) {
+      if (size != sizeof(Pooled)) {
+        return ::operator new(size);
+      }
+      return pool().allocate();
+    }
+
+    static void operator delete(void* ptr, std::size_t size) {
+      if (ptr == nullptr) {
+        return;
+      }
+      if (size != sizeof(Pooled)) {
+        ::operator delete(ptr);
+        return;
+      }
+      pool().deallocate(ptr);
+    }
+
+  private:
+    static auto& pool() { return IrtBlockPool<sizeof(Pooled), alignof(Pooled)>::instance(); }
+  };
+
+} // namespace eicrecon
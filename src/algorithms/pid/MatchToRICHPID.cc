@@ -14,9 +14,9 @@
 #include <cmath>
 #include <cstddef>
 #include <gsl/pointers>
-#include <map>
 #include <vector>
 
+#include "algorithms/interfaces/AssociationIndex.h"
 #include "algorithms/pid/ConvertParticleID.h"
 #include "algorithms/pid/MatchToRICHPIDConfig.h"
 
@@ -32,24 +32,64 @@ namespace eicrecon {
         const auto [parts_in, assocs_in, drich_cherenkov_pid] = input;
         auto [parts_out, assocs_out, pids]                     = output;
 
+        // index the input CherenkovParticleID objects by the momentum direction
+        // of their charged particle, sorted in eta
+        std::vector<PIDDirection> in_pid_directions;
+        in_pid_directions.reserve(drich_cherenkov_pid->size());
+        bool in_pids_valid = true;
+        for (std::size_t in_pid_idx = 0; in_pid_idx < drich_cherenkov_pid->size(); in_pid_idx++) {
+            auto in_pid = drich_cherenkov_pid->at(in_pid_idx);
+
+            // get charged particle track associated to this CherenkovParticleID object
+            auto in_track = in_pid.getChargedParticle();
+            if (!in_track.isAvailable()) {
+                error("found CherenkovParticleID object with no chargedParticle");
+                in_pids_valid = false;
+                break;
+            }
+            if (in_track.points_size() == 0) {
+                error("found chargedParticle for CherenkovParticleID, but it has no TrackPoints");
+                in_pids_valid = false;
+                break;
+            }
+
+            // get averge momentum direction of the track's TrackPoints
+            decltype(edm4eic::TrackPoint::momentum) in_track_p{0.0, 0.0, 0.0};
+            for (const auto& in_track_point : in_track.getPoints())
+                in_track_p = in_track_p + ( in_track_point.momentum / in_track.points_size() );
+            in_pid_directions.push_back(PIDDirection{
+                    edm4hep::utils::eta(in_track_p),
+                    edm4hep::utils::angleAzimuthal(in_track_p),
+                    in_pid_idx
+                    });
+        }
+        // no particle can be matched if any CherenkovParticleID object is invalid
+        if (!in_pids_valid)
+            in_pid_directions.clear();
+        std::sort(
+                in_pid_directions.begin(),
+                in_pid_directions.end(),
+                [] (const PIDDirection& a, const PIDDirection& b) { return a.eta < b.eta; }
+                );
+
+        const AssociationIndex<edm4eic::MCRecoParticleAssociationCollection> assoc_index{*assocs_in};
+
         for (auto part_in : *parts_in) {
             auto part_out = part_in.clone();
 
             // link Cherenkov PID objects
-            auto success = linkCherenkovPID(part_out, *drich_cherenkov_pid, *pids);
+            auto success = linkCherenkovPID(part_out, *drich_cherenkov_pid, in_pid_directions, *pids);
             if (success)
                 trace("Previous PDG vs. CherenkovPID PDG: {:>10} vs. {:<10}",
                         part_in.getPDG(),
                         part_out.getParticleIDUsed().isAvailable() ? part_out.getParticleIDUsed().getPDG() : 0
                         );
 
-            for (auto assoc_in : *assocs_in) {
-              if (assoc_in.getRec() == part_in) {
+            assoc_index.forEach(part_in, [&](const auto& assoc_in) {
                 auto assoc_out = assoc_in.clone();
                 assoc_out.setRec(part_out);
                 assocs_out->push_back(assoc_out);
-              }
-            }
+            });
 
             parts_out->push_back(part_out);
         }
@@ -58,7 +98,8 @@ namespace eicrecon {
 
     /* link PID objects to input particle
      * - finds `CherenkovParticleID` object in `in_pids` associated to particle `in_part`
-     *   by proximity matching to the associated track
+     *   by proximity matching to the associated track, whose directions are
+     *   `in_pid_directions` sorted in eta
      * - converts this `CherenkovParticleID` object's PID hypotheses to `ParticleID` objects,
      *   relates them to `in_part`, and adds them to the collection `out_pids` for persistency
      * - returns `true` iff PID objects were found and linked
@@ -66,6 +107,7 @@ namespace eicrecon {
     bool MatchToRICHPID::linkCherenkovPID(
             edm4eic::MutableReconstructedParticle& in_part,
             const edm4eic::CherenkovParticleIDCollection& in_pids,
+            const std::vector<PIDDirection>& in_pid_directions,
             edm4hep::ParticleIDCollection& out_pids
             ) const
     {
@@ -90,27 +132,16 @@ namespace eicrecon {
                 in_part_phi * 180.0 / M_PI
                 );
 
-        // loop over input CherenkovParticleID objects
-        for (std::size_t in_pid_idx = 0; in_pid_idx < in_pids.size(); in_pid_idx++) {
-            auto in_pid = in_pids.at(in_pid_idx);
-
-            // get charged particle track associated to this CherenkovParticleID object
-            auto in_track = in_pid.getChargedParticle();
-            if (!in_track.isAvailable()) {
-                error("found CherenkovParticleID object with no chargedParticle");
-                return false;
-            }
-            if (in_track.points_size() == 0) {
-                error("found chargedParticle for CherenkovParticleID, but it has no TrackPoints");
-                return false;
-            }
-
-            // get averge momentum direction of the track's TrackPoints
-            decltype(edm4eic::TrackPoint::momentum) in_track_p{0.0, 0.0, 0.0};
-            for (const auto& in_track_point : in_track.getPoints())
-                in_track_p = in_track_p + ( in_track_point.momentum / in_track.points_size() );
-            auto in_track_eta = edm4hep::utils::eta(in_track_p);
-            auto in_track_phi = edm4hep::utils::angleAzimuthal(in_track_p);
+        // loop over input CherenkovParticleID objects within the eta tolerance
+        auto in_pid_direction = std::lower_bound(
+                in_pid_directions.begin(),
+                in_pid_directions.end(),
+                in_part_eta - m_cfg.etaTolerance,
+                [] (const PIDDirection& a, double eta) { return a.eta <= eta; }
+                );
+        for (; in_pid_direction != in_pid_directions.end() && in_pid_direction->eta < in_part_eta + m_cfg.etaTolerance; ++in_pid_direction) {
+            auto in_track_eta = in_pid_direction->eta;
+            auto in_track_phi = in_pid_direction->phi;
 
             // calculate dist(eta,phi)
             auto match_dist = std::hypot(
@@ -123,7 +154,7 @@ namespace eicrecon {
                 std::abs(in_part_eta - in_track_eta) < m_cfg.etaTolerance &&
                 std::abs(in_part_phi - in_track_phi) < m_cfg.phiTolerance;
             if (match_is_close)
-                prox_match_list.push_back(ProxMatch{match_dist, in_pid_idx});
+                prox_match_list.push_back(ProxMatch{match_dist, in_pid_direction->pid_idx});
 
             // logging
             trace("  - (eta,phi) = ( {:>5.4}, {:>5.4} deg ),  match_dist = {:<5.4}{}",
@@ -145,7 +176,10 @@ namespace eicrecon {
         auto closest_prox_match = *std::min_element(
                 prox_match_list.begin(),
                 prox_match_list.end(),
-                [] (ProxMatch a, ProxMatch b) { return a.match_dist < b.match_dist; }
+                [] (ProxMatch a, ProxMatch b) {
+                    // ties go to the first CherenkovParticleID object in the collection
+                    return a.match_dist < b.match_dist || (a.match_dist == b.match_dist && a.pid_idx < b.pid_idx);
+                }
                 );
         auto in_pid_matched = in_pids.at(closest_prox_match.pid_idx);
         trace("  => best match: match_dist = {:<5.4} at idx = {}",
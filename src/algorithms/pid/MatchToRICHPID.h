@@ -9,8 +9,10 @@
 #include <edm4eic/MCRecoParticleAssociationCollection.h>
 #include <edm4eic/ReconstructedParticleCollection.h>
 #include <edm4hep/ParticleIDCollection.h>
+#include <cstddef>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "MatchToRICHPIDConfig.h"
 #include "algorithms/interfaces/WithPodConfig.h"
@@ -34,9 +36,17 @@ public:
 
 private:
 
+    // momentum direction of the charged particle of a `CherenkovParticleID`
+    struct PIDDirection {
+        double      eta;
+        double      phi;
+        std::size_t pid_idx;
+    };
+
     bool linkCherenkovPID(
             edm4eic::MutableReconstructedParticle& in_part,
             const edm4eic::CherenkovParticleIDCollection& in_pids,
+            const std::vector<PIDDirection>& in_pid_directions,
             edm4hep::ParticleIDCollection& out_pids
             ) const;
 };
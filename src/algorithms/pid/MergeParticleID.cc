@@ -11,10 +11,13 @@
 #include <podio/RelationRange.h>
 #include <spdlog/common.h>
 #include <stddef.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
 #include <stdexcept>
-#include <unordered_map>
-#include <utility>
+#include <vector>
 
+#include "algorithms/interfaces/EventArena.h"
 #include "algorithms/pid/MergeParticleIDConfig.h"
 #include "algorithms/pid/Tools.h"
 
@@ -58,15 +61,26 @@ void MergeParticleID::process(
    *      1. gas PID for charged particle B
    *      2. gas PID for charged particle C  // outside aerogel acceptance, but within gas acceptance
    *
-   * - OUTPUT std::unordered_map: `particle_pids` (integer => std::vector<pair of integers>)
-   *   - ID of charged particle A => { (0, 0), (1, 0) }
-   *   - ID of charged particle B => { (0, 1), (1, 1) }
-   *   - ID of charged particle C => { (1, 2) }
+   * - OUTPUT `particle_pids`, sorted by charged particle ID (ID => pair of integers)
+   *   - ID of charged particle A => (0, 0)
+   *   - ID of charged particle A => (1, 0)
+   *   - ID of charged particle B => (0, 1)
+   *   - ID of charged particle B => (1, 1)
+   *   - ID of charged particle C => (1, 2)
    */
 
   // fill `particle_pids`
   // -------------------------------------------------------------------------------
-  std::unordered_map< decltype(podio::ObjectID::index), std::vector<std::pair<size_t,size_t>> > particle_pids;
+  struct ParticlePID {
+    std::uint64_t id_particle; // collection ID and index of the charged particle
+    std::size_t   idx_coll;
+    std::size_t   idx_pid;
+  };
+  std::pmr::vector<ParticlePID> particle_pids{EventArena::resource()};
+  std::size_t n_pids = 0;
+  for(const auto& in_pid_collection : in_pid_collections_list)
+    n_pids += in_pid_collection->size();
+  particle_pids.reserve(n_pids);
   m_log->trace("{:-<70}","Build `particle_pids` indexing data structure ");
 
   // loop over list of PID collections
@@ -83,27 +97,22 @@ void MergeParticleID::process(
         m_log->error("PID object found with no charged particle");
         continue;
       }
-      auto id_particle = charged_particle_track_segment.getObjectID().index;
-      auto idx_paired  = std::make_pair(idx_coll, idx_pid);
-      m_log->trace("  idx_pid={}  id_particle={}", idx_pid, id_particle);
-
-      // insert in `particle_pids`
-      auto it = particle_pids.find(id_particle);
-      if(it == particle_pids.end())
-        particle_pids.insert({id_particle, {idx_paired}});
-      else
-        it->second.push_back(idx_paired);
+      const auto object_id   = charged_particle_track_segment.getObjectID();
+      const auto id_particle = (static_cast<std::uint64_t>(object_id.collectionID) << 32) | static_cast<std::uint32_t>(object_id.index);
+      m_log->trace("  idx_pid={}  id_particle={}", idx_pid, object_id.index);
+      particle_pids.push_back({id_particle, idx_coll, idx_pid});
     }
   }
 
+  // group by charged particle, keeping the order of the collections within each group
+  std::stable_sort(particle_pids.begin(), particle_pids.end(),
+      [] (const ParticlePID& a, const ParticlePID& b) { return a.id_particle < b.id_particle; });
+
   // trace logging
   if(m_log->level() <= spdlog::level::trace) {
     m_log->trace("{:-<70}","Resulting `particle_pids` ");
-    for(auto& [id_particle, idx_paired_list] : particle_pids) {
-      m_log->trace("id_particle={}", id_particle);
-      for(auto& [idx_coll, idx_pid] : idx_paired_list)
-        m_log->trace("  (idx_coll, idx_pid) = ({}, {})", idx_coll, idx_pid);
-    }
+    for(const auto& [id_particle, idx_coll, idx_pid] : particle_pids)
+      m_log->trace("id_particle={}  (idx_coll, idx_pid) = ({}, {})", static_cast<std::uint32_t>(id_particle), idx_coll, idx_pid);
   }
 
   // --------------------------------------------------------------------------------
@@ -112,11 +121,18 @@ void MergeParticleID::process(
   // loop over charged particles, combine weights from the associated `CherenkovParticleID` objects
   // and create a merged output `CherenkovParticleID` object
   m_log->trace("{:-<70}","Begin Merging PID Objects ");
-  for(auto& [id_particle, idx_paired_list] : particle_pids) {
+
+  // merged output hypotheses of a charged particle; there are only a handful of
+  // PDG hypotheses, so they are searched linearly, and the storage is reused
+  std::vector<edm4eic::CherenkovParticleIDHypothesis> out_hyps;
+
+  for(auto group_begin = particle_pids.begin(); group_begin != particle_pids.end(); ) {
+    auto group_end = std::find_if(group_begin, particle_pids.end(),
+        [id = group_begin->id_particle] (const ParticlePID& p) { return p.id_particle != id; });
 
     // trace logging
     m_log->trace("Charged Particle:");
-    m_log->trace("  id = {}", id_particle);
+    m_log->trace("  id = {}", static_cast<std::uint32_t>(group_begin->id_particle));
     m_log->trace("  PID Hypotheses:");
 
     // create mutable output `CherenkovParticleID` object `out_pid`
@@ -124,13 +140,13 @@ void MergeParticleID::process(
     decltype(edm4eic::CherenkovParticleIDData::npe)             out_npe             = 0.0;
     decltype(edm4eic::CherenkovParticleIDData::refractiveIndex) out_refractiveIndex = 0.0;
     decltype(edm4eic::CherenkovParticleIDData::photonEnergy)    out_photonEnergy    = 0.0;
-
-    // define `pdg_2_out_hyp`: map of PDG => merged output hypothesis
-    std::unordered_map< decltype(edm4eic::CherenkovParticleIDHypothesis::PDG), edm4eic::CherenkovParticleIDHypothesis > pdg_2_out_hyp;
+    out_hyps.clear();
 
     // merge each input `CherenkovParticleID` objects associated with this charged particle
-    for(auto& [idx_coll, idx_pid] : idx_paired_list) {
-      const auto& in_pid = in_pid_collections_list.at(idx_coll)->at(idx_pid);
+    for(auto it = group_begin; it != group_end; ++it) {
+      const auto idx_coll = it->idx_coll;
+      const auto idx_pid  = it->idx_pid;
+      const auto& in_pid  = in_pid_collections_list.at(idx_coll)->at(idx_pid);
 
       // logging
       m_log->trace("    Hypotheses for PID result (idx_coll, idx_pid) = ({}, {}):", idx_coll, idx_pid);
@@ -152,16 +168,17 @@ void MergeParticleID::process(
       // merge PDG hypotheses, combining their weights and other members
       for(auto in_hyp : in_pid.getHypotheses()) {
         Tools::PrintHypothesisTableLine(m_log,in_hyp,6);
-        auto out_hyp_it = pdg_2_out_hyp.find(in_hyp.PDG);
-        if(out_hyp_it == pdg_2_out_hyp.end()) {
+        auto out_hyp_it = std::find_if(out_hyps.begin(), out_hyps.end(),
+            [pdg = in_hyp.PDG] (const auto& out_hyp) { return out_hyp.PDG == pdg; });
+        if(out_hyp_it == out_hyps.end()) {
           edm4eic::CherenkovParticleIDHypothesis out_hyp;
           out_hyp.PDG    = in_hyp.PDG; // FIXME: no copy constructor?
           out_hyp.npe    = in_hyp.npe;
           out_hyp.weight = in_hyp.weight;
-          pdg_2_out_hyp.insert({out_hyp.PDG,out_hyp});
+          out_hyps.push_back(out_hyp);
         }
         else {
-          auto& out_hyp = out_hyp_it->second;
+          auto& out_hyp = *out_hyp_it;
           out_hyp.npe += in_hyp.npe;
           // combine hypotheses' weights
           switch(m_cfg.mergeMode) {
@@ -187,7 +204,7 @@ void MergeParticleID::process(
     }
 
     // append hypotheses
-    for(auto [pdg,out_hyp] : pdg_2_out_hyp)
+    for(const auto& out_hyp : out_hyps)
       out_pid.addToHypotheses(out_hyp);
 
     // logging: print merged hypothesis table
@@ -196,6 +213,7 @@ void MergeParticleID::process(
     for(auto out_hyp : out_pid.getHypotheses())
       Tools::PrintHypothesisTableLine(m_log,out_hyp,6);
 
+    group_begin = group_end;
   } // end `particle_pids` loop over charged particles
 }
 
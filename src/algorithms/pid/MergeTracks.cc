@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <edm4eic/TrackPoint.h>
+#include <edm4eic/TrackSegment.h>
 #include <fmt/core.h>
 #include <fmt/format.h>
 #include <gsl/pointers>
@@ -13,6 +14,7 @@
 #include <podio/RelationRange.h>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace eicrecon {
 
@@ -40,28 +42,54 @@ void MergeTracks::process(const MergeTracks::Input& input,
     return;
   }
 
+  // the points of a track in every input collection, reused for all the tracks
+  using PointIterator = decltype(std::declval<const edm4eic::TrackSegment&>().getPoints().begin());
+  std::vector<std::pair<PointIterator, PointIterator>> point_ranges;
+  point_ranges.reserve(in_track_collections.size());
+  // only for tracks with points out of time order
+  std::vector<edm4eic::TrackPoint> out_track_points;
+  const auto by_time = [](const edm4eic::TrackPoint& a, const edm4eic::TrackPoint& b) { return a.time < b.time; };
+
   // loop over track collection elements
   std::size_t n_tracks = in_track_collection_size_distribution.begin()->first;
   for (std::size_t i_track = 0; i_track < n_tracks; i_track++) {
 
-    // create a new output track, and a local container to hold its track points
+    // create a new output track
     auto out_track = out_tracks->create();
-    std::vector<edm4eic::TrackPoint> out_track_points;
 
-    // loop over collections for this track, and add each track's points to `out_track_points`
+    // loop over collections for this track, the points of a radiator are usually already in time order
+    point_ranges.clear();
+    bool time_ordered = true;
     for (const auto& in_track_collection : in_track_collections) {
-      const auto& in_track = in_track_collection->at(i_track);
-      for (const auto& point : in_track.getPoints())
-        out_track_points.push_back(point);
+      const auto points = (*in_track_collection)[i_track].getPoints();
+      point_ranges.emplace_back(points.begin(), points.end());
+      time_ordered = time_ordered && std::is_sorted(points.begin(), points.end(), by_time);
     }
 
-    // sort all `out_track_points` by time
-    std::sort(out_track_points.begin(), out_track_points.end(),
-              [](edm4eic::TrackPoint& a, edm4eic::TrackPoint& b) { return a.time < b.time; });
-
-    // add these sorted points to `out_track`
-    for (const auto& point : out_track_points)
-      out_track.addToPoints(point);
+    if (time_ordered) {
+      // k-way merge by time into `out_track`, with one range per collection
+      while (true) {
+        auto next = point_ranges.end();
+        for (auto range = point_ranges.begin(); range != point_ranges.end(); ++range) {
+          if (range->first != range->second &&
+              (next == point_ranges.end() || by_time(*range->first, *next->first))) {
+            next = range;
+          }
+        }
+        if (next == point_ranges.end())
+          break;
+        out_track.addToPoints(*next->first);
+        ++next->first;
+      }
+    } else {
+      // sort all the points by time, then add them to `out_track`
+      out_track_points.clear();
+      for (const auto& [begin, end] : point_ranges)
+        out_track_points.insert(out_track_points.end(), begin, end);
+      std::stable_sort(out_track_points.begin(), out_track_points.end(), by_time);
+      for (const auto& point : out_track_points)
+        out_track.addToPoints(point);
+    }
 
     /* FIXME: merge other members, such as `length` and `lengthError`;
      * currently not needed for RICH tracks, so such members are left as default
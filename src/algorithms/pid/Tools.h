@@ -8,8 +8,15 @@
 #pragma once
 
 // general
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
 #include <map>
 #include <math.h>
+#include <span>
+#include <utility>
+#include <vector>
 #include <spdlog/spdlog.h>
 
 // ROOT
@@ -167,6 +174,63 @@ namespace eicrecon {
         return true;
       }
 
+      // Table with equidistant entries in the first column, for lookups with one index
+      // and one linear interpolation; made by `GetUniformTable`
+      struct UniformTable {
+        double from{0};
+        double step{0};
+        std::vector<double> values;
+
+        // Sets `entry` to the value interpolated at `argument`; returns true if it is in range
+        bool Lookup(double argument, double *entry) const {
+          if (values.size() < 2 || !(step > 0)) return false;
+          const double x = (argument - from) / step;
+          const auto last = values.size() - 1;
+          if (!(x >= 0 && x <= last)) return false;
+          const auto ibin = std::min(static_cast<std::size_t>(x), last - 1);
+          const double t = x - ibin;
+          *entry = values[ibin] + t * (values[ibin+1] - values[ibin]);
+          return true;
+        }
+
+        // Sets `entries[i]` to the value at `arguments[i]`, NaN if out of range
+        void Lookup(std::span<const double> arguments, std::span<double> entries) const {
+          for (std::size_t i = 0; i < arguments.size() && i < entries.size(); ++i)
+            if (!Lookup(arguments[i], &entries[i]))
+              entries[i] = std::numeric_limits<double>::quiet_NaN();
+        }
+      };
+
+      // Resample input table `input` at `nbins+1` equidistant arguments, by linear interpolation;
+      // returns an empty table if there are less than 2 entries or 2 bins
+      static UniformTable GetUniformTable(
+          const std::vector<std::pair<double,double>> &input,
+          unsigned nbins
+          )
+      {
+        UniformTable ret;
+
+        std::map<double, double> buffer;
+        for(auto entry: input)
+          buffer[entry.first] = entry.second;
+        if (buffer.size() < 2 || nbins < 2) return ret;
+
+        ret.from = buffer.begin()->first;
+        ret.step = (buffer.rbegin()->first - ret.from) / nbins;
+        ret.values.reserve(nbins+1);
+
+        auto upper = std::next(buffer.begin());
+        for(unsigned i = 0; i <= nbins; i++) {
+          const double e = (i == nbins) ? buffer.rbegin()->first : ret.from + i * ret.step;
+          while (std::next(upper) != buffer.end() && upper->first < e)
+            ++upper;
+          const auto lower = std::prev(upper);
+          const double a = (upper->second - lower->second) / (upper->first - lower->first);
+          ret.values.push_back(lower->second + a * (e - lower->first));
+        }
+        return ret;
+      }
+
       // -------------------------------------------------------------------------------------
       // convert PODIO vector datatype to ROOT TVector3
       template<class PodioVector3>
@@ -5,126 +5,190 @@
 #include <edm4eic/MCRecoParticleAssociationCollection.h>
 #include <edm4eic/ReconstructedParticleCollection.h>
 #include <edm4hep/MCParticleCollection.h>
+#include <edm4hep/ParticleID.h>
 #include <edm4hep/utils/vector_utils.h>
 #include <fmt/core.h>
 #include <podio/ObjectID.h>
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <gsl/pointers>
+#include <optional>
+#include <span>
 #include <stdexcept>
+#include <vector>
 
+#include "algorithms/interfaces/AssociationIndex.h"
 #include "algorithms/pid_lut/PIDLookup.h"
 #include "algorithms/pid_lut/PIDLookupConfig.h"
 #include "services/pid_lut/PIDLookupTableSvc.h"
 
 namespace eicrecon {
 
+PIDLookupTable::Binning PIDLookup::binning(const PIDLookupConfig& cfg) {
+  return {
+    .pdg_values=cfg.pdg_values,
+    .charge_values=cfg.charge_values,
+    .momentum_edges=cfg.momentum_edges,
+    .polar_edges=cfg.polar_edges,
+    .azimuthal_binning=cfg.azimuthal_binning,
+    .azimuthal_bin_centers_in_lut=cfg.azimuthal_bin_centers_in_lut,
+    .momentum_bin_centers_in_lut=cfg.momentum_bin_centers_in_lut,
+    .polar_bin_centers_in_lut=cfg.polar_bin_centers_in_lut,
+    .use_radians=cfg.use_radians,
+    .missing_electron_prob=cfg.missing_electron_prob,
+  };
+}
+
 void PIDLookup::init() {
   auto& serviceSvc = algorithms::ServiceSvc::instance();
   auto lut_svc = serviceSvc.service<PIDLookupTableSvc>("PIDLookupTableSvc");
 
-  m_lut = lut_svc->load(m_cfg.filename, {
-    .pdg_values=m_cfg.pdg_values,
-    .charge_values=m_cfg.charge_values,
-    .momentum_edges=m_cfg.momentum_edges,
-    .polar_edges=m_cfg.polar_edges,
-    .azimuthal_binning=m_cfg.azimuthal_binning,
-    .azimuthal_bin_centers_in_lut=m_cfg.azimuthal_bin_centers_in_lut,
-    .momentum_bin_centers_in_lut=m_cfg.momentum_bin_centers_in_lut,
-    .polar_bin_centers_in_lut=m_cfg.polar_bin_centers_in_lut,
-    .use_radians=m_cfg.use_radians,
-    .missing_electron_prob=m_cfg.missing_electron_prob,
-  });
+  // waits for the table if it is being preloaded
+  m_lut = lut_svc->load(m_cfg.filename, binning(m_cfg));
   if (m_lut == nullptr) {
     throw std::runtime_error("LUT not available");
   }
 }
 
 void PIDLookup::process(const Input& input, const Output& output) const {
-  const auto [recoparts_in, partassocs_in]          = input;
-  auto [recoparts_out, partassocs_out, partids_out] = output;
+  process(std::span<const Input>(&input, 1), std::span<const Output>(&output, 1));
+}
+
+void PIDLookup::process(std::span<const Input> inputs, std::span<const Output> outputs) const {
+  constexpr std::size_t no_query = static_cast<std::size_t>(-1);
+
+  // Associations of each reconstructed particle, per event
+  std::vector<AssociationIndex<edm4eic::MCRecoParticleAssociationCollection>> assoc_indices;
+  assoc_indices.reserve(inputs.size());
+
+  // Look up the table for all the associated particles of all the events at once
+  std::vector<PIDLookupTable::Query> queries;
+  std::vector<std::vector<std::size_t>> query_of_particle(inputs.size());
+  for (std::size_t event = 0; event < inputs.size(); ++event) {
+    const auto [recoparts_in, partassocs_in] = inputs[event];
+    const auto& assoc_index = assoc_indices.emplace_back(*partassocs_in);
+    query_of_particle[event].assign(recoparts_in->size(), no_query);
+    for (std::size_t i = 0; i < recoparts_in->size(); ++i) {
+      const auto recopart = (*recoparts_in)[i];
+      edm4hep::MCParticle mcpart;
+      assoc_index.forEach(recopart, [&mcpart](const auto& assoc_in) { mcpart = assoc_in.getSim(); });
+      if (!mcpart.isAvailable()) {
+        continue;
+      }
+      query_of_particle[event][i] = queries.size();
+      queries.push_back({
+        .pdg = mcpart.getPDG(),
+        .charge = static_cast<int>(mcpart.getCharge()),
+        .momentum = edm4hep::utils::magnitude(recopart.getMomentum()),
+        .theta_deg = edm4hep::utils::anglePolar(recopart.getMomentum()) / M_PI * 180.,
+        .phi_deg = edm4hep::utils::angleAzimuthal(recopart.getMomentum()) / M_PI * 180.,
+      });
+    }
+  }
+  std::vector<std::optional<PIDLookupTable::Entry>> entries(queries.size());
+  m_lut->Lookup(queries, entries);
+
+  // the events in order, so that the random numbers are drawn as for one event at a time
+  for (std::size_t event = 0; event < inputs.size(); ++event) {
+    const auto [recoparts_in, partassocs_in]          = inputs[event];
+    auto [recoparts_out, partassocs_out, partids_out] = outputs[event];
+    fill(*recoparts_in, assoc_indices[event], query_of_particle[event], queries, entries,
+         *recoparts_out, partassocs_out, *partids_out);
+  }
+}
 
-  for (const auto& recopart_without_pid : *recoparts_in) {
+void PIDLookup::fill(const edm4eic::ReconstructedParticleCollection& recoparts_in,
+                     const AssociationIndex<edm4eic::MCRecoParticleAssociationCollection>& assoc_index,
+                     std::span<const std::size_t> query_of_particle,
+                     std::span<const PIDLookupTable::Query> queries,
+                     std::span<const std::optional<PIDLookupTable::Entry>> entries,
+                     edm4eic::ReconstructedParticleCollection& recoparts_out,
+                     edm4eic::MCRecoParticleAssociationCollection* partassocs_out,
+                     edm4hep::ParticleIDCollection& partids_out) const {
+  for (std::size_t i = 0; i < recoparts_in.size(); ++i) {
+    const auto recopart_without_pid = recoparts_in[i];
     edm4hep::MCParticle mcpart;
     auto recopart = recopart_without_pid.clone();
 
     // Find MCParticle from associations and propagate the relevant ones further
     bool assoc_found = false;
-    for (auto assoc_in : *partassocs_in) {
-      if (assoc_in.getRec() == recopart_without_pid) {
-        if (assoc_found) {
-          warning("Found a duplicate association for ReconstructedParticle at index {}", recopart_without_pid.getObjectID().index);
-          warning("The previous MCParticle was at {} and the duplicate is at {}", mcpart.getObjectID().index, assoc_in.getSim().getObjectID().index);
-        }
-        assoc_found    = true;
-        mcpart         = assoc_in.getSim();
+    assoc_index.forEach(recopart_without_pid, [&](const auto& assoc_in) {
+      if (assoc_found) {
+        warning("Found a duplicate association for ReconstructedParticle at index {}", recopart_without_pid.getObjectID().index);
+        warning("The previous MCParticle was at {} and the duplicate is at {}", mcpart.getObjectID().index, assoc_in.getSim().getObjectID().index);
+      }
+      assoc_found    = true;
+      mcpart         = assoc_in.getSim();
+      if (partassocs_out != nullptr) {
         auto assoc_out = assoc_in.clone();
         assoc_out.setRec(recopart);
         partassocs_out->push_back(assoc_out);
       }
-    }
-    if (not assoc_found) {
-      recoparts_out->push_back(recopart);
+    });
+    if (not assoc_found || query_of_particle[i] >= queries.size()) {
+      recoparts_out.push_back(recopart);
       continue;
     }
 
-    int true_pdg    = mcpart.getPDG();
-    int true_charge = mcpart.getCharge();
-    int charge      = recopart.getCharge();
-    double momentum = edm4hep::utils::magnitude(recopart.getMomentum());
-
-    double theta = edm4hep::utils::anglePolar(recopart.getMomentum()) / M_PI * 180.;
-    double phi   = edm4hep::utils::angleAzimuthal(recopart.getMomentum()) / M_PI * 180.;
-
+    const auto& query = queries[query_of_particle[i]];
+    int charge = recopart.getCharge();
     trace("lookup for true_pdg={}, true_charge={}, momentum={:.2f} GeV, polar={:.2f}, aziumthal={:.2f}",
-      true_pdg, true_charge, momentum, theta, phi);
-    auto entry = m_lut->Lookup(true_pdg, true_charge, momentum, theta, phi);
+      query.pdg, query.charge, query.momentum, query.theta_deg, query.phi_deg);
+    const auto& entry = entries[query_of_particle[i]];
 
     int identified_pdg = 0; // unknown
 
-    if ((entry != nullptr) && ((entry->prob_electron != 0.) || (entry->prob_pion != 0.) || (entry->prob_kaon != 0.) || (entry->prob_electron != 0.))) {
+    if (entry && ((entry->prob_electron != 0.) || (entry->prob_pion != 0.) || (entry->prob_kaon != 0.) || (entry->prob_electron != 0.))) {
       double random_unit_interval = m_dist(m_gen);
 
       trace("entry with e:pi:K:P={}:{}:{}:{}", entry->prob_electron, entry->prob_pion, entry->prob_kaon, entry->prob_proton);
 
-      recopart.addToParticleIDs(partids_out->create(
-        m_cfg.system,                // std::int32_t type
-        std::copysign(11, -charge),  // std::int32_t PDG
-        0,                           // std::int32_t algorithmType
-        static_cast<float>(entry->prob_electron) // float likelihood
-      ));
-      recopart.addToParticleIDs(partids_out->create(
-        m_cfg.system,                // std::int32_t type
-        std::copysign(211, charge),  // std::int32_t PDG
-        0,                           // std::int32_t algorithmType
-        static_cast<float>(entry->prob_pion) // float likelihood
-      ));
-      recopart.addToParticleIDs(partids_out->create(
-        m_cfg.system,                // std::int32_t type
-        std::copysign(321, charge),  // std::int32_t PDG
-        0,                           // std::int32_t algorithmType
-        static_cast<float>(entry->prob_kaon) // float likelihood
-      ));
-      recopart.addToParticleIDs(partids_out->create(
-        m_cfg.system,                // std::int32_t type
-        std::copysign(2212, charge), // std::int32_t PDG
-        0,                           // std::int32_t algorithmType
-        static_cast<float>(entry->prob_proton) // float likelihood
-      ));
+      // The four hypotheses of the particle, created together
+      const std::array<edm4hep::ParticleID, 4> partids{
+        partids_out.create(
+          m_cfg.system,                // std::int32_t type
+          std::copysign(11, -charge),  // std::int32_t PDG
+          0,                           // std::int32_t algorithmType
+          static_cast<float>(entry->prob_electron) // float likelihood
+        ),
+        partids_out.create(
+          m_cfg.system,                // std::int32_t type
+          std::copysign(211, charge),  // std::int32_t PDG
+          0,                           // std::int32_t algorithmType
+          static_cast<float>(entry->prob_pion) // float likelihood
+        ),
+        partids_out.create(
+          m_cfg.system,                // std::int32_t type
+          std::copysign(321, charge),  // std::int32_t PDG
+          0,                           // std::int32_t algorithmType
+          static_cast<float>(entry->prob_kaon) // float likelihood
+        ),
+        partids_out.create(
+          m_cfg.system,                // std::int32_t type
+          std::copysign(2212, charge), // std::int32_t PDG
+          0,                           // std::int32_t algorithmType
+          static_cast<float>(entry->prob_proton) // float likelihood
+        ),
+      };
+      for (const auto& partid : partids) {
+        recopart.addToParticleIDs(partid);
+      }
 
       if (random_unit_interval < entry->prob_electron) {
         identified_pdg = 11; // electron
-        recopart.setParticleIDUsed((*partids_out)[partids_out->size() - 4]);
+        recopart.setParticleIDUsed(partids[0]);
       } else if (random_unit_interval < (entry->prob_electron + entry->prob_pion)) {
         identified_pdg = 211; // pion
-        recopart.setParticleIDUsed((*partids_out)[partids_out->size() - 3]);
+        recopart.setParticleIDUsed(partids[1]);
       } else if (random_unit_interval <
                  (entry->prob_electron + entry->prob_pion + entry->prob_kaon)) {
         identified_pdg = 321; // kaon
-        recopart.setParticleIDUsed((*partids_out)[partids_out->size() - 2]);
+        recopart.setParticleIDUsed(partids[2]);
       } else if (random_unit_interval < (entry->prob_electron + entry->prob_pion +
                                          entry->prob_kaon + entry->prob_electron)) {
         identified_pdg = 2212; // proton
-        recopart.setParticleIDUsed((*partids_out)[partids_out->size() - 1]);
+        recopart.setParticleIDUsed(partids[3]);
       }
     }
 
@@ -136,7 +200,7 @@ void PIDLookup::process(const Input& input, const Output& output) const {
       trace("randomized PDG is {}", recopart.getPDG());
     }
 
-    recoparts_out->push_back(recopart);
+    recoparts_out.push_back(recopart);
   }
 }
 
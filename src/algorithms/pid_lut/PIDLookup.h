@@ -5,11 +5,15 @@
 #include <edm4eic/MCRecoParticleAssociationCollection.h>
 #include <edm4eic/ReconstructedParticleCollection.h>
 #include <edm4hep/ParticleIDCollection.h>
+#include <cstddef>
+#include <optional>
 #include <random>
+#include <span>
 #include <string>
 #include <string_view>
 
 #include "PIDLookupConfig.h"
+#include "algorithms/interfaces/AssociationIndex.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 #include "services/pid_lut/PIDLookupTable.h"
 
@@ -19,7 +23,7 @@ using PIDLookupAlgorithm =
     algorithms::Algorithm<algorithms::Input<edm4eic::ReconstructedParticleCollection,
                                             edm4eic::MCRecoParticleAssociationCollection>,
                           algorithms::Output<edm4eic::ReconstructedParticleCollection,
-                                             edm4eic::MCRecoParticleAssociationCollection,
+                                             std::optional<edm4eic::MCRecoParticleAssociationCollection>,
                                              edm4hep::ParticleIDCollection>>;
 
 class PIDLookup : public PIDLookupAlgorithm, public WithPodConfig<PIDLookupConfig> {
@@ -35,7 +39,24 @@ public:
   void init() final;
   void process(const Input&, const Output&) const final;
 
+  /// A batch of events with one lookup of the table, `outputs[i]` are the outputs of `inputs[i]`
+  void process(std::span<const Input> inputs, std::span<const Output> outputs) const;
+
+  /// Binning of the table of a configuration
+  static PIDLookupTable::Binning binning(const PIDLookupConfig& cfg);
+
 private:
+  /// The outputs of one event from the lookups of its particles, past the queries for none,
+  /// without output associations if partassocs_out is nullptr
+  void fill(const edm4eic::ReconstructedParticleCollection& recoparts_in,
+            const AssociationIndex<edm4eic::MCRecoParticleAssociationCollection>& assoc_index,
+            std::span<const std::size_t> query_of_particle,
+            std::span<const PIDLookupTable::Query> queries,
+            std::span<const std::optional<PIDLookupTable::Entry>> entries,
+            edm4eic::ReconstructedParticleCollection& recoparts_out,
+            edm4eic::MCRecoParticleAssociationCollection* partassocs_out,
+            edm4hep::ParticleIDCollection& partids_out) const;
+
   mutable std::mt19937 m_gen{};
   mutable std::uniform_real_distribution<double> m_dist{0, 1};
   const PIDLookupTable* m_lut;
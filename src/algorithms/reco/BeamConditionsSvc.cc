@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <edm4hep/Vector3f.h>
+#include <fmt/core.h>
+#include <utility>
+
+#include "Beam.h"
+#include "BeamConditionsSvc.h"
+#include "Boost.h"
+
+namespace eicrecon {
+
+  void BeamConditionsSvc::init() {
+    if (m_electronMomentum.value() > 0 && m_hadronMomentum.value() > 0) {
+      const float ez = -m_electronMomentum.value();
+      const float hz = m_hadronMomentum.value();
+      m_configured = make(
+          round_beam_four_momentum({0, 0, ez}, m_electron, {ez}, 0.0),
+          round_beam_four_momentum({0, 0, hz}, m_hadronPDG.value() == 2212 ? m_proton : m_neutron, {hz},
+                                   m_crossingAngle.value()));
+      info("Beams configured, electron energy, hadron energy = {},{}", m_configured->ei.E(), m_configured->pi.E());
+    }
+  }
+
+  std::shared_ptr<const BeamConditions> BeamConditionsSvc::make(const PxPyPzEVector& ei, const PxPyPzEVector& pi) const {
+    auto conditions = std::make_shared<BeamConditions>();
+    conditions->ei = ei;
+    conditions->pi = pi;
+    conditions->crossingAngle = m_crossingAngle.value();
+    conditions->boost = determine_boost(ei, pi);
+    return conditions;
+  }
+
+  std::shared_ptr<const BeamConditions> BeamConditionsSvc::conditions(
+      std::int64_t run, const edm4hep::MCParticleCollection& mcparts) {
+
+    if (m_configured) {
+      return m_configured;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (const auto it = m_runs.find(run); it != m_runs.end()) {
+      return it->second;
+    }
+
+    const auto ei_coll = find_first_beam_electron(&mcparts);
+    const auto pi_coll = find_first_beam_hadron(&mcparts);
+    if (ei_coll.size() == 0 || pi_coll.size() == 0) {
+      return nullptr;
+    }
+    auto conditions = make(
+        round_beam_four_momentum(
+            ei_coll[0].getMomentum(),
+            m_electron,
+            {-5.0, -10.0, -18.0},
+            0.0),
+        round_beam_four_momentum(
+            pi_coll[0].getMomentum(),
+            pi_coll[0].getPDG() == 2212 ? m_proton : m_neutron,
+            {41.0, 100.0, 275.0},
+            m_crossingAngle.value()));
+    debug("Beams of run {}, electron energy, hadron energy = {},{}", run, conditions->ei.E(), conditions->pi.E());
+    m_runs.emplace(run, conditions);
+    return conditions;
+  }
+
+} // namespace eicrecon
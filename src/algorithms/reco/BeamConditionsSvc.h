@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <Math/LorentzRotation.h>
+#include <Math/Vector4D.h>
+#include <algorithms/logger.h>
+#include <algorithms/service.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+using ROOT::Math::PxPyPzEVector;
+
+namespace eicrecon {
+
+  /** Beams of a run, the same for all of its events.
+   */
+  struct BeamConditions {
+    /// beam four-momenta rounded to the nominal beam energies, see `round_beam_four_momentum`
+    PxPyPzEVector ei;
+    PxPyPzEVector pi;
+    /// of the hadron beam, in the x-z plane
+    double crossingAngle{0};
+    /// boost of the beams to the colinear frame, see `determine_boost`
+    ROOT::Math::LorentzRotation boost;
+  };
+
+  /**
+   * Run-level cache of the beam conditions.
+   *
+   * The beams are given by the `electronMomentum` and `hadronMomentum`
+   * properties, or, if either is zero, determined from the beam particles of
+   * the first event of every run in which both are found. Consumers hold the
+   * conditions of their current run and drop them in `ChangeRun`.
+   */
+  class BeamConditionsSvc : public algorithms::LoggedService<BeamConditionsSvc> {
+  public:
+    void init();
+
+    /// Conditions of the run, nullptr if neither configured nor determined with the beams of this event
+    std::shared_ptr<const BeamConditions> conditions(std::int64_t run, const edm4hep::MCParticleCollection& mcparts);
+
+  private:
+    std::shared_ptr<const BeamConditions> make(const PxPyPzEVector& ei, const PxPyPzEVector& pi) const;
+
+    Property<double> m_electronMomentum{this, "electronMomentum", 0., "Electron beam momentum [GeV], from the events if 0"};
+    Property<double> m_hadronMomentum{this, "hadronMomentum", 0., "Hadron beam momentum [GeV], from the events if 0"};
+    Property<int> m_hadronPDG{this, "hadronPDG", 2212, "PDG code of the hadron beam, if configured"};
+    Property<double> m_crossingAngle{this, "crossingAngle", -0.025, "Crossing angle of the hadron beam [rad]"};
+
+    double m_proton{0.93827}, m_neutron{0.93957}, m_electron{0.000510998928};
+
+    /// configured for all runs
+    std::shared_ptr<const BeamConditions> m_configured;
+
+    std::mutex m_mutex;
+    std::map<std::int64_t, std::shared_ptr<const BeamConditions>> m_runs;
+
+    ALGORITHMS_DEFINE_LOGGED_SERVICE(BeamConditionsSvc);
+  };
+
+} // namespace eicrecon
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <edm4hep/Vector3f.h>
+#include <fmt/core.h>
+#include <gsl/pointers>
+
+#include "BeamContext.h"
+
+namespace eicrecon {
+
+  void BeamContextBuilder::process(
+      const BeamContextBuilder::Input& input,
+      const BeamContextBuilder::Output& output) const {
+
+    const auto [mcparts, conditions] = input;
+    auto [beams] = output;
+
+    // one pass for what `find_first_beam_electron`, `find_first_beam_hadron`
+    // and `find_first_scattered_electron` find
+    for (const auto& p: *mcparts) {
+      const auto status = p.getGeneratorStatus();
+      const auto pdg = p.getPDG();
+      if (status == 4 && pdg == 11) {
+        if (!beams->beam_electron) {
+          beams->beam_electron = p;
+        }
+      } else if (status == 4 && (pdg == 2212 || pdg == 2112)) {
+        if (!beams->beam_hadron) {
+          beams->beam_hadron = p;
+        }
+      } else if (status == 1 && pdg == 11) {
+        if (!beams->scattered_electron) {
+          beams->scattered_electron = p;
+        }
+      }
+      if (beams->beam_electron && beams->beam_hadron && beams->scattered_electron) {
+        break;
+      }
+    }
+
+    if (!beams->has_beams()) {
+      debug("No beam electron or hadron found");
+      return;
+    }
+
+    // the same for all the events of the run
+    beams->ei = conditions->ei;
+    beams->pi = conditions->pi;
+    beams->boost = conditions->boost;
+    beams->crossingAngle = conditions->crossingAngle;
+
+    debug("electron energy, hadron energy = {},{}", beams->ei.E(), beams->pi.E());
+  }
+
+} // namespace eicrecon
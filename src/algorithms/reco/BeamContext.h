@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <Math/LorentzRotation.h>
+#include <Math/Vector4D.h>
+#include <algorithms/algorithm.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "BeamConditionsSvc.h"
+
+using ROOT::Math::PxPyPzEVector;
+
+namespace eicrecon {
+
+  /** Beams of an event, found once per event for all the inclusive
+   *  kinematics methods instead of by each of them. Their rounded four-momenta
+   *  and boost are the conditions of the run, see `BeamConditionsSvc`.
+   */
+  struct BeamContext {
+    /// first beam electron, beam hadron and scattered electron in MCParticles
+    std::optional<edm4hep::MCParticle> beam_electron;
+    std::optional<edm4hep::MCParticle> beam_hadron;
+    std::optional<edm4hep::MCParticle> scattered_electron;
+
+    /// beam four-momenta rounded to the nominal beam energies, see `round_beam_four_momentum`
+    /// (only set if both beams are found)
+    PxPyPzEVector ei;
+    PxPyPzEVector pi;
+
+    /// boost of the rounded beams to the colinear frame, see `determine_boost`
+    ROOT::Math::LorentzRotation boost;
+
+    /// of the hadron beam
+    double crossingAngle{0};
+
+    bool has_beams() const { return beam_electron.has_value() && beam_hadron.has_value(); }
+  };
+
+  using BeamContextBuilderAlgorithm = algorithms::Algorithm<
+    algorithms::Input<edm4hep::MCParticleCollection, BeamConditions>,
+    algorithms::Output<BeamContext>
+  >;
+
+  class BeamContextBuilder : public BeamContextBuilderAlgorithm {
+
+  public:
+    BeamContextBuilder(std::string_view name)
+      : BeamContextBuilderAlgorithm{name,
+                            {"MCParticles", "beamConditions"},
+                            {"beamContext"},
+                            "Find the beam particles, with the beams and the boost of the run."} {}
+
+    void init() final { };
+    void process(const Input&, const Output&) const final;
+  };
+
+} // namespace eicrecon
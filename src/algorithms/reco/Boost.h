@@ -9,6 +9,9 @@
 #include <Math/RotationX.h>
 #include <Math/RotationY.h>
 #include <Math/Boost.h>
+#include <array>
+#include <cstddef>
+#include <vector>
 
 using ROOT::Math::PxPyPzEVector;
 
@@ -60,4 +63,59 @@ namespace eicrecon {
     return part;
   }
 
+  /** Four-momenta of a collection, as arrays of their components.
+   */
+  struct FourMomenta {
+    std::vector<double> px, py, pz, E;
+
+    std::size_t size() const { return E.size(); }
+
+    void clear() { px.clear(); py.clear(); pz.clear(); E.clear(); }
+
+    void push_back(double x, double y, double z, double e) {
+      px.push_back(x); py.push_back(y); pz.push_back(z); E.push_back(e);
+    }
+
+    PxPyPzEVector operator[](std::size_t i) const { return {px[i], py[i], pz[i], E[i]}; }
+  };
+
+  /** Lorentz transform as the 4x4 matrix of its combined boosts and rotations,
+   *  applied to all the four-momenta of a collection in one loop that the
+   *  compiler vectorizes.
+   */
+  class LorentzTransform {
+  public:
+    LorentzTransform(const LorentzRotation& tf) { tf.GetComponents(m_m.begin()); }
+
+    PxPyPzEVector operator()(const PxPyPzEVector& p) const {
+      return {
+        m_m[0] * p.Px() + m_m[1] * p.Py() + m_m[2] * p.Pz() + m_m[3] * p.E(),
+        m_m[4] * p.Px() + m_m[5] * p.Py() + m_m[6] * p.Pz() + m_m[7] * p.E(),
+        m_m[8] * p.Px() + m_m[9] * p.Py() + m_m[10] * p.Pz() + m_m[11] * p.E(),
+        m_m[12] * p.Px() + m_m[13] * p.Py() + m_m[14] * p.Pz() + m_m[15] * p.E(),
+      };
+    }
+
+    /// Transforms all the four-momenta in place
+    void operator()(FourMomenta& p) const {
+      const auto m = m_m;
+      const std::size_t n = p.size();
+      double* __restrict px = p.px.data();
+      double* __restrict py = p.py.data();
+      double* __restrict pz = p.pz.data();
+      double* __restrict E = p.E.data();
+      for (std::size_t i = 0; i < n; ++i) {
+        const double x = px[i], y = py[i], z = pz[i], e = E[i];
+        px[i] = m[0] * x + m[1] * y + m[2] * z + m[3] * e;
+        py[i] = m[4] * x + m[5] * y + m[6] * z + m[7] * e;
+        pz[i] = m[8] * x + m[9] * y + m[10] * z + m[11] * e;
+        E[i] = m[12] * x + m[13] * y + m[14] * z + m[15] * e;
+      }
+    }
+
+  private:
+    /// components xx, xy, xz, xt, yx, ..., tt
+    std::array<double, 16> m_m;
+  };
+
 } // namespace eicrecon
@@ -30,7 +30,7 @@ namespace eicrecon {
       }
     }
     double FarForwardNeutronReconstruction::calc_corr(double Etot) const{
-      auto coeffs=m_cfg.scale_corr_coeff;
+      const auto& coeffs=m_cfg.scale_corr_coeff;
       return coeffs[0]+coeffs[1]/sqrt(Etot)+coeffs[2]/Etot;
     }
     void FarForwardNeutronReconstruction::process(const FarForwardNeutronReconstruction::Input& input,
@@ -38,6 +38,8 @@ namespace eicrecon {
       const auto [clusters] = input;
       auto [out_neutrons] = output;
 
+      // one pass over the clusters, the candidate is only kept if it has energy
+      edm4eic::MutableReconstructedParticle rec_part;
       double Etot=0;
       double Emax=0;
       double x=0;
@@ -52,9 +54,9 @@ namespace eicrecon {
             y=cluster.getPosition().y;
             z=cluster.getPosition().z;
           }
+          rec_part.addToClusters(cluster);
       }
       if (Etot>0){
-          auto rec_part = out_neutrons->create();
           double corr=calc_corr(Etot);
           Etot=Etot/(1+corr);
           rec_part.setEnergy(Etot);
@@ -67,9 +69,7 @@ namespace eicrecon {
           rec_part.setMomentum({(float)px, (float)py, (float)pz});
           rec_part.setCharge(0);
           rec_part.setMass(m_neutron);
-          for (const auto& cluster : *clusters){
-            rec_part.addToClusters(cluster);
-          }
+          out_neutrons->push_back(rec_part);
       }
         //m_log->debug("Found {} neutron candidates", out_neutrons->size());
 
@@ -10,14 +10,13 @@
 #include <edm4eic/HadronicFinalStateCollection.h>
 #include <edm4eic/MCRecoParticleAssociationCollection.h>
 #include <edm4eic/ReconstructedParticleCollection.h>
-#include <edm4hep/MCParticleCollection.h>
 #include <edm4hep/Vector3f.h>
 #include <fmt/core.h>
 #include <podio/ObjectID.h>
 #include <cmath>
 #include <gsl/pointers>
 
-#include "Beam.h"
+#include "BeamContext.h"
 #include "Boost.h"
 #include "HadronicFinalState.h"
 
@@ -37,40 +36,21 @@ namespace eicrecon {
       const HadronicFinalState::Input& input,
       const HadronicFinalState::Output& output) const {
 
-    const auto [mcparts, rcparts, rcassoc] = input;
+    const auto [beams, rcparts, rcassoc] = input;
     auto [hadronicfinalstate] = output;
 
-    // Get incoming electron beam
-    const auto ei_coll = find_first_beam_electron(mcparts);
-    if (ei_coll.size() == 0) {
+    // Get incoming electron and hadron beams
+    if (!beams->beam_electron) {
       debug("No beam electron found");
       return;
     }
-    const PxPyPzEVector ei(
-      round_beam_four_momentum(
-        ei_coll[0].getMomentum(),
-        m_electron,
-        {-5.0, -10.0, -18.0},
-        0.0)
-      );
-
-    // Get incoming hadron beam
-    const auto pi_coll = find_first_beam_hadron(mcparts);
-    if (pi_coll.size() == 0) {
+    if (!beams->beam_hadron) {
       debug("No beam hadron found");
       return;
     }
-    const PxPyPzEVector pi(
-      round_beam_four_momentum(
-        pi_coll[0].getMomentum(),
-        pi_coll[0].getPDG() == 2212 ? m_proton : m_neutron,
-        {41.0, 100.0, 275.0},
-        m_crossingAngle)
-      );
 
     // Get first scattered electron
-    const auto ef_coll = find_first_scattered_electron(mcparts);
-    if (ef_coll.size() == 0) {
+    if (!beams->scattered_electron) {
       debug("No truth scattered electron found");
       return;
     }
@@ -78,10 +58,10 @@ namespace eicrecon {
     //const auto ef_assoc = std::find_if(
     //  rcassoc->begin(),
     //  rcassoc->end(),
-    //  [&ef_coll](const auto& a){ return a.getSim().getObjectID() == ef_coll[0].getObjectID(); });
+    //  [&beams](const auto& a){ return a.getSim().getObjectID() == beams->scattered_electron->getObjectID(); });
     auto ef_assoc = rcassoc->begin();
     for (; ef_assoc != rcassoc->end(); ++ef_assoc) {
-      if (ef_assoc->getSim().getObjectID() == ef_coll[0].getObjectID()) {
+      if (ef_assoc->getSim().getObjectID() == beams->scattered_electron->getObjectID()) {
         break;
       }
     }
@@ -99,7 +79,7 @@ namespace eicrecon {
     double Esum = 0;
 
     // Get boost to colinear frame
-    auto boost = determine_boost(ei, pi);
+    const auto& boost = beams->boost;
 
     auto hfs = hadronicfinalstate->create(0., 0., 0.);
 
@@ -7,14 +7,15 @@
 #include <edm4eic/HadronicFinalStateCollection.h>
 #include <edm4eic/MCRecoParticleAssociationCollection.h>
 #include <edm4eic/ReconstructedParticleCollection.h>
-#include <edm4hep/MCParticleCollection.h>
 #include <string>
 #include <string_view>
 
+#include "BeamContext.h"
+
 namespace eicrecon {
 
 using HadronicFinalStateAlgorithm = algorithms::Algorithm<
-    algorithms::Input<edm4hep::MCParticleCollection, edm4eic::ReconstructedParticleCollection,
+    algorithms::Input<BeamContext, edm4eic::ReconstructedParticleCollection,
                       edm4eic::MCRecoParticleAssociationCollection>,
     algorithms::Output<edm4eic::HadronicFinalStateCollection>>;
 
@@ -23,15 +24,12 @@ class HadronicFinalState : public HadronicFinalStateAlgorithm {
 public:
   HadronicFinalState(std::string_view name)
       : HadronicFinalStateAlgorithm{name,
-                                    {"MCParticles", "inputParticles", "inputAssociations"},
+                                    {"beamContext", "inputParticles", "inputAssociations"},
                                     {"hadronicFinalState"},
                                     "Calculate summed quantities of the hadronic final state."} {}
 
   void init() final;
   void process(const Input&, const Output&) const final;
-
-private:
-  double m_proton{0.93827}, m_neutron{0.93957}, m_electron{0.000510998928}, m_crossingAngle{-0.025};
 };
 
 } // namespace eicrecon
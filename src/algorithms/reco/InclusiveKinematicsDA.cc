@@ -9,13 +9,12 @@
 #include <Math/Vector4Dfwd.h>
 #include <edm4eic/InclusiveKinematicsCollection.h>
 #include <edm4eic/ReconstructedParticleCollection.h>
-#include <edm4hep/MCParticleCollection.h>
 #include <edm4hep/Vector3f.h>
 #include <fmt/core.h>
 #include <cmath>
 #include <gsl/pointers>
 
-#include "Beam.h"
+#include "BeamContext.h"
 #include "Boost.h"
 #include "InclusiveKinematicsDA.h"
 
@@ -35,39 +34,23 @@ namespace eicrecon {
       const InclusiveKinematicsDA::Input& input,
       const InclusiveKinematicsDA::Output& output) const {
 
-    const auto [mcparts, escat, hfs] = input;
+    const auto [beams, escat, hfs] = input;
     auto [kinematics] = output;
 
-    // Get incoming electron beam
-    const auto ei_coll = find_first_beam_electron(mcparts);
-    if (ei_coll.size() == 0) {
+    // Get incoming electron and hadron beams
+    if (!beams->beam_electron) {
       debug("No beam electron found");
       return;
     }
-    const PxPyPzEVector ei(
-      round_beam_four_momentum(
-        ei_coll[0].getMomentum(),
-        m_electron,
-        {-5.0, -10.0, -18.0},
-        0.0)
-      );
-
-    // Get incoming hadron beam
-    const auto pi_coll = find_first_beam_hadron(mcparts);
-    if (pi_coll.size() == 0) {
+    if (!beams->beam_hadron) {
       debug("No beam hadron found");
       return;
     }
-    const PxPyPzEVector pi(
-      round_beam_four_momentum(
-        pi_coll[0].getMomentum(),
-        pi_coll[0].getPDG() == 2212 ? m_proton : m_neutron,
-        {41.0, 100.0, 275.0},
-        m_crossingAngle)
-      );
+    const PxPyPzEVector& ei = beams->ei;
+    const PxPyPzEVector& pi = beams->pi;
 
     // Get boost to colinear frame
-    auto boost = determine_boost(ei, pi);
+    const auto& boost = beams->boost;
 
     // Get electron angle
     auto kf = escat->at(0);
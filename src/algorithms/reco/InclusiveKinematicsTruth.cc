@@ -5,14 +5,13 @@
 #include <Math/GenVector/PxPyPzE4D.h>
 #include <Math/Vector4Dfwd.h>
 #include <edm4eic/InclusiveKinematicsCollection.h>
-#include <edm4hep/MCParticleCollection.h>
 #include <edm4hep/Vector3f.h>
 #include <edm4hep/utils/vector_utils.h>
 #include <fmt/core.h>
 #include <cmath>
 #include <gsl/pointers>
 
-#include "Beam.h"
+#include "BeamContext.h"
 #include "InclusiveKinematicsTruth.h"
 
 using ROOT::Math::PxPyPzEVector;
@@ -33,7 +32,7 @@ namespace eicrecon {
       const InclusiveKinematicsTruth::Input& input,
       const InclusiveKinematicsTruth::Output& output) const {
 
-    const auto [mcparts] = input;
+    const auto [beams] = input;
     auto [kinematics] = output;
 
     // Loop over generated particles to get incoming electron and proton beams
@@ -43,25 +42,23 @@ namespace eicrecon {
     // Also need to update for CC events.
 
     // Get incoming electron beam
-    const auto ei_coll = find_first_beam_electron(mcparts);
-    if (ei_coll.size() == 0) {
+    if (!beams->beam_electron) {
       debug("No beam electron found");
       return;
     }
-    const auto ei_p = ei_coll[0].getMomentum();
+    const auto ei_p = beams->beam_electron->getMomentum();
     const auto ei_p_mag = edm4hep::utils::magnitude(ei_p);
     const auto ei_mass = m_electron;
     const PxPyPzEVector ei(ei_p.x, ei_p.y, ei_p.z, std::hypot(ei_p_mag, ei_mass));
 
     // Get incoming hadron beam
-    const auto pi_coll = find_first_beam_hadron(mcparts);
-    if (pi_coll.size() == 0) {
+    if (!beams->beam_hadron) {
       debug("No beam hadron found");
       return;
     }
-    const auto pi_p = pi_coll[0].getMomentum();
+    const auto pi_p = beams->beam_hadron->getMomentum();
     const auto pi_p_mag = edm4hep::utils::magnitude(pi_p);
-    const auto pi_mass = pi_coll[0].getPDG() == 2212 ? m_proton : m_neutron;
+    const auto pi_mass = beams->beam_hadron->getPDG() == 2212 ? m_proton : m_neutron;
     const PxPyPzEVector pi(pi_p.x, pi_p.y, pi_p.z, std::hypot(pi_p_mag, pi_mass));
 
     // Get first scattered electron
@@ -69,12 +66,11 @@ namespace eicrecon {
     // which seems to be correct based on a cursory glance at the Pythia8 output. In the future,
     // it may be better to trace back each final-state electron and see which one originates from
     // the beam.
-    const auto ef_coll = find_first_scattered_electron(mcparts);
-    if (ef_coll.size() == 0) {
+    if (!beams->scattered_electron) {
       debug("No truth scattered electron found");
       return;
     }
-    const auto ef_p = ef_coll[0].getMomentum();
+    const auto ef_p = beams->scattered_electron->getMomentum();
     const auto ef_p_mag = edm4hep::utils::magnitude(ef_p);
     const auto ef_mass = m_electron;
     const PxPyPzEVector ef(ef_p.x, ef_p.y, ef_p.z, std::hypot(ef_p_mag, ef_mass));
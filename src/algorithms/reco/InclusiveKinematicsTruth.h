@@ -5,14 +5,15 @@
 
 #include <algorithms/algorithm.h>
 #include <edm4eic/InclusiveKinematicsCollection.h>
-#include <edm4hep/MCParticleCollection.h>
 #include <string>
 #include <string_view>
 
+#include "BeamContext.h"
+
 namespace eicrecon {
 
 using InclusiveKinematicsTruthAlgorithm =
-    algorithms::Algorithm<algorithms::Input<edm4hep::MCParticleCollection>,
+    algorithms::Algorithm<algorithms::Input<BeamContext>,
                           algorithms::Output<edm4eic::InclusiveKinematicsCollection>>;
 
 class InclusiveKinematicsTruth : public InclusiveKinematicsTruthAlgorithm {
@@ -21,7 +22,7 @@ public:
   InclusiveKinematicsTruth(std::string_view name)
       : InclusiveKinematicsTruthAlgorithm{
             name,
-            {"MCParticles"},
+            {"beamContext"},
             {"inclusiveKinematics"},
             "Determine inclusive kinematics from truth information."} {}
 
@@ -29,7 +30,7 @@ public:
   void process(const Input&, const Output&) const final;
 
 private:
-  double m_proton{0.93827}, m_neutron{0.93957}, m_electron{0.000510998928}, m_crossingAngle{-0.025};
+  double m_proton{0.93827}, m_neutron{0.93957}, m_electron{0.000510998928};
 };
 
 } // namespace eicrecon
@@ -9,6 +9,7 @@
 #include <edm4hep/MCParticleCollection.h> // IWYU pragma: keep
 #include <edm4hep/Vector3f.h>
 #include <edm4hep/utils/vector_utils.h>
+#include <fastjet/ClusterSequence.hh>
 #include <fastjet/ClusterSequenceArea.hh>
 #include <fastjet/GhostedAreaSpec.hh>
 // for fastjet objects
@@ -16,6 +17,7 @@
 #include <fastjet/contrib/Centauro.hh>
 #include <fmt/core.h>
 #include <gsl/pointers>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 
@@ -45,11 +47,14 @@ template <typename InputT> void JetReconstruction<InputT>::init() {
     throw JException(out.what());
   }
 
-  try {
-    m_mapAreaType.at(m_cfg.areaType);
-  } catch (std::out_of_range& out) {
-    this->error(" Unknown area type \"{}\" specified!", m_cfg.areaType);
-    throw JException(out.what());
+  const bool with_area = (m_cfg.areaType != m_noAreaType);
+  if (with_area) {
+    try {
+      m_mapAreaType.at(m_cfg.areaType);
+    } catch (std::out_of_range& out) {
+      this->error(" Unknown area type \"{}\" specified!", m_cfg.areaType);
+      throw JException(out.what());
+    }
   }
 
   // Choose jet definition based on no. of parameters
@@ -75,26 +80,42 @@ template <typename InputT> void JetReconstruction<InputT>::init() {
     break;
 
   // 2 parameter algorithms
-  case JetAlgorithm::genkt_algorithm:
-    [[fallthrough]];
-
   case JetAlgorithm::ee_genkt_algorithm:
     m_jet_def = std::make_unique<JetDefinition>(m_mapJetAlgo[m_cfg.jetAlgo], m_cfg.rJet, m_cfg.pJet,
                                                 m_mapRecombScheme[m_cfg.recombScheme]);
     break;
 
+  case JetAlgorithm::genkt_algorithm:
+    // without ghosts, choose the strategy by multiplicity in process()
+    if (!with_area) {
+      m_jet_def_few = std::make_unique<JetDefinition>(m_mapJetAlgo[m_cfg.jetAlgo], m_cfg.rJet, m_cfg.pJet,
+                                                      m_mapRecombScheme[m_cfg.recombScheme], N2Plain);
+    }
+    m_jet_def = std::make_unique<JetDefinition>(m_mapJetAlgo[m_cfg.jetAlgo], m_cfg.rJet, m_cfg.pJet,
+                                                m_mapRecombScheme[m_cfg.recombScheme],
+                                                with_area ? Best : N2Tiled);
+    break;
+
   // all others have only 1 parameter
   default:
+    // without ghosts, choose the strategy by multiplicity in process()
+    if (!with_area) {
+      m_jet_def_few = std::make_unique<JetDefinition>(m_mapJetAlgo[m_cfg.jetAlgo], m_cfg.rJet,
+                                                      m_mapRecombScheme[m_cfg.recombScheme], N2Plain);
+    }
     m_jet_def = std::make_unique<JetDefinition>(m_mapJetAlgo[m_cfg.jetAlgo], m_cfg.rJet,
-                                                m_mapRecombScheme[m_cfg.recombScheme]);
+                                                m_mapRecombScheme[m_cfg.recombScheme],
+                                                with_area ? Best : N2Tiled);
     break;
 
   } // end switch (jet algorithm)
 
-  // Define jet area
-  m_area_def = std::make_unique<AreaDefinition>(
-      m_mapAreaType[m_cfg.areaType],
-      GhostedAreaSpec(m_cfg.ghostMaxRap, m_cfg.numGhostRepeat, m_cfg.ghostArea));
+  // Define jet area, if requested: the ghosts dominate the clustering time
+  if (with_area) {
+    m_area_def = std::make_unique<AreaDefinition>(
+        m_mapAreaType[m_cfg.areaType],
+        GhostedAreaSpec(m_cfg.ghostMaxRap, m_cfg.numGhostRepeat, m_cfg.ghostArea));
+  }
 
 } // end 'init()'
 
@@ -108,6 +129,7 @@ void JetReconstruction<InputT>::process(
 
   // extract input momenta and collect into pseudojets
   std::vector<PseudoJet> particles;
+  particles.reserve(input_collection->size());
   for (unsigned iInput = 0; const auto& input : *input_collection) {
 
     // get 4-vector
@@ -131,11 +153,18 @@ void JetReconstruction<InputT>::process(
   this->trace("  Number of particles: {}", particles.size());
 
   // Run the clustering, extract the jets
-  fastjet::ClusterSequenceArea m_clus_seq(particles, *m_jet_def, *m_area_def);
-  std::vector<PseudoJet> jets = sorted_by_pt(m_clus_seq.inclusive_jets(m_cfg.minJetPt));
+  const auto& jet_def =
+      (m_jet_def_few && particles.size() <= m_maxN2PlainParticles) ? *m_jet_def_few : *m_jet_def;
+  std::unique_ptr<ClusterSequence> clus_seq;
+  if (m_area_def) {
+    clus_seq = std::make_unique<ClusterSequenceArea>(particles, jet_def, *m_area_def);
+  } else {
+    clus_seq = std::make_unique<ClusterSequence>(particles, jet_def);
+  }
+  std::vector<PseudoJet> jets = sorted_by_pt(clus_seq->inclusive_jets(m_cfg.minJetPt));
 
   // Print out some infos
-  this->trace("  Clustering with : {}", m_jet_def->description());
+  this->trace("  Clustering with : {}", jet_def.description());
 
   // loop over jets
   for (unsigned i = 0; i < jets.size(); i++) {
@@ -7,6 +7,7 @@
 #include <edm4eic/ReconstructedParticleCollection.h>
 #include <fastjet/AreaDefinition.hh>
 #include <fastjet/JetDefinition.hh>
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <string>
@@ -46,9 +47,13 @@ public:
 private:
   // fastjet components
   std::unique_ptr<fastjet::JetDefinition> m_jet_def;
-  std::unique_ptr<fastjet::AreaDefinition> m_area_def;
+  std::unique_ptr<fastjet::JetDefinition> m_jet_def_few; // for few particles, if the strategy is chosen explicitly
+  std::unique_ptr<fastjet::AreaDefinition> m_area_def;   // no area if null
   std::unique_ptr<fastjet::JetDefinition::Plugin> m_jet_plugin;
 
+  // largest number of particles clustered with the N2Plain strategy rather than N2Tiled
+  static constexpr std::size_t m_maxN2PlainParticles = 30;
+
   // maps of user input onto fastjet options
   std::map<std::string, fastjet::JetAlgorithm> m_mapJetAlgo = {
       {"kt_algorithm", fastjet::JetAlgorithm::kt_algorithm},
@@ -77,13 +82,14 @@ private:
       {"one_ghost_passive_area", fastjet::AreaType::one_ghost_passive_area},
       {"passive_area", fastjet::AreaType::passive_area},
       {"voronoi_area", fastjet::AreaType::voronoi_area}};
+  const std::string m_noAreaType = "none";
 
   // default fastjet options
   const struct defaults {
     std::string jetAlgo;
     std::string recombScheme;
     std::string areaType;
-  } m_defaultFastjetOpts = {"antikt_algorithm", "E_scheme", "active_area"};
+  } m_defaultFastjetOpts = {"antikt_algorithm", "E_scheme", "none"};
 
 }; // end JetReconstruction definition
 
@@ -20,7 +20,7 @@ namespace eicrecon {
     int         numGhostRepeat = 1;                   // number of times a ghost is reused per grid site
     std::string jetAlgo        = "antikt_algorithm";  // jet finding algorithm
     std::string recombScheme   = "E_scheme";          // particle recombination scheme
-    std::string areaType       = "active_area";       // type of area calculated
+    std::string areaType       = "none";              // type of area calculated, "none" for no area
     std::string jetContribAlgo = "Centauro";          // contributed algorithm name
 
   };
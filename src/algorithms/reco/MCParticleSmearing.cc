@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <algorithms/service.h>
+#include <edm4eic/ClusterCollection.h>
+#include <edm4eic/MCRecoParticleAssociationCollection.h>
+#include <edm4eic/ReconstructedParticleCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <edm4hep/Vector3f.h>
+#include <edm4hep/utils/vector_utils.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <gsl/pointers>
+#include <optional>
+#include <stdexcept>
+
+#include "MCParticleSmearing.h"
+
+namespace eicrecon {
+
+namespace {
+
+  // substreams of the random numbers of a particle
+  constexpr std::uint32_t tracking_substream = 0;
+  constexpr std::uint32_t ecal_substream = 1;
+
+  bool is_em(int pdg) { return std::abs(pdg) == 11 || pdg == 22; }
+
+}
+
+void MCParticleSmearing::init() {
+    if (!(m_cfg.momentumResolutionA >= 0 && m_cfg.momentumResolutionB >= 0
+          && m_cfg.angularResolutionA >= 0 && m_cfg.angularResolutionB >= 0
+          && m_cfg.ecalResolutionA >= 0 && m_cfg.ecalResolutionB >= 0)) {
+        error("Invalid configuration: the resolutions can not be negative");
+        throw std::runtime_error("Invalid configuration: the resolutions can not be negative");
+    }
+
+    // Random numbers are drawn from per-particle streams keyed on the run and event
+    // numbers, so the results do not depend on the event processing order
+    auto& serviceSvc = algorithms::ServiceSvc::instance();
+    m_random = serviceSvc.service<CounterRandomSvc>("CounterRandomSvc");
+}
+
+void MCParticleSmearing::process(
+    const MCParticleSmearing::Input& input,
+    const MCParticleSmearing::Output& output) const {
+
+    const auto [headers, mcparticles] = input;
+    auto [charged, charged_assocs, neutral, neutral_assocs, clusters] = output;
+
+    const auto& header = headers->at(0);
+    const auto random_key = m_random->key(name(), header.getRunNumber(), header.getEventNumber());
+
+    for (std::size_t i = 0; i < mcparticles->size(); ++i) {
+        const auto mcparticle = (*mcparticles)[i];
+        if (mcparticle.getGeneratorStatus() != 1) {
+            continue;
+        }
+
+        const edm4hep::Vector3f momentum{static_cast<float>(mcparticle.getMomentum().x),
+                                         static_cast<float>(mcparticle.getMomentum().y),
+                                         static_cast<float>(mcparticle.getMomentum().z)};
+        const double p = edm4hep::utils::magnitude(momentum);
+        if (p == 0) {
+            continue;
+        }
+        const double eta = edm4hep::utils::eta(momentum);
+        const double theta = edm4hep::utils::anglePolar(momentum);
+        const double phi = edm4hep::utils::angleAzimuthal(momentum);
+        const double mass = mcparticle.getMass();
+        const edm4hep::Vector3f vertex{static_cast<float>(mcparticle.getVertex().x),
+                                       static_cast<float>(mcparticle.getVertex().y),
+                                       static_cast<float>(mcparticle.getVertex().z)};
+
+        // 1. Tracking
+        const bool tracked = mcparticle.getCharge() != 0
+            && eta >= m_cfg.trackingEtaMin && eta <= m_cfg.trackingEtaMax
+            && p * std::sin(theta) >= m_cfg.trackingPtMin;
+        std::optional<edm4eic::MutableReconstructedParticle> track;
+        if (tracked) {
+            auto rng = m_random->generator(random_key, i, tracking_substream);
+            const double sigma_p = p * std::hypot(m_cfg.momentumResolutionA * p, m_cfg.momentumResolutionB);
+            const double sigma_angle = std::hypot(m_cfg.angularResolutionA / p, m_cfg.angularResolutionB);
+            const double p_rec = p + sigma_p * rng.gaussian();
+            const double theta_rec = theta + sigma_angle * rng.gaussian();
+            const double phi_rec = phi + sigma_angle / std::max(std::sin(theta), 1e-3) * rng.gaussian();
+            if (p_rec > 0 && theta_rec > 0 && theta_rec < M_PI) {
+                const auto rec_momentum = edm4hep::utils::sphericalToVector(p_rec, theta_rec, phi_rec);
+                auto particle = charged->create();
+                particle.setType(0);
+                particle.setEnergy(static_cast<float>(std::hypot(p_rec, mass)));
+                particle.setMomentum(rec_momentum);
+                particle.setReferencePoint(vertex);
+                particle.setCharge(mcparticle.getCharge());
+                particle.setMass(static_cast<float>(mass));
+                particle.setGoodnessOfPID(0); // assume no PID until proven otherwise
+
+                auto assoc = charged_assocs->create();
+                assoc.setRecID(particle.getObjectID().index);
+                assoc.setSimID(mcparticle.getObjectID().index);
+                assoc.setWeight(1);
+                assoc.setRec(particle);
+                assoc.setSim(mcparticle);
+                track = particle;
+            } else {
+                trace("Particle {} lost in the smearing of its momentum", i);
+            }
+        }
+
+        // 2. Electromagnetic calorimetry
+        const double energy = mcparticle.getEnergy();
+        const bool in_ecal = is_em(mcparticle.getPDG())
+            && eta >= m_cfg.ecalEtaMin && eta <= m_cfg.ecalEtaMax
+            && energy >= m_cfg.ecalEnergyMin;
+        if (!in_ecal || (mcparticle.getCharge() != 0 && !track)) {
+            continue;
+        }
+        auto rng = m_random->generator(random_key, i, ecal_substream);
+        const double sigma_e = energy * std::hypot(m_cfg.ecalResolutionA / std::sqrt(energy), m_cfg.ecalResolutionB);
+        const double energy_rec = energy + sigma_e * rng.gaussian();
+        if (energy_rec <= 0) {
+            continue;
+        }
+        auto cluster = clusters->create();
+        cluster.setType(0);
+        cluster.setEnergy(static_cast<float>(energy_rec));
+        cluster.setEnergyError(static_cast<float>(sigma_e));
+        cluster.setNhits(1);
+        cluster.setPosition(edm4hep::utils::sphericalToVector(m_cfg.ecalDistance, theta, phi));
+
+        if (track) {
+            track->addToClusters(cluster);
+            continue;
+        }
+        auto particle = neutral->create();
+        particle.setType(0);
+        particle.setEnergy(static_cast<float>(energy_rec));
+        particle.setMomentum(edm4hep::utils::sphericalToVector(energy_rec, theta, phi));
+        particle.setReferencePoint(vertex);
+        particle.setCharge(0);
+        particle.setMass(0);
+        particle.setPDG(22);
+        particle.setGoodnessOfPID(0);
+        particle.addToClusters(cluster);
+
+        auto assoc = neutral_assocs->create();
+        assoc.setRecID(particle.getObjectID().index);
+        assoc.setSimID(mcparticle.getObjectID().index);
+        assoc.setWeight(1);
+        assoc.setRec(particle);
+        assoc.setSim(mcparticle);
+    }
+    debug("Smeared {} charged and {} neutral particles of {} MC particles",
+          charged->size(), neutral->size(), mcparticles->size());
+}
+
+} // namespace eicrecon
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+// Parametrised response of the detector to the final-state MC particles, without the geometry
+// 1. Charged particles in the tracking acceptance get a momentum and direction smeared with
+//    the resolutions of the configuration, as the particles of the tracking without PID
+// 2. Electrons and photons in the calorimeter acceptance get a cluster with a smeared energy,
+//    the photons as neutral particles
+// The random numbers are drawn per event and MC particle, so that the result does not depend
+// on the threads or on the other particles of the event.
+
+#pragma once
+
+#include <algorithms/algorithm.h>
+#include <edm4eic/ClusterCollection.h>
+#include <edm4eic/MCRecoParticleAssociationCollection.h>
+#include <edm4eic/ReconstructedParticleCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <string>
+#include <string_view>
+
+#include "algorithms/interfaces/CounterRandomSvc.h"
+#include "algorithms/interfaces/WithPodConfig.h"
+#include "algorithms/reco/MCParticleSmearingConfig.h"
+
+namespace eicrecon {
+
+  using MCParticleSmearingAlgorithm = algorithms::Algorithm<
+    algorithms::Input<
+      edm4hep::EventHeaderCollection,
+      edm4hep::MCParticleCollection
+    >,
+    algorithms::Output<
+      edm4eic::ReconstructedParticleCollection,
+      edm4eic::MCRecoParticleAssociationCollection,
+      edm4eic::ReconstructedParticleCollection,
+      edm4eic::MCRecoParticleAssociationCollection,
+      edm4eic::ClusterCollection
+    >
+  >;
+
+  class MCParticleSmearing
+  : public MCParticleSmearingAlgorithm,
+    public WithPodConfig<MCParticleSmearingConfig> {
+
+  public:
+    MCParticleSmearing(std::string_view name)
+      : MCParticleSmearingAlgorithm{name,
+            {"inputEventHeader", "inputMCParticles"},
+            {"outputChargedParticles", "outputChargedParticleAssociations",
+             "outputNeutralParticles", "outputNeutralParticleAssociations", "outputClusters"},
+            "Smear the final-state MC particles with a parametrised tracking and calorimeter response."} {}
+
+    void init() final;
+    void process(const Input&, const Output&) const final;
+
+  private:
+    const CounterRandomSvc* m_random{nullptr};
+
+  };
+
+} // namespace eicrecon
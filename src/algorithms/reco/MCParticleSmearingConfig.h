@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+namespace eicrecon {
+
+  struct MCParticleSmearingConfig {
+
+    // Acceptance of the tracking for the charged final-state particles
+    double trackingEtaMin{-3.5};
+    double trackingEtaMax{3.5};
+    double trackingPtMin{0.15}; // [GeV]
+
+    // sigma(p)/p = momentumResolutionA * p (+) momentumResolutionB, p in GeV
+    double momentumResolutionA{0.0005}; // [1/GeV]
+    double momentumResolutionB{0.005};
+
+    // sigma(theta) = sigma(phi) sin(theta) = angularResolutionA / p (+) angularResolutionB
+    double angularResolutionA{0.001}; // [rad GeV]
+    double angularResolutionB{0.0001}; // [rad]
+
+    // Acceptance of the electromagnetic calorimetry for the electrons and photons
+    double ecalEtaMin{-3.5};
+    double ecalEtaMax{3.7};
+    double ecalEnergyMin{0.1}; // [GeV]
+
+    // sigma(E)/E = ecalResolutionA / sqrt(E) (+) ecalResolutionB, E in GeV
+    double ecalResolutionA{0.1}; // [sqrt(GeV)]
+    double ecalResolutionB{0.01};
+
+    // Distance from the origin of the clusters, along the true direction of their particle
+    double ecalDistance{1500.}; // [mm]
+
+  };
+
+} // eicrecon
@@ -15,11 +15,15 @@
 #include <edm4hep/utils/vector_utils.h>
 #include <fmt/core.h>
 #include <podio/ObjectID.h>
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <gsl/pointers>
-#include <map>
+#include <iterator>
+#include <optional>
 
 #include "MatchClusters.h"
+#include "algorithms/interfaces/AssociationIndex.h"
 
 namespace eicrecon {
 
@@ -34,11 +38,12 @@ void MatchClusters::process(
 
     debug("Step 0/2: Getting indexed list of clusters...");
 
-    // get an indexed map of all clusters
-    auto clusterMap = indexedClusters(clusters, clustersassoc);
+    // get an indexed list of all clusters
+    const auto clusterMap = indexedClusters(clusters, clustersassoc);
+    std::vector<bool> clusterMatched(clusterMap.size(), false);
 
     // 1. Loop over all tracks and link matched clusters where applicable
-    // (removing matched clusters from the cluster maps)
+    // (marking matched clusters in the cluster list)
     debug("Step 1/2: Matching clusters to charged particles...");
 
     for (const auto inpart: *inparts) {
@@ -51,11 +56,8 @@ void MatchClusters::process(
         int mcID = -1;
 
         // find associated particle
-        for (const auto &assoc: *inpartsassoc) {
-            if (assoc.getRec().getObjectID() == inpart.getObjectID()) {
-                mcID = assoc.getSim().getObjectID().index;
-                break;
-            }
+        if (const auto assoc_index = inpartsassoc->by_rec.first(inpart)) {
+            mcID = inpartsassoc->associations()[*assoc_index].getSim().getObjectID().index;
         }
 
         trace("    --> Found particle with mcID {}", mcID);
@@ -65,12 +67,17 @@ void MatchClusters::process(
             continue;
         }
 
-        if (clusterMap.count(mcID)) {
-            const auto &clus = clusterMap[mcID];
-            debug("    --> found matching cluster with energy: {}", clus.getEnergy());
-            debug("    --> adding cluster to reconstructed particle");
-            outpart.addToClusters(clus);
-            clusterMap.erase(mcID);
+        auto clusterIt = std::lower_bound(clusterMap.begin(), clusterMap.end(), mcID,
+            [](const auto& entry, int id) { return entry.first < id; });
+        if (clusterIt != clusterMap.end() && clusterIt->first == mcID) {
+            const std::size_t clusterIndex = clusterIt - clusterMap.begin();
+            if (!clusterMatched[clusterIndex]) {
+                const auto &clus = clusterIt->second;
+                debug("    --> found matching cluster with energy: {}", clus.getEnergy());
+                debug("    --> adding cluster to reconstructed particle");
+                outpart.addToClusters(clus);
+                clusterMatched[clusterIndex] = true;
+            }
         }
 
         // create truth associations
@@ -85,7 +92,11 @@ void MatchClusters::process(
     // 2. Now loop over all remaining clusters and add neutrals. Also add in Hcal energy
     // if a matching cluster is available
     debug("Step 2/2: Creating neutrals for remaining clusters...");
-    for (const auto &[mcID, clus]: clusterMap) {
+    for (std::size_t clusterIndex = 0; clusterIndex < clusterMap.size(); ++clusterIndex) {
+        if (clusterMatched[clusterIndex]) {
+            continue;
+        }
+        const auto &[mcID, clus] = clusterMap[clusterIndex];
         debug(" --> Processing unmatched cluster with energy: {}", clus.getEnergy());
 
 
@@ -119,13 +130,16 @@ void MatchClusters::process(
     }
 }
 
-// get a map of mcID --> cluster
+// get a list of (mcID, cluster), sorted and unique in mcID
 // input: clusters --> all clusters
-std::map<int, edm4eic::Cluster> MatchClusters::indexedClusters(
+std::vector<std::pair<int, edm4eic::Cluster>> MatchClusters::indexedClusters(
         const edm4eic::ClusterCollection* clusters,
         const edm4eic::MCRecoClusterParticleAssociationCollection* associations) const {
 
-    std::map<int, edm4eic::Cluster> matched = {};
+    std::vector<std::pair<int, edm4eic::Cluster>> matched;
+    matched.reserve(clusters->size());
+
+    const AssociationIndex<edm4eic::MCRecoClusterParticleAssociationCollection> associationIndex{*associations};
 
     // loop over clusters
     for (const auto cluster: *clusters) {
@@ -133,11 +147,8 @@ std::map<int, edm4eic::Cluster> MatchClusters::indexedClusters(
         int mcID = -1;
 
         // find associated particle
-        for (const auto assoc: *associations) {
-            if (assoc.getRec() == cluster) {
-                mcID = assoc.getSim().getObjectID().index;
-                break;
-            }
+        if (const auto assoc_index = associationIndex.first(cluster)) {
+            mcID = (*associations)[*assoc_index].getSim().getObjectID().index;
         }
 
         trace(" --> Found cluster with mcID {} and energy {}", mcID, cluster.getEnergy());
@@ -147,16 +158,27 @@ std::map<int, edm4eic::Cluster> MatchClusters::indexedClusters(
             continue;
         }
 
-        const bool duplicate = matched.count(mcID);
-        if (duplicate) {
-            trace("   --> WARNING: this is a duplicate mcID, keeping the higher energy cluster");
+        matched.emplace_back(mcID, cluster);
+    }
 
-            if (cluster.getEnergy() < matched[mcID].getEnergy()) {
-                continue;
+    // stable, so that clusters of the same mcID stay in collection order
+    std::stable_sort(matched.begin(), matched.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // keep one cluster per mcID
+    auto out = matched.begin();
+    for (auto it = matched.begin(); it != matched.end(); ++it) {
+        if (out != matched.begin() && std::prev(out)->first == it->first) {
+            trace("   --> WARNING: duplicate mcID {}, keeping the higher energy cluster", it->first);
+            // a later cluster of equal energy replaces the earlier one
+            if (it->second.getEnergy() >= std::prev(out)->second.getEnergy()) {
+                *std::prev(out) = *it;
             }
+            continue;
         }
-        matched[mcID] = cluster;
+        *out++ = *it;
     }
+    matched.erase(out, matched.end());
     return matched;
 }
 
@@ -14,10 +14,12 @@
 #include <edm4eic/ReconstructedParticleCollection.h>
 #include <edm4hep/MCParticleCollection.h>
 #include <stdint.h>
-#include <map>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
+#include "algorithms/interfaces/AssociationIndex.h"
 
 namespace eicrecon {
 
@@ -25,7 +27,7 @@ namespace eicrecon {
     algorithms::Input<
       edm4hep::MCParticleCollection,
       edm4eic::ReconstructedParticleCollection,
-      edm4eic::MCRecoParticleAssociationCollection,
+      AssociationLookup<edm4eic::MCRecoParticleAssociationCollection>,
       edm4eic::ClusterCollection,
       edm4eic::MCRecoClusterParticleAssociationCollection
     >,
@@ -55,9 +57,9 @@ namespace eicrecon {
     void process(const Input&, const Output&) const final;
 
     private:
-      // get a map of mcID --> cluster
+      // get a list of (mcID, cluster), sorted and unique in mcID
       // input: clusters --> all clusters
-      std::map<int, edm4eic::Cluster> indexedClusters(
+      std::vector<std::pair<int, edm4eic::Cluster>> indexedClusters(
         const edm4eic::ClusterCollection* clusters,
         const edm4eic::MCRecoClusterParticleAssociationCollection* associations) const;
 
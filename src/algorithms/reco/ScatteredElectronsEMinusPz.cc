@@ -8,14 +8,14 @@
 #include <edm4hep/Vector3f.h>
 #include <fmt/core.h>
 #include <podio/ObjectID.h>
-#include <iterator>
-#include <map>
+#include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <utility>
 
 #include "algorithms/reco/ScatteredElectronsEMinusPz.h"
 #include "algorithms/reco/ScatteredElectronsEMinusPzConfig.h"
 
-using ROOT::Math::PxPyPzEVector;
 using ROOT::Math::PxPyPzMVector;
 
 namespace eicrecon {
@@ -41,11 +41,6 @@ namespace eicrecon {
                 const edm4eic::ReconstructedParticleCollection *rcele
         ){
 
-    // this map will store intermediate results
-    // so that we can sort them before filling output
-    // collection
-    std::map<double, edm4eic::ReconstructedParticle> scatteredElectronsMap;
-
     // our output collection of scattered electrons
     // ordered by E-Pz
     auto out_electrons =  std::make_unique<
@@ -57,88 +52,64 @@ namespace eicrecon {
         rcele->size()
       );
 
-    // Lorentz Vector for the scattered electron,
-    // hadronic final state, and individual hadron
-    // We do it here to avoid creating objects inside the loops
-    PxPyPzMVector  vScatteredElectron;
-    PxPyPzMVector  vHadronicFinalState;
-    PxPyPzMVector  vHadron;
+    // E-Pz is additive, so that of the hadronic final state of a candidate
+    // is that of all reconstructed particles minus the candidate's own one.
+    // Sum over all reconstructed particles once, all assumed to be pions
+    const auto EMinusPz = [](const edm4hep::Vector3f& momentum, double mass) {
+      return PxPyPzMVector(momentum.x, momentum.y, momentum.z, mass).E() - momentum.z;
+    };
+    double allEMinusPz = 0;
+    for (const auto& p: *rcparts) {
+      allEMinusPz += EMinusPz(p.getMomentum(), m_pion);
+    }
 
-    for ( const auto& e: *rcele ) {
-      // Do not cut on charge to account for charge-symmetric background
+    m_log->trace( "Selecting candidates with {} < E-Pz < {}", m_cfg.minEMinusPz, m_cfg.maxEMinusPz );
 
-      // reset the HadronicFinalState
-      vHadronicFinalState.SetCoordinates(0, 0, 0, 0);
-
-      // Set a vector for the electron we are considering now
-      vScatteredElectron.SetCoordinates(
-          e.getMomentum().x,
-          e.getMomentum().y,
-          e.getMomentum().z,
-          m_electron
-        );
-
-      // Loop over reconstructed particles to
-      // sum hadronic final state
-      for (const auto& p: *rcparts) {
-        // What we want is to add all reconstructed particles
-        // except the one we are currently considering as the
-        // (scattered) electron candidate.
-        if (p.getObjectID() != e.getObjectID()) {
-          vHadron.SetCoordinates(
-              p.getMomentum().x,
-              p.getMomentum().y,
-              p.getMomentum().z,
-              m_pion // Assume pion for hadronic state
-            );
-
-          // Sum hadronic final state
-          vHadronicFinalState += vHadron;
-        } else {
-          m_log->trace( "Skipping electron in hadronic final state" );
-        }
-      } // hadron loop (reconstructed particles)
+    m_candidates.clear();
+    for ( std::size_t i = 0; i < rcele->size(); ++i ) {
+      // Do not cut on charge to account for charge-symmetric background
+      const auto e = (*rcele)[i];
+
+      // Remove the candidate from the hadronic final state
+      // if it is one of the reconstructed particles
+      double hadronicEMinusPz = allEMinusPz;
+      const auto id = e.getObjectID();
+      if (id.collectionID == rcparts->getID() && id.index >= 0 && static_cast<std::size_t>(id.index) < rcparts->size()) {
+        m_log->trace( "Skipping electron in hadronic final state" );
+        hadronicEMinusPz -= EMinusPz((*rcparts)[id.index].getMomentum(), m_pion);
+      }
 
       // Calculate the E-Pz for this electron
       // + hadron final state combination
       // For now we keep all electron
       // candidates but we will rank them by their E-Pz
-      double EPz=(vScatteredElectron+vHadronicFinalState).E()
-              - (vScatteredElectron+vHadronicFinalState).Pz();
+      const double EPz = EMinusPz(e.getMomentum(), m_electron) + hadronicEMinusPz;
       m_log->trace( "\tE-Pz={}", EPz );
       m_log->trace( "\tScatteredElectron has Pxyz=( {}, {}, {} )", e.getMomentum().x, e.getMomentum().y, e.getMomentum().z );
 
-      // Store the result of this calculation
-      scatteredElectronsMap[ EPz ] = e;
-    } // electron loop
-
-    m_log->trace( "Selecting candidates with {} < E-Pz < {}", m_cfg.minEMinusPz, m_cfg.maxEMinusPz );
-
-    // map sorts in descending order by default
-    // sort by descending
-    bool first = true;
-    // for (auto kv : scatteredElectronsMap) {
-    for (auto kv = scatteredElectronsMap.rbegin(); kv != scatteredElectronsMap.rend(); ++kv) {
-
-      double EMinusPz = kv->first;
       // Do not save electron candidates that
       // are not within range
-      if ( EMinusPz > m_cfg.maxEMinusPz
-        || EMinusPz < m_cfg.minEMinusPz ){
+      if ( EPz > m_cfg.maxEMinusPz
+        || EPz < m_cfg.minEMinusPz ){
         continue;
       }
+      m_candidates.emplace_back(EPz, i);
+    } // electron loop
 
-      // For logging and development
-      // report the highest E-Pz candidate chosen
-      if ( first ){
-        m_log->trace( "Max E-Pz Candidate:" );
-        m_log->trace( "\tE-Pz={}", EMinusPz );
-        m_log->trace( "\tScatteredElectron has Pxyz=( {}, {}, {} )", kv->second.getMomentum().x, kv->second.getMomentum().y, kv->second.getMomentum().z );
-        first = false;
-      }
-      out_electrons->push_back( kv->second );
-    } // reverse loop on scatteredElectronsMap
+    // rank by descending E-Pz
+    std::sort(m_candidates.begin(), m_candidates.end(), std::greater<>());
 
+    // For logging and development
+    // report the highest E-Pz candidate chosen
+    if ( !m_candidates.empty() ){
+      const auto e = (*rcele)[m_candidates.front().second];
+      m_log->trace( "Max E-Pz Candidate:" );
+      m_log->trace( "\tE-Pz={}", m_candidates.front().first );
+      m_log->trace( "\tScatteredElectron has Pxyz=( {}, {}, {} )", e.getMomentum().x, e.getMomentum().y, e.getMomentum().z );
+    }
+    for (const auto& [EPz, i] : m_candidates) {
+      out_electrons->push_back( (*rcele)[i] );
+    }
 
     // Return Electron candidates ranked
     // in order from largest E-Pz to smallest
@@ -5,7 +5,10 @@
 
 #include <edm4eic/ReconstructedParticleCollection.h>
 #include <spdlog/logger.h>
+#include <cstddef>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "algorithms/reco/ScatteredElectronsEMinusPzConfig.h"
 #include "algorithms/interfaces/WithPodConfig.h"
@@ -27,5 +30,8 @@ namespace eicrecon {
         std::shared_ptr<spdlog::logger> m_log;
         double m_electron{0.000510998928}, m_pion{0.13957};
 
+        /// E-Pz and index of the electron candidates in range, reused for every event
+        std::vector<std::pair<double, std::size_t>> m_candidates;
+
     };
 } // namespace eicrecon
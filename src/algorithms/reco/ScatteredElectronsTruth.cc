@@ -57,22 +57,17 @@ namespace eicrecon {
 
     // Associate first scattered electron
     // with reconstructed electron
-    auto ef_assoc = rcassoc->begin();
-    for (; ef_assoc != rcassoc->end(); ++ef_assoc) {
-      if (ef_assoc->getSim().getObjectID() ==  ef_coll[0].getObjectID()) {
-        break;
-      }
-    }
+    const auto ef_assoc = rcassoc->by_sim.first(ef_coll[0]);
 
     // Check to see if the associated reconstructed
     // particle is available
-    if (!(ef_assoc != rcassoc->end())) {
+    if (!ef_assoc) {
       trace("Truth scattered electron not in reconstructed particles");
       return;
     }
 
     // Get the reconstructed electron object
-    const auto ef_rc{ef_assoc->getRec()};
+    const auto ef_rc{rcassoc->associations()[*ef_assoc].getRec()};
     const auto ef_rc_id{ef_rc.getObjectID()};
 
     // Use these to compute the E-Pz
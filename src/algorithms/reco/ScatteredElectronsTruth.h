@@ -10,6 +10,7 @@
 #include <string>
 #include <string_view>
 
+#include "algorithms/interfaces/AssociationIndex.h"
 
 namespace eicrecon {
 
@@ -17,7 +18,7 @@ namespace eicrecon {
     algorithms::Input<
       edm4hep::MCParticleCollection,
       edm4eic::ReconstructedParticleCollection,
-      edm4eic::MCRecoParticleAssociationCollection
+      AssociationLookup<edm4eic::MCRecoParticleAssociationCollection>
     >,
     algorithms::Output<
       edm4eic::ReconstructedParticleCollection
@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <DD4hep/Detector.h>
+#include <algorithms/logger.h>
+#include <edm4eic/ClusterCollection.h>
+#include <edm4eic/ReconstructedParticleCollection.h>
+#include <edm4eic/TrackSegmentCollection.h>
+#include <edm4hep/Vector3f.h>
+#include <edm4hep/utils/vector_utils.h>
+#include <podio/ObjectID.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <gsl/pointers>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "TrackClusterMatching.h"
+
+namespace eicrecon {
+
+namespace {
+
+  // The target surfaces of TrackPropagation carry the system ID as the extra and
+  // their index within the system as the layer of their Acts::GeometryIdentifier
+  constexpr std::uint64_t surface_extra_mask = 0x00000000000000ff;
+  constexpr std::uint64_t surface_layer_mask = 0x0000fff000000000;
+  constexpr int surface_layer_shift = 36;
+
+  std::uint64_t object_key(const podio::ObjectID& id) {
+    return (static_cast<std::uint64_t>(id.collectionID) << 32) | static_cast<std::uint32_t>(id.index);
+  }
+
+  std::uint64_t bin_key(std::int64_t bin0, std::int64_t bin1) {
+    return (static_cast<std::uint64_t>(bin0) << 32) | static_cast<std::uint32_t>(bin1);
+  }
+
+  constexpr std::size_t no_index = std::numeric_limits<std::size_t>::max();
+
+}
+
+void TrackClusterMatching::init() {
+    m_systemID = m_detector->constant<int>(m_cfg.calorimeterID);
+    if (!(m_cfg.resolution0 > 0 && m_cfg.resolution1 > 0 && m_cfg.maxChi2 > 0)) {
+        error("Invalid configuration: the resolutions and maxChi2 have to be positive");
+        throw std::runtime_error("Invalid configuration: the resolutions and maxChi2 have to be positive");
+    }
+
+    // the 3x3 bins around the one of a projection cover its search window
+    m_binSize0 = m_cfg.resolution0 * std::sqrt(m_cfg.maxChi2);
+    m_binSize1 = m_cfg.resolution1 * std::sqrt(m_cfg.maxChi2);
+    if (m_cfg.etaPhi) {
+        m_phiBins = std::max<std::int64_t>(1, static_cast<std::int64_t>(2 * M_PI / m_binSize1));
+        m_binSize1 = 2 * M_PI / m_phiBins;
+    }
+    debug("Matching to system {} surface {} in bins of {} x {}", m_systemID, m_cfg.surfaceLayer, m_binSize0, m_binSize1);
+}
+
+std::pair<double, double> TrackClusterMatching::coordinates(const edm4hep::Vector3f& position) const {
+    if (m_cfg.etaPhi) {
+        return {edm4hep::utils::eta(position), edm4hep::utils::angleAzimuthal(position)};
+    }
+    return {position.x, position.y};
+}
+
+void TrackClusterMatching::process(
+    const TrackClusterMatching::Input& input,
+    const TrackClusterMatching::Output& output) const {
+
+    const auto [inparts, projections, clusters] = input;
+    auto [outparts] = output;
+
+    // 1. Bin the clusters, chained through the index of the next cluster of their bin
+    std::vector<double> cluster0(clusters->size());
+    std::vector<double> cluster1(clusters->size());
+    std::vector<std::size_t> nextInBin(clusters->size(), no_index);
+    std::unordered_map<std::uint64_t, std::size_t> firstInBin;
+    firstInBin.reserve(clusters->size());
+
+    const auto bin0 = [this](double c0) { return static_cast<std::int64_t>(std::floor(c0 / m_binSize0)); };
+    const auto bin1 = [this](double c1) {
+        if (m_cfg.etaPhi) {
+            const auto bin = static_cast<std::int64_t>(std::floor((c1 + M_PI) / m_binSize1));
+            return std::clamp<std::int64_t>(bin, 0, m_phiBins - 1);
+        }
+        return static_cast<std::int64_t>(std::floor(c1 / m_binSize1));
+    };
+    // coordinates beyond the range of the bins, e.g. on the beam axis, are not matched
+    const auto binnable = [this](double c0, double c1) {
+        return std::abs(c0 / m_binSize0) < std::numeric_limits<std::int32_t>::max()
+            && std::abs(c1 / m_binSize1) < std::numeric_limits<std::int32_t>::max();
+    };
+
+    for (std::size_t i = 0; i < clusters->size(); ++i) {
+        std::tie(cluster0[i], cluster1[i]) = coordinates((*clusters)[i].getPosition());
+        if (!binnable(cluster0[i], cluster1[i])) {
+            continue;
+        }
+        auto [it, inserted] = firstInBin.try_emplace(bin_key(bin0(cluster0[i]), bin1(cluster1[i])), i);
+        if (!inserted) {
+            nextInBin[i] = it->second;
+            it->second = i;
+        }
+    }
+
+    // 2. Projected points of the tracks on the surface of the calorimeter
+    std::unordered_map<std::uint64_t, edm4hep::Vector3f> projection;
+    projection.reserve(projections->size());
+    for (const auto segment : *projections) {
+        if (!segment.getTrack().isAvailable()) {
+            continue;
+        }
+        for (const auto& point : segment.getPoints()) {
+            const bool on_surface = (point.surface & surface_extra_mask) == m_systemID
+                && static_cast<int>((point.surface & surface_layer_mask) >> surface_layer_shift) == m_cfg.surfaceLayer;
+            if (on_surface) {
+                projection.emplace(object_key(segment.getTrack().getObjectID()), point.position);
+                break;
+            }
+        }
+    }
+
+    // 3. Closest cluster of every particle, and closest particle of every cluster
+    std::vector<std::size_t> particleMatch(inparts->size(), no_index);
+    std::vector<double> clusterChi2(clusters->size(), std::numeric_limits<double>::infinity());
+    std::vector<std::size_t> clusterMatch(clusters->size(), no_index);
+
+    for (std::size_t ipart = 0; ipart < inparts->size(); ++ipart) {
+        const auto inpart = (*inparts)[ipart];
+        if (inpart.getTracks().empty()) {
+            continue;
+        }
+        const auto point = projection.find(object_key(inpart.getTracks()[0].getObjectID()));
+        if (point == projection.end()) {
+            trace("Particle {} has no projection to the surface", ipart);
+            continue;
+        }
+        const auto [point0, point1] = coordinates(point->second);
+        if (!binnable(point0, point1)) {
+            continue;
+        }
+
+        const std::int64_t center0 = bin0(point0);
+        const std::int64_t center1 = bin1(point1);
+        // the phi bins wrap around, and are looked up once if there are less than three
+        const std::int64_t n1 = (m_cfg.etaPhi && m_phiBins < 3) ? m_phiBins : 3;
+        double best = m_cfg.maxChi2;
+        for (std::int64_t d0 = -1; d0 <= 1; ++d0) {
+            for (std::int64_t d1 = 0; d1 < n1; ++d1) {
+                std::int64_t b1 = center1 + d1 - 1;
+                if (m_cfg.etaPhi) {
+                    b1 = (n1 < 3) ? d1 : (b1 + m_phiBins) % m_phiBins;
+                }
+                const auto bin = firstInBin.find(bin_key(center0 + d0, b1));
+                if (bin == firstInBin.end()) {
+                    continue;
+                }
+                for (std::size_t icluster = bin->second; icluster != no_index; icluster = nextInBin[icluster]) {
+                    double delta1 = cluster1[icluster] - point1;
+                    if (m_cfg.etaPhi) {
+                        delta1 = std::remainder(delta1, 2 * M_PI);
+                    }
+                    const double chi2 = std::pow((cluster0[icluster] - point0) / m_cfg.resolution0, 2)
+                                      + std::pow(delta1 / m_cfg.resolution1, 2);
+                    if (chi2 < best) {
+                        best = chi2;
+                        particleMatch[ipart] = icluster;
+                    }
+                    if (chi2 < m_cfg.maxChi2 && chi2 < clusterChi2[icluster]) {
+                        clusterChi2[icluster] = chi2;
+                        clusterMatch[icluster] = ipart;
+                    }
+                }
+            }
+        }
+        trace("Particle {} closest to cluster {} with chi2 {}", ipart,
+              particleMatch[ipart] == no_index ? -1 : static_cast<long>(particleMatch[ipart]), best);
+    }
+
+    // 4. A cluster goes to a particle if they are closest to each other
+    std::size_t matched = 0;
+    for (std::size_t ipart = 0; ipart < inparts->size(); ++ipart) {
+        auto outpart = (*inparts)[ipart].clone();
+        const std::size_t icluster = particleMatch[ipart];
+        if (icluster != no_index && clusterMatch[icluster] == ipart) {
+            outpart.addToClusters((*clusters)[icluster]);
+            ++matched;
+        }
+        outparts->push_back(outpart);
+    }
+    debug("Matched {} of {} particles to {} clusters", matched, inparts->size(), clusters->size());
+}
+
+} // namespace eicrecon
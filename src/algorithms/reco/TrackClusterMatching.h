@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+// Takes a list of particles (presumed to be from tracking), their projections to the
+// calorimeters, and the clusters of one calorimeter.
+// 1. Bins the clusters in the coordinates of the match
+// 2. Looks up the clusters around the projection of every track in the bins around it
+// 3. Adds to each particle the closest cluster, if the particle is also the closest one to it
+
+#pragma once
+
+#include <DD4hep/Detector.h>
+#include <algorithms/algorithm.h>
+#include <algorithms/geo.h>
+#include <edm4eic/ClusterCollection.h>
+#include <edm4eic/ReconstructedParticleCollection.h>
+#include <edm4eic/TrackSegmentCollection.h>
+#include <edm4hep/Vector3f.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "algorithms/interfaces/WithPodConfig.h"
+#include "algorithms/reco/TrackClusterMatchingConfig.h"
+
+namespace eicrecon {
+
+  using TrackClusterMatchingAlgorithm = algorithms::Algorithm<
+    algorithms::Input<
+      edm4eic::ReconstructedParticleCollection,
+      edm4eic::TrackSegmentCollection,
+      edm4eic::ClusterCollection
+    >,
+    algorithms::Output<
+      edm4eic::ReconstructedParticleCollection
+    >
+  >;
+
+  class TrackClusterMatching
+  : public TrackClusterMatchingAlgorithm,
+    public WithPodConfig<TrackClusterMatchingConfig> {
+
+  public:
+    TrackClusterMatching(std::string_view name)
+      : TrackClusterMatchingAlgorithm{name,
+            {"inputParticles", "inputTrackProjections", "inputClusters"},
+            {"outputParticles"},
+            "Match tracks with the clusters around their projections to a calorimeter."} {}
+
+    void init() final;
+    void process(const Input&, const Output&) const final;
+
+  private:
+    // coordinates of a position in which the clusters are binned and matched
+    std::pair<double, double> coordinates(const edm4hep::Vector3f& position) const;
+
+    const dd4hep::Detector* m_detector{algorithms::GeoSvc::instance().detector()};
+
+    std::uint32_t m_systemID{0};
+    // bin sizes, at least the search windows, and the number of the phi bins
+    double m_binSize0{0};
+    double m_binSize1{0};
+    std::int64_t m_phiBins{0};
+  };
+
+} // namespace eicrecon
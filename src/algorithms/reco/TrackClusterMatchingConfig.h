@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <string>
+
+namespace eicrecon {
+
+  struct TrackClusterMatchingConfig {
+
+    // DD4hep constant of the system ID of the calorimeter, and the target surface of
+    // TrackPropagation in front of it, counted from 1 in the order of its configuration
+    std::string calorimeterID{};
+    int surfaceLayer{1};
+
+    // Clusters are compared with the projected points in (eta, phi) as seen from the
+    // origin, or in the transverse (x, y) for the disc surfaces of the endcaps
+    bool etaPhi{true};
+    double resolution0{0.02}; // eta, or x [mm]
+    double resolution1{0.02}; // phi [rad], or y [mm]
+
+    // chi2 of the two coordinates of a match, the search window is sqrt(maxChi2) resolutions
+    double maxChi2{9.};
+
+  };
+
+} // eicrecon
@@ -5,6 +5,7 @@
 #include "TransformBreitFrame.h"
 
 #include <Math/GenVector/Boost.h>
+#include <Math/GenVector/LorentzRotation.h>
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/DisplacementVector3D.h>
 #include <Math/GenVector/LorentzVector.h>
@@ -15,8 +16,10 @@
 #include <edm4hep/utils/kinematics.h>
 #include <fmt/core.h>
 #include <gsl/pointers>
+#include <cstddef>
 
 #include "Beam.h"
+#include "Boost.h"
 
 namespace eicrecon {
 
@@ -113,17 +116,22 @@ namespace eicrecon {
     debug("virtual photon in Breit frame px,py,pz,E = {},{},{},{}",
                  virtual_photon_breit.Px(),virtual_photon_breit.Py(),virtual_photon_breit.Pz(),virtual_photon_breit.E());
 
-    // look over the input particles and transform
+    // Transform all the input particles to the Breit frame at once
+    const LorentzTransform to_breit(ROOT::Math::LorentzRotation(breitRot) * ROOT::Math::LorentzRotation(breit));
+    FourMomenta breit_particles;
     for (const auto& lab : *lab_collection) {
+      breit_particles.push_back(lab.getMomentum().x, lab.getMomentum().y, lab.getMomentum().z, lab.getEnergy());
+    }
+    to_breit(breit_particles);
 
-      // Transform to Breit frame
-      PxPyPzEVector lab_particle(lab.getMomentum().x,lab.getMomentum().y,lab.getMomentum().z,lab.getEnergy());
-      PxPyPzEVector breit_particle = breitRot*(breit*lab_particle);
+    // look over the input particles
+    for (std::size_t i = 0; i < lab_collection->size(); ++i) {
+      const auto lab = (*lab_collection)[i];
 
       // create particle to store in output collection
       auto breit_out = breit_collection->create();
-      breit_out.setMomentum(edm4hep::Vector3f(breit_particle.Px(), breit_particle.Py(), breit_particle.Pz()));
-      breit_out.setEnergy(breit_particle.E());
+      breit_out.setMomentum(edm4hep::Vector3f(breit_particles.px[i], breit_particles.py[i], breit_particles.pz[i]));
+      breit_out.setEnergy(breit_particles.E[i]);
 
       // Copy the rest of the particle information
       breit_out.setType(lab.getType());
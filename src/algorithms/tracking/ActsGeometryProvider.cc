@@ -19,17 +19,26 @@
 #include <Acts/Visualization/PlyVisualization3D.hpp>
 #include <DD4hep/DetElement.h>
 #include <DD4hep/VolumeManager.h>
+#include <DD4hep/detail/VolumeManagerInterna.h>
 #include <JANA/JException.h>
 #include <TGeoManager.h>
 #include <fmt/core.h>
 #include <fmt/ostream.h>
+#include <nlohmann/json.hpp>
 #include <spdlog/common.h>
+#include <algorithm>
+#include <cstdint>
 #include <exception>
+#include <fstream>
 #include <initializer_list>
+#include <iterator>
 #include <type_traits>
+#include <vector>
 
 #include "ActsGeometryProvider.h"
+#include "MaterialMapCache.h"
 #include "extensions/spdlog/SpdlogToActs.h"
+#include "services/log/StartupProfile.h"
 
 // Formatter for Eigen matrices
 #if FMT_VERSION >= 90000
@@ -45,6 +54,47 @@ struct fmt::formatter<
 > : fmt::ostream_formatter {};
 #endif // FMT_VERSION >= 90000
 
+std::shared_ptr<const Acts::IMaterialDecorator> ActsGeometryProvider::loadMaterialMap(
+        const std::string& material_file, Acts::Logging::Level level) const {
+
+    eicrecon::StartupProfile::Scope profile("ACTS material map");
+
+    // Set up the converter first
+    Acts::MaterialMapJsonConverter::Config jsonGeoConvConfig;
+
+    const std::uint64_t key = m_materialMapCacheDir.empty() ? 0 : eicrecon::material_map_cache::key(material_file);
+    if (key == 0) {
+        // Set up the json-based decorator
+        return std::make_shared<const Acts::JsonMaterialDecorator>(jsonGeoConvConfig, material_file, level);
+    }
+
+    const std::string cache_path = fmt::format("{}/material_{:016x}.bin", m_materialMapCacheDir, key);
+    if (auto maps = eicrecon::material_map_cache::read(cache_path, key)) {
+        m_init_log->info("materials map read from the cache: '{}'", cache_path);
+        return std::make_shared<const eicrecon::MaterialMapDecorator>(std::move(*maps));
+    }
+
+    // Same parsing as Acts::JsonMaterialDecorator, which does not give access to the maps
+    nlohmann::json jin;
+    if (material_file.find(".cbor") != std::string::npos) {
+        std::ifstream ifc(material_file, std::ios::binary);
+        std::vector<std::uint8_t> cbor((std::istreambuf_iterator<char>(ifc)), std::istreambuf_iterator<char>());
+        jin = nlohmann::json::from_cbor(cbor);
+    } else {
+        std::ifstream ifj(material_file);
+        ifj >> jin;
+    }
+    Acts::MaterialMapJsonConverter converter(jsonGeoConvConfig, level);
+    eicrecon::DetectorMaterialMaps maps = converter.jsonToMaterialTracking(jin);
+
+    if (eicrecon::material_map_cache::write(cache_path, key, maps)) {
+        m_init_log->info("materials map written to the cache: '{}'", cache_path);
+    } else {
+        m_init_log->debug("materials map can not be cached in '{}'", m_materialMapCacheDir);
+    }
+    return std::make_shared<const eicrecon::MaterialMapDecorator>(std::move(maps));
+}
+
 void ActsGeometryProvider::initialize(const dd4hep::Detector* dd4hep_geo,
                                       std::string material_file,
                                       std::shared_ptr<spdlog::logger> log,
@@ -70,10 +120,7 @@ void ActsGeometryProvider::initialize(const dd4hep::Detector* dd4hep_geo,
     std::shared_ptr<const Acts::IMaterialDecorator> materialDeco{nullptr};
     if (!material_file.empty()) {
         m_init_log->info("loading materials map from file: '{}'", material_file);
-        // Set up the converter first
-        Acts::MaterialMapJsonConverter::Config jsonGeoConvConfig;
-        // Set up the json-based decorator
-        materialDeco = std::make_shared<const Acts::JsonMaterialDecorator>(jsonGeoConvConfig, material_file, acts_init_log_level);
+        materialDeco = loadMaterialMap(material_file, acts_init_log_level);
     }
 
     // Geometry identifier hook to write detector ID to extra field
@@ -178,6 +225,7 @@ void ActsGeometryProvider::initialize(const dd4hep::Detector* dd4hep_geo,
 
             this->m_surfaces.insert_or_assign(vol_id, surface);
         });
+        buildSensorSurfaces();
     }
     else {
         m_init_log->error("m_trackingGeo==null why am I still alive???");
@@ -185,7 +233,11 @@ void ActsGeometryProvider::initialize(const dd4hep::Detector* dd4hep_geo,
 
     // Load ACTS magnetic field
     m_init_log->info("Loading magnetic field...");
-    m_magneticField = std::make_shared<const eicrecon::BField::DD4hepBField>(m_dd4hepDetector);
+    m_magneticField = std::make_shared<const eicrecon::BField::DD4hepBField>(m_dd4hepDetector, m_fieldGrid);
+    if (m_magneticField->usesGrid()) {
+        m_init_log->info("Magnetic field is interpolated on a {} grid{}", m_fieldGrid.rz ? "r-z" : "x-y-z",
+                         m_magneticField->gridFromCache() ? " (read from the cache)" : "");
+    }
     Acts::MagneticFieldContext m_fieldctx{eicrecon::BField::BFieldVariant(m_magneticField)};
     auto bCache = m_magneticField->makeCache(m_fieldctx);
     for (int z: {0, 500, 1000, 1500, 2000, 3000, 4000}) {
@@ -195,3 +247,44 @@ void ActsGeometryProvider::initialize(const dd4hep::Detector* dd4hep_geo,
 
     m_init_log->info("ActsGeometryProvider initialization complete");
 }
+
+void ActsGeometryProvider::buildSensorSurfaces() {
+    auto volman = m_dd4hepDetector->volumeManager();
+    m_systemMask = volman.ptr()->sysMask;
+
+    m_sensorSurfaces.clear();
+    m_volumeMasks.clear();
+    m_sensorSurfaces.reserve(m_surfaces.size());
+    for (const auto& [vol_id, surface] : m_surfaces) {
+        SensorSurface sensor{vol_id, surface, std::nullopt};
+        if (surface->type() == Acts::Surface::Plane) {
+            // geometry context contains nothing here, as in the measurement conversion
+            sensor.globalToLocal = surface->transform(Acts::GeometryContext()).inverse();
+        }
+        m_sensorSurfaces.push_back(sensor);
+
+        const uint64_t system = vol_id & m_systemMask;
+        if (std::none_of(m_volumeMasks.begin(), m_volumeMasks.end(), [system](const auto& p) { return p.first == system; })) {
+            m_volumeMasks.emplace_back(system, volman.subdetector(vol_id).ptr()->detMask);
+        }
+    }
+    std::sort(m_sensorSurfaces.begin(), m_sensorSurfaces.end(),
+              [](const SensorSurface& a, const SensorSurface& b) { return a.volumeID < b.volumeID; });
+    std::sort(m_volumeMasks.begin(), m_volumeMasks.end());
+    m_init_log->debug("{} sensor surfaces in {} systems", m_sensorSurfaces.size(), m_volumeMasks.size());
+}
+
+const ActsGeometryProvider::SensorSurface* ActsGeometryProvider::sensorSurface(uint64_t cellID) const {
+    const uint64_t system = cellID & m_systemMask;
+    auto mask = std::lower_bound(m_volumeMasks.begin(), m_volumeMasks.end(), std::pair<uint64_t, uint64_t>{system, 0});
+    if ((mask == m_volumeMasks.end()) || (mask->first != system)) {
+        return nullptr;
+    }
+    const uint64_t vol_id = cellID & mask->second;
+    auto it = std::lower_bound(m_sensorSurfaces.begin(), m_sensorSurfaces.end(), vol_id,
+                               [](const SensorSurface& sensor, uint64_t id) { return sensor.volumeID < id; });
+    if ((it == m_sensorSurfaces.end()) || (it->volumeID != vol_id)) {
+        return nullptr;
+    }
+    return &*it;
+}
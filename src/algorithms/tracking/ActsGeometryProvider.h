@@ -4,10 +4,12 @@
 #pragma once
 
 // ACTS
+#include <Acts/Definitions/Algebra.hpp>
 #include <Acts/Definitions/Units.hpp>
 #include <Acts/Geometry/GeometryContext.hpp>
 #include <Acts/Geometry/TrackingGeometry.hpp>
 #include <Acts/MagneticField/MagneticFieldProvider.hpp>
+#include <Acts/Material/IMaterialDecorator.hpp>
 #include <Acts/Surfaces/Surface.hpp>
 #include <Acts/Utilities/Logger.hpp>
 #include <Acts/Visualization/ViewConfig.hpp>
@@ -21,8 +23,11 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "DD4hepBField.h"
 
@@ -60,6 +65,20 @@ public:
 
     const VolumeSurfaceMap &surfaceMap() const  { return m_surfaces; }
 
+    /// Sensitive surface of a readout volume, with its cached global to local transform
+    struct SensorSurface {
+        uint64_t volumeID;
+        const Acts::Surface* surface;
+        /// inverse surface transform, only set for plane surfaces
+        std::optional<Acts::Transform3> globalToLocal;
+    };
+
+    /** Sensor surface of the volume of a cellID, nullptr if there is none.
+     *  Same result as the surfaceMap() entry of the volume identifier from
+     *  CellIDPositionConverter::findContext(), without the volume manager lookups.
+     */
+    const SensorSurface* sensorSurface(uint64_t cellID) const;
+
 
     std::map<int64_t, dd4hep::rec::Surface *> getDD4hepSurfaceMap() const { return m_surfaceMap; }
 
@@ -96,6 +115,17 @@ private:
     /// ACTS surface lookup container for hit surfaces that generate smeared hits
     VolumeSurfaceMap m_surfaces;
 
+    /// Flat sensor surface lookup, sorted by volume ID, and the volume ID mask of
+    /// every system (system bits of the cellID, mask), sorted by system
+    void buildSensorSurfaces();
+    std::vector<SensorSurface> m_sensorSurfaces;
+    uint64_t m_systemMask{0};
+    std::vector<std::pair<uint64_t, uint64_t>> m_volumeMasks;
+
+    /// Material decorator of a material map file, parsed or read from the cache
+    std::shared_ptr<const Acts::IMaterialDecorator> loadMaterialMap(const std::string& material_file,
+                                                                    Acts::Logging::Level level) const;
+
     /// Acts magnetic field
     std::shared_ptr<const eicrecon::BField::DD4hepBField> m_magneticField = nullptr;
 
@@ -117,6 +147,8 @@ private:
     bool m_plyWriteIt{false};
     std::string m_outputTag{""};
     std::string m_outputDir{""};
+    eicrecon::BField::DD4hepBField::GridConfig m_fieldGrid;
+    std::string m_materialMapCacheDir{""};
 
 public:
     void setObjWriteIt(bool writeit) { m_objWriteIt = writeit; }
@@ -129,6 +161,12 @@ public:
     void setOutputDir(std::string dir) { m_outputDir = dir; }
     std::string getOutputDir() const { return m_outputDir; }
 
+    void setFieldGrid(eicrecon::BField::DD4hepBField::GridConfig grid) { m_fieldGrid = std::move(grid); }
+    const eicrecon::BField::DD4hepBField::GridConfig& getFieldGrid() const { return m_fieldGrid; }
+
+    void setMaterialMapCacheDir(std::string dir) { m_materialMapCacheDir = std::move(dir); }
+    const std::string& getMaterialMapCacheDir() const { return m_materialMapCacheDir; }
+
     void setContainerView(std::array<int,3> view) { m_containerView = Acts::ViewConfig{view}; }
     const Acts::ViewConfig& getContainerView() const { return m_containerView; }
     void setVolumeView(std::array<int,3> view) { m_volumeView = Acts::ViewConfig{view}; }
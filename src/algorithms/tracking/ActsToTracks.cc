@@ -12,32 +12,18 @@
 #include <edm4hep/Vector3f.h>
 #include <fmt/core.h>
 #include <Eigen/Core>
-#include <array>
 #include <cmath>
 #include <cstddef>
 #include <gsl/pointers>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "ActsToTracks.h"
+#include "CovarianceConversion.h"
 
 namespace eicrecon {
 
-// This array relates the Acts and EDM4eic covariance matrices, including
-// the unit conversion to get from Acts units into EDM4eic units.
-//
-// Note: std::map is not constexpr, so we use a constexpr std::array
-// std::array initialization need double braces since arrays are aggregates
-// ref: https://en.cppreference.com/w/cpp/language/aggregate_initialization
-static constexpr std::array<std::pair<Acts::BoundIndices, double>, 6> edm4eic_indexed_units{{
-  {Acts::eBoundLoc0, Acts::UnitConstants::mm},
-  {Acts::eBoundLoc1, Acts::UnitConstants::mm},
-  {Acts::eBoundPhi, 1.},
-  {Acts::eBoundTheta, 1.},
-  {Acts::eBoundQOverP, 1. / Acts::UnitConstants::GeV},
-  {Acts::eBoundTime, Acts::UnitConstants::ns}
-}};
-
 void ActsToTracks::init() {
 }
 
@@ -45,8 +31,22 @@ void ActsToTracks::process(const Input& input, const Output& output) const {
   const auto [meas2Ds, acts_trajectories] = input;
   auto  [trajectories, track_parameters, tracks] = output;
 
-  // Loop over trajectories
+  // Convert the covariances of all track heads in one batch, with the same
+  // selection of the tips as the loop below so that i_cov follows it
+  std::vector<const Acts::BoundSquareMatrix*> acts_covariances;
   for (const auto traj : acts_trajectories) {
+    for (auto trackTip : traj->tips()) {
+      if (not traj->hasTrackParameters(trackTip)) {
+        continue;
+      }
+      acts_covariances.push_back(&*traj->trackParameters(trackTip).covariance());
+    }
+  }
+  std::vector<edm4eic::Cov6f> covariances(acts_covariances.size());
+  covariance_conversion::to_edm4eic(acts_covariances, covariances);
+
+  // Loop over trajectories
+  for (std::size_t i_cov = 0; const auto traj : acts_trajectories) {
     // The trajectory entry indices and the multiTrajectory
     const auto& trackTips = traj->tips();
     const auto& mj = traj->multiTrajectory();
@@ -106,14 +106,7 @@ void ActsToTracks::process(const Input& input, const Output& output) const {
       pars.setPhi(static_cast<float>(parameter[Acts::eBoundPhi]));
       pars.setQOverP(static_cast<float>(parameter[Acts::eBoundQOverP]));
       pars.setTime(static_cast<float>(parameter[Acts::eBoundTime]));
-      edm4eic::Cov6f cov;
-      for (size_t i = 0; const auto& [a, x] : edm4eic_indexed_units) {
-        for (size_t j = 0; const auto& [b, y] : edm4eic_indexed_units) {
-          // FIXME why not pars.getCovariance()(i,j) = covariance(a,b) / x / y;
-          cov(i,j) = covariance(a,b) / x / y;
-        }
-      }
-      pars.setCovariance(cov);
+      pars.setCovariance(covariances[i_cov++]);
 
       trajectory.addToTrackParameters(pars);
 
@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "AdaptiveVertexFinder.h"
+
+#include <Acts/Definitions/Units.hpp>
+#include <Acts/EventData/GenericBoundTrackParameters.hpp>
+#include <Acts/EventData/TrackParameters.hpp>
+#include <Acts/Propagator/EigenStepper.hpp>
+#include <Acts/Propagator/Propagator.hpp>
+#include <Acts/Propagator/detail/VoidPropagatorComponents.hpp>
+#include <Acts/Utilities/AnnealingUtility.hpp>
+#include <Acts/Utilities/Logger.hpp>
+#include <Acts/Utilities/Result.hpp>
+#include <Acts/Vertexing/AdaptiveMultiVertexFinder.hpp>
+#include <Acts/Vertexing/AdaptiveMultiVertexFitter.hpp>
+#include <Acts/Vertexing/GaussianGridTrackDensity.hpp>
+#include <Acts/Vertexing/GridDensityVertexFinder.hpp>
+#include <Acts/Vertexing/HelicalTrackLinearizer.hpp>
+#include <Acts/Vertexing/ImpactPointEstimator.hpp>
+#include <Acts/Vertexing/Vertex.hpp>
+#include <Acts/Vertexing/VertexingOptions.hpp>
+#include <ActsExamples/EventData/Trajectories.hpp>
+#include <edm4eic/Cov4f.h>
+#include <Eigen/Core>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "extensions/spdlog/SpdlogToActs.h"
+
+void eicrecon::AdaptiveVertexFinder::init(std::shared_ptr<const ActsGeometryProvider> geo_svc,
+                                          std::shared_ptr<spdlog::logger> log) {
+
+  m_log = log;
+
+  m_geoSvc = geo_svc;
+
+  m_BField =
+      std::dynamic_pointer_cast<const eicrecon::BField::DD4hepBField>(m_geoSvc->getFieldProvider());
+  m_fieldctx = eicrecon::BField::BFieldVariant(m_BField);
+
+  ACTS_LOCAL_LOGGER(eicrecon::getSpdlogLogger("AMVF", m_log));
+
+  Acts::EigenStepper<> stepper(m_BField);
+
+  // Set up propagator with void navigator
+  m_propagator = std::make_shared<Propagator>(
+    stepper, Acts::detail::VoidNavigator{}, logger().cloneWithSuffix("Prop"));
+
+  ImpactPointEstimator::Config ipEstCfg(m_BField, m_propagator);
+  ImpactPointEstimator ipEst(ipEstCfg);
+
+  // Setup the track linearizer
+  Linearizer::Config linearizerCfg(m_BField, m_propagator);
+  Linearizer linearizer(linearizerCfg, logger().cloneWithSuffix("HelLin"));
+
+  // Setup the vertex fitter with deterministic annealing, the candidates are fitted together
+  Acts::AnnealingUtility::Config annealingCfg;
+  annealingCfg.setOfTemperatures = {8.0, 4.0, 2.0, 1.4142136, 1.2247449, 1.0};
+  VertexFitter::Config vertexFitterCfg(ipEst);
+  vertexFitterCfg.annealingTool     = Acts::AnnealingUtility(annealingCfg);
+  vertexFitterCfg.minWeight         = 0.001;
+  vertexFitterCfg.doSmoothing       = true;
+  vertexFitterCfg.useTime           = m_cfg.useTime;
+  vertexFitterCfg.maxDistToLinPoint = m_cfg.maxDistToLinPoint * Acts::UnitConstants::mm;
+  #if Acts_VERSION_MAJOR >= 31
+  VertexFitter vertexFitter(std::move(vertexFitterCfg), logger().cloneWithSuffix("AMVFitter"));
+  #else
+  VertexFitter vertexFitter(vertexFitterCfg, logger().cloneWithSuffix("AMVFitter"));
+  #endif
+
+  // Setup the seed finder on a grid of the track density in z, which is updated for the
+  // tracks removed by the finder instead of being filled again at every iteration
+  Acts::GaussianGridTrackDensity<mainGridSize, trkGridSize>::Config densityCfg(
+    m_cfg.gridZRange * Acts::UnitConstants::mm);
+  VertexSeeder::Config seederCfg(densityCfg);
+  seederCfg.cacheGridStateForTrackRemoval = true;
+  VertexSeeder seeder(seederCfg);
+
+  // Set up the actual vertex finder
+  VertexFinder::Config finderCfg(std::move(vertexFitter), seeder, ipEst,
+                                 std::move(linearizer), m_BField);
+  finderCfg.maxIterations         = m_cfg.maxIterations;
+  finderCfg.useTime               = m_cfg.useTime;
+  finderCfg.doFullSplitting       = m_cfg.doFullSplitting;
+  finderCfg.tracksMaxZinterval    = m_cfg.tracksMaxZinterval * Acts::UnitConstants::mm;
+  finderCfg.tracksMaxSignificance = m_cfg.tracksMaxSignificance;
+  finderCfg.maxVertexChi2         = m_cfg.maxVertexChi2;
+  #if Acts_VERSION_MAJOR >= 31
+  m_vertexFinder = std::make_unique<VertexFinder>(std::move(finderCfg), logger().clone());
+  #else
+  m_vertexFinder = std::make_unique<VertexFinder>(finderCfg, logger().clone());
+  #endif
+}
+
+std::unique_ptr<edm4eic::VertexCollection> eicrecon::AdaptiveVertexFinder::produce(
+    std::span<const ActsExamples::Trajectories* const> trajectories) {
+
+  auto outputVertices = std::make_unique<edm4eic::VertexCollection>();
+
+  using VertexFinderOptions = Acts::VertexingOptions<Acts::BoundTrackParameters>;
+
+  VertexFinder::State state;
+  VertexFinderOptions finderOpts(m_geoctx, m_fieldctx);
+
+  std::vector<const Acts::BoundTrackParameters*> inputTrackPointers;
+
+  for (const auto& trajectory : trajectories) {
+    auto tips = trajectory->tips();
+    if (tips.empty()) {
+      continue;
+    }
+    /// CKF can provide multiple track trajectories for a single input seed
+    for (auto& tip : tips) {
+      inputTrackPointers.push_back(&(trajectory->trackParameters(tip)));
+    }
+  }
+
+  std::vector<Acts::Vertex<Acts::BoundTrackParameters>> vertices;
+  auto result = m_findTimer.time([&] { return m_vertexFinder->find(inputTrackPointers, finderOpts, state); });
+  if (result.ok()) {
+    vertices = std::move(result.value());
+  } else {
+    m_log->debug("Vertex finding failed: {}", result.error().message());
+  }
+
+  m_findTimer.debug(*m_log, vertices.size(), inputTrackPointers.size());
+
+  for (const auto& vtx : vertices) {
+    edm4eic::Cov4f cov(vtx.fullCovariance()(0,0), vtx.fullCovariance()(1,1), vtx.fullCovariance()(2,2), vtx.fullCovariance()(3,3),
+                       vtx.fullCovariance()(0,1), vtx.fullCovariance()(0,2), vtx.fullCovariance()(0,3),
+                       vtx.fullCovariance()(1,2), vtx.fullCovariance()(1,3),
+                       vtx.fullCovariance()(2,3));
+    auto eicvertex = outputVertices->create();
+    eicvertex.setType(1);                                  // boolean flag if vertex is primary vertex of event
+    eicvertex.setChi2((float)vtx.fitQuality().first);      // chi2
+    eicvertex.setNdf((float)vtx.fitQuality().second);      // ndf
+    eicvertex.setPosition({
+         (float)vtx.position().x(),
+         (float)vtx.position().y(),
+         (float)vtx.position().z(),
+         (float)vtx.time(),
+    }); // vtxposition
+    eicvertex.setPositionError(cov);                          // covariance
+  }
+
+  return outputVertices;
+}
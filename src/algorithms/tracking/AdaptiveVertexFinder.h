@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <Acts/EventData/TrackParameters.hpp>
+#include <Acts/Geometry/GeometryContext.hpp>
+#include <Acts/MagneticField/MagneticFieldContext.hpp>
+#include <Acts/Propagator/EigenStepper.hpp>
+#include <Acts/Propagator/Propagator.hpp>
+#include <Acts/Vertexing/AdaptiveMultiVertexFinder.hpp>
+#include <Acts/Vertexing/AdaptiveMultiVertexFitter.hpp>
+#include <Acts/Vertexing/GridDensityVertexFinder.hpp>
+#include <Acts/Vertexing/HelicalTrackLinearizer.hpp>
+#include <Acts/Vertexing/ImpactPointEstimator.hpp>
+#include <edm4eic/VertexCollection.h>
+#include <spdlog/logger.h>
+#include <memory>
+#include <span>
+
+#include "ActsExamples/EventData/Trajectories.hpp"
+#include "ActsGeometryProvider.h"
+#include "AdaptiveVertexFinderConfig.h"
+#include "DD4hepBField.h"
+#include "VertexFindingTimer.h"
+#include "algorithms/interfaces/WithPodConfig.h"
+
+namespace eicrecon {
+
+/**
+ * Vertex finding with the Acts adaptive multi-vertex finder
+ *
+ * Unlike IterativeVertexFinder, which fits one vertex at a time and removes its
+ * tracks, the candidates are fitted together with deterministic annealing, and a
+ * track is shared between them by weight. The seeds come from a grid of the
+ * track density in z, which is updated for the removed tracks rather than
+ * rebuilt at every iteration, and the linearized tracks of a vertex are reused
+ * until it moves by more than maxDistToLinPoint.
+ */
+class AdaptiveVertexFinder
+    : public eicrecon::WithPodConfig<eicrecon::AdaptiveVertexFinderConfig> {
+public:
+  void init(std::shared_ptr<const ActsGeometryProvider> geo_svc,
+            std::shared_ptr<spdlog::logger> log);
+  std::unique_ptr<edm4eic::VertexCollection>
+  produce(std::span<const ActsExamples::Trajectories* const> trajectories);
+
+private:
+  // 0.125 mm bins of the density of the tracks with the default gridZRange
+  static constexpr int mainGridSize = 4000;
+  static constexpr int trkGridSize  = 55;
+
+  using Propagator           = Acts::Propagator<Acts::EigenStepper<>>;
+  using Linearizer           = Acts::HelicalTrackLinearizer<Propagator>;
+  using VertexFitter         = Acts::AdaptiveMultiVertexFitter<Acts::BoundTrackParameters, Linearizer>;
+  using ImpactPointEstimator = Acts::ImpactPointEstimator<Acts::BoundTrackParameters, Propagator>;
+  using VertexSeeder         = Acts::GridDensityVertexFinder<mainGridSize, trkGridSize>;
+  using VertexFinder         = Acts::AdaptiveMultiVertexFinder<VertexFitter, VertexSeeder>;
+
+  std::shared_ptr<spdlog::logger> m_log;
+  std::shared_ptr<const ActsGeometryProvider> m_geoSvc;
+
+  std::shared_ptr<const eicrecon::BField::DD4hepBField> m_BField = nullptr;
+  Acts::GeometryContext m_geoctx;
+  Acts::MagneticFieldContext m_fieldctx;
+
+  // built once in init(), the per-event state lives in VertexFinder::State
+  std::shared_ptr<Propagator> m_propagator;
+  std::unique_ptr<VertexFinder> m_vertexFinder;
+
+  VertexFindingTimer m_findTimer;
+};
+
+} // namespace eicrecon
@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+namespace eicrecon {
+
+struct AdaptiveVertexFinderConfig {
+  int    maxIterations         = 100;
+  bool   useTime               = false;
+  bool   doFullSplitting       = false;
+  double tracksMaxZinterval    = 1.;    // mm, tracks closer than this in z to a seed fit with it
+  double tracksMaxSignificance = 5.;
+  double maxVertexChi2         = 18.42;
+  double gridZRange            = 250.;  // mm, half length in z of the density grid of the seeder
+  double maxDistToLinPoint     = 0.5;   // mm, tracks are relinearized once their vertex moved further
+};
+
+} // namespace eicrecon
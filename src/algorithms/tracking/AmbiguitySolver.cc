@@ -63,7 +63,7 @@ void AmbiguitySolver::init(std::shared_ptr<spdlog::logger> log) {
 
 
 std::tuple<std::vector<ActsExamples::ConstTrackContainer*>, std::vector<ActsExamples::Trajectories*>>
-AmbiguitySolver::process(std::vector<const ActsExamples::ConstTrackContainer*> input_container,
+AmbiguitySolver::process(std::span<const ActsExamples::ConstTrackContainer* const> input_container,
                          const edm4eic::Measurement2DCollection& meas2Ds) {
 
   // Assuming ActsExamples::ConstTrackContainer is compatible with Acts::ConstVectorTrackContainer
@@ -76,6 +76,29 @@ AmbiguitySolver::process(std::vector<const ActsExamples::ConstTrackContainer*> i
   m_core->computeInitialState(*input_trks, state, &sourceLinkHash, &sourceLinkEquality);
   m_core->resolve(state);
 
+  //Make output trajectories, one per selected track
+  const auto add_trajectory = [&output_trajectories](const auto& track, const auto& trackStateContainer) {
+    ActsExamples::Trajectories::IndexedParameters parameters;
+    std::vector<Acts::MultiTrajectoryTraits::IndexType> tips;
+    tips.push_back(track.tipIndex());
+    parameters.emplace(
+       std::pair{track.tipIndex(),
+                ActsExamples::TrackParameters{track.referenceSurface().getSharedPtr(),
+                                              track.parameters(), track.covariance(),
+                                              track.particleHypothesis()}});
+
+    output_trajectories.push_back(new ActsExamples::Trajectories(trackStateContainer, tips, parameters));
+  };
+
+  if (!m_cfg.copy_tracks) {
+    // the tips of the selected tracks, over the track states of the input
+    output_tracks.push_back(new ActsExamples::ConstTrackContainer(*input_trks));
+    for (auto iTrack : state.selectedTracks) {
+      add_trajectory(input_trks->getTrack(state.trackTips.at(iTrack)), input_trks->trackStateContainer());
+    }
+    return std::make_tuple(std::move(output_tracks), std::move(output_trajectories));
+  }
+
   ActsExamples::TrackContainer solvedTracks{std::make_shared<Acts::VectorTrackContainer>(),
                                             std::make_shared<Acts::VectorMultiTrajectory>()};
   solvedTracks.ensureDynamicColumns(*input_trks);
@@ -93,26 +116,8 @@ AmbiguitySolver::process(std::vector<const ActsExamples::ConstTrackContainer*> i
         std::make_shared<Acts::ConstVectorTrackContainer>(std::move(solvedTracks.container())),
         input_trks->trackStateContainerHolder()));
 
-   //Make output trajectories
-   ActsExamples::Trajectories::IndexedParameters parameters;
-   std::vector<Acts::MultiTrajectoryTraits::IndexType> tips;
-
    for (const auto& track : *(output_tracks.front())) {
-
-        tips.clear();
-        parameters.clear();
-
-        tips.push_back(track.tipIndex());
-        parameters.emplace(
-           std::pair{track.tipIndex(),
-                    ActsExamples::TrackParameters{track.referenceSurface().getSharedPtr(),
-                                                  track.parameters(), track.covariance(),
-                                                  track.particleHypothesis()}});
-
-        output_trajectories.push_back(new ActsExamples::Trajectories(
-             ((*output_tracks.front())).trackStateContainer(),
-             tips, parameters));
-
+        add_trajectory(track, (*output_tracks.front()).trackStateContainer());
    }
 
   return std::make_tuple(std::move(output_tracks), std::move(output_trajectories));
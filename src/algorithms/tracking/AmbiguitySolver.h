@@ -8,6 +8,7 @@
 #include <edm4eic/Measurement2D.h>
 #include <spdlog/logger.h>
 #include <memory>
+#include <span>
 #include <tuple>
 #include <vector>
 
@@ -28,7 +29,7 @@ std::tuple<
       std::vector<ActsExamples::ConstTrackContainer *>,
       std::vector<ActsExamples::Trajectories *>
       >
-  process(std::vector<const ActsExamples::ConstTrackContainer*> input_container,const edm4eic::Measurement2DCollection& meas2Ds);
+  process(std::span<const ActsExamples::ConstTrackContainer* const> input_container,const edm4eic::Measurement2DCollection& meas2Ds);
 
 private:
   std::shared_ptr<spdlog::logger> m_log;
@@ -13,5 +13,8 @@ struct AmbiguitySolverConfig {
   std::uint32_t maximum_iterations = 100000;
   /// Minimum number of measurement to form a track.
   std::size_t n_measurements_min = 3;
+  /// Copy the selected tracks into a new track container, otherwise the output track
+  /// container shares the one of the input, and only the output trajectories select tracks
+  bool copy_tracks = true;
 };
 } // namespace eicrecon
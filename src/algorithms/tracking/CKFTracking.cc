@@ -13,6 +13,7 @@
 #include <Acts/EventData/SourceLink.hpp>
 #include <Acts/EventData/TrackContainer.hpp>
 #include <Acts/EventData/TrackProxy.hpp>
+#include <Acts/EventData/TrackStatePropMask.hpp>
 #include <Acts/EventData/VectorMultiTrajectory.hpp>
 #include <Acts/EventData/VectorTrackContainer.hpp>
 #include <Acts/Geometry/GeometryIdentifier.hpp>
@@ -33,15 +34,24 @@
 #include <edm4hep/Vector2f.h>
 #include <fmt/core.h>
 #include <Eigen/Core>
-#include <array>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <deque>
 #include <functional>
-#include <list>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "ActsGeometryProvider.h"
+#include "CovarianceConversion.h"
 #include "DD4hepBField.h"
 #include "extensions/spdlog/SpdlogFormatters.h" // IWYU pragma: keep
 #include "extensions/spdlog/SpdlogToActs.h"
@@ -50,27 +60,86 @@ namespace eicrecon {
 
     using namespace Acts::UnitLiterals;
 
-    // This array relates the Acts and EDM4eic covariance matrices, including
-    // the unit conversion to get from Acts units into EDM4eic units.
-    //
-    // Note: std::map is not constexpr, so we use a constexpr std::array
-    // std::array initialization need double braces since arrays are aggregates
-    // ref: https://en.cppreference.com/w/cpp/language/aggregate_initialization
-    static constexpr std::array<std::pair<Acts::BoundIndices, double>, 6> edm4eic_indexed_units{{
-      {Acts::eBoundLoc0, Acts::UnitConstants::mm},
-      {Acts::eBoundLoc1, Acts::UnitConstants::mm},
-      {Acts::eBoundPhi, 1.},
-      {Acts::eBoundTheta, 1.},
-      {Acts::eBoundQOverP, 1. / Acts::UnitConstants::GeV},
-      {Acts::eBoundTime, Acts::UnitConstants::ns}
-    }};
+namespace {
+
+    /// Budget of the branches and of the time of the seeds of an event, shared by the seed tasks
+    class EventBudget {
+    public:
+        EventBudget(const CKFTrackingConfig& cfg, bool can_degrade)
+            : m_maxBranches(cfg.maxBranches), m_maxTime(cfg.maxTime), m_canDegrade(can_degrade) {}
+
+        bool degraded() const { return m_degraded.load(std::memory_order_relaxed); }
+        bool truncated() const { return m_truncated.load(std::memory_order_relaxed); }
+        std::size_t branches() const { return m_branches.load(std::memory_order_relaxed); }
+        double elapsed() const { return std::chrono::duration<double, std::milli>(clock::now() - m_start).count(); }
+
+        /// Counts the branches of a seed, returns false if the next seeds are to be skipped
+        bool consume(std::size_t branches) {
+            const std::size_t total = m_branches.fetch_add(branches, std::memory_order_relaxed) + branches;
+            if (truncated()) {
+                return false;
+            }
+            const bool out_of_branches = m_maxBranches > 0 && total - m_branchesBase.load(std::memory_order_relaxed) > m_maxBranches;
+            const bool out_of_time = m_maxTime > 0 && std::chrono::duration<double, std::milli>(clock::now() - phaseStart()).count() > m_maxTime;
+            if (!out_of_branches && !out_of_time) {
+                return true;
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_canDegrade && !degraded()) {
+                // a new budget with the degraded cuts
+                m_branchesBase.store(total, std::memory_order_relaxed);
+                m_phaseStart = clock::now();
+                m_degraded.store(true, std::memory_order_relaxed);
+                return true;
+            }
+            m_truncated.store(true, std::memory_order_relaxed);
+            return false;
+        }
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        clock::time_point phaseStart() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_phaseStart;
+        }
+
+        const std::size_t m_maxBranches;
+        const double m_maxTime;
+        const bool m_canDegrade;
+        const clock::time_point m_start{clock::now()};
+        std::mutex m_mutex;
+        clock::time_point m_phaseStart{m_start};
+        std::atomic<std::size_t> m_branches{0};
+        std::atomic<std::size_t> m_branchesBase{0};
+        std::atomic<bool> m_degraded{false};
+        std::atomic<bool> m_truncated{false};
+    };
+
+    /// Appends a copy of a track with the track state components of `mask`
+    template <typename track_proxy_t>
+    auto copyTrack(const track_proxy_t& track, ActsExamples::TrackContainer& tracks, Acts::TrackStatePropMask mask) {
+        auto copy = tracks.makeTrack();
+        copy.copyFrom(track, false);
+        // the states are appended from the last one, and then put back in order
+        for (const auto& state : track.trackStatesReversed()) {
+            const auto state_mask = state.getMask() & mask;
+            auto copy_state = copy.appendTrackState(state_mask);
+            copy_state.copyFrom(state, state_mask);
+        }
+        copy.reverseTrackStates();
+        return copy;
+    }
+
+} // namespace
 
     CKFTracking::CKFTracking() {
     }
 
     void CKFTracking::init(std::shared_ptr<const ActsGeometryProvider> geo_svc, std::shared_ptr<spdlog::logger> log) {
         m_log = log;
-        m_acts_logger = eicrecon::getSpdlogLogger("CKF", m_log);
+        // once per instance, and shared by the track finding tasks; the level follows m_log
+        m_acts_logger = eicrecon::getSpdlogLogger("CKF", m_log, {"^No tracks found$"});
 
         m_geoSvc = geo_svc;
 
@@ -85,23 +154,58 @@ namespace eicrecon {
                  }
                 },
         };
+        if (!m_cfg.degradedChi2CutOff.empty()) {
+            m_degradedSourcelinkSelectorCfg = {
+                    {Acts::GeometryIdentifier(),
+                     {m_cfg.etaBins, m_cfg.degradedChi2CutOff,
+                      {m_cfg.degradedNumMeasurementsCutOff.begin(), m_cfg.degradedNumMeasurementsCutOff.end()}
+                     }
+                    },
+            };
+        }
+
+        m_trackStateMask = Acts::TrackStatePropMask::None;
+        for (const auto& component : m_cfg.trackStateComponents) {
+            if (component == "predicted") {
+                m_trackStateMask |= Acts::TrackStatePropMask::Predicted;
+            } else if (component == "filtered") {
+                m_trackStateMask |= Acts::TrackStatePropMask::Filtered;
+            } else if (component == "smoothed") {
+                m_trackStateMask |= Acts::TrackStatePropMask::Smoothed;
+            } else if (component == "jacobian") {
+                m_trackStateMask |= Acts::TrackStatePropMask::Jacobian;
+            } else if (component == "calibrated") {
+                m_trackStateMask |= Acts::TrackStatePropMask::Calibrated;
+            } else {
+                throw std::runtime_error(fmt::format("Unknown track state component \"{}\"", component));
+            }
+        }
+
         m_trackFinderFunc = CKFTracking::makeCKFTrackingFunction(m_geoSvc->trackingGeometry(), m_BField, logger());
     }
 
     std::tuple<
         std::vector<ActsExamples::Trajectories*>,
-        std::vector<ActsExamples::ConstTrackContainer*>
+        std::vector<ActsExamples::ConstTrackContainer*>,
+        CKFTrackingStatus
     >
     CKFTracking::process(const edm4eic::Measurement2DCollection& meas2Ds,
                          const edm4eic::TrackParametersCollection &init_trk_params) {
 
+        CKFTrackingStatus status;
+        EventBudget budget(m_cfg, !m_cfg.degradedChi2CutOff.empty());
 
         // create sourcelink and measurement containers
-        auto measurements = std::make_shared<ActsExamples::MeasurementContainer>();
-
-          // need list here for stable addresses
-        std::list<ActsExamples::IndexSourceLink> sourceLinkStorage;
-        ActsExamples::IndexSourceLinkContainer src_links;
+        auto& measurements = m_measurements;
+        measurements.clear();
+        measurements.reserve(meas2Ds.size());
+
+        // reserved up front, so that the source link addresses stay stable
+        auto& sourceLinkStorage = m_sourceLinkStorage;
+        sourceLinkStorage.clear();
+        sourceLinkStorage.reserve(meas2Ds.size());
+        auto& src_links = m_sourceLinks;
+        src_links.clear();
         src_links.reserve(meas2Ds.size());
         std::size_t  hit_index = 0;
 
@@ -130,12 +234,14 @@ namespace eicrecon {
             cov(1, 0) = meas2D.getCovariance().xy;
 
             auto measurement = Acts::makeMeasurement(Acts::SourceLink{sourceLink}, loc, cov, Acts::eBoundLoc0, Acts::eBoundLoc1);
-            measurements->emplace_back(std::move(measurement));
+            measurements.emplace_back(std::move(measurement));
 
             hit_index++;
         }
 
-        ActsExamples::TrackParametersContainer acts_init_trk_params;
+        auto& acts_init_trk_params = m_initTrackParameters;
+        acts_init_trk_params.clear();
+        acts_init_trk_params.reserve(init_trk_params.size());
         for (const auto& track_parameter: init_trk_params) {
 
             Acts::BoundVector params;
@@ -148,14 +254,7 @@ namespace eicrecon {
 
             double charge = std::copysign(1., track_parameter.getQOverP());
 
-            Acts::BoundSquareMatrix cov = Acts::BoundSquareMatrix::Zero();
-            for (size_t i = 0; const auto& [a, x] : edm4eic_indexed_units) {
-              for (size_t j = 0; const auto& [b, y] : edm4eic_indexed_units) {
-                cov(a, b) = track_parameter.getCovariance()(i,j) * x * y;
-                ++j;
-              }
-              ++i;
-            }
+            Acts::BoundSquareMatrix cov = covariance_conversion::to_acts(track_parameter.getCovariance());
 
             // Construct a perigee surface as the target surface
             auto pSurface = Acts::Surface::makeShared<const Acts::PerigeeSurface>(Acts::Vector3(0,0,0));
@@ -167,13 +266,11 @@ namespace eicrecon {
         //// Construct a perigee surface as the target surface
         auto pSurface = Acts::Surface::makeShared<Acts::PerigeeSurface>(Acts::Vector3{0., 0., 0.});
 
-        ACTS_LOCAL_LOGGER(eicrecon::getSpdlogLogger("CKF", m_log, {"^No tracks found$"}));
-
         Acts::PropagatorPlainOptions pOptions;
         pOptions.maxSteps = 10000;
 
         ActsExamples::PassThroughCalibrator pcalibrator;
-        ActsExamples::MeasurementCalibratorAdapter calibrator(pcalibrator, *measurements);
+        ActsExamples::MeasurementCalibratorAdapter calibrator(pcalibrator, measurements);
         Acts::GainMatrixUpdater kfUpdater;
         Acts::GainMatrixSmoother kfSmoother;
         Acts::MeasurementSelector measSel{m_sourcelinkSelectorCfg};
@@ -203,6 +300,16 @@ namespace eicrecon {
                 m_geoctx, m_fieldctx, m_calibctx, slAccessorDelegate,
                 extensions, pOptions, &(*pSurface));
 
+        // the same with the degraded measurement selection, once out of budget
+        Acts::MeasurementSelector degradedMeasSel{m_cfg.degradedChi2CutOff.empty() ? m_sourcelinkSelectorCfg : m_degradedSourcelinkSelectorCfg};
+        auto degradedExtensions = extensions;
+        degradedExtensions.measurementSelector.connect<
+                &Acts::MeasurementSelector::select<Acts::VectorMultiTrajectory>>(
+                &degradedMeasSel);
+        CKFTracking::TrackFinderOptions degradedOptions(
+                m_geoctx, m_fieldctx, m_calibctx, slAccessorDelegate,
+                degradedExtensions, pOptions, &(*pSurface));
+
         // Create track container
         auto trackContainer = std::make_shared<Acts::VectorTrackContainer>();
         auto trackStateContainer = std::make_shared<Acts::VectorMultiTrajectory>();
@@ -212,20 +319,74 @@ namespace eicrecon {
         acts_tracks.addColumn<unsigned int>("seed");
         Acts::TrackAccessor<unsigned int> seedNumber("seed");
 
-        // Loop over seeds
-        for (std::size_t iseed = 0; iseed < acts_init_trk_params.size(); ++iseed) {
-            auto result =
-                (*m_trackFinderFunc)(acts_init_trk_params.at(iseed), options, acts_tracks);
-
-            if (!result.ok()) {
-                m_log->debug("Track finding failed for seed {} with error {}", iseed, result.error());
-                continue;
+        // Find the tracks of the seeds [begin, end) within the budget, the options are only read
+        std::atomic<std::size_t> n_seeds_processed{0};
+        auto find_tracks = [&](std::size_t begin, std::size_t end, ActsExamples::TrackContainer& tracks) {
+            for (std::size_t iseed = begin; iseed < end && !budget.truncated(); ++iseed) {
+                auto result =
+                    (*m_trackFinderFunc)(acts_init_trk_params.at(iseed), budget.degraded() ? degradedOptions : options, tracks);
+                n_seeds_processed.fetch_add(1, std::memory_order_relaxed);
+
+                if (!result.ok()) {
+                    m_log->debug("Track finding failed for seed {} with error {}", iseed, result.error());
+                    if (!budget.consume(0)) {
+                        break;
+                    }
+                    continue;
+                }
+
+                // Set seed number for all found tracks
+                auto& tracksForSeed = result.value();
+                for (auto& track : tracksForSeed) {
+                    seedNumber(track) = iseed;
+                }
+                if (!budget.consume(tracksForSeed.size())) {
+                    break;
+                }
             }
+        };
 
-            // Set seed number for all found tracks
-            auto& tracksForSeed = result.value();
-            for (auto& track : tracksForSeed) {
-                seedNumber(track) = iseed;
+        // Loop over seeds, up to maxSeeds
+        status.numSeeds = acts_init_trk_params.size();
+        std::size_t n_seeds = acts_init_trk_params.size();
+        if (m_cfg.maxSeeds > 0 && n_seeds > m_cfg.maxSeeds) {
+            n_seeds = m_cfg.maxSeeds;
+            status.seedsTruncated = true;
+        }
+        const std::size_t n_tasks = std::min<std::size_t>(std::max<std::size_t>(m_cfg.numSeedTasks, 1), n_seeds);
+        if (n_tasks <= 1 && m_trackStateMask == Acts::TrackStatePropMask::All) {
+            find_tracks(0, n_seeds, acts_tracks);
+        } else {
+            // Every task finds the tracks of a contiguous range of seeds into its own
+            // containers, which are appended in task order, i.e. in seed order, with
+            // the track state components that are kept
+            const std::size_t n_blocks = std::max<std::size_t>(n_tasks, 1);
+            std::deque<ActsExamples::TrackContainer> task_tracks;
+            for (std::size_t task = 0; task < n_blocks; ++task) {
+                task_tracks.emplace_back(std::make_shared<Acts::VectorTrackContainer>(),
+                                         std::make_shared<Acts::VectorMultiTrajectory>());
+                task_tracks.back().addColumn<unsigned int>("seed");
+            }
+            auto seed_range = [n_seeds, n_blocks](std::size_t task) {
+                return std::pair{task * n_seeds / n_blocks, (task + 1) * n_seeds / n_blocks};
+            };
+            {
+                std::vector<std::future<void>> tasks;
+                for (std::size_t task = 1; task < n_blocks; ++task) {
+                    const auto [begin, end] = seed_range(task);
+                    tasks.push_back(std::async(std::launch::async, find_tracks, begin, end, std::ref(task_tracks[task])));
+                }
+                const auto [begin, end] = seed_range(0);
+                find_tracks(begin, end, task_tracks[0]);
+                for (auto& task : tasks) {
+                    task.get();
+                }
+            }
+            for (const auto& tracks : task_tracks) {
+                for (const auto& track : tracks) {
+                    auto copy = copyTrack(track, acts_tracks, m_trackStateMask);
+                    seedNumber(copy) = seedNumber(track);
+                }
             }
         }
 
@@ -296,7 +457,19 @@ namespace eicrecon {
           constTracks.trackStateContainer(),
           std::move(tips), std::move(parameters)));
 
-        return std::make_tuple(std::move(acts_trajectories), std::move(constTracks_v));
+        status.numSeedsProcessed = n_seeds_processed.load();
+        status.numBranches = budget.branches();
+        status.time = budget.elapsed();
+        status.degraded = budget.degraded();
+        status.truncated = budget.truncated();
+        if (status.budgetExceeded()) {
+            m_log->warn("Track finding out of budget: {} of {} seeds, {} branches in {:.1f} ms{}{}{}",
+                        status.numSeedsProcessed, status.numSeeds, status.numBranches, status.time,
+                        status.seedsTruncated ? ", seeds truncated" : "",
+                        status.degraded ? ", degraded cuts" : "",
+                        status.truncated ? ", seeds skipped" : "");
+        }
+        return std::make_tuple(std::move(acts_trajectories), std::move(constTracks_v), status);
     }
 
 } // namespace eicrecon
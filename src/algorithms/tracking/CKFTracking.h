@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <Acts/EventData/TrackStatePropMask.hpp>
 #include <Acts/EventData/VectorMultiTrajectory.hpp>
 #include <Acts/Geometry/GeometryContext.hpp>
 #include <Acts/Geometry/TrackingGeometry.hpp>
@@ -14,11 +15,13 @@
 #include <Acts/Utilities/Logger.hpp>
 #include <Acts/Utilities/Result.hpp>
 #include <ActsExamples/EventData/IndexSourceLink.hpp>
+#include <ActsExamples/EventData/Measurement.hpp>
 #include <ActsExamples/EventData/Track.hpp>
 #include <ActsExamples/EventData/Trajectories.hpp>
 #include <edm4eic/Measurement2DCollection.h>
 #include <edm4eic/TrackParametersCollection.h>
 #include <spdlog/logger.h>
+#include <cstddef>
 #include <memory>
 #include <tuple>
 #include <vector>
@@ -36,6 +39,19 @@ namespace eicrecon {
  * \ingroup tracking
  */
 
+    /// Per-event status of the track finding, with the budgets of CKFTrackingConfig
+    struct CKFTrackingStatus {
+        std::size_t numSeeds{0};            // of the input
+        std::size_t numSeedsProcessed{0};   // with the nominal or the degraded cuts
+        std::size_t numBranches{0};         // tracks found
+        double time{0};                     // ms
+        bool seedsTruncated{false};         // seeds beyond maxSeeds dropped
+        bool degraded{false};               // some seeds with the degraded cuts
+        bool truncated{false};              // some seeds skipped when out of budget
+
+        bool budgetExceeded() const { return seedsTruncated || degraded || truncated; }
+    };
+
     class CKFTracking: public WithPodConfig<eicrecon::CKFTrackingConfig> {
     public:
         /// Track finder function that takes input measurements, initial trackstate
@@ -72,7 +88,8 @@ namespace eicrecon {
 
         std::tuple<
             std::vector<ActsExamples::Trajectories*>,
-            std::vector<ActsExamples::ConstTrackContainer*>
+            std::vector<ActsExamples::ConstTrackContainer*>,
+            CKFTrackingStatus
         >
         process(const edm4eic::Measurement2DCollection& meas2Ds,
                 const edm4eic::TrackParametersCollection &init_trk_params);
@@ -89,6 +106,17 @@ namespace eicrecon {
         Acts::MagneticFieldContext m_fieldctx;
 
         Acts::MeasurementSelector::Config m_sourcelinkSelectorCfg;
+        Acts::MeasurementSelector::Config m_degradedSourcelinkSelectorCfg; // if degradedChi2CutOff is set
+
+        /// Track state components of the output trajectories, from trackStateComponents
+        Acts::TrackStatePropMask m_trackStateMask{Acts::TrackStatePropMask::All};
+
+        /// Per event containers, kept to reuse their capacity between events
+        /// (there is one algorithm instance per thread)
+        std::vector<ActsExamples::IndexSourceLink> m_sourceLinkStorage;
+        ActsExamples::IndexSourceLinkContainer m_sourceLinks;
+        ActsExamples::MeasurementContainer m_measurements;
+        ActsExamples::TrackParametersContainer m_initTrackParameters;
 
         /// Private access to the logging instance
         const Acts::Logger& logger() const { return *m_acts_logger; }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <string>
 #include <vector>
 
 namespace eicrecon {
@@ -11,5 +12,22 @@ namespace eicrecon {
         std::vector<double> etaBins = {};  // {this, "etaBins", {}};
         std::vector<double> chi2CutOff = {15.}; //{this, "chi2CutOff", {15.}};
         std::vector<size_t> numMeasurementsCutOff = {10}; //{this, "numMeasurementsCutOff", {10}};
+        size_t numSeedTasks = 1; // number of tasks that find the tracks of the seeds of an event in parallel
+
+        // Per-event budgets, unlimited if 0. Seeds beyond `maxSeeds` are dropped. When the
+        // tracks found (CKF branches) exceed `maxBranches` or the time exceeds `maxTime`, the
+        // remaining seeds use the degraded cuts with a new budget, or are skipped if there are
+        // no degraded cuts or the degraded budget is exceeded too
+        size_t maxSeeds = 0;
+        size_t maxBranches = 0;
+        double maxTime = 0; // ms
+        std::vector<double> degradedChi2CutOff = {};       // none, no degradation
+        std::vector<size_t> degradedNumMeasurementsCutOff = {1};
+
+        // Components of the track states kept in the output trajectories, of "predicted",
+        // "filtered", "smoothed", "jacobian" and "calibrated". The others are dropped when the
+        // tracks are copied into the output containers (TrackProjector reads the predicted
+        // parameters, the track parameters at the reference surface are always kept)
+        std::vector<std::string> trackStateComponents = {"predicted", "filtered", "smoothed", "jacobian", "calibrated"};
     };
 }
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <Acts/Definitions/TrackParametrization.hpp>
+#include <Acts/Definitions/Units.hpp>
+#include <edm4eic/Cov6f.h>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+namespace eicrecon {
+
+  /** Conversion between Acts bound covariances and edm4eic::Cov6f.
+   *
+   * The index mapping and the unit factors are expanded at compile time into
+   * one assignment per independent matrix element, instead of nested loops
+   * over the index table.
+   */
+  namespace covariance_conversion {
+
+    // This array relates the Acts and EDM4eic covariance matrices, including
+    // the unit conversion to get from Acts units into EDM4eic units.
+    inline constexpr std::array<std::pair<Acts::BoundIndices, double>, 6> edm4eic_indexed_units{{
+      {Acts::eBoundLoc0, Acts::UnitConstants::mm},
+      {Acts::eBoundLoc1, Acts::UnitConstants::mm},
+      {Acts::eBoundPhi, 1.},
+      {Acts::eBoundTheta, 1.},
+      {Acts::eBoundQOverP, 1. / Acts::UnitConstants::GeV},
+      {Acts::eBoundTime, Acts::UnitConstants::ns}
+    }};
+
+    namespace detail {
+
+      /// Element (i, j), i <= j, of the edm4eic matrix and its Acts counterpart
+      struct Element {
+        unsigned i, j;
+        Acts::BoundIndices a, b;
+        double scale; // Acts = edm4eic * scale
+      };
+
+      constexpr std::array<Element, 21> make_elements() {
+        std::array<Element, 21> elements{};
+        std::size_t k = 0;
+        for (unsigned i = 0; i < 6; ++i) {
+          for (unsigned j = i; j < 6; ++j) {
+            elements[k++] = {i, j, edm4eic_indexed_units[i].first, edm4eic_indexed_units[j].first,
+                             edm4eic_indexed_units[i].second * edm4eic_indexed_units[j].second};
+          }
+        }
+        return elements;
+      }
+
+      inline constexpr auto elements = make_elements();
+
+      template <std::size_t... K>
+      inline void to_edm4eic(const Acts::BoundSquareMatrix& in, edm4eic::Cov6f& out, std::index_sequence<K...>) {
+        ((out(elements[K].i, elements[K].j) =
+              static_cast<float>(in(elements[K].a, elements[K].b) * (1. / elements[K].scale))), ...);
+      }
+
+      template <std::size_t... K>
+      inline void to_acts(const edm4eic::Cov6f& in, Acts::BoundSquareMatrix& out, std::index_sequence<K...>) {
+        ((out(elements[K].a, elements[K].b) = out(elements[K].b, elements[K].a) =
+              in(elements[K].i, elements[K].j) * elements[K].scale), ...);
+      }
+
+    } // namespace detail
+
+    /// Acts bound covariance in Acts units to edm4eic units
+    inline edm4eic::Cov6f to_edm4eic(const Acts::BoundSquareMatrix& covariance) {
+      edm4eic::Cov6f cov;
+      detail::to_edm4eic(covariance, cov, std::make_index_sequence<detail::elements.size()>{});
+      return cov;
+    }
+
+    /// Batched conversion, `out[k]` is the conversion of `*covariances[k]`
+    inline void to_edm4eic(std::span<const Acts::BoundSquareMatrix* const> covariances, std::span<edm4eic::Cov6f> out) {
+      for (std::size_t k = 0; k < covariances.size() && k < out.size(); ++k) {
+        detail::to_edm4eic(*covariances[k], out[k], std::make_index_sequence<detail::elements.size()>{});
+      }
+    }
+
+    /// edm4eic covariance to an Acts bound covariance in Acts units
+    inline Acts::BoundSquareMatrix to_acts(const edm4eic::Cov6f& covariance) {
+      Acts::BoundSquareMatrix cov;
+      detail::to_acts(covariance, cov, std::make_index_sequence<detail::elements.size()>{});
+      return cov;
+    }
+
+  } // namespace covariance_conversion
+
+} // namespace eicrecon
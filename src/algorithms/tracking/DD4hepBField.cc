@@ -10,13 +10,65 @@
 #include <Evaluator/DD4hepUnits.h>
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/DisplacementVector3D.h>
+#include <fmt/core.h>
 #include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+#include <exception>
 #include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "services/geometry/disk_cache/CacheFile.h"
 
 namespace eicrecon::BField {
 
-  Acts::Result<Acts::Vector3> DD4hepBField::getField(const Acts::Vector3& position,
-                                                     Acts::MagneticFieldProvider::Cache& /*cache*/) const
+  namespace {
+
+    // of the layout of the cached grid
+    constexpr std::uint32_t grid_file_version = 1;
+
+  } // namespace
+
+  DD4hepBField::DD4hepBField(gsl::not_null<const dd4hep::Detector*> det, const GridConfig& grid)
+    : m_det(det), m_grid_cfg(grid)
+  {
+    if (!m_grid_cfg.enabled) {
+      return;
+    }
+    m_grid_replicas.enable(m_grid_cfg.numaReplicas);
+    const std::size_t dims = m_grid_cfg.rz ? 2 : 3;
+    for (std::size_t d = 0; d < 3; ++d) {
+      if (d >= dims) {
+        m_grid_cfg.points[d] = 1;
+        continue;
+      }
+      if ((m_grid_cfg.points[d] < 2) || !(m_grid_cfg.max[d] > m_grid_cfg.min[d])) {
+        throw std::invalid_argument("Magnetic field grid needs at least two points and a positive extent on every axis");
+      }
+      m_step[d] = (m_grid_cfg.max[d] - m_grid_cfg.min[d]) / (m_grid_cfg.points[d] - 1);
+    }
+    if (m_grid_cfg.rz && (m_grid_cfg.min[0] < 0.)) {
+      throw std::invalid_argument("Magnetic field r-z grid can not start at negative r");
+    }
+
+    const std::uint64_t key = gridKey();
+    std::string path;
+    if (!m_grid_cfg.cacheDir.empty()) {
+      path = fmt::format("{}/bfield_{:016x}.bin", m_grid_cfg.cacheDir, key);
+      m_grid_from_cache = readGrid(path, key);
+    }
+    if (!m_grid_from_cache) {
+      sampleGrid();
+      if (!path.empty()) {
+        writeGrid(path, key);
+      }
+    }
+  }
+
+  Acts::Vector3 DD4hepBField::dd4hepField(const Acts::Vector3& position) const
   {
     dd4hep::Position pos(
       position[0] * (dd4hep::mm / Acts::UnitConstants::mm),
@@ -25,10 +77,170 @@ namespace eicrecon::BField {
 
     auto fieldObj = m_det->field();
     auto field = fieldObj.magneticField(pos) * (Acts::UnitConstants::T / dd4hep::tesla);
+    return {field.x(), field.y(), field.z()};
+  }
+
+  std::uint64_t DD4hepBField::gridKey() const
+  {
+    // the grid configuration, and the field at a few probe points in the grid
+    // (there is no handle on the field configuration itself)
+    CacheHash hash;
+    hash.add(static_cast<std::uint64_t>(m_grid_cfg.rz));
+    for (std::size_t d = 0; d < 3; ++d) {
+      hash.add(m_grid_cfg.min[d]);
+      hash.add(m_grid_cfg.max[d]);
+      hash.add(static_cast<std::uint64_t>(m_grid_cfg.points[d]));
+    }
+    for (double fx : {0.1, 0.5, 0.9}) {
+      for (double fy : {0.1, 0.5, 0.9}) {
+        for (double fz : {0.1, 0.5, 0.9}) {
+          std::array<double, 3> u;
+          for (std::size_t d = 0; const double f : {fx, fy, fz}) {
+            u[d] = m_grid_cfg.min[d] + f * (m_grid_cfg.max[d] - m_grid_cfg.min[d]);
+            ++d;
+          }
+          const Acts::Vector3 position = m_grid_cfg.rz
+            ? Acts::Vector3(u[0], 0., u[1]) * Acts::UnitConstants::mm
+            : Acts::Vector3(u[0], u[1], u[2]) * Acts::UnitConstants::mm;
+          const Acts::Vector3 field = dd4hepField(position);
+          for (std::size_t i = 0; i < 3; ++i) {
+            hash.add(field[i]);
+          }
+        }
+      }
+    }
+    return hash.value();
+  }
+
+  void DD4hepBField::sampleGrid()
+  {
+    const auto& [n0, n1, n2] = m_grid_cfg.points;
+    m_grid.resize(n0 * n1 * n2);
+    for (std::size_t i0 = 0; i0 < n0; ++i0) {
+      for (std::size_t i1 = 0; i1 < n1; ++i1) {
+        for (std::size_t i2 = 0; i2 < n2; ++i2) {
+          const double u0 = m_grid_cfg.min[0] + i0 * m_step[0];
+          const double u1 = m_grid_cfg.min[1] + i1 * m_step[1];
+          const double u2 = m_grid_cfg.min[2] + i2 * m_step[2];
+          const Acts::Vector3 position = m_grid_cfg.rz
+            ? Acts::Vector3(u0, 0., u1) * Acts::UnitConstants::mm
+            : Acts::Vector3(u0, u1, u2) * Acts::UnitConstants::mm;
+          m_grid[(i0 * n1 + i1) * n2 + i2] = dd4hepField(position);
+        }
+      }
+    }
+  }
+
+  bool DD4hepBField::readGrid(const std::string& path, std::uint64_t key)
+  {
+    const auto blob = cache_file::load(path, grid_file_version, 0, key);
+    const std::size_t n = m_grid_cfg.points[0] * m_grid_cfg.points[1] * m_grid_cfg.points[2];
+    if (!blob || (blob->data().size() != 3 * n * sizeof(double))) {
+      return false;
+    }
+    const auto values = blob->array<double>(0, 3 * n);
+    m_grid.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      m_grid[i] = {values[3 * i], values[3 * i + 1], values[3 * i + 2]};
+    }
+    return true;
+  }
+
+  void DD4hepBField::writeGrid(const std::string& path, std::uint64_t key) const
+  {
+    std::vector<double> values;
+    values.reserve(3 * m_grid.size());
+    for (const auto& field : m_grid) {
+      values.insert(values.end(), {field[0], field[1], field[2]});
+    }
+    try {
+      cache_file::store(path, grid_file_version, 0, key, {std::as_bytes(std::span(values))});
+    } catch (const std::exception&) {
+      // a cache that can not be written is not an error, the grid is sampled again next time
+    }
+  }
+
+  Acts::Result<Acts::Vector3> DD4hepBField::getField(const Acts::Vector3& position,
+                                                     Acts::MagneticFieldProvider::Cache& cache) const
+  {
+    Acts::Vector3 field;
+    std::optional<double> phi;
+    if (m_grid.empty()) {
+      field = dd4hepField(position);
+    } else {
+      auto& cell = cache.as<Cache>();
+      const auto& grid = (cell.grid != nullptr) ? *cell.grid : m_grid;
+      const std::array<double, 3> u = m_grid_cfg.rz
+        ? std::array<double, 3>{std::hypot(position[0], position[1]) / Acts::UnitConstants::mm, position[2] / Acts::UnitConstants::mm, 0.}
+        : std::array<double, 3>{position[0] / Acts::UnitConstants::mm, position[1] / Acts::UnitConstants::mm, position[2] / Acts::UnitConstants::mm};
+      const std::size_t dims = m_grid_cfg.rz ? 2 : 3;
+
+      auto in_cell = [&]() {
+        for (std::size_t d = 0; d < dims; ++d) {
+          if ((u[d] < cell.lower[d]) || (u[d] > cell.upper[d])) {
+            return false;
+          }
+        }
+        return true;
+      };
+      bool inside = cell.valid && in_cell();
+      if (!inside) {
+        // locate the new cell
+        inside = true;
+        std::array<std::size_t, 3> i{0, 0, 0};
+        for (std::size_t d = 0; d < dims; ++d) {
+          if (!((u[d] >= m_grid_cfg.min[d]) && (u[d] <= m_grid_cfg.max[d]))) {
+            inside = false;
+            break;
+          }
+          i[d] = std::min(static_cast<std::size_t>((u[d] - m_grid_cfg.min[d]) / m_step[d]), m_grid_cfg.points[d] - 2);
+          cell.lower[d] = m_grid_cfg.min[d] + i[d] * m_step[d];
+          cell.upper[d] = m_grid_cfg.min[d] + (i[d] + 1) * m_step[d];
+        }
+        cell.valid = inside;
+        if (inside) {
+          const auto& [n0, n1, n2] = m_grid_cfg.points;
+          for (std::size_t k = 0; k < (std::size_t{1} << dims); ++k) {
+            const std::size_t j0 = i[0] + (k & 1);
+            const std::size_t j1 = i[1] + ((k >> 1) & 1);
+            const std::size_t j2 = i[2] + ((k >> 2) & 1);
+            cell.corners[k] = grid[(j0 * n1 + j1) * n2 + j2];
+          }
+        }
+      }
+
+      if (inside) {
+        // multilinear interpolation between the corners of the cell
+        std::array<double, 3> t{0., 0., 0.};
+        for (std::size_t d = 0; d < dims; ++d) {
+          t[d] = (u[d] - cell.lower[d]) / (cell.upper[d] - cell.lower[d]);
+        }
+        field = Acts::Vector3::Zero();
+        for (std::size_t k = 0; k < (std::size_t{1} << dims); ++k) {
+          double weight = 1.;
+          for (std::size_t d = 0; d < dims; ++d) {
+            weight *= ((k >> d) & 1) ? t[d] : (1. - t[d]);
+          }
+          field += weight * cell.corners[k];
+        }
+        if (m_grid_cfg.rz) {
+          phi = std::atan2(position[1], position[0]);
+        }
+      } else {
+        field = dd4hepField(position);
+      }
+    }
+
+    if (phi) {
+      // r-z grid is sampled at phi = 0
+      const double c = std::cos(*phi);
+      const double s = std::sin(*phi);
+      field = Acts::Vector3(c * field[0] - s * field[1], s * field[0] + c * field[1], field[2]);
+    }
 
     // FIXME Acts doesn't seem to like exact zero components
     if (field.x() * field.y() * field.z() == 0) {
-      static dd4hep::Direction epsilon{
+      static Acts::Vector3 epsilon{
         std::numeric_limits<double>::epsilon(),
         std::numeric_limits<double>::epsilon(),
         std::numeric_limits<double>::epsilon()
@@ -36,7 +248,7 @@ namespace eicrecon::BField {
       field += epsilon;
     }
 
-    return Acts::Result<Acts::Vector3>::success({field.x(), field.y(), field.z()});
+    return Acts::Result<Acts::Vector3>::success(field);
   }
 
   Acts::Result<Acts::Vector3> DD4hepBField::getFieldGradient(const Acts::Vector3& position,
@@ -14,10 +14,15 @@
 #include <Acts/Utilities/Result.hpp>
 #include <DD4hep/Detector.h>
 #include <gsl/pointers>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <variant>
+#include <vector>
 
-
+#include "algorithms/interfaces/NumaReplicas.h"
 
 
 namespace eicrecon::BField {
@@ -36,14 +41,39 @@ namespace eicrecon::BField {
   public:
       gsl::not_null<const dd4hep::Detector*> m_det;
 
+    /** Regular grid that the DD4hep field can be sampled onto.
+     *
+     * Lengths in mm. For an r-z grid the field is sampled at phi = 0 and
+     * rotated, only the first two entries of min, max and points are used.
+     */
+    struct GridConfig {
+      bool enabled{false};
+      bool rz{true};
+      std::array<double, 3> min{0., -5000., 0.};
+      std::array<double, 3> max{3000., 5000., 0.};
+      std::array<std::size_t, 3> points{301, 1001, 1};
+      /// directory of the sampled grid files, no caching if empty
+      std::string cacheDir;
+      /// one copy of the grid per NUMA node, for the caches made by threads of the node
+      bool numaReplicas{false};
+    };
+
   public:
+    /// Grid cell of the last lookup, with the field at its corners
     struct Cache {
       Cache(const Acts::MagneticFieldContext& /*mcfg*/) { }
+      bool valid{false};
+      std::array<double, 3> lower{0., 0., 0.};
+      std::array<double, 3> upper{0., 0., 0.};
+      std::array<Acts::Vector3, 8> corners;
+      const std::vector<Acts::Vector3>* grid{nullptr}; // on the NUMA node of the thread that made the cache
     };
 
     Acts::MagneticFieldProvider::Cache makeCache(const Acts::MagneticFieldContext& mctx) const override
     {
-      return Acts::MagneticFieldProvider::Cache::make<Cache>(mctx);
+      auto cache = Acts::MagneticFieldProvider::Cache::make<Cache>(mctx);
+      cache.as<Cache>().grid = &m_grid_replicas.local(m_grid);
+      return cache;
     }
 
     /** construct constant magnetic field from field vector.
@@ -52,14 +82,25 @@ namespace eicrecon::BField {
     */
     explicit DD4hepBField(gsl::not_null<const dd4hep::Detector*> det) : m_det(det) {}
 
+    /** sample the DD4hep field onto a grid (or load it from the cache directory)
+    *
+    * @param [in] DD4hep detector instance
+    * @param [in] grid grid configuration, the field is not sampled unless enabled
+    */
+    DD4hepBField(gsl::not_null<const dd4hep::Detector*> det, const GridConfig& grid);
+
+    /// Whether the field is interpolated on a grid, and whether the grid was read from the cache
+    bool usesGrid() const { return !m_grid.empty(); }
+    bool gridFromCache() const { return m_grid_from_cache; }
+
     /**  retrieve magnetic field value.
      *
      *  @param [in] position global position
-     *  @param [in] cache Cache object (is ignored)
+     *  @param [in] cache Cache object, holds the current grid cell
      *  @return magnetic field vector
      *
-     *  @note The @p position is ignored and only kept as argument to provide
-     *        a consistent interface with other magnetic field services.
+     *  @note Positions outside of the grid (or without grid) are evaluated
+     *        directly by DD4hep.
      */
     Acts::Result<Acts::Vector3> getField(const Acts::Vector3& position, Acts::MagneticFieldProvider::Cache& cache) const override;
 
@@ -68,16 +109,29 @@ namespace eicrecon::BField {
      * @param [in]  position   global position
      * @param [out] derivative gradient of magnetic field vector as (3x3)
      * matrix
-     * @param [in] cache Cache object (is ignored)
+     * @param [in] cache Cache object, holds the current grid cell
      * @return magnetic field vector
      *
-     * @note The @p position is ignored and only kept as argument to provide
-     *       a consistent interface with other magnetic field services.
      * @note currently the derivative is not calculated
      * @todo return derivative
      */
     Acts::Result<Acts::Vector3> getFieldGradient(const Acts::Vector3& position, Acts::ActsMatrix<3, 3>& /*derivative*/,
                                                  Acts::MagneticFieldProvider::Cache& cache) const override;
+
+  private:
+    /// Field from DD4hep, in Acts units
+    Acts::Vector3 dd4hepField(const Acts::Vector3& position) const;
+    void sampleGrid();
+    bool readGrid(const std::string& path, std::uint64_t key);
+    void writeGrid(const std::string& path, std::uint64_t key) const;
+    std::uint64_t gridKey() const;
+
+    GridConfig m_grid_cfg;
+    std::array<double, 3> m_step{0., 0., 0.};
+    // field at the grid points, the last grid axis is the fastest
+    std::vector<Acts::Vector3> m_grid;
+    NumaReplicas<std::vector<Acts::Vector3>> m_grid_replicas;
+    bool m_grid_from_cache{false};
   };
 
   using BFieldVariant = std::variant<std::shared_ptr<const DD4hepBField>>;
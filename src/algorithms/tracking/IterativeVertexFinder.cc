@@ -48,52 +48,45 @@ void eicrecon::IterativeVertexFinder::init(std::shared_ptr<const ActsGeometryPro
   m_BField =
       std::dynamic_pointer_cast<const eicrecon::BField::DD4hepBField>(m_geoSvc->getFieldProvider());
   m_fieldctx = eicrecon::BField::BFieldVariant(m_BField);
-}
-
-std::unique_ptr<edm4eic::VertexCollection> eicrecon::IterativeVertexFinder::produce(
-    std::vector<const ActsExamples::Trajectories*> trajectories) {
-
-  auto outputVertices = std::make_unique<edm4eic::VertexCollection>();
-
-  using Propagator        = Acts::Propagator<Acts::EigenStepper<>>;
-  using PropagatorOptions = Acts::PropagatorOptions<>;
-  using Linearizer        = Acts::HelicalTrackLinearizer<Propagator>;
-  using VertexFitter      = Acts::FullBilloirVertexFitter<Acts::BoundTrackParameters, Linearizer>;
-  using ImpactPointEstimator = Acts::ImpactPointEstimator<Acts::BoundTrackParameters, Propagator>;
-  using VertexSeeder         = Acts::ZScanVertexFinder<VertexFitter>;
-  using VertexFinder         = Acts::IterativeVertexFinder<VertexFitter, VertexSeeder>;
-  using VertexFinderOptions  = Acts::VertexingOptions<Acts::BoundTrackParameters>;
 
   ACTS_LOCAL_LOGGER(eicrecon::getSpdlogLogger("IVF", m_log));
 
   Acts::EigenStepper<> stepper(m_BField);
 
   // Set up propagator with void navigator
-  auto propagator = std::make_shared<Propagator>(
+  m_propagator = std::make_shared<Propagator>(
     stepper, Acts::detail::VoidNavigator{}, logger().cloneWithSuffix("Prop"));
-  Acts::PropagatorOptions opts(m_geoctx, m_fieldctx);
 
   // Setup the vertex fitter
   VertexFitter::Config vertexFitterCfg;
   VertexFitter vertexFitter(vertexFitterCfg);
   // Setup the track linearizer
-  Linearizer::Config linearizerCfg(m_BField, propagator);
+  Linearizer::Config linearizerCfg(m_BField, m_propagator);
   Linearizer linearizer(linearizerCfg, logger().cloneWithSuffix("HelLin"));
   // Setup the seed finder
-  ImpactPointEstimator::Config ipEstCfg(m_BField, propagator);
-  ImpactPointEstimator ipEst(ipEstCfg);
-  VertexSeeder::Config seederCfg(ipEst);
+  ImpactPointEstimator::Config ipEstCfg(m_BField, m_propagator);
+  m_ipEst = std::make_unique<ImpactPointEstimator>(ipEstCfg);
+  VertexSeeder::Config seederCfg(*m_ipEst);
   VertexSeeder seeder(seederCfg);
-  // Set up the actual vertex finder
+  // Set up the actual vertex finder, with an estimator of its own
   VertexFinder::Config finderCfg(std::move(vertexFitter), std::move(linearizer),
-                                 std::move(seeder), std::move(ipEst));
+                                 std::move(seeder), ImpactPointEstimator(ipEstCfg));
   finderCfg.maxVertices                 = m_cfg.maxVertices;
   finderCfg.reassignTracksAfterFirstFit = m_cfg.reassignTracksAfterFirstFit;
   #if Acts_VERSION_MAJOR >= 31
-  VertexFinder finder(std::move(finderCfg));
+  m_vertexFinder = std::make_unique<VertexFinder>(std::move(finderCfg));
   #else
-  VertexFinder finder(finderCfg);
+  m_vertexFinder = std::make_unique<VertexFinder>(finderCfg);
   #endif
+}
+
+std::unique_ptr<edm4eic::VertexCollection> eicrecon::IterativeVertexFinder::produce(
+    std::span<const ActsExamples::Trajectories* const> trajectories) {
+
+  auto outputVertices = std::make_unique<edm4eic::VertexCollection>();
+
+  using VertexFinderOptions = Acts::VertexingOptions<Acts::BoundTrackParameters>;
+
   VertexFinder::State state(*m_BField, m_fieldctx);
   VertexFinderOptions finderOpts(m_geoctx, m_fieldctx);
 
@@ -111,11 +104,13 @@ std::unique_ptr<edm4eic::VertexCollection> eicrecon::IterativeVertexFinder::prod
   }
 
   std::vector<Acts::Vertex<Acts::BoundTrackParameters>> vertices;
-  auto result = finder.find(inputTrackPointers, finderOpts, state);
+  auto result = m_findTimer.time([&] { return m_vertexFinder->find(inputTrackPointers, finderOpts, state); });
   if (result.ok()) {
     vertices = std::move(result.value());
   }
 
+  m_findTimer.debug(*m_log, vertices.size(), inputTrackPointers.size());
+
   for (const auto& vtx : vertices) {
     edm4eic::Cov4f cov(vtx.fullCovariance()(0,0), vtx.fullCovariance()(1,1), vtx.fullCovariance()(2,2), vtx.fullCovariance()(3,3),
                        vtx.fullCovariance()(0,1), vtx.fullCovariance()(0,2), vtx.fullCovariance()(0,3),
@@ -4,17 +4,27 @@
 
 #pragma once
 
+#include <Acts/EventData/TrackParameters.hpp>
 #include <Acts/Geometry/GeometryContext.hpp>
 #include <Acts/MagneticField/MagneticFieldContext.hpp>
+#include <Acts/Propagator/EigenStepper.hpp>
+#include <Acts/Propagator/Propagator.hpp>
+#include <Acts/Vertexing/FullBilloirVertexFitter.hpp>
+#include <Acts/Vertexing/HelicalTrackLinearizer.hpp>
+#include <Acts/Vertexing/ImpactPointEstimator.hpp>
+#include <Acts/Vertexing/IterativeVertexFinder.hpp>
+#include <Acts/Vertexing/ZScanVertexFinder.hpp>
 #include <edm4eic/VertexCollection.h>
 #include <spdlog/logger.h>
 #include <memory>
+#include <span>
 #include <vector>
 
 #include "ActsExamples/EventData/Trajectories.hpp"
 #include "ActsGeometryProvider.h"
 #include "DD4hepBField.h"
 #include "IterativeVertexFinderConfig.h"
+#include "VertexFindingTimer.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 
 namespace eicrecon {
@@ -24,15 +34,29 @@ public:
   void init(std::shared_ptr<const ActsGeometryProvider> geo_svc,
             std::shared_ptr<spdlog::logger> log);
   std::unique_ptr<edm4eic::VertexCollection>
-  produce(std::vector<const ActsExamples::Trajectories*> trajectories);
+  produce(std::span<const ActsExamples::Trajectories* const> trajectories);
 
 private:
+  using Propagator           = Acts::Propagator<Acts::EigenStepper<>>;
+  using Linearizer           = Acts::HelicalTrackLinearizer<Propagator>;
+  using VertexFitter         = Acts::FullBilloirVertexFitter<Acts::BoundTrackParameters, Linearizer>;
+  using ImpactPointEstimator = Acts::ImpactPointEstimator<Acts::BoundTrackParameters, Propagator>;
+  using VertexSeeder         = Acts::ZScanVertexFinder<VertexFitter>;
+  using VertexFinder         = Acts::IterativeVertexFinder<VertexFitter, VertexSeeder>;
+
   std::shared_ptr<spdlog::logger> m_log;
   std::shared_ptr<const ActsGeometryProvider> m_geoSvc;
 
   std::shared_ptr<const eicrecon::BField::DD4hepBField> m_BField = nullptr;
   Acts::GeometryContext m_geoctx;
   Acts::MagneticFieldContext m_fieldctx;
-  IterativeVertexFinderConfig m_cfg;
+
+  // built once in init(), the per-event state lives in VertexFinder::State
+  std::shared_ptr<Propagator> m_propagator;
+  // the seeder of m_vertexFinder keeps a reference to this estimator, which has to outlive it
+  std::unique_ptr<ImpactPointEstimator> m_ipEst;
+  std::unique_ptr<VertexFinder> m_vertexFinder;
+
+  VertexFindingTimer m_findTimer;
 };
 } // namespace eicrecon
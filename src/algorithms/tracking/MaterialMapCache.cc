@@ -0,0 +1,317 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <Acts/ActsVersion.hpp>
+#include <Acts/Definitions/Algebra.hpp>
+#include <Acts/Definitions/Common.hpp>
+#include <Acts/Definitions/Direction.hpp>
+#include <Acts/Geometry/TrackingVolume.hpp>
+#include <Acts/Material/BinnedSurfaceMaterial.hpp>
+#include <Acts/Material/HomogeneousSurfaceMaterial.hpp>
+#include <Acts/Material/HomogeneousVolumeMaterial.hpp>
+#include <Acts/Material/Material.hpp>
+#include <Acts/Material/MaterialSlab.hpp>
+#include <Acts/Surfaces/Surface.hpp>
+#include <Acts/Utilities/BinUtility.hpp>
+#include <Acts/Utilities/BinningData.hpp>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#include "MaterialMapCache.h"
+#include "services/geometry/disk_cache/CacheFile.h"
+
+namespace eicrecon {
+
+void MaterialMapDecorator::decorate(Acts::Surface& surface) const {
+  surface.assignSurfaceMaterial(nullptr);
+  if (auto it = m_maps.first.find(surface.geometryId()); it != m_maps.first.end()) {
+    surface.assignSurfaceMaterial(it->second);
+  }
+}
+
+void MaterialMapDecorator::decorate(Acts::TrackingVolume& volume) const {
+  volume.assignVolumeMaterial(nullptr);
+  if (auto it = m_maps.second.find(volume.geometryId()); it != m_maps.second.end()) {
+    volume.assignVolumeMaterial(it->second);
+  }
+}
+
+namespace material_map_cache {
+
+namespace {
+
+  // of the layout of the cached maps
+  constexpr std::uint32_t file_version = 1;
+
+  // the data of a file is the counts, followed by the bytes of the Writer
+  struct Counts {
+    std::uint64_t n_surfaces;
+    std::uint64_t n_volumes;
+    std::uint64_t n_bytes;
+  };
+
+  enum class Kind : std::uint8_t { Homogeneous = 0, Binned = 1 };
+
+  // file is too short or inconsistent
+  struct Truncated : std::runtime_error {
+    Truncated() : std::runtime_error("truncated material map cache") {}
+  };
+
+  class Writer {
+  public:
+    template <typename T>
+    void put(const T& value) {
+      static_assert(std::is_trivially_copyable_v<T>);
+      const auto* bytes = reinterpret_cast<const char*>(&value);
+      m_bytes.insert(m_bytes.end(), bytes, bytes + sizeof(T));
+    }
+
+    void put(const Acts::MaterialSlab& slab) {
+      const auto parameters = slab.material().parameters();
+      for (Eigen::Index i = 0; i < parameters.size(); ++i) {
+        put<float>(parameters[i]);
+      }
+      put<float>(slab.thickness());
+    }
+
+    const std::vector<char>& bytes() const { return m_bytes; }
+
+  private:
+    std::vector<char> m_bytes;
+  };
+
+  class Reader {
+  public:
+    Reader(const char* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    template <typename T>
+    T get() {
+      static_assert(std::is_trivially_copyable_v<T>);
+      if (m_pos + sizeof(T) > m_size) {
+        throw Truncated();
+      }
+      T value;
+      std::memcpy(&value, m_data + m_pos, sizeof(T));
+      m_pos += sizeof(T);
+      return value;
+    }
+
+    Acts::Material material() {
+      Acts::Material::ParametersVector parameters;
+      for (Eigen::Index i = 0; i < parameters.size(); ++i) {
+        parameters[i] = get<float>();
+      }
+      return Acts::Material(parameters);
+    }
+
+    Acts::MaterialSlab slab() {
+      const auto material = this->material();
+      return Acts::MaterialSlab(material, get<float>());
+    }
+
+    bool done() const { return m_pos == m_size; }
+
+  private:
+    const char* m_data;
+    std::size_t m_size;
+    std::size_t m_pos{0};
+  };
+
+  // split factor of a surface material, it is not exposed directly
+  double split_factor(const Acts::ISurfaceMaterial& material) {
+    return material.factor(Acts::Direction::Backward, Acts::MaterialUpdateStage::PreUpdate);
+  }
+
+  bool put_bin_utility(Writer& out, const Acts::BinUtility& bin_utility) {
+    const auto& matrix = bin_utility.transform().matrix();
+    for (Eigen::Index i = 0; i < matrix.size(); ++i) {
+      out.put<double>(matrix.data()[i]);
+    }
+    out.put<std::uint32_t>(bin_utility.binningData().size());
+    for (const auto& data : bin_utility.binningData()) {
+      if (data.subBinningData) {
+        return false;
+      }
+      out.put<std::int32_t>(static_cast<std::int32_t>(data.type));
+      out.put<std::int32_t>(static_cast<std::int32_t>(data.option));
+      out.put<std::int32_t>(static_cast<std::int32_t>(data.binvalue));
+      if (data.type == Acts::equidistant) {
+        out.put<std::uint32_t>(data.bins());
+        out.put<float>(data.min);
+        out.put<float>(data.max);
+      } else {
+        const auto& boundaries = data.boundaries();
+        out.put<std::uint32_t>(boundaries.size());
+        for (float boundary : boundaries) {
+          out.put<float>(boundary);
+        }
+      }
+    }
+    return true;
+  }
+
+  Acts::BinUtility get_bin_utility(Reader& in) {
+    Acts::Transform3 transform;
+    auto& matrix = transform.matrix();
+    for (Eigen::Index i = 0; i < matrix.size(); ++i) {
+      matrix.data()[i] = in.get<double>();
+    }
+    const auto n_data = in.get<std::uint32_t>();
+    if (n_data == 0 || n_data > 3) {
+      throw Truncated();
+    }
+    std::optional<Acts::BinUtility> bin_utility;
+    for (std::uint32_t k = 0; k < n_data; ++k) {
+      const auto type = static_cast<Acts::BinningType>(in.get<std::int32_t>());
+      const auto option = static_cast<Acts::BinningOption>(in.get<std::int32_t>());
+      const auto value = static_cast<Acts::BinningValue>(in.get<std::int32_t>());
+      const auto n = in.get<std::uint32_t>();
+      std::optional<Acts::BinningData> data;
+      if (type == Acts::equidistant) {
+        const auto min = in.get<float>();
+        const auto max = in.get<float>();
+        data.emplace(option, value, n, min, max);
+      } else {
+        std::vector<float> boundaries(n);
+        for (auto& boundary : boundaries) {
+          boundary = in.get<float>();
+        }
+        data.emplace(option, value, boundaries);
+      }
+      if (!bin_utility) {
+        bin_utility.emplace(*data, transform);
+      } else {
+        *bin_utility += Acts::BinUtility(*data);
+      }
+    }
+    return *bin_utility;
+  }
+
+} // namespace
+
+std::uint64_t key(const std::string& material_file) {
+  // the format, the Acts version and the content of the file
+  CacheHash hash;
+  hash.add(static_cast<std::uint64_t>(file_version));
+  hash.add(static_cast<std::uint64_t>(Acts::VersionMajor));
+  hash.add(static_cast<std::uint64_t>(Acts::VersionMinor));
+  hash.add(static_cast<std::uint64_t>(Acts::VersionPatch));
+  if (!hash.add_file(material_file)) {
+    return 0;
+  }
+  // 0 is reserved for unreadable files
+  return hash.value() == 0 ? 1 : hash.value();
+}
+
+std::optional<DetectorMaterialMaps> read(const std::string& path, std::uint64_t key) {
+  const auto blob = cache_file::load(path, file_version, 0, key);
+  if (!blob) {
+    return std::nullopt;
+  }
+
+  DetectorMaterialMaps maps;
+  try {
+    const Counts header = blob->array<Counts>(0, 1)[0];
+    const auto bytes = blob->array<char>(sizeof(Counts), header.n_bytes);
+    Reader in(bytes.data(), bytes.size());
+    for (std::uint64_t s = 0; s < header.n_surfaces; ++s) {
+      const Acts::GeometryIdentifier id(in.get<std::uint64_t>());
+      const auto kind = static_cast<Kind>(in.get<std::uint8_t>());
+      const auto mapping_type = static_cast<Acts::MappingType>(in.get<std::int32_t>());
+      const auto split = in.get<double>();
+      if (kind == Kind::Homogeneous) {
+        maps.first.emplace(id, std::make_shared<const Acts::HomogeneousSurfaceMaterial>(in.slab(), split, mapping_type));
+      } else if (kind == Kind::Binned) {
+        auto bin_utility = get_bin_utility(in);
+        Acts::MaterialSlabMatrix slabs(in.get<std::uint32_t>());
+        for (auto& row : slabs) {
+          const auto n = in.get<std::uint32_t>();
+          row.reserve(n);
+          for (std::uint32_t k = 0; k < n; ++k) {
+            row.push_back(in.slab());
+          }
+        }
+        maps.first.emplace(id, std::make_shared<const Acts::BinnedSurfaceMaterial>(bin_utility, std::move(slabs), split, mapping_type));
+      } else {
+        return std::nullopt;
+      }
+    }
+    for (std::uint64_t v = 0; v < header.n_volumes; ++v) {
+      const Acts::GeometryIdentifier id(in.get<std::uint64_t>());
+      if (static_cast<Kind>(in.get<std::uint8_t>()) != Kind::Homogeneous) {
+        return std::nullopt;
+      }
+      maps.second.emplace(id, std::make_shared<const Acts::HomogeneousVolumeMaterial>(in.material()));
+    }
+    if (!in.done()) {
+      return std::nullopt;
+    }
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+  return maps;
+}
+
+bool write(const std::string& path, std::uint64_t key, const DetectorMaterialMaps& maps) {
+  Writer out;
+
+  for (const auto& [id, material] : maps.first) {
+    out.put<std::uint64_t>(id.value());
+    if (typeid(*material) == typeid(Acts::HomogeneousSurfaceMaterial)) {
+      const auto& homogeneous = static_cast<const Acts::HomogeneousSurfaceMaterial&>(*material);
+      out.put(Kind::Homogeneous);
+      out.put<std::int32_t>(static_cast<std::int32_t>(homogeneous.mappingType()));
+      out.put<double>(split_factor(homogeneous));
+      out.put(homogeneous.materialSlab(Acts::Vector2{0., 0.}));
+    } else if (typeid(*material) == typeid(Acts::BinnedSurfaceMaterial)) {
+      const auto& binned = static_cast<const Acts::BinnedSurfaceMaterial&>(*material);
+      out.put(Kind::Binned);
+      out.put<std::int32_t>(static_cast<std::int32_t>(binned.mappingType()));
+      out.put<double>(split_factor(binned));
+      if (!put_bin_utility(out, binned.binUtility())) {
+        return false;
+      }
+      out.put<std::uint32_t>(binned.fullMaterial().size());
+      for (const auto& row : binned.fullMaterial()) {
+        out.put<std::uint32_t>(row.size());
+        for (const auto& slab : row) {
+          out.put(slab);
+        }
+      }
+    } else {
+      return false;
+    }
+  }
+
+  for (const auto& [id, material] : maps.second) {
+    if (typeid(*material) != typeid(Acts::HomogeneousVolumeMaterial)) {
+      return false;
+    }
+    out.put<std::uint64_t>(id.value());
+    out.put(Kind::Homogeneous);
+    const auto parameters = material->material(Acts::Vector3{0., 0., 0.}).parameters();
+    for (Eigen::Index i = 0; i < parameters.size(); ++i) {
+      out.put<float>(parameters[i]);
+    }
+  }
+
+  // a cache that can not be written is not an error, the map is parsed again next time
+  const Counts counts{maps.first.size(), maps.second.size(), out.bytes().size()};
+  try {
+    cache_file::store(path, file_version, 0, key,
+                      {std::as_bytes(std::span(&counts, 1)), std::as_bytes(std::span(out.bytes()))});
+  } catch (const std::exception&) {
+    return false;
+  }
+  return true;
+}
+
+} // namespace material_map_cache
+
+} // namespace eicrecon
@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <Acts/Geometry/GeometryIdentifier.hpp>
+#include <Acts/Material/IMaterialDecorator.hpp>
+#include <Acts/Material/ISurfaceMaterial.hpp>
+#include <Acts/Material/IVolumeMaterial.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace eicrecon {
+
+  using SurfaceMaterialMap = std::map<Acts::GeometryIdentifier, std::shared_ptr<const Acts::ISurfaceMaterial>>;
+  using VolumeMaterialMap = std::map<Acts::GeometryIdentifier, std::shared_ptr<const Acts::IVolumeMaterial>>;
+  using DetectorMaterialMaps = std::pair<SurfaceMaterialMap, VolumeMaterialMap>;
+
+  /** Decorates surfaces and volumes with material from loaded material maps.
+   *
+   * Same behaviour as Acts::JsonMaterialDecorator, which can only be built
+   * from a file: existing material is cleared and replaced by the material
+   * of the map, if any.
+   */
+  class MaterialMapDecorator : public Acts::IMaterialDecorator {
+  public:
+    explicit MaterialMapDecorator(DetectorMaterialMaps maps) : m_maps(std::move(maps)) {}
+
+    void decorate(Acts::Surface& surface) const final;
+    void decorate(Acts::TrackingVolume& volume) const final;
+
+  private:
+    DetectorMaterialMaps m_maps;
+  };
+
+  /** Binary cache of material maps.
+   *
+   * Parsing a JSON material map is the slowest part of the tracking geometry
+   * construction. The cache stores the parsed maps in a flat binary file,
+   * keyed by a hash of the content of the material map file, that is memory
+   * mapped on later starts. Only homogeneous and binned surface material and
+   * homogeneous volume material can be cached.
+   */
+  namespace material_map_cache {
+
+    /// Key of the cache of a material map file
+    std::uint64_t key(const std::string& material_file);
+
+    /// Maps read from the cache file, std::nullopt if it is missing or does not match the key
+    std::optional<DetectorMaterialMaps> read(const std::string& path, std::uint64_t key);
+
+    /// Writes the cache file, false if the maps can not be cached or the file can not be written
+    bool write(const std::string& path, std::uint64_t key, const DetectorMaterialMaps& maps);
+
+  } // namespace material_map_cache
+
+} // namespace eicrecon
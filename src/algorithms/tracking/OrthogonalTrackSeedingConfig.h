@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <vector>
 
 #include <Acts/Definitions/Units.hpp>
 
@@ -78,6 +79,14 @@ namespace eicrecon {
     float  seedConfMaxZOriginForward      = 150.0 * Acts::UnitConstants::mm;
     float  minImpactSeedConfForward       = 1.0 * Acts::UnitConstants::mm;
 
+    //////////////////////////////////////
+    /// REGION PARTITIONING
+    /// Space points are split into regions of pseudorapidity (seen from the origin)
+    /// that are seeded in parallel, and the seeds of all regions are merged without
+    /// duplicates. The bounds are between regions, no partitioning if empty.
+    std::vector<double> etaRegionBounds = {};
+    double etaRegionOverlap = 0.3; // space points this close in eta to a region are also added to it
+
     //////////////////////////////////////
     ///Seed Covariance Error Matrix
     float locaError   = 1.5 * Acts::UnitConstants::mm;     //Error on Loc a
@@ -18,6 +18,7 @@
 #include <spdlog/common.h>
 #include <Eigen/Core>
 #include <cmath>
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <utility>
@@ -31,6 +32,24 @@ void eicrecon::TrackParamTruthInit::init(std::shared_ptr<const ActsGeometryProvi
 
     // TODO make a service?
     m_pdg_db = std::make_shared<TDatabasePDG>();
+
+    // line surface for the local position values
+    m_perigee = Acts::Surface::makeShared<Acts::PerigeeSurface>(Acts::Vector3(0,0,0));
+
+    m_maxCosTheta = std::tanh(m_cfg.maxEtaForward);
+    m_minCosTheta = -std::tanh(std::abs(m_cfg.maxEtaBackward));
+}
+
+double eicrecon::TrackParamTruthInit::chargeOf(std::int32_t pdg) {
+    // the few PDG codes of the events are looked up once
+    auto [it, inserted] = m_charge_by_pdg.try_emplace(pdg, std::numeric_limits<double>::quiet_NaN());
+    if (inserted) {
+        const auto* particle = m_pdg_db->GetParticle(pdg);
+        if (particle != nullptr) {
+            it->second = (std::abs(particle->Charge()) < std::numeric_limits<double>::epsilon()) ? 0. : std::copysign(1.0, particle->Charge());
+        }
+    }
+    return it->second;
 }
 
 std::unique_ptr<edm4eic::TrackParametersCollection>
@@ -41,7 +60,7 @@ eicrecon::TrackParamTruthInit::produce(const edm4hep::MCParticleCollection* mcpa
     // Create output collection
     auto track_parameters = std::make_unique<edm4eic::TrackParametersCollection>();
 
-    // Loop over input particles
+    // Loop over input particles, with the cheapest cuts first
     for (const auto& mcparticle: *mcparticles) {
 
         // require generatorStatus == 1 for stable generated particles in HepMC3 and DDSim gun
@@ -50,6 +69,21 @@ eicrecon::TrackParamTruthInit::produce(const edm4hep::MCParticleCollection* mcpa
             continue;
         }
 
+        // get the particle charge
+        // note that we cannot trust the mcparticles charge, as DD4hep
+        // sets this value to zero! let's lookup by PDGID instead
+        //const double charge = m_pidSvc->particle(mcparticle.getPDG()).charge;
+        const auto pdg = mcparticle.getPDG();
+        const double charge = chargeOf(pdg);
+        if (std::isnan(charge)) {
+            m_log->debug("particle with PDG {} not in TDatabasePDG", pdg);
+            continue;
+        }
+        if (charge == 0.) {
+            m_log->trace("ignoring neutral particle");
+            continue;
+        }
+
         // require close to interaction vertex
         auto v = mcparticle.getVertex();
         if (abs(v.x) * dd4hep::mm > m_cfg.maxVertexX ||
@@ -67,37 +101,18 @@ eicrecon::TrackParamTruthInit::produce(const edm4hep::MCParticleCollection* mcpa
             continue;
         }
 
-        // require minimum pseudorapidity
-        const auto phi   = std::atan2(p.y, p.x);
-        const auto theta = std::atan2(std::hypot(p.x, p.y), p.z);
-        const auto eta   = -std::log(std::tan(theta/2));
-        if (eta > m_cfg.maxEtaForward || eta < -std::abs(m_cfg.maxEtaBackward)) {
-            m_log->trace("ignoring particle with Eta = {}", eta);
-            continue;
-        }
-
-        // get the particle charge
-        // note that we cannot trust the mcparticles charge, as DD4hep
-        // sets this value to zero! let's lookup by PDGID instead
-        //const double charge = m_pidSvc->particle(mcparticle.getPDG()).charge;
-        const auto pdg = mcparticle.getPDG();
-        const auto* particle = m_pdg_db->GetParticle(pdg);
-        if (particle == nullptr) {
-            m_log->debug("particle with PDG {} not in TDatabasePDG", pdg);
-            continue;
-        }
-        double charge = std::copysign(1.0,particle->Charge());
-        if (abs(charge) < std::numeric_limits<double>::epsilon()) {
-            m_log->trace("ignoring neutral particle");
+        // require minimum pseudorapidity, as a cut on cos(theta)
+        const auto cos_theta = p.z / pmag;
+        if (!(cos_theta <= m_maxCosTheta && cos_theta >= m_minCosTheta)) {
+            m_log->trace("ignoring particle with Eta = {}", std::atanh(cos_theta));
             continue;
         }
+        const auto phi   = std::atan2(p.y, p.x);
+        const auto theta = std::atan2(std::hypot(p.x, p.y), p.z);
 
         // modify initial momentum to avoid bleeding truth to results when fit fails
         const auto pinit = pmag * (1.0 + m_cfg.momentumSmear * m_normDist(generator));
 
-        // define line surface for local position values
-        auto perigee = Acts::Surface::makeShared<Acts::PerigeeSurface>(Acts::Vector3(0,0,0));
-
         // track particle back to transverse point-of-closest approach
         // with respect to the defined line surface
         auto linesurface_parameter = -(v.x*p.x + v.y*p.y)/(p.x*p.x + p.y*p.y);
@@ -110,7 +125,7 @@ eicrecon::TrackParamTruthInit::produce(const edm4hep::MCParticleCollection* mcpa
         Acts::Vector3 direction(sin(theta)*cos(phi), sin(theta)*sin(phi), cos(theta));
 
         // convert from global to local coordinates using the defined line surface
-        auto local = perigee->globalToLocal(m_geoSvc->getActsGeometryContext(), global, direction);
+        auto local = m_perigee->globalToLocal(m_geoSvc->getActsGeometryContext(), global, direction);
 
         if(!local.ok())
         {
@@ -4,12 +4,15 @@
 
 #pragma once
 
+#include <Acts/Surfaces/PerigeeSurface.hpp>
 #include <TDatabasePDG.h>
 #include <edm4eic/TrackParametersCollection.h>
 #include <edm4hep/MCParticleCollection.h>
 #include <spdlog/logger.h>
+#include <cstdint>
 #include <memory>
 #include <random>
+#include <unordered_map>
 
 #include "ActsGeometryProvider.h"
 #include "TrackParamTruthInitConfig.h"
@@ -29,6 +32,15 @@ namespace eicrecon {
         std::shared_ptr<spdlog::logger> m_log;
         std::shared_ptr<TDatabasePDG> m_pdg_db;
         std::shared_ptr<const ActsGeometryProvider> m_geoSvc;
+        std::shared_ptr<Acts::PerigeeSurface> m_perigee;
+
+        /// Sign of the charge of a PDG code, 0 for neutral particles and NaN for unknown codes
+        double chargeOf(std::int32_t pdg);
+        std::unordered_map<std::int32_t, double> m_charge_by_pdg;
+
+        // the eta cuts as cuts on cos(theta), tanh(eta) = cos(theta)
+        double m_maxCosTheta = 1;
+        double m_minCosTheta = -1;
 
         std::default_random_engine generator; // TODO: need something more appropriate here
         std::uniform_int_distribution<int> m_uniformIntDist{-1, 1}; // defaults to min=-1, max=1
@@ -37,7 +37,7 @@ namespace eicrecon {
     }
 
 
-    std::unique_ptr<edm4eic::TrackSegmentCollection> TrackProjector::execute(std::vector<const ActsExamples::Trajectories *> trajectories) {
+    std::unique_ptr<edm4eic::TrackSegmentCollection> TrackProjector::execute(std::span<const ActsExamples::Trajectories* const> trajectories) {
 
         // create output collections
         auto track_segments = std::make_unique<edm4eic::TrackSegmentCollection>();
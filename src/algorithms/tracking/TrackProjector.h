@@ -8,6 +8,7 @@
 #include <edm4eic/TrackSegmentCollection.h>
 #include <spdlog/logger.h>
 #include <memory>
+#include <span>
 #include <vector>
 
 #include "ActsGeometryProvider.h"
@@ -26,7 +27,7 @@ namespace eicrecon {
 
             void init(std::shared_ptr<const ActsGeometryProvider> geo_svc, std::shared_ptr<spdlog::logger> logger);
 
-            std::unique_ptr<edm4eic::TrackSegmentCollection> execute(std::vector<const ActsExamples::Trajectories*> trajectories);
+            std::unique_ptr<edm4eic::TrackSegmentCollection> execute(std::span<const ActsExamples::Trajectories* const> trajectories);
 
         private:
             std::shared_ptr<const ActsGeometryProvider> m_geo_provider;
@@ -9,7 +9,6 @@
 #include <Acts/EventData/MultiTrajectoryHelpers.hpp>
 #include <Acts/EventData/ParticleHypothesis.hpp>
 #include <Acts/Geometry/GeometryIdentifier.hpp>
-#include <Acts/Geometry/TrackingGeometry.hpp>
 #include <Acts/MagneticField/MagneticFieldProvider.hpp>
 #include <Acts/Propagator/EigenStepper.hpp>
 #include <Acts/Propagator/Propagator.hpp>
@@ -17,7 +16,6 @@
 #include <Acts/Surfaces/CylinderSurface.hpp>
 #include <Acts/Surfaces/DiscSurface.hpp>
 #include <Acts/Surfaces/RadialBounds.hpp>
-#include <Acts/Utilities/Logger.hpp>
 #include <ActsExamples/EventData/Trajectories.hpp>
 #include <DD4hep/Handle.h>
 #include <Evaluator/DD4hepUnits.h>
@@ -34,17 +32,21 @@
 #include <functional>
 #include <iterator>
 #include <map>
+#include <numbers>
 #include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <tuple>
 #include <typeinfo>
+#include <unordered_map>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #include "algorithms/tracking/ActsGeometryProvider.h"
 #include "algorithms/tracking/TrackPropagation.h"
 #include "algorithms/tracking/TrackPropagationConfig.h"
-#include "extensions/spdlog/SpdlogToActs.h"
 
 namespace eicrecon {
 
@@ -54,12 +56,117 @@ struct multilambda : L... {
   constexpr multilambda(L...lambda) : L(std::move(lambda))... {}
 };
 
+namespace {
+
+  /** Helix of a track in a uniform solenoid field, in Acts units
+   *
+   * Only used to order the surfaces along the track and to drop the ones it
+   * cannot reach, the actual propagation is done by the Acts stepper.
+   */
+  struct Helix {
+    Acts::Vector3 position;
+    double ux, uy;                // transverse direction
+    double sin_theta, cos_theta;
+    double rho{0};                // transverse radius of curvature, 0 for a straight line
+    double cx{0}, cy{0};          // centre of the transverse circle
+    double alpha0{0};             // azimuth of the position around the centre
+    double sense{1};              // +1 counterclockwise, -1 clockwise
+
+    Helix(const Acts::Vector3& pos, const Acts::Vector3& dir, double charge, double p, double bz)
+      : position(pos) {
+      const double pt = p * std::hypot(dir.x(), dir.y());
+      sin_theta = std::hypot(dir.x(), dir.y());
+      cos_theta = dir.z();
+      ux = sin_theta > 0 ? dir.x() / sin_theta : 1;
+      uy = sin_theta > 0 ? dir.y() / sin_theta : 0;
+      if (charge != 0 && bz != 0) {
+        rho = pt / std::abs(charge * bz);
+        // the Lorentz force q u x B points away from the centre for q Bz > 0
+        sense = charge * bz > 0 ? -1 : 1;
+        cx = pos.x() - sense * rho * uy;
+        cy = pos.y() + sense * rho * ux;
+        alpha0 = std::atan2(pos.y() - cy, pos.x() - cx);
+      }
+    }
+
+    /// Transverse radius after a transverse path length s_t
+    double radius(double s_t) const {
+      if (rho == 0) {
+        return std::hypot(position.x() + s_t * ux, position.y() + s_t * uy);
+      }
+      const double alpha = alpha0 + sense * s_t / rho;
+      return std::hypot(cx + rho * std::cos(alpha), cy + rho * std::sin(alpha));
+    }
+
+    /// Transverse path lengths to the crossings of a cylinder of radius r, the
+    /// crossings are kept if r is within a fraction `tolerance` of the reach
+    std::vector<double> crossings(double r, double tolerance) const {
+      std::vector<double> s_t;
+      if (rho == 0) {
+        const double b = position.x() * ux + position.y() * uy;
+        const double c = position.x() * position.x() + position.y() * position.y() - r * r;
+        double disc = b * b - c;
+        if (disc < 0) {
+          const double closest = std::sqrt(std::max(0., c + r * r - b * b));
+          if (closest > (1 + tolerance) * r) return s_t;
+          disc = 0;
+        }
+        for (double t : {-b - std::sqrt(disc), -b + std::sqrt(disc)}) {
+          if (t >= 0) s_t.push_back(t);
+        }
+        return s_t;
+      }
+      const double d = std::hypot(cx, cy);
+      if (d == 0) {
+        if (std::abs(rho - r) <= tolerance * r) s_t.push_back(0);
+        return s_t;
+      }
+      const double r_lo = std::abs(d - rho), r_hi = d + rho;
+      if (r < (1 - tolerance) * r_lo || r > (1 + tolerance) * r_hi) return s_t;
+      const double beta = std::acos(std::clamp((rho * rho + d * d - r * r) / (2 * rho * d), -1., 1.));
+      const double gamma = std::atan2(-cy, -cx);
+      for (double alpha : {gamma - beta, gamma + beta}) {
+        const double delta = std::remainder(sense * (alpha - alpha0) - std::numbers::pi, 2 * std::numbers::pi) + std::numbers::pi;
+        s_t.push_back(rho * delta);
+      }
+      std::sort(s_t.begin(), s_t.end());
+      return s_t;
+    }
+  };
+
+  /// Path length to the first crossing of the surface within its bounds
+  /// (widened by the tolerance), if any
+  template<class Extent>
+  std::optional<double> expectedPathLength(const Helix& helix, const Extent& extent, double tolerance) {
+    const double z0 = helix.position.z();
+    if (extent.disc) {
+      if (helix.cos_theta == 0) return std::nullopt;
+      const double s = (extent.z_min - z0) / helix.cos_theta;
+      if (s < 0) return std::nullopt;
+      const double r = helix.radius(s * helix.sin_theta);
+      if (r < extent.r_min - tolerance * s || r > extent.r_max + tolerance * s) return std::nullopt;
+      return s;
+    }
+    if (helix.sin_theta == 0) return std::nullopt;
+    for (double s_t : helix.crossings(extent.r_min, tolerance)) {
+      const double s = s_t / helix.sin_theta;
+      const double z = z0 + s * helix.cos_theta;
+      if (z >= extent.z_min - tolerance * s && z <= extent.z_max + tolerance * s) return s;
+    }
+    return std::nullopt;
+  }
+
+} // namespace
+
 void TrackPropagation::init(const dd4hep::Detector* detector,
                             std::shared_ptr<const ActsGeometryProvider> geo_svc,
                             std::shared_ptr<spdlog::logger> logger) {
     m_geoSvc = geo_svc;
     m_log = logger;
 
+    m_field = m_geoSvc->getFieldProvider();
+    m_propagator = std::make_unique<const Propagator>(Stepper(m_field));
+
     std::map<uint32_t,size_t> system_id_layers;
 
     multilambda _toDouble = {
@@ -102,12 +209,43 @@ void TrackPropagation::init(const dd4hep::Detector* detector,
     m_filter_surfaces.resize(m_cfg.filter_surfaces.size());
     std::transform(m_cfg.filter_surfaces.cbegin(), m_cfg.filter_surfaces.cend(), m_filter_surfaces.begin(), _toActsSurface);
 
+    m_surfaces = m_filter_surfaces;
+    m_surfaces.insert(m_surfaces.end(), m_target_surfaces.begin(), m_target_surfaces.end());
+    // in the order of m_surfaces, also if init() runs again
+    m_surface_extents.clear();
+    m_surface_extents.reserve(m_surfaces.size());
+    for (const auto& surface : m_surfaces) {
+      if (surface->type() == Acts::Surface::Disc) {
+        const auto& bounds = dynamic_cast<const Acts::RadialBounds&>(surface->bounds());
+        const double z = surface->center(m_geoContext).z();
+        m_surface_extents.push_back({true, bounds.rMin(), bounds.rMax(), z, z});
+      } else {
+        const auto& bounds = dynamic_cast<const Acts::CylinderBounds&>(surface->bounds());
+        const double r = bounds.get(Acts::CylinderBounds::eR);
+        const double z = surface->center(m_geoContext).z();
+        const double half_z = bounds.get(Acts::CylinderBounds::eHalfLengthZ);
+        m_surface_extents.push_back({false, r, r, z - half_z, z + half_z});
+      }
+    }
+
     m_log->trace("Initialized");
 }
 
 
+TrackPropagation::Workspace& TrackPropagation::workspace() const {
+    thread_local std::unordered_map<uint64_t, Workspace*> workspaces;
+    auto& workspace = workspaces[m_id];
+    if (workspace == nullptr) {
+        std::lock_guard<std::mutex> lock(m_workspaces_mutex);
+        m_workspaces.push_back(std::make_unique<Workspace>(m_geoContext, m_fieldContext, *m_field));
+        workspace = m_workspaces.back().get();
+    }
+    return *workspace;
+}
+
+
 void TrackPropagation::propagateToSurfaceList(
-          const std::tuple<const edm4eic::TrackCollection&, const std::vector<const ActsExamples::Trajectories*>, const std::vector<const ActsExamples::ConstTrackContainer*>> input,
+          const std::tuple<const edm4eic::TrackCollection&, std::span<const ActsExamples::Trajectories* const>, std::span<const ActsExamples::ConstTrackContainer* const>> input,
           const std::tuple<edm4eic::TrackSegmentCollection*> output) const
 {
     const auto [tracks, acts_trajectories, acts_tracks] = input;
@@ -122,13 +260,25 @@ void TrackPropagation::propagateToSurfaceList(
     // loop over input trajectories
     for (size_t i = 0; const auto& traj : acts_trajectories) {
 
+      // in single pass mode, propagate through filter and target surfaces at once
+      std::vector<std::unique_ptr<edm4eic::TrackPoint>> single_pass_points;
+      if (m_cfg.single_pass) {
+        single_pass_points = propagateSinglePass(traj, 0, m_surfaces.size());
+      }
+
       // check if this trajectory can be propagated to any filter surface
       bool trajectory_reaches_filter_surface{false};
-      for (const auto& filter_surface: m_filter_surfaces) {
-        auto point = propagate(edm4eic::Track{}, traj, filter_surface);
-        if (point) {
-          trajectory_reaches_filter_surface = true;
-          break;
+      if (m_cfg.single_pass) {
+        trajectory_reaches_filter_surface = std::any_of(
+          single_pass_points.cbegin(), single_pass_points.cbegin() + m_filter_surfaces.size(),
+          [](const auto& point) { return point != nullptr; });
+      } else {
+        for (const auto& filter_surface: m_filter_surfaces) {
+          auto point = propagate(edm4eic::Track{}, traj, filter_surface);
+          if (point) {
+            trajectory_reaches_filter_surface = true;
+            break;
+          }
         }
       }
       if (trajectory_reaches_filter_surface == false) {
@@ -151,10 +301,12 @@ void TrackPropagation::propagateToSurfaceList(
       decltype(edm4eic::TrackSegmentData::lengthError) length_error = 0;
 
       // loop over projection-target surfaces
-      for (const auto& target_surface : m_target_surfaces) {
+      for (size_t j = 0; j < m_target_surfaces.size(); ++j) {
 
         // project the trajectory `traj` to this surface
-        auto point = propagate(edm4eic::Track{}, traj, target_surface);
+        auto point = m_cfg.single_pass
+          ? std::move(single_pass_points[m_filter_surfaces.size() + j])
+          : propagate(edm4eic::Track{}, traj, m_target_surfaces[j]);
         if (!point) {
           m_log->trace("<> Failed to propagate trajectory to this plane");
           continue;
@@ -236,18 +388,7 @@ void TrackPropagation::propagateToSurfaceList(
 
         m_log->trace("    TrackPropagation. Propagating to surface # {}", typeid(targetSurf->type()).name());
 
-        std::shared_ptr<const Acts::TrackingGeometry> trackingGeometry = m_geoSvc->trackingGeometry();
-        std::shared_ptr<const Acts::MagneticFieldProvider> magneticField = m_geoSvc->getFieldProvider();
-        using Stepper = Acts::EigenStepper<>;
-        using Propagator = Acts::Propagator<Stepper>;
-        Stepper stepper(magneticField);
-        Propagator propagator(stepper);
-
-        ACTS_LOCAL_LOGGER(eicrecon::getSpdlogLogger("PROP", m_log));
-
-        Acts::PropagatorOptions<> options(m_geoContext, m_fieldContext);
-
-        auto result = propagator.propagate(initial_bound_parameters, *targetSurf, options);
+        auto result = m_propagator->propagate(initial_bound_parameters, *targetSurf, workspace().options);
 
         // check propagation result
         if (!result.ok()) {
@@ -256,13 +397,85 @@ void TrackPropagation::propagateToSurfaceList(
         }
         m_log->trace("    propagation result is OK");
 
+        m_log->trace("    chi2    = {:.4f}", trajState.chi2Sum);
+
+        return makeTrackPoint(*((*result).endParameters), (*result).pathLength, *targetSurf);
+    }
+
+
+    std::vector<std::unique_ptr<edm4eic::TrackPoint>> TrackPropagation::propagateSinglePass(
+      const ActsExamples::Trajectories *acts_trajectory,
+      size_t first, size_t last) const {
+
+        std::vector<std::unique_ptr<edm4eic::TrackPoint>> points(last - first);
+
+        const auto &trackTips = acts_trajectory->tips();
+        if (trackTips.empty()) {
+            m_log->trace("  Empty multiTrajectory.");
+            return points;
+        }
+        const auto &initial_bound_parameters = acts_trajectory->trackParameters(trackTips.front());
+
+        auto& ws = workspace();
+
+        // order the reachable surfaces by the path length of the helix in the field at the origin
+        const Acts::Vector3 origin = initial_bound_parameters.position(m_geoContext);
+        auto field = m_field->getField(origin, ws.field_cache);
+        const Helix helix(origin, initial_bound_parameters.direction(),
+                          initial_bound_parameters.charge(), initial_bound_parameters.absoluteMomentum(),
+                          field.ok() ? field->z() : 0.);
+
+        std::vector<std::pair<double, size_t>> order;
+        order.reserve(last - first);
+        for (size_t i = first; i < last; ++i) {
+            auto s = expectedPathLength(helix, m_surface_extents[i], m_cfg.reachability_tolerance);
+            if (!s) {
+                m_log->trace("    surface {} is not reachable", i);
+                continue;
+            }
+            order.emplace_back(*s, i);
+        }
+        std::sort(order.begin(), order.end());
+
+        // each step starts from the last surface reached, so that the track is only stepped through once
+        Acts::BoundTrackParameters parameters = initial_bound_parameters;
+        double path_length = 0;
+        std::optional<size_t> last_reached;
+        for (const auto& [expected, i] : order) {
+            const auto& surface = m_surfaces[i];
+
+            // filter and target surfaces can coincide
+            if (last_reached && *m_surfaces[*last_reached] == *surface) {
+                points[i - first] = std::make_unique<edm4eic::TrackPoint>(*points[*last_reached - first]);
+                points[i - first]->surface = surface->geometryId().value();
+                continue;
+            }
+
+            auto result = m_propagator->propagate(parameters, *surface, ws.options);
+            if (!result.ok()) {
+                m_log->trace("    propagation to surface {} failed (expected path length {})", i, expected);
+                continue;
+            }
+            path_length += (*result).pathLength;
+            parameters = *((*result).endParameters);
+            points[i - first] = makeTrackPoint(parameters, path_length, *surface);
+            last_reached = i;
+        }
+
+        return points;
+    }
+
+
+    std::unique_ptr<edm4eic::TrackPoint> TrackPropagation::makeTrackPoint(
+      const Acts::BoundTrackParameters& trackStateParams,
+      float pathLength,
+      const Acts::Surface& targetSurf) const {
+
         // Pulling results to convenient variables
-        auto trackStateParams = *((*result).endParameters);
         const auto &parameter = trackStateParams.parameters();
         const auto &covariance = *trackStateParams.covariance();
 
         // Path length
-        const float pathLength = (*result).pathLength;
         const float pathLengthError = 0;
         m_log->trace("    path len = {}", pathLength);
 
@@ -317,12 +530,11 @@ void TrackPropagation::propagateToSurfaceList(
         m_log->trace("    err phi = {:.4f}", sqrt(covariance(Acts::eBoundPhi, Acts::eBoundPhi)));
         m_log->trace("    err th  = {:.4f}", sqrt(covariance(Acts::eBoundTheta, Acts::eBoundTheta)));
         m_log->trace("    err q/p = {:.4f}", sqrt(covariance(Acts::eBoundQOverP, Acts::eBoundQOverP)));
-        m_log->trace("    chi2    = {:.4f}", trajState.chi2Sum);
         m_log->trace("    loc err = {:.4f}", static_cast<float>(covariance(Acts::eBoundLoc0, Acts::eBoundLoc0)));
         m_log->trace("    loc err = {:.4f}", static_cast<float>(covariance(Acts::eBoundLoc1, Acts::eBoundLoc1)));
         m_log->trace("    loc err = {:.4f}", static_cast<float>(covariance(Acts::eBoundLoc0, Acts::eBoundLoc1)));
 
-        uint64_t surface = targetSurf->geometryId().value();
+        uint64_t surface = targetSurf.geometryId().value();
         uint32_t system = 0; // default value...will be set in TrackPropagation factory
 
         /*
@@ -7,6 +7,9 @@
 #include <Acts/Geometry/GeometryContext.hpp>
 #include <Acts/Geometry/GeometryIdentifier.hpp>
 #include <Acts/MagneticField/MagneticFieldContext.hpp>
+#include <Acts/MagneticField/MagneticFieldProvider.hpp>
+#include <Acts/Propagator/EigenStepper.hpp>
+#include <Acts/Propagator/Propagator.hpp>
 #include <Acts/Surfaces/Surface.hpp>
 #include <Acts/Utilities/Result.hpp>
 #include <ActsExamples/EventData/Track.hpp>
@@ -18,7 +21,11 @@
 #include <fmt/core.h>
 #include <spdlog/logger.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <tuple>
 #include <vector>
 
@@ -43,7 +50,7 @@ namespace eicrecon {
         void init(const dd4hep::Detector* detector, std::shared_ptr<const ActsGeometryProvider> geo_svc, std::shared_ptr<spdlog::logger> logger);
 
         void process(
-                const std::tuple<const edm4eic::TrackCollection&, const std::vector<const ActsExamples::Trajectories*>, const std::vector<const ActsExamples::ConstTrackContainer*>> input,
+                const std::tuple<const edm4eic::TrackCollection&, std::span<const ActsExamples::Trajectories* const>, std::span<const ActsExamples::ConstTrackContainer* const>> input,
                 const std::tuple<edm4eic::TrackSegmentCollection*> output) const {
 
             const auto [tracks, acts_trajectories, acts_tracks] = input;
@@ -55,6 +62,17 @@ namespace eicrecon {
                     m_log->trace("track segment connected to track {}", i);
                     this_propagated_track.setTrack(tracks[i]);
                 }
+                if (m_cfg.single_pass) {
+                    auto points = propagateSinglePass(traj, m_filter_surfaces.size(), m_surfaces.size());
+                    for (size_t j = 0; j < points.size(); ++j) {
+                        if (!points[j]) continue;
+                        points[j]->surface = m_target_surfaces[j]->geometryId().layer();
+                        points[j]->system  = m_target_surfaces[j]->geometryId().extra();
+                        this_propagated_track.addToPoints(*points[j]);
+                    }
+                    ++i;
+                    continue;
+                }
                 for (auto& surf : m_target_surfaces) {
                     auto prop_point = propagate(
                         tracks.size() == acts_trajectories.size() ? tracks[i] : edm4eic::Track{},
@@ -79,17 +97,71 @@ namespace eicrecon {
          * @return the resulting collection of propagated tracks
          */
         void propagateToSurfaceList(
-            const std::tuple<const edm4eic::TrackCollection&, const std::vector<const ActsExamples::Trajectories*>, const std::vector<const ActsExamples::ConstTrackContainer*>> input,
+            const std::tuple<const edm4eic::TrackCollection&, std::span<const ActsExamples::Trajectories* const>, std::span<const ActsExamples::ConstTrackContainer* const>> input,
             const std::tuple<edm4eic::TrackSegmentCollection*> output) const;
 
+        /** Propagates a single trajectory once through the surfaces `m_surfaces[first:last]`
+         * in the order of their expected path lengths, surfaces that the analytic helix
+         * check finds unreachable are skipped;
+         * @return the track points, in the order of the surfaces, nullptr for surfaces not reached
+         */
+        std::vector<std::unique_ptr<edm4eic::TrackPoint>> propagateSinglePass(
+            const ActsExamples::Trajectories*,
+            size_t first, size_t last) const;
+
     private:
 
+        using Stepper = Acts::EigenStepper<>;
+        using Propagator = Acts::Propagator<Stepper>;
+
+        /** Per-thread state of the propagations, made on the first call of a thread
+         *  and reused by its following calls, see workspace()
+         */
+        struct Workspace {
+            Acts::PropagatorOptions<> options;
+            Acts::MagneticFieldProvider::Cache field_cache;
+
+            Workspace(const Acts::GeometryContext& geo_context, const Acts::MagneticFieldContext& field_context,
+                      const Acts::MagneticFieldProvider& field)
+              : options(geo_context, field_context), field_cache(field.makeCache(field_context)) {}
+        };
+
+        Workspace& workspace() const;
+
+        /** Analytic extent of a target or filter surface, a cylinder has r_min = r_max
+         *  and a disc has z_min = z_max
+         */
+        struct SurfaceExtent {
+            bool disc;
+            double r_min, r_max;
+            double z_min, z_max;
+        };
+
+        std::unique_ptr<edm4eic::TrackPoint> makeTrackPoint(
+            const Acts::BoundTrackParameters& params,
+            float pathLength,
+            const Acts::Surface& surface) const;
+
         Acts::GeometryContext m_geoContext;
         Acts::MagneticFieldContext m_fieldContext;
         std::shared_ptr<const ActsGeometryProvider> m_geoSvc;
         std::shared_ptr<spdlog::logger> m_log;
 
+        // built once in init(), Propagator::propagate() is const and shared by the threads
+        std::shared_ptr<const Acts::MagneticFieldProvider> m_field;
+        std::unique_ptr<const Propagator> m_propagator;
+
+        // ids are never reused, so the workspaces of a destroyed instance are never found again
+        static inline std::atomic<uint64_t> s_next_id{0};
+        const uint64_t m_id{s_next_id.fetch_add(1)};
+        mutable std::mutex m_workspaces_mutex;
+        mutable std::vector<std::unique_ptr<Workspace>> m_workspaces;
+
         std::vector<std::shared_ptr<Acts::Surface>> m_filter_surfaces;
         std::vector<std::shared_ptr<Acts::Surface>> m_target_surfaces;
+
+        // filter surfaces followed by target surfaces, for the single pass mode
+        std::vector<std::shared_ptr<Acts::Surface>> m_surfaces;
+        std::vector<SurfaceExtent> m_surface_extents;
     };
 } // namespace eicrecon
@@ -34,6 +34,12 @@ namespace eicrecon {
       [](const edm4eic::TrackPoint&) { return true; }
     };
     bool skip_track_on_track_point_cut_failure{false};
+
+    // propagate each trajectory once through all surfaces, ordered by the
+    // path length expected from a helix in the field at the track origin
+    bool single_pass{false};
+    // relative margin of the analytic helix check that drops unreachable surfaces
+    double reachability_tolerance{0.1};
   };
 
 } // eicrecon
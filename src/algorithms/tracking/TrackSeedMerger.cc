@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "TrackSeedMerger.h"
+
+#include <edm4eic/TrackParameters.h>
+#include <edm4hep/Vector2f.h>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace eicrecon {
+
+  void TrackSeedMerger::init(std::shared_ptr<spdlog::logger> log) {
+    m_log = log;
+  }
+
+  bool TrackSeedMerger::compatible(const edm4eic::TrackParameters& a, const edm4eic::TrackParameters& b) const {
+    if (std::signbit(a.getQOverP()) != std::signbit(b.getQOverP())) {
+      return false;
+    }
+    const double qop_scale = std::max(std::abs(a.getQOverP()), std::abs(b.getQOverP()));
+    if (std::abs(a.getQOverP() - b.getQOverP()) > m_cfg.maxRelDeltaQOverP * qop_scale) {
+      return false;
+    }
+    if (std::abs(a.getLoc().b - b.getLoc().b) > m_cfg.maxDeltaZ) {
+      return false;
+    }
+    double dphi = std::abs(a.getPhi() - b.getPhi());
+    if (dphi > std::numbers::pi) {
+      dphi = 2 * std::numbers::pi - dphi;
+    }
+    return dphi <= m_cfg.maxDeltaPhi;
+  }
+
+  std::unique_ptr<edm4eic::TrackParametersCollection> TrackSeedMerger::process(const edm4eic::TrackParametersCollection& seeds) {
+    auto merged_seeds = std::make_unique<edm4eic::TrackParametersCollection>();
+
+    // Sorted in theta, the candidates of a seed are a contiguous window
+    const std::size_t n = seeds.size();
+    m_order.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      m_order[i] = i;
+    }
+    std::sort(m_order.begin(), m_order.end(), [&seeds](std::size_t i, std::size_t j) {
+      return seeds[i].getTheta() < seeds[j].getTheta();
+    });
+    m_rank.resize(n);
+    for (std::size_t k = 0; k < n; ++k) {
+      m_rank[m_order[k]] = k;
+    }
+    m_merged.assign(n, false);
+
+    std::size_t n_merged = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      if (m_merged[i]) {
+        continue;
+      }
+      const auto seed = seeds[i];
+      merged_seeds->push_back(seed.clone());
+
+      const float theta = seed.getTheta();
+      for (std::size_t k = m_rank[i] + 1; k < n && seeds[m_order[k]].getTheta() - theta <= m_cfg.maxDeltaTheta; ++k) {
+        const std::size_t j = m_order[k];
+        if (j > i && !m_merged[j] && compatible(seed, seeds[j])) {
+          m_merged[j] = true;
+          ++n_merged;
+        }
+      }
+      for (std::size_t k = m_rank[i]; k-- > 0 && theta - seeds[m_order[k]].getTheta() <= m_cfg.maxDeltaTheta; ) {
+        const std::size_t j = m_order[k];
+        if (j > i && !m_merged[j] && compatible(seed, seeds[j])) {
+          m_merged[j] = true;
+          ++n_merged;
+        }
+      }
+    }
+
+    m_seedsIn += n;
+    m_seedsMerged += n_merged;
+    m_log->debug("Merged {} of {} seeds, {} of {} CKF invocations saved so far",
+                 n_merged, n, m_seedsMerged, m_seedsIn);
+
+    return merged_seeds;
+  }
+
+} // namespace eicrecon
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <edm4eic/TrackParametersCollection.h>
+#include <spdlog/logger.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "TrackSeedMergerConfig.h"
+#include "algorithms/interfaces/WithPodConfig.h"
+
+namespace eicrecon {
+
+  /** Merges compatible seeds before the track finding.
+   *
+   * Seeds with the same charge and compatible q/p, theta, phi and vertex z
+   * (loc1 on the perigee surface at the origin) mostly lead the CKF to the
+   * same track. Seeds are clustered greedily in input order: the first seed
+   * of a cluster is kept and the compatible seeds that follow it are dropped.
+   */
+  class TrackSeedMerger : public WithPodConfig<TrackSeedMergerConfig> {
+  public:
+    void init(std::shared_ptr<spdlog::logger> log);
+
+    std::unique_ptr<edm4eic::TrackParametersCollection> process(const edm4eic::TrackParametersCollection& seeds);
+
+    /// Number of input seeds and of seeds dropped (CKF invocations saved) since init
+    std::size_t seedsIn() const { return m_seedsIn; }
+    std::size_t seedsMerged() const { return m_seedsMerged; }
+
+  private:
+    bool compatible(const edm4eic::TrackParameters& a, const edm4eic::TrackParameters& b) const;
+
+    std::shared_ptr<spdlog::logger> m_log;
+
+    std::vector<std::size_t> m_order;
+    std::vector<std::size_t> m_rank;
+    std::vector<bool> m_merged;
+
+    std::size_t m_seedsIn{0};
+    std::size_t m_seedsMerged{0};
+  };
+
+} // namespace eicrecon
@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+namespace eicrecon {
+
+  struct TrackSeedMergerConfig {
+    /// Maximum relative difference of q/p of merged seeds
+    double maxRelDeltaQOverP = 0.1;
+    /// Maximum difference of theta of merged seeds [rad]
+    double maxDeltaTheta = 0.005;
+    /// Maximum difference of phi of merged seeds [rad]
+    double maxDeltaPhi = 0.01;
+    /// Maximum difference of the z of closest approach to the beam line of merged seeds [mm]
+    double maxDeltaZ = 5.0;
+  };
+
+} // namespace eicrecon
@@ -22,9 +22,13 @@
 #include <edm4eic/Cov6f.h>
 #include <Eigen/Core>
 #include <Eigen/Geometry>
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <functional>
+#include <future>
 #include <limits>
+#include <set>
 #include <tuple>
 #include <type_traits>
 
@@ -112,13 +116,19 @@ void eicrecon::TrackSeeding::configure() {
     m_seedFinderOptions =
       m_seedFinderOptions.toInternalUnits().calculateDerivedQuantities(m_seedFinderConfig);
 
+    m_seedFinder.emplace(m_seedFinderConfig);
+
 }
 
 std::unique_ptr<edm4eic::TrackParametersCollection> eicrecon::TrackSeeding::produce(const edm4eic::TrackerHitCollection& trk_hits) {
 
-  std::vector<const eicrecon::SpacePoint*> spacePoints = getSpacePoints(trk_hits);
+  // the space points refer to the hits of this event, they are let go of on every way out
+  struct EventScope {
+    TrackSeeding* seeding;
+    ~EventScope() { seeding->clearEvent(); }
+  } event_scope{this};
 
-  Acts::SeedFinderOrthogonal<eicrecon::SpacePoint> finder(m_seedFinderConfig); // FIXME move into class scope
+  const std::vector<const eicrecon::SpacePoint*>& spacePoints = getSpacePoints(trk_hits);
 
   std::function<std::pair<Acts::Vector3, Acts::Vector2>(
       const eicrecon::SpacePoint *sp)>
@@ -128,48 +138,113 @@ std::unique_ptr<edm4eic::TrackParametersCollection> eicrecon::TrackSeeding::prod
         return std::make_pair(position, variance);
       };
 
-  eicrecon::SeedContainer seeds = finder.createSeeds(m_seedFinderOptions, spacePoints, create_coordinates);
+  eicrecon::SeedContainer seeds = m_cfg.etaRegionBounds.empty()
+    ? m_seedFinder->createSeeds(m_seedFinderOptions, spacePoints, create_coordinates)
+    : createRegionSeeds(spacePoints, create_coordinates);
 
   std::unique_ptr<edm4eic::TrackParametersCollection> trackparams = makeTrackParams(seeds);
 
-  for (auto& sp: spacePoints) {
-    delete sp;
-  }
-
   return std::move(trackparams);
 }
 
-std::vector<const eicrecon::SpacePoint*> eicrecon::TrackSeeding::getSpacePoints(const edm4eic::TrackerHitCollection& trk_hits)
+void eicrecon::TrackSeeding::clearEvent()
+{
+  // clear() keeps the capacities for the next event
+  m_spacePoints.clear();
+  m_spacePointPtrs.clear();
+  for (auto& region : m_regionSpacePoints) {
+    region.clear();
+  }
+}
+
+const std::vector<const eicrecon::SpacePoint*>& eicrecon::TrackSeeding::getSpacePoints(const edm4eic::TrackerHitCollection& trk_hits)
 {
-  std::vector<const eicrecon::SpacePoint*> spacepoints;
+  m_spacePoints.clear();
+  m_spacePointPtrs.clear();
+  // no reallocation below, the pointers into m_spacePoints stay valid
+  m_spacePoints.reserve(trk_hits.size());
+  m_spacePointPtrs.reserve(trk_hits.size());
 
   for(const auto hit : trk_hits)
     {
-      const eicrecon::SpacePoint* sp = new SpacePoint(hit);
-      spacepoints.push_back(sp);
+      m_spacePointPtrs.push_back(&m_spacePoints.emplace_back(hit));
+    }
+
+  return m_spacePointPtrs;
+}
+
+eicrecon::SeedContainer eicrecon::TrackSeeding::createRegionSeeds(
+    const std::vector<const eicrecon::SpacePoint*>& spacePoints,
+    const std::function<std::pair<Acts::Vector3, Acts::Vector2>(const eicrecon::SpacePoint *sp)>& create_coordinates)
+{
+  // Region i is [bounds[i - 1], bounds[i]), widened by the overlap on both sides
+  const auto& bounds = m_cfg.etaRegionBounds;
+  const std::size_t n_regions = bounds.size() + 1;
+  m_regionSpacePoints.resize(n_regions);
+  for (auto& region : m_regionSpacePoints) {
+    region.clear();
+  }
+  for (const auto* sp : spacePoints) {
+    const double eta = std::asinh(sp->z() / sp->r());
+    for (std::size_t region = 0; region < n_regions; ++region) {
+      const double lo = region == 0 ? -std::numeric_limits<double>::infinity() : bounds[region - 1];
+      const double hi = region == n_regions - 1 ? std::numeric_limits<double>::infinity() : bounds[region];
+      if (eta >= lo - m_cfg.etaRegionOverlap && eta < hi + m_cfg.etaRegionOverlap) {
+        m_regionSpacePoints[region].push_back(sp);
+      }
+    }
+  }
+
+  // The finder is only read by createSeeds, the regions can be seeded concurrently
+  std::vector<eicrecon::SeedContainer> region_seeds(n_regions);
+  auto seed_region = [&](std::size_t region) {
+    if (m_regionSpacePoints[region].empty()) {
+      return;
+    }
+    region_seeds[region] = m_seedFinder->createSeeds(m_seedFinderOptions, m_regionSpacePoints[region], create_coordinates);
+  };
+  {
+    std::vector<std::future<void>> tasks;
+    for (std::size_t region = 1; region < n_regions; ++region) {
+      tasks.push_back(std::async(std::launch::async, seed_region, region));
+    }
+    seed_region(0);
+    for (auto& task : tasks) {
+      task.get();
     }
+  }
+
+  // Merge in region order, a seed found in overlapping regions is kept once
+  eicrecon::SeedContainer seeds;
+  std::set<std::array<const eicrecon::SpacePoint*, 3>> seen;
+  for (std::size_t region = 0; region < n_regions; ++region) {
+    for (auto& seed : region_seeds[region]) {
+      auto key = seed.sp();
+      std::sort(key.begin(), key.end());
+      if (seen.insert(key).second) {
+        seeds.push_back(std::move(seed));
+      }
+    }
+    m_log->debug("Seeding region {}: {} space points, {} seeds", region, m_regionSpacePoints[region].size(), region_seeds[region].size());
+  }
+  m_log->debug("{} seeds after merging the regions", seeds.size());
 
-  return spacepoints;
+  return seeds;
 }
 
 std::unique_ptr<edm4eic::TrackParametersCollection> eicrecon::TrackSeeding::makeTrackParams(SeedContainer& seeds)
 {
   auto trackparams = std::make_unique<edm4eic::TrackParametersCollection>();
 
-  for(auto& seed : seeds)
+  fitSeeds(seeds);
+
+  for(std::size_t iseed = 0; iseed < seeds.size(); ++iseed)
     {
-      std::vector<std::pair<float,float>> xyHitPositions;
-      std::vector<std::pair<float,float>> rzHitPositions;
-      for(const auto& spptr : seed.sp())
-        {
-          xyHitPositions.emplace_back(spptr->x(), spptr->y());
-          rzHitPositions.emplace_back(spptr->r(), spptr->z());
-        }
-
-      auto RX0Y0 = circleFit(xyHitPositions);
-      float R = std::get<0>(RX0Y0);
-      float X0 = std::get<1>(RX0Y0);
-      float Y0 = std::get<2>(RX0Y0);
+      auto& seed = seeds[iseed];
+
+      float R = std::sqrt(m_seedFits.R2[iseed]);
+      float X0 = m_seedFits.X0[iseed];
+      float Y0 = m_seedFits.Y0[iseed];
       if (!(std::isfinite(R) &&
         std::isfinite(std::abs(X0)) &&
         std::isfinite(std::abs(Y0)))) {
@@ -183,14 +258,12 @@ std::unique_ptr<edm4eic::TrackParametersCollection> eicrecon::TrackSeeding::make
         continue;
       }
 
-      auto slopeZ0 = lineFit(rzHitPositions);
+      auto RX0Y0 = std::make_tuple(R, X0, Y0);
       const auto xypos = findPCA(RX0Y0);
 
+      int charge = m_seedFits.charge[iseed];
 
-      //Determine charge
-      int charge = determineCharge(xyHitPositions, xypos, RX0Y0);
-
-      float theta = atan(1./std::get<0>(slopeZ0));
+      float theta = atan(1./m_seedFits.slope[iseed]);
       // normalize to 0<theta<pi
       if(theta < 0)
         { theta += M_PI; }
@@ -246,165 +319,111 @@ std::unique_ptr<edm4eic::TrackParametersCollection> eicrecon::TrackSeeding::make
 
   return std::move(trackparams);
 }
-std::pair<float, float> eicrecon::TrackSeeding::findPCA(std::tuple<float,float,float>& circleParams) const
-{
-  const float R = std::get<0>(circleParams);
-  const float X0 = std::get<1>(circleParams);
-  const float Y0 = std::get<2>(circleParams);
-
-  const double R0 = std::hypot(X0, Y0);
-
-  //Calculate point on circle closest to origin
-  const double xmin = X0 * (1. - R/R0);
-  const double ymin = Y0 * (1. - R/R0);
-
-  return std::make_pair(xmin,ymin);
-}
 
-int eicrecon::TrackSeeding::determineCharge(std::vector<std::pair<float,float>>& positions, const std::pair<float,float>& PCA, std::tuple<float,float,float>& RX0Y0) const
+/**
+ * Fits all the seeds of an event in one pass over columns of their space
+ * points, with the fixed-size fits below. They have no heap allocation and no
+ * branches or calls into libm, so that the loop of fitColumns() vectorises;
+ * the square root of the radius is left to makeTrackParams.
+ */
+void eicrecon::TrackSeeding::fitSeeds(const SeedContainer& seeds)
 {
+  const std::size_t n = seeds.size();
+  auto& fits = m_seedFits;
+  fits.x.resize(3 * n);
+  fits.y.resize(3 * n);
+  fits.r.resize(3 * n);
+  fits.z.resize(3 * n);
+  fits.R2.resize(n);
+  fits.X0.resize(n);
+  fits.Y0.resize(n);
+  fits.slope.resize(n);
+  fits.charge.resize(n);
+
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto& sps = seeds[i].sp();
+    for (std::size_t k = 0; k < 3; ++k) {
+      fits.x[k * n + i] = sps[k]->x();
+      fits.y[k * n + i] = sps[k]->y();
+      fits.r[k * n + i] = sps[k]->r();
+      fits.z[k * n + i] = sps[k]->z();
+    }
+  }
 
-  const auto& firstpos = positions.at(0);
-  auto hit_x = firstpos.first;
-  auto hit_y = firstpos.second;
-
-  auto xpos = PCA.first;
-  auto ypos = PCA.second;
-
-  float X0 = std::get<1>(RX0Y0);
-  float Y0 = std::get<2>(RX0Y0);
-
-  Acts::Vector3 B_z(0,0,1);
-  Acts::Vector3 radial(X0-xpos, Y0-ypos, 0);
-  Acts::Vector3 hit(hit_x-xpos, hit_y-ypos, 0);
-
-  auto cross = radial.cross(hit);
-
-  float dot = cross.dot(B_z);
-
-  return copysign(1., -dot);
+  fitColumns(n, fits.x.data(), fits.y.data(), fits.r.data(), fits.z.data(),
+             fits.R2.data(), fits.X0.data(), fits.Y0.data(), fits.slope.data(), fits.charge.data());
 }
 
-
- /**
-   * Circle fit to a given set of data points (in 2D)
-   * This is an algebraic fit, due to Taubin, based on the journal article
-   * G. Taubin, "Estimation Of Planar Curves, Surfaces And Nonplanar
-   * Space Curves Defined By Implicit Equations, With
-   * Applications To Edge And Range Image Segmentation",
-   * IEEE Trans. PAMI, Vol. 13, pages 1115-1138, (1991)
-   * It works well whether data points are sampled along an entire circle or along a small arc.
-   * It still has a small bias and its statistical accuracy is slightly lower than that of the geometric fit (minimizing geometric distances),
-   * It provides a very good initial guess for a subsequent geometric fit.
-   * Nikolai Chernov  (September 2012)
-   */
-std::tuple<float,float,float> eicrecon::TrackSeeding::circleFit(std::vector<std::pair<float,float>>& positions) const
+void eicrecon::TrackSeeding::fitColumns(std::size_t n, const float* x, const float* y, const float* r, const float* z,
+                                        float* __restrict R2, float* __restrict X0, float* __restrict Y0,
+                                        float* __restrict slope, int* __restrict charge)
 {
-  // Compute x- and y- sample means
-  double meanX = 0;
-  double meanY = 0;
-  double weight = 0;
-
-  for( const auto& [x,y] : positions)
-  {
-    meanX += x;
-    meanY += y;
-    ++weight;
-  }
-  meanX /= weight;
-  meanY /= weight;
-
-  //     computing moments
-
-  double Mxx = 0;
-  double Myy = 0;
-  double Mxy = 0;
-  double Mxz = 0;
-  double Myz = 0;
-  double Mzz = 0;
-
-  for (auto& [x,y] : positions)
-  {
-    double Xi = x - meanX;   //  centered x-coordinates
-    double Yi = y - meanY;   //  centered y-coordinates
-double Zi = std::pow(Xi,2) + std::pow(Yi,2);
-
-    Mxy += Xi*Yi;
-    Mxx += Xi*Xi;
-    Myy += Yi*Yi;
-    Mxz += Xi*Zi;
-    Myz += Yi*Zi;
-    Mzz += Zi*Zi;
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::array<float,3> xi{x[i], x[n + i], x[2 * n + i]};
+    const std::array<float,3> yi{y[i], y[n + i], y[2 * n + i]};
+    const auto [circleR2, circleX0, circleY0] = circumcircle(xi, yi);
+    R2[i] = circleR2;
+    X0[i] = circleX0;
+    Y0[i] = circleY0;
+    slope[i] = std::get<0>(lineFit({r[i], r[n + i], r[2 * n + i]}, {z[i], z[n + i], z[2 * n + i]}));
+    charge[i] = determineCharge(xi, yi, circleX0, circleY0);
   }
-  Mxx /= weight;
-  Myy /= weight;
-  Mxy /= weight;
-  Mxz /= weight;
-  Myz /= weight;
-  Mzz /= weight;
-
-  //  computing coefficients of the characteristic polynomial
-
-  const double Mz = Mxx + Myy;
-  const double Cov_xy = Mxx*Myy - Mxy*Mxy;
-  const double Var_z = Mzz - Mz*Mz;
-  const double A3 = 4*Mz;
-  const double A2 = -3*Mz*Mz - Mzz;
-  const double A1 = Var_z*Mz + 4*Cov_xy*Mz - Mxz*Mxz - Myz*Myz;
-  const double A0 = Mxz*(Mxz*Myy - Myz*Mxy) + Myz*(Myz*Mxx - Mxz*Mxy) - Var_z*Cov_xy;
-  const double A22 = A2 + A2;
-  const double A33 = A3 + A3 + A3;
-
-  //    finding the root of the characteristic polynomial
-  //    using Newton's method starting at x=0
-  //    (it is guaranteed to converge to the right root)
-  static constexpr int iter_max = 99;
-  double x = 0;
-  double y = A0;
-
-  // usually, 4-6 iterations are enough
-  for( int iter=0; iter<iter_max; ++iter)
-  {
-    const double Dy = A1 + x*(A22 + A33*x);
-    const double xnew = x - y/Dy;
-    if ((xnew == x)||(!std::isfinite(xnew))) break;
-
-    const double ynew = A0 + xnew*(A1 + xnew*(A2 + xnew*A3));
-    if (std::abs(ynew)>=std::abs(y))  break;
+}
 
-    x = xnew;  y = ynew;
+/**
+ * The Taubin fit of three points is the circle through them, at the root 0
+ * of its characteristic polynomial. Returns the squared radius and the center,
+ * which are not finite for points on a line.
+ */
+std::tuple<float,float,float> eicrecon::TrackSeeding::circumcircle(const std::array<float,3>& x, const std::array<float,3>& y)
+{
+  // relative to the first point
+  const double bx = x[1] - x[0];
+  const double by = y[1] - y[0];
+  const double cx = x[2] - x[0];
+  const double cy = y[2] - y[0];
+  const double b2 = bx*bx + by*by;
+  const double c2 = cx*cx + cy*cy;
+  const double D = 2 * (bx*cy - by*cx);
+  const double Xcenter = (cy*b2 - by*c2) / D;
+  const double Ycenter = (bx*c2 - cx*b2) / D;
+  return std::make_tuple(Xcenter*Xcenter + Ycenter*Ycenter, Xcenter + x[0], Ycenter + y[0]);
+}
 
+std::tuple<float,float> eicrecon::TrackSeeding::lineFit(const std::array<float,3>& r, const std::array<float,3>& z)
+{
+  // least squares about the means
+  const double meanR = (static_cast<double>(r[0]) + r[1] + r[2]) / 3;
+  const double meanZ = (static_cast<double>(z[0]) + z[1] + z[2]) / 3;
+  double Srr = 0;
+  double Srz = 0;
+  for (std::size_t k = 0; k < 3; ++k) {
+    Srr += (r[k] - meanR) * (r[k] - meanR);
+    Srz += (r[k] - meanR) * (z[k] - meanZ);
   }
+  const double a = Srz / Srr;
+  return std::make_tuple(a, meanZ - a*meanR);
+}
 
-  //  computing parameters of the fitting circle
-  const double DET = std::pow(x,2) - x*Mz + Cov_xy;
-  const double Xcenter = (Mxz*(Myy - x) - Myz*Mxy)/DET/2;
-  const double Ycenter = (Myz*(Mxx - x) - Mxz*Mxy)/DET/2;
-
-  //  assembling the output
-  float X0 = Xcenter + meanX;
-  float Y0 = Ycenter + meanY;
-  float R = std::sqrt( std::pow(Xcenter,2) + std::pow(Ycenter,2) + Mz);
-  return std::make_tuple( R, X0, Y0 );
+int eicrecon::TrackSeeding::determineCharge(const std::array<float,3>& x, const std::array<float,3>& y, float X0, float Y0)
+{
+  // The PCA P lies on the line from the origin to the center C, so the cross
+  // product (C - P) x (H - P) of the first hit H is a positive multiple of C x H
+  const float dot = X0*y[0] - Y0*x[0];
+  return dot >= 0 ? -1 : 1;
 }
 
-std::tuple<float,float> eicrecon::TrackSeeding::lineFit(std::vector<std::pair<float,float>>& positions) const
+std::pair<float, float> eicrecon::TrackSeeding::findPCA(std::tuple<float,float,float>& circleParams) const
 {
-  double xsum=0;
-  double x2sum=0;
-  double ysum=0;
-  double xysum=0;
-  for( const auto& [r,z]:positions )
-  {
-    xsum=xsum+r;                        //calculate sigma(xi)
-    ysum=ysum+z;                        //calculate sigma(yi)
-    x2sum=x2sum+std::pow(r,2);              //calculate sigma(x^2i)
-    xysum=xysum+r*z;                    //calculate sigma(xi*yi)
-  }
+  const float R = std::get<0>(circleParams);
+  const float X0 = std::get<1>(circleParams);
+  const float Y0 = std::get<2>(circleParams);
+
+  const double R0 = std::hypot(X0, Y0);
 
-  const auto npts = positions.size();
-  const double denominator = (x2sum*npts-std::pow(xsum,2));
-  const float a= (xysum*npts-xsum*ysum)/denominator;            //calculate slope
-  const float b= (x2sum*ysum-xsum*xysum)/denominator;           //calculate intercept
-  return std::make_tuple( a, b );
+  //Calculate point on circle closest to origin
+  const double xmin = X0 * (1. - R/R0);
+  const double ymin = Y0 * (1. - R/R0);
+
+  return std::make_pair(xmin,ymin);
 }
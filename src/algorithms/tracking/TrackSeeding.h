@@ -4,15 +4,20 @@
 
 #pragma once
 
+#include <Acts/Definitions/Algebra.hpp>
 #include <Acts/MagneticField/MagneticFieldContext.hpp>
 #include <Acts/Seeding/SeedFilterConfig.hpp>
 #include <Acts/Seeding/SeedFinderConfig.hpp>
+#include <Acts/Seeding/SeedFinderOrthogonal.hpp>
 #include <Acts/Seeding/SeedFinderOrthogonalConfig.hpp>
 #include <edm4eic/TrackParametersCollection.h>
 #include <edm4eic/TrackerHitCollection.h>
 #include <spdlog/logger.h>
+#include <array>
 #include <cstddef> // IWYU pragma: keep FIXME size_t missing in SeedConfirmationRangeConfig.hpp until Acts 27.2.0 (maybe even later)
+#include <functional>
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -44,12 +49,40 @@ namespace eicrecon {
         Acts::SeedFinderOptions m_seedFinderOptions;
         Acts::SeedFinderOrthogonalConfig<SpacePoint> m_seedFinderConfig;
 
-        int determineCharge(std::vector<std::pair<float,float>>& positions, const std::pair<float,float>& PCA, std::tuple<float,float,float>& RX0Y0) const;
+        // one finder per algorithm instance (factories are per thread), built in configure()
+        std::optional<Acts::SeedFinderOrthogonal<SpacePoint>> m_seedFinder;
+
+        // space points of the current event, their capacity is reused between events
+        // (reserved up front, so that the pointers stay valid while seeding); emptied
+        // by clearEvent() once produce() is done, as they refer to the hits of the event
+        std::vector<eicrecon::SpacePoint> m_spacePoints;
+        std::vector<const eicrecon::SpacePoint*> m_spacePointPtrs;
+        // space points of every eta region, if partitioned
+        std::vector<std::vector<const eicrecon::SpacePoint*>> m_regionSpacePoints;
+
+        // closed-form fits of the seeds of the current event, one column per quantity
+        struct SeedFits {
+            std::vector<float> x, y, r, z;   // space point k of seed i at k * n + i
+            std::vector<float> R2, X0, Y0;   // circumscribed circle in xy
+            std::vector<float> slope;        // line in rz
+            std::vector<int> charge;
+        };
+        SeedFits m_seedFits;
+
         std::pair<float,float> findPCA(std::tuple<float,float,float>& circleParams) const;
-        std::vector<const eicrecon::SpacePoint*> getSpacePoints(const edm4eic::TrackerHitCollection& trk_hits);
+        void clearEvent();
+        const std::vector<const eicrecon::SpacePoint*>& getSpacePoints(const edm4eic::TrackerHitCollection& trk_hits);
+        SeedContainer createRegionSeeds(const std::vector<const eicrecon::SpacePoint*>& spacePoints,
+                                        const std::function<std::pair<Acts::Vector3, Acts::Vector2>(const eicrecon::SpacePoint *sp)>& create_coordinates);
         std::unique_ptr<edm4eic::TrackParametersCollection> makeTrackParams(SeedContainer& seeds);
 
-        std::tuple<float,float,float> circleFit(std::vector<std::pair<float,float>>& positions) const;
-        std::tuple<float,float> lineFit(std::vector<std::pair<float,float>>& positions) const;
+        // fixed-size fits of the three space points of a seed, see fitSeeds()
+        void fitSeeds(const SeedContainer& seeds);
+        static void fitColumns(std::size_t n, const float* x, const float* y, const float* r, const float* z,
+                               float* __restrict R2, float* __restrict X0, float* __restrict Y0,
+                               float* __restrict slope, int* __restrict charge);
+        static std::tuple<float,float,float> circumcircle(const std::array<float,3>& x, const std::array<float,3>& y);
+        static std::tuple<float,float> lineFit(const std::array<float,3>& r, const std::array<float,3>& z);
+        static int determineCharge(const std::array<float,3>& x, const std::array<float,3>& y, float X0, float Y0);
     };
 }
@@ -3,15 +3,27 @@
 
 #include "TrackerHitReconstruction.h"
 
+#include <DD4hep/Readout.h>
+#include <DD4hep/Segmentations.h>
+#include <DD4hep/VolumeManager.h>
 #include <Evaluator/DD4hepUnits.h>
+#include <algorithms/service.h>
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/DisplacementVector3D.h>
 #include <edm4eic/CovDiag3f.h>
 #include <edm4hep/Vector3f.h>
 #include <fmt/core.h>
+#include <TGeoMatrix.h>
 #include <spdlog/common.h>
 #include <stddef.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
 #include <iterator>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -33,6 +45,122 @@ void TrackerHitReconstruction::init(const dd4hep::rec::CellIDPositionConverter*
     m_log = logger;
 
     m_converter = converter;
+
+    auto& serviceSvc = algorithms::ServiceSvc::instance();
+    m_geo_cache = serviceSvc.service<CellIDGeometryCacheSvc>("CellIDGeometryCacheSvc");
+
+    m_time_offsets.clear();
+    if (!m_cfg.timeOffsetsFile.empty()) {
+        loadTimeOffsets(m_cfg.timeOffsetsFile);
+    }
+}
+
+void TrackerHitReconstruction::loadTimeOffsets(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error(fmt::format("Can not open the time offsets file {}", path));
+    }
+    std::string line;
+    std::size_t line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::uint64_t cell_id = 0;
+        float offset = 0;
+        if (!(fields >> cell_id)) {
+            // blank or comment line
+            continue;
+        }
+        if (!(fields >> offset)) {
+            throw std::runtime_error(fmt::format("{}:{}: expected \"cellID offset\"", path, line_number));
+        }
+        m_time_offsets.emplace_back(cell_id, offset);
+    }
+    std::stable_sort(m_time_offsets.begin(), m_time_offsets.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+    // the last offset of a channel listed more than once wins
+    auto last = std::unique(m_time_offsets.rbegin(), m_time_offsets.rend(),
+        [](const auto& a, const auto& b) { return a.first == b.first; });
+    m_time_offsets.erase(m_time_offsets.begin(), last.base());
+    m_log->info("Read the time offsets of {} channels from {}", m_time_offsets.size(), path);
+}
+
+double TrackerHitReconstruction::timeOffset(std::uint64_t cell_id) const {
+    const auto it = std::lower_bound(m_time_offsets.begin(), m_time_offsets.end(), cell_id,
+        [](const auto& entry, std::uint64_t id) { return entry.first < id; });
+    return (it != m_time_offsets.end() && it->first == cell_id) ? it->second : 0.;
+}
+
+void TrackerHitReconstruction::convert(const edm4eic::RawTrackerHitCollection& raw_hits,
+                                       std::vector<dd4hep::Position>& positions,
+                                       std::vector<std::vector<double>>& dimensions) {
+    const std::size_t n = raw_hits.size();
+    positions.assign(n, dd4hep::Position());
+    dimensions.assign(n, {});
+    if (n == 0) {
+        return;
+    }
+
+    // the volume ID of a cell is its cellID with the segmentation bits masked out,
+    // with the same mask for all the cells of a readout
+    std::vector<std::uint64_t> cell_ids(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        cell_ids[i] = raw_hits[i].getCellID();
+    }
+    const auto* first_context = m_geo_cache->findContext(cell_ids[0]);
+    const std::uint64_t mask = (first_context != nullptr) ? first_context->mask : ~std::uint64_t(0);
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return (cell_ids[a] & mask) < (cell_ids[b] & mask);
+    });
+
+    std::vector<double> local_x, local_y, local_z;
+    for (std::size_t begin = 0; begin < n;) {
+        const std::uint64_t volume_id = cell_ids[order[begin]] & mask;
+        std::size_t end = begin + 1;
+        while (end < n && (cell_ids[order[end]] & mask) == volume_id) {
+            ++end;
+        }
+
+        // one lookup of the placement and of the segmentation per sensor
+        const auto* context = m_geo_cache->findContext(cell_ids[order[begin]]);
+        if (context == nullptr || context->mask != mask) {
+            for (std::size_t k = begin; k < end; ++k) {
+                positions[order[k]] = m_geo_cache->position(cell_ids[order[k]]);
+                dimensions[order[k]] = m_converter->cellDimensions(cell_ids[order[k]]);
+            }
+            begin = end;
+            continue;
+        }
+        const auto segmentation = m_converter->findReadout(context->element).segmentation();
+        const TGeoHMatrix transform = context->element.nominal().worldTransformation() * context->toElement();
+        const double* r = transform.GetRotationMatrix();
+        const double* t = transform.GetTranslation();
+
+        // the local cell centers from the segmentation, then one affine transform for all of them
+        const std::size_t m = end - begin;
+        local_x.resize(m);
+        local_y.resize(m);
+        local_z.resize(m);
+        const bool same_dimensions = segmentation.type() != "MultiSegmentation";
+        for (std::size_t k = 0; k < m; ++k) {
+            const auto cell_id = cell_ids[order[begin + k]];
+            const auto local = segmentation.position(cell_id);
+            local_x[k] = local.x();
+            local_y[k] = local.y();
+            local_z[k] = local.z();
+            dimensions[order[begin + k]] = (same_dimensions && k > 0) ? dimensions[order[begin]] : segmentation.cellDimensions(cell_id);
+        }
+        for (std::size_t k = 0; k < m; ++k) {
+            positions[order[begin + k]].SetCoordinates(
+                r[0] * local_x[k] + r[1] * local_y[k] + r[2] * local_z[k] + t[0],
+                r[3] * local_x[k] + r[4] * local_y[k] + r[5] * local_z[k] + t[1],
+                r[6] * local_x[k] + r[7] * local_y[k] + r[8] * local_z[k] + t[2]);
+        }
+        begin = end;
+    }
 }
 
 std::unique_ptr<edm4eic::TrackerHitCollection> TrackerHitReconstruction::process(const edm4eic::RawTrackerHitCollection& raw_hits) {
@@ -40,13 +168,22 @@ std::unique_ptr<edm4eic::TrackerHitCollection> TrackerHitReconstruction::process
 
     auto rec_hits { std::make_unique<edm4eic::TrackerHitCollection>() };
 
-    for (const auto& raw_hit : raw_hits) {
+    // Get position and dimension of all the cells, sensor by sensor
+    convert(raw_hits, m_positions, m_dimensions);
 
-        auto id = raw_hit.getCellID();
+    for (std::size_t i = 0; i < raw_hits.size(); ++i) {
+        const auto raw_hit = raw_hits[i];
+        const auto& pos = m_positions[i];
+        const auto& dim = m_dimensions[i];
 
-        // Get position and dimension
-        auto pos = m_converter->position(id);
-        auto dim = m_converter->cellDimensions(id);
+        // calibrated time: the per-channel offset and the time walk of small signals removed
+        double time = (double)(raw_hit.getTimeStamp()) / 1000.0; // ns
+        if (!m_time_offsets.empty()) {
+            time -= timeOffset(raw_hit.getCellID());
+        }
+        if (m_cfg.timeWalkCoefficient != 0 && raw_hit.getCharge() > 0) {
+            time -= m_cfg.timeWalkCoefficient / std::sqrt((double) raw_hit.getCharge());
+        }
 
         // >oO trace
         if(m_log->level() == spdlog::level::trace) {
@@ -71,7 +208,7 @@ std::unique_ptr<edm4eic::TrackerHitCollection> TrackerHitReconstruction::process
             edm4hep::Vector3f{static_cast<float>(pos.x() / mm), static_cast<float>(pos.y() / mm), static_cast<float>(pos.z() / mm)}, // mm
             edm4eic::CovDiag3f{get_variance(dim[0] / mm), get_variance(dim[1] / mm), // variance (see note above)
             std::size(dim) > 2 ? get_variance(dim[2] / mm) : 0.},
-                static_cast<float>((double)(raw_hit.getTimeStamp()) / 1000.0), // ns
+                static_cast<float>(time),                  // ns
             m_cfg.timeResolution,                            // in ns
             static_cast<float>(raw_hit.getCharge() / 1.0e6),   // Collected energy (GeV)
             0.0F);                                       // Error on the energy
@@ -3,14 +3,20 @@
 
 #pragma once
 
+#include <DD4hep/Objects.h>
 #include <DDRec/CellIDPositionConverter.h>
 #include <edm4eic/RawTrackerHitCollection.h>
 #include <edm4eic/TrackerHitCollection.h>
 #include <spdlog/logger.h>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "TrackerHitReconstructionConfig.h"
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "services/geometry/cellid_cache/CellIDGeometryCacheSvc.h"
 
 namespace eicrecon {
 
@@ -30,10 +36,32 @@ namespace eicrecon {
         eicrecon::TrackerHitReconstructionConfig& applyConfig(eicrecon::TrackerHitReconstructionConfig& cfg) {m_cfg = cfg; return m_cfg;}
 
     private:
+        /// Global positions and dimensions of the cells of the hits, with one lookup of the
+        /// placement of every sensor and one affine transform of its local cell positions
+        void convert(const edm4eic::RawTrackerHitCollection& raw_hits,
+                     std::vector<dd4hep::Position>& positions,
+                     std::vector<std::vector<double>>& dimensions);
+
+        /// Reads the per-channel time offsets of the configuration, sorted by cellID
+        void loadTimeOffsets(const std::string& path);
+
+        /// Time offset of a channel in ns, 0 for the channels without one
+        double timeOffset(std::uint64_t cell_id) const;
+
         /** algorithm logger */
         std::shared_ptr<spdlog::logger> m_log;
 
         /// Cell ID position converter
         const dd4hep::rec::CellIDPositionConverter* m_converter;
+
+        /// Per-thread cache of the cell positions
+        CellIDGeometryCacheSvc* m_geo_cache{nullptr};
+
+        /// Per-channel time offsets (cellID, ns), sorted by cellID
+        std::vector<std::pair<std::uint64_t, float>> m_time_offsets;
+
+        /// Of the hits of the event, reused
+        std::vector<dd4hep::Position> m_positions;
+        std::vector<std::vector<double>> m_dimensions;
     };
 }
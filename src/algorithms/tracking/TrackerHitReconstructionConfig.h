@@ -3,8 +3,19 @@
 
 #pragma once
 
+#include <string>
+
 namespace eicrecon {
     struct TrackerHitReconstructionConfig {
         float timeResolution = 10;
+
+        // Per-channel time calibration, e.g. of the TOF detectors.
+        // Text file of "cellID offset" lines (offset in ns, '#' starts a comment),
+        // read once at init, the offset of a channel is subtracted from its hit times.
+        // Empty for no offsets.
+        std::string timeOffsetsFile = "";
+        // Time walk correction: coefficient / sqrt(charge [keV]) is subtracted
+        // from the hit times, in ns sqrt(keV). 0 for no correction.
+        float timeWalkCoefficient = 0;
     };
 }
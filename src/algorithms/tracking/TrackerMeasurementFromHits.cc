@@ -23,10 +23,13 @@
 #include <fmt/core.h>
 #include <spdlog/common.h>
 #include <Eigen/Core>
+#include <cmath>
 #include <exception>
-#include <unordered_map>
+#include <stdexcept>
 #include <utility>
 
+#include "algorithms/interfaces/LogMacros.h"
+
 
 namespace eicrecon {
 
@@ -44,6 +47,10 @@ namespace eicrecon {
 
 
     std::unique_ptr<edm4eic::Measurement2DCollection> TrackerMeasurementFromHits::produce(const edm4eic::TrackerHitCollection& trk_hits) {
+        return produce(CollectionView<edm4eic::TrackerHitCollection>{{&trk_hits}});
+    }
+
+    std::unique_ptr<edm4eic::Measurement2DCollection> TrackerMeasurementFromHits::produce(const CollectionView<edm4eic::TrackerHitCollection>& trk_hits) {
         constexpr double mm_acts = Acts::UnitConstants::mm;
         constexpr double mm_conv = mm_acts / dd4hep::mm; // = 1/0.1
 
@@ -59,23 +66,20 @@ namespace eicrecon {
             cov(1, 1) = hit.getPositionError().yy * mm_acts * mm_acts;
             cov(0, 1) = cov(1, 0) = 0.0;
 
-            const auto* vol_ctx = m_converter->findContext(hit.getCellID());
-            auto vol_id = vol_ctx->identifier;
-
-            auto surfaceMap = m_acts_context->surfaceMap();
+            const auto* sensor = m_acts_context->sensorSurface(hit.getCellID());
 
             // m_log->trace("Hit preparation information: {}", hit_index);
-            m_log->trace("   System id: {}, Cell id: {}", hit.getCellID() &0xFF, hit.getCellID());
-            m_log->trace("   cov matrix:      {:>12.2e} {:>12.2e}", cov(0,0), cov(0,1));
-            m_log->trace("                    {:>12.2e} {:>12.2e}", cov(1,0), cov(1,1));
-            m_log->trace("   surfaceMap size: {}", surfaceMap.size());
-
-            const auto is = surfaceMap.find(vol_id);
-            if (is == m_acts_context->surfaceMap().end()) {
-                m_log->warn(" WARNING: vol_id ({})  not found in m_surfaces.", vol_id );
+            EICRECON_LOG_TRACE(m_log, "   System id: {}, Cell id: {}", hit.getCellID() &0xFF, hit.getCellID());
+            EICRECON_LOG_TRACE(m_log, "   cov matrix:      {:>12.2e} {:>12.2e}", cov(0,0), cov(0,1));
+            EICRECON_LOG_TRACE(m_log, "                    {:>12.2e} {:>12.2e}", cov(1,0), cov(1,1));
+            EICRECON_LOG_TRACE(m_log, "   surfaceMap size: {}", m_acts_context->surfaceMap().size());
+
+            if (sensor == nullptr) {
+                m_log->warn(" WARNING: CellID ({})  has no surface in m_surfaces.", hit.getCellID());
                 continue;
             }
-            const Acts::Surface* surface = is->second;
+            const auto vol_id = sensor->volumeID;
+            const Acts::Surface* surface = sensor->surface;
             // variable surf_center not used anywhere;
 
             const auto& hit_pos = hit.getPosition(); // 3d position
@@ -91,10 +95,19 @@ namespace eicrecon {
             try {
                 // transform global position into local coordinates
                 // geometry context contains nothing here
-                pos = surface->globalToLocal(
-                        Acts::GeometryContext(),
-                        {hit_pos.x, hit_pos.y, hit_pos.z},
-                        {0, 0, 0}, onSurfaceTolerance).value();
+                if (sensor->globalToLocal) {
+                    // same as PlaneSurface::globalToLocal with the cached inverse transform
+                    const Acts::Vector3 local3D = *sensor->globalToLocal * Acts::Vector3(hit_pos.x, hit_pos.y, hit_pos.z);
+                    if (std::abs(local3D.z()) > std::abs(onSurfaceTolerance)) {
+                        throw std::runtime_error("global position not on surface");
+                    }
+                    pos = local3D.head<2>();
+                } else {
+                    pos = surface->globalToLocal(
+                            Acts::GeometryContext(),
+                            {hit_pos.x, hit_pos.y, hit_pos.z},
+                            {0, 0, 0}, onSurfaceTolerance).value();
+                }
 
                 loc[Acts::eBoundLoc0] = pos[0];
                 loc[Acts::eBoundLoc1] = pos[1];
@@ -105,7 +118,7 @@ namespace eicrecon {
                 continue;
             }
 
-            if (m_log->level() <= spdlog::level::trace) {
+            if (EICRECON_LOG_ACTIVE_LEVEL <= 0 && m_log->level() <= spdlog::level::trace) {
                 auto volman         = m_acts_context->dd4hepDetector()->volumeManager();
                 auto alignment      = volman.lookupDetElement(vol_id).nominal();
                 auto local_position = (alignment.worldToLocal({hit_pos.x / mm_conv, hit_pos.y / mm_conv, hit_pos.z / mm_conv})) * mm_conv;
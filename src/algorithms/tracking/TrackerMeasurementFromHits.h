@@ -15,6 +15,7 @@
 #include <memory>
 
 #include "ActsGeometryProvider.h"
+#include "algorithms/interfaces/CollectionView.h"
 
 namespace eicrecon {
 
@@ -27,6 +28,9 @@ namespace eicrecon {
 
         std::unique_ptr<edm4eic::Measurement2DCollection> produce(const edm4eic::TrackerHitCollection& trk_hits);
 
+        /// Measurements of the hits of several collections, without merging them first
+        std::unique_ptr<edm4eic::Measurement2DCollection> produce(const CollectionView<edm4eic::TrackerHitCollection>& trk_hits);
+
     private:
         std::shared_ptr<spdlog::logger> m_log;
 
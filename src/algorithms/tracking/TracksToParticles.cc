@@ -12,19 +12,125 @@
 #include <podio/ObjectID.h>
 #include <podio/RelationRange.h>
 #include <stdint.h>
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <gsl/pointers>
 #include <limits>
 #include <mutex>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "TracksToParticles.h"
 #include "TracksToParticlesConfig.h"
 
-
 namespace eicrecon {
 
+namespace {
+
+    /** Index of the MC particles that can be matched to a track.
+     *
+     * Built once per event from the charged primary particles, binned in
+     * (charge sign, eta, phi) with bins wider than the matching tolerances, so
+     * that every particle within the tolerances of a track is in the bin of the
+     * track or in one of its neighbours. Particles beyond |eta| = 5, which the
+     * matching accepts regardless of the tolerances, and particles without a
+     * valid bin are kept in separate lists. Candidates are returned in
+     * collection order, so that the matching decisions do not depend on the
+     * index.
+     */
+    class MCParticleIndex {
+    public:
+        MCParticleIndex(const edm4hep::MCParticleCollection& mc_particles, double eta_tolerance, double phi_tolerance) {
+            // bins slightly wider than the tolerance guard against rounding
+            m_eta_width = eta_tolerance * 1.001;
+            const double phi_width = phi_tolerance * 1.001;
+            m_n_phi = (phi_width > 0 && phi_width < 2 * M_PI / 3) ? static_cast<std::int64_t>(2 * M_PI / phi_width) : 1;
+            if (!(m_eta_width > 0) || !std::isfinite(m_eta_width)) {
+                m_eta_width = std::numeric_limits<double>::infinity();
+            }
+
+            for (size_t ip = 0; ip < mc_particles.size(); ++ip) {
+                const auto &mc_part = mc_particles[ip];
+                if (mc_part.getGeneratorStatus() > 1 || mc_part.getCharge() == 0) {
+                    continue;
+                }
+                const auto &p = mc_part.getMomentum();
+                const bool positive = mc_part.getCharge() > 0;
+                const double p_eta = edm4hep::utils::eta(p);
+                const double p_phi = edm4hep::utils::angleAzimuthal(p);
+                if (p_eta < -5) {
+                    m_backward[positive].push_back(ip);
+                }
+                if (p_eta > 5) {
+                    m_forward[positive].push_back(ip);
+                }
+                if (std::isnan(p_eta) || std::isnan(p_phi)) {
+                    m_unbinned[positive].push_back(ip);
+                    continue;
+                }
+                m_binned.push_back({{positive, etaBin(p_eta), phiBin(p_phi)}, ip});
+            }
+            std::sort(m_binned.begin(), m_binned.end());
+        }
+
+        /// Indices of the particles that can match a track, in increasing order
+        void candidates(double charge, double eta, double phi, std::vector<size_t>& out) const {
+            out.clear();
+            const bool positive = charge > 0;
+            if (!std::isnan(eta) && !std::isnan(phi)) {
+                const std::int64_t eta_bin = etaBin(eta);
+                const std::int64_t phi_bin = phiBin(phi);
+                for (std::int64_t deta = -1; deta <= 1; ++deta) {
+                    for (std::int64_t dphi = (m_n_phi > 1 ? -1 : 0); dphi <= (m_n_phi > 1 ? 1 : 0); ++dphi) {
+                        const Key key{positive, eta_bin + deta, (phi_bin + dphi + m_n_phi) % m_n_phi};
+                        auto it = std::lower_bound(m_binned.begin(), m_binned.end(), std::pair{key, size_t{0}});
+                        for (; it != m_binned.end() && it->first == key; ++it) {
+                            out.push_back(it->second);
+                        }
+                    }
+                }
+            }
+            if (eta < -5) {
+                out.insert(out.end(), m_backward[positive].begin(), m_backward[positive].end());
+            }
+            if (eta > 5) {
+                out.insert(out.end(), m_forward[positive].begin(), m_forward[positive].end());
+            }
+            out.insert(out.end(), m_unbinned[positive].begin(), m_unbinned[positive].end());
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+        }
+
+    private:
+        using Key = std::tuple<bool, std::int64_t, std::int64_t>;
+
+        std::int64_t etaBin(double eta) const {
+            if (std::isinf(m_eta_width)) {
+                return 0;
+            }
+            // clamping keeps neighbouring values in neighbouring bins
+            return static_cast<std::int64_t>(std::floor(std::clamp(eta / m_eta_width, -1e6, 1e6)));
+        }
+
+        std::int64_t phiBin(double phi) const {
+            const auto bin = static_cast<std::int64_t>(std::floor((phi + M_PI) / (2 * M_PI) * m_n_phi));
+            return std::clamp<std::int64_t>(bin, 0, m_n_phi - 1);
+        }
+
+        double m_eta_width;
+        std::int64_t m_n_phi;
+        std::vector<std::pair<Key, size_t>> m_binned;
+        std::array<std::vector<size_t>, 2> m_backward;
+        std::array<std::vector<size_t>, 2> m_forward;
+        std::array<std::vector<size_t>, 2> m_unbinned;
+    };
+
+} // namespace
+
     void TracksToParticles::init() {}
 
     void TracksToParticles::process(
@@ -38,6 +144,9 @@ namespace eicrecon {
 
         std::vector<bool> mc_prt_is_consumed(mc_particles->size(), false);         // MCParticle is already consumed flag
 
+        const MCParticleIndex mc_index(*mc_particles, m_cfg.etaTolerance, m_cfg.phiTolerance);
+        std::vector<size_t> candidates;
+
         for (const auto &track: *tracks) {
           auto trajectory = track.getTrajectory();
           for (const auto &trk: trajectory.getTrackParameters()) {
@@ -53,7 +162,9 @@ namespace eicrecon {
             // utility variables for matching
             int best_match = -1;
             double best_delta = std::numeric_limits<double>::max();
-            for (size_t ip = 0; ip < mc_particles->size(); ++ip) {
+            mc_index.candidates(charge_rec, edm4hep::utils::eta(mom), edm4hep::utils::angleAzimuthal(mom), candidates);
+            trace("  {} of {} MCParticles are candidates", candidates.size(), mc_particles->size());
+            for (size_t ip : candidates) {
                 const auto &mc_part = (*mc_particles)[ip];
                 const auto &p = mc_part.getMomentum();
 
@@ -151,8 +262,8 @@ namespace eicrecon {
             rec_part.setGoodnessOfPID(0); // assume no PID until proven otherwise
             // rec_part.covMatrix()  // @TODO: covariance matrix on 4-momentum
 
-            // Also write MC <--> truth particle association if match was found
-            if (best_match >= 0) {
+            // Also write MC <--> truth particle association if match was found and it is asked for
+            if (best_match >= 0 && assocs != nullptr) {
                 auto rec_assoc = assocs->create();
                 rec_assoc.setRecID(rec_part.getObjectID().index);
                 rec_assoc.setSimID((*mc_particles)[best_match].getObjectID().index);
@@ -9,6 +9,7 @@
 #include <edm4eic/ReconstructedParticleCollection.h>
 #include <edm4eic/TrackCollection.h>
 #include <edm4hep/MCParticleCollection.h>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -21,7 +22,7 @@ namespace eicrecon {
 using TracksToParticlesAlgorithm =
     algorithms::Algorithm<
       algorithms::Input<edm4hep::MCParticleCollection, edm4eic::TrackCollection>,
-      algorithms::Output<edm4eic::ReconstructedParticleCollection, edm4eic::MCRecoParticleAssociationCollection>
+      algorithms::Output<edm4eic::ReconstructedParticleCollection, std::optional<edm4eic::MCRecoParticleAssociationCollection>>
     >;
 
 class TracksToParticles : public TracksToParticlesAlgorithm, public WithPodConfig<TracksToParticlesConfig> {
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <spdlog/logger.h>
+#include <chrono>
+#include <cstddef>
+
+namespace eicrecon {
+
+/// Time spent in the vertex finding of the last event, and the mean over the events so far
+class VertexFindingTimer {
+public:
+  /// Result of find(), which is timed as the vertex finding of an event
+  template <typename Find> auto time(Find&& find) {
+    const auto start = clock::now();
+    auto result      = find();
+    m_last           = clock::now() - start;
+    m_total += m_last;
+    ++m_calls;
+    return result;
+  }
+
+  void debug(spdlog::logger& log, std::size_t n_vertices, std::size_t n_tracks) const {
+    log.debug("Found {} vertices from {} tracks in {:.3f} ms (mean {:.3f} ms over {} events)", n_vertices, n_tracks,
+              std::chrono::duration<double, std::milli>(m_last).count(),
+              std::chrono::duration<double, std::milli>(m_total).count() / m_calls, m_calls);
+  }
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  clock::duration m_last{0};
+  clock::duration m_total{0};
+  std::size_t m_calls{0};
+};
+
+} // namespace eicrecon
@@ -1,4 +1,3 @@
-
 //
 // Template for this file generated with eicmkplugin.py
 //
@@ -6,6 +5,7 @@
 #include <Acts/Geometry/GeometryContext.hpp>
 #include <ActsExamples/EventData/Trajectories.hpp>
 #include <JANA/JApplication.h>
+#include <JANA/Services/JGlobalRootLock.h>
 #include <TDirectory.h>
 #include <vector>
 
@@ -13,34 +13,48 @@
 #include "services/rootfile/RootFile_service.h"
 
 //-------------------------------------------
-// InitWithGlobalRootLock
+// Init
 //-------------------------------------------
-void TRACKINGcheckProcessor::InitWithGlobalRootLock(){
+void TRACKINGcheckProcessor::Init(){
 
     auto rootfile_svc = GetApplication()->GetService<RootFile_service>();
+    auto root_lock = GetApplication()->GetService<JGlobalRootLock>();
+    root_lock->acquire_write_lock();
     auto *rootfile = rootfile_svc->GetHistFile();
-    rootfile->mkdir("TRACKING")->cd();
-
-    hist1D["Trajectories_trajectories_per_event"]  =  new TH1I("Trajectories_trajectories_per_event",  "TRACKING Reconstructed trajectories/event;Ntrajectories",  201, -0.5, 200.5);
-    hist1D["Trajectories_time"] =  new TH1D("Trajectories_time",  "TRACKING reconstructed particle time;time (ns)",  200, -100.0, 100.0);
-    hist2D["Trajectories_xy"]  =  new TH2D("Trajectories_xy",  "TRACKING reconstructed position Y vs. X;x;y",  100, -1000.0, 1000.0,  100, -1000., 1000.0);
-    hist1D["Trajectories_z"] =  new TH1D("Trajectories_z",  "TRACKING reconstructed position Z;z",  200, -50.0, 50.0);
+    auto *dir = rootfile->mkdir("TRACKING");
+
+    auto *trajectories_per_event = new TH1I("Trajectories_trajectories_per_event",  "TRACKING Reconstructed trajectories/event;Ntrajectories",  201, -0.5, 200.5);
+    auto *trajectories_time = new TH1D("Trajectories_time",  "TRACKING reconstructed particle time;time (ns)",  200, -100.0, 100.0);
+    auto *trajectories_xy = new TH2D("Trajectories_xy",  "TRACKING reconstructed position Y vs. X;x;y",  100, -1000.0, 1000.0,  100, -1000., 1000.0);
+    auto *trajectories_z = new TH1D("Trajectories_z",  "TRACKING reconstructed position Z;z",  200, -50.0, 50.0);
+    for (TH1 *hist : std::vector<TH1*>{trajectories_per_event, trajectories_time, trajectories_xy, trajectories_z}) {
+        hist->SetDirectory(dir);
+    }
 
     // Set some draw options
-    hist2D["Trajectories_xy"]->SetOption("colz");
+    trajectories_xy->SetOption("colz");
+    root_lock->release_lock();
+
+    m_trajectories_per_event = rootfile_svc->MakeThreadLocal(trajectories_per_event);
+    m_trajectories_time = rootfile_svc->MakeThreadLocal(trajectories_time);
+    m_trajectories_xy = rootfile_svc->MakeThreadLocal(trajectories_xy);
+    m_trajectories_z = rootfile_svc->MakeThreadLocal(trajectories_z);
 }
 
 //-------------------------------------------
-// ProcessSequential
+// Process
 //-------------------------------------------
-void TRACKINGcheckProcessor::ProcessSequential(const std::shared_ptr<const JEvent>& event) {
+void TRACKINGcheckProcessor::Process(const std::shared_ptr<const JEvent>& event) {
     auto Trajectories = event->Get<ActsExamples::Trajectories>("CentralCKFActsTrajectories");
 
     // Fill histograms here
 
     // Trajectories
-    hist1D["Trajectories_trajectories_per_event"]->Fill(Trajectories.size());
+    m_trajectories_per_event->Get()->Fill(Trajectories.size());
 
+    auto *time_hist = m_trajectories_time->Get();
+    auto *xy_hist = m_trajectories_xy->Get();
+    auto *z_hist = m_trajectories_z->Get();
     for( const auto *traj : Trajectories ){
         for( auto entryIndex : traj->tips() ){
             if( ! traj->hasTrackParameters( entryIndex) ) continue;
@@ -49,17 +63,17 @@ void TRACKINGcheckProcessor::ProcessSequential(const std::shared_ptr<const JEven
             auto pos = trackparams.position(Acts::GeometryContext());
             auto t = trackparams.time();
 
-            hist1D["Trajectories_time"]->Fill( t );
-            hist2D["Trajectories_xy"]->Fill( pos.x(), pos.y());
-            hist1D["Trajectories_z"]->Fill( pos.z() );
+            time_hist->Fill( t );
+            xy_hist->Fill( pos.x(), pos.y());
+            z_hist->Fill( pos.z() );
         }
     }
 }
 
 //-------------------------------------------
-// FinishWithGlobalRootLock
+// Finish
 //-------------------------------------------
-void TRACKINGcheckProcessor::FinishWithGlobalRootLock() {
+void TRACKINGcheckProcessor::Finish() {
 
     // Do any final calculations here.
 
@@ -4,26 +4,28 @@
 //
 
 #include <JANA/JEvent.h>
-#include <JANA/JEventProcessorSequentialRoot.h>
+#include <JANA/JEventProcessor.h>
 #include <JANA/Utils/JTypeInfo.h>
 #include <TH1.h>
 #include <TH2.h>
-#include <map>
 #include <memory>
-#include <string>
 
+#include "services/rootfile/ThreadLocalHist.h"
 
-class TRACKINGcheckProcessor: public JEventProcessorSequentialRoot {
+
+class TRACKINGcheckProcessor: public JEventProcessor {
 private:
 
-    // Containers for histograms
-    std::map<std::string, TH1*> hist1D;
-    std::map<std::string, TH2*> hist2D;
+    // filled by the worker threads without the root lock, merged when the file is written
+    std::shared_ptr<eicrecon::ThreadLocalHist<TH1I>> m_trajectories_per_event;
+    std::shared_ptr<eicrecon::ThreadLocalHist<TH1D>> m_trajectories_time;
+    std::shared_ptr<eicrecon::ThreadLocalHist<TH2D>> m_trajectories_xy;
+    std::shared_ptr<eicrecon::ThreadLocalHist<TH1D>> m_trajectories_z;
 
 public:
     TRACKINGcheckProcessor() { SetTypeName(NAME_OF_THIS); }
 
-    void InitWithGlobalRootLock() override;
-    void ProcessSequential(const std::shared_ptr<const JEvent>& event) override;
-    void FinishWithGlobalRootLock() override;
+    void Init() override;
+    void Process(const std::shared_ptr<const JEvent>& event) override;
+    void Finish() override;
 };
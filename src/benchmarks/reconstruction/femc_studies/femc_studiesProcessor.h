@@ -7,14 +7,19 @@
 #include <DDSegmentation/BitFieldCoder.h>
 #include <JANA/JEvent.h>
 #include <JANA/JEventProcessor.h>
+#include <JANA/Services/JGlobalRootLock.h>
 #include <JANA/Utils/JTypeInfo.h>
 #include <TDirectory.h>
 #include <TH2.h>
 #include <TH3.h>
 #include <TTree.h>
 #include <spdlog/logger.h>
+#include <array>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 class femc_studiesProcessor: public JEventProcessor {
 public:
@@ -76,7 +81,30 @@ public:
     float*  t_fEMC_cluster_Phi;
     float*  t_fEMC_cluster_Eta;
 
-    int nEventsWithCaloHits = 0;
+    // tree values of an event; Process() collects them, and they are filled
+    // into the trees in batches of treeBatchSize events under the ROOT lock
+    struct towerValues {
+      float E, T;
+      short ix, iy, clusIDA, clusIDB;
+      int   trueID;
+    };
+    struct clusterValues {
+      float E;
+      int   NCells;
+      float Eta, Phi;
+    };
+    struct treeValues {
+      std::vector<towerValues>          towers;
+      std::vector<std::array<float,3>>  mc;      // E, Phi, Eta
+      std::vector<clusterValues>        fEMC_clusters;
+    };
+    void FillTrees(const std::vector<treeValues>& events);
+    const size_t treeBatchSize = 100;
+    std::mutex m_tree_mutex;
+    std::vector<treeValues> m_tree_values;
+    std::shared_ptr<JGlobalRootLock> m_root_lock;
+
+    std::atomic<int> nEventsWithCaloHits{0};
     std::shared_ptr<spdlog::logger> m_log;
     dd4hep::DDSegmentation::BitFieldCoder* m_decoder;
     std::string nameSimHits         = "EcalEndcapPHits";
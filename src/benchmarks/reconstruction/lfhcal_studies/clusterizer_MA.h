@@ -4,8 +4,12 @@
 //  Sections Copyright (C) 2023 Friederike Bock
 //  under SPDX-License-Identifier: LGPL-3.0-or-later
 
-#include <vector>
+#include <TMath.h>
 #include <TVector3.h>
+#include <algorithm>
+#include <cstdlib>
+#include <span>
+#include <vector>
 
 struct towersStrct{
   towersStrct(): energy(0), time (0), posx(0), posy(0), posz(0),  cellID(0), cellIDx(-1), cellIDy(-1), cellIDz(-1), tower_trueID(-10000), tower_clusterIDA(-1), tower_clusterIDB(-1) {}
@@ -44,75 +48,118 @@ struct clustersStrct{
 
 bool acompareCl(clustersStrct lhs, clustersStrct rhs) { return lhs.cluster_E > rhs.cluster_E; }
 
+//**************************************************************************************************************//
+//**************************************************************************************************************//
+// towers of an event on their (x, y, layer) grid, so that the neighbours of a tower are looked up directly
+//**************************************************************************************************************//
+//**************************************************************************************************************//
+class towersGrid{
+  public:
+    towersGrid(const std::vector<towersStrct> &towers){
+      if (towers.empty()) return;
+      int max[3] = {towers.at(0).cellIDx, towers.at(0).cellIDy, towers.at(0).cellIDz};
+      for (int i = 0; i < 3; i++) min[i] = max[i];
+      for (const auto &tower : towers){
+        const int c[3] = {tower.cellIDx, tower.cellIDy, tower.cellIDz};
+        for (int i = 0; i < 3; i++){
+          min[i] = std::min(min[i], c[i]);
+          max[i] = std::max(max[i], c[i]);
+        }
+      }
+      for (int i = 0; i < 3; i++) size[i] = max[i] - min[i] + 1;
+      // towers of every cell, cells may have several towers
+      first.assign((size_t)size[0]*size[1]*size[2] + 1, 0);
+      for (const auto &tower : towers) first.at(cell(tower.cellIDx, tower.cellIDy, tower.cellIDz) + 1)++;
+      for (size_t c = 1; c < first.size(); c++) first.at(c) += first.at(c-1);
+      indices.resize(towers.size());
+      std::vector<int> next(first.begin(), first.end() - 1);
+      for (int t = 0; t < (int)towers.size(); t++) indices.at(next.at(cell(towers.at(t).cellIDx, towers.at(t).cellIDy, towers.at(t).cellIDz))++) = t;
+    }
+
+    // indices of the towers at (x, y, layer), in the order of the tower array
+    std::span<const int> at(int x, int y, int z) const {
+      if (x < min[0] || y < min[1] || z < min[2] || x - min[0] >= size[0] || y - min[1] >= size[1] || z - min[2] >= size[2]) return {};
+      const size_t c = cell(x, y, z);
+      return std::span<const int>(indices).subspan(first.at(c), first.at(c+1) - first.at(c));
+    }
+
+  private:
+    size_t cell(int x, int y, int z) const { return ((size_t)(z - min[2]) * size[1] + (y - min[1])) * size[0] + (x - min[0]); }
+
+    int min[3]  = {0, 0, 0};
+    int size[3] = {0, 0, 0};
+    std::vector<int> first;   // of the towers of cell c in indices, from first[c] to first[c+1]
+    std::vector<int> indices;
+} ;
+
 //**************************************************************************************************************//
 //**************************************************************************************************************//
 // find clusters with common edges or corners, separate if energy increases in neighboring cell
 //**************************************************************************************************************//
 //**************************************************************************************************************//
-clustersStrct findMACluster(
+std::vector<clustersStrct> findMAClusters(
                               float seed,                                     // minimum seed energy
                               float agg,                                      // minimum aggregation energy
-                              std::vector<towersStrct> &input_towers_temp,    // temporary full tower array
-                              std::vector<towersStrct> &cluster_towers_temp,  // towers associated to cluster
-//                               std::vector<int> clslabels_temp              // MC labels in cluster
+                              const std::vector<towersStrct> &input_towers,   // full tower array, sorted by decreasing energy
                               float aggMargin = 1.0                           // aggregation margin
                             ){
-  clustersStrct tempstructC;
-  if(input_towers_temp.at(0).energy > seed){
-//     std::cout << "new cluster" << std::endl;
+  std::vector<clustersStrct> clusters;
+  // towers below the aggregation energy are not clusterized
+  size_t nTowers = 0;
+  while (nTowers < input_towers.size() && input_towers.at(nTowers).energy >= agg) nTowers++;
+  const std::vector<towersStrct> towers(input_towers.begin(), input_towers.begin() + nTowers);
+  const towersGrid grid(towers);
+  std::vector<bool> used(towers.size(), false);
+  std::vector<int> cluster_members;
+  std::vector<int> neighbors;
+
+  // always start with the highest energetic remaining tower
+  for (int sit = 0; sit < (int)towers.size(); sit++){
+    if (used.at(sit)) continue;
+    if (towers.at(sit).energy <= seed) break;
     // fill seed cell information into current cluster
-    tempstructC.cluster_E       = input_towers_temp.at(0).energy;
-    tempstructC.cluster_seed    = input_towers_temp.at(0).energy;
+    clustersStrct tempstructC;
+    tempstructC.cluster_E       = towers.at(sit).energy;
+    tempstructC.cluster_seed    = towers.at(sit).energy;
     tempstructC.cluster_NTowers = 1;
     tempstructC.cluster_NtrueID = 1;
-    tempstructC.cluster_trueID = input_towers_temp.at(0).tower_trueID; // TODO save all MC labels?
-    cluster_towers_temp.push_back(input_towers_temp.at(0));
-//     clslabels_temp.push_back(input_towers_temp.at(0).tower_trueID);
-//     std::cout  << "seed: "<<  input_towers_temp.at(0).cellIDx << "\t" << input_towers_temp.at(0).cellIDy
-//                   << "\t" << input_towers_temp.at(0).cellIDz << "\t E:"<< tempstructC.cluster_E << std::endl;
-
-
-    // remove seed tower from sample
-    input_towers_temp.erase(input_towers_temp.begin());
-    for (int tit = 0; tit < (int)cluster_towers_temp.size(); tit++){
-      // Now go recursively to all neighbours and add them to the cluster if they fulfill the conditions
-      int iEtaTwr = cluster_towers_temp.at(tit).cellIDx;
-      int iPhiTwr = cluster_towers_temp.at(tit).cellIDy;
-      int iLTwr   = cluster_towers_temp.at(tit).cellIDz;
-      int refC = 0;
-      for (int ait = 0; ait < (int)input_towers_temp.size(); ait++){
-        int iEtaTwrAgg = input_towers_temp.at(ait).cellIDx;
-        int iPhiTwrAgg = input_towers_temp.at(ait).cellIDy;
-        int iLTwrAgg   = input_towers_temp.at(ait).cellIDz;
-
-        int deltaL    = TMath::Abs(iLTwrAgg-iLTwr) ;
-        int deltaPhi  = TMath::Abs(iPhiTwrAgg-iPhiTwr) ;
-        int deltaEta  = TMath::Abs(iEtaTwrAgg-iEtaTwr) ;
-        bool neighbor = (deltaL+deltaPhi+deltaEta == 1);
-        bool corner2D = (deltaL == 0 && deltaPhi == 1 && deltaEta == 1) || (deltaL == 1 && deltaPhi == 0 && deltaEta == 1) || (deltaL == 1 && deltaPhi == 1 && deltaEta == 0);
-//         first condition asks for V3-like neighbors, while second condition also checks diagonally attached towers
-        if(neighbor || corner2D ){
-
-          // only aggregate towers with lower energy than current tower
-
-          if(input_towers_temp.at(ait).energy >= (cluster_towers_temp.at(tit).energy + aggMargin)) continue;
-          tempstructC.cluster_E+=input_towers_temp.at(ait).energy;
-          tempstructC.cluster_NTowers++;
-          cluster_towers_temp.push_back(input_towers_temp.at(ait));
-//           if(!(std::find(clslabels_temp.begin(), clslabels_temp.end(), input_towers_temp.at(ait).tower_trueID) != clslabels_temp.end())){
-//             tempstructC.cluster_NtrueID++;
-//             clslabels_temp.push_back(input_towers_temp.at(ait).tower_trueID);
-//           }
-//           std::cout << "aggregated: "<< iEtaTwrAgg << "\t" << iPhiTwrAgg << "\t" << iLTwrAgg << "\t E:" << input_towers_temp.at(ait).energy << "\t reference: "<< refC << "\t"<< iEtaTwr << "\t" << iPhiTwr << "\t" << iLTwr << "\t cond.: \t"<< neighbor << "\t" << corner2D << "\t  diffs: " << deltaEta << "\t" << deltaPhi << "\t" << deltaL<< std::endl;
-
-          input_towers_temp.erase(input_towers_temp.begin()+ait);
-          ait--;
-          refC++;
+    tempstructC.cluster_trueID  = towers.at(sit).tower_trueID; // TODO save all MC labels?
+    cluster_members.assign(1, sit);
+    used.at(sit) = true;
+
+    for (int tit = 0; tit < (int)cluster_members.size(); tit++){
+      // Now go to all neighbours and add them to the cluster if they fulfill the conditions
+      const towersStrct &tower = towers.at(cluster_members.at(tit));
+      neighbors.clear();
+      for (int deltaL = -1; deltaL <= 1; deltaL++){
+        for (int deltaPhi = -1; deltaPhi <= 1; deltaPhi++){
+          for (int deltaEta = -1; deltaEta <= 1; deltaEta++){
+            // V3-like neighbors and diagonally attached towers in 2D, no 3D corners
+            const int distance = std::abs(deltaL) + std::abs(deltaPhi) + std::abs(deltaEta);
+            if (distance == 0 || distance == 3) continue;
+            for (int ait : grid.at(tower.cellIDx + deltaEta, tower.cellIDy + deltaPhi, tower.cellIDz + deltaL)){
+              // only aggregate towers with lower energy than current tower
+              if (used.at(ait) || towers.at(ait).energy >= (tower.energy + aggMargin)) continue;
+              neighbors.push_back(ait);
+            }
+          }
         }
       }
+      // aggregated in the order of the tower array, by decreasing energy
+      std::sort(neighbors.begin(), neighbors.end());
+      for (int ait : neighbors){
+        used.at(ait) = true;
+        tempstructC.cluster_E += towers.at(ait).energy;
+        tempstructC.cluster_NTowers++;
+        cluster_members.push_back(ait);
+      }
     }
+
+    tempstructC.cluster_towers.reserve(cluster_members.size());
+    for (int tit : cluster_members) tempstructC.cluster_towers.push_back(towers.at(tit));
+    clusters.push_back(tempstructC);
   }
-  return tempstructC;
+  return clusters;
 }
 
 
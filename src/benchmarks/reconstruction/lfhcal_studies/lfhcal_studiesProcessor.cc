@@ -30,11 +30,14 @@
 #include <limits>
 #include <map>
 #include <stdexcept>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "clusterizer_MA.h"
 #include "services/geometry/dd4hep/DD4hep_service.h"
 #include "services/log/Log_service.h"
+#include "services/rootfile/HistFillBuffer.h"
 #include "services/rootfile/RootFile_service.h"
 
 
@@ -59,6 +62,7 @@ void lfhcal_studiesProcessor::Init() {
 
   // Get TDirectory for histograms root file
   auto globalRootLock = app->GetService<JGlobalRootLock>();
+  m_root_lock = globalRootLock;
   globalRootLock->acquire_write_lock();
   auto *file = root_file_service->GetHistFile();
   globalRootLock->release_lock();
@@ -264,6 +268,9 @@ void lfhcal_studiesProcessor::Init() {
 //******************************************************************************************//
 void lfhcal_studiesProcessor::Process(const std::shared_ptr<const JEvent>& event) {
 // void lfhcal_studiesProcessor::ProcessSequential(const std::shared_ptr<const JEvent>& event) {
+  treeValues values;
+  // histogram fills of the event, made under one root lock at the end
+  eicrecon::HistFillBuffer fills(256);
 
   // ===============================================================================================
   // process MC particles
@@ -287,22 +294,18 @@ void lfhcal_studiesProcessor::Process(const std::shared_ptr<const JEvent>& event
     // determine mc momentum
     mcp = sqrt(mom.x * mom.x + mom.y * mom.y + mom.z * mom.z);
     m_log->trace("MC particle:{} \t {} \t {} \t totmom: {} phi {} eta {}", mom.x, mom.y, mom.z, mcp, mcphi, mceta);
-    hMCEnergyVsEta->Fill(mcp,mceta);
+    fills.Fill(hMCEnergyVsEta, mcp,mceta);
 
-    if (enableTreeCluster){
-      if (iMC < maxNMC){
-        t_mc_E[iMC]   = mcenergy;
-        t_mc_Phi[iMC] = mcphi;
-        t_mc_Eta[iMC] = mceta;
-      }
+    if (enableTreeCluster && iMC < maxNMC){
+      values.mc.push_back({(float)mcenergy, (float)mcphi, (float)mceta});
     }
     iMC++;
   }
-  if (enableTreeCluster) t_mc_N = iMC;
   // ===============================================================================================
   // process sim hits
   // ===============================================================================================
   std::vector<towersStrct> input_tower_sim;
+  std::unordered_map<uint64_t, size_t> input_tower_sim_index; // cellID -> tower
   int nCaloHitsSim = 0;
   float sumActiveCaloEnergy = 0;
   float sumPassiveCaloEnergy = 0;
@@ -347,25 +350,20 @@ void lfhcal_studiesProcessor::Process(const std::shared_ptr<const JEvent>& event
     }
     nCaloHitsSim++;
 
-    hPosCaloSimHitsXY->Fill(x, y);
-    hPosCaloSimHitsZX->Fill(z, x);
-    hPosCaloSimHitsZY->Fill(z, y);
-
-    hCellESim_layerZ->Fill(cellIDz, energy);
-    hCellESim_layerX->Fill(cellIDx, energy);
-    hCellESim_layerY->Fill(cellIDy, energy);
-    hCellTSim_layerZ->Fill(cellIDz, time);
-
-    //loop over input_tower_sim and find if there is already a tower with the same cellID
-    bool found = false;
-    for (auto& tower : input_tower_sim) {
-      if (tower.cellID == cellID) {
-        tower.energy += energy;
-        found = true;
-        break;
-      }
-    }
-    if (!found) {
+    fills.Fill(hPosCaloSimHitsXY, x, y);
+    fills.Fill(hPosCaloSimHitsZX, z, x);
+    fills.Fill(hPosCaloSimHitsZY, z, y);
+
+    fills.Fill(hCellESim_layerZ, cellIDz, energy);
+    fills.Fill(hCellESim_layerX, cellIDx, energy);
+    fills.Fill(hCellESim_layerY, cellIDy, energy);
+    fills.Fill(hCellTSim_layerZ, cellIDz, time);
+
+    // add to the tower with the same cellID, if there is already one
+    auto [sim_index, inserted] = input_tower_sim_index.try_emplace(cellID, input_tower_sim.size());
+    if (!inserted) {
+      input_tower_sim.at(sim_index->second).energy += energy;
+    } else {
       towersStrct tempstructT;
       tempstructT.energy        = energy;
       tempstructT.time          = time;
@@ -389,6 +387,7 @@ void lfhcal_studiesProcessor::Process(const std::shared_ptr<const JEvent>& event
   int nCaloHitsRec = 0;
   std::vector<towersStrct> input_tower_rec;
   std::vector<towersStrct> input_tower_recSav;
+  std::unordered_map<uint64_t, size_t> input_tower_rec_index; // cellID -> tower
   // process rec hits
   for (const auto caloHit : recHits) {
     float x         = caloHit.getPosition().x / 10.;
@@ -418,22 +417,17 @@ void lfhcal_studiesProcessor::Process(const std::shared_ptr<const JEvent>& event
       cellIDy = 54ll*2 - detector_module_y * 2 + detector_layer_y;
     }
 
-    hPosCaloHitsXY->Fill(x, y);
-    hPosCaloHitsZX->Fill(z, x);
-    hPosCaloHitsZY->Fill(z, y);
+    fills.Fill(hPosCaloHitsXY, x, y);
+    fills.Fill(hPosCaloHitsZX, z, x);
+    fills.Fill(hPosCaloHitsZY, z, y);
 
     nCaloHitsRec++;
 
-    //loop over input_tower_rec and find if there is already a tower with the same cellID
-    bool found = false;
-    for (auto& tower : input_tower_rec) {
-      if (tower.cellID == cellID) {
-        tower.energy += energy;
-        found = true;
-        break;
-      }
-    }
-    if (!found) {
+    // add to the tower with the same cellID, if there is already one
+    auto [rec_index, inserted] = input_tower_rec_index.try_emplace(cellID, input_tower_rec.size());
+    if (!inserted) {
+      input_tower_rec.at(rec_index->second).energy += energy;
+    } else {
       towersStrct tempstructT;
       tempstructT.energy        = energy;
       tempstructT.time          = time;
@@ -457,7 +451,7 @@ void lfhcal_studiesProcessor::Process(const std::shared_ptr<const JEvent>& event
   // ===============================================================================================
   // sort tower arrays
   // ===============================================================================================
-  hSamplingFractionEta->Fill(mceta, sumActiveCaloEnergy / (sumActiveCaloEnergy+sumPassiveCaloEnergy));
+  fills.Fill(hSamplingFractionEta, mceta, sumActiveCaloEnergy / (sumActiveCaloEnergy+sumPassiveCaloEnergy));
   std::sort(input_tower_rec.begin(), input_tower_rec.end(), &acompare);
   std::sort(input_tower_recSav.begin(), input_tower_recSav.end(), &acompare);
   std::sort(input_tower_sim.begin(), input_tower_sim.end(), &acompare);
@@ -491,63 +485,38 @@ void lfhcal_studiesProcessor::Process(const std::shared_ptr<const JEvent>& event
   // Fill summed hits histos
   // ===============================================================================================
   // rec hits
-  hClusterNCells_E_eta->Fill(mcenergy, nCaloHitsRec, mceta);
-  hClusterEcalib_E_eta->Fill(mcenergy, tot_energyRecHit/mcenergy, mceta);
-  hClusterEcalib_E_phi->Fill(mcenergy, tot_energyRecHit/mcenergy, mcphi);
+  fills.Fill(hClusterNCells_E_eta, mcenergy, nCaloHitsRec, mceta);
+  fills.Fill(hClusterEcalib_E_eta, mcenergy, tot_energyRecHit/mcenergy, mceta);
+  fills.Fill(hClusterEcalib_E_phi, mcenergy, tot_energyRecHit/mcenergy, mcphi);
   // sim hits
-  hClusterSimNCells_E_eta->Fill(mcenergy, nCaloHitsSim, mceta);
-  hClusterESimcalib_E_eta->Fill(mcenergy, tot_energySimHit/mcenergy, mceta);
-  hClusterESimcalib_E_phi->Fill(mcenergy, tot_energySimHit/mcenergy, mcphi);
+  fills.Fill(hClusterSimNCells_E_eta, mcenergy, nCaloHitsSim, mceta);
+  fills.Fill(hClusterESimcalib_E_eta, mcenergy, tot_energySimHit/mcenergy, mceta);
+  fills.Fill(hClusterESimcalib_E_phi, mcenergy, tot_energySimHit/mcenergy, mcphi);
 
   // ===============================================================================================
   // MA clusterization
   // ===============================================================================================
-  int removedCells  = 0;
   float minAggE     = 0.001;
   float seedE       = 0.100;
 
   if (!input_tower_rec.empty()){
 
-    // clean up rec array for clusterization
-    while (input_tower_rec.at(input_tower_rec.size()-1).energy < minAggE ){
-      input_tower_rec.pop_back();
-      removedCells++;
-    }
-    m_log->trace("removed {} with E < {} GeV", removedCells, minAggE);
-
-    int nclusters = 0;
-    // vector of clusters
-    std::vector<clustersStrct> clusters_calo;
-    // vector of towers within the currently found cluster
-    std::vector<towersStrct> cluster_towers;
-    while (!input_tower_rec.empty() ) {
-      cluster_towers.clear();
-      clustersStrct tempstructC;
-      // always start with highest energetic tower
-      if(input_tower_rec.at(0).energy > seedE){
-        m_log->trace("seed: {}\t {} \t {}", input_tower_rec.at(0).energy, input_tower_rec.at(0).cellIDx, input_tower_rec.at(0).cellIDy,  input_tower_rec.at(0).cellIDz);
-        tempstructC = findMACluster(seedE, minAggE, input_tower_rec, cluster_towers);
-
-        // determine remaining cluster properties from its towers
-        float* showershape_eta_phi = CalculateM02andWeightedPosition(cluster_towers, tempstructC.cluster_E, 4.5);
-        tempstructC.cluster_M02 = showershape_eta_phi[0];
-        tempstructC.cluster_M20 = showershape_eta_phi[1];
-        tempstructC.cluster_Eta = showershape_eta_phi[2];
-        tempstructC.cluster_Phi = showershape_eta_phi[3];
-        tempstructC.cluster_X = showershape_eta_phi[4];
-        tempstructC.cluster_Y = showershape_eta_phi[5];
-        tempstructC.cluster_Z = showershape_eta_phi[6];
-        tempstructC.cluster_towers = cluster_towers;
-        m_log->trace("---------> \t {} \tcluster with E = {} \tEta: {} \tPhi: {} \tX: {} \tY: {} \tZ: {} \tntowers: {} \ttrueID: {}", nclusters, tempstructC.cluster_E, tempstructC.cluster_Eta, tempstructC.cluster_Phi, tempstructC.cluster_X, tempstructC.cluster_Y, tempstructC.cluster_Z, tempstructC.cluster_NTowers, tempstructC.cluster_trueID );
-        clusters_calo.push_back(tempstructC);
-
-        clusters_calo.push_back(tempstructC);
-
-        nclusters++;
-      } else {
-        m_log->trace("remaining: {} largest: {} \t {}  \t {}  \t {}", (int)input_tower_rec.size(), input_tower_rec.at(0).energy, input_tower_rec.at(0).cellIDx, input_tower_rec.at(0).cellIDy,  input_tower_rec.at(0).cellIDz);
-        input_tower_rec.clear();
-      }
+    // clusters on the (x, y, layer) grid of the towers
+    std::vector<clustersStrct> clusters_calo = findMAClusters(seedE, minAggE, input_tower_rec);
+    for (int nclusters = 0; nclusters < (int)clusters_calo.size(); nclusters++) {
+      clustersStrct &tempstructC = clusters_calo.at(nclusters);
+      m_log->trace("seed: {}\t {} \t {} \t {}", tempstructC.cluster_seed, tempstructC.cluster_towers.at(0).cellIDx, tempstructC.cluster_towers.at(0).cellIDy, tempstructC.cluster_towers.at(0).cellIDz);
+
+      // determine remaining cluster properties from its towers
+      float* showershape_eta_phi = CalculateM02andWeightedPosition(tempstructC.cluster_towers, tempstructC.cluster_E, 4.5);
+      tempstructC.cluster_M02 = showershape_eta_phi[0];
+      tempstructC.cluster_M20 = showershape_eta_phi[1];
+      tempstructC.cluster_Eta = showershape_eta_phi[2];
+      tempstructC.cluster_Phi = showershape_eta_phi[3];
+      tempstructC.cluster_X = showershape_eta_phi[4];
+      tempstructC.cluster_Y = showershape_eta_phi[5];
+      tempstructC.cluster_Z = showershape_eta_phi[6];
+      m_log->trace("---------> \t {} \tcluster with E = {} \tEta: {} \tPhi: {} \tX: {} \tY: {} \tZ: {} \tntowers: {} \ttrueID: {}", nclusters, tempstructC.cluster_E, tempstructC.cluster_Eta, tempstructC.cluster_Phi, tempstructC.cluster_X, tempstructC.cluster_Y, tempstructC.cluster_Z, tempstructC.cluster_NTowers, tempstructC.cluster_trueID );
     }
 
     // -----------------------------------------------------------------------------------------------
@@ -555,36 +524,32 @@ void lfhcal_studiesProcessor::Process(const std::shared_ptr<const JEvent>& event
     // -----------------------------------------------------------------------------------------------
     std::sort(clusters_calo.begin(), clusters_calo.end(), &acompareCl);
     m_log->info("-----> found {} clusters" , clusters_calo.size());
-    hRecNClusters_E_eta->Fill(mcenergy, clusters_calo.size(), mceta);
+    fills.Fill(hRecNClusters_E_eta, mcenergy, clusters_calo.size(), mceta);
+    std::unordered_map<int, size_t> input_tower_recSav_index; // cellID -> tower
+    for (size_t pSav = 0; pSav < input_tower_recSav.size(); pSav++) {
+      input_tower_recSav_index.try_emplace(input_tower_recSav.at(pSav).cellID, pSav);
+    }
     int iCl = 0;
-    for (const auto cluster : clusters_calo) {
+    for (const auto& cluster : clusters_calo) {
       if (iCl < maxNCluster && enableTreeCluster){
-        t_lFHCal_cluster_E[iCl]       = (float)cluster.cluster_E;
-        t_lFHCal_cluster_NCells[iCl]  = (int)cluster.cluster_NTowers;
-        t_lFHCal_cluster_Eta[iCl]     = (float)cluster.cluster_Eta;
-        t_lFHCal_cluster_Phi[iCl]     = (float)cluster.cluster_Phi;
+        values.lFHCal_clusters.push_back({(float)cluster.cluster_E, (int)cluster.cluster_NTowers, (float)cluster.cluster_Eta, (float)cluster.cluster_Phi});
       }
-      hRecClusterEcalib_E_eta->Fill(mcenergy, cluster.cluster_E/mcenergy, mceta);
-      for (int iCell = 0; iCell < (int)cluster.cluster_towers.size(); iCell++){
-        int pSav = 0;
-        while(cluster.cluster_towers.at(iCell).cellID !=  input_tower_recSav.at(pSav).cellID && pSav < (int)input_tower_recSav.size() ) pSav++;
-        if (cluster.cluster_towers.at(iCell).cellID == input_tower_recSav.at(pSav).cellID)
-          input_tower_recSav.at(pSav).tower_clusterIDA = iCl;
+      fills.Fill(hRecClusterEcalib_E_eta, mcenergy, cluster.cluster_E/mcenergy, mceta);
+      for (const auto& cluster_tower : cluster.cluster_towers){
+        auto pSav = input_tower_recSav_index.find(cluster_tower.cellID);
+        if (pSav != input_tower_recSav_index.end())
+          input_tower_recSav.at(pSav->second).tower_clusterIDA = iCl;
       }
 
       if (iCl == 0){
-        hRecClusterEcalib_Ehigh_eta->Fill(mcenergy, cluster.cluster_E/mcenergy, mceta);
-        hRecClusterNCells_Ehigh_eta->Fill(mcenergy, cluster.cluster_NTowers, mceta);
+        fills.Fill(hRecClusterEcalib_Ehigh_eta, mcenergy, cluster.cluster_E/mcenergy, mceta);
+        fills.Fill(hRecClusterNCells_Ehigh_eta, mcenergy, cluster.cluster_NTowers, mceta);
       }
       iCl++;
       m_log->trace("MA cluster {}:\t {} \t {}", iCl, cluster.cluster_E, cluster.cluster_NTowers);
     }
-    if (iCl < maxNCluster && enableTreeCluster) t_lFHCal_clusters_N = (int)iCl;
-
-    clusters_calo.clear();
   } else {
-    hRecNClusters_E_eta->Fill(mcenergy, 0., mceta);
-    if (enableTreeCluster) t_lFHCal_clusters_N = 0;
+    fills.Fill(hRecNClusters_E_eta, mcenergy, 0., mceta);
   }
 
   // ===============================================================================================
@@ -600,17 +565,17 @@ void lfhcal_studiesProcessor::Process(const std::shared_ptr<const JEvent>& event
       iClFHigh    = iClF;
       highestEFr  = cluster.getEnergy();
     }
-    hRecFClusterEcalib_E_eta->Fill(mcenergy, cluster.getEnergy()/mcenergy, mceta);
+    fills.Fill(hRecFClusterEcalib_E_eta, mcenergy, cluster.getEnergy()/mcenergy, mceta);
     m_log->trace("Island cluster {}:\t {} \t {}", iClF, cluster.getEnergy(), cluster.getNhits());
     iClF++;
   }
-  hRecFNClusters_E_eta->Fill(mcenergy, iClF, mceta);
+  fills.Fill(hRecFNClusters_E_eta, mcenergy, iClF, mceta);
   // fill hists for highest Island cluster
   iClF          = 0;
   for (const auto cluster : lfhcalClustersF) {
     if (iClF == iClFHigh){
-      hRecFClusterEcalib_Ehigh_eta->Fill(mcenergy, cluster.getEnergy()/mcenergy, mceta);
-      hRecFClusterNCells_Ehigh_eta->Fill(mcenergy, cluster.getNhits(), mceta);
+      fills.Fill(hRecFClusterEcalib_Ehigh_eta, mcenergy, cluster.getEnergy()/mcenergy, mceta);
+      fills.Fill(hRecFClusterNCells_Ehigh_eta, mcenergy, cluster.getNhits(), mceta);
     }
     iClF++;
   }
@@ -629,27 +594,25 @@ void lfhcal_studiesProcessor::Process(const std::shared_ptr<const JEvent>& event
       m_log->info("-----> found fEMCClustersF:" , fEMCClustersF.size());
       for (const auto cluster : fEMCClustersF) {
         if (iECl < maxNCluster && enableTreeCluster){
-            t_fEMC_cluster_E[iECl]       = (float)cluster.getEnergy();
-            t_fEMC_cluster_NCells[iECl]  = (int)cluster.getNhits();
-            t_fEMC_cluster_Eta[iECl]     = (-1.) * std::log(std::tan((float)cluster.getIntrinsicTheta() / 2.));
-            t_fEMC_cluster_Phi[iECl]     = (float)cluster.getIntrinsicPhi();
+            values.fEMC_clusters.push_back({(float)cluster.getEnergy(), (int)cluster.getNhits(),
+                                            (float)((-1.) * std::log(std::tan((float)cluster.getIntrinsicTheta() / 2.))),
+                                            (float)cluster.getIntrinsicPhi()});
         }
 
         if (cluster.getEnergy() > highestEEmCl){
           iEClHigh      = iECl;
           highestEEmCl  = cluster.getEnergy();
         }
-        hRecFEmClusterEcalib_E_eta->Fill(mcenergy, cluster.getEnergy()/mcenergy, mceta);
+        fills.Fill(hRecFEmClusterEcalib_E_eta, mcenergy, cluster.getEnergy()/mcenergy, mceta);
         iECl++;
       }
-      t_fEMC_clusters_N  = iECl;
-      hRecFEmNClusters_E_eta->Fill(mcenergy, iECl, mceta);
+      fills.Fill(hRecFEmNClusters_E_eta, mcenergy, iECl, mceta);
 
       // fill hists for highest Island cluster
       iECl          = 0;
       for (const auto cluster : fEMCClustersF) {
         if (iECl == iEClHigh){
-          hRecFEmClusterEcalib_Ehigh_eta->Fill(mcenergy, cluster.getEnergy()/mcenergy, mceta);
+          fills.Fill(hRecFEmClusterEcalib_Ehigh_eta, mcenergy, cluster.getEnergy()/mcenergy, mceta);
         }
         iECl++;
       }
@@ -659,71 +622,88 @@ void lfhcal_studiesProcessor::Process(const std::shared_ptr<const JEvent>& event
     }
   }
   // ===============================================================================================
-  // Write clusterizer tree & clean-up variables
+  // Write clusterizer and cluster trees, in batches of events
   // ===============================================================================================
   if (enableTree){
-    t_lFHCal_towers_N = (int)input_tower_recSav.size();
-    for (int iCell = 0; iCell < (int)input_tower_recSav.size(); iCell++){
-      m_log->trace("{} \t {} \t {} \t {} \t {} \t {}", input_tower_recSav.at(iCell).cellIDx, input_tower_recSav.at(iCell).cellIDy, input_tower_recSav.at(iCell).cellIDz , input_tower_recSav.at(iCell).energy, input_tower_recSav.at(iCell).tower_clusterIDA, input_tower_recSav.at(iCell).tower_clusterIDB  );
-
-      t_lFHCal_towers_cellE[iCell]      = (float)input_tower_recSav.at(iCell).energy;
-      t_lFHCal_towers_cellT[iCell]      = (float)input_tower_recSav.at(iCell).time;
-      t_lFHCal_towers_cellIDx[iCell]    = (short)input_tower_recSav.at(iCell).cellIDx;
-      t_lFHCal_towers_cellIDy[iCell]    = (short)input_tower_recSav.at(iCell).cellIDy;
-      t_lFHCal_towers_cellIDz[iCell]    = (short)input_tower_recSav.at(iCell).cellIDz;
-      t_lFHCal_towers_clusterIDA[iCell] = (short)input_tower_recSav.at(iCell).tower_clusterIDA;
-      t_lFHCal_towers_clusterIDB[iCell] = (short)input_tower_recSav.at(iCell).tower_clusterIDB;
-      t_lFHCal_towers_cellTrueID[iCell] = (int)input_tower_recSav.at(iCell).tower_trueID;
+    values.towers.reserve(input_tower_recSav.size());
+    for (const auto& tower : input_tower_recSav){
+      m_log->trace("{} \t {} \t {} \t {} \t {} \t {}", tower.cellIDx, tower.cellIDy, tower.cellIDz , tower.energy, tower.tower_clusterIDA, tower.tower_clusterIDB  );
+      values.towers.push_back({(float)tower.energy, (float)tower.time, (short)tower.cellIDx, (short)tower.cellIDy, (short)tower.cellIDz,
+                               (short)tower.tower_clusterIDA, (short)tower.tower_clusterIDB, (int)tower.tower_trueID});
     }
-
-    event_tree->Fill();
-
-    t_lFHCal_towers_N = 0;
-    for (Int_t itow = 0; itow < maxNTowers; itow++){
-      t_lFHCal_towers_cellE[itow]       = 0;
-      t_lFHCal_towers_cellT[itow]       = 0;
-      t_lFHCal_towers_cellIDx[itow]     = 0;
-      t_lFHCal_towers_cellIDy[itow]     = 0;
-      t_lFHCal_towers_cellIDz[itow]     = 0;
-      t_lFHCal_towers_clusterIDA[itow]  = 0;
-      t_lFHCal_towers_clusterIDB[itow]  = 0;
-      t_lFHCal_towers_cellTrueID[itow]  = 0;
+  }
+  fills.Flush(*m_root_lock);
+
+  if (enableTree || enableTreeCluster){
+    std::vector<treeValues> batch;
+    {
+      std::lock_guard<std::mutex> lock(m_tree_mutex);
+      m_tree_values.push_back(std::move(values));
+      if (m_tree_values.size() >= treeBatchSize) batch.swap(m_tree_values);
     }
+    if (!batch.empty()) FillTrees(batch);
   }
 
-  // ===============================================================================================
-  // Write cluster tree & clean-up variables
-  // ===============================================================================================
-  if (enableTreeCluster){
-    cluster_tree->Fill();
-
-    t_mc_N                = 0;
-    t_lFHCal_clusters_N   = 0;
-    t_fEMC_clusters_N    = 0;
-    for (Int_t iMC = 0; iMC < maxNMC; iMC++){
-      t_mc_E[iMC]                   = 0;
-      t_mc_Phi[iMC]                 = 0;
-      t_mc_Eta[iMC]                 = 0;
+}
+
+//******************************************************************************************//
+// FillTrees
+//******************************************************************************************//
+void lfhcal_studiesProcessor::FillTrees(const std::vector<treeValues>& events) {
+  m_root_lock->acquire_write_lock();
+  for (const auto& values : events){
+    if (enableTree){
+      t_lFHCal_towers_N = (int)std::min(values.towers.size(), (size_t)maxNTowers);
+      for (int iCell = 0; iCell < t_lFHCal_towers_N; iCell++){
+        const auto& tower = values.towers.at(iCell);
+        t_lFHCal_towers_cellE[iCell]      = tower.E;
+        t_lFHCal_towers_cellT[iCell]      = tower.T;
+        t_lFHCal_towers_cellIDx[iCell]    = tower.ix;
+        t_lFHCal_towers_cellIDy[iCell]    = tower.iy;
+        t_lFHCal_towers_cellIDz[iCell]    = tower.iz;
+        t_lFHCal_towers_clusterIDA[iCell] = tower.clusIDA;
+        t_lFHCal_towers_clusterIDB[iCell] = tower.clusIDB;
+        t_lFHCal_towers_cellTrueID[iCell] = tower.trueID;
+      }
+      event_tree->Fill();
     }
-    for (Int_t iCl = 0; iCl < maxNCluster; iCl++){
-      t_lFHCal_cluster_E[iCl]       = 0;
-      t_lFHCal_cluster_NCells[iCl]  = 0;
-      t_lFHCal_cluster_Eta[iCl]     = 0;
-      t_lFHCal_cluster_Phi[iCl]     = 0;
-      t_fEMC_cluster_E[iCl]        = 0;
-      t_fEMC_cluster_NCells[iCl]   = 0;
-      t_fEMC_cluster_Eta[iCl]      = 0;
-      t_fEMC_cluster_Phi[iCl]      = 0;
+    if (enableTreeCluster){
+      t_mc_N = (int)values.mc.size();
+      for (int iMC = 0; iMC < t_mc_N; iMC++){
+        t_mc_E[iMC]   = values.mc.at(iMC)[0];
+        t_mc_Phi[iMC] = values.mc.at(iMC)[1];
+        t_mc_Eta[iMC] = values.mc.at(iMC)[2];
+      }
+      t_lFHCal_clusters_N = (int)values.lFHCal_clusters.size();
+      for (int iCl = 0; iCl < t_lFHCal_clusters_N; iCl++){
+        const auto& cluster = values.lFHCal_clusters.at(iCl);
+        t_lFHCal_cluster_E[iCl]       = cluster.E;
+        t_lFHCal_cluster_NCells[iCl]  = cluster.NCells;
+        t_lFHCal_cluster_Eta[iCl]     = cluster.Eta;
+        t_lFHCal_cluster_Phi[iCl]     = cluster.Phi;
+      }
+      t_fEMC_clusters_N = (int)values.fEMC_clusters.size();
+      for (int iCl = 0; iCl < t_fEMC_clusters_N; iCl++){
+        const auto& cluster = values.fEMC_clusters.at(iCl);
+        t_fEMC_cluster_E[iCl]        = cluster.E;
+        t_fEMC_cluster_NCells[iCl]   = cluster.NCells;
+        t_fEMC_cluster_Eta[iCl]      = cluster.Eta;
+        t_fEMC_cluster_Phi[iCl]      = cluster.Phi;
+      }
+      cluster_tree->Fill();
     }
   }
-
+  m_root_lock->release_lock();
 }
 
 //******************************************************************************************//
 // Finish
 //******************************************************************************************//
 void lfhcal_studiesProcessor::Finish() {
-  std::cout << "------> LFHCal " << nEventsWithCaloHits << " with calo info present"<< std::endl;
+  std::cout << "------> LFHCal " << nEventsWithCaloHits.load() << " with calo info present"<< std::endl;
+  // the events of the last batch
+  FillTrees(m_tree_values);
+  m_tree_values.clear();
   // Do any final calculations here.
 
   if (enableTree) {
@@ -7,14 +7,19 @@
 #include <DDSegmentation/BitFieldCoder.h>
 #include <JANA/JEvent.h>
 #include <JANA/JEventProcessor.h>
+#include <JANA/Services/JGlobalRootLock.h>
 #include <JANA/Utils/JTypeInfo.h>
 #include <TDirectory.h>
 #include <TH2.h>
 #include <TH3.h>
 #include <TTree.h>
 #include <spdlog/logger.h>
+#include <array>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 class lfhcal_studiesProcessor: public JEventProcessor {
 public:
@@ -72,7 +77,7 @@ public:
     int*    t_lFHCal_towers_cellTrueID;
 
     bool enableTreeCluster  = true;
-    bool enableECalCluster  = true;
+    std::atomic<bool> enableECalCluster{true};
     TTree* cluster_tree;
     const int maxNCluster   = 50;
     const int maxNMC        = 50;
@@ -91,8 +96,31 @@ public:
     float*  t_fEMC_cluster_Phi;
     float*  t_fEMC_cluster_Eta;
 
+    // tree values of an event; Process() collects them, and they are filled
+    // into the trees in batches of treeBatchSize events under the ROOT lock
+    struct towerValues {
+      float E, T;
+      short ix, iy, iz, clusIDA, clusIDB;
+      int   trueID;
+    };
+    struct clusterValues {
+      float E;
+      int   NCells;
+      float Eta, Phi;
+    };
+    struct treeValues {
+      std::vector<towerValues>          towers;
+      std::vector<std::array<float,3>>  mc;      // E, Phi, Eta
+      std::vector<clusterValues>        lFHCal_clusters;
+      std::vector<clusterValues>        fEMC_clusters;
+    };
+    void FillTrees(const std::vector<treeValues>& events);
+    const size_t treeBatchSize = 100;
+    std::mutex m_tree_mutex;
+    std::vector<treeValues> m_tree_values;
+    std::shared_ptr<JGlobalRootLock> m_root_lock;
 
-    int nEventsWithCaloHits = 0;
+    std::atomic<int> nEventsWithCaloHits{0};
     bool isLFHCal = true;
     std::shared_ptr<spdlog::logger> m_log;
     dd4hep::DDSegmentation::BitFieldCoder* m_decoder;
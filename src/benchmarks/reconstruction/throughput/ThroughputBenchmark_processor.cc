@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "ThroughputBenchmark_processor.h"
+
+#include <JANA/JApplication.h>
+#include <fmt/core.h>
+#include <spdlog/logger.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "services/log/StartupProfile.h"
+
+namespace {
+
+    /// Wall time since the start of the process, from /proc, in seconds
+    double ProcessAgeSeconds() {
+        std::ifstream uptime_file("/proc/uptime");
+        std::ifstream stat_file("/proc/self/stat");
+        double uptime = 0;
+        std::string stat;
+        if (!(uptime_file >> uptime) || !std::getline(stat_file, stat)) {
+            return 0;
+        }
+        // the start time is the 22nd field, the 20th after the command name in parentheses
+        std::istringstream fields(stat.substr(stat.rfind(')') + 2));
+        std::string field;
+        for (int i = 0; i < 20 && fields >> field; i++) {}
+        if (field.empty()) {
+            return 0;
+        }
+        const double start = std::stod(field) / sysconf(_SC_CLK_TCK);
+        return std::max(uptime - start, 0.);
+    }
+
+    /// User and system CPU time of all the threads of the process, in seconds
+    double ProcessCPUSeconds() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 + usage.ru_stime.tv_sec +
+               usage.ru_stime.tv_usec * 1e-6;
+    }
+
+    /// Peak resident set size of the process in MB
+    double PeakResidentSetSizeMB() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss / 1024.; // kB
+    }
+
+    std::string Escape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+}
+
+//-------------------------------------------
+// Init
+//-------------------------------------------
+void ThroughputBenchmark_processor::Init() {
+    auto* app = GetApplication();
+    InitLogger(app, "throughput");
+    app->SetDefaultParameter("throughput:report_file", m_report_file, "JSON file of the throughput report");
+    app->SetDefaultParameter("throughput:warmup_events", m_warmup_events,
+                             "Events before the throughput measurement, e.g. for the initialisation of the factories");
+    app->SetDefaultParameter("throughput:sample", m_sample, "Name of the event sample, for the report");
+    app->SetDefaultParameter("throughput:configuration", m_configuration,
+                             "Name of the reconstruction configuration, for the report");
+    app->SetDefaultParameter("throughput:label", m_label, "Version of the code, e.g. the commit, for the report");
+}
+
+//-------------------------------------------
+// TakeSnapshot
+//-------------------------------------------
+ThroughputBenchmark_processor::Snapshot ThroughputBenchmark_processor::TakeSnapshot(std::uint64_t events) const {
+    return {events, std::chrono::steady_clock::now(), ProcessCPUSeconds(),
+            eicrecon::JOmniFactoryMetrics::instance().totals()};
+}
+
+//-------------------------------------------
+// Process
+//-------------------------------------------
+void ThroughputBenchmark_processor::Process(const std::shared_ptr<const JEvent>& event) {
+    const std::uint64_t n = ++m_events;
+    // the measurement starts after the warmup, or at the first event of a shorter job
+    if (n == 1 || n == m_warmup_events + 1) {
+        auto snapshot = TakeSnapshot(n - 1);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (n == 1) {
+            m_startup_seconds = ProcessAgeSeconds();
+        }
+        if (snapshot.events >= m_start.events) {
+            m_start = std::move(snapshot);
+        }
+    }
+    m_last_event.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+//-------------------------------------------
+// Finish
+//-------------------------------------------
+void ThroughputBenchmark_processor::Finish() {
+    const std::uint64_t events = m_events;
+    const auto end = std::chrono::steady_clock::time_point(
+            std::chrono::steady_clock::duration(m_last_event.load(std::memory_order_relaxed)));
+    const double cpu_seconds = ProcessCPUSeconds() - m_start.cpu_seconds;
+    const auto factories = eicrecon::JOmniFactoryMetrics::instance().totals();
+
+    const std::uint64_t measured = events - m_start.events;
+    const double wall = (events == 0) ? 0. : std::chrono::duration<double>(end - m_start.wall).count();
+    const double rate = (wall > 0) ? measured / wall : 0.;
+    const int nthreads = GetApplication()->GetNThreads();
+    const double efficiency = (wall > 0) ? cpu_seconds / (wall * nthreads) : 0.;
+    const double peak_rss = PeakResidentSetSizeMB();
+    if (events > 0 && events <= m_warmup_events) {
+        m_log->warn("Only {} events, the throughput includes the warmup", events);
+    }
+
+    std::ofstream out(m_report_file);
+    out << "{\n";
+    out << fmt::format("  \"sample\": \"{}\",\n", Escape(m_sample));
+    out << fmt::format("  \"configuration\": \"{}\",\n", Escape(m_configuration));
+    out << fmt::format("  \"label\": \"{}\",\n", Escape(m_label));
+    out << fmt::format("  \"threads\": {},\n", nthreads);
+    out << fmt::format("  \"events\": {},\n", events);
+    out << fmt::format("  \"measured_events\": {},\n", measured);
+    out << fmt::format("  \"measured_seconds\": {},\n", wall);
+    out << fmt::format("  \"events_per_second\": {},\n", rate);
+    out << fmt::format("  \"cpu_efficiency\": {},\n", efficiency);
+    out << fmt::format("  \"peak_rss_mb\": {},\n", peak_rss);
+    out << fmt::format("  \"startup_seconds\": {},\n", m_startup_seconds);
+
+    out << "  \"startup_phases\": [";
+    const auto phases = eicrecon::StartupProfile::instance().phases();
+    for (std::size_t i = 0; i < phases.size(); ++i) {
+        out << fmt::format("{}\n    {{\"phase\": \"{}\", \"calls\": {}, \"self_seconds\": {}, \"total_seconds\": {}}}",
+                           i == 0 ? "" : ",", Escape(phases[i].phase), phases[i].calls, phases[i].self_ns * 1e-9,
+                           phases[i].total_ns * 1e-9);
+    }
+    out << "\n  ],\n";
+
+    // the factory time per measured event, ranked
+    std::vector<std::pair<std::string, eicrecon::JOmniFactoryMetrics::Totals>> ranked;
+    for (const auto& [prefix, totals] : factories) {
+        auto delta = totals;
+        if (auto it = m_start.factories.find(prefix); it != m_start.factories.end()) {
+            delta.calls -= it->second.calls;
+            delta.wall_ns -= it->second.wall_ns;
+            delta.cpu_ns -= it->second.cpu_ns;
+        }
+        ranked.emplace_back(prefix, delta);
+    }
+    std::sort(ranked.begin(), ranked.end(),
+              [](const auto& a, const auto& b) { return a.second.wall_ns > b.second.wall_ns; });
+    const double per_event = 1e-6 / std::max<std::uint64_t>(measured, 1);
+    out << "  \"factories\": [";
+    for (std::size_t i = 0; i < ranked.size(); ++i) {
+        const auto& [prefix, t] = ranked[i];
+        out << fmt::format("{}\n    {{\"factory\": \"{}\", \"calls\": {}, \"wall_ms_per_event\": {}, \"cpu_ms_per_event\": {}}}",
+                           i == 0 ? "" : ",", Escape(prefix), t.calls, t.wall_ns * per_event, t.cpu_ns * per_event);
+    }
+    out << "\n  ]\n}\n";
+
+    if (!out) {
+        m_log->error("Can not write the throughput report to {}", m_report_file);
+        return;
+    }
+    m_log->info("{} events/s over {} events ({} threads, CPU efficiency {:.1f}%), startup {:.2f} s, peak RSS {:.1f} MB",
+                rate, measured, nthreads, 100 * efficiency, m_startup_seconds, peak_rss);
+    m_log->info("Throughput report written to {}", m_report_file);
+}
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JEvent.h>
+#include <JANA/JEventProcessor.h>
+#include <JANA/Utils/JTypeInfo.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "extensions/jana/JOmniFactoryMetrics.h"
+#include "extensions/spdlog/SpdlogMixin.h"
+
+/**
+ * Compute performance of a reconstruction job, written as a JSON report to
+ * `throughput:report_file` at the end of the job: the events/s after the
+ * first `throughput:warmup_events`, the time of every factory per event,
+ * the peak RSS, the startup time and the startup phases of StartupProfile.
+ *
+ * The sample and the configuration that the report is for are given by
+ * `throughput:sample` and `throughput:configuration`, and the version of
+ * the code by `throughput:label`, so that the reports of two commits can be
+ * compared by eicthroughput.py, which also runs the standard matrix.
+ */
+class ThroughputBenchmark_processor : public JEventProcessor, public eicrecon::SpdlogMixin {
+public:
+    ThroughputBenchmark_processor() { SetTypeName(NAME_OF_THIS); }
+
+    void Init() override;
+    void Process(const std::shared_ptr<const JEvent>& event) override;
+    void Finish() override;
+
+private:
+    /// State of the process when the measurement starts
+    struct Snapshot {
+        std::uint64_t events{0};
+        std::chrono::steady_clock::time_point wall;
+        double cpu_seconds{0};
+        std::map<std::string, eicrecon::JOmniFactoryMetrics::Totals> factories;
+    };
+    Snapshot TakeSnapshot(std::uint64_t events) const;
+
+    std::string m_report_file{"throughput.json"};
+    std::string m_sample;
+    std::string m_configuration;
+    std::string m_label;
+    std::uint64_t m_warmup_events{10};
+
+    std::atomic<std::uint64_t> m_events{0};
+    std::atomic<std::chrono::steady_clock::rep> m_last_event{0};
+    double m_startup_seconds{0};
+    std::mutex m_mutex;
+    Snapshot m_start;
+};
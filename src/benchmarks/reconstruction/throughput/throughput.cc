@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <JANA/JApplication.h>
+#include <JANA/Services/JParameterManager.h>
+
+#include "ThroughputBenchmark_processor.h"
+
+extern "C" {
+    void InitPlugin(JApplication *app) {
+        InitJANAPlugin(app);
+        auto* params = app->GetJParameterManager();
+        if (!params->Exists("omnifactory:MetricsFile")) {
+            // enables the per-factory counters, before the factories are initialised
+            params->SetParameter("omnifactory:MetricsFile", "throughput_factories.json");
+        }
+        app->Add(new ThroughputBenchmark_processor());
+    }
+}
@@ -10,15 +10,16 @@
 #include <fmt/core.h>
 #include <podio/RelationRange.h>
 #include <spdlog/logger.h>
+#include <array>
 #include <cmath>
 #include <vector>
 
 #include "services/rootfile/RootFile_service.h"
 
 //-------------------------------------------
-// InitWithGlobalRootLock
+// Init
 //-------------------------------------------
-void TofEfficiency_processor::InitWithGlobalRootLock(){
+void TofEfficiency_processor::Init(){
     std::string plugin_name=("tof_efficiency");
 
     InitLogger(GetApplication(), plugin_name);
@@ -30,10 +31,9 @@ void TofEfficiency_processor::InitWithGlobalRootLock(){
     auto root_file_service = app->GetService<RootFile_service>();
 
     // Get TDirectory for histograms root file
-    auto globalRootLock = app->GetService<JGlobalRootLock>();
-    globalRootLock->acquire_write_lock();
+    m_root_lock = app->GetService<JGlobalRootLock>();
+    m_root_lock->acquire_write_lock();
     auto *file = root_file_service->GetHistFile();
-    globalRootLock->release_lock();
 
     // Create a directory for this plugin. And subdirectories for series of histograms
     m_dir_main = file->mkdir(plugin_name.c_str());
@@ -45,19 +45,23 @@ void TofEfficiency_processor::InitWithGlobalRootLock(){
     auto r_limit_min = 50;
     auto r_limit_max = 675;
 
-    m_th2_btof_phiz = new TH2F("btof_phiz", "Hit position for Barrel TOF", 100, phi_limit_min, phi_limit_max, 100, z_limit_min, z_limit_max);
-    m_th2_ftof_rphi = new TH2F("ftof_rphi", "Hit position for Forward TOF", 100, r_limit_min, r_limit_max, 100, phi_limit_min, phi_limit_max);
-    m_th2_btof_phiz->SetDirectory(m_dir_main);
-    m_th2_ftof_rphi->SetDirectory(m_dir_main);
+    auto *th2_btof_phiz = new TH2F("btof_phiz", "Hit position for Barrel TOF", 100, phi_limit_min, phi_limit_max, 100, z_limit_min, z_limit_max);
+    auto *th2_ftof_rphi = new TH2F("ftof_rphi", "Hit position for Forward TOF", 100, r_limit_min, r_limit_max, 100, phi_limit_min, phi_limit_max);
+    th2_btof_phiz->SetDirectory(m_dir_main);
+    th2_ftof_rphi->SetDirectory(m_dir_main);
 
     m_tntuple_track = new TNtuple("track","track with tof","det:proj_x:proj_y:proj_z:proj_pathlength:tofhit_x:tofhit_y:tofhit_z:tofhit_t:tofhit_dca");
     m_tntuple_track->SetDirectory(m_dir_main);
+    m_root_lock->release_lock();
+
+    m_th2_btof_phiz = root_file_service->MakeThreadLocal(th2_btof_phiz);
+    m_th2_ftof_rphi = root_file_service->MakeThreadLocal(th2_ftof_rphi);
 }
 
 //-------------------------------------------
-// ProcessSequential
+// Process
 //-------------------------------------------
-void TofEfficiency_processor::ProcessSequential(const std::shared_ptr<const JEvent>& event) {
+void TofEfficiency_processor::Process(const std::shared_ptr<const JEvent>& event) {
     const auto &mcParticles   = *(event->GetCollection<edm4hep::MCParticle>("MCParticles"));
     const auto &trackSegments = *(event->GetCollection<edm4eic::TrackSegment>("CentralTrackSegments"));
     const auto &barrelHits    = *(event->GetCollection<edm4eic::TrackerHit>("TOFBarrelRecHit"));
@@ -70,7 +74,7 @@ void TofEfficiency_processor::ProcessSequential(const std::shared_ptr<const JEve
         const auto& pos = hit.getPosition();
         float r=sqrt(pos.x*pos.x+pos.y*pos.y);
         float phi=acos(pos.x/r); if(pos.y<0) phi+=3.1415927;
-        m_th2_btof_phiz->Fill(phi, pos.z);
+        m_th2_btof_phiz->Get()->Fill(phi, pos.z);
         m_log->trace("   {:>10.2f} {:>10.2f} {:>10.2f} {:>10.4f}", pos.x, pos.y, pos.z, hit.getTime());
     }
 
@@ -81,11 +85,12 @@ void TofEfficiency_processor::ProcessSequential(const std::shared_ptr<const JEve
         const auto& pos = hit.getPosition();
         float r=sqrt(pos.x*pos.x+pos.y*pos.y);
         float phi=acos(pos.x/r); if(pos.y<0) phi+=3.1415927;
-        m_th2_ftof_rphi->Fill(r, phi);
+        m_th2_ftof_rphi->Get()->Fill(r, phi);
         m_log->trace("   {:>10.2f} {:>10.2f} {:>10.2f} {:>10.4f}", pos.x, pos.y, pos.z, hit.getTime());
     }
 
-    // Now go through reconstructed tracks points
+    // Now go through reconstructed tracks points, the rows of the ntuple are filled at once with the root lock
+    std::vector<std::array<float, 10>> track_rows;
     logger()->trace("Going over tracks:");
     m_log->trace("   {:>10} {:>10} {:>10} {:>10}", "[x]", "[y]", "[z]", "[length]");
     for( const auto track_segment : trackSegments ){
@@ -125,15 +130,21 @@ void TofEfficiency_processor::ProcessSequential(const std::shared_ptr<const JEve
                     }
                 }
             }
-            if(det!=0) m_tntuple_track->Fill(det, pos.x, pos.y, pos.z, point.pathlength, hit_x, hit_y, hit_z, hit_t, distance_closest);
+            if(det!=0) track_rows.push_back({static_cast<float>(det), pos.x, pos.y, pos.z, point.pathlength, hit_x, hit_y, hit_z, hit_t, distance_closest});
         }
     }
+
+    if(!track_rows.empty()) {
+        m_root_lock->acquire_write_lock();
+        for(const auto& row : track_rows) m_tntuple_track->Fill(row.data());
+        m_root_lock->release_lock();
+    }
 }
 
 //-------------------------------------------
-// FinishWithGlobalRootLock
+// Finish
 //-------------------------------------------
-void TofEfficiency_processor::FinishWithGlobalRootLock() {
+void TofEfficiency_processor::Finish() {
 
     // Do any final calculations here.
 
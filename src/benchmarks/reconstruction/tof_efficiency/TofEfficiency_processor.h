@@ -4,7 +4,8 @@
 //
 
 #include <JANA/JEvent.h>
-#include <JANA/JEventProcessorSequentialRoot.h>
+#include <JANA/JEventProcessor.h>
+#include <JANA/Services/JGlobalRootLock.h>
 #include <JANA/Utils/JTypeInfo.h>
 #include <TDirectory.h>
 #include <TH1.h>
@@ -15,8 +16,9 @@
 #include <string>
 
 #include "extensions/spdlog/SpdlogMixin.h"
+#include "services/rootfile/ThreadLocalHist.h"
 
-class TofEfficiency_processor: public JEventProcessorSequentialRoot, public eicrecon::SpdlogMixin  {
+class TofEfficiency_processor: public JEventProcessor, public eicrecon::SpdlogMixin  {
 private:
 
     // Containers for histograms
@@ -26,15 +28,17 @@ private:
 public:
     TofEfficiency_processor() { SetTypeName(NAME_OF_THIS); }
 
-    void InitWithGlobalRootLock() override;
-    void ProcessSequential(const std::shared_ptr<const JEvent>& event) override;
-    void FinishWithGlobalRootLock() override;
+    void Init() override;
+    void Process(const std::shared_ptr<const JEvent>& event) override;
+    void Finish() override;
 
     int IsTOFHit(float x, float y, float z);
 
     TDirectory *m_dir_main;
 
-    TH2F * m_th2_btof_phiz;
-    TH2F * m_th2_ftof_rphi;
+    // filled by the worker threads without the root lock
+    std::shared_ptr<eicrecon::ThreadLocalHist<TH2F>> m_th2_btof_phiz;
+    std::shared_ptr<eicrecon::ThreadLocalHist<TH2F>> m_th2_ftof_rphi;
     TNtuple * m_tntuple_track;
+    std::shared_ptr<JGlobalRootLock> m_root_lock;
 };
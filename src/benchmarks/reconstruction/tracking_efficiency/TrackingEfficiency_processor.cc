@@ -9,6 +9,7 @@
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/PxPyPzM4D.h>
 #include <Rtypes.h>
+#include <edm4eic/MCRecoParticleAssociationCollection.h>
 #include <edm4eic/ReconstructedParticleCollection.h>
 #include <edm4hep/MCParticleCollection.h>
 #include <edm4hep/Vector3f.h>
@@ -23,6 +24,7 @@
 #include <string>
 #include <vector>
 
+#include "algorithms/interfaces/AssociationIndex.h"
 #include "services/log/Log_service.h"
 #include "services/rootfile/RootFile_service.h"
 
@@ -51,11 +53,30 @@ void TrackingEfficiency_processor::Init()
     auto globalRootLock = app->GetService<JGlobalRootLock>();
     globalRootLock->acquire_write_lock();
     auto *file = root_file_service->GetHistFile();
-    globalRootLock->release_lock();
 
     // Create a directory for this plugin. And subdirectories for series of histograms
     m_dir_main = file->mkdir(plugin_name.c_str());
 
+    auto *th1_prt_pz = new TH1F("prt_pz", "MC Particles P_{z};p_{z} [GeV]", 200, -50, 50);
+    auto *th1_prt_energy = new TH1F("prt_energy", "MC Particles E;E [GeV]", 200, 0, 50);
+    auto *th1_prt_theta = new TH1F("prt_theta", "MC Particles #theta;#theta [rad]", 200, 0, M_PI);
+    auto *th1_prt_phi = new TH1F("prt_phi", "MC Particles #phi;#phi [rad]", 200, -M_PI, M_PI);
+    auto *th2_prt_pxy = new TH2F("prt_pxy", "MC Particles P_{x} vs P_{y};p_{x} [GeV];p_{y} [GeV]", 200, -10, 10, 200, -10, 10);
+    auto *th1_match_pz = new TH1F("match_pz", "MC Particles with a reconstructed track P_{z};p_{z} [GeV]", 200, -50, 50);
+    auto *th1_match_theta = new TH1F("match_theta", "MC Particles with a reconstructed track #theta;#theta [rad]", 200, 0, M_PI);
+    for (TH1 *hist : std::vector<TH1*>{th1_prt_pz, th1_prt_energy, th1_prt_theta, th1_prt_phi, th2_prt_pxy, th1_match_pz, th1_match_theta}) {
+        hist->SetDirectory(m_dir_main);
+    }
+    globalRootLock->release_lock();
+
+    m_th1_prt_pz = root_file_service->MakeThreadLocal(th1_prt_pz);
+    m_th1_prt_energy = root_file_service->MakeThreadLocal(th1_prt_energy);
+    m_th1_prt_theta = root_file_service->MakeThreadLocal(th1_prt_theta);
+    m_th1_prt_phi = root_file_service->MakeThreadLocal(th1_prt_phi);
+    m_th2_prt_pxy = root_file_service->MakeThreadLocal(th2_prt_pxy);
+    m_th1_match_pz = root_file_service->MakeThreadLocal(th1_match_pz);
+    m_th1_match_theta = root_file_service->MakeThreadLocal(th1_match_theta);
+
     // Get logger
     m_log = app->GetService<Log_service>()->logger(plugin_name);
 }
@@ -129,8 +150,10 @@ void TrackingEfficiency_processor::Process(const std::shared_ptr<const JEvent>&
 
 
     // EXAMPLE III
-    // Loop over MC particles
+    // Loop over MC particles, matched to the reconstructed charged particles through the
+    // association index that is shared by all its consumers of the event
     auto mc_particles = event->Get<edm4hep::MCParticle>("MCParticles");
+    auto assoc_index = event->Get<eicrecon::AssociationLookup<edm4eic::MCRecoParticleAssociationCollection>>("ReconstructedChargedParticleAssociationIndex");
     m_log->debug("MC particles N={}: ", mc_particles.size());
     m_log->debug("   {:<5} {:<6} {:<7} {:>8} {:>8} {:>8} {:>8}","[i]", "status", "[PDG]",  "[px]", "[py]", "[pz]", "[P]");
     for(size_t i=0; i < mc_particles.size(); i++) {
@@ -147,6 +170,17 @@ void TrackingEfficiency_processor::Process(const std::shared_ptr<const JEvent>&
         if(p.R()<1) continue;
 
         m_log->debug("   {:<5} {:<6} {:<7} {:>8.2f} {:>8.2f} {:>8.2f} {:>8.2f}", i, particle->getGeneratorStatus(), particle->getPDG(),  px, py, pz, p.R());
+
+        m_th1_prt_pz->Get()->Fill(pz);
+        m_th1_prt_energy->Get()->Fill(p4v.E());
+        m_th1_prt_theta->Get()->Fill(p.Theta());
+        m_th1_prt_phi->Get()->Fill(p.Phi());
+        m_th2_prt_pxy->Get()->Fill(px, py);
+
+        if(!assoc_index.empty() && assoc_index.front()->by_sim.first(*particle)) {
+            m_th1_match_pz->Get()->Fill(pz);
+            m_th1_match_theta->Get()->Fill(p.Theta());
+        }
     }
 }
 
@@ -9,6 +9,8 @@
 #include <spdlog/fwd.h>
 #include <memory>
 
+#include "services/rootfile/ThreadLocalHist.h"
+
 class TrackingEfficiency_processor:public JEventProcessor
 {
 public:
@@ -44,11 +46,15 @@ public:
 private:
 
     TDirectory* m_dir_main;               /// Main TDirectory for this plugin 'occupancy_ana'
-    TH1F * m_th1_prt_pz;                  /// MC Particles pz
-    TH1F * m_th1_prt_energy;              /// MC Particles total E
-    TH1F * m_th1_prt_theta;               /// MC Particles theta angle
-    TH1F * m_th1_prt_phi;                 /// MC Particles phi angle
-    TH2F * m_th2_prt_pxy;                 /// MC Particles px,py
+
+    // filled by the worker threads without the root lock, merged when the file is written
+    std::shared_ptr<eicrecon::ThreadLocalHist<TH1F>> m_th1_prt_pz;        /// MC Particles pz
+    std::shared_ptr<eicrecon::ThreadLocalHist<TH1F>> m_th1_prt_energy;    /// MC Particles total E
+    std::shared_ptr<eicrecon::ThreadLocalHist<TH1F>> m_th1_prt_theta;     /// MC Particles theta angle
+    std::shared_ptr<eicrecon::ThreadLocalHist<TH1F>> m_th1_prt_phi;       /// MC Particles phi angle
+    std::shared_ptr<eicrecon::ThreadLocalHist<TH2F>> m_th2_prt_pxy;       /// MC Particles px,py
+    std::shared_ptr<eicrecon::ThreadLocalHist<TH1F>> m_th1_match_pz;      /// MC Particles with a reconstructed track, pz
+    std::shared_ptr<eicrecon::ThreadLocalHist<TH1F>> m_th1_match_theta;   /// MC Particles with a reconstructed track, theta angle
 
     std::shared_ptr<spdlog::logger> m_log;
 };
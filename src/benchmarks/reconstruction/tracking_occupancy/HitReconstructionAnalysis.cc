@@ -13,35 +13,41 @@
 #include <memory>
 
 #include "HitReconstructionAnalysis.h"
+#include "services/rootfile/RootFile_service.h"
 
 void HitReconstructionAnalysis::init(JApplication *app, TDirectory *plugin_tdir) {
 
     auto *dir = plugin_tdir->mkdir("RecOccupancies");     // TODO create directory for this analysis
 
+    // filled by the worker threads without the root lock, merged when the file is written
+    auto root_file_service = app->GetService<RootFile_service>();
+
     auto z_limit_min = -2000;
     auto z_limit_max = 2000;
     auto r_limit_min = 0;
     auto r_limit_max = 1200;
 
-    m_total_occup_th2 = new TH2F("total_occup", "Occupancy plot for all readouts", 200, z_limit_min, +z_limit_max, 100, r_limit_min, r_limit_max);
-    m_total_occup_th2->SetDirectory(dir);
+    auto *total_occup_th2 = new TH2F("total_occup", "Occupancy plot for all readouts", 200, z_limit_min, +z_limit_max, 100, r_limit_min, r_limit_max);
+    total_occup_th2->SetDirectory(dir);
+    m_total_occup_th2 = root_file_service->MakeThreadLocal(total_occup_th2);
 
     for(auto &name: m_data_names) {
-        auto count_hist = std::make_shared<TH1F>(("count_" + name).c_str(), ("Count hits for " + name).c_str(), 100, 0, 30);
+        auto *count_hist = new TH1F(("count_" + name).c_str(), ("Count hits for " + name).c_str(), 100, 0, 30);
         count_hist->SetDirectory(dir);
-        m_hits_count_hists.push_back(count_hist);
+        m_hits_count_hists.push_back(root_file_service->MakeThreadLocal(count_hist));
 
-        auto occup_hist = std::make_shared<TH2F>(("occup_" + name).c_str(), ("Occupancy plot for" + name).c_str(), 100, z_limit_min, z_limit_max, 200, r_limit_min, r_limit_max);
+        auto *occup_hist = new TH2F(("occup_" + name).c_str(), ("Occupancy plot for" + name).c_str(), 100, z_limit_min, z_limit_max, 200, r_limit_min, r_limit_max);
         occup_hist->SetDirectory(dir);
-        m_hits_occup_hists.push_back(occup_hist);
+        m_hits_occup_hists.push_back(root_file_service->MakeThreadLocal(occup_hist));
     }
 }
 
 void HitReconstructionAnalysis::process(const std::shared_ptr<const JEvent> &event) {
     for(size_t name_index = 0; name_index < m_data_names.size(); name_index++ ) {
         std::string data_name = m_data_names[name_index];
-        auto &count_hist = m_hits_count_hists[name_index];
-        auto &occup_hist = m_hits_occup_hists[name_index];
+        auto *count_hist = m_hits_count_hists[name_index]->Get();
+        auto *occup_hist = m_hits_occup_hists[name_index]->Get();
+        auto *total_occup_th2 = m_total_occup_th2->Get();
 
         try {
             auto hits = event->Get<edm4eic::TrackerHit>(data_name);
@@ -52,7 +58,7 @@ void HitReconstructionAnalysis::process(const std::shared_ptr<const JEvent> &eve
                 float z = hit->getPosition().z;
                 float r = sqrt(x*x + y*y);
                 occup_hist->Fill(z, r);
-                m_total_occup_th2->Fill(z, r);
+                total_occup_th2->Fill(z, r);
             }
         } catch(std::exception& e) {
             // silently skip missing collections
@@ -36,7 +36,7 @@ extern "C" {
         decltype(CalorimeterHitDigiConfig::resolutionTDC) EcalBarrelScFi_resolutionTDC = 10 * dd4hep::picosecond;
         app->Add(new JOmniFactoryGeneratorT<CalorimeterHitDigi_factory>(
            "EcalBarrelScFiRawHits",
-           {"EcalBarrelScFiHits"},
+           {"EventHeader", "EcalBarrelScFiHits"},
            {"EcalBarrelScFiRawHits"},
            {
              .eRes = {0.0 * sqrt(dd4hep::GeV), 0.0, 0.0 * dd4hep::GeV},
@@ -111,7 +111,7 @@ extern "C" {
         decltype(CalorimeterHitDigiConfig::resolutionTDC) EcalBarrelImaging_resolutionTDC = 3.25 * dd4hep::nanosecond;
         app->Add(new JOmniFactoryGeneratorT<CalorimeterHitDigi_factory>(
            "EcalBarrelImagingRawHits",
-          {"EcalBarrelImagingHits"},
+          {"EventHeader", "EcalBarrelImagingHits"},
           {"EcalBarrelImagingRawHits"},
           {
              .eRes = {0.0 * sqrt(dd4hep::GeV), 0.02, 0.0 * dd4hep::GeV},
@@ -88,7 +88,7 @@ extern "C" {
         }
 
         app->Add(new JOmniFactoryGeneratorT<CalorimeterHitDigi_factory>(
-          "HcalBarrelRawHits", {"HcalBarrelHits"}, {"HcalBarrelRawHits"},
+          "HcalBarrelRawHits", {"EventHeader", "HcalBarrelHits"}, {"HcalBarrelRawHits"},
           {
             .eRes = {},
             .tRes = 0.0 * dd4hep::ns,
@@ -17,9 +17,11 @@
 #include <vector>
 
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "algorithms/pid_lut/PIDLookupConfig.h"
 #include "extensions/jana/JOmniFactoryGeneratorT.h"
 #include "factories/digi/SiliconTrackerDigi_factory.h"
 #include "factories/tracking/TrackerHitReconstruction_factory.h"
+#include "global/pid_lut/PIDLookupTables.h"
 #include "global/pid_lut/PIDLookup_factory.h"
 #include "services/geometry/dd4hep/DD4hep_service.h"
 
@@ -65,8 +67,10 @@ void InitPlugin(JApplication *app) {
         // Nothing
     }
     for (auto qualifier : std::vector<std::string>({"", "Seeded"})) {
+        const std::string tag = fmt::format("CombinedTOF{}LUTPID", qualifier);
+        const PIDLookupConfig lut_cfg = BTOFLookupConfig(BarrelTOF_ID);
         app->Add(new JOmniFactoryGeneratorT<PIDLookup_factory>(
-              fmt::format("CombinedTOF{}LUTPID", qualifier),
+              tag,
               {
               fmt::format("Reconstructed{}ChargedWithPFRICHPIDParticles", qualifier),
               fmt::format("Reconstructed{}ChargedWithPFRICHPIDParticleAssociations", qualifier),
@@ -76,19 +80,10 @@ void InitPlugin(JApplication *app) {
               fmt::format("Reconstructed{}ChargedWithPFRICHTOFPIDParticleAssociations", qualifier),
               fmt::format("CombinedTOF{}ParticleIDs", qualifier),
               },
-              {
-                .filename="calibrations/tof.lut",
-                .system=BarrelTOF_ID,
-                .pdg_values={11, 211, 321, 2212},
-                .charge_values={1},
-                .momentum_edges={0.0, 0.3, 0.6, 0.9, 1.2, 1.5, 1.8, 2.1, 2.4, 2.7, 3.0, 3.3, 3.6, 3.9, 4.2, 4.5, 4.8, 5.1, 5.4, 5.7, 6.0},
-                .polar_edges={2.50, 10.95, 19.40, 27.85, 36.30, 44.75, 53.20, 61.65, 70.10, 78.55, 87.00, 95.45, 103.90, 112.35, 120.80, 129.25, 137.70, 146.15, 154.60},
-                .azimuthal_binning={0., 360., 360.}, // lower, upper, step
-                .momentum_bin_centers_in_lut=true,
-                .polar_bin_centers_in_lut=true,
-              },
+              lut_cfg,
               app
               ));
+        PreloadPIDLookupTable(app, tag, lut_cfg);
     }
 
 }
@@ -30,6 +30,7 @@ void InitPlugin(JApplication *app) {
         },
         {
             .threshold = 0.54 * dd4hep::keV,
+            .readout = "SiBarrelHits",
         },
         app
     ));
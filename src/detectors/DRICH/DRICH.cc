@@ -23,6 +23,7 @@
 #include "algorithms/digi/PhotoMultiplierHitDigiConfig.h"
 #include "algorithms/pid/IrtCherenkovParticleIDConfig.h"
 #include "algorithms/pid/MergeParticleIDConfig.h"
+#include "algorithms/pid_lut/PIDLookupConfig.h"
 #include "algorithms/tracking/TrackPropagationConfig.h"
 #include "extensions/jana/JOmniFactoryGeneratorT.h"
 // factories
@@ -31,6 +32,7 @@
 #include "global/pid/MergeCherenkovParticleID_factory.h"
 #include "global/pid/MergeTrack_factory.h"
 #include "global/pid/RichTrack_factory.h"
+#include "global/pid_lut/PIDLookupTables.h"
 #include "global/pid_lut/PIDLookup_factory.h"
 #include "services/geometry/dd4hep/DD4hep_service.h"
 #include "services/geometry/richgeo/ActsGeo.h"
@@ -136,7 +138,7 @@ extern "C" {
     // digitization
     app->Add(new JOmniFactoryGeneratorT<PhotoMultiplierHitDigi_factory>(
           "DRICHRawHits",
-          {"DRICHHits"},
+          {"EventHeader", "DRICHHits"},
           {"DRICHRawHits", "DRICHRawHitsAssociations"},
           digi_cfg,
           app
@@ -196,8 +198,10 @@ extern "C" {
         // Nothing
     }
     for (auto qualifier : std::vector<std::string>({"", "Seeded"})) {
+        const std::string tag = fmt::format("DRICH{}LUTPID", qualifier);
+        const PIDLookupConfig lut_cfg = DRICHLookupConfig(ForwardRICH_ID);
         app->Add(new JOmniFactoryGeneratorT<PIDLookup_factory>(
-              fmt::format("DRICH{}LUTPID", qualifier),
+              tag,
               {
               fmt::format("Reconstructed{}ChargedWithPFRICHTOFDIRCPIDParticles", qualifier),
               fmt::format("Reconstructed{}ChargedWithPFRICHTOFDIRCPIDParticleAssociations", qualifier),
@@ -207,20 +211,10 @@ extern "C" {
               fmt::format("Reconstructed{}ChargedParticleAssociations", qualifier),
               fmt::format("DRICH{}ParticleIDs", qualifier),
               },
-              {
-                .filename="calibrations/drich.lut",
-                .system=ForwardRICH_ID,
-                .pdg_values={211, 321, 2212},
-                .charge_values={1},
-                .momentum_edges={0.25, 0.75, 1.25, 1.75, 2.25, 2.75, 3.25, 3.75, 4.25, 4.75, 5.25, 5.75, 6.25, 6.75, 7.25, 7.75, 8.25, 8.75, 9.25, 9.75, 10.25, 10.75, 11.25, 11.75, 12.25, 12.75, 13.25, 13.75, 14.25, 14.75, 15.25, 15.75, 16.25, 16.75, 17.25, 17.75, 18.25, 18.75, 19.25, 19.75, 20.50, 21.50, 22.50, 23.50, 24.50, 25.50, 26.50, 27.50, 28.50, 29.50, 30.50},
-                .polar_edges={0.060, 0.164, 0.269, 0.439},
-                .azimuthal_binning={0., 2 * M_PI, 2 * M_PI}, // lower, upper, step
-                .polar_bin_centers_in_lut=true,
-                .use_radians=true,
-                .missing_electron_prob=true,
-              },
+              lut_cfg,
               app
               ));
+        PreloadPIDLookupTable(app, tag, lut_cfg);
     }
     // clang-format on
   }
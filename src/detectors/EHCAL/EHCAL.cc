@@ -8,8 +8,11 @@
 #include <string>
 
 #include "algorithms/calorimetry/CalorimeterHitDigiConfig.h"
+#include "algorithms/calorimetry/CalorimeterHitRecoConfig.h"
+#include "algorithms/calorimetry/CalorimeterHitsMergerConfig.h"
 #include "extensions/jana/JOmniFactoryGeneratorT.h"
 #include "factories/calorimetry/CalorimeterClusterRecoCoG_factory.h"
+#include "factories/calorimetry/CalorimeterFrontEnd_factory.h"
 #include "factories/calorimetry/CalorimeterHitDigi_factory.h"
 #include "factories/calorimetry/CalorimeterHitReco_factory.h"
 #include "factories/calorimetry/CalorimeterHitsMerger_factory.h"
@@ -29,9 +32,7 @@ extern "C" {
         decltype(CalorimeterHitDigiConfig::pedSigmaADC)   HcalEndcapN_pedSigmaADC = 2;
         decltype(CalorimeterHitDigiConfig::resolutionTDC) HcalEndcapN_resolutionTDC = 10 * dd4hep::picosecond;
 
-        app->Add(new JOmniFactoryGeneratorT<CalorimeterHitDigi_factory>(
-          "HcalEndcapNRawHits", {"HcalEndcapNHits"}, {"HcalEndcapNRawHits"},
-          {
+        CalorimeterHitDigiConfig HcalEndcapN_digi_cfg {
             .tRes = 0.0 * dd4hep::ns,
             .capADC = HcalEndcapN_capADC,
             .capTime = 100, // given in ns, 4 samples in HGCROC
@@ -41,12 +42,8 @@ extern "C" {
             .resolutionTDC = HcalEndcapN_resolutionTDC,
             .corrMeanScale = "1.0",
             .readout = "HcalEndcapNHits",
-          },
-          app   // TODO: Remove me once fixed
-        ));
-        app->Add(new JOmniFactoryGeneratorT<CalorimeterHitReco_factory>(
-          "HcalEndcapNRecHits", {"HcalEndcapNRawHits"}, {"HcalEndcapNRecHits"},
-          {
+        };
+        CalorimeterHitRecoConfig HcalEndcapN_reco_cfg {
             .capADC = HcalEndcapN_capADC,
             .dyRangeADC = HcalEndcapN_dyRangeADC,
             .pedMeanADC = HcalEndcapN_pedMeanADC,
@@ -56,18 +53,43 @@ extern "C" {
             .thresholdValue = 41.0, // 0.1875 MeV deposition out of 200 MeV max (per layer) --> adc = 10 + 0.1875 / 200 * 32768 == 41
             .sampFrac = "0.0095", // from latest study - implement at level of reco hits rather than clusters
             .readout = "HcalEndcapNHits",
-          },
-          app   // TODO: Remove me once fixed
-        ));
-        app->Add(new JOmniFactoryGeneratorT<CalorimeterHitsMerger_factory>(
-          "HcalEndcapNMergedHits", {"HcalEndcapNRecHits"}, {"HcalEndcapNMergedHits"},
-          {
+        };
+        CalorimeterHitsMergerConfig HcalEndcapN_merge_cfg {
             .readout = "HcalEndcapNHits",
             .fields = {"layer", "slice"},
             .refs = {4, 0}, // place merged hits at ~1 interaction length deep
-          },
-          app   // TODO: Remove me once fixed
-        ));
+        };
+
+        bool HcalEndcapN_fused_front_end = false;
+        app->SetDefaultParameter("HcalEndcapN:fused_front_end", HcalEndcapN_fused_front_end,
+                                 "Make HcalEndcapNMergedHits and HcalEndcapNRawHits in one factory, without HcalEndcapNRecHits (its parameters are then those of HcalEndcapNMergedHits)");
+        if (HcalEndcapN_fused_front_end) {
+          app->Add(new JOmniFactoryGeneratorT<CalorimeterFrontEnd_factory>(
+            "HcalEndcapNMergedHits", {"EventHeader", "HcalEndcapNHits"}, {"HcalEndcapNMergedHits", "HcalEndcapNRawHits"},
+            {
+              .digi = HcalEndcapN_digi_cfg,
+              .reco = HcalEndcapN_reco_cfg,
+              .merge = HcalEndcapN_merge_cfg,
+            },
+            app   // TODO: Remove me once fixed
+          ));
+        } else {
+          app->Add(new JOmniFactoryGeneratorT<CalorimeterHitDigi_factory>(
+            "HcalEndcapNRawHits", {"EventHeader", "HcalEndcapNHits"}, {"HcalEndcapNRawHits"},
+            HcalEndcapN_digi_cfg,
+            app   // TODO: Remove me once fixed
+          ));
+          app->Add(new JOmniFactoryGeneratorT<CalorimeterHitReco_factory>(
+            "HcalEndcapNRecHits", {"HcalEndcapNRawHits"}, {"HcalEndcapNRecHits"},
+            HcalEndcapN_reco_cfg,
+            app   // TODO: Remove me once fixed
+          ));
+          app->Add(new JOmniFactoryGeneratorT<CalorimeterHitsMerger_factory>(
+            "HcalEndcapNMergedHits", {"HcalEndcapNRecHits"}, {"HcalEndcapNMergedHits"},
+            HcalEndcapN_merge_cfg,
+            app   // TODO: Remove me once fixed
+          ));
+        }
         app->Add(new JOmniFactoryGeneratorT<CalorimeterTruthClustering_factory>(
           "HcalEndcapNTruthProtoClusters", {"HcalEndcapNMergedHits", "HcalEndcapNHits"}, {"HcalEndcapNTruthProtoClusters"},
           app   // TODO: Remove me once fixed
@@ -74,7 +74,7 @@ extern "C" {
       }
     }
 
-    app->Add(new JOmniFactoryGeneratorT<SubDivideCollection_factory<edm4eic::RawTrackerHit>>(
+    app->Add(new JOmniFactoryGeneratorT<SubDivideCollection_factory<edm4eic::RawTrackerHit, GeometrySplit>>(
          "TaggerTrackerSplitHits",
          {"TaggerTrackerRawHits"},
          geometryDivisionCollectionNames,
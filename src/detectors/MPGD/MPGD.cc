@@ -31,6 +31,7 @@ void InitPlugin(JApplication *app) {
         {
             .threshold = 0.25 * dd4hep::keV,
             .timeResolution = 10,
+            .readout = "MPGDBarrelHits",
         },
         app
     ));
@@ -59,6 +60,7 @@ void InitPlugin(JApplication *app) {
         {
             .threshold = 0.25 * dd4hep::keV,
             .timeResolution = 10,
+            .readout = "OuterMPGDBarrelHits",
         },
         app
     ));
@@ -87,6 +89,7 @@ void InitPlugin(JApplication *app) {
         {
             .threshold = 0.25 * dd4hep::keV,
             .timeResolution = 10,
+            .readout = "BackwardMPGDEndcapHits",
         },
         app
     ));
@@ -115,6 +118,7 @@ void InitPlugin(JApplication *app) {
         {
             .threshold = 0.25 * dd4hep::keV,
             .timeResolution = 10,
+            .readout = "ForwardMPGDEndcapHits",
         },
         app
     ));
@@ -26,7 +26,7 @@ extern "C" {
 
         // LYSO part of the ZDC
         app->Add(new JOmniFactoryGeneratorT<CalorimeterHitDigi_factory>(
-          "EcalFarForwardZDCRawHits", {"EcalFarForwardZDCHits"}, {"EcalFarForwardZDCRawHits"},
+          "EcalFarForwardZDCRawHits", {"EventHeader", "EcalFarForwardZDCHits"}, {"EcalFarForwardZDCRawHits"},
           {
             .tRes = 0.0 * dd4hep::ns,
             .capADC = 32768,
@@ -108,7 +108,7 @@ extern "C" {
         );
 
         app->Add(new JOmniFactoryGeneratorT<CalorimeterHitDigi_factory>(
-          "HcalFarForwardZDCRawHits", {"HcalFarForwardZDCHits"}, {"HcalFarForwardZDCRawHits"},
+          "HcalFarForwardZDCRawHits", {"EventHeader", "HcalFarForwardZDCHits"}, {"HcalFarForwardZDCRawHits"},
           {
             .tRes = 0.0 * dd4hep::ns,
             .capADC = 32768,
@@ -13,18 +13,47 @@
 #include <JANA/CLI/JVersion.h>
 #include <JANA/JMultifactory.h>
 #include <JANA/JEvent.h>
+#include <JANA/Podio/JFactoryPodioT.h>
+#include <JANA/Utils/JCallGraphEntryMaker.h>
 #include <spdlog/spdlog.h>
 
+#include "algorithms/interfaces/CollectionColumns.h"
+#include "algorithms/interfaces/EventArena.h"
+#include "extensions/jana/JOmniFactoryExecutor.h"
+#include "extensions/jana/JOmniFactoryMetrics.h"
+#include "extensions/jana/JOmniFactoryPruning.h"
+#include "extensions/jana/JOmniFactoryReplay.h"
 #include "services/io/podio/datamodel_glue.h"
 #include "services/log/Log_service.h"
-
+#include "services/log/StartupProfile.h"
+#include "services/log/TraceRange.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
 #include <vector>
 
-struct EmptyConfig {};
+struct EmptyConfig {
+    bool operator==(const EmptyConfig&) const = default;
+};
+
+/// State shared by the factories of one wiring in all the factory sets, see JOmniFactory::Shared()
+struct JOmniFactorySharedSlot {
+    std::mutex mutex;
+    std::shared_ptr<void> state;
+    std::type_index type{typeid(void)};
+};
 
 template <typename AlgoT, typename ConfigT=EmptyConfig>
-class JOmniFactory : public JMultifactory {
+class JOmniFactory : public JMultifactory, public eicrecon::JOmniFactoryReplayable, public eicrecon::JOmniFactoryPrefetchable {
 public:
 
     /// ========================
@@ -37,12 +66,47 @@ public:
         bool is_variadic = false;
 
         virtual void GetCollection(const JEvent& event) = 0;
+        virtual size_t EntryCount() const = 0;
     };
 
+    /// Factory of an input collection, looked up by its name once per factory set instead of on
+    /// every event. The factory set of the events of a JOmniFactory is the one that it is in, so
+    /// in practice this is once per factory
+    template <typename T, typename FactoryT = JFactoryT<T>>
+    struct FactoryHandle {
+        const JFactorySet* factory_set = nullptr;
+        FactoryT* factory = nullptr;
+
+        FactoryT* Resolve(const JEvent& event, const std::string& tag) {
+            if (factory_set != event.GetFactorySet()) {
+                auto* found = event.GetFactory<T>(tag, true);
+                if constexpr (std::is_same_v<FactoryT, JFactoryT<T>>) {
+                    factory = found;
+                } else {
+                    factory = dynamic_cast<FactoryT*>(found);
+                    if (factory == nullptr) {
+                        throw JException("Factory must inherit from JFactoryPodioT in order to use JEvent::GetCollection()");
+                    }
+                }
+                factory_set = event.GetFactorySet();
+            }
+            return factory;
+        }
+    };
+
+    /// The collection of a resolved podio factory, as `JEvent::GetCollection()` without the lookup
+    template <typename PodioT>
+    static const typename PodioTypeMap<PodioT>::collection_t* GetPodioCollection(const JEvent& event, JFactoryPodioT<PodioT>* factory) {
+        JCallGraphEntryMaker cg_entry(*event.GetJCallGraphRecorder(), factory);
+        factory->CreateAndGetData(event.shared_from_this());
+        return static_cast<const typename PodioTypeMap<PodioT>::collection_t*>(factory->GetCollection());
+    }
+
     template <typename T>
     class Input : public InputBase {
 
-        std::vector<const T*> m_data;
+        FactoryHandle<T> m_factory;
+        std::span<const T* const> m_data;
 
     public:
         Input(JOmniFactory* owner, std::string default_tag="") {
@@ -51,20 +115,36 @@ public:
             this->type_name = JTypeInfo::demangle<T>();
         }
 
-        const std::vector<const T*>& operator()() { return m_data; }
+        /// The objects of the input, in the storage of the factory that produced them
+        std::span<const T* const> operator()() { return m_data; }
+
+        /// Object i of the input, throws std::out_of_range if there are not as many
+        const T* at(size_t i) const {
+            if (i >= m_data.size()) {
+                throw std::out_of_range("JOmniFactory: input '" + this->collection_names[0] + "' has " + std::to_string(m_data.size()) + " objects");
+            }
+            return m_data[i];
+        }
 
     private:
         friend class JOmniFactory;
 
         void GetCollection(const JEvent& event) {
-            m_data = event.Get<T>(this->collection_names[0]);
+            // as `JEvent::Get()`, without the lookup and the copy of the pointers
+            auto* factory = m_factory.Resolve(event, this->collection_names[0]);
+            JCallGraphEntryMaker cg_entry(*event.GetJCallGraphRecorder(), factory);
+            auto [begin, end] = factory->CreateAndGetData(event.shared_from_this());
+            m_data = std::span<const T* const>(std::to_address(begin), static_cast<size_t>(end - begin));
         }
+
+        size_t EntryCount() const override { return m_data.size(); }
     };
 
 
     template <typename PodioT>
     class PodioInput : public InputBase {
 
+        FactoryHandle<PodioT, JFactoryPodioT<PodioT>> m_factory;
         const typename PodioTypeMap<PodioT>::collection_t* m_data;
 
     public:
@@ -83,14 +163,17 @@ public:
         friend class JOmniFactory;
 
         void GetCollection(const JEvent& event) {
-            m_data = event.GetCollection<PodioT>(this->collection_names[0]);
+            m_data = GetPodioCollection<PodioT>(event, m_factory.Resolve(event, this->collection_names[0]));
         }
+
+        size_t EntryCount() const override { return m_data->size(); }
     };
 
 
     template <typename PodioT>
     class VariadicPodioInput : public InputBase {
 
+        std::vector<FactoryHandle<PodioT, JFactoryPodioT<PodioT>>> m_factories;
         std::vector<const typename PodioTypeMap<PodioT>::collection_t*> m_data;
 
     public:
@@ -102,7 +185,7 @@ public:
             this->is_variadic = true;
         }
 
-        const std::vector<const typename PodioTypeMap<PodioT>::collection_t*> operator()() {
+        const std::vector<const typename PodioTypeMap<PodioT>::collection_t*>& operator()() {
             return m_data;
         }
 
@@ -110,10 +193,19 @@ public:
         friend class JOmniFactory;
 
         void GetCollection(const JEvent& event) {
+            m_factories.resize(this->collection_names.size());
             m_data.clear();
-            for (auto& coll_name : this->collection_names) {
-                m_data.push_back(event.GetCollection<PodioT>(coll_name));
+            for (size_t i = 0; i < this->collection_names.size(); ++i) {
+                m_data.push_back(GetPodioCollection<PodioT>(event, m_factories[i].Resolve(event, this->collection_names[i])));
+            }
+        }
+
+        size_t EntryCount() const override {
+            size_t count = 0;
+            for (const auto* collection : m_data) {
+                count += collection->size();
             }
+            return count;
         }
     };
 
@@ -130,10 +222,29 @@ public:
         std::string type_name;
         std::vector<std::string> collection_names;
         bool is_variadic = false;
+        bool reserve_collections = false;
+        /// Whether the collections are podio collections, which can alias others, see omnifactory:MergeIdenticalWirings
+        bool is_podio = false;
+        /// Of every collection, see omnifactory:LazyOutputs
+        std::vector<bool> needed;
+
+        /// Whether collection i of the output is wanted downstream or by the podio writer.
+        /// An output that is not still has to be set, but may be left empty
+        bool IsNeeded(size_t i = 0) const { return i >= needed.size() || needed[i]; }
 
         virtual void CreateHelperFactory(JOmniFactory& fac) = 0;
         virtual void SetCollection(JOmniFactory& fac) = 0;
         virtual void Reset() = 0;
+        /// Drops the data that was not handed to JANA, for Replay()
+        virtual void Discard() = 0;
+        virtual size_t EntryCount() const = 0;
+        /// Requests the first collection of the output from the event, which runs the factory unless it already ran
+        virtual void Request(const JEvent& event) = 0;
+        /// Makes the collections subsets of all the objects of the collections of `tags`, in place of Process()
+        virtual void Alias(const JEvent& event, const std::vector<std::string>& tags) {
+            throw JException("JOmniFactory: output '%s' of type %s can not alias another collection",
+                             collection_names[0].c_str(), type_name.c_str());
+        }
     };
 
     template <typename T>
@@ -158,16 +269,55 @@ public:
 
         void SetCollection(JOmniFactory& fac) override {
             fac.SetData<T>(this->collection_names[0], this->m_data);
+            // owned by JANA from now on
+            this->m_data.clear();
         }
 
         void Reset() override { }
+
+        void Discard() override {
+            for (auto* data : m_data) {
+                delete data;
+            }
+            m_data.clear();
+        }
+
+        size_t EntryCount() const override { return m_data.size(); }
+
+        void Request(const JEvent& event) override { event.Get<T>(this->collection_names[0]); }
     };
 
 
+    /// Size to reserve for the collections of an output, with `<prefix>:ReserveOutputs`
+    ///
+    /// The collections are owned by the podio frame of the event once they
+    /// are set, so they can not be recycled. Instead the new collections of an
+    /// event get the capacity of the largest recent collection, which decays
+    /// by 1/8 per event, if the collection type supports `reserve()`.
+    class CapacityHint {
+        std::size_t m_capacity = 0;
+
+    public:
+        void Record(std::size_t size) {
+            m_capacity = std::max(size, m_capacity - m_capacity / 8);
+        }
+
+        template <typename CollectionT>
+        void Apply(CollectionT& collection) const {
+            if constexpr (requires { collection.reserve(m_capacity); }) {
+                if (m_capacity > 0) {
+                    collection.reserve(m_capacity);
+                }
+            }
+        }
+    };
+
     template <typename PodioT>
     class PodioOutput : public OutputBase {
 
         std::unique_ptr<typename PodioTypeMap<PodioT>::collection_t> m_data;
+        CapacityHint m_capacity_hint;
+        FactoryHandle<PodioT, JFactoryPodioT<PodioT>> m_aliased;
 
     public:
 
@@ -175,6 +325,7 @@ public:
             owner->RegisterOutput(this);
             this->collection_names.push_back(default_collection_name);
             this->type_name = JTypeInfo::demangle<PodioT>();
+            this->is_podio = true;
         }
 
         std::unique_ptr<typename PodioTypeMap<PodioT>::collection_t>& operator()() { return m_data; }
@@ -191,11 +342,32 @@ public:
                 throw JException("JOmniFactory: SetCollection failed due to missing output collection '%s'", this->collection_names[0].c_str());
                 // Otherwise this leads to a PODIO segfault
             }
+            if (this->reserve_collections) {
+                m_capacity_hint.Record(m_data->size());
+            }
             fac.SetCollection<PodioT>(this->collection_names[0], std::move(this->m_data));
         }
 
         void Reset() override {
             m_data = std::move(std::make_unique<typename PodioTypeMap<PodioT>::collection_t>());
+            if (this->reserve_collections) {
+                m_capacity_hint.Apply(*m_data);
+            }
+        }
+
+        void Discard() override { m_data.reset(); }
+
+        size_t EntryCount() const override { return m_data == nullptr ? 0 : m_data->size(); }
+
+        void Request(const JEvent& event) override { event.GetCollection<PodioT>(this->collection_names[0]); }
+
+        void Alias(const JEvent& event, const std::vector<std::string>& tags) override {
+            const auto* aliased = GetPodioCollection<PodioT>(event, m_aliased.Resolve(event, tags[0]));
+            m_data = std::make_unique<typename PodioTypeMap<PodioT>::collection_t>();
+            m_data->setSubsetCollection();
+            for (const auto& object : *aliased) {
+                m_data->push_back(object);
+            }
         }
     };
 
@@ -204,6 +376,8 @@ public:
     class VariadicPodioOutput : public OutputBase {
 
         std::vector<std::unique_ptr<typename PodioTypeMap<PodioT>::collection_t>> m_data;
+        std::vector<CapacityHint> m_capacity_hints;
+        std::vector<FactoryHandle<PodioT, JFactoryPodioT<PodioT>>> m_aliased;
 
     public:
 
@@ -212,6 +386,7 @@ public:
             this->collection_names = default_collection_names;
             this->type_name = JTypeInfo::demangle<PodioT>();
             this->is_variadic = true;
+            this->is_podio = true;
         }
 
         std::vector<std::unique_ptr<typename PodioTypeMap<PodioT>::collection_t>>& operator()() { return m_data; }
@@ -230,6 +405,12 @@ public:
                 throw JException("JOmniFactory: VariadicPodioOutput SetCollection failed: Declared %d collections, but provided %d.", this->collection_names.size(), m_data.size());
                 // Otherwise this leads to a PODIO segfault
             }
+            if (this->reserve_collections) {
+                m_capacity_hints.resize(m_data.size());
+                for (size_t i = 0; i < m_data.size(); ++i) {
+                    m_capacity_hints[i].Record(m_data[i]->size());
+                }
+            }
             size_t i = 0;
             for (auto& coll_name : this->collection_names) {
                 fac.SetCollection<PodioT>(coll_name, std::move(this->m_data[i++]));
@@ -238,8 +419,40 @@ public:
 
         void Reset() override {
             m_data.clear();
-            for (auto& coll_name : this->collection_names) {
+            for (size_t i = 0; i < this->collection_names.size(); ++i) {
                 m_data.push_back(std::make_unique<typename PodioTypeMap<PodioT>::collection_t>());
+                if (this->reserve_collections && i < m_capacity_hints.size()) {
+                    m_capacity_hints[i].Apply(*m_data.back());
+                }
+            }
+        }
+
+        void Discard() override { m_data.clear(); }
+
+        size_t EntryCount() const override {
+            size_t count = 0;
+            for (const auto& collection : m_data) {
+                count += (collection == nullptr) ? 0 : collection->size();
+            }
+            return count;
+        }
+
+        void Request(const JEvent& event) override {
+            if (!this->collection_names.empty()) {
+                event.GetCollection<PodioT>(this->collection_names[0]);
+            }
+        }
+
+        void Alias(const JEvent& event, const std::vector<std::string>& tags) override {
+            m_aliased.resize(tags.size());
+            m_data.clear();
+            for (size_t i = 0; i < tags.size(); ++i) {
+                const auto* aliased = GetPodioCollection<PodioT>(event, m_aliased[i].Resolve(event, tags[i]));
+                auto& collection = m_data.emplace_back(std::make_unique<typename PodioTypeMap<PodioT>::collection_t>());
+                collection->setSubsetCollection();
+                for (const auto& object : *aliased) {
+                    collection->push_back(object);
+                }
             }
         }
     };
@@ -437,6 +650,21 @@ private:
     /// Current logger
     std::shared_ptr<spdlog::logger> m_logger;
 
+    /// Process() metrics, only if `omnifactory:MetricsFile` is set
+    std::shared_ptr<eicrecon::JOmniFactoryCounters> m_metrics;
+
+    /// Hardware counters of Process(), with `omnifactory:PerfCounters`
+    bool m_perf_counters = false;
+
+    /// Process() range of the profiler timeline, with USE_NVTX or USE_ITT
+    eicrecon::TraceName m_trace_name;
+
+    /// Shared with the factories of the same wiring, set by JOmniFactoryGeneratorT
+    std::shared_ptr<JOmniFactorySharedSlot> m_shared_slot{std::make_shared<JOmniFactorySharedSlot>()};
+
+    /// Output tags of the identical wiring whose collections this factory aliases, see omnifactory:MergeIdenticalWirings
+    std::vector<std::string> m_alias_tags;
+
     /// Configuration
     ConfigT m_config;
 
@@ -475,11 +703,14 @@ public:
 
         // TODO: NWB: JMultiFactory::GetTag,SetTag are not currently usable
         m_prefix = (this->GetPluginName().empty()) ? tag : this->GetPluginName() + ":" + tag;
+        m_trace_name = eicrecon::TraceName(m_prefix);
 
         // Obtain collection name overrides if provided.
         // Priority = [JParameterManager, JOmniFactoryGenerator]
         m_app->SetDefaultParameter(m_prefix + ":InputTags", default_input_collection_names, "Input collection names");
         m_app->SetDefaultParameter(m_prefix + ":OutputTags", default_output_collection_names, "Output collection names");
+        bool reserve_outputs = false;
+        m_app->SetDefaultParameter(m_prefix + ":ReserveOutputs", reserve_outputs, "Reserve the output collections from the sizes of the previous events");
 
         // Figure out variadic inputs
         size_t variadic_input_count = 0;
@@ -523,14 +754,45 @@ public:
             else {
                 output->collection_names.push_back(default_output_collection_names[i++]);
             }
+            output->reserve_collections = reserve_outputs;
+            output->needed.clear();
+            for (const auto& collection_name : output->collection_names) {
+                output->needed.push_back(eicrecon::JOmniFactoryWirings::instance().IsCollectionNeeded(m_app, collection_name));
+            }
             output->CreateHelperFactory(*this);
         }
 
         // Obtain logger (defines the parameter option)
         m_logger = m_app->GetService<Log_service>()->logger(m_prefix);
+
+        std::string metrics_file;
+        m_app->SetDefaultParameter("omnifactory:MetricsFile", metrics_file, "Write the time and collection sizes of every factory to this file (.json, .csv or .prom)");
+        m_app->SetDefaultParameter("omnifactory:PerfCounters", m_perf_counters, "Count the cycles, instructions, last-level cache misses and branch misses of every factory with perf_event, for omnifactory:MetricsFile and janatop");
+        if (m_perf_counters) {
+            eicrecon::JOmniFactoryPerfCounts counts;
+            if (!eicrecon::JOmniFactoryPerfCounters::read(counts)) {
+                static std::once_flag warned;
+                std::call_once(warned, [this]() {
+                    m_logger->warn("omnifactory:PerfCounters: perf_event_open is not allowed, check kernel.perf_event_paranoid");
+                });
+                m_perf_counters = false;
+            }
+        }
+        if (!metrics_file.empty() || m_perf_counters) {
+            auto& metrics = eicrecon::JOmniFactoryMetrics::instance();
+            if (!metrics_file.empty()) {
+                metrics.set_output_file(metrics_file);
+            }
+            m_metrics = metrics.counters(m_prefix);
+        }
     }
 
     void Init() override {
+        if (!m_alias_tags.empty()) {
+            // nothing of the algorithm runs, see Process()
+            return;
+        }
+        eicrecon::StartupProfile::Scope profile("JOmniFactory Init", m_prefix);
         auto app = GetApplication();
         for (auto* parameter : m_parameters) {
             parameter->Configure(*(app->GetJParameterManager()), m_prefix);
@@ -542,6 +804,9 @@ public:
     }
 
     void BeginRun(const std::shared_ptr<const JEvent>& event) override {
+        if (!m_alias_tags.empty()) {
+            return;
+        }
         for (auto* resource : m_resources) {
             resource->ChangeRun(*event);
         }
@@ -550,13 +815,54 @@ public:
 
     void Process(const std::shared_ptr<const JEvent> &event) override {
         try {
+            if (!m_alias_tags.empty()) {
+                // the outputs of the identical wiring, in the same order
+                for (size_t i = 0; auto* output : m_outputs) {
+                    const size_t n = output->collection_names.size();
+                    output->Alias(*event, {m_alias_tags.begin() + i, m_alias_tags.begin() + i + n});
+                    output->SetCollection(*this);
+                    i += n;
+                }
+                return;
+            }
+            // the columns of the input collections are shared by the factories of the event
+            const eicrecon::ColumnCache::EventScope column_scope(event.get(), event->GetEventNumber());
             for (auto* input : m_inputs) {
                 input->GetCollection(*event);
             }
             for (auto* output : m_outputs) {
                 output->Reset();
             }
-            static_cast<AlgoT*>(this)->Process(event->GetRunNumber(), event->GetEventNumber());
+            // the temporaries of the algorithm are released once it has processed the event
+            const eicrecon::EventArena::Scope arena_scope(m_prefix);
+            const eicrecon::TraceRange trace_range(m_trace_name);
+            if (m_metrics || eicrecon::JOmniFactoryEventTimes::enabled()) {
+                // excludes the upstream factories, which run in GetCollection() above
+                eicrecon::JOmniFactoryPerfCounts perf_start, perf_end;
+                const bool perf = m_perf_counters && eicrecon::JOmniFactoryPerfCounters::read(perf_start);
+                const eicrecon::JOmniFactoryStopwatch stopwatch;
+                static_cast<AlgoT*>(this)->Process(event->GetRunNumber(), event->GetEventNumber());
+                const auto wall_ns = stopwatch.wall_elapsed_ns();
+                if (perf && eicrecon::JOmniFactoryPerfCounters::read(perf_end)) {
+                    m_metrics->add_perf(perf_end - perf_start);
+                }
+                if (m_metrics) {
+                    const auto cpu_ns = stopwatch.cpu_elapsed_ns();
+                    size_t input_entries = 0, output_entries = 0;
+                    for (const auto* input : m_inputs) {
+                        input_entries += input->EntryCount();
+                    }
+                    for (const auto* output : m_outputs) {
+                        output_entries += output->EntryCount();
+                    }
+                    m_metrics->add(wall_ns, cpu_ns, input_entries, output_entries);
+                }
+                if (eicrecon::JOmniFactoryEventTimes::enabled()) {
+                    eicrecon::JOmniFactoryEventTimes::add(event.get(), event->GetEventNumber(), m_prefix, wall_ns);
+                }
+            } else {
+                static_cast<AlgoT*>(this)->Process(event->GetRunNumber(), event->GetEventNumber());
+            }
             for (auto* output : m_outputs) {
                 output->SetCollection(*this);
             }
@@ -566,6 +872,50 @@ public:
         }
     }
 
+    std::string ReplayPrefix() override { return m_prefix; }
+
+    std::string PrefetchPrefix() override { return m_prefix; }
+
+    void Prefetch(const JEvent& event) override {
+        if (!m_outputs.empty()) {
+            m_outputs.front()->Request(event);
+        }
+    }
+
+    void Replay(const std::shared_ptr<const JEvent>& event, size_t iterations, std::vector<std::uint64_t>& wall_ns) override {
+        try {
+            const eicrecon::ColumnCache::EventScope column_scope(event.get(), event->GetEventNumber());
+            for (auto* input : m_inputs) {
+                input->GetCollection(*event);
+            }
+            for (size_t i = 0; i < iterations; ++i) {
+                for (auto* output : m_outputs) {
+                    output->Discard();
+                    output->Reset();
+                }
+                const eicrecon::EventArena::Scope arena_scope(m_prefix);
+                const eicrecon::JOmniFactoryStopwatch stopwatch;
+                static_cast<AlgoT*>(this)->Process(event->GetRunNumber(), event->GetEventNumber());
+                wall_ns.push_back(stopwatch.wall_elapsed_ns());
+            }
+            for (auto* output : m_outputs) {
+                output->Discard();
+            }
+        }
+        catch(std::exception &e) {
+            throw JException(e.what());
+        }
+    }
+
+    void Finish() override {
+        if (m_metrics) {
+            eicrecon::JOmniFactoryMetrics::instance().write();
+        }
+#ifdef EICRECON_ARENA_STATS
+        m_logger->info("Event arena high-water mark: {} bytes", eicrecon::EventArena::highWater(m_prefix));
+#endif
+    }
+
     using ConfigType = ConfigT;
 
     void SetApplication(JApplication* app) { m_app = app; }
@@ -578,6 +928,46 @@ public:
 
     inline std::string GetPrefix() { return m_prefix; }
 
+    void SetSharedSlot(std::shared_ptr<JOmniFactorySharedSlot> slot) { m_shared_slot = std::move(slot); }
+
+    /// Alias the collections of an identical wiring instead of running the algorithm, set by JOmniFactoryGeneratorT
+    void SetAliasOf(std::vector<std::string> output_tags) { m_alias_tags = std::move(output_tags); }
+
+    /// Whether all the outputs are podio collections, which can alias the ones of an identical wiring
+    bool HasOnlyPodioOutputs() const {
+        return std::all_of(m_outputs.begin(), m_outputs.end(), [](const OutputBase* output) { return output->is_podio; });
+    }
+
+    /// Names of the parameters, without the prefix
+    std::vector<std::string> ParameterNames() const {
+        std::vector<std::string> names;
+        for (const auto* parameter : m_parameters) {
+            names.push_back(parameter->m_name);
+        }
+        return names;
+    }
+
+    /**
+     * State made once by `make()` and shared by the factories of this wiring
+     * in all the factory sets, i.e. all the threads. Meant for the immutable
+     * setup of an algorithm, or for a whole algorithm whose `process()` is
+     * const and has no mutable members, so that it does not have to be
+     * initialised once per thread.
+     */
+    template <typename T, typename MakeT>
+    std::shared_ptr<T> Shared(MakeT&& make) {
+        std::lock_guard<std::mutex> lock(m_shared_slot->mutex);
+        if (m_shared_slot->state == nullptr) {
+            m_shared_slot->state = std::shared_ptr<T>(make());
+            m_shared_slot->type  = typeid(T);
+        }
+        if (m_shared_slot->type != typeid(T)) {
+            throw JException("JOmniFactory '%s': shared state of type %s requested, but it holds %s",
+                             m_prefix.c_str(), typeid(T).name(), m_shared_slot->type.name());
+        }
+        return std::static_pointer_cast<T>(m_shared_slot->state);
+    }
+
     /// Retrieve reference to already-configured logger
     std::shared_ptr<spdlog::logger> &logger() { return m_logger; }
 
@@ -0,0 +1,346 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+/**
+ * Concurrent execution of the independent JOmniFactories of one event.
+ *
+ * JANA runs the factories of an event lazily, depth first, on the thread of
+ * the event, as their collections are requested. With
+ * `-Pomnifactory:IntraEventThreads=N`, the podio writer first hands the event
+ * to Prefetch(), which runs the graph of JOmniFactoryWirings::FactoryGraph()
+ * instead: every factory is started as soon as the factories of its inputs
+ * are done, on the thread of the event or on one of N threads that are
+ * shared by all the events, so that independent chains (e.g. the
+ * calorimeters and the tracking) overlap. The collections are then all there
+ * when the writer asks for them.
+ *
+ * The factory set of an event is not safe for two threads running the same
+ * factory, so a factory is only started once every factory that it takes
+ * inputs from has run, and the inputs from outside of the graph (the input
+ * file, other kinds of factories) are all taken on the thread of the event
+ * first. A factory whose external input can not be taken this way, e.g. one
+ * that is not a podio collection, is left to run lazily afterwards, together
+ * with everything downstream of it. Events with the JANA call graph recorder
+ * on (janatop, janatrace) are not prefetched, as the recorder is not thread
+ * safe either.
+ *
+ * The factories put their collections into the frame of the event in no
+ * fixed order, which needs the collection IDs of podio 0.99 and later, the
+ * hashes of the collection names.
+ *
+ * The factories that run on the shared threads keep their per-thread state
+ * there, e.g. the geometry caches, the event arena and the collection column
+ * cache, and the slow event recorder of janareplay only sees the factories that
+ * ran on the thread of the event.
+ */
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JException.h>
+#include <JANA/JFactorySet.h>
+#include <JANA/JMultifactory.h>
+#include <JANA/Utils/JCallGraphRecorder.h>
+#include <podio/Frame.h>
+#include <podio/podioVersion.h>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "extensions/jana/JOmniFactoryPruning.h"
+#include "services/log/Log_service.h"
+
+namespace eicrecon {
+
+/// A factory that JOmniFactoryExecutor can run by its prefix
+class JOmniFactoryPrefetchable {
+public:
+  virtual ~JOmniFactoryPrefetchable() = default;
+
+  virtual std::string PrefetchPrefix() = 0;
+
+  /// Runs the factory for the event through JANA, as a request of its outputs would
+  virtual void Prefetch(const JEvent& event) = 0;
+};
+
+class JOmniFactoryExecutor {
+public:
+  static JOmniFactoryExecutor& instance() {
+    static JOmniFactoryExecutor executor;
+    return executor;
+  }
+
+  ~JOmniFactoryExecutor() { resize(0); }
+
+  /// Runs the factories that the requested collections of the event depend on, does nothing without
+  /// omnifactory:IntraEventThreads. Rethrows the first exception of a factory, once the others are done.
+  void Prefetch(JApplication* app, const std::shared_ptr<const JEvent>& event) {
+    auto graph = JOmniFactoryWirings::instance().FactoryGraph(app);
+    std::vector<JOmniFactoryPrefetchable*> factories;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (graph != m_graph) {
+        decide(app, graph);
+      }
+      if (m_threads.empty() || graph->prefixes.empty()) {
+        return;
+      }
+      factories = find_factories(*event->GetFactorySet());
+    }
+    if (event->GetJCallGraphRecorder()->IsEnabled()) {
+      return;
+    }
+
+    // the factories put their collections into the frame of the event, which must already be there
+    try {
+      if (event->Get<podio::Frame>().empty()) {
+        return;
+      }
+    } catch (std::exception& e) {
+      return;
+    }
+
+    auto batch = std::make_shared<Batch>(*graph, std::move(factories));
+    std::map<std::string, bool> taken;
+    for (std::size_t i = 0; i < graph->prefixes.size(); ++i) {
+      for (const auto& tag : graph->external[i]) {
+        auto [it, inserted] = taken.try_emplace(tag, false);
+        if (inserted) {
+          try {
+            it->second = event->GetCollectionBase(tag) != nullptr;
+          } catch (std::exception& e) {
+            // e.g. not a podio collection, or its factory fails: the factories that need it run lazily
+          }
+        }
+        if (!it->second) {
+          batch->factories[i] = nullptr;
+        }
+      }
+    }
+    batch->start(*event);
+    run(batch);
+  }
+
+private:
+  /// The factories of one event, and the state of their execution
+  struct Batch {
+    std::vector<JOmniFactoryPrefetchable*> factories; // nullptr if it is left to run lazily
+    std::vector<std::vector<std::size_t>> downstream;
+    std::vector<std::size_t> waiting_for;             // upstream factories that have not run yet
+    const JEvent* event{nullptr};
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::deque<std::size_t> ready;
+    std::size_t running{0};
+    std::exception_ptr error;
+
+    Batch(const JOmniFactoryWirings::Graph& graph, std::vector<JOmniFactoryPrefetchable*> factories_)
+        : factories(std::move(factories_)), downstream(graph.prefixes.size()), waiting_for(graph.prefixes.size()) {
+      for (std::size_t i = 0; i < graph.prefixes.size(); ++i) {
+        waiting_for[i] = graph.upstream[i].size();
+        for (auto j : graph.upstream[i]) {
+          downstream[j].push_back(i);
+        }
+      }
+    }
+
+    /// Leaves the factories downstream of the lazy ones to run lazily as well, and queues the ones without inputs
+    /// from the graph. Factories in a cycle never become ready, which leaves them to run lazily too.
+    void start(const JEvent& event_) {
+      event = &event_;
+      std::vector<std::size_t> lazy;
+      for (std::size_t i = 0; i < factories.size(); ++i) {
+        if (factories[i] == nullptr) {
+          lazy.push_back(i);
+        }
+      }
+      while (!lazy.empty()) {
+        const auto i = lazy.back();
+        lazy.pop_back();
+        for (auto j : downstream[i]) {
+          if (factories[j] != nullptr) {
+            factories[j] = nullptr;
+            lazy.push_back(j);
+          }
+        }
+      }
+      for (std::size_t i = 0; i < factories.size(); ++i) {
+        if (factories[i] != nullptr && waiting_for[i] == 0) {
+          ready.push_back(i);
+        }
+      }
+    }
+
+    /// Runs a ready factory, if there is one. Returns the number of factories that it made ready, the lock is the
+    /// one of mutex, held on entry and on return. Once the batch is done, i.e. neither ready nor running
+    /// factories are left, a shared thread that still takes it does nothing.
+    std::size_t run_one(std::unique_lock<std::mutex>& lock) {
+      if (ready.empty() || error) {
+        return 0;
+      }
+      const auto i = ready.front();
+      ready.pop_front();
+      ++running;
+      lock.unlock();
+      std::exception_ptr failed;
+      try {
+        factories[i]->Prefetch(*event);
+      } catch (...) {
+        failed = std::current_exception();
+      }
+      lock.lock();
+      --running;
+      std::size_t released = 0;
+      if (failed) {
+        if (!error) {
+          error = failed;
+        }
+        ready.clear();
+      } else {
+        for (auto j : downstream[i]) {
+          if (factories[j] != nullptr && --waiting_for[j] == 0) {
+            ready.push_back(j);
+            ++released;
+          }
+        }
+      }
+      done.notify_all();
+      return released;
+    }
+  };
+
+  /// Runs a batch on the thread of the event, helped by the shared threads
+  void run(const std::shared_ptr<Batch>& batch) {
+    offer(batch, batch->ready.size());
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    while (true) {
+      if (!batch->ready.empty() && !batch->error) {
+        const auto released = batch->run_one(lock);
+        if (released > 1) {
+          lock.unlock();
+          offer(batch, released - 1);
+          lock.lock();
+        }
+        continue;
+      }
+      if (batch->running == 0) {
+        break;
+      }
+      batch->done.wait(lock);
+    }
+    if (batch->error) {
+      std::rethrow_exception(batch->error);
+    }
+  }
+
+  /// Lets the shared threads take up to n factories of a batch
+  void offer(const std::shared_ptr<Batch>& batch, std::size_t n) {
+    if (n == 0) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_queue_mutex);
+      for (std::size_t k = 0; k < n; ++k) {
+        m_queue.push_back(batch);
+      }
+    }
+    m_queue_not_empty.notify_all();
+  }
+
+  /// Body of a shared thread
+  void work() {
+    while (true) {
+      std::shared_ptr<Batch> batch;
+      {
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        m_queue_not_empty.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+        if (m_stop) {
+          return;
+        }
+        batch = std::move(m_queue.front());
+        m_queue.pop_front();
+      }
+      // the thread of the event may have taken the factory already
+      std::unique_lock<std::mutex> lock(batch->mutex);
+      const auto released = batch->run_one(lock);
+      lock.unlock();
+      offer(batch, released);
+    }
+  }
+
+  /// Reads omnifactory:IntraEventThreads for a new graph, m_mutex must be held
+  void decide(JApplication* app, std::shared_ptr<const JOmniFactoryWirings::Graph> graph) {
+    std::size_t threads = 0;
+    app->SetDefaultParameter("omnifactory:IntraEventThreads", threads,
+                             "Threads shared by all the events that run the independent factories of an event concurrently, ahead of the podio writer (0 runs them lazily on the thread of the event)");
+    m_graph = std::move(graph);
+    m_factories.clear();
+#if podio_VERSION < PODIO_VERSION(0, 99, 0)
+    if (threads > 0) {
+      throw JException("omnifactory:IntraEventThreads needs podio 0.99 or later, whose collection IDs do not depend on the order of the factories");
+    }
+#endif
+    resize(threads);
+    if (threads > 0) {
+      app->GetService<Log_service>()->logger("omnifactory")->info(
+          "omnifactory:IntraEventThreads: running {} factories on {} shared threads", m_graph->prefixes.size(), threads);
+    }
+  }
+
+  /// The factories of the graph in a factory set, m_mutex must be held
+  std::vector<JOmniFactoryPrefetchable*> find_factories(JFactorySet& factory_set) {
+    auto [it, inserted] = m_factories.try_emplace(&factory_set);
+    if (inserted) {
+      std::map<std::string, JOmniFactoryPrefetchable*> by_prefix;
+      for (auto* multifactory : factory_set.GetAllMultifactories()) {
+        if (auto* factory = dynamic_cast<JOmniFactoryPrefetchable*>(multifactory); factory != nullptr) {
+          by_prefix.emplace(factory->PrefetchPrefix(), factory);
+        }
+      }
+      for (const auto& prefix : m_graph->prefixes) {
+        auto found = by_prefix.find(prefix);
+        it->second.push_back(found == by_prefix.end() ? nullptr : found->second);
+      }
+    }
+    return it->second;
+  }
+
+  /// Replaces the shared threads
+  void resize(std::size_t threads) {
+    {
+      std::lock_guard<std::mutex> lock(m_queue_mutex);
+      m_stop = true;
+    }
+    m_queue_not_empty.notify_all();
+    for (auto& thread : m_threads) {
+      thread.join();
+    }
+    m_threads.clear();
+    m_queue.clear();
+    m_stop = false;
+    for (std::size_t k = 0; k < threads; ++k) {
+      m_threads.emplace_back(&JOmniFactoryExecutor::work, this);
+    }
+  }
+
+  std::mutex m_mutex;
+  std::shared_ptr<const JOmniFactoryWirings::Graph> m_graph;
+  std::map<JFactorySet*, std::vector<JOmniFactoryPrefetchable*>> m_factories;
+
+  std::mutex m_queue_mutex;
+  std::condition_variable m_queue_not_empty;
+  std::deque<std::shared_ptr<Batch>> m_queue; // one entry per factory that a shared thread may take
+  bool m_stop{false};
+  std::vector<std::thread> m_threads;
+};
+
+} // namespace eicrecon
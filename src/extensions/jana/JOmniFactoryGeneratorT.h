@@ -6,10 +6,18 @@
 
 #include <JANA/JFactorySet.h>
 #include <JANA/JFactoryGenerator.h>
+#include <JANA/Services/JParameterManager.h>
+#include <concepts>
+#include <optional>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
 #include <vector>
 
+#include "extensions/jana/JOmniFactoryPruning.h"
+
 template<class FactoryT>
-class JOmniFactoryGeneratorT : public JFactoryGenerator {
+class JOmniFactoryGeneratorT : public JFactoryGenerator, public eicrecon::JOmniFactoryWirings::Source {
 public:
     using FactoryConfigType = typename FactoryT::ConfigType;
 
@@ -19,6 +27,7 @@ private:
         std::vector<std::string> m_default_input_tags;
         std::vector<std::string> m_default_output_tags;
         FactoryConfigType m_default_cfg; /// Must be properly copyable!
+        std::shared_ptr<JOmniFactorySharedSlot> m_shared_slot{std::make_shared<JOmniFactorySharedSlot>()};
     };
 
     struct UntypedWiring {
@@ -42,6 +51,7 @@ public:
                              .m_default_output_tags=default_output_tags,
                              .m_default_cfg=cfg
                             });
+        eicrecon::JOmniFactoryWirings::instance().add(this);
     };
 
     explicit JOmniFactoryGeneratorT(std::string tag,
@@ -53,10 +63,15 @@ public:
                                 .m_default_input_tags=default_input_tags,
                                 .m_default_output_tags=default_output_tags
                                 });
-
+        eicrecon::JOmniFactoryWirings::instance().add(this);
     }
 
     explicit JOmniFactoryGeneratorT(JApplication* app) : m_app(app) {
+        eicrecon::JOmniFactoryWirings::instance().add(this);
+    }
+
+    ~JOmniFactoryGeneratorT() override {
+        eicrecon::JOmniFactoryWirings::instance().remove(this);
     }
 
     void AddWiring(std::string tag,
@@ -89,10 +104,60 @@ public:
 
     }
 
+    std::vector<eicrecon::JOmniFactoryWirings::Wiring> Wirings() override {
+        std::vector<eicrecon::JOmniFactoryWirings::Wiring> wirings;
+        for (const auto& wiring : m_wirings) {
+            const std::string prefix = Prefix(wiring.m_tag);
+            wirings.push_back({
+                .prefix = prefix,
+                .input_tags = eicrecon::JOmniFactoryWirings::Tags(m_app, prefix, "InputTags", wiring.m_default_input_tags),
+                .output_tags = eicrecon::JOmniFactoryWirings::Tags(m_app, prefix, "OutputTags", wiring.m_default_output_tags),
+                .type = typeid(FactoryT),
+                .mergeable = Mergeable(),
+            });
+        }
+        return wirings;
+    }
+
+    /// Same default config, and same overrides of the parameters, see omnifactory:MergeIdenticalWirings
+    bool SameConfig(JApplication* app, const std::string& prefix, eicrecon::JOmniFactoryWirings::Source& other,
+                    const std::string& other_prefix) override {
+        if constexpr (!std::equality_comparable<FactoryConfigType>) {
+            return false;
+        } else {
+            auto* typed = dynamic_cast<JOmniFactoryGeneratorT*>(&other);
+            if (typed == nullptr) {
+                return false;
+            }
+            const auto* wiring = FindWiring(prefix);
+            const auto* other_wiring = typed->FindWiring(other_prefix);
+            if (wiring == nullptr || other_wiring == nullptr || !(wiring->m_default_cfg == other_wiring->m_default_cfg)) {
+                return false;
+            }
+            auto* parman = app->GetJParameterManager();
+            for (const auto& name : FactoryT().ParameterNames()) {
+                const std::string parameter = prefix + ":" + name;
+                const std::string other_parameter = other_prefix + ":" + name;
+                if (parman->Exists(parameter) != parman->Exists(other_parameter)) {
+                    return false;
+                }
+                if (parman->Exists(parameter)
+                    && parman->GetParameterValue<std::string>(parameter) != parman->GetParameterValue<std::string>(other_parameter)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
     void GenerateFactories(JFactorySet *factory_set) override {
 
         for (const auto& wiring : m_wirings) {
 
+            // see JOmniFactoryPruning.h
+            if (!eicrecon::JOmniFactoryWirings::instance().IsNeeded(m_app, Prefix(wiring.m_tag))) {
+                continue;
+            }
 
             FactoryT *factory = new FactoryT;
             factory->SetApplication(m_app);
@@ -102,6 +167,12 @@ public:
             // We do NOT want to do this because JMF will use the tag to suffix the collection names
             // TODO: NWB: Change this in JANA
             factory->config() = wiring.m_default_cfg;
+            factory->SetSharedSlot(wiring.m_shared_slot);
+
+            // see omnifactory:MergeIdenticalWirings
+            if (auto aliased = eicrecon::JOmniFactoryWirings::instance().AliasOf(m_app, Prefix(wiring.m_tag))) {
+                factory->SetAliasOf(std::move(*aliased));
+            }
 
             // Set up all of the wiring prereqs so that Init() can do its thing
             // Specifically, it needs valid input/output tags, a valid logger, and
@@ -114,7 +185,35 @@ public:
     }
 
 private:
+    // same as JOmniFactory::PreInit()
+    std::string Prefix(const std::string& tag) {
+        const std::string plugin_name = this->GetPluginName();
+        return plugin_name.empty() ? tag : plugin_name + ":" + tag;
+    }
+
+    const TypedWiring* FindWiring(const std::string& prefix) {
+        for (const auto& wiring : m_wirings) {
+            if (Prefix(wiring.m_tag) == prefix) {
+                return &wiring;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Whether the wirings can alias identical ones, which needs a comparable config and only podio outputs
+    bool Mergeable() {
+        if constexpr (!std::equality_comparable<FactoryConfigType>) {
+            return false;
+        } else {
+            if (!m_only_podio_outputs) {
+                m_only_podio_outputs = FactoryT().HasOnlyPodioOutputs();
+            }
+            return *m_only_podio_outputs;
+        }
+    }
+
     std::vector<TypedWiring> m_wirings;
     JApplication* m_app;
+    std::optional<bool> m_only_podio_outputs;
 
 };
@@ -0,0 +1,251 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+/**
+ * Per-factory metrics of JOmniFactory::Process.
+ *
+ * Every factory instance owns its counters and is only run by one thread
+ * at a time, so the counters are relaxed atomics without any lock on the
+ * event path. The registry only takes its lock when an instance registers
+ * and when the totals are exported at the end of the job, to the file of
+ * the `omnifactory:MetricsFile` parameter: CSV for `.csv`, Prometheus
+ * text format for `.prom`, JSON otherwise. With `omnifactory:PerfCounters`,
+ * the hardware counts of JOmniFactoryPerfCounters are added to the totals.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "extensions/jana/JOmniFactoryPerfCounters.h"
+
+namespace eicrecon {
+
+struct JOmniFactoryCounters {
+  std::string prefix;
+  std::atomic<std::uint64_t> calls{0};
+  std::atomic<std::uint64_t> wall_ns{0};
+  std::atomic<std::uint64_t> cpu_ns{0};
+  std::atomic<std::uint64_t> input_entries{0};
+  std::atomic<std::uint64_t> output_entries{0};
+  std::atomic<std::uint64_t> cycles{0};
+  std::atomic<std::uint64_t> instructions{0};
+  std::atomic<std::uint64_t> llc_misses{0};
+  std::atomic<std::uint64_t> branch_misses{0};
+
+  void add_perf(const JOmniFactoryPerfCounts& counts) {
+    cycles.fetch_add(counts.cycles, std::memory_order_relaxed);
+    instructions.fetch_add(counts.instructions, std::memory_order_relaxed);
+    llc_misses.fetch_add(counts.llc_misses, std::memory_order_relaxed);
+    branch_misses.fetch_add(counts.branch_misses, std::memory_order_relaxed);
+  }
+
+  void add(std::uint64_t wall, std::uint64_t cpu, std::uint64_t inputs, std::uint64_t outputs) {
+    calls.fetch_add(1, std::memory_order_relaxed);
+    wall_ns.fetch_add(wall, std::memory_order_relaxed);
+    cpu_ns.fetch_add(cpu, std::memory_order_relaxed);
+    input_entries.fetch_add(inputs, std::memory_order_relaxed);
+    output_entries.fetch_add(outputs, std::memory_order_relaxed);
+  }
+};
+
+/// Wall and thread CPU clocks in nanoseconds
+struct JOmniFactoryStopwatch {
+  std::chrono::steady_clock::time_point wall_start{std::chrono::steady_clock::now()};
+  std::uint64_t cpu_start{thread_cpu_ns()};
+
+  static std::uint64_t thread_cpu_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<std::uint64_t>(ts.tv_nsec);
+  }
+  std::uint64_t wall_elapsed_ns() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wall_start).count();
+  }
+  std::uint64_t cpu_elapsed_ns() const { return thread_cpu_ns() - cpu_start; }
+};
+
+/**
+ * Wall time of the factories of the event of this thread, for the slow
+ * event recorder of the janareplay plugin. The factories of an event run on
+ * the thread of the event, so every thread collects the times of its current
+ * event, and take() hands them over at the end of the event.
+ */
+class JOmniFactoryEventTimes {
+public:
+  using Times = std::vector<std::pair<std::string, std::uint64_t>>; // factory prefix, wall ns
+
+  static void enable() { s_enabled.store(true, std::memory_order_relaxed); }
+  static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+  static void add(const void* event, std::uint64_t event_number, const std::string& prefix, std::uint64_t wall_ns) {
+    auto& state = threadState();
+    if (state.event != event || state.event_number != event_number) {
+      state.times.clear();
+      state.event        = event;
+      state.event_number = event_number;
+    }
+    state.times.emplace_back(prefix, wall_ns);
+  }
+
+  /// The times of an event so far, empty if no factory of it ran on this thread
+  static Times take(const void* event, std::uint64_t event_number) {
+    auto& state = threadState();
+    if (state.event != event || state.event_number != event_number) {
+      return {};
+    }
+    state.event = nullptr;
+    return std::move(state.times);
+  }
+
+private:
+  struct State {
+    const void* event{nullptr};
+    std::uint64_t event_number{0};
+    Times times;
+  };
+
+  static State& threadState() {
+    thread_local State state;
+    return state;
+  }
+
+  static inline std::atomic<bool> s_enabled{false};
+};
+
+class JOmniFactoryMetrics {
+public:
+  static JOmniFactoryMetrics& instance() {
+    static JOmniFactoryMetrics metrics;
+    return metrics;
+  }
+
+  struct Totals {
+    std::uint64_t calls{0}, wall_ns{0}, cpu_ns{0}, input_entries{0}, output_entries{0};
+    std::uint64_t cycles{0}, instructions{0}, llc_misses{0}, branch_misses{0};
+  };
+
+  ~JOmniFactoryMetrics() { write(); }
+
+  std::shared_ptr<JOmniFactoryCounters> counters(const std::string& prefix) {
+    auto counters = std::make_shared<JOmniFactoryCounters>();
+    counters->prefix = prefix;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counters.push_back(counters);
+    return counters;
+  }
+
+  void set_output_file(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_output_file = path;
+  }
+
+  /// Totals of all the instances of each factory so far, e.g. for the steps of a benchmark
+  std::map<std::string, Totals> totals() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return sum();
+  }
+
+  /// Writes the totals of all the instances of each factory
+  void write() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_output_file.empty() || m_counters.empty()) {
+      return;
+    }
+    const auto totals = sum();
+    // the hardware counts only with omnifactory:PerfCounters
+    bool perf = false;
+    for (const auto& [prefix, t] : totals) {
+      perf = perf || (t.cycles > 0);
+    }
+
+    std::ofstream out(m_output_file);
+    if (ends_with(m_output_file, ".csv")) {
+      out << "factory,calls,wall_ns,cpu_ns,input_entries,output_entries"
+          << (perf ? ",cycles,instructions,llc_misses,branch_misses\n" : "\n");
+      for (const auto& [prefix, t] : totals) {
+        out << prefix << ',' << t.calls << ',' << t.wall_ns << ',' << t.cpu_ns << ',' << t.input_entries
+            << ',' << t.output_entries;
+        if (perf) {
+          out << ',' << t.cycles << ',' << t.instructions << ',' << t.llc_misses << ',' << t.branch_misses;
+        }
+        out << '\n';
+      }
+    } else if (ends_with(m_output_file, ".prom")) {
+      std::vector<std::pair<const char*, std::uint64_t Totals::*>> metrics{
+          {"eicrecon_factory_calls_total", &Totals::calls},
+          {"eicrecon_factory_wall_ns_total", &Totals::wall_ns},
+          {"eicrecon_factory_cpu_ns_total", &Totals::cpu_ns},
+          {"eicrecon_factory_input_entries_total", &Totals::input_entries},
+          {"eicrecon_factory_output_entries_total", &Totals::output_entries},
+      };
+      if (perf) {
+        metrics.insert(metrics.end(), {{"eicrecon_factory_cycles_total", &Totals::cycles},
+                                       {"eicrecon_factory_instructions_total", &Totals::instructions},
+                                       {"eicrecon_factory_llc_misses_total", &Totals::llc_misses},
+                                       {"eicrecon_factory_branch_misses_total", &Totals::branch_misses}});
+      }
+      for (const auto& [name, member] : metrics) {
+        out << "# TYPE " << name << " counter\n";
+        for (const auto& [prefix, t] : totals) {
+          out << name << "{factory=\"" << prefix << "\"} " << t.*member << '\n';
+        }
+      }
+    } else {
+      out << "{\n";
+      for (auto it = totals.begin(); it != totals.end(); ++it) {
+        const auto& t = it->second;
+        out << "  \"" << it->first << "\": {\"calls\": " << t.calls << ", \"wall_ns\": " << t.wall_ns
+            << ", \"cpu_ns\": " << t.cpu_ns << ", \"input_entries\": " << t.input_entries
+            << ", \"output_entries\": " << t.output_entries;
+        if (perf) {
+          out << ", \"cycles\": " << t.cycles << ", \"instructions\": " << t.instructions
+              << ", \"llc_misses\": " << t.llc_misses << ", \"branch_misses\": " << t.branch_misses;
+        }
+        out << "}" << (std::next(it) == totals.end() ? "\n" : ",\n");
+      }
+      out << "}\n";
+    }
+    // written once, at the first Finish() or else at exit
+    m_output_file.clear();
+  }
+
+private:
+  std::map<std::string, Totals> sum() const {
+    std::map<std::string, Totals> totals;
+    for (const auto& counters : m_counters) {
+      auto& t = totals[counters->prefix];
+      t.calls += counters->calls.load(std::memory_order_relaxed);
+      t.wall_ns += counters->wall_ns.load(std::memory_order_relaxed);
+      t.cpu_ns += counters->cpu_ns.load(std::memory_order_relaxed);
+      t.input_entries += counters->input_entries.load(std::memory_order_relaxed);
+      t.output_entries += counters->output_entries.load(std::memory_order_relaxed);
+      t.cycles += counters->cycles.load(std::memory_order_relaxed);
+      t.instructions += counters->instructions.load(std::memory_order_relaxed);
+      t.llc_misses += counters->llc_misses.load(std::memory_order_relaxed);
+      t.branch_misses += counters->branch_misses.load(std::memory_order_relaxed);
+    }
+    return totals;
+  }
+
+  static bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+  }
+
+  std::mutex m_mutex;
+  std::string m_output_file;
+  std::vector<std::shared_ptr<JOmniFactoryCounters>> m_counters;
+};
+
+} // namespace eicrecon
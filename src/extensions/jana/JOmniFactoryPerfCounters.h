@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+/**
+ * Hardware counters of the calling thread for JOmniFactory::Process, with
+ * `-Pomnifactory:PerfCounters=1`.
+ *
+ * Every thread opens its own perf_event group of cycles, instructions,
+ * last-level cache misses and branch misses on its first read(), counted in
+ * user space only. The counts of a factory are the difference of two reads
+ * around its Process(). Where perf_event_open is not allowed, e.g. with
+ * kernel.perf_event_paranoid > 2 or in some containers, read() returns
+ * false and nothing is counted.
+ */
+
+#include <array>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace eicrecon {
+
+struct JOmniFactoryPerfCounts {
+  std::uint64_t cycles{0};
+  std::uint64_t instructions{0};
+  std::uint64_t llc_misses{0};
+  std::uint64_t branch_misses{0};
+
+  JOmniFactoryPerfCounts operator-(const JOmniFactoryPerfCounts& start) const {
+    return {cycles - start.cycles, instructions - start.instructions, llc_misses - start.llc_misses,
+            branch_misses - start.branch_misses};
+  }
+};
+
+class JOmniFactoryPerfCounters {
+public:
+  /// Counts of the calling thread so far, false if the counters can not be opened
+  static bool read(JOmniFactoryPerfCounts& counts) {
+#if defined(__linux__) && defined(SYS_perf_event_open)
+    auto& group = threadGroup();
+    if (group.fds[0] < 0) {
+      return false;
+    }
+    // nr, time_enabled, time_running, then a value per counter
+    std::array<std::uint64_t, 3 + n_counters> buffer{};
+    if (::read(group.fds[0], buffer.data(), sizeof(buffer)) != static_cast<long>(sizeof(buffer))) {
+      return false;
+    }
+    // scaled up if the group shared the counters with other groups for part of the time
+    const double scale = (buffer[2] > 0 && buffer[2] < buffer[1]) ? double(buffer[1]) / buffer[2] : 1.;
+    counts.cycles        = static_cast<std::uint64_t>(buffer[3] * scale);
+    counts.instructions  = static_cast<std::uint64_t>(buffer[4] * scale);
+    counts.llc_misses    = static_cast<std::uint64_t>(buffer[5] * scale);
+    counts.branch_misses = static_cast<std::uint64_t>(buffer[6] * scale);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+private:
+  static constexpr std::size_t n_counters = 4;
+
+#if defined(__linux__) && defined(SYS_perf_event_open)
+  struct Group {
+    std::array<int, n_counters> fds{-1, -1, -1, -1};
+
+    Group() {
+      const std::array<std::uint64_t, n_counters> configs{PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                          PERF_COUNT_HW_CACHE_MISSES,
+                                                          PERF_COUNT_HW_BRANCH_MISSES};
+      for (std::size_t i = 0; i < n_counters; ++i) {
+        perf_event_attr attr{};
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.size           = sizeof(attr);
+        attr.config         = configs[i];
+        attr.disabled       = (i == 0) ? 1 : 0; // the group starts with its leader
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // this thread, on any CPU
+        fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, (i == 0) ? -1 : fds[0], 0));
+        if (fds[i] < 0) {
+          close();
+          return;
+        }
+      }
+      ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    ~Group() { close(); }
+
+    void close() {
+      for (auto& fd : fds) {
+        if (fd >= 0) {
+          ::close(fd);
+        }
+        fd = -1;
+      }
+    }
+  };
+
+  static Group& threadGroup() {
+    thread_local Group group;
+    return group;
+  }
+#endif
+};
+
+} // namespace eicrecon
@@ -0,0 +1,468 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+/**
+ * Pruning of the JOmniFactory wirings that no requested output depends on.
+ *
+ * With `-Pomnifactory:PruneToOutputs=true`, the generators only create the
+ * factories that `podio:output_collections` and `omnifactory:KeepCollections`
+ * (for processors that get collections themselves) transitively depend on.
+ * The other factories are never constructed, so neither their Init() nor
+ * their services run. A processor that gets a collection of a pruned
+ * factory fails, which is why pruning is opt-in.
+ *
+ * With `-Pomnifactory:LazyOutputs=true`, the factories are still created, but
+ * an output collection that is neither requested nor an input of a factory
+ * that the requested collections depend on is not needed: `IsNeeded()` of the
+ * output is false, and factories that support it leave the collection empty,
+ * e.g. the MC truth associations in production. The same caveat applies, a
+ * processor that gets such a collection has to list it in KeepCollections.
+ *
+ * With `-Preco:reuse_input_collections=CentralCKFTracks,...`, the listed
+ * collections are taken from the input file instead: the factories that make
+ * them are not created, and the walks above stop at them, so nothing upstream
+ * of them runs. A factory is replaced as a whole, all of its outputs have to
+ * be listed. The podio source checks the configuration of the factories
+ * upstream of them against the one stored in the file.
+ *
+ * With `-Pomnifactory:MergeIdenticalWirings=true`, wirings of the same factory
+ * type with the same configuration on the same inputs, e.g. registered under
+ * different tags by two detector plugins, run once: the first one of them
+ * makes the collections, the others alias them with subset collections and
+ * skip their Init(). Only factories whose outputs are all podio collections and
+ * whose config is equality comparable (`operator==`) are merged, along with the
+ * overrides of their parameters, which have to be the same strings. Merging
+ * repeats through the aliases, so identical chains collapse as a whole.
+ *
+ * The same decision also gives the graph of the factories that the requested
+ * collections depend on, which JOmniFactoryExecutor runs ahead of the podio
+ * writer with `-Pomnifactory:IntraEventThreads`.
+ */
+
+#include <JANA/JApplication.h>
+#include <JANA/JException.h>
+#include <fmt/format.h>
+#include <spdlog/logger.h>
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+#include "services/log/Log_service.h"
+
+namespace eicrecon {
+
+class JOmniFactoryWirings {
+public:
+  struct Source;
+
+  struct Wiring {
+    std::string prefix;
+    std::vector<std::string> input_tags;
+    std::vector<std::string> output_tags;
+    /// Factory type, and whether the wiring can be merged with an identical one of the same type
+    std::type_index type{typeid(void)};
+    bool mergeable{false};
+    Source* source{nullptr};
+  };
+
+  /// A generator of JOmniFactory wirings
+  struct Source {
+    virtual ~Source() = default;
+    virtual std::vector<Wiring> Wirings() = 0;
+    /// Whether the resolved config of the wiring of a prefix is the one of a wiring of another source of the same type
+    virtual bool SameConfig(JApplication* app, const std::string& prefix, Source& other, const std::string& other_prefix) {
+      return false;
+    }
+  };
+
+  /// The factories that the requested collections depend on, all of them if none are requested
+  struct Graph {
+    std::vector<std::string> prefixes;
+    /// Of every factory, the indices of the factories that make its inputs
+    std::vector<std::vector<std::size_t>> upstream;
+    /// Of every factory, its inputs that no factory of the graph makes, e.g. the collections of the input file
+    std::vector<std::vector<std::string>> external;
+  };
+
+  static JOmniFactoryWirings& instance() {
+    static JOmniFactoryWirings wirings;
+    return wirings;
+  }
+
+  void add(Source* source) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sources.push_back(source);
+  }
+
+  void remove(Source* source) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sources.erase(std::remove(m_sources.begin(), m_sources.end(), source), m_sources.end());
+    if (m_sources.empty()) {
+      // the application is gone, the next one decides again
+      m_decided_for = nullptr;
+    }
+  }
+
+  /// Whether the factory of a prefix has to be created, decided once for all the factory sets
+  bool IsNeeded(JApplication* app, const std::string& prefix) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ensure_decided(app);
+    return (!m_prune || m_needed.count(prefix) > 0) && m_replaced.count(prefix) == 0;
+  }
+
+  /// Whether a collection is needed by the requested collections, always true without omnifactory:LazyOutputs
+  bool IsCollectionNeeded(JApplication* app, const std::string& tag) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ensure_decided(app);
+    return !m_lazy || m_needed_collections.count(tag) > 0;
+  }
+
+  /// Output tags of the identical wiring whose collections the factory of a prefix aliases, with omnifactory:MergeIdenticalWirings
+  std::optional<std::vector<std::string>> AliasOf(JApplication* app, const std::string& prefix) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ensure_decided(app);
+    auto it = m_aliases.find(prefix);
+    if (it == m_aliases.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  /// The wiring of a prefix, e.g. to record the inputs of a single factory
+  std::optional<Wiring> Find(const std::string& prefix) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto* source : m_sources) {
+      for (auto& wiring : source->Wirings()) {
+        if (wiring.prefix == prefix) {
+          return wiring;
+        }
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// The graph of the factories that are created, decided once with the rest. The inputs of the factories that
+  /// alias identical ones are the collections they alias. A new graph is made for every application.
+  std::shared_ptr<const Graph> FactoryGraph(JApplication* app) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ensure_decided(app);
+    return m_graph;
+  }
+
+  /// Collections that the factories needed for `podio:output_collections` and `omnifactory:KeepCollections`
+  /// get without a JOmniFactory making them, i.e. from the event source or from another kind of factory.
+  /// None if `podio:output_collections` is empty, as the podio writer then writes everything.
+  std::optional<std::set<std::string>> SourceCollections(JApplication* app) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto requested = requested_collections(app);
+    if (requested.empty()) {
+      return std::nullopt;
+    }
+    std::set<std::string> needed, sources, collections;
+    walk(all_wirings(), requested, reused_collections(app), needed, sources, collections);
+    return sources;
+  }
+
+  /// `reco:reuse_input_collections`, the collections taken from the input file instead of their factories
+  std::set<std::string> ReusedCollections(JApplication* app) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return reused_collections(app);
+  }
+
+  /// Collections that a JOmniFactory makes
+  std::set<std::string> FactoryCollections() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::set<std::string> collections;
+    for (const auto& wiring : all_wirings()) {
+      collections.insert(wiring.output_tags.begin(), wiring.output_tags.end());
+    }
+    return collections;
+  }
+
+  /// Prefixes of the factories that the collections transitively depend on, including their own
+  std::set<std::string> UpstreamFactories(const std::vector<std::string>& collections) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::set<std::string> needed, sources, visited;
+    walk(all_wirings(), collections, {}, needed, sources, visited);
+    return needed;
+  }
+
+  /// Input or output tags of a wiring, with the overrides of `<prefix>:<name>`
+  static std::vector<std::string> Tags(JApplication* app, const std::string& prefix, const std::string& name,
+                                       const std::vector<std::string>& default_tags) {
+    const std::string parameter = prefix + ":" + name;
+    if (!app->GetJParameterManager()->Exists(parameter)) {
+      return default_tags;
+    }
+    return app->GetParameterValue<std::vector<std::string>>(parameter);
+  }
+
+private:
+  /// Decides once per application, m_mutex must be held
+  void ensure_decided(JApplication* app) {
+    if (m_decided_for == app) {
+      return;
+    }
+    m_prune = false;
+    m_lazy  = false;
+    m_merge = false;
+    m_needed.clear();
+    m_replaced.clear();
+    m_needed_collections.clear();
+    m_aliases.clear();
+    m_graph.reset();
+    decide(app);
+    m_decided_for = app;
+  }
+
+  void decide(JApplication* app) {
+    app->SetDefaultParameter("omnifactory:PruneToOutputs", m_prune,
+                             "Only create the factories needed for podio:output_collections and omnifactory:KeepCollections");
+    app->SetDefaultParameter("omnifactory:LazyOutputs", m_lazy,
+                             "Leave the outputs that podio:output_collections and omnifactory:KeepCollections do not depend on empty, where supported");
+    app->SetDefaultParameter("omnifactory:MergeIdenticalWirings", m_merge,
+                             "Run wirings of the same factory type, config and inputs once, the others alias their collections");
+    auto requested = requested_collections(app);
+    const auto reused = reused_collections(app);
+    auto wirings = all_wirings();
+    auto logger = app->GetService<Log_service>()->logger("omnifactory");
+
+    if (!reused.empty()) {
+      for (const auto& wiring : wirings) {
+        const auto n = std::count_if(wiring.output_tags.begin(), wiring.output_tags.end(),
+                                     [&reused](const std::string& tag) { return reused.count(tag) > 0; });
+        if (n == 0) {
+          continue;
+        }
+        if (n != static_cast<std::ptrdiff_t>(wiring.output_tags.size())) {
+          throw JException("reco:reuse_input_collections: factory %s also makes %s, which have to be reused as well",
+                           wiring.prefix.c_str(), fmt::format("{}", fmt::join(wiring.output_tags, ", ")).c_str());
+        }
+        m_replaced.insert(wiring.prefix);
+      }
+      logger->info("reco:reuse_input_collections: {} collections from the input in place of {} factories",
+                   reused.size(), m_replaced.size());
+      logger->debug("Replaced factories: {}", fmt::join(m_replaced, ", "));
+    }
+    if (m_merge) {
+      merge(app, wirings);
+      logger->info("omnifactory:MergeIdenticalWirings: {} factories alias the collections of identical ones", m_aliases.size());
+      for (const auto& [prefix, tags] : m_aliases) {
+        logger->debug("{} aliases {}", prefix, fmt::join(tags, ", "));
+      }
+    }
+    m_graph = graph(wirings, requested, reused);
+    if (!m_prune && !m_lazy) {
+      return;
+    }
+
+    if (requested.empty()) {
+      // the podio writer writes everything
+      logger->info("omnifactory:PruneToOutputs and omnifactory:LazyOutputs ignored, podio:output_collections is empty");
+      m_prune = false;
+      m_lazy  = false;
+      return;
+    }
+
+    std::set<std::string> sources;
+    walk(wirings, requested, reused, m_needed, sources, m_needed_collections);
+    if (m_lazy) {
+      logger->info("omnifactory:LazyOutputs: {} collections needed", m_needed_collections.size());
+    }
+    if (!m_prune) {
+      return;
+    }
+
+    std::vector<std::string> pruned;
+    for (const auto& wiring : wirings) {
+      if (m_needed.count(wiring.prefix) == 0) {
+        pruned.push_back(wiring.prefix);
+      }
+    }
+    logger->info("omnifactory:PruneToOutputs: creating {} of {} factories, {} pruned", wirings.size() - pruned.size(),
+                 wirings.size(), pruned.size());
+    logger->debug("Pruned factories: {}", fmt::join(pruned, ", "));
+  }
+
+  /// Finds the wirings identical to an earlier one, and rewires them to take the collections of that one
+  /// as their inputs, so that the walks go through it
+  void merge(JApplication* app, std::vector<Wiring>& wirings) {
+    std::map<std::string, std::string> renamed; // aliased tag -> tag of the collection it aliases
+    const auto resolved = [&renamed](const std::vector<std::string>& tags) {
+      std::vector<std::string> result;
+      for (const auto& tag : tags) {
+        auto it = renamed.find(tag);
+        result.push_back(it == renamed.end() ? tag : it->second);
+      }
+      return result;
+    };
+
+    using Key = std::tuple<std::type_index, std::vector<std::string>, std::size_t>;
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      std::map<Key, std::vector<std::size_t>> candidates;
+      for (std::size_t i = 0; i < wirings.size(); ++i) {
+        auto& wiring = wirings[i];
+        if (!wiring.mergeable || m_replaced.count(wiring.prefix) > 0 || m_aliases.count(wiring.prefix) > 0) {
+          continue;
+        }
+        auto& others = candidates[Key{wiring.type, resolved(wiring.input_tags), wiring.output_tags.size()}];
+        const auto same = std::find_if(others.begin(), others.end(), [&](std::size_t j) {
+          return wiring.source->SameConfig(app, wiring.prefix, *wirings[j].source, wirings[j].prefix);
+        });
+        if (same == others.end()) {
+          others.push_back(i);
+          continue;
+        }
+        const auto& original = wirings[*same];
+        for (std::size_t k = 0; k < wiring.output_tags.size(); ++k) {
+          renamed.emplace(wiring.output_tags[k], original.output_tags[k]);
+        }
+        m_aliases.emplace(wiring.prefix, original.output_tags);
+        changed = true;
+      }
+    }
+    for (auto& wiring : wirings) {
+      auto it = m_aliases.find(wiring.prefix);
+      if (it != m_aliases.end()) {
+        wiring.input_tags = it->second;
+      }
+    }
+  }
+
+  /// The factories that the requested collections depend on, or all of them but the replaced ones,
+  /// m_replaced must be decided
+  std::shared_ptr<const Graph> graph(const std::vector<Wiring>& wirings, const std::vector<std::string>& requested,
+                                     const std::set<std::string>& reused) const {
+    std::set<std::string> needed;
+    if (requested.empty()) {
+      for (const auto& wiring : wirings) {
+        if (m_replaced.count(wiring.prefix) == 0) {
+          needed.insert(wiring.prefix);
+        }
+      }
+    } else {
+      std::set<std::string> sources, collections;
+      walk(wirings, requested, reused, needed, sources, collections);
+    }
+
+    auto result = std::make_shared<Graph>();
+    std::vector<const Wiring*> nodes;
+    std::map<std::string, std::size_t> producer;
+    for (const auto& wiring : wirings) {
+      if (needed.count(wiring.prefix) == 0) {
+        continue;
+      }
+      for (const auto& tag : wiring.output_tags) {
+        producer.emplace(tag, nodes.size());
+      }
+      nodes.push_back(&wiring);
+    }
+    for (const auto* wiring : nodes) {
+      result->prefixes.push_back(wiring->prefix);
+      auto& upstream = result->upstream.emplace_back();
+      auto& external = result->external.emplace_back();
+      for (const auto& tag : wiring->input_tags) {
+        auto it = producer.find(tag);
+        if (it == producer.end() || reused.count(tag) > 0) {
+          external.push_back(tag);
+        } else if (std::find(upstream.begin(), upstream.end(), it->second) == upstream.end()) {
+          upstream.push_back(it->second);
+        }
+      }
+    }
+    return result;
+  }
+
+  /// `podio:output_collections` and `omnifactory:KeepCollections`, empty if the former is
+  static std::vector<std::string> requested_collections(JApplication* app) {
+    std::vector<std::string> keep;
+    app->SetDefaultParameter("omnifactory:KeepCollections", keep,
+                             "Collections kept by omnifactory:PruneToOutputs, e.g. for processors other than the podio writer");
+    std::vector<std::string> requested;
+    if (app->GetJParameterManager()->Exists("podio:output_collections")) {
+      requested = app->GetParameterValue<std::vector<std::string>>("podio:output_collections");
+    }
+    if (!requested.empty()) {
+      requested.insert(requested.end(), keep.begin(), keep.end());
+    }
+    return requested;
+  }
+
+  static std::set<std::string> reused_collections(JApplication* app) {
+    std::vector<std::string> reused;
+    app->SetDefaultParameter("reco:reuse_input_collections", reused,
+                             "Collections of the input file used in place of the factories that make them, e.g. CentralCKFTracks to reprocess the PID");
+    return {reused.begin(), reused.end()};
+  }
+
+  /// All the wirings, m_mutex must be held
+  std::vector<Wiring> all_wirings() {
+    std::vector<Wiring> wirings;
+    for (auto* source : m_sources) {
+      for (auto& wiring : source->Wirings()) {
+        wiring.source = source;
+        wirings.push_back(std::move(wiring));
+      }
+    }
+    return wirings;
+  }
+
+  /// Walks up from the requested collections to the prefixes of the factories that make them,
+  /// and to the collections that no JOmniFactory makes or that are reused, collections are all the collections on the way
+  static void walk(const std::vector<Wiring>& wirings, const std::vector<std::string>& requested,
+                   const std::set<std::string>& reused, std::set<std::string>& needed, std::set<std::string>& sources,
+                   std::set<std::string>& collections) {
+    std::map<std::string, std::size_t> producer;
+    for (std::size_t i = 0; i < wirings.size(); ++i) {
+      for (const auto& tag : wirings[i].output_tags) {
+        producer.emplace(tag, i);
+      }
+    }
+
+    std::deque<std::string> pending(requested.begin(), requested.end());
+    while (!pending.empty()) {
+      const std::string tag = pending.front();
+      pending.pop_front();
+      if (!collections.insert(tag).second) {
+        continue;
+      }
+      auto it = producer.find(tag);
+      if (it == producer.end() || reused.count(tag) > 0) {
+        sources.insert(tag); // from the source, or from a factory that is not a JOmniFactory
+        continue;
+      }
+      const auto& wiring = wirings[it->second];
+      if (needed.insert(wiring.prefix).second) {
+        pending.insert(pending.end(), wiring.input_tags.begin(), wiring.input_tags.end());
+      }
+    }
+  }
+
+  std::mutex m_mutex;
+  std::vector<Source*> m_sources;
+  JApplication* m_decided_for{nullptr};
+  bool m_prune{false};
+  bool m_lazy{false};
+  bool m_merge{false};
+  std::map<std::string, std::vector<std::string>> m_aliases;
+  std::set<std::string> m_needed;
+  std::set<std::string> m_replaced;
+  std::set<std::string> m_needed_collections;
+  std::shared_ptr<const Graph> m_graph;
+};
+
+} // namespace eicrecon
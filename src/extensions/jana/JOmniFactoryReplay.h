@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+/**
+ * Replay of a single JOmniFactory, see the janareplay plugin.
+ *
+ * The inputs of the factory are read once from the event, then the Process()
+ * of the factory is called in a loop and its outputs are dropped, so that a
+ * profiler only sees the algorithm. The first call of the event must have
+ * gone through JANA already, which runs Init() and BeginRun().
+ */
+
+#include <JANA/JEvent.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace eicrecon {
+
+class JOmniFactoryReplayable {
+public:
+  virtual ~JOmniFactoryReplayable() = default;
+
+  virtual std::string ReplayPrefix() = 0;
+
+  /// Calls Process() `iterations` times on the inputs of `event`, and appends the wall time of each call
+  virtual void Replay(const std::shared_ptr<const JEvent>& event, std::size_t iterations,
+                      std::vector<std::uint64_t>& wall_ns) = 0;
+};
+
+} // namespace eicrecon
@@ -9,6 +9,7 @@
 #include <JANA/JApplication.h>
 #include "services/log/Log_service.h"
 #include "SpdlogExtensions.h"
+#include "algorithms/interfaces/LogMacros.h"
 
 namespace eicrecon {
     class SpdlogMixin {
@@ -26,6 +27,9 @@ namespace eicrecon {
          *
          *          void Process(...) {
          *              m_log->trace("Using logger!");
+         *
+         *              // In hot loops, the arguments are only evaluated if the level is enabled:
+         *              EICRECON_LOG_TRACE(m_log, "hit {}", expensive_summary(hit));
          *          }
          *      };
          */
@@ -14,7 +14,11 @@
 #include <boost/assign.hpp>
 #include <boost/bimap.hpp>
 
+#include <atomic>
+#include <memory>
 #include <regex>
+#include <string>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 #include <spdlog/fmt/fmt.h>
@@ -53,6 +57,61 @@ inline spdlog::level::level_enum ActsToSpdlogLevel(Acts::Logging::Level input) {
   }
 }
 
+/// Level of spdlog that an Acts level maps to, without the lookup of ActsToSpdlogLevel, for the
+/// checks of every ACTS logging macro
+constexpr spdlog::level::level_enum ActsToSpdlogLevelFast(Acts::Logging::Level input) {
+  switch (input) {
+    case Acts::Logging::VERBOSE: return spdlog::level::trace;
+    case Acts::Logging::DEBUG:   return spdlog::level::debug;
+    case Acts::Logging::INFO:    return spdlog::level::info;
+    case Acts::Logging::WARNING: return spdlog::level::warn;
+    case Acts::Logging::ERROR:   return spdlog::level::err;
+    case Acts::Logging::FATAL:   return spdlog::level::critical;
+    default:                     return spdlog::level::off;
+  }
+}
+
+/// Acts level of a spdlog level, Acts::Logging::MAX (nothing printed) for spdlog::level::off
+constexpr Acts::Logging::Level SpdlogToActsLevelFast(spdlog::level::level_enum input) {
+  switch (input) {
+    case spdlog::level::trace:    return Acts::Logging::VERBOSE;
+    case spdlog::level::debug:    return Acts::Logging::DEBUG;
+    case spdlog::level::info:     return Acts::Logging::INFO;
+    case spdlog::level::warn:     return Acts::Logging::WARNING;
+    case spdlog::level::err:      return Acts::Logging::ERROR;
+    case spdlog::level::critical: return Acts::Logging::FATAL;
+    default:                      return Acts::Logging::MAX;
+  }
+}
+
+/// @brief filter policy that follows the level of a spdlog logger
+///
+/// The ACTS logging macros ask the filter policy before they build the
+/// message, so the messages that spdlog would drop are not formatted at all.
+/// The level is read from the spdlog logger on every check, and so follows
+/// any later change of it.
+class SpdlogFilterPolicy final : public Acts::Logging::OutputFilterPolicy {
+  public:
+    explicit SpdlogFilterPolicy(std::shared_ptr<spdlog::logger> out) : m_out(std::move(out)) {}
+
+    bool doPrint(const Level& lvl) const override {
+      return m_out->should_log(ActsToSpdlogLevelFast(lvl));
+    }
+
+    Level level() const override { return SpdlogToActsLevelFast(m_out->level()); }
+
+    /// Clones at the current level, e.g. of Logger::cloneWithSuffix(), go on following spdlog
+    std::unique_ptr<OutputFilterPolicy> clone(Level level) const override {
+      if (level == this->level()) {
+        return std::make_unique<SpdlogFilterPolicy>(m_out);
+      }
+      return std::make_unique<DefaultFilterPolicy>(level);
+    }
+
+  private:
+    std::shared_ptr<spdlog::logger> m_out;
+};
+
 /// @brief default print policy for debug messages
 ///
 /// This class allows to print debug messages without further modifications to
@@ -65,19 +124,18 @@ class SpdlogPrintPolicy final : public Acts::Logging::OutputPrintPolicy {
     ///
     /// @pre @p out is non-zero
     explicit SpdlogPrintPolicy(std::shared_ptr<spdlog::logger> out, std::vector<std::string> suppressions = {})
-    : m_out(out) {
-      std::transform(suppressions.begin(), suppressions.end(), std::back_inserter(m_suppressions),
-        [](const std::string& supp_string) {
-          return std::make_tuple(supp_string, std::regex(supp_string), 0, Acts::Logging::INFO);
-        }
-      );
+    : m_out(out), m_suppressions(suppressions.size()) {
+      for (std::size_t i = 0; i < suppressions.size(); ++i) {
+        m_suppressions[i].string = suppressions[i];
+        m_suppressions[i].regex = std::regex(suppressions[i]);
+      }
     }
 
     /// @brief destructor
     ~SpdlogPrintPolicy() {
-      for (const auto& [supp_string, supp_regex, supp_count, supp_level] : m_suppressions) {
-        if (supp_count > 0) {
-          m_out->log(ActsToSpdlogLevel(supp_level), "\"{}\" suppressed {} times", supp_string, supp_count);
+      for (const auto& suppression : m_suppressions) {
+        if (suppression.count > 0) {
+          m_out->log(ActsToSpdlogLevelFast(suppression.level), "\"{}\" suppressed {} times", suppression.string, suppression.count.load());
         }
       }
     }
@@ -87,14 +145,16 @@ class SpdlogPrintPolicy final : public Acts::Logging::OutputPrintPolicy {
     /// @param [in] lvl   debug level of debug message
     /// @param [in] input text of debug message
     void flush(const Level& lvl, const std::string& input) final {
-      for (auto& [supp_string, supp_regex, supp_count, supp_level] : m_suppressions) {
-        if (std::regex_search(input, supp_regex)) {
-          supp_count++;
-          supp_level = std::max(lvl, supp_level);
+      for (auto& suppression : m_suppressions) {
+        if (std::regex_search(input, suppression.regex)) {
+          suppression.count.fetch_add(1, std::memory_order_relaxed);
+          auto supp_level = suppression.level.load(std::memory_order_relaxed);
+          while (lvl > supp_level && !suppression.level.compare_exchange_weak(supp_level, lvl, std::memory_order_relaxed)) {
+          }
           return;
         }
       }
-      m_out->log(ActsToSpdlogLevel(lvl), input);
+      m_out->log(ActsToSpdlogLevelFast(lvl), input);
       if (lvl >= getFailureThreshold()) {
         throw ThresholdFailure(
             "Previous debug message exceeds the "
@@ -131,8 +191,14 @@ class SpdlogPrintPolicy final : public Acts::Logging::OutputPrintPolicy {
     /// pointer to destination output stream
     std::shared_ptr<spdlog::logger> m_out;
 
-    /// regexes for messages to be suppressed
-    std::vector<std::tuple<std::string, std::regex, std::size_t, Acts::Logging::Level>> m_suppressions;
+    /// regexes for messages to be suppressed, counted by all the threads that share the logger
+    struct Suppression {
+      std::string string;
+      std::regex regex;
+      std::atomic<std::size_t> count{0};
+      std::atomic<Acts::Logging::Level> level{Acts::Logging::INFO};
+    };
+    std::vector<Suppression> m_suppressions;
 };
 
 inline std::unique_ptr<const Acts::Logger> getSpdlogLogger(
@@ -140,11 +206,10 @@ inline std::unique_ptr<const Acts::Logger> getSpdlogLogger(
     std::shared_ptr<spdlog::logger> log,
     std::vector<std::string> suppressions = {}) {
 
-  const Acts::Logging::Level lvl = SpdlogToActsLevel(log->level());
   auto output = std::make_unique<Acts::Logging::NamedOutputDecorator>(
       std::make_unique<SpdlogPrintPolicy>(log, suppressions),
       name);
-  auto print = std::make_unique<DefaultFilterPolicy>(lvl);
+  auto print = std::make_unique<SpdlogFilterPolicy>(log);
   return std::make_unique<const Acts::Logger>(std::move(output), std::move(print));
 }
 
@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <span>
+#include <vector>
+
 #include "algorithms/calorimetry/CalorimeterClusterRecoCoG.h"
 #include "services/algorithms_init/AlgorithmsInit_service.h"
 #include "extensions/jana/JOmniFactory.h"
@@ -18,11 +22,17 @@ public:
 private:
     std::unique_ptr<AlgoT> m_algo;
 
-    PodioInput<edm4eic::ProtoCluster> m_proto_input {this};
+    // one or several proto-cluster collections of the same mc hits, e.g. the
+    // truth and the island clusters, with one cluster and one association
+    // output each, in the same order
+    VariadicPodioInput<edm4eic::ProtoCluster> m_proto_input {this};
     PodioInput<edm4hep::SimCalorimeterHit> m_mchits_input {this};
 
-    PodioOutput<edm4eic::Cluster> m_cluster_output {this};
-    PodioOutput<edm4eic::MCRecoClusterParticleAssociation> m_assoc_output {this};
+    VariadicPodioOutput<edm4eic::Cluster> m_cluster_output {this};
+    VariadicPodioOutput<edm4eic::MCRecoClusterParticleAssociation> m_assoc_output {this};
+
+    std::vector<AlgoT::Input> m_inputs;
+    std::vector<AlgoT::Output> m_outputs;
 
     ParameterRef<std::string> m_energyWeight {this, "energyWeight", config().energyWeight};
     ParameterRef<double> m_samplingFraction {this, "samplingFraction", config().sampFrac};
@@ -30,11 +40,15 @@ private:
     ParameterRef<std::vector<double>> m_logWeightBaseCoeffs {this, "logWeightBaseCoeffs", config().logWeightBaseCoeffs};
     ParameterRef<double> m_logWeightBase_Eref {this, "logWeightBase_Eref", config().logWeightBase_Eref};
     ParameterRef<bool> m_enableEtaBounds {this, "enableEtaBounds", config().enableEtaBounds};
+    ParameterRef<bool> m_singlePrecision {this, "singlePrecision", config().singlePrecision};
 
     Service<AlgorithmsInit_service> m_algorithmsInit {this};
 
 public:
     void Configure() {
+        if (m_cluster_output.collection_names.size() != m_proto_input.collection_names.size()) {
+            throw JException("%s: Expected one cluster and one association output per proto-cluster input", GetPrefix().c_str());
+        }
         m_algo = std::make_unique<AlgoT>(GetPrefix());
         m_algo->level(static_cast<algorithms::LogLevel>(logger()->level()));
         m_algo->applyConfig(config());
@@ -45,8 +59,15 @@ public:
     }
 
     void Process(int64_t run_number, uint64_t event_number) {
-        m_algo->process({m_proto_input(), m_mchits_input()},
-                        {m_cluster_output().get(), m_assoc_output().get()});
+        const auto protos = m_proto_input();
+        m_inputs.clear();
+        m_outputs.clear();
+        for (std::size_t i = 0; i < protos.size(); ++i) {
+            m_inputs.push_back({protos[i], m_mchits_input()});
+            // the associations nobody asks for are left empty
+            m_outputs.push_back({m_cluster_output()[i].get(), m_assoc_output.IsNeeded(i) ? m_assoc_output()[i].get() : nullptr});
+        }
+        m_algo->process(std::span<const AlgoT::Input>(m_inputs), std::span<const AlgoT::Output>(m_outputs));
     }
 };
 
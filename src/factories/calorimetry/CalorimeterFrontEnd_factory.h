@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <edm4eic/CalorimeterHitCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
+#include <edm4hep/RawCalorimeterHitCollection.h>
+#include <edm4hep/SimCalorimeterHitCollection.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "algorithms/calorimetry/CalorimeterFrontEnd.h"
+#include "algorithms/calorimetry/CalorimeterFrontEndConfig.h"
+#include "extensions/jana/JOmniFactory.h"
+#include "services/algorithms_init/AlgorithmsInit_service.h"
+
+namespace eicrecon {
+
+/**
+ * CalorimeterFrontEnd in one factory, from the sim hits to the hits for the
+ * clustering, instead of the CalorimeterHitDigi, CalorimeterHitReco and
+ * CalorimeterHitsMerger factories.
+ *
+ * The output tags are the reconstructed (or merged) hits, optionally followed
+ * by the raw hits. The raw hits that are not an output, and the hits before
+ * the merging, are not put into the frame.
+ */
+class CalorimeterFrontEnd_factory :
+public JOmniFactory<CalorimeterFrontEnd_factory, CalorimeterFrontEndConfig> {
+
+private:
+    using AlgoT = eicrecon::CalorimeterFrontEnd;
+    std::unique_ptr<AlgoT> m_algo;
+
+    PodioInput<edm4hep::EventHeader> m_event_headers_input {this};
+    PodioInput<edm4hep::SimCalorimeterHit> m_sim_hits_input {this};
+
+    PodioOutput<edm4eic::CalorimeterHit> m_hits_output {this};
+    // none or one collection
+    VariadicPodioOutput<edm4hep::RawCalorimeterHit> m_raw_hits_output {this};
+
+    ParameterRef<std::vector<double>> m_energyResolutions {this, "energyResolutions", config().digi.eRes};
+    ParameterRef<double> m_timeResolution {this, "timeResolution", config().digi.tRes};
+    ParameterRef<std::string> m_corrMeanScale {this, "scaleResponse", config().digi.corrMeanScale};
+    ParameterRef<std::vector<std::string>> m_signalSumFields {this, "signalSumFields", config().digi.fields};
+    ParameterRef<double> m_thresholdFactor {this, "thresholdFactor", config().reco.thresholdFactor};
+    ParameterRef<double> m_thresholdValue {this, "thresholdValue", config().reco.thresholdValue};
+    ParameterRef<std::string> m_samplingFraction {this, "samplingFraction", config().reco.sampFrac};
+    ParameterRef<std::vector<std::string>> m_mergeFields {this, "mergeFields", config().merge.fields};
+    ParameterRef<std::vector<int>> m_mergeRefs {this, "mergeRefs", config().merge.refs};
+
+    Service<AlgorithmsInit_service> m_algorithmsInit {this};
+
+public:
+    void Configure() {
+        if (m_raw_hits_output.collection_names.size() > 1) {
+            throw JException("%s: the output tags are the hits, optionally followed by the raw hits", GetPrefix().c_str());
+        }
+        m_algo = std::make_unique<AlgoT>(GetPrefix());
+        m_algo->level(static_cast<algorithms::LogLevel>(logger()->level()));
+        m_algo->applyConfig(config());
+        m_algo->init();
+    }
+
+    void ChangeRun(int64_t run_number) {
+    }
+
+    void Process(int64_t run_number, uint64_t event_number) {
+        m_algo->process({m_event_headers_input(), m_sim_hits_input()},
+                        {m_hits_output().get(), m_raw_hits_output().empty() ? nullptr : m_raw_hits_output()[0].get()});
+    }
+};
+
+} // eicrecon
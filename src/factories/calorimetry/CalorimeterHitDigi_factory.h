@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <edm4hep/EventHeaderCollection.h>
+
 #include "algorithms/calorimetry/CalorimeterHitDigi.h"
 #include "services/algorithms_init/AlgorithmsInit_service.h"
 #include "extensions/jana/JOmniFactory.h"
@@ -16,6 +18,7 @@ public:
 private:
     std::unique_ptr<AlgoT> m_algo;
 
+    PodioInput<edm4hep::EventHeader> m_event_headers_input {this};
     PodioInput<edm4hep::SimCalorimeterHit> m_hits_input {this};
     PodioOutput<edm4hep::RawCalorimeterHit> m_hits_output {this};
 
@@ -27,6 +30,14 @@ private:
     ParameterRef<double> m_pedSigmaADC {this, "pedestalSigma", config().pedSigmaADC};
     ParameterRef<double> m_resolutionTDC {this, "resolutionTDC", config().resolutionTDC};
     ParameterRef<std::string> m_corrMeanScale {this, "scaleResponse", config().corrMeanScale};
+    ParameterRef<double> m_zeroSuppressionFactor {this, "zeroSuppressionFactor", config().zeroSuppressionFactor};
+    ParameterRef<double> m_zeroSuppressionValue {this, "zeroSuppressionValue", config().zeroSuppressionValue};
+    ParameterRef<std::string> m_pulseShape {this, "pulseShape", config().pulseShape};
+    ParameterRef<double> m_pulseShapeTau {this, "pulseShapeTau", config().pulseShapeTau};
+    ParameterRef<unsigned int> m_pulseShapeOrder {this, "pulseShapeOrder", config().pulseShapeOrder};
+    ParameterRef<double> m_samplingInterval {this, "samplingInterval", config().samplingInterval};
+    ParameterRef<unsigned int> m_nSamples {this, "numberOfSamples", config().nSamples};
+    ParameterRef<unsigned int> m_pulseTemplatePhases {this, "pulseTemplatePhases", config().pulseTemplatePhases};
     ParameterRef<std::vector<std::string>> m_fields {this, "signalSumFields", config().fields};
     ParameterRef<std::string> m_readout {this, "readoutClass", config().readout};
 
@@ -44,7 +55,7 @@ public:
     }
 
     void Process(int64_t run_nr, uint64_t event_nr) {
-        m_algo->process({m_hits_input()}, {m_hits_output().get()});
+        m_algo->process({m_event_headers_input(), m_hits_input()}, {m_hits_output().get()});
     }
 };
 
@@ -14,7 +14,8 @@ class CalorimeterIslandCluster_factory : public JOmniFactory<CalorimeterIslandCl
 public:
     using AlgoT = eicrecon::CalorimeterIslandCluster;
 private:
-    std::unique_ptr<AlgoT> m_algo;
+    // shared by all threads, process() is const and stateless
+    std::shared_ptr<const AlgoT> m_algo;
 
     PodioInput<edm4eic::CalorimeterHit> m_calo_hit_input {this};
     PodioOutput<edm4eic::ProtoCluster> m_proto_cluster_output {this};
@@ -26,9 +27,13 @@ private:
     ParameterRef<std::vector<double>> m_globallDistRPhi {this, "globalDistRPhi", config().globalDistRPhi};
     ParameterRef<std::vector<double>> m_globalDistEtaPhi {this, "globalDistEtaPhi", config().globalDistEtaPhi};
     ParameterRef<std::vector<double>> m_dimScalledLocalDistXY {this, "dimScaledLocalDistXY", config().dimScaledLocalDistXY};
+    ParameterRef<std::string> m_adjacency {this, "adjacency", config().adjacency};
     ParameterRef<std::string> m_adjacencyMatrix {this, "adjacencyMatrix", config().adjacencyMatrix};
     ParameterRef<std::string> m_readout {this, "readoutClass", config().readout};
     ParameterRef<bool> m_splitCluster {this, "splitCluster", config().splitCluster};
+    ParameterRef<std::string> m_grouping {this, "grouping", config().grouping};
+    ParameterRef<int> m_groupingTasks {this, "groupingTasks", config().groupingTasks};
+    ParameterRef<int> m_groupingMinHitsPerTask {this, "groupingMinHitsPerTask", config().groupingMinHitsPerTask};
     ParameterRef<double> m_minClusterHitEdep {this, "minClusterHitEdep", config().minClusterHitEdep};
     ParameterRef<double> m_minClusterCenterEdep {this, "minClusterCenterEdep", config().minClusterCenterEdep};
     ParameterRef<std::string> m_tepm {this, "transverseEnergyProfileMetric", config().transverseEnergyProfileMetric};
@@ -39,13 +44,16 @@ private:
 public:
 
     void Configure() {
-        m_algo = std::make_unique<AlgoT>(GetPrefix());
-        m_algo->level(static_cast<algorithms::LogLevel>(logger()->level()));
-        // Remove spaces from adjacency matrix
-        // cfg.adjacencyMatrix.erase(
-        //  std::remove_if(cfg.adjacencyMatrix.begin(), cfg.adjacencyMatrix.end(), ::isspace), cfg.adjacencyMatrix.end());
-        m_algo->applyConfig(config());
-        m_algo->init();
+        m_algo = Shared<AlgoT>([this] {
+            auto algo = std::make_unique<AlgoT>(GetPrefix());
+            algo->level(static_cast<algorithms::LogLevel>(logger()->level()));
+            // Remove spaces from adjacency matrix
+            // cfg.adjacencyMatrix.erase(
+            //  std::remove_if(cfg.adjacencyMatrix.begin(), cfg.adjacencyMatrix.end(), ::isspace), cfg.adjacencyMatrix.end());
+            algo->applyConfig(config());
+            algo->init();
+            return algo.release();
+        });
     }
 
     void ChangeRun(int64_t run_number) {
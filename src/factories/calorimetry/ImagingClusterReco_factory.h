@@ -25,6 +25,8 @@ private:
     PodioOutput<edm4eic::Cluster> m_layers_output {this};
 
     ParameterRef<int> m_trackStopLayer {this, "trackStopLayer", config().trackStopLayer};
+    ParameterRef<bool> m_singlePrecision {this, "singlePrecision", config().singlePrecision};
+    ParameterRef<int> m_reconstructionTasks {this, "reconstructionTasks", config().reconstructionTasks};
 
     Service<AlgorithmsInit_service> m_algorithmsInit {this};
 
@@ -27,6 +27,9 @@ private:
     ParameterRef<double> m_mcced {this, "minClusterCenterEdep", config().minClusterCenterEdep};
     ParameterRef<double> m_mced {this, "minClusterEdep", config().minClusterEdep};
     ParameterRef<int> m_mcnh {this, "minClusterNhits", config().minClusterNhits};
+    ParameterRef<std::string> m_grouping {this, "grouping", config().grouping};
+    ParameterRef<int> m_groupingTasks {this, "groupingTasks", config().groupingTasks};
+    ParameterRef<int> m_groupingMinHitsPerTask {this, "groupingMinHitsPerTask", config().groupingMinHitsPerTask};
 
     Service<AlgorithmsInit_service> m_algorithmsInit {this};
 
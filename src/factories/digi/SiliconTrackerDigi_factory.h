@@ -24,6 +24,11 @@ private:
 
     ParameterRef<double> m_threshold {this, "threshold", config().threshold};
     ParameterRef<double> m_timeResolution {this, "timeResolution", config().timeResolution};
+    ParameterRef<double> m_readoutWindow {this, "readoutWindow", config().readoutWindow};
+    ParameterRef<std::string> m_readout {this, "readout", config().readout};
+    ParameterRef<double> m_noiseOccupancy {this, "noiseOccupancy", config().noiseOccupancy};
+    ParameterRef<double> m_noiseEDep {this, "noiseEDep", config().noiseEDep};
+    ParameterRef<double> m_noiseTimeWindow {this, "noiseTimeWindow", config().noiseTimeWindow};
 
 public:
     void Configure() {
@@ -37,8 +42,9 @@ public:
     }
 
     void Process(int64_t run_number, uint64_t event_number) {
+        // the associations nobody asks for are left empty
         m_algo->process({m_sim_hits_input()},
-                        {m_raw_hits_output().get(),m_assoc_output().get()});
+                        {m_raw_hits_output().get(), m_assoc_output.IsNeeded() ? m_assoc_output().get() : nullptr});
     }
 };
 
@@ -11,6 +11,7 @@
 #include <algorithms/fardetectors/FarDetectorMLReconstructionConfig.h>
 
 #include "extensions/jana/JOmniFactory.h"
+#include "services/algorithms_init/AlgorithmsInit_service.h"
 #include <extensions/spdlog/SpdlogMixin.h>
 #include <spdlog/logger.h>
 #include <Evaluator/DD4hepUnits.h>
@@ -32,9 +33,13 @@ private:
     PodioOutput<edm4eic::Track>           m_track_output         {this};
 
 
+    ParameterRef<std::string> m_backend         {this, "backend",         config().backend         };
     ParameterRef<std::string> m_modelPath       {this, "modelPath",       config().modelPath       };
     ParameterRef<std::string> m_methodName      {this, "methodName",      config().methodName      };
 
+    // the ONNX sessions come from OnnxRuntimeSvc, which has to be initialized
+    Service<AlgorithmsInit_service> m_algorithmsInit {this};
+
 
 public:
     void Configure() {
@@ -26,6 +26,8 @@ private:
   ParameterRef<std::string> m_x_field {this, "xField", config().x_field};
   ParameterRef<std::string> m_y_field {this, "yField", config().y_field};
   ParameterRef<double> m_hit_time_limit {this, "hitTimeLimit", config().hit_time_limit};
+  ParameterRef<bool> m_parallel_collections {this, "parallelCollections", config().parallel_collections};
+  ParameterRef<std::size_t> m_parallel_min_hits {this, "parallelMinHits", config().parallel_min_hits};
 
 public:
 
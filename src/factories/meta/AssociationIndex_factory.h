@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <memory>
+
+#include "algorithms/interfaces/AssociationIndex.h"
+#include "extensions/jana/JOmniFactory.h"
+
+namespace eicrecon {
+
+    /// Rec and sim indices of an association collection, built only when
+    /// requested and then shared by all the consumers of the event
+    template<class T>
+    class AssociationIndex_factory : public JOmniFactory<AssociationIndex_factory<T>> {
+public:
+    using LookupT = AssociationLookup<typename T::collection_type>;
+
+private:
+    typename JOmniFactory<AssociationIndex_factory<T>>::template PodioInput<T> m_associations_input {this};
+    typename JOmniFactory<AssociationIndex_factory<T>>::template Output<LookupT> m_lookup_output {this};
+
+public:
+
+    void Configure() {
+    }
+
+    void ChangeRun(int64_t run_number) {
+    }
+
+    void Process(int64_t run_number, uint64_t event_number) {
+        auto lookup = std::make_unique<LookupT>(*m_associations_input());
+        m_lookup_output() = {lookup.release()};
+    };
+
+    };
+
+} // eicrecon
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <memory>
+
+#include "algorithms/interfaces/CollectionView.h"
+#include "extensions/jana/JOmniFactory.h"
+
+namespace eicrecon {
+
+    /// Concatenated view of collections, for consumers that only iterate the
+    /// merged elements, cf. CollectionCollector_factory for a merged collection
+    template<class T>
+    class CollectionView_factory : public JOmniFactory<CollectionView_factory<T>> {
+public:
+    using ViewT = CollectionView<typename T::collection_type>;
+
+private:
+    typename JOmniFactory<CollectionView_factory<T>>::template VariadicPodioInput<T> m_inputs {this};
+    typename JOmniFactory<CollectionView_factory<T>>::template Output<ViewT> m_output {this};
+
+public:
+
+    void Configure() {
+    }
+
+    void ChangeRun(int64_t run_number) {
+    }
+
+    void Process(int64_t run_number, uint64_t event_number) {
+        auto view = std::make_unique<ViewT>(m_inputs());
+        m_output() = {view.release()};
+    };
+
+    };
+
+} // eicrecon
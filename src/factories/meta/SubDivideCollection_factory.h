@@ -3,18 +3,21 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
 #include "algorithms/meta/SubDivideCollection.h"
 #include "services/algorithms_init/AlgorithmsInit_service.h"
 #include "extensions/jana/JOmniFactory.h"
 
 namespace eicrecon {
 
-template <class T>
-class SubDivideCollection_factory : public JOmniFactory<SubDivideCollection_factory<T>, SubDivideCollectionConfig<T>> {
+template <class T, class FunctorT = std::function<std::vector<int>(const T&)>>
+class SubDivideCollection_factory : public JOmniFactory<SubDivideCollection_factory<T, FunctorT>, SubDivideCollectionConfig<T, FunctorT>> {
 
   public:
-    using AlgoT    = eicrecon::SubDivideCollection<T>;
-    using FactoryT = JOmniFactory<SubDivideCollection_factory<T>, SubDivideCollectionConfig<T>>;
+    using AlgoT    = eicrecon::SubDivideCollection<T, FunctorT>;
+    using FactoryT = JOmniFactory<SubDivideCollection_factory<T, FunctorT>, SubDivideCollectionConfig<T, FunctorT>>;
 
   private:
 
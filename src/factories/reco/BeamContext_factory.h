@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JEvent.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "algorithms/reco/BeamConditionsSvc.h"
+#include "algorithms/reco/BeamContext.h"
+#include "extensions/jana/JOmniFactory.h"
+#include "services/algorithms_init/AlgorithmsInit_service.h"
+
+namespace eicrecon {
+
+class BeamContext_factory :
+        public JOmniFactory<BeamContext_factory> {
+
+public:
+    using AlgoT = eicrecon::BeamContextBuilder;
+private:
+    std::unique_ptr<AlgoT> m_algo;
+
+    PodioInput<edm4hep::MCParticle> m_mc_particles_input {this};
+    Output<BeamContext> m_beam_context_output {this};
+
+    Service<AlgorithmsInit_service> m_algorithmsInit {this};
+
+    /// of the current run, once known
+    std::shared_ptr<const BeamConditions> m_conditions;
+    /// for the events without beams before they are known, their context has no beams
+    BeamConditions m_no_conditions;
+
+public:
+    void Configure() {
+        m_algo = std::make_unique<AlgoT>(GetPrefix());
+        m_algo->level(static_cast<algorithms::LogLevel>(logger()->level()));
+        m_algo->init();
+    }
+
+    void ChangeRun(int64_t run_number) {
+        m_conditions.reset();
+    }
+
+    void Process(int64_t run_number, uint64_t event_number) {
+        if (!m_conditions) {
+            m_conditions = BeamConditionsSvc::instance().conditions(run_number, *m_mc_particles_input());
+        }
+        // exactly one context per event, its consumers check which beams were found
+        auto beams = std::make_unique<BeamContext>();
+        m_algo->process({m_mc_particles_input(), m_conditions ? m_conditions.get() : &m_no_conditions}, {beams.get()});
+        m_beam_context_output() = {beams.release()};
+    }
+};
+
+} // eicrecon
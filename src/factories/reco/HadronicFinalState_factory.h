@@ -10,6 +10,7 @@
 #include <utility>
 #include <vector>
 
+#include "algorithms/reco/BeamContext.h"
 #include "extensions/jana/JOmniFactory.h"
 
 namespace eicrecon {
@@ -24,7 +25,7 @@ public:
 private:
     std::unique_ptr<AlgoT> m_algo;
 
-    typename FactoryT::template PodioInput<edm4hep::MCParticle> m_mc_particles_input {this};
+    typename FactoryT::template Input<BeamContext> m_beam_context_input {this};
     typename FactoryT::template PodioInput<edm4eic::ReconstructedParticle> m_rc_particles_input {this};
     typename FactoryT::template PodioInput<edm4eic::MCRecoParticleAssociation> m_rc_particles_assoc_input {this};
     typename FactoryT::template PodioOutput<edm4eic::HadronicFinalState> m_hadronic_final_state_output {this};
@@ -40,7 +41,7 @@ public:
     }
 
     void Process(int64_t run_number, uint64_t event_number) {
-        m_algo->process({m_mc_particles_input(), m_rc_particles_input(), m_rc_particles_assoc_input()},
+        m_algo->process({m_beam_context_input.at(0), m_rc_particles_input(), m_rc_particles_assoc_input()},
                         {m_hadronic_final_state_output().get()});
     }
 };
@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <JANA/JApplication.h>
 #include <JANA/JEvent.h>
+#include <JANA/Services/JParameterManager.h>
+#include <algorithms/service.h>
 #include <edm4eic/InclusiveKinematicsCollection.h>
 #include <memory>
 #include <string>
@@ -11,6 +14,7 @@
 #include <vector>
 
 #include "algorithms/onnx/InclusiveKinematicsML.h"
+#include "algorithms/onnx/OnnxRuntimeSvc.h"
 #include "extensions/jana/JOmniFactory.h"
 
 namespace eicrecon {
@@ -45,4 +49,23 @@ public:
     }
 };
 
+/**
+ * Schedules the ONNX session of the InclusiveKinematicsML factory of a tag to
+ * be created in the background, to be called by the plugins next to adding
+ * the factory. A model set with the parameter of the factory takes
+ * precedence over the one of the configuration.
+ */
+inline void PreloadInclusiveKinematicsMLModel(JApplication* app, const std::string& tag, InclusiveKinematicsMLConfig cfg) {
+    // the parameter is prefixed by the plugin name, if any, and keys are case insensitive
+    const std::string suffix = JParameterManager::ToLower(tag + ":modelPath");
+    for (const auto& [key, param] : app->GetJParameterManager()->GetAllParameters()) {
+        const std::string lower_key = JParameterManager::ToLower(key);
+        if (lower_key == suffix || lower_key.ends_with(":" + suffix)) {
+            cfg.modelPath = param->GetValue();
+        }
+    }
+    auto& serviceSvc = algorithms::ServiceSvc::instance();
+    serviceSvc.service<OnnxRuntimeSvc>("OnnxRuntimeSvc")->preload(cfg.modelPath);
+}
+
 } // eicrecon
@@ -23,7 +23,7 @@ public:
 private:
     std::unique_ptr<AlgoT> m_algo;
 
-    PodioInput<edm4hep::MCParticle> m_mc_particles_input {this};
+    Input<BeamContext> m_beam_context_input {this};
     PodioOutput<edm4eic::InclusiveKinematics> m_inclusive_kinematics_output {this};
 
 public:
@@ -37,7 +37,7 @@ public:
     }
 
     void Process(int64_t run_number, uint64_t event_number) {
-        m_algo->process({m_mc_particles_input()}, {m_inclusive_kinematics_output().get()});
+        m_algo->process({m_beam_context_input.at(0)}, {m_inclusive_kinematics_output().get()});
     }
 };
 
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <edm4eic/ClusterCollection.h>
+#include <edm4eic/MCRecoParticleAssociationCollection.h>
+#include <edm4eic/ReconstructedParticleCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <memory>
+
+#include "algorithms/reco/MCParticleSmearing.h"
+#include "algorithms/reco/MCParticleSmearingConfig.h"
+#include "extensions/jana/JOmniFactory.h"
+#include "services/algorithms_init/AlgorithmsInit_service.h"
+
+namespace eicrecon {
+
+class MCParticleSmearing_factory : public JOmniFactory<MCParticleSmearing_factory, MCParticleSmearingConfig> {
+private:
+    using AlgoT = eicrecon::MCParticleSmearing;
+    std::unique_ptr<AlgoT> m_algo;
+
+    PodioInput<edm4hep::EventHeader> m_event_headers_input {this};
+    PodioInput<edm4hep::MCParticle> m_mc_particles_input {this};
+
+    PodioOutput<edm4eic::ReconstructedParticle> m_charged_output {this};
+    PodioOutput<edm4eic::MCRecoParticleAssociation> m_charged_assocs_output {this};
+    PodioOutput<edm4eic::ReconstructedParticle> m_neutral_output {this};
+    PodioOutput<edm4eic::MCRecoParticleAssociation> m_neutral_assocs_output {this};
+    PodioOutput<edm4eic::Cluster> m_clusters_output {this};
+
+    ParameterRef<double> m_trackingEtaMin {this, "trackingEtaMin", config().trackingEtaMin, "Lowest eta of the tracked particles"};
+    ParameterRef<double> m_trackingEtaMax {this, "trackingEtaMax", config().trackingEtaMax, "Highest eta of the tracked particles"};
+    ParameterRef<double> m_trackingPtMin {this, "trackingPtMin", config().trackingPtMin, "Lowest transverse momentum of the tracked particles [GeV]"};
+    ParameterRef<double> m_momentumResolutionA {this, "momentumResolutionA", config().momentumResolutionA, "Term of sigma(p)/p proportional to p [1/GeV]"};
+    ParameterRef<double> m_momentumResolutionB {this, "momentumResolutionB", config().momentumResolutionB, "Constant term of sigma(p)/p"};
+    ParameterRef<double> m_angularResolutionA {this, "angularResolutionA", config().angularResolutionA, "Term of the angular resolution proportional to 1/p [rad GeV]"};
+    ParameterRef<double> m_angularResolutionB {this, "angularResolutionB", config().angularResolutionB, "Constant term of the angular resolution [rad]"};
+    ParameterRef<double> m_ecalEtaMin {this, "ecalEtaMin", config().ecalEtaMin, "Lowest eta of the electrons and photons in the calorimeters"};
+    ParameterRef<double> m_ecalEtaMax {this, "ecalEtaMax", config().ecalEtaMax, "Highest eta of the electrons and photons in the calorimeters"};
+    ParameterRef<double> m_ecalEnergyMin {this, "ecalEnergyMin", config().ecalEnergyMin, "Lowest energy of the clusters [GeV]"};
+    ParameterRef<double> m_ecalResolutionA {this, "ecalResolutionA", config().ecalResolutionA, "Stochastic term of sigma(E)/E [sqrt(GeV)]"};
+    ParameterRef<double> m_ecalResolutionB {this, "ecalResolutionB", config().ecalResolutionB, "Constant term of sigma(E)/E"};
+    ParameterRef<double> m_ecalDistance {this, "ecalDistance", config().ecalDistance, "Distance of the clusters from the origin [mm]"};
+
+    Service<AlgorithmsInit_service> m_algorithmsInit {this};
+
+public:
+    void Configure() {
+        m_algo = std::make_unique<AlgoT>(GetPrefix());
+        m_algo->level(static_cast<algorithms::LogLevel>(logger()->level()));
+        m_algo->applyConfig(config());
+        m_algo->init();
+    }
+
+    void ChangeRun(int64_t run_number) {
+    }
+
+    void Process(int64_t run_number, uint64_t event_number) {
+        m_algo->process({m_event_headers_input(), m_mc_particles_input()},
+                        {m_charged_output().get(), m_charged_assocs_output().get(),
+                         m_neutral_output().get(), m_neutral_assocs_output().get(),
+                         m_clusters_output().get()});
+    }
+};
+
+} // eicrecon
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <edm4eic/ClusterCollection.h>
+#include <edm4eic/ReconstructedParticleCollection.h>
+#include <edm4eic/TrackSegmentCollection.h>
+#include <memory>
+#include <string>
+
+#include "algorithms/reco/TrackClusterMatching.h"
+#include "algorithms/reco/TrackClusterMatchingConfig.h"
+#include "extensions/jana/JOmniFactory.h"
+#include "services/algorithms_init/AlgorithmsInit_service.h"
+
+namespace eicrecon {
+
+class TrackClusterMatching_factory : public JOmniFactory<TrackClusterMatching_factory, TrackClusterMatchingConfig> {
+private:
+    using AlgoT = eicrecon::TrackClusterMatching;
+    std::unique_ptr<AlgoT> m_algo;
+
+    PodioInput<edm4eic::ReconstructedParticle> m_particles_input {this};
+    PodioInput<edm4eic::TrackSegment> m_projections_input {this};
+    PodioInput<edm4eic::Cluster> m_clusters_input {this};
+
+    PodioOutput<edm4eic::ReconstructedParticle> m_particles_output {this};
+
+    ParameterRef<std::string> m_calorimeterID {this, "calorimeterID", config().calorimeterID, "DD4hep constant of the system ID of the calorimeter"};
+    ParameterRef<int> m_surfaceLayer {this, "surfaceLayer", config().surfaceLayer, "Target surface of the track projections to the calorimeter, counted from 1"};
+    ParameterRef<bool> m_etaPhi {this, "etaPhi", config().etaPhi, "Match in (eta, phi), or in (x, y) on a disc surface"};
+    ParameterRef<double> m_resolution0 {this, "resolution0", config().resolution0, "Resolution of the match in eta, or x [mm]"};
+    ParameterRef<double> m_resolution1 {this, "resolution1", config().resolution1, "Resolution of the match in phi [rad], or y [mm]"};
+    ParameterRef<double> m_maxChi2 {this, "maxChi2", config().maxChi2, "Largest chi2 of a match"};
+
+    Service<AlgorithmsInit_service> m_algorithmsInit {this};
+
+public:
+    void Configure() {
+        m_algo = std::make_unique<AlgoT>(GetPrefix());
+        m_algo->level(static_cast<algorithms::LogLevel>(logger()->level()));
+        m_algo->applyConfig(config());
+        m_algo->init();
+    }
+
+    void ChangeRun(int64_t run_number) {
+    }
+
+    void Process(int64_t run_number, uint64_t event_number) {
+        m_algo->process({m_particles_input(), m_projections_input(), m_clusters_input()},
+                        {m_particles_output().get()});
+    }
+};
+
+} // eicrecon
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <edm4eic/MCRecoTrackerHitAssociationCollection.h>
+#include <edm4eic/RawTrackerHitCollection.h>
+#include <edm4eic/TrackerHitCollection.h>
+#include <edm4hep/SimTrackerHitCollection.h>
+#include <memory>
+#include <string>
+
+#include "algorithms/digi/SiliconTrackerDigi.h"
+#include "algorithms/digi/SiliconTrackerDigiConfig.h"
+#include "algorithms/tracking/TrackerHitReconstruction.h"
+#include "algorithms/tracking/TrackerHitReconstructionConfig.h"
+#include "extensions/jana/JOmniFactory.h"
+#include "services/algorithms_init/AlgorithmsInit_service.h"
+#include "services/geometry/dd4hep/DD4hep_service.h"
+
+
+namespace eicrecon {
+
+struct SiliconTrackerDigiReconstructionConfig {
+    SiliconTrackerDigiConfig digi;
+    TrackerHitReconstructionConfig reco;
+};
+
+/**
+ * SiliconTrackerDigi followed by TrackerHitReconstruction in one factory,
+ * from the sim hits to the hits for the tracking.
+ *
+ * The output tags are the reconstructed hits, optionally followed by the raw
+ * hits and their sim hit associations. Without the latter two, the raw hits
+ * are kept in collections of the factory that are reused for every event,
+ * instead of being put into the frame and read back by a second factory.
+ */
+class SiliconTrackerDigiReconstruction_factory :
+public JOmniFactory<SiliconTrackerDigiReconstruction_factory, SiliconTrackerDigiReconstructionConfig> {
+
+public:
+    using AlgoT = eicrecon::SiliconTrackerDigi;
+private:
+    std::unique_ptr<AlgoT> m_digi;
+    TrackerHitReconstruction m_reco;
+
+    PodioInput<edm4hep::SimTrackerHit> m_sim_hits_input {this};
+
+    PodioOutput<edm4eic::TrackerHit> m_rec_hits_output {this};
+    // none or one collection each
+    VariadicPodioOutput<edm4eic::RawTrackerHit> m_raw_hits_output {this};
+    VariadicPodioOutput<edm4eic::MCRecoTrackerHitAssociation> m_assoc_output {this};
+
+    ParameterRef<double> m_threshold {this, "threshold", config().digi.threshold};
+    ParameterRef<double> m_timeResolution {this, "timeResolution", config().digi.timeResolution};
+    ParameterRef<double> m_readoutWindow {this, "readoutWindow", config().digi.readoutWindow};
+    ParameterRef<std::string> m_readout {this, "readout", config().digi.readout};
+    ParameterRef<double> m_noiseOccupancy {this, "noiseOccupancy", config().digi.noiseOccupancy};
+    ParameterRef<double> m_noiseEDep {this, "noiseEDep", config().digi.noiseEDep};
+    ParameterRef<double> m_noiseTimeWindow {this, "noiseTimeWindow", config().digi.noiseTimeWindow};
+    ParameterRef<float> m_hitTimeResolution {this, "hitTimeResolution", config().reco.timeResolution};
+    ParameterRef<std::string> m_timeOffsetsFile {this, "timeOffsetsFile", config().reco.timeOffsetsFile};
+    ParameterRef<float> m_timeWalkCoefficient {this, "timeWalkCoefficient", config().reco.timeWalkCoefficient};
+
+    Service<AlgorithmsInit_service> m_algorithmsInit {this};
+    Service<DD4hep_service> m_geoSvc {this};
+
+    // the raw hits of the events whose raw hits are not outputs
+    edm4eic::RawTrackerHitCollection m_raw_hits;
+
+public:
+    void Configure() {
+        if (m_raw_hits_output.collection_names.size() != m_assoc_output.collection_names.size()
+            || m_raw_hits_output.collection_names.size() > 1) {
+            throw JException("%s: the output tags are the hits, optionally followed by the raw hits and the associations", GetPrefix().c_str());
+        }
+        m_digi = std::make_unique<AlgoT>(GetPrefix());
+        m_digi->level(static_cast<algorithms::LogLevel>(logger()->level()));
+        m_digi->applyConfig(config().digi);
+        m_digi->init();
+
+        m_reco.applyConfig(config().reco);
+        m_reco.init(m_geoSvc().converter(), logger());
+    }
+
+    void ChangeRun(int64_t run_number) {
+    }
+
+    void Process(int64_t run_number, uint64_t event_number) {
+        if (m_raw_hits_output().empty()) {
+            m_raw_hits.clear();
+            // the raw hits are not outputs, so neither are their associations
+            m_digi->process({m_sim_hits_input()}, {&m_raw_hits, nullptr});
+            m_rec_hits_output() = m_reco.process(m_raw_hits);
+        } else {
+            m_digi->process({m_sim_hits_input()}, {m_raw_hits_output()[0].get(), m_assoc_output.IsNeeded(0) ? m_assoc_output()[0].get() : nullptr});
+            m_rec_hits_output() = m_reco.process(*m_raw_hits_output()[0]);
+        }
+    }
+};
+
+} // eicrecon
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "algorithms/tracking/TrackerHitReconstruction.h"
 #include "services/geometry/dd4hep/DD4hep_service.h"
 #include "extensions/jana/JOmniFactory.h"
@@ -19,6 +21,8 @@ public JOmniFactory<TrackerHitReconstruction_factory, TrackerHitReconstructionCo
     PodioOutput<edm4eic::TrackerHit> m_rec_hits_output {this};
 
     ParameterRef<float> m_timeResolution {this, "timeResolution", config().timeResolution};
+    ParameterRef<std::string> m_timeOffsetsFile {this, "timeOffsetsFile", config().timeOffsetsFile};
+    ParameterRef<float> m_timeWalkCoefficient {this, "timeWalkCoefficient", config().timeWalkCoefficient};
 
     Service<DD4hep_service> m_geoSvc {this};
 
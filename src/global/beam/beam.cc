@@ -25,12 +25,13 @@ extern "C" {
     std::vector<std::string> outCollections{"MCBeamElectrons","MCBeamProtons","MCScatteredElectrons","MCScatteredProtons"};
     std::vector<std::vector<int>> values{{4,11},{4,2212},{1,11},{1,2212}};
 
-    app->Add(new JOmniFactoryGeneratorT<SubDivideCollection_factory<edm4hep::MCParticle>>(
+    using BeamParticleSplit = ValueSplit<&edm4hep::MCParticle::getGeneratorStatus,&edm4hep::MCParticle::getPDG>;
+    app->Add(new JOmniFactoryGeneratorT<SubDivideCollection_factory<edm4hep::MCParticle, BeamParticleSplit>>(
         "BeamParticles",
         {"MCParticles"},
         outCollections,
         {
-          .function = ValueSplit<&edm4hep::MCParticle::getGeneratorStatus,&edm4hep::MCParticle::getPDG>{values},
+          .function = BeamParticleSplit{values},
         },
         app
       )
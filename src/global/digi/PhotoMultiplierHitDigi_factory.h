@@ -6,6 +6,7 @@
 #include <JANA/JEvent.h>
 #include <edm4eic/MCRecoTrackerHitAssociationCollection.h>
 #include <edm4eic/RawTrackerHitCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
 #include <memory>
 #include <string>
 #include <utility>
@@ -32,6 +33,7 @@ public:
 private:
     std::unique_ptr<AlgoT> m_algo;
 
+    PodioInput<edm4hep::EventHeader> m_event_headers_input {this};
     PodioInput<edm4hep::SimTrackerHit> m_sim_hits_input {this};
     PodioOutput<edm4eic::RawTrackerHit> m_raw_hits_output {this};
     PodioOutput<edm4eic::MCRecoTrackerHitAssociation> m_raw_assocs_output {this};
@@ -64,6 +66,10 @@ public:
             m_algo->SetVisitRngCellIDs(
                 [this] (std::function<void(PhotoMultiplierHitDigi::CellIDType)> lambda, float p) { m_RichGeoSvc().GetReadoutGeo(GetPluginName())->VisitAllRngPixels(lambda, p); }
                 );
+            // sample noise from all the pixels instead, where they can be enumerated
+            if (auto pixels = m_RichGeoSvc().GetPixelTable(GetPluginName())) {
+                m_algo->SetNoiseCellIDs(pixels->CellIDs()); // the service keeps the table alive
+            }
             m_algo->SetPixelGapMask(
                 [this] (PhotoMultiplierHitDigi::CellIDType cellID, dd4hep::Position pos) { return m_RichGeoSvc().GetReadoutGeo(GetPluginName())->PixelGapMask(cellID, pos); }
                 );
@@ -77,8 +83,8 @@ public:
     }
 
     void Process(int64_t run_number, uint64_t event_number) {
-        m_algo->process({m_sim_hits_input()},
-                        {m_raw_hits_output().get(), m_raw_assocs_output().get()});
+        m_algo->process({m_event_headers_input(), m_sim_hits_input()},
+                        {m_raw_hits_output().get(), m_raw_assocs_output.IsNeeded() ? m_raw_assocs_output().get() : nullptr});
     }
 };
 
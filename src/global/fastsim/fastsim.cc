@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+// The fast-simulation chain of `eicrecon --profile=fastsim`, from the MC particles to the
+// inclusive kinematics and the jets, without the geometry. It takes the place of the reco,
+// tracking, pid and detector plugins, and produces the same collections as them.
+
+#include <JANA/JApplication.h>
+#include <edm4eic/EDM4eicVersion.h>
+#include <edm4eic/MCRecoParticleAssociation.h>
+#include <edm4eic/ReconstructedParticle.h>
+#include <string>
+
+#include "algorithms/interfaces/WithPodConfig.h"
+#if EDM4EIC_VERSION_MAJOR >= 6
+#include "algorithms/reco/HadronicFinalState.h"
+#include "algorithms/reco/InclusiveKinematicsDA.h"
+#include "algorithms/reco/InclusiveKinematicsElectron.h"
+#include "algorithms/reco/InclusiveKinematicsJB.h"
+#include "algorithms/reco/InclusiveKinematicsSigma.h"
+#include "algorithms/reco/InclusiveKinematicseSigma.h"
+#endif
+#include "extensions/jana/JOmniFactoryGeneratorT.h"
+#include "factories/meta/AssociationIndex_factory.h"
+#include "factories/meta/CollectionCollector_factory.h"
+#include "factories/reco/BeamContext_factory.h"
+#if EDM4EIC_VERSION_MAJOR >= 6
+#include "factories/reco/HadronicFinalState_factory.h"
+#include "factories/reco/InclusiveKinematicsReconstructed_factory.h"
+#endif
+#include "factories/reco/InclusiveKinematicsTruth_factory.h"
+#include "factories/reco/JetReconstruction_factory.h"
+#include "factories/reco/MCParticleSmearing_factory.h"
+#include "global/pid_lut/PIDLookupTables.h"
+#include "global/pid_lut/PIDLookup_factory.h"
+#include "global/reco/BeamConditions.h"
+#include "global/reco/ChargedReconstructedParticleSelector_factory.h"
+#include "global/reco/MC2SmearedParticle_factory.h"
+#include "global/reco/ReconstructedElectrons_factory.h"
+#include "global/reco/ScatteredElectronsTruth_factory.h"
+
+#if EDM4EIC_VERSION_MAJOR >= 6
+namespace {
+
+  template <typename KinematicsT>
+  void AddInclusiveKinematics(JApplication* app, const std::string& tag) {
+    using namespace eicrecon;
+    app->Add(new JOmniFactoryGeneratorT<InclusiveKinematicsReconstructed_factory<KinematicsT>>(
+        tag,
+        {"BeamContext", "ScatteredElectronsTruth", "HadronicFinalState"},
+        {tag},
+        app
+    ));
+  }
+
+}
+#endif
+
+extern "C" {
+void InitPlugin(JApplication *app) {
+    InitJANAPlugin(app);
+
+    using namespace eicrecon;
+
+    AddBeamConditionsSvc(app);
+
+    app->Add(new JOmniFactoryGeneratorT<MC2SmearedParticle_factory>(
+        "GeneratedParticles",
+        {"MCParticles"},
+        {"GeneratedParticles"},
+        app
+    ));
+
+    // Parametrised tracking and electromagnetic calorimetry, in place of the tracking
+    // and of the matching of the clusters
+    app->Add(new JOmniFactoryGeneratorT<MCParticleSmearing_factory>(
+        "FastSimParticles",
+        {"EventHeader", "MCParticles"},
+        {
+          "ReconstructedChargedWithoutPIDParticles",
+          "ReconstructedChargedWithoutPIDParticleAssociations",
+          "ReconstructedNeutralParticles",
+          "ReconstructedNeutralParticleAssociations",
+          "FastSimEcalClusters",
+        },
+        {},
+        app
+    ));
+
+    // PID of all the PID systems from their lookup tables, chained in the order of the
+    // detector plugins. The system IDs are 0 without the geometry.
+    const struct {
+      const char* tag;
+      PIDLookupConfig cfg;
+      const char* input;
+      const char* output;
+      const char* particle_ids;
+    } lookups[] = {
+      {"RICHEndcapNLUTPID", PFRICHLookupConfig(0), "ChargedWithoutPID", "ChargedWithPFRICHPID", "RICHEndcapNParticleIDs"},
+      {"CombinedTOFLUTPID", BTOFLookupConfig(0), "ChargedWithPFRICHPID", "ChargedWithPFRICHTOFPID", "CombinedTOFParticleIDs"},
+      {"DIRCLUTPID", DIRCLookupConfig(0), "ChargedWithPFRICHTOFPID", "ChargedWithPFRICHTOFDIRCPID", "DIRCParticleIDs"},
+      {"DRICHLUTPID", DRICHLookupConfig(0), "ChargedWithPFRICHTOFDIRCPID", "Charged", "DRICHParticleIDs"},
+    };
+    for (const auto& lookup : lookups) {
+      const std::string input = std::string("Reconstructed") + lookup.input;
+      const std::string output = std::string("Reconstructed") + lookup.output;
+      app->Add(new JOmniFactoryGeneratorT<PIDLookup_factory>(
+          lookup.tag,
+          {input + "Particles", input + "ParticleAssociations"},
+          {output + "Particles", output + "ParticleAssociations", lookup.particle_ids},
+          lookup.cfg,
+          app
+      ));
+      PreloadPIDLookupTable(app, lookup.tag, lookup.cfg);
+    }
+
+    app->Add(new JOmniFactoryGeneratorT<CollectionCollector_factory<edm4eic::ReconstructedParticle>>(
+        "ReconstructedParticles",
+        {"ReconstructedChargedParticles", "ReconstructedNeutralParticles"},
+        {"ReconstructedParticles"},
+        app
+    ));
+    app->Add(new JOmniFactoryGeneratorT<CollectionCollector_factory<edm4eic::MCRecoParticleAssociation>>(
+        "ReconstructedParticleAssociations",
+        {"ReconstructedChargedParticleAssociations", "ReconstructedNeutralParticleAssociations"},
+        {"ReconstructedParticleAssociations"},
+        app
+    ));
+    app->Add(new JOmniFactoryGeneratorT<AssociationIndex_factory<edm4eic::MCRecoParticleAssociation>>(
+        "ReconstructedChargedParticleAssociationIndex",
+        {"ReconstructedChargedParticleAssociations"},
+        {"ReconstructedChargedParticleAssociationIndex"},
+        app
+    ));
+
+    app->Add(new JOmniFactoryGeneratorT<ReconstructedElectrons_factory>(
+        "ReconstructedElectrons",
+        {"ReconstructedParticles"},
+        {"ReconstructedElectrons"},
+        {},
+        app
+    ));
+    app->Add(new JOmniFactoryGeneratorT<ReconstructedElectrons_factory>(
+        "ReconstructedElectronsForDIS",
+        {"ReconstructedParticles"},
+        {"ReconstructedElectronsForDIS"},
+        {
+          .min_energy_over_momentum = 0.7, // GeV
+          .max_energy_over_momentum = 1.3  // GeV
+        },
+        app
+    ));
+
+    // Inclusive kinematics
+    app->Add(new JOmniFactoryGeneratorT<BeamContext_factory>(
+        "BeamContext",
+        {"MCParticles"},
+        {"BeamContext"},
+        app
+    ));
+    app->Add(new JOmniFactoryGeneratorT<InclusiveKinematicsTruth_factory>(
+        "InclusiveKinematicsTruth",
+        {"BeamContext"},
+        {"InclusiveKinematicsTruth"},
+        app
+    ));
+    app->Add(new JOmniFactoryGeneratorT<ScatteredElectronsTruth_factory>(
+        "ScatteredElectronsTruth",
+        {"MCParticles", "ReconstructedChargedParticles", "ReconstructedChargedParticleAssociationIndex"},
+        {"ScatteredElectronsTruth"},
+        app
+    ));
+#if EDM4EIC_VERSION_MAJOR >= 6
+    app->Add(new JOmniFactoryGeneratorT<HadronicFinalState_factory<HadronicFinalState>>(
+        "HadronicFinalState",
+        {"BeamContext", "ReconstructedParticles", "ReconstructedParticleAssociations"},
+        {"HadronicFinalState"},
+        app
+    ));
+    AddInclusiveKinematics<InclusiveKinematicsElectron>(app, "InclusiveKinematicsElectron");
+    AddInclusiveKinematics<InclusiveKinematicsJB>(app, "InclusiveKinematicsJB");
+    AddInclusiveKinematics<InclusiveKinematicsDA>(app, "InclusiveKinematicsDA");
+    AddInclusiveKinematics<InclusiveKinematicseSigma>(app, "InclusiveKinematicseSigma");
+    AddInclusiveKinematics<InclusiveKinematicsSigma>(app, "InclusiveKinematicsSigma");
+#endif
+
+    // Jets
+    app->Add(new JOmniFactoryGeneratorT<ChargedReconstructedParticleSelector_factory>(
+        "GeneratedChargedParticles",
+        {"GeneratedParticles"},
+        {"GeneratedChargedParticles"},
+        app
+    ));
+    for (const std::string particles : {"Generated", "GeneratedCharged", "Reconstructed", "ReconstructedCharged"}) {
+      app->Add(new JOmniFactoryGeneratorT<JetReconstruction_factory<edm4eic::ReconstructedParticle>>(
+          particles + "Jets",
+          {particles + "Particles"},
+          {particles + "Jets"},
+          {},
+          app
+      ));
+    }
+}
+} // extern "C"
@@ -36,6 +36,7 @@ private:
 
     ParameterRef<unsigned int> m_numRIndexBins {this, "numRIndexBins", config().numRIndexBins, ""};
     ParameterRef<std::vector<int>> m_pdgList {this, "pdgList", config().pdgList, ""};
+    ParameterRef<unsigned int> m_numTasks {this, "numTasks", config().numTasks, "Parallel tasks over the charged particles of an event, each with an IRT geometry of its own for the event"};
 
     ParameterRef<double> m_aerogel_referenceRIndex {this, "aerogel:referenceRIndex", config().radiators["Aerogel"].referenceRIndex, ""};
     ParameterRef<double> m_aerogel_attenuation {this, "aerogel:attenuation", config().radiators["Aerogel"].attenuation, ""};
@@ -57,7 +58,12 @@ public:
         m_algo = std::make_unique<AlgoT>(GetPrefix());
         m_algo->level(static_cast<algorithms::LogLevel>(logger()->level()));
         m_algo->applyConfig(config());
-        m_algo->init(m_RichGeoSvc().GetIrtGeo("DRICH")->GetIrtDetectorCollection(), logger());
+        // the geometries of the parallel tasks are lent by the service, to one event at a time
+        auto* rich_geo = &m_RichGeoSvc();
+        m_algo->init(rich_geo->GetIrtGeo("DRICH")->GetIrtDetectorCollection(), logger(), {
+            [rich_geo]() { return rich_geo->AcquireIrtDetectorCollection("DRICH"); },
+            [rich_geo](CherenkovDetectorCollection* irt_det_coll) { rich_geo->ReleaseIrtDetectorCollection("DRICH", irt_det_coll); }
+          });
     }
 
     void ChangeRun(int64_t run_number) {
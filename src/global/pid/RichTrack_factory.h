@@ -35,6 +35,9 @@ private:
     Input<ActsExamples::ConstTrackContainer> m_acts_tracks_input {this};
     PodioOutput<edm4eic::TrackSegment> m_track_segments_output {this};
 
+    ParameterRef<bool> m_singlePass {this, "singlePass", config().single_pass, "Propagate once through all surfaces, in the order of their expected path lengths"};
+    ParameterRef<double> m_reachabilityTolerance {this, "reachabilityTolerance", config().reachability_tolerance, "Relative margin of the helix check that skips unreachable surfaces in single pass mode"};
+
     Service<DD4hep_service> m_GeoSvc {this};
     Service<ACTSGeo_service> m_ACTSGeoSvc {this};
 
@@ -3,13 +3,18 @@
 
 #pragma once
 
+#include <JANA/JApplication.h>
+#include <JANA/Services/JParameterManager.h>
+#include <algorithms/service.h>
 #include <edm4eic/MCRecoParticleAssociationCollection.h>
 #include <edm4eic/ReconstructedParticleCollection.h>
 #include <edm4hep/MCParticleCollection.h>
 #include <edm4hep/ParticleIDCollection.h>
+#include <string>
 
 #include "algorithms/pid_lut/PIDLookup.h"
 #include "extensions/jana/JOmniFactory.h"
+#include "services/pid_lut/PIDLookupTableSvc.h"
 
 namespace eicrecon {
 
@@ -42,8 +47,30 @@ public:
 
   void Process(int64_t run_number, uint64_t event_number) {
     m_algo->process({m_recoparticles_input(), m_recoparticle_assocs_input()},
-                    {m_recoparticles_output().get(), m_recoparticle_assocs_output().get(), m_particleids_output().get()});
+                    {m_recoparticles_output().get(),
+                     m_recoparticle_assocs_output.IsNeeded() ? m_recoparticle_assocs_output().get() : nullptr,
+                     m_particleids_output().get()});
   }
 };
 
+/**
+ * Schedules the table of the PIDLookup factory of a tag to be loaded in the
+ * background, to be called by the plugins next to adding the factory. A
+ * filename set with the parameter of the factory takes precedence over the
+ * one of the configuration. Tables of factories that are never used are
+ * loaded anyway, which costs time but is otherwise harmless.
+ */
+inline void PreloadPIDLookupTable(JApplication* app, const std::string& tag, PIDLookupConfig cfg) {
+  // the parameter is prefixed by the plugin name, if any, and keys are case insensitive
+  const std::string suffix = JParameterManager::ToLower(tag + ":filename");
+  for (const auto& [key, param] : app->GetJParameterManager()->GetAllParameters()) {
+    const std::string lower_key = JParameterManager::ToLower(key);
+    if (lower_key == suffix || lower_key.ends_with(":" + suffix)) {
+      cfg.filename = param->GetValue();
+    }
+  }
+  auto& serviceSvc = algorithms::ServiceSvc::instance();
+  serviceSvc.service<PIDLookupTableSvc>("PIDLookupTableSvc")->preload(cfg.filename, PIDLookup::binning(cfg));
+}
+
 } // namespace eicrecon
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JApplication.h>
+#include <algorithms/service.h>
+
+#include "algorithms/reco/BeamConditionsSvc.h"
+
+namespace eicrecon {
+
+/**
+ * Registers the BeamConditionsSvc with its beams:* parameters, for the BeamContext of the
+ * plugins that reconstruct the inclusive kinematics (reco, or fastsim instead of it)
+ */
+inline void AddBeamConditionsSvc(JApplication* app) {
+    // Beams of the runs, shared by the reconstruction of the beam context
+    double beams_electron_momentum = 0;
+    double beams_hadron_momentum = 0;
+    int beams_hadron_pdg = 2212;
+    double beams_crossing_angle = -0.025;
+    app->SetDefaultParameter("beams:ElectronMomentum", beams_electron_momentum, "Electron beam momentum [GeV], from the first event of every run if 0");
+    app->SetDefaultParameter("beams:HadronMomentum", beams_hadron_momentum, "Hadron beam momentum [GeV], from the first event of every run if 0");
+    app->SetDefaultParameter("beams:HadronPDG", beams_hadron_pdg, "PDG code of the hadron beam, if its momentum is given");
+    app->SetDefaultParameter("beams:CrossingAngle", beams_crossing_angle, "Crossing angle of the hadron beam [rad]");
+    auto& serviceSvc = algorithms::ServiceSvc::instance();
+    serviceSvc.add<BeamConditionsSvc>(&BeamConditionsSvc::instance());
+    serviceSvc.setInit<BeamConditionsSvc>([=](auto&& beams) {
+        beams.setProperty("electronMomentum", beams_electron_momentum);
+        beams.setProperty("hadronMomentum", beams_hadron_momentum);
+        beams.setProperty("hadronPDG", beams_hadron_pdg);
+        beams.setProperty("crossingAngle", beams_crossing_angle);
+        beams.init();
+    });
+}
+
+} // namespace eicrecon
@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include <memory>
 
+#include "algorithms/interfaces/AssociationIndex.h"
 #include "algorithms/reco/MatchClusters.h"
 #include "extensions/jana/JOmniFactory.h"
 #include "services/algorithms_init/AlgorithmsInit_service.h"
@@ -29,7 +30,8 @@ private:
     // Declare inputs
     PodioInput<edm4hep::MCParticle> m_mc_parts_input {this};
     PodioInput<edm4eic::ReconstructedParticle> m_rec_parts_input {this};
-    PodioInput<edm4eic::MCRecoParticleAssociation> m_rec_assocs_input {this};
+    // see AssociationIndex_factory
+    Input<AssociationLookup<edm4eic::MCRecoParticleAssociationCollection>> m_rec_assocs_input {this};
     PodioInput<edm4eic::Cluster> m_clusters_input {this};
     PodioInput<edm4eic::MCRecoClusterParticleAssociation> m_cluster_assocs_input {this};
 
@@ -53,7 +55,7 @@ public:
             {
                 m_mc_parts_input(),
                 m_rec_parts_input(),
-                m_rec_assocs_input(),
+                m_rec_assocs_input.at(0),
                 m_clusters_input(),
                 m_cluster_assocs_input(),
             },
@@ -10,6 +10,7 @@
 #include <utility>
 #include <vector>
 
+#include "algorithms/interfaces/AssociationIndex.h"
 #include "algorithms/reco/ScatteredElectronsTruth.h"
 #include "extensions/jana/JOmniFactory.h"
 
@@ -25,7 +26,7 @@ private:
 
     PodioInput<edm4hep::MCParticle> m_mc_particles_input {this};
     PodioInput<edm4eic::ReconstructedParticle> m_rc_particles_input {this};
-    PodioInput<edm4eic::MCRecoParticleAssociation> m_rc_particles_assoc_input {this};
+    Input<AssociationLookup<edm4eic::MCRecoParticleAssociationCollection>> m_rc_particles_assoc_input {this};
 
     // Declare outputs
     PodioOutput<edm4eic::ReconstructedParticle> m_out_reco_particles {this};
@@ -43,7 +44,7 @@ public:
     }
 
     void Process(int64_t run_number, uint64_t event_number) {
-        m_algo->process({m_mc_particles_input(), m_rc_particles_input(), m_rc_particles_assoc_input()},
+        m_algo->process({m_mc_particles_input(), m_rc_particles_input(), m_rc_particles_assoc_input.at(0)},
                         {m_out_reco_particles().get()});
 
     }
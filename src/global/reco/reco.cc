@@ -5,16 +5,21 @@
 
 
 #include <JANA/JApplication.h>
+#include <algorithms/service.h>
 #include <edm4eic/Cluster.h>
 #include <edm4eic/EDM4eicVersion.h>
 #include <edm4eic/MCRecoClusterParticleAssociation.h>
 #include <edm4eic/MCRecoParticleAssociation.h>
 #include <edm4eic/ReconstructedParticle.h>
 #include <edm4hep/MCParticle.h>
+#include <cstddef>
 #include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "algorithms/onnx/OnnxRuntimeSvc.h"
 
 #if EDM4EIC_VERSION_MAJOR >= 6
 #include "algorithms/reco/HadronicFinalState.h"
@@ -25,8 +30,10 @@
 #include "algorithms/reco/InclusiveKinematicseSigma.h"
 #endif
 #include "extensions/jana/JOmniFactoryGeneratorT.h"
+#include "factories/meta/AssociationIndex_factory.h"
 #include "factories/meta/CollectionCollector_factory.h"
 #include "factories/meta/FilterMatching_factory.h"
+#include "factories/reco/BeamContext_factory.h"
 #include "factories/reco/FarForwardNeutronReconstruction_factory.h"
 #include "factories/reco/InclusiveKinematicsML_factory.h"
 #if EDM4EIC_VERSION_MAJOR >= 6
@@ -34,16 +41,19 @@
 #endif
 #include "factories/reco/InclusiveKinematicsTruth_factory.h"
 #include "factories/reco/JetReconstruction_factory.h"
+#include "factories/reco/TrackClusterMatching_factory.h"
 #include "factories/reco/TransformBreitFrame_factory.h"
 #if EDM4EIC_VERSION_MAJOR >= 6
 #include "factories/reco/HadronicFinalState_factory.h"
 #endif
+#include "global/reco/BeamConditions.h"
 #include "global/reco/ChargedReconstructedParticleSelector_factory.h"
 #include "global/reco/MC2SmearedParticle_factory.h"
 #include "global/reco/MatchClusters_factory.h"
 #include "global/reco/ReconstructedElectrons_factory.h"
 #include "global/reco/ScatteredElectronsEMinusPz_factory.h"
 #include "global/reco/ScatteredElectronsTruth_factory.h"
+#include "services/algorithms_init/ParallelInit.h"
 
 extern "C" {
 void InitPlugin(JApplication *app) {
@@ -51,6 +61,32 @@ void InitPlugin(JApplication *app) {
 
     using namespace eicrecon;
 
+    // ONNX Runtime environment, shared by all the ML algorithms
+    int onnx_intra_op_threads = 1;
+    int onnx_inter_op_threads = 1;
+    std::string onnx_execution_providers;
+    app->SetDefaultParameter("onnx:IntraOpThreads", onnx_intra_op_threads, "Threads of the global ONNX Runtime intra-op thread pool");
+    app->SetDefaultParameter("onnx:InterOpThreads", onnx_inter_op_threads, "Threads of the global ONNX Runtime inter-op thread pool");
+    app->SetDefaultParameter("onnx:ExecutionProviders", onnx_execution_providers, "Comma separated ONNX Runtime execution providers to try before the CPU, e.g. CUDA");
+    auto& serviceSvc = algorithms::ServiceSvc::instance();
+    serviceSvc.add<OnnxRuntimeSvc>(&OnnxRuntimeSvc::instance());
+    serviceSvc.setInit<OnnxRuntimeSvc>([=](auto&& onnx) {
+        std::vector<std::string> providers;
+        for (std::size_t begin = 0; begin < onnx_execution_providers.size(); ) {
+            auto end = onnx_execution_providers.find(',', begin);
+            if (end == std::string::npos) end = onnx_execution_providers.size();
+            if (end > begin) providers.push_back(onnx_execution_providers.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        onnx.setProperty("intraOpThreads", onnx_intra_op_threads);
+        onnx.setProperty("interOpThreads", onnx_inter_op_threads);
+        onnx.setProperty("executionProviders", providers);
+        onnx.init();
+    });
+    ParallelInit::instance().addBeforeFork("onnx", []() { OnnxRuntimeSvc::instance().wait(); });
+
+    AddBeamConditionsSvc(app);
+
     // Finds associations matched to initial scattered electrons
     app->Add(new JOmniFactoryGeneratorT<FilterMatching_factory< edm4eic::MCRecoParticleAssociation,
                                                                 [](auto* obj) { return obj->getSim().getObjectID();},
@@ -89,12 +125,20 @@ void InitPlugin(JApplication *app) {
         {"EcalClusterAssociations"},
         app));
 
+    // Shared by the consumers of the charged particle associations
+    app->Add(new JOmniFactoryGeneratorT<AssociationIndex_factory<edm4eic::MCRecoParticleAssociation>>(
+        "ReconstructedChargedParticleAssociationIndex",
+        {"ReconstructedChargedParticleAssociations"},
+        {"ReconstructedChargedParticleAssociationIndex"},
+        app
+    ));
+
     app->Add(new JOmniFactoryGeneratorT<MatchClusters_factory>(
         "ReconstructedParticlesWithAssoc",
         {
           "MCParticles",
           "ReconstructedChargedParticles",
-          "ReconstructedChargedParticleAssociations",
+          "ReconstructedChargedParticleAssociationIndex",
           "EcalClusters",
           "EcalClusterAssociations",
         },
@@ -104,11 +148,53 @@ void InitPlugin(JApplication *app) {
         app
     ));
 
+    // Geometric matching of the charged particles to the clusters around their projections,
+    // each calorimeter adds its clusters to the particles of the previous one
+    app->Add(new JOmniFactoryGeneratorT<TrackClusterMatching_factory>(
+        "EcalEndcapNTrackClusterMatching",
+        {"ReconstructedChargedParticles", "CalorimeterTrackProjections", "EcalEndcapNClusters"},
+        {"EcalEndcapNMatchedChargedParticles"},
+        {
+          .calorimeterID = "EcalEndcapN_ID",
+        },
+        app
+    ));
+    app->Add(new JOmniFactoryGeneratorT<TrackClusterMatching_factory>(
+        "EcalBarrelTrackClusterMatching",
+        {"EcalEndcapNMatchedChargedParticles", "CalorimeterTrackProjections", "EcalBarrelScFiClusters"},
+        {"EcalBarrelMatchedChargedParticles"},
+        {
+          .calorimeterID = "EcalBarrel_ID",
+        },
+        app
+    ));
+    app->Add(new JOmniFactoryGeneratorT<TrackClusterMatching_factory>(
+        "EcalEndcapPTrackClusterMatching",
+        {"EcalBarrelMatchedChargedParticles", "CalorimeterTrackProjections", "EcalEndcapPClusters"},
+        {"EcalMatchedChargedParticles"},
+        {
+          .calorimeterID = "EcalEndcapP_ID",
+        },
+        app
+    ));
+
+
+    // beams and boost, shared by the inclusive kinematics
+    app->Add(new JOmniFactoryGeneratorT<BeamContext_factory>(
+        "BeamContext",
+        {
+          "MCParticles"
+        },
+        {
+          "BeamContext"
+        },
+        app
+    ));
 
     app->Add(new JOmniFactoryGeneratorT<InclusiveKinematicsTruth_factory>(
         "InclusiveKinematicsTruth",
         {
-          "MCParticles"
+          "BeamContext"
         },
         {
           "InclusiveKinematicsTruth"
@@ -120,7 +206,7 @@ void InitPlugin(JApplication *app) {
     app->Add(new JOmniFactoryGeneratorT<InclusiveKinematicsReconstructed_factory<InclusiveKinematicsElectron>>(
         "InclusiveKinematicsElectron",
         {
-          "MCParticles",
+          "BeamContext",
           "ScatteredElectronsTruth",
           "HadronicFinalState"
         },
@@ -133,7 +219,7 @@ void InitPlugin(JApplication *app) {
     app->Add(new JOmniFactoryGeneratorT<InclusiveKinematicsReconstructed_factory<InclusiveKinematicsJB>>(
         "InclusiveKinematicsJB",
         {
-          "MCParticles",
+          "BeamContext",
           "ScatteredElectronsTruth",
           "HadronicFinalState"
         },
@@ -146,7 +232,7 @@ void InitPlugin(JApplication *app) {
     app->Add(new JOmniFactoryGeneratorT<InclusiveKinematicsReconstructed_factory<InclusiveKinematicsDA>>(
         "InclusiveKinematicsDA",
         {
-          "MCParticles",
+          "BeamContext",
           "ScatteredElectronsTruth",
           "HadronicFinalState"
         },
@@ -159,7 +245,7 @@ void InitPlugin(JApplication *app) {
     app->Add(new JOmniFactoryGeneratorT<InclusiveKinematicsReconstructed_factory<InclusiveKinematicseSigma>>(
         "InclusiveKinematicseSigma",
         {
-          "MCParticles",
+          "BeamContext",
           "ScatteredElectronsTruth",
           "HadronicFinalState"
         },
@@ -173,7 +259,7 @@ void InitPlugin(JApplication *app) {
     app->Add(new JOmniFactoryGeneratorT<InclusiveKinematicsReconstructed_factory<InclusiveKinematicsSigma>>(
         "InclusiveKinematicsSigma",
         {
-          "MCParticles",
+          "BeamContext",
           "ScatteredElectronsTruth",
           "HadronicFinalState"
         },
@@ -194,6 +280,7 @@ void InitPlugin(JApplication *app) {
         },
         app
     ));
+    PreloadInclusiveKinematicsMLModel(app, "InclusiveKinematicsML", {});
 #endif
 
     app->Add(new JOmniFactoryGeneratorT<ReconstructedElectrons_factory>(
@@ -259,7 +346,7 @@ void InitPlugin(JApplication *app) {
         {
           "MCParticles",
           "ReconstructedChargedParticles",
-          "ReconstructedChargedParticleAssociations"
+          "ReconstructedChargedParticleAssociationIndex"
         },
         {
           "ScatteredElectronsTruth"
@@ -304,7 +391,7 @@ void InitPlugin(JApplication *app) {
     app->Add(new JOmniFactoryGeneratorT<HadronicFinalState_factory<HadronicFinalState>>(
         "HadronicFinalState",
         {
-          "MCParticles",
+          "BeamContext",
           "ReconstructedParticles",
           "ReconstructedParticleAssociations"
         },
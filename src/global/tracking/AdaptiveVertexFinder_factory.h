@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <ActsExamples/EventData/Trajectories.hpp>
+#include <JANA/JEvent.h>
+#include <edm4eic/VertexCollection.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "algorithms/tracking/AdaptiveVertexFinder.h"
+#include "algorithms/tracking/AdaptiveVertexFinderConfig.h"
+#include "extensions/jana/JOmniFactory.h"
+#include "services/geometry/acts/ACTSGeo_service.h"
+
+namespace eicrecon {
+
+class AdaptiveVertexFinder_factory :
+        public JOmniFactory<AdaptiveVertexFinder_factory, AdaptiveVertexFinderConfig> {
+
+private:
+    using AlgoT = eicrecon::AdaptiveVertexFinder;
+    std::unique_ptr<AlgoT> m_algo;
+
+    Input<ActsExamples::Trajectories> m_acts_trajectories_input {this};
+    PodioOutput<edm4eic::Vertex> m_vertices_output {this};
+
+    ParameterRef<int> m_maxIterations {this, "maxIterations", config().maxIterations,
+                           "Maximum number of iterations of the finder"};
+    ParameterRef<bool> m_useTime {this, "useTime", config().useTime,
+                           "Whether or not to use the time of the tracks"};
+    ParameterRef<bool> m_doFullSplitting {this, "doFullSplitting", config().doFullSplitting,
+                           "Whether or not to split the candidates close to each other"};
+    ParameterRef<double> m_tracksMaxZinterval {this, "tracksMaxZinterval", config().tracksMaxZinterval,
+                           "Maximum distance in z of the tracks to a seed [mm]"};
+    ParameterRef<double> m_tracksMaxSignificance {this, "tracksMaxSignificance", config().tracksMaxSignificance,
+                           "Maximum significance of the distance of the tracks to a seed"};
+    ParameterRef<double> m_maxVertexChi2 {this, "maxVertexChi2", config().maxVertexChi2,
+                           "Maximum chi2 of the tracks to their vertex"};
+    ParameterRef<double> m_gridZRange {this, "gridZRange", config().gridZRange,
+                           "Half length in z of the track density grid of the seeder [mm]"};
+    ParameterRef<double> m_maxDistToLinPoint {this, "maxDistToLinPoint", config().maxDistToLinPoint,
+                           "Shift of a vertex after which its tracks are linearized again [mm]"};
+
+    Service<ACTSGeo_service> m_ACTSGeoSvc {this};
+
+public:
+    void Configure() {
+        m_algo = std::make_unique<AlgoT>();
+        m_algo->applyConfig(config());
+        m_algo->init(m_ACTSGeoSvc().actsGeoProvider(), logger());
+    }
+
+    void ChangeRun(int64_t run_number) {
+    }
+
+    void Process(int64_t run_number, uint64_t event_number) {
+        m_vertices_output() = m_algo->produce(m_acts_trajectories_input());
+    }
+};
+
+} // eicrecon
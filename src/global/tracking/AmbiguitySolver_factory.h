@@ -34,6 +34,8 @@ private:
   ParameterRef<std::size_t> m_nMeasurementsMin{
       this, "nMeasurementsMin", config().n_measurements_min,
       "Number of measurements required for further reconstruction"};
+  ParameterRef<bool> m_copyTracks{this, "copyTracks", config().copy_tracks,
+                                  "Copy the selected tracks, otherwise share the input track container"};
 
 public:
   void Configure() {
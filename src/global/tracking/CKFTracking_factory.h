@@ -9,6 +9,7 @@
 #include <edm4eic/TrackParametersCollection.h>
 #include <edm4eic/TrajectoryCollection.h>
 #include <memory>
+#include <podio/UserDataCollection.h>
 #include <string>
 #include <utility>
 #include <vector>
@@ -32,10 +33,25 @@ private:
     PodioInput<edm4eic::Measurement2D> m_measurements_input {this};
     Output<ActsExamples::Trajectories> m_acts_trajectories_output {this};
     Output<ActsExamples::ConstTrackContainer> m_acts_tracks_output {this};
+    // the CKFTrackingStatus of the event, one value per collection
+    PodioOutput<int> m_num_seeds_output {this};
+    PodioOutput<int> m_num_seeds_processed_output {this};
+    PodioOutput<int> m_num_branches_output {this};
+    PodioOutput<double> m_time_output {this};
+    PodioOutput<int> m_seeds_truncated_output {this};
+    PodioOutput<int> m_degraded_output {this};
+    PodioOutput<int> m_truncated_output {this};
 
     ParameterRef<std::vector<double>> m_etaBins {this, "EtaBins", config().etaBins, "Eta Bins for ACTS CKF tracking reco"};
     ParameterRef<std::vector<double>> m_chi2CutOff {this, "Chi2CutOff", config().chi2CutOff, "Chi2 Cut Off for ACTS CKF tracking"};
     ParameterRef<std::vector<size_t>> m_numMeasurementsCutOff {this, "NumMeasurementsCutOff", config().numMeasurementsCutOff, "Number of measurements Cut Off for ACTS CKF tracking"};
+    ParameterRef<size_t> m_numSeedTasks {this, "NumSeedTasks", config().numSeedTasks, "Number of parallel tasks for the seeds of an event (1 for sequential)"};
+    ParameterRef<size_t> m_maxSeeds {this, "MaxSeeds", config().maxSeeds, "Maximum number of seeds per event, the others are dropped (0 for no limit)"};
+    ParameterRef<size_t> m_maxBranches {this, "MaxBranches", config().maxBranches, "Maximum number of tracks found per event before degrading or skipping the remaining seeds (0 for no limit)"};
+    ParameterRef<double> m_maxTime {this, "MaxTime", config().maxTime, "Maximum time [ms] of the track finding per event before degrading or skipping the remaining seeds (0 for no limit)"};
+    ParameterRef<std::vector<double>> m_degradedChi2CutOff {this, "DegradedChi2CutOff", config().degradedChi2CutOff, "Chi2 Cut Off of the seeds out of budget (none to skip them)"};
+    ParameterRef<std::vector<size_t>> m_degradedNumMeasurementsCutOff {this, "DegradedNumMeasurementsCutOff", config().degradedNumMeasurementsCutOff, "Number of measurements Cut Off of the seeds out of budget"};
+    ParameterRef<std::vector<std::string>> m_trackStateComponents {this, "TrackStateComponents", config().trackStateComponents, "Track state components kept in the trajectories, of predicted, filtered, smoothed, jacobian and calibrated"};
 
     Service<ACTSGeo_service> m_ACTSGeoSvc {this};
 
@@ -50,13 +66,22 @@ public:
     }
 
     void Process(int64_t run_number, uint64_t event_number) {
+        CKFTrackingStatus status;
         std::tie(
             m_acts_trajectories_output(),
-            m_acts_tracks_output()
+            m_acts_tracks_output(),
+            status
         ) = m_algo->process(
             *m_measurements_input(),
             *m_parameters_input()
         );
+        m_num_seeds_output()->push_back(status.numSeeds);
+        m_num_seeds_processed_output()->push_back(status.numSeedsProcessed);
+        m_num_branches_output()->push_back(status.numBranches);
+        m_time_output()->push_back(status.time);
+        m_seeds_truncated_output()->push_back(status.seedsTruncated);
+        m_degraded_output()->push_back(status.degraded);
+        m_truncated_output()->push_back(status.truncated);
     }
 };
 
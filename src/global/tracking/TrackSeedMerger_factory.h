@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JEvent.h>
+#include <edm4eic/TrackParametersCollection.h>
+#include <spdlog/logger.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "algorithms/tracking/TrackSeedMerger.h"
+#include "algorithms/tracking/TrackSeedMergerConfig.h"
+#include "extensions/jana/JOmniFactory.h"
+
+namespace eicrecon {
+
+class TrackSeedMerger_factory :
+        public JOmniFactory<TrackSeedMerger_factory, TrackSeedMergerConfig> {
+
+private:
+    using AlgoT = eicrecon::TrackSeedMerger;
+    std::unique_ptr<AlgoT> m_algo;
+
+    PodioInput<edm4eic::TrackParameters> m_parameters_input {this};
+    PodioOutput<edm4eic::TrackParameters> m_parameters_output {this};
+
+    ParameterRef<double> m_maxRelDeltaQOverP {this, "maxRelDeltaQOverP", config().maxRelDeltaQOverP, "Maximum relative difference of q/p of merged seeds"};
+    ParameterRef<double> m_maxDeltaTheta {this, "maxDeltaTheta", config().maxDeltaTheta, "Maximum difference of theta [rad] of merged seeds"};
+    ParameterRef<double> m_maxDeltaPhi {this, "maxDeltaPhi", config().maxDeltaPhi, "Maximum difference of phi [rad] of merged seeds"};
+    ParameterRef<double> m_maxDeltaZ {this, "maxDeltaZ", config().maxDeltaZ, "Maximum difference of vertex z [mm] of merged seeds"};
+
+public:
+    ~TrackSeedMerger_factory() {
+        if (m_algo && m_algo->seedsIn() > 0) {
+            logger()->info("Merged {} of {} seeds, {} CKF invocations saved",
+                           m_algo->seedsMerged(), m_algo->seedsIn(), m_algo->seedsMerged());
+        }
+    }
+
+    void Configure() {
+        m_algo = std::make_unique<AlgoT>();
+        m_algo->applyConfig(config());
+        m_algo->init(logger());
+    }
+
+    void ChangeRun(int64_t run_number) {
+    }
+
+    void Process(int64_t run_number, uint64_t event_number) {
+        m_parameters_output() = m_algo->process(*m_parameters_input());
+    }
+};
+
+} // eicrecon
@@ -56,6 +56,8 @@ private:
     ParameterRef<float> m_thetaError {this, "theta_Error", config().thetaError, "Error on theta for Acts::OrthogonalSeedFinder"};
     ParameterRef<float> m_qOverPError {this, "qOverP_Error", config().qOverPError, "Error on q/p for Acts::OrthogonalSeedFinder"};
     ParameterRef<float> m_timeError {this, "time_Error", config().timeError, "Error on time for Acts::OrthogonalSeedFinder"};
+    ParameterRef<std::vector<double>> m_etaRegionBounds {this, "etaRegionBounds", config().etaRegionBounds, "Eta bounds between regions that are seeded in parallel (no partitioning if empty)"};
+    ParameterRef<double> m_etaRegionOverlap {this, "etaRegionOverlap", config().etaRegionOverlap, "Overlap in eta of neighbouring seeding regions"};
 
     Service<ACTSGeo_service> m_ACTSGeoSvc {this};
 
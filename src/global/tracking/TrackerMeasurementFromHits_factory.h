@@ -11,6 +11,7 @@
 #include <utility>
 #include <vector>
 
+#include "algorithms/interfaces/CollectionView.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 #include "algorithms/tracking/TrackerMeasurementFromHits.h"
 #include "extensions/jana/JOmniFactory.h"
@@ -26,7 +27,8 @@ private:
     using AlgoT = eicrecon::TrackerMeasurementFromHits;
     std::unique_ptr<AlgoT> m_algo;
 
-    PodioInput<edm4eic::TrackerHit> m_hits_input {this};
+    // concatenated hits of all the trackers, see CollectionView_factory
+    Input<CollectionView<edm4eic::TrackerHitCollection>> m_hits_input {this};
     PodioOutput<edm4eic::Measurement2D> m_measurements_output {this};
 
     Service<DD4hep_service> m_DD4hepSvc {this};
@@ -42,7 +44,7 @@ public:
     }
 
     void Process(int64_t run_number, uint64_t event_number) {
-        m_measurements_output() = m_algo->produce(*m_hits_input());
+        m_measurements_output() = m_algo->produce(*m_hits_input.at(0));
     }
 };
 
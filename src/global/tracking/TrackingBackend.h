@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JApplication.h>
+#include <JANA/JException.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CKFTracking_factory.h"
+#include "TrackSeeding_factory.h"
+#include "extensions/jana/JOmniFactoryGeneratorT.h"
+
+namespace eicrecon {
+
+/// Implementation of the seeding and of the track finding and fitting of the central tracking,
+/// selected with -Ptracking:Backend. A backend adds its factories under the prefixes and the tags
+/// that tracking.cc gives it, with the inputs and outputs of the host Acts factories, so that the
+/// rest of the chain (ActsToTracks, the ambiguity solver, the vertexing) is the same for all of them.
+class TrackingBackend {
+public:
+  virtual ~TrackingBackend() = default;
+
+  /// edm4eic::TrackerHit to edm4eic::TrackParameters
+  virtual void AddSeeding(JApplication* app, const std::string& prefix,
+                          const std::vector<std::string>& input_tags,
+                          const std::vector<std::string>& output_tags) const = 0;
+
+  /// edm4eic::TrackParameters and edm4eic::Measurement2D to ActsExamples::Trajectories,
+  /// ActsExamples::ConstTrackContainer and the fields of CKFTrackingStatus, as podio::UserDataCollection
+  virtual void AddTrackFinding(JApplication* app, const std::string& prefix,
+                               const std::vector<std::string>& input_tags,
+                               const std::vector<std::string>& output_tags) const = 0;
+
+  /// The backends by name. A device backend, built behind a CMake option of its own, adds itself here
+  static std::map<std::string, std::unique_ptr<TrackingBackend>>& registry();
+
+  /// The backend of tracking:Backend, "acts" (host Acts) by default
+  static const TrackingBackend& select(JApplication* app) {
+    std::string name = "acts";
+    app->SetDefaultParameter("tracking:Backend", name, "Backend of the seeding and of the track finding and fitting");
+    auto& backends = registry();
+    auto it = backends.find(name);
+    if (it == backends.end()) {
+      std::string known;
+      for (const auto& [known_name, backend] : backends) {
+        known += (known.empty() ? "" : ", ") + known_name;
+      }
+      throw JException("tracking:Backend: unknown backend '%s', available: %s", name.c_str(), known.c_str());
+    }
+    return *it->second;
+  }
+};
+
+/// TrackSeeding (Acts::SeedFinderOrthogonal) and CKFTracking on the host
+class ActsTrackingBackend : public TrackingBackend {
+public:
+  void AddSeeding(JApplication* app, const std::string& prefix,
+                  const std::vector<std::string>& input_tags,
+                  const std::vector<std::string>& output_tags) const override {
+    app->Add(new JOmniFactoryGeneratorT<TrackSeeding_factory>(prefix, input_tags, output_tags, {}, app));
+  }
+
+  void AddTrackFinding(JApplication* app, const std::string& prefix,
+                       const std::vector<std::string>& input_tags,
+                       const std::vector<std::string>& output_tags) const override {
+    app->Add(new JOmniFactoryGeneratorT<CKFTracking_factory>(prefix, input_tags, output_tags, app));
+  }
+};
+
+inline std::map<std::string, std::unique_ptr<TrackingBackend>>& TrackingBackend::registry() {
+  static std::map<std::string, std::unique_ptr<TrackingBackend>> backends = [] {
+    std::map<std::string, std::unique_ptr<TrackingBackend>> host;
+    host.emplace("acts", std::make_unique<ActsTrackingBackend>());
+    return host;
+  }();
+  return backends;
+}
+
+} // namespace eicrecon
@@ -44,7 +44,7 @@ public:
 
   void Process(int64_t run_number, uint64_t event_number) {
     m_algo->process({m_particles_input(), m_tracks_input()},
-                    {m_recoparticles_output().get(), m_recoassocs_output().get()});
+                    {m_recoparticles_output().get(), m_recoassocs_output.IsNeeded() ? m_recoassocs_output().get() : nullptr});
   }
 };
 
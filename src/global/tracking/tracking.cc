@@ -14,19 +14,21 @@
 
 #include "ActsToTracks.h"
 #include "ActsToTracks_factory.h"
+#include "AdaptiveVertexFinder_factory.h"
 #include "AmbiguitySolver_factory.h"
-#include "CKFTracking_factory.h"
 #include "IterativeVertexFinder_factory.h"
 #include "TrackParamTruthInit_factory.h"
 #include "TrackProjector_factory.h"
 #include "TrackPropagationConfig.h"
 #include "TrackPropagation_factory.h"
-#include "TrackSeeding_factory.h"
+#include "TrackSeedMerger_factory.h"
 #include "TrackerMeasurementFromHits_factory.h"
+#include "TrackingBackend.h"
 #include "TracksToParticlesConfig.h"
 #include "TracksToParticles_factory.h"
 #include "extensions/jana/JOmniFactoryGeneratorT.h"
 #include "factories/meta/CollectionCollector_factory.h"
+#include "factories/meta/CollectionView_factory.h"
 #include "services/geometry/dd4hep/DD4hep_service.h"
 
 //
@@ -36,6 +38,9 @@ void InitPlugin(JApplication *app) {
 
     using namespace eicrecon;
 
+    // seeding and track finding and fitting, host Acts unless -Ptracking:Backend selects another one
+    const TrackingBackend& backend = TrackingBackend::select(app);
+
     app->Add(new JOmniFactoryGeneratorT<TrackParamTruthInit_factory>(
             "InitTrackParams",
             {"MCParticles"},
@@ -76,14 +81,21 @@ void InitPlugin(JApplication *app) {
         {"CentralTrackingRecHits"}, // Output collection name
         app));
 
+    // The same hits without the copy, for the measurements
+    app->Add(new JOmniFactoryGeneratorT<CollectionView_factory<edm4eic::TrackerHit>>(
+        "CentralTrackingRecHitsView",
+        input_collections,
+        {"CentralTrackingRecHitsView"},
+        app));
+
     app->Add(new JOmniFactoryGeneratorT<TrackerMeasurementFromHits_factory>(
             "CentralTrackerMeasurements",
-            {"CentralTrackingRecHits"},
+            {"CentralTrackingRecHitsView"},
             {"CentralTrackerMeasurements"},
             app
             ));
 
-    app->Add(new JOmniFactoryGeneratorT<CKFTracking_factory>(
+    backend.AddTrackFinding(app,
         "CentralCKFTrajectories",
         {
             "InitTrackParams",
@@ -92,9 +104,15 @@ void InitPlugin(JApplication *app) {
         {
             "CentralCKFActsTrajectoriesUnfiltered",
             "CentralCKFActsTracksUnfiltered",
-        },
-        app
-    ));
+            "CentralCKFTrackingStatusNumSeeds",
+            "CentralCKFTrackingStatusNumSeedsProcessed",
+            "CentralCKFTrackingStatusNumBranches",
+            "CentralCKFTrackingStatusTime",
+            "CentralCKFTrackingStatusSeedsTruncated",
+            "CentralCKFTrackingStatusDegraded",
+            "CentralCKFTrackingStatusTruncated",
+        }
+    );
 
     app->Add(new JOmniFactoryGeneratorT<ActsToTracks_factory>(
         "CentralCKFTracksUnfiltered",
@@ -120,6 +138,10 @@ void InitPlugin(JApplication *app) {
              "CentralCKFActsTracks",
              "CentralCKFActsTrajectories",
         },
+        {
+            // the tracks downstream are read from the trajectories, which select the tracks
+            .copy_tracks = false,
+        },
         app
     ));
 
@@ -137,15 +159,23 @@ void InitPlugin(JApplication *app) {
         app
     ));
 
-    app->Add(new JOmniFactoryGeneratorT<TrackSeeding_factory>(
+    backend.AddSeeding(app,
         "CentralTrackSeedingResults",
         {"CentralTrackingRecHits"},
+        {"CentralTrackSeedingResults"}
+        );
+
+    // Merged seeds, CKF tracking uses them when its input tags are overridden e.g. with
+    // -PCentralCKFSeededTrajectories:InputTags=CentralTrackSeedsMerged,CentralTrackerMeasurements
+    app->Add(new JOmniFactoryGeneratorT<TrackSeedMerger_factory>(
+        "CentralTrackSeedsMerged",
         {"CentralTrackSeedingResults"},
+        {"CentralTrackSeedsMerged"},
         {},
         app
         ));
 
-    app->Add(new JOmniFactoryGeneratorT<CKFTracking_factory>(
+    backend.AddTrackFinding(app,
         "CentralCKFSeededTrajectories",
         {
             "CentralTrackSeedingResults",
@@ -154,9 +184,15 @@ void InitPlugin(JApplication *app) {
         {
             "CentralCKFSeededActsTrajectoriesUnfiltered",
             "CentralCKFSeededActsTracksUnfiltered",
-        },
-        app
-    ));
+            "CentralCKFSeededTrackingStatusNumSeeds",
+            "CentralCKFSeededTrackingStatusNumSeedsProcessed",
+            "CentralCKFSeededTrackingStatusNumBranches",
+            "CentralCKFSeededTrackingStatusTime",
+            "CentralCKFSeededTrackingStatusSeedsTruncated",
+            "CentralCKFSeededTrackingStatusDegraded",
+            "CentralCKFSeededTrackingStatusTruncated",
+        }
+    );
 
     app->Add(new JOmniFactoryGeneratorT<ActsToTracks_factory>(
         "CentralCKFSeededTracksUnfiltered",
@@ -182,6 +218,10 @@ void InitPlugin(JApplication *app) {
              "CentralCKFSeededActsTracks",
              "CentralCKFSeededActsTrajectories",
         },
+        {
+            // the tracks downstream are read from the trajectories, which select the tracks
+            .copy_tracks = false,
+        },
         app
     ));
 
@@ -214,6 +254,16 @@ void InitPlugin(JApplication *app) {
             app
             ));
 
+    // Adaptive multi-vertex finding, for events with many tracks or several vertices, e.g. with
+    // beam-gas pileup, where the cost of the iterative finder grows with the multiplicity
+    app->Add(new JOmniFactoryGeneratorT<AdaptiveVertexFinder_factory>(
+            "CentralTrackVerticesAMVF",
+            {"CentralCKFActsTrajectories"},
+            {"CentralTrackVerticesAMVF"},
+            {},
+            app
+            ));
+
     app->Add(new JOmniFactoryGeneratorT<TrackPropagation_factory>(
             "CalorimeterTrackPropagator",
             {"CentralCKFTracks", "CentralCKFActsTrajectories", "CentralCKFActsTracks"},
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: LGPL-3.0-or-later
+# Copyright (C) 2024 EICrecon contributors
+"""
+Throughput benchmark of the reconstruction, with the throughput plugin.
+
+  eicthroughput.py run --sample dis_q2_10_100=dis.edm4hep.root --sample single_e=e.edm4hep.root \
+      --label $(git rev-parse --short HEAD) --output throughput.json
+  eicthroughput.py compare baseline.json throughput.json
+
+`run` reconstructs every sample in every configuration and collects the
+reports of the throughput plugin into one JSON file. `compare` matches the
+runs of two such files by sample and configuration, and fails if the
+events/s drop or the peak RSS grows by more than the threshold.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+TRACKING_COLLECTIONS = [
+    "CentralCKFTracks",
+    "CentralCKFTrajectories",
+    "CentralTrackVertices",
+    "ReconstructedChargedParticles",
+]
+
+CALORIMETRY_COLLECTIONS = [
+    "EcalEndcapNClusters",
+    "EcalBarrelClusters",
+    "EcalBarrelScFiClusters",
+    "EcalEndcapPClusters",
+    "HcalEndcapNClusters",
+    "HcalBarrelClusters",
+    "LFHCALClusters",
+]
+
+# eicrecon parameters of every configuration, the factories that the outputs do not need are pruned
+# and the associations that they do not need are left empty
+CONFIGURATIONS = {
+    "tracking": {
+        "podio:output_collections": ",".join(TRACKING_COLLECTIONS),
+        "omnifactory:PruneToOutputs": "true",
+        "omnifactory:LazyOutputs": "true",
+    },
+    "calorimetry": {
+        "podio:output_collections": ",".join(CALORIMETRY_COLLECTIONS),
+        "omnifactory:PruneToOutputs": "true",
+        "omnifactory:LazyOutputs": "true",
+    },
+    "full": {},
+}
+
+
+def run(args):
+    samples = []
+    for sample in args.sample:
+        name, sep, path = sample.partition("=")
+        if not sep or not name or not path:
+            sys.exit(f"--sample must be NAME=FILE, not '{sample}'")
+        samples.append((name, path))
+    if not samples:
+        sys.exit("no --sample to run")
+    for config in args.config:
+        if config not in CONFIGURATIONS:
+            sys.exit(f"unknown configuration '{config}', one of {', '.join(CONFIGURATIONS)}")
+
+    runs = []
+    with tempfile.TemporaryDirectory(prefix="eicthroughput") as tmp:
+        for name, path in samples:
+            for config in args.config:
+                report = os.path.join(tmp, f"{name}.{config}.json")
+                parameters = {
+                    "plugins": "throughput",
+                    "throughput:report_file": report,
+                    "throughput:sample": name,
+                    "throughput:configuration": config,
+                    "throughput:label": args.label,
+                    "throughput:warmup_events": str(args.warmup),
+                    "omnifactory:MetricsFile": os.path.join(tmp, f"{name}.{config}.factories.json"),
+                    "podio:output_file": os.path.join(tmp, f"{name}.{config}.edm4eic.root"),
+                    "jana:nevents": str(args.events),
+                    "nthreads": str(args.threads),
+                }
+                parameters.update(CONFIGURATIONS[config])
+                command = [args.eicrecon] + [f"-P{k}={v}" for k, v in parameters.items()]
+                command += [f"-P{p}" for p in args.parameter] + [path]
+                print(f"eicthroughput: {name} / {config}", flush=True)
+                log = os.path.join(tmp, f"{name}.{config}.log")
+                with open(log, "w") as out:
+                    status = subprocess.run(command, stdout=out, stderr=subprocess.STDOUT).returncode
+                if status != 0 or not os.path.exists(report):
+                    with open(log) as out:
+                        sys.stderr.write(out.read()[-5000:])
+                    sys.exit(f"eicrecon failed on {name} / {config} with status {status}")
+                with open(report) as f:
+                    result = json.load(f)
+                print(f"    {result['events_per_second']:10.2f} events/s, startup {result['startup_seconds']:.1f} s, "
+                      f"peak RSS {result['peak_rss_mb']:.0f} MB")
+                runs.append(result)
+
+    with open(args.output, "w") as f:
+        json.dump({"label": args.label, "runs": runs}, f, indent=2)
+    print(f"eicthroughput: {len(runs)} runs written to {args.output}")
+
+
+def compare(args):
+    def load(path):
+        with open(path) as f:
+            report = json.load(f)
+        return report.get("label", path), {(r["sample"], r["configuration"]): r for r in report["runs"]}
+
+    old_label, old = load(args.baseline)
+    new_label, new = load(args.current)
+    print(f"{old_label} -> {new_label}")
+    regressions = 0
+    for key in sorted(set(old) & set(new)):
+        a, b = old[key], new[key]
+        rate = b["events_per_second"] / a["events_per_second"] - 1 if a["events_per_second"] > 0 else 0
+        rss = b["peak_rss_mb"] / a["peak_rss_mb"] - 1 if a["peak_rss_mb"] > 0 else 0
+        startup = b["startup_seconds"] - a["startup_seconds"]
+        flag = ""
+        if rate < -args.threshold or rss > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{key[0]:>24} {key[1]:>12}: events/s {rate:+7.1%}, peak RSS {rss:+7.1%}, "
+              f"startup {startup:+6.1f} s{flag}")
+
+        # the factories whose time per event changed the most
+        before = {f["factory"]: f["wall_ms_per_event"] for f in a["factories"]}
+        after = {f["factory"]: f["wall_ms_per_event"] for f in b["factories"]}
+        changes = sorted(((after.get(n, 0) - before.get(n, 0), n) for n in set(before) | set(after)),
+                         key=lambda change: -abs(change[0]))
+        for delta, factory in changes[:args.top]:
+            print(f"{'':>40}{delta:+10.3f} ms/event  {factory}")
+    for key in sorted(set(old) ^ set(new)):
+        print(f"{key[0]:>24} {key[1]:>12}: only in {args.baseline if key in old else args.current}")
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    run_parser = commands.add_parser("run", help="run the samples in the configurations")
+    run_parser.add_argument("--sample", action="append", default=[], help="NAME=FILE of a sample, repeated")
+    run_parser.add_argument("--config", action="append", choices=list(CONFIGURATIONS),
+                            help="configuration to run, repeated (default: all)")
+    run_parser.add_argument("--events", type=int, default=1000, help="events of every run")
+    run_parser.add_argument("--warmup", type=int, default=10, help="events before the measurement")
+    run_parser.add_argument("--threads", type=int, default=1, help="threads of every run")
+    run_parser.add_argument("--label", default="", help="version of the code, e.g. the commit")
+    run_parser.add_argument("--eicrecon", default="eicrecon", help="eicrecon executable")
+    run_parser.add_argument("--parameter", "-P", action="append", default=[],
+                            help="extra eicrecon parameter KEY=VALUE, repeated")
+    run_parser.add_argument("--output", default="throughput.json", help="JSON file of all the runs")
+
+    compare_parser = commands.add_parser("compare", help="compare the runs of two commits")
+    compare_parser.add_argument("baseline")
+    compare_parser.add_argument("current")
+    compare_parser.add_argument("--threshold", type=float, default=0.05,
+                                help="relative drop of events/s or growth of peak RSS that is a regression")
+    compare_parser.add_argument("--top", type=int, default=5, help="factories to show per run")
+
+    args = parser.parse_args()
+    if args.command == "run":
+        args.config = args.config or list(CONFIGURATIONS)
+        run(args)
+        return 0
+    return compare(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -5,6 +5,7 @@
 
 
 #include <JANA/JApplication.h>
+#include <JANA/JException.h>
 #include <JANA/Services/JServiceLocator.h>
 #include <algorithms/geo.h>
 #include <algorithms/logger.h>
@@ -13,6 +14,7 @@
 #include <spdlog/common.h>
 #include <spdlog/logger.h>
 
+#include "algorithms/interfaces/CounterRandomSvc.h"
 #include "services/log/Log_service.h"
 #include "services/geometry/dd4hep/DD4hep_service.h"
 
@@ -30,14 +32,22 @@ class AlgorithmsInit_service : public JService
 
         // Get services
         m_log_service = srv_locator->get<Log_service>();
-        m_dd4hep_service = srv_locator->get<DD4hep_service>();
 
         // Logger for ServiceSvc
         m_log = m_log_service->logger("AlgorithmsInit");
 
-        // Register DD4hep_service as algorithms::GeoSvc
+        // Register DD4hep_service as algorithms::GeoSvc, when the dd4hep plugin is loaded.
+        // Without it, e.g. in the fastsim profile, the geometry is not loaded at all.
+        try {
+            m_dd4hep_service = srv_locator->get<DD4hep_service>();
+        } catch (const JException&) {
+            m_log->debug("No DD4hep_service, algorithms::GeoSvc is left without a geometry");
+        }
         [[maybe_unused]] auto& geoSvc = algorithms::GeoSvc::instance();
         serviceSvc.setInit<algorithms::GeoSvc>([this](auto&& g) {
+            if (this->m_dd4hep_service == nullptr) {
+                return;
+            }
             this->m_log->debug("Initializing algorithms::GeoSvc");
             g.init(const_cast<dd4hep::Detector*>(this->m_dd4hep_service->detector().get()));
         });
@@ -68,6 +78,10 @@ class AlgorithmsInit_service : public JService
             r.init();
         });
 
+        // Register counter-based random streams, reproducible per event
+        auto& counterRandomSvc = eicrecon::CounterRandomSvc::instance();
+        serviceSvc.add<eicrecon::CounterRandomSvc>(&counterRandomSvc);
+
         // Finally, initialize the ServiceSvc
         serviceSvc.init();
     }
@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * The tasks of the parallel initialization phase of ParallelInit_processor.
+ *
+ * Plugins declare the slow initialization of their services as tasks that
+ * depend on the tasks of other services, e.g.
+ *
+ *     ParallelInit::instance().add("acts", {"dd4hep"}, [app]() {
+ *       app->GetService<ACTSGeo_service>()->actsGeoProvider();
+ *     });
+ *
+ * run() starts every task in a thread of its own as soon as its
+ * dependencies are done. Dependencies on the tasks of plugins that are not
+ * loaded are ignored. A task that fails is reported and otherwise
+ * ignored: the service is initialized lazily on its first use as before,
+ * which fails the same way if it is used at all.
+ *
+ * Services that go on loading in threads of their own once initialized
+ * (preloaded tables and sessions, the ACTS geometry in the background)
+ * declare how to wait for them with addBeforeFork(). beforeFork() waits
+ * for all of them, so that no load is pending, and no lock held by a
+ * loading thread, in the processes forked afterwards.
+ */
+class ParallelInit {
+public:
+  static ParallelInit& instance() {
+    static ParallelInit tasks;
+    return tasks;
+  }
+
+  struct Timing {
+    std::string name;
+    std::uint64_t ns{0};
+    std::string error; // empty if the task succeeded
+  };
+
+  /// Declares a task, a task of the same name replaces it
+  void add(const std::string& name, std::vector<std::string> dependencies, std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks[name] = {std::move(dependencies), std::move(task)};
+  }
+
+  /// Declares how to wait for the background work of a service, a wait of the same name replaces it
+  void addBeforeFork(const std::string& name, std::function<void()> wait) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_before_fork[name] = std::move(wait);
+  }
+
+  /// Waits for the background work of all the services, returns the errors by name
+  std::map<std::string, std::string> beforeFork() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::map<std::string, std::string> errors;
+    for (const auto& [name, wait] : m_before_fork) {
+      try {
+        wait();
+      } catch (const std::exception& e) {
+        errors[name] = e.what();
+      } catch (...) {
+        errors[name] = "unknown exception";
+      }
+    }
+    return errors;
+  }
+
+  /// Runs all the tasks, throws std::invalid_argument for circular dependencies
+  std::vector<Timing> run() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Timing> timings(m_tasks.size());
+    std::map<std::string, std::shared_future<void>> done;
+    std::size_t index = 0;
+    for (const auto& name : order()) {
+      const auto& task = m_tasks.at(name);
+      std::vector<std::shared_future<void>> dependencies;
+      for (const auto& dependency : task.dependencies) {
+        if (auto it = done.find(dependency); it != done.end()) {
+          dependencies.push_back(it->second);
+        }
+      }
+      auto& timing = timings[index++];
+      timing.name = name;
+      done[name] = std::async(std::launch::async, [&task, &timing, dependencies]() {
+        for (const auto& dependency : dependencies) {
+          dependency.wait();
+        }
+        const auto start = std::chrono::steady_clock::now();
+        try {
+          task.function();
+        } catch (const std::exception& e) {
+          timing.error = e.what();
+        } catch (...) {
+          timing.error = "unknown exception";
+        }
+        timing.ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+      }).share();
+    }
+    for (auto& [name, future] : done) {
+      future.wait();
+    }
+    return timings;
+  }
+
+private:
+  struct Task {
+    std::vector<std::string> dependencies;
+    std::function<void()> function;
+  };
+
+  /// The task names, every one after its dependencies
+  std::vector<std::string> order() const {
+    std::vector<std::string> result;
+    std::set<std::string> visited;
+    std::set<std::string> visiting;
+    std::function<void(const std::string&)> visit = [&](const std::string& name) {
+      if (visited.contains(name)) {
+        return;
+      }
+      if (!visiting.insert(name).second) {
+        throw std::invalid_argument("circular dependency of the initialization task " + name);
+      }
+      for (const auto& dependency : m_tasks.at(name).dependencies) {
+        if (m_tasks.contains(dependency)) {
+          visit(dependency);
+        }
+      }
+      visiting.erase(name);
+      visited.insert(name);
+      result.push_back(name);
+    };
+    for (const auto& [name, task] : m_tasks) {
+      visit(name);
+    }
+    return result;
+  }
+
+  std::mutex m_mutex;
+  std::map<std::string, Task> m_tasks;
+  std::map<std::string, std::function<void()>> m_before_fork;
+};
+
+} // namespace eicrecon
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JEventProcessor.h>
+#include <JANA/JFactory.h>
+#include <JANA/Services/JComponentManager.h>
+#include <spdlog/logger.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ParallelInit.h"
+#include "services/log/Log_service.h"
+
+/**
+ * Parallel initialization phase, with `-Peicrecon:ParallelInit=<threads>`.
+ *
+ * When the processors are initialized, the tasks of eicrecon::ParallelInit
+ * set up the services, in parallel where their dependencies allow. Then the
+ * factories of a scratch event are initialized on a pool of threads. The
+ * results of the shared services and caches (geometry, lookup tables,
+ * compiled expressions, ONNX models) are kept, so that the factories of the
+ * events are initialized quickly afterwards, the same way as before. A
+ * failure is only reported at debug level, as the factory may never be
+ * used; it fails again when it is. `eicrecon:ParallelInitFactories` limits
+ * the phase to the factories with one of the given tags.
+ *
+ * The time of every task and factory is printed, the slowest first.
+ */
+class ParallelInit_processor : public JEventProcessor {
+public:
+  ParallelInit_processor() { SetTypeName("ParallelInit_processor"); }
+
+  void Init() override {
+    auto app = GetApplication();
+    app->SetDefaultParameter("eicrecon:ParallelInit", m_threads, "Initialize the services and factories ahead of the events on this many threads, 0 for lazily on first use");
+    app->SetDefaultParameter("eicrecon:ParallelInitFactories", m_tags, "Tags of the factories to initialize in parallel, all if empty");
+    if (m_threads == 0) {
+      return;
+    }
+    m_log = app->GetService<Log_service>()->logger("ParallelInit");
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<Timing> timings;
+    for (const auto& task : eicrecon::ParallelInit::instance().run()) {
+      timings.push_back({"service " + task.name, task.ns});
+      if (!task.error.empty()) {
+        m_log->warn("Initialization of {} failed: {}", task.name, task.error);
+      }
+    }
+    const auto services_end = std::chrono::steady_clock::now();
+
+    // the factories of a scratch event, only the shared state they set up is kept
+    auto event = std::make_shared<JEvent>(app);
+    app->GetService<JComponentManager>()->configure_event(*event);
+    std::vector<JFactory*> factories;
+    for (auto* factory : event->GetFactorySet()->GetAllFactories()) {
+      if (m_tags.empty() || std::find(m_tags.begin(), m_tags.end(), factory->GetTag()) != m_tags.end()) {
+        factories.push_back(factory);
+      }
+    }
+    std::vector<Timing> factory_timings(factories.size());
+    std::atomic<std::size_t> next{0};
+    std::mutex log_mutex;
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < std::min<std::size_t>(m_threads, factories.size()); ++t) {
+      threads.emplace_back([&]() {
+        for (std::size_t i = next++; i < factories.size(); i = next++) {
+          auto* factory = factories[i];
+          const auto factory_start = std::chrono::steady_clock::now();
+          try {
+            factory->DoInit();
+          } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(log_mutex);
+            m_log->debug("Initialization of factory {} failed, it will fail again if it is used: {}", factory->GetTag(), e.what());
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(log_mutex);
+            m_log->debug("Initialization of factory {} failed, it will fail again if it is used", factory->GetTag());
+          }
+          factory_timings[i] = {"factory " + factory->GetTag(), elapsed_ns(factory_start)};
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    timings.insert(timings.end(), factory_timings.begin(), factory_timings.end());
+    const std::uint64_t services_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(services_end - start).count();
+    const std::uint64_t factories_ns = elapsed_ns(services_end);
+
+    // the timing report
+    std::uint64_t sum_ns = 0;
+    for (const auto& timing : timings) {
+      sum_ns += timing.ns;
+    }
+    std::sort(timings.begin(), timings.end(), [](const auto& a, const auto& b) { return a.ns > b.ns; });
+    m_log->info("Parallel initialization: {} services in {:.2f} s, {} factories on {} threads in {:.2f} s, {:.2f} s of work",
+                timings.size() - factory_timings.size(), services_ns * 1e-9, factory_timings.size(), threads.size(),
+                factories_ns * 1e-9, sum_ns * 1e-9);
+    for (std::size_t i = 0; i < std::min(timings.size(), m_top); ++i) {
+      m_log->info("{:10.3f} s  {}", timings[i].ns * 1e-9, timings[i].name);
+    }
+  }
+
+  void Process(const std::shared_ptr<const JEvent>& event) override {}
+
+private:
+  struct Timing {
+    std::string name;
+    std::uint64_t ns{0};
+  };
+
+  static std::uint64_t elapsed_ns(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  std::size_t m_threads{0};
+  std::vector<std::string> m_tags;
+  std::size_t m_top{20};
+  std::shared_ptr<spdlog::logger> m_log;
+};
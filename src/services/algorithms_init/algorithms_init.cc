@@ -5,11 +5,17 @@
 #include <memory>
 
 #include "AlgorithmsInit_service.h"
+#include "ParallelInit.h"
+#include "ParallelInit_processor.h"
 
 
 extern "C" {
 void InitPlugin(JApplication *app) {
     InitJANAPlugin(app);
     app->ProvideService(std::make_shared<AlgorithmsInit_service>(app));
+    eicrecon::ParallelInit::instance().add("algorithms", {"dd4hep"}, [app]() {
+        app->GetService<AlgorithmsInit_service>();
+    });
+    app->Add(new ParallelInit_processor());
 }
 }
@@ -0,0 +1,352 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <fmt/core.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include "CompiledExpression.h"
+
+namespace eicrecon {
+
+namespace {
+
+  const std::map<std::string, double (*)(double), std::less<>> functions1{
+      {"abs", [](double x) { return std::abs(x); }},
+      {"fabs", [](double x) { return std::fabs(x); }},
+      {"floor", [](double x) { return std::floor(x); }},
+      {"ceil", [](double x) { return std::ceil(x); }},
+      {"round", [](double x) { return std::round(x); }},
+      {"trunc", [](double x) { return std::trunc(x); }},
+      {"sqrt", [](double x) { return std::sqrt(x); }},
+      {"exp", [](double x) { return std::exp(x); }},
+      {"log", [](double x) { return std::log(x); }},
+      {"log10", [](double x) { return std::log10(x); }},
+      {"sin", [](double x) { return std::sin(x); }},
+      {"cos", [](double x) { return std::cos(x); }},
+      {"tan", [](double x) { return std::tan(x); }},
+      {"atan", [](double x) { return std::atan(x); }},
+  };
+
+  const std::map<std::string, double (*)(double, double), std::less<>> functions2{
+      {"fmod", [](double x, double y) { return std::fmod(x, y); }},
+      {"pow", [](double x, double y) { return std::pow(x, y); }},
+      {"atan2", [](double x, double y) { return std::atan2(x, y); }},
+      {"hypot", [](double x, double y) { return std::hypot(x, y); }},
+      {"min", [](double x, double y) { return std::min(x, y); }},
+      {"max", [](double x, double y) { return std::max(x, y); }},
+  };
+
+  // functions of integer arguments that return an integer
+  bool is_integer_function(std::string_view name) {
+    return (name == "abs") || (name == "min") || (name == "max");
+  }
+
+} // namespace
+
+/// Recursive descent parser emitting the stack program in postfix order
+class CompiledExpressionParser {
+public:
+  using Op = CompiledExpression::Op;
+
+  CompiledExpressionParser(std::string_view expr, const std::vector<std::string>& params)
+    : m_expr(expr), m_params(params) {
+    m_result.m_used.resize(params.size(), false);
+  }
+
+  CompiledExpression parse() {
+    ternary();
+    skip_space();
+    if (m_pos != m_expr.size()) {
+      fail("unexpected input");
+    }
+    return std::move(m_result);
+  }
+
+private:
+  std::string_view m_expr;
+  const std::vector<std::string>& m_params;
+  std::size_t m_pos{0};
+  std::size_t m_depth{0};
+  CompiledExpression m_result;
+
+  [[noreturn]] void fail(std::string_view what) const {
+    throw std::invalid_argument(fmt::format("Can not compile \"{}\": {} at position {}", m_expr, what, m_pos));
+  }
+
+  void skip_space() {
+    while ((m_pos < m_expr.size()) && std::isspace(static_cast<unsigned char>(m_expr[m_pos]))) {
+      ++m_pos;
+    }
+  }
+
+  bool accept(std::string_view token) {
+    skip_space();
+    if (m_expr.substr(m_pos, token.size()) == token) {
+      m_pos += token.size();
+      return true;
+    }
+    return false;
+  }
+
+  void expect(std::string_view token) {
+    if (!accept(token)) {
+      fail(fmt::format("expected \"{}\"", token));
+    }
+  }
+
+  void emit(CompiledExpression::Instruction ins, int stack_change) {
+    m_depth += stack_change;
+    if (m_depth > CompiledExpression::max_stack_depth) {
+      fail("expression is too deep");
+    }
+    m_result.m_code.push_back(ins);
+  }
+
+  void emit(Op op) {
+    // all plain operators are binary, except for these two
+    const bool unary = (op == Op::Neg) || (op == Op::Not);
+    emit({op}, unary ? 0 : -1);
+    fold(unary ? 1 : 2);
+  }
+
+  /// Replaces the last instruction by its value if all of its operands are constants
+  void fold(std::size_t operands) {
+    auto& code = m_result.m_code;
+    if (code.size() < operands + 1) {
+      return;
+    }
+    const auto first = code.end() - operands - 1;
+    if (!std::all_of(first, code.end() - 1, [](const auto& ins) { return ins.op == Op::Const; })) {
+      return;
+    }
+    CompiledExpression constant;
+    constant.m_code.assign(first, code.end());
+    const double value = constant.evaluate([](std::size_t) { return 0.; });
+    code.erase(first, code.end());
+    code.push_back({Op::Const, 0, value});
+  }
+
+  // Each of the following returns whether the parsed subexpression has an integer type
+
+  bool ternary() {
+    bool is_int = logical_or();
+    if (accept("?")) {
+      bool is_int_true = ternary();
+      expect(":");
+      bool is_int_false = ternary();
+      emit({Op::Select}, -2);
+      is_int = is_int_true && is_int_false;
+    }
+    return is_int;
+  }
+
+  bool logical_or() {
+    logical_and();
+    while (accept("||")) {
+      logical_and();
+      emit(Op::Or);
+    }
+    return true;
+  }
+
+  bool logical_and() {
+    equality();
+    while (accept("&&")) {
+      equality();
+      emit(Op::And);
+    }
+    return true;
+  }
+
+  bool equality() {
+    bool is_int = relational();
+    while (true) {
+      if (accept("==")) {
+        relational();
+        emit(Op::Eq);
+      } else if (accept("!=")) {
+        relational();
+        emit(Op::Ne);
+      } else {
+        break;
+      }
+      is_int = true;
+    }
+    return is_int;
+  }
+
+  bool relational() {
+    bool is_int = additive();
+    while (true) {
+      if (accept("<=")) {
+        additive();
+        emit(Op::Le);
+      } else if (accept(">=")) {
+        additive();
+        emit(Op::Ge);
+      } else if (accept("<")) {
+        additive();
+        emit(Op::Lt);
+      } else if (accept(">")) {
+        additive();
+        emit(Op::Gt);
+      } else {
+        break;
+      }
+      is_int = true;
+    }
+    return is_int;
+  }
+
+  bool additive() {
+    bool is_int = multiplicative();
+    while (true) {
+      Op op;
+      if (accept("+")) {
+        op = Op::Add;
+      } else if (accept("-")) {
+        op = Op::Sub;
+      } else {
+        break;
+      }
+      is_int = multiplicative() && is_int;
+      emit(op);
+    }
+    return is_int;
+  }
+
+  bool multiplicative() {
+    bool is_int = unary();
+    while (true) {
+      skip_space();
+      if (accept("*")) {
+        is_int = unary() && is_int;
+        emit(Op::Mul);
+      } else if (accept("/")) {
+        is_int = unary() && is_int;
+        emit(is_int ? Op::IDiv : Op::Div);
+      } else if (accept("%")) {
+        if (!(unary() && is_int)) {
+          fail("operator % requires integer operands");
+        }
+        emit(Op::IMod);
+      } else {
+        break;
+      }
+    }
+    return is_int;
+  }
+
+  bool unary() {
+    skip_space();
+    // do not confuse with "!="
+    if ((m_expr.substr(m_pos, 1) == "!") && (m_expr.substr(m_pos, 2) != "!=")) {
+      ++m_pos;
+      unary();
+      emit(Op::Not);
+      return true;
+    }
+    if (accept("-")) {
+      bool is_int = unary();
+      emit(Op::Neg);
+      return is_int;
+    }
+    if (accept("+")) {
+      return unary();
+    }
+    return primary();
+  }
+
+  bool primary() {
+    skip_space();
+    if (m_pos >= m_expr.size()) {
+      fail("unexpected end of expression");
+    }
+    char c = m_expr[m_pos];
+    if (accept("(")) {
+      bool is_int = ternary();
+      expect(")");
+      return is_int;
+    }
+    if (std::isdigit(static_cast<unsigned char>(c)) || (c == '.')) {
+      return number();
+    }
+    if (std::isalpha(static_cast<unsigned char>(c)) || (c == '_')) {
+      return identifier();
+    }
+    fail("unexpected character");
+  }
+
+  bool number() {
+    const std::string token{m_expr.substr(m_pos)};
+    char* end = nullptr;
+    double value = std::strtod(token.c_str(), &end);
+    std::size_t length = end - token.c_str();
+    std::string_view literal = m_expr.substr(m_pos, length);
+    m_pos += length;
+    if ((m_pos < m_expr.size()) && (std::isalnum(static_cast<unsigned char>(m_expr[m_pos])) || (m_expr[m_pos] == '_'))) {
+      fail("unsupported numeric literal");
+    }
+    emit({Op::Const, 0, value}, +1);
+    return literal.find_first_of(".eExXpP") == std::string_view::npos;
+  }
+
+  bool identifier() {
+    std::size_t begin = m_pos;
+    accept("std::");
+    std::size_t name_begin = m_pos;
+    while ((m_pos < m_expr.size()) && (std::isalnum(static_cast<unsigned char>(m_expr[m_pos])) || (m_expr[m_pos] == '_'))) {
+      ++m_pos;
+    }
+    std::string_view name = m_expr.substr(name_begin, m_pos - name_begin);
+    if (accept("(")) {
+      std::vector<bool> args_int;
+      if (!accept(")")) {
+        do {
+          args_int.push_back(ternary());
+        } while (accept(","));
+        expect(")");
+      }
+      bool all_int = std::all_of(args_int.begin(), args_int.end(), [](bool b) { return b; });
+      if (auto it = functions1.find(name); (it != functions1.end()) && (args_int.size() == 1)) {
+        emit({Op::Call1, 0, 0., it->second}, 0);
+        fold(1);
+      } else if (auto it = functions2.find(name); (it != functions2.end()) && (args_int.size() == 2)) {
+        emit({Op::Call2, 0, 0., nullptr, it->second}, -1);
+        fold(2);
+      } else {
+        m_pos = begin;
+        fail(fmt::format("unsupported function \"{}\" with {} arguments", name, args_int.size()));
+      }
+      return all_int && is_integer_function(name);
+    }
+    if (name_begin == begin) {
+      if (name == "true" || name == "false") {
+        emit({Op::Const, 0, (name == "true") ? 1. : 0.}, +1);
+        return true;
+      }
+      auto it = std::find(m_params.begin(), m_params.end(), name);
+      if (it != m_params.end()) {
+        std::size_t index = it - m_params.begin();
+        m_result.m_used[index] = true;
+        emit({Op::Load, index}, +1);
+        return false;
+      }
+    }
+    m_pos = begin;
+    fail(fmt::format("unknown identifier \"{}\"", name));
+  }
+};
+
+CompiledExpression CompiledExpression::compile(std::string_view expr, const std::vector<std::string>& params) {
+  return CompiledExpressionParser(expr, params).parse();
+}
+
+} // namespace eicrecon
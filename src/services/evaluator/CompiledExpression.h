@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * @brief Arithmetic expression compiled to a compact stack program
+ *
+ * Supports the subset of C++ that is used for configuration expressions:
+ * numeric literals, named parameters, arithmetic (`+ - * / %`), comparison
+ * (`== != < <= > >=`), logical (`! && ||`) and ternary (`?:`) operators, as
+ * well as the common math functions (`abs`, `floor`, `fmod`, `min`, ...,
+ * optionally prefixed with `std::`). Parameters are doubles, while integer
+ * literals follow the C++ integer arithmetic rules, so that the result is the
+ * same as for the expression passed through a C++ compiler.
+ *
+ * Subexpressions of constants only are folded into a single constant.
+ *
+ * compile() throws `std::invalid_argument` for anything outside of the subset,
+ * callers may fall back to a full interpreter in that case.
+ *
+ * Evaluation performs no allocations.
+ */
+class CompiledExpression {
+public:
+  enum class Op : std::uint8_t {
+    Const, Load, Neg, Not, Call1, Call2, Select,
+    Add, Sub, Mul, Div, IDiv, IMod,
+    Eq, Ne, Lt, Le, Gt, Ge, And, Or
+  };
+  struct Instruction {
+    Op op;
+    std::size_t index{0};
+    double value{0.};
+    double (*func1)(double){nullptr};
+    double (*func2)(double, double){nullptr};
+  };
+
+  /// Maximal depth of the evaluation stack
+  static constexpr std::size_t max_stack_depth = 64;
+
+  /**
+   * @brief Compile expression `expr`
+   * @param expr String expression to compile (e.g. `"abs(x_1 - x_2) == 1"`)
+   * @param params Parameter names, their position is the index of the value on evaluation
+   */
+  static CompiledExpression compile(std::string_view expr, const std::vector<std::string>& params);
+
+  /// Whether the parameter with index `param_ix` appears in the expression
+  bool uses(std::size_t param_ix) const {
+    return (param_ix < m_used.size()) && m_used[param_ix];
+  }
+
+  /// Number of parameters the expression was compiled with
+  std::size_t size() const { return m_used.size(); }
+
+  /// Number of instructions of the program, 1 for a constant
+  std::size_t instructions() const { return m_code.size(); }
+
+  /**
+   * @brief Evaluate the expression
+   * @param load Callable returning the value of the parameter with given index
+   */
+  template <typename Load>
+  double evaluate(Load&& load) const {
+    std::array<double, max_stack_depth> stack;
+    std::size_t sp = 0;
+    for (const auto& ins : m_code) {
+      switch (ins.op) {
+      case Op::Const:
+        stack[sp++] = ins.value;
+        break;
+      case Op::Load:
+        stack[sp++] = load(ins.index);
+        break;
+      case Op::Neg:
+        stack[sp - 1] = -stack[sp - 1];
+        break;
+      case Op::Not:
+        stack[sp - 1] = (stack[sp - 1] == 0.) ? 1. : 0.;
+        break;
+      case Op::Call1:
+        stack[sp - 1] = ins.func1(stack[sp - 1]);
+        break;
+      case Op::Call2:
+        --sp;
+        stack[sp - 1] = ins.func2(stack[sp - 1], stack[sp]);
+        break;
+      case Op::Select:
+        sp -= 2;
+        stack[sp - 1] = (stack[sp - 1] != 0.) ? stack[sp] : stack[sp + 1];
+        break;
+      case Op::Add: --sp; stack[sp - 1] = stack[sp - 1] + stack[sp]; break;
+      case Op::Sub: --sp; stack[sp - 1] = stack[sp - 1] - stack[sp]; break;
+      case Op::Mul: --sp; stack[sp - 1] = stack[sp - 1] * stack[sp]; break;
+      case Op::Div: --sp; stack[sp - 1] = stack[sp - 1] / stack[sp]; break;
+      case Op::IDiv: --sp; stack[sp - 1] = std::trunc(stack[sp - 1] / stack[sp]); break;
+      case Op::IMod: --sp; stack[sp - 1] = std::fmod(stack[sp - 1], stack[sp]); break;
+      case Op::Eq: --sp; stack[sp - 1] = (stack[sp - 1] == stack[sp]) ? 1. : 0.; break;
+      case Op::Ne: --sp; stack[sp - 1] = (stack[sp - 1] != stack[sp]) ? 1. : 0.; break;
+      case Op::Lt: --sp; stack[sp - 1] = (stack[sp - 1] < stack[sp]) ? 1. : 0.; break;
+      case Op::Le: --sp; stack[sp - 1] = (stack[sp - 1] <= stack[sp]) ? 1. : 0.; break;
+      case Op::Gt: --sp; stack[sp - 1] = (stack[sp - 1] > stack[sp]) ? 1. : 0.; break;
+      case Op::Ge: --sp; stack[sp - 1] = (stack[sp - 1] >= stack[sp]) ? 1. : 0.; break;
+      case Op::And: --sp; stack[sp - 1] = ((stack[sp - 1] != 0.) && (stack[sp] != 0.)) ? 1. : 0.; break;
+      case Op::Or: --sp; stack[sp - 1] = ((stack[sp - 1] != 0.) || (stack[sp] != 0.)) ? 1. : 0.; break;
+      }
+    }
+    return stack[0];
+  }
+
+  /// Evaluate with parameter values given by position
+  double operator()(std::span<const double> params) const {
+    return evaluate([params](std::size_t i) { return params[i]; });
+  }
+
+private:
+  std::vector<Instruction> m_code;
+  std::vector<bool> m_used;
+
+  friend class CompiledExpressionParser;
+};
+
+} // namespace eicrecon
@@ -7,8 +7,11 @@
 #include <fmt/core.h>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 
 #include "EvaluatorSvc.h"
+#include "services/log/StartupProfile.h"
 
 namespace eicrecon {
 
@@ -18,34 +21,121 @@ void EvaluatorSvc::init() {
   level(algorithms::LogLevel::kTrace);
 }
 
-std::function<double(const std::unordered_map<std::string, double>&)>
-EvaluatorSvc::_compile(const std::string& expr, std::vector<std::string> params) {
+std::shared_ptr<EvaluatorSvc::Function>
+EvaluatorSvc::_function(const std::string& expr, const std::vector<std::string>& params) {
   std::lock_guard<std::mutex> guard(m_interpreter_mutex);
+  ++m_requests;
+  auto [it, inserted] = m_functions.try_emplace({expr, params});
+  if (!inserted) {
+    debug("Reusing the compiled {} for \"{}\" ({} requests, {} expressions)", it->second->name, expr, m_requests,
+          m_functions.size());
+    return it->second;
+  }
+  auto function = std::make_shared<Function>();
+  function->name = fmt::format("_eicrecon_{}", m_function_id++);
+  function->expr = expr;
+  function->params = params;
+  it->second = function;
+  std::string reason = "native compilation is disabled";
+  if (m_native.value()) {
+    try {
+      function->native = CompiledExpression::compile(expr, params);
+      debug("Compiled \"{}\" natively to {} instructions", expr, function->native->instructions());
+      return function;
+    } catch (std::invalid_argument& e) {
+      reason = e.what();
+    }
+  }
+  if (!m_interpreter.value()) {
+    m_functions.erase(it);
+    const auto message = fmt::format("\"{}\" needs the interpreter, which is disabled: {}", expr, reason);
+    error("{}", message);
+    throw std::invalid_argument(message);
+  }
+  debug("{}, using the interpreter", reason);
+  if (m_batchCompile.value()) {
+    m_pending.push_back(function);
+  } else {
+    _compile_functions({function});
+  }
+  return function;
+}
+
+void EvaluatorSvc::_compile_functions(const std::vector<std::shared_ptr<Function>>& functions) {
+  if (functions.empty()) {
+    return;
+  }
+  eicrecon::StartupProfile::Scope profile("EvaluatorSvc JIT");
 
-  std::string func_name = fmt::format("_eicrecon_{}", m_function_id++);
   std::ostringstream sstr;
-  sstr << "double " << func_name << "(double params[]){";
-  for (unsigned int param_ix = 0; const auto& p : params) {
-    sstr << "double " << p << " = params[" << (param_ix++) << "];";
+  for (const auto& function : functions) {
+    sstr << "double " << function->name << "(double params[]){";
+    for (unsigned int param_ix = 0; const auto& p : function->params) {
+      sstr << "double " << p << " = params[" << (param_ix++) << "];";
+    }
+    sstr << "return " << function->expr << ";";
+    sstr << "}\n";
   }
-  sstr << "return " << expr << ";";
-  sstr << "}";
 
+  if (!m_interpreter_started) {
+    info("Starting the interpreter for \"{}\"", functions.front()->expr);
+    m_interpreter_started = true;
+  }
   TInterpreter* interp = TInterpreter::Instance();
   debug("Compiling {}", sstr.str());
   interp->ProcessLine(sstr.str().c_str());
-  std::unique_ptr<TInterpreterValue> func_val{gInterpreter->MakeInterpreterValue()};
-  interp->Evaluate(func_name.c_str(), *func_val);
-  typedef double (*func_t)(double params[]);
-  func_t func = ((func_t)(func_val->GetAsPointer()));
+  for (const auto& function : functions) {
+    std::unique_ptr<TInterpreterValue> func_val{gInterpreter->MakeInterpreterValue()};
+    interp->Evaluate(function->name.c_str(), *func_val);
+    function->func.store((func_t)(func_val->GetAsPointer()), std::memory_order_release);
+  }
+}
+
+void EvaluatorSvc::flush() {
+  std::lock_guard<std::mutex> guard(m_interpreter_mutex);
+  if (!m_pending.empty()) {
+    debug("Compiling {} pending expressions", m_pending.size());
+  }
+  _compile_functions(m_pending);
+  m_pending.clear();
+}
+
+EvaluatorSvc::func_t EvaluatorSvc::_resolve(Function& function) {
+  func_t func = function.func.load(std::memory_order_acquire);
+  if (func == nullptr) {
+    flush();
+    func = function.func.load(std::memory_order_acquire);
+  }
+  return func;
+}
 
-  return [params, func](const std::unordered_map<std::string, double>& param_values) {
+std::function<double(const std::unordered_map<std::string, double>&)>
+EvaluatorSvc::_compile(const std::string& expr, std::vector<std::string> params) {
+  auto function = _function(expr, params);
+
+  return [this, params, function](const std::unordered_map<std::string, double>& param_values) {
     std::vector<double> value_list;
     value_list.reserve(params.size());
     for (const auto& p : params) {
       value_list.push_back(param_values.at(p));
     }
-    return func(value_list.data());
+    if (function->native) {
+      return (*function->native)(value_list);
+    }
+    return _resolve(*function)(value_list.data());
+  };
+}
+
+std::function<double(std::span<const double>)>
+EvaluatorSvc::compile_positional(const std::string& expr, const std::vector<std::string>& params) {
+  auto function = _function(expr, params);
+
+  return [this, function](std::span<const double> param_values) {
+    if (function->native) {
+      return (*function->native)(param_values);
+    }
+    // the generated function only reads from the array
+    return _resolve(*function)(const_cast<double*>(param_values.data()));
   };
 }
 
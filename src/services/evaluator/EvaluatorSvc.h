@@ -2,26 +2,44 @@
 // Copyright (C) 2024 Dmitry Kalinkin
 
 #include <algorithms/logger.h>
+#include <atomic>
 #include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "CompiledExpression.h"
+
 namespace eicrecon {
 
 /**
  * @brief Provides an interface to a compiler that converts string expressions
  * to native `std::function`.
  *
- * The underlying implementation relies on ROOT's TInterpreter, but this may
- * change in the future. User can inspect the full C++ code by setting
+ * Expressions of the arithmetic, comparison, logical and ternary operators
+ * and of the common math functions are compiled by CompiledExpression,
+ * without the interpreter. Anything else is compiled by ROOT's TInterpreter. User can inspect the full C++ code by setting
  * `-PEvaluatorSvc:LogLevel=debug`, the list of provided variables is apparent
  * from the same output.
  *
  * Currently, return type is fixed to `double`, and all input parameters have
  * to be convertible to double.
+ *
+ * Identical expressions with the same parameters, e.g. of the same algorithm
+ * on every thread, are compiled only once. With `batchCompile`, the
+ * expressions are only compiled when one of them is first evaluated, all the
+ * pending ones in a single interpreter transaction.
+ *
+ * The interpreter is only created for the first expression that needs it, so
+ * that it is never set up for configurations of native expressions only. With
+ * `interpreter` set to false such an expression is rejected when it is
+ * compiled, with std::invalid_argument.
  */
 class EvaluatorSvc : public algorithms::LoggedService<EvaluatorSvc> {
 public:
@@ -62,9 +80,54 @@ public:
   std::function<double(const std::unordered_map<std::string, double>&)>
   _compile(const std::string& expr, std::vector<std::string> params);
 
+  /**
+   * @brief Compile expression `expr` to std::function of positional parameters
+   * @param expr String expression to compile (e.g. `"a + b"`)
+   * @param params List of parameter names used in the expression (e.g. `{"a", "b"}`)
+   *
+   * The resulting function accepts a span of `params.size()` values given in
+   * the order of `params`. Unlike _compile(), calling it does not allocate.
+   */
+  std::function<double(std::span<const double>)>
+  compile_positional(const std::string& expr, const std::vector<std::string>& params);
+
+  /// Compiles all the pending expressions of `batchCompile` in one transaction
+  void flush();
+
 private:
+  typedef double (*func_t)(double params[]);
+
+  /// An expression, either native or compiled by the interpreter once `func` is set
+  struct Function {
+    std::string name;
+    std::string expr;
+    std::vector<std::string> params;
+    std::optional<CompiledExpression> native;
+    std::atomic<func_t> func{nullptr};
+  };
+
+  /// The function of an expression, shared by all callers with the same expression and parameters
+  std::shared_ptr<Function> _function(const std::string& expr, const std::vector<std::string>& params);
+
+  /// The compiled function, compiling the pending ones if needed
+  func_t _resolve(Function& function);
+
+  /// Compiles the functions in one interpreter transaction, m_interpreter_mutex must be held
+  void _compile_functions(const std::vector<std::shared_ptr<Function>>& functions);
+
+  Property<bool> m_native{this, "native", true,
+                          "Compile the expressions that CompiledExpression supports without the interpreter"};
+  Property<bool> m_batchCompile{this, "batchCompile", false,
+                                "Compile the expressions when they are first evaluated, all pending ones at once"};
+  Property<bool> m_interpreter{this, "interpreter", true,
+                               "Compile the expressions that CompiledExpression does not support with the interpreter"};
+
   unsigned int m_function_id = 0;
   std::mutex m_interpreter_mutex;
+  std::map<std::pair<std::string, std::vector<std::string>>, std::shared_ptr<Function>> m_functions;
+  std::vector<std::shared_ptr<Function>> m_pending;
+  std::size_t m_requests = 0;
+  bool m_interpreter_started = false;
 
   ALGORITHMS_DEFINE_LOGGED_SERVICE(EvaluatorSvc);
 };
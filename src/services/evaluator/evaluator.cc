@@ -11,8 +11,17 @@ extern "C" {
 void InitPlugin(JApplication* app) {
   InitJANAPlugin(app);
 
+  bool use_interpreter = true;
+  app->SetDefaultParameter("evaluator:interpreter", use_interpreter,
+                           "Compile the expressions that have no native implementation with ROOT's interpreter, "
+                           "reject them if false");
+
   auto& serviceSvc = algorithms::ServiceSvc::instance();
   auto& evaluatorSvc = eicrecon::EvaluatorSvc::instance();
   serviceSvc.add<eicrecon::EvaluatorSvc>(&evaluatorSvc);
+  serviceSvc.setInit<eicrecon::EvaluatorSvc>([=](auto&& evaluator) {
+    evaluator.setProperty("interpreter", use_interpreter);
+    evaluator.init();
+  });
 }
 }
@@ -7,15 +7,20 @@
 
 #include <Acts/Visualization/ViewConfig.hpp>
 #include <JANA/JException.h>
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <exception>
+#include <future>
 #include <gsl/pointers>
 #include <stdexcept>
 #include <string>
 
 #include "ActsGeometryProvider.h"
 #include "services/geometry/dd4hep/DD4hep_service.h"
+#include "services/geometry/disk_cache/CacheFile.h"
 #include "services/log/Log_service.h"
+#include "services/log/StartupProfile.h"
 
 // Virtual destructor implementation to pin vtable and typeinfo to this
 // translation unit
@@ -32,19 +37,7 @@ std::shared_ptr<const ActsGeometryProvider> ACTSGeo_service::actsGeoProvider() {
     try{
         std::call_once(m_init_flag, [this](){
             // Assemble everything on the first call
-
-            if(!m_dd4hepGeo) {
-                throw JException("ACTSGeo_service m_dd4hepGeo==null which should never be!");
-            }
-
-            // Get material map from user parameter
-            std::string material_map_file;
-            try {
-              material_map_file = m_dd4hepGeo->constant<std::string>("material-map");
-            } catch (const std::runtime_error& e) {
-              material_map_file = "calibrations/materials-map.cbor";
-            }
-            m_app->SetDefaultParameter("acts:MaterialMap", material_map_file, "JSON/CBOR material map file path");
+            configure();
 
             // Reading the geometry may take a long time and if the JANA ticker is enabled, it will keep printing
             // while no other output is coming which makes it look like something is wrong. Disable the ticker
@@ -52,46 +45,17 @@ std::shared_ptr<const ActsGeometryProvider> ACTSGeo_service::actsGeoProvider() {
             auto tickerEnabled = m_app->IsTickerEnabled();
             m_app->SetTicker(false);
 
-            // Create default m_acts_provider
-            m_acts_provider = std::make_shared<ActsGeometryProvider>();
-
-            // Set ActsGeometryProvider parameters
-            bool objWriteIt = m_acts_provider->getObjWriteIt();
-            bool plyWriteIt = m_acts_provider->getPlyWriteIt();
-            m_app->SetDefaultParameter("acts:WriteObj", objWriteIt, "Write tracking geometry as obj files");
-            m_app->SetDefaultParameter("acts:WritePly", plyWriteIt, "Write tracking geometry as ply files");
-            m_acts_provider->setObjWriteIt(objWriteIt);
-            m_acts_provider->setPlyWriteIt(plyWriteIt);
-
-            std::string outputTag = m_acts_provider->getOutputTag();
-            std::string outputDir = m_acts_provider->getOutputDir();
-            m_app->SetDefaultParameter("acts:OutputTag", outputTag, "Obj and ply output file tag");
-            m_app->SetDefaultParameter("acts:OutputDir", outputDir, "Obj and ply output file dir");
-            m_acts_provider->setOutputTag(outputTag);
-            m_acts_provider->setOutputDir(outputDir);
-
-            std::array<int,3> containerView = m_acts_provider->getContainerView().color;
-            std::array<int,3> volumeView = m_acts_provider->getVolumeView().color;
-            std::array<int,3> sensitiveView = m_acts_provider->getSensitiveView().color;
-            std::array<int,3> passiveView = m_acts_provider->getPassiveView().color;
-            std::array<int,3> gridView = m_acts_provider->getGridView().color;
-            m_app->SetDefaultParameter("acts:ContainerView", containerView, "RGB for container views");
-            m_app->SetDefaultParameter("acts:VolumeView", volumeView, "RGB for volume views");
-            m_app->SetDefaultParameter("acts:SensitiveView", sensitiveView, "RGB for sensitive views");
-            m_app->SetDefaultParameter("acts:PassiveView", passiveView, "RGB for passive views");
-            m_app->SetDefaultParameter("acts:GridView", gridView, "RGB for grid views");
-            m_acts_provider->setContainerView(containerView);
-            m_acts_provider->setVolumeView(volumeView);
-            m_acts_provider->setSensitiveView(sensitiveView);
-            m_acts_provider->setPassiveView(passiveView);
-            m_acts_provider->setGridView(gridView);
-
-            // Initialize m_acts_provider
-            m_acts_provider->initialize(m_dd4hepGeo, material_map_file, m_log, m_log);
+            build();
 
             // Enable ticker back
             m_app->SetTicker(tickerEnabled);
         });
+
+        if(m_background_init.valid()) {
+            // rethrows what the background thread threw
+            eicrecon::StartupProfile::Scope profile("ACTS geometry wait");
+            m_background_init.get();
+        }
     }
     catch (std::exception &ex) {
         throw JException(ex.what());
@@ -101,6 +65,114 @@ std::shared_ptr<const ActsGeometryProvider> ACTSGeo_service::actsGeoProvider() {
 }
 
 
+//----------------------------------------------------------------
+// startBackgroundInit
+//
+/// Build the geometry in a background thread, the parameters are
+/// read on the calling thread.
+//----------------------------------------------------------------
+void ACTSGeo_service::startBackgroundInit() {
+
+    try{
+        std::call_once(m_init_flag, [this](){
+            configure();
+            m_log->info("Building the ACTS geometry in the background");
+            m_background_init = std::async(std::launch::async, [this](){ build(); }).share();
+        });
+    }
+    catch (std::exception &ex) {
+        throw JException(ex.what());
+    }
+}
+
+
+void ACTSGeo_service::configure() {
+
+    if(!m_dd4hepGeo) {
+        throw JException("ACTSGeo_service m_dd4hepGeo==null which should never be!");
+    }
+
+    // Get material map from user parameter
+    try {
+      m_material_map_file = m_dd4hepGeo->constant<std::string>("material-map");
+    } catch (const std::runtime_error& e) {
+      m_material_map_file = "calibrations/materials-map.cbor";
+    }
+    m_app->SetDefaultParameter("acts:MaterialMap", m_material_map_file, "JSON/CBOR material map file path");
+
+    // Create default m_acts_provider
+    m_acts_provider = std::make_shared<ActsGeometryProvider>();
+
+    // Set ActsGeometryProvider parameters
+    bool objWriteIt = m_acts_provider->getObjWriteIt();
+    bool plyWriteIt = m_acts_provider->getPlyWriteIt();
+    m_app->SetDefaultParameter("acts:WriteObj", objWriteIt, "Write tracking geometry as obj files");
+    m_app->SetDefaultParameter("acts:WritePly", plyWriteIt, "Write tracking geometry as ply files");
+    m_acts_provider->setObjWriteIt(objWriteIt);
+    m_acts_provider->setPlyWriteIt(plyWriteIt);
+
+    std::string outputTag = m_acts_provider->getOutputTag();
+    std::string outputDir = m_acts_provider->getOutputDir();
+    m_app->SetDefaultParameter("acts:OutputTag", outputTag, "Obj and ply output file tag");
+    m_app->SetDefaultParameter("acts:OutputDir", outputDir, "Obj and ply output file dir");
+    m_acts_provider->setOutputTag(outputTag);
+    m_acts_provider->setOutputDir(outputDir);
+
+    std::array<int,3> containerView = m_acts_provider->getContainerView().color;
+    std::array<int,3> volumeView = m_acts_provider->getVolumeView().color;
+    std::array<int,3> sensitiveView = m_acts_provider->getSensitiveView().color;
+    std::array<int,3> passiveView = m_acts_provider->getPassiveView().color;
+    std::array<int,3> gridView = m_acts_provider->getGridView().color;
+    m_app->SetDefaultParameter("acts:ContainerView", containerView, "RGB for container views");
+    m_app->SetDefaultParameter("acts:VolumeView", volumeView, "RGB for volume views");
+    m_app->SetDefaultParameter("acts:SensitiveView", sensitiveView, "RGB for sensitive views");
+    m_app->SetDefaultParameter("acts:PassiveView", passiveView, "RGB for passive views");
+    m_app->SetDefaultParameter("acts:GridView", gridView, "RGB for grid views");
+    m_acts_provider->setContainerView(containerView);
+    m_acts_provider->setVolumeView(volumeView);
+    m_acts_provider->setSensitiveView(sensitiveView);
+    m_acts_provider->setPassiveView(passiveView);
+    m_acts_provider->setGridView(gridView);
+
+    // Magnetic field grid
+    auto fieldGrid = m_acts_provider->getFieldGrid();
+    std::array<double,3> fieldGridMin = fieldGrid.min;
+    std::array<double,3> fieldGridMax = fieldGrid.max;
+    std::array<int,3> fieldGridPoints;
+    std::copy(fieldGrid.points.begin(), fieldGrid.points.end(), fieldGridPoints.begin());
+    fieldGrid.cacheDir = eicrecon::cache_file::default_directory();
+    m_app->SetDefaultParameter("acts:FieldGrid", fieldGrid.enabled, "Interpolate the magnetic field on a grid sampled from DD4hep");
+    m_app->SetDefaultParameter("acts:FieldGridRZ", fieldGrid.rz, "Use an r-z grid for a rotationally symmetric field, x-y-z otherwise");
+    m_app->SetDefaultParameter("acts:FieldGridMin", fieldGridMin, "Lower grid bounds in mm, (r, z) or (x, y, z)");
+    m_app->SetDefaultParameter("acts:FieldGridMax", fieldGridMax, "Upper grid bounds in mm, (r, z) or (x, y, z)");
+    m_app->SetDefaultParameter("acts:FieldGridPoints", fieldGridPoints, "Number of grid points per axis");
+    m_app->SetDefaultParameter("acts:FieldGridCacheDir", fieldGrid.cacheDir, "Directory of the sampled field grids (no caching if empty)");
+    m_app->SetDefaultParameter("acts:FieldGridNumaReplicas", fieldGrid.numaReplicas, "Copy the field grid to every NUMA node, for the threads pinned there with jana:numa_policy");
+    fieldGrid.min = fieldGridMin;
+    fieldGrid.max = fieldGridMax;
+    // negative numbers would wrap around as grid sizes; the third axis is not used by an r-z grid
+    for (std::size_t d = 0; d < (fieldGrid.rz ? 2 : 3); ++d) {
+        if (fieldGridPoints[d] <= 0) {
+            throw JException("acts:FieldGridPoints: the number of grid points of axis %zu must be positive, got %d", d, fieldGridPoints[d]);
+        }
+    }
+    std::copy(fieldGridPoints.begin(), fieldGridPoints.end(), fieldGrid.points.begin());
+    m_acts_provider->setFieldGrid(fieldGrid);
+
+    // Binary cache of the parsed material map
+    std::string materialMapCacheDir = cacheDir;
+    m_app->SetDefaultParameter("acts:MaterialMapCacheDir", materialMapCacheDir, "Directory of the binary material map cache (no caching if empty)");
+    m_acts_provider->setMaterialMapCacheDir(materialMapCacheDir);
+}
+
+
+void ACTSGeo_service::build() {
+
+    eicrecon::StartupProfile::Scope profile("ACTS geometry");
+    m_acts_provider->initialize(m_dd4hepGeo, m_material_map_file, m_log, m_log);
+}
+
+
 
 void ACTSGeo_service::acquire_services(JServiceLocator * srv_locator) {
 
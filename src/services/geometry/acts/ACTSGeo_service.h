@@ -7,12 +7,21 @@
 #include <JANA/JApplication.h>
 #include <JANA/Services/JServiceLocator.h>
 #include <spdlog/logger.h>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <string>
 
 #include "algorithms/tracking/ActsGeometryProvider.h"
 
 
+/**
+ * Builds the ActsGeometryProvider on the first actsGeoProvider() call, or
+ * with `-Pacts:BackgroundInit=true` in a background thread started when the
+ * processors are initialised, overlapping the initialisation of the other
+ * services and factories. actsGeoProvider() then only waits if it is not
+ * ready yet.
+ */
 class ACTSGeo_service : public JService
 {
 public:
@@ -21,6 +30,9 @@ public:
 
     virtual std::shared_ptr<const ActsGeometryProvider> actsGeoProvider();
 
+    /// Starts building the geometry in a background thread, unless it is already built or started
+    void startBackgroundInit();
+
 protected:
 
 
@@ -28,7 +40,15 @@ private:
     ACTSGeo_service()=default;
     void acquire_services(JServiceLocator *) override;
 
+    /// Makes m_acts_provider and sets its parameters, on the calling thread
+    void configure();
+
+    /// Initializes m_acts_provider, the part that takes long
+    void build();
+
     std::once_flag m_init_flag;
+    std::shared_future<void> m_background_init;
+    std::string m_material_map_file;
     JApplication *m_app = nullptr;
     const dd4hep::Detector* m_dd4hepGeo = nullptr;
     std::shared_ptr<ActsGeometryProvider> m_acts_provider;
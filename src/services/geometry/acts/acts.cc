@@ -4,13 +4,45 @@
 //
 
 #include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JEventProcessor.h>
 #include <memory>
 
 #include "ACTSGeo_service.h"
+#include "services/algorithms_init/ParallelInit.h"
+
+namespace {
+
+/// Starts building the ACTS geometry in the background with -Pacts:BackgroundInit=true
+class ACTSGeoBackgroundInit_processor : public JEventProcessor {
+public:
+    ACTSGeoBackgroundInit_processor() { SetTypeName("ACTSGeoBackgroundInit_processor"); }
+
+    void Init() override {
+        auto app = GetApplication();
+        bool background_init = false;
+        app->SetDefaultParameter("acts:BackgroundInit", background_init, "Build the ACTS geometry in a background thread while the rest is initialised");
+        if (background_init) {
+            app->GetService<ACTSGeo_service>()->startBackgroundInit();
+        }
+    }
+
+    void Process(const std::shared_ptr<const JEvent>& event) override {}
+};
+
+} // namespace
 
 extern "C" {
 void InitPlugin(JApplication *app) {
     InitJANAPlugin(app);
     app->ProvideService(std::make_shared<ACTSGeo_service>(app) );
+    eicrecon::ParallelInit::instance().add("acts", {"dd4hep"}, [app]() {
+        app->GetService<ACTSGeo_service>()->actsGeoProvider();
+    });
+    // waits for -Pacts:BackgroundInit as well
+    eicrecon::ParallelInit::instance().addBeforeFork("acts", [app]() {
+        app->GetService<ACTSGeo_service>()->actsGeoProvider();
+    });
+    app->Add(new ACTSGeoBackgroundInit_processor());
 }
 }
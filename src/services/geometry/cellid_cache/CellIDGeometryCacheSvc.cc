@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <DD4hep/Detector.h>
+#include <DD4hep/Readout.h>
+#include <DD4hep/Segmentations.h>
+#include <DD4hep/VolumeManager.h>
+#include <DDRec/CellIDPositionConverter.h>
+#include <algorithms/geo.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "CellIDGeometryCacheSvc.h"
+
+namespace eicrecon {
+
+void CellIDGeometryCacheSvc::init() {
+  // This is needed to bypass condition in algorithms::LoggerMixin::report and
+  // forward all messages to our instance of LogSvc/spdlog.
+  level(algorithms::LogLevel::kTrace);
+}
+
+CellIDGeometryCacheSvc::ThreadCache& CellIDGeometryCacheSvc::threadCache() {
+  // the service is a singleton, so a single cache per thread
+  thread_local ThreadCacheOwner owner;
+  if (owner.cache == nullptr) {
+    owner.cache = std::make_unique<ThreadCache>(m_threadCacheSize.value());
+    owner.service = this;
+    std::lock_guard<std::mutex> lock(m_thread_caches_mutex);
+    m_thread_caches.push_back(owner.cache.get());
+  }
+  return *owner.cache;
+}
+
+CellIDGeometryCacheSvc::ThreadCacheOwner::~ThreadCacheOwner() {
+  if (cache == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(service->m_thread_caches_mutex);
+  service->m_retired_position_counters.hits += cache->position_hits.load(std::memory_order_relaxed);
+  service->m_retired_position_counters.misses += cache->position_misses.load(std::memory_order_relaxed);
+  service->m_retired_context_counters.hits += cache->context_hits.load(std::memory_order_relaxed);
+  service->m_retired_context_counters.misses += cache->context_misses.load(std::memory_order_relaxed);
+  auto& caches = service->m_thread_caches;
+  caches.erase(std::remove(caches.begin(), caches.end(), cache.get()), caches.end());
+}
+
+dd4hep::Position CellIDGeometryCacheSvc::position(std::uint64_t cellID) {
+  auto& cache = threadCache();
+  if (const auto* pos = cache.positions.find(cellID)) {
+    cache.position_hits.fetch_add(1, std::memory_order_relaxed);
+    return *pos;
+  }
+  cache.position_misses.fetch_add(1, std::memory_order_relaxed);
+  auto pos = m_position.get(cellID, m_sharedCacheSize.value(), [](std::uint64_t id) {
+    return algorithms::GeoSvc::instance().cellIDPositionConverter()->position(id);
+  });
+  cache.positions.insert(cellID, pos);
+  return pos;
+}
+
+const dd4hep::VolumeManagerContext* CellIDGeometryCacheSvc::findContext(std::uint64_t cellID) {
+  auto& cache = threadCache();
+  // the volume ID of a cell is its cellID with the segmentation bits masked out
+  for (const auto mask : cache.context_masks) {
+    if (const auto* context = cache.contexts.find(cellID & mask)) {
+      cache.context_hits.fetch_add(1, std::memory_order_relaxed);
+      return *context;
+    }
+  }
+  cache.context_misses.fetch_add(1, std::memory_order_relaxed);
+  const auto* context = algorithms::GeoSvc::instance().cellIDPositionConverter()->findContext(cellID);
+  if (context != nullptr) {
+    if (std::find(cache.context_masks.begin(), cache.context_masks.end(), context->mask) == cache.context_masks.end()) {
+      cache.context_masks.push_back(context->mask);
+    }
+    cache.contexts.insert(cellID & context->mask, context);
+  }
+  return context;
+}
+
+dd4hep::DetElement CellIDGeometryCacheSvc::detElement(std::uint64_t cellID) {
+  return m_det_element.get(cellID, m_sharedCacheSize.value(), [](std::uint64_t id) {
+    return algorithms::GeoSvc::instance().detector()->volumeManager().lookupDetElement(id);
+  });
+}
+
+std::array<double, 3> CellIDGeometryCacheSvc::cellDimensions(std::uint64_t cellID) {
+  return m_cell_dimensions.get(cellID, m_sharedCacheSize.value(), [this](std::uint64_t id) {
+    const auto* converter = algorithms::GeoSvc::instance().cellIDPositionConverter();
+    std::array<double, 3> dim{0., 0., 0.};
+    auto segmentation_type = converter->findReadout(detElement(id)).segmentation().type();
+    if (segmentation_type == "CartesianGridXY" || segmentation_type == "HexGridXY") {
+      auto cell_dim = converter->cellDimensions(id);
+      dim[0] = cell_dim[0];
+      dim[1] = cell_dim[1];
+    } else {
+      if (segmentation_type != "NoSegmentation") {
+        std::lock_guard<std::mutex> lock(m_warning_mutex);
+        if (!m_warned_segmentation[segmentation_type]) {
+          warning("Unsupported segmentation type \"{}\"", segmentation_type);
+          m_warned_segmentation[segmentation_type] = true;
+        }
+      }
+      // Using bounding box instead of actual solid so the dimensions are always in dim_x, dim_y, dim_z
+      std::vector<double> half_dim = converter->findContext(id)->volumePlacement().volume().boundingBox().dimensions();
+      for (std::size_t i = 0; i < std::min(half_dim.size(), dim.size()); ++i) {
+        dim[i] = 2 * half_dim[i];
+      }
+    }
+    return dim;
+  });
+}
+
+CellIDGeometryCacheSvc::Counters CellIDGeometryCacheSvc::threadPositionCounters() const {
+  std::lock_guard<std::mutex> lock(m_thread_caches_mutex);
+  Counters counters = m_retired_position_counters;
+  for (const auto* cache : m_thread_caches) {
+    counters.hits += cache->position_hits.load(std::memory_order_relaxed);
+    counters.misses += cache->position_misses.load(std::memory_order_relaxed);
+  }
+  return counters;
+}
+
+CellIDGeometryCacheSvc::Counters CellIDGeometryCacheSvc::threadContextCounters() const {
+  std::lock_guard<std::mutex> lock(m_thread_caches_mutex);
+  Counters counters = m_retired_context_counters;
+  for (const auto* cache : m_thread_caches) {
+    counters.hits += cache->context_hits.load(std::memory_order_relaxed);
+    counters.misses += cache->context_misses.load(std::memory_order_relaxed);
+  }
+  return counters;
+}
+
+void CellIDGeometryCacheSvc::report() const {
+  auto log_counters = [this](const char* name, Counters c) {
+    const std::uint64_t total = c.hits + c.misses;
+    info("{}: {} lookups, {} cells computed, hit rate {:.1f}%", name, total, c.misses,
+         (total > 0) ? 100. * c.hits / total : 0.);
+  };
+  log_counters("position (per thread)", threadPositionCounters());
+  log_counters("position (shared)", positionCounters());
+  log_counters("context (per thread)", threadContextCounters());
+  log_counters("detElement", detElementCounters());
+  log_counters("cellDimensions", cellDimensionsCounters());
+  info("shared caches: {} positions, {} DetElements, {} cell dimensions held, up to {} each",
+       positionSize(), detElementSize(), cellDimensionsSize(), m_sharedCacheSize.value());
+}
+
+} // namespace eicrecon
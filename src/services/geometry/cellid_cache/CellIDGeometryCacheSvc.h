@@ -0,0 +1,224 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <DD4hep/DetElement.h>
+#include <DD4hep/Objects.h>
+#include <DD4hep/VolumeManager.h>
+#include <algorithms/logger.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * @brief Shared cache of the static geometry of readout cells
+ *
+ * Geometry does not change during a run, so the DD4hep lookups done for
+ * every hit (cell position, DetElement of the volume, cell dimensions) can be
+ * memoised per cellID. Entries are filled lazily on first use by any thread,
+ * the cache is sharded and guarded by reader-writer locks, so that lookups
+ * of already known cells from different threads do not contend. Every cache
+ * holds up to `sharedCacheSize` cells, split evenly over the shards; a full
+ * shard is cleared before it takes a new cell, so that a long job over many
+ * detectors does not grow without bound.
+ *
+ * In front of the shared caches, every thread keeps a small LRU cache of
+ * its recent positions and of the VolumeManager contexts by volume ID, so
+ * that repeated hits on the same sensors neither walk the geometry nor take
+ * a lock. The sizes are set by `threadCacheSize`. The cache of a thread is
+ * freed when the thread exits, so short-lived threads (e.g. of std::async)
+ * do not accumulate caches; their counters are kept for the statistics.
+ *
+ * Lookups throw the same exceptions as the underlying DD4hep calls for
+ * unknown cellIDs, nothing is cached in that case.
+ */
+class CellIDGeometryCacheSvc : public algorithms::LoggedService<CellIDGeometryCacheSvc> {
+public:
+  /// Number of lookups answered from the cache, and number of cells computed
+  struct Counters {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+  };
+
+  void init();
+
+  /// Global position of the cell center (`CellIDPositionConverter::position`)
+  dd4hep::Position position(std::uint64_t cellID);
+
+  /// VolumeManager context of the placed volume (`CellIDPositionConverter::findContext`)
+  const dd4hep::VolumeManagerContext* findContext(std::uint64_t cellID);
+
+  /// DetElement of the placed volume (`VolumeManager::lookupDetElement`)
+  dd4hep::DetElement detElement(std::uint64_t cellID);
+
+  /**
+   * @brief Full cell dimensions
+   *
+   * Taken from the segmentation for `CartesianGridXY` and `HexGridXY` (with a
+   * zero third dimension), from the bounding box of the volume otherwise.
+   */
+  std::array<double, 3> cellDimensions(std::uint64_t cellID);
+
+  Counters positionCounters() const { return m_position.counters(); }
+  Counters detElementCounters() const { return m_det_element.counters(); }
+  Counters cellDimensionsCounters() const { return m_cell_dimensions.counters(); }
+  /// Cells currently held by the shared caches
+  std::size_t positionSize() const { return m_position.size(); }
+  std::size_t detElementSize() const { return m_det_element.size(); }
+  std::size_t cellDimensionsSize() const { return m_cell_dimensions.size(); }
+  /// Summed over the per-thread caches
+  Counters threadPositionCounters() const;
+  Counters threadContextCounters() const;
+
+  /// Log the hit rates of the caches
+  void report() const;
+
+private:
+  template <typename T>
+  class Cache {
+  public:
+    /// The value of a cell, computed if it is not cached; a shard holds at most
+    /// capacity / n_shards cells (rounded up), no limit with a zero capacity
+    template <typename Compute>
+    T get(std::uint64_t cellID, std::size_t capacity, Compute&& compute) {
+      auto& shard = m_shards[shard_index(cellID)];
+      {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        if (auto it = shard.map.find(cellID); it != shard.map.end()) {
+          m_hits.fetch_add(1, std::memory_order_relaxed);
+          return it->second;
+        }
+      }
+      // computed outside of the lock, several threads may compute the same cell
+      T value = compute(cellID);
+      {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        const std::size_t shard_capacity = (capacity + n_shards - 1) / n_shards;
+        if (capacity > 0 && shard.map.size() >= shard_capacity && shard.map.count(cellID) == 0) {
+          shard.map.clear();
+        }
+        shard.map.emplace(cellID, value);
+      }
+      m_misses.fetch_add(1, std::memory_order_relaxed);
+      return value;
+    }
+
+    Counters counters() const {
+      return {m_hits.load(std::memory_order_relaxed), m_misses.load(std::memory_order_relaxed)};
+    }
+
+    std::size_t size() const {
+      std::size_t n = 0;
+      for (auto& shard : m_shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        n += shard.map.size();
+      }
+      return n;
+    }
+
+  private:
+    static constexpr std::size_t n_shards = 16;
+
+    static std::size_t shard_index(std::uint64_t cellID) {
+      // cellID bits are structured, mix them before taking the top bits
+      return (cellID * 0x9E3779B97F4A7C15ULL) >> 60;
+    }
+
+    struct Shard {
+      mutable std::shared_mutex mutex;
+      std::unordered_map<std::uint64_t, T> map;
+    };
+    std::array<Shard, n_shards> m_shards;
+    std::atomic<std::uint64_t> m_hits{0};
+    std::atomic<std::uint64_t> m_misses{0};
+  };
+
+  /// Least recently used entries of a single thread, none with a zero capacity
+  template <typename K, typename V>
+  class LruCache {
+  public:
+    explicit LruCache(std::size_t capacity) : m_capacity(capacity) {}
+
+    const V* find(const K& key) {
+      auto it = m_map.find(key);
+      if (it == m_map.end()) {
+        return nullptr;
+      }
+      m_entries.splice(m_entries.begin(), m_entries, it->second);
+      return &it->second->second;
+    }
+
+    void insert(const K& key, const V& value) {
+      if (m_capacity == 0 || m_map.count(key) > 0) {
+        return;
+      }
+      if (m_map.size() >= m_capacity) {
+        m_map.erase(m_entries.back().first);
+        m_entries.pop_back();
+      }
+      m_entries.emplace_front(key, value);
+      m_map.emplace(key, m_entries.begin());
+    }
+
+  private:
+    std::size_t m_capacity;
+    std::list<std::pair<K, V>> m_entries; // most recently used first
+    std::unordered_map<K, typename std::list<std::pair<K, V>>::iterator> m_map;
+  };
+
+  struct ThreadCache {
+    explicit ThreadCache(std::size_t capacity) : positions(capacity), contexts(capacity) {}
+    LruCache<std::uint64_t, dd4hep::Position> positions;
+    LruCache<dd4hep::VolumeID, const dd4hep::VolumeManagerContext*> contexts; // by volume ID
+    std::vector<dd4hep::VolumeID> context_masks; // of the contexts seen, few per detector
+    // only incremented by the thread of the cache
+    std::atomic<std::uint64_t> position_hits{0};
+    std::atomic<std::uint64_t> position_misses{0};
+    std::atomic<std::uint64_t> context_hits{0};
+    std::atomic<std::uint64_t> context_misses{0};
+  };
+
+  /// The cache of the calling thread, made on its first lookup and freed when the thread exits
+  ThreadCache& threadCache();
+
+  /// Owner of the cache of a thread, which takes it out of the registry on exit
+  struct ThreadCacheOwner {
+    CellIDGeometryCacheSvc* service{nullptr};
+    std::unique_ptr<ThreadCache> cache;
+    ~ThreadCacheOwner();
+  };
+
+  Property<std::size_t> m_threadCacheSize{this, "threadCacheSize", 4096,
+                                          "Entries of the position and context caches of every thread"};
+  Property<std::size_t> m_sharedCacheSize{this, "sharedCacheSize", 1 << 20,
+                                          "Cells of each of the shared caches (0 for no limit)"};
+
+  // the caches of the live threads, and the counters of those of the exited threads
+  mutable std::mutex m_thread_caches_mutex;
+  std::vector<ThreadCache*> m_thread_caches;
+  Counters m_retired_position_counters;
+  Counters m_retired_context_counters;
+
+  Cache<dd4hep::Position> m_position;
+  Cache<dd4hep::DetElement> m_det_element;
+  Cache<std::array<double, 3>> m_cell_dimensions;
+
+  std::mutex m_warning_mutex;
+  std::unordered_map<std::string, bool> m_warned_segmentation;
+
+  ALGORITHMS_DEFINE_LOGGED_SERVICE(CellIDGeometryCacheSvc);
+};
+
+} // namespace eicrecon
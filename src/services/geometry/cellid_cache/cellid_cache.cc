@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JEventProcessor.h>
+#include <algorithms/service.h>
+#include <memory>
+
+#include "CellIDGeometryCacheSvc.h"
+
+namespace {
+
+/// Reports the hit rates of the cellID geometry caches at the end of the job
+class CellIDGeometryCacheReport_processor : public JEventProcessor {
+public:
+  CellIDGeometryCacheReport_processor() { SetTypeName("CellIDGeometryCacheReport_processor"); }
+
+  void Process(const std::shared_ptr<const JEvent>& event) override {}
+
+  void Finish() override {
+    auto& cacheSvc = eicrecon::CellIDGeometryCacheSvc::instance();
+    const auto position = cacheSvc.threadPositionCounters();
+    const auto context = cacheSvc.threadContextCounters();
+    if (position.hits + position.misses + context.hits + context.misses > 0) {
+      cacheSvc.report();
+    }
+  }
+};
+
+} // namespace
+
+extern "C" {
+
+void InitPlugin(JApplication* app) {
+  InitJANAPlugin(app);
+
+  auto& serviceSvc = algorithms::ServiceSvc::instance();
+  auto& cacheSvc = eicrecon::CellIDGeometryCacheSvc::instance();
+  serviceSvc.add<eicrecon::CellIDGeometryCacheSvc>(&cacheSvc);
+
+  app->Add(new CellIDGeometryCacheReport_processor());
+}
+}
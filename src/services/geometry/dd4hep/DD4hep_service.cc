@@ -2,8 +2,10 @@
 // Copyright (C) 2022, 2023 Whitney Armstrong, Wouter Deconinck, David Lawrence
 //
 
+#include <DD4hep/DD4hepRootPersistency.h>
 #include <JANA/JException.h>
 #include <Parsers/Printout.h>
+#include <RVersion.h>
 #include <TGeoManager.h>
 #include <fmt/color.h>
 #include <fmt/core.h>
@@ -14,11 +16,14 @@
 #include <filesystem>
 #include <iostream>
 #include <stdexcept>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "DD4hep_service.h"
+#include "services/geometry/disk_cache/CacheFile.h"
 #include "services/log/Log_service.h"
+#include "services/log/StartupProfile.h"
 
 //----------------------------------------------------------------
 // Services
@@ -71,6 +76,22 @@ DD4hep_service::converter() {
     return m_cellid_converter.get();
 }
 
+//----------------------------------------------------------------
+// compactFingerprint
+//
+/// Return the hash of the XML files that the geometry was built from,
+/// computed once. Call Initialize if needed.
+//----------------------------------------------------------------
+std::uint64_t DD4hep_service::compactFingerprint() {
+    std::call_once(init_flag, &DD4hep_service::Initialize, this);
+    std::call_once(m_fingerprint_flag, [this]() {
+        if (m_compact_fingerprint == 0) {
+            m_compact_fingerprint = snapshotKey(m_resolved_xml_files);
+        }
+    });
+    return m_compact_fingerprint;
+}
+
 //----------------------------------------------------------------
 // Initialize
 //
@@ -81,6 +102,8 @@ DD4hep_service::converter() {
 //----------------------------------------------------------------
 void DD4hep_service::Initialize() {
 
+    eicrecon::StartupProfile::Scope profile("DD4hep geometry");
+
     if (m_dd4hepGeo) {
         m_log->warn("DD4hep_service already initialized!");
     }
@@ -106,6 +129,8 @@ void DD4hep_service::Initialize() {
     // User may specify multiple geometry files via the config. parameter. Normally, this
     // will be a single file which itself has includes for other files.
     m_app->SetDefaultParameter("dd4hep:xml_files", m_xml_files, "Comma separated list of XML files describing the DD4hep geometry. (Defaults to ${DETECTOR_PATH}/${DETECTOR_CONFIG}.xml using envars.)");
+    m_app->SetDefaultParameter("dd4hep:snapshot", m_snapshot, "Load the geometry from a snapshot of an earlier build of the same XML files, and write one after a build. DetElement extensions are not in the snapshot.");
+    m_app->SetDefaultParameter("dd4hep:snapshot_dir", m_snapshot_dir, "Directory of the geometry snapshots, $XDG_CACHE_HOME/eicrecon or ~/.cache/eicrecon if empty");
 
     if( m_xml_files.empty() ){
         m_log->error("No dd4hep XML file specified for the geometry!");
@@ -121,13 +146,42 @@ void DD4hep_service::Initialize() {
     auto tickerEnabled = m_app->IsTickerEnabled();
     m_app->SetTicker( false );
 
+    std::vector<std::string> resolved_filenames;
+    for (auto &filename : m_xml_files) {
+        resolved_filenames.push_back(resolveFileName(filename, detector_path_env));
+    }
+    m_resolved_xml_files = resolved_filenames;
+
+    // A snapshot of an earlier build of the same XML files, if there is one
+    std::string snapshot_path;
+    if (m_snapshot) {
+        const std::string snapshot_dir = snapshotDirectory();
+        if (!snapshot_dir.empty()) {
+            m_compact_fingerprint = snapshotKey(resolved_filenames);
+            snapshot_path = fmt::format("{}/dd4hep_{:016x}.root", snapshot_dir, m_compact_fingerprint);
+        }
+    }
+
     // load geometry
     auto detector = dd4hep::Detector::make_unique("");
+    bool from_snapshot = false;
+    if (!snapshot_path.empty() && std::filesystem::exists(snapshot_path)) {
+        m_log->info("Loading DD4hep geometry snapshot '{}'", snapshot_path);
+        try {
+            from_snapshot = dd4hep::DD4hepRootPersistency::load(*detector, snapshot_path.c_str(), "Geometry") > 0;
+        } catch(std::exception &e) {
+            m_log->warn("Problem loading the geometry snapshot: {}", e.what());
+        }
+        if (!from_snapshot) {
+            m_log->warn("Can not load the geometry snapshot '{}', building the geometry from the XML files", snapshot_path);
+            detector = dd4hep::Detector::make_unique("");
+        }
+    }
     try {
-        m_log->info("Loading DD4hep geometry from {} files", m_xml_files.size());
-        for (auto &filename : m_xml_files) {
-
-            auto resolved_filename = resolveFileName(filename, detector_path_env);
+        if (!from_snapshot) {
+            m_log->info("Loading DD4hep geometry from {} files", m_xml_files.size());
+        }
+        for (auto &resolved_filename : from_snapshot ? std::vector<std::string>{} : resolved_filenames) {
 
             m_log->info("  - loading geometry file:  '{}' (patience ....)", resolved_filename);
             try {
@@ -136,6 +190,19 @@ void DD4hep_service::Initialize() {
                 throw JException(e.what());
             }
         }
+        if (!from_snapshot && !snapshot_path.empty()) {
+            try {
+                eicrecon::cache_file::write_atomically(snapshot_path, [&detector](const std::filesystem::path& tmp_path) {
+                    if (dd4hep::DD4hepRootPersistency::save(*detector, tmp_path.c_str(), "Geometry") <= 0) {
+                        throw std::runtime_error(fmt::format("can not save the geometry to '{}'", tmp_path.string()));
+                    }
+                });
+                m_log->info("Wrote the geometry snapshot '{}'", snapshot_path);
+            } catch(std::exception &e) {
+                // a snapshot that can not be written is not an error, the XML files are read again next time
+                m_log->warn("Can not write the geometry snapshot '{}': {}", snapshot_path, e.what());
+            }
+        }
         detector->volumeManager();
         detector->apply("DD4hepVolumeManager", 0, nullptr);
         m_cellid_converter = std::make_unique<const dd4hep::rec::CellIDPositionConverter>(*detector);
@@ -151,6 +218,45 @@ void DD4hep_service::Initialize() {
     m_app->SetTicker( tickerEnabled );
 }
 
+std::uint64_t DD4hep_service::snapshotKey(const std::vector<std::string> &resolved_filenames) const {
+    // the ROOT version, the names and content of the files, and of the XML files below their directories
+    eicrecon::CacheHash hash;
+    auto add_file = [&hash](const std::filesystem::path& path) {
+        hash.add(std::string_view{path.string()});
+        hash.add_file(path);
+    };
+
+    hash.add(static_cast<std::uint64_t>(ROOT_VERSION_CODE));
+    for (const auto &filename : resolved_filenames) {
+        add_file(filename);
+        std::vector<std::filesystem::path> included;
+        std::error_code ec;
+        const auto directory = std::filesystem::absolute(filename, ec).parent_path();
+        for (std::filesystem::recursive_directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it.depth() >= 3) {
+                // the includes of a detector are next to it, e.g. in compact/, not deep below it
+                it.disable_recursion_pending();
+                continue;
+            }
+            if (it->is_regular_file(ec) && it->path().extension() == ".xml") {
+                included.push_back(it->path());
+            }
+        }
+        std::sort(included.begin(), included.end());
+        for (const auto &path : included) {
+            add_file(path);
+        }
+    }
+    return hash.value() == 0 ? 1 : hash.value();
+}
+
+std::string DD4hep_service::snapshotDirectory() const {
+    if (!m_snapshot_dir.empty()) {
+        return m_snapshot_dir;
+    }
+    return eicrecon::cache_file::default_directory();
+}
+
 std::string DD4hep_service::resolveFileName(const std::string &filename, char *detector_path_env) {
 
     std::string result(filename);
@@ -10,6 +10,7 @@
 #include <JANA/Services/JServiceLocator.h>
 #include <gsl/pointers>
 #include <spdlog/logger.h>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -24,6 +25,9 @@ public:
     virtual gsl::not_null<const dd4hep::Detector*> detector();
     virtual gsl::not_null<const dd4hep::rec::CellIDPositionConverter*> converter();
 
+    /// Hash of the XML files of the geometry, as for the snapshots, for the caches of the products derived from it
+    virtual std::uint64_t compactFingerprint();
+
 protected:
     void Initialize();
 
@@ -36,9 +40,21 @@ private:
     std::unique_ptr<const dd4hep::Detector> m_dd4hepGeo = nullptr;
     std::unique_ptr<const dd4hep::rec::CellIDPositionConverter> m_cellid_converter = nullptr;
     std::vector<std::string> m_xml_files;
+    std::vector<std::string> m_resolved_xml_files;
+    std::once_flag m_fingerprint_flag;
+    std::uint64_t m_compact_fingerprint = 0;
 
     /// Ensures there is a geometry file that should be opened
     std::string resolveFileName(const std::string &filename, char *detector_path_env);
 
+    /// Hash of the content of the XML files and of every XML file in their directories, which they may include
+    std::uint64_t snapshotKey(const std::vector<std::string> &resolved_filenames) const;
+
+    /// Directory of the geometry snapshots, $XDG_CACHE_HOME/eicrecon or ~/.cache/eicrecon by default
+    std::string snapshotDirectory() const;
+
+    bool m_snapshot = false;
+    std::string m_snapshot_dir;
+
     std::shared_ptr<spdlog::logger> m_log;
 };
@@ -7,10 +7,14 @@
 #include <memory>
 
 #include "DD4hep_service.h"
+#include "services/algorithms_init/ParallelInit.h"
 
 extern "C" {
 void InitPlugin(JApplication *app) {
     InitJANAPlugin(app);
     app->ProvideService(std::make_shared<DD4hep_service>(app) );
+    eicrecon::ParallelInit::instance().add("dd4hep", {}, [app]() {
+        app->GetService<DD4hep_service>()->detector();
+    });
 }
 }
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <fcntl.h>
+#include <fmt/core.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <array>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <system_error>
+
+#include "CacheFile.h"
+
+namespace eicrecon {
+
+namespace cache_file {
+
+namespace {
+
+  // "EICGEOC1", the byte order of the file has to match the machine
+  constexpr std::uint64_t file_magic = 0x31434f4547434945ULL;
+  // of the layout of the files, the products have their own versions
+  constexpr std::uint32_t file_format = 1;
+
+  struct FileHeader {
+    std::uint64_t magic;
+    std::uint32_t format;
+    std::uint32_t version;
+    std::uint64_t fingerprint;
+    std::uint64_t key;
+    std::uint64_t bytes;
+    std::uint64_t reserved;
+  };
+  static_assert(sizeof(FileHeader) % 8 == 0);
+
+  std::size_t padded(std::size_t bytes) { return (bytes + 7) & ~std::size_t{7}; }
+
+} // namespace
+
+std::string default_directory() {
+  if (const char* xdg = std::getenv("XDG_CACHE_HOME"); (xdg != nullptr) && (*xdg != '\0')) {
+    return fmt::format("{}/eicrecon", xdg);
+  }
+  if (const char* home = std::getenv("HOME"); (home != nullptr) && (*home != '\0')) {
+    return fmt::format("{}/.cache/eicrecon", home);
+  }
+  return "";
+}
+
+std::optional<CacheBlob> load(const std::filesystem::path& path, std::uint32_t version, std::uint64_t fingerprint,
+                              std::uint64_t key) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+  struct stat st;
+  if ((::fstat(fd, &st) != 0) || (static_cast<std::size_t>(st.st_size) < sizeof(FileHeader))) {
+    ::close(fd);
+    return std::nullopt;
+  }
+  const std::size_t size = st.st_size;
+  void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    return std::nullopt;
+  }
+  std::shared_ptr<const void> mapping(addr, [size](const void* p) { ::munmap(const_cast<void*>(p), size); });
+
+  const auto* header = static_cast<const FileHeader*>(addr);
+  if ((header->magic != file_magic) || (header->format != file_format) || (header->version != version)
+      || (header->fingerprint != fingerprint) || (header->key != key) || (size != sizeof(FileHeader) + header->bytes)) {
+    return std::nullopt;
+  }
+  const auto* data = reinterpret_cast<const std::byte*>(header + 1);
+  return CacheBlob(std::move(mapping), {data, header->bytes});
+}
+
+std::optional<std::uint64_t> stored_key(const std::filesystem::path& path, std::uint32_t version) {
+  std::ifstream in(path, std::ios::binary);
+  FileHeader header;
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!in || (header.magic != file_magic) || (header.format != file_format) || (header.version != version)) {
+    return std::nullopt;
+  }
+  return header.key;
+}
+
+void store(const std::filesystem::path& path, std::uint32_t version, std::uint64_t fingerprint, std::uint64_t key,
+           std::initializer_list<std::span<const std::byte>> chunks) {
+  std::uint64_t bytes = 0;
+  for (const auto& chunk : chunks) {
+    bytes += padded(chunk.size());
+  }
+  write_atomically(path, [&](const std::filesystem::path& tmp_path) {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    const FileHeader header{file_magic, file_format, version, fingerprint, key, bytes, 0};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    constexpr std::array<char, 8> padding{};
+    for (const auto& chunk : chunks) {
+      out.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+      out.write(padding.data(), padded(chunk.size()) - chunk.size());
+    }
+    out.close();
+    if (!out) {
+      throw std::filesystem::filesystem_error("can not write", tmp_path, std::make_error_code(std::errc::io_error));
+    }
+  });
+}
+
+void write_atomically(const std::filesystem::path& path, const std::function<void(const std::filesystem::path&)>& write) {
+  // written next to the target and renamed, so that concurrent jobs never see partial files
+  const auto tmp_path = std::filesystem::path(fmt::format("{}.{}.tmp", path.string(), ::getpid()));
+  try {
+    if (path.has_parent_path()) {
+      std::filesystem::create_directories(path.parent_path());
+    }
+    write(tmp_path);
+    std::filesystem::rename(tmp_path, path);
+  } catch (...) {
+    std::error_code ec;
+    std::filesystem::remove(tmp_path, ec);
+    throw;
+  }
+}
+
+} // namespace cache_file
+
+} // namespace eicrecon
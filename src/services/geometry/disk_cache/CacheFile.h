@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace eicrecon {
+
+/// FNV-1a hash of the inputs of a cached product
+class CacheHash {
+public:
+  void add(std::string_view s) {
+    add_bytes(std::as_bytes(std::span(s.data(), s.size())));
+    // separator, so that consecutive strings do not run together
+    add_byte(0);
+  }
+  void add(std::uint64_t x) {
+    for (int i = 0; i < 8; ++i) {
+      add_byte(static_cast<unsigned char>(x >> (8 * i)));
+    }
+  }
+  void add(double x) { add(std::bit_cast<std::uint64_t>(x)); }
+  /// the raw bytes, without a separator
+  void add_bytes(std::span<const std::byte> bytes) {
+    for (std::byte b : bytes) {
+      add_byte(static_cast<unsigned char>(b));
+    }
+  }
+  /// the content of a file, false if it can not be read
+  bool add_file(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+      return false;
+    }
+    std::vector<char> buffer(1 << 20);
+    while (in.read(buffer.data(), buffer.size()) || (in.gcount() > 0)) {
+      add_bytes(std::as_bytes(std::span(buffer.data(), static_cast<std::size_t>(in.gcount()))));
+    }
+    return in.eof();
+  }
+  std::uint64_t value() const { return m_hash; }
+
+private:
+  void add_byte(unsigned char b) { m_hash = (m_hash ^ b) * 0x100000001b3ULL; }
+  std::uint64_t m_hash{0xcbf29ce484222325ULL};
+};
+
+/**
+ * @brief A cache file, memory mapped read-only
+ *
+ * The views of a product into the data stay valid as long as a copy of the
+ * blob, or of its mapping(), is kept.
+ */
+class CacheBlob {
+public:
+  CacheBlob(std::shared_ptr<const void> mapping, std::span<const std::byte> data)
+    : m_mapping(std::move(mapping)), m_data(data) {}
+
+  std::span<const std::byte> data() const { return m_data; }
+
+  const std::shared_ptr<const void>& mapping() const { return m_mapping; }
+
+  /// count objects of a trivially copyable type at a byte offset of the data, throws std::out_of_range
+  /// beyond its end or for a misaligned offset
+  template <typename T> std::span<const T> array(std::size_t offset, std::size_t count) const {
+    if ((offset % alignof(T) != 0) || (offset > m_data.size()) || (count > (m_data.size() - offset) / sizeof(T))) {
+      throw std::out_of_range("CacheBlob: array beyond the data of the file");
+    }
+    return {reinterpret_cast<const T*>(m_data.data() + offset), count};
+  }
+
+private:
+  std::shared_ptr<const void> m_mapping;
+  std::span<const std::byte> m_data;
+};
+
+/**
+ * The memory mapped cache files, e.g. of the GeometryDiskCacheSvc.
+ *
+ * A file of `store` has a header with the version of its product, the
+ * fingerprint of what the product is derived from (0 if nothing but its
+ * key), its key and its size, and `load` ignores any file that does not
+ * match all of them. The chunks of a file are padded to 8 bytes, so that the
+ * arrays of a product are aligned in the mapping. The byte order of the
+ * files is the one of the machine.
+ *
+ * All files are written to a file of the process and renamed, so that
+ * concurrent jobs never read a partial file.
+ */
+namespace cache_file {
+
+  /// $XDG_CACHE_HOME/eicrecon, or ~/.cache/eicrecon, empty if neither is set
+  std::string default_directory();
+
+  /// The file of a product, std::nullopt if there is none or its header does not match
+  std::optional<CacheBlob> load(const std::filesystem::path& path, std::uint32_t version, std::uint64_t fingerprint,
+                                std::uint64_t key);
+
+  /// The key of a file of `store` with a version of a product, std::nullopt if it is not one
+  std::optional<std::uint64_t> stored_key(const std::filesystem::path& path, std::uint32_t version);
+
+  /// Writes the file of a product from the chunks of its data, throws std::exception if it can not be written
+  void store(const std::filesystem::path& path, std::uint32_t version, std::uint64_t fingerprint, std::uint64_t key,
+             std::initializer_list<std::span<const std::byte>> chunks);
+
+  /// Writes a file of another format with `write`, to a file of the process that is renamed to `path`
+  /// once `write` returns, throws std::exception if either fails
+  void write_atomically(const std::filesystem::path& path, const std::function<void(const std::filesystem::path&)>& write);
+
+} // namespace cache_file
+
+} // namespace eicrecon
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <DD4hep/Detector.h>
+#include <DD4hep/Objects.h>
+#include <algorithms/geo.h>
+#include <fmt/core.h>
+#include <cctype>
+#include <exception>
+
+#include "GeometryDiskCacheSvc.h"
+
+namespace eicrecon {
+
+namespace {
+
+  // of the layout of the directory, the files and the products have their own versions
+  constexpr std::uint32_t directory_format = 1;
+
+} // namespace
+
+void GeometryDiskCacheSvc::init() {
+  // This is needed to bypass condition in algorithms::LoggerMixin::report and
+  // forward all messages to our instance of LogSvc/spdlog.
+  level(algorithms::LogLevel::kTrace);
+}
+
+std::uint64_t GeometryDiskCacheSvc::fingerprint() {
+  std::call_once(m_fingerprint_flag, [this]() {
+    CacheHash hash;
+    hash.add(static_cast<std::uint64_t>(m_compactFingerprint.value()));
+    const dd4hep::Detector* detector = algorithms::GeoSvc::instance().detector();
+    if (detector != nullptr) {
+      // in the order of their names
+      for (const auto& [name, constant] : detector->constants()) {
+        hash.add(std::string_view{name});
+        hash.add(std::string_view{dd4hep::Constant(constant).toString()});
+      }
+    }
+    m_fingerprint = hash.value();
+    debug("Geometry fingerprint {:016x}", m_fingerprint);
+  });
+  return m_fingerprint;
+}
+
+std::string GeometryDiskCacheSvc::cacheDirectory() const {
+  if (!m_useCache.value()) {
+    return "";
+  }
+  if (!m_cacheDir.value().empty()) {
+    return m_cacheDir.value();
+  }
+  return cache_file::default_directory();
+}
+
+std::filesystem::path GeometryDiskCacheSvc::path(std::string_view product, std::uint64_t key) {
+  const std::string cache_dir = cacheDirectory();
+  if (cache_dir.empty()) {
+    return {};
+  }
+  // e.g. readout names, anything else is not in the file name
+  std::string name(product);
+  for (char& c : name) {
+    if ((std::isalnum(static_cast<unsigned char>(c)) == 0) && (c != '_') && (c != '-')) {
+      c = '_';
+    }
+  }
+  return std::filesystem::path(cache_dir) / fmt::format("geometry-v{}", directory_format)
+       / fmt::format("{:016x}", fingerprint()) / fmt::format("{}_{:016x}.bin", name, key);
+}
+
+std::optional<CacheBlob> GeometryDiskCacheSvc::load(std::string_view product, std::uint32_t version, std::uint64_t key) {
+  const auto file_path = path(product, key);
+  if (file_path.empty()) {
+    return std::nullopt;
+  }
+  auto blob = cache_file::load(file_path, version, fingerprint(), key);
+  if (!blob) {
+    debug("No matching file {}", file_path.string());
+    return std::nullopt;
+  }
+  trace("Mapped {} bytes of {} from {}", blob->data().size(), product, file_path.string());
+  return blob;
+}
+
+bool GeometryDiskCacheSvc::store(std::string_view product, std::uint32_t version, std::uint64_t key,
+                                 std::initializer_list<std::span<const std::byte>> chunks) {
+  const auto file_path = path(product, key);
+  if (file_path.empty()) {
+    return false;
+  }
+  try {
+    cache_file::store(file_path, version, fingerprint(), key, chunks);
+  } catch (std::exception& e) {
+    warning("Can not save {} to {}: {}", product, file_path.string(), e.what());
+    return false;
+  }
+  debug("Saved {} to {}", product, file_path.string());
+  return true;
+}
+
+} // namespace eicrecon
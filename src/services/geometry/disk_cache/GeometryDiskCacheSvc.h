@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <algorithms/logger.h>
+#include <algorithms/service.h>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "CacheFile.h"
+
+namespace eicrecon {
+
+/**
+ * @brief Disk cache of the products derived from the geometry
+ *
+ * For the data that are expensive to build but deterministic given the
+ * geometry, e.g. neighbour tables or field grids, built once and memory
+ * mapped by the later jobs:
+ *
+ *     auto& cache = GeometryDiskCacheSvc::instance();
+ *     if (auto blob = cache.load("neighbours_EcalBarrelHits", version, key)) {
+ *       const auto cells = blob->array<std::uint64_t>(0, n);
+ *     } else {
+ *       ... build ...
+ *       cache.store("neighbours_EcalBarrelHits", version, key, {std::as_bytes(std::span(cells))});
+ *     }
+ *
+ * The files are `<cacheDir>/geometry-v<format>/<fingerprint>/<product>_<key>.bin`,
+ * in the format of `cache_file::store`,
+ * where the fingerprint is a hash of the compact XML files of the geometry
+ * (with their includes) and of all its constants, so that every product is
+ * built again for another geometry. The key and the version are the ones of
+ * the product, for its own inputs and its layout. A file is used if its
+ * header matches all of them and its size, anything else is built again.
+ *
+ * A file that can not be written is only a warning.
+ */
+class GeometryDiskCacheSvc : public algorithms::LoggedService<GeometryDiskCacheSvc> {
+public:
+  void init();
+
+  /// Hash of the compact XML files and of the constants of the geometry, computed on first use
+  std::uint64_t fingerprint();
+
+  /// Path of the file of a product, empty if the cache is disabled
+  std::filesystem::path path(std::string_view product, std::uint64_t key);
+
+  /// The file of a product, std::nullopt if there is none that matches
+  std::optional<CacheBlob> load(std::string_view product, std::uint32_t version, std::uint64_t key);
+
+  /// Writes the file of a product from the chunks of its data, false if it is not written
+  bool store(std::string_view product, std::uint32_t version, std::uint64_t key,
+             std::initializer_list<std::span<const std::byte>> chunks);
+
+  /// $XDG_CACHE_HOME/eicrecon or ~/.cache/eicrecon unless cacheDir is set, empty if the cache is disabled
+  std::string cacheDirectory() const;
+
+private:
+  Property<std::string> m_cacheDir{this, "cacheDir", "",
+                                   "Directory of the geometry cache, $XDG_CACHE_HOME/eicrecon or ~/.cache/eicrecon if empty"};
+  Property<bool> m_useCache{this, "useCache", true, "Load and save the products derived from the geometry"};
+  Property<std::size_t> m_compactFingerprint{this, "compactFingerprint", 0,
+                                             "Hash of the compact XML files of the geometry, set from the DD4hep_service"};
+
+  std::once_flag m_fingerprint_flag;
+  std::uint64_t m_fingerprint{0};
+
+  ALGORITHMS_DEFINE_LOGGED_SERVICE(GeometryDiskCacheSvc);
+};
+
+} // namespace eicrecon
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <JANA/JApplication.h>
+#include <JANA/JException.h>
+#include <algorithms/service.h>
+#include <cstddef>
+#include <string>
+
+#include "GeometryDiskCacheSvc.h"
+#include "services/geometry/dd4hep/DD4hep_service.h"
+
+extern "C" {
+
+void InitPlugin(JApplication* app) {
+  InitJANAPlugin(app);
+
+  std::string cache_dir;
+  bool use_cache = true;
+  app->SetDefaultParameter("geometry_cache:dir", cache_dir,
+                           "Directory of the products derived from the geometry, $XDG_CACHE_HOME/eicrecon or ~/.cache/eicrecon if empty");
+  app->SetDefaultParameter("geometry_cache:enable", use_cache, "Load and save the products derived from the geometry");
+
+  auto& serviceSvc = algorithms::ServiceSvc::instance();
+  auto& cacheSvc = eicrecon::GeometryDiskCacheSvc::instance();
+  serviceSvc.add<eicrecon::GeometryDiskCacheSvc>(&cacheSvc);
+  serviceSvc.setInit<eicrecon::GeometryDiskCacheSvc>([=](auto&& cache) {
+    cache.setProperty("cacheDir", cache_dir);
+    cache.setProperty("useCache", use_cache);
+    // the compact XML files of the geometry, without it only its constants are in the fingerprint
+    try {
+      cache.setProperty("compactFingerprint", static_cast<std::size_t>(app->GetService<DD4hep_service>()->compactFingerprint()));
+    } catch (const JException&) {
+    }
+    cache.init();
+  });
+}
+}
@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <DD4hep/Detector.h>
+#include <DD4hep/IDDescriptor.h>
+#include <DD4hep/Objects.h>
+#include <DD4hep/Readout.h>
+#include <DD4hep/VolumeManager.h>
+#include <DD4hep/Volumes.h>
+#include <DD4hep/detail/VolumeManagerInterna.h>
+#include <DDSegmentation/SegmentationParameter.h>
+#include <TGeoBBox.h>
+#include <TGeoMatrix.h>
+#include <algorithms/geo.h>
+#include <fmt/core.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <exception>
+#include <set>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include "ReadoutNeighbourTableSvc.h"
+#include "services/geometry/disk_cache/GeometryDiskCacheSvc.h"
+
+namespace eicrecon {
+
+namespace {
+
+  // of the layout of the table in the geometry cache
+  constexpr std::uint32_t table_version = 2;
+
+  struct SensitiveVolume {
+    std::uint64_t id;
+    const dd4hep::VolumeManagerContext* context;
+  };
+
+  void collect_volumes(const dd4hep::VolumeManager& manager, const std::string& readout,
+                       std::vector<SensitiveVolume>& volumes) {
+    for (const auto& [id, context] : manager.ptr()->volumes) {
+      auto sd = context->volumePlacement().volume().sensitiveDetector();
+      if (sd.isValid() && sd.readout().isValid() && (sd.readout().name() == readout)) {
+        volumes.push_back({id, context});
+      }
+    }
+    for (const auto& [det, sub_manager] : manager.ptr()->subdetectors) {
+      collect_volumes(sub_manager, readout, volumes);
+    }
+  }
+
+  // the numbers of cells and of neighbours, then the cells, the offsets and the neighbours
+  std::unique_ptr<ReadoutNeighbourTable> load(const CacheBlob& blob, const dd4hep::Segmentation& segmentation) {
+    if (blob.data().size() < 2 * sizeof(std::uint64_t)) {
+      return nullptr;
+    }
+    const auto sizes = blob.array<std::uint64_t>(0, 2);
+    const std::uint64_t n_cells = sizes[0];
+    const std::uint64_t n_neighbours = sizes[1];
+    if (blob.data().size() != sizeof(std::uint64_t) * (2 + 2 * n_cells + 1 + n_neighbours)) {
+      return nullptr;
+    }
+    const auto data = blob.array<std::uint64_t>(0, blob.data().size() / sizeof(std::uint64_t)).subspan(2);
+    const auto cells = data.subspan(0, n_cells);
+    const auto offsets = data.subspan(n_cells, n_cells + 1);
+    const auto neighbours = data.subspan(2 * n_cells + 1, n_neighbours);
+    if ((offsets.front() != 0) || (offsets.back() != n_neighbours)) {
+      return nullptr;
+    }
+    return std::make_unique<ReadoutNeighbourTable>(segmentation, blob.mapping(), cells, offsets, neighbours);
+  }
+
+  void save(GeometryDiskCacheSvc& cache, const std::string& product, std::uint64_t hash, const ReadoutNeighbourTable& table) {
+    const std::array<std::uint64_t, 2> sizes{table.cells().size(), table.neighbourList().size()};
+    cache.store(product, table_version, hash,
+                       {std::as_bytes(std::span(sizes)), std::as_bytes(table.cells()), std::as_bytes(table.offsets()),
+                        std::as_bytes(table.neighbourList())});
+  }
+
+} // namespace
+
+ReadoutNeighbourTable::ReadoutNeighbourTable(dd4hep::Segmentation segmentation, std::vector<std::uint64_t> cells,
+                                             std::vector<std::uint64_t> offsets,
+                                             std::vector<std::uint64_t> neighbours)
+  : m_segmentation(segmentation)
+  , m_owned_cells(std::move(cells))
+  , m_owned_offsets(std::move(offsets))
+  , m_owned_neighbours(std::move(neighbours))
+  , m_cells(m_owned_cells)
+  , m_offsets(m_owned_offsets)
+  , m_neighbours(m_owned_neighbours) {}
+
+ReadoutNeighbourTable::ReadoutNeighbourTable(dd4hep::Segmentation segmentation, std::shared_ptr<const void> mapping,
+                                             std::span<const std::uint64_t> cells,
+                                             std::span<const std::uint64_t> offsets,
+                                             std::span<const std::uint64_t> neighbours)
+  : m_segmentation(segmentation)
+  , m_mapping(std::move(mapping))
+  , m_cells(cells)
+  , m_offsets(offsets)
+  , m_neighbours(neighbours) {}
+
+std::span<const std::uint64_t> ReadoutNeighbourTable::neighbours(std::uint64_t cellID) const {
+  if (auto it = std::lower_bound(m_cells.begin(), m_cells.end(), cellID); (it != m_cells.end()) && (*it == cellID)) {
+    const std::size_t i = it - m_cells.begin();
+    return m_neighbours.subspan(m_offsets[i], m_offsets[i + 1] - m_offsets[i]);
+  }
+  {
+    std::shared_lock<std::shared_mutex> lock(m_overlay_mutex);
+    if (auto it = m_overlay.find(cellID); it != m_overlay.end()) {
+      return it->second;
+    }
+  }
+  auto cell_neighbours = compute(m_segmentation, cellID);
+  std::unique_lock<std::shared_mutex> lock(m_overlay_mutex);
+  return m_overlay.try_emplace(cellID, std::move(cell_neighbours)).first->second;
+}
+
+bool ReadoutNeighbourTable::adjacent(std::uint64_t cellID1, std::uint64_t cellID2) const {
+  const auto cell_neighbours = neighbours(cellID1);
+  return std::binary_search(cell_neighbours.begin(), cell_neighbours.end(), cellID2);
+}
+
+std::vector<std::uint64_t> ReadoutNeighbourTable::compute(const dd4hep::Segmentation& segmentation,
+                                                          std::uint64_t cellID) {
+  std::set<dd4hep::CellID> cell_neighbours;
+  segmentation.neighbours(cellID, cell_neighbours);
+  return {cell_neighbours.begin(), cell_neighbours.end()};
+}
+
+void ReadoutNeighbourTableSvc::addVolumeKey(CacheHash& hash, std::uint64_t volumeID, const dd4hep::Solid& solid,
+                                            const TGeoMatrix& to_world) {
+  hash.add(volumeID);
+  if (solid.isValid()) {
+    hash.add(std::string_view{solid.type()});
+    for (double x : solid.dimensions()) {
+      hash.add(x);
+    }
+    // the origin of a box is not among its dimensions
+    if (const auto* box = dynamic_cast<const TGeoBBox*>(solid.ptr()); box != nullptr) {
+      for (std::size_t d = 0; d < 3; ++d) {
+        hash.add(box->GetOrigin()[d]);
+      }
+    }
+  }
+  const double* translation = to_world.GetTranslation();
+  for (std::size_t d = 0; d < 3; ++d) {
+    hash.add(translation[d]);
+  }
+  const double* rotation = to_world.GetRotationMatrix();
+  for (std::size_t d = 0; d < 9; ++d) {
+    hash.add(rotation[d]);
+  }
+}
+
+void ReadoutNeighbourTableSvc::init() {
+  // This is needed to bypass condition in algorithms::LoggerMixin::report and
+  // forward all messages to our instance of LogSvc/spdlog.
+  level(algorithms::LogLevel::kTrace);
+}
+
+const ReadoutNeighbourTable& ReadoutNeighbourTableSvc::table(const std::string& readout) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto& table = m_tables[readout];
+  if (!table) {
+    table = build(readout);
+  }
+  return *table;
+}
+
+std::unique_ptr<ReadoutNeighbourTable> ReadoutNeighbourTableSvc::build(const std::string& readout) {
+  const dd4hep::Detector* detector = algorithms::GeoSvc::instance().detector();
+  const dd4hep::Readout dd4hep_readout = detector->readout(readout);
+  const dd4hep::Segmentation segmentation = dd4hep_readout.segmentation();
+
+  std::vector<SensitiveVolume> volumes;
+  collect_volumes(detector->volumeManager(), readout, volumes);
+  std::sort(volumes.begin(), volumes.end(), [](const auto& a, const auto& b) { return a.id < b.id; });
+  volumes.erase(std::unique(volumes.begin(), volumes.end(), [](const auto& a, const auto& b) { return a.id == b.id; }),
+                volumes.end());
+
+  // everything the table depends on
+  CacheHash hash;
+  hash.add(std::string_view{readout});
+  hash.add(std::string_view{dd4hep_readout.idSpec().fieldDescription()});
+  hash.add(std::string_view{segmentation.type()});
+  for (const auto* parameter : segmentation.parameters()) {
+    hash.add(std::string_view{parameter->name()});
+    hash.add(std::string_view{parameter->value()});
+  }
+  for (const auto& volume : volumes) {
+    // volume to DetElement to world, as in CellIDPositionConverter
+    TGeoHMatrix to_world = volume.context->element.nominal().worldTransformation();
+    to_world.Multiply(&volume.context->toElement());
+    addVolumeKey(hash, volume.id, volume.context->volumePlacement().volume().solid(), to_world);
+  }
+
+  auto& cache = GeometryDiskCacheSvc::instance();
+  const std::string product = fmt::format("neighbours_{}", readout);
+  if (m_useCache.value()) {
+    if (auto blob = cache.load(product, table_version, hash.value())) {
+      if (auto table = load(*blob, segmentation)) {
+        info("Loaded neighbour table of {} with {} cells from {}", readout, table->size(), cache.path(product, hash.value()).string());
+        return table;
+      }
+    }
+  }
+
+  // enumerate the cells by sampling every volume at half the cell pitch
+  std::vector<std::uint64_t> cells;
+  for (const auto& volume : volumes) {
+    const auto* box = dynamic_cast<const TGeoBBox*>(volume.context->volumePlacement().volume().solid().ptr());
+    if (box == nullptr) {
+      continue;
+    }
+    const std::array<double, 3> origin{box->GetOrigin()[0], box->GetOrigin()[1], box->GetOrigin()[2]};
+    const std::array<double, 3> half{box->GetDX(), box->GetDY(), box->GetDZ()};
+    auto cell_at = [&](const std::array<double, 3>& local) {
+      const dd4hep::Position local_position(local[0], local[1], local[2]);
+      // volume to DetElement to world, as in CellIDPositionConverter
+      double element[3], global[3];
+      volume.context->toElement().LocalToMaster(local.data(), element);
+      volume.context->element.nominal().worldTransformation().LocalToMaster(element, global);
+      return segmentation.cellID(local_position, dd4hep::Position(global[0], global[1], global[2]), volume.id);
+    };
+
+    std::vector<double> pitch;
+    try {
+      pitch = segmentation.cellDimensions(cell_at(origin));
+    } catch (std::exception& e) {
+      // no cell dimensions, a single sample is all we can do
+      debug("No cell dimensions for volume {:#x}: {}", volume.id, e.what());
+    }
+    std::array<std::size_t, 3> n_samples{1, 1, 1};
+    std::array<double, 3> step{0., 0., 0.};
+    for (std::size_t d = 0; d < 3; ++d) {
+      if ((d < pitch.size()) && (pitch[d] > 0.)) {
+        step[d] = 0.5 * pitch[d];
+        n_samples[d] = static_cast<std::size_t>(std::ceil(2 * half[d] / step[d])) + 1;
+      }
+    }
+    const std::size_t total_samples = n_samples[0] * n_samples[1] * n_samples[2];
+    if (total_samples > m_maxSamplesPerVolume.value()) {
+      warning("Volume {:#x} of {} needs {} samples, its cells are computed on demand", volume.id, readout, total_samples);
+      continue;
+    }
+    for (std::size_t ix = 0; ix < n_samples[0]; ++ix) {
+      for (std::size_t iy = 0; iy < n_samples[1]; ++iy) {
+        for (std::size_t iz = 0; iz < n_samples[2]; ++iz) {
+          const std::array<std::size_t, 3> i{ix, iy, iz};
+          std::array<double, 3> local = origin;
+          for (std::size_t d = 0; d < 3; ++d) {
+            if (n_samples[d] > 1) {
+              local[d] = std::min(origin[d] - half[d] + i[d] * step[d], origin[d] + half[d]);
+            }
+          }
+          cells.push_back(cell_at(local));
+        }
+      }
+    }
+  }
+  std::sort(cells.begin(), cells.end());
+  cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+  std::vector<std::uint64_t> offsets{0};
+  std::vector<std::uint64_t> neighbours;
+  offsets.reserve(cells.size() + 1);
+  for (auto cell : cells) {
+    try {
+      const auto cell_neighbours = ReadoutNeighbourTable::compute(segmentation, cell);
+      neighbours.insert(neighbours.end(), cell_neighbours.begin(), cell_neighbours.end());
+    } catch (std::exception& e) {
+      error("Segmentation {} of {} can not find neighbours: {}", segmentation.type(), readout, e.what());
+      throw;
+    }
+    offsets.push_back(neighbours.size());
+  }
+  auto table = std::make_unique<ReadoutNeighbourTable>(segmentation, std::move(cells), std::move(offsets), std::move(neighbours));
+  info("Built neighbour table of {} with {} cells in {} volumes", readout, table->size(), volumes.size());
+
+  if (m_useCache.value()) {
+    save(cache, product, hash.value(), *table);
+  }
+  return table;
+}
+
+} // namespace eicrecon
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <DD4hep/Segmentations.h>
+#include <DD4hep/Shapes.h>
+#include <TGeoMatrix.h>
+#include <algorithms/logger.h>
+#include <algorithms/service.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "services/geometry/disk_cache/GeometryDiskCacheSvc.h"
+
+namespace eicrecon {
+
+/**
+ * @brief Neighbour cellIDs of every cell of a readout
+ *
+ * Stored as compressed sparse rows: the cells are sorted and the sorted
+ * neighbours of `cells[i]` are `neighbours[offsets[i]:offsets[i + 1]]`. The
+ * arrays are either owned by the table or point into a memory mapped cache
+ * file.
+ *
+ * Cells that were not found when the table was built are computed from the
+ * segmentation on first use and kept in a (locked) overlay, so that the
+ * table gives the same answers as `dd4hep::Segmentation::neighbours` for
+ * any cell.
+ */
+class ReadoutNeighbourTable {
+public:
+  ReadoutNeighbourTable(dd4hep::Segmentation segmentation, std::vector<std::uint64_t> cells,
+                        std::vector<std::uint64_t> offsets, std::vector<std::uint64_t> neighbours);
+  ReadoutNeighbourTable(dd4hep::Segmentation segmentation, std::shared_ptr<const void> mapping,
+                        std::span<const std::uint64_t> cells, std::span<const std::uint64_t> offsets,
+                        std::span<const std::uint64_t> neighbours);
+
+  /// Sorted neighbours of a cell
+  std::span<const std::uint64_t> neighbours(std::uint64_t cellID) const;
+
+  bool adjacent(std::uint64_t cellID1, std::uint64_t cellID2) const;
+
+  /// Number of cells in the precomputed table
+  std::size_t size() const { return m_cells.size(); }
+
+  std::span<const std::uint64_t> cells() const { return m_cells; }
+  std::span<const std::uint64_t> offsets() const { return m_offsets; }
+  std::span<const std::uint64_t> neighbourList() const { return m_neighbours; }
+
+  /// Neighbours of a cell from the segmentation, sorted
+  static std::vector<std::uint64_t> compute(const dd4hep::Segmentation& segmentation, std::uint64_t cellID);
+
+private:
+  dd4hep::Segmentation m_segmentation;
+
+  std::vector<std::uint64_t> m_owned_cells;
+  std::vector<std::uint64_t> m_owned_offsets;
+  std::vector<std::uint64_t> m_owned_neighbours;
+  std::shared_ptr<const void> m_mapping;
+
+  std::span<const std::uint64_t> m_cells;
+  std::span<const std::uint64_t> m_offsets;
+  std::span<const std::uint64_t> m_neighbours;
+
+  // cells missing from the table, the vectors are stable in the node based map
+  mutable std::shared_mutex m_overlay_mutex;
+  mutable std::unordered_map<std::uint64_t, std::vector<std::uint64_t>> m_overlay;
+};
+
+/**
+ * @brief Service of precomputed readout neighbour tables
+ *
+ * The table of a readout is built on first request (usually from the init()
+ * of an algorithm): the cells are enumerated by sampling the sensitive
+ * volumes of the readout at half the cell pitch, and their neighbours are
+ * taken from the segmentation. Tables are saved to the GeometryDiskCacheSvc,
+ * keyed by a hash of the readout, the segmentation parameters and, for
+ * every sensitive volume, its volume ID, its solid and its placement in the
+ * world, and memory mapped on later runs.
+ */
+class ReadoutNeighbourTableSvc : public algorithms::LoggedService<ReadoutNeighbourTableSvc> {
+public:
+  void init();
+
+  /// Table of a readout, the reference stays valid for the lifetime of the service
+  const ReadoutNeighbourTable& table(const std::string& readout);
+
+  /// Adds a sensitive volume to the key of a table: the cells found by sampling it depend on its shape
+  /// and, for segmentations in global coordinates, on where it is placed
+  static void addVolumeKey(CacheHash& hash, std::uint64_t volumeID, const dd4hep::Solid& solid,
+                           const TGeoMatrix& to_world);
+
+private:
+  std::unique_ptr<ReadoutNeighbourTable> build(const std::string& readout);
+
+  Property<bool> m_useCache{this, "useCache", true, "Load and save tables in the geometry cache"};
+  Property<std::size_t> m_maxSamplesPerVolume{this, "maxSamplesPerVolume", 10000000,
+                                              "Volumes that need more samples are left to the on-demand computation"};
+
+  std::mutex m_mutex;
+  std::map<std::string, std::unique_ptr<ReadoutNeighbourTable>> m_tables;
+
+  ALGORITHMS_DEFINE_LOGGED_SERVICE(ReadoutNeighbourTableSvc);
+};
+
+} // namespace eicrecon
@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <JANA/JApplication.h>
+#include <algorithms/service.h>
+
+#include "ReadoutNeighbourTableSvc.h"
+
+extern "C" {
+
+void InitPlugin(JApplication* app) {
+  InitJANAPlugin(app);
+
+  auto& serviceSvc = algorithms::ServiceSvc::instance();
+  auto& tableSvc = eicrecon::ReadoutNeighbourTableSvc::instance();
+  serviceSvc.add<eicrecon::ReadoutNeighbourTableSvc>(&tableSvc);
+}
+}
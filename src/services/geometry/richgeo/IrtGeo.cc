@@ -3,21 +3,30 @@
 
 #include "IrtGeo.h"
 
+#include <DD4hep/Alignments.h>
 #include <DD4hep/Volumes.h>
 #include <Evaluator/DD4hepUnits.h>
 #include <IRT/CherenkovRadiator.h>
 #include <Math/GenVector/DisplacementVector3D.h>
 #include <TGDMLMatrix.h>
+#include <TGeoMatrix.h>
+#include <TNamed.h>
 #include <TString.h>
 #include <TVector3.h>
 #include <fmt/core.h>
 #include <stdint.h>
 #include <cmath>
+#include <exception>
+#include <filesystem>
 #include <functional>
 #include <map>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "services/geometry/disk_cache/CacheFile.h"
 #include "services/geometry/richgeo/RichGeo.h"
 
 // constructor: creates IRT-DD4hep bindings using main `Detector` handle `*det_`
@@ -40,6 +49,118 @@ void richgeo::IrtGeo::Bind() {
 }
 // ------------------------------------------------
 
+// Build() ----------------------------------------
+// read the IRT geometry from the cache, or produce it from DD4hep and cache it
+void richgeo::IrtGeo::Build(const std::string& cache_dir) {
+  const auto hash = CacheHash();
+  const std::string path = cache_dir.empty() ? "" : fmt::format("{}/rich_irt_{}_{:016x}.root", cache_dir, m_detName, hash);
+  if(!path.empty() && ReadCache(path, hash)) {
+    m_log->debug("Read IRT geometry of {} from {}", m_detName, path);
+    // the refractive indices are not geometry, and the converter is not stored
+    SetRefractiveIndexTable();
+    SetReadoutIDToPositionLambda();
+    return;
+  }
+  DD4hep_to_IRT();
+  // a geometry that can not be written is not an error, it is produced again next time
+  if(!path.empty() && WriteCache(path, hash))
+    m_log->debug("Wrote IRT geometry of {} to {}", m_detName, path);
+}
+// ------------------------------------------------
+
+// everything the IRT geometry depends on: the constants of the detector and its placements
+std::uint64_t richgeo::IrtGeo::CacheHash() const {
+  eicrecon::CacheHash hash;
+  hash.add(std::string_view{"IRT geometry v1"});
+  hash.add(std::string_view{m_detName});
+  const std::string prefix = m_detName + "_";
+  for(const auto& [name, constant] : m_det->constants()) {
+    if(name.rfind(prefix, 0) != 0)
+      continue;
+    hash.add(std::string_view{name});
+    hash.add(std::string_view{m_det->constantAsString(name)});
+  }
+  std::function<void(const dd4hep::DetElement&)> add_element = [&] (const dd4hep::DetElement& elem) {
+    hash.add(std::string_view{elem.path()});
+    hash.add(static_cast<std::uint64_t>(elem.id()));
+    const auto& transform = elem.nominal().worldTransformation();
+    for(int i=0; i<3; i++)
+      hash.add(transform.GetTranslation()[i]);
+    for(int i=0; i<9; i++)
+      hash.add(transform.GetRotationMatrix()[i]);
+    for(const auto& [child_name, child] : elem.children())
+      add_element(child);
+  };
+  add_element(m_detRich);
+  return hash.value();
+}
+
+bool richgeo::IrtGeo::ReadCache(const std::string& path, std::uint64_t hash) {
+  if(!std::filesystem::exists(path))
+    return false;
+  std::unique_ptr<TFile> file{TFile::Open(path.c_str(), "READ")};
+  if(!file || file->IsZombie())
+    return false;
+  const auto *stored_hash = file->Get<TNamed>("hash");
+  if(stored_hash == nullptr || std::string_view{stored_hash->GetTitle()} != fmt::format("{:016x}", hash))
+    return false;
+  std::unique_ptr<CherenkovDetectorCollection> collection{file->Get<CherenkovDetectorCollection>("CherenkovDetectorCollection")};
+  std::unique_ptr<std::vector<double>> sensors{file->Get<std::vector<double>>("sensors")};
+  if(!collection || !sensors || sensors->size() % 8 != 0)
+    return false;
+  auto detector_it = collection->GetDetectors().find(m_detName.c_str());
+  if(detector_it == collection->GetDetectors().end())
+    return false;
+
+  // replace the empty geometry of `Bind()`
+  delete m_irtDetector;
+  delete m_irtDetectorCollection;
+  m_irtDetector           = detector_it->second;
+  m_irtDetectorCollection = collection.release();
+  m_sensor_info.clear();
+  for(std::size_t i=0; i<sensors->size(); i+=8) {
+    const auto *v = sensors->data() + i;
+    richgeo::Sensor sensor_info;
+    sensor_info.size             = v[1];
+    sensor_info.surface_centroid = dd4hep::Position(v[2], v[3], v[4]);
+    sensor_info.surface_offset   = dd4hep::Direction(v[5], v[6], v[7]);
+    m_sensor_info.insert({ static_cast<int>(v[0]), sensor_info });
+  }
+  m_cacheFile = std::move(file);
+  return true;
+}
+
+bool richgeo::IrtGeo::WriteCache(const std::string& path, std::uint64_t hash) const {
+  try {
+    eicrecon::cache_file::write_atomically(path, [this, hash] (const std::filesystem::path& tmp_path) {
+      std::unique_ptr<TFile> file{TFile::Open(tmp_path.c_str(), "RECREATE")};
+      if(!file || file->IsZombie())
+        throw std::runtime_error(fmt::format("can not open {}", tmp_path.string()));
+      std::vector<double> sensors;
+      sensors.reserve(8 * m_sensor_info.size());
+      for(const auto& [id, sensor] : m_sensor_info) {
+        sensors.insert(sensors.end(), {
+            static_cast<double>(id), sensor.size,
+            sensor.surface_centroid.x(), sensor.surface_centroid.y(), sensor.surface_centroid.z(),
+            sensor.surface_offset.x(),   sensor.surface_offset.y(),   sensor.surface_offset.z()
+            });
+      }
+      TNamed stored_hash("hash", fmt::format("{:016x}", hash).c_str());
+      const bool written =
+        file->WriteObject(m_irtDetectorCollection, "CherenkovDetectorCollection") > 0 &&
+        file->WriteObject(&sensors, "sensors") > 0 &&
+        file->WriteTObject(&stored_hash) > 0;
+      file->Close();
+      if(!written)
+        throw std::runtime_error(fmt::format("can not write {}", tmp_path.string()));
+    });
+  } catch(const std::exception&) {
+    return false;
+  }
+  return true;
+}
+// ------------------------------------------------
+
 // define the `cell ID -> pixel position` converter, correcting to sensor surface
 void richgeo::IrtGeo::SetReadoutIDToPositionLambda() {
 
@@ -48,11 +169,13 @@ void richgeo::IrtGeo::SetReadoutIDToPositionLambda() {
     // capture instance members by value, so those owned by `this` are not mutable here
     cell_mask   = this->m_irtDetector->GetReadoutCellMask(),
     converter   = this->m_converter,
-    sensor_info = this->m_sensor_info
+    sensor_info = this->m_sensor_info,
+    pixels      = this->m_pixels
   ] (auto cell_id) {
     // decode cell ID to get the sensor ID and pixel volume centroid
     auto sensor_id = cell_id & cell_mask;
-    auto pixel_volume_centroid = (1/dd4hep::mm) * converter->position(cell_id);
+    auto index     = pixels ? pixels->Index(cell_id) : std::nullopt;
+    auto pixel_volume_centroid = (1/dd4hep::mm) * (index ? pixels->Position(*index) : converter->position(cell_id));
     // get sensor info
     auto sensor_info_it = sensor_info.find(sensor_id);
     if(sensor_info_it == sensor_info.end()) {
@@ -72,12 +195,20 @@ void richgeo::IrtGeo::SetReadoutIDToPositionLambda() {
 }
 // ------------------------------------------------
 
+// use precomputed pixel positions, and redefine the converter to capture them
+void richgeo::IrtGeo::SetPixelTable(std::shared_ptr<const PixelTable> pixels) {
+  m_pixels = std::move(pixels);
+  SetReadoutIDToPositionLambda();
+}
+// ------------------------------------------------
+
 // fill table of refractive indices
 void richgeo::IrtGeo::SetRefractiveIndexTable() {
   m_log->debug("{:-^60}"," Refractive Index Tables ");
   for(auto rad_obj : m_irtDetector->Radiators()) {
     m_log->debug("{}:", rad_obj.first.Data());
     auto *const rad = rad_obj.second;
+    rad->m_ri_lookup_table.clear();
     const auto *rindex_matrix = m_det->material(rad->GetAlternativeMaterialName()).property("RINDEX");
     for(unsigned row=0; row<rindex_matrix->GetRows(); row++) {
       auto energy = rindex_matrix->Get(row,0) / dd4hep::eV;
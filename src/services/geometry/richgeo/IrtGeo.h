@@ -13,13 +13,16 @@
 #include <IRT/CherenkovDetectorCollection.h>
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/DisplacementVector3D.h>
+#include <TFile.h>
 #include <spdlog/logger.h>
+#include <cstdint>
 #include <gsl/pointers>
 #include <memory>
 #include <string>
 #include <unordered_map>
 
 // local
+#include "PixelTable.h"
 #include "RichGeo.h"
 
 namespace richgeo {
@@ -30,13 +33,21 @@ namespace richgeo {
       IrtGeo(std::string detName_, gsl::not_null<const dd4hep::Detector*> det_, gsl::not_null<const dd4hep::rec::CellIDPositionConverter*> conv_, std::shared_ptr<spdlog::logger> log_);
       virtual ~IrtGeo();
 
-      // access the full IRT geometry
+      // access the full IRT geometry; it is shared by all the users of this `IrtGeo`,
+      // so they must not change it after their initialization
       CherenkovDetectorCollection *GetIrtDetectorCollection() { return m_irtDetectorCollection; }
 
+      // true if the IRT geometry was read from the cache instead of built from DD4hep
+      bool FromCache() const { return m_cacheFile != nullptr; }
+
+      // use precomputed pixel positions in the `cell ID -> pixel position` converter, where available
+      void SetPixelTable(std::shared_ptr<const PixelTable> pixels);
+
     protected:
 
       // protected methods
       virtual void DD4hep_to_IRT() = 0;    // given DD4hep geometry, produce IRT geometry
+      void Build(const std::string& cache_dir); // read the IRT geometry from `cache_dir`, or produce and write it there (no caching if empty)
       void SetReadoutIDToPositionLambda(); // define the `cell ID -> pixel position` converter, correcting to sensor surface
       void SetRefractiveIndexTable();      // fill table of refractive indices
       // read `VariantParameters` for a vector
@@ -56,6 +67,7 @@ namespace richgeo {
       // cell ID conversion
       gsl::not_null<const dd4hep::rec::CellIDPositionConverter*> m_converter;
       std::unordered_map<int,richgeo::Sensor> m_sensor_info; // sensor ID -> sensor info
+      std::shared_ptr<const PixelTable>       m_pixels;      // precomputed pixels, may be null
 
       // IRT geometry handles
       CherenkovDetectorCollection *m_irtDetectorCollection;
@@ -68,5 +80,11 @@ namespace richgeo {
 
       // set all geometry handles
       void Bind();
+
+      // cache file of the IRT geometry and of `m_sensor_info`, keyed by a hash of the DD4hep geometry
+      std::uint64_t CacheHash() const;
+      bool ReadCache(const std::string& path, std::uint64_t hash);
+      bool WriteCache(const std::string& path, std::uint64_t hash) const;
+      std::unique_ptr<TFile> m_cacheFile; // kept open for the `TRef`s of the geometry read from it
   };
 }
@@ -13,6 +13,7 @@
 #include <spdlog/logger.h>
 #include <gsl/pointers>
 #include <memory>
+#include <string>
 
 #include "IrtGeo.h"
 #include "services/geometry/richgeo/RichGeo.h"
@@ -21,22 +22,23 @@ namespace richgeo {
   class IrtGeoDRICH : public IrtGeo {
 
     public:
-      IrtGeoDRICH(gsl::not_null<const dd4hep::Detector*> det_, gsl::not_null<const dd4hep::rec::CellIDPositionConverter*> conv_, std::shared_ptr<spdlog::logger> log_) :
-        IrtGeo("DRICH",det_,conv_,log_) { DD4hep_to_IRT(); }
+      IrtGeoDRICH(gsl::not_null<const dd4hep::Detector*> det_, gsl::not_null<const dd4hep::rec::CellIDPositionConverter*> conv_, std::shared_ptr<spdlog::logger> log_, const std::string& cache_dir = "") :
+        IrtGeo("DRICH",det_,conv_,log_) { Build(cache_dir); }
       ~IrtGeoDRICH();
     TVector3 GetSensorSurfaceNorm(CellIDType);
     protected:
       void DD4hep_to_IRT() override;
 
     private:
-      // FIXME: should be smart pointers, but IRT methods sometimes assume ownership of such raw pointers
-      FlatSurface*             m_surfEntrance;
-      CherenkovPhotonDetector* m_irtPhotonDetector;
-      FlatSurface*             m_aerogelFlatSurface;
-      FlatSurface*             m_filterFlatSurface;
-      SphericalSurface*        m_mirrorSphericalSurface;
-      OpticalBoundary*         m_mirrorOpticalBoundary;
-      FlatSurface*             m_sensorFlatSurface;
+      // FIXME: should be smart pointers, but IRT methods sometimes assume ownership of such raw pointers;
+      // all null if the geometry was read from the cache
+      FlatSurface*             m_surfEntrance = nullptr;
+      CherenkovPhotonDetector* m_irtPhotonDetector = nullptr;
+      FlatSurface*             m_aerogelFlatSurface = nullptr;
+      FlatSurface*             m_filterFlatSurface = nullptr;
+      SphericalSurface*        m_mirrorSphericalSurface = nullptr;
+      OpticalBoundary*         m_mirrorOpticalBoundary = nullptr;
+      FlatSurface*             m_sensorFlatSurface = nullptr;
 
   };
 }
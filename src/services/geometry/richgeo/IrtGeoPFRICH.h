@@ -11,6 +11,7 @@
 #include <spdlog/logger.h>
 #include <gsl/pointers>
 #include <memory>
+#include <string>
 
 #include "IrtGeo.h"
 
@@ -18,19 +19,20 @@ namespace richgeo {
   class IrtGeoPFRICH : public IrtGeo {
 
     public:
-      IrtGeoPFRICH(gsl::not_null<const dd4hep::Detector*> det_, gsl::not_null<const dd4hep::rec::CellIDPositionConverter*> conv_, std::shared_ptr<spdlog::logger> log_) :
-        IrtGeo("PFRICH",det_,conv_,log_) { DD4hep_to_IRT(); }
+      IrtGeoPFRICH(gsl::not_null<const dd4hep::Detector*> det_, gsl::not_null<const dd4hep::rec::CellIDPositionConverter*> conv_, std::shared_ptr<spdlog::logger> log_, const std::string& cache_dir = "") :
+        IrtGeo("PFRICH",det_,conv_,log_) { Build(cache_dir); }
       ~IrtGeoPFRICH();
 
     protected:
       void DD4hep_to_IRT() override;
 
     private:
-      // FIXME: should be smart pointers, but IRT methods sometimes assume ownership of such raw pointers
-      FlatSurface*             m_surfEntrance;
-      CherenkovPhotonDetector* m_irtPhotonDetector;
-      FlatSurface*             m_aerogelFlatSurface;
-      FlatSurface*             m_filterFlatSurface;
-      FlatSurface*             m_sensorFlatSurface;
+      // FIXME: should be smart pointers, but IRT methods sometimes assume ownership of such raw pointers;
+      // all null if the geometry was read from the cache
+      FlatSurface*             m_surfEntrance = nullptr;
+      CherenkovPhotonDetector* m_irtPhotonDetector = nullptr;
+      FlatSurface*             m_aerogelFlatSurface = nullptr;
+      FlatSurface*             m_filterFlatSurface = nullptr;
+      FlatSurface*             m_sensorFlatSurface = nullptr;
   };
 }
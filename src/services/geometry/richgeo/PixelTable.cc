@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "PixelTable.h"
+
+#include <DD4hep/IDDescriptor.h>
+#include <DD4hep/Readout.h>
+#include <DD4hep/Segmentations.h>
+#include <DD4hep/VolumeManager.h>
+#include <DD4hep/Volumes.h>
+#include <DDSegmentation/SegmentationParameter.h>
+#include <TGeoMatrix.h>
+#include <fmt/core.h>
+#include <algorithm>
+#include <exception>
+#include <string_view>
+#include <unordered_map>
+
+#include "services/geometry/disk_cache/CacheFile.h"
+
+namespace {
+
+  // of the layout of the cached positions
+  constexpr std::uint32_t file_version = 1;
+
+}
+
+// build ------------------------------------------------------------
+std::shared_ptr<const richgeo::PixelTable> richgeo::PixelTable::Build(
+    std::string readout,
+    gsl::not_null<const dd4hep::Detector*> det,
+    gsl::not_null<const dd4hep::rec::CellIDPositionConverter*> conv,
+    const PixelVisitor& visit_pixels,
+    const std::string& cache_dir,
+    std::shared_ptr<spdlog::logger> log
+    )
+{
+  auto table = std::make_shared<PixelTable>();
+
+  // enumerate the pixels
+  visit_pixels([&table] (CellIDType cellID) { table->m_cells.push_back(cellID); });
+  std::sort(table->m_cells.begin(), table->m_cells.end());
+  table->m_cells.erase(std::unique(table->m_cells.begin(), table->m_cells.end()), table->m_cells.end());
+
+  // everything the pixel positions depend on
+  const dd4hep::Readout dd4hep_readout    = det->readout(readout);
+  const dd4hep::Segmentation segmentation = dd4hep_readout.segmentation();
+  eicrecon::CacheHash hash;
+  hash.add(std::string_view{readout});
+  hash.add(std::string_view{dd4hep_readout.idSpec().fieldDescription()});
+  hash.add(std::string_view{segmentation.type()});
+  for (const auto* parameter : segmentation.parameters()) {
+    hash.add(std::string_view{parameter->name()});
+    hash.add(std::string_view{parameter->value()});
+  }
+
+  // one frame per sensor, i.e. per sensitive volume
+  std::unordered_map<dd4hep::VolumeID, std::uint32_t> sensor_of_volume;
+  table->m_sensor_index.reserve(table->m_cells.size());
+  for (auto cellID : table->m_cells) {
+    hash.add(static_cast<std::uint64_t>(cellID));
+    auto [it, inserted] = sensor_of_volume.try_emplace(segmentation.volumeID(cellID), table->m_sensors.size());
+    table->m_sensor_index.push_back(it->second);
+    if (!inserted)
+      continue;
+
+    // sensor position, cf. `ReadoutGeo::GetSensorLocalPosition`
+    auto context = conv->findContext(cellID);
+    double xyz_l[3], xyz_e[3];
+    SensorFrame frame;
+    auto sensor_elem = context->element;
+    sensor_elem.placement().position().GetCoordinates(xyz_l);
+    const auto& volToElement = context->toElement();
+    volToElement.LocalToMaster(xyz_l, xyz_e);
+    sensor_elem.nominal().worldTransformation().LocalToMaster(xyz_e, frame.origin.data());
+
+    // rotation to the sensor frame, from the images of the unit vectors
+    for (int j = 0; j < 3; ++j) {
+      double unit[3] = {0., 0., 0.};
+      double local[3];
+      unit[j] = 1.;
+      volToElement.MasterToLocalVect(unit, local);
+      for (int i = 0; i < 3; ++i)
+        frame.rotation[3*i + j] = local[i];
+    }
+    table->m_sensors.push_back(frame);
+
+    // the pixel positions follow the placement of the sensitive volume
+    const auto& volToWorld = context->worldTransformation();
+    for (int i = 0; i < 3; ++i)
+      hash.add(volToWorld.GetTranslation()[i]);
+    for (int i = 0; i < 9; ++i)
+      hash.add(volToWorld.GetRotationMatrix()[i]);
+    for (double x : frame.origin)
+      hash.add(x);
+    for (double x : frame.rotation)
+      hash.add(x);
+  }
+
+  // pixel positions, from the cache if possible
+  const std::string path = cache_dir.empty() ? "" : fmt::format("{}/rich_pixels_{}_{:016x}.bin", cache_dir, readout, hash.value());
+  if (!path.empty() && table->Read(path, hash.value())) {
+    log->debug("Read {} pixel positions of {} from {}", table->size(), readout, path);
+    return table;
+  }
+  table->m_positions.reserve(table->m_cells.size());
+  for (auto cellID : table->m_cells) {
+    auto pos = conv->position(cellID);
+    table->m_positions.push_back({pos.x(), pos.y(), pos.z()});
+  }
+  log->debug("Computed {} pixel positions of {} on {} sensors", table->size(), readout, table->m_sensors.size());
+  // a table that can not be written is not an error, it is computed again next time
+  if (!path.empty() && table->Write(path, hash.value()))
+    log->debug("Wrote pixel positions of {} to {}", readout, path);
+  return table;
+}
+
+// lookups ----------------------------------------------------------
+std::optional<std::size_t> richgeo::PixelTable::Index(CellIDType cellID) const {
+  auto it = std::lower_bound(m_cells.begin(), m_cells.end(), cellID);
+  if (it == m_cells.end() || *it != cellID)
+    return std::nullopt;
+  return static_cast<std::size_t>(it - m_cells.begin());
+}
+
+dd4hep::Position richgeo::PixelTable::SensorLocalPosition(std::size_t index, dd4hep::Position pos) const {
+  const auto& frame = m_sensors[m_sensor_index[index]];
+  const double v[3] = {pos.x() - frame.origin[0], pos.y() - frame.origin[1], pos.z() - frame.origin[2]};
+  const auto& r = frame.rotation;
+  return {
+    r[0]*v[0] + r[1]*v[1] + r[2]*v[2],
+    r[3]*v[0] + r[4]*v[1] + r[5]*v[2],
+    r[6]*v[0] + r[7]*v[1] + r[8]*v[2]
+  };
+}
+
+// cache file -------------------------------------------------------
+bool richgeo::PixelTable::Read(const std::string& path, std::uint64_t hash) {
+  const auto blob = eicrecon::cache_file::load(path, file_version, 0, hash);
+  if (!blob || blob->data().size() != m_cells.size() * sizeof(std::array<double,3>))
+    return false;
+  const auto positions = blob->array<std::array<double,3>>(0, m_cells.size());
+  m_positions.assign(positions.begin(), positions.end());
+  return true;
+}
+
+bool richgeo::PixelTable::Write(const std::string& path, std::uint64_t hash) const {
+  try {
+    eicrecon::cache_file::store(path, file_version, 0, hash, {std::as_bytes(std::span(m_positions))});
+  } catch (const std::exception&) {
+    return false;
+  }
+  return true;
+}
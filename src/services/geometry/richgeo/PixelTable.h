@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+// precomputed pixel positions and sensor frames of a RICH readout
+#pragma once
+
+#include <DD4hep/Detector.h>
+#include <DD4hep/Objects.h>
+#include <DDRec/CellIDPositionConverter.h>
+#include <spdlog/logger.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <gsl/pointers>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+// local
+#include "RichGeo.h"
+
+namespace richgeo {
+
+  /* Table of the global position of every pixel of a readout, and of the
+   * frame of its sensor, which replaces the DD4hep volume lookups of
+   * `CellIDPositionConverter::position` and `findContext` for each hit.
+   * The table is built once, shared read-only by all threads, and cached on
+   * disk keyed by a hash of the readout and of the sensor placements.
+   */
+  class PixelTable {
+    public:
+
+      // loop over all readout pixels, see `ReadoutGeo::VisitAllReadoutPixels`
+      using PixelVisitor = std::function<void(std::function<void(CellIDType)>)>;
+
+      // build the table of the pixels of `visit_pixels`, reading it from or
+      // writing it to `cache_dir` (no caching if empty)
+      static std::shared_ptr<const PixelTable> Build(
+          std::string readout,
+          gsl::not_null<const dd4hep::Detector*> det,
+          gsl::not_null<const dd4hep::rec::CellIDPositionConverter*> conv,
+          const PixelVisitor& visit_pixels,
+          const std::string& cache_dir,
+          std::shared_ptr<spdlog::logger> log
+          );
+
+      std::size_t size() const { return m_cells.size(); }
+
+      // cellIDs of all the pixels of the table, sorted
+      std::span<const CellIDType> CellIDs() const { return m_cells; }
+
+      // index of a pixel in the table, std::nullopt if it is not in the table
+      std::optional<std::size_t> Index(CellIDType cellID) const;
+
+      // global position of the pixel volume centroid, as `CellIDPositionConverter::position`
+      dd4hep::Position Position(std::size_t index) const {
+        const auto& p = m_positions[index];
+        return {p[0], p[1], p[2]};
+      }
+
+      // global position `pos` in the frame of the sensor of the pixel, as `ReadoutGeo::GetSensorLocalPosition`
+      dd4hep::Position SensorLocalPosition(std::size_t index, dd4hep::Position pos) const;
+
+    private:
+
+      // sensor origin and global-to-local rotation, local = rotation * (global - origin)
+      struct SensorFrame {
+        std::array<double,3> origin;
+        std::array<double,9> rotation; // row major
+      };
+
+      bool Read(const std::string& path, std::uint64_t hash);
+      bool Write(const std::string& path, std::uint64_t hash) const;
+
+      std::vector<CellIDType>           m_cells; // sorted
+      std::vector<std::array<double,3>> m_positions;
+      std::vector<std::uint32_t>        m_sensor_index;
+      std::vector<SensorFrame>          m_sensors;
+  };
+
+}
@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <cmath>
 #include <map>
+#include <optional>
 
 #include "services/geometry/richgeo/RichGeo.h"
 
@@ -118,9 +119,16 @@ richgeo::ReadoutGeo::ReadoutGeo(std::string detName_, gsl::not_null<const dd4hep
 // pixel gap mask
 // FIXME: generalize; this assumes the segmentation is `CartesianGridXY`
 bool richgeo::ReadoutGeo::PixelGapMask(CellIDType cellID, dd4hep::Position pos_hit_global) {
-  auto pos_pixel_global = m_conv->position(cellID);
-  auto pos_pixel_local  = GetSensorLocalPosition(cellID, pos_pixel_global);
-  auto pos_hit_local    = GetSensorLocalPosition(cellID, pos_hit_global);
+  dd4hep::Position pos_pixel_local, pos_hit_local;
+  if(auto index = m_pixels ? m_pixels->Index(cellID) : std::nullopt) {
+    pos_pixel_local = m_pixels->SensorLocalPosition(*index, m_pixels->Position(*index));
+    pos_hit_local   = m_pixels->SensorLocalPosition(*index, pos_hit_global);
+  }
+  else {
+    auto pos_pixel_global = m_conv->position(cellID);
+    pos_pixel_local = GetSensorLocalPosition(cellID, pos_pixel_global);
+    pos_hit_local   = GetSensorLocalPosition(cellID, pos_hit_global);
+  }
   return ! (
       std::abs( pos_hit_local.x()/dd4hep::mm - pos_pixel_local.x()/dd4hep::mm ) > m_pixel_size/2 ||
       std::abs( pos_hit_local.y()/dd4hep::mm - pos_pixel_local.y()/dd4hep::mm ) > m_pixel_size/2
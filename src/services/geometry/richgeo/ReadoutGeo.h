@@ -19,8 +19,10 @@
 #include <gsl/pointers>
 #include <memory>
 #include <string>
+#include <utility>
 
 // local
+#include "PixelTable.h"
 #include "RichGeo.h"
 
 namespace richgeo {
@@ -63,6 +65,9 @@ namespace richgeo {
       // set RNG seed
       void SetSeed(unsigned long seed) { m_random.SetSeed(seed); }
 
+      // use precomputed pixel positions and sensor frames, where available
+      void SetPixelTable(std::shared_ptr<const PixelTable> pixels) { m_pixels = std::move(pixels); }
+
     protected:
 
       // common objects
@@ -84,6 +89,9 @@ namespace richgeo {
       // local function to generate rng cellIDs; defined in initialization and called by `VisitAllRngPixels`
       std::function< void(std::function<void(CellIDType)>, float) > m_rngCellIDs;
 
+      // precomputed pixels, may be null
+      std::shared_ptr<const PixelTable> m_pixels;
+
     private:
 
       // random number generators
@@ -4,6 +4,7 @@
 #include "RichGeo_service.h"
 
 #include <JANA/JException.h>
+#include <JANA/Services/JGlobalRootLock.h>
 #include <ctype.h>
 #include <fmt/core.h>
 #include <algorithm>
@@ -11,12 +12,15 @@
 #include <gsl/pointers>
 
 #include "services/geometry/dd4hep/DD4hep_service.h"
+#include "services/geometry/disk_cache/CacheFile.h"
 #include "services/geometry/richgeo/ActsGeo.h"
 #include "services/geometry/richgeo/IrtGeo.h"
 #include "services/geometry/richgeo/IrtGeoDRICH.h"
 #include "services/geometry/richgeo/IrtGeoPFRICH.h"
+#include "services/geometry/richgeo/PixelTable.h"
 #include "services/geometry/richgeo/ReadoutGeo.h"
 #include "services/log/Log_service.h"
+#include "services/log/StartupProfile.h"
 
 // Services ----------------------------------------------------------
 void RichGeo_service::acquire_services(JServiceLocator *srv_locator) {
@@ -29,6 +33,12 @@ void RichGeo_service::acquire_services(JServiceLocator *srv_locator) {
   auto dd4hep_service = srv_locator->get<DD4hep_service>();
   m_dd4hepGeo = dd4hep_service->detector();
   m_converter = dd4hep_service->converter();
+
+  // cache of the pixel positions
+  m_pixelTableCacheDir = eicrecon::cache_file::default_directory();
+  m_app->SetDefaultParameter("richgeo:PixelTableCacheDir", m_pixelTableCacheDir, "Directory of the cached pixel positions (no caching if empty)");
+  m_irtGeoCacheDir = m_pixelTableCacheDir;
+  m_app->SetDefaultParameter("richgeo:IrtGeoCacheDir", m_irtGeoCacheDir, "Directory of the cached IRT geometry (no caching if empty)");
 }
 
 // IrtGeo -----------------------------------------------------------
@@ -38,13 +48,8 @@ richgeo::IrtGeo *RichGeo_service::GetIrtGeo(std::string detector_name) {
   try {
     m_log->debug("Call RichGeo_service::GetIrtGeo initializer");
     auto initialize = [this,&detector_name] () {
-      if(!m_dd4hepGeo) throw JException("RichGeo_service m_dd4hepGeo==null which should never be!");
-      // instantiate IrtGeo-derived object, depending on detector
-      auto which_rich = detector_name;
-      std::transform(which_rich.begin(), which_rich.end(), which_rich.begin(), ::toupper);
-      if     ( which_rich=="DRICH"  ) m_irtGeo = new richgeo::IrtGeoDRICH(m_dd4hepGeo,  m_converter, m_log);
-      else if( which_rich=="PFRICH" ) m_irtGeo = new richgeo::IrtGeoPFRICH(m_dd4hepGeo, m_converter, m_log);
-      else throw JException(fmt::format("IrtGeo is not defined for detector '{}'",detector_name));
+      eicrecon::StartupProfile::Scope profile("RichGeo IrtGeo", detector_name);
+      m_irtGeo = MakeIrtGeo(detector_name, m_irtGeoCacheDir);
     };
     std::call_once(m_init_irt, initialize);
   }
@@ -55,12 +60,69 @@ richgeo::IrtGeo *RichGeo_service::GetIrtGeo(std::string detector_name) {
   return m_irtGeo;
 }
 
+CherenkovDetectorCollection *RichGeo_service::AcquireIrtDetectorCollection(std::string detector_name) {
+  try {
+    {
+      std::lock_guard<std::mutex> lock(m_irt_pool_mutex);
+      auto& pool = m_irtGeoPools[detector_name];
+      if(!pool.seeded) {
+        pool.seeded = true;
+        pool.free.push_back(GetIrtGeo(detector_name)->GetIrtDetectorCollection());
+      }
+      if(!pool.free.empty()) {
+        auto *irt_det_coll = pool.free.back();
+        pool.free.pop_back();
+        return irt_det_coll;
+      }
+    }
+    // none is free, built without the lock, as it takes long
+    m_log->debug("Building another IRT geometry of {}", detector_name);
+    eicrecon::StartupProfile::Scope profile("RichGeo IrtGeo copy", detector_name);
+    std::unique_ptr<richgeo::IrtGeo> irt_geo{MakeIrtGeo(detector_name, "")};
+    auto *irt_det_coll = irt_geo->GetIrtDetectorCollection();
+    std::lock_guard<std::mutex> lock(m_irt_pool_mutex);
+    m_irtGeoPools[detector_name].built.push_back(std::move(irt_geo));
+    return irt_det_coll;
+  }
+  catch (std::exception &ex) {
+    throw JException(ex.what());
+  }
+}
+
+void RichGeo_service::ReleaseIrtDetectorCollection(std::string detector_name, CherenkovDetectorCollection *irt_det_coll) {
+  std::lock_guard<std::mutex> lock(m_irt_pool_mutex);
+  m_irtGeoPools[detector_name].free.push_back(irt_det_coll);
+}
+
+richgeo::IrtGeo *RichGeo_service::MakeIrtGeo(const std::string& detector_name, const std::string& cache_dir) {
+  if(!m_dd4hepGeo) throw JException("RichGeo_service m_dd4hepGeo==null which should never be!");
+  // instantiate IrtGeo-derived object, depending on detector
+  auto which_rich = detector_name;
+  std::transform(which_rich.begin(), which_rich.end(), which_rich.begin(), ::toupper);
+  // the cache is a ROOT file
+  richgeo::IrtGeo *irt_geo = nullptr;
+  auto root_lock = m_app->GetService<JGlobalRootLock>();
+  root_lock->acquire_write_lock();
+  try {
+    if     ( which_rich=="DRICH"  ) irt_geo = new richgeo::IrtGeoDRICH(m_dd4hepGeo,  m_converter, m_log, cache_dir);
+    else if( which_rich=="PFRICH" ) irt_geo = new richgeo::IrtGeoPFRICH(m_dd4hepGeo, m_converter, m_log, cache_dir);
+  } catch (...) {
+    root_lock->release_lock();
+    throw;
+  }
+  root_lock->release_lock();
+  if(!irt_geo) throw JException(fmt::format("IrtGeo is not defined for detector '{}'",detector_name));
+  irt_geo->SetPixelTable(GetPixelTable(detector_name));
+  return irt_geo;
+}
+
 // ActsGeo -----------------------------------------------------------
 richgeo::ActsGeo *RichGeo_service::GetActsGeo(std::string detector_name) {
   // initialize, if not yet initialized
   try {
     m_log->debug("Call RichGeo_service::GetActsGeo initializer");
     auto initialize = [this,&detector_name] () {
+      eicrecon::StartupProfile::Scope profile("RichGeo ActsGeo", detector_name);
       if(!m_dd4hepGeo) throw JException("RichGeo_service m_dd4hepGeo==null which should never be!");
       m_actsGeo = new richgeo::ActsGeo(detector_name, m_dd4hepGeo, m_log);
     };
@@ -78,8 +140,19 @@ std::shared_ptr<richgeo::ReadoutGeo> RichGeo_service::GetReadoutGeo(std::string
   try {
     m_log->debug("Call RichGeo_service::GetReadoutGeo initializer");
     auto initialize = [this,&detector_name] () {
+      eicrecon::StartupProfile::Scope profile("RichGeo ReadoutGeo", detector_name);
       if(!m_dd4hepGeo) throw JException("RichGeo_service m_dd4hepGeo==null which should never be!");
       m_readoutGeo = std::make_shared<richgeo::ReadoutGeo>(detector_name, m_dd4hepGeo, m_converter, m_log);
+      // only the dRICH readout pixels can be enumerated, see `ReadoutGeo`
+      auto which_rich = detector_name;
+      std::transform(which_rich.begin(), which_rich.end(), which_rich.begin(), ::toupper);
+      if(which_rich=="DRICH") {
+        m_pixelTable = richgeo::PixelTable::Build(
+            which_rich+"Hits", m_dd4hepGeo, m_converter,
+            [readout_geo = m_readoutGeo] (auto lambda) { readout_geo->VisitAllReadoutPixels(lambda); },
+            m_pixelTableCacheDir, m_log);
+        m_readoutGeo->SetPixelTable(m_pixelTable);
+      }
     };
     std::call_once(m_init_readout, initialize);
   }
@@ -89,6 +162,17 @@ std::shared_ptr<richgeo::ReadoutGeo> RichGeo_service::GetReadoutGeo(std::string
   return m_readoutGeo;
 }
 
+// PixelTable -----------------------------------------------------------
+std::shared_ptr<const richgeo::PixelTable> RichGeo_service::GetPixelTable(std::string detector_name) {
+  // only the dRICH readout pixels can be enumerated, see `ReadoutGeo`
+  auto which_rich = detector_name;
+  std::transform(which_rich.begin(), which_rich.end(), which_rich.begin(), ::toupper);
+  if(which_rich!="DRICH") return nullptr;
+  // the table is built with the ReadoutGeo
+  GetReadoutGeo(detector_name);
+  return m_pixelTable;
+}
+
 // Destructor --------------------------------------------------------
 RichGeo_service::~RichGeo_service() {
   try {
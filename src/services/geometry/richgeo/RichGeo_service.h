@@ -5,16 +5,20 @@
 
 #include <DD4hep/Detector.h>
 #include <DDRec/CellIDPositionConverter.h>
+#include <IRT/CherenkovDetectorCollection.h>
 // JANA
 #include <JANA/JApplication.h>
 #include <JANA/Services/JServiceLocator.h>
 #include <spdlog/logger.h>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "ActsGeo.h"
 #include "IrtGeo.h"
+#include "PixelTable.h"
 #include "ReadoutGeo.h"
 
 class RichGeo_service : public JService {
@@ -26,13 +30,24 @@ class RichGeo_service : public JService {
     virtual const dd4hep::Detector* GetDD4hepGeo() { return m_dd4hepGeo; };
 
     // return pointers to geometry bindings; initializes the bindings upon the first time called
+    // - the IRT geometry is read from the cache of `richgeo:IrtGeoCacheDir` if it is valid, and
+    //   shared by all its users, see `IrtGeo::GetIrtDetectorCollection`
     virtual richgeo::IrtGeo *GetIrtGeo(std::string detector_name);
+    // IRT geometries lent to the users that change them per event (IRT keeps the trajectory of the
+    // current particle in the radiators), each to one user at a time until it is released; the
+    // first one is the geometry of GetIrtGeo, the others are built from DD4hep when none is free,
+    // as the copies read from the same cache would share their `TRef`s, and owned by the service
+    virtual CherenkovDetectorCollection *AcquireIrtDetectorCollection(std::string detector_name);
+    virtual void ReleaseIrtDetectorCollection(std::string detector_name, CherenkovDetectorCollection *irt_det_coll);
     virtual richgeo::ActsGeo *GetActsGeo(std::string detector_name);
     virtual std::shared_ptr<richgeo::ReadoutGeo> GetReadoutGeo(std::string detector_name);
+    // precomputed pixel positions, built with the ReadoutGeo; null if the readout pixels cannot be enumerated
+    virtual std::shared_ptr<const richgeo::PixelTable> GetPixelTable(std::string detector_name);
 
   private:
     RichGeo_service() = default;
     void acquire_services(JServiceLocator *) override;
+    richgeo::IrtGeo *MakeIrtGeo(const std::string& detector_name, const std::string& cache_dir);
 
     std::once_flag   m_init_irt;
     std::once_flag   m_init_acts;
@@ -41,8 +56,18 @@ class RichGeo_service : public JService {
     const dd4hep::Detector* m_dd4hepGeo  = nullptr;
     const dd4hep::rec::CellIDPositionConverter* m_converter = nullptr;
     richgeo::IrtGeo     *m_irtGeo     = nullptr;
+    struct IrtGeoPool {
+      bool seeded = false; // with the geometry of GetIrtGeo
+      std::vector<std::unique_ptr<richgeo::IrtGeo>> built;
+      std::vector<CherenkovDetectorCollection*> free;
+    };
+    std::mutex           m_irt_pool_mutex;
+    std::map<std::string, IrtGeoPool> m_irtGeoPools;
     richgeo::ActsGeo    *m_actsGeo    = nullptr;
     std::shared_ptr<richgeo::ReadoutGeo> m_readoutGeo;
+    std::shared_ptr<const richgeo::PixelTable> m_pixelTable;
+    std::string m_pixelTableCacheDir;
+    std::string m_irtGeoCacheDir;
 
     std::shared_ptr<spdlog::logger> m_log;
 };
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "FlatColumns.h"
+
+#include <edm4eic/ClusterCollection.h>
+#include <edm4eic/InclusiveKinematicsCollection.h>
+#include <edm4eic/ReconstructedParticleCollection.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <edm4hep/ParticleIDCollection.h>
+#include <cmath>
+
+namespace eicrecon {
+
+namespace {
+
+  template <typename CollectionT, auto get>
+  void Extract(const podio::CollectionBase& collection, std::vector<float>& values) {
+    for (const auto& object : static_cast<const CollectionT&>(collection)) {
+      values.push_back(static_cast<float>(get(object)));
+    }
+  }
+
+  struct Member {
+    std::string_view type;
+    std::string_view member;
+    FlatExtractor extract;
+  };
+
+  double pt(const auto& momentum) { return std::hypot(momentum.x, momentum.y); }
+
+  /// The kinematics of the particles of both edm4eic and edm4hep
+  template <typename CollectionT>
+  void AddParticleMembers(std::vector<Member>& members, std::string_view type) {
+    members.insert(members.end(), {
+      {type, "energy", &Extract<CollectionT, [](const auto& o) { return o.getEnergy(); }>},
+      {type, "px", &Extract<CollectionT, [](const auto& o) { return o.getMomentum().x; }>},
+      {type, "py", &Extract<CollectionT, [](const auto& o) { return o.getMomentum().y; }>},
+      {type, "pz", &Extract<CollectionT, [](const auto& o) { return o.getMomentum().z; }>},
+      {type, "p", &Extract<CollectionT, [](const auto& o) { return std::hypot(pt(o.getMomentum()), o.getMomentum().z); }>},
+      {type, "pt", &Extract<CollectionT, [](const auto& o) { return pt(o.getMomentum()); }>},
+      {type, "eta", &Extract<CollectionT, [](const auto& o) { return std::asinh(o.getMomentum().z / pt(o.getMomentum())); }>},
+      {type, "phi", &Extract<CollectionT, [](const auto& o) { return std::atan2(o.getMomentum().y, o.getMomentum().x); }>},
+      {type, "theta", &Extract<CollectionT, [](const auto& o) { return std::atan2(pt(o.getMomentum()), o.getMomentum().z); }>},
+      {type, "charge", &Extract<CollectionT, [](const auto& o) { return o.getCharge(); }>},
+      {type, "mass", &Extract<CollectionT, [](const auto& o) { return o.getMass(); }>},
+      {type, "PDG", &Extract<CollectionT, [](const auto& o) { return o.getPDG(); }>},
+    });
+  }
+
+  const std::vector<Member>& Members() {
+    static const std::vector<Member> members = [] {
+      std::vector<Member> m;
+
+      using RecoParticles = edm4eic::ReconstructedParticleCollection;
+      constexpr std::string_view reco_particle = "edm4eic::ReconstructedParticleCollection";
+      AddParticleMembers<RecoParticles>(m, reco_particle);
+      m.insert(m.end(), {
+        {reco_particle, "type", &Extract<RecoParticles, [](const auto& o) { return o.getType(); }>},
+        {reco_particle, "goodnessOfPID", &Extract<RecoParticles, [](const auto& o) { return o.getGoodnessOfPID(); }>},
+        {reco_particle, "nClusters", &Extract<RecoParticles, [](const auto& o) { return o.getClusters().size(); }>},
+        {reco_particle, "nTracks", &Extract<RecoParticles, [](const auto& o) { return o.getTracks().size(); }>},
+        {reco_particle, "clusterEnergy", &Extract<RecoParticles, [](const auto& o) {
+          double energy = 0;
+          for (const auto& cluster : o.getClusters()) {
+            energy += cluster.getEnergy();
+          }
+          return energy;
+        }>},
+      });
+
+      using MCParticles = edm4hep::MCParticleCollection;
+      constexpr std::string_view mc_particle = "edm4hep::MCParticleCollection";
+      AddParticleMembers<MCParticles>(m, mc_particle);
+      m.insert(m.end(), {
+        {mc_particle, "generatorStatus", &Extract<MCParticles, [](const auto& o) { return o.getGeneratorStatus(); }>},
+        {mc_particle, "time", &Extract<MCParticles, [](const auto& o) { return o.getTime(); }>},
+      });
+
+      using ParticleIDs = edm4hep::ParticleIDCollection;
+      constexpr std::string_view particle_id = "edm4hep::ParticleIDCollection";
+      m.insert(m.end(), {
+        {particle_id, "type", &Extract<ParticleIDs, [](const auto& o) { return o.getType(); }>},
+        {particle_id, "PDG", &Extract<ParticleIDs, [](const auto& o) { return o.getPDG(); }>},
+        {particle_id, "algorithmType", &Extract<ParticleIDs, [](const auto& o) { return o.getAlgorithmType(); }>},
+        {particle_id, "likelihood", &Extract<ParticleIDs, [](const auto& o) { return o.getLikelihood(); }>},
+      });
+
+      using Clusters = edm4eic::ClusterCollection;
+      constexpr std::string_view cluster = "edm4eic::ClusterCollection";
+      m.insert(m.end(), {
+        {cluster, "type", &Extract<Clusters, [](const auto& o) { return o.getType(); }>},
+        {cluster, "energy", &Extract<Clusters, [](const auto& o) { return o.getEnergy(); }>},
+        {cluster, "energyError", &Extract<Clusters, [](const auto& o) { return o.getEnergyError(); }>},
+        {cluster, "time", &Extract<Clusters, [](const auto& o) { return o.getTime(); }>},
+        {cluster, "nhits", &Extract<Clusters, [](const auto& o) { return o.getNhits(); }>},
+        {cluster, "x", &Extract<Clusters, [](const auto& o) { return o.getPosition().x; }>},
+        {cluster, "y", &Extract<Clusters, [](const auto& o) { return o.getPosition().y; }>},
+        {cluster, "z", &Extract<Clusters, [](const auto& o) { return o.getPosition().z; }>},
+        {cluster, "eta", &Extract<Clusters, [](const auto& o) { return std::asinh(o.getPosition().z / pt(o.getPosition())); }>},
+        {cluster, "phi", &Extract<Clusters, [](const auto& o) { return std::atan2(o.getPosition().y, o.getPosition().x); }>},
+      });
+
+      using Kinematics = edm4eic::InclusiveKinematicsCollection;
+      constexpr std::string_view kinematics = "edm4eic::InclusiveKinematicsCollection";
+      m.insert(m.end(), {
+        {kinematics, "x", &Extract<Kinematics, [](const auto& o) { return o.getX(); }>},
+        {kinematics, "Q2", &Extract<Kinematics, [](const auto& o) { return o.getQ2(); }>},
+        {kinematics, "W", &Extract<Kinematics, [](const auto& o) { return o.getW(); }>},
+        {kinematics, "y", &Extract<Kinematics, [](const auto& o) { return o.getY(); }>},
+        {kinematics, "nu", &Extract<Kinematics, [](const auto& o) { return o.getNu(); }>},
+      });
+      return m;
+    }();
+    return members;
+  }
+
+}
+
+FlatColumn ParseFlatColumn(const std::string& spec) {
+  const auto dot = spec.rfind('.');
+  if (dot == std::string::npos) {
+    return {spec, "", nullptr};
+  }
+  return {spec.substr(0, dot), spec.substr(dot + 1), nullptr};
+}
+
+FlatExtractor FindFlatExtractor(std::string_view type_name, const std::string& member) {
+  for (const auto& known : Members()) {
+    if (known.type == type_name && known.member == member) {
+      return known.extract;
+    }
+  }
+  return nullptr;
+}
+
+std::vector<std::string> FlatMembers(std::string_view type_name) {
+  std::vector<std::string> members;
+  for (const auto& known : Members()) {
+    if (known.type == type_name) {
+      members.emplace_back(known.member);
+    }
+  }
+  return members;
+}
+
+} // namespace eicrecon
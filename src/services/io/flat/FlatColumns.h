@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <podio/CollectionBase.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace eicrecon {
+
+/// Appends a value per object of a collection
+using FlatExtractor = void (*)(const podio::CollectionBase& collection, std::vector<float>& values);
+
+/// A column of the flat output, "<collection>.<member>" in flat:columns, "<collection>_<member>" as a branch
+struct FlatColumn {
+  std::string collection;
+  std::string member;
+  FlatExtractor extract{nullptr}; // found from the type of the collection in the first event
+};
+
+/// Parses "<collection>.<member>", the member is empty if there is no dot
+FlatColumn ParseFlatColumn(const std::string& spec);
+
+/// The extractor of a member of the objects of a collection type, nullptr if the member is not known.
+/// The members are the scalar members of the type, the components of its 3-vectors (e.g. px, x) and,
+/// for the particles, pt, p, eta, phi and theta.
+FlatExtractor FindFlatExtractor(std::string_view type_name, const std::string& member);
+
+/// The members that FindFlatExtractor knows for a collection type, for the error messages
+std::vector<std::string> FlatMembers(std::string_view type_name);
+
+} // namespace eicrecon
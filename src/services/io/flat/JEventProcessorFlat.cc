@@ -0,0 +1,247 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "JEventProcessorFlat.h"
+
+#include <JANA/JApplication.h>
+#include <JANA/JException.h>
+#include <JANA/Utils/JTypeInfo.h>
+#include <TFile.h>
+#include <TROOT.h>
+#include <TTree.h>
+#include <fmt/core.h>
+#include <fmt/format.h>
+#include <podio/CollectionBase.h>
+#include <algorithm>
+#include <set>
+#include <utility>
+
+#include "services/log/Log_service.h"
+
+JEventProcessorFlat::JEventProcessorFlat() {
+    SetTypeName(NAME_OF_THIS); // Provide JANA with this class's name
+
+    // the default columns of the particles, their PID, the clusters and the inclusive kinematics
+    for (const std::string particles : {"ReconstructedParticles", "GeneratedParticles"}) {
+        for (const std::string member : {"energy", "px", "py", "pz", "pt", "eta", "phi", "charge", "PDG"}) {
+            m_column_specs.push_back(particles + "." + member);
+        }
+    }
+    m_column_specs.push_back("ReconstructedParticles.goodnessOfPID");
+    m_column_specs.push_back("ReconstructedParticles.clusterEnergy");
+    for (const std::string member : {"type", "PDG", "likelihood"}) {
+        m_column_specs.push_back("ReconstructedChargedParticleIDs." + member);
+    }
+    for (const std::string clusters : {"EcalEndcapNClusters", "EcalBarrelScFiClusters", "EcalEndcapPClusters"}) {
+        for (const std::string member : {"energy", "eta", "phi"}) {
+            m_column_specs.push_back(clusters + "." + member);
+        }
+    }
+    for (const std::string kinematics : {"InclusiveKinematicsTruth", "InclusiveKinematicsElectron", "InclusiveKinematicsJB",
+                                         "InclusiveKinematicsDA", "InclusiveKinematicseSigma", "InclusiveKinematicsSigma"}) {
+        for (const std::string member : {"x", "Q2", "y", "W"}) {
+            m_column_specs.push_back(kinematics + "." + member);
+        }
+    }
+
+    japp->SetDefaultParameter(
+            "flat:output_file",
+            m_output_file,
+            "Name of the flat ROOT file of the flat:columns"
+    );
+    japp->SetDefaultParameter(
+            "flat:columns",
+            m_column_specs,
+            "Comma separated list of the columns to write, as <collection>.<member>, e.g. ReconstructedParticles.pt"
+    );
+    japp->SetDefaultParameter(
+            "flat:batch_events",
+            m_batch_events,
+            "Number of events of the columnar batches handed to the writer thread"
+    );
+    japp->SetDefaultParameter(
+            "flat:async_write",
+            m_queue_depth,
+            "Number of batches queued for the writer thread before the workers wait for it"
+    );
+}
+
+void JEventProcessorFlat::Init() {
+
+    auto* app = GetApplication();
+    // eicrecon --fork sets the output file of every worker after the processor is created
+    m_output_file = app->GetParameterValue<std::string>("flat:output_file");
+    m_log = app->GetService<Log_service>()->logger("JEventProcessorFlat");
+
+    if (m_batch_events == 0 || m_queue_depth == 0) {
+        throw JException("flat:batch_events and flat:async_write must be at least 1");
+    }
+    for (const auto& spec : m_column_specs) {
+        auto column = eicrecon::ParseFlatColumn(spec);
+        if (column.collection.empty() || column.member.empty()) {
+            throw JException("flat:columns must be <collection>.<member>, not \"%s\"", spec.c_str());
+        }
+        m_columns.push_back(std::move(column));
+    }
+    m_batch.values.resize(m_columns.size());
+    m_batch.ends.resize(m_columns.size());
+
+    // the file and the tree are only used by the writer thread
+    ROOT::EnableThreadSafety();
+    m_write_thread = std::thread(&JEventProcessorFlat::WriteLoop, this);
+    m_log->info("Writing {} flat columns to {} in batches of {} events", m_columns.size(), m_output_file, m_batch_events);
+}
+
+void JEventProcessorFlat::FindExtractors(const JEvent& event) {
+    std::set<std::string> missing;
+    for (auto& column : m_columns) {
+        const podio::CollectionBase* collection = nullptr;
+        try {
+            collection = event.GetCollectionBase(column.collection);
+        }
+        catch (std::exception& e) {
+            missing.insert(column.collection);
+            continue;
+        }
+        const std::string type(collection->getTypeName());
+        column.extract = eicrecon::FindFlatExtractor(type, column.member);
+        if (column.extract == nullptr) {
+            throw JException("flat:columns: %s has no member %s, the members of a %s are %s", column.collection.c_str(),
+                             column.member.c_str(), type.c_str(), fmt::format("{}", fmt::join(eicrecon::FlatMembers(type), ", ")).c_str());
+        }
+    }
+    if (!missing.empty()) {
+        // the branches of the tree are fixed by the first event, these columns stay empty
+        m_log->warn("flat:columns: no collections {}, their columns are empty", fmt::join(missing, ", "));
+    }
+}
+
+void JEventProcessorFlat::Process(const std::shared_ptr<const JEvent>& event) {
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_found_extractors) {
+            FindExtractors(*event);
+            m_found_extractors = true;
+        }
+    }
+
+    // the columns of the event are made without a lock, the factories run on the thread of the event
+    std::vector<std::vector<float>> values(m_columns.size());
+    for (std::size_t i = 0; i < m_columns.size(); ++i) {
+        if (m_columns[i].extract == nullptr) {
+            continue;
+        }
+        try {
+            m_columns[i].extract(*event->GetCollectionBase(m_columns[i].collection), values[i]);
+        }
+        catch (std::exception& e) {
+            // a failed factory leaves its columns of the event empty
+            m_log->debug("Event {}: no {}: {}", event->GetEventNumber(), m_columns[i].collection, e.what());
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_batch.runs.push_back(event->GetRunNumber());
+    m_batch.events.push_back(event->GetEventNumber());
+    for (std::size_t i = 0; i < m_columns.size(); ++i) {
+        auto& column = m_batch.values[i];
+        column.insert(column.end(), values[i].begin(), values[i].end());
+        m_batch.ends[i].push_back(column.size());
+    }
+    if (m_batch.events.size() >= m_batch_events) {
+        QueueBatch();
+    }
+}
+
+void JEventProcessorFlat::QueueBatch() {
+    if (m_batch.events.empty()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_write_mutex);
+    m_write_not_full.wait(lock, [this]{ return m_write_queue.size() < m_queue_depth || m_write_error; });
+    if (m_write_error) {
+        std::rethrow_exception(m_write_error);
+    }
+    m_write_queue.push_back(std::move(m_batch));
+    m_write_not_empty.notify_one();
+    m_batch = Batch{};
+    m_batch.values.resize(m_columns.size());
+    m_batch.ends.resize(m_columns.size());
+}
+
+void JEventProcessorFlat::WriteLoop() {
+    try {
+        std::unique_ptr<TFile> file{TFile::Open(m_output_file.c_str(), "RECREATE")};
+        if (file == nullptr || file->IsZombie()) {
+            throw JException("Can not open the flat output file %s", m_output_file.c_str());
+        }
+        auto* tree = new TTree("events", "flat columns of the events");
+        tree->SetDirectory(file.get());
+        std::uint32_t run = 0;
+        std::uint64_t event = 0;
+        tree->Branch("run", &run);
+        tree->Branch("event", &event);
+        std::vector<std::vector<float>> branches(m_columns.size());
+        std::vector<std::vector<float>*> addresses(m_columns.size());
+        for (std::size_t i = 0; i < m_columns.size(); ++i) {
+            addresses[i] = &branches[i];
+            tree->Branch((m_columns[i].collection + "_" + m_columns[i].member).c_str(), &addresses[i]);
+        }
+
+        while (true) {
+            Batch batch;
+            {
+                std::unique_lock<std::mutex> lock(m_write_mutex);
+                m_write_not_empty.wait(lock, [this]{ return !m_write_queue.empty() || m_write_done; });
+                if (m_write_queue.empty()) {
+                    break;
+                }
+                batch = std::move(m_write_queue.front());
+                m_write_queue.pop_front();
+                m_write_not_full.notify_one();
+            }
+            for (std::size_t k = 0; k < batch.events.size(); ++k) {
+                run = batch.runs[k];
+                event = batch.events[k];
+                for (std::size_t i = 0; i < m_columns.size(); ++i) {
+                    const auto begin = batch.values[i].begin() + (k == 0 ? 0 : batch.ends[i][k - 1]);
+                    const auto end = batch.values[i].begin() + batch.ends[i][k];
+                    branches[i].assign(begin, end);
+                }
+                tree->Fill();
+            }
+            m_written += batch.events.size();
+        }
+        file->Write();
+        file->Close();
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(m_write_mutex);
+        m_write_error = std::current_exception();
+        m_write_queue.clear();
+        m_write_not_full.notify_all();
+    }
+}
+
+void JEventProcessorFlat::Finish() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_write_thread.joinable()) {
+            QueueBatch();
+        }
+    }
+    if (m_write_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_write_mutex);
+            m_write_done = true;
+        }
+        m_write_not_empty.notify_all();
+        m_write_thread.join();
+    }
+    if (m_write_error) {
+        m_log->error("Writing {} failed, it is incomplete", m_output_file);
+        return;
+    }
+    m_log->info("Wrote {} events of {} flat columns to {}", m_written, m_columns.size(), m_output_file);
+}
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JEvent.h>
+#include <JANA/JEventProcessor.h>
+#include <spdlog/logger.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FlatColumns.h"
+
+/**
+ * Writes flat columns of the collections of every event into a TTree, e.g.
+ * the kinematics of the particles, the PID likelihoods, the energies of the
+ * clusters and the inclusive kinematics, for analyses that do not need the
+ * podio data model.
+ *
+ * An entry of the "events" tree has the run and event numbers and, for each
+ * of the `flat:columns`, a `std::vector<float>` branch `<collection>_<member>`
+ * of the values of the objects of the collection. The columns of the events
+ * are gathered by the worker threads into columnar batches of
+ * `flat:batch_events`, which a writer thread fills into the tree, so the
+ * workers do not wait for ROOT.
+ */
+class JEventProcessorFlat : public JEventProcessor {
+
+public:
+    JEventProcessorFlat();
+    virtual ~JEventProcessorFlat() = default;
+
+    void Init() override;
+    void Process(const std::shared_ptr<const JEvent>& event) override;
+    void Finish() override;
+
+private:
+    /// The columns of a number of events, each column of all of them in one array
+    struct Batch {
+        std::vector<std::uint32_t> runs;
+        std::vector<std::uint64_t> events;
+        std::vector<std::vector<float>> values;        // per column
+        std::vector<std::vector<std::size_t>> ends;    // per column and event, the end of its values
+    };
+
+    /// Finds the extractors of the columns from the types of the collections of the first event
+    void FindExtractors(const JEvent& event);
+
+    /// Queues the current batch for the writer thread, m_mutex must be held
+    void QueueBatch();
+
+    /// Body of the writer thread
+    void WriteLoop();
+
+    std::shared_ptr<spdlog::logger> m_log;
+    std::string m_output_file = "flat.root";
+    std::vector<std::string> m_column_specs;
+    std::vector<eicrecon::FlatColumn> m_columns;
+    std::size_t m_batch_events = 256;
+    std::size_t m_queue_depth = 4;
+
+    std::mutex m_mutex;
+    bool m_found_extractors = false;
+    Batch m_batch;
+
+    std::thread m_write_thread;
+    std::mutex m_write_mutex;
+    std::condition_variable m_write_not_empty;
+    std::condition_variable m_write_not_full;
+    std::deque<Batch> m_write_queue;
+    std::exception_ptr m_write_error;
+    bool m_write_done = false;
+    std::uint64_t m_written = 0;
+};
@@ -0,0 +1,15 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <JANA/JApplication.h>
+
+#include "JEventProcessorFlat.h"
+
+
+// Make this a JANA plugin
+extern "C" {
+void InitPlugin(JApplication *app) {
+    InitJANAPlugin(app);
+    app->Add(new JEventProcessorFlat());
+}
+}
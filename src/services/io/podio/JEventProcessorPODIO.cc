@@ -8,14 +8,28 @@
 #include <edm4eic/EDM4eicVersion.h>
 #include <fmt/core.h>
 #include <podio/CollectionBase.h>
+#include <podio/CollectionBuffers.h>
 #include <podio/Frame.h>
-#include <podio/ROOTWriter.h>
+#include <podio/ObjectID.h>
+#include <TROOT.h>
 #include <spdlog/common.h>
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <exception>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <set>
+#include <stdexcept>
 #include <thread>
+#include <utility>
 
+#include "PodioEventPoolController.h"
+#include "PodioSharedFrame.h"
+#include "extensions/jana/JOmniFactoryExecutor.h"
 #include "services/log/Log_service.h"
+#include "services/log/TraceRange.h"
 
 
 JEventProcessorPODIO::JEventProcessorPODIO() {
@@ -44,6 +58,12 @@ JEventProcessorPODIO::JEventProcessorPODIO() {
             "Directory name to make an additional copy of the output file to. Copy will be done at end of processing. Default is empty string which means do not make a copy. No check is made on path existing."
     );
 
+    japp->SetDefaultParameter(
+            "podio:output_format",
+            m_output_formats,
+            "Storage of the frames in the output file: ttree or rntuple. With both, e.g. \"ttree,rntuple\", the second format is written to a copy whose name ends with .<format>.root, to compare them."
+    );
+
     // Get the list of output collections to include/exclude
     std::vector<std::string> output_collections={
             // Header and other metadata
@@ -194,6 +214,21 @@ JEventProcessorPODIO::JEventProcessorPODIO() {
             "CentralCKFSeededTrajectoriesUnfiltered",
             "CentralCKFSeededTracksUnfiltered",
             "CentralCKFSeededTrackParametersUnfiltered",
+            //tracking status, with the budgets of the track finding
+            "CentralCKFTrackingStatusNumSeeds",
+            "CentralCKFTrackingStatusNumSeedsProcessed",
+            "CentralCKFTrackingStatusNumBranches",
+            "CentralCKFTrackingStatusTime",
+            "CentralCKFTrackingStatusSeedsTruncated",
+            "CentralCKFTrackingStatusDegraded",
+            "CentralCKFTrackingStatusTruncated",
+            "CentralCKFSeededTrackingStatusNumSeeds",
+            "CentralCKFSeededTrackingStatusNumSeedsProcessed",
+            "CentralCKFSeededTrackingStatusNumBranches",
+            "CentralCKFSeededTrackingStatusTime",
+            "CentralCKFSeededTrackingStatusSeedsTruncated",
+            "CentralCKFSeededTrackingStatusDegraded",
+            "CentralCKFSeededTrackingStatusTruncated",
             "InclusiveKinematicsDA",
             "InclusiveKinematicsJB",
             "InclusiveKinematicsSigma",
@@ -337,6 +372,111 @@ JEventProcessorPODIO::JEventProcessorPODIO() {
             "Comma separated list of collection names to print to screen, e.g. for debugging."
     );
 
+    japp->SetDefaultParameter(
+            "podio:async_write",
+            m_write_queue_depth,
+            "Number of events queued for a dedicated writer thread (0 writes on the worker threads), which shares the frames of the events with their source."
+    );
+    japp->SetDefaultParameter(
+            "podio:ordered_write",
+            m_ordered_write,
+            "Write the events in the order of the input instead of the order in which they complete, through a reorder buffer of podio:async_write events in front of the writer thread."
+    );
+    int implicit_mt = 0;
+    japp->SetDefaultParameter(
+            "podio:root_implicit_mt",
+            implicit_mt,
+            "number of ROOT implicit multi-threading threads, which decompress the baskets of an entry in parallel (0 disables it)"
+    );
+    if (implicit_mt > 0 && !ROOT::IsImplicitMTEnabled()) {
+        // also compresses the baskets of the branches in parallel when the TTree is filled
+        ROOT::EnableImplicitMT(implicit_mt);
+    }
+
+    japp->SetDefaultParameter(
+            "podio:output_shards",
+            m_output_shards,
+            "Number of output files written at the same time by the worker threads (0 writes a single file). Set it to nthreads for a file per thread."
+    );
+    japp->SetDefaultParameter(
+            "podio:output_merge",
+            m_output_merge,
+            "Merge of the podio:output_shards into podio:output_file at the end of the job: ordered (by run and event number), unordered, or none (keeps the shards and writes an index)."
+    );
+    japp->SetDefaultParameter(
+            "podio:checkpoint_events",
+            m_checkpoint_events,
+            "Close a numbered output chunk <stem>.chunk<k>.root every N events and list it in podio:checkpoint_manifest, so that a stopped job can be resumed with jana:resume_from (0 writes a single file)."
+    );
+    japp->SetDefaultParameter(
+            "podio:checkpoint_manifest",
+            m_checkpoint_manifest,
+            "Manifest of the completed chunks of podio:checkpoint_events and of their input entries (<stem>.manifest of podio:output_file if empty)."
+    );
+    japp->SetDefaultParameter(
+            "jana:resume_from",
+            m_resume_from,
+            "Manifest of a stopped job with podio:checkpoint_events: its chunks are kept, and only the input entries that are not in them are processed."
+    );
+
+    japp->SetDefaultParameter(
+            "podio:compression_algorithm",
+            m_compression_algorithm,
+            "Compression algorithm of the TTree output: zlib, lzma, lz4, zstd or none (ROOT's default if empty)"
+    );
+    japp->SetDefaultParameter(
+            "podio:compression_level",
+            m_write_tuning.compression_level,
+            "Compression level of the TTree output, 1-9 (0 for no compression, -1 for ROOT's default)"
+    );
+    japp->SetDefaultParameter(
+            "podio:auto_flush",
+            m_write_tuning.auto_flush,
+            "TTree::SetAutoFlush of the output: baskets are flushed every N entries if N > 0, every -N bytes if N < 0 (0 for ROOT's default)"
+    );
+    japp->SetDefaultParameter(
+            "podio:basket_size",
+            m_write_tuning.basket_size,
+            "Basket size in bytes of all the output branches, from the second event on (0 for ROOT's default)"
+    );
+    japp->SetDefaultParameter(
+            "podio:write_buffer_size",
+            m_write_tuning.write_buffer_size,
+            "Size in bytes of the write cache of the output TFile (0 for none)"
+    );
+
+    japp->SetDefaultParameter(
+            "podio:filter",
+            m_filter_expression,
+            "Only write the events that pass this expression of collection sizes and element members, e.g. 'ScatteredElectronsEMinusPz.size > 0 || ReconstructedJets[0].energy > 10' (all if empty). The other collections of a failing event are not made."
+    );
+
+    bool memory_report = false;
+    std::string memory_report_file;
+    japp->SetDefaultParameter(
+            "podio:memory_report",
+            memory_report,
+            "Report the element counts and approximate bytes of all the collections of the frame, and the peak bytes per event slot."
+    );
+    japp->SetDefaultParameter(
+            "podio:memory_report_file",
+            memory_report_file,
+            "CSV file of the collection sizes of every event, with podio:memory_report."
+    );
+    // the live bytes per event of the accounting adapt the events in flight of the source
+    size_t memory_limit_mb = 0;
+    japp->SetDefaultParameter(
+            "podio:memory_limit_mb",
+            memory_limit_mb,
+            "hold the events in flight below this resident set size, adapting their number to the RSS and the live bytes per event (0 leaves it to jana:nevents_in_pool)"
+    );
+    m_print_memory_report = memory_report;
+    if (memory_report || memory_limit_mb > 0) {
+        m_memory_report = std::make_unique<PodioMemoryReport>();
+        m_memory_report->SetOutputFile(memory_report_file);
+        m_observe_event_bytes = memory_limit_mb > 0;
+    }
+
     m_output_collections = std::set<std::string>(output_collections.begin(),
                                                  output_collections.end());
     m_output_exclude_collections = std::set<std::string>(output_exclude_collections.begin(),
@@ -348,9 +488,65 @@ JEventProcessorPODIO::JEventProcessorPODIO() {
 void JEventProcessorPODIO::Init() {
 
     auto *app = GetApplication();
+    // eicrecon --fork sets the output file of every worker after the processor is created
+    m_output_file = app->GetParameterValue<std::string>("podio:output_file");
     m_log = app->GetService<Log_service>()->logger("JEventProcessorPODIO");
     m_log->set_level(spdlog::level::debug);
-    m_writer = std::make_unique<podio::ROOTFrameWriter>(m_output_file);
+    if (!m_filter_expression.empty()) {
+        try {
+            m_filter = std::make_unique<PodioEventFilter>(m_filter_expression);
+        }
+        catch (std::invalid_argument& e) {
+            throw JException(e.what());
+        }
+        m_log->info("Writing only the events that pass '{}'", m_filter_expression);
+    }
+    if (!m_compression_algorithm.empty() && !m_write_tuning.SetCompressionAlgorithm(m_compression_algorithm)) {
+        throw JException("podio:compression_algorithm must be zlib, lzma, lz4, zstd or none, not '%s'", m_compression_algorithm.c_str());
+    }
+    try {
+        if (m_checkpoint_events > 0 || !m_resume_from.empty()) {
+            if (m_checkpoint_events == 0) {
+                throw JException("jana:resume_from needs podio:checkpoint_events");
+            }
+            if (m_write_queue_depth > 0 || m_output_shards > 0) {
+                throw JException("podio:checkpoint_events can not be combined with podio:async_write or podio:output_shards");
+            }
+            if (m_checkpoint_manifest.empty()) {
+                m_checkpoint_manifest = eicrecon::PodioCheckpointWriter::DefaultManifest(m_output_file);
+            }
+            m_checkpoint_writer = std::make_unique<eicrecon::PodioCheckpointWriter>(
+                    m_output_file, m_output_formats, m_checkpoint_events, m_checkpoint_manifest, m_resume_from, m_write_tuning);
+            m_log->info("Writing chunks of {} events of {}, listed in {}{}", m_checkpoint_events, m_output_file,
+                        m_checkpoint_manifest, m_resume_from.empty() ? "" : fmt::format(", resumed from {}", m_resume_from));
+        } else if (m_output_shards > 0) {
+            if (m_write_queue_depth > 0) {
+                throw JException("podio:async_write and podio:output_shards can not be combined");
+            }
+            if (!eicrecon::PodioShardedWriter::ParseMerge(m_output_merge)) {
+                throw JException("podio:output_merge must be ordered, unordered or none, not '%s'", m_output_merge.c_str());
+            }
+            // the shards are written by several threads at the same time
+            ROOT::EnableThreadSafety();
+            m_sharded_writer = std::make_unique<eicrecon::PodioShardedWriter>(m_output_file, m_output_formats, m_output_shards, m_write_tuning);
+            m_log->info("Writing {} shards of {}, merged at the end: {}", m_output_shards, m_output_file, m_output_merge);
+        } else {
+            m_writers = eicrecon::MakePodioWriters(m_output_file, m_output_formats, m_write_tuning);
+        }
+    }
+    catch (std::runtime_error& e) {
+        throw JException(e.what());
+    }
+    if (m_ordered_write && m_write_queue_depth == 0) {
+        throw JException("podio:ordered_write needs podio:async_write, the size of its reorder buffer");
+    }
+    if (m_write_queue_depth > 0) {
+        // the frames are written on their own thread, while the sources read theirs
+        ROOT::EnableThreadSafety();
+        m_write_thread = std::thread(&JEventProcessorPODIO::WriteLoop, this);
+        m_log->info("Writing {} asynchronously, with up to {} events {}", m_output_file, m_write_queue_depth,
+                    m_ordered_write ? "in the reorder buffer, in the order of the input" : "queued");
+    }
     // TODO: NWB: Verify that output file is writable NOW, rather than after event processing completes.
     //       I definitely don't trust PODIO to do this for me.
 
@@ -403,59 +599,109 @@ void JEventProcessorPODIO::FindCollectionsToWrite(const std::shared_ptr<const JE
 
 }
 
-void JEventProcessorPODIO::Process(const std::shared_ptr<const JEvent> &event) {
+namespace {
+
+/// Range of the frame writes on the profiler timeline, with USE_NVTX or USE_ITT
+const eicrecon::TraceName& WriteTraceName() {
+    static const eicrecon::TraceName trace_name("podio write");
+    return trace_name;
+}
 
-    std::lock_guard<std::mutex> lock(m_mutex);
-    if (m_is_first_event) {
-        FindCollectionsToWrite(event);
+/// The input entry that JEventSourcePODIO inserts with podio:checkpoint_events, nullptr for other sources
+const eicrecon::PodioInputEntry* InputEntry(const JEvent& event) {
+    try {
+        const auto entries = event.Get<eicrecon::PodioInputEntry>();
+        return entries.empty() ? nullptr : entries.front();
+    }
+    catch(std::exception &e) {
+        return nullptr;
     }
+}
 
-    // Trigger all collections once to fix the collection IDs
-    // TODO: WDC: This should not be necessary, but while we await collection IDs
-    //            that are determined by hash, we have to ensure they are reproducible
-    //            even if the collections are filled in unpredictable order (or not at
-    //            all). See also below, at "TODO: NWB:".
-    for (const auto& coll_name : m_collections_to_write) {
-        try {
-            [[maybe_unused]]
-            const auto* coll_ptr = event->GetCollectionBase(coll_name);
-        }
-        catch(std::exception &e) {
-            // chomp
+/// The frame of an event that its source shares with the writer, see eicrecon::InsertSharedFrame
+const eicrecon::PodioSharedFrame* SharedFrame(const JEvent& event) {
+    try {
+        const auto frames = event.Get<eicrecon::PodioSharedFrame>();
+        return frames.empty() ? nullptr : frames.front();
+    }
+    catch(std::exception &e) {
+        return nullptr;
+    }
+}
+
+/// The position in the input that JEventSourcePODIO inserts with podio:ordered_write, none for other sources
+std::optional<std::uint64_t> InputSequence(const JEvent& event) {
+    try {
+        const auto sequences = event.Get<eicrecon::PodioEventSequence>();
+        if (sequences.empty()) {
+            return std::nullopt;
         }
+        return sequences.front()->index;
+    }
+    catch(std::exception &e) {
+        return std::nullopt;
     }
+}
 
-    // Print the contents of some collections, just for debugging purposes
-    // Do this before writing just in case writing crashes
-    if (!m_collections_to_print.empty()) {
-        LOG << "========================================" << LOG_END;
-        LOG << "JEventProcessorPODIO: Event " << event->GetEventNumber() << LOG_END;
+} // namespace
+
+
+void JEventProcessorPODIO::Process(const std::shared_ptr<const JEvent> &event) {
+
+    std::vector<std::string> collections_to_write;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_is_first_event) {
+            FindCollectionsToWrite(event);
+            m_is_first_event = false;
+        }
+        collections_to_write = m_collections_to_write;
     }
-    for (const auto& coll_name : m_collections_to_print) {
-        LOG << "------------------------------" << LOG_END;
-        LOG << coll_name << LOG_END;
-        try {
-            const auto* coll_ptr = event->GetCollectionBase(coll_name);
-            if (coll_ptr == nullptr) {
-                LOG << "missing" << LOG_END;
-            } else {
-                coll_ptr->print();
+
+    // The collections of the filter are made first, in every event, the others only for the events that pass
+    if (m_filter) {
+        const bool pass = m_filter->Pass([&event](const std::string& name) -> const podio::CollectionBase* {
+            try {
+                return event->GetCollectionBase(name);
             }
+            catch(std::exception &e) {
+                return nullptr;
+            }
+        });
+        if (!pass) {
+            ++m_filter_failed;
+            if (m_checkpoint_writer) {
+                // the entry is done, even if nothing of it is written
+                const auto* entry = InputEntry(*event);
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_checkpoint_writer->writeFrame(nullptr, m_collections_to_write, entry);
+            }
+            if (m_ordered_write) {
+                // the writer does not wait for its position
+                std::unique_lock<std::mutex> lock(m_write_mutex);
+                QueueOrdered(lock, InputSequence(*event), {});
+            }
+            return;
         }
-        catch(std::exception &e) {
-            LOG << "missing" << LOG_END;
-        }
+        ++m_filter_passed;
     }
 
-    m_log->trace("==================================");
-    m_log->trace("Event #{}", event->GetEventNumber());
-
-
-    // Make sure that all factories get called that need to be written into the frame.
-    // We need to do this for _all_ factories unless we've constrained it by using includes/excludes.
-    // Note that all collections need to be present in the first event, as podio::RootFrameWriter constrains us to write one event at a time, so there
-    // is no way to add a new branch after the first event.
+    // With omnifactory:IntraEventThreads, the factories of the event run first, the independent ones concurrently
+    eicrecon::JOmniFactoryExecutor::instance().Prefetch(GetApplication(), event);
 
+    // Phase 1, without any lock: make the collections of the event and fill their write buffers.
+    // The factories of an event run on the thread of the event, in the order of
+    // collections_to_write, which also fixes the collection IDs (unless they are prefetched above,
+    // which needs the hashed collection IDs).
+    // TODO: WDC: Triggering all collections in a fixed order should not be necessary, but while we
+    //            await collection IDs that are determined by hash, we have to ensure they are
+    //            reproducible even if the collections are filled in unpredictable order (or not at
+    //            all). See also below, at "TODO: NWB:".
+    //
+    // Note that all collections need to be present in the first event, as podio::RootFrameWriter
+    // constrains us to write one event at a time, so there is no way to add a new branch after the
+    // first event.
+    //
     // If we get an exception below while trying to add a factory for any
     // reason then mark that factory as bad and don't try running it again.
     // This is motivated by trying to write EcalBarrelSciGlass objects for
@@ -463,47 +709,80 @@ void JEventProcessorPODIO::Process(const std::shared_ptr<const JEvent> &event) {
     // always throw an exception, but DD4hep also prints its own error message.
     // Thus, to prevent that error message every event, we must avoid calling
     // it.
-
-    // Activate factories.
     // TODO: NWB: For now we run every factory every time, swallowing exceptions if necessary.
     //            We do this so that we always have the same collections created in the same order.
     //            This means that the collection IDs are stable so the writer doesn't segfault.
     //            The better fix is to maintain a map of collection IDs, or just wait for PODIO to fix the bug.
-    std::vector<std::string> successful_collections;
-    static std::set<std::string> failed_collections;
-    for (const std::string& coll : m_collections_to_write) {
+    std::vector<std::string> failed_now;
+    std::vector<std::string> failure_messages;
+    std::vector<const podio::CollectionBase*> collections(collections_to_write.size(), nullptr);
+    for (size_t i = 0; i < collections_to_write.size(); ++i) {
+        const std::string& coll = collections_to_write[i];
         try {
             m_log->trace("Ensuring factory for collection '{}' has been called.", coll);
-            const auto* coll_ptr = event->GetCollectionBase(coll);
-            if (coll_ptr == nullptr) {
+            collections[i] = event->GetCollectionBase(coll);
+            if (collections[i] == nullptr) {
                 // If a collection is missing from the frame, the podio root writer will segfault.
                 // To avoid this, we treat this as a failing collection and omit from this point onwards.
                 // However, this code path is expected to be unreachable because any missing collection will be
                 // replaced with an empty collection in JFactoryPodioTFixed::Create.
-                if (failed_collections.count(coll) == 0) {
-                    m_log->error("Omitting PODIO collection '{}' because it is null", coll);
-                    failed_collections.insert(coll);
-                }
-            }
-            else {
-                m_log->trace("Including PODIO collection '{}'", coll);
-                successful_collections.push_back(coll);
+                failed_now.push_back(coll);
+                failure_messages.push_back("because it is null");
             }
         }
         catch(std::exception &e) {
-            // Limit printing warning to just once per factory
-            if (failed_collections.count(coll) == 0) {
-                m_log->error("Omitting PODIO collection '{}' due to exception: {}.", coll, e.what());
-                failed_collections.insert(coll);
+            failed_now.push_back(coll);
+            failure_messages.push_back(fmt::format("due to exception: {}.", e.what()));
+        }
+    }
+    for (size_t i = 0; i < collections.size(); ++i) {
+        if (collections[i] != nullptr) {
+            m_log->trace("Including PODIO collection '{}'", collections_to_write[i]);
+            // Resolve the relations and fill the write buffers here, in parallel with the other
+            // events, once all the factories have run; the writer then only copies the buffers
+            // into the TTree baskets.
+            collections[i]->prepareForWrite();
+        }
+    }
+
+    // Print the contents of some collections, just for debugging purposes
+    // Do this before writing just in case writing crashes
+    if (!m_collections_to_print.empty()) {
+        // the factories run before the lock is taken, which only orders the printing
+        std::vector<const podio::CollectionBase*> printed;
+        for (const auto& coll_name : m_collections_to_print) {
+            try {
+                printed.push_back(event->GetCollectionBase(coll_name));
+            }
+            catch(std::exception &e) {
+                printed.push_back(nullptr);
+            }
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        LOG << "========================================" << LOG_END;
+        LOG << "JEventProcessorPODIO: Event " << event->GetEventNumber() << LOG_END;
+        for (size_t i = 0; i < m_collections_to_print.size(); ++i) {
+            LOG << "------------------------------" << LOG_END;
+            LOG << m_collections_to_print[i] << LOG_END;
+            if (printed[i] == nullptr) {
+                LOG << "missing" << LOG_END;
+            } else {
+                printed[i]->print();
             }
         }
     }
-    m_collections_to_write = successful_collections;
 
+    m_log->trace("==================================");
+    m_log->trace("Event #{}", event->GetEventNumber());
+
+    // Phase 2: the lock is only taken for the failed collections and to serialise the frame.
     // Frame will contain data from all Podio factories that have been triggered,
     // including by the `event->GetCollectionBase(coll);` above.
     // Note that collections MUST be present in frame. If a collection is null, the writer will segfault.
     const auto* frame = event->GetSingle<podio::Frame>();
+    if (!m_subsets_checked.exchange(true)) {
+        CheckSubsetCollections(*frame, collections_to_write);
+    }
 
     // TODO: NWB: We need to actively stabilize podio collections. Until then, keep this around in case
     //            the writer starts segfaulting, so we can quickly see whether the problem is unstable collection IDs.
@@ -513,9 +792,243 @@ void JEventProcessorPODIO::Process(const std::shared_ptr<const JEvent> &event) {
         m_log->info("Writing collection '{}' with id {}", collname, frame->get(collname)->getID());
     }
     */
-    m_writer->writeFrame(*frame, "events", m_collections_to_write);
-    m_is_first_event = false;
 
+    if (m_sharded_writer) {
+        std::vector<std::string> collections;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            RemoveFailedCollections(failed_now, failure_messages);
+            collections = m_collections_to_write;
+            AccountFrame(event.get(), event->GetEventNumber(), *frame);
+        }
+        // only the threads that share a shard wait for each other
+        const eicrecon::TraceRange trace_range(WriteTraceName());
+        m_sharded_writer->writeFrame(*frame, collections, event->GetRunNumber(), event->GetEventNumber());
+        return;
+    }
+
+    if (m_checkpoint_writer) {
+        const auto* entry = InputEntry(*event);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        RemoveFailedCollections(failed_now, failure_messages);
+        const eicrecon::TraceRange trace_range(WriteTraceName());
+        m_checkpoint_writer->writeFrame(frame, m_collections_to_write, entry);
+        AccountFrame(event.get(), event->GetEventNumber(), *frame);
+        return;
+    }
+
+    if (m_write_queue_depth == 0) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        RemoveFailedCollections(failed_now, failure_messages);
+        WriteFrame(*frame, m_collections_to_write);
+        // the JEvent is the slot of the event in the pool
+        AccountFrame(event.get(), event->GetEventNumber(), *frame);
+        return;
+    }
+
+    // Asynchronous writing: the writer thread shares the frame with the event, and writes it after the
+    // event is recycled if need be. The event is not changed, the processors and factories that run
+    // after this one still see all of its collections.
+    const auto* shared = SharedFrame(*event);
+    if (shared == nullptr || shared->frame.get() != frame) {
+        throw JException("podio:async_write needs a source that shares the frames of its events (eicrecon::InsertSharedFrame)");
+    }
+    PendingFrame pending;
+    pending.frame = shared->frame;
+    pending.keep_alive = shared->keep_alive;
+    pending.slot = event.get();
+    pending.event_number = event->GetEventNumber();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        RemoveFailedCollections(failed_now, failure_messages);
+        pending.collections = m_collections_to_write;
+    }
+    const auto sequence = m_ordered_write ? InputSequence(*event) : std::nullopt;
+    std::unique_lock<std::mutex> lock(m_write_mutex);
+    if (m_ordered_write) {
+        QueueOrdered(lock, sequence, std::move(pending));
+        return;
+    }
+    m_write_not_full.wait(lock, [this]{ return m_write_queue.size() < m_write_queue_depth || m_write_error; });
+    if (m_write_error) {
+        RethrowWriteError();
+    }
+    m_write_queue.push_back(std::move(pending));
+    m_write_not_empty.notify_one();
+}
+
+void JEventProcessorPODIO::QueueOrdered(std::unique_lock<std::mutex>& lock, std::optional<std::uint64_t> sequence, PendingFrame pending) {
+    if (!sequence) {
+        if (!std::exchange(m_unsequenced_warned, true)) {
+            m_log->warn("podio:ordered_write: the source does not insert the positions of its events, they are written in the order in which they complete");
+        }
+        sequence = m_unsequenced++;
+    }
+    // The event at m_reorder_next never waits, so the buffer always drains. The positions that are
+    // not written hold no frame and do not wait either
+    if (pending.frame && *sequence >= m_reorder_next + m_write_queue_depth) {
+        const auto start = std::chrono::steady_clock::now();
+        m_write_not_full.wait(lock, [&]{ return *sequence < m_reorder_next + m_write_queue_depth || m_write_error; });
+        ++m_reorder_stalls;
+        m_reorder_stall_time += std::chrono::steady_clock::now() - start;
+    }
+    if (m_write_error) {
+        RethrowWriteError();
+    }
+    m_reorder_buffer.emplace(*sequence, std::move(pending));
+    ++m_reorder_frames;
+    m_reorder_occupancy += m_reorder_buffer.size();
+    m_reorder_max_occupancy = std::max(m_reorder_max_occupancy, m_reorder_buffer.size());
+    if (m_reorder_buffer.begin()->first == m_reorder_next) {
+        m_write_not_empty.notify_one();
+    }
+}
+
+void JEventProcessorPODIO::RemoveFailedCollections(const std::vector<std::string>& failed_now, const std::vector<std::string>& messages) {
+    for (size_t i = 0; i < failed_now.size(); ++i) {
+        // Limit printing warning to just once per factory
+        if (m_failed_collections.insert(failed_now[i]).second) {
+            m_log->error("Omitting PODIO collection '{}' {}", failed_now[i], messages[i]);
+        }
+    }
+    if (!failed_now.empty()) {
+        m_collections_to_write.erase(std::remove_if(m_collections_to_write.begin(), m_collections_to_write.end(),
+                                                    [this](const std::string& coll) { return m_failed_collections.count(coll) > 0; }),
+                                     m_collections_to_write.end());
+    }
+}
+
+void JEventProcessorPODIO::CheckSubsetCollections(const podio::Frame& frame, const std::vector<std::string>& collections) {
+    std::map<std::uint32_t, std::string> names;
+    for (const auto& name : frame.getAvailableCollections()) {
+        if (const auto* collection = frame.get(name)) {
+            names[collection->getID()] = name;
+        }
+    }
+    const std::set<std::string> written(collections.begin(), collections.end());
+
+    // the write buffers of a subset collection hold the object IDs of its elements in their collections
+    size_t subsets = 0;
+    for (const auto& name : collections) {
+        const auto* collection = frame.get(name);
+        if (collection == nullptr || !collection->isSubsetCollection()) {
+            continue;
+        }
+        ++subsets;
+        auto buffers = const_cast<podio::CollectionBase*>(collection)->getBuffers();
+        std::set<std::uint32_t> parents;
+        if (buffers.references != nullptr) {
+            for (const auto& references : *buffers.references) {
+                for (const auto& id : *references) {
+                    parents.insert(id.collectionID);
+                }
+            }
+        }
+        for (const auto id : parents) {
+            const auto parent = names.find(id);
+            if (parent == names.end()) {
+                m_log->warn("Subset collection '{}' refers to elements that are in no collection of the event (ID {:#x})", name, id);
+            } else if (written.count(parent->second) == 0) {
+                m_log->warn("Subset collection '{}' refers to '{}', which is not written: its elements can not be read back", name, parent->second);
+            }
+        }
+    }
+    m_log->info("{} of the {} written collections are subset collections, which store references only", subsets, collections.size());
+}
+
+void JEventProcessorPODIO::AccountFrame(const void* slot, std::uint64_t event_number, const podio::Frame& frame) {
+    if (!m_memory_report) {
+        return;
+    }
+    const auto bytes = m_memory_report->Add(slot, event_number, frame);
+    if (m_observe_event_bytes) {
+        eicrecon::PodioEventPoolController::instance().observeEventBytes(bytes);
+    }
+}
+
+void JEventProcessorPODIO::WriteFrame(const podio::Frame& frame, const std::vector<std::string>& collections) {
+    const eicrecon::TraceRange trace_range(WriteTraceName());
+    for (auto& writer : m_writers) {
+        writer->writeFrame(frame, "events", collections);
+    }
+}
+
+void JEventProcessorPODIO::WriteLoop() {
+    while (true) {
+        PendingFrame pending;
+        {
+            std::unique_lock<std::mutex> lock(m_write_mutex);
+            if (m_ordered_write) {
+                // at the end of the job, the positions that never came are skipped
+                m_write_not_empty.wait(lock, [this]{
+                    return m_write_done || (!m_reorder_buffer.empty() && m_reorder_buffer.begin()->first == m_reorder_next);
+                });
+                if (m_reorder_buffer.empty()) {
+                    return;
+                }
+                auto next = m_reorder_buffer.extract(m_reorder_buffer.begin());
+                m_reorder_next = next.key() + 1;
+                pending = std::move(next.mapped());
+                // the events wait for different positions
+                m_write_not_full.notify_all();
+            } else {
+                m_write_not_empty.wait(lock, [this]{ return !m_write_queue.empty() || m_write_done; });
+                if (m_write_queue.empty()) {
+                    return;
+                }
+                pending = std::move(m_write_queue.front());
+                m_write_queue.pop_front();
+                m_write_not_full.notify_one();
+            }
+        }
+        if (!pending.frame) {
+            continue;
+        }
+        try {
+            WriteFrame(*pending.frame, pending.collections);
+            AccountFrame(pending.slot, pending.event_number, *pending.frame);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(m_write_mutex);
+            m_write_error = std::current_exception();
+            m_write_queue.clear();
+            m_reorder_buffer.clear();
+            m_write_not_full.notify_all();
+            return;
+        }
+    }
+}
+
+void JEventProcessorPODIO::RethrowWriteError() {
+    try {
+        std::rethrow_exception(m_write_error);
+    }
+    catch (std::exception& e) {
+        throw JException(fmt::format("Writing {} failed: {}", m_output_file, e.what()));
+    }
+}
+
+void JEventProcessorPODIO::PrintCompression(std::vector<eicrecon::PodioCollectionBytes> bytes) {
+    if (bytes.empty()) {
+        return;
+    }
+    std::uint64_t total_bytes = 0;
+    std::uint64_t zip_bytes = 0;
+    for (const auto& collection : bytes) {
+        total_bytes += collection.total_bytes;
+        zip_bytes += collection.zip_bytes;
+    }
+    std::sort(bytes.begin(), bytes.end(), [](const auto& a, const auto& b) { return a.zip_bytes > b.zip_bytes; });
+    const std::size_t shown = std::min<std::size_t>(bytes.size(), 20);
+    m_log->info("Largest {} of the {} collections written, {:.1f} MB compressed {:.2f} times:", shown, bytes.size(),
+                zip_bytes / 1e6, zip_bytes == 0 ? 0. : double(total_bytes) / zip_bytes);
+    m_log->info("{:>10} {:>10} {:>7}  {}", "zip [MB]", "raw [MB]", "ratio", "collection");
+    for (std::size_t i = 0; i < shown; ++i) {
+        const auto& collection = bytes[i];
+        m_log->info("{:10.3f} {:10.3f} {:7.2f}  {}", collection.zip_bytes / 1e6, collection.total_bytes / 1e6,
+                    collection.zip_bytes == 0 ? 0. : double(collection.total_bytes) / collection.zip_bytes,
+                    collection.collection);
+    }
 }
 
 void JEventProcessorPODIO::Finish() {
@@ -526,5 +1039,54 @@ void JEventProcessorPODIO::Finish() {
       std::this_thread::sleep_for(10s);
     }
 
-    m_writer->finish();
+    if (m_write_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_write_mutex);
+            m_write_done = true;
+        }
+        m_write_not_empty.notify_all();
+        m_write_thread.join();
+        if (m_write_error) {
+            m_log->error("The asynchronous writer stopped on an error, {} is incomplete", m_output_file);
+        }
+        if (m_ordered_write && m_reorder_frames > 0) {
+            m_log->info("podio:ordered_write: {:.1f} of {} frames in the reorder buffer on average, at most {}; "
+                        "{} events waited for room, {:.1f} ms in total",
+                        double(m_reorder_occupancy) / m_reorder_frames, m_write_queue_depth, m_reorder_max_occupancy,
+                        m_reorder_stalls, std::chrono::duration<double, std::milli>(m_reorder_stall_time).count());
+        }
+    }
+
+    if (m_checkpoint_writer) {
+        m_checkpoint_writer->finish(*m_log);
+    }
+    if (m_sharded_writer) {
+        m_sharded_writer->finish(*eicrecon::PodioShardedWriter::ParseMerge(m_output_merge), *m_log);
+    }
+    // the parameters of the job, against which reco:reuse_input_collections checks the factories
+    // upstream of the collections that it reuses; all factories that ran are initialised by now
+    podio::Frame configuration;
+    for (const auto& [key, param] : GetApplication()->GetJParameterManager()->GetAllParameters()) {
+        configuration.putParameter(key, param->GetValue());
+    }
+    for (auto& writer : m_writers) {
+        PrintCompression(writer->collectionBytes(m_collections_to_write));
+        const auto events = writer->frames();
+        writer->writeFrame(configuration, eicrecon::PodioConfigurationCategory, {});
+        writer->finish();
+        std::error_code ec;
+        const auto bytes = std::filesystem::file_size(writer->filename(), ec);
+        const double ms_per_frame = events == 0 ? 0. : writer->write_ns() * 1e-6 / events;
+        m_log->info("Wrote {} events to {} ({}): {:.1f} MB, {:.3f} ms per event", events, writer->filename(),
+                    eicrecon::PodioFormatName(writer->format()), ec ? 0. : bytes / 1e6, ms_per_frame);
+    }
+
+    if (m_filter) {
+        const std::uint64_t events = m_filter_passed + m_filter_failed;
+        m_log->info("{} of {} events ({:.1f}%) passed the filter '{}'", m_filter_passed.load(), events,
+                    events == 0 ? 0. : 100. * m_filter_passed / events, m_filter->expression());
+    }
+    if (m_memory_report && m_print_memory_report) {
+        m_memory_report->Print(*m_log);
+    }
 }
@@ -3,14 +3,29 @@
 
 #include <JANA/JEvent.h>
 #include <JANA/JEventProcessor.h>
-#include <podio/ROOTFrameWriter.h>
+#include <podio/Frame.h>
 #include <spdlog/logger.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "PodioCheckpoint.h"
+#include "PodioEventFilter.h"
+#include "PodioFrameIO.h"
+#include "PodioMemoryReport.h"
+#include "PodioShardedWriter.h"
+
 
 class JEventProcessorPODIO : public JEventProcessor {
 
@@ -19,24 +34,101 @@ public:
     JEventProcessorPODIO();
     virtual ~JEventProcessorPODIO() = default;
 
+    /// The frame of an event, shared with it, for the writer thread of podio:async_write, without a
+    /// frame for the positions of podio:ordered_write that are not written
+    struct PendingFrame {
+        std::shared_ptr<const podio::Frame> frame;
+        std::shared_ptr<const void> keep_alive;  // see eicrecon::PodioSharedFrame
+        std::vector<std::string> collections;
+        const void* slot = nullptr;
+        std::uint64_t event_number = 0;
+    };
+
     void Init() override;
     void Process(const std::shared_ptr<const JEvent>& event) override;
     void Finish() override;
 
     void FindCollectionsToWrite(const std::shared_ptr<const JEvent>& event);
 
-    std::unique_ptr<podio::ROOTFrameWriter> m_writer;
+    /// Drops the collections that failed in an event from m_collections_to_write, m_mutex must be held
+    void RemoveFailedCollections(const std::vector<std::string>& failed_now, const std::vector<std::string>& messages);
+
+    /// Body of the writer thread of podio:async_write
+    void WriteLoop();
+
+    void RethrowWriteError();
+
+    /// Puts a frame into the reorder buffer of podio:ordered_write, m_write_mutex must be held by lock.
+    /// Only the calling event waits, while the buffer has no room for its position. Events without a
+    /// position, from sources that do not insert it, get the next one in the order of arrival
+    void QueueOrdered(std::unique_lock<std::mutex>& lock, std::optional<std::uint64_t> sequence, PendingFrame pending);
+
+    /// Prints the bytes and compression ratio of the largest collections of a TTree output
+    void PrintCompression(std::vector<eicrecon::PodioCollectionBytes> bytes);
+
+    /// Warns about the subset collections whose parent collections are not written, once
+    void CheckSubsetCollections(const podio::Frame& frame, const std::vector<std::string>& collections);
+
+    /// Adds the collections of a written frame to m_memory_report, if any
+    void AccountFrame(const void* slot, std::uint64_t event_number, const podio::Frame& frame);
+
+    /// Writes the frame with every writer of podio:output_format
+    void WriteFrame(const podio::Frame& frame, const std::vector<std::string>& collections);
+
+    std::vector<std::unique_ptr<eicrecon::PodioFrameWriter>> m_writers;  // one per podio:output_format
+    std::unique_ptr<eicrecon::PodioShardedWriter> m_sharded_writer;     // with podio:output_shards, instead of m_writers
+    size_t m_output_shards = 0;                                         // config. parameter
+    std::unique_ptr<eicrecon::PodioCheckpointWriter> m_checkpoint_writer; // with podio:checkpoint_events, instead of m_writers
+    size_t m_checkpoint_events = 0;                                     // config. parameter
+    std::string m_checkpoint_manifest;                                  // config. parameter
+    std::string m_resume_from;                                          // config. parameter
+    std::string m_output_merge = "ordered";                             // config. parameter
+    std::string m_compression_algorithm;                                // config. parameter, ROOT's default if empty
+    eicrecon::PodioWriteTuning m_write_tuning;                          // config. parameters
     std::mutex m_mutex;
     bool m_is_first_event = true;
+    std::atomic<bool> m_subsets_checked{false};
     bool m_user_included_collections = false;
     std::shared_ptr<spdlog::logger> m_log;
     bool m_output_include_collections_set = false;
 
     std::string m_output_file = "podio_output.root";
     std::string m_output_file_copy_dir = "";
+    std::vector<std::string> m_output_formats = {"ttree"};  // config. parameter
     std::set<std::string> m_output_collections;  // config. parameter
     std::set<std::string> m_output_exclude_collections;  // config. parameter
     std::vector<std::string> m_collections_to_write;  // derived from above config. parameters
     std::vector<std::string> m_collections_to_print;
+    std::set<std::string> m_failed_collections;
+    std::unique_ptr<PodioMemoryReport> m_memory_report;  // with podio:memory_report or podio:memory_limit_mb
+    bool m_print_memory_report = false;  // with podio:memory_report
+    bool m_observe_event_bytes = false;  // for the PodioEventPoolController of podio:memory_limit_mb
+    std::string m_filter_expression;  // config. parameter
+    std::unique_ptr<PodioEventFilter> m_filter;  // with podio:filter
+    std::atomic<std::uint64_t> m_filter_passed{0};
+    std::atomic<std::uint64_t> m_filter_failed{0};
+
+    // With podio:async_write > 0, the frames are shared with the events and written by m_write_thread
+    size_t m_write_queue_depth = 0;
+    std::thread m_write_thread;
+    std::mutex m_write_mutex;
+    std::condition_variable m_write_not_empty;
+    std::condition_variable m_write_not_full;
+    std::deque<PendingFrame> m_write_queue;
+    std::exception_ptr m_write_error;
+    bool m_write_done = false;
+
+    // With podio:ordered_write, m_write_queue is replaced by a buffer of at most podio:async_write
+    // positions from m_reorder_next on, which the writer thread empties in order
+    bool m_ordered_write = false;  // config. parameter
+    std::map<std::uint64_t, PendingFrame> m_reorder_buffer;
+    std::uint64_t m_reorder_next = 0;
+    std::uint64_t m_unsequenced = 0;  // positions of the events without eicrecon::PodioEventSequence
+    bool m_unsequenced_warned = false;
+    std::uint64_t m_reorder_frames = 0;
+    std::uint64_t m_reorder_occupancy = 0;  // sum of the frames in the buffer when a frame is added
+    size_t m_reorder_max_occupancy = 0;
+    std::uint64_t m_reorder_stalls = 0;
+    std::chrono::steady_clock::duration m_reorder_stall_time{0};
 
 };
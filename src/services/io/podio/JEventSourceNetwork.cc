@@ -0,0 +1,315 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "JEventSourceNetwork.h"
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JException.h>
+#include <JANA/JLogger.h>
+#include <JANA/Services/JParameterManager.h>
+#include <JANA/Utils/JTypeInfo.h>
+#include <edm4eic/RawTrackerHitCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
+#include <edm4hep/RawCalorimeterHitCollection.h>
+#include <fmt/core.h>
+#include <netdb.h>
+#include <podio/Frame.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+#include "NetworkHitBlocks.h"
+#include "PodioSharedFrame.h"
+
+namespace {
+
+    /// Connects to "host:port", retrying until the timeout, -1 if it is not reached
+    int ConnectTo(const std::string& endpoint, double timeout, std::string& error) {
+        const auto colon = endpoint.rfind(':');
+        if( colon == std::string::npos || colon == 0 || colon + 1 == endpoint.size() ){
+            error = "expected host:port";
+            return -1;
+        }
+        const std::string host = endpoint.substr(0, colon);
+        const std::string port = endpoint.substr(colon + 1);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+        while( true ){
+            addrinfo hints{};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo* addresses = nullptr;
+            if( const int status = getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses); status != 0 ){
+                error = gai_strerror(status);
+                return -1;
+            }
+            for (addrinfo* address = addresses; address != nullptr; address = address->ai_next) {
+                const int fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+                if( fd < 0 ) continue;
+                if( connect(fd, address->ai_addr, address->ai_addrlen) == 0 ){
+                    freeaddrinfo(addresses);
+                    return fd;
+                }
+                error = std::strerror(errno);
+                ::close(fd);
+            }
+            freeaddrinfo(addresses);
+            // the senders of a run may start after the reconstruction
+            if( std::chrono::steady_clock::now() >= deadline ) return -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+    }
+
+    /// Reads exactly bytes bytes, false at the end of the stream or on an error
+    bool ReadAll(int fd, void* data, size_t bytes) {
+        auto* position = static_cast<std::byte*>(data);
+        while( bytes > 0 ){
+            const ssize_t n = recv(fd, position, bytes, 0);
+            if( n < 0 && errno == EINTR ) continue;
+            if( n <= 0 ) return false;
+            position += n;
+            bytes -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    /// Puts the hits of a block into a new collection of the frame, and into the event
+    template <typename CollectionT>
+    void InsertBlock(podio::Frame& frame, JEvent& event, const eicrecon::NetworkHitBlock& block) {
+        CollectionT hits;
+        for (size_t i = 0; i < block.size(); ++i) {
+            const auto hit = block[i];
+            hits.create(hit.cellID, hit.value, hit.timeStamp);
+        }
+        const std::string name(block.name);
+        const auto& stored = frame.put(std::move(hits), name);
+        event.InsertCollectionAlreadyInFrame<typename CollectionT::value_type>(&stored, name);
+    }
+
+}
+
+
+//------------------------------------------------------------------------------
+// Constructor
+//
+/// \param resource_name  "tcp://host:port,host:port,...", nothing is connected before Open()
+/// \param app            JApplication
+//------------------------------------------------------------------------------
+JEventSourceNetwork::JEventSourceNetwork(std::string resource_name, JApplication* app) : JEventSource(resource_name, app) {
+    SetTypeName(NAME_OF_THIS); // Provide JANA with class name
+
+    GetApplication()->SetDefaultParameter(
+            "net:buffer_events",
+            m_buffer_events,
+            "number of received events queued for the workers, the senders are held back when it is full"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "net:max_message_bytes",
+            m_max_message_bytes,
+            "largest event message accepted from a sender, larger ones close the connection"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "net:connect_timeout",
+            m_connect_timeout,
+            "seconds to wait for every sender to accept the connection"
+            );
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+JEventSourceNetwork::~JEventSourceNetwork() {
+    Stop();
+}
+
+//------------------------------------------------------------------------------
+// Open
+//
+/// Connect to all the senders of the resource name and start their receiving
+/// threads.
+//------------------------------------------------------------------------------
+void JEventSourceNetwork::Open() {
+
+    std::vector<std::string> endpoints;
+    JParameterManager::Parse(GetResourceName().substr(std::string("tcp://").size()), endpoints);
+    if( endpoints.empty() ){
+        throw JException("The network source \"%s\" has no host:port to connect to", GetResourceName().c_str());
+    }
+    if( m_buffer_events == 0 ){
+        throw JException("net:buffer_events must be at least 1");
+    }
+
+    for (const auto& endpoint : endpoints) {
+        std::string error;
+        const int fd = ConnectTo(endpoint, m_connect_timeout, error);
+        if( fd < 0 ){
+            Stop();
+            throw JException(fmt::format("Can not connect to {}: {}", endpoint, error));
+        }
+        m_connections.push_back({endpoint, fd, {}, 0});
+    }
+    m_receiving = m_connections.size();
+    for (auto& connection : m_connections) {
+        connection.thread = std::thread(&JEventSourceNetwork::Receive, this, std::ref(connection));
+    }
+
+    LOG << "Receiving events from " << m_connections.size() << " senders of \"" << GetResourceName()
+        << "\", with up to " << m_buffer_events << " events queued" << LOG_END;
+}
+
+//------------------------------------------------------------------------------
+// Receive
+//
+/// Read the messages of a connection into the queue, waiting while it is full
+/// so that the sender is held back by TCP flow control.
+//------------------------------------------------------------------------------
+void JEventSourceNetwork::Receive(Connection& connection) {
+
+    std::string ended = "closed by the sender";
+    while( true ){
+        std::uint32_t length = 0;
+        if( !ReadAll(connection.socket, &length, sizeof(length)) ){
+            ended = "lost";
+            break;
+        }
+        if( length == 0 ) break; // end of the stream
+        if( length > m_max_message_bytes ){
+            ended = fmt::format("closed after a message of {} bytes, more than net:max_message_bytes", length);
+            break;
+        }
+        std::vector<std::byte> message(length);
+        if( !ReadAll(connection.socket, message.data(), message.size()) ){
+            ended = "lost in a message";
+            break;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_full.wait(lock, [this]{ return m_queue.size() < m_buffer_events || m_stop; });
+        if( m_stop ) break;
+        m_queue.push_back(std::move(message));
+        ++connection.messages;
+        m_not_empty.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if( !m_stop ){
+        LOG << "Connection to " << connection.endpoint << " " << ended << ", after " << connection.messages << " events" << LOG_END;
+    }
+    --m_receiving;
+    m_not_empty.notify_all();
+}
+
+//------------------------------------------------------------------------------
+// GetEvent
+//
+/// Make the next queued message an event, with a collection for each of its
+/// hit blocks and an EventHeader. While the senders are connected but no
+/// message is queued, JANA is asked to try again.
+///
+/// \param event
+//------------------------------------------------------------------------------
+void JEventSourceNetwork::GetEvent(std::shared_ptr<JEvent> event) {
+
+    std::vector<std::byte> message;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_empty.wait_for(lock, std::chrono::milliseconds(100), [this]{ return !m_queue.empty() || m_receiving == 0; });
+        if( m_queue.empty() ){
+            if( m_receiving > 0 ) throw RETURN_STATUS::kTRY_AGAIN;
+            throw RETURN_STATUS::kNO_MORE_EVENTS;
+        }
+        message = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_not_full.notify_one();
+    }
+
+    eicrecon::NetworkEvent received;
+    try {
+        received = eicrecon::NetworkEvent::decode(message);
+    }
+    catch(std::runtime_error& e) {
+        throw JException(fmt::format("{}: {}", GetResourceName(), e.what()));
+    }
+    ++m_events;
+    event->SetEventNumber(received.event_number);
+    event->SetRunNumber(received.run_number);
+
+    auto frame = std::make_unique<podio::Frame>();
+    for (const auto& block : received.blocks) {
+        if( block.kind == eicrecon::NetworkHitKind::RawTrackerHit ){
+            InsertBlock<edm4eic::RawTrackerHitCollection>(*frame, *event, block);
+        } else {
+            InsertBlock<edm4hep::RawCalorimeterHitCollection>(*frame, *event, block);
+        }
+    }
+
+    edm4hep::EventHeaderCollection headers;
+    auto header = headers.create();
+    header.setEventNumber(received.event_number);
+    header.setRunNumber(received.run_number);
+    header.setTimeStamp(received.time_stamp);
+    const auto& stored_headers = frame->put(std::move(headers), "EventHeader");
+    event->InsertCollectionAlreadyInFrame<edm4hep::EventHeader>(&stored_headers, "EventHeader");
+
+    eicrecon::InsertSharedFrame(*event, std::move(frame));
+}
+
+//------------------------------------------------------------------------------
+// Close
+//------------------------------------------------------------------------------
+void JEventSourceNetwork::Close() {
+    LOG << "Closing the network source \"" << GetResourceName() << "\" after " << m_events << " events" << LOG_END;
+    Stop();
+}
+
+//------------------------------------------------------------------------------
+// Stop
+//
+/// Wake up and join the receiving threads, and close the connections.
+//------------------------------------------------------------------------------
+void JEventSourceNetwork::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_not_full.notify_all();
+    for (auto& connection : m_connections) {
+        // ends a blocking recv of the thread
+        if( connection.socket >= 0 ) shutdown(connection.socket, SHUT_RDWR);
+    }
+    for (auto& connection : m_connections) {
+        if( connection.thread.joinable() ) connection.thread.join();
+        if( connection.socket >= 0 ) ::close(connection.socket);
+        connection.socket = -1;
+    }
+    m_connections.clear();
+}
+
+//------------------------------------------------------------------------------
+// GetDescription
+//------------------------------------------------------------------------------
+std::string JEventSourceNetwork::GetDescription() {
+
+    /// GetDescription() helps JANA explain to the user what is going on
+    return "Raw hit blocks of a live DAQ stream over TCP";
+}
+
+//------------------------------------------------------------------------------
+// CheckOpenable
+//
+/// Return a value from 0-1 indicating probability that this source will be
+/// able to read this resource: all the "tcp://" ones.
+///
+/// \param resource_name name of the resource to evaluate.
+/// \return              value from 0-1 indicating confidence that this source can open the given resource
+//------------------------------------------------------------------------------
+template <>
+double JEventSourceGeneratorT<JEventSourceNetwork>::CheckOpenable(std::string resource_name) {
+    return resource_name.rfind("tcp://", 0) == 0 ? 1.0 : 0.0;
+}
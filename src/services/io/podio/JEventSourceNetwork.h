@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JEventSource.h>
+#include <JANA/JEventSourceGeneratorT.h>
+#include <stddef.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Event source of a live DAQ stream, for test beams and online monitoring:
+ * `eicrecon tcp://daq1:5555,daq2:5555` connects to every sender of the list
+ * and reads eicrecon::NetworkEvent messages of raw hit blocks from them.
+ *
+ * Every connection has its own receiving thread, which reads each message
+ * into one buffer, the only copy before the hits are put into their
+ * collections by GetEvent. The messages of all the connections share a queue
+ * of `net:buffer_events`; when it is full, the receiving threads stop
+ * reading, and TCP flow control holds back the senders. The event run and
+ * event numbers are the ones of the messages. The source ends when all the
+ * senders have closed their streams.
+ */
+class JEventSourceNetwork : public JEventSource {
+
+public:
+    JEventSourceNetwork(std::string resource_name, JApplication* app);
+
+    virtual ~JEventSourceNetwork();
+
+    void Open() override;
+
+    void Close() override;
+
+    void GetEvent(std::shared_ptr<JEvent>) override;
+
+    static std::string GetDescription();
+
+protected:
+    struct Connection {
+        std::string endpoint;
+        int socket = -1;
+        std::thread thread;
+        std::uint64_t messages = 0;
+    };
+
+    /// Body of the receiving thread of a connection
+    void Receive(Connection& connection);
+
+    void Stop();
+
+    size_t m_buffer_events = 64;
+    size_t m_max_message_bytes = 64 << 20;
+    double m_connect_timeout = 10; // s
+
+    std::deque<Connection> m_connections; // not moved by the threads that refer to them
+    std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    std::deque<std::vector<std::byte>> m_queue;
+    size_t m_receiving = 0;
+    bool m_stop = false;
+    std::uint64_t m_events = 0;
+};
+
+template <>
+double JEventSourceGeneratorT<JEventSourceNetwork>::CheckOpenable(std::string);
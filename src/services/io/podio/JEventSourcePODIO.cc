@@ -10,28 +10,47 @@
 #include <JANA/JApplication.h>
 #include <JANA/JEvent.h>
 #include <JANA/JException.h>
+#include <JANA/JFactorySet.h>
 #include <JANA/JLogger.h>
+#include <JANA/Podio/JFactoryPodioT.h>
+#include <JANA/Services/JParameterManager.h>
 #include <JANA/Utils/JTypeInfo.h>
 #include <TFile.h>
-#include <TObject.h>
+#include <TKey.h>
+#include <TROOT.h>
+#include <TTree.h>
 #include <fmt/color.h>
 #include <fmt/core.h>
 #include <fmt/format.h>
+#include <edm4hep/SimCalorimeterHitCollection.h>
+#include <edm4hep/SimTrackerHitCollection.h>
 #include <podio/CollectionBase.h>
 #include <podio/Frame.h>
 #include <podio/podioVersion.h>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <cstdlib>
+#include <deque>
 #include <exception>
 #include <filesystem>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
+#include "PodioEventIndex.h"
+#include "PodioEventPoolController.h"
+#include "PodioSharedFrame.h"
+#include "extensions/jana/JOmniFactoryPruning.h"
 // These files are generated automatically by make_datamodel_glue.py
 #include "services/io/podio/datamodel_glue.h"
 #include "services/io/podio/datamodel_includes.h" // IWYU pragma: keep
+#include "services/log/TraceRange.h"
 
 
 //------------------------------------------------------------------------------
@@ -60,6 +79,158 @@ struct InsertingVisitor {
 };
 
 
+//------------------------------------------------------------------------------
+// FrameCollectionFactory
+//
+/// JANA factory of a collection of the input frame of the event. Instead of
+/// GetEvent inserting the collection, the factory takes it from the frame when
+/// it is first requested, so that the collections that are not used cost
+/// nothing. An entry without the collection gives an empty one.
+/// The factories are added once to every factory set by ExposingVisitor.
+///
+/// \param collection_name   name of the collection, which is the factory tag
+//------------------------------------------------------------------------------
+template <typename T>
+class FrameCollectionFactory : public JFactoryPodioT<T> {
+public:
+    explicit FrameCollectionFactory(const std::string& collection_name) {
+        this->SetTag(collection_name);
+    }
+
+    void Process(const std::shared_ptr<const JEvent>& event) override {
+        // the frame of the entry is inserted first, before the one of the background
+        const auto frames = event->Get<podio::Frame>();
+        if (frames.empty()) return;
+        const auto* collection = dynamic_cast<const typename PodioTypeMap<T>::collection_t*>(frames[0]->get(this->GetTag()));
+        if (collection != nullptr) {
+            this->SetCollectionAlreadyInFrame(collection);
+        }
+    }
+};
+
+
+//------------------------------------------------------------------------------
+// ExposingVisitor
+//
+/// This datamodel visitor adds a FrameCollectionFactory of a collection to a
+/// factory set, unless the set already has a factory of that name, e.g. of a
+/// collection that is reconstructed again. Such collections are still
+/// inserted by GetEvent.
+///
+/// \param factory_set       factory set of a JEvent
+/// \param collection_name   name of the collection which will be used as the factory tag
+//------------------------------------------------------------------------------
+struct ExposingVisitor {
+    JFactorySet& m_factory_set;
+    const std::string& m_collection_name;
+    bool added = false;
+
+    ExposingVisitor(JFactorySet& factory_set, const std::string& collection_name) : m_factory_set(factory_set), m_collection_name(collection_name){};
+
+    template <typename T>
+    void operator() (const T& collection) {
+
+        using ContentsT = decltype(collection[0]);
+        if (m_factory_set.GetFactory<ContentsT>(m_collection_name) != nullptr) return;
+        m_factory_set.Add(new FrameCollectionFactory<ContentsT>(m_collection_name));
+        added = true;
+    }
+};
+
+
+//------------------------------------------------------------------------------
+// CloningVisitor
+//
+/// This datamodel visitor puts clones of the objects of a PODIO collection into
+/// a new collection of the frame of a JEvent, and inserts that into the JEvent.
+/// The relations of the clones still point at the objects of the original
+/// collections, which must outlive the event. CloningVisitor is called in
+/// GetReplayEvent()
+///
+/// \param frame             frame of the JEvent, which owns the new collection
+/// \param event             JANA JEvent to insert the new collection into
+/// \param collection_name   name of the collection which will be used as the factory tag for these objects
+//------------------------------------------------------------------------------
+struct CloningVisitor {
+    podio::Frame& m_frame;
+    JEvent& m_event;
+    const std::string& m_collection_name;
+
+    CloningVisitor(podio::Frame& frame, JEvent& event, const std::string& collection_name) : m_frame(frame), m_event(event), m_collection_name(collection_name){};
+
+    template <typename T>
+    void operator() (const T& collection) {
+
+        using ContentsT = decltype(collection[0]);
+        T clone;
+        for (const auto& object : collection) clone.push_back(object.clone());
+        const auto& stored = m_frame.put(std::move(clone), m_collection_name);
+        m_event.InsertCollectionAlreadyInFrame<ContentsT>(&stored, m_collection_name);
+    }
+};
+
+
+namespace {
+
+    /// The sources of all the input files, for podio:parallel_files
+    std::mutex g_sources_mutex;
+    std::vector<JEventSourcePODIO*> g_sources;
+
+    /// Entry numbers at which the ROOT clusters of the "events" tree start, followed by the number of entries
+    std::vector<size_t> ClusterStarts(const std::string& filename) {
+        std::vector<size_t> starts;
+        std::unique_ptr<TFile> file{TFile::Open(filename.c_str())};
+        auto* tree = (file == nullptr) ? nullptr : file->Get<TTree>("events");
+        if (tree == nullptr) return starts;
+        auto clusters = tree->GetClusterIterator(0);
+        for (Long64_t start = clusters(); start < tree->GetEntries(); start = clusters()) {
+            starts.push_back(static_cast<size_t>(start));
+        }
+        starts.push_back(static_cast<size_t>(tree->GetEntries()));
+        return starts;
+    }
+
+    /// Number of the sim hits of the collections of an unpacked frame, as the cost of its event
+    size_t SimHitCount(const podio::Frame& frame, const std::vector<std::string>& collections) {
+        size_t hits = 0;
+        for (const std::string& coll_name : collections.empty() ? frame.getAvailableCollections() : collections) {
+            const podio::CollectionBase* collection = frame.get(coll_name);
+            if( dynamic_cast<const edm4hep::SimTrackerHitCollection*>(collection) != nullptr ||
+                dynamic_cast<const edm4hep::SimCalorimeterHitCollection*>(collection) != nullptr ){
+                hits += collection->size();
+            }
+        }
+        return hits;
+    }
+
+    /// Adds the collections that the collections of an unpacked frame point to through their relations,
+    /// transitively, to collections
+    void AddRelationTargets(const podio::Frame& frame, std::set<std::string>& collections) {
+        std::map<std::uint32_t, std::string> names;
+        for (const std::string& coll_name : frame.getAvailableCollections()) {
+            if (const auto* collection = frame.get(coll_name)) names[collection->getID()] = coll_name;
+        }
+        std::deque<std::string> pending(collections.begin(), collections.end());
+        while( !pending.empty() ){
+            const podio::CollectionBase* collection = frame.get(pending.front());
+            pending.pop_front();
+            if( collection == nullptr ) continue;
+            // the write buffers hold the object IDs of the related objects in their collections
+            collection->prepareForWrite();
+            auto buffers = const_cast<podio::CollectionBase*>(collection)->getBuffers();
+            if( buffers.references == nullptr ) continue;
+            for (const auto& references : *buffers.references) {
+                for (const auto& id : *references) {
+                    const auto target = names.find(id.collectionID);
+                    if( target != names.end() && collections.insert(target->second).second ) pending.push_back(target->second);
+                }
+            }
+        }
+    }
+
+}
+
+
 //------------------------------------------------------------------------------
 // Constructor
 //
@@ -80,6 +251,115 @@ JEventSourcePODIO::JEventSourcePODIO(std::string resource_name, JApplication* ap
             "set to true to recycle through events continuously"
             );
 
+    GetApplication()->SetDefaultParameter(
+            "podio:replay_cache",
+            m_replay_cache_size,
+            "number of entries read into memory once and handed out round-robin, so that the file is not read while processing (0 disables it)"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:replay_mode",
+            m_replay_mode,
+            "how podio:replay_cache hands out its frames: shallow (the cached collections themselves, read-only and not writable) or clone (copies in the frame of the event)"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:prefetch",
+            m_prefetch_depth,
+            "number of entries read and unpacked ahead by a background thread (0 reads on the thread of GetEvent)"
+            );
+
+    int implicit_mt = 0;
+    GetApplication()->SetDefaultParameter(
+            "podio:root_implicit_mt",
+            implicit_mt,
+            "number of ROOT implicit multi-threading threads, which decompress the baskets of an entry in parallel (0 disables it)"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:input_include_collections",
+            m_include_collections_str,
+            "comma separated list of the collections to read (empty reads all)"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:input_exclude_collections",
+            m_exclude_collections_str,
+            "comma separated list of the collections not to read"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:input_from_outputs",
+            m_input_from_outputs,
+            "only read the collections that the factories of podio:output_collections and omnifactory:KeepCollections need"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:shard",
+            m_shard_str,
+            "read only the shard K of N of every file, as \"K/N\" with 0 <= K < N, split at ROOT cluster boundaries"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:entry_ranges",
+            m_entry_ranges_str,
+            "read only these entries of every file, as a comma separated list of \"first-last\" ranges"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:event_list",
+            m_event_list_str,
+            "read only these events of every file, as a comma separated list of \"event\" or \"run:event\", or \"@file\" with one per line, found with the event index <file>.evindex"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:checkpoint_events",
+            m_checkpoint_events,
+            "Close a numbered output chunk <stem>.chunk<k>.root every N events and list it in podio:checkpoint_manifest, so that a stopped job can be resumed with jana:resume_from (0 writes a single file)."
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:input_entries",
+            m_input_entries,
+            "insert the input file and entry of every event as an eicrecon::PodioInputEntry, which podio:checkpoint_events does as well"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:ordered_write",
+            m_ordered_write,
+            "write the events in the order of the input, through a reorder buffer of podio:async_write frames in front of the writer"
+            );
+    if( m_ordered_write && GetApplication()->GetJParameterManager()->Exists("jana:nskip") ){
+        m_nskip = GetApplication()->GetParameterValue<std::uint64_t>("jana:nskip");
+    }
+
+    GetApplication()->SetDefaultParameter(
+            "jana:resume_from",
+            m_resume_from,
+            "Manifest of a stopped job with podio:checkpoint_events: its chunks are kept, and only the input entries that are not in them are processed."
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:memory_limit_mb",
+            m_memory_limit_mb,
+            "hold the events in flight below this resident set size, adapting their number to the RSS and the live bytes per event (0 leaves it to jana:nevents_in_pool)"
+            );
+    if( m_memory_limit_mb > 0 ){
+        eicrecon::PodioEventPoolController::instance().configure(m_memory_limit_mb << 20);
+    }
+
+    GetApplication()->SetDefaultParameter(
+            "podio:reorder_window",
+            m_reorder_window,
+            "number of entries held back to hand out the one with the most sim hits first, so that the large events do not end the job (0 keeps the order of the file)"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:parallel_files",
+            m_parallel_files,
+            "read all the input files at the same time, each by its own prefetch thread, into the queue of the first source"
+            );
+
     bool print_type_table = false;
     GetApplication()->SetDefaultParameter(
             "podio:print_type_table",
@@ -87,43 +367,119 @@ JEventSourcePODIO::JEventSourcePODIO(std::string resource_name, JApplication* ap
             "Print list of collection names and their types"
             );
 
-    // Hopefully we won't need to reimplement background event merging. Using podio frames, it looks like we would
-    // have to do a deep copy of all data in order to insert it into the same frame, which would probably be
-    // quite inefficient.
-    /*
-    std::string background_filename;
     GetApplication()->SetDefaultParameter(
-            "podio:background_filename",
-            background_filename,
-            "Name of file containing background events to merge in (default is not to merge any background)"
+            "podio:background_files",
+            m_background_files_str,
+            "comma separated list of podio files of background events to mix into every event (default is not to mix any background)"
             );
 
-    int num_background_events=1;
     GetApplication()->SetDefaultParameter(
-            "podio:num_background_events",
-            num_background_events,
-            "Number of background events to add to every primary event."
-    );
-    */
+            "podio:background_rates",
+            m_background_rates_str,
+            "comma separated list of the rates of the podio:background_files in Hz"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:background_time_window",
+            m_background_time_window,
+            "time window in ns over which the background events of every event are spread"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:background_cache",
+            m_background_cache_size,
+            "number of entries of every background file read into memory once and reused"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:background_collections",
+            m_background_collections_str,
+            "comma separated list of the SimTrackerHit and SimCalorimeterHit collections to mix (empty mixes all of them)"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:background_seed",
+            m_background_seed,
+            "seed of the random numbers of the background mixing"
+            );
+
+    std::lock_guard<std::mutex> lock(g_sources_mutex);
+    g_sources.push_back(this);
 }
 
 //------------------------------------------------------------------------------
 // Destructor
 //------------------------------------------------------------------------------
 JEventSourcePODIO::~JEventSourcePODIO() {
+    StopPrefetch();
+    {
+        // the prefetch threads of the source that absorbed this one read from m_reader
+        std::lock_guard<std::mutex> lock(g_sources_mutex);
+        if( m_absorbed_by != nullptr ) m_absorbed_by->StopPrefetch();
+        for (auto* source : g_sources) {
+            if( source->m_absorbed_by == this ) source->m_absorbed_by = nullptr;
+        }
+        g_sources.erase(std::remove(g_sources.begin(), g_sources.end(), this), g_sources.end());
+    }
     LOG << "Closing Event Source for " << GetResourceName() << LOG_END;
 }
 
 //------------------------------------------------------------------------------
 // Open
 //
-/// Open the root file and read in metadata.
+/// Open the root file and read in metadata. With podio:parallel_files, the
+/// first source to be opened also opens the files of all the other sources
+/// and reads them concurrently, one prefetch thread per file, into its own
+/// queue. The other sources then have no events of their own.
 //------------------------------------------------------------------------------
 void JEventSourcePODIO::Open() {
 
+    {
+        std::lock_guard<std::mutex> lock(g_sources_mutex);
+        if( m_absorbed_by != nullptr || m_opened ) return;
+    }
+    if( m_prefetch_depth > 0 || m_parallel_files ){
+        // the readers of the files and the writer run on different threads
+        ROOT::EnableThreadSafety();
+    }
+    OpenFile();
+    OpenBackground();
+    if( m_replay_cache_size > 0 ){
+        LoadReplayCache();
+        return;
+    }
+
+    std::vector<JEventSourcePODIO*> inputs{this};
+    if( m_parallel_files ){
+        std::lock_guard<std::mutex> lock(g_sources_mutex);
+        for (auto* source : g_sources) {
+            if( source != this && !source->m_opened && source->GetApplication() == GetApplication() ){
+                source->m_absorbed_by = this;
+                inputs.push_back(source);
+            }
+        }
+    }
+    for (size_t i = 1; i < inputs.size(); ++i) inputs[i]->OpenFile();
+
+    if( inputs.size() > 1 && m_prefetch_depth == 0 ) m_prefetch_depth = 2 * inputs.size();
+    if( m_prefetch_depth > 0 ){
+        LOG << "Prefetching up to " << m_prefetch_depth << " events from " << inputs.size() << " file(s)" << LOG_END;
+        m_prefetch_running = inputs.size();
+        for (auto* input : inputs) {
+            m_prefetch_threads.emplace_back(&JEventSourcePODIO::Prefetch, this, input);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// OpenFile
+//
+/// Open the file of this source and choose its collections and entries.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::OpenFile() {
+
     bool print_type_table = GetApplication()->GetParameterValue<bool>("podio:print_type_table");
-    // std::string background_filename = GetApplication()->GetParameterValue<std::string>("podio:background_filename");;
-    // int num_background_events = GetApplication()->GetParameterValue<int>("podio:num_background_events");;
+    int implicit_mt = GetApplication()->GetParameterValue<int>("podio:root_implicit_mt");
 
     // Open primary events file
     try {
@@ -139,6 +495,10 @@ void JEventSourcePODIO::Open() {
             std::_Exit(EXIT_FAILURE);
         }
 
+        if( implicit_mt > 0 && !ROOT::IsImplicitMTEnabled() ){
+            ROOT::EnableImplicitMT(implicit_mt);
+        }
+
         m_reader.openFile( GetResourceName() );
 
         auto version = m_reader.currentFileVersion();
@@ -154,10 +514,15 @@ void JEventSourcePODIO::Open() {
         LOG << "PODIO version: file=" << version << " (executable=" << podio::version::build_version << ")" << LOG_END;
 
         Nevents_in_file = m_reader.getEntries("events");
-        LOG << "Opened PODIO Frame file \"" << GetResourceName() << "\" with " << Nevents_in_file << " events" << LOG_END;
+        LOG << "Opened PODIO Frame file \"" << GetResourceName() << "\" with " << Nevents_in_file << " events ("
+            << eicrecon::PodioFormatName(m_reader.format()) << ")" << LOG_END;
 
         if( print_type_table ) PrintCollectionTypeTable();
 
+        SelectCollections();
+        SelectEntries();
+        m_opened = true;
+
     }catch (std::exception &e ){
         LOG_ERROR(default_cerr_logger) << e.what() << LOG_END;
         throw JException( fmt::format( "Problem opening file \"{}\"", GetResourceName() ) );
@@ -165,6 +530,49 @@ void JEventSourcePODIO::Open() {
 
 }
 
+//------------------------------------------------------------------------------
+// OpenBackground
+//
+/// With podio:background_files, read the background caches that the events
+/// are mixed with. The first source to be opened reads them, the sources of
+/// the other input files share its caches.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::OpenBackground() {
+
+    if( m_background_files_str.empty() ) return;
+    {
+        std::lock_guard<std::mutex> lock(g_sources_mutex);
+        for (auto* source : g_sources) {
+            if( source != this && source->m_background && source->GetApplication() == GetApplication() ){
+                m_background = source->m_background;
+                return;
+            }
+        }
+    }
+
+    std::vector<std::string> files, rates, collections;
+    JParameterManager::Parse(m_background_files_str, files);
+    JParameterManager::Parse(m_background_rates_str, rates);
+    JParameterManager::Parse(m_background_collections_str, collections);
+    if( rates.size() != files.size() ){
+        throw JException("podio:background_rates must give one rate per podio:background_files, not %d for %d files", rates.size(), files.size());
+    }
+    std::vector<eicrecon::PodioBackgroundMixer::Source> sources;
+    for (size_t i = 0; i < files.size(); ++i) {
+        sources.push_back({files[i], std::stod(rates[i])});
+    }
+
+    try {
+        m_background = std::make_shared<eicrecon::PodioBackgroundMixer>(
+                sources, m_background_time_window, m_background_cache_size,
+                std::set<std::string>(collections.begin(), collections.end()), m_background_seed);
+    }catch (std::exception &e ){
+        throw JException( fmt::format( "Problem reading the background files \"{}\": {}", m_background_files_str, e.what() ) );
+    }
+    LOG << "Mixing on average " << m_background->MeanEvents() << " background events of " << files.size()
+        << " file(s) into the " << m_background->collections().size() << " hit collections of every event" << LOG_END;
+}
+
 //------------------------------------------------------------------------------
 // Close
 //
@@ -173,6 +581,12 @@ void JEventSourcePODIO::Open() {
 /// \param event
 //------------------------------------------------------------------------------
 void JEventSourcePODIO::Close() {
+    StopPrefetch();
+    if( m_memory_limit_mb > 0 ){
+        if( auto summary = eicrecon::PodioEventPoolController::instance().summary(); !summary.empty() ){
+            LOG << summary << LOG_END;
+        }
+    }
     // m_reader.close();
     // TODO: ROOTFrameReader does not appear to have a close() method.
 }
@@ -190,46 +604,572 @@ void JEventSourcePODIO::GetEvent(std::shared_ptr<JEvent> event) {
     /// Calls to GetEvent are synchronized with each other, which means they can
     /// read and write state on the JEventSource without causing race conditions.
 
-    // Check if we have exhausted events from file
-    if( Nevents_read >= Nevents_in_file ) {
-        if( m_run_forever ){
-            Nevents_read = 0;
-        }else{
-            // m_reader.close();
-            // TODO:: ROOTFrameReader does not appear to have a close() method.
-            throw RETURN_STATUS::kNO_MORE_EVENTS;
-        }
+    // the events in flight are counted by their tokens, which are released with the event
+    auto& pool = eicrecon::PodioEventPoolController::instance();
+    if( m_memory_limit_mb > 0 && !pool.admit() ) throw RETURN_STATUS::kTRY_AGAIN;
+
+    if( m_replay_cache_size > 0 ){
+        GetReplayEvent(*event);
+        if( m_memory_limit_mb > 0 ) event->Insert(new eicrecon::PodioEventPoolController::Token);
+        InsertSequence(*event);
+        return;
     }
 
-    auto frame_data = m_reader.readEntry("events", Nevents_read);
-    auto frame = std::make_unique<podio::Frame>(std::move(frame_data));
+    Prefetched next;
+    if( m_reorder_window == 0 ){
+        if( !NextFrame(next) ) throw RETURN_STATUS::kNO_MORE_EVENTS;
+    }else{
+        // the largest event of the window is handed out first
+        while( m_reorder_buffer.size() < m_reorder_window ){
+            Prefetched read;
+            if( !NextFrame(read) ) break;
+            read.sim_hits = SimHitCount(*read.frame, read.input->m_collections_to_read);
+            m_reorder_buffer.push_back(std::move(read));
+        }
+        if( m_reorder_buffer.empty() ) throw RETURN_STATUS::kNO_MORE_EVENTS;
+        auto largest = std::max_element(m_reorder_buffer.begin(), m_reorder_buffer.end(),
+                                        [](const Prefetched& a, const Prefetched& b){ return a.sim_hits < b.sim_hits; });
+        next = std::move(*largest);
+        m_reorder_buffer.erase(largest);
+    }
+    const JEventSourcePODIO* input = next.input; // the source of the file of the entry
+    const size_t entry = next.entry;
+    std::unique_ptr<podio::Frame> frame = std::move(next.frame);
 
     const auto& event_headers = frame->get<edm4hep::EventHeaderCollection>("EventHeader"); // TODO: What is the collection name?
     if (event_headers.size() != 1) {
-        throw JException("Bad event headers: Entry %d contains %d items, but 1 expected.", Nevents_read, event_headers.size());
+        throw JException("Bad event headers: Entry %d of %s contains %d items, but 1 expected.", entry, input->GetResourceName().c_str(), event_headers.size());
     }
     event->SetEventNumber(event_headers[0].getEventNumber());
     event->SetRunNumber(event_headers[0].getRunNumber());
 
-    // Insert contents odf frame into JFactories
-    VisitPodioCollection<InsertingVisitor> visit;
-    for (const std::string& coll_name : frame->getAvailableCollections()) {
+    // The collections of the frame are taken from it by the factories of the factory set when they are
+    // requested, the ones that can not be, e.g. the mixed hit collections merged with the background,
+    // are inserted into JFactories
+    auto background = m_background ? m_background->Draw() : nullptr;
+    auto [inserted, first_event] = m_inserted_collections.try_emplace({event->GetFactorySet(), input});
+    if( first_event ){
+        ExposeCollections(*event->GetFactorySet(), *frame, input->m_collections_to_read, inserted->second);
+    }
+    for (auto& [coll_name, insert] : inserted->second) {
         const podio::CollectionBase* collection = frame->get(coll_name);
+        if (collection == nullptr) continue; // not in this entry
+        if( background && m_background->Mixes(coll_name) ){
+            collection = m_background->Merge(*background, coll_name, *collection);
+        }
+        // the type of a collection of a file is looked up once, in its first entry
+        if( insert == nullptr ){
+            insert = VisitPodioCollection<InsertingVisitor>::Find(collection->getTypeName());
+            if( insert == nullptr ) continue; // not of the datamodels, see ExposeCollections
+        }
         InsertingVisitor visitor(*event, coll_name);
+        insert(visitor, *collection);
+    }
+
+    eicrecon::InsertSharedFrame(*event, std::move(frame));
+    if( background ) event->Insert(background.release()); // the merged collections are not in the frame
+    if( m_checkpoint_events > 0 || m_input_entries ) event->Insert(new eicrecon::PodioInputEntry{input->GetResourceName(), entry});
+    if( m_memory_limit_mb > 0 ) event->Insert(new eicrecon::PodioEventPoolController::Token);
+    InsertSequence(*event);
+}
+
+//------------------------------------------------------------------------------
+// InsertSequence
+//
+/// Insert the position of the event in the input for podio:ordered_write. The
+/// sources are read one after the other, and the entries of a source in order,
+/// so the sequence is counted over all of them. With podio:reorder_window the
+/// sequence is the order in which the entries are handed out, not the one of
+/// the file.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::InsertSequence(JEvent& event) {
+    static std::atomic<std::uint64_t> sequence{0};
+    if( !m_ordered_write ) return;
+    if( m_events_read++ < m_nskip ) return; // skipped by JANA
+    event.Insert(new eicrecon::PodioEventSequence{sequence++});
+}
+
+//------------------------------------------------------------------------------
+// ExposeCollections
+//
+/// Add the factories that take the collections of the file from the frames of
+/// the events to a factory set, once per set and file. The collections are the
+/// ones to read or, if all are read, the ones of the first entry. The hit
+/// collections mixed with the background, the collections that already have a
+/// factory and the ones missing from the entry are left to be inserted. The
+/// collections of other types than those of the datamodels, e.g. the
+/// podio::UserDataCollection of the status of a factory, are not read.
+///
+/// \param factory_set  factory set of the events
+/// \param frame        first entry of the file for the factory set
+/// \param collections  collections to read, empty for all
+/// \param inserted     the collections that GetEvent has to insert
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::ExposeCollections(JFactorySet& factory_set, const podio::Frame& frame,
+                                          const std::vector<std::string>& collections, std::vector<InsertedCollection>& inserted) {
+    VisitPodioCollection<ExposingVisitor> visit;
+    for (const std::string& coll_name : collections.empty() ? frame.getAvailableCollections() : collections) {
+        const podio::CollectionBase* collection = frame.get(coll_name);
+        if( collection == nullptr || (m_background && m_background->Mixes(coll_name)) ){
+            inserted.push_back({coll_name});
+            continue;
+        }
+        if( VisitPodioCollection<ExposingVisitor>::Find(collection->getTypeName()) == nullptr ) continue;
+        ExposingVisitor visitor(factory_set, coll_name);
         visit(visitor, *collection);
+        if( !visitor.added ) inserted.push_back({coll_name});
     }
+}
 
-    event->Insert(frame.release()); // Transfer ownership from unique_ptr to JFactoryT<podio::Frame>
+//------------------------------------------------------------------------------
+// NextFrame
+//
+/// Read the next entry of the file, or take it from the prefetch queue.
+///
+/// \param next  filled with the entry, its frame and the source of its file
+/// \return      false if there are no more entries
+//------------------------------------------------------------------------------
+bool JEventSourcePODIO::NextFrame(Prefetched& next) {
+
+    next.input = this;
+    if( m_prefetch_threads.empty() ){
+        if( m_absorbed_by != nullptr ) return false; // read by another source
+
+        // Check if we have exhausted events from file
+        if( Nevents_read >= Nevents_selected ) {
+            if( m_run_forever && Nevents_selected > 0 ){
+                Nevents_read = 0;
+            }else{
+                // m_reader.close();
+                // TODO:: ROOTFrameReader does not appear to have a close() method.
+                return false;
+            }
+        }
+        next.entry = EntryOf(Nevents_read);
+        next.frame = ReadFrame(next.entry);
+        Nevents_read += 1;
+    }else{
+        std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+        m_prefetch_not_empty.wait(lock, [this]{ return !m_prefetch_queue.empty() || m_prefetch_done; });
+        if( m_prefetch_queue.empty() ){
+            if( m_prefetch_error ){
+                auto error = std::exchange(m_prefetch_error, nullptr);
+                try {
+                    std::rethrow_exception(error);
+                } catch (std::exception &e) {
+                    throw JException( fmt::format( "Problem reading \"{}\": {}", GetResourceName(), e.what() ) );
+                }
+            }
+            return false;
+        }
+        next = std::move(m_prefetch_queue.front());
+        m_prefetch_queue.pop_front();
+        m_prefetch_not_full.notify_one();
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// ReadFrame
+//
+/// Read an entry of the "events" category and unpack all of its collections,
+/// so that the decompression and the deserialisation are done by the caller,
+/// which is the prefetch thread if there is one.
+///
+/// \param entry  entry number in the file
+//------------------------------------------------------------------------------
+std::unique_ptr<podio::Frame> JEventSourcePODIO::ReadFrame(size_t entry) {
+    static const eicrecon::TraceName trace_name("podio read");
+    const eicrecon::TraceRange trace_range(trace_name);
+    // with podio >= 1.1 only the selected collections are read, older versions read all but only
+    // the selected ones are unpacked
+    auto frame = std::make_unique<podio::Frame>(m_reader.readEntry("events", entry, m_collections_to_read));
+    for (const std::string& coll_name : m_collections_to_read.empty() ? frame->getAvailableCollections() : m_collections_to_read) {
+        frame->get(coll_name);
+    }
+    return frame;
+}
+
+//------------------------------------------------------------------------------
+// LoadReplayCache
+//
+/// Read and unpack the first podio:replay_cache selected entries, once. The
+/// events are then made from these frames only, so that reading and
+/// decompression are not part of the measured throughput.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::LoadReplayCache() {
+    if( m_replay_mode != "shallow" && m_replay_mode != "clone" ){
+        throw JException("podio:replay_mode must be shallow or clone, not '%s'", m_replay_mode.c_str());
+    }
+    const size_t entries = std::min(m_replay_cache_size, Nevents_selected);
+    for (size_t position = 0; position < entries; ++position) {
+        m_replay_frames.push_back(ReadFrame(EntryOf(position)));
+    }
+    LOG << "Replaying " << m_replay_frames.size() << " entries of \"" << GetResourceName() << "\" from memory ("
+        << m_replay_mode << ")" << LOG_END;
+}
+
+//------------------------------------------------------------------------------
+// GetReplayEvent
+//
+/// Fill the event from the next cached frame. In the shallow mode the cached
+/// collections themselves are inserted, which the events then share read-only;
+/// they are not in the frame of the event, so they can not be written out. In
+/// the clone mode they are copied into the frame of the event.
+///
+/// \param event
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::GetReplayEvent(JEvent& event) {
+    if( m_replay_frames.empty() || (Nevents_read >= Nevents_selected && !m_run_forever) ){
+        throw RETURN_STATUS::kNO_MORE_EVENTS;
+    }
+    const podio::Frame& cached = *m_replay_frames[m_replay_next];
+    m_replay_next = (m_replay_next + 1) % m_replay_frames.size();
+
+    const auto& event_headers = cached.get<edm4hep::EventHeaderCollection>("EventHeader");
+    if (event_headers.size() != 1) {
+        throw JException("Bad event headers: a cached entry of %s contains %d items, but 1 expected.", GetResourceName().c_str(), event_headers.size());
+    }
+    event.SetEventNumber(event_headers[0].getEventNumber());
+    event.SetRunNumber(event_headers[0].getRunNumber());
+
+    auto frame = std::make_unique<podio::Frame>();
+    auto background = m_background ? m_background->Draw() : nullptr;
+    VisitPodioCollection<InsertingVisitor> insert;
+    VisitPodioCollection<CloningVisitor> clone;
+    for (const std::string& coll_name : m_collections_to_read.empty() ? cached.getAvailableCollections() : m_collections_to_read) {
+        const podio::CollectionBase* collection = cached.get(coll_name);
+        if (collection == nullptr) continue; // not in this entry
+        if (VisitPodioCollection<InsertingVisitor>::Find(collection->getTypeName()) == nullptr) continue; // not of the datamodels
+        if( background && m_background->Mixes(coll_name) ){
+            InsertingVisitor visitor(event, coll_name);
+            insert(visitor, *m_background->Merge(*background, coll_name, *collection));
+        }else if( m_replay_mode == "clone" ){
+            CloningVisitor visitor(*frame, event, coll_name);
+            clone(visitor, *collection);
+        }else{
+            InsertingVisitor visitor(event, coll_name);
+            insert(visitor, *collection);
+        }
+    }
+
+    eicrecon::InsertSharedFrame(event, std::move(frame)); // the new collections of the event go into a frame of its own
+    if( background ) event.Insert(background.release());
     Nevents_read += 1;
 }
 
+//------------------------------------------------------------------------------
+// SelectCollections
+//
+/// Choose the collections to read: the podio:input_include_collections (all
+/// if empty) or, with podio:input_from_outputs, the ones that the factory
+/// graph gets from the source, minus podio:input_exclude_collections. The
+/// EventHeader is always read. Nothing is selected if all the collections
+/// of the file are read anyway. With reco:reuse_input_collections, the
+/// reused collections and the collections they point to are read, and the
+/// other collections of the file that the factories make again are not.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::SelectCollections() {
+
+    std::vector<std::string> include_list, exclude_list;
+    JParameterManager::Parse(m_include_collections_str, include_list);
+    JParameterManager::Parse(m_exclude_collections_str, exclude_list);
+    m_INPUT_INCLUDE_COLLECTIONS = std::set<std::string>(include_list.begin(), include_list.end());
+    m_INPUT_EXCLUDE_COLLECTIONS = std::set<std::string>(exclude_list.begin(), exclude_list.end());
+
+    auto& wirings = eicrecon::JOmniFactoryWirings::instance();
+    const auto reused = wirings.ReusedCollections(GetApplication());
+    if( !reused.empty() ){
+        if( !m_INPUT_INCLUDE_COLLECTIONS.empty() ) m_INPUT_INCLUDE_COLLECTIONS.insert(reused.begin(), reused.end());
+        for (const std::string& coll_name : wirings.FactoryCollections()) {
+            if( reused.count(coll_name) == 0 ) m_INPUT_EXCLUDE_COLLECTIONS.insert(coll_name);
+        }
+        for (const std::string& coll_name : reused) m_INPUT_EXCLUDE_COLLECTIONS.erase(coll_name);
+    }
+
+    bool from_outputs = false;
+    if( m_input_from_outputs ){
+        auto sources = eicrecon::JOmniFactoryWirings::instance().SourceCollections(GetApplication());
+        if( sources ){
+            from_outputs = true;
+            m_INPUT_INCLUDE_COLLECTIONS.insert(sources->begin(), sources->end());
+        }else{
+            LOG << "podio:input_from_outputs ignored, podio:output_collections is empty" << LOG_END;
+        }
+    }
+    if( m_INPUT_INCLUDE_COLLECTIONS.empty() && m_INPUT_EXCLUDE_COLLECTIONS.empty() && reused.empty() ) return;
+    const bool include_all = m_INPUT_INCLUDE_COLLECTIONS.empty();
+
+    // the collections of the file, from its first entry
+    auto frame = std::make_unique<podio::Frame>(m_reader.readEntry("events", 0));
+    const auto available = frame->getAvailableCollections();
+    for (const std::string& coll_name : reused) {
+        // their factories are not created, the collection would be silently empty
+        if( std::find(available.begin(), available.end(), coll_name) == available.end() ){
+            throw JException("reco:reuse_input_collections: no collection \"%s\" in %s", coll_name.c_str(), GetResourceName().c_str());
+        }
+    }
+    if( !reused.empty() ) ValidateReusedCollections(reused);
+
+    // The collections that the reused ones point to through their relations, in the first entries, have
+    // to be read too, podio would resolve those relations to empty handles otherwise. The ones that no
+    // factory makes are added, the others have to be reused as well, their factories would run again.
+    std::set<std::string> targets(reused.begin(), reused.end());
+    if( !reused.empty() ){
+        constexpr size_t relation_scan_entries = 16;
+        AddRelationTargets(*frame, targets);
+        for (size_t entry = 1; entry < std::min<size_t>(Nevents_in_file, relation_scan_entries); ++entry) {
+            AddRelationTargets(podio::Frame(m_reader.readEntry("events", entry)), targets);
+        }
+        const auto factory_collections = wirings.FactoryCollections();
+        for (const std::string& coll_name : targets) {
+            if( !include_all && factory_collections.count(coll_name) == 0 ) m_INPUT_INCLUDE_COLLECTIONS.insert(coll_name);
+        }
+    }
+
+    m_collections_to_read.clear();
+    for (const std::string& coll_name : available) {
+        bool selected = include_all || m_INPUT_INCLUDE_COLLECTIONS.count(coll_name) > 0;
+        selected &= m_INPUT_EXCLUDE_COLLECTIONS.count(coll_name) == 0;
+        if( selected || coll_name == "EventHeader" ) m_collections_to_read.push_back(coll_name);
+    }
+    std::vector<std::string> unread;
+    for (const std::string& coll_name : targets) {
+        if( std::find(m_collections_to_read.begin(), m_collections_to_read.end(), coll_name) == m_collections_to_read.end() ) unread.push_back(coll_name);
+    }
+    if( !unread.empty() ){
+        throw JException("reco:reuse_input_collections: the reused collections point to %s, which would not be read; reuse them as well, or do not exclude them",
+                         fmt::format("{}", fmt::join(unread, ", ")).c_str());
+    }
+    if( !from_outputs ){
+        // the collections of the graph include the ones made by other kinds of factories
+        for (const std::string& coll_name : m_INPUT_INCLUDE_COLLECTIONS) {
+            if( std::find(available.begin(), available.end(), coll_name) == available.end() ){
+                LOG_WARN(default_cout_logger) << "podio:input_include_collections: no collection \"" << coll_name << "\" in " << GetResourceName() << LOG_END;
+            }
+        }
+    }
+    LOG << "Reading " << m_collections_to_read.size() << " of the " << available.size() << " collections" << LOG_END;
+    if( m_collections_to_read.size() == available.size() ) m_collections_to_read.clear();
+}
+
+//------------------------------------------------------------------------------
+// ValidateReusedCollections
+//
+/// Check the factories upstream of the reco:reuse_input_collections against
+/// the parameters of the job that wrote the file, which JEventProcessorPODIO
+/// stores in its "configuration" frame. A parameter of such a factory that
+/// is set in this job has to have the value it had in that job: e.g. a
+/// tracking parameter can not be changed while the tracks are reused. The
+/// defaults of the factories are not known, as they are not created.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::ValidateReusedCollections(const std::set<std::string>& reused) {
+
+    if( m_reader.getEntries(eicrecon::PodioConfigurationCategory) == 0 ){
+        LOG_WARN(default_cout_logger) << "reco:reuse_input_collections: " << GetResourceName()
+                                      << " has no configuration, the factories of the reused collections are not checked" << LOG_END;
+        return;
+    }
+    podio::Frame configuration(m_reader.readEntry(eicrecon::PodioConfigurationCategory, 0));
+
+    std::set<std::string> upstream;
+    for (const auto& prefix : eicrecon::JOmniFactoryWirings::instance().UpstreamFactories({reused.begin(), reused.end()})) {
+        upstream.insert(JParameterManager::ToLower(prefix));
+    }
+    auto* parameters = GetApplication()->GetJParameterManager();
+    std::vector<std::string> mismatches;
+    for (const auto& key : configuration.getParameterKeys<std::string>()) {
+        const auto colon = key.rfind(':');
+        if( colon == std::string::npos || upstream.count(JParameterManager::ToLower(key.substr(0, colon))) == 0 ) continue;
+        if( !parameters->Exists(key) ) continue;
+        const std::string value = parameters->FindParameter(key)->GetValue();
+        const std::string stored = configuration.getParameter<std::string>(key);
+        if( value != stored ) mismatches.push_back(key + "=" + value + " (" + stored + " in the input)");
+    }
+    if( !mismatches.empty() ){
+        throw JException("reco:reuse_input_collections: the factories of the reused collections were configured differently in %s: %s",
+                         GetResourceName().c_str(), fmt::format("{}", fmt::join(mismatches, ", ")).c_str());
+    }
+    LOG << "Reusing " << reused.size() << " collections, the " << upstream.size() << " factories upstream of them match the configuration of the input" << LOG_END;
+}
+
+//------------------------------------------------------------------------------
+// SelectEntries
+//
+/// Choose the entries to read, all of them unless podio:shard,
+/// podio:entry_ranges or podio:event_list is set. The shards are contiguous
+/// blocks of entries whose boundaries are moved to the next ROOT cluster
+/// boundary of the "events" tree, so that no cluster is decompressed by two
+/// shards. The entries of the events of the list are looked up in the event
+/// index of the file and read by random access, a shard of them is an equal
+/// share of these entries.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::SelectEntries() {
+
+    // eicrecon --fork sets the shard of every worker after the sources are created
+    m_shard_str = GetApplication()->GetParameterValue<std::string>("podio:shard");
+    m_entry_ranges.clear();
+    if( !m_entry_ranges_str.empty() && (!m_shard_str.empty() || !m_event_list_str.empty()) ){
+        throw JException("podio:entry_ranges can not be set together with podio:shard or podio:event_list");
+    }
+
+    size_t shard = 0, shards = 0;
+    if( !m_shard_str.empty() ){
+        char slash = 0;
+        std::istringstream ss(m_shard_str);
+        if( !(ss >> shard >> slash >> shards) || slash != '/' || shards == 0 || shard >= shards ){
+            throw JException("podio:shard must be \"K/N\" with 0 <= K < N, not \"%s\"", m_shard_str.c_str());
+        }
+    }
+
+    if( !m_event_list_str.empty() ){
+        try {
+            const auto selections = eicrecon::ParsePodioEventList(m_event_list_str);
+            const auto index = eicrecon::PodioEventIndex::load(m_reader, GetResourceName(), Nevents_in_file);
+            auto [entries, found] = index.entries(selections);
+            LOG << "Found " << found << " of the " << selections.size() << " podio:event_list events in \"" << GetResourceName()
+                << "\" (" << (index.cached() ? "cached" : "new") << " index " << eicrecon::PodioEventIndex::cachePath(GetResourceName()) << ")" << LOG_END;
+            if( shards > 0 ){
+                // e.g. with eicrecon --fork, the entries of the events are split among the workers
+                const size_t n = entries.size();
+                auto first = std::next(entries.begin(), n * shard / shards);
+                auto last = std::next(entries.begin(), n * (shard + 1) / shards);
+                entries = std::set<size_t>(first, last);
+            }
+            m_entry_ranges = eicrecon::ToEntryRanges(entries);
+        }
+        catch(std::runtime_error& e) {
+            throw JException(e.what());
+        }
+    }
+    else if( shards > 0 ){
+        auto starts = ClusterStarts(GetResourceName());
+        if( starts.empty() ) starts = {0, Nevents_in_file};
+        const auto boundary = [&](size_t k) -> size_t {
+            if( k == shards ) return Nevents_in_file;
+            const size_t ideal = (Nevents_in_file * k) / shards;
+            return *std::lower_bound(starts.begin(), starts.end(), ideal);
+        };
+        m_entry_ranges.emplace_back(boundary(shard), std::max(boundary(shard), boundary(shard + 1)));
+    }
+    else if( !m_entry_ranges_str.empty() ){
+        std::vector<std::string> ranges;
+        JParameterManager::Parse(m_entry_ranges_str, ranges);
+        for (const auto& range : ranges) {
+            size_t first = 0, last = 0;
+            char dash = 0;
+            std::istringstream ss(range);
+            if( !(ss >> first >> dash >> last) || dash != '-' || last < first ){
+                throw JException("podio:entry_ranges must be ranges \"first-last\", not \"%s\"", range.c_str());
+            }
+            first = std::min(first, Nevents_in_file);
+            last = std::min(last + 1, Nevents_in_file);
+            if( first < last ) m_entry_ranges.emplace_back(first, last);
+        }
+    }
+    else {
+        m_entry_ranges.emplace_back(0, Nevents_in_file);
+    }
+
+    if( !m_resume_from.empty() ){
+        // the entries of the completed chunks of the stopped job, including the ones that it filtered out
+        try {
+            const auto manifest = eicrecon::PodioCheckpointManifest::read(m_resume_from);
+            m_entry_ranges = eicrecon::SubtractEntryRanges(m_entry_ranges, manifest.done(GetResourceName()));
+        }
+        catch(std::runtime_error& e) {
+            throw JException(e.what());
+        }
+    }
+
+    Nevents_selected = 0;
+    for (const auto& [first, end] : m_entry_ranges) Nevents_selected += end - first;
+    if( Nevents_selected != Nevents_in_file ){
+        LOG << "Reading " << Nevents_selected << " of the " << Nevents_in_file << " entries of \"" << GetResourceName() << "\"" << LOG_END;
+    }
+}
+
+//------------------------------------------------------------------------------
+// EntryOf
+//
+/// Entry number of the position-th selected entry.
+//------------------------------------------------------------------------------
+size_t JEventSourcePODIO::EntryOf(size_t position) const {
+    for (const auto& [first, end] : m_entry_ranges) {
+        if( position < end - first ) return first + position;
+        position -= end - first;
+    }
+    throw std::out_of_range("JEventSourcePODIO::EntryOf");
+}
+
+//------------------------------------------------------------------------------
+// Prefetch
+//
+/// Read the selected entries of the file of input in order into
+/// m_prefetch_queue, waiting while it holds m_prefetch_depth of them. The
+/// first error stops the reading of all the files, GetEvent throws it once
+/// the entries read before it are consumed.
+///
+/// \param input  this source, or a source absorbed with podio:parallel_files
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::Prefetch(JEventSourcePODIO* input) {
+    size_t position = 0;
+    while( true ){
+        if( position >= input->Nevents_selected ){
+            if( !m_run_forever || input->Nevents_selected == 0 ) break;
+            position = 0;
+        }
+        const size_t entry = input->EntryOf(position++);
+        std::unique_ptr<podio::Frame> frame;
+        try {
+            frame = input->ReadFrame(entry);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+            if( !m_prefetch_error ) m_prefetch_error = std::current_exception();
+            m_prefetch_stop = true;
+            m_prefetch_not_full.notify_all();
+            break;
+        }
+        std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+        m_prefetch_not_full.wait(lock, [this]{ return m_prefetch_stop || m_prefetch_queue.size() < m_prefetch_depth; });
+        if( m_prefetch_stop ) break;
+        m_prefetch_queue.push_back({input, entry, std::move(frame)});
+        m_prefetch_not_empty.notify_one();
+    }
+    std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+    if( --m_prefetch_running == 0 ) m_prefetch_done = true;
+    m_prefetch_not_empty.notify_all();
+}
+
+//------------------------------------------------------------------------------
+// StopPrefetch
+//
+/// Stop and join the prefetch threads, dropping the entries read ahead.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::StopPrefetch() {
+    if( m_prefetch_threads.empty() ) return;
+    {
+        std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+        m_prefetch_stop = true;
+        m_prefetch_queue.clear();
+    }
+    m_prefetch_not_full.notify_all();
+    for (auto& thread : m_prefetch_threads) {
+        if( thread.joinable() ) thread.join();
+    }
+    std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+    m_prefetch_queue.clear();
+    m_prefetch_done = true;
+    m_prefetch_not_empty.notify_all();
+}
+
 //------------------------------------------------------------------------------
 // GetDescription
 //------------------------------------------------------------------------------
 std::string JEventSourcePODIO::GetDescription() {
 
     /// GetDescription() helps JANA explain to the user what is going on
-    return "PODIO root file (Frames, podio >= v0.16.3)";
+    return "PODIO root file (Frames as TTree or RNTuple, podio >= v0.16.3)";
 }
 
 //------------------------------------------------------------------------------
@@ -258,8 +1198,8 @@ double JEventSourceGeneratorT<JEventSourcePODIO>::CheckOpenable(std::string reso
     if (!file || file->IsZombie()) return 0.0;
 
     // We test the format the same way that PODIO's python API does. See python/podio/reading.py
-    TObject* tree = file->Get("podio_metadata");
-    if (tree == nullptr) return 0.0;
+    // The metadata is a TTree or an RNTuple, depending on the format of the file.
+    if (file->GetKey("podio_metadata") == nullptr) return 0.0;
     return 0.03;
 }
 
@@ -8,11 +8,27 @@
 #include <JANA/JEvent.h>
 #include <JANA/JEventSource.h>
 #include <JANA/JEventSourceGeneratorT.h>
-#include <podio/ROOTFrameReader.h>
+#include <JANA/JFactorySet.h>
+#include <podio/Frame.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "PodioBackgroundMixer.h"
+#include "PodioCheckpoint.h"
+#include "PodioFrameIO.h"
+
+struct InsertingVisitor;
 
 class JEventSourcePODIO : public JEventSource {
 
@@ -32,16 +48,136 @@ public:
     void PrintCollectionTypeTable(void);
 
 protected:
-    podio::ROOTFrameReader m_reader;
+    /// Opens the file of this source, also for the source that absorbs it with podio:parallel_files
+    void OpenFile();
+
+    struct Prefetched;
+
+    /// The next entry of the file or of the prefetch queue, false if there are none
+    bool NextFrame(Prefetched& next);
+
+    /// A collection that GetEvent inserts, with the visitor thunk of its type once it has been seen
+    struct InsertedCollection {
+        std::string name;
+        void (*insert)(InsertingVisitor&, const podio::CollectionBase&) = nullptr;
+    };
+
+    /// Adds the factories that take the collections from the frames of the events to a factory set,
+    /// inserted are the collections left to GetEvent
+    void ExposeCollections(JFactorySet& factory_set, const podio::Frame& frame,
+                           const std::vector<std::string>& collections, std::vector<InsertedCollection>& inserted);
+
+    /// Reads an entry and unpacks all its collections
+    std::unique_ptr<podio::Frame> ReadFrame(size_t entry);
+
+    /// Reads the first podio:replay_cache selected entries into m_replay_frames
+    void LoadReplayCache();
+
+    /// Fills the event from the next frame of m_replay_frames, without reading the file
+    void GetReplayEvent(JEvent& event);
+
+    /// Inserts the eicrecon::PodioEventSequence of podio:ordered_write
+    void InsertSequence(JEvent& event);
+
+    /// Reads the background caches with podio:background_files, or shares the ones of another source
+    void OpenBackground();
+
+    /// Body of a prefetch thread, which reads the file of input into the queue of this source
+    void Prefetch(JEventSourcePODIO* input);
+
+    void StopPrefetch();
+
+    /// Fills m_collections_to_read from the podio:input_* parameters and the collections of the file
+    void SelectCollections();
+
+    /// Checks the configuration of the factories upstream of the reused collections against the one of the file
+    void ValidateReusedCollections(const std::set<std::string>& reused);
+
+    /// Fills m_entry_ranges from podio:shard, podio:entry_ranges or podio:event_list
+    void SelectEntries();
+
+    /// Entry number of the position-th entry of m_entry_ranges
+    size_t EntryOf(size_t position) const;
+
+    eicrecon::PodioFrameReader m_reader; // TTree or RNTuple
     size_t Nevents_in_file = 0;
+    size_t Nevents_selected = 0;
     size_t Nevents_read = 0;
+    bool m_opened = false;
+
+    // The collections that GetEvent inserts into the events of a factory set, for the entries of a
+    // source, the others are taken from the frame by the factories that ExposeCollections adds
+    std::map<std::pair<JFactorySet*, const JEventSourcePODIO*>, std::vector<InsertedCollection>> m_inserted_collections;
+
+    std::string m_shard_str;
+    std::string m_entry_ranges_str;
+    std::string m_event_list_str;
+    std::vector<std::pair<size_t, size_t>> m_entry_ranges; // [first, end) entries to read
+
+    // With podio:checkpoint_events > 0, the input entry of every event is inserted for the chunk manifest,
+    // and with jana:resume_from the entries of the completed chunks are not read again
+    size_t m_checkpoint_events = 0;
+    std::string m_resume_from;
+    bool m_input_entries = false; // also without checkpoints, e.g. for the slow event recorder
+
+    // With podio:ordered_write, the position of every event in the input is inserted for the reorder
+    // buffer of the writer, counted over all the sources. The first jana:nskip events of a source are
+    // read but not processed, they are not counted
+    bool m_ordered_write = false;
+    std::uint64_t m_nskip = 0;
+    std::uint64_t m_events_read = 0;
+
+    // With podio:memory_limit_mb > 0, the events in flight are held below the RSS limit by
+    // eicrecon::PodioEventPoolController
+    size_t m_memory_limit_mb = 0;
 
     std::string m_include_collections_str;
     std::string m_exclude_collections_str;
     std::set<std::string> m_INPUT_INCLUDE_COLLECTIONS;
     std::set<std::string> m_INPUT_EXCLUDE_COLLECTIONS;
+    bool m_input_from_outputs=false;
+    std::vector<std::string> m_collections_to_read; // empty reads all collections
     bool m_run_forever=false;
 
+    // With podio:replay_cache > 0, the events are handed out round-robin from frames kept in memory
+    size_t m_replay_cache_size = 0;
+    std::string m_replay_mode = "shallow";
+    std::vector<std::unique_ptr<podio::Frame>> m_replay_frames;
+    size_t m_replay_next = 0;
+
+    // With podio:background_files, the hits of cached background entries are merged into the events
+    std::string m_background_files_str;
+    std::string m_background_rates_str;
+    std::string m_background_collections_str;
+    double m_background_time_window = 1000; // ns
+    size_t m_background_cache_size = 100;
+    uint64_t m_background_seed = 1;
+    std::shared_ptr<eicrecon::PodioBackgroundMixer> m_background;
+
+    // With podio:prefetch > 0, only the prefetch threads use m_reader after Open()
+    bool m_parallel_files = false;
+    JEventSourcePODIO* m_absorbed_by = nullptr; // the source whose prefetch threads read this file
+    size_t m_prefetch_depth = 0;
+    std::vector<std::thread> m_prefetch_threads;
+    size_t m_prefetch_running = 0;
+    std::mutex m_prefetch_mutex;
+    std::condition_variable m_prefetch_not_empty;
+    std::condition_variable m_prefetch_not_full;
+    struct Prefetched {
+        const JEventSourcePODIO* input = nullptr;
+        size_t entry = 0;
+        std::unique_ptr<podio::Frame> frame;
+        size_t sim_hits = 0; // with podio:reorder_window
+    };
+    std::deque<Prefetched> m_prefetch_queue;
+    std::exception_ptr m_prefetch_error;
+    bool m_prefetch_done = false;
+    bool m_prefetch_stop = false;
+
+    // With podio:reorder_window > 0, the entry with the most sim hits of the window goes first
+    size_t m_reorder_window = 0;
+    std::vector<Prefetched> m_reorder_buffer;
+
 };
 
 template <>
@@ -0,0 +1,286 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "JEventSourceTimeframePODIO.h"
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JException.h>
+#include <JANA/JLogger.h>
+#include <JANA/Utils/JTypeInfo.h>
+#include <TFile.h>
+#include <edm4hep/EventHeaderCollection.h>
+#include <fmt/core.h>
+#include <podio/CollectionBase.h>
+#include <podio/Frame.h>
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <utility>
+
+// These files are generated automatically by make_datamodel_glue.py
+#include "PodioSharedFrame.h"
+#include "services/io/podio/datamodel_glue.h"
+#include "services/io/podio/datamodel_includes.h" // IWYU pragma: keep
+
+
+namespace {
+
+    /// Appends the time of every hit of a collection, getTimeStamp() or getTime()
+    struct HitTimesVisitor {
+        const std::string& m_collection_name;
+        std::vector<double>& m_times;
+
+        template <typename T>
+        void operator() (const T& collection) {
+            using ContentsT = decltype(collection[0]);
+            if constexpr (requires(const ContentsT& hit) { hit.getTimeStamp(); }) {
+                for (const auto& hit : collection) m_times.push_back(hit.getTimeStamp());
+            } else if constexpr (requires(const ContentsT& hit) { hit.getTime(); }) {
+                for (const auto& hit : collection) m_times.push_back(hit.getTime());
+            } else {
+                throw JException(fmt::format("podio:timeframe_hit_collections: the {} of '{}' have no time",
+                                             collection.getTypeName(), m_collection_name));
+            }
+        }
+    };
+
+    /// Puts clones of some hits of a time frame collection into the frame of a slice, and into its JEvent
+    struct SliceVisitor {
+        podio::Frame& m_frame;
+        JEvent& m_event;
+        const std::string& m_collection_name;
+        const std::vector<size_t>& m_hits;
+
+        template <typename T>
+        void operator() (const T& collection) {
+            using ContentsT = decltype(collection[0]);
+            T slice;
+            for (size_t i : m_hits) slice.push_back(collection[i].clone());
+            const auto& stored = m_frame.put(std::move(slice), m_collection_name);
+            m_event.InsertCollectionAlreadyInFrame<ContentsT>(&stored, m_collection_name);
+        }
+    };
+
+}
+
+
+//------------------------------------------------------------------------------
+// Constructor
+//
+///
+/// \param resource_name  Name of root file to open (n.b. file is not opened until Open() is called)
+/// \param app            JApplication
+//------------------------------------------------------------------------------
+JEventSourceTimeframePODIO::JEventSourceTimeframePODIO(std::string resource_name, JApplication* app) : JEventSource(resource_name, app) {
+    SetTypeName(NAME_OF_THIS); // Provide JANA with class name
+
+    GetApplication()->SetDefaultParameter(
+            "podio:timeframe_hit_collections",
+            m_hit_collections,
+            "comma separated list of the hit collections of the time frames that are split into time slices"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:timeframe_gap",
+            m_gap,
+            "a time slice ends where the next hit is more than this later, in the time unit of the hits"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:timeframe_min_hits",
+            m_min_hits,
+            "time slices with fewer hits are dropped as noise"
+            );
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+JEventSourceTimeframePODIO::~JEventSourceTimeframePODIO() {
+    LOG << "Closing Event Source for " << GetResourceName() << LOG_END;
+}
+
+//------------------------------------------------------------------------------
+// Open
+//
+/// Open the root file and check that the first time frame has the hit
+/// collections to split.
+//------------------------------------------------------------------------------
+void JEventSourceTimeframePODIO::Open() {
+
+    if( m_hit_collections.empty() ){
+        throw JException("podio:timeframe needs the podio:timeframe_hit_collections to split into time slices");
+    }
+    if( ! std::filesystem::exists(GetResourceName()) ){
+        throw JException( fmt::format( "File \"{}\" does not exist", GetResourceName() ) );
+    }
+
+    try {
+        m_reader.openFile( GetResourceName() );
+        Ntimeframes_in_file = m_reader.getEntries("events");
+        if( Ntimeframes_in_file > 0 ){
+            podio::Frame first(m_reader.readEntry("events", 0));
+            const auto available = first.getAvailableCollections();
+            for (const auto& name : m_hit_collections) {
+                if( std::find(available.begin(), available.end(), name) == available.end() ){
+                    throw JException( fmt::format( "The time frames of \"{}\" have no collection '{}'", GetResourceName(), name ) );
+                }
+            }
+            m_has_event_header = std::find(available.begin(), available.end(), "EventHeader") != available.end();
+        }
+    }catch (JException&){
+        throw;
+    }catch (std::exception &e ){
+        LOG_ERROR(default_cerr_logger) << e.what() << LOG_END;
+        throw JException( fmt::format( "Problem opening file \"{}\"", GetResourceName() ) );
+    }
+
+    LOG << "Opened PODIO time frame file \"" << GetResourceName() << "\" with " << Ntimeframes_in_file
+        << " time frames, split at gaps longer than " << m_gap << LOG_END;
+}
+
+//------------------------------------------------------------------------------
+// ReadTimeframe
+//
+/// Read the next time frame, order all the hits of m_hit_collections by time
+/// and split them wherever the gap to the next hit exceeds m_gap. The slices
+/// hold the indices of their hits until GetEvent clones them.
+//------------------------------------------------------------------------------
+void JEventSourceTimeframePODIO::ReadTimeframe() {
+
+    std::vector<std::string> collections = m_hit_collections;
+    if( m_has_event_header ) collections.push_back("EventHeader");
+    const size_t entry = Ntimeframes_read++;
+    std::shared_ptr<const podio::Frame> frame = std::make_shared<podio::Frame>(m_reader.readEntry("events", entry, collections));
+
+    std::uint64_t run_number = 0;
+    std::uint64_t time_stamp = 0;
+    if( m_has_event_header ){
+        const auto& headers = frame->get<edm4hep::EventHeaderCollection>("EventHeader");
+        if( !headers.empty() ){
+            run_number = headers[0].getRunNumber();
+            time_stamp = headers[0].getTimeStamp();
+        }
+    }
+
+    struct Hit {
+        double time;
+        size_t collection;
+        size_t index;
+    };
+    std::vector<Hit> hits;
+    VisitPodioCollection<HitTimesVisitor> visit;
+    for (size_t c = 0; c < m_hit_collections.size(); ++c) {
+        std::vector<double> times;
+        HitTimesVisitor visitor{m_hit_collections[c], times};
+        visit(visitor, *frame->get(m_hit_collections[c]));
+        for (size_t i = 0; i < times.size(); ++i) hits.push_back({times[i], c, i});
+    }
+    std::stable_sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) { return a.time < b.time; });
+
+    // [first, end) of the hits of every slice
+    std::vector<std::pair<size_t, size_t>> ranges;
+    size_t first = 0;
+    for (size_t i = 1; i <= hits.size(); ++i) {
+        if( i == hits.size() || hits[i].time - hits[i - 1].time > m_gap ){
+            if( i - first >= m_min_hits ) ranges.emplace_back(first, i);
+            first = i;
+        }
+    }
+
+    for (size_t k = 0; k < ranges.size(); ++k) {
+        Slice slice;
+        slice.timeframe = {frame, entry, k, ranges.size(), hits[ranges[k].first].time, hits[ranges[k].second - 1].time};
+        slice.run_number = run_number;
+        slice.time_stamp = time_stamp;
+        slice.hits.resize(m_hit_collections.size());
+        for (size_t i = ranges[k].first; i < ranges[k].second; ++i) {
+            slice.hits[hits[i].collection].push_back(hits[i].index);
+        }
+        m_slices.push_back(std::move(slice));
+    }
+}
+
+//------------------------------------------------------------------------------
+// GetEvent
+//
+/// Make the next time slice an event: clones of its hits, an EventHeader and
+/// the eicrecon::PodioTimeframe that it belongs to.
+///
+/// \param event
+//------------------------------------------------------------------------------
+void JEventSourceTimeframePODIO::GetEvent(std::shared_ptr<JEvent> event) {
+
+    while( m_slices.empty() ){
+        if( Ntimeframes_read >= Ntimeframes_in_file ) throw RETURN_STATUS::kNO_MORE_EVENTS;
+        ReadTimeframe();
+    }
+    Slice slice = std::move(m_slices.front());
+    m_slices.pop_front();
+
+    const std::uint64_t event_number = Nslices_made++;
+    event->SetEventNumber(event_number);
+    event->SetRunNumber(slice.run_number);
+
+    auto frame = std::make_unique<podio::Frame>();
+    VisitPodioCollection<SliceVisitor> visit;
+    for (size_t c = 0; c < m_hit_collections.size(); ++c) {
+        SliceVisitor visitor{*frame, *event, m_hit_collections[c], slice.hits[c]};
+        visit(visitor, *slice.timeframe.frame->get(m_hit_collections[c]));
+    }
+
+    edm4hep::EventHeaderCollection headers;
+    auto header = headers.create();
+    header.setEventNumber(event_number);
+    header.setRunNumber(slice.run_number);
+    header.setTimeStamp(slice.time_stamp);
+    const auto& stored_headers = frame->put(std::move(headers), "EventHeader");
+    event->InsertCollectionAlreadyInFrame<edm4hep::EventHeader>(&stored_headers, "EventHeader");
+
+    frame->putParameter("timeframe", static_cast<int>(slice.timeframe.timeframe));
+    frame->putParameter("timeslice", static_cast<int>(slice.timeframe.slice));
+    frame->putParameter("timeslices", static_cast<int>(slice.timeframe.slices));
+    frame->putParameter("timeslice_start", slice.timeframe.start_time);
+    frame->putParameter("timeslice_end", slice.timeframe.end_time);
+
+    // the cloned hits point into the time frame, which the writer may outlive the event with
+    eicrecon::InsertSharedFrame(*event, std::move(frame), slice.timeframe.frame);
+    event->Insert(new eicrecon::PodioTimeframe(std::move(slice.timeframe)));
+}
+
+//------------------------------------------------------------------------------
+// GetDescription
+//------------------------------------------------------------------------------
+std::string JEventSourceTimeframePODIO::GetDescription() {
+
+    /// GetDescription() helps JANA explain to the user what is going on
+    return "PODIO time frames split into time slices (streaming readout)";
+}
+
+//------------------------------------------------------------------------------
+// CheckOpenable
+//
+/// Return a value from 0-1 indicating probability that this source will be
+/// able to read this root file. Only with podio:timeframe, when it takes
+/// precedence over JEventSourcePODIO.
+///
+/// \param resource_name name of root file to evaluate.
+/// \return              value from 0-1 indicating confidence that this source can open the given file
+//------------------------------------------------------------------------------
+template <>
+double JEventSourceGeneratorT<JEventSourceTimeframePODIO>::CheckOpenable(std::string resource_name) {
+
+    bool timeframe = false;
+    japp->SetDefaultParameter(
+            "podio:timeframe",
+            timeframe,
+            "read the entries of the podio files as streaming readout time frames, split into time slices"
+            );
+    if( !timeframe || resource_name.find(".root") == std::string::npos ) return 0.0;
+
+    std::unique_ptr<TFile> file = std::make_unique<TFile>(resource_name.c_str());
+    if (!file || file->IsZombie()) return 0.0;
+    if (file->GetKey("podio_metadata") == nullptr) return 0.0;
+    return 0.05;
+}
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JEventSource.h>
+#include <JANA/JEventSourceGeneratorT.h>
+#include <podio/Frame.h>
+#include <stddef.h>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "PodioFrameIO.h"
+
+namespace eicrecon {
+
+/// The time frame of a time slice, inserted into the JEvent of every slice
+struct PodioTimeframe {
+    std::shared_ptr<const podio::Frame> frame; // keeps the relations of the cloned hits valid
+    std::uint64_t timeframe;  // entry of the time frame in the file
+    std::uint64_t slice;      // index of the slice in the time frame
+    std::uint64_t slices;     // number of slices of the time frame
+    double start_time;        // of the first hit of the slice
+    double end_time;          // of the last hit of the slice
+};
+
+}
+
+/**
+ * Event source of streaming readout, with `-Ppodio:timeframe=true`: every
+ * entry of the podio file is a time frame, which is split into time slices
+ * that are processed as events.
+ *
+ * The hits of `podio:timeframe_hit_collections` are ordered by time, and a
+ * slice ends wherever the next hit is more than `podio:timeframe_gap` later
+ * (in the time unit of the hits, `getTimeStamp()` or `getTime()`). Every
+ * slice gets clones of its hits in collections of the same names and an
+ * EventHeader, and the slices of all the time frames are numbered in time
+ * order, so that they are processed in parallel like events and can be put
+ * back in order afterwards, e.g. by the ordered merge of podio:output_shards.
+ * The time frame and slice numbers are also frame parameters of the slices,
+ * and a eicrecon::PodioTimeframe in the event.
+ */
+class JEventSourceTimeframePODIO : public JEventSource {
+
+public:
+    JEventSourceTimeframePODIO(std::string resource_name, JApplication* app);
+
+    virtual ~JEventSourceTimeframePODIO();
+
+    void Open() override;
+
+    void GetEvent(std::shared_ptr<JEvent>) override;
+
+    static std::string GetDescription();
+
+protected:
+    struct Slice {
+        eicrecon::PodioTimeframe timeframe;
+        std::uint64_t run_number;
+        std::uint64_t time_stamp;
+        std::vector<std::vector<size_t>> hits; // of every hit collection, indices in the time frame
+    };
+
+    /// Reads the next time frame and splits it into m_slices
+    void ReadTimeframe();
+
+    eicrecon::PodioFrameReader m_reader;
+    size_t Ntimeframes_in_file = 0;
+    size_t Ntimeframes_read = 0;
+    std::uint64_t Nslices_made = 0;
+
+    std::vector<std::string> m_hit_collections;
+    bool m_has_event_header = false;
+    double m_gap = 100;
+    size_t m_min_hits = 1;
+    std::deque<Slice> m_slices;
+};
+
+template <>
+double JEventSourceGeneratorT<JEventSourceTimeframePODIO>::CheckOpenable(std::string);
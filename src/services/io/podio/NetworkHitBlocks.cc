@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "NetworkHitBlocks.h"
+
+#include <fmt/core.h>
+#include <cstring>
+#include <stdexcept>
+
+namespace eicrecon {
+
+namespace {
+
+  /// Reads the next values of a message, checking its length
+  class MessageReader {
+  public:
+    explicit MessageReader(std::span<const std::byte> message) : m_message(message) {}
+
+    template <typename T> T read() {
+      T value;
+      std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+      return value;
+    }
+
+    std::span<const std::byte> take(std::size_t bytes) {
+      if (bytes > m_message.size() - m_position) {
+        throw std::runtime_error(fmt::format("Network event message of {} bytes ends early, at {} + {}",
+                                             m_message.size(), m_position, bytes));
+      }
+      const auto taken = m_message.subspan(m_position, bytes);
+      m_position += bytes;
+      return taken;
+    }
+
+    bool done() const { return m_position == m_message.size(); }
+
+  private:
+    std::span<const std::byte> m_message;
+    std::size_t m_position = 0;
+  };
+
+  template <typename T> void append(std::vector<std::byte>& message, const T& value) {
+    const auto* bytes = reinterpret_cast<const std::byte*>(&value);
+    message.insert(message.end(), bytes, bytes + sizeof(T));
+  }
+
+} // namespace
+
+NetworkRawHit NetworkHitBlock::operator[](std::size_t i) const {
+  NetworkRawHit hit;
+  std::memcpy(&hit, hits.data() + i * sizeof(NetworkRawHit), sizeof(NetworkRawHit));
+  return hit;
+}
+
+NetworkEvent NetworkEvent::decode(std::span<const std::byte> message) {
+  MessageReader reader(message);
+  if (reader.read<std::uint32_t>() != magic) {
+    throw std::runtime_error("Network event message does not start with \"EICB\"");
+  }
+  if (const auto message_version = reader.read<std::uint32_t>(); message_version != version) {
+    throw std::runtime_error(fmt::format("Network event message of version {}, expected {}", message_version, version));
+  }
+  NetworkEvent event;
+  event.run_number   = reader.read<std::uint64_t>();
+  event.event_number = reader.read<std::uint64_t>();
+  event.time_stamp   = reader.read<std::uint64_t>();
+  const auto n_blocks = reader.read<std::uint32_t>();
+  for (std::uint32_t b = 0; b < n_blocks; ++b) {
+    NetworkHitBlock block;
+    block.kind = static_cast<NetworkHitKind>(reader.read<std::uint32_t>());
+    if (block.kind != NetworkHitKind::RawTrackerHit && block.kind != NetworkHitKind::RawCalorimeterHit) {
+      throw std::runtime_error(fmt::format("Network event message with a block of unknown kind {}",
+                                           static_cast<std::uint32_t>(block.kind)));
+    }
+    const auto name = reader.take(reader.read<std::uint32_t>());
+    block.name = std::string_view(reinterpret_cast<const char*>(name.data()), name.size());
+    block.hits = reader.take(std::size_t{reader.read<std::uint32_t>()} * sizeof(NetworkRawHit));
+    event.blocks.push_back(block);
+  }
+  if (!reader.done()) {
+    throw std::runtime_error("Network event message has bytes after its last block");
+  }
+  return event;
+}
+
+std::vector<std::byte> NetworkEvent::encode(std::uint64_t run_number, std::uint64_t event_number,
+                                            std::uint64_t time_stamp,
+                                            const std::vector<std::pair<std::string, std::vector<NetworkRawHit>>>& tracker_hits,
+                                            const std::vector<std::pair<std::string, std::vector<NetworkRawHit>>>& calorimeter_hits) {
+  std::vector<std::byte> message;
+  append(message, magic);
+  append(message, version);
+  append(message, run_number);
+  append(message, event_number);
+  append(message, time_stamp);
+  append(message, static_cast<std::uint32_t>(tracker_hits.size() + calorimeter_hits.size()));
+  for (const auto kind : {NetworkHitKind::RawTrackerHit, NetworkHitKind::RawCalorimeterHit}) {
+    for (const auto& [name, hits] : (kind == NetworkHitKind::RawTrackerHit ? tracker_hits : calorimeter_hits)) {
+      append(message, static_cast<std::uint32_t>(kind));
+      append(message, static_cast<std::uint32_t>(name.size()));
+      const auto* name_bytes = reinterpret_cast<const std::byte*>(name.data());
+      message.insert(message.end(), name_bytes, name_bytes + name.size());
+      append(message, static_cast<std::uint32_t>(hits.size()));
+      for (const auto& hit : hits) {
+        append(message, hit);
+      }
+    }
+  }
+  return message;
+}
+
+} // namespace eicrecon
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace eicrecon {
+
+/// Raw hit on the wire, the members of edm4eic::RawTrackerHit and of edm4hep::RawCalorimeterHit
+struct NetworkRawHit {
+  std::uint64_t cellID;
+  std::int32_t value; // charge or amplitude
+  std::int32_t timeStamp;
+};
+static_assert(sizeof(NetworkRawHit) == 16);
+
+enum class NetworkHitKind : std::uint32_t {
+  RawTrackerHit     = 1, // edm4eic::RawTrackerHitCollection
+  RawCalorimeterHit = 2, // edm4hep::RawCalorimeterHitCollection
+};
+
+/// The hits of a collection of a message, pointing into the message
+struct NetworkHitBlock {
+  NetworkHitKind kind;
+  std::string_view name;
+  std::span<const std::byte> hits; // NetworkRawHit, not necessarily aligned
+
+  std::size_t size() const { return hits.size() / sizeof(NetworkRawHit); }
+  NetworkRawHit operator[](std::size_t i) const;
+};
+
+/**
+ * One event of a DAQ stream, with the hit blocks of its collections. A
+ * message is, in the byte order of the machines (little-endian):
+ *
+ *     uint32 magic "EICB", uint32 version 1
+ *     uint64 run number, uint64 event number, uint64 time stamp
+ *     uint32 number of blocks, and for every block:
+ *       uint32 NetworkHitKind, uint32 name length, the name,
+ *       uint32 number of hits, 16 bytes per NetworkRawHit
+ *
+ * On a stream, every message is preceded by its uint32 length in bytes. A
+ * length of 0 ends the stream.
+ */
+struct NetworkEvent {
+  static constexpr std::uint32_t magic   = 0x42434945; // "EICB"
+  static constexpr std::uint32_t version = 1;
+
+  std::uint64_t run_number = 0;
+  std::uint64_t event_number = 0;
+  std::uint64_t time_stamp = 0;
+  std::vector<NetworkHitBlock> blocks;
+
+  /// Throws std::runtime_error if the message is malformed, the blocks point into message
+  static NetworkEvent decode(std::span<const std::byte> message);
+
+  /// The message of an event, for senders and tests
+  static std::vector<std::byte> encode(std::uint64_t run_number, std::uint64_t event_number,
+                                       std::uint64_t time_stamp,
+                                       const std::vector<std::pair<std::string, std::vector<NetworkRawHit>>>& tracker_hits,
+                                       const std::vector<std::pair<std::string, std::vector<NetworkRawHit>>>& calorimeter_hits);
+};
+
+} // namespace eicrecon
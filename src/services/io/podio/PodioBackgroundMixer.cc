@@ -0,0 +1,240 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "PodioBackgroundMixer.h"
+
+#include <edm4hep/CaloHitContributionCollection.h>
+#include <edm4hep/SimCalorimeterHitCollection.h>
+#include <edm4hep/SimTrackerHitCollection.h>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "PodioFrameIO.h"
+
+namespace eicrecon {
+
+namespace {
+
+  /// A hit of the signal or of a background entry, with the time offset of its entry
+  template <typename CollectionT>
+  struct HitRef {
+    std::uint64_t cellID;
+    const CollectionT* collection;
+    std::size_t index;
+    float time;
+  };
+
+  /// Indices of the hits of a collection, sorted by cellID
+  template <typename CollectionT>
+  std::vector<std::size_t> CellIDOrder(const CollectionT& hits) {
+    std::vector<std::size_t> order(hits.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&hits](std::size_t a, std::size_t b) { return hits[a].getCellID() < hits[b].getCellID(); });
+    return order;
+  }
+
+  /// All the hits of the signal and of the background, by cellID with the signal first in a cell.
+  /// The background collections are sorted once in the cache, so that they are only merged here.
+  template <typename CollectionT, typename BackgroundF>
+  std::vector<HitRef<CollectionT>> SortedHits(const CollectionT& signal, const std::vector<PodioBackgroundMixer::Pick>& picks,
+                                              BackgroundF&& background) {
+    std::vector<HitRef<CollectionT>> hits;
+    hits.reserve(signal.size());
+    for (std::size_t i : CellIDOrder(signal)) {
+      hits.push_back({signal[i].getCellID(), &signal, i, 0.f});
+    }
+    const auto by_cellID = [](const auto& a, const auto& b) { return a.cellID < b.cellID; };
+    for (const auto& pick : picks) {
+      const auto [collection, order] = background(pick);
+      if (collection == nullptr) {
+        continue;
+      }
+      const std::size_t middle = hits.size();
+      for (std::size_t i : *order) {
+        hits.push_back({(*collection)[i].getCellID(), collection, i, pick.time});
+      }
+      std::inplace_merge(hits.begin(), hits.begin() + middle, hits.end(), by_cellID);
+    }
+    return hits;
+  }
+
+}
+
+PodioBackgroundMixer::PodioBackgroundMixer(const std::vector<Source>& sources, double time_window,
+                                           std::size_t cache_size, const std::set<std::string>& collections,
+                                           std::uint64_t seed)
+    : m_time_window(time_window), m_collections(collections), m_generator(seed) {
+  if (time_window <= 0) {
+    throw std::runtime_error("the background time window must be positive");
+  }
+  for (const auto& source : sources) {
+    Load(source, cache_size, collections.empty());
+  }
+}
+
+void PodioBackgroundMixer::Load(const Source& source, std::size_t cache_size, bool all_collections) {
+  PodioFrameReader reader;
+  reader.openFile(source.filename);
+  const std::size_t entries = std::min(cache_size, reader.getEntries("events"));
+  if (entries == 0) {
+    throw std::runtime_error("no background entries to cache from " + source.filename);
+  }
+
+  // the collections of the file, from its first entry
+  const podio::Frame first(reader.readEntry("events", 0));
+  const auto available = first.getAvailableCollections();
+  const auto has = [&available](const std::string& name) {
+    return std::find(available.begin(), available.end(), name) != available.end();
+  };
+  if (all_collections) {
+    for (const auto& name : available) {
+      const auto* collection = first.get(name);
+      if (dynamic_cast<const edm4hep::SimTrackerHitCollection*>(collection) != nullptr ||
+          dynamic_cast<const edm4hep::SimCalorimeterHitCollection*>(collection) != nullptr) {
+        m_collections.insert(name);
+      }
+    }
+  }
+
+  // the mixed hits, the calorimeter contributions and the particles that they point to
+  std::vector<std::string> mixed;
+  std::vector<std::string> to_read;
+  for (const auto& name : m_collections) {
+    if (has(name)) {
+      mixed.push_back(name);
+      to_read.push_back(name);
+      if (has(name + "Contributions")) {
+        to_read.push_back(name + "Contributions");
+      }
+    }
+  }
+  if (has("MCParticles")) {
+    to_read.push_back("MCParticles");
+  }
+
+  CachedSource cached{source, source.rate * m_time_window * 1e-9, {}};
+  cached.entries.reserve(entries);
+  for (std::size_t entry = 0; entry < entries; ++entry) {
+    CachedEntry cached_entry{std::make_unique<podio::Frame>(reader.readEntry("events", entry, to_read)), {}};
+    // unpacked here, so that the events never unpack the shared frames
+    for (const auto& name : to_read) {
+      cached_entry.frame->get(name);
+    }
+    for (const auto& name : mixed) {
+      const auto* collection = cached_entry.frame->get(name);
+      if (const auto* hits = dynamic_cast<const edm4hep::SimTrackerHitCollection*>(collection)) {
+        cached_entry.order[name] = CellIDOrder(*hits);
+      } else if (const auto* hits = dynamic_cast<const edm4hep::SimCalorimeterHitCollection*>(collection)) {
+        cached_entry.order[name] = CellIDOrder(*hits);
+      }
+    }
+    cached.entries.push_back(std::move(cached_entry));
+  }
+  m_sources.push_back(std::move(cached));
+}
+
+double PodioBackgroundMixer::MeanEvents() const {
+  double mean = 0;
+  for (const auto& source : m_sources) {
+    mean += source.mean;
+  }
+  return mean;
+}
+
+std::unique_ptr<PodioBackgroundMixer::Mixed> PodioBackgroundMixer::Draw() {
+  auto mixed = std::make_unique<Mixed>();
+  std::lock_guard<std::mutex> lock(m_generator_mutex);
+  std::uniform_real_distribution<float> time(0.f, static_cast<float>(m_time_window));
+  for (std::size_t s = 0; s < m_sources.size(); ++s) {
+    const auto& source = m_sources[s];
+    if (source.mean <= 0) {
+      continue;
+    }
+    std::poisson_distribution<std::size_t> count(source.mean);
+    std::uniform_int_distribution<std::size_t> entry(0, source.entries.size() - 1);
+    for (std::size_t n = count(m_generator); n > 0; --n) {
+      const std::size_t e = entry(m_generator);
+      mixed->picks.push_back({s, e, time(m_generator)});
+    }
+  }
+  return mixed;
+}
+
+const podio::CollectionBase* PodioBackgroundMixer::Merge(Mixed& mixed, const std::string& name,
+                                                         const podio::CollectionBase& signal) const {
+  // the collection of the background entry of a pick and its order by cellID, of the type of the signal
+  const auto background = [this, &name](const auto* signal_type) {
+    using CollectionT = std::remove_cv_t<std::remove_pointer_t<decltype(signal_type)>>;
+    return [this, &name](const Pick& pick) -> std::pair<const CollectionT*, const std::vector<std::size_t>*> {
+      const auto& entry = m_sources[pick.source].entries[pick.entry];
+      const auto order = entry.order.find(name);
+      if (order == entry.order.end()) {
+        return {nullptr, nullptr};
+      }
+      return {dynamic_cast<const CollectionT*>(entry.frame->get(name)), &order->second};
+    };
+  };
+
+  if (const auto* tracker = dynamic_cast<const edm4hep::SimTrackerHitCollection*>(&signal)) {
+    // the hits of a pixel are only grouped by the digitization
+    auto merged = std::make_unique<edm4hep::SimTrackerHitCollection>();
+    for (const auto& ref : SortedHits(*tracker, mixed.picks, background(tracker))) {
+      auto hit = (*ref.collection)[ref.index].clone();
+      if (ref.collection != tracker) {
+        hit.setTime(hit.getTime() + ref.time);
+      }
+      merged->push_back(hit);
+    }
+    mixed.collections.push_back(std::move(merged));
+    return mixed.collections.back().get();
+  }
+
+  if (const auto* calorimeter = dynamic_cast<const edm4hep::SimCalorimeterHitCollection*>(&signal)) {
+    const auto hits = SortedHits(*calorimeter, mixed.picks, background(calorimeter));
+    auto merged = std::make_unique<edm4hep::SimCalorimeterHitCollection>();
+    auto contributions = std::make_unique<edm4hep::CaloHitContributionCollection>();
+    for (auto begin = hits.begin(); begin != hits.end();) {
+      const auto end = std::find_if(begin, hits.end(), [&begin](const auto& ref) { return ref.cellID != begin->cellID; });
+      const auto first = (*begin->collection)[begin->index];
+      if (end - begin == 1 && begin->collection == calorimeter) {
+        merged->push_back(first.clone());
+        begin = end;
+        continue;
+      }
+      // one hit of the cell, with the contributions of all of them
+      edm4hep::MutableSimCalorimeterHit hit;
+      hit.setCellID(first.getCellID());
+      hit.setPosition(first.getPosition());
+      double energy = 0;
+      for (auto ref = begin; ref != end; ++ref) {
+        const auto part = (*ref->collection)[ref->index];
+        energy += part.getEnergy();
+        for (const auto& contribution : part.getContributions()) {
+          if (ref->collection == calorimeter) {
+            hit.addToContributions(contribution);
+          } else {
+            auto shifted = contribution.clone();
+            shifted.setTime(contribution.getTime() + ref->time);
+            contributions->push_back(shifted);
+            hit.addToContributions(shifted);
+          }
+        }
+      }
+      hit.setEnergy(static_cast<float>(energy));
+      merged->push_back(hit);
+      begin = end;
+    }
+    const auto* result = merged.get();
+    mixed.collections.push_back(std::move(merged));
+    mixed.collections.push_back(std::move(contributions));
+    return result;
+  }
+
+  throw std::runtime_error("can not mix the background into " + name + ", which is no SimTrackerHit or SimCalorimeterHit collection");
+}
+
+} // namespace eicrecon
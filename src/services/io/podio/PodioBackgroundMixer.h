@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <podio/CollectionBase.h>
+#include <podio/Frame.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * Mixing of background events into the signal events as they are read, with
+ * `-Ppodio:background_files=<file>,...`.
+ *
+ * The first `podio:background_cache` entries of every background file are
+ * read and unpacked once, at the start, and reused for all the events. For
+ * every signal event, the number of events of each background file is drawn
+ * from a Poisson distribution whose mean is its rate times the time window,
+ * each with a random cached entry and a time offset uniform in the window.
+ *
+ * The hits of the mixed SimTrackerHit and SimCalorimeterHit collections of
+ * these entries are merged with the ones of the signal into collections that
+ * are sorted by cellID, with their times shifted by the offsets. Calorimeter
+ * hits of the same cell are summed into one hit with the contributions of
+ * all of them, so that the digitization sees one hit per cell as from the
+ * simulation.
+ */
+class PodioBackgroundMixer {
+public:
+  struct Source {
+    std::string filename;
+    double rate{0}; // Hz
+  };
+
+  /// Background entry mixed into an event
+  struct Pick {
+    std::size_t source;
+    std::size_t entry; // of the cache of the source
+    float time;        // ns
+  };
+
+  /// The background of one event, and the merged collections that it owns
+  struct Mixed {
+    std::vector<Pick> picks;
+    std::vector<std::unique_ptr<podio::CollectionBase>> collections;
+  };
+
+  /// Reads the caches of the sources, throws std::runtime_error if a file can not be read. The
+  /// collections to mix are all the SimTrackerHit and SimCalorimeterHit ones if empty.
+  PodioBackgroundMixer(const std::vector<Source>& sources, double time_window, std::size_t cache_size,
+                       const std::set<std::string>& collections, std::uint64_t seed);
+
+  /// Whether the signal collection of this name is replaced by a merged one
+  bool Mixes(const std::string& name) const { return m_collections.count(name) > 0; }
+
+  const std::set<std::string>& collections() const { return m_collections; }
+
+  /// Draws the background entries of the next event
+  std::unique_ptr<Mixed> Draw();
+
+  /// The signal collection merged with the background of the event, owned by mixed
+  const podio::CollectionBase* Merge(Mixed& mixed, const std::string& name, const podio::CollectionBase& signal) const;
+
+  /// Mean number of background events per signal event, of all the sources
+  double MeanEvents() const;
+
+private:
+  struct CachedEntry {
+    std::unique_ptr<podio::Frame> frame;
+    std::map<std::string, std::vector<std::size_t>> order; // of the hits by cellID, per mixed collection
+  };
+
+  struct CachedSource {
+    Source source;
+    double mean{0};
+    std::vector<CachedEntry> entries;
+  };
+
+  void Load(const Source& source, std::size_t cache_size, bool all_collections);
+
+  double m_time_window;
+  std::set<std::string> m_collections;
+  std::vector<CachedSource> m_sources;
+  std::mutex m_generator_mutex;
+  std::mt19937_64 m_generator;
+};
+
+} // namespace eicrecon
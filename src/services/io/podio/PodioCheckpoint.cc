@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "PodioCheckpoint.h"
+
+#include <fmt/core.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace eicrecon {
+
+PodioEntryRanges ToEntryRanges(const std::set<std::size_t>& entries) {
+  PodioEntryRanges ranges;
+  for (const std::size_t entry : entries) {
+    if (!ranges.empty() && ranges.back().second == entry) {
+      ranges.back().second = entry + 1;
+    } else {
+      ranges.emplace_back(entry, entry + 1);
+    }
+  }
+  return ranges;
+}
+
+PodioEntryRanges SubtractEntryRanges(const PodioEntryRanges& ranges, const PodioEntryRanges& done) {
+  PodioEntryRanges left;
+  for (auto [first, end] : ranges) {
+    for (const auto& [done_first, done_end] : done) {
+      if (done_end <= first || done_first >= end) {
+        continue;
+      }
+      if (done_first > first) {
+        left.emplace_back(first, done_first);
+      }
+      first = std::max(first, done_end);
+      if (first >= end) {
+        break;
+      }
+    }
+    if (first < end) {
+      left.emplace_back(first, end);
+    }
+  }
+  return left;
+}
+
+PodioCheckpointManifest PodioCheckpointManifest::read(const std::string& path) {
+  std::ifstream in(path);
+  if (!in) {
+    throw std::runtime_error(fmt::format("Can not open the checkpoint manifest {}", path));
+  }
+  PodioCheckpointManifest manifest;
+  std::string line;
+  std::size_t line_number = 0;
+  while (std::getline(in, line)) {
+    ++line_number;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::vector<std::string> fields;
+    std::istringstream ss(line);
+    for (std::string field; std::getline(ss, field, '\t');) {
+      fields.push_back(field);
+    }
+    const auto bad = [&]() {
+      return std::runtime_error(fmt::format("{}:{}: expected \"chunk <file> <events>\" or \"input <file> <ranges>\"", path, line_number));
+    };
+    if (fields.size() != 3) {
+      throw bad();
+    }
+    if (fields[0] == "chunk") {
+      manifest.chunks.push_back({fields[1], std::stoul(fields[2]), {}});
+    } else if (fields[0] == "input" && !manifest.chunks.empty()) {
+      auto& ranges = manifest.chunks.back().inputs[fields[1]];
+      std::istringstream rs(fields[2]);
+      for (std::string range; std::getline(rs, range, ',');) {
+        std::size_t first = 0, last = 0;
+        char dash = 0;
+        std::istringstream r(range);
+        if (!(r >> first >> dash >> last) || dash != '-' || last < first) {
+          throw bad();
+        }
+        ranges.emplace_back(first, last + 1);
+      }
+    } else {
+      throw bad();
+    }
+  }
+  return manifest;
+}
+
+void PodioCheckpointManifest::write(const std::string& path) const {
+  // written next to the target and renamed, so that a stopped job never leaves a partial manifest
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    out << "# eicrecon checkpoint manifest: the completed chunks and their input entries\n";
+    for (const auto& chunk : chunks) {
+      out << "chunk\t" << chunk.file << '\t' << chunk.events << '\n';
+      for (const auto& [input, ranges] : chunk.inputs) {
+        std::vector<std::string> text;
+        for (const auto& [first, end] : ranges) {
+          text.push_back(fmt::format("{}-{}", first, end - 1));
+        }
+        out << "input\t" << input << '\t' << fmt::format("{}", fmt::join(text, ",")) << '\n';
+      }
+    }
+    if (!out) {
+      throw std::runtime_error(fmt::format("Can not write the checkpoint manifest {}", tmp_path));
+    }
+  }
+  std::filesystem::rename(tmp_path, path);
+}
+
+PodioEntryRanges PodioCheckpointManifest::done(const std::string& input) const {
+  PodioEntryRanges ranges;
+  for (const auto& chunk : chunks) {
+    const auto it = chunk.inputs.find(input);
+    if (it != chunk.inputs.end()) {
+      ranges.insert(ranges.end(), it->second.begin(), it->second.end());
+    }
+  }
+  std::sort(ranges.begin(), ranges.end());
+  PodioEntryRanges merged;
+  for (const auto& [first, end] : ranges) {
+    if (!merged.empty() && first <= merged.back().second) {
+      merged.back().second = std::max(merged.back().second, end);
+    } else {
+      merged.emplace_back(first, end);
+    }
+  }
+  return merged;
+}
+
+PodioCheckpointWriter::PodioCheckpointWriter(const std::string& filename, const std::vector<std::string>& formats,
+                                             std::size_t chunk_events, const std::string& manifest,
+                                             const std::string& resume_from, const PodioWriteTuning& tuning)
+  : m_filename(filename), m_formats(formats), m_chunk_events(chunk_events), m_manifest_path(manifest),
+    m_tuning(tuning) {
+  if (!resume_from.empty()) {
+    m_manifest = PodioCheckpointManifest::read(resume_from);
+  }
+}
+
+std::string PodioCheckpointWriter::DefaultManifest(const std::string& filename) {
+  return std::filesystem::path(filename).replace_extension(".manifest").string();
+}
+
+std::string PodioCheckpointWriter::ChunkFilename(std::size_t chunk) const {
+  return std::filesystem::path(m_filename).replace_extension(fmt::format(".chunk{:04}.root", chunk)).string();
+}
+
+void PodioCheckpointWriter::writeFrame(const podio::Frame* frame, const std::vector<std::string>& collections,
+                                       const PodioInputEntry* input) {
+  if (m_writers.empty()) {
+    // a chunk that is not closed is written again by the resumed job
+    m_writers = MakePodioWriters(ChunkFilename(m_manifest.chunks.size()), m_formats, m_tuning);
+  }
+  if (frame != nullptr) {
+    for (auto& writer : m_writers) {
+      writer->writeFrame(*frame, "events", collections);
+    }
+    ++m_events;
+  }
+  if (input != nullptr) {
+    m_entries[input->file].insert(input->entry);
+  }
+  if (m_events >= m_chunk_events) {
+    CloseChunk();
+  }
+}
+
+void PodioCheckpointWriter::CloseChunk() {
+  PodioCheckpointManifest::Chunk chunk{m_writers.front()->filename(), m_events, {}};
+  for (auto& writer : m_writers) {
+    writer->finish();
+  }
+  m_writers.clear();
+  for (const auto& [input, entries] : m_entries) {
+    chunk.inputs[input] = ToEntryRanges(entries);
+  }
+  m_manifest.chunks.push_back(std::move(chunk));
+  m_manifest.write(m_manifest_path);
+  m_events = 0;
+  m_entries.clear();
+}
+
+void PodioCheckpointWriter::finish(spdlog::logger& log) {
+  if (!m_writers.empty() && (m_events > 0 || !m_entries.empty())) {
+    CloseChunk();
+  } else {
+    for (auto& writer : m_writers) {
+      writer->finish();
+    }
+    m_writers.clear();
+  }
+  std::size_t events = 0;
+  for (const auto& chunk : m_manifest.chunks) {
+    events += chunk.events;
+  }
+  log.info("Wrote {} events to {} chunks of {}, listed in {}", events, m_manifest.chunks.size(), m_filename,
+           m_manifest_path);
+}
+
+} // namespace eicrecon
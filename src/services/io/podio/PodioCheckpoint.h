@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <podio/Frame.h>
+#include <spdlog/logger.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PodioFrameIO.h"
+
+namespace eicrecon {
+
+/// [first, end) entries of an input file
+using PodioEntryRanges = std::vector<std::pair<std::size_t, std::size_t>>;
+
+/// Ranges of a set of entries, merged
+PodioEntryRanges ToEntryRanges(const std::set<std::size_t>& entries);
+
+/// The entries of ranges that are not in done, both sorted and merged
+PodioEntryRanges SubtractEntryRanges(const PodioEntryRanges& ranges, const PodioEntryRanges& done);
+
+/// Input file and entry of an event, inserted into the event by JEventSourcePODIO
+struct PodioInputEntry {
+  std::string file;
+  std::size_t entry = 0;
+};
+
+/// Position of an event in the order of the input, from 0, inserted by JEventSourcePODIO with podio:ordered_write
+struct PodioEventSequence {
+  std::uint64_t index = 0;
+};
+
+/**
+ * The completed output chunks of a checkpointed job, and the input entries
+ * that went into each of them, in a text file:
+ *
+ *     chunk <TAB> out.chunk0000.root <TAB> 1000
+ *     input <TAB> in.edm4hep.root <TAB> 0-499,512-1011
+ *
+ * A chunk is only listed once its file is closed, so that a job that is
+ * stopped at any time can be resumed from the chunks of its manifest.
+ */
+struct PodioCheckpointManifest {
+  struct Chunk {
+    std::string file;
+    std::size_t events = 0;
+    std::map<std::string, PodioEntryRanges> inputs;
+  };
+  std::vector<Chunk> chunks;
+
+  /// Throws std::runtime_error if the file can not be read or parsed
+  static PodioCheckpointManifest read(const std::string& path);
+
+  /// Replaces the file at once, a stopped job leaves the previous one
+  void write(const std::string& path) const;
+
+  /// The entries of an input file in all the chunks
+  PodioEntryRanges done(const std::string& input) const;
+};
+
+/**
+ * Writes the events to numbered chunks `<stem>.chunk<k>.root` of
+ * `-Ppodio:checkpoint_events=N` events each. Every chunk is closed and added
+ * to the manifest once it is full, together with the input entries that it
+ * holds. The entries of the events that are not written, e.g. that fail
+ * podio:filter, belong to the chunk as well. With a manifest to resume from,
+ * the chunks continue after the ones of the manifest.
+ *
+ * Not thread safe, the caller serialises the calls.
+ */
+class PodioCheckpointWriter {
+public:
+  /// Throws std::runtime_error as MakePodioWriters, or if resume_from can not be read
+  PodioCheckpointWriter(const std::string& filename, const std::vector<std::string>& formats,
+                        std::size_t chunk_events, const std::string& manifest,
+                        const std::string& resume_from, const PodioWriteTuning& tuning = {});
+
+  /// Default manifest of an output file, `<stem>.manifest`
+  static std::string DefaultManifest(const std::string& filename);
+
+  /// Writes the frame of an input entry to the current chunk, or only counts the entry without a frame
+  void writeFrame(const podio::Frame* frame, const std::vector<std::string>& collections,
+                  const PodioInputEntry* input);
+
+  /// Closes the last chunk, if it holds any events
+  void finish(spdlog::logger& log);
+
+private:
+  std::string ChunkFilename(std::size_t chunk) const;
+
+  void CloseChunk();
+
+  std::string m_filename;
+  std::vector<std::string> m_formats;
+  std::size_t m_chunk_events;
+  std::string m_manifest_path;
+  PodioWriteTuning m_tuning;
+  PodioCheckpointManifest m_manifest;
+
+  // the chunk being written
+  std::vector<std::unique_ptr<PodioFrameWriter>> m_writers;
+  std::size_t m_events = 0;
+  std::map<std::string, std::set<std::size_t>> m_entries;
+};
+
+} // namespace eicrecon
@@ -0,0 +1,300 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "PodioEventFilter.h"
+
+#include <TClass.h>
+#include <TDataMember.h>
+#include <TDataType.h>
+#include <TRealData.h>
+#include <TVirtualCollectionProxy.h>
+#include <podio/CollectionBuffers.h>
+#include <cctype>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+struct PodioEventFilter::Node {
+  enum class Kind { Or, And, Not, Compare };
+  enum class Op { NotZero, Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+  Kind kind{Kind::Compare};
+  std::vector<std::unique_ptr<Node>> children;
+
+  // of Kind::Compare
+  std::string collection;
+  long index{-1}; // -1 for the size of the collection
+  std::string member;
+  Op op{Op::NotZero};
+  double value{0};
+};
+
+namespace {
+
+  using Node = PodioEventFilter::Node;
+
+  class Parser {
+  public:
+    Parser(const std::string& text, std::set<std::string>& collections) : m_text(text), m_collections(collections) {}
+
+    std::unique_ptr<Node> Parse() {
+      auto node = ParseOr();
+      SkipSpaces();
+      if (m_pos != m_text.size()) {
+        Fail("unexpected '" + std::string(m_text.substr(m_pos)) + "'");
+      }
+      return node;
+    }
+
+  private:
+    std::unique_ptr<Node> ParseOr() {
+      auto node = ParseAnd();
+      while (Accept("||")) {
+        node = Combine(Node::Kind::Or, std::move(node), ParseAnd());
+      }
+      return node;
+    }
+
+    std::unique_ptr<Node> ParseAnd() {
+      auto node = ParseUnary();
+      while (Accept("&&")) {
+        node = Combine(Node::Kind::And, std::move(node), ParseUnary());
+      }
+      return node;
+    }
+
+    std::unique_ptr<Node> ParseUnary() {
+      if (Accept("!")) {
+        auto node = std::make_unique<Node>();
+        node->kind = Node::Kind::Not;
+        node->children.push_back(ParseUnary());
+        return node;
+      }
+      if (Accept("(")) {
+        auto node = ParseOr();
+        if (!Accept(")")) {
+          Fail("missing ')'");
+        }
+        return node;
+      }
+      return ParseComparison();
+    }
+
+    std::unique_ptr<Node> ParseComparison() {
+      auto node = std::make_unique<Node>();
+      node->collection = Identifier();
+      m_collections.insert(node->collection);
+      if (Accept("[")) {
+        SkipSpaces();
+        const std::size_t start = m_pos;
+        while (m_pos < m_text.size() && std::isdigit(static_cast<unsigned char>(m_text[m_pos]))) {
+          ++m_pos;
+        }
+        if (m_pos == start || !Accept("]")) {
+          Fail("expected an element index after '['");
+        }
+        node->index = std::stol(std::string(m_text.substr(start, m_pos - start)));
+        if (!Accept(".")) {
+          Fail("expected '.member' after the element index");
+        }
+        node->member = Identifier();
+        while (Accept(".")) {
+          node->member += "." + Identifier();
+        }
+      } else if (Accept(".")) {
+        if (Identifier() != "size") {
+          Fail("only the size of a collection or the members of its elements can be compared");
+        }
+      }
+
+      static const std::vector<std::pair<std::string_view, Node::Op>> ops = {
+          {"<=", Node::Op::LessEqual}, {">=", Node::Op::GreaterEqual}, {"==", Node::Op::Equal},
+          {"!=", Node::Op::NotEqual},  {"<", Node::Op::Less},          {">", Node::Op::Greater},
+      };
+      for (const auto& [symbol, op] : ops) {
+        if (Accept(symbol)) {
+          node->op    = op;
+          node->value = Number();
+          break;
+        }
+      }
+      return node;
+    }
+
+    static std::unique_ptr<Node> Combine(Node::Kind kind, std::unique_ptr<Node> a, std::unique_ptr<Node> b) {
+      auto node  = std::make_unique<Node>();
+      node->kind = kind;
+      node->children.push_back(std::move(a));
+      node->children.push_back(std::move(b));
+      return node;
+    }
+
+    std::string Identifier() {
+      SkipSpaces();
+      const std::size_t start = m_pos;
+      while (m_pos < m_text.size() &&
+             (std::isalnum(static_cast<unsigned char>(m_text[m_pos])) || m_text[m_pos] == '_')) {
+        ++m_pos;
+      }
+      if (m_pos == start) {
+        Fail("expected a name");
+      }
+      return std::string(m_text.substr(start, m_pos - start));
+    }
+
+    double Number() {
+      SkipSpaces();
+      const std::string rest(m_text.substr(m_pos));
+      char* end = nullptr;
+      const double value = std::strtod(rest.c_str(), &end);
+      if (end == rest.c_str()) {
+        Fail("expected a number");
+      }
+      m_pos += end - rest.c_str();
+      return value;
+    }
+
+    bool Accept(std::string_view symbol) {
+      SkipSpaces();
+      if (m_text.substr(m_pos, symbol.size()) != symbol) {
+        return false;
+      }
+      // "!" is not the start of "!="
+      if (symbol == "!" && m_text.substr(m_pos, 2) == "!=") {
+        return false;
+      }
+      m_pos += symbol.size();
+      return true;
+    }
+
+    void SkipSpaces() {
+      while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) {
+        ++m_pos;
+      }
+    }
+
+    [[noreturn]] void Fail(const std::string& message) const {
+      throw std::invalid_argument("podio:filter '" + std::string(m_text) + "': " + message + " at position " +
+                                  std::to_string(m_pos));
+    }
+
+    std::string_view m_text;
+    std::set<std::string>& m_collections;
+    std::size_t m_pos{0};
+  };
+
+  /// Where a member is in the elements of the data vector of a collection type
+  struct MemberAccessor {
+    TVirtualCollectionProxy* proxy{nullptr};
+    Long_t offset{0};
+    EDataType type{kNoType_t};
+  };
+
+  std::mutex g_accessor_mutex;
+
+  /// Found once from the ROOT dictionaries, g_accessor_mutex must be held
+  const MemberAccessor& Accessor(const std::string& data_type, const std::string& member) {
+    static std::map<std::pair<std::string, std::string>, MemberAccessor> accessors;
+    auto [it, inserted] = accessors.try_emplace({data_type, member});
+    if (inserted) {
+      auto* vector_class = TClass::GetClass(("vector<" + data_type + ">").c_str());
+      auto* data_class   = TClass::GetClass(data_type.c_str());
+      if (vector_class != nullptr && data_class != nullptr) {
+        data_class->BuildRealData();
+        auto* real_data = data_class->GetRealData(member.c_str());
+        auto* data_type_info =
+            (real_data == nullptr) ? nullptr : real_data->GetDataMember()->GetDataType();
+        if (data_type_info != nullptr) {
+          it->second.proxy  = vector_class->GetCollectionProxy();
+          it->second.offset = real_data->GetThisOffset();
+          it->second.type   = static_cast<EDataType>(data_type_info->GetType());
+        }
+      }
+    }
+    return it->second;
+  }
+
+  bool ToDouble(const char* address, EDataType type, double& value) {
+    switch (type) {
+    case kChar_t:     value = *reinterpret_cast<const Char_t*>(address); return true;
+    case kUChar_t:    value = *reinterpret_cast<const UChar_t*>(address); return true;
+    case kShort_t:    value = *reinterpret_cast<const Short_t*>(address); return true;
+    case kUShort_t:   value = *reinterpret_cast<const UShort_t*>(address); return true;
+    case kInt_t:      value = *reinterpret_cast<const Int_t*>(address); return true;
+    case kUInt_t:     value = *reinterpret_cast<const UInt_t*>(address); return true;
+    case kLong_t:     value = *reinterpret_cast<const Long_t*>(address); return true;
+    case kULong_t:    value = *reinterpret_cast<const ULong_t*>(address); return true;
+    case kLong64_t:   value = *reinterpret_cast<const Long64_t*>(address); return true;
+    case kULong64_t:  value = *reinterpret_cast<const ULong64_t*>(address); return true;
+    case kFloat_t:    value = *reinterpret_cast<const Float_t*>(address); return true;
+    case kDouble_t:   value = *reinterpret_cast<const Double_t*>(address); return true;
+    case kBool_t:     value = *reinterpret_cast<const Bool_t*>(address); return true;
+    default:          return false;
+    }
+  }
+
+  /// The member of an element, false if there is no such element or member
+  bool ElementValue(const podio::CollectionBase& collection, std::size_t index, const std::string& member,
+                    double& value) {
+    if (index >= collection.size()) {
+      return false;
+    }
+    // the data vector of the collection is only filled for writing
+    collection.prepareForWrite();
+    auto buffers = const_cast<podio::CollectionBase&>(collection).getBuffers();
+    if (buffers.data == nullptr) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(g_accessor_mutex);
+    const auto& accessor = Accessor(std::string(collection.getDataTypeName()), member);
+    if (accessor.proxy == nullptr) {
+      return false;
+    }
+    TVirtualCollectionProxy::TPushPop helper(accessor.proxy, buffers.data);
+    const auto* element = static_cast<const char*>(accessor.proxy->At(index));
+    return element != nullptr && ToDouble(element + accessor.offset, accessor.type, value);
+  }
+
+  bool Evaluate(const Node& node, const PodioEventFilter::CollectionGetter& get) {
+    switch (node.kind) {
+    case Node::Kind::Or:
+      return Evaluate(*node.children[0], get) || Evaluate(*node.children[1], get);
+    case Node::Kind::And:
+      return Evaluate(*node.children[0], get) && Evaluate(*node.children[1], get);
+    case Node::Kind::Not:
+      return !Evaluate(*node.children[0], get);
+    case Node::Kind::Compare:
+      break;
+    }
+
+    const auto* collection = get(node.collection);
+    double value = 0;
+    if (node.index < 0) {
+      value = (collection == nullptr) ? 0 : collection->size();
+    } else if (collection == nullptr || !ElementValue(*collection, node.index, node.member, value)) {
+      return false;
+    }
+    switch (node.op) {
+    case Node::Op::NotZero:      return value != 0;
+    case Node::Op::Less:         return value < node.value;
+    case Node::Op::LessEqual:    return value <= node.value;
+    case Node::Op::Greater:      return value > node.value;
+    case Node::Op::GreaterEqual: return value >= node.value;
+    case Node::Op::Equal:        return value == node.value;
+    case Node::Op::NotEqual:     return value != node.value;
+    }
+    return false;
+  }
+
+}
+
+PodioEventFilter::PodioEventFilter(const std::string& expression) : m_expression(expression) {
+  m_root = Parser(m_expression, m_collections).Parse();
+}
+
+PodioEventFilter::~PodioEventFilter() = default;
+
+bool PodioEventFilter::Pass(const CollectionGetter& get) const { return Evaluate(*m_root, get); }
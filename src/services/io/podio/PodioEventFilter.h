@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <podio/CollectionBase.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * Selection of the events to write, with `-Ppodio:filter=<expression>`.
+ *
+ * The expression combines comparisons of collections with `&&`, `||`, `!`
+ * and parentheses:
+ *
+ *   - `Name` or `Name.size`: the number of elements of the collection, so a
+ *     bare name keeps the events in which the factory of a filtering
+ *     collection selected anything;
+ *   - `Name[i].member`: a member of the i-th element, e.g. `energy`, `PDG`
+ *     or `momentum.z`, found from the ROOT dictionary of the data type of
+ *     the collection. The comparison is false if there is no such element.
+ *
+ * A comparison is `operand op number` with op one of `< <= > >= == !=`; an
+ * operand alone is true if it is not zero. For example
+ * `ScatteredElectronsEMinusPz.size > 0 || ReconstructedJets[0].energy > 10`.
+ */
+class PodioEventFilter {
+public:
+  /// Returns the collection of a name, nullptr if it can not be made
+  using CollectionGetter = std::function<const podio::CollectionBase*(const std::string&)>;
+
+  /// Throws std::invalid_argument if the expression can not be parsed
+  explicit PodioEventFilter(const std::string& expression);
+  ~PodioEventFilter();
+
+  const std::string& expression() const { return m_expression; }
+
+  /// The collections that the expression looks at, to be made before the others
+  const std::set<std::string>& collections() const { return m_collections; }
+
+  bool Pass(const CollectionGetter& get) const;
+
+  struct Node;
+
+private:
+  std::string m_expression;
+  std::set<std::string> m_collections;
+  std::unique_ptr<Node> m_root;
+};
@@ -0,0 +1,198 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "PodioEventIndex.h"
+
+#include <edm4hep/EventHeaderCollection.h>
+#include <fmt/core.h>
+#include <podio/Frame.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+
+#include "services/geometry/disk_cache/CacheFile.h"
+
+namespace eicrecon {
+
+namespace {
+
+  PodioEventSelection ParseSelection(const std::string& item) {
+    PodioEventSelection selection;
+    std::istringstream ss(item);
+    std::uint64_t first = 0;
+    char colon = 0;
+    if (!(ss >> first)) {
+      throw std::runtime_error(fmt::format("podio:event_list: expected \"event\" or \"run:event\", not \"{}\"", item));
+    }
+    if (ss >> colon) {
+      if (colon != ':' || !(ss >> selection.event) || !(ss >> std::ws).eof()) {
+        throw std::runtime_error(fmt::format("podio:event_list: expected \"event\" or \"run:event\", not \"{}\"", item));
+      }
+      selection.run = static_cast<std::uint32_t>(first);
+    } else {
+      selection.event = first;
+    }
+    return selection;
+  }
+
+}
+
+std::vector<PodioEventSelection> ParsePodioEventList(const std::string& list) {
+  std::vector<PodioEventSelection> selections;
+  std::istringstream items(list);
+  for (std::string item; std::getline(items, item, ',');) {
+    item.erase(0, item.find_first_not_of(" \t"));
+    item.erase(item.find_last_not_of(" \t") + 1);
+    if (item.empty()) {
+      continue;
+    }
+    if (item[0] != '@') {
+      selections.push_back(ParseSelection(item));
+      continue;
+    }
+    const std::string path = item.substr(1);
+    std::ifstream in(path);
+    if (!in) {
+      throw std::runtime_error(fmt::format("podio:event_list: can not open {}", path));
+    }
+    for (std::string line; std::getline(in, line);) {
+      line = line.substr(0, line.find('#'));
+      std::istringstream words(line);
+      for (std::string word; words >> word;) {
+        selections.push_back(ParseSelection(word));
+      }
+    }
+  }
+  return selections;
+}
+
+PodioEventIndex PodioEventIndex::load(PodioFrameReader& reader, const std::string& filename, std::size_t entries) {
+  // the sources of the same file, e.g. of --fork workers or of podio:run_forever, share the index
+  static std::mutex mutex;
+  static std::map<std::string, PodioEventIndex> indices;
+  std::error_code ec;
+  std::string key = std::filesystem::weakly_canonical(filename, ec).string();
+  if (ec) {
+    key = filename;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto known = indices.find(key);
+  if (known != indices.end() && known->second.size() == entries) {
+    return known->second;
+  }
+
+  std::optional<PodioEventIndex> index;
+  try {
+    index = read(filename, entries);
+  } catch (const std::runtime_error&) {
+    // an unreadable cache is built again
+  }
+  if (!index) {
+    index.emplace();
+    index->m_ids.reserve(entries);
+    for (std::size_t entry = 0; entry < entries; ++entry) {
+      podio::Frame frame(reader.readEntry("events", entry, {"EventHeader"}));
+      const auto& headers = frame.get<edm4hep::EventHeaderCollection>("EventHeader");
+      if (headers.empty()) {
+        throw std::runtime_error(fmt::format("Entry {} of {} has no EventHeader to index", entry, filename));
+      }
+      index->m_ids.emplace_back(headers[0].getRunNumber(), headers[0].getEventNumber());
+    }
+    try {
+      index->write(filename);
+    } catch (const std::exception&) {
+      // e.g. a read-only directory, the index is only kept in memory
+    }
+  }
+  indices[key] = *index;
+  return *index;
+}
+
+std::pair<std::set<std::size_t>, std::size_t> PodioEventIndex::entries(const std::vector<PodioEventSelection>& selections) const {
+  std::unordered_multimap<std::uint64_t, std::size_t> by_event;
+  by_event.reserve(m_ids.size());
+  for (std::size_t entry = 0; entry < m_ids.size(); ++entry) {
+    by_event.emplace(m_ids[entry].second, entry);
+  }
+
+  std::set<std::size_t> selected;
+  std::size_t found = 0;
+  for (const auto& selection : selections) {
+    bool any = false;
+    const auto [first, last] = by_event.equal_range(selection.event);
+    for (auto it = first; it != last; ++it) {
+      if (!selection.run || m_ids[it->second].first == *selection.run) {
+        selected.insert(it->second);
+        any = true;
+      }
+    }
+    found += any ? 1 : 0;
+  }
+  return {selected, found};
+}
+
+std::optional<PodioEventIndex> PodioEventIndex::read(const std::string& filename, std::size_t entries) {
+  const std::string path = cachePath(filename);
+  std::error_code ec;
+  if (!std::filesystem::exists(path, ec)) {
+    return std::nullopt;
+  }
+  // the cache of a file that was rewritten is stale
+  const auto file_time = std::filesystem::last_write_time(filename, ec);
+  if (!ec && std::filesystem::last_write_time(path, ec) < file_time) {
+    return std::nullopt;
+  }
+
+  std::ifstream in(path);
+  if (!in) {
+    throw std::runtime_error(fmt::format("Can not open the event index {}", path));
+  }
+  std::string line;
+  std::size_t cached_entries = 0;
+  if (!std::getline(in, line) || std::sscanf(line.c_str(), "# eicrecon event index: %zu entries", &cached_entries) != 1) {
+    throw std::runtime_error(fmt::format("{} is not an event index", path));
+  }
+  if (cached_entries != entries) {
+    return std::nullopt;
+  }
+
+  PodioEventIndex index;
+  index.m_ids.reserve(entries);
+  while (std::getline(in, line)) {
+    std::uint32_t run = 0;
+    std::uint64_t event = 0;
+    std::istringstream ss(line);
+    if (!(ss >> run >> event)) {
+      throw std::runtime_error(fmt::format("{}:{}: expected \"<run> <event>\"", path, index.m_ids.size() + 2));
+    }
+    index.m_ids.emplace_back(run, event);
+  }
+  if (index.m_ids.size() != entries) {
+    throw std::runtime_error(fmt::format("{} is truncated", path));
+  }
+  index.m_cached = true;
+  return index;
+}
+
+void PodioEventIndex::write(const std::string& filename) const {
+  // written atomically, the --fork workers may read the index concurrently
+  cache_file::write_atomically(cachePath(filename), [this](const std::filesystem::path& tmp_path) {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    out << "# eicrecon event index: " << m_ids.size() << " entries\n";
+    for (const auto& [run, event] : m_ids) {
+      out << run << '\t' << event << '\n';
+    }
+    if (!out) {
+      throw std::runtime_error(fmt::format("Can not write the event index {}", tmp_path.string()));
+    }
+  });
+}
+
+} // namespace eicrecon
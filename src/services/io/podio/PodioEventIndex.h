@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PodioFrameIO.h"
+
+namespace eicrecon {
+
+/// An event of podio:event_list, any run if run is std::nullopt
+struct PodioEventSelection {
+  std::optional<std::uint32_t> run;
+  std::uint64_t event = 0;
+};
+
+/// The events of a podio:event_list, comma separated "event" or "run:event", or "@file" with one
+/// of these per line (# starts a comment). Throws std::runtime_error for anything else.
+std::vector<PodioEventSelection> ParsePodioEventList(const std::string& list);
+
+/**
+ * The run and event numbers of the EventHeader of every entry of an input
+ * file, to find the entries of given events without reading the file in order.
+ *
+ * The index is built by reading only the EventHeader of the entries, once,
+ * and kept in memory for the other sources of the same file. It is also
+ * cached as `<file>.evindex` beside the file, one line per entry:
+ *
+ *     # eicrecon event index: 10000 entries
+ *     1 <TAB> 4711
+ *
+ * The cache is used as long as it is newer than the file and has as many
+ * entries. A file in a directory that is not writable is only indexed in
+ * memory.
+ */
+class PodioEventIndex {
+public:
+  /// The index of a file that the reader has open with the given number of entries
+  static PodioEventIndex load(PodioFrameReader& reader, const std::string& filename, std::size_t entries);
+
+  /// Path of the cache of the index of a file
+  static std::string cachePath(const std::string& filename) { return filename + ".evindex"; }
+
+  std::size_t size() const { return m_ids.size(); }
+
+  /// The selected entries of the file, and the number of the selections found in it
+  std::pair<std::set<std::size_t>, std::size_t> entries(const std::vector<PodioEventSelection>& selections) const;
+
+  /// Whether the index was read from the cache rather than built
+  bool cached() const { return m_cached; }
+
+private:
+  /// The cache of a file, throws std::runtime_error if it can not be read, std::nullopt if it is stale
+  static std::optional<PodioEventIndex> read(const std::string& filename, std::size_t entries);
+
+  /// Replaces the cache of a file at once, throws std::runtime_error if it can not be written
+  void write(const std::string& filename) const;
+
+  std::vector<std::pair<std::uint32_t, std::uint64_t>> m_ids; // run and event of every entry
+  bool m_cached{false};
+};
+
+} // namespace eicrecon
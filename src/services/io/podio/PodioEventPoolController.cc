@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "PodioEventPoolController.h"
+
+#include <fmt/core.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace eicrecon {
+
+PodioEventPoolController& PodioEventPoolController::instance() {
+  static PodioEventPoolController controller;
+  return controller;
+}
+
+void PodioEventPoolController::configure(std::size_t limit_bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_limit_bytes = limit_bytes;
+}
+
+bool PodioEventPoolController::admit() {
+  const std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now().time_since_epoch())
+                               .count();
+  auto next = m_next_sample_ns.load(std::memory_order_relaxed);
+  // one of the sources samples, the others go on with the current limit
+  if (now >= next && m_next_sample_ns.compare_exchange_strong(next, now + m_sample_interval_ns)) {
+    if (const auto rss = residentBytes(); rss > 0) {
+      update(rss);
+    }
+  }
+  if (m_in_flight.load(std::memory_order_relaxed) < m_events_limit.load(std::memory_order_relaxed)) {
+    return true;
+  }
+  m_throttled.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void PodioEventPoolController::enter() {
+  const auto in_flight = m_in_flight.fetch_add(1, std::memory_order_relaxed) + 1;
+  auto max_in_flight = m_max_in_flight.load(std::memory_order_relaxed);
+  while (in_flight > max_in_flight &&
+         !m_max_in_flight.compare_exchange_weak(max_in_flight, in_flight, std::memory_order_relaxed)) {
+  }
+}
+
+void PodioEventPoolController::leave() { m_in_flight.fetch_sub(1, std::memory_order_relaxed); }
+
+void PodioEventPoolController::observeEventBytes(std::size_t bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // the mean over the last few hundred events follows a change of the event sample
+  m_event_bytes = (m_event_bytes == 0) ? bytes : m_event_bytes + (bytes - m_event_bytes) / 256.;
+}
+
+void PodioEventPoolController::update(std::size_t rss_bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_limit_bytes == 0) {
+    return;
+  }
+  m_peak_rss = std::max(m_peak_rss, rss_bytes);
+
+  const auto limit = m_events_limit.load(std::memory_order_relaxed);
+  const double target = 0.9 * m_limit_bytes;
+  double wanted = 0;
+  if (m_event_bytes > 0) {
+    // the events in flight are in the RSS already, the headroom is for the ones to come
+    const double headroom = target - static_cast<double>(rss_bytes);
+    wanted = m_in_flight.load(std::memory_order_relaxed) + headroom / (m_event_overhead * m_event_bytes);
+  } else if (rss_bytes < target) {
+    wanted = limit + 1;
+  } else if (rss_bytes > 0.95 * m_limit_bytes) {
+    wanted = limit - std::max<std::size_t>(1, limit / 4);
+  } else {
+    wanted = limit;
+  }
+  wanted = std::min(wanted, static_cast<double>(limit + 1));
+  wanted = std::min(wanted, static_cast<double>(m_max_in_flight.load(std::memory_order_relaxed) + 1));
+
+  const auto new_limit = static_cast<std::size_t>(std::max(wanted, 1.));
+  m_events_limit.store(new_limit, std::memory_order_relaxed);
+  m_min_limit = std::min(m_min_limit, new_limit);
+  m_max_limit = std::max(m_max_limit, new_limit);
+}
+
+std::string PodioEventPoolController::summary() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_limit_bytes == 0 || m_summarized) {
+    return {};
+  }
+  m_summarized = true;
+  return fmt::format("{}-{} events in flight under podio:memory_limit_mb={}, {} reads waited, peak RSS {:.1f} MB",
+                     m_min_limit, m_max_limit, m_limit_bytes >> 20, m_throttled.load(),
+                     m_peak_rss / 1024. / 1024.);
+}
+
+std::size_t PodioEventPoolController::residentBytes() {
+#if defined(__linux__)
+  // size and resident pages
+  std::ifstream statm("/proc/self/statm");
+  std::size_t size = 0, resident = 0;
+  if (statm >> size >> resident) {
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  }
+#endif
+  return 0;
+}
+
+} // namespace eicrecon
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace eicrecon {
+
+/**
+ * Number of the events in flight under a limit of the resident set size,
+ * with `-Ppodio:memory_limit_mb=M`.
+ *
+ * JEventSourcePODIO asks admit() before it reads an event and tells JANA to
+ * try again while the events in flight are at the current limit. The limit
+ * follows the RSS of the process, sampled every few milliseconds, and the
+ * live bytes per event of the collection accounting of JEventProcessorPODIO
+ * (PodioMemoryReport): it is set to the number of events that fit into the
+ * headroom below 90% of M, growing by at most one event per sample and
+ * shrinking at once. Without the accounting, e.g. without an output file, it
+ * grows while the RSS is below 90% of M and shrinks by a quarter above 95%.
+ * It never goes below one event, so that the job always progresses, and
+ * never far above the events that JANA has actually put in flight, bounded
+ * by `jana:nevents_in_pool`.
+ */
+class PodioEventPoolController {
+public:
+  static PodioEventPoolController& instance();
+
+  /// Turns the control on with a limit of the RSS, off with 0
+  void configure(std::size_t limit_bytes);
+
+  bool enabled() const { return m_limit_bytes > 0; }
+
+  /// Whether one more event may be read, samples the RSS if it is due
+  bool admit();
+
+  /// An event in flight, inserted into the JEvent, which leaves when the event is recycled
+  struct Token {
+    Token() { PodioEventPoolController::instance().enter(); }
+    ~Token() { PodioEventPoolController::instance().leave(); }
+    Token(const Token&) = delete;
+    Token& operator=(const Token&) = delete;
+  };
+
+  /// Live bytes of the collections of a processed event
+  void observeEventBytes(std::size_t bytes);
+
+  /// New limit of the events in flight for an RSS, called by admit()
+  void update(std::size_t rss_bytes);
+
+  std::size_t eventsLimit() const { return m_events_limit.load(std::memory_order_relaxed); }
+
+  /// Range of the limit, requests that had to wait and peak RSS, once per job (empty afterwards)
+  std::string summary();
+
+  /// Resident set size of the process, 0 where it is not known
+  static std::size_t residentBytes();
+
+private:
+  void enter();
+  void leave();
+
+  /// The collection accounting leaves out the objects and the temporaries of the factories
+  static constexpr double m_event_overhead = 2.;
+  static constexpr std::int64_t m_sample_interval_ns = 20'000'000;
+
+  std::size_t m_limit_bytes = 0;
+
+  std::atomic<std::size_t> m_in_flight{0};
+  std::atomic<std::size_t> m_max_in_flight{0};
+  std::atomic<std::size_t> m_events_limit{1};
+  std::atomic<std::int64_t> m_next_sample_ns{0};
+  std::atomic<std::uint64_t> m_throttled{0};
+
+  std::mutex m_mutex;
+  double m_event_bytes = 0; // running mean of the observed live bytes
+  std::size_t m_min_limit = 1;
+  std::size_t m_max_limit = 1;
+  std::size_t m_peak_rss = 0;
+  bool m_summarized = false;
+};
+
+} // namespace eicrecon
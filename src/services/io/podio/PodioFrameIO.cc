@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "PodioFrameIO.h"
+
+#include <Compression.h>
+#include <TBranch.h>
+#include <TFile.h>
+#include <TFileCacheWrite.h>
+#include <TKey.h>
+#include <TObjArray.h>
+#include <TROOT.h>
+#include <TSeqCollection.h>
+#include <TTree.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+
+namespace eicrecon {
+
+namespace {
+
+  /// Times a call into the nanoseconds counter
+  class WriteTimer {
+  public:
+    explicit WriteTimer(std::uint64_t& ns) : m_ns(ns) {}
+    ~WriteTimer() {
+      m_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+  private:
+    std::uint64_t& m_ns;
+    std::chrono::steady_clock::time_point m_start{std::chrono::steady_clock::now()};
+  };
+
+  /// The frames of a category are stored as a TTree or as an RNTuple of the same name
+  PodioFormat DetectFormat(const std::string& filename) {
+    std::unique_ptr<TFile> file{TFile::Open(filename.c_str())};
+    auto* key = (file == nullptr) ? nullptr : file->GetKey("events");
+    if (key != nullptr && std::string_view(key->GetClassName()).find("RNTuple") != std::string_view::npos) {
+      return PodioFormat::RNTuple;
+    }
+    return PodioFormat::TTree;
+  }
+
+}
+
+std::optional<PodioFormat> ParsePodioFormat(const std::string& name) {
+  if (name == "ttree") {
+    return PodioFormat::TTree;
+  }
+  if (name == "rntuple") {
+    return PodioFormat::RNTuple;
+  }
+  return std::nullopt;
+}
+
+std::string PodioFormatName(PodioFormat format) { return format == PodioFormat::RNTuple ? "rntuple" : "ttree"; }
+
+bool PodioWriteTuning::SetCompressionAlgorithm(const std::string& name) {
+  using Algorithm = ROOT::RCompressionSetting::EAlgorithm;
+  if (name == "zlib") {
+    compression_algorithm = Algorithm::kZLIB;
+  } else if (name == "lzma") {
+    compression_algorithm = Algorithm::kLZMA;
+  } else if (name == "lz4") {
+    compression_algorithm = Algorithm::kLZ4;
+  } else if (name == "zstd") {
+    compression_algorithm = Algorithm::kZSTD;
+  } else if (name == "none") {
+    compression_level = 0;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::vector<std::unique_ptr<PodioFrameWriter>> MakePodioWriters(const std::string& filename,
+                                                                const std::vector<std::string>& formats,
+                                                                const PodioWriteTuning& tuning) {
+  std::vector<std::unique_ptr<PodioFrameWriter>> writers;
+  for (const auto& format_name : formats) {
+    auto format = ParsePodioFormat(format_name);
+    if (!format) {
+      throw std::runtime_error("podio output format must be ttree or rntuple, not '" + format_name + "'");
+    }
+    std::string name = filename;
+    if (!writers.empty()) {
+      name = std::filesystem::path(filename).replace_extension("." + format_name + ".root").string();
+    }
+    writers.push_back(std::make_unique<PodioFrameWriter>(name, *format, tuning));
+  }
+  if (writers.empty()) {
+    throw std::runtime_error("no podio output format");
+  }
+  return writers;
+}
+
+//------------------------------------------------------------------------------
+// PodioFrameReader
+//------------------------------------------------------------------------------
+void PodioFrameReader::openFile(const std::string& filename) {
+  m_format = DetectFormat(filename);
+  if (m_format == PodioFormat::RNTuple) {
+#ifdef EICRECON_PODIO_HAS_RNTUPLE
+    m_rntuple = std::make_unique<podio_rntuple::Reader>();
+    m_rntuple->openFile(filename);
+    return;
+#else
+    throw std::runtime_error(filename + " is an RNTuple file, but podio was built without RNTuple support");
+#endif
+  }
+  m_ttree.openFile(filename);
+}
+
+std::size_t PodioFrameReader::getEntries(const std::string& category) {
+#ifdef EICRECON_PODIO_HAS_RNTUPLE
+  if (m_rntuple) {
+    return m_rntuple->getEntries(category);
+  }
+#endif
+  return m_ttree.getEntries(category);
+}
+
+podio::version::Version PodioFrameReader::currentFileVersion() const {
+#ifdef EICRECON_PODIO_HAS_RNTUPLE
+  if (m_rntuple) {
+    return m_rntuple->currentFileVersion();
+  }
+#endif
+  return m_ttree.currentFileVersion();
+}
+
+std::unique_ptr<podio::ROOTFrameData> PodioFrameReader::readEntry(const std::string& category, std::size_t entry,
+                                                                  const std::vector<std::string>& collections) {
+#if podio_VERSION >= PODIO_VERSION(1, 1, 0)
+  // only the branches or fields of the given collections are read
+#ifdef EICRECON_PODIO_HAS_RNTUPLE
+  if (m_rntuple) {
+    return m_rntuple->readEntry(category, entry, collections);
+  }
+#endif
+  return m_ttree.readEntry(category, entry, collections);
+#else
+  // all the collections are read, but only the requested ones are unpacked later
+  (void)collections;
+#ifdef EICRECON_PODIO_HAS_RNTUPLE
+  if (m_rntuple) {
+    return m_rntuple->readEntry(category, entry);
+  }
+#endif
+  return m_ttree.readEntry(category, entry);
+#endif
+}
+
+//------------------------------------------------------------------------------
+// PodioFrameWriter
+//------------------------------------------------------------------------------
+PodioFrameWriter::PodioFrameWriter(const std::string& filename, PodioFormat format, const PodioWriteTuning& tuning)
+  : m_filename(filename), m_format(format), m_tuning(tuning) {
+  if (format == PodioFormat::RNTuple) {
+#ifdef EICRECON_PODIO_HAS_RNTUPLE
+    m_rntuple = std::make_unique<podio_rntuple::Writer>(filename);
+#else
+    throw std::runtime_error("podio was built without RNTuple support, " + filename + " can not be written as an RNTuple");
+#endif
+  } else {
+    m_ttree = std::make_unique<podio::ROOTFrameWriter>(filename);
+    // the writer opens the file, but does not give access to it
+    m_file = dynamic_cast<TFile*>(gROOT->GetListOfFiles()->FindObject(filename.c_str()));
+    if (m_file != nullptr) {
+      // the branches take the compression of the file when they are created, at the first frame
+      if (m_tuning.compression_algorithm >= 0) {
+        m_file->SetCompressionAlgorithm(m_tuning.compression_algorithm);
+      }
+      if (m_tuning.compression_level >= 0) {
+        m_file->SetCompressionLevel(m_tuning.compression_level);
+      }
+      if (m_tuning.write_buffer_size > 0) {
+        new TFileCacheWrite(m_file, m_tuning.write_buffer_size); // owned by the file
+      }
+    }
+  }
+}
+
+PodioFrameWriter::~PodioFrameWriter() = default;
+
+void PodioFrameWriter::writeFrame(const podio::Frame& frame, const std::string& category,
+                                  const std::vector<std::string>& collections) {
+  WriteTimer timer(m_write_ns);
+#ifdef EICRECON_PODIO_HAS_RNTUPLE
+  if (m_rntuple) {
+    m_rntuple->writeFrame(frame, category, collections);
+    ++m_frames;
+    return;
+  }
+#endif
+  m_ttree->writeFrame(frame, category, collections);
+  ++m_frames;
+  if (m_file != nullptr && (m_tuning.auto_flush != 0 || m_tuning.basket_size > 0) &&
+      m_tuned_categories.insert(category).second) {
+    // the tree of a category is made by its first frame, the next baskets get the new size
+    if (auto* tree = m_file->Get<TTree>(category.c_str())) {
+      if (m_tuning.auto_flush != 0) {
+        tree->SetAutoFlush(m_tuning.auto_flush);
+      }
+      if (m_tuning.basket_size > 0) {
+        tree->SetBasketSize("*", m_tuning.basket_size);
+      }
+    }
+  }
+}
+
+std::vector<PodioCollectionBytes> PodioFrameWriter::collectionBytes(const std::vector<std::string>& collections) {
+  std::vector<PodioCollectionBytes> result;
+  auto* tree = (m_file == nullptr) ? nullptr : m_file->Get<TTree>("events");
+  if (tree == nullptr) {
+    return result;
+  }
+  tree->FlushBaskets();
+  for (const auto& collection : collections) {
+    result.push_back({collection, 0, 0});
+  }
+  // podio names the branches of a collection "<name>" and "_<name>_<member>" for the relations and vector members
+  for (auto* object : *tree->GetListOfBranches()) {
+    auto* branch = static_cast<TBranch*>(object);
+    const std::string name = branch->GetName();
+    PodioCollectionBytes* owner = nullptr;
+    for (auto& bytes : result) {
+      const bool matches = name == bytes.collection || name.rfind("_" + bytes.collection + "_", 0) == 0;
+      if (matches && (owner == nullptr || bytes.collection.size() > owner->collection.size())) {
+        owner = &bytes;
+      }
+    }
+    if (owner != nullptr) {
+      owner->total_bytes += branch->GetTotBytes("*");
+      owner->zip_bytes += branch->GetZipBytes("*");
+    }
+  }
+  return result;
+}
+
+void PodioFrameWriter::finish() {
+  // includes the last flush of the baskets or pages
+  WriteTimer timer(m_write_ns);
+#ifdef EICRECON_PODIO_HAS_RNTUPLE
+  if (m_rntuple) {
+    m_rntuple->finish();
+    return;
+  }
+#endif
+  m_ttree->finish();
+}
+
+} // namespace eicrecon
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <podio/Frame.h>
+#include <podio/ROOTFrameData.h>
+#include <podio/ROOTFrameReader.h>
+#include <podio/ROOTFrameWriter.h>
+#include <podio/podioVersion.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+class TFile;
+
+// RNTuple support is optional in podio, its headers are only installed with it
+#if __has_include(<podio/RNTupleWriter.h>)
+#include <podio/RNTupleReader.h>
+#include <podio/RNTupleWriter.h>
+#define EICRECON_PODIO_HAS_RNTUPLE 1
+namespace eicrecon::podio_rntuple {
+  using Reader = podio::RNTupleReader;
+  using Writer = podio::RNTupleWriter;
+}
+#elif __has_include(<podio/ROOTNTupleWriter.h>)
+#include <podio/ROOTNTupleReader.h>
+#include <podio/ROOTNTupleWriter.h>
+#define EICRECON_PODIO_HAS_RNTUPLE 1
+namespace eicrecon::podio_rntuple {
+  using Reader = podio::ROOTNTupleReader;
+  using Writer = podio::ROOTNTupleWriter;
+}
+#endif
+
+namespace eicrecon {
+
+/// Storage of the podio frames in a ROOT file
+enum class PodioFormat { TTree, RNTuple };
+
+/// "ttree" or "rntuple", std::nullopt for anything else
+std::optional<PodioFormat> ParsePodioFormat(const std::string& name);
+
+std::string PodioFormatName(PodioFormat format);
+
+/// ROOT settings of the written TTree files, the defaults keep the ones of ROOT
+struct PodioWriteTuning {
+  int compression_algorithm{-1}; // ROOT::RCompressionSetting::EAlgorithm
+  int compression_level{-1};     // 0 for no compression
+  long long auto_flush{0};       // as TTree::SetAutoFlush: entries if > 0, bytes if < 0
+  int basket_size{0};            // bytes of the baskets of all the branches
+  int write_buffer_size{0};      // bytes of the TFileCacheWrite of the file
+
+  /// "zlib", "lzma", "lz4", "zstd" or "none" (the latter sets the level to 0), false for anything else
+  bool SetCompressionAlgorithm(const std::string& name);
+};
+
+/// Category of the frame of the parameters of the job that wrote a file, see reco:reuse_input_collections
+constexpr const char* PodioConfigurationCategory = "configuration";
+
+/// Bytes of the branches of a collection in a TTree file
+struct PodioCollectionBytes {
+  std::string collection;
+  std::uint64_t total_bytes{0}; // uncompressed
+  std::uint64_t zip_bytes{0};
+};
+
+class PodioFrameWriter;
+
+/// Writers of a file in each of the formats ("ttree", "rntuple"), the ones after the first
+/// write to <stem>.<format>.root. Throws std::runtime_error for unknown or unsupported formats.
+std::vector<std::unique_ptr<PodioFrameWriter>> MakePodioWriters(const std::string& filename,
+                                                                const std::vector<std::string>& formats,
+                                                                const PodioWriteTuning& tuning = {});
+
+/// Whether this build of podio can read and write RNTuples
+constexpr bool PodioHasRNTuple() {
+#ifdef EICRECON_PODIO_HAS_RNTUPLE
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Reader of the frames of a podio file of either format. The format is
+ * found from the "events" key of the file when it is opened.
+ */
+class PodioFrameReader {
+public:
+  void openFile(const std::string& filename);
+
+  PodioFormat format() const { return m_format; }
+
+  std::size_t getEntries(const std::string& category);
+
+  podio::version::Version currentFileVersion() const;
+
+  /// An entry of a category, with only the given collections if the podio version supports it (all if empty)
+  std::unique_ptr<podio::ROOTFrameData> readEntry(const std::string& category, std::size_t entry,
+                                                  const std::vector<std::string>& collections = {});
+
+private:
+  PodioFormat m_format{PodioFormat::TTree};
+  podio::ROOTFrameReader m_ttree;
+#ifdef EICRECON_PODIO_HAS_RNTUPLE
+  std::unique_ptr<podio_rntuple::Reader> m_rntuple;
+#endif
+};
+
+/**
+ * Writer of podio frames in either format, which also accounts the time
+ * spent in writing, to compare the formats.
+ */
+class PodioFrameWriter {
+public:
+  /// Throws std::runtime_error for RNTuple if podio was built without it. The tuning only applies to
+  /// TTree files, the podio RNTuple writer does not expose its write options.
+  PodioFrameWriter(const std::string& filename, PodioFormat format, const PodioWriteTuning& tuning = {});
+  ~PodioFrameWriter();
+
+  void writeFrame(const podio::Frame& frame, const std::string& category, const std::vector<std::string>& collections);
+
+  void finish();
+
+  /// Bytes of the branches of the collections in the "events" TTree, before finish(), empty for RNTuple
+  std::vector<PodioCollectionBytes> collectionBytes(const std::vector<std::string>& collections);
+
+  const std::string& filename() const { return m_filename; }
+  PodioFormat format() const { return m_format; }
+  std::uint64_t frames() const { return m_frames; }
+  std::uint64_t write_ns() const { return m_write_ns; }
+
+private:
+  std::string m_filename;
+  PodioFormat m_format;
+  std::unique_ptr<podio::ROOTFrameWriter> m_ttree;
+#ifdef EICRECON_PODIO_HAS_RNTUPLE
+  std::unique_ptr<podio_rntuple::Writer> m_rntuple;
+#endif
+  PodioWriteTuning m_tuning;
+  TFile* m_file{nullptr}; // of m_ttree
+  std::set<std::string> m_tuned_categories;
+  std::uint64_t m_frames{0};
+  std::uint64_t m_write_ns{0};
+};
+
+} // namespace eicrecon
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "PodioMemoryReport.h"
+
+#include <TClass.h>
+#include <TVirtualCollectionProxy.h>
+#include <fmt/core.h>
+#include <podio/CollectionBuffers.h>
+#include <podio/ObjectID.h>
+#include <algorithm>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  /// Size of a type from its ROOT dictionary, 0 if it has none
+  std::size_t TypeSize(const std::string& type_name) {
+    static std::mutex mutex;
+    static std::map<std::string, std::size_t> sizes;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto [it, inserted] = sizes.try_emplace(type_name, 0);
+    if (inserted) {
+      if (auto* cls = TClass::GetClass(type_name.c_str())) {
+        it->second = cls->Size();
+      }
+    }
+    return it->second;
+  }
+
+  /// Bytes of the elements of a `std::vector<type_name>` buffer, through the ROOT collection proxy
+  std::size_t VectorBytes(const std::string& type_name, void* vector) {
+    auto* cls = TClass::GetClass(("vector<" + type_name + ">").c_str());
+    auto* proxy = (cls == nullptr) ? nullptr : cls->GetCollectionProxy();
+    if (proxy == nullptr) {
+      return 0;
+    }
+    TVirtualCollectionProxy::TPushPop helper(proxy, vector);
+    return proxy->Size() * proxy->GetIncrement();
+  }
+
+}
+
+PodioMemoryReport::CollectionBytes PodioMemoryReport::Measure(const podio::CollectionBase& collection) {
+  CollectionBytes result;
+  result.entries = collection.size();
+  result.bytes = result.entries * TypeSize(std::string(collection.getDataTypeName()));
+
+  // the buffers of the relations and of the vector members are only filled for writing
+  collection.prepareForWrite();
+  auto buffers = const_cast<podio::CollectionBase&>(collection).getBuffers();
+  if (buffers.references != nullptr) {
+    for (const auto& references : *buffers.references) {
+      result.bytes += references->size() * sizeof(podio::ObjectID);
+    }
+  }
+  if (buffers.vectorMembers != nullptr) {
+    for (const auto& [type_name, vector] : *buffers.vectorMembers) {
+      result.bytes += VectorBytes(type_name, vector);
+    }
+  }
+  return result;
+}
+
+void PodioMemoryReport::SetOutputFile(const std::string& path) {
+  if (path.empty()) {
+    m_csv.reset();
+    return;
+  }
+  m_csv = std::make_unique<std::ofstream>(path);
+  *m_csv << "event,collection,type,entries,bytes\n";
+}
+
+std::size_t PodioMemoryReport::Add(const void* slot, std::uint64_t event_number, const podio::Frame& frame) {
+  std::size_t event_bytes = 0;
+  for (const auto& name : frame.getAvailableCollections()) {
+    const auto* collection = frame.get(name);
+    if (collection == nullptr) {
+      continue;
+    }
+    const auto measured = Measure(*collection);
+    auto& totals = m_collections[name];
+    totals.type = collection->getTypeName();
+    totals.events += 1;
+    totals.entries += measured.entries;
+    totals.bytes += measured.bytes;
+    totals.max_bytes = std::max(totals.max_bytes, measured.bytes);
+    event_bytes += measured.bytes;
+    if (m_csv) {
+      *m_csv << event_number << ',' << name << ',' << totals.type << ',' << measured.entries << ',' << measured.bytes << '\n';
+    }
+  }
+  auto& peak = m_slot_peak_bytes[slot];
+  peak = std::max(peak, event_bytes);
+  m_events += 1;
+  return event_bytes;
+}
+
+void PodioMemoryReport::Print(spdlog::logger& log) const {
+  if (m_events == 0) {
+    return;
+  }
+  std::vector<std::pair<std::string, Totals>> ranked(m_collections.begin(), m_collections.end());
+  std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.second.bytes > b.second.bytes; });
+
+  std::size_t total_bytes = 0;
+  for (const auto& [name, totals] : ranked) {
+    total_bytes += totals.bytes;
+  }
+  log.info("Podio collections of {} events, {:.1f} kB per event:", m_events, total_bytes / 1024. / m_events);
+  log.info("{:>12} {:>12} {:>12} {:>7}  {}", "entries/evt", "kB/evt", "max kB", "share", "collection");
+  for (const auto& [name, totals] : ranked) {
+    log.info("{:12.1f} {:12.2f} {:12.2f} {:6.1f}%  {} ({})",
+             static_cast<double>(totals.entries) / m_events, totals.bytes / 1024. / m_events,
+             totals.max_bytes / 1024., 100. * totals.bytes / std::max<std::size_t>(total_bytes, 1), name, totals.type);
+  }
+
+  std::size_t sum_of_peaks = 0;
+  for (const auto& [slot, peak] : m_slot_peak_bytes) {
+    sum_of_peaks += peak;
+  }
+  log.info("Peak live bytes of the {} event slots: {:.1f} kB max, {:.1f} kB for all the slots",
+           m_slot_peak_bytes.size(),
+           std::max_element(m_slot_peak_bytes.begin(), m_slot_peak_bytes.end(),
+                            [](const auto& a, const auto& b) { return a.second < b.second; })->second / 1024.,
+           sum_of_peaks / 1024.);
+}
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <podio/CollectionBase.h>
+#include <podio/Frame.h>
+#include <spdlog/logger.h>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+
+/**
+ * Element counts and approximate bytes of the podio collections of the
+ * events, with `-Ppodio:memory_report=true`.
+ *
+ * The bytes of a collection are the ones of its buffers for writing: the
+ * data of the elements, the object IDs of the relations and the vector
+ * members. The in-memory objects add about a pointer per element. Every
+ * event is also accounted to its JANA event slot, i.e. the JEvent of the
+ * pool that holds it, whose peak live bytes bound the memory that an event
+ * of the pool (`jana:nevents_in_pool`) needs.
+ */
+class PodioMemoryReport {
+public:
+  struct CollectionBytes {
+    std::size_t entries{0};
+    std::size_t bytes{0};
+  };
+
+  /// Bytes of the buffers of a collection, which is prepared for writing if it is not yet
+  static CollectionBytes Measure(const podio::CollectionBase& collection);
+
+  /// Opens the file of the per-event rows, none if empty
+  void SetOutputFile(const std::string& path);
+
+  /// Accounts all the collections of the frame of an event, in the event slot `slot`, returns their bytes
+  std::size_t Add(const void* slot, std::uint64_t event_number, const podio::Frame& frame);
+
+  /// Prints the collections ranked by mean bytes per event, and the peak bytes of the event slots
+  void Print(spdlog::logger& log) const;
+
+private:
+  struct Totals {
+    std::string type;
+    std::size_t events{0};
+    std::size_t entries{0};
+    std::size_t bytes{0};
+    std::size_t max_bytes{0};
+  };
+
+  std::map<std::string, Totals> m_collections;
+  std::map<const void*, std::size_t> m_slot_peak_bytes;
+  std::size_t m_events{0};
+  std::unique_ptr<std::ofstream> m_csv;
+};
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "PodioShardedWriter.h"
+
+#include <fmt/core.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+namespace eicrecon {
+
+std::optional<PodioShardedWriter::Merge> PodioShardedWriter::ParseMerge(const std::string& name) {
+  if (name == "none") {
+    return Merge::None;
+  }
+  if (name == "ordered") {
+    return Merge::Ordered;
+  }
+  if (name == "unordered") {
+    return Merge::Unordered;
+  }
+  return std::nullopt;
+}
+
+PodioShardedWriter::PodioShardedWriter(const std::string& filename, const std::vector<std::string>& formats,
+                                       std::size_t shards, const PodioWriteTuning& tuning)
+  : m_filename(filename), m_formats(formats), m_tuning(tuning) {
+  for (std::size_t k = 0; k < shards; ++k) {
+    auto shard = std::make_unique<Shard>();
+    shard->writers = MakePodioWriters(ShardFilename(k), formats, m_tuning);
+    m_shards.push_back(std::move(shard));
+  }
+}
+
+std::string PodioShardedWriter::ShardFilename(std::size_t shard) const {
+  return std::filesystem::path(m_filename).replace_extension(fmt::format(".shard{}.root", shard)).string();
+}
+
+void PodioShardedWriter::writeFrame(const podio::Frame& frame, const std::vector<std::string>& collections,
+                                    std::uint64_t run, std::uint64_t event) {
+  // the shard of this thread, or the next one that is free
+  thread_local const std::size_t thread_number = m_next_thread.fetch_add(1);
+  const std::size_t n = m_shards.size();
+  const std::size_t preferred = thread_number % n;
+  std::unique_lock<std::mutex> lock;
+  std::size_t k = preferred;
+  for (std::size_t i = 0; i < n && !lock.owns_lock(); ++i) {
+    k = (preferred + i) % n;
+    lock = std::unique_lock<std::mutex>(m_shards[k]->mutex, std::try_to_lock);
+  }
+  if (!lock.owns_lock()) {
+    k = preferred;
+    lock = std::unique_lock<std::mutex>(m_shards[k]->mutex);
+  }
+
+  auto& shard = *m_shards[k];
+  for (auto& writer : shard.writers) {
+    writer->writeFrame(frame, "events", collections);
+  }
+  shard.index.push_back({run, event, k, shard.index.size()});
+}
+
+void PodioShardedWriter::finish(Merge merge, spdlog::logger& log) {
+  std::vector<IndexEntry> index;
+  std::uint64_t write_ns = 0;
+  for (auto& shard : m_shards) {
+    for (auto& writer : shard->writers) {
+      writer->finish();
+      write_ns += writer->write_ns();
+    }
+    index.insert(index.end(), shard->index.begin(), shard->index.end());
+  }
+  log.info("Wrote {} events to {} shards of {} in {:.1f} s of the writer threads", index.size(), m_shards.size(),
+           m_filename, write_ns * 1e-9);
+
+  if (merge == Merge::None) {
+    const auto index_file = std::filesystem::path(m_filename).replace_extension(".index.csv").string();
+    std::ofstream csv(index_file);
+    csv << "run,event,shard,entry\n";
+    for (const auto& entry : index) {
+      csv << entry.run << ',' << entry.event << ',' << entry.shard << ',' << entry.entry << '\n';
+    }
+    log.info("Kept the shards {}, their index is {}", ShardFilename(0), index_file);
+    return;
+  }
+  if (merge == Merge::Ordered) {
+    std::stable_sort(index.begin(), index.end(), [](const IndexEntry& a, const IndexEntry& b) {
+      return std::tie(a.run, a.event) < std::tie(b.run, b.event);
+    });
+  }
+
+  // the shards are merged format by format, the writers of a shard are in the order of the formats
+  const auto start = std::chrono::steady_clock::now();
+  auto outputs = MakePodioWriters(m_filename, m_formats, m_tuning);
+  for (std::size_t f = 0; f < outputs.size(); ++f) {
+    std::vector<PodioFrameReader> readers(m_shards.size());
+    for (std::size_t k = 0; k < m_shards.size(); ++k) {
+      readers[k].openFile(m_shards[k]->writers[f]->filename());
+    }
+    for (const auto& entry : index) {
+      podio::Frame frame(readers[entry.shard].readEntry("events", entry.entry));
+      outputs[f]->writeFrame(frame, "events", frame.getAvailableCollections());
+    }
+    outputs[f]->finish();
+  }
+  for (auto& shard : m_shards) {
+    for (auto& writer : shard->writers) {
+      std::error_code ec;
+      std::filesystem::remove(writer->filename(), ec);
+    }
+  }
+  log.info("Merged the shards into {} ({}) in {:.1f} s", m_filename, merge == Merge::Ordered ? "ordered" : "unordered",
+           std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+
+} // namespace eicrecon
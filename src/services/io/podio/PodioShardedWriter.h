@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <podio/Frame.h>
+#include <spdlog/logger.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "PodioFrameIO.h"
+
+namespace eicrecon {
+
+/**
+ * Writes the events to several podio files at the same time, with
+ * `-Ppodio:output_shards=N`, so that the worker threads do not all wait
+ * for a single writer.
+ *
+ * A thread keeps writing to the same shard, `<stem>.shard<k>.root`, as long
+ * as no other thread holds it; with as many shards as threads, every thread
+ * has its own file. The run and event numbers of the entries of the shards
+ * are indexed, so that finish() can merge the shards in the order of the
+ * events, or in no particular order. Without a merge, the shards are kept
+ * and the index is written as `<stem>.index.csv` for a later merge.
+ */
+class PodioShardedWriter {
+public:
+  enum class Merge { None, Ordered, Unordered };
+
+  /// "none", "ordered" or "unordered", std::nullopt for anything else
+  static std::optional<Merge> ParseMerge(const std::string& name);
+
+  /// Throws std::runtime_error as MakePodioWriters
+  PodioShardedWriter(const std::string& filename, const std::vector<std::string>& formats, std::size_t shards,
+                     const PodioWriteTuning& tuning = {});
+
+  void writeFrame(const podio::Frame& frame, const std::vector<std::string>& collections, std::uint64_t run,
+                  std::uint64_t event);
+
+  /// Finishes the shards, then merges them into the files of `filename`, once no thread writes anymore
+  void finish(Merge merge, spdlog::logger& log);
+
+private:
+  struct IndexEntry {
+    std::uint64_t run;
+    std::uint64_t event;
+    std::size_t shard;
+    std::size_t entry;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<PodioFrameWriter>> writers; // one per format
+    std::vector<IndexEntry> index;
+  };
+
+  std::string ShardFilename(std::size_t shard) const;
+
+  std::string m_filename;
+  std::vector<std::string> m_formats;
+  PodioWriteTuning m_tuning;
+  std::vector<std::unique_ptr<Shard>> m_shards;
+  std::atomic<std::size_t> m_next_thread{0};
+};
+
+} // namespace eicrecon
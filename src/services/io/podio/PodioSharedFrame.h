@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JEvent.h>
+#include <JANA/JFactory.h>
+#include <podio/Frame.h>
+#include <memory>
+#include <utility>
+
+namespace eicrecon {
+
+/// The frame of an event, shared with the writer thread of podio:async_write, which may write it after
+/// the event is recycled. `keep_alive` holds what the relations of its collections point into, if that
+/// is not in the frame itself, e.g. the time frame of a slice.
+struct PodioSharedFrame {
+  std::shared_ptr<const podio::Frame> frame;
+  std::shared_ptr<const void> keep_alive;
+};
+
+/// Inserts the frame of an event, and a PodioSharedFrame of it. The JFactoryT<podio::Frame> does not own
+/// the frame, so that it is only destroyed with the last of the event and the writer that holds it.
+inline void InsertSharedFrame(JEvent& event, std::unique_ptr<podio::Frame> frame,
+                              std::shared_ptr<const void> keep_alive = nullptr) {
+  std::shared_ptr<podio::Frame> shared = std::move(frame);
+  auto* factory = event.Insert(shared.get());
+  factory->SetFactoryFlag(JFactory::NOT_OBJECT_OWNER);
+  event.Insert(new PodioSharedFrame{std::move(shared), std::move(keep_alive)});
+}
+
+} // namespace eicrecon
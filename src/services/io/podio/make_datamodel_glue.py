@@ -85,9 +85,7 @@ def AddCollections(datamodelName, collectionfiles):
         type_map.append('};')
         type_map.append('#endif')
 
-        visitor.append('        if (podio_typename == "' + datamodelName + '::' + basename + 'Collection") {')
-        visitor.append('            return visitor(*reinterpret_cast<const ' + datamodelName + '::' + basename + 'Collection*>(&collection));')
-        visitor.append('        }')
+        visitor.append('            {"' + datamodelName + '::' + basename + 'Collection", &Visit<' + datamodelName + '::' + basename + 'Collection>},')
 
 
 collectionfiles_edm4hep = glob.glob(EDM4HEP_INCLUDE_DIR+'/edm4hep/*Collection.h')
@@ -114,8 +112,13 @@ with open('datamodel_glue.h', 'w') as f:
     f.write('#pragma once\n')
     f.write('\n')
     f.write('#include <stdexcept>\n')
+    f.write('#include <string>\n')
+    f.write('#include <string_view>\n')
+    f.write('#include <unordered_map>\n')
     f.write('#include <podio/podioVersion.h>\n')
     f.write('#include <podio/CollectionBase.h>\n')
+    f.write('#include <podio/UserDataCollection.h>\n')
+    f.write('#include <type_traits>\n')
     f.write('\n')
 
     f.write('\ntemplate <typename T> struct PodioTypeMap {')
@@ -124,14 +127,43 @@ with open('datamodel_glue.h', 'w') as f:
     f.write('\n    using mutable_t = typename T::mutable_type;')
     f.write('\n#endif')
     f.write('\n};')
+    f.write('\n')
+    # Plain values, e.g. the per-event status of a factory, are written as podio::UserDataCollection.
+    # They are not types of the datamodels, VisitPodioCollection does not visit them.
+    f.write('\ntemplate <typename T> requires std::is_arithmetic_v<T> struct PodioTypeMap<T> {')
+    f.write('\n    using collection_t = podio::UserDataCollection<T>;')
+    f.write('\n    using mutable_t = T;')
+    f.write('\n};')
     f.write('\n\n')
     f.write('\n'.join(type_map))
     f.write('\n')
+    # The thunks of the collection types are found by a hash of the type name, in
+    # a table built once per visitor. Callers that visit the same collections in
+    # every event can keep the thunk of a collection from Find().
     f.write('\ntemplate <typename Visitor> struct VisitPodioCollection {')
-    f.write('\n    void operator()(Visitor& visitor, const podio::CollectionBase& collection) {')
-    f.write('\n        auto podio_typename = collection.getTypeName();\n')
+    f.write('\n    using Thunk = void (*)(Visitor&, const podio::CollectionBase&);')
+    f.write('\n')
+    f.write('\n    /// The thunk of a collection type, nullptr if it is not a type of the datamodels')
+    f.write('\n    static Thunk Find(std::string_view podio_typename) {')
+    f.write('\n        static const std::unordered_map<std::string_view, Thunk> thunks = {\n')
     f.write('\n'.join(visitor))
-    f.write('\n        throw std::runtime_error("Unrecognized podio typename!");')
+    f.write('\n        };')
+    f.write('\n        auto thunk = thunks.find(podio_typename);')
+    f.write('\n        return thunk == thunks.end() ? nullptr : thunk->second;')
+    f.write('\n    }')
+    f.write('\n')
+    f.write('\n    void operator()(Visitor& visitor, const podio::CollectionBase& collection) {')
+    f.write('\n        auto thunk = Find(collection.getTypeName());')
+    f.write('\n        if (thunk == nullptr) {')
+    f.write('\n            throw std::runtime_error("Unrecognized podio typename " + std::string(collection.getTypeName()) + "!");')
+    f.write('\n        }')
+    f.write('\n        thunk(visitor, collection);')
+    f.write('\n    }')
+    f.write('\n')
+    f.write('\nprivate:')
+    f.write('\n    template <typename CollectionT>')
+    f.write('\n    static void Visit(Visitor& visitor, const podio::CollectionBase& collection) {')
+    f.write('\n        visitor(*reinterpret_cast<const CollectionT*>(&collection));')
     f.write('\n    }')
     f.write('\n};\n')
     f.close()
@@ -7,7 +7,9 @@
 #include <JANA/JEventSourceGeneratorT.h>
 
 #include "JEventProcessorPODIO.h"
+#include "JEventSourceNetwork.h"
 #include "JEventSourcePODIO.h"
+#include "JEventSourceTimeframePODIO.h"
 
 
 // Make this a JANA plugin
@@ -15,6 +17,8 @@ extern "C" {
 void InitPlugin(JApplication *app) {
     InitJANAPlugin(app);
     app->Add(new JEventSourceGeneratorT<JEventSourcePODIO>());
+    app->Add(new JEventSourceGeneratorT<JEventSourceTimeframePODIO>());
+    app->Add(new JEventSourceGeneratorT<JEventSourceNetwork>());
 
     // Disable this behavior for now so one can run eicrecon with only the
     // input file as an argument.
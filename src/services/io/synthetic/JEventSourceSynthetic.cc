@@ -0,0 +1,243 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "JEventSourceSynthetic.h"
+
+#include <DD4hep/Detector.h>
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JException.h>
+#include <JANA/JLogger.h>
+#include <JANA/Services/JParameterManager.h>
+#include <JANA/Utils/JTypeInfo.h>
+#include <edm4hep/CaloHitContributionCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <edm4hep/SimCalorimeterHitCollection.h>
+#include <edm4hep/SimTrackerHitCollection.h>
+#include <fmt/core.h>
+#include <podio/Frame.h>
+#include <exception>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+#include "services/geometry/dd4hep/DD4hep_service.h"
+#include "services/io/podio/PodioSharedFrame.h"
+
+namespace {
+
+    /// Mixes the seed with the event number and the readout, so that every event and readout has its own stream
+    std::uint64_t SplitMix64(std::uint64_t x) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    template <typename CollectionT>
+    void Insert(podio::Frame& frame, JEvent& event, CollectionT&& collection, const std::string& name) {
+        const auto& stored = frame.put(std::move(collection), name);
+        event.InsertCollectionAlreadyInFrame<typename CollectionT::value_type>(&stored, name);
+    }
+
+}
+
+
+//------------------------------------------------------------------------------
+// Constructor
+//
+/// \param resource_name  "synthetic://" or "synthetic://<number of events>"
+/// \param app            JApplication
+//------------------------------------------------------------------------------
+JEventSourceSynthetic::JEventSourceSynthetic(std::string resource_name, JApplication* app) : JEventSource(resource_name, app) {
+    SetTypeName(NAME_OF_THIS); // Provide JANA with class name
+
+    GetApplication()->SetDefaultParameter(
+            "synth:readouts",
+            m_readouts_str,
+            "comma separated list of the readouts to make hits of, named as their collections (empty for all the readouts of the geometry)"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synth:occupancy",
+            m_cfg.occupancy,
+            "mean fraction of the cells of a readout hit per event"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synth:occupancies",
+            m_occupancies_str,
+            "comma separated list of the occupancies of the synth:readouts, in place of synth:occupancy"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synth:cluster_size",
+            m_cfg.clusterSize,
+            "mean number of hits per cluster"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synth:cluster_spread",
+            m_cfg.clusterSpread,
+            "standard deviation of the hits of a cluster around its seed, in cell sizes"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synth:tracker_edep",
+            m_cfg.trackerEDep,
+            "median of the log-normal energy deposits of the tracker hits, in GeV"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synth:tracker_edep_width",
+            m_cfg.trackerEDepWidth,
+            "standard deviation of the log of the energy deposits of the tracker hits"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synth:calo_hit_energy",
+            m_cfg.caloHitEnergy,
+            "mean of the exponential energies of the calorimeter hits, in GeV"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synth:time_window",
+            m_cfg.timeWindow,
+            "time window in ns over which the clusters are spread, after their time of flight"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synth:seed",
+            m_seed,
+            "seed of the random numbers, the hits of an event only depend on it and on the event number"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synth:run_number",
+            m_run_number,
+            "run number of the events"
+            );
+}
+
+//------------------------------------------------------------------------------
+// Open
+//
+/// Collect the sensitive volumes of the readouts from the geometry.
+//------------------------------------------------------------------------------
+void JEventSourceSynthetic::Open() {
+
+    const std::string count = GetResourceName().substr(std::string("synthetic://").size());
+    try {
+        m_max_events = count.empty() ? 0 : std::stoull(count);
+    }
+    catch(std::exception&) {
+        throw JException("The synthetic source \"%s\" must be synthetic://<number of events>", GetResourceName().c_str());
+    }
+
+    const auto* detector = GetApplication()->GetService<DD4hep_service>()->detector().get();
+    std::vector<std::string> readouts, occupancies;
+    JParameterManager::Parse(m_readouts_str, readouts);
+    JParameterManager::Parse(m_occupancies_str, occupancies);
+    const bool all_readouts = readouts.empty();
+    if( all_readouts ){
+        for (const auto& [name, readout] : detector->readouts()) readouts.push_back(name);
+    }
+    if( !occupancies.empty() && occupancies.size() != readouts.size() ){
+        throw JException("synth:occupancies must give one occupancy per synth:readouts, not %d for %d readouts", occupancies.size(), readouts.size());
+    }
+
+    for (size_t i = 0; i < readouts.size(); ++i) {
+        auto cfg = m_cfg;
+        if( !occupancies.empty() ) cfg.occupancy = std::stod(occupancies[i]);
+        try {
+            m_readouts.emplace_back(*detector, readouts[i], cfg);
+        }
+        catch(std::runtime_error& e) {
+            // e.g. the readouts of volumes that are no boxes or of no sensitive detector
+            if( !all_readouts ) throw JException(fmt::format("synth:readouts: {}", e.what()));
+            continue;
+        }
+        const auto& readout = m_readouts.back();
+        LOG << "Synthetic " << (readout.isTracker() ? "tracker" : "calorimeter") << " hits of " << readout.name() << ": "
+            << readout.volumes() << " volumes, " << readout.cells() << " cells, occupancy " << cfg.occupancy << LOG_END;
+    }
+    if( m_readouts.empty() ){
+        throw JException("The synthetic source has no readouts to make hits of");
+    }
+}
+
+//------------------------------------------------------------------------------
+// GetEvent
+//
+/// Make the hits of all the readouts, each from its own random stream of the
+/// event.
+///
+/// \param event
+//------------------------------------------------------------------------------
+void JEventSourceSynthetic::GetEvent(std::shared_ptr<JEvent> event) {
+
+    if( m_max_events > 0 && m_events >= m_max_events ) throw RETURN_STATUS::kNO_MORE_EVENTS;
+    const std::uint64_t event_number = m_events++;
+    event->SetEventNumber(event_number);
+    event->SetRunNumber(m_run_number);
+
+    auto frame = std::make_unique<podio::Frame>();
+    edm4hep::EventHeaderCollection headers;
+    auto header = headers.create();
+    header.setEventNumber(static_cast<int>(event_number));
+    header.setRunNumber(m_run_number);
+    Insert(*frame, *event, std::move(headers), "EventHeader");
+
+    edm4hep::MCParticleCollection particles;
+    for (size_t i = 0; i < m_readouts.size(); ++i) {
+        const auto& readout = m_readouts[i];
+        std::mt19937_64 rng(SplitMix64(SplitMix64(m_seed ^ SplitMix64(event_number)) + i));
+        if( readout.isTracker() ){
+            edm4hep::SimTrackerHitCollection hits;
+            readout.generate(rng, particles, hits);
+            m_hits += hits.size();
+            Insert(*frame, *event, std::move(hits), readout.name());
+        }else{
+            edm4hep::SimCalorimeterHitCollection hits;
+            edm4hep::CaloHitContributionCollection contributions;
+            readout.generate(rng, particles, hits, contributions);
+            m_hits += hits.size();
+            Insert(*frame, *event, std::move(hits), readout.name());
+            Insert(*frame, *event, std::move(contributions), readout.name() + "Contributions");
+        }
+    }
+    Insert(*frame, *event, std::move(particles), "MCParticles");
+
+    eicrecon::InsertSharedFrame(*event, std::move(frame));
+}
+
+//------------------------------------------------------------------------------
+// Close
+//------------------------------------------------------------------------------
+void JEventSourceSynthetic::Close() {
+    LOG << "Closing the synthetic source after " << m_events << " events of " << m_hits << " hits" << LOG_END;
+}
+
+//------------------------------------------------------------------------------
+// GetDescription
+//------------------------------------------------------------------------------
+std::string JEventSourceSynthetic::GetDescription() {
+
+    /// GetDescription() helps JANA explain to the user what is going on
+    return "Synthetic sim hits on the readouts of the geometry";
+}
+
+//------------------------------------------------------------------------------
+// CheckOpenable
+//
+/// Return a value from 0-1 indicating probability that this source will be
+/// able to read this resource: all the "synthetic://" ones.
+///
+/// \param resource_name name of the resource to evaluate.
+/// \return              value from 0-1 indicating confidence that this source can open the given resource
+//------------------------------------------------------------------------------
+template <>
+double JEventSourceGeneratorT<JEventSourceSynthetic>::CheckOpenable(std::string resource_name) {
+    return resource_name.rfind("synthetic://", 0) == 0 ? 1.0 : 0.0;
+}
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JEventSource.h>
+#include <JANA/JEventSourceGeneratorT.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SyntheticHits.h"
+
+/**
+ * Event source of synthetic sim hits, to measure how the reconstruction
+ * scales with the occupancy: `eicrecon synthetic://1000` makes 1000 events
+ * (`synthetic://` never ends) of hits on the sensitive volumes of the
+ * `synth:readouts` of the DD4hep geometry, see eicrecon::SyntheticReadout.
+ *
+ * An event has an EventHeader, the MCParticles of the clusters, and a
+ * SimTrackerHit collection, or a SimCalorimeterHit collection and its
+ * `<readout>Contributions`, named after every readout, as in the output of
+ * the simulation. The hits of an event only depend on `synth:seed` and the
+ * event number.
+ */
+class JEventSourceSynthetic : public JEventSource {
+
+public:
+    JEventSourceSynthetic(std::string resource_name, JApplication* app);
+
+    virtual ~JEventSourceSynthetic() = default;
+
+    void Open() override;
+
+    void Close() override;
+
+    void GetEvent(std::shared_ptr<JEvent>) override;
+
+    static std::string GetDescription();
+
+protected:
+    std::string m_readouts_str;
+    std::string m_occupancies_str;
+    eicrecon::SyntheticHitsConfig m_cfg;
+    std::uint64_t m_seed = 1;
+    int m_run_number = 1;
+
+    std::vector<eicrecon::SyntheticReadout> m_readouts;
+    std::uint64_t m_max_events = 0; // 0 does not end
+    std::uint64_t m_events = 0;
+    std::uint64_t m_hits = 0;
+};
+
+template <>
+double JEventSourceGeneratorT<JEventSourceSynthetic>::CheckOpenable(std::string);
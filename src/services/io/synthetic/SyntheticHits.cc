@@ -0,0 +1,238 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "SyntheticHits.h"
+
+#include <DD4hep/DetElement.h>
+#include <DD4hep/Objects.h>
+#include <DD4hep/Readout.h>
+#include <DD4hep/Volumes.h>
+#include <TGeoBBox.h>
+#include <TGeoMatrix.h>
+#include <TGeoNode.h>
+#include <TGeoShape.h>
+#include <TGeoVolume.h>
+#include <edm4hep/Vector3f.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace eicrecon {
+
+namespace {
+
+  constexpr double speed_of_light = 299.792458; // mm/ns
+
+  /// Tries to find a point inside the solid of a volume for the clusters to start at
+  constexpr int max_seed_tries = 16;
+
+  void local_to_global(const double rotation[9], const double translation[3], const double local[3], double global[3]) {
+    for (int i = 0; i < 3; ++i) {
+      global[i] = rotation[3 * i] * local[0] + rotation[3 * i + 1] * local[1] + rotation[3 * i + 2] * local[2] + translation[i];
+    }
+  }
+
+  template <typename ParticleT>
+  void set_particle(ParticleT& particle, int pdg, const double direction[3]) {
+    const double norm = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+    using MomType = std::decay_t<decltype(particle.getMomentum().x)>;
+    const double p = 1.; // GeV
+    particle.setPDG(pdg);
+    particle.setGeneratorStatus(0);
+    particle.setCharge(pdg == 22 ? 0.f : 1.f);
+    particle.setMass(pdg == 22 ? 0. : 0.13957);
+    if (norm > 0) {
+      particle.setMomentum({static_cast<MomType>(p * direction[0] / norm), static_cast<MomType>(p * direction[1] / norm),
+                            static_cast<MomType>(p * direction[2] / norm)});
+    }
+  }
+
+}
+
+SyntheticReadout::SyntheticReadout(const dd4hep::Detector& detector, const std::string& readout, const SyntheticHitsConfig& cfg)
+    : m_name(readout), m_cfg(cfg) {
+
+  const auto dd4hep_readout = detector.readout(readout);
+  m_segmentation = dd4hep_readout.segmentation();
+  const auto* decoder = dd4hep_readout.idSpec().decoder();
+
+  // the sensitive volumes of the sensitive detectors of the readout, with their world transforms
+  std::function<void(dd4hep::PlacedVolume, dd4hep::VolumeID, const TGeoHMatrix&)> walk =
+      [&](dd4hep::PlacedVolume placement, dd4hep::VolumeID volume_id, const TGeoHMatrix& transform) {
+    for (const auto& [field, value] : placement.volIDs()) {
+      (*decoder)[field].set(volume_id, value);
+    }
+    auto volume = placement.volume();
+    const auto* box = dynamic_cast<const TGeoBBox*>(volume.solid().ptr());
+    if (volume.isSensitive() && box != nullptr) {
+      Sensor sensor{volume_id, box, {box->GetDX(), box->GetDY(), box->GetDZ()},
+                    {box->GetOrigin()[0], box->GetOrigin()[1], box->GetOrigin()[2]}, {}, {}, {}};
+      std::copy_n(transform.GetRotationMatrix(), 9, sensor.rotation);
+      std::copy_n(transform.GetTranslation(), 3, sensor.translation);
+
+      // the number of cells from the cell sizes at the center of the volume
+      double global[3];
+      local_to_global(sensor.rotation, sensor.translation, sensor.origin, global);
+      const auto cell_id = m_segmentation.cellID(dd4hep::Position(sensor.origin[0], sensor.origin[1], sensor.origin[2]),
+                                                 dd4hep::Position(global[0], global[1], global[2]), volume_id);
+      const auto dimensions = m_segmentation.cellDimensions(cell_id);
+      double cells = 1;
+      for (int i = 0; i < 2; ++i) {
+        sensor.cell[i] = 2 * sensor.half[i];
+        if (dimensions.size() > static_cast<std::size_t>(i) && dimensions[i] > 0) {
+          sensor.cell[i] = std::min(dimensions[i], 2 * sensor.half[i]);
+          cells *= 2 * sensor.half[i] / sensor.cell[i];
+        }
+      }
+      if (dimensions.size() > 2 && dimensions[2] > 0) {
+        cells *= std::max(1., 2 * sensor.half[2] / dimensions[2]);
+      }
+      m_sensors.push_back(sensor);
+      m_cells_end.push_back(this->cells() + std::max(1., cells));
+    }
+    for (Int_t i = 0; i < volume->GetNdaughters(); ++i) {
+      const auto* node = volume->GetNode(i);
+      TGeoHMatrix daughter = transform;
+      daughter.Multiply(node->GetMatrix());
+      walk(dd4hep::PlacedVolume(node), volume_id, daughter);
+    }
+  };
+  for (const auto& [name, handle] : detector.detectors()) {
+    const auto sensitive = detector.sensitiveDetector(name);
+    if (sensitive.isValid() && sensitive.readout().name() == readout) {
+      m_tracker = sensitive.type() != "calorimeter";
+      dd4hep::DetElement element(handle);
+      walk(element.placement(), 0, element.nominal().worldTransformation());
+    }
+  }
+  if (m_sensors.empty()) {
+    throw std::runtime_error("no sensitive volumes of the readout " + readout);
+  }
+}
+
+template <typename AddCluster>
+void SyntheticReadout::clusters(std::mt19937_64& rng, edm4hep::MCParticleCollection& particles, int pdg, AddCluster add) const {
+
+  const double mean_clusters = m_cfg.occupancy * cells() / std::max(1., m_cfg.clusterSize);
+  if (!(mean_clusters > 0)) {
+    return;
+  }
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::normal_distribution<double> gaussian(0., 1.);
+  const auto n_clusters = std::poisson_distribution<std::size_t>(mean_clusters)(rng);
+  std::poisson_distribution<std::size_t> extra_hits(std::max(1e-9, m_cfg.clusterSize - 1));
+
+  std::vector<Point> points;
+  for (std::size_t i = 0; i < n_clusters; ++i) {
+    // the volume, by its number of cells
+    const double cell = uniform(rng) * cells();
+    const auto s = std::min<std::size_t>(std::upper_bound(m_cells_end.begin(), m_cells_end.end(), cell) - m_cells_end.begin(),
+                                         m_sensors.size() - 1);
+    const auto& sensor = m_sensors[s];
+
+    // the seed of the cluster, inside the solid and not only in its bounding box
+    double seed[3];
+    bool inside = false;
+    for (int tries = 0; tries < max_seed_tries && !inside; ++tries) {
+      for (int k = 0; k < 3; ++k) {
+        seed[k] = sensor.origin[k] + (2 * uniform(rng) - 1) * sensor.half[k];
+      }
+      inside = sensor.solid->Contains(seed);
+    }
+    if (!inside) {
+      continue;
+    }
+
+    points.clear();
+    const std::size_t n_hits = 1 + (m_cfg.clusterSize > 1 ? extra_hits(rng) : 0);
+    for (std::size_t j = 0; j < n_hits; ++j) {
+      double local[3] = {seed[0], seed[1], seed[2]};
+      if (j > 0) {
+        for (int k = 0; k < 2; ++k) {
+          local[k] += gaussian(rng) * m_cfg.clusterSpread * sensor.cell[k];
+        }
+        if (!sensor.solid->Contains(local)) {
+          continue;
+        }
+      }
+      double global[3];
+      local_to_global(sensor.rotation, sensor.translation, local, global);
+      Point point;
+      point.cellID = m_segmentation.cellID(dd4hep::Position(local[0], local[1], local[2]),
+                                           dd4hep::Position(global[0], global[1], global[2]), sensor.volumeID);
+      for (int k = 0; k < 3; ++k) {
+        point.position[k] = global[k] / dd4hep::mm;
+      }
+      points.push_back(point);
+    }
+
+    auto particle = particles.create();
+    set_particle(particle, pdg, points.front().position);
+    const double start = uniform(rng) * m_cfg.timeWindow;
+    particle.setTime(static_cast<float>(start));
+    const double distance = std::hypot(points.front().position[0], points.front().position[1], points.front().position[2]);
+    const double time = start + distance / speed_of_light;
+    add(particle, points, time, 2 * sensor.half[2] / dd4hep::mm, rng);
+  }
+}
+
+void SyntheticReadout::generate(std::mt19937_64& rng, edm4hep::MCParticleCollection& particles,
+                                edm4hep::SimTrackerHitCollection& hits) const {
+  std::normal_distribution<double> gaussian(0., 1.);
+  clusters(rng, particles, 211, [&](const edm4hep::MCParticle& particle, const std::vector<Point>& points, double time,
+                                    double thickness, std::mt19937_64& generator) {
+    for (const auto& point : points) {
+      auto hit = hits.create();
+      hit.setCellID(point.cellID);
+      hit.setEDep(static_cast<float>(m_cfg.trackerEDep * std::exp(m_cfg.trackerEDepWidth * gaussian(generator))));
+      hit.setTime(static_cast<float>(time));
+      hit.setPathLength(static_cast<float>(thickness));
+      hit.setQuality(0);
+      hit.setPosition({point.position[0], point.position[1], point.position[2]});
+      hit.setMomentum({static_cast<float>(particle.getMomentum().x), static_cast<float>(particle.getMomentum().y),
+                       static_cast<float>(particle.getMomentum().z)});
+      hit.setMCParticle(particle);
+    }
+  });
+}
+
+void SyntheticReadout::generate(std::mt19937_64& rng, edm4hep::MCParticleCollection& particles,
+                                edm4hep::SimCalorimeterHitCollection& hits,
+                                edm4hep::CaloHitContributionCollection& contributions) const {
+  std::exponential_distribution<double> exponential(1. / m_cfg.caloHitEnergy);
+  std::vector<std::pair<dd4hep::CellID, edm4hep::MutableSimCalorimeterHit>> cluster_hits;
+  clusters(rng, particles, 22, [&](const edm4hep::MCParticle& particle, const std::vector<Point>& points, double time,
+                                   double /* thickness */, std::mt19937_64& generator) {
+    cluster_hits.clear();
+    for (const auto& point : points) {
+      const edm4hep::Vector3f position{static_cast<float>(point.position[0]), static_cast<float>(point.position[1]),
+                                       static_cast<float>(point.position[2])};
+      const auto energy = static_cast<float>(exponential(generator));
+      auto it = std::find_if(cluster_hits.begin(), cluster_hits.end(),
+                             [&point](const auto& cluster_hit) { return cluster_hit.first == point.cellID; });
+      if (it == cluster_hits.end()) {
+        auto hit = hits.create();
+        hit.setCellID(point.cellID);
+        hit.setEnergy(0);
+        hit.setPosition(position);
+        cluster_hits.emplace_back(point.cellID, hit);
+        it = std::prev(cluster_hits.end());
+      }
+      auto& hit = it->second;
+      auto contribution = contributions.create();
+      contribution.setPDG(particle.getPDG());
+      contribution.setEnergy(energy);
+      contribution.setTime(static_cast<float>(time));
+      contribution.setStepPosition(position);
+      contribution.setParticle(particle);
+      hit.addToContributions(contribution);
+      hit.setEnergy(hit.getEnergy() + energy);
+    }
+  });
+}
+
+} // namespace eicrecon
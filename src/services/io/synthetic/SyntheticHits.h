@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <DD4hep/Detector.h>
+#include <DD4hep/DD4hepUnits.h>
+#include <DD4hep/Segmentations.h>
+#include <edm4hep/CaloHitContributionCollection.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <edm4hep/SimCalorimeterHitCollection.h>
+#include <edm4hep/SimTrackerHitCollection.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+class TGeoShape;
+
+namespace eicrecon {
+
+/// Occupancy, clustering and energy spectra of the synthetic hits of a readout
+struct SyntheticHitsConfig {
+  double occupancy{1e-3};                   // mean fraction of the cells hit per event
+  double clusterSize{3};                    // mean number of hits per cluster
+  double clusterSpread{1};                  // standard deviation of the hits around the cluster seed, in cells
+  double trackerEDep{100 * dd4hep::keV};    // median of the log-normal deposits of the tracker hits
+  double trackerEDepWidth{0.3};             // standard deviation of the log of the tracker deposits
+  double caloHitEnergy{10 * dd4hep::MeV};   // mean of the exponential energies of the calorimeter hits
+  double timeWindow{0};                     // ns, uniform spread of the clusters after their time of flight
+};
+
+/**
+ * Synthetic sim hits of a DD4hep readout, for occupancy scaling tests
+ * without Geant4.
+ *
+ * The sensitive volumes of the readout are collected once, with their world
+ * transforms and the cell sizes of the segmentation. An event is a Poisson
+ * number of clusters, spread over the volumes by their number of cells. A
+ * cluster starts at a uniform point of a volume, its hits are spread around
+ * it in the local x and y, and the segmentation gives their cellIDs, which
+ * are therefore valid for any segmentation. Every cluster has a MCParticle of
+ * its own, with generator status 0, that its hits or contributions point to.
+ */
+class SyntheticReadout {
+public:
+  /// Throws std::runtime_error for a readout without sensitive volumes
+  SyntheticReadout(const dd4hep::Detector& detector, const std::string& readout, const SyntheticHitsConfig& cfg);
+
+  const std::string& name() const { return m_name; }
+  bool isTracker() const { return m_tracker; }
+  std::size_t volumes() const { return m_sensors.size(); }
+
+  /// Estimated from the bounding boxes of the volumes and the cell sizes
+  double cells() const { return m_cells_end.empty() ? 0. : m_cells_end.back(); }
+
+  void generate(std::mt19937_64& rng, edm4hep::MCParticleCollection& particles,
+                edm4hep::SimTrackerHitCollection& hits) const;
+
+  /// The hits of a cluster in the same cell are merged
+  void generate(std::mt19937_64& rng, edm4hep::MCParticleCollection& particles,
+                edm4hep::SimCalorimeterHitCollection& hits,
+                edm4hep::CaloHitContributionCollection& contributions) const;
+
+private:
+  struct Sensor {
+    dd4hep::VolumeID volumeID;
+    const TGeoShape* solid;
+    double half[3];        // of the bounding box
+    double origin[3];      // of the bounding box
+    double rotation[9];    // local to global
+    double translation[3];
+    double cell[2];        // sizes of the cells in the local x and y
+  };
+
+  struct Point {
+    dd4hep::CellID cellID;
+    double position[3];    // global, in mm
+  };
+
+  /// The points of the clusters of an event, calls add(particle, points) for every cluster
+  template <typename AddCluster>
+  void clusters(std::mt19937_64& rng, edm4hep::MCParticleCollection& particles, int pdg, AddCluster add) const;
+
+  std::string m_name;
+  bool m_tracker{true};
+  SyntheticHitsConfig m_cfg;
+  dd4hep::Segmentation m_segmentation;
+  std::vector<Sensor> m_sensors;
+  std::vector<double> m_cells_end; // cumulative number of cells of the sensors
+};
+
+} // namespace eicrecon
@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <JANA/JApplication.h>
+#include <JANA/JEventSourceGeneratorT.h>
+
+#include "JEventSourceSynthetic.h"
+
+
+// Make this a JANA plugin
+extern "C" {
+void InitPlugin(JApplication *app) {
+    InitJANAPlugin(app);
+    app->Add(new JEventSourceGeneratorT<JEventSourceSynthetic>());
+}
+}
@@ -5,17 +5,149 @@
 #include "Log_service.h"
 
 #include <JANA/JException.h>
+#include <fmt/core.h>
+#include <spdlog/async.h>
+#include <spdlog/async_logger.h>
+#include <spdlog/details/log_msg.h>
+#include <spdlog/sinks/base_sink.h>
 #include <spdlog/spdlog.h>
+#include <chrono>
 #include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "extensions/spdlog/SpdlogExtensions.h"
 
 
+namespace {
+
+    /// Limits the warnings and errors of every logger before they get to the sinks
+    class RateLimitSink : public spdlog::sinks::base_sink<std::mutex> {
+    public:
+        RateLimitSink(std::vector<spdlog::sink_ptr> sinks, std::size_t repeat_limit, std::size_t rate_limit)
+            : m_sinks(std::move(sinks)), m_repeat_limit(repeat_limit), m_rate_limit(rate_limit) {}
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg& msg) override {
+            if(msg.level < spdlog::level::warn) {
+                forward(msg);
+                return;
+            }
+            auto& state = m_loggers[std::string(msg.logger_name)];
+
+            const auto second = std::chrono::time_point_cast<std::chrono::seconds>(msg.time);
+            if(second != state.second) {
+                if(state.rate_suppressed > 0) {
+                    note(msg, fmt::format("{} more messages were suppressed in one second", state.rate_suppressed));
+                }
+                state.second = second;
+                state.in_second = 0;
+                state.rate_suppressed = 0;
+            }
+            if(m_rate_limit > 0 && ++state.in_second > m_rate_limit) {
+                ++state.rate_suppressed;
+                return;
+            }
+
+            if(m_repeat_limit > 0) {
+                // bounded, so that messages with varying values do not grow it forever
+                if(state.repeats.size() > 1024) state.repeats.clear();
+                const std::size_t count = ++state.repeats[std::string(msg.payload)];
+                if(count > m_repeat_limit) {
+                    // a reminder at 10, 100, ... times the limit
+                    std::size_t reminder = m_repeat_limit * 10;
+                    while(reminder < count) reminder *= 10;
+                    if(count == reminder) {
+                        note(msg, fmt::format("repeated {} times: {}", count, std::string_view(msg.payload.data(), msg.payload.size())));
+                    }
+                    return;
+                }
+                forward(msg);
+                if(count == m_repeat_limit) {
+                    note(msg, fmt::format("the last message was repeated {} times, further repeats are suppressed", count));
+                }
+                return;
+            }
+            forward(msg);
+        }
+
+        void flush_() override {
+            for(auto& sink : m_sinks) sink->flush();
+        }
+
+        void set_pattern_(const std::string& pattern) override {
+            for(auto& sink : m_sinks) sink->set_pattern(pattern);
+        }
+
+        void set_formatter_(std::unique_ptr<spdlog::formatter> sink_formatter) override {
+            for(auto& sink : m_sinks) sink->set_formatter(sink_formatter->clone());
+        }
+
+    private:
+        struct LoggerState {
+            std::chrono::time_point<spdlog::log_clock, std::chrono::seconds> second;
+            std::size_t in_second = 0;
+            std::size_t rate_suppressed = 0;
+            std::unordered_map<std::string, std::size_t> repeats;
+        };
+
+        void forward(const spdlog::details::log_msg& msg) {
+            for(auto& sink : m_sinks) {
+                if(sink->should_log(msg.level)) sink->log(msg);
+            }
+        }
+
+        void note(const spdlog::details::log_msg& msg, const std::string& text) {
+            forward(spdlog::details::log_msg(msg.time, msg.source, msg.logger_name, msg.level, text));
+        }
+
+        std::vector<spdlog::sink_ptr> m_sinks;
+        std::size_t m_repeat_limit;
+        std::size_t m_rate_limit;
+        std::unordered_map<std::string, LoggerState> m_loggers;
+    };
+
+}
+
+
 Log_service::Log_service(JApplication *app) {
     // Here one could add centralized documentation for spdlog::default_logger()
     // All subsequent loggers are cloned from the spdlog::default_logger()
     m_application = app;
 
+    m_application->SetDefaultParameter("eicrecon:LogAsync", m_async, "write the log messages from a background thread");
+    m_application->SetDefaultParameter("eicrecon:LogAsyncQueueSize", m_async_queue_size, "number of messages queued for the background thread");
+    m_application->SetDefaultParameter("eicrecon:LogAsyncOverflow", m_async_overflow, "when the queue is full: block, or overrun_oldest to drop the oldest messages");
+    m_application->SetDefaultParameter("eicrecon:LogRepeatLimit", m_repeat_limit, "identical warnings and errors of a logger are suppressed after this many, 0 for no limit");
+    m_application->SetDefaultParameter("eicrecon:LogRateLimit", m_rate_limit, "warnings and errors of a logger above this many per second are suppressed, 0 for no limit");
+
+    if(m_async || m_repeat_limit > 0 || m_rate_limit > 0) {
+        // All subsequent loggers are cloned from it, and share its sinks
+        auto sinks = spdlog::default_logger()->sinks();
+        if(m_repeat_limit > 0 || m_rate_limit > 0) {
+            sinks = {std::make_shared<RateLimitSink>(sinks, m_repeat_limit, m_rate_limit)};
+        }
+        std::shared_ptr<spdlog::logger> default_logger;
+        if(m_async) {
+            spdlog::async_overflow_policy policy = spdlog::async_overflow_policy::block;
+            if(m_async_overflow == "overrun_oldest") {
+                policy = spdlog::async_overflow_policy::overrun_oldest;
+            } else if(m_async_overflow != "block") {
+                throw JException("eicrecon:LogAsyncOverflow must be block or overrun_oldest, not '%s'", m_async_overflow.c_str());
+            }
+            spdlog::init_thread_pool(m_async_queue_size, 1);
+            default_logger = std::make_shared<spdlog::async_logger>("", sinks.begin(), sinks.end(), spdlog::thread_pool(), policy);
+        } else {
+            default_logger = std::make_shared<spdlog::logger>("", sinks.begin(), sinks.end());
+        }
+        spdlog::set_default_logger(default_logger);
+    }
+
     m_log_level_str = "info";
     m_application->SetDefaultParameter("eicrecon:LogLevel", m_log_level_str, "log_level: trace, debug, info, warn, error, critical, off");
     spdlog::default_logger()->set_level(eicrecon::ParseLogLevel(m_log_level_str));
@@ -28,7 +160,10 @@ Log_service::Log_service(JApplication *app) {
 
 // Virtual destructor implementation to pin vtable and typeinfo to this
 // translation unit
-Log_service::~Log_service() {};
+Log_service::~Log_service() {
+    // the background thread writes what is still queued
+    if(m_async) spdlog::default_logger()->flush();
+};
 
 
 std::shared_ptr<spdlog::logger> Log_service::logger(
@@ -9,9 +9,17 @@
 #include <mutex>
 #include <optional>
 #include <string>
+#include <cstddef>
 
 /**
  * The Service centralizes use of spdlog
+ *
+ * With -Peicrecon:LogAsync=true the messages are written by a background
+ * thread, so that the worker threads do not wait on the console. Bursts of
+ * warnings are limited per logger: identical messages after
+ * eicrecon:LogRepeatLimit repeats, and all the messages above
+ * eicrecon:LogRateLimit per second are suppressed, with a count of what was
+ * dropped.
  */
 class Log_service : public JService
 {
@@ -43,4 +51,10 @@ private:
     JApplication* m_application;
     std::string m_log_level_str;
     std::string m_log_format_str;
+
+    bool m_async = false;
+    std::size_t m_async_queue_size = 8192;
+    std::string m_async_overflow = "block";
+    std::size_t m_repeat_limit = 100;
+    std::size_t m_rate_limit = 0;
 };
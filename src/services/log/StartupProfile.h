@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+/**
+ * Wall time of the phases of the job startup: geometry, material maps,
+ * lookup tables, JIT compilation and factory initialisation.
+ *
+ * A `StartupProfile::Scope` on the stack times its block. Scopes nest per
+ * thread, so that every phase has an inclusive time and a self time that
+ * excludes the phases it triggered, e.g. the DD4hep geometry built from the
+ * Init of the first factory that needs it. The self times of one thread add
+ * up; the phases run in background threads (the preloaded PID lookup tables)
+ * overlap the others. A scope takes two clock readings and a lock, it is
+ * only meant for the code that runs once per job, or once per factory.
+ *
+ * The breakdown is printed at the end of the job with
+ * `-Peicrecon:StartupProfile=true`, see StartupProfile_processor. Every
+ * scope is also a TraceRange of the profiler timeline.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "services/log/TraceRange.h"
+
+namespace eicrecon {
+
+class StartupProfile {
+public:
+  static StartupProfile& instance() {
+    static StartupProfile profile;
+    return profile;
+  }
+
+  struct Entry {
+    std::string phase;
+    std::string name;
+    std::uint64_t calls{0};
+    std::uint64_t total_ns{0};
+    std::uint64_t self_ns{0};
+    std::uint64_t max_ns{0};
+  };
+
+  /// Times a block as one call of `phase`, `name` tells apart the instances of the phase
+  class Scope {
+  public:
+    explicit Scope(std::string phase, std::string name = "")
+      : m_phase(std::move(phase)), m_name(std::move(name)), m_parent(current())
+      , m_trace(m_name.empty() ? m_phase : m_phase + " " + m_name) {
+      current() = this;
+    }
+    ~Scope() {
+      const auto elapsed = static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+      current() = m_parent;
+      if (m_parent != nullptr) {
+        m_parent->m_children_ns += elapsed;
+      }
+      StartupProfile::instance().add(m_phase, m_name, elapsed, elapsed - std::min(elapsed, m_children_ns));
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    static Scope*& current() {
+      thread_local Scope* scope = nullptr;
+      return scope;
+    }
+
+    std::string m_phase;
+    std::string m_name;
+    Scope* m_parent;
+    std::uint64_t m_children_ns{0};
+    std::chrono::steady_clock::time_point m_start{std::chrono::steady_clock::now()};
+    TraceRange m_trace; // of the profiler timeline, with USE_NVTX or USE_ITT
+  };
+
+  void add(const std::string& phase, const std::string& name, std::uint64_t total_ns, std::uint64_t self_ns) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& entry = m_entries[{phase, name}];
+    entry.phase = phase;
+    entry.name = name;
+    entry.calls += 1;
+    entry.total_ns += total_ns;
+    entry.self_ns += self_ns;
+    entry.max_ns = std::max(entry.max_ns, total_ns);
+  }
+
+  /// Adds a phase that is not a scope of its own, e.g. from the first plugin to the first processor,
+  /// whose self time excludes the scopes that ended meanwhile in the same process
+  void add_span(const std::string& phase, std::chrono::steady_clock::time_point start) {
+    const auto elapsed = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    std::uint64_t nested_ns = 0;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (const auto& [key, entry] : m_entries) {
+        nested_ns += entry.self_ns;
+      }
+    }
+    add(phase, "", elapsed, elapsed - std::min(elapsed, nested_ns));
+  }
+
+  /// Entries ranked by decreasing self time
+  std::vector<Entry> entries() const {
+    std::vector<Entry> ranked;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (const auto& [key, entry] : m_entries) {
+        ranked.push_back(entry);
+      }
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const Entry& a, const Entry& b) { return a.self_ns > b.self_ns; });
+    return ranked;
+  }
+
+  /// Entries summed per phase, ranked by decreasing self time
+  std::vector<Entry> phases() const {
+    std::map<std::string, Entry> sums;
+    for (const auto& entry : entries()) {
+      auto& sum = sums[entry.phase];
+      sum.phase = entry.phase;
+      sum.calls += entry.calls;
+      sum.total_ns += entry.total_ns;
+      sum.self_ns += entry.self_ns;
+      sum.max_ns = std::max(sum.max_ns, entry.max_ns);
+    }
+    std::vector<Entry> ranked;
+    for (auto& [phase, sum] : sums) {
+      ranked.push_back(std::move(sum));
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const Entry& a, const Entry& b) { return a.self_ns > b.self_ns; });
+    return ranked;
+  }
+
+  bool write_json(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+      return false;
+    }
+    const auto write = [&out](const std::vector<Entry>& list) {
+      for (std::size_t i = 0; i < list.size(); ++i) {
+        const auto& e = list[i];
+        out << (i == 0 ? "\n    " : ",\n    ") << "{\"phase\": \"" << escape(e.phase) << "\", \"name\": \""
+            << escape(e.name) << "\", \"calls\": " << e.calls << ", \"total_ns\": " << e.total_ns
+            << ", \"self_ns\": " << e.self_ns << ", \"max_ns\": " << e.max_ns << "}";
+      }
+    };
+    out << "{\n  \"phases\": [";
+    write(phases());
+    out << "\n  ],\n  \"entries\": [";
+    write(entries());
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+  }
+
+private:
+  StartupProfile() = default;
+
+  static std::string escape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+      if (c == '"' || c == '\\') {
+        escaped += '\\';
+      }
+      escaped += c;
+    }
+    return escaped;
+  }
+
+  mutable std::mutex m_mutex;
+  std::map<std::pair<std::string, std::string>, Entry> m_entries;
+};
+
+} // namespace eicrecon
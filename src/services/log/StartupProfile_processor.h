@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JEventProcessor.h>
+#include <spdlog/logger.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Log_service.h"
+#include "StartupProfile.h"
+
+/**
+ * Prints the startup breakdown of StartupProfile at the end of the job,
+ * with `-Peicrecon:StartupProfile=true`, and writes it as JSON to
+ * `eicrecon:StartupProfileFile` if it is set.
+ *
+ * The log plugin is the first one loaded, so the span from its InitPlugin
+ * to the Init of this processor is reported as plugin loading: the shared
+ * libraries, their InitPlugin and the services set up meanwhile. The
+ * factories are initialised later, on the first event that needs them.
+ */
+class StartupProfile_processor : public JEventProcessor {
+public:
+  explicit StartupProfile_processor(std::chrono::steady_clock::time_point plugins_start)
+    : JEventProcessor(), m_plugins_start(plugins_start) {
+    SetTypeName("StartupProfile_processor");
+  }
+
+  void Init() override {
+    auto app = GetApplication();
+    app->SetDefaultParameter("eicrecon:StartupProfile", m_enabled, "Print the time of the startup phases at the end of the job");
+    app->SetDefaultParameter("eicrecon:StartupProfileFile", m_json_file, "Write the time of the startup phases to this JSON file");
+    eicrecon::StartupProfile::instance().add_span("plugin loading", m_plugins_start);
+    if (m_enabled || !m_json_file.empty()) {
+      m_log = app->GetService<Log_service>()->logger("StartupProfile");
+    }
+  }
+
+  void Process(const std::shared_ptr<const JEvent>& event) override { }
+
+  void Finish() override {
+    if (m_log == nullptr) {
+      return;
+    }
+    const auto& profile = eicrecon::StartupProfile::instance();
+    if (m_enabled) {
+      const auto phases = profile.phases();
+      std::uint64_t self_ns = 0;
+      for (const auto& phase : phases) {
+        self_ns += phase.self_ns;
+      }
+      m_log->info("Startup phases, {:.2f} s in total:", self_ns * 1e-9);
+      m_log->info("{:>10} {:>10} {:>7} {:>7}  {}", "self [s]", "incl [s]", "share", "calls", "phase");
+      for (const auto& phase : phases) {
+        m_log->info("{:10.3f} {:10.3f} {:6.1f}% {:7}  {}", phase.self_ns * 1e-9, phase.total_ns * 1e-9,
+                    100. * phase.self_ns / std::max<std::uint64_t>(self_ns, 1), phase.calls, phase.phase);
+      }
+      const auto entries = profile.entries();
+      m_log->info("Slowest {} of the {} startup steps:", std::min(entries.size(), m_top), entries.size());
+      for (std::size_t i = 0; i < std::min(entries.size(), m_top); ++i) {
+        const auto& entry = entries[i];
+        m_log->info("{:10.3f} {:10.3f}  {} {}", entry.self_ns * 1e-9, entry.total_ns * 1e-9, entry.phase, entry.name);
+      }
+    }
+    if (!m_json_file.empty()) {
+      if (profile.write_json(m_json_file)) {
+        m_log->info("Startup profile written to {}", m_json_file);
+      } else {
+        m_log->error("Can not write the startup profile to {}", m_json_file);
+      }
+    }
+  }
+
+private:
+  std::chrono::steady_clock::time_point m_plugins_start;
+  bool m_enabled{false};
+  std::string m_json_file;
+  std::size_t m_top{20};
+  std::shared_ptr<spdlog::logger> m_log;
+};
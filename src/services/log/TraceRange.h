@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+/**
+ * Named ranges for the timelines of Nsight Systems and VTune.
+ *
+ * With `-DUSE_NVTX=ON` a `TraceRange` on the stack is an NVTX push/pop
+ * range, with `-DUSE_ITT=ON` an Intel ITT task of the "eicrecon" domain,
+ * both if both are on. Otherwise the classes are empty and the ranges cost
+ * nothing. A `TraceName` keeps the backend handles of a name that is used
+ * for every event, e.g. the prefix of a factory:
+ *
+ *     m_trace_name = eicrecon::TraceName(m_prefix);    // once
+ *     const eicrecon::TraceRange range(m_trace_name);  // per event
+ *
+ * The factories, the podio reads and writes, and the StartupProfile scopes
+ * of the services are annotated.
+ */
+
+#include <string>
+
+#if defined(EICRECON_TRACE_NVTX)
+#include <nvtx3/nvToolsExt.h>
+#endif
+#if defined(EICRECON_TRACE_ITT)
+#include <ittnotify.h>
+#endif
+
+namespace eicrecon {
+
+class TraceName {
+public:
+  TraceName() = default;
+  explicit TraceName([[maybe_unused]] const std::string& name)
+#if defined(EICRECON_TRACE_NVTX) || defined(EICRECON_TRACE_ITT)
+    : m_name(name)
+#endif
+  {
+#if defined(EICRECON_TRACE_ITT)
+    m_itt_name = __itt_string_handle_create(m_name.c_str());
+#endif
+  }
+
+private:
+  friend class TraceRange;
+
+#if defined(EICRECON_TRACE_NVTX) || defined(EICRECON_TRACE_ITT)
+  std::string m_name;
+#endif
+#if defined(EICRECON_TRACE_ITT)
+  __itt_string_handle* m_itt_name = nullptr;
+
+  static __itt_domain* domain() {
+    static __itt_domain* const itt_domain = __itt_domain_create("eicrecon");
+    return itt_domain;
+  }
+#endif
+};
+
+class TraceRange {
+public:
+  explicit TraceRange([[maybe_unused]] const TraceName& name) {
+#if defined(EICRECON_TRACE_NVTX)
+    nvtxRangePushA(name.m_name.c_str());
+#endif
+#if defined(EICRECON_TRACE_ITT)
+    __itt_task_begin(TraceName::domain(), __itt_null, __itt_null, name.m_itt_name);
+#endif
+  }
+
+  /// For the ranges that are only opened once, the name is looked up every time
+  explicit TraceRange(const std::string& name) : TraceRange(TraceName(name)) {}
+
+  ~TraceRange() {
+#if defined(EICRECON_TRACE_ITT)
+    __itt_task_end(TraceName::domain());
+#endif
+#if defined(EICRECON_TRACE_NVTX)
+    nvtxRangePop();
+#endif
+  }
+
+  TraceRange(const TraceRange&)            = delete;
+  TraceRange& operator=(const TraceRange&) = delete;
+};
+
+} // namespace eicrecon
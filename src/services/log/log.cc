@@ -4,14 +4,18 @@
 //
 
 #include <JANA/JApplication.h>
+#include <chrono>
 #include <memory>
 
 #include "Log_service.h"
+#include "StartupProfile_processor.h"
 
 
 extern "C" {
 void InitPlugin(JApplication *app) {
+    const auto plugins_start = std::chrono::steady_clock::now();
     InitJANAPlugin(app);
     app->ProvideService(std::make_shared<Log_service>(app) );
+    app->Add(new StartupProfile_processor(plugins_start));
 }
 }
@@ -13,17 +13,138 @@
 #include <stdlib.h>
 #include <algorithm>
 #include <cctype>
+#include <exception>
 #include <fstream> // IWYU pragma: keep
 #include <iterator>
 #include <sstream> // IWYU pragma: keep
 #include <stdexcept>
+
+#include "services/geometry/disk_cache/CacheFile.h"
 // IWYU pragma: no_include <boost/mp11/detail/mp_defer.hpp>
 
 namespace bh = boost::histogram;
 
 namespace eicrecon {
 
-const PIDLookupTable::Entry* PIDLookupTable::Lookup(int pdg, int charge, double momentum, double theta_deg, double phi_deg) const {
+namespace {
+
+  // of the layout of the table in its cache file
+  constexpr std::uint32_t file_version = 2;
+
+  struct TableHeader {
+    std::uint64_t symmetrizing_charges;
+    std::uint64_t n_pdg;
+    std::uint64_t n_charge;
+    std::uint64_t n_momentum;
+    std::uint64_t n_polar;
+    std::uint64_t n_azimuthal;
+    double azimuthal_lower; // degrees
+    double azimuthal_upper; // degrees
+  };
+
+  // The header is followed by the int32 pdg and charge values, padded to 8
+  // bytes, the double momentum and polar (degrees) edges, and the float
+  // electron, pion, kaon and proton probability arrays of all bins
+  std::size_t padded(std::size_t size) { return (size + 7) / 8 * 8; }
+
+  template <typename Axis>
+  std::optional<std::size_t> inner_index(const Axis& axis, typename Axis::value_type value) {
+    const auto index = axis.index(value);
+    if ((index < 0) || (index >= static_cast<decltype(index)>(axis.size()))) {
+      return std::nullopt;
+    }
+    return static_cast<std::size_t>(index);
+  }
+
+} // namespace
+
+void PIDLookupTable::set_axes(const PIDLookupTable::Binning &binning) {
+    const double angle_fudge = binning.use_radians ? 180. / M_PI : 1.;
+
+    m_pdg_axis = bh::axis::category<int>(binning.pdg_values);
+    m_charge_axis = bh::axis::category<int>(binning.charge_values);
+    m_momentum_axis = bh::axis::variable<>(binning.momentum_edges);
+    std::vector<double> polar_edges = binning.polar_edges;
+    for (double &edge : polar_edges) {
+      edge *= angle_fudge;
+    }
+    m_polar_axis = bh::axis::variable<>(polar_edges);
+    m_azimuthal_axis = bh::axis::circular<>(bh::axis::step(binning.azimuthal_binning.at(2) * angle_fudge), binning.azimuthal_binning.at(0) * angle_fudge, binning.azimuthal_binning.at(1) * angle_fudge);
+
+    m_symmetrizing_charges = binning.charge_values.size() == 1;
+
+    build_indices();
+}
+
+std::size_t PIDLookupTable::n_bins() const {
+    return m_pdg_axis.size() * m_charge_axis.size() * m_momentum_axis.size() * m_polar_axis.size() * m_azimuthal_axis.size();
+}
+
+void PIDLookupTable::set_probabilities(const float* probs, std::size_t n_bins) {
+    m_prob_electron = {probs, n_bins};
+    m_prob_pion = {probs + n_bins, n_bins};
+    m_prob_kaon = {probs + 2 * n_bins, n_bins};
+    m_prob_proton = {probs + 3 * n_bins, n_bins};
+}
+
+void PIDLookupTable::EdgeIndex::build(const bh::axis::variable<>& axis) {
+    const std::size_t n = axis.size();
+    edges.resize(n + 1);
+    for (std::size_t i = 0; i <= n; ++i) {
+      edges[i] = axis.value(i);
+    }
+    lower = edges.front();
+    upper = edges.back();
+
+    const double width = (upper - lower) / n;
+    bool uniform = true;
+    for (std::size_t i = 0; i < n; ++i) {
+      uniform &= std::abs(edges[i + 1] - edges[i] - width) <= 1e-9 * std::abs(width);
+    }
+
+    // a few cells per bin, so that the guess is mostly right or one bin off
+    n_cells = uniform ? n : 4 * n;
+    inv_cell_width = n_cells / (upper - lower);
+    cell_bin.clear();
+    if (!uniform) {
+      cell_bin.resize(n_cells);
+      for (std::size_t c = 0; c < n_cells; ++c) {
+        const double x = lower + c / inv_cell_width;
+        cell_bin[c] = std::upper_bound(edges.begin(), edges.end(), x) - edges.begin() - 1;
+      }
+    }
+}
+
+std::optional<std::size_t> PIDLookupTable::EdgeIndex::index(double x) const {
+    // also false for NaN
+    if (!((x >= lower) && (x < upper))) {
+      return std::nullopt;
+    }
+    const std::size_t cell = std::min(static_cast<std::size_t>((x - lower) * inv_cell_width), n_cells - 1);
+    std::size_t bin = cell_bin.empty() ? cell : cell_bin[cell];
+    while ((bin > 0) && (x < edges[bin])) {
+      --bin;
+    }
+    while ((bin + 2 < edges.size()) && (x >= edges[bin + 1])) {
+      ++bin;
+    }
+    return bin;
+}
+
+void PIDLookupTable::build_indices() {
+    m_pdg_values.resize(m_pdg_axis.size());
+    for (std::size_t i = 0; i < m_pdg_values.size(); ++i) {
+      m_pdg_values[i] = m_pdg_axis.value(i);
+    }
+    m_charge_values.resize(m_charge_axis.size());
+    for (std::size_t i = 0; i < m_charge_values.size(); ++i) {
+      m_charge_values[i] = m_charge_axis.value(i);
+    }
+    m_momentum_index.build(m_momentum_axis);
+    m_polar_index.build(m_polar_axis);
+}
+
+std::optional<std::size_t> PIDLookupTable::bin_index(int pdg, int charge, double momentum, double theta_deg, double phi_deg) const {
     // Our lookup table expects _unsigned_ PDGs. The charge information is passed separately.
     pdg = std::abs(pdg);
 
@@ -31,15 +152,43 @@ const PIDLookupTable::Entry* PIDLookupTable::Lookup(int pdg, int charge, double
       charge = std::abs(charge);
     }
 
-    return &m_hist[
-      decltype(m_hist)::multi_index_type {
-        m_hist.axis(0).index(pdg),
-        m_hist.axis(1).index(charge),
-        m_hist.axis(2).index(momentum),
-        m_hist.axis(3).index(theta_deg),
-        m_hist.axis(4).index(phi_deg)
-      }
-    ];
+    // a handful of categories
+    const auto i_pdg = std::find(m_pdg_values.begin(), m_pdg_values.end(), pdg) - m_pdg_values.begin();
+    const auto i_charge = std::find(m_charge_values.begin(), m_charge_values.end(), charge) - m_charge_values.begin();
+    if ((i_pdg == static_cast<std::ptrdiff_t>(m_pdg_values.size())) || (i_charge == static_cast<std::ptrdiff_t>(m_charge_values.size()))) {
+      return std::nullopt;
+    }
+
+    const auto i_momentum = m_momentum_index.index(momentum);
+    const auto i_polar = m_polar_index.index(theta_deg);
+    // wrapped as by the circular axis
+    const auto i_azimuthal = inner_index(m_azimuthal_axis, phi_deg);
+    if (!i_momentum || !i_polar || !i_azimuthal) {
+      return std::nullopt;
+    }
+
+    const std::size_t n_momentum = m_momentum_index.edges.size() - 1;
+    const std::size_t n_polar = m_polar_index.edges.size() - 1;
+    return (((i_pdg * m_charge_values.size() + i_charge) * n_momentum + *i_momentum) * n_polar + *i_polar)
+           * m_azimuthal_axis.size() + *i_azimuthal;
+}
+
+std::optional<PIDLookupTable::Entry> PIDLookupTable::Lookup(int pdg, int charge, double momentum, double theta_deg, double phi_deg) const {
+    const auto bin = bin_index(pdg, charge, momentum, theta_deg, phi_deg);
+    if (!bin) {
+      return std::nullopt;
+    }
+    return Entry{m_prob_electron[*bin], m_prob_pion[*bin], m_prob_kaon[*bin], m_prob_proton[*bin]};
+}
+
+void PIDLookupTable::Lookup(std::span<const PIDLookupTable::Query> queries, std::span<std::optional<PIDLookupTable::Entry>> entries) const {
+    const std::size_t n = std::min(queries.size(), entries.size());
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto& query = queries[i];
+      const auto bin = bin_index(query.pdg, query.charge, query.momentum, query.theta_deg, query.phi_deg);
+      entries[i] = bin ? std::optional<Entry>{Entry{m_prob_electron[*bin], m_prob_pion[*bin], m_prob_kaon[*bin], m_prob_proton[*bin]}}
+                       : std::nullopt;
+    }
 }
 
 void PIDLookupTable::load_file(const std::string& filename, const PIDLookupTable::Binning &binning) {
@@ -62,31 +211,22 @@ void PIDLookupTable::load_file(const std::string& filename, const PIDLookupTable
 
     std::string line;
     std::istringstream iss;
-    double step;
 
     const double angle_fudge = binning.use_radians ? 180. / M_PI : 1.;
 
-    bh::axis::category<int> pdg_bins(binning.pdg_values);
-    bh::axis::category<int> charge_bins(binning.charge_values);
-    bh::axis::variable<> momentum_bins(binning.momentum_edges);
-    std::vector<double> polar_edges = binning.polar_edges;
-    for (double &edge : polar_edges) {
-      edge *= angle_fudge;
-    }
-    bh::axis::variable<> polar_bins(polar_edges);
-    bh::axis::circular<> azimuthal_bins(bh::axis::step(binning.azimuthal_binning.at(2) * angle_fudge), binning.azimuthal_binning.at(0) * angle_fudge, binning.azimuthal_binning.at(1) * angle_fudge);
-
-    m_hist = bh::make_histogram_with(bh::dense_storage<PIDLookupTable::Entry>(), pdg_bins, charge_bins, momentum_bins, polar_bins, azimuthal_bins);
-
-    m_symmetrizing_charges = binning.charge_values.size() == 1;
+    set_axes(binning);
+    const std::size_t bins = n_bins();
+    m_mapping.reset();
+    m_owned_probs.assign(4 * bins, 0.f);
+    set_probabilities(m_owned_probs.data(), bins);
+    std::vector<unsigned int> counts(bins, 0);
 
     while (std::getline(in, line)) {
-        Entry entry;
         if (line.empty() || line[0] == '#' || std::all_of(std::begin(line), std::end(line), [](unsigned char c) { return std::isspace(c); })) continue;
 
         iss.str(line);
         iss.clear();
-        double pdg, charge, momentum, eta, phi, prob_electron, prob_pion, prob_kaon, prob_proton;
+        double pdg, charge, momentum, eta, phi, prob_electron = 0., prob_pion, prob_kaon, prob_proton;
         // Read each field from the line and assign to Entry struct members
         if ((bool)(iss >> pdg
                 >> charge
@@ -102,18 +242,26 @@ void PIDLookupTable::load_file(const std::string& filename, const PIDLookupTable
               charge = std::abs(charge);
             }
 
-            // operator() here allows to lookup mutable entry and increases the access counter
-            auto &entry = *m_hist(
-              pdg,
-              charge,
-              momentum + (binning.momentum_bin_centers_in_lut ? 0. : (momentum_bins.bin(0).width() / 2)),
-              eta * angle_fudge + (binning.polar_bin_centers_in_lut ? 0. : (polar_bins.bin(0).width() / 2)),
-              phi * angle_fudge + (binning.azimuthal_bin_centers_in_lut ? 0. : (azimuthal_bins.bin(0).width() / 2))
-            ); // N.B. bin(0) may not be of a correct width
-            entry.prob_electron = prob_electron;
-            entry.prob_pion = prob_pion;
-            entry.prob_kaon = prob_kaon;
-            entry.prob_proton = prob_proton;
+            const auto i_pdg = inner_index(m_pdg_axis, static_cast<int>(pdg));
+            const auto i_charge = inner_index(m_charge_axis, static_cast<int>(charge));
+            const auto i_momentum = inner_index(m_momentum_axis,
+              momentum + (binning.momentum_bin_centers_in_lut ? 0. : (m_momentum_axis.bin(0).width() / 2)));
+            const auto i_polar = inner_index(m_polar_axis,
+              eta * angle_fudge + (binning.polar_bin_centers_in_lut ? 0. : (m_polar_axis.bin(0).width() / 2)));
+            const auto i_azimuthal = inner_index(m_azimuthal_axis,
+              phi * angle_fudge + (binning.azimuthal_bin_centers_in_lut ? 0. : (m_azimuthal_axis.bin(0).width() / 2)));
+            // N.B. bin(0) may not be of a correct width
+            if (!i_pdg || !i_charge || !i_momentum || !i_polar || !i_azimuthal) {
+              debug("Ignoring LUT line outside of the binning: {}", line);
+              continue;
+            }
+            const std::size_t bin = (((*i_pdg * m_charge_axis.size() + *i_charge) * m_momentum_axis.size() + *i_momentum)
+                                     * m_polar_axis.size() + *i_polar) * m_azimuthal_axis.size() + *i_azimuthal;
+            counts[bin]++;
+            m_owned_probs[bin] = prob_electron;
+            m_owned_probs[bins + bin] = prob_pion;
+            m_owned_probs[2 * bins + bin] = prob_kaon;
+            m_owned_probs[3 * bins + bin] = prob_proton;
         }
         else {
             error("Unable to parse LUT file!");
@@ -121,20 +269,29 @@ void PIDLookupTable::load_file(const std::string& filename, const PIDLookupTable
         }
     }
 
-    for (auto&& b : bh::indexed(m_hist)) {
-      if (b->value() != 1) {
-        error(
-          "Bin {} {} {}:{} {}:{} {}:{} is defined {} times in the PID table",
-          b.bin(0).lower(),
-          b.bin(1).lower(),
-          b.bin(2).lower(),
-          b.bin(2).upper(),
-          b.bin(3).lower() / angle_fudge,
-          b.bin(3).upper() / angle_fudge,
-          b.bin(4).lower() / angle_fudge,
-          b.bin(4).upper() / angle_fudge,
-          b->value()
-        );
+    std::size_t bin = 0;
+    for (std::size_t i_pdg = 0; i_pdg < m_pdg_axis.size(); ++i_pdg) {
+      for (std::size_t i_charge = 0; i_charge < m_charge_axis.size(); ++i_charge) {
+        for (std::size_t i_momentum = 0; i_momentum < m_momentum_axis.size(); ++i_momentum) {
+          for (std::size_t i_polar = 0; i_polar < m_polar_axis.size(); ++i_polar) {
+            for (std::size_t i_azimuthal = 0; i_azimuthal < m_azimuthal_axis.size(); ++i_azimuthal, ++bin) {
+              if (counts[bin] != 1) {
+                error(
+                  "Bin {} {} {}:{} {}:{} {}:{} is defined {} times in the PID table",
+                  m_pdg_axis.value(i_pdg),
+                  m_charge_axis.value(i_charge),
+                  m_momentum_axis.bin(i_momentum).lower(),
+                  m_momentum_axis.bin(i_momentum).upper(),
+                  m_polar_axis.bin(i_polar).lower() / angle_fudge,
+                  m_polar_axis.bin(i_polar).upper() / angle_fudge,
+                  m_azimuthal_axis.bin(i_azimuthal).lower() / angle_fudge,
+                  m_azimuthal_axis.bin(i_azimuthal).upper() / angle_fudge,
+                  counts[bin]
+                );
+              }
+            }
+          }
+        }
       }
     }
 
@@ -142,4 +299,132 @@ void PIDLookupTable::load_file(const std::string& filename, const PIDLookupTable
     file.close();
 }
 
+bool PIDLookupTable::is_binary(const std::string& filename) {
+    return cache_file::stored_key(filename, file_version).has_value();
+}
+
+bool PIDLookupTable::load_binary(const std::string& filename, const PIDLookupTable::Binning &binning, std::uint64_t key) {
+    if (key == 0) {
+      key = cache_file::stored_key(filename, file_version).value_or(0);
+    }
+    const auto blob = cache_file::load(filename, file_version, 0, key);
+    if (!blob) {
+      return false;
+    }
+
+    // the table has to have the configured binning
+    set_axes(binning);
+    const std::size_t bins = n_bins();
+    try {
+      const TableHeader header = blob->array<TableHeader>(0, 1)[0];
+      if ((header.n_pdg != m_pdg_axis.size()) || (header.n_charge != m_charge_axis.size())
+          || (header.n_momentum != m_momentum_axis.size()) || (header.n_polar != m_polar_axis.size())
+          || (header.n_azimuthal != m_azimuthal_axis.size())) {
+        error("Binary PID table {} does not have the configured binning", filename);
+        return false;
+      }
+      const std::size_t values_offset = sizeof(TableHeader);
+      const std::size_t edges_offset = values_offset + padded((header.n_pdg + header.n_charge) * sizeof(std::int32_t));
+      const std::size_t probs_offset = edges_offset + padded((header.n_momentum + header.n_polar + 2) * sizeof(double));
+      const auto values = blob->array<std::int32_t>(values_offset, header.n_pdg + header.n_charge);
+      const auto edges = blob->array<double>(edges_offset, header.n_momentum + header.n_polar + 2);
+      const auto probs = blob->array<float>(probs_offset, 4 * bins);
+      if (blob->data().size() != padded(probs_offset + 4 * bins * sizeof(float))) {
+        error("Binary PID table {} does not have the configured binning", filename);
+        return false;
+      }
+
+      bool same_binning = (header.azimuthal_lower == m_azimuthal_axis.value(0))
+                          && (header.azimuthal_upper == m_azimuthal_axis.value(m_azimuthal_axis.size()))
+                          && (header.symmetrizing_charges == static_cast<std::uint64_t>(m_symmetrizing_charges));
+      for (std::size_t i = 0; i < header.n_pdg; ++i) {
+        same_binning &= values[i] == m_pdg_axis.value(i);
+      }
+      for (std::size_t i = 0; i < header.n_charge; ++i) {
+        same_binning &= values[header.n_pdg + i] == m_charge_axis.value(i);
+      }
+      for (std::size_t i = 0; i <= header.n_momentum; ++i) {
+        same_binning &= edges[i] == m_momentum_axis.value(i);
+      }
+      for (std::size_t i = 0; i <= header.n_polar; ++i) {
+        same_binning &= edges[header.n_momentum + 1 + i] == m_polar_axis.value(i);
+      }
+      if (!same_binning) {
+        error("Binary PID table {} does not have the configured binning", filename);
+        return false;
+      }
+
+      m_owned_probs.clear();
+      m_mapping = blob->mapping();
+      set_probabilities(probs.data(), bins);
+    } catch (const std::out_of_range&) {
+      error("Binary PID table {} is truncated", filename);
+      return false;
+    }
+    return true;
+}
+
+bool PIDLookupTable::write_binary(const std::string& filename, std::uint64_t key) const {
+    const std::size_t bins = n_bins();
+    const TableHeader header{
+      .symmetrizing_charges = m_symmetrizing_charges,
+      .n_pdg = static_cast<std::uint64_t>(m_pdg_axis.size()),
+      .n_charge = static_cast<std::uint64_t>(m_charge_axis.size()),
+      .n_momentum = static_cast<std::uint64_t>(m_momentum_axis.size()),
+      .n_polar = static_cast<std::uint64_t>(m_polar_axis.size()),
+      .n_azimuthal = static_cast<std::uint64_t>(m_azimuthal_axis.size()),
+      .azimuthal_lower = m_azimuthal_axis.value(0),
+      .azimuthal_upper = m_azimuthal_axis.value(m_azimuthal_axis.size()),
+    };
+    std::vector<std::int32_t> values;
+    for (std::size_t i = 0; i < m_pdg_axis.size(); ++i) {
+      values.push_back(m_pdg_axis.value(i));
+    }
+    for (std::size_t i = 0; i < m_charge_axis.size(); ++i) {
+      values.push_back(m_charge_axis.value(i));
+    }
+    std::vector<double> edges;
+    for (std::size_t i = 0; i <= m_momentum_axis.size(); ++i) {
+      edges.push_back(m_momentum_axis.value(i));
+    }
+    for (std::size_t i = 0; i <= m_polar_axis.size(); ++i) {
+      edges.push_back(m_polar_axis.value(i));
+    }
+    // the four arrays are consecutive, both when owned and when mapped
+    const std::span<const float> probs(m_prob_electron.data(), 4 * bins);
+
+    try {
+      cache_file::store(filename, file_version, 0, key,
+                        {std::as_bytes(std::span(&header, 1)), std::as_bytes(std::span(values)),
+                         std::as_bytes(std::span(edges)), std::as_bytes(probs)});
+    } catch (const std::exception& e) {
+      error("Can not write binary PID table {}: {}", filename, e.what());
+      return false;
+    }
+    return true;
+}
+
+std::uint64_t PIDLookupTable::key(const std::string& filename, const PIDLookupTable::Binning &binning) {
+    CacheHash hash;
+    hash.add(static_cast<std::uint64_t>(file_version));
+    for (const auto& values : {binning.pdg_values, binning.charge_values}) {
+      hash.add(static_cast<std::uint64_t>(values.size()));
+      for (int value : values) {
+        hash.add(static_cast<std::uint64_t>(value));
+      }
+    }
+    for (const auto& edges : {binning.momentum_edges, binning.polar_edges, binning.azimuthal_binning}) {
+      hash.add(static_cast<std::uint64_t>(edges.size()));
+      for (double edge : edges) {
+        hash.add(edge);
+      }
+    }
+    for (bool flag : {binning.azimuthal_bin_centers_in_lut, binning.momentum_bin_centers_in_lut,
+                      binning.polar_bin_centers_in_lut, binning.use_radians, binning.missing_electron_prob}) {
+      hash.add(static_cast<std::uint64_t>(flag));
+    }
+    hash.add_file(filename);
+    return hash.value() == 0 ? 1 : hash.value();
+}
+
 }
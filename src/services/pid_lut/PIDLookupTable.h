@@ -5,19 +5,40 @@
 
 #include <algorithms/logger.h>
 #include <boost/histogram.hpp>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
-#include <tuple>
 #include <vector>
 // IWYU pragma: no_include <boost/mp11/detail/mp_defer.hpp>
 
 namespace eicrecon {
 
+/**
+ * The probabilities of every bin are stored as four dense float arrays (one
+ * per hypothesis), either owned by the table when parsed from the text
+ * format or pointing into a memory mapped binary table. The binary format is
+ * a cache_file of a header with the axes followed by the arrays, see
+ * write_binary().
+ */
 class PIDLookupTable : public algorithms::LoggerMixin {
 
 public:
-    /// The histogram entry with access counter, where the probabilities are stored in metadata
-    struct Entry : public boost::histogram::accumulators::count<unsigned char, false> {
-        double prob_electron, prob_pion, prob_kaon, prob_proton;
+    /// The probabilities of a bin
+    struct Entry {
+        float prob_electron, prob_pion, prob_kaon, prob_proton;
+    };
+
+    /// A lookup of the batched Lookup()
+    struct Query {
+        int pdg;
+        int charge;
+        double momentum;
+        double theta_deg;
+        double phi_deg;
     };
 
     struct Binning {
@@ -31,28 +52,72 @@ public:
       bool polar_bin_centers_in_lut;
       bool use_radians;
       bool missing_electron_prob;
+
+      auto operator<=>(const Binning&) const = default;
     };
 
 private:
-    boost::histogram::histogram<
-      std::tuple<
-        boost::histogram::axis::category<int>,
-        boost::histogram::axis::category<int>,
-        boost::histogram::axis::variable<>,
-        boost::histogram::axis::variable<>,
-        boost::histogram::axis::circular<>
-      >
-      , boost::histogram::dense_storage<Entry>
-    > m_hist;
-    bool m_symmetrizing_charges;
+    // angles in degrees
+    boost::histogram::axis::category<int> m_pdg_axis;
+    boost::histogram::axis::category<int> m_charge_axis;
+    boost::histogram::axis::variable<> m_momentum_axis;
+    boost::histogram::axis::variable<> m_polar_axis;
+    boost::histogram::axis::circular<> m_azimuthal_axis;
+    bool m_symmetrizing_charges{false};
+
+    std::vector<float> m_owned_probs;
+    std::shared_ptr<const void> m_mapping;
+    std::span<const float> m_prob_electron, m_prob_pion, m_prob_kaon, m_prob_proton;
+
+    /// Bin index of axes of increasing edges, without binary searches: the
+    /// bin is guessed arithmetically (uniform edges) or from a table of the
+    /// bins of finer equal cells (variable edges), then corrected against the
+    /// neighbouring edges
+    struct EdgeIndex {
+      std::vector<double> edges;
+      std::vector<std::uint32_t> cell_bin; // empty for uniform edges
+      double lower{0}, upper{0}, inv_cell_width{0};
+      std::size_t n_cells{0};
+
+      void build(const boost::histogram::axis::variable<>& axis);
+      std::optional<std::size_t> index(double x) const;
+    };
+
+    std::vector<int> m_pdg_values;
+    std::vector<int> m_charge_values;
+    EdgeIndex m_momentum_index;
+    EdgeIndex m_polar_index;
+
+    void set_axes(const Binning &binning);
+    void build_indices();
+    std::optional<std::size_t> bin_index(int pdg, int charge, double momentum, double theta_deg, double phi_deg) const;
+    void set_probabilities(const float* probs, std::size_t n_bins);
+    std::size_t n_bins() const;
 
 public:
 
     PIDLookupTable() : algorithms::LoggerMixin("PIDLookupTable") {};
 
-    const Entry* Lookup(int pdg, int charge, double momentum, double theta_deg, double phi_deg) const;
+    /// Probabilities of the bin, std::nullopt outside of the table
+    std::optional<Entry> Lookup(int pdg, int charge, double momentum, double theta_deg, double phi_deg) const;
 
+    /// Probabilities of a batch of bins, `entries[i]` is the lookup of `queries[i]`
+    void Lookup(std::span<const Query> queries, std::span<std::optional<Entry>> entries) const;
+
+    /// Parses a (gzipped) text table
     void load_file(const std::string& filename, const Binning &binning);
+
+    /// Whether the file starts like a binary table
+    static bool is_binary(const std::string& filename);
+
+    /// Memory maps a binary table, false if it is invalid, does not match the key (unless 0) or the binning
+    bool load_binary(const std::string& filename, const Binning &binning, std::uint64_t key = 0);
+
+    /// Writes the table in the binary format, false on failure
+    bool write_binary(const std::string& filename, std::uint64_t key = 0) const;
+
+    /// Key of the binary table converted from a text table with a binning
+    static std::uint64_t key(const std::string& filename, const Binning &binning);
 };
 
 }
@@ -5,42 +5,150 @@
 
 #include <algorithms/logger.h>
 #include "PIDLookupTable.h"
+#include "services/geometry/disk_cache/CacheFile.h"
+#include "services/log/StartupProfile.h"
 #include <JANA/Services/JServiceLocator.h>
 #include <JANA/JLogger.h>
-#include <mutex>
+#include <fmt/core.h>
+#include <cstdint>
 #include <filesystem>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace eicrecon {
 
+/**
+ * Loads each PID lookup table once per binning. Tables in the binary format
+ * are memory mapped. Text tables are parsed and converted to the binary format
+ * in the cache directory, keyed by a hash of the file and the binning, and
+ * later runs map the converted table instead.
+ *
+ * Tables can be scheduled with preload() when the plugins are loaded, they
+ * are then loaded in background threads as soon as the service is
+ * initialized, and load() only waits for them.
+ */
 class PIDLookupTableSvc : public algorithms::LoggedService<PIDLookupTableSvc> {
 public:
-    void init() {};
+    void init() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_initialized = true;
+        if (m_preload.value()) {
+            for (auto& [key, table] : m_tables) {
+                start(key, table);
+            }
+        }
+    };
 
-    const PIDLookupTable* load(std::string filename, const PIDLookupTable::Binning &binning) {
+    /// Schedules the loading of a table in the background, does nothing if it is already scheduled
+    void preload(const std::string& filename, const PIDLookupTable::Binning &binning) {
         std::lock_guard<std::mutex> lock(m_mutex);
-        auto pair = m_cache.find(filename);
-        if (pair == m_cache.end()) {
-            auto lut = std::make_unique<PIDLookupTable>();
-            info("Loading PID lookup table \"{}\"", filename);
+        auto [it, inserted] = m_tables.try_emplace({filename, binning});
+        if (inserted && m_initialized && m_preload.value()) {
+            start(it->first, it->second);
+        }
+    }
 
-            if (!std::filesystem::exists(filename)) {
-                error("PID lookup table \"{}\" not found", filename);
-                return nullptr;
+    /// Waits for the tables that are being loaded, without their errors, which load() reports
+    void wait() {
+        std::vector<std::shared_future<std::shared_ptr<const PIDLookupTable>>> futures;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& [key, table] : m_tables) {
+                if (table.future.valid()) {
+                    futures.push_back(table.future);
+                }
             }
+        }
+        for (const auto& future : futures) {
+            future.wait();
+        }
+    }
 
-            lut->load_file(filename, binning); // load_file can except
-            auto result_ptr = lut.get();
-            m_cache.insert({filename, std::move(lut)});
-            return result_ptr;
+    const PIDLookupTable* load(std::string filename, const PIDLookupTable::Binning &binning) {
+        std::shared_future<std::shared_ptr<const PIDLookupTable>> future;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            // a table preloaded with another binning, e.g. before a parameter changed it, is not used
+            auto [it, inserted] = m_tables.try_emplace({filename, binning});
+            start(it->first, it->second);
+            future = it->second.future;
         }
-        else {
-            return pair->second.get();
+        // waits for the table without holding the lock, load_file can except
+        eicrecon::StartupProfile::Scope profile("PID lookup table wait", filename);
+        return future.get().get();
+    }
+
+private:
+    /// A table is loaded for each binning it is requested with
+    using Key = std::pair<std::string, PIDLookupTable::Binning>;
+
+    struct Table {
+        std::shared_future<std::shared_ptr<const PIDLookupTable>> future;
+    };
+
+    /// Starts loading the table unless it is already started, m_mutex must be held
+    void start(const Key& key, Table& table) {
+        if (table.future.valid()) {
+            return;
         }
+        table.future = std::async(std::launch::async, [this, key]() {
+            return read(key.first, key.second);
+        }).share();
+    }
+
+    std::shared_ptr<const PIDLookupTable> read(const std::string& filename, const PIDLookupTable::Binning &binning) const {
+        eicrecon::StartupProfile::Scope profile("PID lookup table", filename);
+        auto lut = std::make_shared<PIDLookupTable>();
+        info("Loading PID lookup table \"{}\"", filename);
+
+        if (!std::filesystem::exists(filename)) {
+            error("PID lookup table \"{}\" not found", filename);
+            return nullptr;
+        }
+
+        if (PIDLookupTable::is_binary(filename)) {
+            if (!lut->load_binary(filename, binning)) {
+                error("PID lookup table \"{}\" is not a valid binary table", filename);
+                return nullptr;
+            }
+        } else {
+            const std::string cache_dir = m_useCache.value() ? cacheDirectory() : "";
+            const std::uint64_t key = cache_dir.empty() ? 0 : PIDLookupTable::key(filename, binning);
+            const std::string path = cache_dir.empty() ? "" : fmt::format("{}/pid_lut_{:016x}.bin", cache_dir, key);
+            if (!path.empty() && lut->load_binary(path, binning, key)) {
+                info("Mapped converted PID lookup table \"{}\"", path);
+            } else {
+                lut->load_file(filename, binning); // load_file can except
+                // a table that can not be written is not an error, it is parsed again next time
+                if (!path.empty() && lut->write_binary(path, key)) {
+                    info("Converted PID lookup table to \"{}\"", path);
+                }
+            }
+        }
+        return lut;
     }
 
 private:
+    std::string cacheDirectory() const {
+        if (!m_cacheDir.value().empty()) {
+            return m_cacheDir.value();
+        }
+        return cache_file::default_directory();
+    }
+
+    Property<std::string> m_cacheDir{this, "cacheDir", "",
+                                     "Directory of the converted tables, $XDG_CACHE_HOME/eicrecon or ~/.cache/eicrecon if empty"};
+    Property<bool> m_useCache{this, "useCache", true, "Convert text tables to binary tables in the cache directory"};
+    Property<bool> m_preload{this, "preload", true, "Load the scheduled tables in the background when initialized"};
+
     std::mutex m_mutex;
-    std::map<std::string, std::unique_ptr<PIDLookupTable>> m_cache;
+    bool m_initialized{false};
+    std::map<Key, Table> m_tables;
 
     ALGORITHMS_DEFINE_LOGGED_SERVICE(PIDLookupTableSvc);
 };
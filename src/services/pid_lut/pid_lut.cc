@@ -5,6 +5,7 @@
 #include <algorithms/service.h>
 
 #include "PIDLookupTableSvc.h"
+#include "services/algorithms_init/ParallelInit.h"
 
 extern "C" {
 
@@ -14,5 +15,6 @@ void InitPlugin(JApplication* app) {
   auto& serviceSvc = algorithms::ServiceSvc::instance();
   auto& pidLookupTableSvc = eicrecon::PIDLookupTableSvc::instance();
   serviceSvc.add<eicrecon::PIDLookupTableSvc>(&pidLookupTableSvc);
+  eicrecon::ParallelInit::instance().addBeforeFork("pid_lut", [&pidLookupTableSvc]() { pidLookupTableSvc.wait(); });
 }
 }
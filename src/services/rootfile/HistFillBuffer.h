@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/Services/JGlobalRootLock.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <TH3.h>
+#include <cstddef>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * The histogram fills of an event, kept by a processor while it loops over
+ * the hits and clusters and made by Flush() under a single write lock of the
+ * global root lock. For histograms that are too large to be cloned for every
+ * thread by ThreadLocalHist, e.g. the TH3Ds of E vs. eta of the benchmarks.
+ */
+class HistFillBuffer {
+public:
+    explicit HistFillBuffer(std::size_t reserve = 0) { m_fills.reserve(reserve); }
+
+    void Fill(TH1* hist, double x, double w = 1.) { m_fills.push_back({hist, Dim::X, x, w, 0.}); }
+    void Fill(TH2* hist, double x, double y) { m_fills.push_back({hist, Dim::XY, x, y, 0.}); }
+    void Fill(TH3* hist, double x, double y, double z) { m_fills.push_back({hist, Dim::XYZ, x, y, z}); }
+
+    bool Empty() const { return m_fills.empty(); }
+
+    /// Makes the fills under the write lock and clears them
+    void Flush(JGlobalRootLock& lock) {
+        if (m_fills.empty()) return;
+        lock.acquire_write_lock();
+        for (const auto& fill : m_fills) {
+            switch (fill.dim) {
+            case Dim::X:   fill.hist->Fill(fill.x, fill.y); break;
+            case Dim::XY:  static_cast<TH2*>(fill.hist)->Fill(fill.x, fill.y); break;
+            case Dim::XYZ: static_cast<TH3*>(fill.hist)->Fill(fill.x, fill.y, fill.z); break;
+            }
+        }
+        lock.release_lock();
+        m_fills.clear();
+    }
+
+private:
+    enum class Dim { X, XY, XYZ };
+    struct Entry {
+        TH1* hist;
+        Dim dim;
+        double x, y, z; // y is the weight of a TH1 fill
+    };
+    std::vector<Entry> m_fills;
+};
+
+} // namespace eicrecon
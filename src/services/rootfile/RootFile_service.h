@@ -1,10 +1,14 @@
 #pragma once
 
 
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
 #include <iostream>
 #include <vector>
 #include <string>
 #include <mutex>
+#include <thread>
 
 #include <JANA/JApplication.h>
 #include "services/log/Log_service.h"
@@ -12,9 +16,18 @@
 #include <JANA/Services/JServiceLocator.h>
 
 #include <TFile.h>
+#include <TH1.h>
+#include <TROOT.h>
+
+#include "ThreadLocalHist.h"
 
 /**
  * This Service centralizes creation of a root file for histograms
+ *
+ * With -Phistsfile:publish=<file>, e.g. in /dev/shm, a snapshot of the
+ * histograms of the file is also written every histsfile:publish_interval
+ * seconds for a live view of long online runs. The per-thread clones of
+ * MakeThreadLocal() are merged into it incrementally, see ThreadLocalHist.
  */
 class RootFile_service : public JService
 {
@@ -25,6 +38,17 @@ public:
     void acquire_services(JServiceLocator *locater) override {
         auto log_service = m_app->GetService<Log_service>();
         m_log = log_service->logger("RootFile");
+
+        m_app->SetDefaultParameter("histsfile:publish", m_publish_file,
+                                   "Snapshot file of the histograms of the histsfile, replaced every histsfile:publish_interval while the job runs, e.g. /dev/shm/eicrecon_live.root for live monitoring (none if empty)");
+        m_app->SetDefaultParameter("histsfile:publish_interval", m_publish_interval,
+                                   "Seconds between the snapshots of histsfile:publish");
+        if (!m_publish_file.empty()) {
+            // the snapshots are written by their own thread
+            ROOT::EnableThreadSafety();
+            m_publish_thread = std::thread(&RootFile_service::PublishLoop, this);
+            m_log->info("Publishing the histograms to {} every {} s", m_publish_file, m_publish_interval);
+        }
     }
 
     /// This will return a pointer to the top-level directory of the
@@ -56,6 +80,35 @@ public:
         return m_histfile;
     }
 
+    /// Per-thread clones of a histogram of the file, which worker threads
+    /// fill without the global root lock. They are merged into the
+    /// histogram by MergeThreadHists() when the file is closed, or by
+    /// ThreadLocalHist::Merge() in the Finish() of the owner.
+    template <class T>
+    std::shared_ptr<eicrecon::ThreadLocalHist<T>> MakeThreadLocal(T* hist) {
+        auto result = std::make_shared<eicrecon::ThreadLocalHist<T>>(hist, m_app->GetService<JGlobalRootLock>());
+        std::lock_guard<std::mutex> lock(m_thread_hists_mutex);
+        m_thread_hists.push_back(result);
+        return result;
+    }
+
+    /// Merge all the per-thread clones of MakeThreadLocal() into their histograms
+    void MergeThreadHists() {
+        std::lock_guard<std::mutex> lock(m_thread_hists_mutex);
+        for (auto& weak : m_thread_hists) {
+            if (auto hist = weak.lock()) hist->Merge();
+        }
+    }
+
+    /// Add the fills of the per-thread clones of MakeThreadLocal() that the threads have handed over
+    /// to their histograms, while they keep filling. The global root write lock must be held
+    void PublishThreadHists() {
+        std::lock_guard<std::mutex> lock(m_thread_hists_mutex);
+        for (auto& weak : m_thread_hists) {
+            if (auto hist = weak.lock()) hist->Publish();
+        }
+    }
+
     /// Close the histogram file. If no histogram file was opened,
     /// then this does nothing.
     ///
@@ -67,7 +120,9 @@ public:
     /// a fatal crash and we want to try and save the work by
     /// closing the file cleanly.
     void CloseHistFile(){
+        StopPublishing();
         if( m_histfile){
+            MergeThreadHists();
             std::string filename = m_histfile->GetName();
             m_histfile->Write();
             delete m_histfile;
@@ -96,10 +151,76 @@ private:
         }
     }
 
+    /// Body of the thread of histsfile:publish
+    void PublishLoop() {
+        std::unique_lock<std::mutex> lock(m_publish_mutex);
+        while (!m_publish_cv.wait_for(lock, std::chrono::duration<double>(m_publish_interval), [this]{ return m_publish_stop; })) {
+            lock.unlock();
+            try {
+                Publish();
+            } catch (std::exception& e) {
+                m_log->error("Publishing the histograms to {} failed: {}", m_publish_file, e.what());
+            }
+            lock.lock();
+        }
+    }
+
+    /// Write the histograms of the file, with the fills handed over by the threads so far,
+    /// to a new snapshot that replaces the previous one at once
+    void Publish() {
+        const std::string tmp_file = m_publish_file + ".tmp";
+        auto root_lock = m_app->GetService<JGlobalRootLock>();
+        root_lock->acquire_write_lock();
+        if (m_histfile == nullptr) {
+            root_lock->release_lock();
+            return;
+        }
+        PublishThreadHists();
+        {
+            TDirectory::TContext context;
+            TFile snapshot(tmp_file.c_str(), "RECREATE", "live user histograms");
+            CopyHists(m_histfile, &snapshot);
+            snapshot.Close();
+        }
+        root_lock->release_lock();
+        std::filesystem::rename(tmp_file, m_publish_file);
+    }
+
+    /// Write the histograms of a directory and of its subdirectories to another
+    static void CopyHists(TDirectory* from, TDirectory* to) {
+        for (TObject* object : *from->GetList()) {
+            if (auto* dir = dynamic_cast<TDirectory*>(object)) {
+                CopyHists(dir, to->mkdir(dir->GetName(), dir->GetTitle()));
+            } else if (object->InheritsFrom(TH1::Class())) {
+                to->WriteTObject(object);
+            }
+        }
+    }
+
+    void StopPublishing() {
+        if (!m_publish_thread.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(m_publish_mutex);
+            m_publish_stop = true;
+        }
+        m_publish_cv.notify_all();
+        m_publish_thread.join();
+    }
+
     RootFile_service()=default;
 
     JApplication *m_app=nullptr;
     std::shared_ptr<spdlog::logger> m_log;
     TFile *m_histfile = nullptr;
     std::once_flag init_flag;
+    std::mutex m_thread_hists_mutex;
+    std::vector<std::weak_ptr<eicrecon::ThreadLocalHistBase>> m_thread_hists;
+
+    // With histsfile:publish, a snapshot of the histograms is written every m_publish_interval
+    std::string m_publish_file;
+    double m_publish_interval = 10; // s
+    std::thread m_publish_thread;
+    std::mutex m_publish_mutex;
+    std::condition_variable m_publish_cv;
+    bool m_publish_stop = false;
 };
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/Services/JGlobalRootLock.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace eicrecon {
+
+class ThreadLocalHistBase {
+public:
+    virtual ~ThreadLocalHistBase() = default;
+
+    /// Adds the per-thread clones to the histogram and resets them
+    virtual void Merge() = 0;
+
+    /// Adds the fills that the threads have handed over since the last call to the histogram,
+    /// while they go on filling
+    virtual void Publish() = 0;
+
+protected:
+    static inline std::atomic<std::uint64_t> s_next_id{0};
+};
+
+/**
+ * Per-thread clones of a histogram, so that worker threads fill it without
+ * the global root lock. The clones are made on the first Get() of every
+ * thread and added to the histogram by Merge(), which RootFile_service calls
+ * before writing the file; a processor may also call it in Finish() to use
+ * the merged histogram.
+ *
+ *     m_hist = root_file_service->MakeThreadLocal(new TH1F(...));  // in Init()
+ *     m_hist->Get()->Fill(x);                                        // in Process()
+ *
+ * Merge() must not run concurrently with Get()->Fill(). For live monitoring,
+ * Publish() may: it gives every thread a second clone and starts a new
+ * epoch, and on its next Get() the thread swaps its filled clone for the
+ * empty one, which the following Publish() adds to the histogram and gives
+ * back. The fill path only reads the epoch, the clones are exchanged with
+ * atomics, and threads that fill nothing hand nothing over.
+ */
+template <class T>
+class ThreadLocalHist : public ThreadLocalHistBase {
+public:
+    ThreadLocalHist(T* hist, std::shared_ptr<JGlobalRootLock> root_lock)
+        : m_hist(hist), m_root_lock(std::move(root_lock)) {}
+
+    ~ThreadLocalHist() override { Merge(); }
+
+    /// The histogram of the calling thread
+    T* Get() {
+        // ids are never reused, so entries of destroyed instances are never found again
+        thread_local std::unordered_map<std::uint64_t, Slot*> slots;
+        auto& slot = slots[m_id];
+        if (slot == nullptr) {
+            m_root_lock->acquire_write_lock();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_slots.push_back(std::make_unique<Slot>());
+                slot = m_slots.back().get();
+                slot->active = MakeClone();
+                slot->epoch = m_epoch.load(std::memory_order_relaxed);
+            }
+            m_root_lock->release_lock();
+        }
+        if (slot->epoch != m_epoch.load(std::memory_order_relaxed)) {
+            // the empty clone is only there once Publish() is done with the previous fills
+            if (T* empty = slot->spare.exchange(nullptr, std::memory_order_acquire)) {
+                slot->ready.store(slot->active, std::memory_order_release);
+                slot->active = empty;
+                slot->epoch = m_epoch.load(std::memory_order_relaxed);
+            }
+        }
+        return slot->active;
+    }
+
+    /// The merged histogram, complete after Merge()
+    T* Hist() const { return m_hist; }
+
+    void Merge() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& clone : m_clones) {
+            // empty after a previous merge, m_hist may be gone by then
+            if (clone->GetEntries() == 0) continue;
+            m_hist->Add(clone.get());
+            clone->Reset();
+        }
+    }
+
+    /// To be called with the global root write lock held, e.g. by RootFile_service
+    void Publish() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& slot : m_slots) {
+            if (!slot->has_spare) {
+                slot->spare.store(MakeClone(), std::memory_order_release);
+                slot->has_spare = true;
+            } else if (T* filled = slot->ready.exchange(nullptr, std::memory_order_acquire)) {
+                m_hist->Add(filled);
+                filled->Reset();
+                slot->spare.store(filled, std::memory_order_release);
+            }
+        }
+        m_epoch.fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        T* active = nullptr;  // filled by the thread
+        std::uint64_t epoch = 0;  // of the last hand-over of the thread
+        std::atomic<T*> ready{nullptr};  // handed over to Publish()
+        std::atomic<T*> spare{nullptr};  // empty, given back by Publish()
+        bool has_spare = false;
+    };
+
+    /// An empty clone of the histogram, m_root_lock and m_mutex must be held
+    T* MakeClone() {
+        auto* clone = static_cast<T*>(m_hist->Clone());
+        clone->SetDirectory(nullptr);
+        clone->Reset();
+        m_clones.emplace_back(clone);
+        return clone;
+    }
+
+    T* m_hist;
+    std::shared_ptr<JGlobalRootLock> m_root_lock;
+    const std::uint64_t m_id{s_next_id++};
+    std::atomic<std::uint64_t> m_epoch{0};
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<Slot>> m_slots;
+    std::vector<std::unique_ptr<T>> m_clones;
+};
+
+} // namespace eicrecon
@@ -1,10 +1,17 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 // Copyright (C) 2024, Wouter Deconinck
 
+#include <DD4hep/DetElement.h>
 #include <DD4hep/Detector.h>
+#include <DD4hep/Objects.h>
 #include <DD4hep/IDDescriptor.h>
 #include <DD4hep/Readout.h>
 #include <DD4hep/Segmentations.h>
+#include <DD4hep/Shapes.h>
+#include <DD4hep/Volumes.h>
+#include <Evaluator/DD4hepUnits.h>
+#include <TGeoMaterial.h>
+#include <TGeoMedium.h>
 #include <algorithms/geo.h>
 #include <algorithms/random.h>
 #include <algorithms/service.h>
@@ -13,6 +20,7 @@
 #include <catch2/reporters/catch_reporter_event_listener.hpp>
 #include <catch2/reporters/catch_reporter_registrars.hpp>
 #include <services/evaluator/EvaluatorSvc.h>
+#include <services/geometry/cellid_cache/CellIDGeometryCacheSvc.h>
 #include <services/pid_lut/PIDLookupTableSvc.h>
 #include <stddef.h>
 #include <cstdint>
@@ -20,6 +28,8 @@
 #include <string>
 #include <utility>
 
+#include "algorithms/interfaces/CounterRandomSvc.h"
+
 class algorithmsInitListener : public Catch::EventListenerBase {
 public:
   using Catch::EventListenerBase::EventListenerBase;
@@ -30,10 +40,33 @@ public:
     auto detector = dd4hep::Detector::make_unique("");
     dd4hep::Readout readout(std::string("MockCalorimeterHits"));
     dd4hep::IDDescriptor id_desc("MockCalorimeterHits", "system:8,layer:8,x:8,y:8");
+    dd4hep::Segmentation segmentation_calorimeter("NoSegmentation", "CalorimeterHitsSeg", id_desc.decoder());
     readout.setIDDescriptor(id_desc);
+    readout.setSegmentation(segmentation_calorimeter);
     detector->add(id_desc);
     detector->add(readout);
 
+    // The cells of MockCalorimeterHits with system 255 are in a single volume at the origin, so that their
+    // geometry can be looked up: they all have the position, DetElement and dimensions of that volume
+    new TGeoMedium("Air", 1, new TGeoMaterial("Air", 0, 0, 0));
+    new TGeoMedium("Vacuum", 2, new TGeoMaterial("Vacuum", 0, 0, 0));
+    detector->add(dd4hep::Constant("world_x", "1*m"));
+    detector->add(dd4hep::Constant("world_y", "1*m"));
+    detector->add(dd4hep::Constant("world_z", "1*m"));
+    detector->init();
+    dd4hep::SensitiveDetector sensitive_calorimeter("MockCalorimeter", "calorimeter");
+    sensitive_calorimeter.setReadout(readout);
+    detector->add(sensitive_calorimeter);
+    dd4hep::Volume calorimeter_volume("MockCalorimeter",
+                                      dd4hep::Box(10 * dd4hep::cm, 10 * dd4hep::cm, 1 * dd4hep::cm),
+                                      detector->air());
+    calorimeter_volume.setSensitiveDetector(sensitive_calorimeter);
+    dd4hep::PlacedVolume calorimeter_placement = detector->worldVolume().placeVolume(calorimeter_volume);
+    calorimeter_placement.addPhysVolID("system", 255);
+    dd4hep::DetElement calorimeter("MockCalorimeter", 255);
+    calorimeter.setPlacement(calorimeter_placement);
+    detector->add(calorimeter);
+
     dd4hep::Readout readoutTracker(std::string("MockTrackerHits"));
     dd4hep::IDDescriptor id_desc_tracker("MockTrackerHits", "system:8,layer:8,x:8,y:8");
     //Create segmentation with 1x1 mm pixels
@@ -43,6 +76,9 @@ public:
     detector->add(id_desc_tracker);
     detector->add(readoutTracker);
 
+    detector->add(dd4hep::Constant("MockCalorimeter_ID", "101"));
+    detector->endDocument();
+
     m_detector = std::move(detector);
 
     auto& serviceSvc = algorithms::ServiceSvc::instance();
@@ -58,9 +94,15 @@ public:
       r.init();
     });
 
+    auto& counterRandomSvc = eicrecon::CounterRandomSvc::instance();
+    serviceSvc.add<eicrecon::CounterRandomSvc>(&counterRandomSvc);
+
     auto& evaluatorSvc = eicrecon::EvaluatorSvc::instance();
     serviceSvc.add<eicrecon::EvaluatorSvc>(&evaluatorSvc);
 
+    auto& geoCacheSvc = eicrecon::CellIDGeometryCacheSvc::instance();
+    serviceSvc.add<eicrecon::CellIDGeometryCacheSvc>(&geoCacheSvc);
+
     auto& lutSvc = eicrecon::PIDLookupTableSvc::instance();
     serviceSvc.add<eicrecon::PIDLookupTableSvc>(&lutSvc);
 
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+// synthetic events for the algorithm benchmarks (the `*_benchmark.cc` files)
+#pragma once
+
+#include <DD4hep/Detector.h>
+#include <DD4hep/IDDescriptor.h>
+#include <DD4hep/Readout.h>
+#include <Evaluator/DD4hepUnits.h>
+#include <algorithms/geo.h>
+#include <edm4eic/CalorimeterHitCollection.h>
+#include <edm4hep/Vector3f.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace eicrecon::benchmark {
+
+  // Numbers of hits per event of the benchmarks, 100, 1000 and 10000 by
+  // default, or the comma separated list of EICRECON_BENCHMARK_HITS
+  inline std::vector<std::size_t> occupancies() {
+    std::vector<std::size_t> n_hits;
+    if (const char* env = std::getenv("EICRECON_BENCHMARK_HITS")) {
+      std::string list(env);
+      std::size_t pos = 0;
+      while (pos < list.size()) {
+        std::size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        if (end > pos) n_hits.push_back(std::stoul(list.substr(pos, end - pos)));
+        pos = end + 1;
+      }
+    }
+    if (n_hits.empty()) {
+      n_hits = {100, 1000, 10000};
+    }
+    return n_hits;
+  }
+
+  // a calorimeter of 20 layers of 100 x 100 cells of 10 mm, 1 m downstream,
+  // on the mock readout (system:8,layer:8,x:8,y:8)
+  struct CalorimeterGrid {
+    int n_layers = 20;
+    int n_cells = 100;
+    double pitch = 10 * dd4hep::mm;
+    double z0 = 1000 * dd4hep::mm;
+    double layer_spacing = 10 * dd4hep::mm;
+
+    dd4hep::IDDescriptor id_desc = algorithms::GeoSvc::instance().detector()->readout("MockCalorimeterHits").idSpec();
+
+    std::uint64_t cellID(int layer, int x, int y) const {
+      return id_desc.encode({{"system", 255}, {"layer", layer}, {"x", x}, {"y", y}});
+    }
+    edm4hep::Vector3f local(int layer, int x, int y) const {
+      return {
+        static_cast<float>((x - n_cells / 2) * pitch),
+        static_cast<float>((y - n_cells / 2) * pitch),
+        static_cast<float>(layer * layer_spacing)
+      };
+    }
+    edm4hep::Vector3f position(int layer, int x, int y) const {
+      auto pos = local(layer, x, y);
+      pos.z += z0;
+      return pos;
+    }
+  };
+
+  // `n_hits` hits of random cells, grouped in showers of about 10 hits in
+  // neighbouring cells of consecutive layers, reproducible for a given seed
+  inline edm4eic::CalorimeterHitCollection make_calorimeter_hits(
+      const CalorimeterGrid& grid, std::size_t n_hits,
+      edm4hep::Vector3f dimension = {0, 0, 0}, unsigned seed = 1) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> cell(0, grid.n_cells - 1);
+    std::uniform_int_distribution<int> step(-1, 1);
+    std::exponential_distribution<float> energy(1. / (10 * dd4hep::MeV));
+
+    edm4eic::CalorimeterHitCollection hits;
+    int layer = 0, x = 0, y = 0;
+    for (std::size_t i = 0; i < n_hits; i++) {
+      if (i % 10 == 0) {
+        // new shower
+        layer = 0;
+        x = cell(rng);
+        y = cell(rng);
+      } else {
+        layer = std::min(layer + 1, grid.n_layers - 1);
+        x = std::clamp(x + step(rng), 0, grid.n_cells - 1);
+        y = std::clamp(y + step(rng), 0, grid.n_cells - 1);
+      }
+      hits.create(
+        grid.cellID(layer, x, y), // std::uint64_t cellID,
+        energy(rng), // float energy,
+        0.0, // float energyError,
+        0.0, // float time,
+        0.0, // float timeError,
+        grid.position(layer, x, y), // edm4hep::Vector3f position,
+        dimension, // edm4hep::Vector3f dimension,
+        0, // std::int32_t sector,
+        layer, // std::int32_t layer,
+        grid.local(layer, x, y) // edm4hep::Vector3f local
+      );
+    }
+    return hits;
+  }
+
+} // namespace eicrecon::benchmark
@@ -4,6 +4,7 @@
 
 #include <Evaluator/DD4hepUnits.h>                 // for MeV, mm, keV, ns
 #include <catch2/catch_test_macros.hpp>            // for AssertionHandler, operator""_catch_sr, StringRef, REQUIRE, operator<, operator==, operator>, TEST_CASE
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <edm4eic/CalorimeterHitCollection.h>      // for CalorimeterHitCollection, MutableCalorimeterHit, CalorimeterHitMutableCollectionIterator
 #include <edm4eic/ClusterCollection.h>
 #include <edm4eic/MCRecoClusterParticleAssociationCollection.h>
@@ -15,12 +16,17 @@
 #include <spdlog/common.h>                         // for level_enum
 #include <spdlog/logger.h>                         // for logger
 #include <spdlog/spdlog.h>                         // for default_logger
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <memory>                                  // for allocator, unique_ptr, make_unique, shared_ptr, __shared_ptr_access
+#include <span>
 #include <tuple>
 #include <vector>
 
 #include "algorithms/calorimetry/CalorimeterClusterRecoCoG.h"        // for CalorimeterClusterRecoCoG
 #include "algorithms/calorimetry/CalorimeterClusterRecoCoGConfig.h"  // for CalorimeterClusterRecoCoGConfig
+#include "algorithms/calorimetry/FastLog.h"
 
 using eicrecon::CalorimeterClusterRecoCoG;
 using eicrecon::CalorimeterClusterRecoCoGConfig;
@@ -103,5 +109,85 @@ TEST_CASE( "the calorimeter CoG algorithm runs", "[CalorimeterClusterRecoCoG]" )
     REQUIRE(abs(clust.getShapeParameters()[9]) == 1);
   }
 
+  // several collections of the same mc hits at once, e.g. the truth and the island clusters
+  auto assoc2 = std::make_unique<edm4eic::MCRecoClusterParticleAssociationCollection>();
+  auto assoc3 = std::make_unique<edm4eic::MCRecoClusterParticleAssociationCollection>();
+  auto clust_coll2 = std::make_unique<edm4eic::ClusterCollection>();
+  auto clust_coll3 = std::make_unique<edm4eic::ClusterCollection>();
+  const std::vector<CalorimeterClusterRecoCoG::Input> inputs{input, input};
+  const std::vector<CalorimeterClusterRecoCoG::Output> outputs{
+    std::make_tuple(clust_coll2.get(), assoc2.get()), std::make_tuple(clust_coll3.get(), assoc3.get())};
+  algo.process(std::span<const CalorimeterClusterRecoCoG::Input>(inputs), std::span<const CalorimeterClusterRecoCoG::Output>(outputs));
+
+  REQUIRE(clust_coll2->size() == clust_coll->size());
+  REQUIRE(clust_coll3->size() == clust_coll->size());
+  for (std::size_t i = 0; i < clust_coll->size(); ++i) {
+    REQUIRE((*clust_coll2)[i].getEnergy() == (*clust_coll)[i].getEnergy());
+    REQUIRE((*clust_coll3)[i].getPosition().z == (*clust_coll)[i].getPosition().z);
+  }
+
+
+}
+
+TEST_CASE( "the single precision logarithm is within its error bound", "[CalorimeterClusterRecoCoG]" ) {
+  for (float x = 1e-30f; x < 1e30f; x *= 1.0137f) {
+    const double expected = std::log(static_cast<double>(x));
+    REQUIRE(std::abs(eicrecon::fast_math::log(x) - expected) <= eicrecon::fast_math::log_error * std::max(std::abs(expected), 1.));
+  }
+  REQUIRE(eicrecon::fast_math::log(0.f) < -1e30f);
+  REQUIRE(eicrecon::fast_math::log(-1.f) < -1e30f);
+  REQUIRE(eicrecon::fast_math::log_weight(1e-3f, 3.6f) == 0.f);
+  REQUIRE(eicrecon::fast_math::log_weight(1.f, 3.6f) == 3.6f);
+}
 
+TEST_CASE( "the single precision CoG agrees with the double precision one", "[CalorimeterClusterRecoCoG]" ) {
+  // a shower of 5x5 hits falling off from the center, some of them below the log weight cut
+  edm4eic::CalorimeterHitCollection hits_coll;
+  edm4eic::ProtoClusterCollection pclust_coll;
+  auto pclust = pclust_coll.create();
+  for (int ix = -2; ix <= 2; ++ix) {
+    for (int iy = -2; iy <= 2; ++iy) {
+      const edm4hep::Vector3f position(10 * dd4hep::mm * ix + 1 * dd4hep::mm, 10 * dd4hep::mm * iy, 1000 * dd4hep::mm + ix * iy * dd4hep::mm);
+      auto hit = hits_coll.create();
+      hit.setEnergy(1 * dd4hep::GeV * std::exp(-0.8 * std::hypot(ix + 0.3, iy - 0.1)));
+      hit.setPosition(position);
+      hit.setLocal(position);
+      pclust.addToHits(hit);
+      pclust.addToWeights(1);
+    }
+  }
+
+  auto reconstruct = [&](bool singlePrecision) {
+    CalorimeterClusterRecoCoG algo("CalorimeterClusterRecoCoG");
+    CalorimeterClusterRecoCoGConfig cfg;
+    cfg.energyWeight = "log";
+    cfg.logWeightBase = 3.6;
+    cfg.singlePrecision = singlePrecision;
+    algo.applyConfig(cfg);
+    algo.init();
+
+    edm4hep::SimCalorimeterHitCollection simhits;
+    auto assoc = std::make_unique<edm4eic::MCRecoClusterParticleAssociationCollection>();
+    auto clust_coll = std::make_unique<edm4eic::ClusterCollection>();
+    algo.process(std::make_tuple(&pclust_coll, &simhits), std::make_tuple(clust_coll.get(), assoc.get()));
+    REQUIRE(clust_coll->size() == 1);
+    return clust_coll;
+  };
+  const auto reference = reconstruct(false);
+  const auto single = reconstruct(true);
+
+  using Catch::Matchers::WithinAbs;
+  using Catch::Matchers::WithinRel;
+  const auto& ref = (*reference)[0];
+  const auto& cl = (*single)[0];
+  REQUIRE(cl.getEnergy() == ref.getEnergy());
+  // well below the cell size and the position resolution
+  REQUIRE_THAT(cl.getPosition().x, WithinAbs(ref.getPosition().x, 1e-4 * dd4hep::mm));
+  REQUIRE_THAT(cl.getPosition().y, WithinAbs(ref.getPosition().y, 1e-4 * dd4hep::mm));
+  REQUIRE_THAT(cl.getPosition().z, WithinAbs(ref.getPosition().z, 1e-4 * dd4hep::mm));
+  // radius, dispersion and widths, the axis of a round shower is not well defined
+  REQUIRE(cl.getShapeParameters().size() == ref.getShapeParameters().size());
+  for (std::size_t i = 0; i < 7; ++i) {
+    REQUIRE_THAT(cl.getShapeParameters()[i], WithinRel(ref.getShapeParameters()[i], 1e-3) || WithinAbs(ref.getShapeParameters()[i], 1e-6));
+  }
 }
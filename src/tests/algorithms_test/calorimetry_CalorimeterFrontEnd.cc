@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <DD4hep/Detector.h>
+#include <DD4hep/IDDescriptor.h>
+#include <DD4hep/Readout.h>
+#include <Evaluator/DD4hepUnits.h>
+#include <algorithms/geo.h>
+#include <catch2/catch_test_macros.hpp>
+#include <edm4eic/CalorimeterHitCollection.h>
+#include <edm4hep/CaloHitContributionCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
+#include <edm4hep/RawCalorimeterHitCollection.h>
+#include <edm4hep/SimCalorimeterHitCollection.h>
+#include <edm4hep/Vector3f.h>
+#include <cmath>
+#include <cstddef>
+#include <gsl/pointers>
+#include <memory>
+
+#include "algorithms/calorimetry/CalorimeterFrontEnd.h"
+#include "algorithms/calorimetry/CalorimeterFrontEndConfig.h"
+#include "algorithms/calorimetry/CalorimeterHitDigi.h"
+#include "algorithms/calorimetry/CalorimeterHitReco.h"
+#include "algorithms/calorimetry/CalorimeterHitsMerger.h"
+
+using eicrecon::CalorimeterFrontEnd;
+using eicrecon::CalorimeterFrontEndConfig;
+using eicrecon::CalorimeterHitDigi;
+using eicrecon::CalorimeterHitReco;
+using eicrecon::CalorimeterHitsMerger;
+
+namespace {
+
+void require_same_vectors(const edm4hep::Vector3f& a, const edm4hep::Vector3f& b) {
+  REQUIRE( a.x == b.x );
+  REQUIRE( a.y == b.y );
+  REQUIRE( a.z == b.z );
+}
+
+void require_same_hits(const edm4eic::CalorimeterHitCollection& a, const edm4eic::CalorimeterHitCollection& b) {
+  REQUIRE( a.size() == b.size() );
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    REQUIRE( a[i].getCellID() == b[i].getCellID() );
+    REQUIRE( a[i].getEnergy() == b[i].getEnergy() );
+    REQUIRE( a[i].getEnergyError() == b[i].getEnergyError() );
+    REQUIRE( a[i].getTime() == b[i].getTime() );
+    REQUIRE( a[i].getTimeError() == b[i].getTimeError() );
+    REQUIRE( a[i].getSector() == b[i].getSector() );
+    REQUIRE( a[i].getLayer() == b[i].getLayer() );
+    require_same_vectors(a[i].getPosition(), b[i].getPosition());
+    require_same_vectors(a[i].getDimension(), b[i].getDimension());
+    require_same_vectors(a[i].getLocal(), b[i].getLocal());
+  }
+}
+
+} // namespace
+
+TEST_CASE( "the front end makes the hits of digi, reco and merging one after the other", "[CalorimeterFrontEnd]" ) {
+  auto detector = algorithms::GeoSvc::instance().detector();
+  auto id_desc = detector->readout("MockCalorimeterHits").idSpec();
+
+  // with smearing, from the same random streams as the algorithms have the same names
+  CalorimeterFrontEndConfig cfg;
+  cfg.digi.eRes = {0.1 * std::sqrt(dd4hep::GeV), 0.02, 0. * dd4hep::GeV};
+  cfg.digi.tRes = 0.5 * dd4hep::ns;
+  cfg.digi.capADC = 32768;
+  cfg.digi.dyRangeADC = 2 * dd4hep::GeV;
+  cfg.digi.pedMeanADC = 100;
+  cfg.digi.pedSigmaADC = 2;
+  cfg.digi.resolutionTDC = 10 * dd4hep::picosecond;
+  cfg.digi.readout = "MockCalorimeterHits";
+  cfg.reco.capADC = cfg.digi.capADC;
+  cfg.reco.dyRangeADC = cfg.digi.dyRangeADC;
+  cfg.reco.pedMeanADC = cfg.digi.pedMeanADC;
+  cfg.reco.pedSigmaADC = cfg.digi.pedSigmaADC;
+  cfg.reco.resolutionTDC = cfg.digi.resolutionTDC;
+  cfg.reco.thresholdValue = 5;
+  cfg.reco.sampFrac = "0.5";
+  cfg.reco.readout = "MockCalorimeterHits";
+  cfg.reco.layerField = "layer";
+  cfg.merge.readout = "MockCalorimeterHits";
+  cfg.merge.fields = {"layer"};
+  cfg.merge.refs = {1};
+
+  auto headers = std::make_unique<edm4hep::EventHeaderCollection>();
+  headers->create(
+    3, // std::int32_t eventNumber
+    7, // std::int32_t runNumber
+    0, // std::uint64_t timeStamp
+    1. // float weight
+  );
+  auto contributions = std::make_unique<edm4hep::CaloHitContributionCollection>();
+  auto sim_hits = std::make_unique<edm4hep::SimCalorimeterHitCollection>();
+  for (int layer = 0; layer < 4; ++layer) {
+    for (int x = 0; x < 3; ++x) {
+      const float energy = 0.02 * (layer + 1) * (x + 1); /* GeV */
+      auto sim_hit = sim_hits->create(
+        id_desc.encode({{"system", 255}, {"layer", layer}, {"x", x}, {"y", 0}}), // std::uint64_t cellID
+        energy, // float energy
+        edm4hep::Vector3f({0. /* mm */, 0. /* mm */, 0. /* mm */}) // edm4hep::Vector3f position
+      );
+      sim_hit.addToContributions(contributions->create(
+        0, // std::int32_t PDG
+        energy, // float energy
+        static_cast<float>(1.0 + layer), /* ns */ // float time
+        edm4hep::Vector3f({0. /* mm */, 0. /* mm */, 0. /* mm */}) // edm4hep::Vector3f stepPosition
+      ));
+    }
+  }
+
+  CalorimeterHitDigi digi("test:digi");
+  CalorimeterHitReco reco("test:reco");
+  CalorimeterHitsMerger merger("test:merge");
+
+  SECTION( "with merging" ) {
+    digi.applyConfig(cfg.digi);
+    digi.init();
+    reco.applyConfig(cfg.reco);
+    reco.init();
+    merger.applyConfig(cfg.merge);
+    merger.init();
+    auto raw_hits = std::make_unique<edm4hep::RawCalorimeterHitCollection>();
+    auto rec_hits = std::make_unique<edm4eic::CalorimeterHitCollection>();
+    auto merged_hits = std::make_unique<edm4eic::CalorimeterHitCollection>();
+    digi.process({headers.get(), sim_hits.get()}, {raw_hits.get()});
+    reco.process({raw_hits.get()}, {rec_hits.get()});
+    merger.process({rec_hits.get()}, {merged_hits.get()});
+    REQUIRE( merged_hits->size() == 3 );
+
+    CalorimeterFrontEnd algo("test");
+    algo.applyConfig(cfg);
+    algo.init();
+    // twice, with the raw hits kept by the algorithm the second time
+    auto front_end_raw_hits = std::make_unique<edm4hep::RawCalorimeterHitCollection>();
+    auto front_end_hits = std::make_unique<edm4eic::CalorimeterHitCollection>();
+    algo.process({headers.get(), sim_hits.get()}, {front_end_hits.get(), front_end_raw_hits.get()});
+    require_same_hits(*front_end_hits, *merged_hits);
+    REQUIRE( front_end_raw_hits->size() == raw_hits->size() );
+    for (std::size_t i = 0; i < raw_hits->size(); ++i) {
+      REQUIRE( (*front_end_raw_hits)[i].getCellID() == (*raw_hits)[i].getCellID() );
+      REQUIRE( (*front_end_raw_hits)[i].getAmplitude() == (*raw_hits)[i].getAmplitude() );
+      REQUIRE( (*front_end_raw_hits)[i].getTimeStamp() == (*raw_hits)[i].getTimeStamp() );
+    }
+
+    auto front_end_hits_again = std::make_unique<edm4eic::CalorimeterHitCollection>();
+    algo.process({headers.get(), sim_hits.get()}, {front_end_hits_again.get(), nullptr});
+    require_same_hits(*front_end_hits_again, *merged_hits);
+  }
+
+  SECTION( "without merging" ) {
+    cfg.merge.fields.clear();
+    cfg.merge.refs.clear();
+    digi.applyConfig(cfg.digi);
+    digi.init();
+    reco.applyConfig(cfg.reco);
+    reco.init();
+    auto raw_hits = std::make_unique<edm4hep::RawCalorimeterHitCollection>();
+    auto rec_hits = std::make_unique<edm4eic::CalorimeterHitCollection>();
+    digi.process({headers.get(), sim_hits.get()}, {raw_hits.get()});
+    reco.process({raw_hits.get()}, {rec_hits.get()});
+    REQUIRE( rec_hits->size() > 0 );
+
+    CalorimeterFrontEnd algo("test");
+    algo.applyConfig(cfg);
+    algo.init();
+    auto front_end_hits = std::make_unique<edm4eic::CalorimeterHitCollection>();
+    algo.process({headers.get(), sim_hits.get()}, {front_end_hits.get(), nullptr});
+    require_same_hits(*front_end_hits, *rec_hits);
+  }
+}
@@ -9,6 +9,7 @@
 #include <algorithms/logger.h>
 #include <catch2/catch_test_macros.hpp>
 #include <edm4hep/CaloHitContributionCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
 #include <edm4hep/RawCalorimeterHitCollection.h>
 #include <edm4hep/SimCalorimeterHitCollection.h>
 #include <edm4hep/Vector3f.h>
@@ -16,6 +17,7 @@
 #include <spdlog/common.h>
 #include <spdlog/logger.h>
 #include <spdlog/spdlog.h>
+#include <cstdint>
 #include <gsl/pointers>
 #include <memory>
 #include <utility>
@@ -55,6 +57,13 @@ TEST_CASE( "the clustering algorithm runs", "[CalorimeterHitDigi]" ) {
     algo.applyConfig(cfg);
     algo.init();
 
+    auto headers = std::make_unique<edm4hep::EventHeaderCollection>();
+    headers->create(
+      1, // std::int32_t eventNumber
+      1, // std::int32_t runNumber
+      0, // std::uint64_t timeStamp
+      1. // float weight
+    );
     auto calohits = std::make_unique<edm4hep::CaloHitContributionCollection>();
     auto simhits = std::make_unique<edm4hep::SimCalorimeterHitCollection>();
     auto mhit = simhits->create(
@@ -76,11 +85,142 @@ TEST_CASE( "the clustering algorithm runs", "[CalorimeterHitDigi]" ) {
     ));
 
     auto rawhits = std::make_unique<edm4hep::RawCalorimeterHitCollection>();
-    algo.process({simhits.get()}, {rawhits.get()});
+    algo.process({headers.get(), simhits.get()}, {rawhits.get()});
 
     REQUIRE( (*rawhits).size() == 1 );
     REQUIRE( (*rawhits)[0].getCellID() == id_desc.encode({{"system", 255}, {"x", 0}, {"y", 0}}));
     REQUIRE( (*rawhits)[0].getAmplitude() == 123 + 111 );
     REQUIRE( (*rawhits)[0].getTimeStamp() == 7 ); // currently, earliest contribution is returned
   }
+
+  SECTION( "cells below the zero suppression threshold are dropped" ) {
+    cfg.capADC = 555;
+    cfg.dyRangeADC = 5.0 /* GeV */;
+    cfg.pedMeanADC = 123;
+    cfg.pedSigmaADC = 0;
+    cfg.resolutionTDC = 1.0 * dd4hep::ns;
+    cfg.zeroSuppressionValue = 50;
+    algo.applyConfig(cfg);
+    algo.init();
+
+    auto headers = std::make_unique<edm4hep::EventHeaderCollection>();
+    headers->create(1, 1, 0, 1.);
+    auto calohits = std::make_unique<edm4hep::CaloHitContributionCollection>();
+    auto simhits = std::make_unique<edm4hep::SimCalorimeterHitCollection>();
+    // 111, 44 and 67 ADC above the pedestal
+    for (const auto& [x, energy] : std::vector<std::pair<int, float>>{{0, 1.0}, {1, 0.4}, {2, 0.6}}) {
+      auto mhit = simhits->create(
+        id_desc.encode({{"system", 255}, {"x", x}, {"y", 0}}), // std::uint64_t cellID,
+        energy /* GeV */, // float energy
+        edm4hep::Vector3f({0. /* mm */, 0. /* mm */, 0. /* mm */}) // edm4hep::Vector3f position
+      );
+      mhit.addToContributions(calohits->create(
+        0, // std::int32_t PDG
+        energy /* GeV */, // float energy
+        7.0 /* ns */, // float time
+        edm4hep::Vector3f({0. /* mm */, 0. /* mm */, 0. /* mm */}) // edm4hep::Vector3f stepPosition
+      ));
+    }
+
+    auto rawhits = std::make_unique<edm4hep::RawCalorimeterHitCollection>();
+    algo.process({headers.get(), simhits.get()}, {rawhits.get()});
+
+    REQUIRE( (*rawhits).size() == 2 );
+    REQUIRE( (*rawhits)[0].getAmplitude() == 123 + 111 );
+    REQUIRE( (*rawhits)[1].getAmplitude() == 123 + 67 );
+  }
+
+  SECTION( "pulses of the contributions are summed and sampled" ) {
+    cfg.capADC = 555;
+    cfg.dyRangeADC = 5.0 /* GeV */;
+    cfg.pedMeanADC = 123;
+    cfg.resolutionTDC = 1.0 * dd4hep::ns;
+    cfg.pulseShape = "CRRC";
+    cfg.pulseShapeTau = 2.0 * dd4hep::ns;
+    cfg.pulseShapeOrder = 2;
+    cfg.samplingInterval = 1.0 * dd4hep::ns;
+    cfg.nSamples = 64;
+    algo.level(algorithms::LogLevel(spdlog::level::trace));
+    algo.applyConfig(cfg);
+    algo.init();
+
+    auto headers = std::make_unique<edm4hep::EventHeaderCollection>();
+    headers->create(1, 1, 0, 1.);
+    auto calohits = std::make_unique<edm4hep::CaloHitContributionCollection>();
+    auto simhits = std::make_unique<edm4hep::SimCalorimeterHitCollection>();
+    // two cells, the second with its contributions within a clock cycle
+    for (const auto& [x, time] : std::vector<std::pair<int, float>>{{0, 7.0}, {1, 12.77}}) {
+      auto mhit = simhits->create(
+        id_desc.encode({{"system", 255}, {"x", x}, {"y", 0}}), // std::uint64_t cellID,
+        1.0 /* GeV */, // float energy
+        edm4hep::Vector3f({0. /* mm */, 0. /* mm */, 0. /* mm */}) // edm4hep::Vector3f position
+      );
+      for (int i = 0; i < 2; ++i) {
+        mhit.addToContributions(calohits->create(
+          0, // std::int32_t PDG
+          0.5 /* GeV */, // float energy
+          time /* ns */, // float time
+          edm4hep::Vector3f({0. /* mm */, 0. /* mm */, 0. /* mm */}) // edm4hep::Vector3f stepPosition
+        ));
+      }
+    }
+
+    auto rawhits = std::make_unique<edm4hep::RawCalorimeterHitCollection>();
+    algo.process({headers.get(), simhits.get()}, {rawhits.get()});
+
+    REQUIRE( (*rawhits).size() == 2 );
+    REQUIRE( (*rawhits)[0].getAmplitude() == 123 + 111 );
+    REQUIRE( (*rawhits)[0].getTimeStamp() == 7 );
+    REQUIRE( (*rawhits)[1].getAmplitude() == 123 + 111 );
+    REQUIRE( (*rawhits)[1].getTimeStamp() == 13 );
+
+    // the sample buffer of the cells is reused by the next event
+    auto rawhits2 = std::make_unique<edm4hep::RawCalorimeterHitCollection>();
+    algo.process({headers.get(), simhits.get()}, {rawhits2.get()});
+    REQUIRE( (*rawhits2)[0].getAmplitude() == (*rawhits)[0].getAmplitude() );
+    REQUIRE( (*rawhits2)[1].getTimeStamp() == (*rawhits)[1].getTimeStamp() );
+  }
+
+  SECTION( "smearing is reproducible for a given event" ) {
+    cfg.capADC = 1 << 14;
+    cfg.dyRangeADC = 5.0 /* GeV */;
+    cfg.pedMeanADC = 1000;
+    cfg.pedSigmaADC = 100;
+    cfg.resolutionTDC = 1.0 * dd4hep::ns;
+    algo.applyConfig(cfg);
+    algo.init();
+
+    auto simhits = std::make_unique<edm4hep::SimCalorimeterHitCollection>();
+    auto calohits = std::make_unique<edm4hep::CaloHitContributionCollection>();
+    for (int x = 0; x < 10; ++x) {
+      auto mhit = simhits->create(
+        id_desc.encode({{"system", 255}, {"x", x}, {"y", 0}}), // std::uint64_t cellID,
+        1.0 /* GeV */, // float energy
+        edm4hep::Vector3f({0. /* mm */, 0. /* mm */, 0. /* mm */}) // edm4hep::Vector3f position
+      );
+      mhit.addToContributions(calohits->create(
+        0, // std::int32_t PDG
+        1.0 /* GeV */, // float energy
+        7.0 /* ns */, // float time
+        edm4hep::Vector3f({0. /* mm */, 0. /* mm */, 0. /* mm */}) // edm4hep::Vector3f stepPosition
+      ));
+    }
+
+    auto digitize = [&](int event_number) {
+      auto headers = std::make_unique<edm4hep::EventHeaderCollection>();
+      headers->create(event_number, 1, 0, 1.);
+      auto rawhits = std::make_unique<edm4hep::RawCalorimeterHitCollection>();
+      algo.process({headers.get(), simhits.get()}, {rawhits.get()});
+      std::vector<std::uint64_t> amplitudes;
+      for (const auto& hit : *rawhits) {
+        amplitudes.push_back(hit.getAmplitude());
+      }
+      return amplitudes;
+    };
+
+    const auto first = digitize(1);
+    REQUIRE( first.size() == 10 );
+    REQUIRE( digitize(2) != first );
+    REQUIRE( digitize(1) == first );
+  }
 }
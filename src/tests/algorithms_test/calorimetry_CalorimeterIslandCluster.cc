@@ -17,9 +17,12 @@
 #include <spdlog/common.h>
 #include <spdlog/logger.h>
 #include <spdlog/spdlog.h>
+#include <cmath>
+#include <cstdint>
 #include <gsl/pointers>
 #include <limits>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -44,6 +47,7 @@ TEST_CASE( "the clustering algorithm runs", "[CalorimeterIslandCluster]" ) {
 
   SECTION( "without splitting" ) {
     bool use_adjacencyMatrix = GENERATE(false, true);
+    cfg.grouping = GENERATE(Catch::Generators::as<std::string>{}, "bfs", "components");
     cfg.splitCluster = false;
     if (use_adjacencyMatrix) {
       cfg.adjacencyMatrix = "abs(x_1 - x_2) + abs(y_1 - y_2) == 1";
@@ -147,8 +151,61 @@ TEST_CASE( "the clustering algorithm runs", "[CalorimeterIslandCluster]" ) {
     }
   }
 
+  SECTION( "with global eta-phi distances" ) {
+    cfg.splitCluster = false;
+    cfg.globalDistEtaPhi = {0.1, 0.02 * dd4hep::rad};
+    cfg.sectorDist = 5.0 * dd4hep::mm;
+    algo.applyConfig(cfg);
+    algo.init();
+
+    // hits on a ring at r = 1 m, eta = 0
+    auto make_hit = [&](edm4eic::CalorimeterHitCollection &coll, double phi, std::int32_t sector) {
+      coll.create(
+        0, // std::uint64_t cellID,
+        5.0, // float energy,
+        0.0, // float energyError,
+        0.0, // float time,
+        0.0, // float timeError,
+        edm4hep::Vector3f(1000. * std::cos(phi), 1000. * std::sin(phi), 0.0), // edm4hep::Vector3f position,
+        edm4hep::Vector3f(1.0, 1.0, 0.0), // edm4hep::Vector3f dimension,
+        sector, // std::int32_t sector,
+        0, // std::int32_t layer,
+        edm4hep::Vector3f(0.0, 0.0, 0.0) // edm4hep::Vector3f local
+      );
+    };
+
+    SECTION( "on two adjacent cells across phi = pi" ) {
+      edm4eic::CalorimeterHitCollection hits_coll;
+      make_hit(hits_coll, M_PI - 0.005, 0);
+      make_hit(hits_coll, 0., 0);
+      make_hit(hits_coll, -M_PI + 0.005, 0);
+      auto protoclust_coll = std::make_unique<edm4eic::ProtoClusterCollection>();
+      algo.process({&hits_coll}, {protoclust_coll.get()});
+
+      REQUIRE( (*protoclust_coll).size() == 2 );
+      REQUIRE( (*protoclust_coll)[0].hits_size() == 2 );
+      REQUIRE( (*protoclust_coll)[0].getHits()[0] == hits_coll[0] );
+      REQUIRE( (*protoclust_coll)[0].getHits()[1] == hits_coll[2] );
+      REQUIRE( (*protoclust_coll)[1].hits_size() == 1 );
+    }
+
+    SECTION( "on adjacent cells in different sectors" ) {
+      edm4eic::CalorimeterHitCollection hits_coll;
+      make_hit(hits_coll, 0., 0);
+      make_hit(hits_coll, 0.004, 1); // 4 mm away
+      make_hit(hits_coll, 0.012, 2); // 8 mm away from the previous one
+      auto protoclust_coll = std::make_unique<edm4eic::ProtoClusterCollection>();
+      algo.process({&hits_coll}, {protoclust_coll.get()});
+
+      REQUIRE( (*protoclust_coll).size() == 2 );
+      REQUIRE( (*protoclust_coll)[0].hits_size() == 2 );
+      REQUIRE( (*protoclust_coll)[1].hits_size() == 1 );
+    }
+  }
+
   SECTION( "run on three adjacent cells" ) {
     bool use_adjacencyMatrix = GENERATE(false, true);
+    cfg.grouping = GENERATE(Catch::Generators::as<std::string>{}, "bfs", "components");
     if (use_adjacencyMatrix) {
       cfg.adjacencyMatrix = "abs(x_1 - x_2) + abs(y_1 - y_2) == 1";
       cfg.readout = "MockCalorimeterHits";
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <catch2/catch_test_macros.hpp>
+#include <edm4eic/CalorimeterHitCollection.h>
+#include <edm4eic/ProtoClusterCollection.h>
+#include <edm4hep/CaloHitContributionCollection.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <edm4hep/SimCalorimeterHitCollection.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "algorithms/calorimetry/CalorimeterTruthClustering.h"
+
+using eicrecon::CalorimeterTruthClustering;
+
+TEST_CASE( "the truth clustering groups the hits by particle", "[CalorimeterTruthClustering]" ) {
+  CalorimeterTruthClustering algo("CalorimeterTruthClustering");
+  algo.init();
+
+  edm4hep::MCParticleCollection particles;
+  particles.setID(1);
+  for (int i = 0; i < 3; ++i) {
+    particles.create();
+  }
+
+  // the hits of particles 2, 0, 2, 1, 0, one sim hit per reco hit
+  const std::vector<std::size_t> hit_particles{2, 0, 2, 1, 0};
+  edm4hep::CaloHitContributionCollection contributions;
+  edm4hep::SimCalorimeterHitCollection simhits;
+  edm4eic::CalorimeterHitCollection hits;
+  for (std::size_t i = 0; i < hit_particles.size(); ++i) {
+    auto contribution = contributions.create();
+    contribution.setParticle(particles[hit_particles[i]]);
+    auto simhit = simhits.create();
+    simhit.setCellID(100 + i);
+    simhit.addToContributions(contribution);
+    auto hit = hits.create();
+    hit.setCellID(100 + i);
+  }
+
+  SECTION("hits in a collection") {
+    edm4eic::ProtoClusterCollection clusters;
+    algo.process({&hits, &simhits}, {&clusters});
+
+    // in the order of the first hit of each particle
+    REQUIRE(clusters.size() == 3);
+    REQUIRE(clusters[0].hits_size() == 2);
+    REQUIRE(clusters[0].getHits(0).getCellID() == 100);
+    REQUIRE(clusters[0].getHits(1).getCellID() == 102);
+    REQUIRE(clusters[1].hits_size() == 2);
+    REQUIRE(clusters[1].getHits(0).getCellID() == 101);
+    REQUIRE(clusters[1].getHits(1).getCellID() == 104);
+    REQUIRE(clusters[2].hits_size() == 1);
+    REQUIRE(clusters[2].getHits(0).getCellID() == 103);
+  }
+
+  SECTION("hits without a collection index are matched by cellID") {
+    // a subset collection in reverse order, the mc hits are found by cellID
+    edm4eic::CalorimeterHitCollection subset;
+    subset.setSubsetCollection();
+    for (std::size_t i = hits.size(); i-- > 0;) {
+      auto hit = edm4eic::MutableCalorimeterHit();
+      hit.setCellID(hits[i].getCellID());
+      subset.push_back(hit);
+    }
+    // a hit without truth is ignored
+    auto unmatched = edm4eic::MutableCalorimeterHit();
+    unmatched.setCellID(999);
+    subset.push_back(unmatched);
+
+    edm4eic::ProtoClusterCollection clusters;
+    algo.process({&subset, &simhits}, {&clusters});
+
+    REQUIRE(clusters.size() == 3);
+    REQUIRE(clusters[0].hits_size() == 2);
+    REQUIRE(clusters[0].getHits(0).getCellID() == 104);
+    REQUIRE(clusters[1].hits_size() == 1);
+    REQUIRE(clusters[1].getHits(0).getCellID() == 103);
+    REQUIRE(clusters[2].hits_size() == 2);
+    REQUIRE(clusters[2].getHits(0).getCellID() == 102);
+  }
+}
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "algorithms/calorimetry/ConnectedComponents.h"
+
+TEST_CASE("connected components do not depend on the number of tasks", "[ConnectedComponents]") {
+  // hits on a grid, neighbours within one cell, some of them too soft to take part
+  struct Hit {
+    int x;
+    int y;
+    bool qualified;
+    bool seed;
+  };
+  std::mt19937 rng(GENERATE(1, 2, 3));
+  std::uniform_int_distribution<int> position(0, 40);
+  std::bernoulli_distribution qualified(0.9);
+  std::bernoulli_distribution seed(0.5);
+  std::vector<Hit> hits(1000);
+  for (auto& hit : hits) {
+    hit = {position(rng), position(rng), qualified(rng), seed(rng)};
+  }
+
+  auto groups = [&](std::size_t min_hits_per_task, std::size_t tasks) {
+    eicrecon::ConnectedComponents components(min_hits_per_task);
+    components.build(
+        hits.size(), tasks, [&](std::size_t idx) { return hits[idx].qualified; },
+        [&](std::size_t, auto&& f) {
+          for (std::size_t idx2 = 0; idx2 < hits.size(); ++idx2) {
+            f(idx2);
+          }
+        },
+        [&](std::size_t idx1, std::size_t idx2) {
+          return std::abs(hits[idx1].x - hits[idx2].x) <= 1 && std::abs(hits[idx1].y - hits[idx2].y) <= 1;
+        });
+    std::vector<std::size_t> group_hits;
+    std::vector<std::size_t> group_offsets{0};
+    components.groups([&](std::size_t idx) { return hits[idx].seed; }, group_hits, group_offsets);
+    return std::make_pair(group_hits, group_offsets);
+  };
+
+  const auto single = groups(1024, 1);
+  REQUIRE(single.second.size() > 2);
+
+  SECTION("with small blocks in several tasks") {
+    const std::size_t tasks = GENERATE(2, 3, 7, 16);
+    REQUIRE(groups(1, tasks) == single);
+    REQUIRE(groups(100, tasks) == single);
+  }
+
+  SECTION("with more tasks than blocks of the fewest hits") {
+    // 1000 hits make at most 2 blocks of 400 hits
+    REQUIRE(groups(400, 16) == single);
+  }
+}
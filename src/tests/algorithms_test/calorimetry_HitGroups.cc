@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "algorithms/calorimetry/HitGroups.h"
+
+using eicrecon::HitGroups;
+
+namespace {
+
+struct MockHit {
+  std::uint64_t cellID;
+};
+
+std::vector<std::size_t> indices(const HitGroups::Group& group) {
+  return {group.indices.begin(), group.indices.end()};
+}
+
+} // namespace
+
+TEST_CASE("hits are grouped by key", "[HitGroups]") {
+  HitGroups groups;
+  auto masked = [](const MockHit& hit) { return hit.cellID & ~std::uint64_t{0xff}; };
+
+  SECTION("no hits") {
+    groups.build(std::vector<MockHit>{}, masked);
+    REQUIRE(groups.empty());
+    REQUIRE(groups.size() == 0);
+    REQUIRE(groups.begin() == groups.end());
+  }
+
+  SECTION("groups in ascending key, indices in ascending order") {
+    const std::vector<MockHit> hits{
+        {0x0301}, {0x0100}, {0x0302}, {0x0200}, {0x01ff}, {0x0300}, {0x0101},
+    };
+    groups.build(hits, masked);
+    REQUIRE(groups.size() == 3);
+    REQUIRE(groups[0].id == 0x0100);
+    REQUIRE(indices(groups[0]) == std::vector<std::size_t>{1, 4, 6});
+    REQUIRE(groups[1].id == 0x0200);
+    REQUIRE(indices(groups[1]) == std::vector<std::size_t>{3});
+    REQUIRE(groups[2].id == 0x0300);
+    REQUIRE(indices(groups[2]) == std::vector<std::size_t>{0, 2, 5});
+
+    std::vector<std::uint64_t> ids;
+    for (const auto& group : groups) {
+      ids.push_back(group.id);
+    }
+    REQUIRE(ids == std::vector<std::uint64_t>{0x0100, 0x0200, 0x0300});
+
+    SECTION("reordered within the groups, ties in ascending index") {
+      const std::vector<double> energies{2., 1., 3., 4., 1., 2., 3.};
+      groups.sort_each([&](std::size_t a, std::size_t b) { return energies[a] > energies[b]; });
+      REQUIRE(groups.size() == 3);
+      REQUIRE(indices(groups[0]) == std::vector<std::size_t>{6, 1, 4});
+      REQUIRE(indices(groups[1]) == std::vector<std::size_t>{3});
+      REQUIRE(indices(groups[2]) == std::vector<std::size_t>{2, 0, 5});
+    }
+
+    SECTION("rebuilt from other hits") {
+      groups.build(std::vector<MockHit>{{0x0500}, {0x0500}}, masked);
+      REQUIRE(groups.size() == 1);
+      REQUIRE(groups[0].id == 0x0500);
+      REQUIRE(indices(groups[0]) == std::vector<std::size_t>{0, 1});
+
+      groups.build(std::vector<MockHit>{}, masked);
+      REQUIRE(groups.empty());
+    }
+  }
+}
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <Evaluator/DD4hepUnits.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <edm4eic/CalorimeterHitCollection.h>
+#include <edm4eic/ClusterCollection.h>
+#include <edm4eic/MCRecoClusterParticleAssociationCollection.h>
+#include <edm4eic/ProtoClusterCollection.h>
+#include <edm4hep/SimCalorimeterHitCollection.h>
+#include <edm4hep/Vector3f.h>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+
+#include "algorithms/calorimetry/ImagingClusterReco.h"
+#include "algorithms/calorimetry/ImagingClusterRecoConfig.h"
+
+using eicrecon::ImagingClusterReco;
+using eicrecon::ImagingClusterRecoConfig;
+
+namespace {
+
+  // proto-clusters of hits along a line at polar angle theta, with the layers of the hits out of order
+  void make_clusters(edm4eic::CalorimeterHitCollection& hits, edm4eic::ProtoClusterCollection& pclusters,
+                     std::size_t n_clusters, double theta) {
+    for (std::size_t c = 0; c < n_clusters; ++c) {
+      auto pcl = pclusters.create();
+      for (int i = 0; i < 100; ++i) {
+        const int layer = (i * 7) % 10 + 1;
+        const float r = 1000 * dd4hep::mm + 10 * dd4hep::mm * layer;
+        const float phi = 0.01 * c;
+        const edm4hep::Vector3f position(r * std::sin(theta) * std::cos(phi), r * std::sin(theta) * std::sin(phi), r * std::cos(theta));
+        auto hit = hits.create();
+        hit.setEnergy(1 * dd4hep::MeV * (1 + i % 5));
+        hit.setPosition(position);
+        hit.setLayer(layer);
+        pcl.addToHits(hit);
+        pcl.addToWeights(1);
+      }
+    }
+  }
+
+  auto reconstruct(const ImagingClusterRecoConfig& cfg, const edm4eic::ProtoClusterCollection& pclusters) {
+    ImagingClusterReco algo("ImagingClusterReco");
+    algo.applyConfig(cfg);
+    algo.init();
+
+    edm4hep::SimCalorimeterHitCollection mchits;
+    auto clusters = std::make_unique<edm4eic::ClusterCollection>();
+    auto assocs = std::make_unique<edm4eic::MCRecoClusterParticleAssociationCollection>();
+    auto layers = std::make_unique<edm4eic::ClusterCollection>();
+    algo.process({&pclusters, &mchits}, {clusters.get(), assocs.get(), layers.get()});
+    return std::make_tuple(std::move(clusters), std::move(layers));
+  }
+
+}
+
+TEST_CASE( "the imaging cluster reconstruction groups the hits by layer", "[ImagingClusterReco]" ) {
+  edm4eic::CalorimeterHitCollection hits;
+  edm4eic::ProtoClusterCollection pclusters;
+  const double theta = 0.3;
+  make_clusters(hits, pclusters, 1, theta);
+
+  ImagingClusterRecoConfig cfg;
+  cfg.trackStopLayer = 10;
+  const auto [clusters, layers] = reconstruct(cfg, pclusters);
+
+  REQUIRE(clusters->size() == 1);
+  REQUIRE(layers->size() == 10);
+  const auto cl = (*clusters)[0];
+  REQUIRE(cl.getNhits() == 100);
+  REQUIRE(cl.clusters_size() == 10);
+  float layer_energy = 0;
+  for (std::size_t l = 0; l < layers->size(); ++l) {
+    const auto layer = (*layers)[l];
+    REQUIRE(layer.getNhits() == 10);
+    for (const auto& hit : layer.getHits()) {
+      REQUIRE(hit.getLayer() == static_cast<int>(l) + 1);
+    }
+    layer_energy += layer.getEnergy();
+  }
+  REQUIRE_THAT(layer_energy, Catch::Matchers::WithinRel(cl.getEnergy(), 1e-5));
+
+  // the layer positions are on the line, oriented outwards
+  REQUIRE_THAT(cl.getIntrinsicTheta(), Catch::Matchers::WithinAbs(theta, 1e-3));
+  REQUIRE_THAT(cl.getIntrinsicPhi(), Catch::Matchers::WithinAbs(0., 1e-2));
+}
+
+TEST_CASE( "the imaging cluster reconstruction does not depend on the tasks", "[ImagingClusterReco]" ) {
+  edm4eic::CalorimeterHitCollection hits;
+  edm4eic::ProtoClusterCollection pclusters;
+  make_clusters(hits, pclusters, 50, 0.5);
+
+  ImagingClusterRecoConfig cfg;
+  const auto [clusters, layers] = reconstruct(cfg, pclusters);
+  cfg.reconstructionTasks = 4;
+  const auto [clusters_tasks, layers_tasks] = reconstruct(cfg, pclusters);
+
+  REQUIRE(clusters_tasks->size() == clusters->size());
+  REQUIRE(layers_tasks->size() == layers->size());
+  for (std::size_t i = 0; i < clusters->size(); ++i) {
+    REQUIRE((*clusters_tasks)[i].getEnergy() == (*clusters)[i].getEnergy());
+    REQUIRE((*clusters_tasks)[i].getPosition().z == (*clusters)[i].getPosition().z);
+    REQUIRE((*clusters_tasks)[i].getIntrinsicTheta() == (*clusters)[i].getIntrinsicTheta());
+  }
+  for (std::size_t i = 0; i < layers->size(); ++i) {
+    REQUIRE((*layers_tasks)[i].getEnergy() == (*layers)[i].getEnergy());
+    REQUIRE((*layers_tasks)[i].getPosition().x == (*layers)[i].getPosition().x);
+  }
+}
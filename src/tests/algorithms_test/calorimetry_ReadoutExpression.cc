@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <DD4hep/IDDescriptor.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+
+#include "algorithms/calorimetry/ReadoutExpression.h"
+
+TEST_CASE("memoized readout expressions give the values of direct evaluation", "[ReadoutExpression]") {
+  // the fields of an expression over layer and y are not adjacent in the cellID, y is signed
+  dd4hep::IDDescriptor id_desc("MockExpressionHits", "system:4,layer:3,module:-5,x:4,y:-4");
+
+  auto [expr, memoized] = GENERATE(std::pair<std::string, bool>{"(layer == 0) ? 0.019 : 0.037", true},
+                                   std::pair<std::string, bool>{"layer * 10 + y / 4.", true},
+                                   std::pair<std::string, bool>{"system + layer * 0.5 + module - x * y", false},
+                                   std::pair<std::string, bool>{"2 * 3.5", false});
+
+  eicrecon::ReadoutExpression memo;
+  memo.init(expr, id_desc);
+  eicrecon::ReadoutExpression direct;
+  direct.init(expr, id_desc, false);
+
+  REQUIRE(memo.memoized() == memoized);
+  REQUIRE(!direct.memoized());
+  REQUIRE(memo.mask() == direct.mask());
+
+  std::mt19937_64 rng(7);
+  for (int i = 0; i < 10000; ++i) {
+    // bits beyond the fields of the readout do not change the value either
+    const std::uint64_t cellID = rng();
+    REQUIRE(memo(cellID) == direct(cellID));
+    REQUIRE(memo(cellID) == direct(cellID & direct.mask()));
+  }
+}
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include "algorithms/calorimetry/SymmetricEigen.h"
+
+using eicrecon::symmetric_eigen::Matrix3;
+using eicrecon::symmetric_eigen::eigenvalues;
+using eicrecon::symmetric_eigen::eigenvector;
+
+namespace {
+
+constexpr double tolerance = 1e-12;
+
+double dot(const std::array<double, 3>& a, const std::array<double, 3>& b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+/// A v = lambda v, for a unit vector v
+void check_eigenvector(const Matrix3& m, double lambda, const std::array<double, 3>& v) {
+  const auto& [xx, yy, zz, xy, xz, yz] = m;
+  CHECK_THAT(dot(v, v), Catch::Matchers::WithinAbs(1., tolerance));
+  CHECK_THAT(xx * v[0] + xy * v[1] + xz * v[2], Catch::Matchers::WithinAbs(lambda * v[0], tolerance));
+  CHECK_THAT(xy * v[0] + yy * v[1] + yz * v[2], Catch::Matchers::WithinAbs(lambda * v[1], tolerance));
+  CHECK_THAT(xz * v[0] + yz * v[1] + zz * v[2], Catch::Matchers::WithinAbs(lambda * v[2], tolerance));
+}
+
+} // namespace
+
+TEST_CASE("eigenvalues of 2x2 symmetric matrices", "[SymmetricEigen]") {
+  const auto a = eigenvalues(2., 2., 1.);
+  CHECK_THAT(a[0], Catch::Matchers::WithinAbs(1., tolerance));
+  CHECK_THAT(a[1], Catch::Matchers::WithinAbs(3., tolerance));
+
+  // diagonal, in ascending order
+  const auto b = eigenvalues(5., -1., 0.);
+  CHECK_THAT(b[0], Catch::Matchers::WithinAbs(-1., tolerance));
+  CHECK_THAT(b[1], Catch::Matchers::WithinAbs(5., tolerance));
+
+  // degenerate
+  const auto c = eigenvalues(4., 4., 0.);
+  CHECK_THAT(c[0], Catch::Matchers::WithinAbs(4., tolerance));
+  CHECK_THAT(c[1], Catch::Matchers::WithinAbs(4., tolerance));
+}
+
+TEST_CASE("eigen decomposition of a 3x3 symmetric matrix with distinct eigenvalues", "[SymmetricEigen]") {
+  // {{2, -1, 0}, {-1, 2, -1}, {0, -1, 2}}
+  const Matrix3 m{2., 2., 2., -1., 0., -1.};
+  const auto lambda = eigenvalues(m);
+  const double sqrt2 = std::sqrt(2.);
+  CHECK_THAT(lambda[0], Catch::Matchers::WithinAbs(2. - sqrt2, tolerance));
+  CHECK_THAT(lambda[1], Catch::Matchers::WithinAbs(2., tolerance));
+  CHECK_THAT(lambda[2], Catch::Matchers::WithinAbs(2. + sqrt2, tolerance));
+
+  // up to their sign
+  const std::array<std::array<double, 3>, 3> expected{{
+    {0.5, sqrt2 / 2., 0.5},
+    {1. / sqrt2, 0., -1. / sqrt2},
+    {0.5, -sqrt2 / 2., 0.5},
+  }};
+  for (std::size_t i = 0; i < 3; ++i) {
+    const auto v = eigenvector(m, lambda[i]);
+    check_eigenvector(m, lambda[i], v);
+    CHECK_THAT(std::abs(dot(v, expected[i])), Catch::Matchers::WithinAbs(1., tolerance));
+  }
+}
+
+TEST_CASE("eigen decomposition of a diagonal 3x3 matrix", "[SymmetricEigen]") {
+  const Matrix3 m{3., 1., 2., 0., 0., 0.};
+  const auto lambda = eigenvalues(m);
+  CHECK(lambda == std::array<double, 3>{1., 2., 3.});
+
+  const std::array<std::array<double, 3>, 3> expected{{{0., 1., 0.}, {0., 0., 1.}, {1., 0., 0.}}};
+  for (std::size_t i = 0; i < 3; ++i) {
+    const auto v = eigenvector(m, lambda[i]);
+    check_eigenvector(m, lambda[i], v);
+    CHECK_THAT(std::abs(dot(v, expected[i])), Catch::Matchers::WithinAbs(1., tolerance));
+  }
+}
+
+TEST_CASE("eigen decomposition of 3x3 matrices with degenerate eigenvalues", "[SymmetricEigen]") {
+  SECTION("two equal eigenvalues") {
+    // {{2, 1, 1}, {1, 2, 1}, {1, 1, 2}}: 1, 1 and 4 along (1, 1, 1)
+    const Matrix3 m{2., 2., 2., 1., 1., 1.};
+    const auto lambda = eigenvalues(m);
+    CHECK_THAT(lambda[0], Catch::Matchers::WithinAbs(1., tolerance));
+    CHECK_THAT(lambda[1], Catch::Matchers::WithinAbs(1., tolerance));
+    CHECK_THAT(lambda[2], Catch::Matchers::WithinAbs(4., tolerance));
+
+    const auto v = eigenvector(m, lambda[2]);
+    check_eigenvector(m, lambda[2], v);
+    CHECK_THAT(std::abs(dot(v, {1. / std::sqrt(3.), 1. / std::sqrt(3.), 1. / std::sqrt(3.)})),
+               Catch::Matchers::WithinAbs(1., tolerance));
+
+    // any unit vector of the plane orthogonal to (1, 1, 1)
+    const auto u = eigenvector(m, 1.);
+    check_eigenvector(m, 1., u);
+    CHECK_THAT(dot(u, v), Catch::Matchers::WithinAbs(0., tolerance));
+  }
+
+  SECTION("three equal eigenvalues") {
+    const Matrix3 m{5., 5., 5., 0., 0., 0.};
+    const auto lambda = eigenvalues(m);
+    CHECK(lambda == std::array<double, 3>{5., 5., 5.});
+    check_eigenvector(m, 5., eigenvector(m, 5.));
+  }
+
+  SECTION("zero matrix") {
+    const Matrix3 m{0., 0., 0., 0., 0., 0.};
+    CHECK(eigenvalues(m) == std::array<double, 3>{0., 0., 0.});
+    check_eigenvector(m, 0., eigenvector(m, 0.));
+  }
+}
@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <Evaluator/DD4hepUnits.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+#include <edm4eic/CalorimeterHitCollection.h>
+#include <edm4eic/ClusterCollection.h>
+#include <edm4eic/MCRecoClusterParticleAssociationCollection.h>
+#include <edm4eic/ProtoClusterCollection.h>
+#include <edm4hep/CaloHitContributionCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
+#include <edm4hep/RawCalorimeterHitCollection.h>
+#include <edm4hep/SimCalorimeterHitCollection.h>
+#include <edm4hep/Vector3f.h>
+#include <fmt/core.h>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <tuple>
+
+#include "algorithms/calorimetry/CalorimeterClusterRecoCoG.h"
+#include "algorithms/calorimetry/CalorimeterClusterRecoCoGConfig.h"
+#include "algorithms/calorimetry/CalorimeterHitDigi.h"
+#include "algorithms/calorimetry/CalorimeterHitDigiConfig.h"
+#include "algorithms/calorimetry/CalorimeterIslandCluster.h"
+#include "algorithms/calorimetry/CalorimeterIslandClusterConfig.h"
+#include "algorithms/calorimetry/HEXPLIT.h"
+#include "algorithms/calorimetry/HEXPLITConfig.h"
+#include "algorithms/calorimetry/ImagingTopoCluster.h"
+#include "algorithms/calorimetry/ImagingTopoClusterConfig.h"
+#include "benchmark_events.h"
+
+using eicrecon::benchmark::CalorimeterGrid;
+using eicrecon::benchmark::make_calorimeter_hits;
+using eicrecon::benchmark::occupancies;
+
+// The benchmarks are hidden by default, run them with
+// `algorithms_test "[benchmark]"`, add `--reporter JSON::out=benchmark.json`
+// (or `XML`) for machine readable results, and set EICRECON_BENCHMARK_HITS
+// for other numbers of hits per event.
+
+TEST_CASE("the calorimeter island clustering benchmark", "[.][CalorimeterIslandCluster][benchmark]") {
+  const std::size_t n_hits = GENERATE(from_range(occupancies()));
+  const bool use_adjacencyMatrix = GENERATE(false, true);
+
+  CalorimeterGrid grid;
+  auto hits = make_calorimeter_hits(grid, n_hits);
+
+  eicrecon::CalorimeterIslandCluster algo("CalorimeterIslandCluster");
+  eicrecon::CalorimeterIslandClusterConfig cfg;
+  cfg.minClusterHitEdep = 0. * dd4hep::GeV;
+  cfg.minClusterCenterEdep = 0. * dd4hep::GeV;
+  cfg.splitCluster = false;
+  if (use_adjacencyMatrix) {
+    cfg.adjacencyMatrix = "abs(x_1 - x_2) + abs(y_1 - y_2) == 1";
+    cfg.readout = "MockCalorimeterHits";
+  } else {
+    cfg.localDistXY = {grid.pitch, grid.pitch};
+  }
+  algo.applyConfig(cfg);
+  algo.init();
+
+  const std::string name = fmt::format("{} hits, {}", n_hits, use_adjacencyMatrix ? "adjacencyMatrix" : "localDistXY");
+  BENCHMARK(name.c_str()) {
+    auto protoclusters = std::make_unique<edm4eic::ProtoClusterCollection>();
+    algo.process({&hits}, {protoclusters.get()});
+    return protoclusters->size();
+  };
+}
+
+TEST_CASE("the imaging topological clustering benchmark", "[.][ImagingTopoCluster][benchmark]") {
+  const std::size_t n_hits = GENERATE(from_range(occupancies()));
+
+  CalorimeterGrid grid;
+  auto hits = make_calorimeter_hits(grid, n_hits);
+
+  eicrecon::ImagingTopoCluster algo("ImagingTopoCluster");
+  eicrecon::ImagingTopoClusterConfig cfg;
+  cfg.localDistXY = {grid.pitch, grid.pitch};
+  cfg.minClusterEdep = 0. * dd4hep::GeV;
+  cfg.minClusterNhits = 1;
+  algo.applyConfig(cfg);
+  algo.init();
+
+  const std::string name = fmt::format("{} hits", n_hits);
+  BENCHMARK(name.c_str()) {
+    auto protoclusters = std::make_unique<edm4eic::ProtoClusterCollection>();
+    algo.process({&hits}, {protoclusters.get()});
+    return protoclusters->size();
+  };
+}
+
+TEST_CASE("the calorimeter hit digitization benchmark", "[.][CalorimeterHitDigi][benchmark]") {
+  const std::size_t n_hits = GENERATE(from_range(occupancies()));
+
+  // sim hits of the cells of the grid event, with 2 contributions each
+  CalorimeterGrid grid;
+  auto hits = make_calorimeter_hits(grid, n_hits);
+  auto headers = std::make_unique<edm4hep::EventHeaderCollection>();
+  headers->create(
+    1, // std::int32_t eventNumber
+    1, // std::int32_t runNumber
+    0, // std::uint64_t timeStamp
+    1. // float weight
+  );
+  auto calohits = std::make_unique<edm4hep::CaloHitContributionCollection>();
+  auto simhits = std::make_unique<edm4hep::SimCalorimeterHitCollection>();
+  for (const auto& hit : hits) {
+    auto mhit = simhits->create(hit.getCellID(), hit.getEnergy(), hit.getPosition());
+    for (float time : {7.0, 9.0}) {
+      mhit.addToContributions(calohits->create(
+        0, // std::int32_t PDG
+        hit.getEnergy() / 2, // float energy
+        time, // float time
+        hit.getPosition() // edm4hep::Vector3f stepPosition
+      ));
+    }
+  }
+
+  eicrecon::CalorimeterHitDigi algo("CalorimeterHitDigi");
+  eicrecon::CalorimeterHitDigiConfig cfg;
+  cfg.threshold = 0. /* GeV */;
+  cfg.corrMeanScale = "1.";
+  cfg.capADC = 1 << 14;
+  cfg.dyRangeADC = 5.0 /* GeV */;
+  cfg.pedMeanADC = 1000;
+  cfg.pedSigmaADC = 100;
+  cfg.tRes = 0.1 * dd4hep::ns;
+  cfg.eRes = {0.1 * sqrt(dd4hep::GeV), 0.01, 0. * dd4hep::GeV};
+  cfg.resolutionTDC = 1.0 * dd4hep::ns;
+  cfg.readout = "MockCalorimeterHits";
+  algo.applyConfig(cfg);
+  algo.init();
+
+  const std::string name = fmt::format("{} hits", n_hits);
+  BENCHMARK(name.c_str()) {
+    auto rawhits = std::make_unique<edm4hep::RawCalorimeterHitCollection>();
+    algo.process({headers.get(), simhits.get()}, {rawhits.get()});
+    return rawhits->size();
+  };
+}
+
+TEST_CASE("the calorimeter CoG benchmark", "[.][CalorimeterClusterRecoCoG][benchmark]") {
+  const std::size_t n_hits = GENERATE(from_range(occupancies()));
+  const bool singlePrecision = GENERATE(false, true);
+
+  // protoclusters of the showers of 10 hits of the grid event
+  CalorimeterGrid grid;
+  auto hits = make_calorimeter_hits(grid, n_hits);
+  edm4eic::ProtoClusterCollection protoclusters;
+  edm4hep::SimCalorimeterHitCollection simhits;
+  for (std::size_t i = 0; i < hits.size(); i++) {
+    if (i % 10 == 0) {
+      protoclusters.create();
+    }
+    auto pclust = protoclusters[protoclusters.size() - 1];
+    pclust.addToHits(hits[i]);
+    pclust.addToWeights(1);
+  }
+
+  eicrecon::CalorimeterClusterRecoCoG algo("CalorimeterClusterRecoCoG");
+  eicrecon::CalorimeterClusterRecoCoGConfig cfg;
+  cfg.energyWeight = "log";
+  cfg.sampFrac = 0.0203;
+  cfg.logWeightBaseCoeffs = {5.0, 0.65, 0.31};
+  cfg.logWeightBase_Eref = 50 * dd4hep::GeV;
+  cfg.singlePrecision = singlePrecision;
+  algo.applyConfig(cfg);
+  algo.init();
+
+  const std::string name = fmt::format("{} hits{}", n_hits, singlePrecision ? ", singlePrecision" : "");
+  BENCHMARK(name.c_str()) {
+    auto clusters = std::make_unique<edm4eic::ClusterCollection>();
+    auto assocs = std::make_unique<edm4eic::MCRecoClusterParticleAssociationCollection>();
+    algo.process(std::make_tuple(&protoclusters, &simhits), std::make_tuple(clusters.get(), assocs.get()));
+    return clusters->size();
+  };
+}
+
+TEST_CASE("the HEXPLIT benchmark", "[.][HEXPLIT][benchmark]") {
+  const std::size_t n_hits = GENERATE(from_range(occupancies()));
+
+  // hexagonal cells of the HEXPLIT test, on the grid of the event
+  CalorimeterGrid grid;
+  const double side_length = 31.3 * dd4hep::mm;
+  grid.pitch = side_length;
+  grid.layer_spacing = 25.1 * dd4hep::mm;
+  auto hits = make_calorimeter_hits(grid, n_hits, edm4hep::Vector3f(2 * side_length, sqrt(3) * side_length, 3 * dd4hep::mm));
+
+  eicrecon::HEXPLIT algo("HEXPLIT");
+  eicrecon::HEXPLITConfig cfg;
+  cfg.MIP = 472. * dd4hep::keV;
+  cfg.tmax = 1000. * dd4hep::ns;
+  algo.applyConfig(cfg);
+  algo.init();
+
+  const std::string name = fmt::format("{} hits", n_hits);
+  BENCHMARK(name.c_str()) {
+    auto subcells = std::make_unique<edm4eic::CalorimeterHitCollection>();
+    algo.process({&hits}, {subcells.get()});
+    return subcells->size();
+  };
+}
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <Evaluator/DD4hepUnits.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "services/geometry/cellid_cache/CellIDGeometryCacheSvc.h"
+
+namespace {
+
+/// Sets the capacity of the shared caches for the scope of a test
+struct SharedCacheSize {
+  explicit SharedCacheSize(std::size_t size) {
+    eicrecon::CellIDGeometryCacheSvc::instance().setProperty("sharedCacheSize", size);
+  }
+  ~SharedCacheSize() {
+    eicrecon::CellIDGeometryCacheSvc::instance().setProperty("sharedCacheSize", std::size_t{1 << 20});
+  }
+};
+
+/// A cell of the MockCalorimeter volume of algorithmsInit.cc, system:8,layer:8,x:8,y:8
+std::uint64_t mock_cell(std::uint64_t i) { return 255 | (i << 8); }
+
+} // namespace
+
+TEST_CASE( "the shared caches hold at most sharedCacheSize cells", "[CellIDGeometryCacheSvc]" ) {
+  auto& cache = eicrecon::CellIDGeometryCacheSvc::instance();
+  const std::size_t capacity = 32;
+  SharedCacheSize limit(capacity);
+
+  const std::uint64_t n_cells = 1000;
+  for (std::uint64_t i = 0; i < n_cells; ++i) {
+    const auto dim = cache.cellDimensions(mock_cell(i));
+    // the cells have the dimensions of the volume, also once the caches were cleared
+    REQUIRE( dim[0] == Catch::Approx(20 * dd4hep::cm) );
+    REQUIRE( dim[1] == Catch::Approx(20 * dd4hep::cm) );
+    REQUIRE( dim[2] == Catch::Approx(2 * dd4hep::cm) );
+    REQUIRE( cache.cellDimensionsSize() <= capacity );
+    REQUIRE( cache.detElementSize() <= capacity );
+  }
+
+  SECTION("evicted cells are computed again") {
+    const auto before = cache.cellDimensionsCounters();
+    for (std::uint64_t i = 0; i < n_cells; ++i) {
+      cache.cellDimensions(mock_cell(i));
+    }
+    const auto after = cache.cellDimensionsCounters();
+    REQUIRE( after.misses - before.misses > n_cells - capacity - 1 );
+  }
+
+  SECTION("cached cells are not computed again") {
+    cache.cellDimensions(mock_cell(0));
+    const auto before = cache.cellDimensionsCounters();
+    cache.cellDimensions(mock_cell(0));
+    const auto after = cache.cellDimensionsCounters();
+    REQUIRE( after.misses == before.misses );
+    REQUIRE( after.hits == before.hits + 1 );
+  }
+}
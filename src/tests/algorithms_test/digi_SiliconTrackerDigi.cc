@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <DD4hep/Detector.h>
+#include <DD4hep/IDDescriptor.h>
+#include <DD4hep/Readout.h>
+#include <Evaluator/DD4hepUnits.h>
+#include <algorithms/geo.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <edm4eic/MCRecoTrackerHitAssociationCollection.h>
+#include <edm4eic/RawTrackerHitCollection.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <edm4hep/SimTrackerHitCollection.h>
+#include <cstdint>
+#include <memory>
+
+#include "algorithms/digi/SiliconTrackerDigi.h"
+#include "algorithms/digi/SiliconTrackerDigiConfig.h"
+
+TEST_CASE("the silicon tracker digitization splits cells into readout windows", "[SiliconTrackerDigi]") {
+  auto id_desc = algorithms::GeoSvc::instance().detector()->readout("MockTrackerHits").idSpec();
+  const std::uint64_t cell_a = id_desc.encode({{"system", 255}, {"layer", 0}, {"x", 1}, {"y", 1}});
+  const std::uint64_t cell_b = id_desc.encode({{"system", 255}, {"layer", 0}, {"x", 2}, {"y", 1}});
+
+  auto mcparts = std::make_unique<edm4hep::MCParticleCollection>();
+  auto mcpart = mcparts->create();
+  auto sim_hits = std::make_unique<edm4hep::SimTrackerHitCollection>();
+  const auto add_hit = [&](std::uint64_t cell_id, double edep, double time) {
+    auto hit = sim_hits->create();
+    hit.setCellID(cell_id);
+    hit.setEDep(edep);
+    hit.setTime(time);
+    hit.setMCParticle(mcpart);
+  };
+  // not in the order of the cells nor of the times
+  add_hit(cell_a, 10 * dd4hep::keV, 150.);
+  add_hit(cell_b, 20 * dd4hep::keV, 30.);
+  add_hit(cell_a, 10 * dd4hep::keV, 40.);
+  add_hit(cell_a, 10 * dd4hep::keV, 20.);
+  add_hit(cell_a, 1 * dd4hep::keV, 10.); // below threshold
+
+  eicrecon::SiliconTrackerDigi algo("SiliconTrackerDigi");
+  eicrecon::SiliconTrackerDigiConfig cfg;
+  cfg.threshold = 5 * dd4hep::keV;
+  cfg.timeResolution = 0;
+
+  auto raw_hits = std::make_unique<edm4eic::RawTrackerHitCollection>();
+  auto associations = std::make_unique<edm4eic::MCRecoTrackerHitAssociationCollection>();
+
+  SECTION("one window per event") {
+    algo.applyConfig(cfg);
+    algo.init();
+    algo.process({sim_hits.get()}, {raw_hits.get(), associations.get()});
+
+    REQUIRE(raw_hits->size() == 2);
+    CHECK((*raw_hits)[0].getCellID() == cell_a);
+    CHECK((*raw_hits)[0].getCharge() == 30);
+    CHECK((*raw_hits)[0].getTimeStamp() == 20000);
+    CHECK((*raw_hits)[1].getCellID() == cell_b);
+    CHECK(associations->size() == 5);
+  }
+
+  SECTION("readout windows of 100 ns") {
+    cfg.readoutWindow = 100;
+    algo.applyConfig(cfg);
+    algo.init();
+    algo.process({sim_hits.get()}, {raw_hits.get(), associations.get()});
+
+    // sorted by cellID and time, with the hit at 150 ns in a second window of cell a
+    REQUIRE(raw_hits->size() == 3);
+    CHECK((*raw_hits)[0].getCellID() == cell_a);
+    CHECK((*raw_hits)[0].getCharge() == 20);
+    CHECK((*raw_hits)[0].getTimeStamp() == 20000);
+    CHECK((*raw_hits)[1].getCellID() == cell_a);
+    CHECK((*raw_hits)[1].getCharge() == 10);
+    CHECK((*raw_hits)[1].getTimeStamp() == 150000);
+    CHECK((*raw_hits)[2].getCellID() == cell_b);
+    CHECK((*raw_hits)[2].getTimeStamp() == 30000);
+    // the hit below threshold is associated with the raw hit of its window
+    CHECK(associations->size() == 5);
+  }
+
+  SECTION("without associations") {
+    cfg.readoutWindow = GENERATE(0., 100.);
+    algo.applyConfig(cfg);
+    algo.init();
+    algo.process({sim_hits.get()}, {raw_hits.get(), nullptr});
+
+    // the same raw hits as with the associations
+    REQUIRE(raw_hits->size() == (cfg.readoutWindow > 0 ? 3 : 2));
+    CHECK((*raw_hits)[0].getCellID() == cell_a);
+    CHECK((*raw_hits)[0].getTimeStamp() == 20000);
+  }
+}
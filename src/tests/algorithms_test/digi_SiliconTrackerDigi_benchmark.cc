@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <DD4hep/Detector.h>
+#include <DD4hep/IDDescriptor.h>
+#include <DD4hep/Readout.h>
+#include <Evaluator/DD4hepUnits.h>
+#include <algorithms/geo.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+#include <edm4eic/MCRecoTrackerHitAssociationCollection.h>
+#include <edm4eic/RawTrackerHitCollection.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <edm4hep/SimTrackerHitCollection.h>
+#include <edm4hep/Vector3d.h>
+#include <fmt/core.h>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "algorithms/digi/SiliconTrackerDigi.h"
+#include "algorithms/digi/SiliconTrackerDigiConfig.h"
+#include "benchmark_events.h"
+
+// hidden by default, run with `algorithms_test "[SiliconTrackerDigi][benchmark]"`
+TEST_CASE("the silicon tracker digitization benchmark", "[.][SiliconTrackerDigi][benchmark]") {
+  const std::size_t n_hits = GENERATE(from_range(eicrecon::benchmark::occupancies()));
+
+  // hits in 10 layers of 64 x 64 pixels, so that cells with several hits
+  // become frequent at high occupancy
+  auto id_desc = algorithms::GeoSvc::instance().detector()->readout("MockTrackerHits").idSpec();
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> layer(0, 9);
+  std::uniform_int_distribution<int> pixel(0, 63);
+  std::exponential_distribution<double> edep(1. / (30 * dd4hep::keV));
+
+  auto mcparts = std::make_unique<edm4hep::MCParticleCollection>();
+  auto mcpart = mcparts->create();
+  auto sim_hits = std::make_unique<edm4hep::SimTrackerHitCollection>();
+  for (std::size_t i = 0; i < n_hits; i++) {
+    const int x = pixel(rng), y = pixel(rng);
+    auto hit = sim_hits->create();
+    hit.setCellID(id_desc.encode({{"system", 255}, {"layer", layer(rng)}, {"x", x}, {"y", y}}));
+    hit.setEDep(edep(rng));
+    hit.setTime(1.0 /* ns */);
+    hit.setPosition(edm4hep::Vector3d(x * dd4hep::mm, y * dd4hep::mm, 0.));
+    hit.setMCParticle(mcpart);
+  }
+
+  eicrecon::SiliconTrackerDigi algo("SiliconTrackerDigi");
+  eicrecon::SiliconTrackerDigiConfig cfg;
+  cfg.threshold = 5 * dd4hep::keV;
+  algo.applyConfig(cfg);
+  algo.init();
+
+  const std::string name = fmt::format("{} hits", n_hits);
+  BENCHMARK(name.c_str()) {
+    auto raw_hits = std::make_unique<edm4eic::RawTrackerHitCollection>();
+    auto associations = std::make_unique<edm4eic::MCRecoTrackerHitAssociationCollection>();
+    algo.process({sim_hits.get()}, {raw_hits.get(), associations.get()});
+    return raw_hits->size();
+  };
+}
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+#include <unistd.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <system_error>
+
+#include "services/geometry/disk_cache/CacheFile.h"
+#include "services/geometry/disk_cache/GeometryDiskCacheSvc.h"
+
+TEST_CASE( "products are stored and mapped back from the geometry cache", "[GeometryDiskCacheSvc]" ) {
+  auto& cache = eicrecon::GeometryDiskCacheSvc::instance();
+  const auto dir = std::filesystem::temp_directory_path() / fmt::format("eicrecon_disk_cache_test_{}", ::getpid());
+  cache.setProperty("cacheDir", dir.string());
+
+  const std::array<std::uint64_t, 3> cells{1, 2, 3};
+  const std::array<std::uint8_t, 5> flags{1, 0, 1, 1, 0};
+  const std::array<float, 2> widths{0.5f, 2.f};
+  REQUIRE( cache.store("test product 1", 1, 42,
+                       {std::as_bytes(std::span(cells)), std::as_bytes(std::span(flags)), std::as_bytes(std::span(widths))}) );
+  // the name of the file is sanitized, under the fingerprint of the geometry
+  const auto path = cache.path("test product 1", 42);
+  REQUIRE( path.filename() == "test_product_1_000000000000002a.bin" );
+  REQUIRE( std::filesystem::exists(path) );
+
+  SECTION("the chunks are aligned to 8 bytes") {
+    auto blob = cache.load("test product 1", 1, 42);
+    REQUIRE( blob.has_value() );
+    REQUIRE( blob->data().size() == 24 + 8 + 8 );
+    const auto read_cells = blob->array<std::uint64_t>(0, 3);
+    REQUIRE( read_cells[2] == 3 );
+    REQUIRE( blob->array<std::uint8_t>(24, 5)[3] == 1 );
+    REQUIRE( blob->array<float>(32, 2)[1] == 2.f );
+    REQUIRE_THROWS( blob->array<float>(36, 2) );
+    REQUIRE_THROWS( blob->array<std::uint64_t>(28, 1) );
+  }
+
+  SECTION("other versions and keys are not found") {
+    REQUIRE_FALSE( cache.load("test product 1", 2, 42).has_value() );
+    REQUIRE_FALSE( cache.load("test product 1", 1, 43).has_value() );
+  }
+
+  SECTION("the key of a file is read back for its version") {
+    REQUIRE( eicrecon::cache_file::stored_key(path, 1) == 42 );
+    REQUIRE_FALSE( eicrecon::cache_file::stored_key(path, 2).has_value() );
+    REQUIRE_FALSE( eicrecon::cache_file::stored_key(dir / "missing.bin", 1).has_value() );
+  }
+
+  SECTION("files are hashed by content") {
+    eicrecon::CacheHash file_hash;
+    REQUIRE( file_hash.add_file(path) );
+    eicrecon::CacheHash missing_hash;
+    REQUIRE_FALSE( missing_hash.add_file(dir / "missing.bin") );
+    REQUIRE( file_hash.value() != missing_hash.value() );
+  }
+
+  SECTION("partial files are ignored") {
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    REQUIRE_FALSE( cache.load("test product 1", 1, 42).has_value() );
+  }
+
+  SECTION("nothing is written without the cache") {
+    cache.setProperty("useCache", false);
+    REQUIRE( cache.path("test product 1", 42).empty() );
+    REQUIRE_FALSE( cache.store("test product 2", 1, 42, {std::as_bytes(std::span(cells))}) );
+    REQUIRE_FALSE( cache.load("test product 1", 1, 42).has_value() );
+    cache.setProperty("useCache", true);
+  }
+
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  cache.setProperty("cacheDir", std::string());
+}
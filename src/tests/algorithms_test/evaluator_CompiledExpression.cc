@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "services/evaluator/CompiledExpression.h"
+
+using eicrecon::CompiledExpression;
+
+TEST_CASE( "expressions are compiled natively", "[CompiledExpression]" ) {
+  const std::vector<std::string> params{"x_1", "x_2", "y_1", "y_2"};
+
+  SECTION( "adjacency" ) {
+    auto expr = CompiledExpression::compile("abs(x_1 - x_2) + abs(y_1 - y_2) == 1", params);
+    REQUIRE( expr(std::vector<double>{1, 2, 3, 3}) == 1. );
+    REQUIRE( expr(std::vector<double>{1, 3, 3, 3}) == 0. );
+    REQUIRE( expr(std::vector<double>{1, 2, 3, 4}) == 0. );
+    REQUIRE( expr.uses(0) );
+    REQUIRE( expr.uses(3) );
+  }
+
+  SECTION( "unused parameters" ) {
+    auto expr = CompiledExpression::compile("(y_1 == 0) ? 0.019 : 0.037", params);
+    REQUIRE( !expr.uses(0) );
+    REQUIRE( expr.uses(2) );
+    REQUIRE_THAT( expr(std::vector<double>{0, 0, 0, 0}), Catch::Matchers::WithinAbs(0.019, 1e-12) );
+    REQUIRE_THAT( expr(std::vector<double>{0, 0, 1, 0}), Catch::Matchers::WithinAbs(0.037, 1e-12) );
+  }
+
+  SECTION( "precedence and C++ arithmetic" ) {
+    auto expr = CompiledExpression::compile("1 / 2 + 7 % 3 + 1. / 2 + -3 / 2 + std::min(2, 5) + !0 + (3 != 4) * 10", params);
+    REQUIRE( expr(std::vector<double>{}) == (1 / 2 + 7 % 3 + 1. / 2 + -3 / 2 + std::min(2, 5) + !0 + (3 != 4) * 10) );
+    auto expr2 = CompiledExpression::compile("x_1 / 2 + floor(x_2 / 10) * 10 + fmod(y_1, 10) || y_2", params);
+    REQUIRE( expr2(std::vector<double>{0, 0, 0, 0}) == 0. );
+    REQUIRE( expr2(std::vector<double>{0, 0, 0, 3}) == 1. );
+  }
+
+  SECTION( "constant folding" ) {
+    auto expr = CompiledExpression::compile("2 * std::sqrt(16.) + 1 / 2 - -1", params);
+    REQUIRE( expr.instructions() == 1 );
+    REQUIRE( expr(std::vector<double>{}) == 9. );
+    auto expr2 = CompiledExpression::compile("x_1 * (2 * 5 + 1)", params);
+    REQUIRE( expr2.instructions() == 3 );
+    REQUIRE( expr2(std::vector<double>{2, 0, 0, 0}) == 22. );
+  }
+
+  SECTION( "unsupported expressions" ) {
+    for (const char *expr : {"x_1 +", "foo(x_1)", "1.0f", "x_1 % 2", "(x_1", "TMath::Abs(x_1)", "z"}) {
+      REQUIRE_THROWS_AS( CompiledExpression::compile(expr, params), std::invalid_argument );
+    }
+  }
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <catch2/catch_test_macros.hpp>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "services/evaluator/EvaluatorSvc.h"
+
+TEST_CASE( "identical expressions share a compiled function", "[EvaluatorSvc]" ) {
+  auto& svc = eicrecon::EvaluatorSvc::instance();
+  const std::vector<std::string> params{"a", "b"};
+
+  auto f1 = svc.compile_positional("a * 10 + b", params);
+  auto f2 = svc.compile_positional("a * 10 + b", params);
+  auto g = svc.compile_positional("a * 10 + b", {"b", "a"});
+  svc.flush();
+
+  const std::vector<double> values{1, 2};
+  REQUIRE( f1(values) == 12. );
+  REQUIRE( f2(values) == 12. );
+  // the same expression with other parameters is another function
+  REQUIRE( g(values) == 21. );
+
+  auto h = svc._compile("a - b", params);
+  REQUIRE( h({{"a", 5.}, {"b", 3.}}) == 2. );
+}
+
+namespace {
+
+/// Turns the interpreter off for the scope of a test, it is back on however the test ends
+struct InterpreterOff {
+  InterpreterOff() { eicrecon::EvaluatorSvc::instance().setProperty("interpreter", false); }
+  ~InterpreterOff() { eicrecon::EvaluatorSvc::instance().setProperty("interpreter", true); }
+};
+
+} // namespace
+
+TEST_CASE( "expressions that need the interpreter can be rejected", "[EvaluatorSvc]" ) {
+  auto& svc = eicrecon::EvaluatorSvc::instance();
+  const std::vector<std::string> params{"a"};
+  InterpreterOff interpreter_off;
+
+  // native expressions are not affected
+  auto f = svc.compile_positional("(a > 1) ? 0.019 : 0.037", params);
+  const std::vector<double> values{2};
+  REQUIRE( f(values) == 0.019 );
+
+  REQUIRE_THROWS_AS( svc.compile_positional("[&] { return a; }()", params), std::invalid_argument );
+  // and the rejected expression is not kept for the next callers
+  REQUIRE_THROWS_AS( svc.compile_positional("[&] { return a; }()", params), std::invalid_argument );
+}
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <algorithms/logger.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <edm4eic/TrackParametersCollection.h>
+#include <edm4eic/TrackPoint.h>
+#include <edm4eic/TrackSegmentCollection.h>
+#include <Eigen/Core>
+#include <Eigen/LU>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+
+#include "algorithms/fardetectors/FarDetectorLinearProjection.h"
+#include "algorithms/fardetectors/FarDetectorLinearProjectionConfig.h"
+
+using eicrecon::FarDetectorLinearProjection;
+using eicrecon::FarDetectorLinearProjectionConfig;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+  edm4eic::TrackPoint make_point(float x, float y, float z, float theta, float phi) {
+    edm4eic::TrackPoint point;
+    point.position = {x, y, z};
+    point.theta = theta;
+    point.phi = phi;
+    return point;
+  }
+
+  // the projection as the solution of the 3x3 system of the two plane directions and of the track
+  Eigen::Vector3d reference(const FarDetectorLinearProjectionConfig& cfg, const edm4eic::TrackPoint& point) {
+    Eigen::Matrix3d directions;
+    directions.col(0) << cfg.plane_a[0], cfg.plane_a[1], cfg.plane_a[2];
+    directions.col(1) << cfg.plane_b[0], cfg.plane_b[1], cfg.plane_b[2];
+    directions.col(2) << std::sin(point.theta) * std::cos(point.phi), std::sin(point.theta) * std::sin(point.phi), std::cos(point.theta);
+    const Eigen::Vector3d diff(point.position.x - cfg.plane_position[0],
+                               point.position.y - cfg.plane_position[1],
+                               point.position.z - cfg.plane_position[2]);
+    return directions.inverse() * diff;
+  }
+
+}
+
+TEST_CASE("tracks are projected to the plane", "[FarDetectorLinearProjection]") {
+  FarDetectorLinearProjectionConfig cfg;
+  cfg.plane_position = {10.0, -5.0, -20000.0};
+  cfg.plane_a = {1.0, 0.0, 0.1};
+  cfg.plane_b = {0.2, 1.0, 0.0};
+
+  FarDetectorLinearProjection algo("FarDetectorLinearProjection");
+  algo.level(algorithms::LogLevel::kTrace);
+  algo.applyConfig(cfg);
+  algo.init();
+
+  edm4eic::TrackSegmentCollection segments;
+  const edm4eic::TrackPoint points[] = {
+    make_point(15.0, 3.0, -19000.0, 3.1, 0.5),
+    make_point(-40.0, 12.0, -21000.0, 3.05, -2.0),
+    make_point(0.0, 0.0, -20000.0, M_PI, 0.0),
+  };
+  for (const auto& point : points) {
+    segments.create().addToPoints(point);
+  }
+  // segments without points are not projected
+  segments.create();
+
+  auto tracks = std::make_unique<edm4eic::TrackParametersCollection>();
+  algo.process({&segments}, {tracks.get()});
+
+  REQUIRE(tracks->size() == 3);
+  for (std::size_t i = 0; i < tracks->size(); ++i) {
+    const auto expected = reference(cfg, points[i]);
+    const auto track = (*tracks)[i];
+    REQUIRE_THAT(track.getLoc().a, WithinAbs(expected[0], 1e-3));
+    REQUIRE_THAT(track.getLoc().b, WithinAbs(expected[1], 1e-3));
+    REQUIRE(track.getTheta() == points[i].theta);
+    REQUIRE(track.getPhi() == points[i].phi);
+    REQUIRE(track.getPdg() == 11);
+  }
+}
+
+TEST_CASE("a degenerate plane is rejected", "[FarDetectorLinearProjection]") {
+  FarDetectorLinearProjectionConfig cfg;
+  cfg.plane_a = {0.0, 1.0, 0.0};
+  cfg.plane_b = {0.0, 2.0, 0.0};
+
+  FarDetectorLinearProjection algo("FarDetectorLinearProjection");
+  algo.applyConfig(cfg);
+  REQUIRE_THROWS(algo.init());
+}
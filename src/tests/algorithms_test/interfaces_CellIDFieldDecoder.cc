@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <DDSegmentation/BitFieldCoder.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "algorithms/interfaces/CellIDFieldDecoder.h"
+
+TEST_CASE("CellIDFieldDecoder decodes as the BitFieldCoder", "[CellIDFieldDecoder]") {
+  const dd4hep::DDSegmentation::BitFieldCoder coder("system:8,barrel:3,module:4,layer:8,slice:5,x:32:-16,y:-16");
+
+  std::vector<std::uint64_t> cellIDs;
+  for (long x : {-32768L, -1L, 0L, 1L, 32767L}) {
+    for (long y : {-32768L, -7L, 0L, 32767L}) {
+      for (long layer : {0L, 1L, 255L}) {
+        std::uint64_t cellID = 0;
+        coder.set(cellID, "system", 101);
+        coder.set(cellID, "module", 9);
+        coder.set(cellID, "layer", layer);
+        coder.set(cellID, "x", x);
+        coder.set(cellID, "y", y);
+        cellIDs.push_back(cellID);
+      }
+    }
+  }
+
+  SECTION("all the fields") {
+    const auto decoder = eicrecon::CellIDFieldDecoder::allFields(coder);
+    REQUIRE(decoder.size() == coder.fields().size());
+    for (auto cellID : cellIDs) {
+      for (std::size_t k = 0; k < decoder.size(); ++k) {
+        REQUIRE(decoder.get(cellID, k) == coder.get(cellID, k));
+      }
+    }
+  }
+
+  SECTION("named fields, one at a time and batched") {
+    const eicrecon::CellIDFieldDecoder decoder(coder, {"layer", "x", "y"});
+    REQUIRE(decoder.size() == 3);
+
+    std::vector<double> columns(decoder.size() * cellIDs.size());
+    decoder.decode(cellIDs.data(), cellIDs.size(), columns.data());
+    for (std::size_t i = 0; i < cellIDs.size(); ++i) {
+      REQUIRE(decoder.get<0>(cellIDs[i]) == coder.get(cellIDs[i], "layer"));
+      REQUIRE(decoder.get<1>(cellIDs[i]) == coder.get(cellIDs[i], "x"));
+      REQUIRE(decoder.get<2>(cellIDs[i]) == coder.get(cellIDs[i], "y"));
+      REQUIRE(columns[i] == coder.get(cellIDs[i], "layer"));
+      REQUIRE(columns[cellIDs.size() + i] == coder.get(cellIDs[i], "x"));
+      REQUIRE(columns[2 * cellIDs.size() + i] == coder.get(cellIDs[i], "y"));
+    }
+  }
+}
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "algorithms/interfaces/CounterRandomSvc.h"
+
+using eicrecon::CounterRandom;
+using eicrecon::Philox4x32;
+
+TEST_CASE("Philox4x32-10 gives the known answers of Random123", "[CounterRandom]") {
+  REQUIRE(Philox4x32::generate({0, 0, 0, 0}, {0, 0}) ==
+          Philox4x32::Counter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+  REQUIRE(Philox4x32::generate({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}) ==
+          Philox4x32::Counter{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+  REQUIRE(Philox4x32::generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}) ==
+          Philox4x32::Counter{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+}
+
+TEST_CASE("the gaussians of many cells are the first of their streams", "[CounterRandom]") {
+  auto& svc                = eicrecon::CounterRandomSvc::instance();
+  const std::uint64_t key  = svc.key("CounterRandomTest", 1, 42);
+  const std::size_t n      = 100000;
+
+  // cellIDs with structured bits, as those of a readout
+  std::vector<std::uint64_t> cellIDs(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    cellIDs[i] = (std::uint64_t{i % 317} << 40) | (i / 317) << 8 | 0x3;
+  }
+  std::vector<double> values(n);
+  CounterRandom::gaussians(key, cellIDs, values);
+
+  SECTION("the same as a stream per cell") {
+    for (std::size_t i = 0; i < n; i += 97) {
+      REQUIRE(values[i] == CounterRandom(key, cellIDs[i]).gaussian());
+    }
+  }
+
+  SECTION("reproducible for a key and cellID") {
+    REQUIRE(svc.key("CounterRandomTest", 1, 42) == key);
+    std::vector<double> again(n);
+    CounterRandom::gaussians(key, cellIDs, again);
+    REQUIRE(again == values);
+
+    // other events and cells have other values
+    std::vector<double> other(n);
+    CounterRandom::gaussians(svc.key("CounterRandomTest", 1, 43), cellIDs, other);
+    std::size_t same = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      same += (other[i] == values[i]);
+    }
+    REQUIRE(same == 0);
+    REQUIRE(values[0] != values[1]);
+  }
+
+  SECTION("standard normal moments") {
+    double sum = 0, sum2 = 0, sum3 = 0, sum4 = 0;
+    for (double x : values) {
+      sum += x;
+      sum2 += x * x;
+      sum3 += x * x * x;
+      sum4 += x * x * x * x;
+    }
+    // within about 5 standard deviations of the sample moments
+    REQUIRE_THAT(sum / n, Catch::Matchers::WithinAbs(0., 0.016));
+    REQUIRE_THAT(sum2 / n, Catch::Matchers::WithinAbs(1., 0.023));
+    REQUIRE_THAT(sum3 / n, Catch::Matchers::WithinAbs(0., 0.062));
+    REQUIRE_THAT(sum4 / n, Catch::Matchers::WithinAbs(3., 0.16));
+  }
+
+  SECTION("no more values than cells or outputs") {
+    std::vector<double> short_out(10, -1.);
+    CounterRandom::gaussians(key, cellIDs, short_out);
+    REQUIRE(short_out[9] == values[9]);
+    std::vector<double> long_out(3, -1.);
+    CounterRandom::gaussians(key, std::span(cellIDs).first(2), long_out);
+    REQUIRE(long_out[1] == values[1]);
+    REQUIRE(long_out[2] == -1.);
+  }
+}
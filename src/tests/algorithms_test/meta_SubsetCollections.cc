@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <algorithms/logger.h>
+#include <catch2/catch_test_macros.hpp>
+#include <edm4hep/MCParticleCollection.h>
+#include <gsl/pointers>
+#include <spdlog/spdlog.h>
+#include <memory>
+#include <vector>
+
+#include "algorithms/meta/CollectionCollector.h"
+#include "algorithms/meta/SubDivideCollection.h"
+#include "algorithms/reco/ChargedMCParticleSelector.h"
+
+namespace {
+
+  // two charged particles and a neutral one
+  std::unique_ptr<edm4hep::MCParticleCollection> make_particles() {
+    auto particles = std::make_unique<edm4hep::MCParticleCollection>();
+    for (float charge : {-1.f, 0.f, 1.f}) {
+      auto particle = particles->create();
+      particle.setCharge(charge);
+    }
+    return particles;
+  }
+
+  // the elements are the ones of the parent, not copies
+  void require_references(const edm4hep::MCParticleCollection& subset, const edm4hep::MCParticleCollection& parent) {
+    REQUIRE(subset.isSubsetCollection());
+    for (const auto& particle : subset) {
+      REQUIRE(particle.getObjectID().collectionID == parent.getID());
+    }
+  }
+
+}
+
+TEST_CASE("the selections are subset collections of their input", "[SubsetCollections]") {
+  auto particles = make_particles();
+  particles->setID(1);
+
+  SECTION("ChargedMCParticleSelector") {
+    std::shared_ptr<spdlog::logger> logger = spdlog::default_logger()->clone("ChargedMCParticleSelector");
+    eicrecon::ChargedMCParticleSelector selector;
+    selector.init(logger);
+    auto charged = selector.process(particles.get());
+    REQUIRE(charged->size() == 2);
+    require_references(*charged, *particles);
+  }
+
+  SECTION("SubDivideCollection") {
+    eicrecon::SubDivideCollection<edm4hep::MCParticle> algo("test");
+    algo.level(algorithms::LogLevel::kDebug);
+    eicrecon::SubDivideCollectionConfig<edm4hep::MCParticle> cfg;
+    cfg.function = [](const edm4hep::MCParticle& particle) { return std::vector<int>{particle.getCharge() != 0 ? 0 : 1}; };
+    algo.applyConfig(cfg);
+    algo.init();
+
+    auto charged = std::make_unique<edm4hep::MCParticleCollection>();
+    auto neutral = std::make_unique<edm4hep::MCParticleCollection>();
+    std::vector<gsl::not_null<edm4hep::MCParticleCollection*>> divisions = {charged.get(), neutral.get()};
+    algo.process({particles.get()}, {divisions});
+    REQUIRE(charged->size() == 2);
+    REQUIRE(neutral->size() == 1);
+    require_references(*charged, *particles);
+    require_references(*neutral, *particles);
+  }
+
+  SECTION("CollectionCollector") {
+    eicrecon::CollectionCollector<edm4hep::MCParticleCollection> algo("test");
+    algo.level(algorithms::LogLevel::kDebug);
+    algo.init();
+
+    auto collected = std::make_unique<edm4hep::MCParticleCollection>();
+    std::vector<gsl::not_null<const edm4hep::MCParticleCollection*>> inputs = {particles.get()};
+    algo.process({inputs}, {collected.get()});
+    REQUIRE(collected->size() == 3);
+    require_references(*collected, *particles);
+  }
+}
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <DD4hep/Shapes.h>
+#include <TGeoMatrix.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+
+#include "services/geometry/disk_cache/GeometryDiskCacheSvc.h"
+#include "services/geometry/neighbour_table/ReadoutNeighbourTableSvc.h"
+
+namespace {
+
+std::uint64_t volume_key(std::uint64_t volumeID, const dd4hep::Solid& solid, const TGeoMatrix& to_world) {
+  eicrecon::CacheHash hash;
+  eicrecon::ReadoutNeighbourTableSvc::addVolumeKey(hash, volumeID, solid, to_world);
+  return hash.value();
+}
+
+} // namespace
+
+TEST_CASE( "the neighbour table key depends on the sensitive volumes", "[ReadoutNeighbourTableSvc]" ) {
+  const dd4hep::Box box(10., 10., 1.);
+  const TGeoHMatrix identity;
+  const auto key = volume_key(255, box, identity);
+
+  SECTION("the same volume has the same key") {
+    REQUIRE( volume_key(255, dd4hep::Box(10., 10., 1.), TGeoHMatrix()) == key );
+  }
+
+  SECTION("the volume ID is in the key") {
+    REQUIRE( volume_key(254, box, identity) != key );
+  }
+
+  SECTION("the solid is in the key") {
+    REQUIRE( volume_key(255, dd4hep::Box(10., 10., 2.), identity) != key );
+    REQUIRE( volume_key(255, dd4hep::Tube(0., 10., 1.), identity) != key );
+  }
+
+  SECTION("the placement is in the key") {
+    TGeoHMatrix shifted;
+    const double translation[3]{0., 0., 100.};
+    shifted.SetTranslation(translation);
+    REQUIRE( volume_key(255, box, shifted) != key );
+
+    TGeoHMatrix rotated;
+    rotated.RotateZ(90.);
+    REQUIRE( volume_key(255, box, rotated) != key );
+  }
+}
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <edm4eic/CherenkovParticleIDCollection.h>
+#include <edm4eic/CherenkovParticleIDHypothesis.h>
+#include <edm4eic/TrackSegmentCollection.h>
+#include <edm4hep/Vector2f.h>
+#include <gsl/pointers>
+#include <spdlog/common.h>
+#include <spdlog/logger.h>
+#include <spdlog/spdlog.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "algorithms/pid/MergeParticleID.h"
+#include "algorithms/pid/MergeParticleIDConfig.h"
+
+// hidden by default, run with `algorithms_test "[MergeParticleID][benchmark]"`
+TEST_CASE("the PID MergeParticleID algorithm benchmark", "[.][MergeParticleID][benchmark]") {
+
+  std::shared_ptr<spdlog::logger> logger = spdlog::default_logger()->clone("MergeParticleID");
+  logger->set_level(spdlog::level::warn);
+
+  // a dRICH-like event: aerogel and gas PIDs of each charged particle, with
+  // the gas collection in the reverse track order, and 4 hypotheses each
+  const std::size_t n_tracks = 20;
+  const int pdgs[] = {11, 211, 321, 2212};
+
+  auto tracks = std::make_unique<edm4eic::TrackSegmentCollection>();
+  for(std::size_t i=0; i<n_tracks; i++)
+    tracks->create();
+
+  auto make_pids = [&tracks, &pdgs] (bool reversed, float refractive_index) {
+    auto coll = std::make_unique<edm4eic::CherenkovParticleIDCollection>();
+    for(std::size_t i=0; i<n_tracks; i++) {
+      auto pid = coll->create();
+      pid.setChargedParticle(tracks->at(reversed ? n_tracks-1-i : i));
+      pid.setNpe(10);
+      pid.setRefractiveIndex(refractive_index);
+      pid.setPhotonEnergy(3e-9);
+      for(int pdg : pdgs) {
+        edm4eic::CherenkovParticleIDHypothesis pid_hyp;
+        pid_hyp.PDG    = pdg;
+        pid_hyp.npe    = 5;
+        pid_hyp.weight = 0.5;
+        pid.addToHypotheses(pid_hyp);
+      }
+      for(int j=0; j<10; j++)
+        pid.addToThetaPhiPhotons(edm4hep::Vector2f{0.2, 0});
+    }
+    return coll;
+  };
+  auto coll_aerogel = make_pids(false, 1.02);
+  auto coll_gas     = make_pids(true,  1.0008);
+
+  std::vector<gsl::not_null<const edm4eic::CherenkovParticleIDCollection*>> coll_cherenkov_list = {
+    coll_aerogel.get(),
+    coll_gas.get()
+  };
+
+  eicrecon::MergeParticleID algo("test");
+  eicrecon::MergeParticleIDConfig cfg;
+  cfg.mergeMode = eicrecon::MergeParticleIDConfig::kMultiplyWeights;
+  algo.applyConfig(cfg);
+  algo.init(logger);
+
+  // sanity check of the benchmarked configuration
+  {
+    auto result = std::make_unique<edm4eic::CherenkovParticleIDCollection>();
+    algo.process({coll_cherenkov_list}, {result.get()});
+    REQUIRE(result->size() == n_tracks);
+    for(auto pid : *result)
+      REQUIRE(pid.hypotheses_size() == std::size(pdgs));
+  }
+
+  BENCHMARK("merge 2 collections of 20 charged particles") {
+    auto result = std::make_unique<edm4eic::CherenkovParticleIDCollection>();
+    algo.process({coll_cherenkov_list}, {result.get()});
+    return result->size();
+  };
+
+}
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "algorithms/pid/Tools.h"
+
+TEST_CASE("the uniform table lookup matches the finely binned table", "[Tools]") {
+  // refractive index vs. photon energy [eV], not equidistant and not in order
+  const std::vector<std::pair<double, double>> table{
+    {1.5, 1.0190}, {2.0, 1.0191}, {4.0, 1.0196}, {3.0, 1.0193}, {6.5, 1.0210}};
+  const unsigned nbins = 500;
+
+  const auto fine = eicrecon::Tools::ApplyFineBinning(table, nbins);
+  const auto uniform = eicrecon::Tools::GetUniformTable(table, nbins);
+  REQUIRE(uniform.values.size() == nbins + 1);
+
+  SECTION("single lookups") {
+    for (double e : {1.5, 1.7, 2.0, 2.5, 3.9, 5.0, 6.4}) {
+      double fine_entry, uniform_entry;
+      REQUIRE(eicrecon::Tools::GetFinelyBinnedTableEntry(fine, e, &fine_entry));
+      REQUIRE(uniform.Lookup(e, &uniform_entry));
+      // the finely binned lookup takes the entry at the lower edge of a bin
+      CHECK_THAT(uniform_entry, Catch::Matchers::WithinAbs(fine_entry, 1e-5));
+    }
+    double entry;
+    CHECK(uniform.Lookup(6.5, &entry));
+    CHECK_THAT(entry, Catch::Matchers::WithinAbs(1.0210, 1e-12));
+    CHECK_FALSE(uniform.Lookup(1.4, &entry));
+    CHECK_FALSE(uniform.Lookup(6.6, &entry));
+  }
+
+  SECTION("batched lookups") {
+    const std::vector<double> energies{0., 1.5, 3.5, 6.5, 7.};
+    std::vector<double> entries(energies.size());
+    uniform.Lookup(energies, entries);
+    CHECK(std::isnan(entries[0]));
+    CHECK_THAT(entries[1], Catch::Matchers::WithinAbs(1.0190, 1e-12));
+    CHECK_THAT(entries[2], Catch::Matchers::WithinAbs(1.01945, 1e-9));
+    CHECK_THAT(entries[3], Catch::Matchers::WithinAbs(1.0210, 1e-12));
+    CHECK(std::isnan(entries[4]));
+  }
+}
@@ -13,10 +13,21 @@
 #include <edm4hep/Vector3f.h>
 #include <math.h>
 #include <spdlog/common.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
 #include <memory>
+#include <span>
+#include <vector>
 
+#include "algorithms/interfaces/BatchedProcess.h"
 #include "algorithms/pid_lut/PIDLookup.h"
 #include "algorithms/pid_lut/PIDLookupConfig.h"
+#include "services/algorithms_init/ParallelInit.h"
+#include "services/pid_lut/PIDLookupTable.h"
+#include "services/pid_lut/PIDLookupTableSvc.h"
 
 using eicrecon::PIDLookup;
 using eicrecon::PIDLookupConfig;
@@ -85,4 +96,118 @@ TEST_CASE( "particles acquire PID", "[PIDLookup]" ) {
     REQUIRE( (*assocs_in).size() == (*assocs_out).size() );
     REQUIRE( (*partids_out).size() == (*partids_out).size() );
   }
+
+  SECTION( "a batch of events is processed as one event at a time" ) {
+    algo.applyConfig(cfg);
+    algo.init();
+
+    // two events with one and two associated particles
+    std::vector<std::unique_ptr<edm4eic::ReconstructedParticleCollection>> parts_in;
+    std::vector<std::unique_ptr<edm4eic::MCRecoParticleAssociationCollection>> assocs_in;
+    std::vector<std::unique_ptr<edm4hep::MCParticleCollection>> mcparts;
+    for (int event = 0; event < 2; ++event) {
+      parts_in.push_back(std::make_unique<edm4eic::ReconstructedParticleCollection>());
+      assocs_in.push_back(std::make_unique<edm4eic::MCRecoParticleAssociationCollection>());
+      mcparts.push_back(std::make_unique<edm4hep::MCParticleCollection>());
+      for (int i = 0; i <= event; ++i) {
+        auto part = parts_in.back()->create();
+        part.setMomentum({0.5f + i, 0.f, 0.f});
+        part.setCharge(1.);
+        auto mcpart = mcparts.back()->create();
+        mcpart.setPDG(11);
+        auto assoc = assocs_in.back()->create();
+        assoc.setRec(part);
+        assoc.setSim(mcpart);
+      }
+    }
+
+    std::vector<std::unique_ptr<edm4eic::ReconstructedParticleCollection>> parts_out;
+    std::vector<std::unique_ptr<edm4eic::MCRecoParticleAssociationCollection>> assocs_out;
+    std::vector<std::unique_ptr<edm4hep::ParticleIDCollection>> partids_out;
+    std::vector<PIDLookup::Input> inputs;
+    std::vector<PIDLookup::Output> outputs;
+    for (int event = 0; event < 2; ++event) {
+      parts_out.push_back(std::make_unique<edm4eic::ReconstructedParticleCollection>());
+      assocs_out.push_back(std::make_unique<edm4eic::MCRecoParticleAssociationCollection>());
+      partids_out.push_back(std::make_unique<edm4hep::ParticleIDCollection>());
+      inputs.push_back({parts_in[event].get(), assocs_in[event].get()});
+      outputs.push_back({parts_out[event].get(), assocs_out[event].get(), partids_out[event].get()});
+    }
+    eicrecon::process_batch(algo, std::span<const PIDLookup::Input>(inputs), std::span<const PIDLookup::Output>(outputs));
+
+    PIDLookup single("single");
+    single.applyConfig(cfg);
+    single.init();
+    for (int event = 0; event < 2; ++event) {
+      auto parts = std::make_unique<edm4eic::ReconstructedParticleCollection>();
+      auto assocs = std::make_unique<edm4eic::MCRecoParticleAssociationCollection>();
+      auto partids = std::make_unique<edm4hep::ParticleIDCollection>();
+      single.process({parts_in[event].get(), assocs_in[event].get()}, {parts.get(), assocs.get(), partids.get()});
+
+      REQUIRE( parts->size() == parts_out[event]->size() );
+      CHECK( assocs->size() == assocs_out[event]->size() );
+      CHECK( partids->size() == partids_out[event]->size() );
+      for (std::size_t i = 0; i < parts->size(); ++i) {
+        CHECK( (*parts)[i].getPDG() == (*parts_out[event])[i].getPDG() );
+      }
+    }
+  }
+}
+
+TEST_CASE( "a preloaded table does not fix the binning of its file", "[PIDLookup]" ) {
+  auto& lut_svc = eicrecon::PIDLookupTableSvc::instance();
+
+  PIDLookupConfig cfg {
+    .filename="/dev/null",
+    .pdg_values={11},
+    .charge_values={1},
+    .momentum_edges={0., 1., 2.},
+    .polar_edges={0., M_PI},
+    .azimuthal_binning={0., 2 * M_PI, 2 * M_PI}, // lower, upper, step
+    .use_radians=true,
+  };
+  PIDLookupConfig rebinned = cfg;
+  rebinned.momentum_edges = {0., 0.5, 1., 2.};
+
+  lut_svc.preload(cfg.filename, PIDLookup::binning(cfg));
+  const auto* table = lut_svc.load(cfg.filename, PIDLookup::binning(cfg));
+  const auto* rebinned_table = lut_svc.load(rebinned.filename, PIDLookup::binning(rebinned));
+
+  CHECK( table == lut_svc.load(cfg.filename, PIDLookup::binning(cfg)) );
+  CHECK( rebinned_table != table );
+  CHECK( rebinned_table == lut_svc.load(rebinned.filename, PIDLookup::binning(rebinned)) );
+}
+
+TEST_CASE( "preloaded tables can be used in forked processes", "[PIDLookupTableSvc]" ) {
+  auto& svc = eicrecon::PIDLookupTableSvc::instance();
+  eicrecon::ParallelInit::instance().addBeforeFork("pid_lut", [&svc]() { svc.wait(); });
+
+  const eicrecon::PIDLookupTable::Binning binning{
+    .pdg_values={11},
+    .charge_values={1},
+    .momentum_edges={0., 1., 2., 3.},
+    .polar_edges={0., M_PI},
+    .azimuthal_binning={0., 2 * M_PI, 2 * M_PI},
+    .azimuthal_bin_centers_in_lut=false,
+    .momentum_bin_centers_in_lut=true,
+    .polar_bin_centers_in_lut=true,
+    .use_radians=true,
+    .missing_electron_prob=false,
+  };
+  // the service is initialized, so that the table is loaded in the background right away
+  svc.preload("/dev/null", binning);
+  REQUIRE( eicrecon::ParallelInit::instance().beforeFork().empty() );
+
+  const pid_t pid = fork();
+  REQUIRE( pid >= 0 );
+  if (pid == 0) {
+    // a load left behind by the fork would never finish
+    alarm(10);
+    _exit(svc.load("/dev/null", binning) != nullptr ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+  int status = 0;
+  while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+  }
+  REQUIRE( WIFEXITED(status) );
+  REQUIRE( WEXITSTATUS(status) == EXIT_SUCCESS );
 }
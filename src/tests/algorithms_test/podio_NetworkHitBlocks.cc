@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "services/io/podio/NetworkHitBlocks.h"
+
+using eicrecon::NetworkEvent;
+using eicrecon::NetworkHitKind;
+using eicrecon::NetworkRawHit;
+
+TEST_CASE("Network event messages are decoded as encoded", "[NetworkEvent]") {
+  const std::vector<std::pair<std::string, std::vector<NetworkRawHit>>> tracker_hits{
+    {"SiBarrelRawHits", {{0x1234567890abcdefULL, 17, -3}, {2, 0, 1 << 30}}},
+    {"EmptyRawHits", {}},
+  };
+  const std::vector<std::pair<std::string, std::vector<NetworkRawHit>>> calorimeter_hits{
+    {"EcalBarrelRawHits", {{42, 4095, 7}}},
+  };
+  const auto message = NetworkEvent::encode(7, 123456789012ULL, 99, tracker_hits, calorimeter_hits);
+
+  SECTION("round trip") {
+    const auto event = NetworkEvent::decode(message);
+    REQUIRE(event.run_number == 7);
+    REQUIRE(event.event_number == 123456789012ULL);
+    REQUIRE(event.time_stamp == 99);
+    REQUIRE(event.blocks.size() == 3);
+
+    // the tracker blocks come first, in their order
+    const std::vector<std::pair<NetworkHitKind, const std::pair<std::string, std::vector<NetworkRawHit>>*>> expected{
+      {NetworkHitKind::RawTrackerHit, &tracker_hits[0]},
+      {NetworkHitKind::RawTrackerHit, &tracker_hits[1]},
+      {NetworkHitKind::RawCalorimeterHit, &calorimeter_hits[0]},
+    };
+    for (std::size_t b = 0; b < expected.size(); ++b) {
+      const auto& block = event.blocks[b];
+      const auto& [name, hits] = *expected[b].second;
+      REQUIRE(block.kind == expected[b].first);
+      REQUIRE(block.name == name);
+      REQUIRE(block.size() == hits.size());
+      for (std::size_t i = 0; i < hits.size(); ++i) {
+        REQUIRE(block[i].cellID == hits[i].cellID);
+        REQUIRE(block[i].value == hits[i].value);
+        REQUIRE(block[i].timeStamp == hits[i].timeStamp);
+      }
+    }
+  }
+
+  SECTION("an empty event") {
+    const auto empty = NetworkEvent::encode(1, 2, 3, {}, {});
+    const auto event = NetworkEvent::decode(empty);
+    REQUIRE(event.event_number == 2);
+    REQUIRE(event.blocks.empty());
+  }
+
+  SECTION("truncated messages are rejected") {
+    // every proper prefix ends inside a value, a name or a block of hits
+    for (std::size_t size = 0; size < message.size(); ++size) {
+      REQUIRE_THROWS_AS(NetworkEvent::decode(std::span(message).first(size)), std::runtime_error);
+    }
+  }
+
+  SECTION("trailing bytes are rejected") {
+    auto longer = message;
+    longer.push_back(std::byte{0});
+    REQUIRE_THROWS_AS(NetworkEvent::decode(longer), std::runtime_error);
+  }
+
+  SECTION("a bad magic is rejected") {
+    auto bad = message;
+    bad[0] = std::byte{'X'};
+    REQUIRE_THROWS_AS(NetworkEvent::decode(bad), std::runtime_error);
+  }
+
+  SECTION("other versions are rejected") {
+    auto bad = message;
+    const std::uint32_t version = NetworkEvent::version + 1;
+    std::memcpy(bad.data() + sizeof(std::uint32_t), &version, sizeof(version));
+    REQUIRE_THROWS_AS(NetworkEvent::decode(bad), std::runtime_error);
+  }
+
+  SECTION("blocks of unknown kind are rejected") {
+    auto bad = message;
+    // the kind of the first block follows the magic, the version, the three numbers and the block count
+    const std::uint32_t kind = 3;
+    std::memcpy(bad.data() + 2 * sizeof(std::uint32_t) + 3 * sizeof(std::uint64_t) + sizeof(std::uint32_t), &kind,
+                sizeof(kind));
+    REQUIRE_THROWS_AS(NetworkEvent::decode(bad), std::runtime_error);
+  }
+}
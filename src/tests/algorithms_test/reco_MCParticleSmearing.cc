@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <algorithms/logger.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <edm4eic/ClusterCollection.h>
+#include <edm4eic/MCRecoParticleAssociationCollection.h>
+#include <edm4eic/ReconstructedParticleCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+
+#include "algorithms/reco/MCParticleSmearing.h"
+#include "algorithms/reco/MCParticleSmearingConfig.h"
+
+using eicrecon::MCParticleSmearing;
+using eicrecon::MCParticleSmearingConfig;
+
+namespace {
+
+  struct Event {
+    edm4hep::EventHeaderCollection headers;
+    edm4hep::MCParticleCollection mcparticles;
+
+    std::unique_ptr<edm4eic::ReconstructedParticleCollection> charged = std::make_unique<edm4eic::ReconstructedParticleCollection>();
+    std::unique_ptr<edm4eic::MCRecoParticleAssociationCollection> charged_assocs = std::make_unique<edm4eic::MCRecoParticleAssociationCollection>();
+    std::unique_ptr<edm4eic::ReconstructedParticleCollection> neutral = std::make_unique<edm4eic::ReconstructedParticleCollection>();
+    std::unique_ptr<edm4eic::MCRecoParticleAssociationCollection> neutral_assocs = std::make_unique<edm4eic::MCRecoParticleAssociationCollection>();
+    std::unique_ptr<edm4eic::ClusterCollection> clusters = std::make_unique<edm4eic::ClusterCollection>();
+
+    explicit Event(int event_number = 1) {
+      auto header = headers.create();
+      header.setRunNumber(1);
+      header.setEventNumber(event_number);
+    }
+
+    // a final-state particle of momentum p at eta = 0.5
+    void add_particle(int pdg, float charge, double p, int status = 1) {
+      auto mcparticle = mcparticles.create();
+      mcparticle.setPDG(pdg);
+      mcparticle.setCharge(charge);
+      mcparticle.setGeneratorStatus(status);
+      const double theta = 2 * std::atan(std::exp(-0.5));
+      using MomType = std::decay_t<decltype(mcparticle.getMomentum().x)>;
+      mcparticle.setMomentum({static_cast<MomType>(p * std::sin(theta) * std::cos(1.)),
+                              static_cast<MomType>(p * std::sin(theta) * std::sin(1.)),
+                              static_cast<MomType>(p * std::cos(theta))});
+      mcparticle.setMass(std::abs(pdg) == 11 ? 0.000511 : (pdg == 22 ? 0. : 0.13957));
+    }
+
+    void smear(const MCParticleSmearingConfig& cfg) {
+      MCParticleSmearing algo("MCParticleSmearing");
+      algo.level(algorithms::LogLevel::kTrace);
+      algo.applyConfig(cfg);
+      algo.init();
+      algo.process({&headers, &mcparticles},
+                   {charged.get(), charged_assocs.get(), neutral.get(), neutral_assocs.get(), clusters.get()});
+    }
+  };
+
+}
+
+TEST_CASE("the final-state particles are smeared with the parametrised resolutions", "[MCParticleSmearing]") {
+  MCParticleSmearingConfig cfg;
+
+  SECTION("acceptance of the tracking and of the calorimetry") {
+    Event event;
+    event.add_particle(211, 1, 5.);      // tracked
+    event.add_particle(11, -1, 5.);      // tracked, with a cluster
+    event.add_particle(22, 0, 5.);       // neutral with a cluster
+    event.add_particle(2112, 0, 5.);     // not seen
+    event.add_particle(211, 1, 5., 2);   // not in the final state
+    event.add_particle(211, 1, 0.05);    // below the pT threshold
+    event.smear(cfg);
+
+    REQUIRE(event.charged->size() == 2);
+    REQUIRE(event.charged_assocs->size() == 2);
+    REQUIRE(event.neutral->size() == 1);
+    REQUIRE(event.neutral_assocs->size() == 1);
+    REQUIRE(event.clusters->size() == 2);
+    REQUIRE((*event.charged)[0].getClusters().empty());
+    REQUIRE((*event.charged)[1].getClusters().size() == 1);
+    REQUIRE((*event.neutral)[0].getClusters().size() == 1);
+    REQUIRE((*event.charged_assocs)[1].getSim() == event.mcparticles[1]);
+    REQUIRE((*event.neutral_assocs)[0].getSim() == event.mcparticles[2]);
+  }
+
+  SECTION("without resolutions the particles are not changed") {
+    cfg.momentumResolutionA = cfg.momentumResolutionB = 0;
+    cfg.angularResolutionA = cfg.angularResolutionB = 0;
+    Event event;
+    event.add_particle(211, 1, 5.);
+    event.smear(cfg);
+    REQUIRE(event.charged->size() == 1);
+    const auto momentum = (*event.charged)[0].getMomentum();
+    const auto true_momentum = event.mcparticles[0].getMomentum();
+    REQUIRE_THAT(momentum.x, Catch::Matchers::WithinAbs(true_momentum.x, 1e-5));
+    REQUIRE_THAT(momentum.y, Catch::Matchers::WithinAbs(true_momentum.y, 1e-5));
+    REQUIRE_THAT(momentum.z, Catch::Matchers::WithinAbs(true_momentum.z, 1e-5));
+  }
+
+  SECTION("the smearing only depends on the event and the particle") {
+    Event first(7), second(7), other(8);
+    for (auto* event : {&first, &second, &other}) {
+      event->add_particle(211, 1, 5.);
+      event->smear(cfg);
+    }
+    REQUIRE((*first.charged)[0].getMomentum().x == (*second.charged)[0].getMomentum().x);
+    REQUIRE((*first.charged)[0].getMomentum().x != (*other.charged)[0].getMomentum().x);
+  }
+}
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <algorithms/logger.h>
+#include <catch2/catch_test_macros.hpp>
+#include <edm4eic/ClusterCollection.h>
+#include <edm4eic/ReconstructedParticleCollection.h>
+#include <edm4eic/TrackCollection.h>
+#include <edm4eic/TrackPoint.h>
+#include <edm4eic/TrackSegmentCollection.h>
+#include <edm4hep/Vector3f.h>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+#include "algorithms/reco/TrackClusterMatching.h"
+#include "algorithms/reco/TrackClusterMatchingConfig.h"
+
+using eicrecon::TrackClusterMatching;
+using eicrecon::TrackClusterMatchingConfig;
+
+namespace {
+
+  // position at a radius of 1 m in the barrel
+  edm4hep::Vector3f barrel_position(double eta, double phi) {
+    const double r = 1000.;
+    return {static_cast<float>(r * std::cos(phi)), static_cast<float>(r * std::sin(phi)),
+            static_cast<float>(r * std::sinh(eta))};
+  }
+
+  struct Event {
+    edm4eic::TrackCollection tracks;
+    edm4eic::TrackSegmentCollection projections;
+    edm4eic::ReconstructedParticleCollection particles;
+    edm4eic::ClusterCollection clusters;
+
+    // a charged particle with a projection to the given surface of a system
+    void add_particle(double eta, double phi, std::uint64_t system = 101, std::uint64_t layer = 1) {
+      auto track = tracks.create();
+      auto segment = projections.create();
+      segment.setTrack(track);
+      edm4eic::TrackPoint point;
+      point.surface = system | (layer << 36);
+      point.position = barrel_position(eta, phi);
+      segment.addToPoints(point);
+      auto particle = particles.create();
+      particle.addToTracks(track);
+    }
+
+    void add_cluster(double eta, double phi) {
+      auto cluster = clusters.create();
+      cluster.setPosition(barrel_position(eta, phi));
+    }
+
+    std::unique_ptr<edm4eic::ReconstructedParticleCollection> match(const TrackClusterMatchingConfig& cfg) {
+      TrackClusterMatching algo("TrackClusterMatching");
+      algo.level(algorithms::LogLevel::kTrace);
+      algo.applyConfig(cfg);
+      algo.init();
+      auto matched = std::make_unique<edm4eic::ReconstructedParticleCollection>();
+      algo.process({&particles, &projections, &clusters}, {matched.get()});
+      return matched;
+    }
+  };
+
+  TrackClusterMatchingConfig make_config() {
+    TrackClusterMatchingConfig cfg;
+    cfg.calorimeterID = "MockCalorimeter_ID";
+    cfg.resolution0 = 0.02;
+    cfg.resolution1 = 0.02;
+    cfg.maxChi2 = 9.;
+    return cfg;
+  }
+
+}
+
+TEST_CASE("tracks are matched with the closest clusters around their projections", "[TrackClusterMatching]") {
+  Event event;
+  auto cfg = make_config();
+
+  SECTION("closest cluster within the window") {
+    event.add_particle(0.5, 1.0);
+    event.add_particle(-0.5, -2.0);
+    event.add_cluster(0.53, 1.0);  // chi2 2.25
+    event.add_cluster(0.51, 1.01); // chi2 0.5
+    event.add_cluster(-0.5, -1.9); // chi2 25
+    auto matched = event.match(cfg);
+    REQUIRE(matched->size() == 2);
+    REQUIRE((*matched)[0].getClusters().size() == 1);
+    REQUIRE((*matched)[0].getClusters()[0] == event.clusters[1]);
+    REQUIRE((*matched)[1].getClusters().empty());
+  }
+
+  SECTION("a cluster goes to the closest of the tracks") {
+    event.add_particle(0.5, 1.0);
+    event.add_particle(0.5, 1.03);
+    event.add_cluster(0.5, 1.02);
+    auto matched = event.match(cfg);
+    REQUIRE((*matched)[0].getClusters().empty());
+    REQUIRE((*matched)[1].getClusters().size() == 1);
+  }
+
+  SECTION("phi wraps around") {
+    event.add_particle(0., M_PI - 0.01);
+    event.add_cluster(0., -M_PI + 0.01);
+    auto matched = event.match(cfg);
+    REQUIRE((*matched)[0].getClusters().size() == 1);
+  }
+
+  SECTION("only the projections to the configured surface are used") {
+    event.add_particle(0., 0., 101, 2);
+    event.add_particle(0., 1., 102, 1);
+    event.add_cluster(0., 0.);
+    event.add_cluster(0., 1.);
+    auto matched = event.match(cfg);
+    REQUIRE((*matched)[0].getClusters().empty());
+    REQUIRE((*matched)[1].getClusters().empty());
+  }
+
+  SECTION("transverse coordinates") {
+    cfg.etaPhi = false;
+    cfg.resolution0 = 5.;
+    cfg.resolution1 = 5.;
+    event.add_particle(0., 0.);
+    event.add_cluster(0., 0.01); // 10 mm in y
+    event.add_cluster(0., 0.02);
+    auto matched = event.match(cfg);
+    REQUIRE((*matched)[0].getClusters().size() == 1);
+    REQUIRE((*matched)[0].getClusters()[0] == event.clusters[0]);
+  }
+}
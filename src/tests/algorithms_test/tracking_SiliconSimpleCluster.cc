@@ -8,16 +8,61 @@
 #include <algorithms/logger.h>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
 #include <edm4eic/RawTrackerHitCollection.h>
 #include <edm4eic/unit_system.h>
 #include <gsl/pointers>
 #include <podio/ObjectID.h>
+#include <cstddef>
+#include <cstdlib>
+#include <random>
 #include <utility>
 #include <vector>
 
 #include "algorithms/fardetectors/FarDetectorTrackerCluster.h"
 #include "algorithms/fardetectors/FarDetectorTrackerClusterConfig.h"
 
+namespace {
+
+struct MockPixel {
+  int x;
+  int y;
+  int charge;
+  int time;
+};
+
+// The hit indices of the clusters as the clustering seeded them before the sweep: at the available hit of
+// highest charge, the first of equal ones, growing by the available neighbours of each hit in input order
+std::vector<std::vector<std::size_t>> argmax_clusters(const std::vector<MockPixel>& pixels, double time_limit) {
+  std::vector<std::vector<std::size_t>> clusters;
+  std::vector<bool> available(pixels.size(), true);
+  while (true) {
+    std::size_t seed = pixels.size();
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+      if (available[i] && (seed == pixels.size() || pixels[i].charge > pixels[seed].charge)) {
+        seed = i;
+      }
+    }
+    if (seed == pixels.size()) {
+      return clusters;
+    }
+    available[seed] = false;
+    auto& cluster   = clusters.emplace_back(1, seed);
+    for (std::size_t next = 0; next < cluster.size(); ++next) {
+      const auto& pixel = pixels[cluster[next]];
+      for (std::size_t i = 0; i < pixels.size(); ++i) {
+        if (available[i] && std::abs(pixels[i].x - pixel.x) <= 1 && std::abs(pixels[i].y - pixel.y) <= 1 &&
+            std::abs(pixels[i].time - pixel.time) < time_limit) {
+          available[i] = false;
+          cluster.push_back(i);
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
 TEST_CASE("the clustering algorithm runs", "[FarDetectorTrackerCluster]") {
   eicrecon::FarDetectorTrackerCluster algo("FarDetectorTrackerCluster");
 
@@ -144,4 +189,39 @@ TEST_CASE("the clustering algorithm runs", "[FarDetectorTrackerCluster]") {
       REQUIRE(clusterPositions.size() == 2);
     }
   }
+
+  SECTION("in the order and with the seeds of the ArgMax clustering") {
+    std::vector<MockPixel> pixels;
+    SECTION("with tied charges of seeds and hits") {
+      // The cluster of the first two hits is seeded at the third one, after the seed of the second cluster
+      pixels = {{0, 0, 1, 0}, {5, 5, 5, 0}, {1, 0, 5, 0}, {1, 1, 5, 0}, {0, 1, 1, 0}};
+    }
+    SECTION("on random hits") {
+      std::mt19937 rng(GENERATE(range(1, 21)));
+      std::uniform_int_distribution<int> position(0, 7);
+      std::uniform_int_distribution<int> charge(1, 3);
+      std::uniform_int_distribution<int> time(0, 2);
+      for (int i = 0; i < 40; ++i) {
+        pixels.push_back({position(rng), position(rng), charge(rng), 8 * time(rng)});
+      }
+    }
+
+    edm4eic::RawTrackerHitCollection hits_coll;
+    for (const auto& pixel : pixels) {
+      hits_coll.create(id_desc.encode({{"system", 255}, {"x", pixel.x}, {"y", pixel.y}}), pixel.charge,
+                       pixel.time);
+    }
+
+    std::vector<FDTrackerCluster> clusterPositions = algo.ClusterHits(hits_coll);
+    auto expected = argmax_clusters(pixels, cfg.hit_time_limit);
+
+    REQUIRE(clusterPositions.size() == expected.size());
+    for (std::size_t c = 0; c < expected.size(); ++c) {
+      REQUIRE(clusterPositions[c].cellID == hits_coll[expected[c][0]].getCellID());
+      REQUIRE(clusterPositions[c].rawHits.size() == expected[c].size());
+      for (std::size_t i = 0; i < expected[c].size(); ++i) {
+        REQUIRE(clusterPositions[c].rawHits[i] == hits_coll[expected[c][i]].getObjectID());
+      }
+    }
+  }
 }
@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <catch2/catch_test_macros.hpp>
+#include <edm4eic/TrackParametersCollection.h>
+#include <edm4hep/Vector2f.h>
+#include <spdlog/common.h>
+#include <spdlog/logger.h>
+#include <spdlog/spdlog.h>
+#include <memory>
+#include <numbers>
+#include <vector>
+
+#include "algorithms/tracking/TrackSeedMerger.h"
+#include "algorithms/tracking/TrackSeedMergerConfig.h"
+
+namespace {
+
+struct MockSeed {
+  float z;
+  float theta;
+  float phi;
+  float qOverP;
+};
+
+edm4eic::TrackParametersCollection make_seeds(const std::vector<MockSeed>& mock_seeds) {
+  edm4eic::TrackParametersCollection seeds;
+  for (const auto& mock : mock_seeds) {
+    auto seed = seeds.create();
+    seed.setLoc(edm4hep::Vector2f{0, mock.z});
+    seed.setTheta(mock.theta);
+    seed.setPhi(mock.phi);
+    seed.setQOverP(mock.qOverP);
+  }
+  return seeds;
+}
+
+// theta of the kept seeds, in the order in which they are kept
+std::vector<float> kept_thetas(const edm4eic::TrackParametersCollection& merged) {
+  std::vector<float> thetas;
+  for (const auto& seed : merged) {
+    thetas.push_back(seed.getTheta());
+  }
+  return thetas;
+}
+
+} // namespace
+
+TEST_CASE("compatible seeds are merged into the first of them", "[TrackSeedMerger]") {
+  std::shared_ptr<spdlog::logger> logger = spdlog::default_logger()->clone("TrackSeedMerger");
+  logger->set_level(spdlog::level::trace);
+
+  eicrecon::TrackSeedMergerConfig cfg;
+  cfg.maxRelDeltaQOverP = 0.1;
+  cfg.maxDeltaTheta     = 0.005;
+  cfg.maxDeltaPhi       = 0.01;
+  cfg.maxDeltaZ         = 5.0;
+
+  eicrecon::TrackSeedMerger algo;
+  algo.applyConfig(cfg);
+  algo.init(logger);
+
+  SECTION("the first seed is kept") {
+    auto seeds  = make_seeds({{1.f, 1.f, 0.5f, 0.5f}, {-1.f, 1.002f, 0.505f, 0.52f}});
+    auto merged = algo.process(seeds);
+    REQUIRE(merged->size() == 1);
+    REQUIRE((*merged)[0].getLoc().b == 1.f);
+    REQUIRE((*merged)[0].getTheta() == 1.f);
+    REQUIRE((*merged)[0].getPhi() == 0.5f);
+    REQUIRE((*merged)[0].getQOverP() == 0.5f);
+    REQUIRE(algo.seedsIn() == 2);
+    REQUIRE(algo.seedsMerged() == 1);
+  }
+
+  SECTION("phi wraps around") {
+    const float pi = std::numbers::pi_v<float>;
+    auto seeds  = make_seeds({{0.f, 1.f, pi - 0.002f, 0.5f}, {0.f, 1.f, -pi + 0.002f, 0.5f}, {0.f, 1.f, -pi + 0.02f, 0.5f}});
+    auto merged = algo.process(seeds);
+    REQUIRE(merged->size() == 2);
+    REQUIRE((*merged)[0].getPhi() == pi - 0.002f);
+    REQUIRE((*merged)[1].getPhi() == -pi + 0.02f);
+  }
+
+  SECTION("opposite charges are not merged") {
+    auto seeds  = make_seeds({{0.f, 1.f, 0.5f, 0.5f}, {0.f, 1.f, 0.5f, -0.5f}, {0.f, 1.f, 0.5f, 0.52f}});
+    auto merged = algo.process(seeds);
+    REQUIRE(merged->size() == 2);
+    REQUIRE((*merged)[0].getQOverP() == 0.5f);
+    REQUIRE((*merged)[1].getQOverP() == -0.5f);
+  }
+
+  SECTION("q/p and z are compared") {
+    auto seeds  = make_seeds({{0.f, 1.f, 0.5f, 0.5f}, {0.f, 1.f, 0.5f, 0.6f}, {6.f, 1.f, 0.5f, 0.5f}});
+    auto merged = algo.process(seeds);
+    REQUIRE(merged->size() == 3);
+  }
+
+  SECTION("the theta window extends in both directions") {
+    // seeds at larger and smaller theta than the first one are merged, those outside of the window are not
+    auto seeds  = make_seeds({{0.f, 1.f, 0.5f, 0.5f},
+                              {0.f, 1.004f, 0.5f, 0.5f},
+                              {0.f, 0.996f, 0.5f, 0.5f},
+                              {0.f, 1.007f, 0.5f, 0.5f},
+                              {0.f, 0.993f, 0.5f, 0.5f}});
+    auto merged = algo.process(seeds);
+    REQUIRE(kept_thetas(*merged) == std::vector<float>{1.f, 1.007f, 0.993f});
+    REQUIRE(algo.seedsMerged() == 2);
+  }
+
+  SECTION("seeds are merged into the kept seed only") {
+    // the third seed is compatible with the second, but not with the first that absorbs the second
+    auto seeds  = make_seeds({{0.f, 1.008f, 0.5f, 0.5f}, {0.f, 1.004f, 0.5f, 0.5f}, {0.f, 1.f, 0.5f, 0.5f}});
+    auto merged = algo.process(seeds);
+    REQUIRE(kept_thetas(*merged) == std::vector<float>{1.008f, 1.f});
+  }
+}
@@ -1,13 +1,51 @@
 #include "GeometryNavigationSteps_processor.h"
 
+#include <Acts/Definitions/Units.hpp>
+#include <Acts/MagneticField/MagneticFieldProvider.hpp>
+#include <Acts/Surfaces/Surface.hpp>
+#include <DD4hep/VolumeManager.h>
 #include <JANA/JApplication.h>
 #include <JANA/JEvent.h>
 #include <JANA/Services/JGlobalRootLock.h>
+#include <edm4hep/SimTrackerHitCollection.h>
+#include <fmt/core.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <random>
 #include <string>
+#include <utility>
 
+#include "algorithms/tracking/DD4hepBField.h"
 #include "services/geometry/acts/ACTSGeo_service.h"
+#include "services/geometry/cellid_cache/CellIDGeometryCacheSvc.h"
+#include "services/geometry/dd4hep/DD4hep_service.h"
 #include "services/rootfile/RootFile_service.h"
 
+namespace {
+
+    /// Nanoseconds per call of the first and of the fastest pass over the points
+    template <typename F>
+    std::pair<double, double> NanosecondsPerCall(std::size_t calls, int repetitions, F&& call) {
+        double first = 0;
+        double best  = std::numeric_limits<double>::max();
+        for (int pass = 0; pass < std::max(repetitions, 1); pass++) {
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < calls; i++) {
+                call(i);
+            }
+            const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / std::max<std::size_t>(calls, 1);
+            if (pass == 0) first = ns;
+            best = std::min(best, ns);
+        }
+        return {first, best};
+    }
+
+}
+
 GeometryNavigationSteps_processor::GeometryNavigationSteps_processor(JApplication *app) :
         JEventProcessor(app)
 {
@@ -35,15 +73,166 @@ void GeometryNavigationSteps_processor::Init()
     // Get log level from user parameter or default
     InitLogger(app, plugin_name);
 
-    auto acts_service = GetApplication()->GetService<ACTSGeo_service>();
+    app->SetDefaultParameter(plugin_name + ":hit_collections", m_hit_collections, "Sim tracker hits whose cells are looked up");
+    app->SetDefaultParameter(plugin_name + ":max_hits", m_max_hits, "Maximum number of hits collected from the events");
+    app->SetDefaultParameter(plugin_name + ":random_points", m_random_points, "Number of random points on random sensors");
+    app->SetDefaultParameter(plugin_name + ":repetitions", m_repetitions, "Passes over the points of every lookup");
+    app->SetDefaultParameter(plugin_name + ":report_file", m_report_file, "JSON file of the timings, none if empty");
+
+    auto dd4hep_service = app->GetService<DD4hep_service>();
+    m_detector  = dd4hep_service->detector();
+    m_converter = dd4hep_service->converter();
 
+    auto acts_service = GetApplication()->GetService<ACTSGeo_service>();
+    m_acts = acts_service->actsGeoProvider();
+    m_geoContext = m_acts->getActsGeometryContext();
 }
 
 
 void GeometryNavigationSteps_processor::Process(const std::shared_ptr<const JEvent>& event)
 {
+    std::vector<Point> points;
+    for (const auto& name : m_hit_collections) {
+        try {
+            const auto* hits = event->GetCollection<edm4hep::SimTrackerHit>(name);
+            for (const auto& hit : *hits) {
+                const auto& pos = hit.getPosition();
+                const auto& mom = hit.getMomentum();
+                Acts::Vector3 position(pos.x, pos.y, pos.z);
+                Acts::Vector3 direction(mom.x, mom.y, mom.z);
+                direction = (direction.norm() > 0) ? direction.normalized() : position.normalized();
+                points.push_back({hit.getCellID(), position, direction});
+            }
+        } catch (const std::exception&) {
+            // no such collection in the input
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const std::size_t n = std::min(points.size(), m_max_hits - std::min(m_max_hits, m_hits.size()));
+    m_hits.insert(m_hits.end(), points.begin(), points.begin() + n);
+}
+
+std::vector<GeometryNavigationSteps_processor::Point> GeometryNavigationSteps_processor::RandomPoints() const
+{
+    std::vector<std::pair<std::uint64_t, const Acts::Surface*>> sensors(m_acts->surfaceMap().begin(), m_acts->surfaceMap().end());
+    std::vector<Point> points;
+    if (sensors.empty()) return points;
+    std::sort(sensors.begin(), sensors.end());
+
+    // volume IDs are the cellIDs of the first cell of the sensors, the points are near their centers
+    std::mt19937_64 generator(1);
+    std::uniform_int_distribution<std::size_t> sensor_index(0, sensors.size() - 1);
+    std::uniform_real_distribution<double> offset(-1. * Acts::UnitConstants::mm, 1. * Acts::UnitConstants::mm);
+    points.reserve(m_random_points);
+    for (std::size_t i = 0; i < m_random_points; i++) {
+        const auto& [volume_id, surface] = sensors[sensor_index(generator)];
+        const Acts::Vector3 center = surface->center(m_geoContext);
+        const Acts::Vector3 direction = (center.norm() > 0) ? center.normalized() : Acts::Vector3(0, 0, 1);
+        const Acts::Vector3 position = surface->localToGlobal(m_geoContext, Acts::Vector2(offset(generator), offset(generator)), direction);
+        points.push_back({volume_id, position, direction});
+    }
+    return points;
+}
+
+void GeometryNavigationSteps_processor::TimePoints(const std::string& name, const std::vector<Point>& points, std::vector<Timing>& timings) const
+{
+    const std::size_t n = points.size();
+    auto time = [&](const std::string& call, auto&& f) {
+        const auto [first, best] = NanosecondsPerCall(n, m_repetitions, f);
+        timings.push_back({call, name, n, first, best});
+    };
+    // accumulated so that the calls are not optimised away
+    double sink = 0;
+
+    time("CellIDPositionConverter::position", [&](std::size_t i) { sink += m_converter->position(points[i].cellID).x(); });
+    time("CellIDPositionConverter::findContext", [&](std::size_t i) { sink += (m_converter->findContext(points[i].cellID) != nullptr); });
+    const auto volman = m_detector->volumeManager();
+    time("VolumeManager::lookupDetElement", [&](std::size_t i) { sink += volman.lookupDetElement(points[i].cellID).volumeID(); });
+
+    auto& cache = eicrecon::CellIDGeometryCacheSvc::instance();
+    time("CellIDGeometryCacheSvc::position", [&](std::size_t i) { sink += cache.position(points[i].cellID).x(); });
+    time("CellIDGeometryCacheSvc::findContext", [&](std::size_t i) { sink += (cache.findContext(points[i].cellID) != nullptr); });
+    time("CellIDGeometryCacheSvc::detElement", [&](std::size_t i) { sink += cache.detElement(points[i].cellID).volumeID(); });
+
+    const auto& surface_map = m_acts->surfaceMap();
+    time("findContext + surfaceMap", [&](std::size_t i) {
+        const auto* context = m_converter->findContext(points[i].cellID);
+        sink += (context != nullptr) && (surface_map.find(context->identifier) != surface_map.end());
+    });
+    time("ActsGeometryProvider::sensorSurface", [&](std::size_t i) { sink += (m_acts->sensorSurface(points[i].cellID) != nullptr); });
+
+    // the surfaces are looked up before the transforms are timed
+    std::vector<const ActsGeometryProvider::SensorSurface*> sensors(n);
+    for (std::size_t i = 0; i < n; i++) sensors[i] = m_acts->sensorSurface(points[i].cellID);
+    std::size_t off_surface = 0;
+    time("Surface::globalToLocal", [&](std::size_t i) {
+        if (sensors[i] == nullptr) return;
+        auto local = sensors[i]->surface->globalToLocal(m_geoContext, points[i].position, points[i].direction);
+        if (local.ok()) {
+            sink += local.value()[0];
+        } else {
+            off_surface++;
+        }
+    });
+    time("SensorSurface::globalToLocal (cached transform)", [&](std::size_t i) {
+        if (sensors[i] == nullptr || !sensors[i]->globalToLocal) return;
+        sink += (*sensors[i]->globalToLocal * points[i].position)[0];
+    });
+
+    const auto field = m_acts->getFieldProvider();
+    auto field_cache = field->makeCache(m_fieldContext);
+    time("DD4hepBField::getField", [&](std::size_t i) {
+        auto value = field->getField(points[i].position, field_cache);
+        if (value.ok()) sink += value.value()[2];
+    });
+    const eicrecon::BField::DD4hepBField direct_field(m_detector);
+    auto direct_cache = direct_field.makeCache(m_fieldContext);
+    time("DD4hepBField::getField (DD4hep, no grid)", [&](std::size_t i) {
+        auto value = direct_field.getField(points[i].position, direct_cache);
+        if (value.ok()) sink += value.value()[2];
+    });
+
+    const std::size_t on_sensors = std::count_if(sensors.begin(), sensors.end(), [](const auto* s) { return s != nullptr; });
+    m_log->info("{} {} points, {} on Acts sensors, {} globalToLocal off the surface (checksum {})",
+                n, name, on_sensors, off_surface / std::max(m_repetitions, 1), sink);
 }
 
 void GeometryNavigationSteps_processor::Finish()
 {
+    std::vector<Timing> timings;
+    if (!m_hits.empty()) {
+        TimePoints("hit", m_hits, timings);
+    } else {
+        m_log->warn("No hits of the collections {}", fmt::join(m_hit_collections, ", "));
+    }
+    const auto random = RandomPoints();
+    if (!random.empty()) {
+        TimePoints("random", random, timings);
+    }
+
+    const auto grid = std::dynamic_pointer_cast<const eicrecon::BField::DD4hepBField>(m_acts->getFieldProvider());
+    m_log->info("Geometry lookups, tracking field {}:", (grid && grid->usesGrid()) ? "on a grid" : "from DD4hep");
+    m_log->info("{:>12} {:>12} {:>8} {:>10}  {}", "first [ns]", "best [ns]", "points", "calls", "call");
+    for (const auto& t : timings) {
+        m_log->info("{:12.1f} {:12.1f} {:>8} {:10}  {}", t.first_ns, t.best_ns, t.points, t.calls, t.call);
+    }
+
+    if (!m_report_file.empty()) {
+        std::ofstream out(m_report_file);
+        out << "{\n";
+        out << fmt::format("  \"field_grid\": {},\n", (grid && grid->usesGrid()) ? "true" : "false");
+        out << "  \"timings\": [";
+        for (std::size_t i = 0; i < timings.size(); ++i) {
+            const auto& t = timings[i];
+            out << fmt::format("{}\n    {{\"call\": \"{}\", \"points\": \"{}\", \"calls\": {}, \"first_ns\": {}, \"best_ns\": {}}}",
+                               i == 0 ? "" : ",", t.call, t.points, t.calls, t.first_ns, t.best_ns);
+        }
+        out << "\n  ]\n}\n";
+        if (out) {
+            m_log->info("Geometry lookup timings written to {}", m_report_file);
+        } else {
+            m_log->error("Can not write the geometry lookup timings to {}", m_report_file);
+        }
+    }
 }
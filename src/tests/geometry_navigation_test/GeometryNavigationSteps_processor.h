@@ -1,16 +1,45 @@
 #pragma once
 
+#include <Acts/Definitions/Algebra.hpp>
 #include <Acts/Geometry/GeometryContext.hpp>
 #include <Acts/MagneticField/MagneticFieldContext.hpp>
+#include <DD4hep/Detector.h>
+#include <DDRec/CellIDPositionConverter.h>
 #include <JANA/JApplication.h>
 #include <JANA/JEvent.h>
 #include <JANA/JEventProcessor.h>
 #include <TDirectory.h>
 #include <spdlog/logger.h>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
+#include "algorithms/tracking/ActsGeometryProvider.h"
 #include "extensions/spdlog/SpdlogMixin.h"
 
+/**
+ * Benchmark of the geometry lookups behind the hit reconstruction and the
+ * tracking. The processor collects the cellIDs and positions of the sim hits
+ * of `geometry_navigation_test:hit_collections`, and at the end of the job
+ * times, for these hits and for random points on random sensors:
+ *
+ *   - `CellIDPositionConverter::position` and `findContext`,
+ *   - `VolumeManager::lookupDetElement`,
+ *   - the same lookups through the CellIDGeometryCacheSvc caches,
+ *   - the Acts surface of a cell, from the `surfaceMap()` of the volume ID
+ *     and from `ActsGeometryProvider::sensorSurface`,
+ *   - `Surface::globalToLocal`, and the cached transform of the sensor,
+ *   - `DD4hepBField::getField` of the tracking field (on its grid with
+ *     `acts:FieldGrid`) and directly from DD4hep.
+ *
+ * Every call is repeated over all the points; the report gives the time per
+ * call of the first pass, in which the caches are filled, and the best of
+ * the `geometry_navigation_test:repetitions` passes. It is logged and
+ * written as JSON to `geometry_navigation_test:report_file` if it is set.
+ */
 class GeometryNavigationSteps_processor:
         public JEventProcessor,
         public eicrecon::SpdlogMixin   // this automates proper log initialization
@@ -47,10 +76,45 @@ public:
 
 private:
 
+    /// A cell and a global point on its sensor, in mm
+    struct Point {
+        std::uint64_t cellID;
+        Acts::Vector3 position;
+        Acts::Vector3 direction;
+    };
+
+    /// Time per call of one lookup over a set of points
+    struct Timing {
+        std::string call;
+        std::string points;
+        std::size_t calls;
+        double first_ns;
+        double best_ns;
+    };
+
+    /// Random points on random sensor surfaces
+    std::vector<Point> RandomPoints() const;
+
+    /// Times all the lookups over the points
+    void TimePoints(const std::string& name, const std::vector<Point>& points, std::vector<Timing>& timings) const;
+
     /// Directory to store histograms to
     TDirectory *m_dir_main{};
     Acts::GeometryContext m_geoContext;
     Acts::MagneticFieldContext m_fieldContext;
-    std::shared_ptr<spdlog::logger> m_log;
+    const dd4hep::Detector* m_detector{nullptr};
+    const dd4hep::rec::CellIDPositionConverter* m_converter{nullptr};
+    std::shared_ptr<const ActsGeometryProvider> m_acts;
+
+    std::vector<std::string> m_hit_collections{
+        "VertexBarrelHits", "SiBarrelHits", "TrackerEndcapHits",
+        "MPGDBarrelHits", "OuterMPGDBarrelHits", "BackwardMPGDEndcapHits", "ForwardMPGDEndcapHits",
+        "TOFBarrelHits", "TOFEndcapHits"};
+    std::size_t m_max_hits{100000};
+    std::size_t m_random_points{100000};
+    int m_repetitions{5};
+    std::string m_report_file;
 
+    std::mutex m_mutex;
+    std::vector<Point> m_hits;
 };
@@ -10,6 +10,7 @@
 #include <fmt/core.h>
 #include <spdlog/logger.h>
 #include <stdint.h>
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -18,6 +19,7 @@
 #include <vector>
 
 #include "extensions/jana/JOmniFactory.h"
+#include "extensions/jana/JOmniFactoryExecutor.h"
 #include "extensions/jana/JOmniFactoryGeneratorT.h"
 
 struct BasicTestAlgConfig {
@@ -419,3 +421,186 @@ TEST_CASE("VariadicPodioOutputTests") {
     REQUIRE(left_hits->size() == 2);
     REQUIRE(right_hits->size() == 1);
 }
+
+struct InputTestAlg : public JOmniFactory<InputTestAlg, BasicTestAlgConfig> {
+
+    Input<edm4hep::SimCalorimeterHit> m_vechits_in {this};
+    PodioInput<edm4hep::SimCalorimeterHit> m_hits_in {this};
+    PodioOutput<edm4hep::SimCalorimeterHit> m_hits_out {this};
+
+    const edm4hep::SimCalorimeterHit* m_seen_vechit = nullptr;
+
+    void Configure() {}
+    void ChangeRun(int64_t run_number) {}
+
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    void Process(int64_t run_number, uint64_t event_number) {
+        REQUIRE(m_vechits_in().size() == 1);
+        REQUIRE(m_vechits_in.at(0) == m_vechits_in()[0]);
+        REQUIRE_THROWS(m_vechits_in.at(1));
+        m_seen_vechit = m_vechits_in()[0];
+
+        m_hits_out() = std::make_unique<edm4hep::SimCalorimeterHitCollection>();
+        m_hits_out()->setSubsetCollection();
+        for (const auto& hit : *m_hits_in()) {
+            m_hits_out()->push_back(hit);
+        }
+    }
+};
+
+TEST_CASE("Inputs are views of the objects of their producers") {
+    JApplication app;
+    app.AddPlugin("log");
+
+    app.Add(new JOmniFactoryGeneratorT<BasicTestAlg>("BasicTest", {}, {"left_hits", "right_hits", "vec_hits"}, &app));
+    app.Add(new JOmniFactoryGeneratorT<InputTestAlg>("InputTest", {"vec_hits", "all_hits"}, {"processed_hits"}, &app));
+    app.Initialize();
+
+    auto event = std::make_shared<JEvent>();
+    app.GetService<JComponentManager>()->configure_event(*event);
+
+    edm4hep::SimCalorimeterHitCollection all_hits;
+    all_hits.create();
+    all_hits.create();
+    event->InsertCollection<edm4hep::SimCalorimeterHit>(std::move(all_hits), "all_hits");
+
+    auto processed = event->GetCollection<edm4hep::SimCalorimeterHit>("processed_hits");
+    REQUIRE(processed->size() == 2);
+
+    auto input_test = RetrieveMultifactory<edm4hep::SimCalorimeterHit,InputTestAlg>(event->GetFactorySet(), "processed_hits");
+    auto vec_hits = event->Get<edm4hep::SimCalorimeterHit>("vec_hits");
+    REQUIRE(vec_hits.size() == 1);
+    REQUIRE(input_test->m_seen_vechit == vec_hits[0]);
+}
+
+struct MergeTestAlgConfig {
+    double scale = 1.;
+    bool operator==(const MergeTestAlgConfig&) const = default;
+};
+
+struct MergeTestAlg : public JOmniFactory<MergeTestAlg, MergeTestAlgConfig> {
+
+    PodioInput<edm4hep::SimCalorimeterHit> m_hits_in {this};
+    PodioOutput<edm4hep::SimCalorimeterHit> m_hits_out {this};
+
+    ParameterRef<double> m_scale {this, "scale", config().scale, "Scale of the energies"};
+
+    // the factories of an event may run on several threads, see omnifactory:IntraEventThreads
+    static inline std::atomic<int> s_init_count{0};
+    static inline std::atomic<int> s_process_count{0};
+
+    void Configure() { s_init_count++; }
+    void ChangeRun(int64_t run_number) {}
+
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    void Process(int64_t run_number, uint64_t event_number) {
+        s_process_count++;
+        for (const auto& hit : *m_hits_in()) {
+            auto out = m_hits_out()->create();
+            out.setEnergy(hit.getEnergy() * config().scale);
+        }
+    }
+};
+
+TEST_CASE("Identical wirings alias the collections of the first one") {
+    JApplication app;
+    app.AddPlugin("log");
+    app.SetParameterValue("omnifactory:MergeIdenticalWirings", true);
+    app.SetParameterValue("MergeTestC:scale", 2.);
+
+    app.Add(new JOmniFactoryGeneratorT<MergeTestAlg>("MergeTestA", {"all_hits"}, {"hits_a"}, &app));
+    app.Add(new JOmniFactoryGeneratorT<MergeTestAlg>("MergeTestB", {"all_hits"}, {"hits_b"}, &app));
+    app.Add(new JOmniFactoryGeneratorT<MergeTestAlg>("MergeTestC", {"all_hits"}, {"hits_c"}, &app));
+    // identical once hits_b is an alias of hits_a
+    app.Add(new JOmniFactoryGeneratorT<MergeTestAlg>("MergeTestD", {"hits_a"}, {"hits_d"}, &app));
+    app.Add(new JOmniFactoryGeneratorT<MergeTestAlg>("MergeTestE", {"hits_b"}, {"hits_e"}, &app));
+    app.Initialize();
+
+    auto event = std::make_shared<JEvent>();
+    app.GetService<JComponentManager>()->configure_event(*event);
+
+    edm4hep::SimCalorimeterHitCollection all_hits;
+    all_hits.create().setEnergy(1.);
+    all_hits.create().setEnergy(3.);
+    event->InsertCollection<edm4hep::SimCalorimeterHit>(std::move(all_hits), "all_hits");
+
+    MergeTestAlg::s_init_count = 0;
+    MergeTestAlg::s_process_count = 0;
+    auto hits_a = event->GetCollection<edm4hep::SimCalorimeterHit>("hits_a");
+    auto hits_b = event->GetCollection<edm4hep::SimCalorimeterHit>("hits_b");
+    auto hits_c = event->GetCollection<edm4hep::SimCalorimeterHit>("hits_c");
+    auto hits_d = event->GetCollection<edm4hep::SimCalorimeterHit>("hits_d");
+    auto hits_e = event->GetCollection<edm4hep::SimCalorimeterHit>("hits_e");
+
+    REQUIRE(!hits_a->isSubsetCollection());
+    REQUIRE(hits_b->isSubsetCollection());
+    REQUIRE(hits_b->size() == 2);
+    REQUIRE((*hits_b)[1] == (*hits_a)[1]);
+
+    // a different parameter is a different wiring
+    REQUIRE(!hits_c->isSubsetCollection());
+    REQUIRE((*hits_c)[1].getEnergy() == 6.);
+
+    REQUIRE(hits_e->isSubsetCollection());
+    REQUIRE((*hits_e)[0] == (*hits_d)[0]);
+
+    // A, C and D
+    REQUIRE(MergeTestAlg::s_init_count == 3);
+    REQUIRE(MergeTestAlg::s_process_count == 3);
+}
+
+struct JoinTestAlg : public JOmniFactory<JoinTestAlg> {
+
+    PodioInput<edm4hep::SimCalorimeterHit> m_left_in {this};
+    PodioInput<edm4hep::SimCalorimeterHit> m_right_in {this};
+    PodioOutput<edm4hep::SimCalorimeterHit> m_hits_out {this};
+
+    static inline std::atomic<int> s_process_count{0};
+
+    void Configure() {}
+    void ChangeRun(int64_t run_number) {}
+
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    void Process(int64_t run_number, uint64_t event_number) {
+        s_process_count++;
+        for (size_t i = 0; i < m_left_in()->size(); ++i) {
+            auto out = m_hits_out()->create();
+            out.setEnergy((*m_left_in())[i].getEnergy() + (*m_right_in())[i].getEnergy());
+        }
+    }
+};
+
+TEST_CASE("The factories of an event run ahead of the requests on the shared threads") {
+    JApplication app;
+    app.AddPlugin("log");
+    app.SetParameterValue("omnifactory:IntraEventThreads", 2);
+    app.SetParameterValue("ExecTestB:scale", 2.);
+
+    app.Add(new JOmniFactoryGeneratorT<MergeTestAlg>("ExecTestA", {"all_hits"}, {"exec_a"}, &app));
+    app.Add(new JOmniFactoryGeneratorT<MergeTestAlg>("ExecTestB", {"all_hits"}, {"exec_b"}, &app));
+    app.Add(new JOmniFactoryGeneratorT<JoinTestAlg>("ExecTestJoin", {"exec_a", "exec_b"}, {"exec_joined"}, &app));
+    // its input is not a collection of the event, so it is left to run on request
+    app.Add(new JOmniFactoryGeneratorT<MergeTestAlg>("ExecTestMissing", {"missing_hits"}, {"exec_missing"}, &app));
+    app.Initialize();
+
+    auto event = std::make_shared<JEvent>();
+    app.GetService<JComponentManager>()->configure_event(*event);
+
+    edm4hep::SimCalorimeterHitCollection all_hits;
+    all_hits.create().setEnergy(1.);
+    all_hits.create().setEnergy(3.);
+    event->InsertCollection<edm4hep::SimCalorimeterHit>(std::move(all_hits), "all_hits");
+
+    MergeTestAlg::s_process_count = 0;
+    JoinTestAlg::s_process_count = 0;
+    eicrecon::JOmniFactoryExecutor::instance().Prefetch(&app, event);
+    REQUIRE(MergeTestAlg::s_process_count == 2);
+    REQUIRE(JoinTestAlg::s_process_count == 1);
+
+    // the requests find the collections made
+    auto joined = event->GetCollection<edm4hep::SimCalorimeterHit>("exec_joined");
+    REQUIRE(joined->size() == 2);
+    REQUIRE((*joined)[1].getEnergy() == 9.);
+    REQUIRE(MergeTestAlg::s_process_count == 2);
+    REQUIRE(JoinTestAlg::s_process_count == 1);
+}
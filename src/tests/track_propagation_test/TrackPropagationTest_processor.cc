@@ -1,9 +1,19 @@
 
+#include <Acts/ActsVersion.hpp>
 #include <Acts/Definitions/Algebra.hpp>
+#include <Acts/MagneticField/MagneticFieldContext.hpp>
+#include <Acts/MagneticField/MagneticFieldProvider.hpp>
+#include <Acts/Propagator/EigenStepper.hpp>
+#include <Acts/Propagator/Navigator.hpp>
+#include <Acts/Propagator/Propagator.hpp>
+#include <Acts/Propagator/StraightLineStepper.hpp>
+#include <Acts/Surfaces/CylinderSurface.hpp>
 #include <Acts/Surfaces/DiscSurface.hpp>
 #include <Acts/Surfaces/RadialBounds.hpp>
 #include <Acts/Surfaces/Surface.hpp>
 #include <ActsExamples/EventData/Trajectories.hpp>
+#include <DD4hep/DD4hepUnits.h>
+#include <DD4hep/Detector.h>
 #include <JANA/JApplication.h>
 #include <JANA/JEvent.h>
 #include <JANA/JException.h>
@@ -15,10 +25,13 @@
 #include <spdlog/logger.h>
 #include <stddef.h>
 #include <Eigen/Geometry>
+#include <algorithm>
+#include <chrono>
 #include <exception>
 #include <gsl/pointers>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "TrackPropagationTest_processor.h"
@@ -27,6 +40,36 @@
 #include "services/rootfile/RootFile_service.h"
 
 
+namespace {
+
+    /// Field of the timed propagators, counts the lookups of every thread
+    class CountingField final : public Acts::MagneticFieldProvider {
+    public:
+        explicit CountingField(std::shared_ptr<const Acts::MagneticFieldProvider> field) : m_field(std::move(field)) {}
+
+        Acts::MagneticFieldProvider::Cache makeCache(const Acts::MagneticFieldContext& mctx) const override {
+            return m_field->makeCache(mctx);
+        }
+
+        Acts::Result<Acts::Vector3> getField(const Acts::Vector3& position, Acts::MagneticFieldProvider::Cache& cache) const override {
+            ++s_lookups;
+            return m_field->getField(position, cache);
+        }
+
+        Acts::Result<Acts::Vector3> getFieldGradient(const Acts::Vector3& position, Acts::ActsMatrix<3, 3>& derivative,
+                                                     Acts::MagneticFieldProvider::Cache& cache) const override {
+            ++s_lookups;
+            return m_field->getFieldGradient(position, derivative, cache);
+        }
+
+        static std::uint64_t lookups() { return s_lookups; }
+
+    private:
+        std::shared_ptr<const Acts::MagneticFieldProvider> m_field;
+        static inline thread_local std::uint64_t s_lookups{0};
+    };
+
+}
 
 
 //------------------
@@ -77,6 +120,99 @@ void TrackPropagationTest_processor::Init()
     auto hcalEndcapNBounds = std::make_shared<Acts::RadialBounds>(hcalEndcapNMinR, hcalEndcapNMaxR);
     auto hcalEndcapNTrf = transform * Acts::Translation3(Acts::Vector3(0, 0, hcalEndcapNZ));
     m_hcal_surface = Acts::Surface::makeShared<Acts::DiscSurface>(hcalEndcapNTrf, hcalEndcapNBounds);
+
+    app->SetDefaultParameter(plugin_name + ":Timing", m_timing, "Time the propagation in several stepper and navigator configurations");
+    app->SetDefaultParameter(plugin_name + ":TimingConfigurations", m_timing_configurations, "Configurations to time: TrackPropagation, EigenStepper, EigenStepper+Navigator, EigenStepper+maxStep, StraightLineStepper");
+    app->SetDefaultParameter(plugin_name + ":TimingMaxStepSize", m_timing_max_step_size, "Maximum step size of EigenStepper+maxStep [mm]");
+    if (m_timing) {
+        InitTiming();
+    }
+}
+
+
+//------------------
+// InitTiming
+//------------------
+void TrackPropagationTest_processor::InitTiming()
+{
+    auto *app = GetApplication();
+    const dd4hep::Detector* detector = app->GetService<DD4hep_service>()->detector();
+    auto geo = app->GetService<ACTSGeo_service>()->actsGeoProvider();
+
+    // a reference cylinder at the barrel ECal, as the calorimeter track projections
+    double barrel_r = 1000.;
+    double barrel_half_z = 3000.;
+    try {
+        barrel_r = detector->constantAsDouble("EcalBarrel_rmin") / dd4hep::mm;
+        barrel_half_z = 1.1 * std::max(detector->constantAsDouble("EcalBarrelBackward_zmax"),
+                                       detector->constantAsDouble("EcalBarrelForward_zmax")) / dd4hep::mm;
+    } catch (std::exception &e) {
+        m_log->warn("No barrel ECal constants, the timing cylinder has r = {} mm: {}", barrel_r, e.what());
+    }
+    auto barrel_surface = Acts::Surface::makeShared<Acts::CylinderSurface>(Acts::Transform3::Identity(), barrel_r, barrel_half_z);
+    m_timing_surfaces = {{"HcalEndcapN disc", m_hcal_surface}, {"EcalBarrel cylinder", barrel_surface}};
+
+    const Acts::GeometryContext geo_context = geo->getActsGeometryContext();
+    const Acts::MagneticFieldContext field_context;
+    auto field = std::make_shared<CountingField>(geo->getFieldProvider());
+
+    // the propagators are shared by the threads, Propagator::propagate() is const
+    auto make = [&](auto propagator, double max_step_size) {
+        auto shared = std::make_shared<decltype(propagator)>(std::move(propagator));
+        return [shared, geo_context, field_context, max_step_size](const ActsExamples::Trajectories&, const Acts::BoundTrackParameters& parameters,
+                                                                  const std::shared_ptr<const Acts::Surface>& surface) {
+            Acts::PropagatorOptions<> options(geo_context, field_context);
+            if (max_step_size > 0) {
+#if Acts_VERSION_MAJOR >= 36
+                options.stepping.maxStepSize = max_step_size;
+#else
+                options.maxStepSize = max_step_size;
+#endif
+            }
+            auto result = shared->propagate(parameters, *surface, options);
+            return result.ok() ? Outcome{true, true, (*result).steps} : Outcome{false, true, 0};
+        };
+    };
+
+    using Navigator = Acts::Navigator;
+    for (const auto& name : m_timing_configurations) {
+        Configuration config{name, {}, nullptr, nullptr};
+        if (name == "TrackPropagation") {
+            config.propagate = [this](const ActsExamples::Trajectories& trajectory, const Acts::BoundTrackParameters&,
+                                      const std::shared_ptr<const Acts::Surface>& surface) {
+                return Outcome{m_propagation_algo.propagate(edm4eic::Track{}, &trajectory, surface) != nullptr, false, 0};
+            };
+        } else if (name == "EigenStepper") {
+            config.propagate = make(Acts::Propagator<Acts::EigenStepper<>>(Acts::EigenStepper<>(field)), 0.);
+        } else if (name == "EigenStepper+Navigator") {
+            Navigator::Config cfg{geo->trackingGeometry()};
+            cfg.resolvePassive   = false;
+            cfg.resolveMaterial  = true;
+            cfg.resolveSensitive = true;
+            config.propagate = make(Acts::Propagator<Acts::EigenStepper<>, Navigator>(Acts::EigenStepper<>(field), Navigator(cfg)), 0.);
+        } else if (name == "EigenStepper+maxStep") {
+            config.propagate = make(Acts::Propagator<Acts::EigenStepper<>>(Acts::EigenStepper<>(field)), m_timing_max_step_size);
+        } else if (name == "StraightLineStepper") {
+            config.propagate = make(Acts::Propagator<Acts::StraightLineStepper>(Acts::StraightLineStepper()), 0.);
+        } else {
+            m_log->warn("Unknown propagation timing configuration '{}'", name);
+            continue;
+        }
+
+        auto root_file_service = app->GetService<RootFile_service>();
+        auto globalRootLock = app->GetService<JGlobalRootLock>();
+        globalRootLock->acquire_write_lock();
+        m_dir_main->cd();
+        auto *track_time = new TH1D(fmt::format("track_time_{}", m_configurations.size()).c_str(),
+                                    fmt::format("{};time per track [#mus];tracks", name).c_str(), 500, 0., 5000.);
+        auto *track_steps = new TH1D(fmt::format("track_steps_{}", m_configurations.size()).c_str(),
+                                     fmt::format("{};steps per track;tracks", name).c_str(), 500, 0., 5000.);
+        globalRootLock->release_lock();
+        config.track_time = root_file_service->MakeThreadLocal(track_time);
+        config.track_steps = root_file_service->MakeThreadLocal(track_steps);
+        m_configurations.push_back(std::move(config));
+    }
+    m_stats.resize(m_configurations.size() * m_timing_surfaces.size());
 }
 
 
@@ -117,6 +253,63 @@ void TrackPropagationTest_processor::Process(const std::shared_ptr<const JEvent>
         auto length =  projection_point->pathlength;
         m_log->trace("   {:>10} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f}", traj_index, pos.x, pos.y, pos.z, length);
     }
+
+    if (m_timing) {
+        std::vector<Stats> stats(m_stats.size());
+        for (const auto* trajectory : trajectories) {
+            TimeTrajectory(*trajectory, stats);
+        }
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        for (size_t i = 0; i < stats.size(); i++) {
+            m_stats[i].calls += stats[i].calls;
+            m_stats[i].ok += stats[i].ok;
+            m_stats[i].ns += stats[i].ns;
+            m_stats[i].steps += stats[i].steps;
+            m_stats[i].field_lookups += stats[i].field_lookups;
+            m_stats[i].counted = m_stats[i].counted || stats[i].counted;
+        }
+    }
+}
+
+
+//------------------
+// TimeTrajectory
+//------------------
+void TrackPropagationTest_processor::TimeTrajectory(const ActsExamples::Trajectories& trajectory, std::vector<Stats>& stats) const
+{
+    const auto &tips = trajectory.tips();
+    if (tips.empty() || !trajectory.hasTrackParameters(tips.front())) {
+        return;
+    }
+    const auto &parameters = trajectory.trackParameters(tips.front());
+
+    for (size_t c = 0; c < m_configurations.size(); c++) {
+        const auto &config = m_configurations[c];
+        std::uint64_t track_ns = 0;
+        std::uint64_t track_steps = 0;
+        bool counted = false;
+        for (size_t s = 0; s < m_timing_surfaces.size(); s++) {
+            const std::uint64_t lookups = CountingField::lookups();
+            const auto start = std::chrono::steady_clock::now();
+            const Outcome outcome = config.propagate(trajectory, parameters, m_timing_surfaces[s].second);
+            const std::uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+            auto &stat = stats[c * m_timing_surfaces.size() + s];
+            stat.calls++;
+            stat.ok += outcome.ok;
+            stat.ns += ns;
+            stat.steps += outcome.steps;
+            stat.field_lookups += CountingField::lookups() - lookups;
+            stat.counted = outcome.counted;
+            track_ns += ns;
+            track_steps += outcome.steps;
+            counted = outcome.counted;
+        }
+        config.track_time->Get()->Fill(track_ns * 1e-3);
+        if (counted) {
+            config.track_steps->Get()->Fill(track_steps);
+        }
+    }
 }
 
 
@@ -127,4 +320,22 @@ void TrackPropagationTest_processor::Finish()
 {
 //    m_log->trace("TrackPropagationTest_processor finished\n");
 
+    if (!m_timing) {
+        return;
+    }
+    m_log->info("Propagation timing, per propagation:");
+    m_log->info("{:>24} {:>20} {:>8} {:>6} {:>10} {:>8} {:>10}", "configuration", "surface", "calls", "ok", "time [us]", "steps", "field");
+    for (size_t c = 0; c < m_configurations.size(); c++) {
+        for (size_t s = 0; s < m_timing_surfaces.size(); s++) {
+            const auto &stat = m_stats[c * m_timing_surfaces.size() + s];
+            const double calls = std::max<std::uint64_t>(stat.calls, 1);
+            if (stat.counted) {
+                m_log->info("{:>24} {:>20} {:8} {:5.1f}% {:10.2f} {:8.1f} {:10.1f}", m_configurations[c].name, m_timing_surfaces[s].first,
+                            stat.calls, 100. * stat.ok / calls, stat.ns * 1e-3 / calls, stat.steps / calls, stat.field_lookups / calls);
+            } else {
+                m_log->info("{:>24} {:>20} {:8} {:5.1f}% {:10.2f} {:>8} {:>10}", m_configurations[c].name, m_timing_surfaces[s].first,
+                            stat.calls, 100. * stat.ok / calls, stat.ns * 1e-3 / calls, "-", "-");
+            }
+        }
+    }
 }
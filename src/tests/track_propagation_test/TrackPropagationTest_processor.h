@@ -1,14 +1,43 @@
 #pragma once
 
+#include <Acts/EventData/TrackParameters.hpp>
 #include <Acts/Surfaces/DiscSurface.hpp>
+#include <Acts/Surfaces/Surface.hpp>
 #include <JANA/JApplication.h>
 #include <JANA/JEvent.h>
 #include <JANA/JEventProcessor.h>
 #include <TDirectory.h>
+#include <TH1.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include "algorithms/tracking/TrackPropagation.h"
 #include "extensions/spdlog/SpdlogMixin.h"
+#include "services/rootfile/ThreadLocalHist.h"
+
+/**
+ * Propagates the CKF trajectories to an HCal disc. With
+ * `-Ptrack_propagation_test:Timing=true` it also times the propagation of
+ * every trajectory to the surfaces of several types: the disc of the
+ * electron-endcap HCal and the cylinder of the barrel ECal. It does this
+ * with TrackPropagation and with the alternative steppers and navigators of
+ * `track_propagation_test:TimingConfigurations`:
+ *
+ *   - `TrackPropagation`: the algorithm itself, i.e. EigenStepper and no navigator,
+ *   - `EigenStepper`: the same propagator, with the steps and field lookups counted,
+ *   - `EigenStepper+Navigator`: navigation through the tracking geometry,
+ *   - `EigenStepper+maxStep`: steps of at most `track_propagation_test:TimingMaxStepSize`,
+ *   - `StraightLineStepper`: no field, the lower bound of the cost.
+ *
+ * The time, the steps and the field lookups of every configuration and
+ * surface are logged at the end of the job, and the time and the steps per
+ * track are histogrammed.
+ */
 
 class TrackPropagationTest_processor:
         public JEventProcessor,
@@ -54,4 +83,46 @@ private:
 
     /// A surface to propagate to
     std::shared_ptr<Acts::DiscSurface> m_hcal_surface;
+
+    /// Outcome of a timed propagation, steps and field lookups if counted
+    struct Outcome {
+        bool ok{false};
+        bool counted{false};
+        std::size_t steps{0};
+    };
+
+    /// A propagator to time
+    struct Configuration {
+        std::string name;
+        std::function<Outcome(const ActsExamples::Trajectories&, const Acts::BoundTrackParameters&, const std::shared_ptr<const Acts::Surface>&)> propagate;
+        std::shared_ptr<eicrecon::ThreadLocalHist<TH1D>> track_time;
+        std::shared_ptr<eicrecon::ThreadLocalHist<TH1D>> track_steps;
+    };
+
+    /// Sums over the propagations of a configuration to a surface
+    struct Stats {
+        std::uint64_t calls{0};
+        std::uint64_t ok{0};
+        std::uint64_t ns{0};
+        std::uint64_t steps{0};
+        std::uint64_t field_lookups{0};
+        bool counted{false};
+    };
+
+    /// Makes the propagators to time and the surfaces of the timing
+    void InitTiming();
+
+    /// Times the propagation of a trajectory in every configuration
+    void TimeTrajectory(const ActsExamples::Trajectories& trajectory, std::vector<Stats>& stats) const;
+
+    bool m_timing{false};
+    std::vector<std::string> m_timing_configurations{
+        "TrackPropagation", "EigenStepper", "EigenStepper+Navigator", "EigenStepper+maxStep", "StraightLineStepper"};
+    double m_timing_max_step_size{50.}; // mm
+    std::vector<std::pair<std::string, std::shared_ptr<const Acts::Surface>>> m_timing_surfaces;
+    std::vector<Configuration> m_configurations;
+
+    /// Of every configuration and surface, surface index fastest
+    std::mutex m_stats_mutex;
+    std::vector<Stats> m_stats;
 };
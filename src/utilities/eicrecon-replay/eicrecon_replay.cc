@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+// Replays a single factory on the inputs recorded by the janareplay plugin:
+//
+//   eicrecon -Pplugins=janareplay -Pjanareplay:record=<factory prefix> sim.edm4hep.root
+//   eicrecon-replay [-n <iterations>] [-t <threads>[,<threads>...]] [-Pkey=value ...] janareplay.root
+//
+// Only the replayed factory runs, on the recorded collections, with the
+// parameters of the recording job. With several thread counts, every count is
+// run in its own process, one after the other.
+
+#include <JANA/JApplication.h>
+#include <JANA/Services/JParameterManager.h>
+#include <podio/Frame.h>
+#include <podio/ROOTFrameReader.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  void PrintUsage() {
+    std::cout << "Usage: eicrecon-replay [options] <file written by janareplay:record>\n"
+              << "Options:\n"
+              << "  -n <iterations>          calls of the factory per event (default 100)\n"
+              << "  -t <threads>[,<threads>] numbers of threads to run with (default 1)\n"
+              << "  -e <events>              number of recorded events to replay (default all)\n"
+              << "  -Pkey=value              override a recorded parameter\n" << std::endl;
+  }
+
+  std::vector<std::string> Split(const std::string& list, char separator) {
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, separator)) {
+      if (!item.empty()) {
+        items.push_back(item);
+      }
+    }
+    return items;
+  }
+
+  /// The parameters of the recording job, see JEventProcessorJANARECORD
+  std::map<std::string, std::string> ReadRecordedParameters(const std::string& file) {
+    podio::ROOTFrameReader reader;
+    reader.openFile(file);
+    if (reader.getEntries("janareplay") == 0) {
+      throw std::runtime_error(file + " has no janareplay configuration, was it written by janareplay:record?");
+    }
+    podio::Frame configuration(reader.readNextEntry("janareplay"));
+    std::map<std::string, std::string> parameters;
+    for (const auto& key : configuration.getParameterKeys<std::string>()) {
+      parameters[key] = configuration.getParameter<std::string>(key);
+    }
+    return parameters;
+  }
+
+  int Run(const std::string& file, std::map<std::string, std::string> parameters, int nthreads) {
+    // drop the profiling plugins of the recording job
+    std::string plugins;
+    for (const auto& plugin : Split(parameters["plugins"], ',')) {
+      if (plugin != "janatop" && plugin != "janatrace" && plugin != "janareplay") {
+        plugins += plugin + ",";
+      }
+    }
+    parameters["plugins"] = plugins + "janareplay";
+    parameters["nthreads"] = std::to_string(nthreads);
+    // the podio writer is loaded with the podio source, keep its output small
+    parameters.try_emplace("podio:output_file", "eicrecon-replay.podio.root");
+    parameters.try_emplace("podio:output_collections", "EventHeader");
+    // as eicrecon, the replay loop makes the events long
+    parameters.try_emplace("jana:timeout", "180");
+    parameters.try_emplace("jana:warmup_timeout", "180");
+
+    auto* para_mgr = new JParameterManager(); // owned by the JApplication
+    for (const auto& [key, value] : parameters) {
+      para_mgr->SetParameter(key, value);
+    }
+    japp = new JApplication(para_mgr);
+    japp->Add(file);
+    japp->Run();
+    auto exit_code = static_cast<int>(japp->GetExitCode());
+    delete japp;
+    return exit_code;
+  }
+
+} // namespace
+
+int main(int narg, char** argv) {
+  std::string file;
+  std::string iterations = "100";
+  std::vector<int> threads;
+  std::map<std::string, std::string> overrides;
+
+  for (int i = 1; i < narg; i++) {
+    std::string arg = argv[i];
+    if (arg == "-h" || arg == "--help") {
+      PrintUsage();
+      return 0;
+    } else if ((arg == "-n" || arg == "-t" || arg == "-e") && i + 1 < narg) {
+      std::string value = argv[++i];
+      if (arg == "-n") {
+        iterations = value;
+      } else if (arg == "-t") {
+        for (const auto& n : Split(value, ',')) {
+          threads.push_back(std::stoi(n));
+        }
+      } else {
+        overrides["jana:nevents"] = value;
+      }
+    } else if (arg.rfind("-P", 0) == 0 && arg.find('=') != std::string::npos) {
+      auto pos = arg.find('=');
+      overrides[arg.substr(2, pos - 2)] = arg.substr(pos + 1);
+    } else if (arg[0] != '-' && file.empty()) {
+      file = arg;
+    } else {
+      PrintUsage();
+      return EXIT_FAILURE;
+    }
+  }
+  if (file.empty()) {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+  if (threads.empty()) {
+    threads.push_back(1);
+  }
+
+  std::map<std::string, std::string> parameters;
+  try {
+    parameters = ReadRecordedParameters(file);
+  } catch (std::exception& e) {
+    std::cout << "eicrecon-replay: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  parameters["janareplay:iterations"] = iterations;
+  for (const auto& [key, value] : overrides) {
+    parameters[key] = value;
+  }
+  std::cout << "eicrecon-replay: replaying " << parameters["janareplay:factory"] << " from " << file << std::endl;
+
+  int exit_code = EXIT_SUCCESS;
+  for (int nthreads : threads) {
+    // a JApplication per process, the plugins and services are not meant to be set up twice
+    pid_t pid = fork();
+    if (pid < 0) {
+      std::cout << "eicrecon-replay: fork failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (pid == 0) {
+      std::exit(Run(file, parameters, nthreads));
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      std::cout << "eicrecon-replay: run with " << nthreads << " threads failed" << std::endl;
+      exit_code = EXIT_FAILURE;
+    }
+  }
+  return exit_code;
+}
@@ -0,0 +1,13 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include "StaticPlugins.h"
+
+namespace jana {
+
+    // eicrecon loads all of its plugins from the plugin paths
+    std::span<const StaticPlugin> GetStaticPlugins() {
+        return {};
+    }
+
+}
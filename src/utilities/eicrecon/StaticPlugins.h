@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <span>
+
+class JApplication;
+
+namespace jana {
+
+    /// A plugin linked into the executable, with its renamed InitPlugin
+    struct StaticPlugin {
+        const char* name;
+        void (*init)(JApplication*);
+    };
+
+    /// The plugins of EICRECON_STATIC_PLUGINS in eicrecon_static, none in eicrecon.
+    /// The table of eicrecon_static is generated from StaticPlugins.cc.in.
+    std::span<const StaticPlugin> GetStaticPlugins();
+
+}
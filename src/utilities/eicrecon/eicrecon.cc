@@ -3,6 +3,7 @@
 //
 //
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -18,6 +19,9 @@ std::vector<std::string> EICRECON_DEFAULT_PLUGINS = {
         "acts",
         "algorithms_init",
         "evaluator",
+        "cellid_cache",
+        "disk_cache",
+        "neighbour_table",
         "pid_lut",
         "richgeo",
         "rootfile",
@@ -51,12 +55,49 @@ std::vector<std::string> EICRECON_DEFAULT_PLUGINS = {
         "janatop",
 };
 
+/// The plugins of --profile=fastsim: the parametrised chain of the fastsim plugin from the
+/// MC particles, with the services that do not need the geometry (no dd4hep, acts or richgeo)
+std::vector<std::string> EICRECON_FASTSIM_PLUGINS = {
+
+        "log",
+        "algorithms_init",
+        "pid_lut",
+        "fastsim",
+        "podio",
+};
+
+/// The defaults of the parameters of --profile=fastsim, which only reads the MC particles and
+/// reads and writes the events in batches next to the worker threads
+std::map<std::string, std::string> EICRECON_FASTSIM_PARAMETERS = {
+
+        {"podio:input_include_collections", "EventHeader,MCParticles"},
+        {"podio:prefetch", "256"},
+        {"podio:async_write", "256"},
+        {"podio:output_collections",
+         "EventHeader,MCParticles,GeneratedParticles,"
+         "ReconstructedParticles,ReconstructedParticleAssociations,"
+         "ReconstructedChargedParticles,ReconstructedChargedParticleAssociations,"
+         "RICHEndcapNParticleIDs,CombinedTOFParticleIDs,DIRCParticleIDs,DRICHParticleIDs,"
+         "FastSimEcalClusters,ReconstructedElectrons,ScatteredElectronsTruth,HadronicFinalState,"
+         "InclusiveKinematicsTruth,InclusiveKinematicsElectron,InclusiveKinematicsJB,"
+         "InclusiveKinematicsDA,InclusiveKinematicseSigma,InclusiveKinematicsSigma,"
+         "GeneratedJets,GeneratedChargedJets,ReconstructedJets,ReconstructedChargedJets"},
+};
+
 int main( int narg, char **argv)
 {
-    std::vector<std::string> default_plugins = EICRECON_DEFAULT_PLUGINS;
+    const std::map<std::string, jana::Profile> profiles = {
+        {"default", {EICRECON_DEFAULT_PLUGINS, {}}},
+        {"fastsim", {EICRECON_FASTSIM_PLUGINS, EICRECON_FASTSIM_PARAMETERS}},
+    };
 
     auto options = jana::GetCliOptions(narg, argv, false);
 
+    const auto* profile = jana::SelectProfile(options, profiles);
+    if (profile == nullptr)
+        return -1;
+    std::vector<std::string> default_plugins = profile->plugins;
+
     if (jana::HasPrintOnlyCliOptions(options, default_plugins))
         return -1;
 
@@ -8,22 +8,40 @@
 #include <JANA/CLI/JSignalHandler.h>
 #include <JANA/CLI/JVersion.h>
 #include <JANA/Services/JComponentManager.h>
+#include <fmt/core.h>
+#include <fmt/format.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <exception>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string.h>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "JANA/JApplication.h"
 #include "JANA/JEventSource.h"
 #include "JANA/JException.h"
 #include "JANA/Services/JParameterManager.h"
+#include "extensions/jana/JOmniFactoryMetrics.h"
+#include "StaticPlugins.h"
 #include "print_info.h"
+#include "services/algorithms_init/ParallelInit.h"
 
 #define QUOTE(name) #name
 #define STR(macro) QUOTE(macro)
@@ -46,8 +64,14 @@ void PrintUsageOptions() {
             << std::endl;
   std::cout << "   -d   --dumpconfigs <file>    Dump configuration parameters to file" << std::endl;
   std::cout << "   -b   --benchmark             Run in benchmark mode" << std::endl;
+  std::cout << "        --benchmark-threads=1,2,4,...  Run the benchmark at each thread count"
+            << std::endl;
   std::cout << "   -L   --list-factories        List all the factories without running"
             << std::endl;
+  std::cout << "        --fork=N                Initialize once, then process the input in N processes"
+            << std::endl;
+  std::cout << "        --profile=NAME          Run a configuration other than the default one, e.g. fastsim"
+            << std::endl;
   std::cout << "   -Pkey=value                  Specify a configuration parameter" << std::endl;
   std::cout << "   -Pplugin:param=value         Specify a parameter value for a plugin"
             << std::endl;
@@ -249,6 +273,68 @@ void AddAvailablePluginsToOptionParams(UserOptions& options,
   }
 }
 
+const Profile* SelectProfile(UserOptions& options, std::map<std::string, Profile> const& profiles) {
+  auto profile = profiles.find(options.profile);
+  if (profile == profiles.end()) {
+    std::cout << "Unknown profile '" << options.profile << "', the profiles are:";
+    for (const auto& [name, _] : profiles) {
+      std::cout << " " << name;
+    }
+    std::cout << std::endl;
+    return nullptr;
+  }
+  // parameter keys are case insensitive
+  std::set<std::string> user_keys;
+  for (const auto& [key, _] : options.params) {
+    user_keys.insert(JParameterManager::ToLower(key));
+  }
+  for (const auto& [key, value] : profile->second.parameters) {
+    if (!user_keys.contains(JParameterManager::ToLower(key))) {
+      options.params[key] = value;
+    }
+  }
+  return &profile->second;
+}
+
+/// Take the plugins of the executable out of the "plugins" parameter of @param para_mgr, in their
+/// order. JANA loads the rest of them from the plugin paths, after the ones returned here.
+std::vector<const StaticPlugin*> TakeStaticPlugins(JParameterManager* para_mgr) {
+  std::vector<const StaticPlugin*> taken;
+  const auto static_plugins = GetStaticPlugins();
+  auto* plugins_param       = para_mgr->FindParameter("plugins");
+  if (static_plugins.empty() || plugins_param == nullptr) {
+    return taken;
+  }
+
+  std::set<std::string> ignored;
+  if (auto* ignore_param = para_mgr->FindParameter("plugins_to_ignore")) {
+    std::stringstream ss(ignore_param->GetValue());
+    std::string name;
+    while (std::getline(ss, name, ',')) {
+      ignored.insert(name);
+    }
+  }
+
+  std::set<std::string> seen;
+  std::string dynamic_plugins;
+  std::stringstream ss(plugins_param->GetValue());
+  std::string name;
+  while (std::getline(ss, name, ',')) {
+    if (name.empty() || ignored.contains(name) || !seen.insert(name).second) {
+      continue;
+    }
+    auto it = std::find_if(static_plugins.begin(), static_plugins.end(),
+                           [&name](const StaticPlugin& plugin) { return name == plugin.name; });
+    if (it != static_plugins.end()) {
+      taken.push_back(&*it);
+    } else {
+      dynamic_plugins += (dynamic_plugins.empty() ? "" : ",") + name;
+    }
+  }
+  para_mgr->SetParameter("plugins", dynamic_plugins);
+  return taken;
+}
+
 JApplication* CreateJApplication(UserOptions& options) {
 
   auto* para_mgr =
@@ -285,8 +371,43 @@ JApplication* CreateJApplication(UserOptions& options) {
     para_mgr->SetParameter("jana:warmup_timeout", 180); // seconds
   }
 
+  // jana:numa_policy pins the worker threads and keeps the events of a thread on its socket
+  // (socket) or NUMA node (numa), through the JANA thread affinity and event queue locality
+  {
+    std::string policy = "none";
+    para_mgr->SetDefaultParameter("jana:numa_policy", policy,
+                                  "Pin the worker threads and keep their events on their socket or NUMA node: none, socket or numa");
+    int locality = 0;
+    if (policy == "socket") {
+      locality = 1;
+    } else if (policy == "numa") {
+      locality = 2;
+    } else if (policy != "none") {
+      std::cout << "jana:numa_policy must be none, socket or numa, not '" << policy << "'. Exiting."
+                << std::endl;
+      exit(-1);
+    }
+    if (locality > 0) {
+      if (para_mgr->FindParameter("jana:affinity") == nullptr) {
+        para_mgr->SetParameter("jana:affinity", 1); // fill the memory localities one after the other
+      }
+      if (para_mgr->FindParameter("jana:locality") == nullptr) {
+        para_mgr->SetParameter("jana:locality", locality);
+      }
+    }
+  }
+
+  const auto static_plugins = TakeStaticPlugins(para_mgr);
+
   auto* app = new JApplication(para_mgr);
 
+  // The plugins linked into eicrecon_static are initialized here instead of
+  // being searched for in the plugin paths at JApplication::Initialize()
+  for (const auto* plugin : static_plugins) {
+    app->GetService<JComponentManager>()->next_plugin(plugin->name);
+    plugin->init(app);
+  }
+
   const char* env_p = getenv("EICrecon_MY");
   if (env_p) {
     app->AddPluginPath(std::string(env_p) + "/plugins");
@@ -373,6 +494,213 @@ void PrintConfigParameters(JApplication* app) {
   std::cout << std::string(max_key_length + max_val_length + 20, '-') << std::endl;
 }
 
+/// Resident set size of the process in MB
+double GetResidentSetSizeMB() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmRSS:", 0) == 0) {
+      return std::stod(line.substr(6)) / 1024.; // kB
+    }
+  }
+  return 0;
+}
+
+/// User and system CPU time of all the threads of the process, in seconds
+double GetProcessCPUSeconds() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 + usage.ru_stime.tv_sec +
+         usage.ru_stime.tv_usec * 1e-6;
+}
+
+/// Returns false if the application stopped, e.g. at the end of the event source
+bool SleepUnlessQuitting(JApplication* app, int seconds) {
+  for (int i = 0; i < seconds; i++) {
+    if (app->IsQuitting()) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+  }
+  return !app->IsQuitting();
+}
+
+void RunBenchmarkSweep(JApplication* app, std::vector<int> const& nthreads) {
+  auto* params = app->GetJParameterManager();
+  if (!params->Exists("omnifactory:MetricsFile")) {
+    // enables the per-factory counters
+    params->SetParameter("omnifactory:MetricsFile", "benchmark_factories.json");
+  }
+  int warmup_seconds     = 10;
+  int step_seconds       = 30;
+  std::string sweep_file = "benchmark_sweep.csv";
+  app->SetDefaultParameter("benchmark:warmup_seconds", warmup_seconds,
+                           "Seconds before the measurement of each thread count of --benchmark-threads");
+  app->SetDefaultParameter("benchmark:step_seconds", step_seconds,
+                           "Seconds of the measurement of each thread count of --benchmark-threads");
+  app->SetDefaultParameter("benchmark:sweep_file", sweep_file,
+                           "CSV file of the results of --benchmark-threads");
+
+  // the geometry and the plugins are loaded once, the thread pool is rescaled for each step
+  app->Run(false);
+  auto& metrics = eicrecon::JOmniFactoryMetrics::instance();
+
+  std::ofstream csv(sweep_file);
+  csv << "threads,events,seconds,events_per_second,cpu_efficiency,rss_mb" << std::endl;
+  for (int n : nthreads) {
+    app->Scale(n);
+    if (!SleepUnlessQuitting(app, warmup_seconds)) {
+      std::cout << "Benchmark stopped before " << n << " threads, the event source is exhausted" << std::endl;
+      break;
+    }
+    const auto factories_start = metrics.totals();
+    const auto events_start    = app->GetNEventsProcessed();
+    const double cpu_start     = GetProcessCPUSeconds();
+    const auto wall_start      = std::chrono::steady_clock::now();
+    const bool complete        = SleepUnlessQuitting(app, step_seconds);
+    const auto factories_end   = metrics.totals();
+    const auto events          = app->GetNEventsProcessed() - events_start;
+    const double cpu           = GetProcessCPUSeconds() - cpu_start;
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    const double rss  = GetResidentSetSizeMB();
+
+    const double rate       = events / wall;
+    const double efficiency = cpu / (wall * n);
+    std::cout << fmt::format("Benchmark {:3d} threads: {:10.2f} events/s, CPU efficiency {:5.1f}%, RSS {:8.1f} MB",
+                             n, rate, 100 * efficiency, rss)
+              << std::endl;
+    csv << n << ',' << events << ',' << wall << ',' << rate << ',' << efficiency << ',' << rss << std::endl;
+
+    // the factories that took the most time in this step
+    std::vector<std::pair<std::uint64_t, std::string>> factory_ns;
+    std::uint64_t total_ns = 0;
+    for (const auto& [prefix, totals] : factories_end) {
+      auto it                = factories_start.find(prefix);
+      const std::uint64_t ns = totals.wall_ns - (it == factories_start.end() ? 0 : it->second.wall_ns);
+      factory_ns.emplace_back(ns, prefix);
+      total_ns += ns;
+    }
+    std::sort(factory_ns.rbegin(), factory_ns.rend());
+    for (std::size_t i = 0; i < std::min<std::size_t>(10, factory_ns.size()) && events > 0; i++) {
+      std::cout << fmt::format("    {:8.3f} ms/event {:5.1f}%  {}", factory_ns[i].first * 1e-6 / events,
+                               100. * factory_ns[i].first / std::max<std::uint64_t>(total_ns, 1),
+                               factory_ns[i].second)
+                << std::endl;
+    }
+    if (!complete) {
+      std::cout << "Benchmark stopped during " << n << " threads, the event source is exhausted" << std::endl;
+      break;
+    }
+  }
+  std::cout << "Benchmark results written to " << sweep_file << std::endl;
+  app->Quit();
+}
+
+/// The options that start threads before the workers are forked, which the workers would not have:
+/// the asynchronous logger would block on its first full queue, and the others would never run.
+std::vector<std::string> ThreadsBeforeFork(JApplication* app) {
+  auto* params = app->GetJParameterManager();
+  std::vector<std::string> options;
+  if (params->Exists("eicrecon:LogAsync") && app->GetParameterValue<bool>("eicrecon:LogAsync")) {
+    options.push_back("eicrecon:LogAsync");
+  }
+  if (params->Exists("histsfile:publish") && !app->GetParameterValue<std::string>("histsfile:publish").empty()) {
+    options.push_back("histsfile:publish");
+  }
+  for (const auto* name : {"onnx:IntraOpThreads", "onnx:InterOpThreads"}) {
+    if (params->Exists(name) && app->GetParameterValue<int>(name) > 1) {
+      options.push_back(name);
+    }
+  }
+  return options;
+}
+
+int RunForkedWorkers(JApplication* app, int nworkers) {
+  app->Initialize();
+  auto* params = app->GetJParameterManager();
+  if (!params->Exists("podio:shard")) {
+    std::cout << "--fork needs the podio event source. Exiting." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (!app->GetParameterValue<std::string>("podio:shard").empty()) {
+    std::cout << "--fork can not be combined with podio:shard. Exiting." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (const auto options = ThreadsBeforeFork(app); !options.empty()) {
+    std::cout << "--fork can not be combined with " << fmt::format("{}", fmt::join(options, ", "))
+              << ", which start threads before the workers are forked. Exiting." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // the geometry, the field map and the other services are initialized here, before the fork,
+  // so that the workers share their pages until they write to them
+  for (const auto& task : eicrecon::ParallelInit::instance().run()) {
+    if (!task.error.empty()) {
+      std::cout << "Initialization of " << task.name << " failed: " << task.error << std::endl;
+    }
+  }
+  // the workers would wait forever for a table or a session whose loading thread was left behind
+  for (const auto& [name, error] : eicrecon::ParallelInit::instance().beforeFork()) {
+    std::cout << "Background initialization of " << name << " failed: " << error << std::endl;
+  }
+  const std::string output_file = app->GetParameterValue<std::string>("podio:output_file");
+  const std::string flat_file = params->Exists("flat:output_file") ? app->GetParameterValue<std::string>("flat:output_file") : "";
+  // the histograms file is only created by the first processor that uses it, in the workers
+  const std::string hists_file = params->Exists("histsfile") ? app->GetParameterValue<std::string>("histsfile") : "eicrecon.root";
+
+  // the output buffered so far would otherwise be printed by every worker
+  std::cout.flush();
+  std::cerr.flush();
+  std::vector<pid_t> workers;
+  for (int k = 0; k < nworkers; k++) {
+    const pid_t pid = fork();
+    if (pid < 0) {
+      std::cout << "Starting the worker " << k << " failed: " << strerror(errno) << std::endl;
+      break;
+    }
+    if (pid == 0) {
+      params->SetParameter("podio:shard", fmt::format("{}/{}", k, nworkers));
+      params->SetParameter("podio:output_file",
+                           std::filesystem::path(output_file).replace_extension(fmt::format(".worker{}.root", k)).string());
+      if (!flat_file.empty()) {
+        params->SetParameter("flat:output_file",
+                             std::filesystem::path(flat_file).replace_extension(fmt::format(".worker{}.root", k)).string());
+      }
+      params->SetParameter("histsfile",
+                           std::filesystem::path(hists_file).replace_extension(fmt::format(".worker{}.root", k)).string());
+      try {
+        JSignalHandler::register_handlers(app);
+        app->Run();
+      } catch (JException& e) {
+        std::cout << "Worker " << k << ": " << e << std::endl;
+        app->SetExitCode(EXIT_FAILURE);
+      } catch (std::runtime_error& e) {
+        std::cout << "Worker " << k << ": exception: " << e.what() << std::endl;
+        app->SetExitCode(EXIT_FAILURE);
+      }
+      return (int)app->GetExitCode();
+    }
+    workers.push_back(pid);
+  }
+
+  int exit_code = workers.size() == static_cast<std::size_t>(nworkers) ? EXIT_SUCCESS : EXIT_FAILURE;
+  for (std::size_t k = 0; k < workers.size(); k++) {
+    int status = 0;
+    while (waitpid(workers[k], &status, 0) < 0 && errno == EINTR) {
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+      std::cout << "Worker " << k << " failed" << (WIFSIGNALED(status) ? fmt::format(" on signal {}", WTERMSIG(status)) : "")
+                << std::endl;
+      exit_code = EXIT_FAILURE;
+    }
+  }
+  if (exit_code == EXIT_SUCCESS) {
+    std::cout << "The " << nworkers << " workers wrote "
+              << std::filesystem::path(output_file).replace_extension(".worker*.root").string() << std::endl;
+  }
+  return exit_code;
+}
+
 int Execute(JApplication* app, UserOptions& options) {
 
   std::cout << std::endl;
@@ -395,6 +723,12 @@ int Execute(JApplication* app, UserOptions& options) {
     std::cout << std::endl
               << "Writing configuration options to file: " << options.dump_config_file << std::endl;
     app->GetJParameterManager()->WriteConfigFile(options.dump_config_file);
+  } else if (options.flags[ForkWorkers]) {
+    printJANAHeaderIMG();
+    return RunForkedWorkers(app, options.fork_workers);
+  } else if (options.flags[BenchmarkThreads]) {
+    JSignalHandler::register_handlers(app);
+    RunBenchmarkSweep(app, options.benchmark_threads);
   } else if (options.flags[Benchmark]) {
     JSignalHandler::register_handlers(app);
     // Run JANA in benchmark mode
@@ -464,6 +798,81 @@ UserOptions GetCliOptions(int nargs, char* argv[], bool expect_extra) {
       continue;
     }
 
+    if (arg.rfind("--benchmark-threads", 0) == 0) {
+      std::string list;
+      if (arg.size() > 20 && arg[19] == '=') {
+        list = arg.substr(20);
+      } else if (arg.size() == 19 && i + 1 < nargs) {
+        list = argv[++i];
+      }
+      std::stringstream ss(list);
+      std::string item;
+      bool valid = true;
+      while (valid && std::getline(ss, item, ',')) {
+        if (item.empty()) {
+          continue;
+        }
+        std::size_t parsed = 0;
+        int threads = 0;
+        try {
+          threads = std::stoi(item, &parsed);
+        } catch (const std::invalid_argument&) {
+          parsed = 0;
+        } catch (const std::out_of_range&) {
+          parsed = 0;
+        }
+        if (parsed != item.size() || threads < 1) {
+          std::cout << "Invalid thread count '" << item << "' in '" << arg << "': Expected positive integers" << std::endl;
+          valid = false;
+        } else {
+          options.benchmark_threads.push_back(threads);
+        }
+      }
+      if (!valid) {
+        options.benchmark_threads.clear();
+      }
+      if (options.benchmark_threads.empty()) {
+        std::cout << "Invalid '" << arg << "': Expected format --benchmark-threads=1,2,4" << std::endl;
+        options.flags[ShowUsage] = true;
+      } else {
+        options.flags[BenchmarkThreads] = true;
+      }
+      continue;
+    }
+
+    if (arg.rfind("--fork", 0) == 0) {
+      std::string count;
+      if (arg.size() > 7 && arg[6] == '=') {
+        count = arg.substr(7);
+      } else if (arg.size() == 6 && i + 1 < nargs) {
+        count = argv[++i];
+      }
+      try {
+        options.fork_workers = std::stoi(count);
+      } catch (std::exception&) {
+        options.fork_workers = 0;
+      }
+      if (options.fork_workers < 1) {
+        std::cout << "Invalid '" << arg << "': Expected format --fork=N with N >= 1" << std::endl;
+        options.flags[ShowUsage] = true;
+      } else {
+        options.flags[ForkWorkers] = true;
+      }
+      continue;
+    }
+
+    if (arg.rfind("--profile", 0) == 0) {
+      if (arg.size() > 10 && arg[9] == '=') {
+        options.profile = arg.substr(10);
+      } else if (arg.size() == 9 && i + 1 < nargs) {
+        options.profile = argv[++i];
+      } else {
+        std::cout << "Invalid '" << arg << "': Expected format --profile=NAME" << std::endl;
+        options.flags[ShowUsage] = true;
+      }
+      continue;
+    }
+
     switch (tokenizer[arg]) {
 
     case Benchmark:
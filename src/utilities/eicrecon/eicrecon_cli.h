@@ -27,7 +27,9 @@ namespace jana {
         LoadConfigs,
         DumpConfigs,
         Benchmark,
-        ListFactories
+        BenchmarkThreads,
+        ListFactories,
+        ForkWorkers
     };
 
     struct UserOptions {
@@ -39,8 +41,23 @@ namespace jana {
         std::vector<std::string> eventSources;
         std::string load_config_file;
         std::string dump_config_file;
+        std::vector<int> benchmark_threads;
+        int fork_workers = 0;
+        std::string profile = "default";
     };
 
+    /// A configuration of eicrecon selected with --profile=<name>: the plugins that it loads
+    /// instead of the default plugins, and the defaults of its parameters, which the -P options
+    /// and the config file take precedence over.
+    struct Profile {
+        std::vector<std::string> plugins;
+        std::map<std::string, std::string> parameters;
+    };
+
+    /// Find the profile of @param options in @param profiles, and add the defaults of its
+    /// parameters to @param options.params. Returns nullptr for an unknown profile.
+    const Profile* SelectProfile(UserOptions& options, std::map<std::string, Profile> const& profiles);
+
     /// Read the user options from the command line and initialize @param options.
     /// If there are certain flags, mark them as true.
     /// Push the event source strings to @param options.eventSources.
@@ -80,6 +97,18 @@ namespace jana {
     /// @note The cli -Pkey=value pairs are not processed when the function returns. They are processed,
     /// or, added to @var app at calling JApplication::Initialize().
     JApplication* CreateJApplication(UserOptions& options);
+
+    /// Benchmark the @param app at each of the thread counts of @param nthreads, in the same process.
+    /// Prints the event rate, the CPU efficiency, the RSS and the slowest factories of every step,
+    /// and writes the steps to the CSV file of the benchmark:sweep_file parameter.
+    void RunBenchmarkSweep(JApplication* app, std::vector<int> const& nthreads);
+
+    /// Initialize the @param app once, then fork @param nworkers processes that share its memory copy-on-write.
+    /// The worker k reads the podio:shard k/N of every input file and writes <output>.worker<k>.root.
+    /// Returns the exit code of the worker in the workers; in the parent, it waits for all of them and
+    /// returns EXIT_FAILURE if any of them failed.
+    int RunForkedWorkers(JApplication* app, int nworkers);
+
     int Execute(JApplication* app, UserOptions& options);
 
 }
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JEventProcessor.h>
+#include <JANA/Services/JParameterManager.h>
+#include <fmt/format.h>
+#include <podio/Frame.h>
+#include <podio/ROOTFrameWriter.h>
+#include <spdlog/logger.h>
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "extensions/jana/JOmniFactoryPruning.h"
+#include "services/log/Log_service.h"
+
+/**
+ * Records the inputs of one JOmniFactory for `eicrecon-replay`.
+ *
+ * With `-Pjanareplay:record=<factory prefix>`, the input collections of the
+ * factory are written as the "events" of `janareplay:record_file`, which the
+ * podio event source reads back. At the end of the job, the resolved values
+ * of all the parameters are written to the same file, as the parameters of a
+ * frame of the "janareplay" category.
+ */
+class JEventProcessorJANARECORD : public JEventProcessor
+{
+  public:
+
+    /// Parameters of the recording job that must not be replayed
+    static bool IsJobParameter(const std::string& key) {
+        for (const char* prefix : {"jana:", "podio:", "janareplay:", "janatop:", "janatrace:", "omnifactory:"}) {
+            if (key.rfind(prefix, 0) == 0) {
+                return true;
+            }
+        }
+        return key == "nthreads" || key == "nevents" || key == "nskip";
+    }
+
+    JEventProcessorJANARECORD(): JEventProcessor() {
+        SetTypeName("JEventProcessorJANARECORD");
+    };
+
+    void Init() override {
+        auto app = GetApplication();
+        app->SetDefaultParameter("janareplay:record", m_prefix, "Prefix of the factory whose inputs are recorded, e.g. tracking:CentralCKFTrajectories");
+        app->SetDefaultParameter("janareplay:record_file", m_output_file, "Output file of janareplay:record");
+        if (m_prefix.empty()) {
+            return;
+        }
+        m_log = app->GetService<Log_service>()->logger("janareplay");
+
+        auto wiring = eicrecon::JOmniFactoryWirings::instance().Find(m_prefix);
+        if (!wiring) {
+            throw JException("janareplay: no JOmniFactory with prefix '%s'", m_prefix.c_str());
+        }
+        m_collections = wiring->input_tags;
+        if (std::find(m_collections.begin(), m_collections.end(), "EventHeader") == m_collections.end()) {
+            m_collections.push_back("EventHeader");
+        }
+        m_writer = std::make_unique<podio::ROOTFrameWriter>(m_output_file);
+        m_log->info("Recording the inputs of {} to {}: {}", m_prefix, m_output_file, fmt::join(m_collections, ", "));
+    };
+
+    void BeginRun(const std::shared_ptr<const JEvent>& event) override { };
+
+    void Process(const std::shared_ptr<const JEvent>& event) override {
+        if (m_writer == nullptr) {
+            return;
+        }
+        std::call_once(m_first_event, [this, &event]() {
+            // the inputs that are not podio collections are made again by the replay
+            std::vector<std::string> podio_collections;
+            for (const auto& collection : m_collections) {
+                try {
+                    event->GetCollectionBase(collection);
+                    podio_collections.push_back(collection);
+                } catch (std::exception& e) {
+                    m_log->warn("Not recording '{}', which is not a podio collection", collection);
+                }
+            }
+            m_collections = podio_collections;
+        });
+        // runs the upstream factories
+        for (const auto& collection : m_collections) {
+            event->GetCollectionBase(collection);
+        }
+        const auto* frame = event->GetSingle<podio::Frame>();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_writer->writeFrame(*frame, "events", m_collections);
+        ++m_events;
+    };
+
+    void EndRun() override { };
+
+    void Finish() override {
+        if (m_writer == nullptr) {
+            return;
+        }
+        // all factories that ran are initialised, so their parameters are registered
+        podio::Frame configuration;
+        configuration.putParameter("janareplay:factory", m_prefix);
+        for (const auto& [key, param] : GetApplication()->GetJParameterManager()->GetAllParameters()) {
+            if (!IsJobParameter(key)) {
+                configuration.putParameter(key, param->GetValue());
+            }
+        }
+        m_writer->writeFrame(configuration, "janareplay");
+        m_writer->finish();
+        m_log->info("Recorded {} events for {} to {}", m_events, m_prefix, m_output_file);
+    };
+
+  private:
+
+    std::string m_prefix;
+    std::string m_output_file{"janareplay.root"};
+    std::vector<std::string> m_collections;
+
+    std::once_flag m_first_event;
+    std::mutex m_mutex;
+    std::unique_ptr<podio::ROOTFrameWriter> m_writer;
+    std::size_t m_events{0};
+    std::shared_ptr<spdlog::logger> m_log;
+};
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JEventProcessor.h>
+#include <JANA/JFactorySet.h>
+#include <JANA/JMultifactory.h>
+#include <JANA/Services/JParameterManager.h>
+#include <spdlog/logger.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "extensions/jana/JOmniFactoryPruning.h"
+#include "extensions/jana/JOmniFactoryReplay.h"
+#include "services/log/Log_service.h"
+
+/**
+ * Calls the Process() of one JOmniFactory in a loop, on the recorded inputs.
+ *
+ * With `-Pjanareplay:factory=<factory prefix>`, the factory runs once per
+ * event through JANA, then `janareplay:iterations` more times on the same
+ * inputs, without the other factories, the event source or the writer. The
+ * per-call wall times of all the threads are summarised at Finish.
+ */
+class JEventProcessorJANAREPLAY : public JEventProcessor
+{
+  public:
+
+    JEventProcessorJANAREPLAY(): JEventProcessor() {
+        SetTypeName("JEventProcessorJANAREPLAY");
+    };
+
+    void Init() override {
+        auto app = GetApplication();
+        app->SetDefaultParameter("janareplay:factory", m_prefix, "Prefix of the factory to replay");
+        app->SetDefaultParameter("janareplay:iterations", m_iterations, "Calls of the factory per event");
+        if (m_prefix.empty()) {
+            return;
+        }
+        m_log = app->GetService<Log_service>()->logger("janareplay");
+
+        auto wiring = eicrecon::JOmniFactoryWirings::instance().Find(m_prefix);
+        if (!wiring) {
+            throw JException("janareplay: no JOmniFactory with prefix '%s'", m_prefix.c_str());
+        }
+        m_output_tags = wiring->output_tags;
+    };
+
+    void BeginRun(const std::shared_ptr<const JEvent>& event) override { };
+
+    void Process(const std::shared_ptr<const JEvent>& event) override {
+        if (m_prefix.empty()) {
+            return;
+        }
+        auto* factory = FindFactory(event);
+
+        // the first call goes through JANA, which initialises the factory
+        bool triggered = false;
+        for (const auto& tag : m_output_tags) {
+            try {
+                event->GetCollectionBase(tag);
+                triggered = true;
+                break;
+            } catch (std::exception& e) {
+                // not a podio output
+            }
+        }
+        if (!triggered) {
+            throw JException("janareplay: %s has no podio output to trigger it", m_prefix.c_str());
+        }
+
+        auto& wall_ns = GetThreadTimes();
+        const auto start = std::chrono::steady_clock::now();
+        factory->Replay(event, m_iterations, wall_ns);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_replay_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    };
+
+    void EndRun() override { };
+
+    void Finish() override {
+        if (m_prefix.empty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<std::uint64_t> wall_ns;
+        for (const auto& thread_times : m_thread_times) {
+            wall_ns.insert(wall_ns.end(), thread_times->begin(), thread_times->end());
+        }
+        if (wall_ns.empty()) {
+            m_log->warn("No call of {} was replayed", m_prefix);
+            return;
+        }
+        std::sort(wall_ns.begin(), wall_ns.end());
+        const auto quantile = [&wall_ns](double q) {
+            return wall_ns[std::min(wall_ns.size() - 1, static_cast<std::size_t>(q * wall_ns.size()))] / 1000.;
+        };
+        // calls per second of the whole job, i.e. over all the threads
+        const std::size_t n_threads = m_thread_times.size();
+        const double throughput = wall_ns.size() / (m_replay_ns * 1e-9 / n_threads);
+        m_log->info("{}: {} calls on {} threads, min {:.1f} us, p50 {:.1f} us, p95 {:.1f} us, p99 {:.1f} us, {:.1f} calls/s",
+                    m_prefix, wall_ns.size(), n_threads, wall_ns.front() / 1000., quantile(0.5), quantile(0.95),
+                    quantile(0.99), throughput);
+    };
+
+  private:
+
+    std::string m_prefix;
+    std::size_t m_iterations{100};
+    std::vector<std::string> m_output_tags;
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<std::vector<std::uint64_t>>> m_thread_times;
+    std::uint64_t m_replay_ns{0}; // summed over the threads
+    std::shared_ptr<spdlog::logger> m_log;
+
+    eicrecon::JOmniFactoryReplayable* FindFactory(const std::shared_ptr<const JEvent>& event) {
+        for (auto* multifactory : event->GetFactorySet()->GetAllMultifactories()) {
+            auto* factory = dynamic_cast<eicrecon::JOmniFactoryReplayable*>(multifactory);
+            if (factory != nullptr && factory->ReplayPrefix() == m_prefix) {
+                return factory;
+            }
+        }
+        throw JException("janareplay: factory '%s' not found in the factory set", m_prefix.c_str());
+    }
+
+    std::vector<std::uint64_t>& GetThreadTimes() {
+        thread_local std::vector<std::uint64_t>* times = nullptr;
+        if (times == nullptr) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_thread_times.push_back(std::make_unique<std::vector<std::uint64_t>>());
+            times = m_thread_times.back().get();
+        }
+        return *times;
+    }
+};
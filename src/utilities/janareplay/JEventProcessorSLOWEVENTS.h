@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JEventProcessor.h>
+#include <JANA/Services/JParameterManager.h>
+#include <podio/Frame.h>
+#include <podio/ROOTFrameReader.h>
+#include <podio/ROOTFrameWriter.h>
+#include <spdlog/logger.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "JEventProcessorJANARECORD.h"
+#include "extensions/jana/JOmniFactoryMetrics.h"
+#include "services/io/podio/PodioCheckpoint.h"
+#include "services/log/Log_service.h"
+
+/**
+ * Flight recorder of the slowest events, for the long tail of the event time.
+ *
+ * With `-Pjanareplay:slow_events=K`, every JOmniFactory times its Process()
+ * in every event, and the K events with the largest sum of these times are
+ * kept: their event numbers and the time of every factory. Nothing else is
+ * kept while the job runs. At the end, the input frames of these events are
+ * read again from the input files of JEventSourcePODIO, unless
+ * `janareplay:slow_events_frames` is off, and written slowest first as the
+ * "events" of `janareplay:slow_events_file`, with the times as frame
+ * parameters. The parameters of the job are written as for
+ * `janareplay:record`, with the slowest factory, so that the file is ready
+ * for `eicrecon-replay`, or for eicrecon itself.
+ *
+ * The factories that run after this processor are not counted, it is meant
+ * to be the last one, as with `-Pplugins=janareplay` after the others.
+ */
+class JEventProcessorSLOWEVENTS : public JEventProcessor
+{
+  public:
+
+    JEventProcessorSLOWEVENTS(): JEventProcessor() {
+        SetTypeName("JEventProcessorSLOWEVENTS");
+
+        // before the event sources are made, which insert the input entries of the events
+        japp->SetDefaultParameter("janareplay:slow_events", m_slow_events, "Number of the slowest events whose factory times and input frames are kept (0 for none)");
+        japp->SetDefaultParameter("janareplay:slow_events_frames", m_frames, "Write the input frames of janareplay:slow_events, read again from the input files at the end");
+        if (m_slow_events > 0 && m_frames) {
+            japp->SetParameterValue("podio:input_entries", true);
+        }
+    };
+
+    void Init() override {
+        auto app = GetApplication();
+        app->SetDefaultParameter("janareplay:slow_events_file", m_output_file, "Output file of janareplay:slow_events");
+        if (m_slow_events == 0) {
+            return;
+        }
+        m_log = app->GetService<Log_service>()->logger("janareplay");
+        eicrecon::JOmniFactoryEventTimes::enable();
+        m_log->info("Keeping the {} slowest events for {}", m_slow_events, m_output_file);
+    };
+
+    void BeginRun(const std::shared_ptr<const JEvent>& event) override { };
+
+    void Process(const std::shared_ptr<const JEvent>& event) override {
+        if (m_slow_events == 0) {
+            return;
+        }
+        auto times = eicrecon::JOmniFactoryEventTimes::take(event.get(), event->GetEventNumber());
+        std::uint64_t total_ns = 0;
+        for (const auto& [prefix, wall_ns] : times) {
+            total_ns += wall_ns;
+        }
+        // most events are faster than the slowest ones so far
+        if (total_ns <= m_threshold_ns.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        SlowEvent slow{event->GetRunNumber(), event->GetEventNumber(), total_ns, std::move(times), std::nullopt};
+        if (m_frames) {
+            try {
+                const auto entries = event->Get<eicrecon::PodioInputEntry>();
+                if (!entries.empty()) {
+                    slow.input = *entries.front();
+                }
+            } catch (std::exception& e) {
+                // not from JEventSourcePODIO
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_events.size() == m_slow_events) {
+            if (total_ns <= m_events.front().total_ns) {
+                return;
+            }
+            std::pop_heap(m_events.begin(), m_events.end(), IsSlower);
+            m_events.pop_back();
+        }
+        m_events.push_back(std::move(slow));
+        std::push_heap(m_events.begin(), m_events.end(), IsSlower);
+        if (m_events.size() == m_slow_events) {
+            m_threshold_ns.store(m_events.front().total_ns, std::memory_order_relaxed);
+        }
+    };
+
+    void EndRun() override { };
+
+    void Finish() override {
+        if (m_slow_events == 0) {
+            return;
+        }
+        std::sort(m_events.begin(), m_events.end(), IsSlower);
+
+        // the factory with the most time in all the slow events is the one to replay
+        std::map<std::string, std::uint64_t> factory_ns;
+        for (const auto& slow : m_events) {
+            for (const auto& [prefix, wall_ns] : slow.times) {
+                factory_ns[prefix] += wall_ns;
+            }
+        }
+        const auto slowest = std::max_element(factory_ns.begin(), factory_ns.end(),
+                                              [](const auto& a, const auto& b) { return a.second < b.second; });
+
+        podio::ROOTFrameWriter writer(m_output_file);
+        std::map<std::string, std::unique_ptr<podio::ROOTFrameReader>> readers;
+        std::size_t frames = 0;
+        for (std::size_t rank = 0; rank < m_events.size(); ++rank) {
+            const auto& slow = m_events[rank];
+            podio::Frame frame;
+            if (slow.input) {
+                try {
+                    auto& reader = readers[slow.input->file];
+                    if (reader == nullptr) {
+                        reader = std::make_unique<podio::ROOTFrameReader>();
+                        reader->openFile(slow.input->file);
+                    }
+                    frame = podio::Frame(reader->readEntry("events", slow.input->entry));
+                    ++frames;
+                } catch (std::exception& e) {
+                    m_log->warn("Can not read entry {} of {} again: {}", slow.input->entry, slow.input->file, e.what());
+                }
+            }
+            std::vector<std::string> prefixes;
+            std::vector<double> ms;
+            for (const auto& [prefix, wall_ns] : slow.times) {
+                prefixes.push_back(prefix);
+                ms.push_back(wall_ns * 1e-6);
+            }
+            frame.putParameter("slow:rank", static_cast<int>(rank));
+            frame.putParameter("slow:run_number", static_cast<int>(slow.run_number));
+            frame.putParameter("slow:event_number", static_cast<int>(slow.event_number));
+            frame.putParameter("slow:total_ms", slow.total_ns * 1e-6);
+            frame.putParameter("slow:factories", std::move(prefixes));
+            frame.putParameter("slow:factory_ms", std::move(ms));
+            writer.writeFrame(frame, "events");
+
+            const auto top = std::max_element(slow.times.begin(), slow.times.end(),
+                                              [](const auto& a, const auto& b) { return a.second < b.second; });
+            m_log->info("{:3}. event {:>10}: {:10.3f} ms, {:.3f} ms in {}", rank + 1, slow.event_number, slow.total_ns * 1e-6,
+                        top == slow.times.end() ? 0. : top->second * 1e-6, top == slow.times.end() ? "-" : top->first);
+        }
+
+        podio::Frame configuration;
+        configuration.putParameter("janareplay:factory", slowest == factory_ns.end() ? std::string() : slowest->first);
+        for (const auto& [key, param] : GetApplication()->GetJParameterManager()->GetAllParameters()) {
+            if (!JEventProcessorJANARECORD::IsJobParameter(key)) {
+                configuration.putParameter(key, param->GetValue());
+            }
+        }
+        writer.writeFrame(configuration, "janareplay");
+        writer.finish();
+        m_log->info("Wrote the {} slowest events, {} with their input frames, to {}", m_events.size(), frames, m_output_file);
+    };
+
+  private:
+
+    struct SlowEvent {
+        std::uint64_t run_number;
+        std::uint64_t event_number;
+        std::uint64_t total_ns;
+        eicrecon::JOmniFactoryEventTimes::Times times;
+        std::optional<eicrecon::PodioInputEntry> input;
+    };
+
+    /// Heap order with the fastest of the kept events at the front
+    static bool IsSlower(const SlowEvent& a, const SlowEvent& b) { return a.total_ns > b.total_ns; }
+
+    std::size_t m_slow_events{0};
+    bool m_frames{true};
+    std::string m_output_file{"slow_events.root"};
+
+    std::mutex m_mutex;
+    std::vector<SlowEvent> m_events; // heap of the slowest events
+    std::atomic<std::uint64_t> m_threshold_ns{0}; // of the fastest kept event, once there are m_slow_events
+    std::shared_ptr<spdlog::logger> m_log;
+};
@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#include <JANA/JApplication.h>
+
+#include "JEventProcessorJANARECORD.h"
+#include "JEventProcessorJANAREPLAY.h"
+#include "JEventProcessorSLOWEVENTS.h"
+
+extern "C" {
+    void InitPlugin(JApplication *app) {
+        InitJANAPlugin(app);
+        app->Add(new JEventProcessorJANARECORD());
+        app->Add(new JEventProcessorJANAREPLAY());
+        app->Add(new JEventProcessorSLOWEVENTS());
+    }
+}
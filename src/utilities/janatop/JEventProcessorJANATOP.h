@@ -3,8 +3,18 @@
 
 #include <JANA/JEventProcessor.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+#include "extensions/jana/JOmniFactoryMetrics.h"
 
 class JEventProcessorJANATOP : public JEventProcessor
 {
@@ -75,6 +85,50 @@ class JEventProcessorJANATOP : public JEventProcessor
         unsigned int Nfrom_cache;
     };
 
+    // per-call times on a log scale, 8 bins per factor 2 from 1 ns
+    class CallTimeHistogram {
+      public:
+        void Fill(double time_ms) {
+            const double ns = time_ms * 1e6;
+            std::size_t bin = 0;
+            if (ns > 1.) {
+                bin = std::min<std::size_t>(static_cast<std::size_t>(bins_per_octave * std::log2(ns)), n_bins - 1);
+            }
+            ++counts[bin];
+            ++entries;
+        }
+        void Add(const CallTimeHistogram& other) {
+            for (std::size_t i = 0; i < n_bins; ++i) {
+                counts[i] += other.counts[i];
+            }
+            entries += other.entries;
+        }
+        // upper edge of the bin of quantile q, in ms
+        double Quantile(double q) const {
+            const auto target = static_cast<std::uint64_t>(std::ceil(q * entries));
+            std::uint64_t sum = 0;
+            for (std::size_t i = 0; i < n_bins; ++i) {
+                sum += counts[i];
+                if (sum >= target && sum > 0) {
+                    return std::exp2((i + 1.) / bins_per_octave) * 1e-6;
+                }
+            }
+            return 0.;
+        }
+        std::uint64_t entries{0};
+      private:
+        static constexpr double bins_per_octave = 8.;
+        static constexpr std::size_t n_bins = 64 * 8;
+        std::array<std::uint64_t, n_bins> counts{};
+    };
+
+    // filled by one thread each, merged at Finish
+    struct ThreadStats {
+        std::map<CallLink, CallStats> call_links;
+        std::map<std::string, FactoryCallStats> factory_stats;
+        std::map<std::string, CallTimeHistogram> call_times;
+    };
+
   public:
 
     JEventProcessorJANATOP(): JEventProcessor() {
@@ -88,10 +142,12 @@ class JEventProcessorJANATOP : public JEventProcessor
 
     void Process(const std::shared_ptr<const JEvent>& event) override {
         // Get the call stack for ths event and add the results to our stats
-        auto stack = event->GetJCallGraphRecorder()->GetCallGraph();
+        const auto& stack = event->GetJCallGraphRecorder()->GetCallGraph();
 
-        // Lock mutex in case we are running with multiple threads
-        std::lock_guard<std::mutex> lck(mutex);
+        // Statistics of this thread, no lock needed
+        ThreadStats& thread_stats = GetThreadStats();
+        auto& call_links = thread_stats.call_links;
+        auto& factory_stats = thread_stats.factory_stats;
 
         // Loop over the call stack elements and add in the values
         for (unsigned int i = 0; i < stack.size(); i++) {
@@ -103,7 +159,7 @@ class JEventProcessorJANATOP : public JEventProcessor
             FactoryCallStats &fcallstats1 = factory_stats[nametag1];
             FactoryCallStats &fcallstats2 = factory_stats[nametag2];
 
-            auto delta_t_ms = std::chrono::duration_cast<std::chrono::milliseconds>(stack[i].end_time - stack[i].start_time).count();
+            const double delta_t_ms = std::chrono::duration<double, std::milli>(stack[i].end_time - stack[i].start_time).count();
             fcallstats1.time_waiting += delta_t_ms;
             fcallstats2.time_waited_on += delta_t_ms;
 
@@ -134,6 +190,7 @@ class JEventProcessorJANATOP : public JEventProcessor
                     fcallstats2.Nfrom_factory++;
                     stats.Nfrom_factory++;
                     stats.from_factory_ms += delta_t_ms;
+                    thread_stats.call_times[nametag2].Fill(delta_t_ms);
                     break;
             }
         }
@@ -142,6 +199,34 @@ class JEventProcessorJANATOP : public JEventProcessor
     void EndRun() override { };
 
     void Finish() override {
+        // Merge the statistics of all the threads
+        std::lock_guard<std::mutex> lck(mutex);
+        std::map<std::string, CallTimeHistogram> call_times;
+        for (const auto& thread_stats : thread_stats_list) {
+            for (const auto& [link, stats] : thread_stats->call_links) {
+                CallStats& total = call_links[link];
+                total.from_cache_ms += stats.from_cache_ms;
+                total.from_source_ms += stats.from_source_ms;
+                total.from_factory_ms += stats.from_factory_ms;
+                total.data_not_available_ms += stats.data_not_available_ms;
+                total.Nfrom_cache += stats.Nfrom_cache;
+                total.Nfrom_source += stats.Nfrom_source;
+                total.Nfrom_factory += stats.Nfrom_factory;
+                total.Ndata_not_available += stats.Ndata_not_available;
+            }
+            for (const auto& [nametag, stats] : thread_stats->factory_stats) {
+                FactoryCallStats& total = factory_stats[nametag];
+                total.time_waited_on += stats.time_waited_on;
+                total.time_waiting += stats.time_waiting;
+                total.Nfrom_factory += stats.Nfrom_factory;
+                total.Nfrom_source += stats.Nfrom_source;
+                total.Nfrom_cache += stats.Nfrom_cache;
+            }
+            for (const auto& [nametag, histogram] : thread_stats->call_times) {
+                call_times[nametag].Add(histogram);
+            }
+        }
+
         // In order to get the total time we have to first get a list of
         // the event processors (i.e. top-level callers). We can tell
         // this just by looking for callers that never show up as callees
@@ -232,11 +317,61 @@ class JEventProcessorJANATOP : public JEventProcessor
             std::cout << nodename;
             std::cout << std::endl;
         }
+
+        // Tails of the per-call times (including the factories called) of the same factories
+        std::cout << "Per-call times (p50 / p95 / p99):" << std::endl;
+        for (auto iter = factory_stats_vector.end() - std::min(factory_stats_vector.size(), 10ul);
+                  iter != factory_stats_vector.end(); iter++) {
+            auto it = call_times.find(iter->first);
+            if (it == call_times.end() || it->second.entries == 0) {
+                continue;
+            }
+            const auto& histogram = it->second;
+            std::cout << MakeTimeString(histogram.Quantile(0.50)) << " / "
+                      << MakeTimeString(histogram.Quantile(0.95)) << " / "
+                      << MakeTimeString(histogram.Quantile(0.99)) << " ";
+            std::cout << histogram.entries << " calls " << iter->first;
+            std::cout << std::endl;
+        }
+
+        // Hardware counters of the JOmniFactory prefixes, with omnifactory:PerfCounters
+        std::vector<std::pair<std::string, eicrecon::JOmniFactoryMetrics::Totals>> counted;
+        for (const auto& [prefix, totals] : eicrecon::JOmniFactoryMetrics::instance().totals()) {
+            if (totals.cycles > 0) {
+                counted.emplace_back(prefix, totals);
+            }
+        }
+        std::sort(counted.begin(), counted.end(),
+                  [](const auto& a, const auto& b) { return a.second.cycles < b.second.cycles; });
+        if (!counted.empty()) {
+            std::cout << "Hardware counters (IPC, LLC / branch misses per input entry):" << std::endl;
+        }
+        for (auto iter = counted.end() - std::min(counted.size(), 10ul); iter != counted.end(); iter++) {
+            const auto& t = iter->second;
+            const double entries = std::max<std::uint64_t>(t.input_entries, 1);
+            char line[128];
+            snprintf(line, sizeof(line), "%.2e cycles, IPC %4.2f, %8.2f / %8.2f ", double(t.cycles),
+                     double(t.instructions) / t.cycles, t.llc_misses / entries, t.branch_misses / entries);
+            std::cout << line << iter->first;
+            std::cout << std::endl;
+        }
     };
 
   private:
 
+    // only taken when a thread registers its statistics and at Finish
     std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadStats>> thread_stats_list;
+
+    ThreadStats& GetThreadStats() {
+        thread_local ThreadStats* thread_stats = nullptr;
+        if (thread_stats == nullptr) {
+            std::lock_guard<std::mutex> lck(mutex);
+            thread_stats_list.push_back(std::make_unique<ThreadStats>());
+            thread_stats = thread_stats_list.back().get();
+        }
+        return *thread_stats;
+    }
 
     std::map<CallLink, CallStats> call_links;
     std::map<std::string, FactoryCallStats> factory_stats;
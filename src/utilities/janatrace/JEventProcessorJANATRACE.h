@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 EICrecon contributors
+
+#pragma once
+
+#include <JANA/JEvent.h>
+#include <JANA/JEventProcessor.h>
+#include <JANA/Services/JParameterManager.h>
+#include <JANA/Utils/JCallGraphRecorder.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Timeline of the factory calls of every thread, as a Chrome trace.
+ *
+ * The spans come from the call graph JANA records for each event (the same
+ * data as janatop). Every thread appends its spans to its own ring buffer,
+ * the processor only locks once per thread to register the buffer. At
+ * Finish the buffers are written as Chrome Trace Event JSON, which
+ * chrome://tracing and https://ui.perfetto.dev open directly.
+ */
+class JEventProcessorJANATRACE : public JEventProcessor
+{
+  private:
+    struct Span {
+        std::uint32_t name;     // index in the names of the thread
+        std::uint32_t caller;
+        std::uint64_t event;
+        std::int64_t start_ns;
+        std::int64_t end_ns;
+    };
+
+    struct ThreadBuffer {
+        std::size_t thread_index{0};
+        std::vector<std::string> names;
+        std::unordered_map<std::string, std::uint32_t> name_index;
+        std::vector<Span> spans;  // ring buffer
+        std::size_t next{0};
+        bool wrapped{false};
+
+        std::uint32_t Intern(const std::string& name) {
+            auto [it, inserted] = name_index.try_emplace(name, names.size());
+            if (inserted) {
+                names.push_back(name);
+            }
+            return it->second;
+        }
+
+        void Push(const Span& span) {
+            if (spans.empty()) {
+                return;
+            }
+            spans[next] = span;
+            if (++next == spans.size()) {
+                next    = 0;
+                wrapped = true;
+            }
+        }
+    };
+
+  public:
+
+    JEventProcessorJANATRACE(): JEventProcessor() {
+        SetTypeName("JEventProcessorJANATRACE");
+    };
+
+    void Init() override {
+        auto app = GetApplication();
+        app->SetDefaultParameter("janatrace:output_file", m_output_file, "Chrome trace JSON file written at the end of the job");
+        app->SetDefaultParameter("janatrace:sample_every", m_sample_every, "Record one event out of this many");
+        app->SetDefaultParameter("janatrace:buffer_size", m_buffer_size, "Maximal number of spans kept per thread, older spans are overwritten");
+        m_sample_every = std::max<std::uint64_t>(m_sample_every, 1);
+    };
+
+    void BeginRun(const std::shared_ptr<const JEvent>& event) override { };
+
+    void Process(const std::shared_ptr<const JEvent>& event) override {
+        if (event->GetEventNumber() % m_sample_every != 0) {
+            return;
+        }
+        auto& buffer = GetThreadBuffer();
+        const auto& stack = event->GetJCallGraphRecorder()->GetCallGraph();
+        for (const auto& node : stack) {
+            if (node.data_source != JCallGraphRecorder::DATA_FROM_FACTORY
+             && node.data_source != JCallGraphRecorder::DATA_FROM_SOURCE) {
+                continue;
+            }
+            buffer.Push({
+                buffer.Intern(MakeNametag(node.callee_name, node.callee_tag)),
+                buffer.Intern(MakeNametag(node.caller_name, node.caller_tag)),
+                event->GetEventNumber(),
+                ToNanoseconds(node.start_time),
+                ToNanoseconds(node.end_time),
+            });
+        }
+    };
+
+    void EndRun() override { };
+
+    void Finish() override {
+        std::lock_guard<std::mutex> lck(m_mutex);
+        if (m_output_file.empty()) {
+            return;
+        }
+
+        // timestamps relative to the first span
+        std::int64_t t0 = std::numeric_limits<std::int64_t>::max();
+        for (const auto& buffer : m_buffers) {
+            for (std::size_t i = 0; i < Count(*buffer); ++i) {
+                t0 = std::min(t0, buffer->spans[i].start_ns);
+            }
+        }
+
+        std::ofstream out(m_output_file);
+        out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+        bool first = true;
+        std::size_t n_spans = 0;
+        for (const auto& buffer : m_buffers) {
+            for (std::size_t i = 0; i < Count(*buffer); ++i) {
+                const auto& span = buffer->spans[i];
+                out << (first ? "" : ",\n");
+                first = false;
+                // complete events, in microseconds
+                out << "{\"name\": \"" << Escape(buffer->names[span.name]) << "\", \"cat\": \"factory\", \"ph\": \"X\""
+                    << ", \"ts\": " << (span.start_ns - t0) / 1000.
+                    << ", \"dur\": " << (span.end_ns - span.start_ns) / 1000.
+                    << ", \"pid\": 0, \"tid\": " << buffer->thread_index
+                    << ", \"args\": {\"event\": " << span.event
+                    << ", \"caller\": \"" << Escape(buffer->names[span.caller]) << "\"}}";
+                ++n_spans;
+            }
+        }
+        out << "\n]}\n";
+        std::cout << "janatrace: wrote " << n_spans << " spans of " << m_buffers.size() << " threads to " << m_output_file << std::endl;
+    };
+
+  private:
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+
+    std::string m_output_file{"janatrace.json"};
+    std::uint64_t m_sample_every{1};
+    std::size_t m_buffer_size{1000000};
+
+    ThreadBuffer& GetThreadBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (buffer == nullptr) {
+            std::lock_guard<std::mutex> lck(m_mutex);
+            m_buffers.push_back(std::make_unique<ThreadBuffer>());
+            buffer = m_buffers.back().get();
+            buffer->thread_index = m_buffers.size() - 1;
+            buffer->spans.resize(m_buffer_size);
+        }
+        return *buffer;
+    }
+
+    static std::size_t Count(const ThreadBuffer& buffer) {
+        return buffer.wrapped ? buffer.spans.size() : buffer.next;
+    }
+
+    template <typename TimePoint>
+    static std::int64_t ToNanoseconds(const TimePoint& t) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+    }
+
+    static std::string Escape(const std::string& s) {
+        std::string escaped;
+        escaped.reserve(s.size());
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    std::string MakeNametag(const std::string &name, const std::string &tag) {
+        std::string nametag = name;
+        if (tag.size() > 0) nametag += ":" + tag;
+        return nametag;
+    }
+};